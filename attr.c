@@ -45,9 +45,13 @@
 #include "pthread_attr_destroy.c"
 #include "pthread_attr_getdetachstate.c"
 #include "pthread_attr_setdetachstate.c"
+#include "pthread_attr_getstack.c"
 #include "pthread_attr_getstackaddr.c"
+#include "pthread_attr_setstack.c"
 #include "pthread_attr_setstackaddr.c"
 #include "pthread_attr_getstacksize.c"
 #include "pthread_attr_setstacksize.c"
+#include "pthread_attr_getguardsize.c"
+#include "pthread_attr_setguardsize.c"
 #include "pthread_attr_getscope.c"
 #include "pthread_attr_setscope.c"
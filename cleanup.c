@@ -44,8 +44,24 @@
  * The functions ptw32_pop_cleanup and ptw32_push_cleanup
  * are implemented here for applications written in C with no
  * SEH or C++ destructor support. 
+ *
+ * The handlers are a list through the cleanup structures, which
+ * live in the pushers' stack frames, headed by the thread's
+ * cleanupStack. A push or pop is then a few loads and stores.
  */
 
+/*
+ * The calling thread's POSIX handle. A thread that isn't a POSIX
+ * thread gets an implicit one on its first push.
+ */
+static ptw32_thread_t *
+ptw32_cleanup_self (void)
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) PTW32_SELF_THREAD ();
+
+  return (sp != NULL) ? sp : (ptw32_thread_t *) pthread_self ().p;
+}
+
 ptw32_cleanup_t *
 ptw32_pop_cleanup (int execute)
      /*
@@ -73,9 +89,8 @@ ptw32_pop_cleanup (int execute)
       * ------------------------------------------------------
       */
 {
-  ptw32_cleanup_t *cleanup;
-
-  cleanup = (ptw32_cleanup_t *) pthread_getspecific (ptw32_cleanupKey);
+  ptw32_thread_t *sp = (ptw32_thread_t *) PTW32_SELF_THREAD ();
+  ptw32_cleanup_t *cleanup = (sp != NULL) ? sp->cleanupStack : NULL;
 
   if (cleanup != NULL)
     {
@@ -86,7 +101,7 @@ ptw32_pop_cleanup (int execute)
 
 	}
 
-      pthread_setspecific (ptw32_cleanupKey, (void *) cleanup->prev);
+      sp->cleanupStack = cleanup->prev;
 
     }
 
@@ -138,11 +153,19 @@ ptw32_push_cleanup (ptw32_cleanup_t * cleanup,
       * ------------------------------------------------------
       */
 {
+  ptw32_thread_t *sp = ptw32_cleanup_self ();
+
   cleanup->routine = routine;
   cleanup->arg = arg;
 
-  cleanup->prev = (ptw32_cleanup_t *) pthread_getspecific (ptw32_cleanupKey);
-
-  pthread_setspecific (ptw32_cleanupKey, (void *) cleanup);
+  if (sp != NULL)
+    {
+      cleanup->prev = sp->cleanupStack;
+      sp->cleanupStack = cleanup;
+    }
+  else
+    {
+      cleanup->prev = NULL;
+    }
 
 }				/* ptw32_push_cleanup */
@@ -0,0 +1,139 @@
+/*
+ * clock_getres.c
+ * 
+ * Description:
+ * POSIX clock functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_CLOCK_GETTIME)
+
+int
+clock_getres (clockid_t clock_id, struct timespec *res)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function returns the resolution of a clock.
+      *
+      * PARAMETERS
+      *      clock_id
+      *              CLOCK_REALTIME, CLOCK_MONOTONIC,
+      *              CLOCK_PROCESS_CPUTIME_ID,
+      *              CLOCK_THREAD_CPUTIME_ID or a thread's CPU time
+      *              clock from pthread_getcpuclockid
+      *
+      *      res
+      *              pointer to an instance of struct timespec,
+      *              or NULL
+      *
+      * DESCRIPTION
+      *      CLOCK_MONOTONIC resolves one QueryPerformanceCounter
+      *      tick, rounded up to a nanosecond. CLOCK_REALTIME
+      *      resolves 100 nanoseconds where
+      *      GetSystemTimePreciseAsFileTime is available; it and the
+      *      CPU time clocks otherwise advance with the system clock
+      *      tick.
+      *
+      * RESULTS
+      *              0               successfully returned the resolution,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'clock_id' is not a valid clock.
+      *
+      * ------------------------------------------------------
+      */
+{
+  long nsec;
+
+  switch (clock_id)
+    {
+    case CLOCK_MONOTONIC:
+      {
+	int64_t frequency = ptw32_perf_frequency();
+
+	nsec = (long) ((1000000000 + frequency - 1) / frequency);
+	break;
+      }
+
+    case CLOCK_REALTIME:
+#if !defined(NEED_FTIME)
+      if (ptw32_getsystemtimepreciseasfiletime != NULL)
+	{
+	  nsec = 100;
+	  break;
+	}
+#endif
+      /* Fall through */
+
+    case CLOCK_PROCESS_CPUTIME_ID:
+    case CLOCK_THREAD_CPUTIME_ID:
+      {
+#if defined(NEED_FTIME)
+	/* The system time is read in milliseconds */
+	nsec = 1000000;
+#else
+	DWORD adjustment, increment;
+	BOOL disabled;
+
+	if (!GetSystemTimeAdjustment(&adjustment, &increment, &disabled))
+	  {
+	    increment = 156250;	/* The common 15.625 ms tick */
+	  }
+
+	nsec = (long) increment * 100;
+#endif
+	break;
+      }
+
+    default:
+      if (clock_id < 0)
+	{
+	  /* A thread CPU time clock from pthread_getcpuclockid */
+	  return clock_getres(CLOCK_THREAD_CPUTIME_ID, res);
+	}
+      errno = EINVAL;
+      return -1;
+    }
+
+  if (res != NULL)
+    {
+      res->tv_sec = nsec / 1000000000;
+      res->tv_nsec = nsec % 1000000000;
+    }
+
+  return 0;
+}				/* clock_getres */
+
+#endif /* PTW32_CLOCK_GETTIME */
@@ -0,0 +1,167 @@
+/*
+ * clock_gettime.c
+ * 
+ * Description:
+ * POSIX clock functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_CLOCK_GETTIME)
+
+int
+clock_gettime (clockid_t clock_id, struct timespec *tp)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function reads the current value of a clock.
+      *
+      * PARAMETERS
+      *      clock_id
+      *              CLOCK_REALTIME, CLOCK_MONOTONIC,
+      *              CLOCK_PROCESS_CPUTIME_ID,
+      *              CLOCK_THREAD_CPUTIME_ID or a thread's CPU time
+      *              clock from pthread_getcpuclockid
+      *
+      *      tp
+      *              pointer to an instance of struct timespec
+      *
+      * DESCRIPTION
+      *      CLOCK_REALTIME is the system time, read with
+      *      GetSystemTimePreciseAsFileTime where available.
+      *      CLOCK_MONOTONIC is QueryPerformanceCounter time, the
+      *      clock that the *_clockwait functions measure
+      *      CLOCK_MONOTONIC timeouts against. The CPU time clocks
+      *      are the user plus kernel times of the process or the
+      *      calling thread, or of the thread a clock from
+      *      pthread_getcpuclockid belongs to, which advance with the
+      *      system clock tick.
+      *
+      *      CLOCK_REALTIME and CLOCK_MONOTONIC make no system calls
+      *      beyond the underlying time query.
+      *
+      * RESULTS
+      *              0               successfully read the clock,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'clock_id' is not a valid clock,
+      *                              'tp' is NULL, or the thread of a
+      *                              thread CPU time clock has exited.
+      *
+      * ------------------------------------------------------
+      */
+{
+  FILETIME ft;
+  FILETIME creation, exitTime, kernel, user;
+  HANDLE threadH;
+  BOOL ok;
+  int64_t t;
+
+  if (tp == NULL)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  switch (clock_id)
+    {
+    case CLOCK_REALTIME:
+      ptw32_filetime_now(&ft);
+      ptw32_filetime_to_timespec(&ft, tp);
+      return 0;
+
+    case CLOCK_MONOTONIC:
+      ptw32_monotonic_now(tp);
+      return 0;
+
+    case CLOCK_PROCESS_CPUTIME_ID:
+#if !defined(NEED_FTIME)
+      if (GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernel, &user))
+	{
+	  break;
+	}
+#endif
+      errno = EINVAL;
+      return -1;
+
+    case CLOCK_THREAD_CPUTIME_ID:
+      if (GetThreadTimes(GetCurrentThread(), &creation, &exitTime, &kernel, &user))
+	{
+	  break;
+	}
+      errno = EINVAL;
+      return -1;
+
+    default:
+      /*
+       * pthread_getcpuclockid makes negative clock IDs from the
+       * complement of the Windows thread ID.
+       */
+      if (clock_id < 0)
+	{
+	  DWORD id = (DWORD) ~clock_id;
+
+	  if (id == GetCurrentThreadId())
+	    {
+	      if (GetThreadTimes(GetCurrentThread(), &creation, &exitTime, &kernel, &user))
+		{
+		  break;
+		}
+	    }
+	  else if (ptw32_openthread != NULL
+		   && (threadH = ptw32_openthread(THREAD_QUERY_INFORMATION, PTW32_FALSE, id)) != NULL)
+	    {
+	      ok = GetThreadTimes(threadH, &creation, &exitTime, &kernel, &user);
+	      (void) CloseHandle(threadH);
+
+	      if (ok)
+		{
+		  break;
+		}
+	    }
+	}
+      errno = EINVAL;
+      return -1;
+    }
+
+  t = ((int64_t) kernel.dwHighDateTime << 32) + (int64_t) kernel.dwLowDateTime
+      + ((int64_t) user.dwHighDateTime << 32) + (int64_t) user.dwLowDateTime;
+
+  tp->tv_sec = (time_t) (t / 10000000);
+  tp->tv_nsec = (long) (t % 10000000) * 100;
+
+  return 0;
+}				/* clock_gettime */
+
+#endif /* PTW32_CLOCK_GETTIME */
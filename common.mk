@@ -11,18 +11,23 @@ DLL_OBJS	= \
 STATIC_OBJS	= \
 		autostatic.$(OBJEXT) \
 		cleanup.$(OBJEXT) \
+		clock_getres.$(OBJEXT) \
+		clock_gettime.$(OBJEXT) \
 		create.$(OBJEXT) \
 		dll.$(OBJEXT) \
 		errno.$(OBJEXT) \
 		global.$(OBJEXT) \
+		nanosleep.$(OBJEXT) \
 		pthread_attr_destroy.$(OBJEXT) \
 		pthread_attr_getaffinity_np.$(OBJEXT) \
 		pthread_attr_getdetachstate.$(OBJEXT) \
 		pthread_attr_getinheritsched.$(OBJEXT) \
 		pthread_attr_getname_np.$(OBJEXT) \
+		pthread_attr_getnumanode_np.$(OBJEXT) \
 		pthread_attr_getschedparam.$(OBJEXT) \
 		pthread_attr_getschedpolicy.$(OBJEXT) \
 		pthread_attr_getscope.$(OBJEXT) \
+		pthread_attr_getstack.$(OBJEXT) \
 		pthread_attr_getstackaddr.$(OBJEXT) \
 		pthread_attr_getstacksize.$(OBJEXT) \
 		pthread_attr_init.$(OBJEXT) \
@@ -30,62 +35,194 @@ STATIC_OBJS	= \
 		pthread_attr_setdetachstate.$(OBJEXT) \
 		pthread_attr_setinheritsched.$(OBJEXT) \
 		pthread_attr_setname_np.$(OBJEXT) \
+		pthread_attr_setnumanode_np.$(OBJEXT) \
+		pthread_attr_getqos_np.$(OBJEXT) \
+		pthread_attr_setqos_np.$(OBJEXT) \
+		pthread_attr_getpooled_np.$(OBJEXT) \
+		pthread_attr_setpooled_np.$(OBJEXT) \
+		pthread_attr_getstackcommit_np.$(OBJEXT) \
+		pthread_attr_setstackcommit_np.$(OBJEXT) \
 		pthread_attr_setschedparam.$(OBJEXT) \
 		pthread_attr_setschedpolicy.$(OBJEXT) \
 		pthread_attr_setscope.$(OBJEXT) \
+		pthread_attr_setstack.$(OBJEXT) \
 		pthread_attr_setstackaddr.$(OBJEXT) \
 		pthread_attr_setstacksize.$(OBJEXT) \
+		pthread_attr_getguardsize.$(OBJEXT) \
+		pthread_attr_setguardsize.$(OBJEXT) \
 		pthread_barrier_destroy.$(OBJEXT) \
 		pthread_barrier_init.$(OBJEXT) \
 		pthread_barrier_wait.$(OBJEXT) \
 		pthread_barrierattr_destroy.$(OBJEXT) \
+		pthread_barrierattr_getkind_np.$(OBJEXT) \
+		pthread_barrier_arrive_np.$(OBJEXT) \
 		pthread_barrierattr_getpshared.$(OBJEXT) \
 		pthread_barrierattr_init.$(OBJEXT) \
+		pthread_barrierattr_setkind_np.$(OBJEXT) \
 		pthread_barrierattr_setpshared.$(OBJEXT) \
+		pthread_latch_init_np.$(OBJEXT) \
+		pthread_latch_destroy_np.$(OBJEXT) \
+		pthread_latch_wait_np.$(OBJEXT) \
+		pthread_phaser_init_np.$(OBJEXT) \
+		pthread_phaser_destroy_np.$(OBJEXT) \
+		pthread_phaser_arrive_np.$(OBJEXT) \
+		pthread_group_create_np.$(OBJEXT) \
+		pthread_group_destroy_np.$(OBJEXT) \
+		pthread_group_add_np.$(OBJEXT) \
+		pthread_group_cancel_np.$(OBJEXT) \
+		pthread_group_join_np.$(OBJEXT) \
+		pthread_group_setaffinity_np.$(OBJEXT) \
+		pthread_group_setschedparam_np.$(OBJEXT) \
 		pthread_cancel.$(OBJEXT) \
 		pthread_cond_destroy.$(OBJEXT) \
 		pthread_cond_init.$(OBJEXT) \
 		pthread_cond_signal.$(OBJEXT) \
 		pthread_cond_wait.$(OBJEXT) \
 		pthread_condattr_destroy.$(OBJEXT) \
+		pthread_condattr_getclock.$(OBJEXT) \
 		pthread_condattr_getpshared.$(OBJEXT) \
 		pthread_condattr_init.$(OBJEXT) \
+		pthread_condattr_setclock.$(OBJEXT) \
 		pthread_condattr_setpshared.$(OBJEXT) \
 		pthread_delay_np.$(OBJEXT) \
 		pthread_detach.$(OBJEXT) \
 		pthread_equal.$(OBJEXT) \
 		pthread_exit.$(OBJEXT) \
 		pthread_getconcurrency.$(OBJEXT) \
+		pthread_getcpuclockid.$(OBJEXT) \
 		pthread_getname_np.$(OBJEXT) \
+		pthread_getnumanode_np.$(OBJEXT) \
+		pthread_getqos_np.$(OBJEXT) \
+		pthread_setqos_np.$(OBJEXT) \
+		pthread_getwakeboost_np.$(OBJEXT) \
+		pthread_setwakeboost_np.$(OBJEXT) \
+		pthread_setsoftaffinity_np.$(OBJEXT) \
+		pthread_getstats_np.$(OBJEXT) \
+		pthread_getlibstats_np.$(OBJEXT) \
 		pthread_getschedparam.$(OBJEXT) \
 		pthread_getspecific.$(OBJEXT) \
+		pthread_getspecific_fast_np.$(OBJEXT) \
+		pthread_key_create_np.$(OBJEXT) \
+		pthread_setobjectalign_np.$(OBJEXT) \
+		pthread_getobjectalign_np.$(OBJEXT) \
+		pthread_setparam_np.$(OBJEXT) \
+		pthread_getthreadcache_np.$(OBJEXT) \
+		pthread_getthreadreuse_np.$(OBJEXT) \
+		pthread_gettimerslack_np.$(OBJEXT) \
+		pthread_getyieldmode_np.$(OBJEXT) \
 		pthread_getunique_np.$(OBJEXT) \
 		pthread_getw32threadhandle_np.$(OBJEXT) \
 		pthread_join.$(OBJEXT) \
 		pthread_timedjoin_np.$(OBJEXT) \
+		pthread_join_async_np.$(OBJEXT) \
+		pthread_mutex_lock_async_np.$(OBJEXT) \
+		pthread_cond_wait_async_np.$(OBJEXT) \
+		pthread_create_n_np.$(OBJEXT) \
+		pthread_join_n_np.$(OBJEXT) \
+		pthread_create_payload_np.$(OBJEXT) \
+		pthread_arena_alloc_np.$(OBJEXT) \
+		pthread_arena_reset_np.$(OBJEXT) \
 		pthread_tryjoin_np.$(OBJEXT) \
 		pthread_key_create.$(OBJEXT) \
 		pthread_key_delete.$(OBJEXT) \
 		pthread_kill.$(OBJEXT) \
+		pthread_lockstat_np.$(OBJEXT) \
+		pthread_lockprof_np.$(OBJEXT) \
+		pthread_dump_waitgraph_np.$(OBJEXT) \
+		pthread_flightrec_dump_np.$(OBJEXT) \
+		pthread_gethistograms_np.$(OBJEXT) \
+		pthread_lockwatch_np.$(OBJEXT) \
 		pthread_mutex_consistent.$(OBJEXT) \
 		pthread_mutex_destroy.$(OBJEXT) \
+		pthread_mutex_getdefaultspin_np.$(OBJEXT) \
 		pthread_mutex_init.$(OBJEXT) \
+		pthread_mutex_init_storage_np.$(OBJEXT) \
+		pthread_mutex_kind_np.$(OBJEXT) \
+		pthread_mutex_init_array_np.$(OBJEXT) \
+		pthread_mutex_destroy_array_np.$(OBJEXT) \
+		pthread_cond_init_array_np.$(OBJEXT) \
+		pthread_cond_destroy_array_np.$(OBJEXT) \
+		pthread_mutex_getprioceiling.$(OBJEXT) \
 		pthread_mutex_lock.$(OBJEXT) \
+		pthread_mutex_setprioceiling.$(OBJEXT) \
+		pthread_mutex_setdefaultspin_np.$(OBJEXT) \
 		pthread_mutex_timedlock.$(OBJEXT) \
 		pthread_mutex_trylock.$(OBJEXT) \
 		pthread_mutex_unlock.$(OBJEXT) \
 		pthread_mutexattr_destroy.$(OBJEXT) \
 		pthread_mutexattr_getkind_np.$(OBJEXT) \
 		pthread_mutexattr_getpshared.$(OBJEXT) \
+		pthread_mutexattr_getprioceiling.$(OBJEXT) \
+		pthread_mutexattr_getprotocol.$(OBJEXT) \
 		pthread_mutexattr_getrobust.$(OBJEXT) \
+		pthread_mutexattr_getspin_np.$(OBJEXT) \
+		pthread_condattr_setspin_np.$(OBJEXT) \
+		pthread_condattr_getspin_np.$(OBJEXT) \
+		pthread_condattr_setwakeorder_np.$(OBJEXT) \
+		pthread_condattr_getwakeorder_np.$(OBJEXT) \
+		pthread_mutexattr_getfairness_np.$(OBJEXT) \
 		pthread_mutexattr_gettype.$(OBJEXT) \
 		pthread_mutexattr_init.$(OBJEXT) \
 		pthread_mutexattr_setkind_np.$(OBJEXT) \
 		pthread_mutexattr_setpshared.$(OBJEXT) \
+		pthread_mutexattr_setprioceiling.$(OBJEXT) \
+		pthread_mutexattr_setprotocol.$(OBJEXT) \
 		pthread_mutexattr_setrobust.$(OBJEXT) \
+		pthread_mutexattr_setspin_np.$(OBJEXT) \
+		pthread_mutexattr_setfairness_np.$(OBJEXT) \
 		pthread_mutexattr_settype.$(OBJEXT) \
 		pthread_num_processors_np.$(OBJEXT) \
 		pthread_once.$(OBJEXT) \
+		pthread_once_np.$(OBJEXT) \
+		pthread_pool_create_np.$(OBJEXT) \
+		pthread_pool_destroy_np.$(OBJEXT) \
+		pthread_pool_submit_np.$(OBJEXT) \
+		pthread_pool_task_wait_np.$(OBJEXT) \
+		pthread_pool_wait_np.$(OBJEXT) \
+		pthread_pool_parallel_for_np.$(OBJEXT) \
+		pthread_pool_parallel_reduce_np.$(OBJEXT) \
+		pthread_setcputokens_np.$(OBJEXT) \
+		pthread_getcputokens_np.$(OBJEXT) \
+		pthread_cputokens_acquire_np.$(OBJEXT) \
+		pthread_queue_create_np.$(OBJEXT) \
+		pthread_queue_destroy_np.$(OBJEXT) \
+		pthread_queue_pop_np.$(OBJEXT) \
+		pthread_queue_push_np.$(OBJEXT) \
+		pthread_wsdeque_np.$(OBJEXT) \
+		pthread_spsc_create_np.$(OBJEXT) \
+		pthread_spsc_destroy_np.$(OBJEXT) \
+		pthread_spsc_pop_np.$(OBJEXT) \
+		pthread_spsc_push_np.$(OBJEXT) \
+		pthread_lockstripe_create_np.$(OBJEXT) \
+		pthread_lockstripe_destroy_np.$(OBJEXT) \
+		pthread_lockstripe_lock_np.$(OBJEXT) \
+		pthread_lockstripe_unlock_np.$(OBJEXT) \
+		pthread_seqlock_init_np.$(OBJEXT) \
+		pthread_seqlock_destroy_np.$(OBJEXT) \
+		pthread_seqlock_read_np.$(OBJEXT) \
+		pthread_seqlock_write_np.$(OBJEXT) \
+		pthread_rwspin_init_np.$(OBJEXT) \
+		pthread_rwspin_destroy_np.$(OBJEXT) \
+		pthread_rwspin_rdlock_np.$(OBJEXT) \
+		pthread_rwspin_wrlock_np.$(OBJEXT) \
+		pthread_rwspin_unlock_np.$(OBJEXT) \
+		pthread_mcs_lock_np.$(OBJEXT) \
+		pthread_percpu_create_np.$(OBJEXT) \
+		pthread_percpu_destroy_np.$(OBJEXT) \
+		pthread_percpu_slot_np.$(OBJEXT) \
+		pthread_counter_add_np.$(OBJEXT) \
+		pthread_counter_destroy_np.$(OBJEXT) \
+		pthread_counter_init_np.$(OBJEXT) \
+		pthread_counter_read_np.$(OBJEXT) \
+		pthread_rcu_online_np.$(OBJEXT) \
+		pthread_io_begin_np.$(OBJEXT) \
+		pthread_rcu_synchronize_np.$(OBJEXT) \
+		pthread_call_rcu_np.$(OBJEXT) \
+		pthread_hazard_protect_np.$(OBJEXT) \
+		pthread_hazard_retire_np.$(OBJEXT) \
+		pthread_wait_on_address_np.$(OBJEXT) \
+		pthread_wake_np.$(OBJEXT) \
+		pthread_waitany_np.$(OBJEXT) \
 		pthread_rwlock_destroy.$(OBJEXT) \
 		pthread_rwlock_init.$(OBJEXT) \
 		pthread_rwlock_rdlock.$(OBJEXT) \
@@ -96,8 +233,15 @@ STATIC_OBJS	= \
 		pthread_rwlock_unlock.$(OBJEXT) \
 		pthread_rwlock_wrlock.$(OBJEXT) \
 		pthread_rwlockattr_destroy.$(OBJEXT) \
+		pthread_rwlockattr_getdistributed_np.$(OBJEXT) \
+		pthread_rwlockattr_getkind_np.$(OBJEXT) \
+		pthread_rwlock_downgrade_np.$(OBJEXT) \
+		pthread_rwlock_rdlock_upgradable_np.$(OBJEXT) \
+		pthread_rwlock_upgrade_np.$(OBJEXT) \
 		pthread_rwlockattr_getpshared.$(OBJEXT) \
 		pthread_rwlockattr_init.$(OBJEXT) \
+		pthread_rwlockattr_setdistributed_np.$(OBJEXT) \
+		pthread_rwlockattr_setkind_np.$(OBJEXT) \
 		pthread_rwlockattr_setpshared.$(OBJEXT) \
 		pthread_self.$(OBJEXT) \
 		pthread_setaffinity.$(OBJEXT) \
@@ -107,40 +251,105 @@ STATIC_OBJS	= \
 		pthread_setname_np.$(OBJEXT) \
 		pthread_setschedparam.$(OBJEXT) \
 		pthread_setspecific.$(OBJEXT) \
+		pthread_setthreadcache_np.$(OBJEXT) \
+		pthread_setthreadreuse_np.$(OBJEXT) \
+		pthread_settimerslack_np.$(OBJEXT) \
+		pthread_setyieldmode_np.$(OBJEXT) \
 		pthread_spin_destroy.$(OBJEXT) \
 		pthread_spin_init.$(OBJEXT) \
+		pthread_spin_init_np.$(OBJEXT) \
+		pthread_spin_init_storage_np.$(OBJEXT) \
+		pthread_spin_init_array_np.$(OBJEXT) \
+		pthread_spin_destroy_array_np.$(OBJEXT) \
 		pthread_spin_lock.$(OBJEXT) \
 		pthread_spin_trylock.$(OBJEXT) \
 		pthread_spin_unlock.$(OBJEXT) \
 		pthread_testcancel.$(OBJEXT) \
 		pthread_timechange_handler_np.$(OBJEXT) \
+		pthread_topology_np.$(OBJEXT) \
 		pthread_win32_attach_detach_np.$(OBJEXT) \
 		ptw32_MCS_lock.$(OBJEXT) \
+		ptw32_affinity.$(OBJEXT) \
+		ptw32_barrier_tree.$(OBJEXT) \
 		ptw32_callUserDestroyRoutines.$(OBJEXT) \
 		ptw32_calloc.$(OBJEXT) \
 		ptw32_cond_check_need_init.$(OBJEXT) \
+		ptw32_etw.$(OBJEXT) \
+		ptw32_perf.$(OBJEXT) \
 		ptw32_getprocessors.$(OBJEXT) \
+		ptw32_spin_calibrate.$(OBJEXT) \
+		ptw32_implicit.$(OBJEXT) \
 		ptw32_is_attr.$(OBJEXT) \
+		ptw32_lockstat.$(OBJEXT) \
+		ptw32_lockprof.$(OBJEXT) \
+		ptw32_lock_elide.$(OBJEXT) \
+		ptw32_lockwatch.$(OBJEXT) \
 		ptw32_mutex_check_need_init.$(OBJEXT) \
+		ptw32_mutex_init.$(OBJEXT) \
+		ptw32_cond_init.$(OBJEXT) \
+		ptw32_mutex_spin.$(OBJEXT) \
+		ptw32_cond_spin.$(OBJEXT) \
+		ptw32_mutex_fair.$(OBJEXT) \
+		ptw32_mutex_cohort.$(OBJEXT) \
+		ptw32_mutex_prio.$(OBJEXT) \
+		ptw32_mutex_wait.$(OBJEXT) \
 		ptw32_new.$(OBJEXT) \
+		ptw32_object_alloc.$(OBJEXT) \
+		ptw32_largepage.$(OBJEXT) \
+		ptw32_park.$(OBJEXT) \
+		ptw32_async.$(OBJEXT) \
+		ptw32_pool.$(OBJEXT) \
+		ptw32_cputokens.$(OBJEXT) \
 		ptw32_processInitialize.$(OBJEXT) \
+		ptw32_cancel_initialize.$(OBJEXT) \
 		ptw32_processTerminate.$(OBJEXT) \
+		ptw32_pshared.$(OBJEXT) \
+		ptw32_pshared_barrier.$(OBJEXT) \
+		ptw32_pshared_cond.$(OBJEXT) \
+		ptw32_pshared_mutex.$(OBJEXT) \
+		ptw32_pshared_sem.$(OBJEXT) \
+		ptw32_queue.$(OBJEXT) \
+		ptw32_wsdeque.$(OBJEXT) \
+		ptw32_spsc.$(OBJEXT) \
+		ptw32_yield.$(OBJEXT) \
+		ptw32_rcu.$(OBJEXT) \
+		ptw32_hazard.$(OBJEXT) \
+		ptw32_waitgraph.$(OBJEXT) \
+		ptw32_flightrec.$(OBJEXT) \
+		ptw32_hist.$(OBJEXT) \
+		ptw32_waitany.$(OBJEXT) \
 		ptw32_relmillisecs.$(OBJEXT) \
 		ptw32_reuse.$(OBJEXT) \
 		ptw32_rwlock_cancelwrwait.$(OBJEXT) \
 		ptw32_rwlock_check_need_init.$(OBJEXT) \
+		ptw32_rwlock_policy.$(OBJEXT) \
+		ptw32_rwlock_readers.$(OBJEXT) \
+		ptw32_rwlock_srw.$(OBJEXT) \
+		ptw32_sem_unwait.$(OBJEXT) \
+		ptw32_sem_fifo.$(OBJEXT) \
+		ptw32_sem_release.$(OBJEXT) \
 		ptw32_semwait.$(OBJEXT) \
 		ptw32_spinlock_check_need_init.$(OBJEXT) \
+		ptw32_rwspin.$(OBJEXT) \
+		ptw32_spinlock_init.$(OBJEXT) \
+		ptw32_threadCache.$(OBJEXT) \
+		ptw32_threadPool.$(OBJEXT) \
+		ptw32_libstats.$(OBJEXT) \
+		ptw32_fiber.$(OBJEXT) \
 		ptw32_threadDestroy.$(OBJEXT) \
 		ptw32_threadStart.$(OBJEXT) \
 		ptw32_throw.$(OBJEXT) \
 		ptw32_timespec.$(OBJEXT) \
-		ptw32_tkAssocCreate.$(OBJEXT) \
-		ptw32_tkAssocDestroy.$(OBJEXT) \
+		ptw32_topology.$(OBJEXT) \
+		ptw32_tsd_table.$(OBJEXT) \
+		ptw32_wait_timer.$(OBJEXT) \
+		ptw32_timer.$(OBJEXT) \
+		ptw32_timer_wheel.$(OBJEXT) \
 		sched_get_priority_max.$(OBJEXT) \
 		sched_get_priority_min.$(OBJEXT) \
 		sched_getscheduler.$(OBJEXT) \
 		sched_setaffinity.$(OBJEXT) \
+		sched_getcpu.$(OBJEXT) \
 		sched_setscheduler.$(OBJEXT) \
 		sched_yield.$(OBJEXT) \
 		sem_close.$(OBJEXT) \
@@ -154,46 +363,120 @@ STATIC_OBJS	= \
 		sem_trywait.$(OBJEXT) \
 		sem_unlink.$(OBJEXT) \
 		sem_wait.$(OBJEXT) \
+		sem_wait_multiple_np.$(OBJEXT) \
+		sem_wait_async_np.$(OBJEXT) \
 		signal.$(OBJEXT) \
+		timer_create.$(OBJEXT) \
+		timer_delete.$(OBJEXT) \
+		timer_getoverrun.$(OBJEXT) \
+		timer_gettime.$(OBJEXT) \
+		timer_settime.$(OBJEXT) \
 		w32_CancelableWait.$(OBJEXT)
 
 PTHREAD_SRCS	= \
 		ptw32_MCS_lock.c \
 		ptw32_is_attr.c \
 		ptw32_processInitialize.c \
+		ptw32_cancel_initialize.c \
 		ptw32_processTerminate.c \
 		ptw32_threadStart.c \
 		ptw32_threadDestroy.c \
-		ptw32_tkAssocCreate.c \
-		ptw32_tkAssocDestroy.c \
+		ptw32_tsd_table.c \
 		ptw32_callUserDestroyRoutines.c \
 		ptw32_semwait.c \
+		ptw32_sem_unwait.c \
+		ptw32_sem_fifo.c \
+		ptw32_sem_release.c \
 		ptw32_timespec.c \
 		ptw32_throw.c \
 		ptw32_getprocessors.c \
+		ptw32_spin_calibrate.c \
+		ptw32_affinity.c \
+		ptw32_topology.c \
 		ptw32_calloc.c \
 		ptw32_new.c \
+		ptw32_implicit.c \
 		ptw32_reuse.c \
+		ptw32_threadCache.c \
+		ptw32_threadPool.c \
+		ptw32_libstats.c \
+		ptw32_fiber.c \
 		ptw32_relmillisecs.c \
+		ptw32_wait_timer.c \
+		ptw32_timer_wheel.c \
+		ptw32_timer.c \
 		ptw32_cond_check_need_init.c \
 		ptw32_mutex_check_need_init.c \
+		ptw32_mutex_init.c \
+		ptw32_cond_init.c \
+		ptw32_object_alloc.c \
+		ptw32_largepage.c \
+		ptw32_mutex_spin.c \
+		ptw32_cond_spin.c \
+		ptw32_mutex_fair.c \
+		ptw32_mutex_cohort.c \
+		ptw32_mutex_prio.c \
+		ptw32_mutex_wait.c \
 		ptw32_rwlock_check_need_init.c \
 		ptw32_rwlock_cancelwrwait.c \
+		ptw32_rwlock_readers.c \
+		ptw32_rwlock_policy.c \
+		ptw32_rwlock_srw.c \
+		ptw32_barrier_tree.c \
+		ptw32_park.c \
+		ptw32_async.c \
+		ptw32_lockstat.c \
+		ptw32_lockprof.c \
+		ptw32_lock_elide.c \
+		ptw32_etw.c \
+		ptw32_perf.c \
+		ptw32_lockwatch.c \
+		ptw32_pool.c \
+		ptw32_cputokens.c \
+		ptw32_queue.c \
+		ptw32_wsdeque.c \
+		ptw32_spsc.c \
+		ptw32_yield.c \
+		ptw32_rcu.c \
+		ptw32_hazard.c \
+		ptw32_waitgraph.c \
+		ptw32_flightrec.c \
+		ptw32_hist.c \
+		ptw32_waitany.c \
+		ptw32_pshared.c \
+		ptw32_pshared_mutex.c \
+		ptw32_pshared_cond.c \
+		ptw32_pshared_sem.c \
+		ptw32_pshared_barrier.c \
 		ptw32_spinlock_check_need_init.c \
+		ptw32_rwspin.c \
+		ptw32_spinlock_init.c \
 		pthread_attr_init.c \
 		pthread_attr_destroy.c \
 		pthread_attr_getaffinity_np.c \
 		pthread_attr_setaffinity_np.c \
+		pthread_attr_getnumanode_np.c \
+		pthread_attr_setnumanode_np.c \
+		pthread_attr_getqos_np.c \
+		pthread_attr_setqos_np.c \
+		pthread_attr_getpooled_np.c \
+		pthread_attr_setpooled_np.c \
+		pthread_attr_getstackcommit_np.c \
+		pthread_attr_setstackcommit_np.c \
 		pthread_attr_getdetachstate.c \
 		pthread_attr_setdetachstate.c \
 		pthread_attr_getname_np.c \
 		pthread_attr_setname_np.c \
 		pthread_attr_getscope.c \
 		pthread_attr_setscope.c \
+		pthread_attr_getstack.c \
 		pthread_attr_getstackaddr.c \
+		pthread_attr_setstack.c \
 		pthread_attr_setstackaddr.c \
 		pthread_attr_getstacksize.c \
 		pthread_attr_setstacksize.c \
+		pthread_attr_getguardsize.c \
+		pthread_attr_setguardsize.c \
 		pthread_barrier_init.c \
 		pthread_barrier_destroy.c \
 		pthread_barrier_wait.c \
@@ -206,8 +489,10 @@ PTHREAD_SRCS	= \
 		pthread_testcancel.c \
 		pthread_cancel.c \
 		pthread_condattr_destroy.c \
+		pthread_condattr_getclock.c \
 		pthread_condattr_getpshared.c \
 		pthread_condattr_init.c \
+		pthread_condattr_setclock.c \
 		pthread_condattr_setpshared.c \
 		pthread_cond_destroy.c \
 		pthread_cond_init.c \
@@ -237,6 +522,12 @@ PTHREAD_SRCS	= \
 		pthread_mutexattr_gettype.c \
 		pthread_mutexattr_setrobust.c \
 		pthread_mutexattr_getrobust.c \
+		pthread_mutexattr_setprotocol.c \
+		pthread_mutexattr_getprotocol.c \
+		pthread_mutexattr_setprioceiling.c \
+		pthread_mutexattr_getprioceiling.c \
+		pthread_mutex_setprioceiling.c \
+		pthread_mutex_getprioceiling.c \
 		pthread_mutex_lock.c \
 		pthread_mutex_timedlock.c \
 		pthread_mutex_unlock.c \
@@ -244,10 +535,131 @@ PTHREAD_SRCS	= \
 		pthread_mutex_consistent.c \
 		pthread_mutexattr_setkind_np.c \
 		pthread_mutexattr_getkind_np.c \
+		pthread_mutexattr_setspin_np.c \
+		pthread_mutexattr_getspin_np.c \
+		pthread_condattr_setspin_np.c \
+		pthread_condattr_getspin_np.c \
+		pthread_condattr_setwakeorder_np.c \
+		pthread_condattr_getwakeorder_np.c \
+		pthread_mutexattr_setfairness_np.c \
+		pthread_mutexattr_getfairness_np.c \
+		pthread_mutex_setdefaultspin_np.c \
+		pthread_mutex_init_storage_np.c \
+		pthread_mutex_kind_np.c \
+		pthread_mutex_init_array_np.c \
+		pthread_mutex_destroy_array_np.c \
+		pthread_cond_init_array_np.c \
+		pthread_cond_destroy_array_np.c \
+		pthread_mutex_getdefaultspin_np.c \
+		pthread_setthreadcache_np.c \
+		pthread_getthreadcache_np.c \
+		pthread_setthreadreuse_np.c \
+		pthread_getthreadreuse_np.c \
+		pthread_settimerslack_np.c \
+		pthread_gettimerslack_np.c \
+		pthread_setobjectalign_np.c \
+		pthread_getobjectalign_np.c \
+		pthread_setparam_np.c \
+		pthread_rwlockattr_setdistributed_np.c \
+		pthread_rwlockattr_getdistributed_np.c \
+		pthread_rwlockattr_setkind_np.c \
+		pthread_rwlockattr_getkind_np.c \
+		pthread_rwlock_downgrade_np.c \
+		pthread_rwlock_rdlock_upgradable_np.c \
+		pthread_rwlock_upgrade_np.c \
+		pthread_spin_init_np.c \
+		pthread_spin_init_storage_np.c \
+		pthread_spin_init_array_np.c \
+		pthread_spin_destroy_array_np.c \
+		pthread_barrierattr_setkind_np.c \
+		pthread_barrierattr_getkind_np.c \
+		pthread_barrier_arrive_np.c \
+		pthread_latch_init_np.c \
+		pthread_latch_destroy_np.c \
+		pthread_latch_wait_np.c \
+		pthread_phaser_init_np.c \
+		pthread_phaser_destroy_np.c \
+		pthread_phaser_arrive_np.c \
+		pthread_group_create_np.c \
+		pthread_group_destroy_np.c \
+		pthread_group_add_np.c \
+		pthread_group_cancel_np.c \
+		pthread_group_join_np.c \
+		pthread_group_setaffinity_np.c \
+		pthread_group_setschedparam_np.c \
 		pthread_getw32threadhandle_np.c \
 		pthread_getunique_np.c \
+		pthread_once_np.c \
+		pthread_getspecific_fast_np.c \
+		pthread_key_create_np.c \
+		pthread_pool_create_np.c \
+		pthread_pool_destroy_np.c \
+		pthread_pool_submit_np.c \
+		pthread_pool_task_wait_np.c \
+		pthread_pool_wait_np.c \
+		pthread_pool_parallel_for_np.c \
+		pthread_pool_parallel_reduce_np.c \
+		pthread_setcputokens_np.c \
+		pthread_getcputokens_np.c \
+		pthread_cputokens_acquire_np.c \
+		pthread_queue_create_np.c \
+		pthread_queue_destroy_np.c \
+		pthread_queue_pop_np.c \
+		pthread_queue_push_np.c \
+		pthread_wsdeque_np.c \
+		pthread_spsc_create_np.c \
+		pthread_spsc_destroy_np.c \
+		pthread_spsc_pop_np.c \
+		pthread_spsc_push_np.c \
+		pthread_lockstripe_create_np.c \
+		pthread_lockstripe_destroy_np.c \
+		pthread_lockstripe_lock_np.c \
+		pthread_lockstripe_unlock_np.c \
+		pthread_seqlock_init_np.c \
+		pthread_seqlock_destroy_np.c \
+		pthread_seqlock_read_np.c \
+		pthread_seqlock_write_np.c \
+		pthread_rwspin_init_np.c \
+		pthread_rwspin_destroy_np.c \
+		pthread_rwspin_rdlock_np.c \
+		pthread_rwspin_wrlock_np.c \
+		pthread_rwspin_unlock_np.c \
+		pthread_mcs_lock_np.c \
+		pthread_percpu_create_np.c \
+		pthread_percpu_destroy_np.c \
+		pthread_percpu_slot_np.c \
+		pthread_counter_add_np.c \
+		pthread_counter_destroy_np.c \
+		pthread_counter_init_np.c \
+		pthread_counter_read_np.c \
+		pthread_rcu_online_np.c \
+		pthread_io_begin_np.c \
+		pthread_rcu_synchronize_np.c \
+		pthread_call_rcu_np.c \
+		pthread_hazard_protect_np.c \
+		pthread_hazard_retire_np.c \
+		pthread_wait_on_address_np.c \
+		pthread_wake_np.c \
+		pthread_waitany_np.c \
 		pthread_setaffinity.c \
+		pthread_getnumanode_np.c \
+		pthread_getqos_np.c \
+		pthread_setqos_np.c \
+		pthread_getwakeboost_np.c \
+		pthread_setwakeboost_np.c \
+		pthread_setsoftaffinity_np.c \
+		pthread_getstats_np.c \
+		pthread_getlibstats_np.c \
+		pthread_topology_np.c \
+		pthread_lockstat_np.c \
+		pthread_lockprof_np.c \
+		pthread_dump_waitgraph_np.c \
+		pthread_flightrec_dump_np.c \
+		pthread_gethistograms_np.c \
+		pthread_lockwatch_np.c \
 		pthread_delay_np.c \
+		pthread_setyieldmode_np.c \
+		pthread_getyieldmode_np.c \
 		pthread_num_processors_np.c \
 		pthread_win32_attach_detach_np.c \
 		pthread_timechange_handler_np.c \
@@ -280,6 +692,16 @@ PTHREAD_SRCS	= \
 		sched_getscheduler.c \
 		sched_yield.c \
 		sched_setaffinity.c \
+		sched_getcpu.c \
+		clock_gettime.c \
+		clock_getres.c \
+		nanosleep.c \
+		pthread_getcpuclockid.c \
+		timer_create.c \
+		timer_delete.c \
+		timer_settime.c \
+		timer_gettime.c \
+		timer_getoverrun.c \
 		sem_init.c \
 		sem_destroy.c \
 		sem_trywait.c \
@@ -287,6 +709,8 @@ PTHREAD_SRCS	= \
 		sem_wait.c \
 		sem_post.c \
 		sem_post_multiple.c \
+		sem_wait_multiple_np.c \
+		sem_wait_async_np.c \
 		sem_getvalue.c \
 		sem_open.c \
 		sem_close.c \
@@ -299,6 +723,14 @@ PTHREAD_SRCS	= \
 		pthread_detach.c \
 		pthread_join.c \
 		pthread_timedjoin_np.c \
+		pthread_join_async_np.c \
+		pthread_mutex_lock_async_np.c \
+		pthread_cond_wait_async_np.c \
+		pthread_create_n_np.c \
+		pthread_join_n_np.c \
+		pthread_create_payload_np.c \
+		pthread_arena_alloc_np.c \
+		pthread_arena_reset_np.c \
 		pthread_tryjoin_np.c \
 		pthread_key_create.c \
 		pthread_key_delete.c \
@@ -310,6 +742,8 @@ INCL		= \
 		implement.h \
 		need_errno.h \
 		pthread.h \
+		pthread_async_np.hpp \
+		pthread_mutex_np.hpp \
 		semaphore.h \
 		need_errno.h
 
@@ -43,6 +43,8 @@
 #include "pthread_condattr_destroy.c"
 #include "pthread_condattr_getpshared.c"
 #include "pthread_condattr_setpshared.c"
+#include "pthread_condattr_getclock.c"
+#include "pthread_condattr_setclock.c"
 #include "pthread_cond_init.c"
 #include "pthread_cond_destroy.c"
 #include "pthread_cond_wait.c"
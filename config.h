@@ -63,6 +63,25 @@
 /* Define if you don't have the GetProcessAffinityMask() */
 #undef NEED_PROCESS_AFFINITY_MASK
 
+/*
+ * Define if you don't want threads to park on addresses at all. By
+ * default the library looks for WaitOnAddress() (Windows 8 and later)
+ * at run time and otherwise uses its own parking lot (ptw32_park.c);
+ * either way non-robust mutexes park waiters on the mutex lock word
+ * instead of using a per-mutex event.
+ */
+#undef NEED_WAITONADDRESS
+
+/*
+ * Define to build condition variables on a sequence counter that waiters
+ * park on with WaitOnAddress(), instead of the three-semaphore algorithm.
+ * Signal and broadcast with no waiters then never enter the kernel.
+ * Condition variables initialised when the library doesn't park on
+ * addresses (NEED_WAITONADDRESS) still use the semaphores. Define it
+ * here or on the compiler command line.
+ */
+/* #define PTW32_COND_WAITONADDRESS */
+
 /* Define if your version of Windows TLSGetValue() clears WSALastError
  * and calling SetLastError() isn't enough restore it. You'll also need to
  * link against wsock32.lib (or libwsock32.a for MinGW).
@@ -121,6 +140,7 @@
 /* #define NEED_SEM */
 #define NEED_UNICODE_CONSTS
 #define NEED_PROCESS_AFFINITY_MASK
+#define NEED_WAITONADDRESS
 /* This may not be needed */
 #define RETAIN_WSALASTERROR
 #endif
@@ -40,6 +40,7 @@
 # include <config.h>
 #endif
 
+#include <string.h>
 #include "pthread.h"
 #include "implement.h"
 #if ! defined(_UWIN) && ! defined(WINCE)
@@ -47,17 +48,17 @@
 #endif
 
 int
-pthread_create (pthread_t * tid,
+ptw32_create (pthread_t * tid,
     const pthread_attr_t * attr,
-    void *(PTW32_CDECL *start) (void *), void *arg)
+    void *(PTW32_CDECL *start) (void *), void *arg,
+    const void * payload, size_t size)
 /*
  * ------------------------------------------------------
- * DOCPUBLIC
- *      This function creates a thread running the start function,
- *      passing it the parameter value, 'arg'. The 'attr'
- *      argument specifies optional creation attributes.
- *      The identity of the new thread is returned
- *      via 'tid', which should not be NULL.
+ * DOCPRIVATE
+ *      pthread_create() and pthread_create_payload_np(): creates
+ *      a thread running the start function, passing it 'arg', or
+ *      if 'size' isn't 0 a copy of the 'size' bytes at 'payload'
+ *      made in the thread struct.
  *
  * PARAMETERS
  *      tid
@@ -72,6 +73,12 @@ pthread_create (pthread_t * tid,
  *      arg
  *              optional parameter passed to 'start'
  *
+ *      payload
+ *              bytes to copy for 'start' in place of 'arg'
+ *
+ *      size
+ *              their number, at most PTHREAD_PAYLOAD_MAX_NP, or 0
+ *
  *
  * DESCRIPTION
  *      This function creates a thread running the start function,
@@ -82,7 +89,9 @@ pthread_create (pthread_t * tid,
  *
  * RESULTS
  *              0               successfully created thread,
- *              EINVAL          attr invalid,
+ *              EINVAL          attr invalid, its stack too small, or
+ *                              a stack given for a PTHREAD_SCOPE_PROCESS
+ *                              thread,
  *              EAGAIN          insufficient resources.
  *
  * ------------------------------------------------------
@@ -96,8 +105,11 @@ pthread_create (pthread_t * tid,
   int result = EAGAIN;
   int run = PTW32_TRUE;
   ThreadParms *parms = NULL;
+  ptw32_parked_thread_t * pt = NULL;
   unsigned int stackSize;
+  int stackReserve = PTW32_FALSE;
   int priority;
+  int policy;
 
   /*
    * Before doing anything, check that tid can be stored through
@@ -112,7 +124,7 @@ pthread_create (pthread_t * tid,
       goto FAIL0;
     }
 
-  if (attr != NULL)
+  if (attr != NULL && !PTW32_ATTR_IS_INITIALIZER (*attr))
     {
       a = *attr;
     }
@@ -130,15 +142,25 @@ pthread_create (pthread_t * tid,
   tp = (ptw32_thread_t *) thread.p;
 
   priority = tp->sched_priority;
+  policy = tp->sched_policy;
+  tp->wakeBoost = ptw32_wakeBoost;
 
-  if ((parms = (ThreadParms *) malloc (sizeof (*parms))) == NULL)
-    {
-      goto FAIL0;
-    }
-
+  /*
+   * The parameters live in the thread struct, which is recycled,
+   * so creating a thread needs no allocation of its own.
+   */
+  parms = &tp->parms;
   parms->tid = thread;
   parms->start = start;
   parms->arg = arg;
+  if (size > 0)
+    {
+      memcpy (tp->payload, payload, size);
+      parms->arg = tp->payload;
+    }
+  parms->stackAddr = NULL;
+  parms->stackCommit = 0;
+  parms->stackGuard = 0;
 
   /*
    * Threads inherit their initial sigmask and CPU affinity from their creator thread.
@@ -147,27 +169,137 @@ pthread_create (pthread_t * tid,
   tp->sigmask = sp->sigmask;
 #endif
 #if defined(HAVE_CPU_AFFINITY)
+  if (sp->implicit && 0 == CPU_COUNT(&sp->cpuset))
+    {
+      ptw32_implicit_affinity (sp);
+    }
   tp->cpuset = sp->cpuset;
 #endif
 
   if (a != NULL)
     {
 #if defined(HAVE_CPU_AFFINITY)
-      cpu_set_t none;
-      cpu_set_t attr_cpuset;
-      ((_sched_cpu_set_vector_*)&attr_cpuset)->_cpuset = a->cpuset;
-
-      CPU_ZERO(&none);
-      if (! CPU_EQUAL(&attr_cpuset, &none))
+      if (CPU_COUNT(&a->cpuset) > 0)
         {
           tp->cpuset = a->cpuset;
         }
+      if (a->numanode >= 0)
+        {
+          /*
+           * Restrict the thread to the node, keeping any CPU set
+           * from the attributes that it overlaps.
+           */
+          ptw32_topology_t * topology = ptw32_gettopology ();
+
+          if (topology != NULL)
+            {
+              cpu_set_t nodeCpuset;
+              cpu_set_t common;
+
+              ptw32_topologycpus (topology->node, a->numanode, &nodeCpuset);
+              CPU_AND(&common, &nodeCpuset, &tp->cpuset);
+              if (CPU_COUNT(&a->cpuset) > 0 && CPU_COUNT(&common) > 0)
+                {
+                  tp->cpuset = common;
+                }
+              else if (CPU_COUNT(&nodeCpuset) > 0)
+                {
+                  tp->cpuset = nodeCpuset;
+                }
+            }
+        }
+      if (PTHREAD_QOS_DEFAULT_NP != a->qos)
+        {
+          /*
+           * On a hybrid machine, keep the thread to the cores of the
+           * fastest or of the most efficient class that its CPU set
+           * includes, if it does.
+           */
+          ptw32_topology_t * topology = ptw32_gettopology ();
+
+          if (topology != NULL && topology->nClasses > 1)
+            {
+              cpu_set_t classCpuset;
+              cpu_set_t common;
+
+              ptw32_topologycpus (topology->efficiency,
+                                  (PTHREAD_QOS_HIGH_NP == a->qos ? topology->nClasses - 1 : 0),
+                                  &classCpuset);
+              CPU_AND(&common, &classCpuset, &tp->cpuset);
+              if (CPU_COUNT(&common) > 0)
+                {
+                  tp->cpuset = common;
+                }
+              else if (0 == CPU_COUNT(&tp->cpuset))
+                {
+                  tp->cpuset = classCpuset;
+                }
+            }
+        }
 #endif
+      tp->qos = a->qos;
       stackSize = (unsigned int)a->stacksize;
+
+      /*
+       * The stack size is only reserved, and the thread commits its
+       * stack as it grows into it. A commit of at least that size is
+       * passed as the size to commit instead, which reserves at
+       * least as much; a smaller one ptw32_threadStart commits.
+       */
+      if (a->stackcommit >= a->stacksize && a->stackcommit > 0)
+        {
+          stackSize = (unsigned int)a->stackcommit;
+        }
+      else
+        {
+          stackReserve = (stackSize != 0);
+          parms->stackCommit = a->stackcommit;
+        }
+
+#if defined( _POSIX_THREAD_ATTR_STACKADDR ) && _POSIX_THREAD_ATTR_STACKADDR != -1
+      if (a->stackaddr != NULL)
+        {
+          /*
+           * The thread runs on the caller's stack, so the OS thread
+           * needs only a small one of its own.
+           */
+          if (a->stacksize < PTW32_STACKADDR_MIN)
+            {
+              result = EINVAL;
+              goto FAIL0;
+            }
+
+          parms->stackAddr = a->stackaddr;
+          parms->stackBytes = a->stacksize;
+          parms->stackCommit = 0;
+          stackSize = PTW32_STACKADDR_OS_RESERVE;
+          stackReserve = PTW32_TRUE;
+        }
+#endif
+
+      /*
+       * The system keeps one guard page. A larger guard is kept as
+       * the thread's stack guarantee, reserved on top of the stack
+       * size so as not to take from it.
+       */
+      if (a->guardsize > PTW32_STACK_PAGE && parms->stackAddr == NULL
+          && ptw32_setthreadstackguarantee != NULL)
+        {
+          parms->stackGuard = (ULONG) a->guardsize;
+          if (stackReserve)
+            {
+              stackSize += (unsigned int) a->guardsize;
+            }
+        }
+
       tp->detachState = a->detachstate;
       priority = a->param.sched_priority;
+      policy = a->schedpolicy;
       if (a->thrname != NULL)
-        tp->name = _strdup(a->thrname);
+        {
+          strncpy (tp->name, a->thrname, sizeof (tp->name) - 1);
+          tp->name[sizeof (tp->name) - 1] = '\0';
+        }
 
 #if (THREAD_PRIORITY_LOWEST > THREAD_PRIORITY_NORMAL)
       /* WinCE */
@@ -194,6 +326,7 @@ pthread_create (pthread_t * tid,
            * system adjustment. This is not the case for POSIX threads.
            */
           priority = sp->sched_priority;
+          policy = sp->sched_policy;
         }
 
 #endif
@@ -209,7 +342,46 @@ pthread_create (pthread_t * tid,
 
   tp->state = run ? PThreadStateInitial : PThreadStateSuspended;
 
-  tp->keys = NULL;
+  if (a != NULL && a->contentionscope == PTHREAD_SCOPE_PROCESS)
+    {
+      /*
+       * The thread is a fiber run by the fiber workers; it has no
+       * OS thread of its own. See ptw32_fiber.c.
+       */
+      tp->sched_priority = priority;
+      tp->sched_policy = policy;
+      result = (parms->stackAddr != NULL) ? EINVAL
+               : ptw32_fiber_create (tp, stackReserve ? stackSize : 0,
+                                     stackReserve ? parms->stackCommit : stackSize);
+      goto FAIL0;
+    }
+
+  /*
+   * A pooled thread runs as a thread pool work item; it has no OS
+   * thread of its own until the callback binds it to a worker. What
+   * the pool can't give a thread gets it an OS thread as below, as
+   * does a system without the pool API. See ptw32_threadPool.c.
+   */
+  if (a != NULL && a->pooled && run
+      && PTHREAD_CREATE_DETACHED == a->detachstate
+      && 0 == a->stacksize
+      && 0 == a->stackcommit
+      && 0 == parms->stackGuard
+      && NULL == parms->stackAddr
+      && PTHREAD_QOS_DEFAULT_NP == a->qos
+#if defined(HAVE_CPU_AFFINITY)
+      && 0 == CPU_COUNT(&a->cpuset)
+      && a->numanode < 0
+#endif
+      )
+    {
+      tp->sched_priority = priority;
+      tp->sched_policy = policy;
+      if (0 == (result = ptw32_threadPoolStart (tp)))
+        {
+          goto FAIL0;
+        }
+    }
 
   /*
    * Threads must be started in suspended mode and resumed if necessary
@@ -222,32 +394,116 @@ pthread_create (pthread_t * tid,
 
 #if ! defined (PTW32_CONFIG_MINGW) || defined (__MSVCRT__) || defined (__DMC__)
 
-  tp->threadH =
-      threadH =
-          (HANDLE) _beginthreadex ((void *) NULL,	/* No security info             */
-              stackSize,		/* default stack size   */
-              ptw32_threadStart,
-              parms,
-              (unsigned)
-              CREATE_SUSPENDED,
-              (unsigned *) &(tp->thread));
-
-  if (threadH != 0)
+  parms->stackSize = stackSize;
+
+  /*
+   * With the thread cache enabled the OS thread may park when this
+   * thread ends, so the end is signalled by the struct's exit event.
+   * Threads on a caller's stack aren't cached: the caller may only
+   * reuse the stack once the OS thread is gone.
+   */
+  if (ptw32_threadCacheMax > 0 && parms->stackAddr == NULL)
     {
-      if (a != NULL)
+      if (tp->exitEvent == NULL)
+        {
+          tp->exitEvent = ptw32_libstat_handle (CreateEvent (NULL, PTW32_TRUE, PTW32_FALSE, NULL),
+                                                 PTW32_LIBSTAT_EVENTS);
+        }
+      else
         {
-          (void) ptw32_setthreadpriority (thread, SCHED_OTHER, priority);
+          (void) ResetEvent (tp->exitEvent);
         }
 
+      tp->cached = (tp->exitEvent != NULL);
+    }
+
+  if (run && tp->cached
+#if defined(HAVE_CPU_AFFINITY)
+      && CPU_COUNT(&tp->cpuset) > 0
+#endif
+      && (stackReserve || 0 == stackSize)
+      && (pt = ptw32_threadCacheUnpark (stackSize)) != NULL)
+    {
+      /*
+       * A parked OS thread runs this thread. The thread that ran
+       * on it last may have changed its priority, QoS, wake boost,
+       * name and (soft) affinity, so all are set whatever the
+       * attributes.
+       */
+      tp->threadH = threadH = pt->threadH;
+      tp->thread = pt->thread;
+
+      (void) ptw32_setthreadpriority (thread, policy, priority);
+      ptw32_setthreadqos (threadH, tp->qos);
+      ptw32_setthreadwakeboost (threadH, tp->wakeBoost);
+      ptw32_setthreadname (tp);
+
 #if defined(HAVE_CPU_AFFINITY)
+      (void) ptw32_setthreadaffinity (threadH, &tp->cpuset, PTW32_TRUE);
+      (void) ptw32_setthreadsoftaffinity (threadH, &tp->softCpuset);
+#endif
 
-      SetThreadAffinityMask(tp->threadH, tp->cpuset);
+      pt->parms = parms;
+      (void) PTW32_SETEVENT (pt->wakeEvent);
+    }
+  else
+    {
+      unsigned int createFlags = CREATE_SUSPENDED;
 
+#if defined(STACK_SIZE_PARAM_IS_A_RESERVATION)
+      if (stackReserve)
+        {
+          createFlags |= STACK_SIZE_PARAM_IS_A_RESERVATION;
+        }
 #endif
 
-      if (run)
+      tp->threadH =
+          threadH =
+              (HANDLE) _beginthreadex ((void *) NULL,	/* No security info             */
+                  stackSize,		/* default stack size   */
+                  ptw32_threadStart,
+                  parms,
+                  createFlags,
+                  (unsigned *) &(tp->thread));
+
+      if (threadH != 0)
         {
-          ResumeThread (threadH);
+          PTW32_LIBSTAT_ADD (PTW32_LIBSTAT_THREAD_HANDLES, 1);
+
+          if (a != NULL)
+            {
+              (void) ptw32_setthreadpriority (thread, policy, priority);
+            }
+
+          if (PTHREAD_QOS_DEFAULT_NP != tp->qos)
+            {
+              ptw32_setthreadqos (threadH, tp->qos);
+            }
+
+          if (!tp->wakeBoost)
+            {
+              ptw32_setthreadwakeboost (threadH, 0);
+            }
+
+          /* Named before it runs, so no trace sees it nameless */
+          if ('\0' != tp->name[0])
+            {
+              ptw32_setthreadname (tp);
+            }
+
+#if defined(HAVE_CPU_AFFINITY)
+
+          if (CPU_COUNT(&tp->cpuset) > 0)
+            {
+              (void) ptw32_setthreadaffinity (tp->threadH, &tp->cpuset, PTW32_TRUE);
+            }
+
+#endif
+
+          if (run)
+            {
+              ResumeThread (threadH);
+            }
         }
     }
 
@@ -288,12 +544,30 @@ pthread_create (pthread_t * tid,
 
         if (a != NULL)
           {
-            (void) ptw32_setthreadpriority (thread, SCHED_OTHER, priority);
+            (void) ptw32_setthreadpriority (thread, policy, priority);
+          }
+
+        if (PTHREAD_QOS_DEFAULT_NP != tp->qos)
+          {
+            ptw32_setthreadqos (threadH, tp->qos);
+          }
+
+        if (!tp->wakeBoost)
+          {
+            ptw32_setthreadwakeboost (threadH, 0);
+          }
+
+        if ('\0' != tp->name[0])
+          {
+            ptw32_setthreadname (tp);
           }
 
 #if defined(HAVE_CPU_AFFINITY)
 
-        SetThreadAffinityMask(tp->threadH, tp->cpuset);
+        if (CPU_COUNT(&tp->cpuset) > 0)
+          {
+            (void) ptw32_setthreadaffinity (tp->threadH, &tp->cpuset, PTW32_TRUE);
+          }
 
 #endif
 
@@ -321,15 +595,12 @@ pthread_create (pthread_t * tid,
 
       ptw32_threadDestroy (thread);
       tp = NULL;
-
-      if (parms != NULL)
-        {
-          free (parms);
-        }
     }
   else
     {
       *tid = thread;
+      PTW32_ETW_EVENT (PTW32_ETW_THREAD_CREATE, thread.p,
+                       ((ptw32_thread_t *) thread.p)->seqNumber);
     }
 
 #if defined(_UWIN)
@@ -337,4 +608,27 @@ pthread_create (pthread_t * tid,
     pthread_count++;
 #endif
   return (result);
+}				/* ptw32_create */
+
+
+int
+pthread_create (pthread_t * tid,
+    const pthread_attr_t * attr,
+    void *(PTW32_CDECL *start) (void *), void *arg)
+/*
+ * ------------------------------------------------------
+ * DOCPUBLIC
+ *      This function creates a thread running the start function,
+ *      passing it the parameter value, 'arg'. The 'attr'
+ *      argument specifies optional creation attributes.
+ *      The identity of the new thread is returned
+ *      via 'tid', which should not be NULL.
+ *
+ * RESULTS
+ *      as ptw32_create.
+ *
+ * ------------------------------------------------------
+ */
+{
+  return ptw32_create (tid, attr, start, arg, NULL, 0);
 }				/* pthread_create */
@@ -73,6 +73,17 @@ DllMain (HINSTANCE hinstDll, DWORD fdwReason, LPVOID lpvReserved)
 
     case DLL_PROCESS_ATTACH:
       result = pthread_win32_process_attach_np ();
+#if !defined(PTW32_STATIC_TLSLIB)
+      /*
+       * Thread exits are seen through FLS, so the loader needn't call
+       * us for every thread in the process. It refuses if the DLL has
+       * static TLS; the thread calls below then do nothing.
+       */
+      if (result && ptw32_flsIndex != FLS_OUT_OF_INDEXES)
+	{
+	  (void) DisableThreadLibraryCalls (hinstDll);
+	}
+#endif
       break;
 
     case DLL_THREAD_ATTACH:
@@ -86,7 +97,10 @@ DllMain (HINSTANCE hinstDll, DWORD fdwReason, LPVOID lpvReserved)
       /*
        * A thread is exiting cleanly
        */
-      result = pthread_win32_thread_detach_np ();
+      if (FLS_OUT_OF_INDEXES == ptw32_flsIndex)
+	{
+	  result = pthread_win32_thread_detach_np ();
+	}
       break;
 
     case DLL_PROCESS_DETACH:
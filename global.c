@@ -42,20 +42,180 @@
 int ptw32_processInitialized = PTW32_FALSE;
 ptw32_thread_t * ptw32_threadReuseTop = PTW32_THREAD_REUSE_EMPTY;
 ptw32_thread_t * ptw32_threadReuseBottom = PTW32_THREAD_REUSE_EMPTY;
+ptw32_thread_reuse_queue_t ptw32_threadReuseQueue;
+ptw32_thread_reuse_cpu_t ptw32_threadReuseCpus[PTW32_THREAD_REUSE_CPUS];
+
+/*
+ * Structs queued for reuse, and how many may be (-1: no limit; see
+ * pthread_setthreadreuse_np). New structs start their reuse counter
+ * at ptw32_threadReuseBase, which is kept past that of every struct
+ * freed, under ptw32_thread_reuse_lock.
+ */
+volatile LONG ptw32_threadReuseCount = 0;
+int ptw32_threadReuseMax = -1;
+unsigned int ptw32_threadReuseBase = 0;
 pthread_key_t ptw32_selfThreadKey = NULL;
-pthread_key_t ptw32_cleanupKey = NULL;
-pthread_cond_t ptw32_cond_list_head = NULL;
-pthread_cond_t ptw32_cond_list_tail = NULL;
+#if defined(PTW32_THREAD_LOCAL)
+PTW32_THREAD_LOCAL ptw32_thread_t * ptw32_selfThread = NULL;
+#endif
+ptw32_cond_list_t ptw32_cond_list[PTW32_COND_LIST_SHARDS];
 
 int ptw32_concurrency = 0;
 
+/*
+ * The policy given to sched_setscheduler() for this process while it
+ * runs in REALTIME_PRIORITY_CLASS, as Windows has one for both.
+ */
+int ptw32_schedPolicy = SCHED_RR;
+
+/* How sched_yield gives up the processor, PTHREAD_YIELD_*_NP */
+int ptw32_yield_mode = PTHREAD_YIELD_SWITCH_NP;
+
+/* See pthread_win32_set_fast_exit_np() */
+int ptw32_fastExit = PTW32_FALSE;
+
+/*
+ * Process wide mutex defaults. ptw32_mutex_default_spin is the
+ * spin budget given to mutexes that are initialised without an
+ * explicit pthread_mutexattr_setspin_np() value (0: don't spin).
+ */
+int ptw32_mutex_default_kind = PTHREAD_MUTEX_DEFAULT;
+int ptw32_mutex_default_spin = 0;
+
+/*
+ * What the PTHREAD_*ATTR_INITIALIZER_NP attribute objects hold; the
+ * same values as the *attr_init functions set.
+ */
+const struct pthread_attr_t_ ptw32_attr_default =
+{
+  PTW32_ATTR_VALID, NULL, 0, 0, PTW32_STACK_PAGE, PTHREAD_CREATE_JOINABLE,
+  {THREAD_PRIORITY_NORMAL}, SCHED_OTHER, PTHREAD_EXPLICIT_SCHED,
+  PTHREAD_SCOPE_SYSTEM, {{0}}, PTHREAD_QOS_DEFAULT_NP, -1, PTW32_FALSE, NULL
+};
+const struct pthread_mutexattr_t_ ptw32_mutexattr_default =
+{
+  PTHREAD_PROCESS_PRIVATE, PTHREAD_MUTEX_DEFAULT,
+  PTHREAD_MUTEX_STALLED, PTHREAD_MUTEX_SPIN_DEFAULT,
+  PTHREAD_MUTEX_BARGING_NP, PTHREAD_PRIO_NONE, PTW32_PRIO_CEILING_DEFAULT
+};
+const struct pthread_condattr_t_ ptw32_condattr_default =
+{
+  PTHREAD_PROCESS_PRIVATE, CLOCK_REALTIME, 0, PTHREAD_COND_WAKE_ANY_NP
+};
+const struct pthread_rwlockattr_t_ ptw32_rwlockattr_default =
+{
+  PTHREAD_PROCESS_PRIVATE, 0, PTHREAD_RWLOCK_DEFAULT_NP
+};
+const struct pthread_barrierattr_t_ ptw32_barrierattr_default =
+{
+  PTHREAD_PROCESS_PRIVATE, PTHREAD_BARRIER_DEFAULT_NP
+};
+
+/*
+ * Boundary that synchronisation objects are placed on (0: the
+ * allocator's own). See pthread_setobjectalign_np().
+ */
+int ptw32_objectAlign = 0;
+
+/*
+ * Free blocks of each ptw32_object_alloc() size class.
+ */
+ptw32_object_class_t ptw32_objectClasses[PTW32_OBJECT_CLASSES];
+
+/*
+ * Large pages for slabs and thread structs: as set by
+ * PTHREAD_PARAM_LARGE_PAGES_NP, whether the system gives them
+ * (PTW32_LARGEPAGE_*) and their size, the unused rest of the
+ * current region, and the thread structs cut from regions that
+ * have been freed. All but the first under ptw32_largepage_lock.
+ * See ptw32_largepage.c.
+ */
+int ptw32_largePages = 0;
+int ptw32_largePageState = PTW32_LARGEPAGE_UNKNOWN;
+SIZE_T ptw32_largePageSize = 0;
+ptw32_mcs_lock_t ptw32_largepage_lock = 0;
+char * ptw32_largePageNext = NULL;
+char * ptw32_largePageEnd = NULL;
+ptw32_thread_t * ptw32_largePageThreads = NULL;
+
+/*
+ * GetLargePageMinimum if the system provides it (Windows Server 2003
+ * and later), otherwise NULL. Set once when the process attaches.
+ */
+SIZE_T (WINAPI *ptw32_getlargepageminimum) (void) = NULL;
+
+/*
+ * Number of polls of its queue node made by an MCS lock waiter before
+ * it blocks, and of the release by a combining tree barrier waiter
+ * before it parks. Set from PTW32_MCS_SPIN_NS and PTW32_BARRIER_SPIN_NS
+ * when the process initialises on a multi-processor system.
+ */
+int ptw32_mcs_spin_limit = 0;
+int ptw32_barrierSpinLimit = 0;
+
+/*
+ * The most processor hints a contended spin lock waits between
+ * attempts, and the hints it makes without the lock changing hands
+ * before it yields. See pthread_spin_lock.c.
+ */
+int ptw32_spinBackoffLimit = PTW32_SPIN_BACKOFF_NS * 1000 / PTW32_SPIN_HINT_PS;
+int ptw32_spinYieldLimit = PTW32_SPIN_YIELD_NS / (PTW32_SPIN_HINT_PS / 1000);
+
+/*
+ * Picoseconds one processor hint takes. See ptw32_spin_calibrate.c.
+ */
+int ptw32_spinHintPs = PTW32_SPIN_HINT_PS;
+
+/*
+ * The CPUs the process can use at once, or 0 if not yet known, and
+ * the tick count when it was last read. See ptw32_getprocessors.c.
+ */
+LONG ptw32_spinCpus = 0;
+LONG ptw32_spinCpusTick = 0;
+
+/*
+ * Non-zero if timed waits may use a high resolution waitable timer.
+ * See ptw32_wait_timer.c.
+ */
+int ptw32_hiresWait = 1;
+
+/*
+ * Zero if threads the library creates get no priority boost when
+ * woken. See pthread_setwakeboost_np.c.
+ */
+int ptw32_wakeBoost = 1;
+
+/*
+ * The processor tokens: as given to pthread_setcputokens_np, the
+ * tokens there are, those not held (negative while more are held
+ * than there are), and the threads waiting for some. See
+ * ptw32_cputokens.c.
+ */
+int ptw32_cpuTokens = PTHREAD_CPUTOKENS_OFF_NP;
+volatile LONG ptw32_cpuTokensTotal = 0;
+volatile LONG ptw32_cpuTokensFree = 0;
+volatile LONG ptw32_cpuTokensWaiters = 0;
+
+/*
+ * Kernel objects held and kernel calls made by the library, indexed
+ * by PTW32_LIBSTAT_*. See pthread_getlibstats_np.c.
+ */
+volatile LONG64 ptw32_libStats[PTW32_LIBSTAT_COUNT];
+
 /* What features have been auto-detected */
 int ptw32_features = 0;
 
 /*
- * Global [process wide] thread sequence Number
+ * Non-zero if the processor supports RTM, which elided mutexes and
+ * read/write locks need. See ptw32_lock_elide.c.
+ */
+int ptw32_lockElide = PTW32_FALSE;
+
+/*
+ * Global [process wide] thread sequence Number, only changed with
+ * interlocked operations
  */
-unsigned __int64 ptw32_threadSeqNumber = 0;
+volatile LONG64 ptw32_threadSeqNumber = 0;
 
 /* 
  * Function pointer to QueueUserAPCEx if it exists, otherwise
@@ -64,40 +224,387 @@ unsigned __int64 ptw32_threadSeqNumber = 0;
  */
 DWORD (*ptw32_register_cancellation) (PAPCFUNC, HANDLE, DWORD) = NULL;
 
+/*
+ * QueueUserAPC2 if the system provides it, otherwise NULL. Async
+ * cancellation uses it in preference to the above.
+ */
+BOOL (WINAPI *ptw32_queueuserapc2) (PAPCFUNC, HANDLE, ULONG_PTR, DWORD) = NULL;
+
+/*
+ * SetThreadStackGuarantee if the system provides it (Windows Vista and
+ * later), otherwise NULL. Guard sizes beyond a page need it.
+ */
+BOOL (WINAPI *ptw32_setthreadstackguarantee) (PULONG) = NULL;
+
+/*
+ * Handle to quserex.dll, and whether ptw32_register_cancellation has
+ * been set up yet. See ptw32_cancel_initialize.c.
+ */
+HINSTANCE ptw32_h_quserex = 0;
+volatile LONG ptw32_cancelInitialized = PTW32_FALSE;
+ptw32_mcs_lock_t ptw32_cancel_init_lock = 0;
+
+/*
+ * Function pointers to WaitOnAddress and WakeByAddress* if the system
+ * provides them (Windows 8 and later), otherwise NULL. Set once when
+ * the process attaches and never reset.
+ */
+BOOL (WINAPI *ptw32_waitonaddress) (volatile VOID *, PVOID, SIZE_T, DWORD) = NULL;
+VOID (WINAPI *ptw32_wakebyaddresssingle) (PVOID) = NULL;
+VOID (WINAPI *ptw32_wakebyaddressall) (PVOID) = NULL;
+
+/*
+ * Function pointers to the Slim Reader/Writer lock routines if the
+ * system provides them and WaitOnAddress, otherwise NULL. Set once
+ * when the process attaches and never reset.
+ */
+VOID (WINAPI *ptw32_acquiresrwlockshared) (PVOID *) = NULL;
+VOID (WINAPI *ptw32_acquiresrwlockexclusive) (PVOID *) = NULL;
+BOOLEAN (WINAPI *ptw32_tryacquiresrwlockshared) (PVOID *) = NULL;
+BOOLEAN (WINAPI *ptw32_tryacquiresrwlockexclusive) (PVOID *) = NULL;
+VOID (WINAPI *ptw32_releasesrwlockshared) (PVOID *) = NULL;
+VOID (WINAPI *ptw32_releasesrwlockexclusive) (PVOID *) = NULL;
+
+/*
+ * Function pointers to the processor group routines if the system
+ * provides them (Windows 7 and later), otherwise NULL. Set once when
+ * the process attaches and never reset.
+ */
+BOOL (WINAPI *ptw32_setthreadgroupaffinity) (HANDLE, const ptw32_group_affinity_t *, ptw32_group_affinity_t *) = NULL;
+BOOL (WINAPI *ptw32_getthreadgroupaffinity) (HANDLE, ptw32_group_affinity_t *) = NULL;
+WORD (WINAPI *ptw32_getactiveprocessorgroupcount) (void) = NULL;
+DWORD (WINAPI *ptw32_getactiveprocessorcount) (WORD) = NULL;
+
+/*
+ * Next processor group to place a thread in when its CPU set spans
+ * more than one.
+ */
+LONG ptw32_affinityNextGroup = 0;
+
+/*
+ * GetLogicalProcessorInformationEx and GetCurrentProcessorNumberEx if
+ * the system provides them (Windows 7 and later), otherwise NULL. Set
+ * once when the process attaches.
+ */
+BOOL (WINAPI *ptw32_getlogicalprocessorinformationex) (DWORD, ptw32_processor_info_t *, PDWORD) = NULL;
+VOID (WINAPI *ptw32_getcurrentprocessornumberex) (ptw32_processor_number_t *) = NULL;
+
+/*
+ * QueryThreadCycleTime if the system provides it (Windows Vista and
+ * later), otherwise NULL. Set once when the process attaches.
+ */
+BOOL (WINAPI *ptw32_querythreadcycletime) (HANDLE, PULONG64) = NULL;
+
+/*
+ * FlushProcessWriteBuffers if the system provides it (Windows Vista
+ * and later), otherwise NULL: a barrier on every processor running
+ * the process's threads. Set once when the process attaches.
+ */
+VOID (WINAPI *ptw32_flushprocesswritebuffers) (void) = NULL;
+
+/*
+ * OpenThread if the system provides it (Windows 2000 and later),
+ * otherwise NULL. Set once when the process attaches.
+ */
+HANDLE (WINAPI *ptw32_openthread) (DWORD, BOOL, DWORD) = NULL;
+
+/*
+ * SetThreadInformation if the system provides it (Windows 8 and
+ * later), otherwise NULL. Set once when the process attaches.
+ */
+BOOL (WINAPI *ptw32_setthreadinformation) (HANDLE, int, LPVOID, DWORD) = NULL;
+
+/*
+ * SetThreadDescription if the system provides it (Windows 10 version
+ * 1607 and later), otherwise NULL. Set once when the process attaches.
+ */
+HRESULT (WINAPI *ptw32_setthreaddescription) (HANDLE, const WCHAR *) = NULL;
+
+/*
+ * CancelSynchronousIo if the system provides it (Windows Vista and
+ * later), otherwise NULL. Set once when the process attaches.
+ */
+BOOL (WINAPI *ptw32_cancelsynchronousio) (HANDLE) = NULL;
+
+/*
+ * The CPU Sets calls for soft affinity if the system provides them,
+ * otherwise NULL. SetThreadSelectedCpuSetMasks is Windows 11 and
+ * later, the other two Windows 10. Set once when the process attaches.
+ */
+BOOL (WINAPI *ptw32_setthreadselectedcpusetmasks) (HANDLE, ptw32_group_affinity_t *, USHORT) = NULL;
+BOOL (WINAPI *ptw32_setthreadselectedcpusets) (HANDLE, const ULONG *, ULONG) = NULL;
+BOOL (WINAPI *ptw32_getsystemcpusetinformation) (ptw32_cpu_set_info_t *, ULONG, PULONG, HANDLE, ULONG) = NULL;
+
+/*
+ * The processor topology, built by ptw32_gettopology() under
+ * ptw32_topology_lock and freed when the process detaches.
+ */
+ptw32_topology_t * ptw32_topology = NULL;
+ptw32_mcs_lock_t ptw32_topology_lock = 0;
+
+/*
+ * GetSystemTimePreciseAsFileTime (Windows 8 and later) and
+ * CreateWaitableTimerExW, if the system provides them, otherwise NULL.
+ * The latter is only set if it can make high resolution timers
+ * (Windows 10 version 1803 and later). Set once when the process
+ * attaches.
+ */
+VOID (WINAPI *ptw32_getsystemtimepreciseasfiletime) (LPFILETIME) = NULL;
+HANDLE (WINAPI *ptw32_createwaitabletimerex) (LPSECURITY_ATTRIBUTES, LPCWSTR, DWORD, DWORD) = NULL;
+
+/*
+ * FlsSetValue and FlsFree, if the system provides them (Windows Vista
+ * and later), and the FLS index whose callback detaches a thread that
+ * exits without going through the library, otherwise
+ * FLS_OUT_OF_INDEXES. The DLL then doesn't take thread notifications.
+ */
+BOOL (WINAPI *ptw32_flssetvalue) (DWORD, PVOID) = NULL;
+BOOL (WINAPI *ptw32_flsfree) (DWORD) = NULL;
+DWORD ptw32_flsIndex = FLS_OUT_OF_INDEXES;
+
+/*
+ * QueryPerformanceFrequency, cached by ptw32_perf_frequency().
+ */
+int64_t ptw32_perfFrequency = 0;
+
 /*
  * Global lock for managing pthread_t struct reuse.
  */
 ptw32_mcs_lock_t ptw32_thread_reuse_lock = 0;
 
 /*
- * Global lock for testing internal state of statically declared mutexes.
+ * OS threads parked in the thread cache, held under
+ * ptw32_thread_cache_lock. ptw32_threadCacheMax is set by
+ * pthread_setthreadcache_np (0: threads aren't cached).
  */
-ptw32_mcs_lock_t ptw32_mutex_test_init_lock = 0;
+ptw32_parked_thread_t * ptw32_threadCache = NULL;
+int ptw32_threadCacheCount = 0;
+int ptw32_threadCacheMax = 0;
+ptw32_mcs_lock_t ptw32_thread_cache_lock = 0;
 
 /*
- * Global lock for testing internal state of PTHREAD_COND_INITIALIZER
- * created condition variables.
+ * The thread pool API (Windows Vista and later), and the private pool
+ * that pooled threads run on, created on first use under
+ * ptw32_thread_pool_lock. See ptw32_threadPool.c.
  */
-ptw32_mcs_lock_t ptw32_cond_test_init_lock = 0;
+PVOID (WINAPI *ptw32_createthreadpool) (PVOID) = NULL;
+BOOL (WINAPI *ptw32_setthreadpoolthreadminimum) (PVOID, DWORD) = NULL;
+PVOID (WINAPI *ptw32_createthreadpoolwork) (ptw32_tp_work_callback_t, PVOID, ptw32_tp_environ_t *) = NULL;
+VOID (WINAPI *ptw32_submitthreadpoolwork) (PVOID) = NULL;
+VOID (WINAPI *ptw32_closethreadpoolwork) (PVOID) = NULL;
+BOOL (WINAPI *ptw32_callbackmayrunlong) (PVOID) = NULL;
+PVOID ptw32_threadPool = NULL;
+ptw32_tp_environ_t ptw32_threadPoolEnviron;
+ptw32_mcs_lock_t ptw32_thread_pool_lock = 0;
 
 /*
- * Global lock for testing internal state of PTHREAD_RWLOCK_INITIALIZER
- * created read/write locks.
+ * This process's views of the process shared object arenas, mapped
+ * on first use under ptw32_pshared_lock. See ptw32_pshared.c.
  */
-ptw32_mcs_lock_t ptw32_rwlock_test_init_lock = 0;
+ptw32_pshared_arena_t * ptw32_psharedArenas[PTW32_PSHARED_ARENAS];
+ptw32_mcs_lock_t ptw32_pshared_lock = 0;
+
+/*
+ * The named semaphores this process has open, held under
+ * ptw32_named_sem_lock.
+ */
+ptw32_named_sem_t * ptw32_namedSems = NULL;
+ptw32_mcs_lock_t ptw32_named_sem_lock = 0;
+
+/*
+ * PTHREAD_SCOPE_PROCESS threads: the run queue and worker counts are
+ * held under ptw32_fiber_lock. The idle semaphore and the worker TLS
+ * index are created with the first such thread, when the WaitOnAddress
+ * pointers above are also swapped for ones that park fibers; the
+ * system's are kept here. See ptw32_fiber.c.
+ */
+ptw32_fiber_t * ptw32_fiberRunHead = NULL;
+ptw32_fiber_t * ptw32_fiberRunTail = NULL;
+int ptw32_fiberWorkers = 0;
+int ptw32_fiberIdleWorkers = 0;
+HANDLE ptw32_fiberIdleSem = NULL;
+DWORD ptw32_fiberWorkerIndex = TLS_OUT_OF_INDEXES;
+ptw32_fiber_bucket_t ptw32_fiberBuckets[PTW32_FIBER_BUCKETS];
+BOOL (WINAPI *ptw32_fiber_os_waitonaddress) (volatile VOID *, PVOID, SIZE_T, DWORD) = NULL;
+VOID (WINAPI *ptw32_fiber_os_wakebyaddresssingle) (PVOID) = NULL;
+VOID (WINAPI *ptw32_fiber_os_wakebyaddressall) (PVOID) = NULL;
+ptw32_mcs_lock_t ptw32_fiber_lock = 0;
+
+/*
+ * The parking lot's wait queues, used in place of the system's
+ * WaitOnAddress when it has none. See ptw32_park.c.
+ */
+ptw32_park_bucket_t ptw32_parkingLot[PTW32_PARK_BUCKETS];
+
+/*
+ * Queues of the asynchronous waiters on mutexes, condition variables
+ * and semaphores, and how many there are. See ptw32_async.c.
+ */
+ptw32_async_bucket_t ptw32_asyncLot[PTW32_PARK_BUCKETS];
+volatile LONG ptw32_asyncWaiters = 0;
+
+/*
+ * The timer slack set by pthread_settimerslack_np (in 100 nanosecond
+ * units; 0: no timer wheel) and the wheel itself, guarded by
+ * ptw32_timer_wheel_lock. The tick length is 0 until the wheel's
+ * thread is started. See ptw32_timer_wheel.c.
+ */
+volatile LONG ptw32_timerSlack = 0;
+ptw32_mcs_lock_t ptw32_timer_wheel_lock = 0;
+ptw32_wheel_timer_t * ptw32_timerWheel[PTW32_WHEEL_LEVELS][PTW32_WHEEL_SLOTS];
+ptw32_wheel_timer_t * ptw32_timerWheelExpired = NULL;
+long ptw32_timerWheelCount = 0;
+int64_t ptw32_timerWheelTick = 0;
+int64_t ptw32_timerWheelNext = 0;
+int64_t ptw32_timerWheelWake = 0;
+HANDLE ptw32_timerWheelEvent = NULL;
+
+/*
+ * RCU: the grace period counter (odd, so never 0), the readers that
+ * have ever gone online and the lock that guards the list and
+ * serialises grace periods, and the callbacks waiting for the
+ * call_rcu worker. See pthread_rcu_synchronize_np.c and
+ * pthread_call_rcu_np.c.
+ */
+volatile LONG ptw32_rcuGp = 1;
+ptw32_rcu_reader_t * ptw32_rcuReaders = NULL;
+ptw32_mcs_lock_t ptw32_rcu_lock = 0;
+pthread_mutex_t ptw32_rcuCallbackLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t ptw32_rcuCallbackCond = PTHREAD_COND_INITIALIZER;
+pthread_rcu_head_np_t * ptw32_rcuCallbacks = NULL;
+pthread_rcu_head_np_t ** ptw32_rcuCallbackTail = &ptw32_rcuCallbacks;
+unsigned __int64 ptw32_rcuQueued = 0;
+unsigned __int64 ptw32_rcuDone = 0;
+int ptw32_rcuWorkerStarted = PTW32_FALSE;
+
+#if defined(PTW32_TIMER_CREATE)
+/*
+ * POSIX timers: the heap of armed timers, room for every timer that
+ * exists, the event that tells the timer thread the heap's top has
+ * changed and the pool that runs SIGEV_THREAD notifications. See
+ * ptw32_timer.c.
+ */
+ptw32_mcs_lock_t ptw32_timer_lock = 0;
+timer_t * ptw32_timerHeap = NULL;
+int ptw32_timerHeapSize = 0;
+int ptw32_timerCount = 0;
+int ptw32_timerCapacity = 0;
+HANDLE ptw32_timerEvent = NULL;
+pthread_pool_np_t ptw32_timerPool = NULL;
+#endif
+
+/*
+ * Hazard pointer records of all threads that have used them. The list
+ * only grows, by interlocked push, so scans walk it without a lock.
+ * See ptw32_hazard.c.
+ */
+ptw32_hazard_record_t * volatile ptw32_hazardRecords = NULL;
+volatile LONG ptw32_hazardRecordCount = 0;
+
+/*
+ * Wait-for graph records of all threads that have blocked on a mutex,
+ * pushed like ptw32_hazardRecords. See ptw32_waitgraph.c.
+ */
+ptw32_waitgraph_record_t * volatile ptw32_waitgraphRecords = NULL;
+
+/*
+ * Flight recorders of all threads that have recorded an event, pushed
+ * like ptw32_hazardRecords. A debugger finds them from here in a dump.
+ * See ptw32_flightrec.c.
+ */
+ptw32_flightrec_t * volatile ptw32_flightRecs = NULL;
+
+/*
+ * Wait time histograms of all threads that have blocked, pushed like
+ * ptw32_hazardRecords. See ptw32_hist.c.
+ */
+ptw32_hist_record_t * volatile ptw32_histRecords = NULL;
+
+/*
+ * Threads blocked in pthread_waitany_np. See ptw32_waitany.c.
+ */
+ptw32_waitany_waiter_t * volatile ptw32_waitanyWaiters = NULL;
+ptw32_mcs_lock_t ptw32_waitany_lock = 0;
+
+/*
+ * Guards the priority protocol state of all mutexes and threads. See
+ * ptw32_mutex_prio.c.
+ */
+ptw32_mcs_lock_t ptw32_mutex_prio_lock = 0;
+
+#if defined(PTW32_LOCKSTAT)
+/*
+ * Objects that have been contended, and the lock that guards the
+ * list and their statistics. See ptw32_lockstat.c.
+ */
+ptw32_mcs_lock_t ptw32_lockstat_lock = 0;
+ptw32_lockstat_t * ptw32_lockstatList = NULL;
+
+/*
+ * The lock profiler's sample ring and sampling settings. See
+ * ptw32_lockprof.c.
+ */
+ptw32_lockprof_slot_t ptw32_lockprofRing[PTW32_LOCKPROF_SLOTS];
+volatile LONG ptw32_lockprofNext = 0;
+volatile LONG ptw32_lockprofCount = 0;
+LONG ptw32_lockprofEvery = 0;
+int64_t ptw32_lockprofThreshold = 0;
+int ptw32_lockprofOn = PTW32_FALSE;
+#endif
+
+#if defined(PTW32_ETW)
+/*
+ * The ETW provider's registration, and whether any session has it
+ * enabled. See ptw32_etw.c.
+ */
+REGHANDLE ptw32_etwHandle = 0;
+volatile LONG ptw32_etwEnabled = 0;
+#endif
+
+#if defined(PTW32_PERFCOUNTERS)
+/*
+ * The performance counter provider and this process's instance of
+ * its counter set. See ptw32_perf.c.
+ */
+HANDLE ptw32_perfProvider = NULL;
+PPERF_COUNTERSET_INSTANCE ptw32_perfInstance = NULL;
+#endif
+
+#if defined(PTW32_LOCKWATCH)
+/*
+ * Lock orders seen so far, the lock that guards them, and where and
+ * when to report. See ptw32_lockwatch.c.
+ */
+ptw32_mcs_lock_t ptw32_lockwatch_lock = 0;
+ptw32_lockwatch_edge_t ptw32_lockwatchEdges[PTW32_LOCKWATCH_EDGES];
+LONG ptw32_lockwatchNextId = 0;
+void (PTW32_CDECL *ptw32_lockwatchCallback) (const pthread_lockwatch_np_t *, void *) = NULL;
+void * ptw32_lockwatchArg = NULL;
+int64_t ptw32_lockwatchLimit = 0;
+#endif
 
 /*
- * Global lock for testing internal state of PTHREAD_SPINLOCK_INITIALIZER
- * created spin locks.
+ * Key slots and the thread specific data kept in per-thread tables
+ * once Win32 runs out of TLS indexes (see ptw32_tsd_table.c).
+ * ptw32_tsdTableIndex is allocated when the process attaches, while
+ * indexes are available. ptw32_tsdKeys and the slot allocator are
+ * guarded by ptw32_tsd_slot_lock.
  */
-ptw32_mcs_lock_t ptw32_spinlock_test_init_lock = 0;
+DWORD ptw32_tsdTableIndex = TLS_OUT_OF_INDEXES;
+pthread_key_t * ptw32_tsdKeys = NULL;
+ptw32_mcs_lock_t ptw32_tsd_slot_lock = 0;
+unsigned int ptw32_tsdNextSlot = 0;
+unsigned int ptw32_tsdGeneration = 0;
+unsigned int * ptw32_tsdFreeSlots = NULL;
+unsigned int ptw32_tsdNumFreeSlots = 0;
 
 /*
- * Global lock for condition variable linked list. The list exists
- * to wake up CVs when a WM_TIMECHANGE message arrives. See
- * w32_TimeChangeHandler.c.
+ * The TLS indexes of deleted keys. TlsFree clears an index in every
+ * thread of the process, so instead they are held until the process
+ * detaches. Once one has been retired new keys are table keys.
  */
-ptw32_mcs_lock_t ptw32_cond_list_lock = 0;
+DWORD * ptw32_tsdRetired = NULL;
+unsigned int ptw32_tsdNumRetired = 0;
 
 #if defined(_UWIN)
 /*
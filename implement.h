@@ -193,64 +193,849 @@ typedef struct ptw32_mcs_node_t_     ptw32_mcs_local_node_t;
 typedef struct ptw32_mcs_node_t_*    ptw32_mcs_lock_t;
 typedef struct ptw32_robust_node_t_  ptw32_robust_node_t;
 typedef struct ptw32_thread_t_       ptw32_thread_t;
+typedef struct ptw32_mutex_prio_t_   ptw32_mutex_prio_t;
+typedef struct ptw32_mutex_cohort_t_ ptw32_mutex_cohort_t;
+
+/*
+ * Each thread has a bitmap, indexed by key slot, of the keys with a
+ * destructor that it has set a value for. The first bits are kept in
+ * the thread struct so that most threads never allocate one. Only the
+ * words from dtorFirst up to dtorLimit can have bits set, so a thread
+ * that never set such a key exits without looking at the bitmap.
+ */
+#define PTW32_TSD_DTOR_INLINE_WORDS 2
+
+#define PTW32_TSD_DTOR_BITS(tp) \
+  ((tp)->dtorBits != NULL ? (tp)->dtorBits : (tp)->dtorBitsInline)
+#define PTW32_TSD_DTOR_WORDS(tp) \
+  ((tp)->dtorBits != NULL ? (tp)->nDtorWords : PTW32_TSD_DTOR_INLINE_WORDS)
+
+typedef struct ThreadParms ThreadParms;
+
+/*
+ * ptw32_threadStart commits stack a page at a time, and never within
+ * PTW32_STACK_COMMIT_SLACK bytes of the bottom of the reservation, which
+ * the guard page and the stack overflow handler need.
+ */
+#define PTW32_STACK_PAGE		4096
+#define PTW32_STACK_COMMIT_SLACK	(64 * 1024)
+
+/*
+ * A parked thread keeps PTW32_STACK_PARK_KEEP bytes of committed stack
+ * below the frame that parks it. See ptw32_threadCache.c.
+ */
+#define PTW32_STACK_PARK_KEEP		(16 * 1024)
+
+struct ThreadParms
+{
+  pthread_t tid;
+  void *(PTW32_CDECL *start) (void *);
+  void *arg;
+  unsigned int stackSize;	/* As passed to _beginthreadex */
+  size_t stackCommit;		/* Stack ptw32_threadStart commits, or 0 */
+  ULONG stackGuard;		/* Stack guarantee it sets, or 0 */
+  void *stackAddr;		/* Lowest address of the caller's stack, or NULL */
+  size_t stackBytes;		/* Size of the caller's stack */
+};
+
+/*
+ * A thread given its own stack by pthread_attr_setstack runs on an OS
+ * thread that reserves only PTW32_STACKADDR_OS_RESERVE bytes of stack.
+ * That stack still runs the DLL thread attach and detach notifications
+ * and the TSD destructors. The caller's stack must be at least
+ * PTW32_STACKADDR_MIN bytes.
+ */
+#define PTW32_STACKADDR_OS_RESERVE	(256 * 1024)
+#define PTW32_STACKADDR_MIN		(8 * 1024)
+
+/*
+ * A finished POSIX thread's OS thread that waits in the thread cache
+ * (see ptw32_threadCache.c) for pthread_create to give it another
+ * start routine. The record lives on the parked thread's stack.
+ */
+typedef struct ptw32_parked_thread_t_ ptw32_parked_thread_t;
+
+struct ptw32_parked_thread_t_
+{
+  ptw32_parked_thread_t * next;
+  HANDLE wakeEvent;		/* Auto-reset; set when parms is filled in */
+  HANDLE threadH;		/* Handed over to the next POSIX thread */
+  DWORD thread;			/* Windows thread ID */
+  unsigned int stackSize;
+  ThreadParms * parms;		/* NULL on wakeup: exit */
+};
+
+/*
+ * A detached thread created with pthread_attr_setpooled_np runs as a
+ * work item of the library's own system thread pool (see
+ * ptw32_threadPool.c). The callback environment is declared here, as
+ * version 1 of TP_CALLBACK_ENVIRON, so that the library builds with
+ * headers that predate Vista.
+ */
+typedef struct
+{
+  DWORD version;		/* 1 */
+  PVOID pool;
+  PVOID cleanupGroup;
+  PVOID cleanupGroupCancelCallback;
+  PVOID raceDll;
+  PVOID activationContext;
+  PVOID finalizationCallback;
+  DWORD flags;
+} ptw32_tp_environ_t;
+
+typedef VOID (CALLBACK * ptw32_tp_work_callback_t) (PVOID instance, PVOID context, PVOID work);
+
+/*
+ * A PTHREAD_SCOPE_PROCESS thread is a fiber, run by whichever of the
+ * fiber workers takes it off the run queue (see ptw32_fiber.c).
+ */
+#if ! defined(WINCE)
+#  define PTW32_FIBER_THREADS
+#endif
+
+#define PTW32_FIBER_MAX_WAIT	3	/* Handles in one fiber wait */
+#define PTW32_FIBER_BUCKETS	256	/* Address park hash buckets */
+
+typedef struct ptw32_fiber_t_ ptw32_fiber_t;
+
+/* What the worker does once a fiber has switched back to it */
+enum
+{
+  PTW32_FIBER_YIELD,		/* Queue it again */
+  PTW32_FIBER_WAIT,		/* Register its handle waits */
+  PTW32_FIBER_PARK,		/* Unlock the bucket it is parked in */
+  PTW32_FIBER_EXIT		/* Delete it */
+};
+
+/* Found through the TLS index ptw32_fiberWorkerIndex */
+typedef struct
+{
+  LPVOID fiber;			/* The worker thread's own fiber */
+  int action;
+} ptw32_fiber_worker_t;
+
+typedef struct
+{
+  ptw32_fiber_t * fb;
+  HANDLE wait;			/* From RegisterWaitForSingleObject */
+  DWORD status;			/* WAIT_FAILED until the wait fires */
+} ptw32_fiber_handle_wait_t;
+
+struct ptw32_fiber_t_
+{
+  LPVOID handle;		/* NULL unless the thread is a fiber */
+  ptw32_fiber_t * next;		/* Run queue or park bucket */
+  DWORD lastError;		/* While switched out */
+  /* Handle waits */
+  DWORD nHandles;
+  HANDLE handles[PTW32_FIBER_MAX_WAIT];
+  ptw32_fiber_handle_wait_t waits[PTW32_FIBER_MAX_WAIT];
+  DWORD timeout;
+  LONG fired;			/* Set by the first wait to fire */
+  LONG refs;			/* Queued when the registration and one wait are done */
+  /* Address parks */
+  volatile VOID * address;
+  ptw32_mcs_local_node_t * bucketNode;
+  HANDLE timer;
+  int woken;
+  /* TSD values while switched out; the buffer is kept across reuse */
+  struct ptw32_tsd_entry_t_ * tsd;
+  unsigned int nTsd;
+  unsigned int tsdSize;
+  void * tsdTable;
+};
+
+typedef struct
+{
+  ptw32_mcs_lock_t lock;
+  ptw32_fiber_t * parked;
+} ptw32_fiber_bucket_t;
+
+#define PTW32_FIBER_BUCKET(address) \
+  (&ptw32_fiberBuckets[((size_t) (address) >> 2) % PTW32_FIBER_BUCKETS])
+
+/*
+ * The parking lot, the library's WaitOnAddress (see ptw32_park.c).
+ */
+#define PTW32_PARK_BUCKETS	256	/* Address park hash buckets */
+
+typedef struct ptw32_parker_t_ ptw32_parker_t;
+
+struct ptw32_parker_t_
+{
+  volatile VOID * address;	/* parked on */
+  HANDLE event;			/* the thread's MCS wait event */
+  ptw32_parker_t * next;
+  int woken;			/* taken off the queue by a waker */
+};
+
+typedef struct
+{
+  ptw32_mcs_lock_t lock;
+  ptw32_parker_t * head;	/* parked the longest */
+  ptw32_parker_t * tail;
+} ptw32_park_bucket_t;
+
+/*
+ * Asynchronous waiters on mutexes, condition variables and semaphores
+ * (pthread_mutex_lock_async_np etc., see ptw32_async.c). Instead of
+ * blocking, a waiter queues a node keyed by the address the object's
+ * wakers already wake; when it gets what it waits for its callback is
+ * run on a thread pool, or a packet is posted to a completion port.
+ */
+typedef enum
+{
+  PTW32_ASYNC_MUTEX,		/* object is a pthread_mutex_t */
+  PTW32_ASYNC_COND,		/* waits for a signal, then for 'mutex' */
+  PTW32_ASYNC_SEM		/* object is a sem_t */
+} ptw32_async_type_t;
+
+typedef struct ptw32_async_waiter_t_ ptw32_async_waiter_t;
+
+struct ptw32_async_waiter_t_
+{
+  volatile VOID * address;	/* queued on */
+  ptw32_async_waiter_t * next;
+  ptw32_async_type_t type;
+  void * object;
+  pthread_mutex_t mutex;	/* PTW32_ASYNC_COND: relocked when signalled */
+  pthread_pool_task_np_t task;	/* submitted to the pool when done */
+  void (PTW32_CDECL * callback) (void *);
+  void * arg;
+  HANDLE port;			/* if no task: completion port posted */
+  ULONG_PTR key;		/*   with this key                     */
+  LPOVERLAPPED overlapped;	/*   and this OVERLAPPED pointer       */
+};
+
+typedef struct
+{
+  ptw32_mcs_lock_t lock;
+  ptw32_async_waiter_t * head;	/* queued the longest */
+  ptw32_async_waiter_t * tail;
+} ptw32_async_bucket_t;
+
+/*
+ * The timer wheel, which ends the WaitOnAddress waits of a process
+ * that has set a timer slack (see ptw32_timer_wheel.c). Level 0 has a
+ * slot per tick; each slot of level n covers all of level n-1.
+ */
+#define PTW32_WHEEL_BITS	6
+#define PTW32_WHEEL_SLOTS	(1 << PTW32_WHEEL_BITS)
+#define PTW32_WHEEL_MASK	(PTW32_WHEEL_SLOTS - 1)
+#define PTW32_WHEEL_LEVELS	4
+
+typedef struct ptw32_wheel_timer_t_ ptw32_wheel_timer_t;
+
+struct ptw32_wheel_timer_t_
+{
+  ptw32_wheel_timer_t * next;
+  ptw32_wheel_timer_t ** link;	/* the pointer to this one */
+  volatile VOID * address;	/* the waiter's WaitOnAddress address */
+  int64_t deadline;		/* monotonic, in 100 nanosecond units */
+  int64_t expires;		/* the wheel tick that ends the wait */
+  int expired;			/* on ptw32_timerWheelExpired */
+};
+
+/*
+ * Contention statistics kept in each mutex, condition variable and
+ * read-write lock of a PTW32_LOCKSTAT build (see ptw32_lockstat.c).
+ * Times are in performance counter ticks. Objects are linked into
+ * ptw32_lockstatList the first time they are contended.
+ */
+typedef struct ptw32_lockstat_t_ ptw32_lockstat_t;
+
+/*
+ * The last release of a mutex to blocked waiters while sampling is on,
+ * kept for the owner half of the next sample. See ptw32_lockprof.c.
+ */
+typedef struct
+{
+  int64_t when;
+  pthread_t thread;
+  int depth;
+  void * stack[PTHREAD_LOCKPROF_DEPTH_NP];
+} ptw32_lockprof_owner_t;
+
+struct ptw32_lockstat_t_
+{
+  volatile size_t acquisitions;	/* Owner or interlocked access */
+  size_t contended;		/* The rest under ptw32_lockstat_lock */
+  int64_t waitTime;
+  int64_t maxWaitTime;
+  int64_t holdTime;		/* Contended mutex acquisitions only */
+  int64_t holdStart;		/* Owner access only */
+  int kind;			/* PTHREAD_LOCKSTAT_*_NP */
+  void * object;
+  int listed;
+  ptw32_lockstat_t * prev;
+  ptw32_lockstat_t * next;
+  ptw32_lockprof_owner_t * releasedBy;	/* Owner access only, NULL until sampled */
+};
+
+/*
+ * The sample ring of the lock profiler. 'seq' is the sample's position
+ * plus 1, or 0 while it is being written. See ptw32_lockprof.c.
+ */
+#define PTW32_LOCKPROF_SLOTS	256	/* Power of 2 */
+
+typedef struct
+{
+  volatile LONG seq;
+  pthread_lockprof_np_t sample;
+} ptw32_lockprof_slot_t;
+
+/*
+ * Recording points. Only the contended paths read the clock; the
+ * uncontended cost is the increment at unlock or in the rwlock
+ * dispatch. Without PTW32_LOCKSTAT they compile to the plain code.
+ */
+#if defined(PTW32_LOCKSTAT)
+#define PTW32_LOCKSTAT_DECL(start)	int64_t start = 0;
+#define PTW32_LOCKSTAT_SPIN(mx, idx, start) \
+  ((start) = ptw32_lockstat_now (), ptw32_mutex_spin ((mx), (idx)))
+#define PTW32_LOCKSTAT_MUTEX_WAITED(mx, start) \
+  do { if (0 != (start)) ptw32_lockstat_waited (&(mx)->stats, (start), 1); } while (0)
+#define PTW32_LOCKSTAT_MUTEX_RELEASE(mx) \
+  do { (mx)->stats.acquisitions++; \
+       if (0 != (mx)->stats.holdStart) ptw32_lockstat_released (&(mx)->stats); \
+       if ((mx)->lock_idx < 0 && ptw32_lockprofOn) ptw32_lockprof_released (&(mx)->stats); } while (0)
+#define PTW32_LOCKSTAT_COND_BEGIN(start) \
+  ((start) = ptw32_lockstat_now ())
+#define PTW32_LOCKSTAT_COND_WAITED(cv, result, start) \
+  ptw32_lockstat_cond_waited (&(cv)->stats, (result), (start))
+#define PTW32_LOCKSTAT_RWLOCK(rwl, lock, abstime, tryOnly) \
+  ptw32_lockstat_rwlock ((rwl), (lock), (abstime), (tryOnly))
+#define PTW32_LOCKSTAT_INIT(stats, kind, object) \
+  ptw32_lockstat_init (&(stats), (kind), (void *) (object))
+#define PTW32_LOCKSTAT_DESTROY(stats) \
+  ptw32_lockstat_destroy (&(stats))
+#else
+#define PTW32_LOCKSTAT_DECL(start)
+#define PTW32_LOCKSTAT_SPIN(mx, idx, start)	ptw32_mutex_spin ((mx), (idx))
+#define PTW32_LOCKSTAT_MUTEX_WAITED(mx, start)	((void) 0)
+#define PTW32_LOCKSTAT_MUTEX_RELEASE(mx)	((void) 0)
+#define PTW32_LOCKSTAT_COND_BEGIN(start)	((void) 0)
+#define PTW32_LOCKSTAT_COND_WAITED(cv, result, start)	((void) 0)
+#define PTW32_LOCKSTAT_RWLOCK(rwl, lock, abstime, tryOnly) \
+  (lock) ((rwl), (abstime), (tryOnly))
+#define PTW32_LOCKSTAT_INIT(stats, kind, object)	((void) 0)
+#define PTW32_LOCKSTAT_DESTROY(stats)	((void) 0)
+#endif
+
+/*
+ * Event Tracing for Windows events written by a PTW32_ETW build (see
+ * ptw32_etw.c). The enable callback sets ptw32_etwEnabled while any
+ * session listens, so a disabled provider costs one load and branch
+ * at each recording point; these are all on paths that block, wake or
+ * start and end threads. 'value' is event specific.
+ *
+ * Every build also keeps them in the calling thread's flight recorder
+ * (see ptw32_flightrec.c), which reports them as the matching
+ * PTHREAD_FLIGHTREC_*_NP, so the two lists are in the same order.
+ */
+enum {
+  PTW32_ETW_MUTEX_WAIT_BEGIN = PTHREAD_FLIGHTREC_MUTEX_WAIT_BEGIN_NP,
+  PTW32_ETW_MUTEX_WAIT_END,	/* value: result */
+  PTW32_ETW_MUTEX_WAKE,
+  PTW32_ETW_COND_WAIT_BEGIN,
+  PTW32_ETW_COND_WAIT_END,	/* value: result */
+  PTW32_ETW_COND_SIGNAL,	/* value: waiters released */
+  PTW32_ETW_COND_BROADCAST,	/* value: waiters released */
+  PTW32_ETW_THREAD_CREATE,	/* object: new thread, value: its seqNumber */
+  PTW32_ETW_THREAD_EXIT,	/* value: exit status */
+  PTW32_ETW_THREAD_CANCEL,
+  PTW32_ETW_EVENTS
+};
+
+#if defined(PTW32_ETW)
+#include <evntprov.h>
+#define PTW32_ETW_EVENT(event, object, value) \
+  do { ptw32_flightrec_record ((event), (const void *) (object), (int64_t) (value)); \
+       if (ptw32_etwEnabled) \
+         ptw32_etw_write ((event), (const void *) (object), (int64_t) (value)); } while (0)
+#else
+#define PTW32_ETW_EVENT(event, object, value) \
+  ptw32_flightrec_record ((event), (const void *) (object), (int64_t) (value))
+#endif
+
+/*
+ * Process wide library statistics (see pthread_getlibstats_np.c).
+ * The first five are gauges; the rest count calls, and the waits'
+ * performance counter ticks (PTW32_LIBSTAT_TIME_*) and the number of
+ * waits timed (PTW32_LIBSTAT_TIMED_*) by kind, as ptw32_wait_end
+ * sees them. Every counting point already enters the kernel or
+ * starts or ends a thread, so the counters are always kept.
+ */
+enum {
+  PTW32_LIBSTAT_EVENTS,
+  PTW32_LIBSTAT_SEMAPHORES,
+  PTW32_LIBSTAT_TIMERS,
+  PTW32_LIBSTAT_THREAD_HANDLES,
+  PTW32_LIBSTAT_THREADS,
+  PTW32_LIBSTAT_WAIT_MUTEX,
+  PTW32_LIBSTAT_WAIT_COND,
+  PTW32_LIBSTAT_WAIT_RWLOCK,
+  PTW32_LIBSTAT_WAIT_SEM,
+  PTW32_LIBSTAT_WAIT_BARRIER,
+  PTW32_LIBSTAT_WAIT_JOIN,
+  PTW32_LIBSTAT_WAIT_OTHER,
+  PTW32_LIBSTAT_SET_EVENTS,
+  PTW32_LIBSTAT_RELEASE_SEMAPHORES,
+  PTW32_LIBSTAT_MCS_EVENTS,
+  PTW32_LIBSTAT_CANCELS,
+  PTW32_LIBSTAT_TIME_MUTEX,
+  PTW32_LIBSTAT_TIME_OTHER = PTW32_LIBSTAT_TIME_MUTEX
+                             + PTW32_LIBSTAT_WAIT_OTHER - PTW32_LIBSTAT_WAIT_MUTEX,
+  PTW32_LIBSTAT_TIMED_MUTEX,
+  PTW32_LIBSTAT_TIMED_OTHER = PTW32_LIBSTAT_TIMED_MUTEX
+                              + PTW32_LIBSTAT_WAIT_OTHER - PTW32_LIBSTAT_WAIT_MUTEX,
+  PTW32_LIBSTAT_COUNT
+};
+
+/*
+ * Given to ptw32_libstat_wait() by a rwlock write wait, which is
+ * counted as PTW32_LIBSTAT_WAIT_RWLOCK but has a histogram of its own.
+ */
+#define PTW32_LIBSTAT_WAIT_RWLOCK_WRITE PTW32_LIBSTAT_COUNT
+
+/*
+ * A thread's wait time histograms, one per PTHREAD_HIST_*_NP kind,
+ * made the first time it blocks and kept across reuse of its
+ * ptw32_thread_t so that the waits of threads gone are still counted.
+ * Only the thread writes it, without atomics; pthread_gethistograms_np
+ * adds up all records. See ptw32_hist.c.
+ */
+typedef struct ptw32_hist_record_t_ ptw32_hist_record_t;
+
+struct ptw32_hist_record_t_
+{
+  unsigned __int64 count[PTHREAD_HIST_KINDS_NP][PTHREAD_HIST_BUCKETS_NP];
+  ptw32_hist_record_t * next;	/* ptw32_histRecords, never unlinked */
+};
+
+#define PTW32_LIBSTAT_ADD(stat, n) \
+  ((void) PTW32_INTERLOCKED_EXCHANGE_ADD_64 (&ptw32_libStats[(stat)], (LONG64) (n)))
+#define PTW32_LIBSTAT_WAIT(stat)	ptw32_libstat_wait (stat)
+#define PTW32_SETEVENT(h) \
+  (PTW32_LIBSTAT_ADD (PTW32_LIBSTAT_SET_EVENTS, 1), SetEvent (h))
+#define PTW32_RELEASESEMAPHORE(h, n, prev) \
+  (PTW32_LIBSTAT_ADD (PTW32_LIBSTAT_RELEASE_SEMAPHORES, 1), ReleaseSemaphore ((h), (n), (prev)))
+
+/*
+ * The performance counter set of a PTW32_PERFCOUNTERS build, which
+ * refers to the statistics above (see ptw32_perf.c).
+ */
+#if defined(PTW32_PERFCOUNTERS)
+#include <perflib.h>
+#endif
+
+/*
+ * Lock order and hold time checking of a PTW32_LOCKWATCH build (see
+ * ptw32_lockwatch.c). Each thread keeps the first PTW32_LOCKWATCH_DEPTH
+ * mutexes it holds and counts the rest; an order seen once is kept as
+ * an edge between the two mutexes' watchIds.
+ */
+#define PTW32_LOCKWATCH_DEPTH	16
+#define PTW32_LOCKWATCH_EDGES	4096	/* Power of 2 */
+
+typedef struct
+{
+  pthread_mutex_t mx;
+  LONG id;			/* mx->watchId, in case mx goes */
+  int64_t acquired;		/* Performance counter ticks */
+} ptw32_lockwatch_held_t;
+
+typedef struct
+{
+  LONG before;			/* 0: free */
+  LONG after;
+  int reported;
+} ptw32_lockwatch_edge_t;
+
+#if defined(PTW32_LOCKWATCH)
+#define PTW32_LOCKWATCH_ORDER(mx)	ptw32_lockwatch_order (mx)
+#define PTW32_LOCKWATCH_ACQUIRED(mx)	ptw32_lockwatch_acquired (mx)
+#define PTW32_LOCKWATCH_RELEASE(mx)	ptw32_lockwatch_release (mx)
+#define PTW32_LOCKWATCH_INIT(mx) \
+  ((mx)->watchId = (LONG) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_lockwatchNextId))
+#else
+#define PTW32_LOCKWATCH_ORDER(mx)	((void) 0)
+#define PTW32_LOCKWATCH_ACQUIRED(mx)	((void) 0)
+#define PTW32_LOCKWATCH_RELEASE(mx)	((void) 0)
+#define PTW32_LOCKWATCH_INIT(mx)	((void) 0)
+#endif
+
+#define PTW32_CACHE_LINE_SIZE 64
+
+/*
+ * Slabs for ptw32_object_alloc() (see ptw32_object_alloc.c). Blocks
+ * of up to PTW32_OBJECT_SLAB_MAX bytes, object and header, come from
+ * PTW32_OBJECT_SLAB_SIZE byte slabs, one size class per
+ * PTW32_OBJECT_GRANULE bytes. Each thread keeps up to
+ * PTW32_OBJECT_CACHE_MAX free blocks of a class and trades them with
+ * the class's free list PTW32_OBJECT_CACHE_BATCH at a time.
+ */
+#define PTW32_OBJECT_GRANULE	16
+#define PTW32_OBJECT_SLAB_MAX	512
+#define PTW32_OBJECT_SLAB_ALIGN	128
+#define PTW32_OBJECT_SLAB_SIZE	16384
+#define PTW32_OBJECT_CLASSES	(PTW32_OBJECT_SLAB_MAX / PTW32_OBJECT_GRANULE)
+#define PTW32_OBJECT_CACHE_MAX	32
+#define PTW32_OBJECT_CACHE_BATCH 16
+
+/*
+ * Whether large pages can be had, see ptw32_largepage.c.
+ */
+#define PTW32_LARGEPAGE_UNKNOWN	0
+#define PTW32_LARGEPAGE_READY	1
+#define PTW32_LARGEPAGE_NONE	2
+
+typedef struct
+{
+  ptw32_mcs_lock_t lock;
+  void * freeList;		/* Linked through each block's first word */
+  char pad[PTW32_CACHE_LINE_SIZE - 2 * sizeof (void *)];
+} ptw32_object_class_t;
+
+/*
+ * A thread's pthread_arena_alloc_np() blocks, newest first. A block
+ * is PTW32_ARENA_BLOCK_SIZE bytes, header included, or bigger for
+ * an allocation that won't fit one; allocations are rounded up to
+ * PTW32_ARENA_ALIGN bytes and cut from the newest block in turn.
+ */
+#define PTW32_ARENA_BLOCK_SIZE	65536
+#define PTW32_ARENA_ALIGN	16
+
+typedef struct ptw32_arena_block_t_ ptw32_arena_block_t;
+
+struct ptw32_arena_block_t_
+{
+  ptw32_arena_block_t * prev;	/* The next older block */
+  size_t size;			/* Bytes after the header */
+  size_t used;
+};
+
+#define PTW32_ARENA_HEADER \
+  ((sizeof (ptw32_arena_block_t) + PTW32_ARENA_ALIGN - 1) & ~((size_t) PTW32_ARENA_ALIGN - 1))
+
+/*
+ * A thread's record as a reader of RCU protected data, made the first
+ * time it goes online and kept, like attrCache, across reuse of its
+ * ptw32_thread_t. See pthread_rcu_synchronize_np.c.
+ */
+typedef struct ptw32_rcu_reader_t_ ptw32_rcu_reader_t;
+
+struct ptw32_rcu_reader_t_
+{
+  volatile LONG ctr;		/* ptw32_rcuGp at the last quiescent state,
+				   0 while offline */
+  ptw32_rcu_reader_t * next;	/* ptw32_rcuReaders */
+};
+
+/*
+ * A thread's hazard pointer slots and the pointers it has retired,
+ * made when it first protects or retires one and kept across reuse
+ * of its ptw32_thread_t. See ptw32_hazard.c.
+ */
+typedef struct
+{
+  void * p;
+  void (PTW32_CDECL * reclaim) (void *);
+} ptw32_hazard_retired_t;
+
+typedef struct ptw32_hazard_record_t_ ptw32_hazard_record_t;
+
+struct ptw32_hazard_record_t_
+{
+  void * volatile slots[PTHREAD_HAZARD_SLOTS_NP];
+  ptw32_hazard_record_t * next;	/* ptw32_hazardRecords, never unlinked */
+  ptw32_hazard_retired_t * retired;	/* owner thread only */
+  int nRetired;
+  int maxRetired;
+};
+
+/* Retired pointers a thread holds before it scans, at least */
+#define PTW32_HAZARD_SCAN_MIN 64
+
+/*
+ * A thread's entry in the wait-for graph, made the first time it
+ * blocks on a mutex and kept across reuse of its ptw32_thread_t.
+ * See ptw32_waitgraph.c.
+ */
+typedef struct ptw32_waitgraph_record_t_ ptw32_waitgraph_record_t;
+
+struct ptw32_waitgraph_record_t_
+{
+  pthread_mutex_t volatile mutex;	/* Blocked on, or NULL */
+  pthread_t thread;		/* Written before mutex is set */
+  ptw32_waitgraph_record_t * next;	/* ptw32_waitgraphRecords, never unlinked */
+};
+
+/*
+ * A thread's flight recorder: a ring of its latest PTW32_ETW_* events,
+ * made the first time it records one and kept across reuse of its
+ * ptw32_thread_t, which restarts it. The records are self-describing
+ * and hold no pointers but the list link, so they can be read from a
+ * crash dump: they are linked from ptw32_flightRecs and each starts
+ * with PTW32_FLIGHTREC_TAG. See ptw32_flightrec.c.
+ */
+#define PTW32_FLIGHTREC_EVENTS PTHREAD_FLIGHTREC_EVENTS_NP	/* A power of 2 */
+#define PTW32_FLIGHTREC_TAG "ptw32fr"
+
+typedef struct
+{
+  int64_t time;			/* QueryPerformanceCounter ticks */
+  const void * object;
+  int64_t value;
+  LONG event;			/* PTW32_ETW_* */
+  volatile LONG seq;		/* Position + 1, 0 while being written */
+} ptw32_flightrec_event_t;
+
+typedef struct ptw32_flightrec_t_ ptw32_flightrec_t;
+
+struct ptw32_flightrec_t_
+{
+  char tag[8];			/* PTW32_FLIGHTREC_TAG */
+  int64_t frequency;		/* Ticks per second of 'time' */
+  unsigned __int64 seqNumber;	/* Of the thread recording */
+  DWORD thread;			/* Its Windows thread ID */
+  volatile LONG next;		/* Position of the next event */
+  ptw32_flightrec_t * link;	/* ptw32_flightRecs, never unlinked */
+  ptw32_flightrec_event_t events[PTW32_FLIGHTREC_EVENTS];
+};
+
+/*
+ * A thread blocked in pthread_waitany_np, on its own stack. Posts to
+ * process private semaphores set the event of every one listed.
+ */
+typedef struct ptw32_waitany_waiter_t_ ptw32_waitany_waiter_t;
+
+struct ptw32_waitany_waiter_t_
+{
+  HANDLE event;			/* the thread's waitanyEvent */
+  ptw32_waitany_waiter_t * next;	/* ptw32_waitanyWaiters, under ptw32_waitany_lock */
+  ptw32_waitany_waiter_t * prev;
+};
+
+/* Only a semaphore post with waitany waiters takes the lock */
+#define PTW32_WAITANY_NOTIFY() \
+  do { if (ptw32_waitanyWaiters != NULL) ptw32_waitany_notify (); } while (0)
+
+/*
+ * Longest (ms) a cancelable pthread_wait_on_address_np sleeps before it
+ * looks for a cancel whose wakeup came before it was parked.
+ */
+#define PTW32_WAIT_ADDRESS_SLICE 100
+
+/*
+ * Longest (ms) pthread_join waits for a thread's exit notification
+ * before it looks at the thread's handle, in case the thread ended
+ * without one, by ExitThread or TerminateThread for instance.
+ */
+#define PTW32_JOIN_SLICE 100
+
+/*
+ * ptw32_yield backoff: the first PTW32_YIELD_SWITCHES yields of a wait
+ * go to any ready thread on the processor, those up to
+ * PTW32_YIELD_SLEEPS to others of at least the caller's priority, and
+ * later ones sleep for a tick so that anything can run.
+ */
+#define PTW32_YIELD_SWITCHES 4
+#define PTW32_YIELD_SLEEPS 16
+
+/* A longer (ms) gap between sched_yield calls starts a new backoff */
+#define PTW32_YIELD_RESET 50
+
+/* Polls of a reader before pthread_rcu_synchronize_np sleeps */
+#define PTW32_RCU_SPIN 1000
+
+/* A quiescent state also puts an offline reader online */
+#define PTW32_RCU_ONLINE(r) \
+  ((void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &(r)->ctr, \
+                                           (PTW32_INTERLOCKED_LONG) ptw32_rcuGp))
+#define PTW32_RCU_OFFLINE(r) \
+  ((void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &(r)->ctr, \
+                                           (PTW32_INTERLOCKED_LONG) 0))
+
+/*
+ * The fields touched by every create, exit, join and cancellation
+ * test come first so that they share as few cache lines as possible;
+ * the rarely used ones follow.
+ *
+ * A struct is reset field by field when it is queued for reuse (see
+ * ptw32_threadReusePush); a new field must be reset there unless
+ * ptw32_new always sets it.
+ */
+/*
+ * Bits of ptw32_thread_t.testCancel, set while pthread_testcancel has
+ * something to do for the thread. The inline pthread_testcancel in
+ * pthread.h calls the library only if one is set.
+ */
+#define PTW32_TESTCANCEL_CANCEL 1	/* Cancel pending and enabled */
+#define PTW32_TESTCANCEL_SIGNAL 2	/* pthread_kill signals pending */
+#define PTW32_TESTCANCEL_RCU    4	/* An RCU reader, see ptw32_rcu.c */
+
+/*
+ * Attempts pthread_cancel makes at aborting the I/O of a thread in a
+ * cancelable I/O region that hasn't started its I/O call yet.
+ */
+#define PTW32_CANCEL_IO_TRIES 10
+
+/*
+ * SCHED_FIFO and SCHED_RR priorities are the base priority levels of
+ * REALTIME_PRIORITY_CLASS. They lie above the SCHED_OTHER priorities
+ * (THREAD_PRIORITY_IDLE to THREAD_PRIORITY_TIME_CRITICAL), so the
+ * priorities of threads of either policy compare directly.
+ */
+#define PTW32_SCHED_RT_PRIORITY_MIN 16
+#define PTW32_SCHED_RT_PRIORITY_MAX 31
 
 struct ptw32_thread_t_
 {
-  unsigned __int64 seqNumber;	/* Process-unique thread sequence number */
-  HANDLE threadH;		/* Win32 thread handle - POSIX thread is invalid if threadH == 0 */
+  /* Hot */
   pthread_t ptHandle;		/* This thread's permanent pthread_t handle */
-  ptw32_thread_t * prevReuse;	/* Links threads on reuse stack */
+  volatile LONG testCancel;	/* PTW32_TESTCANCEL_*: mirrored in pthread.h, keep second */
+  HANDLE threadH;		/* Win32 thread handle - POSIX thread is invalid if threadH == 0,
+				 * unless implicit: see PTW32_THREAD_HANDLE */
   volatile PThreadState state;
+  int detachState;
   ptw32_mcs_lock_t threadLock;	/* Used for serialised access to public thread state */
   ptw32_mcs_lock_t stateLock;	/* Used for async-cancel safety */
-  HANDLE cancelEvent;
+  HANDLE cancelEvent;		/* NULL until needed, see ptw32_cancel_event */
+  int cancelState;
+  int cancelType;
   void *exitStatus;
-  void *parms;
-  void *keys;
-  void *nextAssoc;
+  ThreadParms parms;		/* Passed to ptw32_threadStart */
+  ptw32_thread_t * prevReuse;	/* Links threads on reuse stack */
+  HANDLE mcsEvent;		/* Cached MCS lock wait event */
+  unsigned int * dtorBits;	/* NULL: the bits are in dtorBitsInline */
+  unsigned int nDtorWords;
+  unsigned int dtorFirst;	/* Meaningless while dtorLimit is 0 */
+  unsigned int dtorLimit;
+  unsigned int dtorBitsInline[PTW32_TSD_DTOR_INLINE_WORDS];
+
+  /* Cold */
+  unsigned __int64 seqNumber;	/* Process-unique thread sequence number */
+  DWORD thread;			/* Windows thread ID */
+  int ptErrno;
+  ptw32_cleanup_t * cleanupStack;	/* Innermost ptw32_push_cleanup handler */
+  int sched_priority;		/* As set, not as currently is */
+  int sched_policy;
+  int implicit:1;
+  ptw32_robust_node_t*
+                  robustMxList; /* List of currenty held robust mutexes */
+  ptw32_mutex_prio_t *
+                  prioMxList;	/* Held PTHREAD_PRIO_INHERIT/PROTECT
+				   mutexes (see ptw32_mutex_prio.c) */
+  int boostPriority;		/* Priority they lend the thread, or
+				   PTW32_PRIO_NO_BOOST */
+  unsigned __int64 waits;	/* Blocking waits in the library, by the thread */
+  int64_t waitTime;		/* Their performance counter ticks */
+  int waitStat;			/* PTW32_LIBSTAT_WAIT_* of the wait begun */
+  int waitHist;			/* PTHREAD_HIST_*_NP of the wait begun */
+  ptw32_hist_record_t * hist;	/* NULL until the thread blocks */
+  volatile LONG blocked;	/* In a blocking library wait, so not on
+				   a processor (see pthread_spin_lock.c) */
+  pthread_pool_np_t pool;	/* Pool the thread is a worker of, or NULL */
+  int poolBlocked;		/* Counted in pool->nBlocked (see ptw32_pool.c) */
+  int cpuToken;			/* PTW32_CPUTOKEN_*, a pool worker's token */
+  int largePage;		/* Cut from large pages, see ptw32_largepage.c */
+  int yields;			/* PTHREAD_YIELD_BACKOFF_NP sched_yield count */
+  DWORD yieldTick;		/* GetTickCount() at the last one */
+  unsigned __int64 cancelRequests;	/* Under stateLock */
+  volatile LONG sigPending;	/* pthread_kill signals not yet delivered */
+  volatile LONG ioCancel;	/* pthread_io_begin_np region depth */
+  char name[PTHREAD_MAX_NAMELEN_NP];	/* Thread name, under threadLock */
+  double payload[PTHREAD_PAYLOAD_MAX_NP / sizeof (double)];	/* pthread_create_payload_np copy */
+  HANDLE waitTimer;		/* High resolution timeout timer, created on first use */
+  pthread_attr_t attrCache;	/* Last attr destroyed by this thread, kept across reuse */
+  void * objectCache[PTW32_OBJECT_CLASSES];	/* Free blocks, see ptw32_object_alloc.c */
+  unsigned char nObjectCache[PTW32_OBJECT_CLASSES];
+  HANDLE exitEvent;		/* Signals a cached thread's end, kept across reuse */
+  ptw32_rcu_reader_t * rcuReader;	/* NULL until the thread reads under RCU */
+  ptw32_hazard_record_t * hazards;	/* NULL until the thread uses hazard pointers */
+  ptw32_arena_block_t * arena;	/* NULL until the thread calls pthread_arena_alloc_np */
+  ptw32_waitgraph_record_t * waitgraph;	/* NULL until the thread blocks on a mutex */
+  ptw32_flightrec_t * flightRec;	/* NULL until the thread records an event */
+  volatile VOID * waitAddress;	/* Under stateLock: pthread_wait_on_address_np location */
+  HANDLE waitanyEvent;		/* pthread_waitany_np wakeups, created on first use */
+  void (PTW32_CDECL * joinCallback) (pthread_t, void *, void *);	/* Under stateLock: pthread_join_async_np */
+  void * joinArg;
+  volatile LONG * joinCount;	/* Under stateLock: pthread_join_n_np */
+  pthread_group_np_t group;	/* Under stateLock: see pthread_group_add_np */
+  ptw32_thread_t * groupNext;	/* Under the group's lock */
+  ptw32_thread_t * groupPrev;
+  int cached;			/* Runs on an OS thread that may park in the thread cache, or is a fiber */
+  volatile LONG exited;		/* An uncached thread is done with the struct, see pthread_join */
+  ptw32_fiber_t fiber;		/* PTHREAD_SCOPE_PROCESS */
+#if defined(PTW32_LOCKWATCH)
+  int nHeld;			/* Entries in held[] */
+  int nUntracked;		/* Mutexes held above held[] */
+  ptw32_lockwatch_held_t held[PTW32_LOCKWATCH_DEPTH];
+#endif
 #if defined(__CLEANUP_C)
   jmp_buf start_mark;		/* Jump buffer follows void* so should be aligned */
 #endif				/* __CLEANUP_C */
+#if defined(HAVE_CPU_AFFINITY)
+  cpu_set_t cpuset;		/* Thread CPU affinity set */
+  cpu_set_t softCpuset;		/* Preferred CPUs, empty for none */
+#endif
+  int qos;			/* PTHREAD_QOS_*_NP */
+  int wakeBoost;		/* Zero: no priority boost when woken */
+#if defined(PTW32_COND_WAITONADDRESS)
+  LONG * condWaitAddress;	/* Condvar sequence parked on, if any */
+#endif
 #if defined(HAVE_SIGSET_T)
   sigset_t sigmask;
 #endif				/* HAVE_SIGSET_T */
-  ptw32_mcs_lock_t
-              robustMxListLock; /* robustMxList lock */
-  ptw32_robust_node_t*
-                  robustMxList; /* List of currenty held robust mutexes */
-  int ptErrno;
-  int detachState;
-  int sched_priority;		/* As set, not as currently is */
-  int cancelState;
-  int cancelType;
-  int implicit:1;
-  DWORD thread;			/* Windows thread ID */
-#if defined(HAVE_CPU_AFFINITY)
-  size_t cpuset;		/* Thread CPU affinity set */
-#endif
-  char * name;                  /* Thread name */
 #if defined(_UWIN)
   DWORD dummy[5];
 #endif
   size_t align;			/* Force alignment if this struct is packed */
 };
 
+/*
+ * What join and detach wait on for the thread to finish. A cached
+ * thread's OS thread outlives it, and a fiber has none, so their end
+ * is signalled by an event.
+ */
+#define PTW32_THREAD_EXIT_HANDLE(tp) \
+  ((tp)->cached ? (tp)->exitEvent : (tp)->threadH)
+
 
 /*
  * Special value to mark attribute objects as valid.
  */
 #define PTW32_ATTR_VALID ((unsigned long) 0xC4C0FFEE)
 
+/*
+ * An attribute object set to its PTHREAD_*ATTR_INITIALIZER_NP value
+ * holds the defaults without pointing to anything. Getters and the
+ * functions the object is passed to read the type's ptw32_*_default
+ * instead; the first setter replaces it with an allocated object.
+ */
+#define PTW32_ATTR_IS_INITIALIZER(a) ((size_t) (a) == (size_t) -1)
+#define PTW32_ATTR_READ(a, def) (PTW32_ATTR_IS_INITIALIZER (a) ? &(def) : (a))
+#define PTW32_ATTR_NEED_INIT(attr, init) \
+  ((attr) != NULL && PTW32_ATTR_IS_INITIALIZER (*(attr)) ? (init) (attr) : 0)
+
 struct pthread_attr_t_
 {
   unsigned long valid;
   void *stackaddr;
   size_t stacksize;
+  size_t stackcommit;		/* 0 unless set */
+  size_t guardsize;
   int detachstate;
   struct sched_param param;
+  int schedpolicy;
   int inheritsched;
   int contentionscope;
-  size_t cpuset;
+  cpu_set_t cpuset;
+  int qos;
+  int numanode;			/* -1 unless set */
+  int pooled;			/* Run on the thread pool if detached */
   char * thrname;
 #if defined(HAVE_SIGSET_T)
   sigset_t sigmask;
@@ -266,19 +1051,190 @@ struct pthread_attr_t_
  * ====================
  */
 
+/*
+ * Unless NEED_SEM is defined, "value" is only changed with interlocked
+ * operations. A negative value counts the threads blocked (or about
+ * to block) on the kernel semaphore "sem", which is only released when
+ * a post finds the value negative. "lock" is then only used by
+ * sem_destroy().
+ */
+
+/*
+ * A FIFO semaphore (sem_init_np SEM_FIFO_NP or SEM_PRIORITY_NP) queues
+ * its blocked waiters instead of using "sem", and a post hands its
+ * units to the waiters at the head of the queue. See ptw32_sem_fifo.c.
+ */
+typedef struct ptw32_sem_waiter_t_ ptw32_sem_waiter_t;
+
+struct ptw32_sem_waiter_t_
+{
+  ptw32_sem_waiter_t * next;
+  volatile LONG state;		/* PTW32_SEM_WAITER_* */
+  int priority;			/* PTW32_WAIT_PRIORITY when queued */
+};
+
+#define PTW32_SEM_WAITER_QUEUED  0
+#define PTW32_SEM_WAITER_GRANTED 1	/* A post handed over a unit */
+
+typedef struct ptw32_sem_fifo_t_
+{
+  ptw32_mcs_lock_t lock;	/* Guards the queue and a negative value */
+  ptw32_sem_waiter_t * head;	/* Next to be handed a unit */
+  ptw32_sem_waiter_t * tail;
+  int byPriority;		/* Highest priority first, then FIFO */
+} ptw32_sem_fifo_t;
+
 struct sem_t_
 {
-  int value;
+  LONG value;
   ptw32_mcs_lock_t lock;
   HANDLE sem;
+  LONG refs;			/* See ptw32_sem_release.c */
 #if defined(NEED_SEM)
   int leftToUnblock;
 #endif
+  ptw32_sem_fifo_t * fifo;	/* Waiter queue of a FIFO semaphore,
+				   NULL otherwise */
 };
 
 #define PTW32_OBJECT_AUTO_INIT ((void *)(size_t) -1)
 #define PTW32_OBJECT_INVALID   NULL
 
+enum ptw32_robust_state_t_
+{
+  PTW32_ROBUST_CONSISTENT,
+  PTW32_ROBUST_INCONSISTENT,
+  PTW32_ROBUST_NOTRECOVERABLE
+};
+
+typedef enum ptw32_robust_state_t_   ptw32_robust_state_t;
+
+/*
+ * Node used to manage per-thread lists of currently-held robust mutexes.
+ * It is part of the mutex. A thread's list is only changed by the
+ * thread itself, when it locks or unlocks a robust mutex and when it
+ * exits, so the list needs no lock.
+ */
+struct ptw32_robust_node_t_
+{
+  pthread_mutex_t mx;
+  ptw32_robust_state_t stateInconsistent;
+  ptw32_robust_node_t* prev;
+  ptw32_robust_node_t* next;
+};
+
+/*
+ * lock_idx, recursive_count and kind lead the structure and are
+ * mirrored by struct ptw32_inline_mutex_t_ in pthread.h for the
+ * PTW32_INLINE_LOCKS fast paths, as are interlock and the
+ * PTW32_SPIN_* values for spinlocks.
+ */
+/*
+ * A thread queued on a fair mutex. Lives on the waiting thread's
+ * stack; 'state' is the address the thread waits on.
+ */
+typedef struct ptw32_mutex_waiter_t_ ptw32_mutex_waiter_t;
+
+struct ptw32_mutex_waiter_t_
+{
+  ptw32_mutex_waiter_t * next;
+  volatile LONG state;		/* PTW32_MUTEX_WAITER_* */
+  int64_t start;		/* Performance counter when first queued */
+  int priority;			/* PTW32_WAIT_PRIORITY when queued */
+};
+
+#define PTW32_MUTEX_WAITER_QUEUED  0
+#define PTW32_MUTEX_WAITER_GRANTED 1	/* Unlock handed the mutex over */
+#define PTW32_MUTEX_WAITER_RETRY   2	/* Unlock freed the mutex, try again */
+
+typedef struct ptw32_mutex_fair_t_
+{
+  ptw32_mcs_lock_t lock;	/* Guards the queue and lock_idx -1, -2 */
+  ptw32_mutex_waiter_t * head;	/* Longest waiter */
+  ptw32_mutex_waiter_t * tail;
+  int fairness;			/* PTHREAD_MUTEX_FAIR_NP,
+				   PTHREAD_MUTEX_EVENTUALLY_FAIR_NP or
+				   PTHREAD_MUTEX_PRIORITY_NP */
+} ptw32_mutex_fair_t;
+
+/*
+ * A thread blocked on a PTHREAD_PRIO_INHERIT mutex, on its stack.
+ */
+typedef struct ptw32_mutex_prio_waiter_t_ ptw32_mutex_prio_waiter_t;
+
+struct ptw32_mutex_prio_waiter_t_
+{
+  ptw32_mutex_prio_waiter_t * next;
+  ptw32_mutex_prio_waiter_t * prev;
+  int priority;			/* The waiter's effective priority */
+};
+
+/*
+ * Priority protocol state of a mutex. All of it, and the prioMxList
+ * and boostPriority of every thread, is guarded by ptw32_mutex_prio_lock.
+ */
+struct ptw32_mutex_prio_t_
+{
+  int protocol;			/* PTHREAD_PRIO_INHERIT or PTHREAD_PRIO_PROTECT */
+  int ceiling;			/* Priority ceiling (PTHREAD_PRIO_PROTECT) */
+  ptw32_thread_t * owner;	/* NULL if the mutex is free */
+  ptw32_mutex_prio_waiter_t * waiters;
+  ptw32_mutex_prio_t * next;	/* In the owner's prioMxList */
+  ptw32_mutex_prio_t * prev;
+};
+
+#define PTW32_PRIO_NO_BOOST INT_MIN
+
+/*
+ * Elision state of a PTHREAD_MUTEX_ELIDE_NP mutex or PTHREAD_RWLOCK_ELIDE_NP
+ * read/write lock, kept apart from the lock word: it is written on
+ * aborts, which mustn't abort the transactions that read the lock word.
+ * Neither field is updated atomically. See ptw32_lock_elide.c.
+ */
+typedef struct ptw32_lock_elide_t_
+{
+  LONG skip;			/* Acquisitions left to make without eliding */
+  LONG penalty;			/* skip to set at the next abort */
+  char pad[PTW32_CACHE_LINE_SIZE - 2 * sizeof (LONG)];
+} ptw32_lock_elide_t;
+
+#define PTW32_ELIDE_RETRIES      3	/* Attempts after transient aborts */
+#define PTW32_ELIDE_PENALTY_MIN  1
+#define PTW32_ELIDE_PENALTY_MAX  (1 << 16)
+
+/*
+ * The default priority ceiling: the highest thread priority, so that
+ * no thread is refused the mutex.
+ */
+#define PTW32_PRIO_CEILING_DEFAULT PTW32_SCHED_RT_PRIORITY_MAX
+
+/*
+ * Bookkeeping around an acquisition and a release of a mutex, which
+ * only priority protocol mutexes need.
+ */
+#define PTW32_MUTEX_PRIO_ACQUIRED(mx) \
+  do { if ((mx)->prio != NULL) ptw32_mutex_prio_acquired (mx); } while (0)
+#define PTW32_MUTEX_PRIO_RELEASE(mx) \
+  do { if ((mx)->prio != NULL) ptw32_mutex_prio_release (mx); } while (0)
+
+/*
+ * lock_idx of a fair mutex that an unlock freed for a waiter it
+ * woke to retry, with other threads still queued.
+ */
+#define PTW32_MUTEX_FREE_QUEUED (-2)
+
+/*
+ * lock_idx of a cohort mutex taken by a thread that queued for it,
+ * so that its unlock comes to the library.
+ */
+#define PTW32_MUTEX_COHORT_HELD 2
+
+/*
+ * An eventually fair mutex hands over to a waiter that has been
+ * queued this long.
+ */
+#define PTW32_MUTEX_STARVATION_MS 1
+
 struct pthread_mutex_t_
 {
   LONG lock_idx;		/* Provides exclusive access to mutex state
@@ -286,130 +1242,705 @@ struct pthread_mutex_t_
 				    0: unlocked/free.
 				    1: locked - no other waiters.
 				   -1: locked - with possible other waiters.
+				   -2: unlocked - fair mutex with waiters
+				       (PTW32_MUTEX_FREE_QUEUED).
+				    2: locked - cohort mutex owner that
+				       queued (PTW32_MUTEX_COHORT_HELD).
 				*/
   int recursive_count;		/* Number of unlocks a thread needs to perform
 				   before the lock is released (recursive
 				   mutexes only). */
   int kind;			/* Mutex type. */
+  int fastKind;			/* kind if the mutex has nothing but the
+				   plain lock_idx protocol (no robustness,
+				   elision, fairness, cohort, priority
+				   protocol or instrumentation), else -1.
+				   See pthread_mutex_kind_np.c. */
   pthread_t ownerThread;
   HANDLE event;			/* Mutex release notification to waiting
 				   threads. */
-  ptw32_robust_node_t*
+  LONG parked;			/* Threads in ptw32_mutex_wait(), so
+				   that a release only wakes if there
+				   are any. See ptw32_mutex_wait.c. */
+  ptw32_robust_node_t
                     robustNode; /* Extra state for robust mutexes  */
+  int spinLimit;		/* Upper bound on the number of spins
+				   before blocking (0: block immediately). */
+  int spinEstimate;		/* Running average of the spins needed
+				   to acquire the lock (adaptive). */
+  ptw32_mutex_fair_t * fair;	/* Waiter queue of a fair mutex, NULL
+				   if the mutex is barging (default).
+				   See ptw32_mutex_fair.c. */
+  ptw32_mutex_cohort_t * cohort;	/* NUMA node queues of a cohort mutex,
+				   NULL unless the fairness attribute is
+				   PTHREAD_MUTEX_NUMA_COHORT_NP. */
+  ptw32_mutex_prio_t * prio;	/* Priority protocol state, NULL for
+				   PTHREAD_PRIO_NONE (default). */
+  ptw32_lock_elide_t * elide;	/* Elision state, NULL unless kind is
+				   PTHREAD_MUTEX_ELIDE_NP. */
+#if defined(PTW32_COND_WAITONADDRESS)
+  pthread_cond_t morphCond;	/* Condition variable with a broadcast
+				   waiter to wake at the next unlock
+				   (owner access only). */
+#endif
+#if defined(PTW32_LOCKSTAT)
+  ptw32_lockstat_t stats;
+#endif
+#if defined(PTW32_LOCKWATCH)
+  LONG watchId;			/* Names the mutex in lock order edges */
+#endif
+  int inPlace;			/* In application storage, not freed
+				   (see pthread_mutex_init_storage_np). */
 };
 
-enum ptw32_robust_state_t_
+struct pthread_mutexattr_t_
 {
-  PTW32_ROBUST_CONSISTENT,
-  PTW32_ROBUST_INCONSISTENT,
-  PTW32_ROBUST_NOTRECOVERABLE
+  int pshared;
+  int kind;
+  int robustness;
+  int spin;
+  int fairness;
+  int protocol;
+  int prioceiling;
 };
 
-typedef enum ptw32_robust_state_t_   ptw32_robust_state_t;
+/*
+ * Possible values, other than PTW32_OBJECT_INVALID,
+ * for the "interlock" element in a spinlock.
+ *
+ * In this implementation, when a spinlock is initialised,
+ * the number of cpus available to the process is checked.
+ * If there is only one cpu then "interlock" is set equal to
+ * PTW32_SPIN_USE_MUTEX and u.mutex is an initialised mutex.
+ * If the number of cpus is greater than 1 then "interlock"
+ * is set equal to PTW32_SPIN_UNLOCKED and the number is
+ * stored in u.cpus. This arrangement allows the spinlock
+ * routines to attempt an InterlockedCompareExchange on "interlock"
+ * immediately and, if that fails, to try the inferior mutex.
+ *
+ * "u.cpus" isn't used for anything yet, but could be used at
+ * some point to optimise spinlock behaviour.
+ *
+ * A ticket spinlock (see pthread_spin_init_np) has "interlock" set
+ * permanently to PTW32_SPIN_USE_TICKET and is locked through
+ * ticketNext and ticketOwner instead.
+ */
+#define PTW32_SPIN_INVALID     (0)
+#define PTW32_SPIN_UNLOCKED    (1)
+#define PTW32_SPIN_LOCKED      (2)
+#define PTW32_SPIN_USE_MUTEX   (3)
+#define PTW32_SPIN_USE_TICKET  (4)
+
+struct pthread_spinlock_t_
+{
+  long interlock;		/* Locking element for multi-cpus. */
+  union
+  {
+    int cpus;			/* No. of cpus if multi cpus, or   */
+    pthread_mutex_t mutex;	/* mutex if single cpu.            */
+  } u;
+  LONG ticketNext;		/* Next ticket to hand out.        */
+  LONG ticketOwner;		/* Ticket now holding the lock.    */
+  ptw32_thread_t * volatile owner;	/* Holder, if a POSIX thread: a hint
+				   for waiters, see pthread_spin_lock.c */
+  int inPlace;			/* In application storage, not freed. */
+};
 
 /*
- * Node used to manage per-thread lists of currently-held robust mutexes.
+ * A reader-writer spin lock is one word, "state", using the
+ * PTW32_SPIN_* values of a spinlock's "interlock": PTW32_SPIN_INVALID
+ * once destroyed, PTW32_SPIN_LOCKED while a writer holds it, and
+ * otherwise PTW32_SPIN_UNLOCKED plus PTW32_RWSPIN_READER for each
+ * reader holding it, with PTW32_RWSPIN_WRITER_WAITING set while a
+ * writer waits for the readers to leave. See pthread_rwspin_init_np.c.
  */
-struct ptw32_robust_node_t_
+#define PTW32_RWSPIN_WRITER_WAITING	(4)
+#define PTW32_RWSPIN_READER		(8)
+#define PTW32_RWSPIN_MAX_STATE		(0x7FFFFFFF - PTW32_RWSPIN_READER)
+
+/* Readers may join: no writer holds the lock or is waiting for it */
+#define PTW32_RWSPIN_READABLE(s) \
+  (((s) & (PTW32_SPIN_UNLOCKED | PTW32_RWSPIN_WRITER_WAITING)) == PTW32_SPIN_UNLOCKED)
+
+struct pthread_rwspinlock_np_t_
 {
-  pthread_mutex_t mx;
-  ptw32_robust_state_t stateInconsistent;
-  ptw32_robust_node_t* prev;
-  ptw32_robust_node_t* next;
+  volatile LONG state;
+};
+
+/* A waiter's backoff, see ptw32_rwspin_wait() */
+typedef struct
+{
+  int backoff;
+  int pays;
+  long spun;
+} ptw32_rwspin_wait_t;
+
+/*
+ * MCS lock queue node - see ptw32_MCS_lock.c. Mirrored by
+ * struct pthread_mcs_node_np_t_ in pthread.h for the public
+ * pthread_mcs_*_np() functions.
+ */
+struct ptw32_mcs_node_t_
+{
+  struct ptw32_mcs_node_t_ **lock;        /* ptr to tail of queue */
+  struct ptw32_mcs_node_t_  *next;        /* ptr to successor in queue */
+  HANDLE                     readyFlag;   /* set after lock is released by
+                                             predecessor */
+  HANDLE                     nextFlag;    /* set after 'next' ptr is set by
+                                             successor */
+};
+
+/*
+ * The threads of one NUMA node queued on a cohort mutex, on a cache
+ * line of their own.
+ */
+typedef struct ptw32_mutex_cohort_node_t_
+{
+  ptw32_mcs_lock_t lock;	/* Queue of the node's threads */
+  ptw32_mcs_local_node_t owner;	/* Queue entry of the thread at its head */
+  LONG passed;			/* The head was handed the mutex */
+  LONG handoffs;		/* Consecutive handoffs within the node */
+  char pad[PTW32_CACHE_LINE_SIZE - sizeof (ptw32_mcs_lock_t)
+           - sizeof (ptw32_mcs_local_node_t) - 2 * sizeof (LONG)];
+} ptw32_mutex_cohort_node_t;
+
+/*
+ * A cohort mutex (PTHREAD_MUTEX_NUMA_COHORT_NP). The nodes follow the
+ * structure, from the next cache line. See ptw32_mutex_cohort.c.
+ */
+struct ptw32_mutex_cohort_t_
+{
+  ptw32_mcs_lock_t lock;	/* Queue of the nodes' heads */
+  ptw32_mcs_local_node_t owner;	/* Queue entry of the head that has it */
+  int held;			/* Node of the owner, -1 if the owner
+				   didn't queue (owner access only) */
+  int nNodes;
+  ptw32_mutex_cohort_node_t * nodes;
+};
+
+/*
+ * Handoffs within a NUMA node before a cohort mutex passes to
+ * another node.
+ */
+#define PTW32_MUTEX_COHORT_HANDOFFS 64
+
+
+/*
+ * A node of a combining tree barrier (PTHREAD_BARRIER_TREE_NP).
+ * Arrivals are spread over the leaves; the thread that completes a
+ * node arrives at its parent. Each node has a cache line to itself.
+ */
+#define PTW32_BARRIER_TREE_FANIN 4
+
+typedef struct
+{
+  LONG count;			/* arrivals this cycle */
+  LONG width;			/* arrivals that complete the node */
+  int parent;			/* index in nodes, -1 for the root */
+  char pad[PTW32_CACHE_LINE_SIZE - 2 * sizeof (LONG) - sizeof (int)];
+} ptw32_barrier_node_t;
+
+/*
+ * Nanoseconds a combining tree barrier waiter polls for the release
+ * before it parks with WaitOnAddress (see ptw32_spin_calibrate.c).
+ */
+#define PTW32_BARRIER_SPIN_NS 16000
+
+struct pthread_barrier_t_
+{
+  unsigned int nCurrentBarrierHeight;
+  unsigned int nInitialBarrierHeight;
+  int pshared;
+  sem_t semBarrierBreeched;
+  ptw32_mcs_lock_t lock;
+  ptw32_mcs_local_node_t proxynode;
+  int kind;			/* PTHREAD_BARRIER_DEFAULT_NP uses the    */
+				/* semaphore and lock above; the tree     */
+				/* kind uses the fields below.            */
+  ptw32_barrier_node_t * nodes;
+  int nLeaves;
+  LONG cycle;			/* incremented as each cycle ends; */
+				/* tree waiters park on it         */
+  LONG nParked;			/* waiters in WaitOnAddress */
+};
+
+/*
+ * Count-down latches (pthread_latch_*_np). Waiters are counted from
+ * before they look at 'released' until they are done with the latch,
+ * so that destroying it can wait for released ones to leave.
+ */
+struct pthread_latch_np_t_
+{
+  volatile LONG count;		/* arrivals still expected */
+  volatile LONG released;	/* set once count reaches 0 */
+  volatile LONG nWaiting;
+};
+
+/*
+ * Phasers (pthread_phaser_*_np). 'state' holds the phase, the number
+ * of registered parties and the number yet to arrive, so that
+ * registering and arriving are each one compare-exchange. 'phase'
+ * follows the phase in state and is what waiters park on. Waiters are
+ * counted by the parity of the phase they wait for, which tells the
+ * waiters of the current phase from those just released.
+ */
+struct pthread_phaser_np_t_
+{
+  volatile LONG64 state;
+  volatile LONG phase;
+  volatile LONG nWaiting[2];
+};
+
+#define PTW32_PHASER_PHASE(s)      ((ULONG) ((ULONG64) (s) >> 32))
+#define PTW32_PHASER_PARTIES(s)    ((unsigned int) (((ULONG64) (s) >> 16) & 0xFFFF))
+#define PTW32_PHASER_UNARRIVED(s)  ((unsigned int) ((ULONG64) (s) & 0xFFFF))
+#define PTW32_PHASER_STATE(phase, parties, unarrived) \
+  ((LONG64) (((ULONG64) (ULONG) (phase) << 32) \
+             | ((ULONG64) (parties) << 16) | (ULONG64) (unarrived)))
+
+/*
+ * Thread groups (pthread_group_*_np). The lock orders after
+ * ptw32_thread_reuse_lock and before the members' locks. A member
+ * stays on the list until its struct is about to be reused, so the
+ * group's lock keeps every member's struct and handles valid.
+ */
+struct pthread_group_np_t_
+{
+  ptw32_mcs_lock_t lock;
+  ptw32_thread_t * members;	/* linked by groupNext and groupPrev */
+  int nMembers;
+  int cancelled;		/* pthread_group_cancel_np() has been called */
+};
+
+/* tp->group of a thread that is being destroyed */
+#define PTW32_GROUP_CLOSED ((pthread_group_np_t) (size_t) -1)
+
+struct pthread_barrierattr_t_
+{
+  int pshared;
+  int kind;
 };
 
-struct pthread_mutexattr_t_
+/*
+ * Process shared (PTHREAD_PROCESS_SHARED) mutexes, condition
+ * variables, semaphores and barriers keep their state in a slot of a
+ * named file mapping, an arena, and the object itself holds only the
+ * slot's id, tagged so that it can't be taken for a pointer or a
+ * static initialiser. Ids are handed out by a counter in the first
+ * slot of arena 0 and are never reused. See ptw32_pshared.c.
+ */
+#define PTW32_PSHARED_ARENAS  1024
+#define PTW32_PSHARED_SLOTS   1024	/* per arena */
+
+/*
+ * Milliseconds a waiter for a robust process shared mutex waits
+ * between looks at whether its owner has died. See
+ * ptw32_pshared_mutex.c.
+ */
+#define PTW32_PSHARED_ROBUST_POLL 5
+
+#define PTW32_PSHARED_HANDLE(id) ((void *) (((size_t) (id) << 2) | 2))
+#define PTW32_PSHARED_ID(h)      ((LONG) ((size_t) (h) >> 2))
+#define PTW32_IS_PSHARED(h) \
+  ((((size_t) (h)) & 3) == 2 \
+   && ((size_t) (h)) < ((size_t) PTW32_PSHARED_ARENAS * PTW32_PSHARED_SLOTS << 2))
+
+enum
+{
+  PTW32_PSHARED_FREE = 0,
+  PTW32_PSHARED_MUTEX,
+  PTW32_PSHARED_COND,
+  PTW32_PSHARED_SEM,
+  PTW32_PSHARED_BARRIER
+};
+
+typedef union
+{
+  struct
+  {
+    LONG type;			/* PTW32_PSHARED_* */
+    union
+    {
+      struct
+      {
+	LONG nextId;		/* slot 0 of arena 0 only */
+      } dir;
+      struct
+      {
+	LONG lock_idx;		/* as pthread_mutex_t_ */
+	LONG recursive_count;
+	LONG kind;
+	DWORD ownerThread;	/* Win32 thread id */
+	DWORD ownerProcess;	/* Win32 process id, robust mutexes */
+	LONG robustness;	/* PTHREAD_MUTEX_ROBUST or _STALLED */
+	LONG state;		/* PTW32_ROBUST_*, robust mutexes */
+      } mutex;
+      struct
+      {
+	LONG value;		/* -(number of waiters) if negative */
+	LONG clock;
+      } cond;
+      struct
+      {
+	LONG value;		/* as sem_t_ */
+	LONG refs;		/* named: the name and each opener */
+      } sem;
+      struct
+      {
+	LONG height;
+	LONG remaining;
+	LONG cycle;
+      } barrier;
+    } u;
+  } s;
+  char pad[PTW32_CACHE_LINE_SIZE];
+} ptw32_pshared_slot_t;
+
+/*
+ * A process's view of an arena, with the kernel objects it has opened
+ * for each slot: an auto-reset event for mutexes, semaphores for the
+ * others.
+ */
+typedef struct
+{
+  HANDLE mapping;
+  ptw32_pshared_slot_t * slots;
+  HANDLE kernel[PTW32_PSHARED_SLOTS][2];
+} ptw32_pshared_arena_t;
+
+/*
+ * Named semaphores (sem_open) are process shared semaphores whose id
+ * is kept in a small mapping named after the semaphore. The mapping is
+ * looked up by name under its spin lock. See sem_open.c.
+ */
+#define PTW32_SEM_NAME_MAX 200
+
+#if !defined(ENAMETOOLONG)
+#  define ENAMETOOLONG EINVAL
+#endif
+
+typedef struct
+{
+  LONG lock;			/* 1 while held */
+  LONG id;			/* 0 if there is no such semaphore */
+} ptw32_sem_name_t;
+
+/*
+ * A named semaphore open in this process. sem_open returns &sem.
+ */
+typedef struct ptw32_named_sem_t_ ptw32_named_sem_t;
+
+struct ptw32_named_sem_t_
+{
+  sem_t sem;			/* the process shared handle */
+  HANDLE mapping;
+  ptw32_sem_name_t * name;
+  int opens;			/* sem_open calls not yet closed */
+  ptw32_named_sem_t * next;
+};
+
+/*
+ * Work-stealing deques (Chase-Lev), for pthread_wsdeque_*_np and the
+ * pool workers. The owner pushes and pops at 'bottom', thieves take
+ * from 'top'; the two ends are in separate cache lines. Arrays
+ * replaced by a bigger one stay on the 'prev' list until the deque is
+ * freed, since a thief may still be reading them.
+ */
+typedef struct ptw32_wsdeque_array_t_ ptw32_wsdeque_array_t;
+
+struct ptw32_wsdeque_array_t_
+{
+  LONG mask;			/* size - 1, size a power of 2 */
+  ptw32_wsdeque_array_t * prev;
+  void * volatile items[1];	/* really size */
+};
+
+struct pthread_wsdeque_np_t_
+{
+  volatile LONG top;		/* oldest item, stolen first */
+  char pad1[PTW32_CACHE_LINE_SIZE];
+  volatile LONG bottom;		/* next push */
+  ptw32_wsdeque_array_t * volatile array;
+  char pad2[PTW32_CACHE_LINE_SIZE];
+};
+
+#define PTW32_WSDEQUE_INITIAL_SIZE 64
+
+/*
+ * Single-producer single-consumer channels (pthread_spsc_*_np). Each
+ * end keeps its index and a cached copy of the other end's in a cache
+ * line of its own; the parked flags, written only around a park, are
+ * in a line that both ends just read. See ptw32_spsc.c.
+ */
+struct pthread_spsc_np_t_
+{
+  void ** items;		/* size a power of 2 */
+  LONG mask;			/* size - 1 */
+  LONG capacity;
+  char pad1[PTW32_CACHE_LINE_SIZE];
+  volatile LONG tail;		/* next push, written by the producer */
+  LONG headCache;		/* the producer's last look at head */
+  char pad2[PTW32_CACHE_LINE_SIZE];
+  volatile LONG head;		/* next pop, written by the consumer */
+  LONG tailCache;		/* the consumer's last look at tail */
+  char pad3[PTW32_CACHE_LINE_SIZE];
+  volatile LONG consumerParked;	/* waits on tail */
+  volatile LONG producerParked;	/* waits on head */
+  char pad4[PTW32_CACHE_LINE_SIZE];
+};
+
+/* Items between index h and index t, modulo 2^32 */
+#define PTW32_SPSC_LENGTH(t, h) ((LONG) ((ULONG) (t) - (ULONG) (h)))
+
+/* Checks of the other end's index before parking */
+#define PTW32_SPSC_SPIN 100
+
+/*
+ * Thread pools (pthread_pool_*_np). Each worker owns a work-stealing
+ * deque of tasks: it pushes and pops its own end, and other workers
+ * steal from the other end when theirs is empty. Tasks submitted from
+ * outside the pool go on a shared list, which workers check before
+ * stealing.
+ */
+struct pthread_pool_task_np_t_
+{
+  void *(PTW32_CDECL *routine) (void *);
+  void * arg;
+  void * result;
+  pthread_pool_np_t pool;
+  pthread_pool_task_np_t next;	/* on the submitted list */
+  int detached;			/* no handle: freed when it completes */
+  volatile LONG done;
+};
+
+typedef struct
+{
+  struct pthread_wsdeque_np_t_ deque;
+  int depth;			/* tasks running on this worker's stack */
+  int spare;			/* started to stand in for blocked workers */
+  pthread_t thread;
+  pthread_pool_np_t pool;
+  char pad[PTW32_CACHE_LINE_SIZE];  /* keeps the next deque's top apart */
+} ptw32_pool_worker_t;
+
+struct pthread_pool_np_t_
+{
+  int nWorkers;
+  ptw32_pool_worker_t * workers;
+  pthread_key_t selfKey;	/* the worker struct in pool workers */
+  pthread_attr_t attr;		/* to start (replacement) workers */
+  HANDLE wake;			/* semaphore idle workers wait on */
+  volatile LONG nIdle;		/* workers owed a wake up */
+  ptw32_mcs_lock_t submittedLock;
+  pthread_pool_task_np_t submitted;	/* from outside the pool, oldest */
+  pthread_pool_task_np_t submittedTail;
+  volatile LONG nSubmitted;
+  volatile LONG outstanding;	/* submitted and not completed */
+  volatile LONG nWaiting;	/* threads waiting on 'changed' */
+  volatile LONG nBlocked;	/* workers in blocking library waits */
+  volatile LONG nSpares;	/* spare workers running */
+  volatile LONG spawning;	/* a spare is being started */
+  volatile LONG shutdown;
+  pthread_mutex_t lock;
+  pthread_cond_t changed;	/* a task completed or was submitted */
+};
+
+/*
+ * A pthread_pool_parallel_for_np or _reduce_np loop, on the caller's
+ * stack. Its chunks are handed out in order from 'next' to the
+ * caller and to up to one helper task per worker.
+ */
+typedef struct
+{
+  long begin;
+  long end;
+  long grain;
+  LONG nChunks;
+  volatile LONG next;		/* the next chunk to run */
+  void (PTW32_CDECL *forRoutine) (long, long, void *);
+  void * (PTW32_CDECL *reduceRoutine) (long, long, void *, void *);
+  void * identity;
+  void * arg;
+  pthread_pool_task_np_t * helpers;
+  int nHelpers;
+} ptw32_pool_loop_t;
+
+/* Most spare workers a pool runs for its blocked workers at once */
+#define PTW32_POOL_SPARES_MAX 64
+
+/*
+ * A pool worker's processor token (see ptw32_cputokens.c): none, held
+ * while it runs tasks, or given back while it is blocked, to be taken
+ * again when it runs.
+ */
+#define PTW32_CPUTOKEN_NONE	0
+#define PTW32_CPUTOKEN_HELD	1
+#define PTW32_CPUTOKEN_LENT	2
+
+/* Chunks per participant when the caller leaves the grain to us */
+#define PTW32_POOL_LOOP_CHUNKS 4
+
+#if defined(PTW32_TIMER_CREATE)
+/*
+ * POSIX timers (timer_create). Armed timers are on a binary heap
+ * ordered by their next expiry; everything but 'refs' is guarded by
+ * ptw32_timer_lock. See ptw32_timer.c.
+ */
+struct timer_t_
 {
-  int pshared;
-  int kind;
-  int robustness;
+  struct sigevent event;
+  clockid_t clock;
+  int64_t expiry;		/* monotonic, in 100 nanosecond units */
+  int64_t interval;		/* 100 nanosecond units; 0: one-shot */
+  int heapIndex;		/* -1: disarmed */
+  int pending;			/* a notification is queued, not yet begun */
+  int overrun;			/* expiries since it was queued */
+  int lastOverrun;		/* of the last notification begun */
+  int deleted;
+  volatile LONG refs;		/* the timer's, and each queued notification's */
 };
+#endif /* PTW32_TIMER_CREATE */
 
 /*
- * Possible values, other than PTW32_OBJECT_INVALID,
- * for the "interlock" element in a spinlock.
- *
- * In this implementation, when a spinlock is initialised,
- * the number of cpus available to the process is checked.
- * If there is only one cpu then "interlock" is set equal to
- * PTW32_SPIN_USE_MUTEX and u.mutex is an initialised mutex.
- * If the number of cpus is greater than 1 then "interlock"
- * is set equal to PTW32_SPIN_UNLOCKED and the number is
- * stored in u.cpus. This arrangement allows the spinlock
- * routines to attempt an InterlockedCompareExchange on "interlock"
- * immediately and, if that fails, to try the inferior mutex.
- *
- * "u.cpus" isn't used for anything yet, but could be used at
- * some point to optimise spinlock behaviour.
+ * Bounded MPMC queues (pthread_queue_*_np). See ptw32_queue.c.
  */
-#define PTW32_SPIN_INVALID     (0)
-#define PTW32_SPIN_UNLOCKED    (1)
-#define PTW32_SPIN_LOCKED      (2)
-#define PTW32_SPIN_USE_MUTEX   (3)
+typedef struct
+{
+  volatile LONG sequence;	/* ticket the cell is ready for */
+  void * item;
+} ptw32_queue_cell_t;
 
-struct pthread_spinlock_t_
+struct pthread_queue_np_t_
 {
-  long interlock;		/* Locking element for multi-cpus. */
-  union
-  {
-    int cpus;			/* No. of cpus if multi cpus, or   */
-    pthread_mutex_t mutex;	/* mutex if single cpu.            */
-  } u;
+  ptw32_queue_cell_t * cells;	/* size a power of 2 */
+  LONG mask;			/* size - 1 */
+  sem_t slots;			/* free places */
+  sem_t items;			/* filled places */
+  char pad1[PTW32_CACHE_LINE_SIZE];
+  volatile LONG tail;		/* next push ticket */
+  char pad2[PTW32_CACHE_LINE_SIZE];
+  volatile LONG head;		/* next pop ticket */
+  char pad3[PTW32_CACHE_LINE_SIZE];
+};
+
+struct pthread_seqlock_np_t_
+{
+  volatile LONG sequence;	/* odd while a writer is active */
+  pthread_mutex_t writers;	/* serialises writers */
 };
 
+/* Polls of an odd sequence before a reader yields its time slice */
+#define PTW32_SEQLOCK_SPIN 100
+
 /*
- * MCS lock queue node - see ptw32_MCS_lock.c
+ * Per-CPU data: one slot per logical processor, each in cache lines
+ * of its own. Processors are numbered densely across the groups, so
+ * the first processor of group g has slot groupBase[g].
  */
-struct ptw32_mcs_node_t_
+struct pthread_percpu_np_t_
 {
-  struct ptw32_mcs_node_t_ **lock;        /* ptr to tail of queue */
-  struct ptw32_mcs_node_t_  *next;        /* ptr to successor in queue */
-  HANDLE                     readyFlag;   /* set after lock is released by
-                                             predecessor */
-  HANDLE                     nextFlag;    /* set after 'next' ptr is set by
-                                             successor */
+  char * slots;
+  size_t stride;		/* Slot size, rounded up to cache lines */
+  int nSlots;
+  int groupBase[PTW32_CPU_SET_GROUPS];
 };
 
-
-struct pthread_barrier_t_
+/*
+ * A sharded counter: a LONG64 per-CPU slot for each processor.
+ */
+struct pthread_counter_np_t_
 {
-  unsigned int nCurrentBarrierHeight;
-  unsigned int nInitialBarrierHeight;
-  int pshared;
-  sem_t semBarrierBreeched;
-  ptw32_mcs_lock_t lock;
-  ptw32_mcs_local_node_t proxynode;
+  pthread_percpu_np_t shards;
 };
 
-struct pthread_barrierattr_t_
+struct pthread_lockstripe_np_t_
 {
-  int pshared;
+  pthread_mutex_t * locks;	/* stripes, a power of 2, each in its own
+				   cache lines of one block */
+  unsigned int mask;		/* stripes - 1 */
 };
 
+/*
+ * Stripe of a caller's hash. Fibonacci hashing spreads hashes whose
+ * low bits don't vary, such as pointers to aligned objects.
+ */
+#define PTW32_LOCKSTRIPE_INDEX(s, h) \
+  (((((unsigned int) (h) ^ (unsigned int) ((h) >> 16 >> 16)) * 0x9E3779B1U) >> 16) \
+   & (s)->mask)
+
+/* TLS_OUT_OF_INDEXES not defined on WinCE */
+#if !defined(TLS_OUT_OF_INDEXES)
+#define TLS_OUT_OF_INDEXES 0xffffffff
+#endif
+
 struct pthread_key_t_
 {
-  DWORD key;
+  DWORD key;			/* TLS_OUT_OF_INDEXES for table keys */
   void (PTW32_CDECL *destructor) (void *);
-  ptw32_mcs_lock_t keyLock;
-  void *threads;
+  unsigned int slot;		/* index in ptw32_tsdKeys */
+  unsigned int generation;
+  int task;			/* PTHREAD_KEY_TASK_NP: always a table key */
 };
 
+/*
+ * Every key has a slot, registered in ptw32_tsdKeys until the key is
+ * deleted. Slots are reused after pthread_key_delete.
+ *
+ * Keys created after Win32 has run out of TLS indexes keep their
+ * values in a per-thread table instead, indexed by slot and found
+ * through the single TLS index ptw32_tsdTableIndex. An entry only
+ * holds a value for the key whose generation it records, so a new key
+ * starts out NULL in every thread.
+ *
+ * Deleting a key is O(1) in the number of threads: the slot is freed
+ * and the values left behind under it are ignored. A TLS index is not
+ * given back with TlsFree, which visits every thread, but retired; new
+ * keys are then made table keys, see pthread_key_create.
+ *
+ * Task keys (pthread_key_create_np) are table keys whose entries also
+ * record the table's task number when set. A pool worker bumps the
+ * number between tasks, which leaves every task key NULL again
+ * without touching the entries. The slots of task keys given values
+ * with destructors are listed in the table as they are set, up to
+ * PTW32_TSD_TASK_SLOTS (past that every entry is looked at), so that
+ * the destructors can be run for the task that set them.
+ */
+#define PTW32_TSD_TASK_SLOTS 8
+#define PTW32_KEY_IN_TABLE(k) ((k)->key == TLS_OUT_OF_INDEXES)
 
-typedef struct ThreadParms ThreadParms;
+typedef struct ptw32_tsd_entry_t_
+{
+  void * value;
+  unsigned int generation;
+  unsigned int task;		/* Task keys: the table's task when set */
+} ptw32_tsd_entry_t;
 
-struct ThreadParms
+typedef struct
 {
-  pthread_t tid;
-  void *(PTW32_CDECL *start) (void *);
-  void *arg;
-};
+  void * block;			/* as returned by malloc */
+  unsigned int nEntries;
+  ptw32_tsd_entry_t * entries;	/* cache line aligned */
+  unsigned int task;		/* Bumped between pool tasks */
+  unsigned int nTaskSlots;	/* > PTW32_TSD_TASK_SLOTS: too many to list */
+  unsigned int taskSlots[PTW32_TSD_TASK_SLOTS];
+} ptw32_tsd_table_t;
 
 
+/*
+ * A condition variable's members are grouped by who writes them, each
+ * group a cache line from the next: what init sets and the others only
+ * read; the counts that waiters and signallers update together, under
+ * semBlockLock and mtxUnblockLock or, waking by address, seqLock; and
+ * seq, which waiters spin and park on while the counts change. The
+ * links of the time change list, written only by the init and destroy
+ * of other condition variables in the shard, share seq's line. The two
+ * pads cost 128 bytes (64 without PTW32_COND_WAITONADDRESS), also in
+ * application storage, for a signal that misses only on the counts'
+ * line rather than on every line a waiter touched.
+ */
 struct pthread_cond_t_
 {
-  long nWaitersBlocked;		/* Number of threads blocked            */
-  long nWaitersGone;		/* Number of threads timed out          */
-  long nWaitersToUnblock;	/* Number of threads to unblock         */
+  /* Read only after init */
   sem_t semBlockQueue;		/* Queue up threads waiting for the     */
   /*   condition to become signalled      */
   sem_t semBlockLock;		/* Semaphore that guards access to      */
@@ -418,18 +1949,85 @@ struct pthread_cond_t_
   pthread_mutex_t mtxUnblockLock;	/* Mutex that guards access to          */
   /* | waiters (to)unblock(ed) counts     */
   /* +-> Optional* Sync.LEVEL-2           */
+#if defined(PTW32_COND_WAITONADDRESS)
+  int wakeByAddress;		/* Waiters park on seq, none of the     */
+  /* semaphore members are used           */
+#endif
+  clockid_t clock;		/* Clock timedwait abstimes are against */
+  int spinLimit;		/* Polls for a signal before blocking   */
+  int inPlace;			/* In application storage, not freed    */
+  char pad1[PTW32_CACHE_LINE_SIZE];
+
+  /* Waiters and signallers */
+  long nWaitersBlocked;		/* Number of threads blocked            */
+  long nWaitersGone;		/* Number of threads timed out          */
+  long nWaitersToUnblock;	/* Number of threads to unblock         */
+  int spinEstimate;		/* Running average of the polls needed  */
+#if defined(PTW32_COND_WAITONADDRESS)
+  ptw32_mcs_lock_t seqLock;	/* Guards the sequence counters         */
+  LONG nWaiters;		/* Number of threads in a wait          */
+  long nGenWaiters;		/* Waiters since the last broadcast     */
+  long nMorphWaiters;		/* Waiters released by a broadcast      */
+  /* that have yet to leave               */
+  unsigned __int64 totalSeq;	/* Waits started                        */
+  unsigned __int64 wakeupSeq;	/* Wakeups issued                       */
+  unsigned __int64 wokenSeq;	/* Wakeups consumed                     */
+  unsigned __int64 broadcastSeq;	/* Broadcasts issued                    */
+  char pad2[PTW32_CACHE_LINE_SIZE];
+
+  LONG seq;			/* Word waiters park on                 */
+#endif
+
   pthread_cond_t next;		/* Doubly linked list                   */
   pthread_cond_t prev;
+#if defined(PTW32_LOCKSTAT)
+  ptw32_lockstat_t stats;
+#endif
 };
 
 
 struct pthread_condattr_t_
 {
   int pshared;
+  clockid_t clock;
+  int spin;
+  int wakeOrder;
 };
 
+/*
+ * The clocks an abstime may be measured against.
+ */
+#define PTW32_VALID_CLOCK(c) \
+  ((c) == CLOCK_REALTIME || (c) == CLOCK_MONOTONIC)
+
+/*
+ * Not a clock: marks an "abstime" that is really a duration from the
+ * start of the wait, for the relative timed waits. ptw32_rel100nanosecs
+ * returns it as it is, without reading the time, so it only suits a
+ * wait made of one sleep; a wait that may sleep again first turns it
+ * into a deadline with ptw32_monotonic_deadline.
+ */
+#define PTW32_CLOCK_RELATIVE ((clockid_t) -2)
+
+#define PTW32_VALID_RELTIME(t) \
+  ((t) != NULL && (t)->tv_sec >= 0 \
+   && (t)->tv_nsec >= 0 && (t)->tv_nsec < 1000000000L)
+
 #define PTW32_RWLOCK_MAGIC 0xfacade2
 
+/*
+ * Reader counters of a distributed read/write lock are padded to
+ * a cache line each so that readers on different processors don't
+ * contend for the same line.
+ */
+#define PTW32_RWLOCK_MAX_READER_SLOTS 64
+
+typedef struct
+{
+  LONG count;
+  char pad[PTW32_CACHE_LINE_SIZE - sizeof (LONG)];
+} ptw32_rwlock_slot_t;
+
 struct pthread_rwlock_t_
 {
   pthread_mutex_t mtxExclusiveAccess;
@@ -437,130 +2035,203 @@ struct pthread_rwlock_t_
   pthread_cond_t cndSharedAccessCompleted;
   int nSharedAccessCount;
   int nExclusiveAccessCount;
-  int nCompletedSharedAccessCount;
+  volatile LONG nCompletedSharedAccessCount;	/* Read unlocks; atomic */
   int nMagic;
+  ptw32_rwlock_slot_t * readerSlots;	/* NULL unless distributed */
+  int nReaderSlots;
+  LONG writerActive;
+  int kind;			/* PTHREAD_RWLOCK_DEFAULT_NP uses the    */
+				/* mutexes and condvar above; the other  */
+				/* kinds use the fields below instead    */
+  ptw32_mcs_lock_t stateLock;
+  HANDLE semReaders;
+  HANDLE semWriters;
+  volatile LONG lockWord;	/* Owners: PTW32_RWLOCK_WRITER, or     */
+				/* PTW32_RWLOCK_READER per reader,     */
+				/* including an upgradable reader      */
+  int nWaitingReaders;
+  int nWaitingWriters;
+  int upgraderActive;		/* The upgradable read lock is held,   */
+  ptw32_thread_t * upgrader;	/* by this thread once it has woken    */
+  int upgradePending;		/* It waits for the readers to leave   */
+  int nWaitingUpgraders;
+  HANDLE semUpgraders;		/* Created on first upgradable lock    */
+  HANDLE semUpgrade;
+  int useSRWLock;		/* Default kind built on srwLock:      */
+  PVOID srwLock;		/* the fields above are unused         */
+  LONG srwGeneration;		/* Bumped on unlock for timed waiters  */
+  LONG nSrwTimedWaiters;
+  ptw32_lock_elide_t * elide;	/* PTHREAD_RWLOCK_ELIDE_NP only        */
+#if defined(PTW32_LOCKSTAT)
+  ptw32_lockstat_t stats;	/* Unused by the default mutex kind    */
+#endif
 };
 
+/*
+ * The lockWord of the preference policy kinds. See
+ * ptw32_rwlock_policy.c.
+ */
+#define PTW32_RWLOCK_WRITER 1
+#define PTW32_RWLOCK_READER 2
+
+/*
+ * Read unlocks of the default kind only increment
+ * nCompletedSharedAccessCount. A writer, holding mtxExclusiveAccess so
+ * that no reader can join, takes them off nSharedAccessCount with this
+ * and then counts the rest down from minus the readers still inside;
+ * the reader that brings it to zero signals the writer.
+ */
+#define PTW32_RWLOCK_FOLD_COMPLETED(rwl) \
+  ((rwl)->nSharedAccessCount -= (int) PTW32_INTERLOCKED_EXCHANGE_LONG ( \
+       (PTW32_INTERLOCKED_LONGPTR) &(rwl)->nCompletedSharedAccessCount, \
+       (PTW32_INTERLOCKED_LONG) 0))
+
 struct pthread_rwlockattr_t_
 {
   int pshared;
+  int distributed;
+  int kind;
 };
 
+/*
+ * A cpu_set_t seen as one affinity mask per processor group.
+ */
+#define PTW32_CPU_GROUP_SIZE (sizeof(size_t)*8)
+
 typedef union
 {
   char cpuset[CPU_SETSIZE/8];
-  size_t _cpuset;
+  size_t _cpuset[PTW32_CPU_SET_GROUPS];
 } _sched_cpu_set_vector_;
 
-typedef struct ThreadKeyAssoc ThreadKeyAssoc;
+/*
+ * GROUP_AFFINITY, which older SDKs don't have.
+ */
+typedef struct
+{
+  DWORD_PTR Mask;
+  WORD Group;
+  WORD Reserved[3];
+} ptw32_group_affinity_t;
+
+/*
+ * PROCESSOR_NUMBER, which older SDKs don't have.
+ */
+typedef struct
+{
+  WORD Group;
+  BYTE Number;
+  BYTE Reserved;
+} ptw32_processor_number_t;
+
+#if !defined(ALL_PROCESSOR_GROUPS)
+#define ALL_PROCESSOR_GROUPS 0xffff
+#endif
+
+/*
+ * SYSTEM_CPU_SET_INFORMATION, which older SDKs don't have, for
+ * mapping CPUs to CPU Set ids.
+ */
+#define PTW32_CPU_SET_INFORMATION 0
 
-struct ThreadKeyAssoc
+typedef struct
 {
-  /*
-   * Purpose:
-   *      This structure creates an association between a thread and a key.
-   *      It is used to implement the implicit invocation of a user defined
-   *      destroy routine for thread specific data registered by a user upon
-   *      exiting a thread.
-   *
-   *      Graphically, the arrangement is as follows, where:
-   *
-   *         K - Key with destructor
-   *            (head of chain is key->threads)
-   *         T - Thread that has called pthread_setspecific(Kn)
-   *            (head of chain is thread->keys)
-   *         A - Association. Each association is a node at the
-   *             intersection of two doubly-linked lists.
-   *
-   *                 T1    T2    T3
-   *                 |     |     |
-   *                 |     |     |
-   *         K1 -----+-----A-----A----->
-   *                 |     |     |
-   *                 |     |     |
-   *         K2 -----A-----A-----+----->
-   *                 |     |     |
-   *                 |     |     |
-   *         K3 -----A-----+-----A----->
-   *                 |     |     |
-   *                 |     |     |
-   *                 V     V     V
-   *
-   *      Access to the association is guarded by two locks: the key's
-   *      general lock (guarding the row) and the thread's general
-   *      lock (guarding the column). This avoids the need for a
-   *      dedicated lock for each association, which not only consumes
-   *      more handles but requires that the lock resources persist
-   *      until both the key is deleted and the thread has called the
-   *      destructor. The two-lock arrangement allows those resources
-   *      to be freed as soon as either thread or key is concluded.
-   *
-   *      To avoid deadlock, whenever both locks are required both the
-   *      key and thread locks are acquired consistently in the order
-   *      "key lock then thread lock". An exception to this exists
-   *      when a thread calls the destructors, however, this is done
-   *      carefully (but inelegantly) to avoid deadlock.
-   *
-   *      An association is created when a thread first calls
-   *      pthread_setspecific() on a key that has a specified
-   *      destructor.
-   *
-   *      An association is destroyed either immediately after the
-   *      thread calls the key destructor function on thread exit, or
-   *      when the key is deleted.
-   *
-   * Attributes:
-   *      thread
-   *              reference to the thread that owns the
-   *              association. This is actually the pointer to the
-   *              thread struct itself. Since the association is
-   *              destroyed before the thread exits, this can never
-   *              point to a different logical thread to the one that
-   *              created the assoc, i.e. after thread struct reuse.
-   *
-   *      key
-   *              reference to the key that owns the association.
-   *
-   *      nextKey
-   *              The pthread_t->keys attribute is the head of a
-   *              chain of associations that runs through the nextKey
-   *              link. This chain provides the 1 to many relationship
-   *              between a pthread_t and all pthread_key_t on which
-   *              it called pthread_setspecific.
-   *
-   *      prevKey
-   *              Similarly.
-   *
-   *      nextThread
-   *              The pthread_key_t->threads attribute is the head of
-   *              a chain of associations that runs through the
-   *              nextThreads link. This chain provides the 1 to many
-   *              relationship between a pthread_key_t and all the
-   *              PThreads that have called pthread_setspecific for
-   *              this pthread_key_t.
-   *
-   *      prevThread
-   *              Similarly.
-   *
-   * Notes:
-   *      1)      As soon as either the key or the thread is no longer
-   *              referencing the association, it can be destroyed. The
-   *              association will be removed from both chains.
-   *
-   *      2)      Under WIN32, an association is only created by
-   *              pthread_setspecific if the user provided a
-   *              destroyRoutine when they created the key.
-   *
-   *
-   */
-  ptw32_thread_t * thread;
-  pthread_key_t key;
-  ThreadKeyAssoc *nextKey;
-  ThreadKeyAssoc *nextThread;
-  ThreadKeyAssoc *prevKey;
-  ThreadKeyAssoc *prevThread;
-};
+  DWORD Size;
+  DWORD Type;
+  union
+  {
+    struct
+    {
+      DWORD Id;
+      WORD Group;
+      BYTE LogicalProcessorIndex;
+      BYTE CoreIndex;
+      BYTE LastLevelCacheIndex;
+      BYTE NumaNodeIndex;
+      BYTE EfficiencyClass;
+      BYTE AllFlags;
+      DWORD Reserved;
+      unsigned __int64 AllocationTag;
+    } CpuSet;
+  } u;
+} ptw32_cpu_set_info_t;
 
+/*
+ * SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX, which older SDKs don't
+ * have, with just the relationships the topology code reads.
+ */
+#define PTW32_RELATION_PROCESSOR_CORE 0
+#define PTW32_RELATION_NUMA_NODE 1
+#define PTW32_RELATION_CACHE 2
+#define PTW32_RELATION_ALL 0xffff
+
+#define PTW32_CACHE_UNIFIED 0
+#define PTW32_CACHE_DATA 2
+
+typedef struct
+{
+  DWORD Relationship;
+  DWORD Size;
+  union
+  {
+    struct
+    {
+      BYTE Flags;
+      BYTE EfficiencyClass;
+      BYTE Reserved[20];
+      WORD GroupCount;
+      ptw32_group_affinity_t GroupMask[1];
+    } Processor;
+    struct
+    {
+      DWORD NodeNumber;
+      BYTE Reserved[18];
+      WORD GroupCount;		/* Zero before Windows Server 2022 */
+      ptw32_group_affinity_t GroupMask[1];
+    } NumaNode;
+    struct
+    {
+      BYTE Level;
+      BYTE Associativity;
+      WORD LineSize;
+      DWORD CacheSize;
+      DWORD Type;
+      BYTE Reserved[18];
+      WORD GroupCount;		/* Zero before Windows Server 2022 */
+      ptw32_group_affinity_t GroupMask[1];
+    } Cache;
+  } u;
+} ptw32_processor_info_t;
+
+/*
+ * The processor topology, indexed by cpu_set_t CPU number. Each
+ * entry is the NUMA node, core, last level cache or core efficiency
+ * class of the CPU, or -1 if there is no such CPU. Built on first use.
+ */
+typedef struct
+{
+  int nNodes;			/* Highest NUMA node number + 1 */
+  int nClasses;			/* Highest efficiency class + 1 */
+  int node[CPU_SETSIZE];
+  int core[CPU_SETSIZE];
+  int cache[CPU_SETSIZE];
+  int efficiency[CPU_SETSIZE];	/* Higher is faster */
+} ptw32_topology_t;
+
+/*
+ * THREAD_POWER_THROTTLING_STATE for SetThreadInformation, which older
+ * SDKs don't have.
+ */
+#define PTW32_THREAD_POWER_THROTTLING 3	/* ThreadPowerThrottling */
+#define PTW32_POWER_THROTTLING_VERSION 1
+#define PTW32_POWER_THROTTLING_EXECUTION_SPEED 0x1
+
+typedef struct
+{
+  ULONG Version;
+  ULONG ControlMask;
+  ULONG StateMask;
+} ptw32_power_throttling_t;
 
 #if defined(__CLEANUP_SEH)
 /*
@@ -616,40 +2287,512 @@ struct ThreadKeyAssoc
 #define PTW32_EPS_EXIT                  (1)
 #define PTW32_EPS_CANCEL                (2)
 
+/*
+ * How many frames ptw32_exit_return() will unwind looking for
+ * ptw32_threadRun before leaving pthread_exit() to ptw32_throw().
+ */
+#define PTW32_EXIT_RETURN_FRAMES        16
+
 
 /* Useful macros */
 #define PTW32_MAX(a,b)  ((a)<(b)?(b):(a))
 #define PTW32_MIN(a,b)  ((a)>(b)?(b):(a))
 
+/*
+ * The priority a thread waits at: its sched_priority, or the boost its
+ * priority protocol mutexes lend it if that is higher.
+ */
+#define PTW32_WAIT_PRIORITY(tp) \
+  PTW32_MAX ((tp)->sched_priority, (tp)->boostPriority)
+
+/*
+ * Processor hint for use inside busy-wait loops.
+ */
+#if defined(YieldProcessor)
+#  define PTW32_YIELD_PROCESSOR()  YieldProcessor()
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#  define PTW32_YIELD_PROCESSOR()  __asm__ __volatile__ ("pause")
+#elif defined(__GNUC__) && defined(__aarch64__)
+#  define PTW32_YIELD_PROCESSOR()  __asm__ __volatile__ ("yield")
+#else
+#  define PTW32_YIELD_PROCESSOR()  ((void) 0)
+#endif
+
+/*
+ * One step of a spin loop waiting for *p to change from old, for spin
+ * locks, which spin for as long as it takes. On ARM64 the exclusive
+ * load arms the monitor, so wfe sleeps until the line is written (or an
+ * interrupt arrives) instead of polling; if *p has already changed the
+ * step returns at once. MSVC has no exclusive load intrinsic to arm the
+ * monitor with, so it, like everything else, uses the processor hint.
+ */
+#if defined(__GNUC__) && defined(__aarch64__)
+#  define PTW32_SPIN_WAIT_LONG(p, old) \
+     do { unsigned int _v; \
+          __asm__ __volatile__ ("ldaxr	%w0, [%1]\n\t" \
+                                "cmp	%w0, %w2\n\t" \
+                                "b.ne	1f\n\t" \
+                                "wfe\n" \
+                                "1:" \
+                                : "=&r" (_v) \
+                                : "r" (p), "r" ((unsigned int) (old)) \
+                                : "memory", "cc"); } while (0)
+#else
+#  define PTW32_SPIN_WAIT_LONG(p, old) \
+     do { (void) (old); PTW32_YIELD_PROCESSOR (); } while (0)
+#endif
+
+/*
+ * Keeps the loads before it ahead of the loads after it, for readers
+ * that check a counter with plain reads instead of an interlocked
+ * operation. x86 and x64 don't reorder loads with each other, so there
+ * only the compiler needs holding back; ARM64 needs a fence.
+ */
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+#  define PTW32_READ_FENCE()  __atomic_thread_fence (__ATOMIC_ACQUIRE)
+#elif defined(__GNUC__)
+#  define PTW32_READ_FENCE()  __sync_synchronize ()
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#  include <intrin.h>
+#  pragma intrinsic(_ReadWriteBarrier)
+#  define PTW32_READ_FENCE()  _ReadWriteBarrier ()
+#else
+#  define PTW32_READ_FENCE()  MemoryBarrier ()
+#endif
+
+/*
+ * The first TLS_MINIMUM_AVAILABLE (64) TLS slots live in the TlsSlots
+ * array of the thread's TEB. Reading them there is what TlsGetValue()
+ * does, except that it also clears the thread's last error code.
+ */
+#if (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))) \
+    || (defined(__GNUC__) && (defined(__x86_64__) || defined(__aarch64__)))
+#  define PTW32_TEB_TLS_SLOTS_OFFSET 0x1480
+#elif (defined(_MSC_VER) && defined(_M_IX86)) \
+      || (defined(__GNUC__) && defined(__i386__))
+#  define PTW32_TEB_TLS_SLOTS_OFFSET 0xE10
+#endif
+
+#if defined(PTW32_TEB_TLS_SLOTS_OFFSET)
+#  define PTW32_TEB_TLS_SLOTS 64
+#  define PTW32_TEB_TLS_VALUE(index) \
+     (((void * volatile *) ((char *) NtCurrentTeb () + PTW32_TEB_TLS_SLOTS_OFFSET))[index])
+#endif
+
+/*
+ * Compiler thread local storage, used to keep the calling thread's
+ * struct where pthread_self can read it with a single load. The
+ * loader only sets up implicit TLS for a dll loaded by LoadLibrary
+ * from Windows Vista on, so the dll uses it only if built for Vista
+ * or later.
+ */
+#if defined(PTW32_STATIC_LIB) || (_WIN32_WINNT >= 0x0600)
+#  if defined(_MSC_VER)
+#    define PTW32_THREAD_LOCAL __declspec(thread)
+#  elif defined(__GNUC__) || defined(__MINGW32__)
+#    define PTW32_THREAD_LOCAL __thread
+#  endif
+#endif
+
+/*
+ * Spin budgets are set in nanoseconds and turned into counts of
+ * processor hints when the process initialises, by timing the hint
+ * (see ptw32_spin_calibrate.c). PTW32_SPIN_HINT_PS is the picoseconds
+ * a hint is taken to cost until then.
+ */
+#define PTW32_SPIN_HINT_PS 4000
+
+/*
+ * Initial upper bound of the exponential backoff between attempts to
+ * take a contended test-and-set spinlock (see
+ * PTHREAD_PARAM_SPIN_BACKOFF_NP).
+ */
+#define PTW32_SPIN_BACKOFF_NS 4000
+
+/*
+ * How long a spinlock waiter spins without the lock changing hands
+ * before it yields the processor, in case the owner has been
+ * preempted (see pthread_spin_lock.c).
+ */
+#define PTW32_SPIN_YIELD_NS 256000
+
+/*
+ * Milliseconds for which ptw32_spin_pays() trusts its last reading of
+ * the process affinity and job CPU rate.
+ */
+#define PTW32_SPIN_PAYS_REFRESH 1000
+
+/*
+ * How long a waiter polls its MCS queue node flag before it falls
+ * back to blocking on an event (multi-processor systems only).
+ */
+#define PTW32_MCS_SPIN_NS 4000
+
+/*
+ * time between jan 1, 1601 and jan 1, 1970 in units of 100 nanoseconds
+ */
+#define PTW32_TIMESPEC_TO_FILETIME_OFFSET \
+	  ( ((int64_t) 27111902 << 32) + (int64_t) 3577643008 )
+
+/* FlsAlloc's failure value, for SDKs older than Windows Vista's */
+#if !defined(FLS_OUT_OF_INDEXES)
+#define FLS_OUT_OF_INDEXES ((DWORD) 0xFFFFFFFF)
+#endif
+
+/*
+ * Older SDKs don't define the CreateWaitableTimerEx flag for a high
+ * resolution timer (Windows 10 version 1803 and later).
+ */
+#if !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+/*
+ * Likewise the QueueUserAPC2 flag for a special user APC, which runs
+ * whether or not the target thread is in an alertable wait.
+ */
+#if !defined(QUEUE_USER_APC_FLAGS_SPECIAL_USER_APC)
+#define QUEUE_USER_APC_FLAGS_SPECIAL_USER_APC 0x00000001
+#endif
+
+/*
+ * WaitOnAddress can't wait for a timer as well, and its timeouts are
+ * only as good as the system clock tick. A WaitOnAddress wait with
+ * less than this long (in 100 nanosecond units) to go sleeps on the
+ * thread's high resolution timer instead.
+ */
+#define PTW32_HIRES_WAIT_LIMIT 10000
+
+/*
+ * The end (in 100 nanosecond units) of a pthread_delay_np or nanosleep
+ * that polls the clock rather than sleeps, as a timer may wake the
+ * thread late. 0 sleeps for all of it.
+ */
+#if !defined(PTW32_DELAY_SPIN)
+#define PTW32_DELAY_SPIN 500
+#endif
+
 
 /* Declared in pthread_cancel.c */
 extern DWORD (*ptw32_register_cancellation) (PAPCFUNC, HANDLE, DWORD);
+extern BOOL (WINAPI *ptw32_queueuserapc2) (PAPCFUNC, HANDLE, ULONG_PTR, DWORD);
+extern BOOL (WINAPI *ptw32_setthreadstackguarantee) (PULONG);
+extern HINSTANCE ptw32_h_quserex;
+extern volatile LONG ptw32_cancelInitialized;
+extern ptw32_mcs_lock_t ptw32_cancel_init_lock;
+
+/* Declared in global.c */
+extern BOOL (WINAPI *ptw32_waitonaddress) (volatile VOID *, PVOID, SIZE_T, DWORD);
+extern VOID (WINAPI *ptw32_wakebyaddresssingle) (PVOID);
+extern VOID (WINAPI *ptw32_wakebyaddressall) (PVOID);
+extern VOID (WINAPI *ptw32_acquiresrwlockshared) (PVOID *);
+extern VOID (WINAPI *ptw32_acquiresrwlockexclusive) (PVOID *);
+extern BOOLEAN (WINAPI *ptw32_tryacquiresrwlockshared) (PVOID *);
+extern BOOLEAN (WINAPI *ptw32_tryacquiresrwlockexclusive) (PVOID *);
+extern VOID (WINAPI *ptw32_releasesrwlockshared) (PVOID *);
+extern VOID (WINAPI *ptw32_releasesrwlockexclusive) (PVOID *);
+extern BOOL (WINAPI *ptw32_setthreadgroupaffinity) (HANDLE, const ptw32_group_affinity_t *, ptw32_group_affinity_t *);
+extern BOOL (WINAPI *ptw32_getthreadgroupaffinity) (HANDLE, ptw32_group_affinity_t *);
+extern WORD (WINAPI *ptw32_getactiveprocessorgroupcount) (void);
+extern DWORD (WINAPI *ptw32_getactiveprocessorcount) (WORD);
+extern LONG ptw32_affinityNextGroup;
+extern BOOL (WINAPI *ptw32_getlogicalprocessorinformationex) (DWORD, ptw32_processor_info_t *, PDWORD);
+extern VOID (WINAPI *ptw32_getcurrentprocessornumberex) (ptw32_processor_number_t *);
+extern BOOL (WINAPI *ptw32_querythreadcycletime) (HANDLE, PULONG64);
+extern VOID (WINAPI *ptw32_flushprocesswritebuffers) (void);
+extern HANDLE (WINAPI *ptw32_openthread) (DWORD, BOOL, DWORD);
+extern BOOL (WINAPI *ptw32_setthreadinformation) (HANDLE, int, LPVOID, DWORD);
+extern HRESULT (WINAPI *ptw32_setthreaddescription) (HANDLE, const WCHAR *);
+extern BOOL (WINAPI *ptw32_cancelsynchronousio) (HANDLE);
+extern BOOL (WINAPI *ptw32_setthreadselectedcpusetmasks) (HANDLE, ptw32_group_affinity_t *, USHORT);
+extern BOOL (WINAPI *ptw32_setthreadselectedcpusets) (HANDLE, const ULONG *, ULONG);
+extern BOOL (WINAPI *ptw32_getsystemcpusetinformation) (ptw32_cpu_set_info_t *, ULONG, PULONG, HANDLE, ULONG);
+extern ptw32_topology_t * ptw32_topology;
+extern ptw32_mcs_lock_t ptw32_topology_lock;
+extern VOID (WINAPI *ptw32_getsystemtimepreciseasfiletime) (LPFILETIME);
+extern int64_t ptw32_perfFrequency;
+extern HANDLE (WINAPI *ptw32_createwaitabletimerex) (LPSECURITY_ATTRIBUTES, LPCWSTR, DWORD, DWORD);
+extern BOOL (WINAPI *ptw32_flssetvalue) (DWORD, PVOID);
+extern BOOL (WINAPI *ptw32_flsfree) (DWORD);
+extern DWORD ptw32_flsIndex;
+
+/*
+ * The Win32 handle of thread tp, opened on first use for an implicit
+ * thread; NULL if there is none.
+ */
+#define PTW32_THREAD_HANDLE(tp) \
+  (NULL != (tp)->threadH ? (tp)->threadH : ptw32_implicit_handle (tp))
+
+/*
+ * Let the FLS callback detach the calling thread, which is sp, if it
+ * exits without the library detaching it first. See
+ * pthread_win32_thread_detach_np.
+ */
+#define PTW32_FLS_ATTACH(sp) \
+  do { if (ptw32_flsIndex != FLS_OUT_OF_INDEXES) \
+         (void) ptw32_flssetvalue (ptw32_flsIndex, (PVOID) (sp)); } while (0)
+
+/*
+ * Non-robust mutexes park waiters on lock_idx with WaitOnAddress, the
+ * system's or the parking lot's, unless the library is built with
+ * NEED_WAITONADDRESS. Robust mutexes always use their event,
+ * which must stay signalled for a waiter that arrives after an owner
+ * has died (see pthread_win32_thread_detach_np).
+ */
+#define PTW32_MUTEX_USES_WAITONADDRESS(mx) \
+  (ptw32_waitonaddress != NULL && (mx)->kind >= 0)
+
+/*
+ * Read/write locks of the default kind are built on a Slim
+ * Reader/Writer lock when the system provides one. Timed lock
+ * calls poll it, parking on srwGeneration with WaitOnAddress.
+ */
+#define PTW32_RWLOCK_USES_SRW() \
+  (ptw32_acquiresrwlockshared != NULL)
 
 /* Thread Reuse stack bottom marker. Must not be NULL or any valid pointer to memory. */
 #define PTW32_THREAD_REUSE_EMPTY ((ptw32_thread_t *)(size_t) 1)
 
+/*
+ * Reusable thread structs are queued in a lock-free bounded ring
+ * (see ptw32_reuse.c). Each cell's sequence number says whether it
+ * is ready to be filled or emptied at a given position, which makes
+ * the ring ABA-safe without tagged pointers. Must be a power of 2.
+ */
+#define PTW32_THREAD_REUSE_RING_SIZE 1024
+
+typedef struct
+{
+  volatile LONG seq;
+  ptw32_thread_t * tp;
+} ptw32_thread_reuse_cell_t;
+
+typedef struct
+{
+  volatile LONG enqueuePos;
+  char pad1[PTW32_CACHE_LINE_SIZE - sizeof (LONG)];
+  volatile LONG dequeuePos;
+  char pad2[PTW32_CACHE_LINE_SIZE - sizeof (LONG)];
+  ptw32_thread_reuse_cell_t cells[PTW32_THREAD_REUSE_RING_SIZE];
+} ptw32_thread_reuse_queue_t;
+
+/*
+ * Each processor, by number modulo PTW32_THREAD_REUSE_CPUS, keeps
+ * the last PTW32_THREAD_REUSE_CPU_DEPTH structs destroyed on it in
+ * front of the ring, oldest at 'first'. The entries are padded to
+ * the line size, but the array isn't aligned to it, so neighbours
+ * may still share a line. Only a full FIFO is popped (see
+ * ptw32_reuse.c).
+ */
+#define PTW32_THREAD_REUSE_CPUS      64
+#define PTW32_THREAD_REUSE_CPU_DEPTH 4
+
+typedef struct
+{
+  ptw32_mcs_lock_t lock;
+  volatile int count;
+  int first;
+  ptw32_thread_t * tp[PTW32_THREAD_REUSE_CPU_DEPTH];
+  char pad[PTW32_CACHE_LINE_SIZE - sizeof (ptw32_mcs_lock_t) - 2 * sizeof (int)
+           - PTW32_THREAD_REUSE_CPU_DEPTH * sizeof (ptw32_thread_t *)];
+} ptw32_thread_reuse_cpu_t;
+
+/*
+ * The list of CVs that pthread_timechange_handler_np broadcasts is
+ * split into shards, chosen by CV address, so that init and destroy
+ * on different CVs rarely contend for a lock. CVs that use
+ * CLOCK_MONOTONIC are not listed.
+ */
+#define PTW32_COND_LIST_SHARDS 16
+
+typedef struct
+{
+  ptw32_mcs_lock_t lock;
+  pthread_cond_t head;
+  pthread_cond_t tail;
+  char pad[PTW32_CACHE_LINE_SIZE - sizeof (ptw32_mcs_lock_t)
+           - 2 * sizeof (pthread_cond_t)];
+} ptw32_cond_list_t;
+
+#define PTW32_COND_LIST_SHARD(cv) \
+  (&ptw32_cond_list[((size_t) (cv) >> 6) % PTW32_COND_LIST_SHARDS])
+
 extern int ptw32_processInitialized;
 extern ptw32_thread_t * ptw32_threadReuseTop;
 extern ptw32_thread_t * ptw32_threadReuseBottom;
+extern ptw32_thread_reuse_queue_t ptw32_threadReuseQueue;
+extern ptw32_thread_reuse_cpu_t ptw32_threadReuseCpus[PTW32_THREAD_REUSE_CPUS];
+extern volatile LONG ptw32_threadReuseCount;
+extern int ptw32_threadReuseMax;
+extern unsigned int ptw32_threadReuseBase;
 extern pthread_key_t ptw32_selfThreadKey;
-extern pthread_key_t ptw32_cleanupKey;
-extern pthread_cond_t ptw32_cond_list_head;
-extern pthread_cond_t ptw32_cond_list_tail;
+#if defined(PTW32_THREAD_LOCAL)
+extern PTW32_THREAD_LOCAL ptw32_thread_t * ptw32_selfThread;
+#endif
 
-extern int ptw32_mutex_default_kind;
+/*
+ * The calling thread's struct, or NULL if it has none yet. Doesn't
+ * create an implicit one as pthread_self() does. ptw32_selfThread
+ * follows ptw32_selfThreadKey, which must only be set through
+ * pthread_setspecific().
+ */
+#if defined(PTW32_THREAD_LOCAL)
+#  define PTW32_SELF_THREAD() (ptw32_selfThread)
+#else
+#  define PTW32_SELF_THREAD() \
+     ((ptw32_thread_t *) pthread_getspecific (ptw32_selfThreadKey))
+#endif
+extern ptw32_cond_list_t ptw32_cond_list[PTW32_COND_LIST_SHARDS];
+extern ptw32_parked_thread_t * ptw32_threadCache;
+extern int ptw32_threadCacheCount;
+extern int ptw32_threadCacheMax;
+extern PVOID ptw32_threadPool;
+extern ptw32_tp_environ_t ptw32_threadPoolEnviron;
+extern PVOID (WINAPI *ptw32_createthreadpool) (PVOID);
+extern BOOL (WINAPI *ptw32_setthreadpoolthreadminimum) (PVOID, DWORD);
+extern PVOID (WINAPI *ptw32_createthreadpoolwork) (ptw32_tp_work_callback_t, PVOID, ptw32_tp_environ_t *);
+extern VOID (WINAPI *ptw32_submitthreadpoolwork) (PVOID);
+extern VOID (WINAPI *ptw32_closethreadpoolwork) (PVOID);
+extern BOOL (WINAPI *ptw32_callbackmayrunlong) (PVOID);
+extern ptw32_pshared_arena_t * ptw32_psharedArenas[PTW32_PSHARED_ARENAS];
+extern ptw32_named_sem_t * ptw32_namedSems;
+extern ptw32_fiber_t * ptw32_fiberRunHead;
+extern ptw32_fiber_t * ptw32_fiberRunTail;
+extern int ptw32_fiberWorkers;
+extern int ptw32_fiberIdleWorkers;
+extern HANDLE ptw32_fiberIdleSem;
+extern DWORD ptw32_fiberWorkerIndex;
+extern ptw32_fiber_bucket_t ptw32_fiberBuckets[PTW32_FIBER_BUCKETS];
+extern BOOL (WINAPI *ptw32_fiber_os_waitonaddress) (volatile VOID *, PVOID, SIZE_T, DWORD);
+extern VOID (WINAPI *ptw32_fiber_os_wakebyaddresssingle) (PVOID);
+extern VOID (WINAPI *ptw32_fiber_os_wakebyaddressall) (PVOID);
+extern ptw32_park_bucket_t ptw32_parkingLot[PTW32_PARK_BUCKETS];
+extern ptw32_async_bucket_t ptw32_asyncLot[PTW32_PARK_BUCKETS];
+extern volatile LONG ptw32_asyncWaiters;
+extern volatile LONG ptw32_timerSlack;
+extern ptw32_mcs_lock_t ptw32_timer_wheel_lock;
+extern ptw32_wheel_timer_t * ptw32_timerWheel[PTW32_WHEEL_LEVELS][PTW32_WHEEL_SLOTS];
+extern ptw32_wheel_timer_t * ptw32_timerWheelExpired;
+extern long ptw32_timerWheelCount;
+extern int64_t ptw32_timerWheelTick;
+extern int64_t ptw32_timerWheelNext;
+extern int64_t ptw32_timerWheelWake;
+extern HANDLE ptw32_timerWheelEvent;
+extern volatile LONG ptw32_rcuGp;
+extern ptw32_rcu_reader_t * ptw32_rcuReaders;
+extern ptw32_mcs_lock_t ptw32_rcu_lock;
+extern pthread_mutex_t ptw32_rcuCallbackLock;
+extern pthread_cond_t ptw32_rcuCallbackCond;
+extern pthread_rcu_head_np_t * ptw32_rcuCallbacks;
+extern pthread_rcu_head_np_t ** ptw32_rcuCallbackTail;
+extern unsigned __int64 ptw32_rcuQueued;
+extern unsigned __int64 ptw32_rcuDone;
+extern int ptw32_rcuWorkerStarted;
+#if defined(PTW32_TIMER_CREATE)
+extern ptw32_mcs_lock_t ptw32_timer_lock;
+extern timer_t * ptw32_timerHeap;
+extern int ptw32_timerHeapSize;
+extern int ptw32_timerCount;
+extern int ptw32_timerCapacity;
+extern HANDLE ptw32_timerEvent;
+extern pthread_pool_np_t ptw32_timerPool;
+#endif
+extern ptw32_hazard_record_t * volatile ptw32_hazardRecords;
+extern volatile LONG ptw32_hazardRecordCount;
+extern ptw32_waitgraph_record_t * volatile ptw32_waitgraphRecords;
+extern ptw32_flightrec_t * volatile ptw32_flightRecs;
+extern ptw32_hist_record_t * volatile ptw32_histRecords;
+extern ptw32_waitany_waiter_t * volatile ptw32_waitanyWaiters;
+extern ptw32_mcs_lock_t ptw32_waitany_lock;
+extern ptw32_mcs_lock_t ptw32_mutex_prio_lock;
+#if defined(PTW32_LOCKSTAT)
+extern ptw32_mcs_lock_t ptw32_lockstat_lock;
+extern ptw32_lockstat_t * ptw32_lockstatList;
+extern ptw32_lockprof_slot_t ptw32_lockprofRing[PTW32_LOCKPROF_SLOTS];
+extern volatile LONG ptw32_lockprofNext;
+extern volatile LONG ptw32_lockprofCount;
+extern LONG ptw32_lockprofEvery;
+extern int64_t ptw32_lockprofThreshold;
+extern int ptw32_lockprofOn;
+#endif
+#if defined(PTW32_ETW)
+extern REGHANDLE ptw32_etwHandle;
+extern volatile LONG ptw32_etwEnabled;
+#endif
+#if defined(PTW32_PERFCOUNTERS)
+extern HANDLE ptw32_perfProvider;
+extern PPERF_COUNTERSET_INSTANCE ptw32_perfInstance;
+#endif
+#if defined(PTW32_LOCKWATCH)
+extern ptw32_mcs_lock_t ptw32_lockwatch_lock;
+extern ptw32_lockwatch_edge_t ptw32_lockwatchEdges[PTW32_LOCKWATCH_EDGES];
+extern LONG ptw32_lockwatchNextId;
+extern void (PTW32_CDECL *ptw32_lockwatchCallback) (const pthread_lockwatch_np_t *, void *);
+extern void * ptw32_lockwatchArg;
+extern int64_t ptw32_lockwatchLimit;
+#endif
 
-extern unsigned __int64 ptw32_threadSeqNumber;
+extern int ptw32_mutex_default_kind;
+extern int ptw32_mutex_default_spin;
+extern int ptw32_objectAlign;
+extern const struct pthread_attr_t_ ptw32_attr_default;
+extern const struct pthread_mutexattr_t_ ptw32_mutexattr_default;
+extern const struct pthread_condattr_t_ ptw32_condattr_default;
+extern const struct pthread_rwlockattr_t_ ptw32_rwlockattr_default;
+extern const struct pthread_barrierattr_t_ ptw32_barrierattr_default;
+extern ptw32_object_class_t ptw32_objectClasses[PTW32_OBJECT_CLASSES];
+extern int ptw32_largePages;
+extern int ptw32_largePageState;
+extern SIZE_T ptw32_largePageSize;
+extern ptw32_mcs_lock_t ptw32_largepage_lock;
+extern char * ptw32_largePageNext;
+extern char * ptw32_largePageEnd;
+extern ptw32_thread_t * ptw32_largePageThreads;
+extern SIZE_T (WINAPI *ptw32_getlargepageminimum) (void);
+extern int ptw32_mcs_spin_limit;
+extern int ptw32_spinBackoffLimit;
+extern int ptw32_spinYieldLimit;
+extern int ptw32_barrierSpinLimit;
+extern int ptw32_spinHintPs;
+extern LONG ptw32_spinCpus;
+extern LONG ptw32_spinCpusTick;
+extern int ptw32_hiresWait;
+extern int ptw32_wakeBoost;
+extern int ptw32_cpuTokens;
+extern volatile LONG ptw32_cpuTokensTotal;
+extern volatile LONG ptw32_cpuTokensFree;
+extern volatile LONG ptw32_cpuTokensWaiters;
+extern volatile LONG64 ptw32_libStats[PTW32_LIBSTAT_COUNT];
+
+extern volatile LONG64 ptw32_threadSeqNumber;
 
 extern int ptw32_concurrency;
 
+extern int ptw32_schedPolicy;
+
+extern int ptw32_yield_mode;
+extern int ptw32_fastExit;
+
 extern int ptw32_features;
 
+extern int ptw32_lockElide;
+
 extern ptw32_mcs_lock_t ptw32_thread_reuse_lock;
-extern ptw32_mcs_lock_t ptw32_mutex_test_init_lock;
-extern ptw32_mcs_lock_t ptw32_cond_list_lock;
-extern ptw32_mcs_lock_t ptw32_cond_test_init_lock;
-extern ptw32_mcs_lock_t ptw32_rwlock_test_init_lock;
-extern ptw32_mcs_lock_t ptw32_spinlock_test_init_lock;
+extern ptw32_mcs_lock_t ptw32_thread_cache_lock;
+extern ptw32_mcs_lock_t ptw32_thread_pool_lock;
+extern ptw32_mcs_lock_t ptw32_pshared_lock;
+extern ptw32_mcs_lock_t ptw32_named_sem_lock;
+extern ptw32_mcs_lock_t ptw32_fiber_lock;
+extern ptw32_mcs_lock_t ptw32_tsd_slot_lock;
+
+extern DWORD ptw32_tsdTableIndex;
+extern pthread_key_t * ptw32_tsdKeys;
+extern unsigned int ptw32_tsdNextSlot;
+extern unsigned int ptw32_tsdGeneration;
+extern unsigned int * ptw32_tsdFreeSlots;
+extern unsigned int ptw32_tsdNumFreeSlots;
+extern DWORD * ptw32_tsdRetired;
+extern unsigned int ptw32_tsdNumRetired;
 
 #if defined(_UWIN)
 extern int pthread_count;
@@ -675,6 +2818,81 @@ extern "C"
   int ptw32_rwlock_check_need_init (pthread_rwlock_t * rwlock);
   int ptw32_spinlock_check_need_init (pthread_spinlock_t * lock);
 
+  int ptw32_rwspin_check_need_init (pthread_rwspinlock_np_t * lock);
+
+  void ptw32_rwspin_wait (pthread_rwspinlock_np_t l, LONG seen, ptw32_rwspin_wait_t * w);
+
+  int ptw32_mutex_init (pthread_mutex_t * mutex, const pthread_mutexattr_t * attr,
+			void * storage, size_t size);
+
+  int ptw32_spinlock_init (pthread_spinlock_t * lock, int pshared, int kind,
+			   void * storage, size_t size);
+
+  int ptw32_cond_init (pthread_cond_t * cond, const pthread_condattr_t * attr,
+		       void * storage, size_t size);
+
+  void * ptw32_object_alloc (size_t size, int align);
+
+  void ptw32_object_free (void * p);
+
+  size_t ptw32_object_stride (size_t size, int align);
+
+  void ptw32_object_cache_flush (ptw32_thread_t * tp);
+
+  int ptw32_largepage_available (void);
+
+  void * ptw32_largepage_alloc (size_t size);
+
+  ptw32_thread_t * ptw32_largepage_thread_alloc (void);
+
+  void ptw32_largepage_thread_free (ptw32_thread_t * tp);
+
+  int ptw32_mutex_spin (pthread_mutex_t mx, LONG lockval);
+
+  int ptw32_cond_spin (pthread_cond_t cv, LONG seq);
+
+  int ptw32_mutex_wait (pthread_mutex_t mx, clockid_t clock,
+                        const struct timespec *abstime);
+
+  int ptw32_mutex_wake (pthread_mutex_t mx);
+
+  int ptw32_mutex_fair_acquire (pthread_mutex_t mx, clockid_t clock,
+                                const struct timespec *abstime);
+
+  int ptw32_mutex_fair_release (pthread_mutex_t mx);
+
+  ptw32_mutex_cohort_t * ptw32_mutex_cohort_new (int nNodes);
+
+  int ptw32_mutex_cohort_acquire (pthread_mutex_t mx);
+
+  int ptw32_mutex_cohort_release (pthread_mutex_t mx);
+
+  int ptw32_lock_elide_probe (void);
+
+  ptw32_lock_elide_t * ptw32_lock_elide_new (void);
+
+  int ptw32_mutex_elide_lock (pthread_mutex_t mx);
+
+  int ptw32_mutex_elide_unlock (pthread_mutex_t mx);
+
+  int ptw32_rwlock_elide_lock (pthread_rwlock_t rwl);
+
+  int ptw32_rwlock_elide_unlock (pthread_rwlock_t rwl);
+
+  int ptw32_mutex_prio_check (pthread_mutex_t mx);
+
+  void ptw32_mutex_prio_block (pthread_mutex_t mx,
+                               ptw32_mutex_prio_waiter_t * waiter);
+
+  void ptw32_mutex_prio_unblock (pthread_mutex_t mx,
+                                 ptw32_mutex_prio_waiter_t * waiter);
+
+  void ptw32_mutex_prio_acquired (pthread_mutex_t mx);
+
+  void ptw32_mutex_prio_release (pthread_mutex_t mx);
+
+  void ptw32_mutex_prio_quit (ptw32_thread_t * tp);
+
   int ptw32_robust_mutex_inherit(pthread_mutex_t * mutex);
   void ptw32_robust_mutex_add(pthread_mutex_t* mutex, pthread_t self);
   void ptw32_robust_mutex_remove(pthread_mutex_t* mutex, ptw32_thread_t* otp);
@@ -683,26 +2901,402 @@ extern "C"
     ptw32_Registercancellation (PAPCFUNC callback,
 			       HANDLE threadH, DWORD callback_arg);
 
+  HANDLE ptw32_cancel_event (ptw32_thread_t * tp);
+
+  void ptw32_cancel_io (ptw32_thread_t * tp);
+
+  int ptw32_cancel_thread (ptw32_thread_t * tp, int cancel_self);
+
+  void ptw32_group_leave (ptw32_thread_t * tp);
+
+  void ptw32_signal_deliver (ptw32_thread_t * sp);
+
+  void ptw32_testcancel_raise (ptw32_thread_t * sp, LONG bits);
+
+  void ptw32_testcancel_lower (ptw32_thread_t * sp, LONG bits);
+
   int ptw32_processInitialize (void);
 
+  void ptw32_cancel_initialize (void);
+
   void ptw32_processTerminate (void);
 
   void ptw32_threadDestroy (pthread_t tid);
 
   void ptw32_pop_cleanup_all (int execute);
 
+  void ptw32_exit_return (ptw32_thread_t * sp);
+
   pthread_t ptw32_new (void);
 
+  int ptw32_create (pthread_t * tid, const pthread_attr_t * attr,
+                    void *(PTW32_CDECL * start) (void *), void * arg,
+                    const void * payload, size_t size);
+
   pthread_t ptw32_threadReusePop (void);
 
   void ptw32_threadReusePush (pthread_t thread);
 
+  void ptw32_threadReuseTrim (int max);
+
+  void ptw32_threadReuseFree (ptw32_thread_t * tp);
+
+  int ptw32_thread_valid (pthread_t thread);
+
+  int ptw32_join_wait (ptw32_thread_t * tp);
+
+  void ptw32_arena_free (ptw32_arena_block_t * block);
+
+  HANDLE ptw32_implicit_handle (ptw32_thread_t * tp);
+
+#if defined(HAVE_CPU_AFFINITY)
+  void ptw32_implicit_affinity (ptw32_thread_t * tp);
+#endif
+
+  ThreadParms * ptw32_threadCachePark (ptw32_parked_thread_t * pt, HANDLE exitEvent);
+
+  ptw32_parked_thread_t * ptw32_threadCacheUnpark (unsigned int stackSize);
+
+  void ptw32_threadCacheTrim (int max);
+
+  void ptw32_threadCacheClearKeys (void);
+
+  int ptw32_threadPoolStart (ptw32_thread_t * tp);
+
+  void ptw32_threadRun (void);
+
+  int ptw32_fiber_create (ptw32_thread_t * tp, size_t stackSize, size_t stackCommit);
+
+  void ptw32_fiber_workers (void);
+
+  int ptw32_fiber_yield (void);
+
+  void ptw32_yield (int * yields);
+
+  DWORD ptw32_wait_objects (DWORD nCount, HANDLE * handles, DWORD milliseconds);
+
   int ptw32_getprocessors (int *count);
 
+  int ptw32_concurrency_level (void);
+
+  int ptw32_spin_pays (void);
+
+  void ptw32_spin_calibrate (void);
+
+  int ptw32_spin_hints (int ns);
+
+  BOOL WINAPI ptw32_park (volatile VOID * address, PVOID compare, SIZE_T size, DWORD milliseconds);
+
+  VOID WINAPI ptw32_unpark_one (PVOID address);
+
+  VOID WINAPI ptw32_unpark_all (PVOID address);
+
+  int ptw32_async_new (pthread_pool_np_t pool,
+                       void (PTW32_CDECL * callback) (void *),
+                       void * arg,
+                       ptw32_async_waiter_t ** waiter);
+
+  int ptw32_async_new_port (HANDLE port, void * key, void * overlapped,
+                            ptw32_async_waiter_t ** waiter);
+
+  void ptw32_async_free (ptw32_async_waiter_t * w);
+
+  void ptw32_async_wait (ptw32_async_waiter_t * w, volatile VOID * address);
+
+  int ptw32_async_wake (volatile VOID * address, int all);
+
+  int ptw32_async_mutex_check (pthread_mutex_t * mutex);
+
+#if defined(PTW32_LOCKSTAT)
+  int64_t ptw32_lockstat_now (void);
+
+  void ptw32_lockstat_init (ptw32_lockstat_t * stats, int kind, void * object);
+
+  void ptw32_lockstat_destroy (ptw32_lockstat_t * stats);
+
+  void ptw32_lockstat_waited (ptw32_lockstat_t * stats, int64_t start, int hold);
+
+  void ptw32_lockstat_released (ptw32_lockstat_t * stats);
+
+  void ptw32_lockstat_cond_waited (ptw32_lockstat_t * stats, int result, int64_t start);
+
+  int ptw32_lockstat_rwlock (pthread_rwlock_t rwl,
+                             int (*lock) (pthread_rwlock_t, const struct timespec *, int),
+                             const struct timespec * abstime, int tryOnly);
+
+  void ptw32_lockprof_sample (ptw32_lockstat_t * stats, int64_t start, int64_t waited);
+
+  void ptw32_lockprof_released (ptw32_lockstat_t * stats);
+#endif
+
+#if defined(PTW32_ETW)
+  void ptw32_etw_register (void);
+
+  void ptw32_etw_unregister (void);
+
+  void ptw32_etw_write (int event, const void * object, int64_t value);
+#endif
+
+#if defined(PTW32_PERFCOUNTERS)
+  void ptw32_perf_register (void);
+
+  void ptw32_perf_unregister (void);
+#endif
+
+#if defined(PTW32_LOCKWATCH)
+  void ptw32_lockwatch_order (pthread_mutex_t mx);
+
+  void ptw32_lockwatch_acquired (pthread_mutex_t mx);
+
+  void ptw32_lockwatch_release (pthread_mutex_t mx);
+#endif
+
   int ptw32_setthreadpriority (pthread_t thread, int policy, int priority);
 
+  void ptw32_boostthreadpriority (ptw32_thread_t * tp, int boost);
+
   void ptw32_rwlock_cancelwrwait (void *arg);
 
+  int ptw32_rwlock_readers_init (pthread_rwlock_t rwl);
+
+  int ptw32_rwlock_readers_active (pthread_rwlock_t rwl);
+
+  int ptw32_rwlock_readers_rdlock (pthread_rwlock_t rwl,
+				   const struct timespec *abstime, int tryOnly);
+
+  int ptw32_rwlock_readers_wrlock (pthread_rwlock_t rwl,
+				   const struct timespec *abstime, int tryOnly);
+
+  int ptw32_rwlock_readers_unlock (pthread_rwlock_t rwl);
+
+  int ptw32_rwlock_policy_init (pthread_rwlock_t rwl, int kind);
+
+  int ptw32_rwlock_policy_destroy (pthread_rwlock_t rwl);
+
+  int ptw32_rwlock_policy_rdlock (pthread_rwlock_t rwl,
+				  const struct timespec *abstime, int tryOnly);
+
+  int ptw32_rwlock_policy_wrlock (pthread_rwlock_t rwl,
+				  const struct timespec *abstime, int tryOnly);
+
+  int ptw32_rwlock_policy_unlock (pthread_rwlock_t rwl);
+
+  int ptw32_rwlock_policy_downgrade (pthread_rwlock_t rwl);
+
+  int ptw32_rwlock_policy_rdlock_upgradable (pthread_rwlock_t rwl, int tryOnly);
+
+  int ptw32_rwlock_policy_upgrade (pthread_rwlock_t rwl);
+
+  int ptw32_rwlock_srw_destroy (pthread_rwlock_t rwl);
+
+  int ptw32_rwlock_srw_rdlock (pthread_rwlock_t rwl,
+			       const struct timespec *abstime, int tryOnly);
+
+  int ptw32_rwlock_srw_wrlock (pthread_rwlock_t rwl,
+			       const struct timespec *abstime, int tryOnly);
+
+  int ptw32_rwlock_srw_unlock (pthread_rwlock_t rwl);
+
+  int ptw32_tsd_slot_alloc (pthread_key_t key);
+
+  void ptw32_tsd_slot_free (pthread_key_t key);
+
+  int ptw32_tsd_mark_destructor (ptw32_thread_t * sp, pthread_key_t key);
+
+  void * ptw32_tsd_table_get (pthread_key_t key);
+
+  int ptw32_tsd_table_set (pthread_key_t key, const void * value);
+
+  void ptw32_tsd_table_release (void);
+
+  void ptw32_tsd_task_end (void);
+
+  void ptw32_barrier_park (volatile LONG * word, LONG seen, volatile LONG * nParked);
+
+  int ptw32_barrier_tree_init (pthread_barrier_t b, unsigned int count);
+
+  int ptw32_barrier_tree_destroy (pthread_barrier_t b);
+
+  int ptw32_barrier_tree_arrive (pthread_barrier_t b, LONG * arrivedAt);
+
+  int ptw32_barrier_tree_wait (pthread_barrier_t b);
+
+  int ptw32_pshared_alloc (void ** handle, ptw32_pshared_slot_t ** slot);
+
+  ptw32_pshared_slot_t * ptw32_pshared_get (void * handle, LONG type);
+
+  HANDLE ptw32_pshared_kernel (void * handle, int n);
+
+  int ptw32_pshared_unwait (LONG * value, HANDLE h);
+
+  void ptw32_pshared_free (void * handle);
+
+  void ptw32_pshared_terminate (void);
+
+  int ptw32_pshared_mutex_init (pthread_mutex_t * mutex, int kind, int robustness);
+
+  int ptw32_pshared_mutex_destroy (pthread_mutex_t * mutex);
+
+  int ptw32_pshared_mutex_lock (pthread_mutex_t mutex, clockid_t clock,
+				const struct timespec * abstime);
+
+  int ptw32_pshared_mutex_trylock (pthread_mutex_t mutex);
+
+  int ptw32_pshared_mutex_unlock (pthread_mutex_t mutex);
+
+  int ptw32_pshared_mutex_consistent (pthread_mutex_t mutex);
+
+  int ptw32_pshared_cond_init (pthread_cond_t * cond, clockid_t clock);
+
+  int ptw32_pshared_cond_destroy (pthread_cond_t * cond);
+
+  int ptw32_pshared_cond_wait (pthread_cond_t cond, pthread_mutex_t * mutex,
+			       clockid_t clock, const struct timespec * abstime);
+
+  int ptw32_pshared_cond_unblock (pthread_cond_t cond, int unblockAll);
+
+  int ptw32_pshared_sem_init (sem_t * sem, unsigned int value);
+
+  int ptw32_pshared_sem_destroy (sem_t * sem);
+
+  int ptw32_pshared_sem_wait (sem_t sem, clockid_t clock,
+			      const struct timespec * abstime);
+
+  int ptw32_pshared_sem_take (sem_t sem, int max);
+
+  int ptw32_pshared_sem_post (sem_t sem, int count);
+
+  int ptw32_pshared_sem_getvalue (sem_t sem, int * sval);
+
+  HANDLE ptw32_sem_name_map (const char * name, int create, ptw32_sem_name_t ** view);
+
+  void ptw32_sem_name_lock (ptw32_sem_name_t * name);
+
+  void ptw32_sem_name_unlock (ptw32_sem_name_t * name);
+
+  void ptw32_named_sem_release (sem_t sem);
+
+  int ptw32_pshared_barrier_init (pthread_barrier_t * barrier, unsigned int count);
+
+  int ptw32_pshared_barrier_destroy (pthread_barrier_t * barrier);
+
+  int ptw32_pshared_barrier_wait (pthread_barrier_t barrier);
+
+  int ptw32_pshared_barrier_arrive (pthread_barrier_t barrier, LONG * arrivedAt);
+
+  int ptw32_pshared_barrier_wait_cycle (pthread_barrier_t barrier, LONG cycle);
+
+  int ptw32_wsdeque_init (pthread_wsdeque_np_t dq);
+
+  void ptw32_wsdeque_free (pthread_wsdeque_np_t dq);
+
+  int ptw32_wsdeque_push (pthread_wsdeque_np_t dq, void * item);
+
+  int ptw32_wsdeque_pop (pthread_wsdeque_np_t dq, void ** item);
+
+  int ptw32_wsdeque_steal (pthread_wsdeque_np_t dq, void ** item);
+
+  int ptw32_wsdeque_empty (pthread_wsdeque_np_t dq);
+
+  void ptw32_spsc_wait (volatile LONG * index, LONG seen, volatile LONG * parked);
+
+  void ptw32_spsc_wake (volatile LONG * index, volatile LONG * parked);
+
+  void * PTW32_CDECL ptw32_pool_worker (void * arg);
+
+  int ptw32_pool_push (pthread_pool_np_t pool, ptw32_pool_worker_t * w,
+                       pthread_pool_task_np_t task);
+
+  pthread_pool_task_np_t ptw32_pool_get (pthread_pool_np_t pool, ptw32_pool_worker_t * w);
+
+  int ptw32_pool_has_tasks (pthread_pool_np_t pool);
+
+  void ptw32_pool_run (ptw32_pool_worker_t * w, pthread_pool_task_np_t task);
+
+  void ptw32_pool_wake (pthread_pool_np_t pool);
+
+  void ptw32_pool_block (pthread_pool_np_t pool);
+
+  void ptw32_pool_unblock (pthread_pool_np_t pool);
+
+  int ptw32_cputokens_take (int min, int max);
+
+  void ptw32_cputokens_give (int count);
+
+  void ptw32_cputoken_hold (ptw32_thread_t * sp);
+
+  void ptw32_cputoken_drop (ptw32_thread_t * sp, int state);
+
+  void PTW32_CDECL ptw32_pool_wait_cleanup (void * arg);
+
+  void ptw32_pool_free (pthread_pool_np_t pool);
+
+  int ptw32_pool_loop (pthread_pool_np_t pool, ptw32_pool_loop_t * loop,
+                       void * (PTW32_CDECL *combine) (void *, void *, void *),
+                       void ** value_ptr);
+
+#if defined(PTW32_TIMER_CREATE)
+  int ptw32_timer_start (void);
+
+  int ptw32_timer_reserve (int count);
+
+  void ptw32_timer_arm (timer_t t, int64_t expiry, int64_t interval);
+
+  void ptw32_timer_release (timer_t t);
+#endif
+
+  void ptw32_queue_put (pthread_queue_np_t queue, void * item);
+
+  ptw32_rcu_reader_t * ptw32_rcu_register (ptw32_thread_t * sp);
+
+  ptw32_hazard_record_t * ptw32_hazard_register (ptw32_thread_t * sp);
+
+  int ptw32_hazard_scan (ptw32_hazard_record_t * rec);
+
+  ptw32_waitgraph_record_t * ptw32_waitgraph_block (pthread_mutex_t mx);
+
+  void ptw32_waitgraph_unblock (ptw32_waitgraph_record_t * rec);
+
+  void ptw32_flightrec_record (int event, const void * object, int64_t value);
+
+  void ptw32_waitany_notify (void);
+
+  void * ptw32_queue_get (pthread_queue_np_t queue);
+
+#if ! defined(NEED_PROCESS_AFFINITY_MASK)
+  int ptw32_getprocessaffinity (cpu_set_t * cpuset);
+
+  int ptw32_setthreadaffinity (HANDLE threadH, const cpu_set_t * cpuset, int spread);
+
+  int ptw32_getthreadaffinity (HANDLE threadH, cpu_set_t * cpuset);
+
+  int ptw32_setthreadsoftaffinity (HANDLE threadH, const cpu_set_t * cpuset);
+#endif
+
+  void ptw32_cpusetcopy (void * dest, size_t destsize, const void * src, size_t srcsize);
+
+  ptw32_topology_t * ptw32_gettopology (void);
+
+  void ptw32_topologycpus (const int * table, int id, cpu_set_t * cpuset);
+
+  void ptw32_setthreadqos (HANDLE threadH, int qos);
+
+  void ptw32_setthreadwakeboost (HANDLE threadH, int boost);
+
+  void ptw32_setthreadname (ptw32_thread_t * tp);
+
+  void ptw32_param_environment (void);
+
+  HANDLE ptw32_libstat_handle (HANDLE h, int stat);
+
+  BOOL ptw32_closehandle (HANDLE h, int stat);
+
+  void ptw32_libstat_wait (int stat);
+
+  int ptw32_wait_on_address (volatile void * address, const void * expected,
+			     size_t size, clockid_t clock, const struct timespec * abstime,
+			     int stat);
+
 #if ! defined (PTW32_CONFIG_MINGW) || (defined (__MSVCRT__) && ! defined (__DMC__))
   unsigned __stdcall
 #else
@@ -712,13 +3306,44 @@ extern "C"
 
   void ptw32_callUserDestroyRoutines (pthread_t thread);
 
-  int ptw32_tkAssocCreate (ptw32_thread_t * thread, pthread_key_t key);
+  int ptw32_semwait (sem_t * sem);
+
+#if !defined(NEED_SEM)
+  int ptw32_sem_decrement (sem_t s);
 
-  void ptw32_tkAssocDestroy (ThreadKeyAssoc * assoc);
+  int ptw32_sem_unwait (sem_t s);
 
-  int ptw32_semwait (sem_t * sem);
+  int ptw32_sem_fifo_wait (sem_t s, clockid_t clock, const struct timespec * abstime);
+
+  int ptw32_sem_fifo_post (sem_t s, int count);
+#endif
+
+  void ptw32_sem_release (sem_t s);
+
+  int64_t ptw32_rel100nanosecs (clockid_t clock, const struct timespec * abstime);
+
+  DWORD ptw32_relmillisecs (clockid_t clock, const struct timespec * abstime);
+
+  DWORD ptw32_wait_timeout (clockid_t clock, const struct timespec * abstime,
+                            HANDLE * timer);
 
-  DWORD ptw32_relmillisecs (const struct timespec * abstime);
+  int ptw32_cancelable_abstimed_wait (HANDLE waitHandle, clockid_t clock,
+                                      const struct timespec * abstime);
+
+  BOOL ptw32_waitonaddress_abstime (volatile VOID * address, PVOID compare,
+                                    SIZE_T size, clockid_t clock,
+                                    const struct timespec * abstime);
+
+  BOOL ptw32_timer_wheel_wait (volatile VOID * address, PVOID compare,
+                               SIZE_T size, int64_t timeout);
+
+  void ptw32_timer_wheel_retick (int64_t tick);
+
+  int64_t ptw32_wait_begin (void);
+
+  void ptw32_wait_end (int64_t start);
+
+  void ptw32_hist_add (ptw32_thread_t * sp, int kind, int64_t ticks);
 
   void ptw32_mcs_lock_acquire (ptw32_mcs_lock_t * lock, ptw32_mcs_local_node_t * node);
 
@@ -728,10 +3353,21 @@ extern "C"
 
   void ptw32_mcs_node_transfer (ptw32_mcs_local_node_t * new_node, ptw32_mcs_local_node_t * old_node);
 
-#if defined(NEED_FTIME)
   void ptw32_timespec_to_filetime (const struct timespec *ts, FILETIME * ft);
   void ptw32_filetime_to_timespec (const FILETIME * ft, struct timespec *ts);
-#endif
+
+  void ptw32_filetime_now (FILETIME * ft);
+
+  int64_t ptw32_perf_frequency (void);
+
+  unsigned __int64 ptw32_ticks_to_ns (int64_t ticks);
+
+  void ptw32_monotonic_now (struct timespec *ts);
+
+  int64_t ptw32_monotonic_100nanosecs (void);
+
+  void ptw32_monotonic_deadline (clockid_t clock, const struct timespec * abstime,
+                                 struct timespec * deadline);
 
 /* Declared in misc.c */
 #if defined(NEED_CALLOC)
@@ -821,7 +3457,7 @@ extern "C"
 # define PTW32_TO_VLONG64PTR(ptr) (ptr)
 #endif
 
-#if defined(__GNUC__)
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
 # if defined(_WIN64)
 # define PTW32_INTERLOCKED_COMPARE_EXCHANGE_64(location, value, comparand) \
     ({                                                                     \
@@ -942,6 +3578,45 @@ extern "C"
         :"memory", "cc");                                                  \
       --_temp;                                                             \
     })
+# define PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR(location, value, comparand) \
+    PTW32_INTERLOCKED_COMPARE_EXCHANGE_SIZE((PTW32_INTERLOCKED_SIZEPTR)location, \
+                                            (PTW32_INTERLOCKED_SIZE)value, \
+                                            (PTW32_INTERLOCKED_SIZE)comparand)
+# define PTW32_INTERLOCKED_EXCHANGE_PTR(location, value) \
+    PTW32_INTERLOCKED_EXCHANGE_SIZE((PTW32_INTERLOCKED_SIZEPTR)location, \
+                                    (PTW32_INTERLOCKED_SIZE)value)
+#elif defined(__GNUC__)
+/*
+ * ARM64 and anything else GCC or clang targets: the sequentially
+ * consistent builtins. Built with -march=armv8.1-a (see the -arm64
+ * targets in GNUmakefile) these are the single LSE instructions casal,
+ * swpal and ldaddal rather than ldaxr/stlxr retry loops.
+ */
+# if defined(__ATOMIC_SEQ_CST)
+#  define PTW32_GCC_CAS_(p,v,c) \
+    ({ __typeof (c) _c = (c); \
+       (void) __atomic_compare_exchange_n ((p), &_c, (v), 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); \
+       _c; })
+#  define PTW32_GCC_XCHG_(p,v)	__atomic_exchange_n ((p), (v), __ATOMIC_SEQ_CST)
+#  define PTW32_GCC_XADD_(p,v)	__atomic_fetch_add ((p), (v), __ATOMIC_SEQ_CST)
+# else
+#  define PTW32_GCC_CAS_(p,v,c)	__sync_val_compare_and_swap ((p), (c), (v))
+#  define PTW32_GCC_XCHG_(p,v) \
+    ({ __sync_synchronize (); __sync_lock_test_and_set ((p), (v)); })
+#  define PTW32_GCC_XADD_(p,v)	__sync_fetch_and_add ((p), (v))
+# endif
+# if defined(_WIN64)
+#  define PTW32_INTERLOCKED_COMPARE_EXCHANGE_64(p,v,c) PTW32_GCC_CAS_(PTW32_TO_VLONG64PTR(p),(LONG64)(v),(LONG64)(c))
+#  define PTW32_INTERLOCKED_EXCHANGE_64(p,v) PTW32_GCC_XCHG_(PTW32_TO_VLONG64PTR(p),(LONG64)(v))
+#  define PTW32_INTERLOCKED_EXCHANGE_ADD_64(p,v) PTW32_GCC_XADD_(PTW32_TO_VLONG64PTR(p),(LONG64)(v))
+#  define PTW32_INTERLOCKED_INCREMENT_64(p) (PTW32_GCC_XADD_(PTW32_TO_VLONG64PTR(p),(LONG64)1) + 1)
+#  define PTW32_INTERLOCKED_DECREMENT_64(p) (PTW32_GCC_XADD_(PTW32_TO_VLONG64PTR(p),(LONG64)-1) - 1)
+# endif
+# define PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(p,v,c) PTW32_GCC_CAS_((p),(LONG)(v),(LONG)(c))
+# define PTW32_INTERLOCKED_EXCHANGE_LONG(p,v) PTW32_GCC_XCHG_((p),(LONG)(v))
+# define PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(p,v) PTW32_GCC_XADD_((p),(LONG)(v))
+# define PTW32_INTERLOCKED_INCREMENT_LONG(p) (PTW32_GCC_XADD_((p),(LONG)1) + 1)
+# define PTW32_INTERLOCKED_DECREMENT_LONG(p) (PTW32_GCC_XADD_((p),(LONG)-1) - 1)
 # define PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR(location, value, comparand) \
     PTW32_INTERLOCKED_COMPARE_EXCHANGE_SIZE((PTW32_INTERLOCKED_SIZEPTR)location, \
                                             (PTW32_INTERLOCKED_SIZE)value, \
@@ -990,6 +3665,92 @@ extern "C"
 #   define PTW32_INTERLOCKED_DECREMENT_SIZE(p) PTW32_INTERLOCKED_DECREMENT_LONG((p))
 #endif
 
+/*
+ * Ordered atomics for the lock fast paths. The PTW32_INTERLOCKED_*
+ * operations are all full barriers, which on ARM64 costs a dmb each;
+ * taking a lock only needs acquire order and releasing it release
+ * order. _ACQ operations keep later accesses after them, _REL ones
+ * keep earlier accesses before them and _RELAXED ones order nothing.
+ * The RMW forms return the old value, as the Interlocked ones do.
+ *
+ * x86 and x64 loads and stores already have acquire and release
+ * order and every locked instruction is a full barrier, so there these
+ * compile to what was used before. Elsewhere, without the intrinsics
+ * or builtins, they fall back to the full barrier operations.
+ */
+#if defined(__GNUC__) && defined(__ATOMIC_ACQUIRE)
+# define PTW32_ATOMIC_LOAD_RELAXED_LONG(p)	__atomic_load_n ((p), __ATOMIC_RELAXED)
+# define PTW32_ATOMIC_LOAD_ACQ_LONG(p)	__atomic_load_n ((p), __ATOMIC_ACQUIRE)
+# define PTW32_ATOMIC_STORE_RELAXED_LONG(p,v)	__atomic_store_n ((p), (v), __ATOMIC_RELAXED)
+# define PTW32_ATOMIC_STORE_REL_LONG(p,v)	__atomic_store_n ((p), (v), __ATOMIC_RELEASE)
+# define PTW32_ATOMIC_EXCHANGE_ACQ_LONG(p,v)	__atomic_exchange_n ((p), (v), __ATOMIC_ACQUIRE)
+# define PTW32_ATOMIC_EXCHANGE_REL_LONG(p,v)	__atomic_exchange_n ((p), (v), __ATOMIC_RELEASE)
+# define PTW32_ATOMIC_EXCHANGE_ADD_ACQ_LONG(p,v)	__atomic_fetch_add ((p), (v), __ATOMIC_ACQUIRE)
+# define PTW32_ATOMIC_EXCHANGE_ADD_REL_LONG(p,v)	__atomic_fetch_add ((p), (v), __ATOMIC_RELEASE)
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG(p,v,c) \
+    ({ PTW32_INTERLOCKED_LONG _c = (c); \
+       (void) __atomic_compare_exchange_n ((p), &_c, (v), 0, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE); \
+       _c; })
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_REL_LONG(p,v,c) \
+    ({ PTW32_INTERLOCKED_LONG _c = (c); \
+       (void) __atomic_compare_exchange_n ((p), &_c, (v), 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED); \
+       _c; })
+# define PTW32_ATOMIC_LOAD_ACQ_SIZE(p)	__atomic_load_n ((p), __ATOMIC_ACQUIRE)
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+# include <intrin.h>
+# define PTW32_ATOMIC_LOAD_RELAXED_LONG(p)	((long) __iso_volatile_load32 ((const volatile __int32 *) (p)))
+# define PTW32_ATOMIC_LOAD_ACQ_LONG(p)	((long) __ldar32 ((volatile unsigned __int32 *) (p)))
+# define PTW32_ATOMIC_STORE_RELAXED_LONG(p,v)	__iso_volatile_store32 ((volatile __int32 *) (p), (__int32) (v))
+# define PTW32_ATOMIC_STORE_REL_LONG(p,v)	__stlr32 ((volatile unsigned __int32 *) (p), (unsigned __int32) (v))
+# define PTW32_ATOMIC_EXCHANGE_ACQ_LONG(p,v)	_InterlockedExchange_acq ((p), (v))
+# define PTW32_ATOMIC_EXCHANGE_REL_LONG(p,v)	_InterlockedExchange_rel ((p), (v))
+# define PTW32_ATOMIC_EXCHANGE_ADD_ACQ_LONG(p,v)	_InterlockedExchangeAdd_acq ((p), (v))
+# define PTW32_ATOMIC_EXCHANGE_ADD_REL_LONG(p,v)	_InterlockedExchangeAdd_rel ((p), (v))
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG(p,v,c)	_InterlockedCompareExchange_acq ((p), (v), (c))
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_REL_LONG(p,v,c)	_InterlockedCompareExchange_rel ((p), (v), (c))
+# define PTW32_ATOMIC_LOAD_ACQ_SIZE(p)	((PTW32_INTERLOCKED_SIZE) __ldar64 ((volatile unsigned __int64 *) (p)))
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+/* Volatile accesses: the compiler keeps them ordered too (/volatile:ms) */
+# define PTW32_ATOMIC_LOAD_RELAXED_LONG(p)	(*(p))
+# define PTW32_ATOMIC_LOAD_ACQ_LONG(p)	(*(p))
+# define PTW32_ATOMIC_STORE_RELAXED_LONG(p,v)	((void) (*(p) = (v)))
+# define PTW32_ATOMIC_STORE_REL_LONG(p,v)	((void) (*(p) = (v)))
+# define PTW32_ATOMIC_EXCHANGE_ACQ_LONG(p,v)	PTW32_INTERLOCKED_EXCHANGE_LONG ((p), (v))
+# define PTW32_ATOMIC_EXCHANGE_REL_LONG(p,v)	PTW32_INTERLOCKED_EXCHANGE_LONG ((p), (v))
+# define PTW32_ATOMIC_EXCHANGE_ADD_ACQ_LONG(p,v)	PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((p), (v))
+# define PTW32_ATOMIC_EXCHANGE_ADD_REL_LONG(p,v)	PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((p), (v))
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG(p,v,c)	PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((p), (v), (c))
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_REL_LONG(p,v,c)	PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((p), (v), (c))
+# define PTW32_ATOMIC_LOAD_ACQ_SIZE(p)	(*(p))
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+/* GCC before 4.7: only the compiler needs holding back */
+# define PTW32_ATOMIC_LOAD_RELAXED_LONG(p)	(*(p))
+# define PTW32_ATOMIC_LOAD_ACQ_LONG(p) \
+    ({ __typeof (*(p)) _v = *(p); __asm__ __volatile__ ("" : : : "memory"); _v; })
+# define PTW32_ATOMIC_STORE_RELAXED_LONG(p,v)	((void) (*(p) = (v)))
+# define PTW32_ATOMIC_STORE_REL_LONG(p,v) \
+    ({ __asm__ __volatile__ ("" : : : "memory"); (void) (*(p) = (v)); })
+# define PTW32_ATOMIC_EXCHANGE_ACQ_LONG(p,v)	PTW32_INTERLOCKED_EXCHANGE_LONG ((p), (v))
+# define PTW32_ATOMIC_EXCHANGE_REL_LONG(p,v)	PTW32_INTERLOCKED_EXCHANGE_LONG ((p), (v))
+# define PTW32_ATOMIC_EXCHANGE_ADD_ACQ_LONG(p,v)	PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((p), (v))
+# define PTW32_ATOMIC_EXCHANGE_ADD_REL_LONG(p,v)	PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((p), (v))
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG(p,v,c)	PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((p), (v), (c))
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_REL_LONG(p,v,c)	PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((p), (v), (c))
+# define PTW32_ATOMIC_LOAD_ACQ_SIZE(p)	PTW32_ATOMIC_LOAD_ACQ_LONG (p)
+#else
+# define PTW32_ATOMIC_LOAD_RELAXED_LONG(p)	(*(p))
+# define PTW32_ATOMIC_LOAD_ACQ_LONG(p)	PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((p), 0)
+# define PTW32_ATOMIC_STORE_RELAXED_LONG(p,v)	((void) (*(p) = (v)))
+# define PTW32_ATOMIC_STORE_REL_LONG(p,v)	((void) PTW32_INTERLOCKED_EXCHANGE_LONG ((p), (v)))
+# define PTW32_ATOMIC_EXCHANGE_ACQ_LONG(p,v)	PTW32_INTERLOCKED_EXCHANGE_LONG ((p), (v))
+# define PTW32_ATOMIC_EXCHANGE_REL_LONG(p,v)	PTW32_INTERLOCKED_EXCHANGE_LONG ((p), (v))
+# define PTW32_ATOMIC_EXCHANGE_ADD_ACQ_LONG(p,v)	PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((p), (v))
+# define PTW32_ATOMIC_EXCHANGE_ADD_REL_LONG(p,v)	PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((p), (v))
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG(p,v,c)	PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((p), (v), (c))
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_REL_LONG(p,v,c)	PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((p), (v), (c))
+# define PTW32_ATOMIC_LOAD_ACQ_SIZE(p)	PTW32_INTERLOCKED_EXCHANGE_ADD_SIZE ((p), 0)
+#endif
+
 #if defined(NEED_CREATETHREAD)
 
 /*
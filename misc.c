@@ -44,4 +44,13 @@
 #include "pthread_equal.c"
 #include "pthread_setconcurrency.c"
 #include "pthread_getconcurrency.c"
+#include "clock_gettime.c"
+#include "clock_getres.c"
+#include "nanosleep.c"
+#include "pthread_getcpuclockid.c"
+#include "timer_create.c"
+#include "timer_delete.c"
+#include "timer_settime.c"
+#include "timer_gettime.c"
+#include "timer_getoverrun.c"
 #include "w32_CancelableWait.c"
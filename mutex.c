@@ -54,6 +54,12 @@
 #include "pthread_mutexattr_gettype.c"
 #include "pthread_mutexattr_setrobust.c"
 #include "pthread_mutexattr_getrobust.c"
+#include "pthread_mutexattr_setprotocol.c"
+#include "pthread_mutexattr_getprotocol.c"
+#include "pthread_mutexattr_setprioceiling.c"
+#include "pthread_mutexattr_getprioceiling.c"
+#include "pthread_mutex_setprioceiling.c"
+#include "pthread_mutex_getprioceiling.c"
 #include "pthread_mutex_lock.c"
 #include "pthread_mutex_timedlock.c"
 #include "pthread_mutex_unlock.c"
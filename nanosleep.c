@@ -0,0 +1,98 @@
+/*
+ * nanosleep.c
+ * 
+ * Description:
+ * POSIX clock functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_CLOCK_GETTIME)
+
+int
+nanosleep (const struct timespec *rqtp, struct timespec *rmtp)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function suspends the calling thread for an
+      *      interval.
+      *
+      * PARAMETERS
+      *      rqtp
+      *              pointer to the interval
+      *
+      *      rmtp
+      *              pointer to an instance of struct timespec to
+      *              receive the time left (always zero), or NULL
+      *
+      * DESCRIPTION
+      *      The interval is measured against CLOCK_MONOTONIC as
+      *      pthread_delay_np measures it: to the 100 nanoseconds
+      *      where the system has high resolution timers. Nothing
+      *      interrupts the sleep but cancellation; this is a
+      *      cancellation point.
+      *
+      * RESULTS
+      *              0               slept for the interval,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'rqtp' is NULL or tv_nsec is not
+      *                              from 0 to 999999999.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result;
+
+  if (rqtp == NULL)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  if (0 != (result = pthread_delay_np ((struct timespec *) rqtp)))
+    {
+      errno = result;
+      return -1;
+    }
+
+  if (rmtp != NULL)
+    {
+      rmtp->tv_sec = 0;
+      rmtp->tv_nsec = 0;
+    }
+
+  return 0;
+}
+
+#endif /* PTW32_CLOCK_GETTIME */
@@ -39,10 +39,147 @@
 
 #include "pthread_mutexattr_setkind_np.c"
 #include "pthread_mutexattr_getkind_np.c"
+#include "pthread_mutexattr_setspin_np.c"
+#include "pthread_mutexattr_getspin_np.c"
+#include "pthread_condattr_setspin_np.c"
+#include "pthread_condattr_getspin_np.c"
+#include "pthread_condattr_setwakeorder_np.c"
+#include "pthread_condattr_getwakeorder_np.c"
+#include "pthread_mutexattr_setfairness_np.c"
+#include "pthread_mutexattr_getfairness_np.c"
+#include "pthread_mutex_setdefaultspin_np.c"
+#include "pthread_mutex_init_storage_np.c"
+#include "pthread_mutex_kind_np.c"
+#include "pthread_mutex_init_array_np.c"
+#include "pthread_mutex_destroy_array_np.c"
+#include "pthread_cond_init_array_np.c"
+#include "pthread_cond_destroy_array_np.c"
+#include "pthread_mutex_getdefaultspin_np.c"
+#include "pthread_setthreadcache_np.c"
+#include "pthread_getthreadcache_np.c"
+#include "pthread_setthreadreuse_np.c"
+#include "pthread_getthreadreuse_np.c"
+#include "pthread_settimerslack_np.c"
+#include "pthread_gettimerslack_np.c"
+#include "pthread_setobjectalign_np.c"
+#include "pthread_setparam_np.c"
+#include "pthread_getobjectalign_np.c"
+#include "pthread_rwlockattr_setdistributed_np.c"
+#include "pthread_rwlockattr_getdistributed_np.c"
+#include "pthread_rwlockattr_setkind_np.c"
+#include "pthread_rwlockattr_getkind_np.c"
+#include "pthread_rwlock_downgrade_np.c"
+#include "pthread_rwlock_rdlock_upgradable_np.c"
+#include "pthread_rwlock_upgrade_np.c"
+#include "pthread_spin_init_np.c"
+#include "pthread_spin_init_storage_np.c"
+#include "pthread_spin_init_array_np.c"
+#include "pthread_spin_destroy_array_np.c"
+#include "pthread_barrierattr_setkind_np.c"
+#include "pthread_barrierattr_getkind_np.c"
+#include "pthread_barrier_arrive_np.c"
+#include "pthread_latch_init_np.c"
+#include "pthread_latch_destroy_np.c"
+#include "pthread_latch_wait_np.c"
+#include "pthread_phaser_init_np.c"
+#include "pthread_phaser_destroy_np.c"
+#include "pthread_phaser_arrive_np.c"
+#include "pthread_group_create_np.c"
+#include "pthread_group_destroy_np.c"
+#include "pthread_group_add_np.c"
+#include "pthread_group_cancel_np.c"
+#include "pthread_group_join_np.c"
+#include "pthread_group_setaffinity_np.c"
+#include "pthread_group_setschedparam_np.c"
 #include "pthread_getw32threadhandle_np.c"
 #include "pthread_getunique_np.c"
+#include "pthread_once_np.c"
+#include "pthread_getspecific_fast_np.c"
+#include "pthread_key_create_np.c"
+#include "pthread_pool_create_np.c"
+#include "pthread_pool_destroy_np.c"
+#include "pthread_pool_submit_np.c"
+#include "pthread_pool_task_wait_np.c"
+#include "pthread_pool_wait_np.c"
+#include "pthread_pool_parallel_for_np.c"
+#include "pthread_pool_parallel_reduce_np.c"
+#include "pthread_setcputokens_np.c"
+#include "pthread_getcputokens_np.c"
+#include "pthread_cputokens_acquire_np.c"
+#include "pthread_queue_create_np.c"
+#include "pthread_queue_destroy_np.c"
+#include "pthread_queue_pop_np.c"
+#include "pthread_queue_push_np.c"
+#include "pthread_wsdeque_np.c"
+#include "pthread_spsc_create_np.c"
+#include "pthread_spsc_destroy_np.c"
+#include "pthread_spsc_pop_np.c"
+#include "pthread_spsc_push_np.c"
+#include "pthread_lockstripe_create_np.c"
+#include "pthread_lockstripe_destroy_np.c"
+#include "pthread_lockstripe_lock_np.c"
+#include "pthread_lockstripe_unlock_np.c"
+#include "pthread_seqlock_init_np.c"
+#include "pthread_seqlock_destroy_np.c"
+#include "pthread_seqlock_read_np.c"
+#include "pthread_seqlock_write_np.c"
+#include "pthread_rwspin_init_np.c"
+#include "pthread_rwspin_destroy_np.c"
+#include "pthread_rwspin_rdlock_np.c"
+#include "pthread_rwspin_wrlock_np.c"
+#include "pthread_rwspin_unlock_np.c"
+#include "pthread_mcs_lock_np.c"
+#include "pthread_percpu_create_np.c"
+#include "pthread_percpu_destroy_np.c"
+#include "pthread_percpu_slot_np.c"
+#include "pthread_counter_add_np.c"
+#include "pthread_counter_destroy_np.c"
+#include "pthread_counter_init_np.c"
+#include "pthread_counter_read_np.c"
+#include "pthread_rcu_online_np.c"
+#include "pthread_io_begin_np.c"
+#include "pthread_rcu_synchronize_np.c"
+#include "pthread_call_rcu_np.c"
+#include "pthread_hazard_protect_np.c"
+#include "pthread_hazard_retire_np.c"
+#include "pthread_wait_on_address_np.c"
+#include "pthread_wake_np.c"
+#include "pthread_waitany_np.c"
+#include "pthread_attr_getnumanode_np.c"
+#include "pthread_attr_setnumanode_np.c"
+#include "pthread_attr_getqos_np.c"
+#include "pthread_attr_setqos_np.c"
+#include "pthread_attr_getpooled_np.c"
+#include "pthread_attr_setpooled_np.c"
+#include "pthread_attr_getstackcommit_np.c"
+#include "pthread_attr_setstackcommit_np.c"
+#include "pthread_getnumanode_np.c"
+#include "pthread_getqos_np.c"
+#include "pthread_setqos_np.c"
+#include "pthread_getwakeboost_np.c"
+#include "pthread_setwakeboost_np.c"
+#include "pthread_setsoftaffinity_np.c"
+#include "pthread_getstats_np.c"
+#include "pthread_getlibstats_np.c"
+#include "pthread_topology_np.c"
+#include "pthread_lockstat_np.c"
+#include "pthread_lockprof_np.c"
+#include "pthread_dump_waitgraph_np.c"
+#include "pthread_flightrec_dump_np.c"
+#include "pthread_gethistograms_np.c"
+#include "pthread_lockwatch_np.c"
 #include "pthread_delay_np.c"
+#include "pthread_setyieldmode_np.c"
+#include "pthread_getyieldmode_np.c"
 #include "pthread_timedjoin_np.c"
+#include "pthread_join_async_np.c"
+#include "pthread_mutex_lock_async_np.c"
+#include "pthread_cond_wait_async_np.c"
+#include "pthread_create_n_np.c"
+#include "pthread_join_n_np.c"
+#include "pthread_create_payload_np.c"
+#include "pthread_arena_alloc_np.c"
+#include "pthread_arena_reset_np.c"
 #include "pthread_num_processors_np.c"
 #include "pthread_win32_attach_detach_np.c"
 #include "pthread_timechange_handler_np.c"
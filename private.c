@@ -41,22 +41,77 @@
 #include "ptw32_MCS_lock.c"
 #include "ptw32_is_attr.c"
 #include "ptw32_processInitialize.c"
+#include "ptw32_cancel_initialize.c"
 #include "ptw32_processTerminate.c"
 #include "ptw32_threadStart.c"
 #include "ptw32_threadDestroy.c"
-#include "ptw32_tkAssocCreate.c"
-#include "ptw32_tkAssocDestroy.c"
+#include "ptw32_tsd_table.c"
 #include "ptw32_callUserDestroyRoutines.c"
 #include "ptw32_semwait.c"
+#include "ptw32_sem_unwait.c"
+#include "ptw32_sem_fifo.c"
+#include "ptw32_sem_release.c"
 #include "ptw32_timespec.c"
 #include "ptw32_relmillisecs.c"
+#include "ptw32_wait_timer.c"
+#include "ptw32_timer_wheel.c"
+#include "ptw32_timer.c"
 #include "ptw32_throw.c"
 #include "ptw32_getprocessors.c"
+#include "ptw32_spin_calibrate.c"
+#include "ptw32_affinity.c"
+#include "ptw32_topology.c"
 #include "ptw32_new.c"
+#include "ptw32_implicit.c"
 #include "ptw32_calloc.c"
 #include "ptw32_reuse.c"
+#include "ptw32_threadCache.c"
+#include "ptw32_threadPool.c"
+#include "ptw32_libstats.c"
+#include "ptw32_fiber.c"
 #include "ptw32_cond_check_need_init.c"
 #include "ptw32_mutex_check_need_init.c"
+#include "ptw32_mutex_init.c"
+#include "ptw32_cond_init.c"
+#include "ptw32_object_alloc.c"
+#include "ptw32_largepage.c"
+#include "ptw32_mutex_spin.c"
+#include "ptw32_cond_spin.c"
+#include "ptw32_mutex_fair.c"
+#include "ptw32_mutex_cohort.c"
+#include "ptw32_mutex_prio.c"
+#include "ptw32_mutex_wait.c"
 #include "ptw32_rwlock_check_need_init.c"
 #include "ptw32_rwlock_cancelwrwait.c"
+#include "ptw32_rwlock_readers.c"
+#include "ptw32_rwlock_policy.c"
+#include "ptw32_rwlock_srw.c"
+#include "ptw32_barrier_tree.c"
+#include "ptw32_park.c"
+#include "ptw32_async.c"
+#include "ptw32_lockstat.c"
+#include "ptw32_lockprof.c"
+#include "ptw32_lock_elide.c"
+#include "ptw32_etw.c"
+#include "ptw32_perf.c"
+#include "ptw32_lockwatch.c"
+#include "ptw32_pool.c"
+#include "ptw32_cputokens.c"
+#include "ptw32_queue.c"
+#include "ptw32_wsdeque.c"
+#include "ptw32_spsc.c"
+#include "ptw32_yield.c"
+#include "ptw32_rcu.c"
+#include "ptw32_hazard.c"
+#include "ptw32_waitgraph.c"
+#include "ptw32_flightrec.c"
+#include "ptw32_hist.c"
+#include "ptw32_waitany.c"
+#include "ptw32_pshared.c"
+#include "ptw32_pshared_mutex.c"
+#include "ptw32_pshared_cond.c"
+#include "ptw32_pshared_sem.c"
+#include "ptw32_pshared_barrier.c"
 #include "ptw32_spinlock_check_need_init.c"
+#include "ptw32_rwspin.c"
+#include "ptw32_spinlock_init.c"
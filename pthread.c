@@ -49,39 +49,106 @@
 #include "ptw32_MCS_lock.c"
 #include "ptw32_is_attr.c"
 #include "ptw32_processInitialize.c"
+#include "ptw32_cancel_initialize.c"
 #include "ptw32_processTerminate.c"
 #include "ptw32_threadStart.c"
 #include "ptw32_threadDestroy.c"
-#include "ptw32_tkAssocCreate.c"
-#include "ptw32_tkAssocDestroy.c"
+#include "ptw32_tsd_table.c"
 #include "ptw32_callUserDestroyRoutines.c"
 #include "ptw32_semwait.c"
+#include "ptw32_sem_unwait.c"
+#include "ptw32_sem_fifo.c"
+#include "ptw32_sem_release.c"
 #include "ptw32_timespec.c"
 #include "ptw32_throw.c"
 #include "ptw32_getprocessors.c"
+#include "ptw32_spin_calibrate.c"
+#include "ptw32_affinity.c"
+#include "ptw32_topology.c"
 #include "ptw32_calloc.c"
 #include "ptw32_new.c"
+#include "ptw32_implicit.c"
 #include "ptw32_reuse.c"
+#include "ptw32_threadCache.c"
+#include "ptw32_threadPool.c"
+#include "ptw32_libstats.c"
+#include "ptw32_fiber.c"
 #include "ptw32_relmillisecs.c"
+#include "ptw32_wait_timer.c"
+#include "ptw32_timer_wheel.c"
+#include "ptw32_timer.c"
 #include "ptw32_cond_check_need_init.c"
 #include "ptw32_mutex_check_need_init.c"
+#include "ptw32_mutex_init.c"
+#include "ptw32_cond_init.c"
+#include "ptw32_object_alloc.c"
+#include "ptw32_largepage.c"
+#include "ptw32_mutex_spin.c"
+#include "ptw32_cond_spin.c"
+#include "ptw32_mutex_fair.c"
+#include "ptw32_mutex_cohort.c"
+#include "ptw32_mutex_prio.c"
+#include "ptw32_mutex_wait.c"
 #include "ptw32_rwlock_check_need_init.c"
 #include "ptw32_rwlock_cancelwrwait.c"
+#include "ptw32_rwlock_readers.c"
+#include "ptw32_rwlock_policy.c"
+#include "ptw32_rwlock_srw.c"
+#include "ptw32_barrier_tree.c"
+#include "ptw32_park.c"
+#include "ptw32_async.c"
+#include "ptw32_lockstat.c"
+#include "ptw32_lockprof.c"
+#include "ptw32_lock_elide.c"
+#include "ptw32_etw.c"
+#include "ptw32_perf.c"
+#include "ptw32_lockwatch.c"
+#include "ptw32_pool.c"
+#include "ptw32_cputokens.c"
+#include "ptw32_queue.c"
+#include "ptw32_wsdeque.c"
+#include "ptw32_spsc.c"
+#include "ptw32_yield.c"
+#include "ptw32_rcu.c"
+#include "ptw32_hazard.c"
+#include "ptw32_waitgraph.c"
+#include "ptw32_flightrec.c"
+#include "ptw32_hist.c"
+#include "ptw32_waitany.c"
+#include "ptw32_pshared.c"
+#include "ptw32_pshared_mutex.c"
+#include "ptw32_pshared_cond.c"
+#include "ptw32_pshared_sem.c"
+#include "ptw32_pshared_barrier.c"
 #include "ptw32_spinlock_check_need_init.c"
+#include "ptw32_rwspin.c"
+#include "ptw32_spinlock_init.c"
 #include "pthread_attr_init.c"
 #include "pthread_attr_destroy.c"
 #include "pthread_attr_getaffinity_np.c"
 #include "pthread_attr_setaffinity_np.c"
+#include "pthread_attr_getnumanode_np.c"
+#include "pthread_attr_setnumanode_np.c"
+#include "pthread_attr_getqos_np.c"
+#include "pthread_attr_setqos_np.c"
+#include "pthread_attr_getpooled_np.c"
+#include "pthread_attr_setpooled_np.c"
+#include "pthread_attr_getstackcommit_np.c"
+#include "pthread_attr_setstackcommit_np.c"
 #include "pthread_attr_getdetachstate.c"
 #include "pthread_attr_setdetachstate.c"
 #include "pthread_attr_getname_np.c"
 #include "pthread_attr_setname_np.c"
 #include "pthread_attr_getscope.c"
 #include "pthread_attr_setscope.c"
+#include "pthread_attr_getstack.c"
 #include "pthread_attr_getstackaddr.c"
+#include "pthread_attr_setstack.c"
 #include "pthread_attr_setstackaddr.c"
 #include "pthread_attr_getstacksize.c"
 #include "pthread_attr_setstacksize.c"
+#include "pthread_attr_getguardsize.c"
+#include "pthread_attr_setguardsize.c"
 #include "pthread_barrier_init.c"
 #include "pthread_barrier_destroy.c"
 #include "pthread_barrier_wait.c"
@@ -94,8 +161,10 @@
 #include "pthread_testcancel.c"
 #include "pthread_cancel.c"
 #include "pthread_condattr_destroy.c"
+#include "pthread_condattr_getclock.c"
 #include "pthread_condattr_getpshared.c"
 #include "pthread_condattr_init.c"
+#include "pthread_condattr_setclock.c"
 #include "pthread_condattr_setpshared.c"
 #include "pthread_cond_destroy.c"
 #include "pthread_cond_init.c"
@@ -125,6 +194,12 @@
 #include "pthread_mutexattr_gettype.c"
 #include "pthread_mutexattr_setrobust.c"
 #include "pthread_mutexattr_getrobust.c"
+#include "pthread_mutexattr_setprotocol.c"
+#include "pthread_mutexattr_getprotocol.c"
+#include "pthread_mutexattr_setprioceiling.c"
+#include "pthread_mutexattr_getprioceiling.c"
+#include "pthread_mutex_setprioceiling.c"
+#include "pthread_mutex_getprioceiling.c"
 #include "pthread_mutex_lock.c"
 #include "pthread_mutex_timedlock.c"
 #include "pthread_mutex_unlock.c"
@@ -132,12 +207,141 @@
 #include "pthread_mutex_consistent.c"
 #include "pthread_mutexattr_setkind_np.c"
 #include "pthread_mutexattr_getkind_np.c"
+#include "pthread_mutexattr_setspin_np.c"
+#include "pthread_mutexattr_getspin_np.c"
+#include "pthread_condattr_setspin_np.c"
+#include "pthread_condattr_getspin_np.c"
+#include "pthread_condattr_setwakeorder_np.c"
+#include "pthread_condattr_getwakeorder_np.c"
+#include "pthread_mutexattr_setfairness_np.c"
+#include "pthread_mutexattr_getfairness_np.c"
+#include "pthread_mutex_setdefaultspin_np.c"
+#include "pthread_mutex_init_storage_np.c"
+#include "pthread_mutex_kind_np.c"
+#include "pthread_mutex_init_array_np.c"
+#include "pthread_mutex_destroy_array_np.c"
+#include "pthread_cond_init_array_np.c"
+#include "pthread_cond_destroy_array_np.c"
+#include "pthread_mutex_getdefaultspin_np.c"
+#include "pthread_setthreadcache_np.c"
+#include "pthread_getthreadcache_np.c"
+#include "pthread_setthreadreuse_np.c"
+#include "pthread_getthreadreuse_np.c"
+#include "pthread_settimerslack_np.c"
+#include "pthread_gettimerslack_np.c"
+#include "pthread_setobjectalign_np.c"
+#include "pthread_setparam_np.c"
+#include "pthread_getobjectalign_np.c"
+#include "pthread_rwlockattr_setdistributed_np.c"
+#include "pthread_rwlockattr_getdistributed_np.c"
+#include "pthread_rwlockattr_setkind_np.c"
+#include "pthread_rwlockattr_getkind_np.c"
+#include "pthread_rwlock_downgrade_np.c"
+#include "pthread_rwlock_rdlock_upgradable_np.c"
+#include "pthread_rwlock_upgrade_np.c"
+#include "pthread_spin_init_np.c"
+#include "pthread_spin_init_storage_np.c"
+#include "pthread_spin_init_array_np.c"
+#include "pthread_spin_destroy_array_np.c"
+#include "pthread_barrierattr_setkind_np.c"
+#include "pthread_barrierattr_getkind_np.c"
+#include "pthread_barrier_arrive_np.c"
+#include "pthread_latch_init_np.c"
+#include "pthread_latch_destroy_np.c"
+#include "pthread_latch_wait_np.c"
+#include "pthread_phaser_init_np.c"
+#include "pthread_phaser_destroy_np.c"
+#include "pthread_phaser_arrive_np.c"
+#include "pthread_group_create_np.c"
+#include "pthread_group_destroy_np.c"
+#include "pthread_group_add_np.c"
+#include "pthread_group_cancel_np.c"
+#include "pthread_group_join_np.c"
+#include "pthread_group_setaffinity_np.c"
+#include "pthread_group_setschedparam_np.c"
 #include "pthread_getw32threadhandle_np.c"
 #include "pthread_getunique_np.c"
+#include "pthread_once_np.c"
+#include "pthread_getspecific_fast_np.c"
+#include "pthread_key_create_np.c"
+#include "pthread_pool_create_np.c"
+#include "pthread_pool_destroy_np.c"
+#include "pthread_pool_submit_np.c"
+#include "pthread_pool_task_wait_np.c"
+#include "pthread_pool_wait_np.c"
+#include "pthread_pool_parallel_for_np.c"
+#include "pthread_pool_parallel_reduce_np.c"
+#include "pthread_setcputokens_np.c"
+#include "pthread_getcputokens_np.c"
+#include "pthread_cputokens_acquire_np.c"
+#include "pthread_queue_create_np.c"
+#include "pthread_queue_destroy_np.c"
+#include "pthread_queue_pop_np.c"
+#include "pthread_queue_push_np.c"
+#include "pthread_wsdeque_np.c"
+#include "pthread_spsc_create_np.c"
+#include "pthread_spsc_destroy_np.c"
+#include "pthread_spsc_pop_np.c"
+#include "pthread_spsc_push_np.c"
+#include "pthread_lockstripe_create_np.c"
+#include "pthread_lockstripe_destroy_np.c"
+#include "pthread_lockstripe_lock_np.c"
+#include "pthread_lockstripe_unlock_np.c"
+#include "pthread_seqlock_init_np.c"
+#include "pthread_seqlock_destroy_np.c"
+#include "pthread_seqlock_read_np.c"
+#include "pthread_seqlock_write_np.c"
+#include "pthread_rwspin_init_np.c"
+#include "pthread_rwspin_destroy_np.c"
+#include "pthread_rwspin_rdlock_np.c"
+#include "pthread_rwspin_wrlock_np.c"
+#include "pthread_rwspin_unlock_np.c"
+#include "pthread_mcs_lock_np.c"
+#include "pthread_percpu_create_np.c"
+#include "pthread_percpu_destroy_np.c"
+#include "pthread_percpu_slot_np.c"
+#include "pthread_counter_add_np.c"
+#include "pthread_counter_destroy_np.c"
+#include "pthread_counter_init_np.c"
+#include "pthread_counter_read_np.c"
+#include "pthread_rcu_online_np.c"
+#include "pthread_io_begin_np.c"
+#include "pthread_rcu_synchronize_np.c"
+#include "pthread_call_rcu_np.c"
+#include "pthread_hazard_protect_np.c"
+#include "pthread_hazard_retire_np.c"
+#include "pthread_wait_on_address_np.c"
+#include "pthread_wake_np.c"
+#include "pthread_waitany_np.c"
+#include "pthread_getnumanode_np.c"
+#include "pthread_getqos_np.c"
+#include "pthread_setqos_np.c"
+#include "pthread_getwakeboost_np.c"
+#include "pthread_setwakeboost_np.c"
+#include "pthread_setsoftaffinity_np.c"
+#include "pthread_getstats_np.c"
+#include "pthread_getlibstats_np.c"
+#include "pthread_topology_np.c"
+#include "pthread_lockstat_np.c"
+#include "pthread_lockprof_np.c"
+#include "pthread_dump_waitgraph_np.c"
+#include "pthread_flightrec_dump_np.c"
+#include "pthread_gethistograms_np.c"
+#include "pthread_lockwatch_np.c"
 #include "pthread_timedjoin_np.c"
+#include "pthread_join_async_np.c"
+#include "pthread_mutex_lock_async_np.c"
+#include "pthread_cond_wait_async_np.c"
+#include "pthread_create_n_np.c"
+#include "pthread_join_n_np.c"
+#include "pthread_create_payload_np.c"
+#include "pthread_arena_alloc_np.c"
+#include "pthread_arena_reset_np.c"
 #include "pthread_tryjoin_np.c"
 #include "pthread_setaffinity.c"
 #include "pthread_delay_np.c"
+#include "pthread_setyieldmode_np.c"
+#include "pthread_getyieldmode_np.c"
 #include "pthread_num_processors_np.c"
 #include "pthread_win32_attach_detach_np.c"
 #include "pthread_timechange_handler_np.c"
@@ -167,7 +371,17 @@
 #include "sched_setscheduler.c"
 #include "sched_getscheduler.c"
 #include "sched_yield.c"
+#include "clock_gettime.c"
+#include "clock_getres.c"
+#include "nanosleep.c"
+#include "pthread_getcpuclockid.c"
+#include "timer_create.c"
+#include "timer_delete.c"
+#include "timer_settime.c"
+#include "timer_gettime.c"
+#include "timer_getoverrun.c"
 #include "sched_setaffinity.c"
+#include "sched_getcpu.c"
 #include "sem_init.c"
 #include "sem_destroy.c"
 #include "sem_trywait.c"
@@ -175,6 +389,8 @@
 #include "sem_wait.c"
 #include "sem_post.c"
 #include "sem_post_multiple.c"
+#include "sem_wait_multiple_np.c"
+#include "sem_wait_async_np.c"
 #include "sem_getvalue.c"
 #include "sem_open.c"
 #include "sem_close.c"
@@ -309,6 +309,35 @@ struct timespec {
 #endif /* _TIMESPEC_DEFINED */
 #endif /* HAVE_STRUCT_TIMESPEC */
 
+/*
+ * Clocks that absolute timeouts can be measured against (see
+ * pthread_condattr_setclock and the *_clock* wait functions).
+ * CLOCK_MONOTONIC counts QueryPerformanceCounter ticks, converted as
+ * tv_sec = count / frequency and
+ * tv_nsec = (count % frequency) * 1000000000 / frequency
+ * with the frequency from QueryPerformanceFrequency.
+ *
+ * Where the compiler's headers do not provide the clocks, this library
+ * does, along with clock_gettime and clock_getres
+ * (PTW32_CLOCK_GETTIME is then defined).
+ */
+#if !defined(CLOCK_REALTIME)
+#define PTW32_CLOCK_GETTIME
+typedef int clockid_t;
+#define CLOCK_REALTIME 0
+#endif
+#if !defined(CLOCK_MONOTONIC)
+#define CLOCK_MONOTONIC 1
+#endif
+#if defined(PTW32_CLOCK_GETTIME)
+#if !defined(CLOCK_PROCESS_CPUTIME_ID)
+#define CLOCK_PROCESS_CPUTIME_ID 2
+#endif
+#if !defined(CLOCK_THREAD_CPUTIME_ID)
+#define CLOCK_THREAD_CPUTIME_ID 3
+#endif
+#endif /* PTW32_CLOCK_GETTIME */
+
 #if !defined(SIG_BLOCK)
 #define SIG_BLOCK 0
 #endif /* SIG_BLOCK */
@@ -352,11 +381,15 @@ extern "C"
  *                              pthread_attr_getstacksize
  *                              pthread_attr_setstacksize
  *
- * _POSIX_THREAD_ATTR_STACKADDR (== -1)
+ * _POSIX_THREAD_ATTR_STACKADDR (== 200809L or -1)
  *                      If == 200809L, you can allocate and control a thread's
- *                      stack. If not supported, the following functions
+ *                      stack. This needs a compiler for which the library
+ *                      knows how to switch stacks (GCC or MSVC on x86, GCC
+ *                      on x64). If not supported, the following functions
  *                      will return ENOSYS, indicating they are not
  *                      supported:
+ *                              pthread_attr_getstack
+ *                              pthread_attr_setstack
  *                              pthread_attr_getstackaddr
  *                              pthread_attr_setstackaddr
  *
@@ -367,21 +400,21 @@ extern "C"
  *                      requirements in the standard. E.g. rwlocks favour
  *                      writers over readers when threads have equal priority.
  *
- * _POSIX_THREAD_PRIO_INHERIT (== -1)
+ * _POSIX_THREAD_PRIO_INHERIT (== 200809L)
  *                      If == 200809L, you can create priority inheritance
  *                      mutexes.
- *                              pthread_mutexattr_getprotocol +
- *                              pthread_mutexattr_setprotocol +
+ *                              pthread_mutexattr_getprotocol
+ *                              pthread_mutexattr_setprotocol
  *
- * _POSIX_THREAD_PRIO_PROTECT (== -1)
+ * _POSIX_THREAD_PRIO_PROTECT (== 200809L)
  *                      If == 200809L, you can create priority ceiling mutexes
  *                      Indicates the availability of:
  *                              pthread_mutex_getprioceiling
  *                              pthread_mutex_setprioceiling
  *                              pthread_mutexattr_getprioceiling
- *                              pthread_mutexattr_getprotocol     +
+ *                              pthread_mutexattr_getprotocol
  *                              pthread_mutexattr_setprioceiling
- *                              pthread_mutexattr_setprotocol     +
+ *                              pthread_mutexattr_setprotocol
  *
  * _POSIX_THREAD_PROCESS_SHARED (== -1)
  *                      If set, you can create mutexes and condition
@@ -393,6 +426,11 @@ extern "C"
  *                              pthread_condattr_getpshared
  *                              pthread_condattr_setpshared
  *
+ *                      Not set because read-write locks and spin
+ *                      locks can't be process shared, but mutexes
+ *                      (other than robust ones), condition
+ *                      variables, semaphores and barriers can.
+ *
  * _POSIX_THREAD_SAFE_FUNCTIONS (== 200809L)
  *                      If == 200809L you can use the special *_r library
  *                      functions that provide thread-safe behaviour
@@ -439,18 +477,23 @@ extern "C"
 #undef _POSIX_ROBUST_MUTEXES
 #define _POSIX_ROBUST_MUTEXES 200809L
 
-/*
- * The following options are not supported
- */
-#undef _POSIX_THREAD_ATTR_STACKADDR
-#define _POSIX_THREAD_ATTR_STACKADDR -1
-
 #undef _POSIX_THREAD_PRIO_INHERIT
-#define _POSIX_THREAD_PRIO_INHERIT -1
+#define _POSIX_THREAD_PRIO_INHERIT 200809L
 
 #undef _POSIX_THREAD_PRIO_PROTECT
-#define _POSIX_THREAD_PRIO_PROTECT -1
+#define _POSIX_THREAD_PRIO_PROTECT 200809L
+
+#undef _POSIX_THREAD_ATTR_STACKADDR
+#if (defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))) \
+    || (defined(_MSC_VER) && defined(_M_IX86))
+#define _POSIX_THREAD_ATTR_STACKADDR 200809L
+#else
+#define _POSIX_THREAD_ATTR_STACKADDR -1
+#endif
 
+/*
+ * The following options are not supported
+ */
 /* TPS is not fully supported.  */
 #undef _POSIX_THREAD_PRIORITY_SCHEDULING
 #define _POSIX_THREAD_PRIORITY_SCHEDULING -1
@@ -576,8 +619,63 @@ typedef struct pthread_condattr_t_ * pthread_condattr_t;
 typedef struct pthread_rwlock_t_ * pthread_rwlock_t;
 typedef struct pthread_rwlockattr_t_ * pthread_rwlockattr_t;
 typedef struct pthread_spinlock_t_ * pthread_spinlock_t;
+typedef struct pthread_rwspinlock_np_t_ * pthread_rwspinlock_np_t;
 typedef struct pthread_barrier_t_ * pthread_barrier_t;
 typedef struct pthread_barrierattr_t_ * pthread_barrierattr_t;
+typedef struct pthread_pool_np_t_ * pthread_pool_np_t;
+typedef struct pthread_pool_task_np_t_ * pthread_pool_task_np_t;
+typedef struct pthread_queue_np_t_ * pthread_queue_np_t;
+typedef struct pthread_wsdeque_np_t_ * pthread_wsdeque_np_t;
+typedef struct pthread_spsc_np_t_ * pthread_spsc_np_t;
+typedef struct pthread_latch_np_t_ * pthread_latch_np_t;
+typedef struct pthread_phaser_np_t_ * pthread_phaser_np_t;
+typedef struct pthread_group_np_t_ * pthread_group_np_t;
+typedef struct pthread_lockstripe_np_t_ * pthread_lockstripe_np_t;
+typedef struct pthread_seqlock_np_t_ * pthread_seqlock_np_t;
+typedef struct pthread_percpu_np_t_ * pthread_percpu_np_t;
+typedef struct pthread_counter_np_t_ * pthread_counter_np_t;
+typedef struct pthread_rcu_head_np_t_ pthread_rcu_head_np_t;
+typedef struct pthread_mcs_node_np_t_ pthread_mcs_node_np_t;
+typedef pthread_mcs_node_np_t * pthread_mcs_lock_np_t;
+
+/*
+ * POSIX timers (timer_create), where the compiler's headers do not
+ * provide them (PTW32_TIMER_CREATE is then defined). Only SIGEV_NONE
+ * and SIGEV_THREAD notification are supported; SIGEV_THREAD
+ * notifications run on library pool threads.
+ */
+#if !defined(SIGEV_THREAD)
+#define PTW32_TIMER_CREATE
+#define SIGEV_NONE   0
+#define SIGEV_SIGNAL 1
+#define SIGEV_THREAD 2
+
+union sigval {
+        int sival_int;
+        void * sival_ptr;
+};
+
+struct sigevent {
+        int sigev_notify;
+        int sigev_signo;
+        union sigval sigev_value;
+        void (PTW32_CDECL *sigev_notify_function) (union sigval);
+        pthread_attr_t * sigev_notify_attributes;
+};
+#endif /* SIGEV_THREAD */
+
+#if defined(PTW32_TIMER_CREATE)
+struct itimerspec {
+        struct timespec it_interval;
+        struct timespec it_value;
+};
+
+#if !defined(TIMER_ABSTIME)
+#define TIMER_ABSTIME 1
+#endif
+
+typedef struct timer_t_ * timer_t;
+#endif /* PTW32_TIMER_CREATE */
 
 /*
  * ====================
@@ -631,6 +729,13 @@ enum {
   PTHREAD_MUTEX_STALLED         = 0,  /* Default */
   PTHREAD_MUTEX_ROBUST          = 1,
 
+/*
+ * pthread_mutexattr_{get,set}protocol
+ */
+  PTHREAD_PRIO_NONE             = 0,  /* Default */
+  PTHREAD_PRIO_INHERIT          = 1,
+  PTHREAD_PRIO_PROTECT          = 2,
+
 /*
  * pthread_barrier_wait
  */
@@ -664,6 +769,20 @@ struct pthread_once_t_
   int          reserved2;
 };
 
+/*
+ * Tests the done flag of a pthread_once_t with acquire semantics,
+ * where the compiler provides that without an interlocked operation.
+ * Used by pthread_once() and by the pthread_once_np() macro.
+ */
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+#  define PTW32_ONCE_IS_DONE(once_control) \
+    (__atomic_load_n (&(once_control)->done, __ATOMIC_ACQUIRE) != 0)
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+   /* Volatile reads have acquire semantics on these targets */
+#  define PTW32_ONCE_IS_DONE(once_control) \
+    (*(volatile int *) &(once_control)->done != 0)
+#endif
+
 
 /*
  * ====================
@@ -688,6 +807,18 @@ struct pthread_once_t_
 
 #define PTHREAD_SPINLOCK_INITIALIZER ((pthread_spinlock_t)(size_t) -1)
 
+#define PTHREAD_RWSPINLOCK_INITIALIZER_NP ((pthread_rwspinlock_np_t)(size_t) -1)
+
+/*
+ * Default attributes without a call to the *attr_init function.
+ * The first change allocates the object as *attr_init would.
+ */
+#define PTHREAD_ATTR_INITIALIZER_NP ((pthread_attr_t)(size_t) -1)
+#define PTHREAD_MUTEXATTR_INITIALIZER_NP ((pthread_mutexattr_t)(size_t) -1)
+#define PTHREAD_CONDATTR_INITIALIZER_NP ((pthread_condattr_t)(size_t) -1)
+#define PTHREAD_RWLOCKATTR_INITIALIZER_NP ((pthread_rwlockattr_t)(size_t) -1)
+#define PTHREAD_BARRIERATTR_INITIALIZER_NP ((pthread_barrierattr_t)(size_t) -1)
+
 
 /*
  * Mutex types.
@@ -704,7 +835,39 @@ enum
   PTHREAD_MUTEX_NORMAL = PTHREAD_MUTEX_FAST_NP,
   PTHREAD_MUTEX_RECURSIVE = PTHREAD_MUTEX_RECURSIVE_NP,
   PTHREAD_MUTEX_ERRORCHECK = PTHREAD_MUTEX_ERRORCHECK_NP,
-  PTHREAD_MUTEX_DEFAULT = PTHREAD_MUTEX_NORMAL
+  PTHREAD_MUTEX_DEFAULT = PTHREAD_MUTEX_NORMAL,
+  /* Non-portable: a normal mutex that may be elided (needs RTM) */
+  PTHREAD_MUTEX_ELIDE_NP = PTHREAD_MUTEX_ERRORCHECK_NP + 1
+};
+
+/*
+ * Read/write lock kinds (non-portable).
+ */
+enum
+{
+  PTHREAD_RWLOCK_DEFAULT_NP,
+  PTHREAD_RWLOCK_PREFER_READER_NP,
+  PTHREAD_RWLOCK_PREFER_WRITER_NP,
+  PTHREAD_RWLOCK_PHASE_FAIR_NP,
+  PTHREAD_RWLOCK_ELIDE_NP
+};
+
+/*
+ * Spin lock kinds (non-portable).
+ */
+enum
+{
+  PTHREAD_SPINLOCK_DEFAULT_NP,
+  PTHREAD_SPINLOCK_TICKET_NP
+};
+
+/*
+ * Barrier kinds (non-portable).
+ */
+enum
+{
+  PTHREAD_BARRIER_DEFAULT_NP,
+  PTHREAD_BARRIER_TREE_NP
 };
 
 
@@ -881,6 +1044,13 @@ PTW32_DLLPORT int PTW32_CDECL pthread_attr_getaffinity_np (const pthread_attr_t
 PTW32_DLLPORT int PTW32_CDECL pthread_attr_getdetachstate (const pthread_attr_t * attr,
                                          int *detachstate);
 
+PTW32_DLLPORT int PTW32_CDECL pthread_attr_getguardsize (const pthread_attr_t * attr,
+                                         size_t * guardsize);
+
+PTW32_DLLPORT int PTW32_CDECL pthread_attr_getstack (const pthread_attr_t * attr,
+                                       void **stackaddr,
+                                       size_t * stacksize);
+
 PTW32_DLLPORT int PTW32_CDECL pthread_attr_getstackaddr (const pthread_attr_t * attr,
                                        void **stackaddr);
 
@@ -894,6 +1064,13 @@ PTW32_DLLPORT int PTW32_CDECL pthread_attr_setaffinity_np (pthread_attr_t * attr
 PTW32_DLLPORT int PTW32_CDECL pthread_attr_setdetachstate (pthread_attr_t * attr,
                                          int detachstate);
 
+PTW32_DLLPORT int PTW32_CDECL pthread_attr_setguardsize (pthread_attr_t * attr,
+                                         size_t guardsize);
+
+PTW32_DLLPORT int PTW32_CDECL pthread_attr_setstack (pthread_attr_t * attr,
+                                       void *stackaddr,
+                                       size_t stacksize);
+
 PTW32_DLLPORT int PTW32_CDECL pthread_attr_setstackaddr (pthread_attr_t * attr,
                                        void *stackaddr);
 
@@ -965,6 +1142,44 @@ PTW32_DLLPORT void PTW32_CDECL ptw32_push_cleanup (ptw32_cleanup_t * cleanup,
                                  void *arg);
 #endif /* PTW32_LEVEL >= PTW32_LEVEL_MAX */
 
+#if defined(PTW32_CLOCK_GETTIME)
+/*
+ * Clock Functions
+ */
+PTW32_DLLPORT int PTW32_CDECL clock_gettime (clockid_t clock_id,
+                               struct timespec *tp);
+
+PTW32_DLLPORT int PTW32_CDECL clock_getres (clockid_t clock_id,
+                              struct timespec *res);
+
+PTW32_DLLPORT int PTW32_CDECL pthread_getcpuclockid (pthread_t thread,
+                              clockid_t *clock_id);
+
+PTW32_DLLPORT int PTW32_CDECL nanosleep (const struct timespec *rqtp,
+                           struct timespec *rmtp);
+#endif /* PTW32_CLOCK_GETTIME */
+
+#if defined(PTW32_TIMER_CREATE)
+/*
+ * Timer Functions
+ */
+PTW32_DLLPORT int PTW32_CDECL timer_create (clockid_t clock_id,
+                              struct sigevent * evp,
+                              timer_t * timerid);
+
+PTW32_DLLPORT int PTW32_CDECL timer_delete (timer_t timerid);
+
+PTW32_DLLPORT int PTW32_CDECL timer_settime (timer_t timerid,
+                               int flags,
+                               const struct itimerspec * value,
+                               struct itimerspec * ovalue);
+
+PTW32_DLLPORT int PTW32_CDECL timer_gettime (timer_t timerid,
+                               struct itimerspec * value);
+
+PTW32_DLLPORT int PTW32_CDECL timer_getoverrun (timer_t timerid);
+#endif /* PTW32_TIMER_CREATE */
+
 /*
  * Thread Specific Data Functions
  */
@@ -1003,6 +1218,16 @@ PTW32_DLLPORT int PTW32_CDECL pthread_mutexattr_getrobust(
                                            const pthread_mutexattr_t * attr,
                                            int * robust);
 
+PTW32_DLLPORT int PTW32_CDECL pthread_mutexattr_setprotocol (pthread_mutexattr_t * attr,
+                                           int protocol);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutexattr_getprotocol (const pthread_mutexattr_t * attr,
+                                           int *protocol);
+
+PTW32_DLLPORT int PTW32_CDECL pthread_mutexattr_setprioceiling (pthread_mutexattr_t * attr,
+                                           int prioceiling);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutexattr_getprioceiling (const pthread_mutexattr_t * attr,
+                                           int *prioceiling);
+
 /*
  * Barrier Attribute Functions
  */
@@ -1030,12 +1255,26 @@ PTW32_DLLPORT int PTW32_CDECL pthread_mutex_lock (pthread_mutex_t * mutex);
 PTW32_DLLPORT int PTW32_CDECL pthread_mutex_timedlock(pthread_mutex_t * mutex,
                                     const struct timespec *abstime);
 
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_clocklock(pthread_mutex_t * mutex,
+                                    clockid_t clock_id,
+                                    const struct timespec *abstime);
+
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_reltimedlock_np(pthread_mutex_t * mutex,
+                                    const struct timespec *reltime);
+
 PTW32_DLLPORT int PTW32_CDECL pthread_mutex_trylock (pthread_mutex_t * mutex);
 
 PTW32_DLLPORT int PTW32_CDECL pthread_mutex_unlock (pthread_mutex_t * mutex);
 
 PTW32_DLLPORT int PTW32_CDECL pthread_mutex_consistent (pthread_mutex_t * mutex);
 
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_setprioceiling (pthread_mutex_t * mutex,
+                                          int prioceiling,
+                                          int *old_ceiling);
+
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_getprioceiling (const pthread_mutex_t * mutex,
+                                          int *prioceiling);
+
 /*
  * Spinlock Functions
  */
@@ -1073,6 +1312,12 @@ PTW32_DLLPORT int PTW32_CDECL pthread_condattr_getpshared (const pthread_condatt
 PTW32_DLLPORT int PTW32_CDECL pthread_condattr_setpshared (pthread_condattr_t * attr,
                                          int pshared);
 
+PTW32_DLLPORT int PTW32_CDECL pthread_condattr_getclock (const pthread_condattr_t * attr,
+                                       clockid_t * clock_id);
+
+PTW32_DLLPORT int PTW32_CDECL pthread_condattr_setclock (pthread_condattr_t * attr,
+                                       clockid_t clock_id);
+
 /*
  * Condition Variable Functions
  */
@@ -1088,6 +1333,24 @@ PTW32_DLLPORT int PTW32_CDECL pthread_cond_timedwait (pthread_cond_t * cond,
                                     pthread_mutex_t * mutex,
                                     const struct timespec *abstime);
 
+PTW32_DLLPORT int PTW32_CDECL pthread_cond_clockwait (pthread_cond_t * cond,
+                                    pthread_mutex_t * mutex,
+                                    clockid_t clock_id,
+                                    const struct timespec *abstime);
+
+PTW32_DLLPORT int PTW32_CDECL pthread_cond_timedwait_relative_np (pthread_cond_t * cond,
+                                    pthread_mutex_t * mutex,
+                                    const struct timespec *reltime);
+
+PTW32_DLLPORT int PTW32_CDECL pthread_cond_wait_rwlock_np (pthread_cond_t * cond,
+                                    pthread_rwlock_t * rwlock,
+                                    int exclusive);
+
+PTW32_DLLPORT int PTW32_CDECL pthread_cond_timedwait_rwlock_np (pthread_cond_t * cond,
+                                    pthread_rwlock_t * rwlock,
+                                    int exclusive,
+                                    const struct timespec *abstime);
+
 PTW32_DLLPORT int PTW32_CDECL pthread_cond_signal (pthread_cond_t * cond);
 
 PTW32_DLLPORT int PTW32_CDECL pthread_cond_broadcast (pthread_cond_t * cond);
@@ -1165,17 +1428,926 @@ PTW32_DLLPORT int PTW32_CDECL pthread_timedjoin_np(pthread_t thread,
                                          const struct timespec *abstime);
 PTW32_DLLPORT int PTW32_CDECL pthread_tryjoin_np(pthread_t thread,
                                          void **value_ptr);
+PTW32_DLLPORT int PTW32_CDECL pthread_join_async_np(pthread_t thread,
+                                         void (PTW32_CDECL * callback) (pthread_t thread,
+                                                                        void * value,
+                                                                        void * arg),
+                                         void * arg);
+PTW32_DLLPORT int PTW32_CDECL pthread_create_n_np(pthread_t * threads,
+                                         int n,
+                                         const pthread_attr_t * attr,
+                                         void *(PTW32_CDECL * start) (void *),
+                                         void ** args);
+PTW32_DLLPORT int PTW32_CDECL pthread_join_n_np(pthread_t * threads,
+                                         int n,
+                                         void ** values);
+/*
+ * Most bytes pthread_create_payload_np copies for the new thread.
+ */
+#define PTHREAD_PAYLOAD_MAX_NP 256
+PTW32_DLLPORT int PTW32_CDECL pthread_create_payload_np(pthread_t * tid,
+                                         const pthread_attr_t * attr,
+                                         void *(PTW32_CDECL * start) (void *),
+                                         const void * payload,
+                                         size_t size);
+PTW32_DLLPORT void * PTW32_CDECL pthread_arena_alloc_np(size_t size);
+PTW32_DLLPORT int PTW32_CDECL pthread_arena_reset_np(void);
 PTW32_DLLPORT int PTW32_CDECL pthread_setaffinity_np(pthread_t thread,
 										 size_t cpusetsize,
 										 const cpu_set_t *cpuset);
 PTW32_DLLPORT int PTW32_CDECL pthread_getaffinity_np(pthread_t thread,
 										 size_t cpusetsize,
 										 cpu_set_t *cpuset);
+PTW32_DLLPORT int PTW32_CDECL pthread_setsoftaffinity_np(pthread_t thread,
+										 size_t cpusetsize,
+										 const cpu_set_t *cpuset);
+PTW32_DLLPORT int PTW32_CDECL pthread_getsoftaffinity_np(pthread_t thread,
+										 size_t cpusetsize,
+										 cpu_set_t *cpuset);
+
+/*
+ * Adaptive (spin-then-block) mutexes.
+ */
+#define PTHREAD_MUTEX_SPIN_DEFAULT (-1)
+
+PTW32_DLLPORT int PTW32_CDECL pthread_mutexattr_setspin_np(pthread_mutexattr_t * attr,
+                                         int spin);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutexattr_getspin_np(const pthread_mutexattr_t * attr,
+                                         int *spin);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_setdefaultspin_np(int spin);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_getdefaultspin_np(int *spin);
+
+/*
+ * Spin-then-block condition variable waits.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_condattr_setspin_np(pthread_condattr_t * attr,
+                                         int spin);
+PTW32_DLLPORT int PTW32_CDECL pthread_condattr_getspin_np(const pthread_condattr_t * attr,
+                                         int *spin);
+
+/*
+ * Mutex fairness under contention.
+ */
+enum
+{
+  PTHREAD_MUTEX_BARGING_NP         = 0,	/* Default: a free mutex goes to whoever gets there first */
+  PTHREAD_MUTEX_FAIR_NP            = 1,	/* Unlock hands the mutex to the longest waiter */
+  PTHREAD_MUTEX_EVENTUALLY_FAIR_NP = 2,	/* Barging until a waiter starves, then handoff */
+  PTHREAD_MUTEX_NUMA_COHORT_NP     = 3,	/* Handoff within a NUMA node, a bounded number of times */
+  PTHREAD_MUTEX_PRIORITY_NP        = 4	/* Unlock hands the mutex to the highest priority waiter */
+};
+
+PTW32_DLLPORT int PTW32_CDECL pthread_mutexattr_setfairness_np(pthread_mutexattr_t * attr,
+                                         int fairness);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutexattr_getfairness_np(const pthread_mutexattr_t * attr,
+                                         int *fairness);
+
+/*
+ * Which condition variable waiter a signal wakes.
+ */
+enum
+{
+  PTHREAD_COND_WAKE_ANY_NP      = 0,	/* Default: whichever the system wakes */
+  PTHREAD_COND_WAKE_PRIORITY_NP = 1	/* The highest priority waiter, then the longest */
+};
+
+PTW32_DLLPORT int PTW32_CDECL pthread_condattr_setwakeorder_np(pthread_condattr_t * attr,
+                                         int order);
+PTW32_DLLPORT int PTW32_CDECL pthread_condattr_getwakeorder_np(const pthread_condattr_t * attr,
+                                         int *order);
+
+/*
+ * Keep finished threads' OS threads to run new threads.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_setthreadcache_np(int max);
+PTW32_DLLPORT int PTW32_CDECL pthread_getthreadcache_np(int *max);
+PTW32_DLLPORT int PTW32_CDECL pthread_setthreadreuse_np(int max);
+PTW32_DLLPORT int PTW32_CDECL pthread_getthreadreuse_np(int *max);
+
+/*
+ * End timed waits together, on a timer wheel, up to 'slack' ns late.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_settimerslack_np(long slack);
+PTW32_DLLPORT int PTW32_CDECL pthread_gettimerslack_np(long *slack);
+
+/*
+ * Placement of synchronisation objects.
+ */
+#define PTHREAD_OBJECT_ALIGN_DEFAULT_NP   0
+#define PTHREAD_OBJECT_ALIGN_CACHELINE_NP 64
+#define PTHREAD_OBJECT_ALIGN_SECTOR_NP    128
+
+PTW32_DLLPORT int PTW32_CDECL pthread_setobjectalign_np(int align);
+PTW32_DLLPORT int PTW32_CDECL pthread_getobjectalign_np(int *align);
+
+/*
+ * Process wide tunables, whose initial values can also be given by
+ * the environment (see README.NONPORTABLE).
+ */
+enum
+{
+  PTHREAD_PARAM_MUTEX_SPIN_NP    = 0,	/* pthread_mutex_setdefaultspin_np */
+  PTHREAD_PARAM_MCS_SPIN_NP      = 1,	/* Internal lock polls before blocking */
+  PTHREAD_PARAM_SPIN_BACKOFF_NP  = 2,	/* Spin lock backoff cap, in pause hints */
+  PTHREAD_PARAM_THREAD_REUSE_NP  = 3,	/* pthread_setthreadreuse_np */
+  PTHREAD_PARAM_THREAD_CACHE_NP  = 4,	/* pthread_setthreadcache_np */
+  PTHREAD_PARAM_TIMER_SLACK_NP   = 5,	/* pthread_settimerslack_np */
+  PTHREAD_PARAM_YIELD_MODE_NP    = 6,	/* pthread_setyieldmode_np */
+  PTHREAD_PARAM_OBJECT_ALIGN_NP  = 7,	/* pthread_setobjectalign_np */
+  PTHREAD_PARAM_CONCURRENCY_NP   = 8,	/* pthread_setconcurrency */
+  PTHREAD_PARAM_HIRES_WAIT_NP    = 9,	/* High resolution timed waits, 0 or 1 */
+  PTHREAD_PARAM_CPU_TOKENS_NP    = 10,	/* pthread_setcputokens_np */
+  PTHREAD_PARAM_LARGE_PAGES_NP   = 11,	/* Slabs and thread structs on large pages, 0 or 1 */
+  PTHREAD_PARAM_WAKE_BOOST_NP    = 12	/* New threads boosted when woken, 0 or 1 */
+};
+
+PTW32_DLLPORT int PTW32_CDECL pthread_setparam_np(int param, long value);
+PTW32_DLLPORT int PTW32_CDECL pthread_getparam_np(int param, long *value);
+
+/*
+ * Read/write locks with per-processor reader counters.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlockattr_setdistributed_np(pthread_rwlockattr_t * attr,
+                                         int distributed);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlockattr_getdistributed_np(const pthread_rwlockattr_t * attr,
+                                         int *distributed);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlockattr_setkind_np(pthread_rwlockattr_t * attr,
+                                         int kind);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlockattr_getkind_np(const pthread_rwlockattr_t * attr,
+                                         int *kind);
+
+/*
+ * Changing the mode a read/write lock is held in without releasing
+ * it. Upgrading needs one of the kinds other than the default.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlock_downgrade_np(pthread_rwlock_t * rwlock);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlock_rdlock_upgradable_np(pthread_rwlock_t * rwlock);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlock_tryrdlock_upgradable_np(pthread_rwlock_t * rwlock);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlock_upgrade_np(pthread_rwlock_t * rwlock);
+
+/*
+ * Ticket (FIFO) spin locks.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_spin_init_np (pthread_spinlock_t * lock,
+                                         int pshared, int kind);
+
+/*
+ * Mutexes and spin locks kept in the application's own structures,
+ * next to the data they protect, instead of on the heap. The storage
+ * must stay in place until the object is destroyed. A library whose
+ * objects don't fit (PTW32_LOCKSTAT builds) falls back to the heap.
+ */
+#define PTHREAD_MUTEX_STORAGE_SIZE_NP    128
+#define PTHREAD_SPINLOCK_STORAGE_SIZE_NP 48
+
+typedef union {
+  char bytes[PTHREAD_MUTEX_STORAGE_SIZE_NP];
+  void * align;
+  unsigned __int64 align64;
+} pthread_mutex_storage_np_t;
+
+typedef union {
+  char bytes[PTHREAD_SPINLOCK_STORAGE_SIZE_NP];
+  void * align;
+  unsigned __int64 align64;
+} pthread_spinlock_storage_np_t;
+
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_init_storage_np (pthread_mutex_t * mutex,
+                                         const pthread_mutexattr_t * attr,
+                                         pthread_mutex_storage_np_t * storage);
+PTW32_DLLPORT int PTW32_CDECL pthread_spin_init_storage_np (pthread_spinlock_t * lock,
+                                         int pshared, int kind,
+                                         pthread_spinlock_storage_np_t * storage);
+
+/*
+ * Lock, trylock and unlock for a dynamically initialised, process
+ * private mutex of a kind known to the caller. See
+ * pthread_mutex_np.hpp for C++ wrappers.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_lock_normal_np (pthread_mutex_t * mutex);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_trylock_normal_np (pthread_mutex_t * mutex);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_unlock_normal_np (pthread_mutex_t * mutex);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_lock_recursive_np (pthread_mutex_t * mutex);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_trylock_recursive_np (pthread_mutex_t * mutex);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_unlock_recursive_np (pthread_mutex_t * mutex);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_lock_errorcheck_np (pthread_mutex_t * mutex);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_trylock_errorcheck_np (pthread_mutex_t * mutex);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_unlock_errorcheck_np (pthread_mutex_t * mutex);
+
+/*
+ * Arrays of mutexes, condition variables or spin locks made in one
+ * allocation and destroyed with one call. The elements are spaced by
+ * the pthread_setobjectalign_np() alignment and must not be destroyed
+ * one by one.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_init_array_np (pthread_mutex_t * mutexes,
+                                         size_t n,
+                                         const pthread_mutexattr_t * attr);
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_destroy_array_np (pthread_mutex_t * mutexes,
+                                         size_t n);
+PTW32_DLLPORT int PTW32_CDECL pthread_cond_init_array_np (pthread_cond_t * conds,
+                                         size_t n,
+                                         const pthread_condattr_t * attr);
+PTW32_DLLPORT int PTW32_CDECL pthread_cond_destroy_array_np (pthread_cond_t * conds,
+                                         size_t n);
+PTW32_DLLPORT int PTW32_CDECL pthread_spin_init_array_np (pthread_spinlock_t * locks,
+                                         size_t n, int pshared, int kind);
+PTW32_DLLPORT int PTW32_CDECL pthread_spin_destroy_array_np (pthread_spinlock_t * locks,
+                                         size_t n);
+
+/*
+ * Signal or broadcast a condition variable and unlock the mutex, waking
+ * the waiters only once the mutex is free.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_cond_signal_unlock_np (pthread_cond_t * cond,
+                                         pthread_mutex_t * mutex);
+PTW32_DLLPORT int PTW32_CDECL pthread_cond_broadcast_unlock_np (pthread_cond_t * cond,
+                                         pthread_mutex_t * mutex);
+
+/*
+ * Combining tree barriers.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_barrierattr_setkind_np(pthread_barrierattr_t * attr,
+                                         int kind);
+PTW32_DLLPORT int PTW32_CDECL pthread_barrierattr_getkind_np(const pthread_barrierattr_t * attr,
+                                         int *kind);
+
+/*
+ * Split-phase barrier waits: arrive, do other work, then wait for
+ * the cycle arrived at.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_barrier_arrive_np (pthread_barrier_t * barrier,
+                                         unsigned int * token);
+PTW32_DLLPORT int PTW32_CDECL pthread_barrier_wait_token_np (pthread_barrier_t * barrier,
+                                         unsigned int token);
+
+/*
+ * Count-down latches: waiters are released once count arrivals have
+ * been counted down. Single use.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_latch_init_np (pthread_latch_np_t * latch,
+                                         unsigned int count);
+PTW32_DLLPORT int PTW32_CDECL pthread_latch_destroy_np (pthread_latch_np_t * latch);
+PTW32_DLLPORT int PTW32_CDECL pthread_latch_count_down_np (pthread_latch_np_t latch,
+                                         unsigned int n);
+PTW32_DLLPORT int PTW32_CDECL pthread_latch_wait_np (pthread_latch_np_t latch);
+PTW32_DLLPORT int PTW32_CDECL pthread_latch_try_wait_np (pthread_latch_np_t latch);
+PTW32_DLLPORT int PTW32_CDECL pthread_latch_arrive_and_wait_np (pthread_latch_np_t latch,
+                                         unsigned int n);
+
+/*
+ * Phasers: reusable barriers whose parties register and deregister
+ * as they come and go, and which may arrive without waiting.
+ */
+#define PTHREAD_PHASER_MAX_PARTIES_NP 65535
+
+PTW32_DLLPORT int PTW32_CDECL pthread_phaser_init_np (pthread_phaser_np_t * phaser,
+                                         unsigned int parties);
+PTW32_DLLPORT int PTW32_CDECL pthread_phaser_destroy_np (pthread_phaser_np_t * phaser);
+PTW32_DLLPORT int PTW32_CDECL pthread_phaser_register_np (pthread_phaser_np_t phaser,
+                                         unsigned int n,
+                                         unsigned int * phase);
+PTW32_DLLPORT int PTW32_CDECL pthread_phaser_arrive_np (pthread_phaser_np_t phaser,
+                                         unsigned int * phase);
+PTW32_DLLPORT int PTW32_CDECL pthread_phaser_arrive_and_deregister_np (pthread_phaser_np_t phaser,
+                                         unsigned int * phase);
+PTW32_DLLPORT int PTW32_CDECL pthread_phaser_await_np (pthread_phaser_np_t phaser,
+                                         unsigned int phase);
+PTW32_DLLPORT int PTW32_CDECL pthread_phaser_arrive_and_await_np (pthread_phaser_np_t phaser,
+                                         unsigned int * phase);
+
+/*
+ * Thread groups: threads that are cancelled, joined and have their
+ * affinity or priority set together.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_group_create_np (pthread_group_np_t * group);
+PTW32_DLLPORT int PTW32_CDECL pthread_group_destroy_np (pthread_group_np_t * group);
+PTW32_DLLPORT int PTW32_CDECL pthread_group_add_np (pthread_group_np_t group,
+                                         pthread_t thread);
+PTW32_DLLPORT int PTW32_CDECL pthread_group_remove_np (pthread_group_np_t group,
+                                         pthread_t thread);
+PTW32_DLLPORT int PTW32_CDECL pthread_group_cancel_np (pthread_group_np_t group);
+PTW32_DLLPORT int PTW32_CDECL pthread_group_join_np (pthread_group_np_t group);
+PTW32_DLLPORT int PTW32_CDECL pthread_group_setaffinity_np (pthread_group_np_t group,
+                                         size_t cpusetsize,
+                                         const cpu_set_t * cpuset);
+PTW32_DLLPORT int PTW32_CDECL pthread_group_setschedparam_np (pthread_group_np_t group,
+                                         int policy,
+                                         const struct sched_param * param);
+
+/*
+ * As pthread_once(), but also a macro that tests the done flag
+ * inline and only calls the library until the init routine has
+ * completed. Use (pthread_once_np) for the function.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_once_np (pthread_once_t * once_control,
+                                         void (PTW32_CDECL *init_routine) (void));
+
+#if defined(PTW32_ONCE_IS_DONE)
+#define pthread_once_np( _once_control, _init_routine ) \
+  (PTW32_ONCE_IS_DONE(_once_control) \
+   ? 0 : pthread_once( (_once_control), (_init_routine) ))
+#endif
+
+/*
+ * As pthread_getspecific(), but may change the last error code.
+ */
+PTW32_DLLPORT void * PTW32_CDECL pthread_getspecific_fast_np (pthread_key_t key);
+
+/*
+ * Keys whose values pool workers clear between tasks.
+ */
+#define PTHREAD_KEY_TASK_NP 1
+
+PTW32_DLLPORT int PTW32_CDECL pthread_key_create_np (pthread_key_t * key,
+                                void (PTW32_CDECL *destructor) (void *),
+                                int flags);
+
+/*
+ * The TLS index holding the calling thread's struct, for the inline
+ * pthread_testcancel below, or -1.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_testcancel_slot_np (void);
+
+/*
+ * Regions in which a deferred cancel also aborts the thread's
+ * synchronous I/O.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_io_begin_np (void);
+PTW32_DLLPORT int PTW32_CDECL pthread_io_end_np (void);
+
+/*
+ * Thread pools with a work stealing deque per worker.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_pool_create_np (pthread_pool_np_t * pool,
+                                         const pthread_attr_t * attr,
+                                         int nworkers);
+PTW32_DLLPORT int PTW32_CDECL pthread_pool_destroy_np (pthread_pool_np_t * pool);
+PTW32_DLLPORT int PTW32_CDECL pthread_pool_submit_np (pthread_pool_np_t pool,
+                                         void *(PTW32_CDECL *routine) (void *),
+                                         void * arg,
+                                         pthread_pool_task_np_t * task);
+PTW32_DLLPORT int PTW32_CDECL pthread_pool_task_wait_np (pthread_pool_task_np_t task,
+                                         void ** value_ptr);
+PTW32_DLLPORT int PTW32_CDECL pthread_pool_wait_np (pthread_pool_np_t pool);
+PTW32_DLLPORT int PTW32_CDECL pthread_pool_parallel_for_np (pthread_pool_np_t pool,
+                                         long begin, long end, long grain,
+                                         void (PTW32_CDECL *routine) (long begin, long end,
+                                                                      void * arg),
+                                         void * arg);
+PTW32_DLLPORT int PTW32_CDECL pthread_pool_parallel_reduce_np (pthread_pool_np_t pool,
+                                         long begin, long end, long grain,
+                                         void * (PTW32_CDECL *routine) (long begin, long end,
+                                                                        void * value, void * arg),
+                                         void * (PTW32_CDECL *combine) (void * a, void * b,
+                                                                        void * arg),
+                                         void * identity, void * arg, void ** value_ptr);
+
+/*
+ * Process wide processor tokens, held by the threads running compute
+ * work, so that pool workers and other runtimes (OpenMP) sharing the
+ * process don't run more of it at once than there are processors.
+ */
+#define PTHREAD_CPUTOKENS_OFF_NP	-1	/* No limit (the default) */
+#define PTHREAD_CPUTOKENS_PROCESSORS_NP	0	/* pthread_num_processors_np() */
+
+PTW32_DLLPORT int PTW32_CDECL pthread_setcputokens_np (int tokens);
+PTW32_DLLPORT int PTW32_CDECL pthread_getcputokens_np (int * tokens, int * available);
+PTW32_DLLPORT int PTW32_CDECL pthread_cputokens_acquire_np (int min, int max, int * count);
+PTW32_DLLPORT int PTW32_CDECL pthread_cputokens_release_np (int count);
+
+/*
+ * Waiting for a mutex or condition variable without a thread: the
+ * callback runs on a pool worker, or a packet is posted to an I/O
+ * completion port, once the wait is over (see also sem_wait_async_np
+ * and pthread_async_np.hpp).
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_lock_async_np (pthread_mutex_t * mutex,
+                                         pthread_pool_np_t pool,
+                                         void (PTW32_CDECL * callback) (void *),
+                                         void * arg);
+PTW32_DLLPORT int PTW32_CDECL pthread_cond_wait_async_np (pthread_cond_t * cond,
+                                         pthread_mutex_t * mutex,
+                                         pthread_pool_np_t pool,
+                                         void (PTW32_CDECL * callback) (void *),
+                                         void * arg);
+PTW32_DLLPORT int PTW32_CDECL pthread_cond_wait_port_np (pthread_cond_t * cond,
+                                         pthread_mutex_t * mutex,
+                                         HANDLE port,
+                                         void * key,
+                                         void * overlapped);
+
+/*
+ * Bounded multi-producer, multi-consumer queues of pointers.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_queue_create_np (pthread_queue_np_t * queue,
+                                         int capacity);
+PTW32_DLLPORT int PTW32_CDECL pthread_queue_destroy_np (pthread_queue_np_t * queue);
+PTW32_DLLPORT int PTW32_CDECL pthread_queue_push_np (pthread_queue_np_t queue,
+                                         void * item);
+PTW32_DLLPORT int PTW32_CDECL pthread_queue_trypush_np (pthread_queue_np_t queue,
+                                         void * item);
+PTW32_DLLPORT int PTW32_CDECL pthread_queue_timedpush_np (pthread_queue_np_t queue,
+                                         void * item,
+                                         const struct timespec * abstime);
+PTW32_DLLPORT int PTW32_CDECL pthread_queue_pop_np (pthread_queue_np_t queue,
+                                         void ** item);
+PTW32_DLLPORT int PTW32_CDECL pthread_queue_trypop_np (pthread_queue_np_t queue,
+                                         void ** item);
+PTW32_DLLPORT int PTW32_CDECL pthread_queue_timedpop_np (pthread_queue_np_t queue,
+                                         void ** item,
+                                         const struct timespec * abstime);
+
+/*
+ * Unbounded work-stealing deques of pointers: the owner thread pushes
+ * and pops at one end, any thread steals from the other.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_wsdeque_create_np (pthread_wsdeque_np_t * deque);
+PTW32_DLLPORT int PTW32_CDECL pthread_wsdeque_destroy_np (pthread_wsdeque_np_t * deque);
+PTW32_DLLPORT int PTW32_CDECL pthread_wsdeque_push_np (pthread_wsdeque_np_t deque,
+                                         void * item);
+PTW32_DLLPORT int PTW32_CDECL pthread_wsdeque_pop_np (pthread_wsdeque_np_t deque,
+                                         void ** item);
+PTW32_DLLPORT int PTW32_CDECL pthread_wsdeque_steal_np (pthread_wsdeque_np_t deque,
+                                         void ** item);
+
+/*
+ * Single-producer single-consumer channels of pointers, with batched
+ * pushes and pops and ends that park when the channel is full or empty.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_spsc_create_np (pthread_spsc_np_t * channel,
+                                         int capacity);
+PTW32_DLLPORT int PTW32_CDECL pthread_spsc_destroy_np (pthread_spsc_np_t * channel);
+PTW32_DLLPORT int PTW32_CDECL pthread_spsc_push_np (pthread_spsc_np_t channel,
+                                         void * item);
+PTW32_DLLPORT int PTW32_CDECL pthread_spsc_trypush_np (pthread_spsc_np_t channel,
+                                         void * item);
+PTW32_DLLPORT int PTW32_CDECL pthread_spsc_pushv_np (pthread_spsc_np_t channel,
+                                         void * const * items,
+                                         int count);
+PTW32_DLLPORT int PTW32_CDECL pthread_spsc_pop_np (pthread_spsc_np_t channel,
+                                         void ** item);
+PTW32_DLLPORT int PTW32_CDECL pthread_spsc_trypop_np (pthread_spsc_np_t channel,
+                                         void ** item);
+PTW32_DLLPORT int PTW32_CDECL pthread_spsc_popv_np (pthread_spsc_np_t channel,
+                                         void ** items,
+                                         int count,
+                                         int * popped);
+
+/*
+ * Tables of cache line padded locks selected by hash (lock striping).
+ */
+#define PTHREAD_LOCKSTRIPE_MAX_NP 65536
+
+PTW32_DLLPORT int PTW32_CDECL pthread_lockstripe_create_np (pthread_lockstripe_np_t * stripe,
+                                         int nstripes,
+                                         const pthread_mutexattr_t * attr);
+PTW32_DLLPORT int PTW32_CDECL pthread_lockstripe_destroy_np (pthread_lockstripe_np_t * stripe);
+PTW32_DLLPORT int PTW32_CDECL pthread_lockstripe_lock_np (pthread_lockstripe_np_t stripe,
+                                         size_t hash);
+PTW32_DLLPORT int PTW32_CDECL pthread_lockstripe_trylock_np (pthread_lockstripe_np_t stripe,
+                                         size_t hash);
+PTW32_DLLPORT int PTW32_CDECL pthread_lockstripe_unlock_np (pthread_lockstripe_np_t stripe,
+                                         size_t hash);
+PTW32_DLLPORT int PTW32_CDECL pthread_lockstripe_lockmany_np (pthread_lockstripe_np_t stripe,
+                                         const size_t * hashes,
+                                         int count);
+PTW32_DLLPORT int PTW32_CDECL pthread_lockstripe_unlockmany_np (pthread_lockstripe_np_t stripe,
+                                         const size_t * hashes,
+                                         int count);
+PTW32_DLLPORT int PTW32_CDECL pthread_lockstripe_getmutex_np (pthread_lockstripe_np_t stripe,
+                                         size_t hash,
+                                         pthread_mutex_t * mutex);
+
+/*
+ * Sequence locks: writers take a mutex, readers copy the data and
+ * retry if a writer was active, without writing to shared memory.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_init_np (pthread_seqlock_np_t * lock);
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_destroy_np (pthread_seqlock_np_t * lock);
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_read_begin_np (pthread_seqlock_np_t lock,
+                                         unsigned int * seq);
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_read_retry_np (pthread_seqlock_np_t lock,
+                                         unsigned int seq);
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_write_lock_np (pthread_seqlock_np_t lock);
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_write_unlock_np (pthread_seqlock_np_t lock);
+
+/*
+ * Reader-writer spin locks: one word holding a reader count and a
+ * writer bit, for very short read-mostly critical sections.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_rwspin_init_np (pthread_rwspinlock_np_t * lock,
+                                         int pshared);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwspin_destroy_np (pthread_rwspinlock_np_t * lock);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwspin_rdlock_np (pthread_rwspinlock_np_t * lock);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwspin_tryrdlock_np (pthread_rwspinlock_np_t * lock);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwspin_wrlock_np (pthread_rwspinlock_np_t * lock);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwspin_trywrlock_np (pthread_rwspinlock_np_t * lock);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwspin_unlock_np (pthread_rwspinlock_np_t * lock);
+
+/*
+ * Per-CPU data: a zeroed slot for each logical processor, in cache
+ * lines of its own, for counters and caches that would otherwise be
+ * kept per thread.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_percpu_create_np (pthread_percpu_np_t * percpu,
+                                         size_t size);
+PTW32_DLLPORT int PTW32_CDECL pthread_percpu_destroy_np (pthread_percpu_np_t * percpu);
+PTW32_DLLPORT int PTW32_CDECL pthread_percpu_this_np (pthread_percpu_np_t percpu,
+                                         void ** slot);
+PTW32_DLLPORT int PTW32_CDECL pthread_percpu_slot_np (pthread_percpu_np_t percpu,
+                                         int index,
+                                         void ** slot);
+PTW32_DLLPORT int PTW32_CDECL pthread_percpu_count_np (pthread_percpu_np_t percpu);
+
+/*
+ * Sharded counter, built on the per-CPU slots: adds go to the caller's
+ * processor's shard and reads sum the shards.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_counter_init_np (pthread_counter_np_t * counter);
+PTW32_DLLPORT int PTW32_CDECL pthread_counter_destroy_np (pthread_counter_np_t * counter);
+PTW32_DLLPORT int PTW32_CDECL pthread_counter_add_np (pthread_counter_np_t counter,
+                                         __int64 delta);
+PTW32_DLLPORT int PTW32_CDECL pthread_counter_read_np (pthread_counter_np_t counter,
+                                         __int64 * value);
+
+/*
+ * Quiescent state based read-copy-update. Readers go online, read
+ * shared data without locks and report quiescent states (cancellation
+ * points count as one); updaters wait for a grace period, or have a
+ * callback run after one, before reclaiming what they unlinked.
+ * Embed a pthread_rcu_head_np_t in objects passed to pthread_call_rcu_np.
+ */
+struct pthread_rcu_head_np_t_ {
+  pthread_rcu_head_np_t * next;
+  void (PTW32_CDECL * func) (pthread_rcu_head_np_t * head);
+};
+
+PTW32_DLLPORT int PTW32_CDECL pthread_rcu_online_np (void);
+PTW32_DLLPORT int PTW32_CDECL pthread_rcu_offline_np (void);
+PTW32_DLLPORT int PTW32_CDECL pthread_rcu_quiescent_np (void);
+PTW32_DLLPORT int PTW32_CDECL pthread_rcu_synchronize_np (void);
+PTW32_DLLPORT int PTW32_CDECL pthread_call_rcu_np (pthread_rcu_head_np_t * head,
+                                         void (PTW32_CDECL * func) (pthread_rcu_head_np_t *));
+PTW32_DLLPORT int PTW32_CDECL pthread_rcu_barrier_np (void);
+
+/*
+ * MCS queue locks. A lock is a pointer to the last of the threads
+ * queued for it, NULL (PTHREAD_MCS_LOCK_INITIALIZER_NP) when free.
+ * Each locker supplies a queue node, usually on its stack, and waits
+ * on that node alone; the node must stay put until the unlock, or
+ * until pthread_mcs_node_transfer_np() moves the lock to another one.
+ * The node mirrors the library's internal MCS node (see implement.h)
+ * and must be kept in step with it.
+ */
+struct pthread_mcs_node_np_t_ {
+  pthread_mcs_lock_np_t * lock;
+  pthread_mcs_node_np_t * next;
+  void * readyFlag;
+  void * nextFlag;
+};
+
+#define PTHREAD_MCS_LOCK_INITIALIZER_NP ((pthread_mcs_lock_np_t) NULL)
+
+PTW32_DLLPORT int PTW32_CDECL pthread_mcs_lock_np (pthread_mcs_lock_np_t * lock,
+                                         pthread_mcs_node_np_t * node);
+PTW32_DLLPORT int PTW32_CDECL pthread_mcs_trylock_np (pthread_mcs_lock_np_t * lock,
+                                         pthread_mcs_node_np_t * node);
+PTW32_DLLPORT int PTW32_CDECL pthread_mcs_unlock_np (pthread_mcs_node_np_t * node);
+PTW32_DLLPORT int PTW32_CDECL pthread_mcs_node_transfer_np (pthread_mcs_node_np_t * newNode,
+                                         pthread_mcs_node_np_t * oldNode);
+
+/*
+ * Hazard pointers: a thread publishes the pointers it is about to use
+ * in its slots, and retired objects are reclaimed once no slot of any
+ * thread holds them.
+ */
+#define PTHREAD_HAZARD_SLOTS_NP 4
+
+PTW32_DLLPORT int PTW32_CDECL pthread_hazard_protect_np (int slot,
+                                         void * volatile * src,
+                                         void ** ptr);
+PTW32_DLLPORT int PTW32_CDECL pthread_hazard_clear_np (int slot);
+PTW32_DLLPORT int PTW32_CDECL pthread_hazard_retire_np (void * p,
+                                         void (PTW32_CDECL * reclaim) (void *));
+PTW32_DLLPORT int PTW32_CDECL pthread_hazard_scan_np (void);
+
+/*
+ * Futex style blocking on an arbitrary 1, 2, 4 or 8 byte location:
+ * wait while it holds the expected value, wake waiters after changing it.
+ */
+#define PTHREAD_WAKE_ALL_NP INT_MAX
+
+PTW32_DLLPORT int PTW32_CDECL pthread_wait_on_address_np (volatile void * address,
+                                         const void * expected,
+                                         size_t size,
+                                         const struct timespec * abstime);
+PTW32_DLLPORT int PTW32_CDECL pthread_wake_np (volatile void * address, int n);
+
+/*
+ * Waiting for the first of several semaphores, queues and threads.
+ */
+enum {
+  PTHREAD_WAITANY_SEM_NP   = 1,	/* object is a sem_t * */
+  PTHREAD_WAITANY_QUEUE_NP = 2,	/* object is a pthread_queue_np_t */
+  PTHREAD_WAITANY_JOIN_NP  = 3	/* object is a pthread_t * */
+};
+
+#define PTHREAD_WAITANY_MAX_NP 62
+
+typedef struct {
+  int type;
+  void * object;
+  void * value;			/* Popped item or joined thread's exit value */
+} pthread_waitany_np_t;
+
+PTW32_DLLPORT int PTW32_CDECL pthread_waitany_np (pthread_waitany_np_t * objects,
+                                         int n,
+                                         const struct timespec * abstime,
+                                         int * index);
+
+/*
+ * Processor topology and NUMA node placement.
+ */
+enum {
+  PTHREAD_CPU_CORE_NP     = 0,	/* Hardware threads of one core */
+  PTHREAD_CPU_CACHE_NP    = 1,	/* CPUs sharing the last level cache */
+  PTHREAD_CPU_NUMANODE_NP = 2	/* CPUs of one NUMA node */
+};
+
+PTW32_DLLPORT int PTW32_CDECL pthread_num_numanodes_np (void);
+PTW32_DLLPORT int PTW32_CDECL pthread_getnumanodecpus_np (int node,
+                                         size_t cpusetsize,
+                                         cpu_set_t * cpuset);
+PTW32_DLLPORT int PTW32_CDECL pthread_getcpunumanode_np (int cpu,
+                                         int * node);
+PTW32_DLLPORT int PTW32_CDECL pthread_getcpusiblings_np (int cpu,
+                                         int relation,
+                                         size_t cpusetsize,
+                                         cpu_set_t * cpuset);
+PTW32_DLLPORT int PTW32_CDECL pthread_attr_setnumanode_np (pthread_attr_t * attr,
+                                         int node);
+PTW32_DLLPORT int PTW32_CDECL pthread_attr_getnumanode_np (const pthread_attr_t * attr,
+                                         int * node);
+PTW32_DLLPORT int PTW32_CDECL pthread_getnumanode_np (pthread_t thread,
+                                         int * node);
+
+/*
+ * Thread quality of service on hybrid (performance and efficiency
+ * core) machines.
+ */
+enum {
+  PTHREAD_QOS_DEFAULT_NP    = 0,	/* The system decides */
+  PTHREAD_QOS_HIGH_NP       = 1,	/* Never throttled, fastest cores */
+  PTHREAD_QOS_EFFICIENCY_NP = 2	/* EcoQoS, most efficient cores */
+};
+
+PTW32_DLLPORT int PTW32_CDECL pthread_attr_setqos_np (pthread_attr_t * attr,
+                                         int qos);
+PTW32_DLLPORT int PTW32_CDECL pthread_attr_getqos_np (const pthread_attr_t * attr,
+                                         int * qos);
+PTW32_DLLPORT int PTW32_CDECL pthread_setqos_np (pthread_t thread,
+                                         int qos);
+PTW32_DLLPORT int PTW32_CDECL pthread_getqos_np (pthread_t thread,
+                                         int * qos);
+
+/*
+ * Whether a thread gets Windows' dynamic priority boost when woken.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_setwakeboost_np (pthread_t thread,
+                                         int boost);
+PTW32_DLLPORT int PTW32_CDECL pthread_getwakeboost_np (pthread_t thread,
+                                         int * boost);
+
+/*
+ * Detached threads run as work items of a thread pool.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_attr_setpooled_np (pthread_attr_t * attr,
+                                         int pooled);
+PTW32_DLLPORT int PTW32_CDECL pthread_attr_getpooled_np (const pthread_attr_t * attr,
+                                         int * pooled);
+
+/*
+ * The stack size is a reservation; this sets how much is committed
+ * when the thread starts.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_attr_setstackcommit_np (pthread_attr_t * attr,
+                                         size_t stackcommit);
+PTW32_DLLPORT int PTW32_CDECL pthread_attr_getstackcommit_np (const pthread_attr_t * attr,
+                                         size_t * stackcommit);
+
+/*
+ * Per-thread CPU time and blocking statistics. Times are in
+ * nanoseconds.
+ */
+typedef struct {
+  unsigned __int64 userTime;
+  unsigned __int64 kernelTime;
+  unsigned __int64 cycles;	/* 0 where QueryThreadCycleTime is missing */
+  unsigned __int64 waits;	/* Waits that blocked */
+  unsigned __int64 waitTime;
+  unsigned __int64 cancelRequests;
+} pthread_threadstats_np_t;
+
+PTW32_DLLPORT int PTW32_CDECL pthread_getstats_np (pthread_t thread,
+                                         pthread_threadstats_np_t * stats);
+
+/*
+ * Process wide counts of the kernel objects the library holds and
+ * the kernel calls it makes.
+ */
+typedef struct {
+  unsigned __int64 events;	/* Held now */
+  unsigned __int64 semaphores;	/* Held now */
+  unsigned __int64 timers;	/* Held now */
+  unsigned __int64 threadHandles;	/* Held now */
+  unsigned __int64 mutexWaits;	/* Waits that entered the kernel */
+  unsigned __int64 condWaits;
+  unsigned __int64 rwlockWaits;
+  unsigned __int64 semWaits;
+  unsigned __int64 barrierWaits;
+  unsigned __int64 joinWaits;
+  unsigned __int64 otherWaits;
+  unsigned __int64 setEvents;
+  unsigned __int64 releaseSemaphores;
+  unsigned __int64 mcsEvents;	/* Created by internal locks */
+  unsigned __int64 threads;	/* POSIX threads now, including implicit */
+  unsigned __int64 cancellations;	/* pthread_cancel() requests */
+} pthread_libstats_np_t;
+
+PTW32_DLLPORT int PTW32_CDECL pthread_getlibstats_np (pthread_libstats_np_t * stats);
+
+/*
+ * Contention statistics, kept by a library built with PTW32_LOCKSTAT.
+ * Times are in nanoseconds.
+ */
+typedef struct {
+  unsigned __int64 acquisitions;	/* Locks taken, or condition waits */
+  unsigned __int64 contended;	/* Of which had to wait, or were woken */
+  unsigned __int64 waitTime;
+  unsigned __int64 maxWaitTime;
+  unsigned __int64 holdTime;	/* After contended acquisitions */
+} pthread_lockstat_np_t;
+
+enum {
+  PTHREAD_LOCKSTAT_MUTEX_NP  = 0,
+  PTHREAD_LOCKSTAT_RWLOCK_NP = 1,
+  PTHREAD_LOCKSTAT_COND_NP   = 2
+};
+
+PTW32_DLLPORT int PTW32_CDECL pthread_mutex_getstats_np (pthread_mutex_t * mutex,
+                                         pthread_lockstat_np_t * stats);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlock_getstats_np (pthread_rwlock_t * rwlock,
+                                         pthread_lockstat_np_t * stats);
+PTW32_DLLPORT int PTW32_CDECL pthread_cond_getstats_np (pthread_cond_t * cond,
+                                         pthread_lockstat_np_t * stats);
+PTW32_DLLPORT int PTW32_CDECL pthread_lockstat_walk_np (int (PTW32_CDECL *callback) (int kind,
+                                                                     void * object,
+                                                                     const pthread_lockstat_np_t * stats,
+                                                                     void * arg),
+                                         void * arg);
+PTW32_DLLPORT int PTW32_CDECL pthread_lockstat_dump_np (void);
+
+/*
+ * Samples of slow or 1-in-N contended acquisitions, taken by a library
+ * built with PTW32_LOCKSTAT once sampling is set.
+ */
+#define PTHREAD_LOCKPROF_DEPTH_NP 16
+
+typedef struct {
+  int kind;			/* PTHREAD_LOCKSTAT_*_NP */
+  void * object;
+  pthread_t waiter;
+  pthread_t owner;		/* Mutexes only, else a NULL handle */
+  unsigned __int64 waitTime;	/* Nanoseconds */
+  int waiterDepth;
+  int ownerDepth;		/* 0 if owner is not known */
+  void * waiterStack[PTHREAD_LOCKPROF_DEPTH_NP];
+  void * ownerStack[PTHREAD_LOCKPROF_DEPTH_NP];
+} pthread_lockprof_np_t;
+
+PTW32_DLLPORT int PTW32_CDECL pthread_lockprof_setsampling_np (int every,
+                                         const struct timespec * threshold);
+PTW32_DLLPORT int PTW32_CDECL pthread_lockprof_read_np (unsigned int * position,
+                                         pthread_lockprof_np_t * samples,
+                                         int n,
+                                         int * count);
+
+/*
+ * Lock order and hold time reports, made by a library built with
+ * PTW32_LOCKWATCH.
+ */
+typedef struct {
+  int event;			/* PTHREAD_LOCKWATCH_*_NP */
+  pthread_t thread;		/* The thread that took or held the locks */
+  pthread_mutex_t held;		/* ORDER: held while taking 'acquired'; HOLD: held too long */
+  pthread_mutex_t acquired;	/* ORDER only */
+  unsigned __int64 holdTime;	/* HOLD only, nanoseconds */
+} pthread_lockwatch_np_t;
+
+enum {
+  PTHREAD_LOCKWATCH_ORDER_NP = 1,	/* Taken in both orders */
+  PTHREAD_LOCKWATCH_HOLD_NP  = 2	/* Held longer than the limit */
+};
+
+PTW32_DLLPORT int PTW32_CDECL pthread_lockwatch_setcallback_np (void (PTW32_CDECL *callback) (const pthread_lockwatch_np_t * report,
+                                                                              void * arg),
+                                         void * arg);
+PTW32_DLLPORT int PTW32_CDECL pthread_lockwatch_setholdlimit_np (const struct timespec * limit);
+
+/*
+ * An edge of the mutex wait-for graph: 'waiter' is blocked on 'mutex',
+ * held by 'owner' (a NULL handle if that isn't known).
+ */
+typedef struct {
+  pthread_t waiter;
+  pthread_mutex_t mutex;
+  pthread_t owner;
+} pthread_waitedge_np_t;
+
+PTW32_DLLPORT int PTW32_CDECL pthread_dump_waitgraph_np (pthread_waitedge_np_t * edges,
+                                         int n,
+                                         int * count);
+
+/*
+ * A thread's latest slow path events, kept in any build.
+ */
+#define PTHREAD_FLIGHTREC_EVENTS_NP 32
+
+typedef struct {
+  unsigned __int64 time;	/* CLOCK_MONOTONIC, nanoseconds */
+  int event;			/* PTHREAD_FLIGHTREC_*_NP */
+  void * object;		/* The mutex, condition variable or thread */
+  __int64 value;		/* Event specific */
+} pthread_flightrec_np_t;
+
+enum {
+  PTHREAD_FLIGHTREC_MUTEX_WAIT_BEGIN_NP = 1,
+  PTHREAD_FLIGHTREC_MUTEX_WAIT_END_NP,	/* value: result */
+  PTHREAD_FLIGHTREC_MUTEX_WAKE_NP,
+  PTHREAD_FLIGHTREC_COND_WAIT_BEGIN_NP,
+  PTHREAD_FLIGHTREC_COND_WAIT_END_NP,	/* value: result */
+  PTHREAD_FLIGHTREC_COND_SIGNAL_NP,	/* value: waiters released */
+  PTHREAD_FLIGHTREC_COND_BROADCAST_NP,	/* value: waiters released */
+  PTHREAD_FLIGHTREC_THREAD_CREATE_NP,	/* object: the new thread's .p */
+  PTHREAD_FLIGHTREC_THREAD_EXIT_NP,	/* value: exit status */
+  PTHREAD_FLIGHTREC_THREAD_CANCEL_NP
+};
+
+PTW32_DLLPORT int PTW32_CDECL pthread_flightrec_dump_np (pthread_t thread,
+                                         pthread_flightrec_np_t * events,
+                                         int n,
+                                         int * count);
+
+/*
+ * Process wide histograms of the time spent in blocking waits, by kind
+ * of wait. Bucket 0 counts waits under 256 nanoseconds; above that
+ * each power of 2 is split into 4 buckets, and bucket b counts waits
+ * from PTHREAD_HIST_LOWER_NP(b) nanoseconds up to the next bucket's.
+ * The last one also counts all longer waits.
+ */
+#define PTHREAD_HIST_BUCKETS_NP 125
+#define PTHREAD_HIST_LOWER_NP(b) \
+  ((b) == 0 ? (unsigned __int64) 0 \
+   : (unsigned __int64) (4 + ((b) - 1) % 4) << (((b) - 1) / 4 + 6))
+
+enum {
+  PTHREAD_HIST_MUTEX_NP = 0,
+  PTHREAD_HIST_COND_NP,
+  PTHREAD_HIST_RWLOCK_READ_NP,
+  PTHREAD_HIST_RWLOCK_WRITE_NP,
+  PTHREAD_HIST_SEM_NP,
+  PTHREAD_HIST_BARRIER_NP,
+  PTHREAD_HIST_JOIN_NP,
+  PTHREAD_HIST_OTHER_NP,
+  PTHREAD_HIST_KINDS_NP
+};
+
+typedef struct {
+  unsigned __int64 count[PTHREAD_HIST_BUCKETS_NP];
+} pthread_hist_np_t;
+
+PTW32_DLLPORT int PTW32_CDECL pthread_gethistograms_np (pthread_hist_np_t * hists,
+                                         int n);
 
 /*
  * Possibly supported by other POSIX threads implementations
  */
 PTW32_DLLPORT int PTW32_CDECL pthread_delay_np (struct timespec * interval);
+
+/*
+ * How sched_yield (and pthread_delay_np with a zero interval) gives
+ * up the processor
+ */
+enum
+{
+  PTHREAD_YIELD_SWITCH_NP  = 0,	/* To any ready thread (default) */
+  PTHREAD_YIELD_SLEEP_NP   = 1,	/* To threads of at least equal priority */
+  PTHREAD_YIELD_BACKOFF_NP = 2	/* Escalate to sleeping on repeated calls */
+};
+
+PTW32_DLLPORT int PTW32_CDECL pthread_setyieldmode_np(int mode);
+PTW32_DLLPORT int PTW32_CDECL pthread_getyieldmode_np(int *mode);
 PTW32_DLLPORT int PTW32_CDECL pthread_num_processors_np(void);
 PTW32_DLLPORT unsigned __int64 PTW32_CDECL pthread_getunique_np(pthread_t thread);
 
@@ -1187,6 +2359,7 @@ PTW32_DLLPORT int PTW32_CDECL pthread_win32_process_attach_np(void);
 PTW32_DLLPORT int PTW32_CDECL pthread_win32_process_detach_np(void);
 PTW32_DLLPORT int PTW32_CDECL pthread_win32_thread_attach_np(void);
 PTW32_DLLPORT int PTW32_CDECL pthread_win32_thread_detach_np(void);
+PTW32_DLLPORT int PTW32_CDECL pthread_win32_set_fast_exit_np(int enable);
 
 /*
  * Features that are auto-detected at load/run time.
@@ -1194,7 +2367,15 @@ PTW32_DLLPORT int PTW32_CDECL pthread_win32_thread_detach_np(void);
 PTW32_DLLPORT int PTW32_CDECL pthread_win32_test_features_np(int);
 enum ptw32_features {
   PTW32_SYSTEM_INTERLOCKED_COMPARE_EXCHANGE = 0x0001,	/* System provides it. */
-  PTW32_ALERTABLE_ASYNC_CANCEL              = 0x0002	/* Can cancel blocked threads. */
+  PTW32_ALERTABLE_ASYNC_CANCEL              = 0x0002,	/* Can cancel blocked threads. */
+  PTW32_WAIT_ON_ADDRESS                     = 0x0004,	/* Mutexes wait via WaitOnAddress. */
+  PTW32_SRW_LOCKS                           = 0x0008,	/* RW locks use Slim R/W locks. */
+  PTW32_PROCESSOR_GROUPS                    = 0x0010,	/* CPU sets span processor groups. */
+  PTW32_HIGH_RES_TIMEOUTS                   = 0x0020,	/* Timed waits use high resolution timers. */
+  PTW32_SPECIAL_APC_CANCEL                  = 0x0040,	/* Async cancel doesn't suspend the thread. */
+  PTW32_SOFT_AFFINITY                       = 0x0080,	/* Soft affinity via CPU Sets. */
+  PTW32_THREAD_EXIT_FLS                     = 0x0100,	/* Thread exits are seen through FLS. */
+  PTW32_LOCK_ELISION                        = 0x0200	/* Elided mutexes and rwlocks use RTM. */
 };
 
 /*
@@ -1400,6 +2581,242 @@ PTW32_DLLPORT DWORD PTW32_CDECL ptw32_get_exception_services_code(void);
 
 #endif /* __CLEANUP_CXX */
 
+#if defined(PTW32_INLINE_LOCKS) \
+    && ((defined(_MSC_VER) && _MSC_VER >= 1400) || defined(__GNUC__))
+
+/*
+ * Inline fast paths for uncontended normal mutexes and spinlocks,
+ * and for pthread_testcancel, enabled by defining PTW32_INLINE_LOCKS
+ * before including this file.
+ * An uncontended lock or unlock is then a single interlocked
+ * operation in the caller; anything else (contention, statically
+ * initialised objects, other mutex types, process shared objects)
+ * is passed to the library as before.
+ *
+ * Only uncontended calls are inlined, so a library built with
+ * PTW32_LOCKSTAT or PTW32_LOCKWATCH sees only those that reach it.
+ * Requires MSVC 2005 or later, or GCC.
+ *
+ * The structures below mirror the leading members of the library's
+ * struct pthread_mutex_t_ and struct pthread_spinlock_t_ (see
+ * implement.h) and must be kept in step with them.
+ */
+struct ptw32_inline_mutex_t_ {
+  long lock_idx;		/* 0: unlocked, 1: locked, -1: locked with waiters */
+  int recursive_count;
+  int kind;
+};
+
+struct ptw32_inline_spinlock_t_ {
+  long interlock;
+};
+
+#define PTW32_INLINE_SPIN_UNLOCKED 1
+#define PTW32_INLINE_SPIN_LOCKED   2
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#  pragma intrinsic(_InterlockedCompareExchange)
+#  define PTW32_INLINE_CAS(location, value, comparand) \
+     _InterlockedCompareExchange ((location), (value), (comparand))
+#else
+#  define PTW32_INLINE_CAS(location, value, comparand) \
+     __sync_val_compare_and_swap ((location), (comparand), (value))
+#endif
+
+#if defined(__cplusplus)
+#  define PTW32_INLINE_FN static inline
+#elif defined(_MSC_VER)
+#  define PTW32_INLINE_FN static __inline
+#else
+#  define PTW32_INLINE_FN static __inline__
+#endif
+
+/*
+ * An initialised, process private normal mutex: heap objects are
+ * aligned, unlike process shared handles, and lie below the static
+ * initialisers.
+ */
+#define PTW32_INLINE_MUTEX(mx) \
+  ((mx) != NULL \
+   && (size_t) (mx) < (size_t) PTHREAD_ERRORCHECK_MUTEX_INITIALIZER \
+   && ((size_t) (mx) & 3) == 0 \
+   && ((struct ptw32_inline_mutex_t_ *) (mx))->kind == PTHREAD_MUTEX_NORMAL)
+
+PTW32_INLINE_FN int
+ptw32_inline_mutex_lock (pthread_mutex_t * mutex)
+{
+  pthread_mutex_t mx = *mutex;
+
+  if (PTW32_INLINE_MUTEX (mx)
+      && PTW32_INLINE_CAS (&((struct ptw32_inline_mutex_t_ *) mx)->lock_idx, 1, 0) == 0)
+    {
+      return 0;
+    }
+
+  return pthread_mutex_lock (mutex);
+}
+
+PTW32_INLINE_FN int
+ptw32_inline_mutex_trylock (pthread_mutex_t * mutex)
+{
+  pthread_mutex_t mx = *mutex;
+
+  if (PTW32_INLINE_MUTEX (mx)
+      && PTW32_INLINE_CAS (&((struct ptw32_inline_mutex_t_ *) mx)->lock_idx, 1, 0) == 0)
+    {
+      return 0;
+    }
+
+  return pthread_mutex_trylock (mutex);
+}
+
+PTW32_INLINE_FN int
+ptw32_inline_mutex_unlock (pthread_mutex_t * mutex)
+{
+  pthread_mutex_t mx = *mutex;
+
+  /* A lock_idx of -1 means there may be waiters to wake */
+  if (PTW32_INLINE_MUTEX (mx)
+      && PTW32_INLINE_CAS (&((struct ptw32_inline_mutex_t_ *) mx)->lock_idx, 0, 1) == 1)
+    {
+      return 0;
+    }
+
+  return pthread_mutex_unlock (mutex);
+}
+
+PTW32_INLINE_FN int
+ptw32_inline_spin_lock (pthread_spinlock_t * lock)
+{
+  pthread_spinlock_t s;
+
+  if (lock != NULL
+      && (s = *lock) != NULL && s != PTHREAD_SPINLOCK_INITIALIZER
+      && PTW32_INLINE_CAS (&((struct ptw32_inline_spinlock_t_ *) s)->interlock,
+                           PTW32_INLINE_SPIN_LOCKED,
+                           PTW32_INLINE_SPIN_UNLOCKED) == PTW32_INLINE_SPIN_UNLOCKED)
+    {
+      return 0;
+    }
+
+  return pthread_spin_lock (lock);
+}
+
+PTW32_INLINE_FN int
+ptw32_inline_spin_trylock (pthread_spinlock_t * lock)
+{
+  pthread_spinlock_t s;
+
+  if (lock != NULL
+      && (s = *lock) != NULL && s != PTHREAD_SPINLOCK_INITIALIZER
+      && PTW32_INLINE_CAS (&((struct ptw32_inline_spinlock_t_ *) s)->interlock,
+                           PTW32_INLINE_SPIN_LOCKED,
+                           PTW32_INLINE_SPIN_UNLOCKED) == PTW32_INLINE_SPIN_UNLOCKED)
+    {
+      return 0;
+    }
+
+  return pthread_spin_trylock (lock);
+}
+
+PTW32_INLINE_FN int
+ptw32_inline_spin_unlock (pthread_spinlock_t * lock)
+{
+  pthread_spinlock_t s;
+
+  if (lock != NULL
+      && (s = *lock) != NULL && s != PTHREAD_SPINLOCK_INITIALIZER
+      && PTW32_INLINE_CAS (&((struct ptw32_inline_spinlock_t_ *) s)->interlock,
+                           PTW32_INLINE_SPIN_UNLOCKED,
+                           PTW32_INLINE_SPIN_LOCKED) == PTW32_INLINE_SPIN_LOCKED)
+    {
+      return 0;
+    }
+
+  return pthread_spin_unlock (lock);
+}
+
+/*
+ * pthread_testcancel reads the calling thread's struct from the TEB's
+ * TLS slots, which leaves the last error alone, and calls the library
+ * only if the word after the struct's handle is set: a cancel, a
+ * signal or an RCU quiescent state is pending. Only x86 and x64 are
+ * inlined.
+ */
+struct ptw32_inline_thread_t_ {
+  pthread_t ptHandle;
+  long testCancel;		/* ptw32_thread_t.testCancel */
+};
+
+#if defined(_M_X64) || defined(__x86_64__)
+#  define PTW32_INLINE_TLS_SLOTS 0x1480	/* TEB.TlsSlots, see implement.h */
+#elif defined(_M_IX86) || defined(__i386__)
+#  define PTW32_INLINE_TLS_SLOTS 0xE10
+#endif
+
+#if defined(PTW32_INLINE_TLS_SLOTS)
+
+PTW32_INLINE_FN void *
+ptw32_inline_tls_slot (int slot)
+{
+  unsigned long offset = PTW32_INLINE_TLS_SLOTS + (unsigned long) slot * sizeof (void *);
+#if defined(_MSC_VER) && defined(_M_X64)
+  return (void *) __readgsqword (offset);
+#elif defined(_MSC_VER)
+  return (void *) __readfsdword (offset);
+#else
+  void * value;
+#  if defined(__x86_64__)
+  __asm__ __volatile__ ("movq %%gs:(%1), %0" : "=r" (value) : "r" ((unsigned long long) offset));
+#  else
+  __asm__ __volatile__ ("movl %%fs:(%1), %0" : "=r" (value) : "r" (offset));
+#  endif
+  return value;
+#endif
+}
+
+PTW32_INLINE_FN void
+ptw32_inline_testcancel (void)
+{
+  /* 0: not yet asked, -1: not usable, otherwise the slot + 1 */
+  static int slot = 0;
+  struct ptw32_inline_thread_t_ * sp;
+
+  if (slot == 0)
+    {
+      int s = pthread_testcancel_slot_np ();
+
+      slot = (s < 0) ? -1 : s + 1;
+    }
+
+  if (slot > 0)
+    {
+      sp = (struct ptw32_inline_thread_t_ *) ptw32_inline_tls_slot (slot - 1);
+
+      /* No struct: nothing can have been sent to the thread */
+      if (sp == NULL || *(volatile long *) &sp->testCancel == 0)
+        {
+          return;
+        }
+    }
+
+  pthread_testcancel ();
+}
+
+#define pthread_testcancel()		ptw32_inline_testcancel ()
+
+#endif /* PTW32_INLINE_TLS_SLOTS */
+
+#define pthread_mutex_lock(mutex)	ptw32_inline_mutex_lock (mutex)
+#define pthread_mutex_trylock(mutex)	ptw32_inline_mutex_trylock (mutex)
+#define pthread_mutex_unlock(mutex)	ptw32_inline_mutex_unlock (mutex)
+#define pthread_spin_lock(lock)		ptw32_inline_spin_lock (lock)
+#define pthread_spin_trylock(lock)	ptw32_inline_spin_trylock (lock)
+#define pthread_spin_unlock(lock)	ptw32_inline_spin_unlock (lock)
+
+#endif /* PTW32_INLINE_LOCKS */
+
 #endif /* ! PTW32_BUILD */
 
 #if defined(__cplusplus)
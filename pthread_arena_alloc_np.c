@@ -0,0 +1,103 @@
+/*
+ * pthread_arena_alloc_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+void *
+pthread_arena_alloc_np (size_t size)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Allocates 'size' bytes of scratch memory from the
+      *      calling thread's arena.
+      *
+      * PARAMETERS
+      *      size
+      *              number of bytes wanted
+      *
+      * DESCRIPTION
+      *      The memory is cut from a block the thread owns, so
+      *      most calls take no lock and don't go to the heap. It
+      *      is aligned to 16 bytes and not initialised. It can't be
+      *      freed on its own: pthread_arena_reset_np() releases
+      *      everything the thread has allocated, and whatever is
+      *      left is freed, with the rest of the thread's resources,
+      *      once the thread has ended and been joined or detached.
+      *      Only the calling thread may reset its arena, but the
+      *      memory may be passed to other threads meanwhile.
+      *
+      *      A thread has no arena until it first calls this.
+      *
+      * RESULTS
+      *              the memory, or NULL if there is not enough.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp;
+  ptw32_arena_block_t * b;
+  char * p;
+
+  if (NULL == (sp = (ptw32_thread_t *) pthread_self ().p)
+      || size > (size_t) -1 - PTW32_ARENA_HEADER - PTW32_ARENA_ALIGN)
+    {
+      return NULL;
+    }
+
+  size = (PTW32_MAX (size, 1) + PTW32_ARENA_ALIGN - 1) & ~((size_t) PTW32_ARENA_ALIGN - 1);
+
+  if (NULL == (b = sp->arena) || b->size - b->used < size)
+    {
+      size_t bytes = PTW32_MAX (PTW32_ARENA_BLOCK_SIZE, PTW32_ARENA_HEADER + size);
+
+      if (NULL == (b = (ptw32_arena_block_t *) malloc (bytes)))
+	{
+	  return NULL;
+	}
+
+      b->size = bytes - PTW32_ARENA_HEADER;
+      b->used = 0;
+      b->prev = sp->arena;
+      sp->arena = b;
+    }
+
+  p = (char *) b + PTW32_ARENA_HEADER + b->used;
+  b->used += size;
+
+  return (void *) p;
+}
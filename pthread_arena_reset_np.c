@@ -0,0 +1,94 @@
+/*
+ * pthread_arena_reset_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_arena_reset_np (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Releases everything the calling thread has allocated
+      *      with pthread_arena_alloc_np().
+      *
+      * PARAMETERS
+      *      N/A
+      *
+      * DESCRIPTION
+      *      All of it becomes invalid at once. The newest block is
+      *      kept for the allocations that follow, so a thread that
+      *      resets its arena after each request it handles stops
+      *      going to the heap once it has one block big enough.
+      *
+      * RESULTS
+      *              0               successful.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) PTW32_SELF_THREAD ();
+
+  if (sp != NULL && sp->arena != NULL)
+    {
+      ptw32_arena_free (sp->arena->prev);
+      sp->arena->prev = NULL;
+      sp->arena->used = 0;
+    }
+
+  return 0;
+}
+
+
+void
+ptw32_arena_free (ptw32_arena_block_t * block)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Frees the arena blocks from 'block' to the oldest.
+      *
+      * ------------------------------------------------------
+      */
+{
+  while (block != NULL)
+    {
+      ptw32_arena_block_t * prev = block->prev;
+
+      free (block);
+      block = prev;
+    }
+}
@@ -0,0 +1,198 @@
+/*
+ * Module: pthread_async_np.hpp
+ *
+ * Purpose:
+ *	C++20 coroutine awaitables for mutexes, condition variables
+ *	and semaphores, built on pthread_mutex_lock_async_np(),
+ *	pthread_cond_wait_async_np() and sem_wait_async_np(). A
+ *	coroutine that has to wait is suspended without holding a
+ *	thread and resumed on a pthread_pool_np_t worker. Threads
+ *	using the blocking functions and coroutines can share the
+ *	same objects.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+#if !defined( PTHREAD_ASYNC_NP_HPP )
+#define PTHREAD_ASYNC_NP_HPP
+
+#if !defined(__cpp_impl_coroutine)
+#error pthread_async_np.hpp requires C++20 coroutines
+#endif
+
+#include <coroutine>
+#include <pthread.h>
+#include <semaphore.h>
+
+namespace ptw32
+{
+
+  /*
+   * The result of co_await is 0, or the error the _async_np function
+   * returned, in which case the coroutine wasn't suspended.
+   */
+  class async_waiter
+  {
+  public:
+    int await_resume () const noexcept { return result_; }
+
+  protected:
+    async_waiter () noexcept : result_ (0) {}
+
+    /*
+     * The coroutine may be resumed, and this object destroyed, before
+     * the _async_np function returns, so nothing is touched after a
+     * successful call.
+     */
+    bool suspended (int result) noexcept
+    {
+      if (result != 0)
+        {
+          result_ = result;
+          return false;
+        }
+      return true;
+    }
+
+    static void PTW32_CDECL resume (void * self)
+    {
+      std::coroutine_handle<> h = static_cast<async_waiter *> (self)->handle_;
+
+      h.resume ();
+    }
+
+    std::coroutine_handle<> handle_;
+    int result_;
+  };
+
+  /*
+   * co_await ptw32::lock (&mutex, pool): resumes owning the mutex,
+   * which must be a non-robust PTHREAD_MUTEX_NORMAL mutex. Unlock
+   * it with pthread_mutex_unlock().
+   */
+  class lock_awaiter : public async_waiter
+  {
+  public:
+    lock_awaiter (pthread_mutex_t * mutex, pthread_pool_np_t pool) noexcept
+      : mutex_ (mutex), pool_ (pool) {}
+
+    bool await_ready () noexcept
+    {
+      return pthread_mutex_trylock (mutex_) == 0;
+    }
+
+    bool await_suspend (std::coroutine_handle<> h) noexcept
+    {
+      handle_ = h;
+      return suspended (pthread_mutex_lock_async_np (mutex_, pool_, resume,
+                                                     static_cast<async_waiter *> (this)));
+    }
+
+  private:
+    pthread_mutex_t * mutex_;
+    pthread_pool_np_t pool_;
+  };
+
+  /*
+   * co_await ptw32::cond_wait (&cond, &mutex, pool): as
+   * pthread_cond_wait(); the caller holds the mutex and resumes
+   * holding it again.
+   */
+  class cond_wait_awaiter : public async_waiter
+  {
+  public:
+    cond_wait_awaiter (pthread_cond_t * cond, pthread_mutex_t * mutex,
+                       pthread_pool_np_t pool) noexcept
+      : cond_ (cond), mutex_ (mutex), pool_ (pool) {}
+
+    bool await_ready () const noexcept { return false; }
+
+    bool await_suspend (std::coroutine_handle<> h) noexcept
+    {
+      handle_ = h;
+      return suspended (pthread_cond_wait_async_np (cond_, mutex_, pool_, resume,
+                                                    static_cast<async_waiter *> (this)));
+    }
+
+  private:
+    pthread_cond_t * cond_;
+    pthread_mutex_t * mutex_;
+    pthread_pool_np_t pool_;
+  };
+
+  /*
+   * co_await ptw32::acquire (&sem, pool): as sem_wait(), returning
+   * the error rather than setting errno.
+   */
+  class sem_awaiter : public async_waiter
+  {
+  public:
+    sem_awaiter (sem_t * sem, pthread_pool_np_t pool) noexcept
+      : sem_ (sem), pool_ (pool) {}
+
+    bool await_ready () noexcept
+    {
+      return sem_trywait_np (sem_) == 0;
+    }
+
+    bool await_suspend (std::coroutine_handle<> h) noexcept
+    {
+      handle_ = h;
+      return suspended (sem_wait_async_np (sem_, pool_, resume,
+                                           static_cast<async_waiter *> (this)));
+    }
+
+  private:
+    sem_t * sem_;
+    pthread_pool_np_t pool_;
+  };
+
+  inline lock_awaiter
+  lock (pthread_mutex_t * mutex, pthread_pool_np_t pool) noexcept
+  {
+    return lock_awaiter (mutex, pool);
+  }
+
+  inline cond_wait_awaiter
+  cond_wait (pthread_cond_t * cond, pthread_mutex_t * mutex,
+             pthread_pool_np_t pool) noexcept
+  {
+    return cond_wait_awaiter (cond, mutex, pool);
+  }
+
+  inline sem_awaiter
+  acquire (sem_t * sem, pthread_pool_np_t pool) noexcept
+  {
+    return sem_awaiter (sem, pool);
+  }
+
+} /* namespace ptw32 */
+
+#endif /* PTHREAD_ASYNC_NP_HPP */
@@ -63,16 +63,42 @@ pthread_attr_destroy (pthread_attr_t * attr)
       * ------------------------------------------------------
       */
 {
+  ptw32_thread_t * sp;
+
   if (ptw32_is_attr (attr) != 0)
     {
       return EINVAL;
     }
 
+  if (PTW32_ATTR_IS_INITIALIZER (*attr))
+    {
+      *attr = NULL;
+      return 0;
+    }
+
   /*
    * Set the attribute object to a specific invalid value.
    */
   (*attr)->valid = 0;
-  free (*attr);
+
+  if ((*attr)->thrname != NULL)
+    {
+      free ((*attr)->thrname);
+    }
+
+  /*
+   * Keep it for this thread's next pthread_attr_init.
+   */
+  sp = PTW32_SELF_THREAD ();
+
+  if (sp != NULL && sp->attrCache == NULL)
+    {
+      sp->attrCache = *attr;
+    }
+  else
+    {
+      ptw32_object_free (*attr);
+    }
   *attr = NULL;
 
   return 0;
@@ -51,7 +51,7 @@ pthread_attr_getaffinity_np (const pthread_attr_t * attr, size_t cpusetsize, cpu
       return EINVAL;
     }
 
-  ((_sched_cpu_set_vector_*)cpuset)->_cpuset = (*attr)->cpuset;
+  ptw32_cpusetcopy (cpuset, cpusetsize, &PTW32_ATTR_READ (*attr, ptw32_attr_default)->cpuset, sizeof (cpu_set_t));
 
   return 0;
 }
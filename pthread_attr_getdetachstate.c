@@ -81,6 +81,6 @@ pthread_attr_getdetachstate (const pthread_attr_t * attr, int *detachstate)
       return EINVAL;
     }
 
-  *detachstate = (*attr)->detachstate;
+  *detachstate = PTW32_ATTR_READ (*attr, ptw32_attr_default)->detachstate;
   return 0;
 }
@@ -0,0 +1,71 @@
+/*
+ * pthread_attr_getguardsize.c
+ *
+ * Description:
+ * This translation unit implements operations on thread attribute objects.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_attr_getguardsize (const pthread_attr_t * attr, size_t * guardsize)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function returns the guard size set with
+      *      pthread_attr_setguardsize().
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_attr_t
+      *
+      *      guardsize
+      *              pointer to size_t into which is returned the
+      *              guard size, in bytes.
+      *
+      * RESULTS
+      *              0               successfully retrieved guard size,
+      *              EINVAL          'attr' or 'guardsize' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (ptw32_is_attr (attr) != 0 || guardsize == NULL)
+    {
+      return EINVAL;
+    }
+
+  *guardsize = PTW32_ATTR_READ (*attr, ptw32_attr_default)->guardsize;
+  return 0;
+}
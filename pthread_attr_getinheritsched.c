@@ -46,6 +46,6 @@ pthread_attr_getinheritsched (const pthread_attr_t * attr, int *inheritsched)
       return EINVAL;
     }
 
-  *inheritsched = (*attr)->inheritsched;
+  *inheritsched = PTW32_ATTR_READ (*attr, ptw32_attr_default)->inheritsched;
   return 0;
 }
@@ -43,6 +43,11 @@
 int
 pthread_attr_getname_np(pthread_attr_t * attr, char *name, int len)
 {
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_attr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
   //strncpy_s(name, len - 1, (*attr)->thrname, len - 1);
 #if defined(_MSVCRT_)
 # pragma warning(suppress:4996)
@@ -47,6 +47,6 @@ pthread_attr_getschedparam (const pthread_attr_t * attr,
       return EINVAL;
     }
 
-  memcpy (param, &(*attr)->param, sizeof (*param));
+  memcpy (param, &PTW32_ATTR_READ (*attr, ptw32_attr_default)->param, sizeof (*param));
   return 0;
 }
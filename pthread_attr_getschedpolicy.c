@@ -46,7 +46,7 @@ pthread_attr_getschedpolicy (const pthread_attr_t * attr, int *policy)
       return EINVAL;
     }
 
-  *policy = SCHED_OTHER;
+  *policy = PTW32_ATTR_READ (*attr, ptw32_attr_default)->schedpolicy;
 
   return 0;
 }
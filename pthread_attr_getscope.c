@@ -46,7 +46,7 @@ int
 pthread_attr_getscope (const pthread_attr_t * attr, int *contentionscope)
 {
 #if defined(_POSIX_THREAD_PRIORITY_SCHEDULING)
-  *contentionscope = (*attr)->contentionscope;
+  *contentionscope = PTW32_ATTR_READ (*attr, ptw32_attr_default)->contentionscope;
   return 0;
 #else
   return ENOSYS;
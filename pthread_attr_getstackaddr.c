@@ -91,7 +91,7 @@ pthread_attr_getstackaddr (const pthread_attr_t * attr, void **stackaddr)
       return EINVAL;
     }
 
-  *stackaddr = (*attr)->stackaddr;
+  *stackaddr = PTW32_ATTR_READ (*attr, ptw32_attr_default)->stackaddr;
   return 0;
 
 #else
@@ -93,7 +93,7 @@ pthread_attr_getstacksize (const pthread_attr_t * attr, size_t * stacksize)
     }
 
   /* Everything is okay. */
-  *stacksize = (*attr)->stacksize;
+  *stacksize = PTW32_ATTR_READ (*attr, ptw32_attr_default)->stacksize;
   return 0;
 
 #else
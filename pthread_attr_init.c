@@ -71,7 +71,7 @@ pthread_attr_init (pthread_attr_t * attr)
       */
 {
   pthread_attr_t attr_result;
-  cpu_set_t cpuset;
+  ptw32_thread_t * sp;
 
   if (attr == NULL)
     {
@@ -79,9 +79,19 @@ pthread_attr_init (pthread_attr_t * attr)
       return EINVAL;
     }
 
-  attr_result = (pthread_attr_t) malloc (sizeof (*attr_result));
+  /*
+   * Take the last attribute object this thread destroyed, if any,
+   * so that an init/create/destroy cycle doesn't touch the heap.
+   * Threads that aren't POSIX threads yet aren't given a struct.
+   */
+  sp = PTW32_SELF_THREAD ();
 
-  if (attr_result == NULL)
+  if (sp != NULL && sp->attrCache != NULL)
+    {
+      attr_result = sp->attrCache;
+      sp->attrCache = NULL;
+    }
+  else if ((attr_result = (pthread_attr_t) ptw32_object_alloc (sizeof (*attr_result), 0)) == NULL)
     {
       return ENOMEM;
     }
@@ -94,6 +104,8 @@ pthread_attr_init (pthread_attr_t * attr)
    */
   attr_result->stacksize = 0;
 #endif
+  attr_result->stackcommit = 0;
+  attr_result->guardsize = PTW32_STACK_PAGE;
 
 #if defined(_POSIX_THREAD_ATTR_STACKADDR)
   /* FIXME: Set this to something sensible when we support it. */
@@ -112,10 +124,13 @@ pthread_attr_init (pthread_attr_t * attr)
    * this arrangement.
    */
   attr_result->param.sched_priority = THREAD_PRIORITY_NORMAL;
+  attr_result->schedpolicy = SCHED_OTHER;
   attr_result->inheritsched = PTHREAD_EXPLICIT_SCHED;
   attr_result->contentionscope = PTHREAD_SCOPE_SYSTEM;
-  CPU_ZERO(&cpuset);
-  attr_result->cpuset = ((_sched_cpu_set_vector_*)&cpuset)->_cpuset;
+  CPU_ZERO(&attr_result->cpuset);
+  attr_result->qos = PTHREAD_QOS_DEFAULT_NP;
+  attr_result->numanode = -1;
+  attr_result->pooled = PTW32_FALSE;
   attr_result->thrname = NULL;
 
   attr_result->valid = PTW32_ATTR_VALID;
@@ -46,12 +46,17 @@
 int
 pthread_attr_setaffinity_np (pthread_attr_t * attr, size_t cpusetsize, const cpu_set_t * cpuset)
 {
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_attr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
   if (ptw32_is_attr (attr) != 0 || cpuset == NULL)
     {
       return EINVAL;
     }
 
-  (*attr)->cpuset = ((_sched_cpu_set_vector_*)cpuset)->_cpuset;
+  ptw32_cpusetcopy (&(*attr)->cpuset, sizeof (cpu_set_t), cpuset, cpusetsize);
 
   return 0;
 }
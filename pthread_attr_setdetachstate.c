@@ -75,6 +75,11 @@ pthread_attr_setdetachstate (pthread_attr_t * attr, int detachstate)
       * ------------------------------------------------------
       */
 {
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_attr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
   if (ptw32_is_attr (attr) != 0)
     {
       return EINVAL;
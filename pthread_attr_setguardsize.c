@@ -0,0 +1,87 @@
+/*
+ * pthread_attr_setguardsize.c
+ *
+ * Description:
+ * This translation unit implements operations on thread attribute objects.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_attr_setguardsize (pthread_attr_t * attr, size_t guardsize)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function sets the size of the guard area below
+      *      the stack of threads created with 'attr'.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_attr_t
+      *
+      *      guardsize
+      *              guard size, in bytes.
+      *
+      *
+      * DESCRIPTION
+      *      The system always keeps one guard page below a
+      *      thread's stack. A larger guard size is reserved
+      *      beyond the stack size and kept for the thread with
+      *      SetThreadStackGuarantee, so that a stack overflow
+      *      still has that much stack to be handled on. The
+      *      default is one page; 0 and sizes up to a page give
+      *      the system's guard page alone.
+      *      Threads with a stack of their own from
+      *      pthread_attr_setstack() ignore it.
+      *
+      * RESULTS
+      *              0               successfully set guard size,
+      *              EINVAL          'attr' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_attr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
+  if (ptw32_is_attr (attr) != 0)
+    {
+      return EINVAL;
+    }
+
+  (*attr)->guardsize = guardsize;
+  return 0;
+}
@@ -41,6 +41,11 @@
 int
 pthread_attr_setinheritsched (pthread_attr_t * attr, int inheritsched)
 {
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_attr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
   if (ptw32_is_attr (attr) != 0)
     {
       return EINVAL;
@@ -51,6 +51,11 @@ pthread_attr_setname_np(pthread_attr_t * attr, const char *name, void *arg)
   char * newname;
   char * oldname;
 
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_attr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
   /*
    * According to the MSDN description for snprintf()
    * where count is the second parameter:
@@ -85,6 +90,11 @@ pthread_attr_setname_np(pthread_attr_t * attr, const char *name)
   char * newname;
   char * oldname;
 
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_attr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
   newname = _strdup(name);
 
   oldname = (*attr)->thrname;
@@ -0,0 +1,98 @@
+/*
+ * pthread_attr_setnumanode_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_attr_setnumanode_np (pthread_attr_t * attr, int node)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets the NUMA node that threads created with attr
+      *      are placed on.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_attr_t
+      *
+      *      node
+      *              a NUMA node number, or -1 for no node
+      *
+      * DESCRIPTION
+      *      A thread created with a node runs on the CPUs of that
+      *      node. If attr also has a CPU set that shares CPUs
+      *      with the node, the thread runs on the shared CPUs
+      *      only.
+      *
+      * RESULTS
+      *              0               successfully set the node,
+      *              EINVAL          'attr' or 'node' is invalid,
+      *              ENOMEM          no memory for the topology.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_attr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
+  if (ptw32_is_attr (attr) != 0 || node < -1)
+    {
+      return EINVAL;
+    }
+
+  if (node >= 0)
+    {
+      ptw32_topology_t * topology = ptw32_gettopology ();
+
+      if (NULL == topology)
+	{
+	  return ENOMEM;
+	}
+
+      if (node >= topology->nNodes)
+	{
+	  return EINVAL;
+	}
+    }
+
+  (*attr)->numanode = node;
+
+  return 0;
+}
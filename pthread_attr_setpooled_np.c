@@ -0,0 +1,91 @@
+/*
+ * pthread_attr_setpooled_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_attr_setpooled_np (pthread_attr_t * attr, int pooled)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets whether detached threads created with attr run
+      *      on the library's thread pool.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_attr_t
+      *
+      *      pooled
+      *              non-zero to run threads on the thread pool,
+      *              zero (the default) to give each its own OS
+      *              thread
+      *
+      * DESCRIPTION
+      *      A pooled thread runs as a work item of a private
+      *      system thread pool instead of on an OS thread created
+      *      for it, and the pool's worker is its OS thread until
+      *      it ends. The attribute only applies to detached
+      *      threads that aren't created suspended and have none of
+      *      a stack, a stack size, a CPU set, a NUMA node, a QoS
+      *      or PTHREAD_SCOPE_PROCESS in their attributes; others,
+      *      and all threads where the system has no thread pool
+      *      API, get an OS thread as usual. A pooled thread runs
+      *      with its worker's CPU affinity rather than its
+      *      creator's.
+      *
+      * RESULTS
+      *              0               successfully set the attribute,
+      *              EINVAL          'attr' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_attr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
+  if (ptw32_is_attr (attr) != 0)
+    {
+      return EINVAL;
+    }
+
+  (*attr)->pooled = (pooled != 0);
+
+  return 0;
+}
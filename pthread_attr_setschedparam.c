@@ -44,6 +44,11 @@ pthread_attr_setschedparam (pthread_attr_t * attr,
 {
   int priority;
 
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_attr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
   if (ptw32_is_attr (attr) != 0 || param == NULL)
     {
       return EINVAL;
@@ -52,8 +57,8 @@ pthread_attr_setschedparam (pthread_attr_t * attr,
   priority = param->sched_priority;
 
   /* Validate priority level. */
-  if (priority < sched_get_priority_min (SCHED_OTHER) ||
-      priority > sched_get_priority_max (SCHED_OTHER))
+  if (priority < sched_get_priority_min ((*attr)->schedpolicy) ||
+      priority > sched_get_priority_max ((*attr)->schedpolicy))
     {
       return EINVAL;
     }
@@ -41,15 +41,29 @@
 int
 pthread_attr_setschedpolicy (pthread_attr_t * attr, int policy)
 {
-  if (ptw32_is_attr (attr) != 0)
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_attr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
+  if (ptw32_is_attr (attr) != 0 || policy < SCHED_MIN || policy > SCHED_MAX)
     {
       return EINVAL;
     }
 
-  if (policy != SCHED_OTHER)
+  /*
+   * Keep the priority valid for the new policy, as
+   * pthread_attr_setschedparam() only accepts one that is.
+   */
+  if ((*attr)->param.sched_priority < sched_get_priority_min (policy)
+      || (*attr)->param.sched_priority > sched_get_priority_max (policy))
     {
-      return ENOTSUP;
+      (*attr)->param.sched_priority = (SCHED_OTHER == policy
+				       ? THREAD_PRIORITY_NORMAL
+				       : sched_get_priority_min (policy));
     }
 
+  (*attr)->schedpolicy = policy;
+
   return 0;
 }
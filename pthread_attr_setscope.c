@@ -46,13 +46,23 @@ int
 pthread_attr_setscope (pthread_attr_t * attr, int contentionscope)
 {
 #if defined(_POSIX_THREAD_PRIORITY_SCHEDULING)
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_attr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
   switch (contentionscope)
     {
     case PTHREAD_SCOPE_SYSTEM:
       (*attr)->contentionscope = contentionscope;
       return 0;
     case PTHREAD_SCOPE_PROCESS:
+#if defined(PTW32_FIBER_THREADS)
+      (*attr)->contentionscope = contentionscope;
+      return 0;
+#else
       return ENOTSUP;
+#endif
     default:
       return EINVAL;
     }
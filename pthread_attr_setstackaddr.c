@@ -76,6 +76,12 @@ pthread_attr_setstackaddr (pthread_attr_t * attr, void *stackaddr)
       *
       *              3)      Ensure that stackaddr is aligned.
       *
+      *              4)      'stackaddr' is the lowest address of the
+      *                      stack and its size is the one set by
+      *                      pthread_attr_setstacksize. pthread_create
+      *                      fails with EINVAL if that is too small.
+      *                      pthread_attr_setstack sets both at once.
+      *
       * RESULTS
       *              0               successfully set stack address,
       *              EINVAL          'attr' is invalid
@@ -85,6 +91,10 @@ pthread_attr_setstackaddr (pthread_attr_t * attr, void *stackaddr)
       */
 {
 #if defined( _POSIX_THREAD_ATTR_STACKADDR ) && _POSIX_THREAD_ATTR_STACKADDR != -1
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_attr_init) != 0)
+    {
+      return ENOMEM;
+    }
 
   if (ptw32_is_attr (attr) != 0)
     {
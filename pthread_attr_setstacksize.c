@@ -76,6 +76,10 @@ pthread_attr_setstacksize (pthread_attr_t * attr, size_t stacksize)
       *              3)      Only use if thread needs more than the
       *                      default.
       *
+      *              4)      The stack is only reserved, and is
+      *                      committed as the thread uses it. See
+      *                      pthread_attr_setstackcommit_np.
+      *
       * RESULTS
       *              0               successfully set stack size,
       *              EINVAL          'attr' is invalid or stacksize too
@@ -86,6 +90,10 @@ pthread_attr_setstacksize (pthread_attr_t * attr, size_t stacksize)
       */
 {
 #if defined(_POSIX_THREAD_ATTR_STACKSIZE) && _POSIX_THREAD_ATTR_STACKSIZE != -1
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_attr_init) != 0)
+    {
+      return ENOMEM;
+    }
 
 #if PTHREAD_STACK_MIN > 0
 
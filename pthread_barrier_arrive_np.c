@@ -0,0 +1,192 @@
+/*
+ * pthread_barrier_arrive_np.c
+ *
+ * Description:
+ * This translation unit implements barrier primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_barrier_arrive_np (pthread_barrier_t * barrier, unsigned int * token)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Arrives at a barrier without waiting for the other
+      *      threads: the first half of pthread_barrier_wait().
+      *
+      * PARAMETERS
+      *      barrier
+      *              pointer to an instance of pthread_barrier_t
+      *
+      *      token
+      *              where the cycle arrived at is returned, to pass
+      *              to pthread_barrier_wait_token_np()
+      *
+      * DESCRIPTION
+      *      The calling thread counts as arrived at the barrier's
+      *      current cycle and may go on with work that doesn't
+      *      depend on the other threads. It must then call
+      *      pthread_barrier_wait_token_np() with the token, once,
+      *      before it arrives at the barrier again. Arrivals of
+      *      this kind and calls to pthread_barrier_wait() may be
+      *      mixed in one cycle.
+      *
+      * RESULTS
+      *              PTHREAD_BARRIER_SERIAL_THREAD
+      *                              for the last thread to arrive,
+      *              0               for the others,
+      *              EINVAL          'barrier' or 'token' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_barrier_t b;
+  ptw32_mcs_local_node_t node;
+  LONG cycle;
+  int result;
+
+  if (barrier == NULL || *barrier == (pthread_barrier_t) PTW32_OBJECT_INVALID
+      || token == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (PTW32_IS_PSHARED (*barrier))
+    {
+      result = ptw32_pshared_barrier_arrive (*barrier, &cycle);
+      *token = (unsigned int) cycle;
+      return result;
+    }
+
+  if ((*barrier)->kind != PTHREAD_BARRIER_DEFAULT_NP)
+    {
+      result = ptw32_barrier_tree_arrive (*barrier, &cycle);
+      *token = (unsigned int) cycle;
+      return result;
+    }
+
+  ptw32_mcs_lock_acquire(&(*barrier)->lock, &node);
+
+  b = *barrier;
+  *token = (unsigned int) b->cycle;
+
+  if (--b->nCurrentBarrierHeight == 0)
+    {
+      /*
+       * As in pthread_barrier_wait(), except that we also release
+       * ourself: every split arrival takes a semaphore unit in
+       * pthread_barrier_wait_token_np(), and the last of them out
+       * releases the lock.
+       */
+      ptw32_mcs_node_transfer(&b->proxynode, &node);
+      b->cycle++;
+
+      if (0 != sem_post_multiple (&(b->semBarrierBreeched),
+				  (int) b->nInitialBarrierHeight))
+	{
+	  return EINVAL;
+	}
+
+      return PTHREAD_BARRIER_SERIAL_THREAD;
+    }
+
+  ptw32_mcs_lock_release(&node);
+
+  return 0;
+}				/* pthread_barrier_arrive_np */
+
+
+int
+pthread_barrier_wait_token_np (pthread_barrier_t * barrier, unsigned int token)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits for the barrier to release the cycle that
+      *      pthread_barrier_arrive_np() arrived at: the second
+      *      half of pthread_barrier_wait().
+      *
+      * PARAMETERS
+      *      barrier
+      *              pointer to an instance of pthread_barrier_t
+      *
+      *      token
+      *              as returned by pthread_barrier_arrive_np()
+      *
+      * DESCRIPTION
+      *      Returns once every thread has arrived at the cycle,
+      *      at once if they already have. Not a cancellation
+      *      point, like pthread_barrier_wait().
+      *
+      * RESULTS
+      *              0               the cycle is complete,
+      *              EINVAL          'barrier' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_barrier_t b;
+  int result;
+
+  if (barrier == NULL || *barrier == (pthread_barrier_t) PTW32_OBJECT_INVALID)
+    {
+      return EINVAL;
+    }
+
+  if (PTW32_IS_PSHARED (*barrier))
+    {
+      return ptw32_pshared_barrier_wait_cycle (*barrier, (LONG) token);
+    }
+
+  b = *barrier;
+
+  if (b->kind != PTHREAD_BARRIER_DEFAULT_NP)
+    {
+      ptw32_barrier_park (&b->cycle, (LONG) token, &b->nParked);
+      return 0;
+    }
+
+  result = ptw32_semwait (&(b->semBarrierBreeched));
+
+  if ((PTW32_INTERLOCKED_LONG)PTW32_INTERLOCKED_INCREMENT_LONG((PTW32_INTERLOCKED_LONGPTR)&b->nCurrentBarrierHeight)
+		  == (PTW32_INTERLOCKED_LONG)b->nInitialBarrierHeight)
+    {
+      /*
+       * We are the last thread to cross this barrier
+       */
+      ptw32_mcs_lock_release(&b->proxynode);
+    }
+
+  return (result);
+}				/* pthread_barrier_wait_token_np */
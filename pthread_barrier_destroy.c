@@ -49,6 +49,24 @@ pthread_barrier_destroy (pthread_barrier_t * barrier)
       return EINVAL;
     }
 
+  if (PTW32_IS_PSHARED (*barrier))
+    {
+      return ptw32_pshared_barrier_destroy (barrier);
+    }
+
+  if ((*barrier)->kind != PTHREAD_BARRIER_DEFAULT_NP)
+    {
+      b = *barrier;
+
+      if (0 == (result = ptw32_barrier_tree_destroy (b)))
+	{
+	  *barrier = (pthread_barrier_t) PTW32_OBJECT_INVALID;
+	  ptw32_object_free (b);
+	}
+
+      return (result);
+    }
+
   if (0 != ptw32_mcs_lock_try_acquire(&(*barrier)->lock, &node))
     {
       return EBUSY;
@@ -76,7 +94,7 @@ pthread_barrier_destroy (pthread_barrier_t * barrier)
            * and will require a major version number increment.
            */
           ptw32_mcs_lock_release(&node);
-	  (void) free (b);
+	  ptw32_object_free (b);
 	  return 0;
 	}
       else
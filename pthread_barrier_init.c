@@ -49,20 +49,52 @@ pthread_barrier_init (pthread_barrier_t * barrier,
       return EINVAL;
     }
 
-  if (NULL != (b = (pthread_barrier_t) calloc (1, sizeof (*b))))
+  if (attr != NULL && PTW32_ATTR_IS_INITIALIZER (*attr))
+    {
+      attr = NULL;
+    }
+
+  if (attr != NULL && *attr != NULL
+      && (*attr)->pshared == PTHREAD_PROCESS_SHARED)
+    {
+      /*
+       * See ptw32_pshared_barrier.c. Process shared barriers are
+       * never tree barriers.
+       */
+      return ptw32_pshared_barrier_init (barrier, count);
+    }
+
+  if (NULL != (b = (pthread_barrier_t) ptw32_object_alloc (sizeof (*b), ptw32_objectAlign)))
     {
       b->pshared = (attr != NULL && *attr != NULL
 		    ? (*attr)->pshared : PTHREAD_PROCESS_PRIVATE);
 
       b->nCurrentBarrierHeight = b->nInitialBarrierHeight = count;
       b->lock = 0;
+      b->kind = PTHREAD_BARRIER_DEFAULT_NP;
 
-      if (0 == sem_init (&(b->semBarrierBreeched), b->pshared, 0))
+      /*
+       * The tree barrier parks waiters with WaitOnAddress, which
+       * only works within a process.
+       */
+      if (attr != NULL && *attr != NULL
+	  && (*attr)->kind == PTHREAD_BARRIER_TREE_NP
+	  && b->pshared == PTHREAD_PROCESS_PRIVATE
+	  && ptw32_waitonaddress != NULL)
+	{
+	  if (0 == ptw32_barrier_tree_init (b, count))
+	    {
+	      b->kind = PTHREAD_BARRIER_TREE_NP;
+	      *barrier = b;
+	      return 0;
+	    }
+	}
+      else if (0 == sem_init (&(b->semBarrierBreeched), b->pshared, 0))
 	    {
 	      *barrier = b;
 	      return 0;
 	    }
-      (void) free (b);
+      ptw32_object_free (b);
     }
 
   return ENOMEM;
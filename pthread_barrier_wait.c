@@ -51,6 +51,16 @@ pthread_barrier_wait (pthread_barrier_t * barrier)
       return EINVAL;
     }
 
+  if (PTW32_IS_PSHARED (*barrier))
+    {
+      return ptw32_pshared_barrier_wait (*barrier);
+    }
+
+  if ((*barrier)->kind != PTHREAD_BARRIER_DEFAULT_NP)
+    {
+      return ptw32_barrier_tree_wait (*barrier);
+    }
+
   ptw32_mcs_lock_acquire(&(*barrier)->lock, &node);
 
   b = *barrier;
@@ -62,6 +72,7 @@ pthread_barrier_wait (pthread_barrier_t * barrier)
        * last thread out (not necessarily us) can release the lock.
        */
       ptw32_mcs_node_transfer(&b->proxynode, &node);
+      b->cycle++;
 
       /*
        * Any threads that have not quite entered sem_wait below when the
@@ -76,7 +76,10 @@ pthread_barrierattr_destroy (pthread_barrierattr_t * attr)
       pthread_barrierattr_t ba = *attr;
 
       *attr = NULL;
-      free (ba);
+      if (!PTW32_ATTR_IS_INITIALIZER (ba))
+	{
+	  ptw32_object_free (ba);
+	}
     }
 
   return (result);
@@ -83,7 +83,7 @@ pthread_barrierattr_getpshared (const pthread_barrierattr_t * attr,
 
   if ((attr != NULL && *attr != NULL) && (pshared != NULL))
     {
-      *pshared = (*attr)->pshared;
+      *pshared = PTW32_ATTR_READ (*attr, ptw32_barrierattr_default)->pshared;
       result = 0;
     }
   else
@@ -68,7 +68,7 @@ pthread_barrierattr_init (pthread_barrierattr_t * attr)
   pthread_barrierattr_t ba;
   int result = 0;
 
-  ba = (pthread_barrierattr_t) calloc (1, sizeof (*ba));
+  ba = (pthread_barrierattr_t) ptw32_object_alloc (sizeof (*ba), 0);
 
   if (ba == NULL)
     {
@@ -77,6 +77,7 @@ pthread_barrierattr_init (pthread_barrierattr_t * attr)
   else
     {
       ba->pshared = PTHREAD_PROCESS_PRIVATE;
+      ba->kind = PTHREAD_BARRIER_DEFAULT_NP;
     }
 
   *attr = ba;
@@ -0,0 +1,96 @@
+/*
+ * pthread_barrierattr_setkind_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_barrierattr_setkind_np (pthread_barrierattr_t * attr, int kind)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Selects the implementation of barriers initialised
+      *      with 'attr'.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_barrierattr_t
+      *
+      *      kind
+      *              one of:
+      *
+      *              PTHREAD_BARRIER_DEFAULT_NP (default)
+      *                      arrivals are counted under an
+      *                      internal lock and waiters are released
+      *                      through a semaphore.
+      *
+      *              PTHREAD_BARRIER_TREE_NP
+      *                      a combining tree barrier. Arrivals are
+      *                      counted in small groups, each in its
+      *                      own cache line, and waiters poll for the
+      *                      release for a while before they block.
+      *
+      * DESCRIPTION
+      *      PTHREAD_BARRIER_TREE_NP suits many threads that meet
+      *      at a barrier often, each arriving after a short time.
+      *      It needs WaitOnAddress (Windows 8 and later); without
+      *      it, or for process-shared barriers, the default
+      *      implementation is used.
+      *
+      * RESULTS
+      *              0               successfully set attribute,
+      *              EINVAL          'attr' or 'kind' is invalid,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_barrierattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
+  if (attr == NULL || *attr == NULL
+      || kind < PTHREAD_BARRIER_DEFAULT_NP
+      || kind > PTHREAD_BARRIER_TREE_NP)
+    {
+      return EINVAL;
+    }
+
+  (*attr)->kind = kind;
+
+  return 0;
+}				/* pthread_barrierattr_setkind_np */
@@ -83,6 +83,11 @@ pthread_barrierattr_setpshared (pthread_barrierattr_t * attr, int pshared)
 {
   int result;
 
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_barrierattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
   if ((attr != NULL && *attr != NULL) &&
       ((pshared == PTHREAD_PROCESS_SHARED) ||
        (pshared == PTHREAD_PROCESS_PRIVATE)))
@@ -0,0 +1,214 @@
+/*
+ * pthread_call_rcu_np.c
+ *
+ * Description:
+ * This translation unit implements read-copy-update primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+static void * PTW32_CDECL
+ptw32_rcu_worker (void * arg)
+{
+  /*
+   * Runs the queued callbacks a batch at a time, each batch after a
+   * grace period that began once all of it was queued. Nothing cancels
+   * this thread, and with cancellation disabled its condition variable
+   * waits skip the cleanup handler.
+   */
+  (void) pthread_setcancelstate (PTHREAD_CANCEL_DISABLE, NULL);
+
+  for (;;)
+    {
+      pthread_rcu_head_np_t * batch;
+      unsigned __int64 n = 0;
+
+      (void) pthread_mutex_lock (&ptw32_rcuCallbackLock);
+      while (ptw32_rcuCallbacks == NULL)
+	{
+	  (void) pthread_cond_wait (&ptw32_rcuCallbackCond, &ptw32_rcuCallbackLock);
+	}
+      batch = ptw32_rcuCallbacks;
+      ptw32_rcuCallbacks = NULL;
+      ptw32_rcuCallbackTail = &ptw32_rcuCallbacks;
+      (void) pthread_mutex_unlock (&ptw32_rcuCallbackLock);
+
+      (void) pthread_rcu_synchronize_np ();
+
+      while (batch != NULL)
+	{
+	  pthread_rcu_head_np_t * head = batch;
+
+	  batch = head->next;
+	  head->func (head);
+	  n++;
+	}
+
+      (void) pthread_mutex_lock (&ptw32_rcuCallbackLock);
+      ptw32_rcuDone += n;
+      (void) pthread_cond_broadcast (&ptw32_rcuCallbackCond);
+      (void) pthread_mutex_unlock (&ptw32_rcuCallbackLock);
+    }
+
+  return NULL;
+}
+
+
+int
+pthread_call_rcu_np (pthread_rcu_head_np_t * head,
+		     void (PTW32_CDECL * func) (pthread_rcu_head_np_t *))
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Has 'func' called with 'head' after an RCU grace
+      *      period.
+      *
+      * PARAMETERS
+      *      head
+      *              a pthread_rcu_head_np_t, usually a member of
+      *              the object to reclaim
+      *
+      *      func
+      *              called on a library thread with 'head' once
+      *              no reader can hold a reference to the object
+      *
+      * DESCRIPTION
+      *      Returns at once. The callbacks are run in turn on one
+      *      thread, started by the first call, and should be
+      *      short; they may call pthread_call_rcu_np() but not
+      *      pthread_rcu_barrier_np().
+      *
+      * RESULTS
+      *              0               the callback is queued,
+      *              EINVAL          'head' or 'func' is NULL,
+      *              EAGAIN          the thread couldn't be started.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result = 0;
+
+  if (head == NULL || func == NULL)
+    {
+      return EINVAL;
+    }
+
+  (void) pthread_mutex_lock (&ptw32_rcuCallbackLock);
+
+  if (!ptw32_rcuWorkerStarted)
+    {
+      pthread_attr_t attr;
+      pthread_t t;
+
+      if (0 == (result = pthread_attr_init (&attr)))
+	{
+	  (void) pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+	  if (0 == (result = pthread_create (&t, &attr, ptw32_rcu_worker, NULL)))
+	    {
+	      ptw32_rcuWorkerStarted = PTW32_TRUE;
+	    }
+	  (void) pthread_attr_destroy (&attr);
+	}
+    }
+
+  if (0 == result)
+    {
+      head->func = func;
+      head->next = NULL;
+      *ptw32_rcuCallbackTail = head;
+      ptw32_rcuCallbackTail = &head->next;
+      ptw32_rcuQueued++;
+
+      /* The worker shares the condition with pthread_rcu_barrier_np */
+      (void) pthread_cond_broadcast (&ptw32_rcuCallbackCond);
+    }
+  else
+    {
+      result = EAGAIN;
+    }
+
+  (void) pthread_mutex_unlock (&ptw32_rcuCallbackLock);
+
+  return result;
+}				/* pthread_call_rcu_np */
+
+
+int
+pthread_rcu_barrier_np (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits until the callbacks queued with
+      *      pthread_call_rcu_np() before the call have run.
+      *
+      * DESCRIPTION
+      *      For instance before unloading the code of a callback.
+      *      If the calling thread is an online reader it is
+      *      offline while it waits. Must not be called from a
+      *      callback.
+      *
+      * RESULTS
+      *              0               always.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+  ptw32_rcu_reader_t * self = (sp != NULL) ? sp->rcuReader : NULL;
+  unsigned __int64 target;
+
+  if (self != NULL && self->ctr != 0)
+    {
+      PTW32_RCU_OFFLINE (self);
+    }
+  else
+    {
+      self = NULL;
+    }
+
+  (void) pthread_mutex_lock (&ptw32_rcuCallbackLock);
+  target = ptw32_rcuQueued;
+  while (ptw32_rcuDone < target)
+    {
+      (void) pthread_cond_wait (&ptw32_rcuCallbackCond, &ptw32_rcuCallbackLock);
+    }
+  (void) pthread_mutex_unlock (&ptw32_rcuCallbackLock);
+
+  if (self != NULL)
+    {
+      PTW32_RCU_ONLINE (self);
+    }
+
+  return 0;
+}				/* pthread_rcu_barrier_np */
@@ -91,15 +91,13 @@ pthread_cancel (pthread_t thread)
       * RESULTS
       *              0               successfully requested cancellation,
       *              ESRCH           no thread found corresponding to 'thread',
-      *              ENOMEM          implicit self thread create failed.
+      *              ENOMEM          implicit self thread or the thread's
+      *                              cancel event create failed.
       * ------------------------------------------------------
       */
 {
   int result;
-  int cancel_self;
   pthread_t self;
-  ptw32_thread_t * tp;
-  ptw32_mcs_local_node_t stateLock;
 
   result = pthread_kill (thread, 0);
 
@@ -113,24 +111,59 @@ pthread_cancel (pthread_t thread)
       return ENOMEM;
     };
 
+  if (!pthread_equal (thread, self))
+    {
+      ptw32_cancel_initialize ();
+    }
+
   /*
    * For self cancellation we need to ensure that a thread can't
    * deadlock itself trying to cancel itself asynchronously
    * (pthread_cancel is required to be an async-cancel
    * safe function).
    */
-  cancel_self = pthread_equal (thread, self);
+  return ptw32_cancel_thread ((ptw32_thread_t *) thread.p,
+			      pthread_equal (thread, self));
+}
+
 
-  tp = (ptw32_thread_t *) thread.p;
+int
+ptw32_cancel_thread (ptw32_thread_t * tp, int cancel_self)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Requests cancellation of thread tp, which the caller
+      *      has found valid and keeps from being reused. A
+      *      thread cancelling itself asynchronously doesn't
+      *      return.
+      *
+      * RESULTS
+      *              as pthread_cancel().
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result = 0;
+  int abortIo = 0;
+  HANDLE cancelEvent;
+  ptw32_mcs_local_node_t stateLock;
 
   /*
    * Lock for async-cancel safety.
    */
   ptw32_mcs_lock_acquire (&tp->stateLock, &stateLock);
 
+  tp->cancelRequests++;
+  PTW32_LIBSTAT_ADD (PTW32_LIBSTAT_CANCELS, 1);
+
+  /*
+   * Another thread can't interrupt a fiber, which has no OS thread of
+   * its own, so asynchronous cancellation of one is deferred.
+   */
   if (tp->cancelType == PTHREAD_CANCEL_ASYNCHRONOUS
       && tp->cancelState == PTHREAD_CANCEL_ENABLE
-      && tp->state < PThreadStateCanceling)
+      && tp->state < PThreadStateCanceling
+      && (cancel_self || NULL == tp->fiber.handle))
     {
       if (cancel_self)
 	{
@@ -142,9 +175,29 @@ pthread_cancel (pthread_t thread)
 
 	  /* Never reached */
 	}
+      else if (ptw32_queueuserapc2 != NULL)
+	{
+	  HANDLE threadH = PTW32_THREAD_HANDLE (tp);
+
+	  /*
+	   * A special user APC interrupts the thread wherever it is,
+	   * alertable or not, so there is no need to suspend it and
+	   * redirect its context; suspending a thread that holds a
+	   * lock such as the process heap lock stalls every thread
+	   * that wants it.
+	   */
+	  if (WaitForSingleObject (threadH, 0) == WAIT_TIMEOUT)
+	    {
+	      tp->state = PThreadStateCanceling;
+	      tp->cancelState = PTHREAD_CANCEL_DISABLE;
+	      (void) ptw32_queueuserapc2 ((PAPCFUNC)ptw32_cancel_callback, threadH, 0,
+					  QUEUE_USER_APC_FLAGS_SPECIAL_USER_APC);
+	    }
+	  ptw32_mcs_lock_release (&stateLock);
+	}
       else
 	{
-	  HANDLE threadH = tp->threadH;
+	  HANDLE threadH = PTW32_THREAD_HANDLE (tp);
 
 	  SuspendThread (threadH);
 
@@ -172,10 +225,40 @@ pthread_cancel (pthread_t thread)
       if (tp->state < PThreadStateCancelPending)
 	{
 	  tp->state = PThreadStateCancelPending;
-	  if (!SetEvent (tp->cancelEvent))
+	  if (tp->cancelState == PTHREAD_CANCEL_ENABLE)
+	    {
+	      ptw32_testcancel_raise (tp, PTW32_TESTCANCEL_CANCEL);
+	      abortIo = !cancel_self;
+	    }
+	  if (ptw32_wakebyaddressall != NULL)
+	    {
+	      /* See pthread_delay_np */
+	      ptw32_wakebyaddressall ((PVOID) &tp->state);
+	    }
+	  if (NULL == (cancelEvent = ptw32_cancel_event (tp)))
+	    {
+	      result = ENOMEM;
+	    }
+	  else if (!PTW32_SETEVENT (cancelEvent))
 	    {
 	      result = ESRCH;
 	    }
+	  else if (tp->waitAddress != NULL)
+	    {
+	      /* See pthread_wait_on_address_np */
+	      ptw32_wakebyaddressall ((PVOID) tp->waitAddress);
+	    }
+#if defined(PTW32_COND_WAITONADDRESS)
+	  else if (tp->condWaitAddress != NULL)
+	    {
+	      /*
+	       * The thread is in (or entering) a condition variable wait.
+	       * Bump the sequence so that the wait can't miss this wakeup.
+	       */
+	      (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) tp->condWaitAddress);
+	      ptw32_wakebyaddressall ((PVOID) tp->condWaitAddress);
+	    }
+#endif
 	}
       else if (tp->state >= PThreadStateCanceling)
 	{
@@ -183,7 +266,56 @@ pthread_cancel (pthread_t thread)
 	}
 
       ptw32_mcs_lock_release (&stateLock);
+
+      if (0 == result && abortIo)
+	{
+	  /* See pthread_io_begin_np */
+	  ptw32_cancel_io (tp);
+	}
     }
 
   return (result);
 }
+
+
+HANDLE
+ptw32_cancel_event (ptw32_thread_t * tp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns the manual-reset event that pthread_cancel()
+      *      sets for thread tp, creating it the first time it is
+      *      needed: by a cancelable wait made with cancellation
+      *      enabled or by a deferred cancel. Most threads are
+      *      never cancelled, so most never hold one. The canceller
+      *      and the thread may race to create it; the loser
+      *      closes its own.
+      *
+      * RESULTS
+      *              the event, or NULL if it cannot be created.
+      *
+      * ------------------------------------------------------
+      */
+{
+  HANDLE cancelEvent = tp->cancelEvent;
+
+  if (NULL == cancelEvent)
+    {
+      cancelEvent = ptw32_libstat_handle (CreateEvent (0, (int) PTW32_TRUE,	/* manualReset  */
+						       (int) PTW32_FALSE,	/* setSignaled  */
+						       NULL),
+					  PTW32_LIBSTAT_EVENTS);
+
+      if (NULL != cancelEvent
+	  && NULL != (HANDLE) PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &tp->cancelEvent,
+								      (PTW32_INTERLOCKED_PVOID) cancelEvent,
+								      (PTW32_INTERLOCKED_PVOID) NULL))
+	{
+	  (void) ptw32_closehandle (cancelEvent, PTW32_LIBSTAT_EVENTS);
+	}
+
+      cancelEvent = tp->cancelEvent;
+    }
+
+  return cancelEvent;
+}
@@ -124,129 +124,160 @@ pthread_cond_destroy (pthread_cond_t * cond)
       return EINVAL;
     }
 
+  if (PTW32_IS_PSHARED (*cond))
+    {
+      return ptw32_pshared_cond_destroy (cond);
+    }
+
   if (*cond != PTHREAD_COND_INITIALIZER)
     {
       ptw32_mcs_local_node_t node;
-      ptw32_mcs_lock_acquire(&ptw32_cond_list_lock, &node);
+      ptw32_cond_list_t * list = NULL;
 
       cv = *cond;
 
       /*
-       * Close the gate; this will synchronize this thread with
-       * all already signaled waiters to let them retract their
-       * waiter status - SEE NOTE 1 ABOVE!!!
+       * Hold the CV's list shard so that the time change handler
+       * cannot broadcast it while it is destroyed.
        */
-      if (ptw32_semwait (&(cv->semBlockLock)) != 0) /* Non-cancelable */
+      if (cv->clock != CLOCK_MONOTONIC)
 	{
-	  result = errno;
+	  list = PTW32_COND_LIST_SHARD(cv);
+	  ptw32_mcs_lock_acquire(&list->lock, &node);
 	}
-      else
-        {
-          /*
-           * !TRY! lock mtxUnblockLock; try will detect busy condition
-           * and will not cause a deadlock with respect to concurrent
-           * signal/broadcast.
-           */
-          if ((result = pthread_mutex_trylock (&(cv->mtxUnblockLock))) != 0)
-	    {
-	      (void) sem_post (&(cv->semBlockLock));
-	    }
-	}
-	
-      if (result != 0)
-        {
-          ptw32_mcs_lock_release(&node);
-          return result;
-        }
 
-      /*
-       * Check whether cv is still busy (still has waiters)
-       */
-      if (cv->nWaitersBlocked > cv->nWaitersGone)
+#if defined(PTW32_COND_WAITONADDRESS)
+      if (cv->wakeByAddress)
 	{
-	  if (sem_post (&(cv->semBlockLock)) != 0)
+	  if (0 != PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &cv->nWaiters,
+							(PTW32_INTERLOCKED_LONG) 0))
 	    {
-	      result = errno;
+	      result2 = EBUSY;
+	    }
+	  else
+	    {
+	      *cond = NULL;
 	    }
-	  result1 = pthread_mutex_unlock (&(cv->mtxUnblockLock));
-	  result2 = EBUSY;
 	}
       else
+#endif
 	{
-	  /*
-	   * Now it is safe to destroy
-	   */
-	  *cond = NULL;
-
-	  if (sem_destroy (&(cv->semBlockLock)) != 0)
+          /*
+           * Close the gate; this will synchronize this thread with
+           * all already signaled waiters to let them retract their
+           * waiter status - SEE NOTE 1 ABOVE!!!
+           */
+          if (ptw32_semwait (&(cv->semBlockLock)) != 0) /* Non-cancelable */
 	    {
 	      result = errno;
 	    }
-	  if (sem_destroy (&(cv->semBlockQueue)) != 0)
+          else
+            {
+              /*
+               * !TRY! lock mtxUnblockLock; try will detect busy condition
+               * and will not cause a deadlock with respect to concurrent
+               * signal/broadcast.
+               */
+              if ((result = pthread_mutex_trylock (&(cv->mtxUnblockLock))) != 0)
+		{
+		  (void) sem_post (&(cv->semBlockLock));
+		}
+	    }
+	
+          if (result != 0)
+            {
+	      if (list != NULL)
+		{
+		  ptw32_mcs_lock_release(&node);
+		}
+              return result;
+            }
+
+          /*
+           * Check whether cv is still busy (still has waiters)
+           */
+          if (cv->nWaitersBlocked > cv->nWaitersGone)
 	    {
-	      result1 = errno;
+	      if (sem_post (&(cv->semBlockLock)) != 0)
+		{
+		  result = errno;
+		}
+	      result1 = pthread_mutex_unlock (&(cv->mtxUnblockLock));
+	      result2 = EBUSY;
 	    }
-	  if ((result2 = pthread_mutex_unlock (&(cv->mtxUnblockLock))) == 0)
+          else
 	    {
-	      result2 = pthread_mutex_destroy (&(cv->mtxUnblockLock));
+	      /*
+	       * Now it is safe to destroy
+	       */
+	      *cond = NULL;
+
+	      if (sem_destroy (&(cv->semBlockLock)) != 0)
+		{
+		  result = errno;
+		}
+	      if (sem_destroy (&(cv->semBlockQueue)) != 0)
+		{
+		  result1 = errno;
+		}
+	      if ((result2 = pthread_mutex_unlock (&(cv->mtxUnblockLock))) == 0)
+		{
+		  result2 = pthread_mutex_destroy (&(cv->mtxUnblockLock));
+		}
 	    }
+	}
 
+      if (*cond == NULL && list != NULL)
+	{
 	  /* Unlink the CV from the list */
 
-	  if (ptw32_cond_list_head == cv)
+	  if (list->head == cv)
 	    {
-	      ptw32_cond_list_head = cv->next;
+	      list->head = cv->next;
 	    }
 	  else
 	    {
 	      cv->prev->next = cv->next;
 	    }
 
-	  if (ptw32_cond_list_tail == cv)
+	  if (list->tail == cv)
 	    {
-	      ptw32_cond_list_tail = cv->prev;
+	      list->tail = cv->prev;
 	    }
 	  else
 	    {
 	      cv->next->prev = cv->prev;
 	    }
+	}
 
-	  (void) free (cv);
+      if (list != NULL)
+	{
+	  ptw32_mcs_lock_release(&node);
 	}
 
-      ptw32_mcs_lock_release(&node);
+      if (*cond == NULL)
+	{
+	  PTW32_LOCKSTAT_DESTROY (cv->stats);
+	  if (!cv->inPlace)
+	    {
+	      ptw32_object_free (cv);
+	    }
+	}
     }
   else
     {
-      ptw32_mcs_local_node_t node;
-      /*
-       * See notes in ptw32_cond_check_need_init() above also.
-       */
-      ptw32_mcs_lock_acquire(&ptw32_cond_test_init_lock, &node);
-
       /*
-       * Check again.
+       * Clear a static cond that has not been used yet, as
+       * pthread_mutex_destroy() does, unless another thread has
+       * just initialised it.
        */
-      if (*cond == PTHREAD_COND_INITIALIZER)
+      if (PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) cond,
+						  (PTW32_INTERLOCKED_PVOID) NULL,
+						  (PTW32_INTERLOCKED_PVOID) PTHREAD_COND_INITIALIZER)
+	  != (PTW32_INTERLOCKED_PVOID) PTHREAD_COND_INITIALIZER)
 	{
-	  /*
-	   * This is all we need to do to destroy a statically
-	   * initialised cond that has not yet been used (initialised).
-	   * If we get to here, another thread waiting to initialise
-	   * this cond will get an EINVAL. That's OK.
-	   */
-	  *cond = NULL;
-	}
-      else
-	{
-	  /*
-	   * The cv has been initialised while we were waiting
-	   * so assume it's in use.
-	   */
 	  result = EBUSY;
 	}
-
-      ptw32_mcs_lock_release(&node);
     }
 
   return ((result != 0) ? result : ((result1 != 0) ? result1 : result2));
@@ -0,0 +1,94 @@
+/*
+ * pthread_cond_destroy_array_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_cond_destroy_array_np (pthread_cond_t * conds, size_t n)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Destroys an array of condition variables initialised
+      *      with pthread_cond_init_array_np().
+      *
+      * PARAMETERS
+      *      conds
+      *              the array passed to pthread_cond_init_array_np()
+      *
+      *      n
+      *              its number of condition variables
+      *
+      * DESCRIPTION
+      *      Destroys the condition variables, last first, and frees
+      *      their block. If one has waiters the error is returned
+      *      and it and those before it are left initialised.
+      *
+      * RESULTS
+      *              0               successfully destroyed them,
+      *              EINVAL          'conds' is NULL, 'n' is 0 or the
+      *                              first one is not initialised,
+      *              EBUSY           a condition variable has waiters.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_cond_t block;
+  int result;
+  size_t i;
+
+  if (conds == NULL || n == 0 || conds[0] == NULL)
+    {
+      return EINVAL;
+    }
+
+  /* The block starts with the first condition variable */
+  block = conds[0];
+
+  for (i = n; i-- > 0;)
+    {
+      if (conds[i] != NULL
+	  && 0 != (result = pthread_cond_destroy (&conds[i])))
+	{
+	  return result;
+	}
+    }
+
+  ptw32_object_free (block);
+
+  return 0;
+}				/* pthread_cond_destroy_array_np */
@@ -0,0 +1,121 @@
+/*
+ * pthread_cond_init_array_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_cond_init_array_np (pthread_cond_t * conds, size_t n,
+			    const pthread_condattr_t * attr)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Initialises an array of condition variables with one
+      *      allocation.
+      *
+      * PARAMETERS
+      *      conds
+      *              array of 'n' pthread_cond_t
+      *
+      *      n
+      *              number of condition variables
+      *
+      *      attr
+      *              as for pthread_cond_init(), for every condition
+      *              variable.
+      *
+      * DESCRIPTION
+      *      As pthread_cond_init() on each element, but the
+      *      condition variables share one block, spaced as
+      *      pthread_setobjectalign_np() asks. They must be
+      *      destroyed together with pthread_cond_destroy_array_np().
+      *      On failure none are left initialised.
+      *
+      * RESULTS
+      *              0               successfully initialised the
+      *                              condition variables,
+      *              EINVAL          'conds' is NULL, 'n' is 0 or
+      *                              'attr' is process shared,
+      *              ENOMEM          insufficient memory,
+      *              other           as for pthread_cond_init().
+      *
+      * ------------------------------------------------------
+      */
+{
+  int align = ptw32_objectAlign;
+  size_t stride = ptw32_object_stride (sizeof (struct pthread_cond_t_), align);
+  char * block;
+  int pshared;
+  int result = 0;
+  size_t i;
+
+  if (conds == NULL || n == 0 || n > (size_t) -1 / stride)
+    {
+      return EINVAL;
+    }
+
+  if (attr != NULL
+      && pthread_condattr_getpshared (attr, &pshared) == 0
+      && pshared == PTHREAD_PROCESS_SHARED)
+    {
+      return EINVAL;
+    }
+
+  if ((block = (char *) ptw32_object_alloc (n * stride, align)) == NULL)
+    {
+      return ENOMEM;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      if (0 != (result = ptw32_cond_init (&conds[i], attr, block + i * stride, stride)))
+	{
+	  break;
+	}
+    }
+
+  if (result != 0)
+    {
+      while (i-- > 0)
+	{
+	  (void) pthread_cond_destroy (&conds[i]);
+	}
+      ptw32_object_free (block);
+    }
+
+  return result;
+}				/* pthread_cond_init_array_np */
@@ -43,10 +43,31 @@
 #include "implement.h"
 
 static INLINE int
-ptw32_cond_unblock (pthread_cond_t * cond, int unblockAll)
+ptw32_cond_unlock_mutex (pthread_mutex_t * mutex, int result)
+{
+  int unlockResult;
+
+  if (mutex != NULL
+      && 0 != (unlockResult = pthread_mutex_unlock (mutex))
+      && 0 == result)
+    {
+      result = unlockResult;
+    }
+
+  return result;
+}
+
+static INLINE int
+ptw32_cond_unblock (pthread_cond_t * cond, int unblockAll,
+		    pthread_mutex_t * mutex)
      /*
       * Notes.
       *
+      * If 'mutex' isn't NULL the caller holds it, and it is
+      * unlocked after the waiters to release have been chosen
+      * but before they are woken, so that they don't wake only
+      * to block on it.
+      *
       * Does not use the external mutex for synchronisation,
       * therefore semBlockLock is needed.
       * mtxUnblockLock is for LEVEL-2 synch. LEVEL-2 is the
@@ -55,6 +76,9 @@ ptw32_cond_unblock (pthread_cond_t * cond, int unblockAll)
       * the lock after having been signaled or a timeout or
       * cancellation.
       *
+      * Condition variables that wait via WaitOnAddress use the
+      * sequence counters instead (see pthread_cond_wait.c).
+      *
       * Uses the following CV elements:
       *   nWaitersBlocked
       *   nWaitersToUnblock
@@ -75,25 +99,104 @@ ptw32_cond_unblock (pthread_cond_t * cond, int unblockAll)
 
   cv = *cond;
 
+  if (PTW32_IS_PSHARED (cv))
+    {
+      /*
+       * The kernel semaphore is posted inside; waiters wake to the
+       * mutex still held, as with pthread_cond_signal().
+       */
+      result = ptw32_pshared_cond_unblock (cv, unblockAll);
+      return ptw32_cond_unlock_mutex (mutex, result);
+    }
+
   /*
    * No-op if the CV is static and hasn't been initialised yet.
    * Assuming that any race condition is harmless.
    */
   if (cv == PTHREAD_COND_INITIALIZER)
     {
-      return 0;
+      return ptw32_cond_unlock_mutex (mutex, 0);
     }
 
-  if ((result = pthread_mutex_lock (&(cv->mtxUnblockLock))) != 0)
+  /*
+   * Asynchronous waiters (pthread_cond_wait_async_np) are released
+   * first. A signal that releases one releases no thread.
+   */
+  if (ptw32_async_wake ((volatile VOID *) cv, unblockAll) > 0 && !unblockAll)
     {
+      return ptw32_cond_unlock_mutex (mutex, 0);
+    }
+
+#if defined(PTW32_COND_WAITONADDRESS)
+  if (cv->wakeByAddress)
+    {
+      ptw32_mcs_local_node_t node;
+      int wake = PTW32_FALSE;
+#if defined(PTW32_ETW)
+      int released = 1;
+#endif
+
+      /*
+       * No waiters means no work at all, not even taking the lock.
+       */
+      if (0 == PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &cv->nWaiters,
+                                                    (PTW32_INTERLOCKED_LONG) 0))
+	{
+	  return ptw32_cond_unlock_mutex (mutex, 0);
+	}
+
+      ptw32_mcs_lock_acquire (&cv->seqLock, &node);
+
+      if (cv->totalSeq > cv->wakeupSeq)
+	{
+	  if (unblockAll)
+	    {
+#if defined(PTW32_ETW)
+	      released = (int) (cv->totalSeq - cv->wakeupSeq);
+#endif
+	      cv->wakeupSeq = cv->wokenSeq = cv->totalSeq;
+	      cv->broadcastSeq++;
+	      cv->nMorphWaiters += cv->nGenWaiters;
+	      cv->nGenWaiters = 0;
+	    }
+	  else
+	    {
+	      cv->wakeupSeq++;
+	    }
+	  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &cv->seq);
+	  wake = PTW32_TRUE;
+	}
+
+      ptw32_mcs_lock_release (&node);
+
+      result = ptw32_cond_unlock_mutex (mutex, 0);
+
+      if (wake)
+	{
+	  PTW32_ETW_EVENT (unblockAll ? PTW32_ETW_COND_BROADCAST : PTW32_ETW_COND_SIGNAL,
+	                   cv, released);
+	  /*
+	   * Broadcast too: the released waiters wake each other in turn
+	   * as they unlock the mutex (see pthread_cond_wait.c).
+	   */
+	  ptw32_wakebyaddresssingle ((PVOID) &cv->seq);
+	}
+
       return result;
     }
+#endif
+
+  if ((result = pthread_mutex_lock (&(cv->mtxUnblockLock))) != 0)
+    {
+      return ptw32_cond_unlock_mutex (mutex, result);
+    }
 
   if (0 != cv->nWaitersToUnblock)
     {
       if (0 == cv->nWaitersBlocked)
 	{
-	  return pthread_mutex_unlock (&(cv->mtxUnblockLock));
+	  result = pthread_mutex_unlock (&(cv->mtxUnblockLock));
+	  return ptw32_cond_unlock_mutex (mutex, result);
 	}
       if (unblockAll)
 	{
@@ -114,7 +217,7 @@ ptw32_cond_unblock (pthread_cond_t * cond, int unblockAll)
 	{
 	  result = errno;
 	  (void) pthread_mutex_unlock (&(cv->mtxUnblockLock));
-	  return result;
+	  return ptw32_cond_unlock_mutex (mutex, result);
 	}
       if (0 != cv->nWaitersGone)
 	{
@@ -134,15 +237,26 @@ ptw32_cond_unblock (pthread_cond_t * cond, int unblockAll)
     }
   else
     {
-      return pthread_mutex_unlock (&(cv->mtxUnblockLock));
+      result = pthread_mutex_unlock (&(cv->mtxUnblockLock));
+      return ptw32_cond_unlock_mutex (mutex, result);
     }
 
-  if ((result = pthread_mutex_unlock (&(cv->mtxUnblockLock))) == 0)
+  if ((result = pthread_mutex_unlock (&(cv->mtxUnblockLock))) != 0)
     {
-      if (sem_post_multiple (&(cv->semBlockQueue), nSignalsToIssue) != 0)
-	{
-	  result = errno;
-	}
+      return ptw32_cond_unlock_mutex (mutex, result);
+    }
+
+  /*
+   * The signals are counted in, so they must be posted even if
+   * unlocking the caller's mutex fails.
+   */
+  result = ptw32_cond_unlock_mutex (mutex, 0);
+
+  PTW32_ETW_EVENT (unblockAll ? PTW32_ETW_COND_BROADCAST : PTW32_ETW_COND_SIGNAL,
+                   cv, nSignalsToIssue);
+  if (sem_post_multiple (&(cv->semBlockQueue), nSignalsToIssue) != 0)
+    {
+      result = errno;
     }
 
   return result;
@@ -187,7 +301,7 @@ pthread_cond_signal (pthread_cond_t * cond)
   /*
    * The '0'(FALSE) unblockAll arg means unblock ONE waiter.
    */
-  return (ptw32_cond_unblock (cond, 0));
+  return (ptw32_cond_unblock (cond, 0, NULL));
 
 }				/* pthread_cond_signal */
 
@@ -226,6 +340,93 @@ pthread_cond_broadcast (pthread_cond_t * cond)
   /*
    * The TRUE unblockAll arg means unblock ALL waiters.
    */
-  return (ptw32_cond_unblock (cond, PTW32_TRUE));
+  return (ptw32_cond_unblock (cond, PTW32_TRUE, NULL));
 
 }				/* pthread_cond_broadcast */
+
+int
+pthread_cond_signal_unlock_np (pthread_cond_t * cond, pthread_mutex_t * mutex)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Signals a condition variable and unlocks a mutex in
+      *      one call.
+      *
+      * PARAMETERS
+      *      cond
+      *              pointer to an instance of pthread_cond_t
+      *
+      *      mutex
+      *              pointer to the mutex the caller holds, that
+      *              waiters on 'cond' wait with
+      *
+      * DESCRIPTION
+      *      Equivalent to pthread_cond_signal() followed by
+      *      pthread_mutex_unlock(), except that the waiter to
+      *      release is chosen while the mutex is still held and
+      *      woken only after it has been unlocked. The waiter
+      *      can then take the mutex at once instead of waking
+      *      to find it held and blocking again.
+      *
+      * RESULTS
+      *              0               successfully signaled condition
+      *                              and unlocked the mutex,
+      *              EINVAL          'cond' is invalid; the mutex
+      *                              is still locked,
+      *              EPERM           as for pthread_mutex_unlock();
+      *                              the condition was signaled.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (mutex == NULL)
+    {
+      return EINVAL;
+    }
+
+  return (ptw32_cond_unblock (cond, 0, mutex));
+
+}				/* pthread_cond_signal_unlock_np */
+
+int
+pthread_cond_broadcast_unlock_np (pthread_cond_t * cond, pthread_mutex_t * mutex)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Broadcasts a condition variable and unlocks a mutex
+      *      in one call.
+      *
+      * PARAMETERS
+      *      cond
+      *              pointer to an instance of pthread_cond_t
+      *
+      *      mutex
+      *              pointer to the mutex the caller holds, that
+      *              waiters on 'cond' wait with
+      *
+      * DESCRIPTION
+      *      Equivalent to pthread_cond_broadcast() followed by
+      *      pthread_mutex_unlock(), except that the waiters are
+      *      woken only after the mutex has been unlocked; see
+      *      pthread_cond_signal_unlock_np().
+      *
+      * RESULTS
+      *              0               successfully signalled condition
+      *                              to all waiting threads and
+      *                              unlocked the mutex,
+      *              EINVAL          'cond' is invalid; the mutex
+      *                              is still locked,
+      *              EPERM           as for pthread_mutex_unlock();
+      *                              the condition was broadcast.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (mutex == NULL)
+    {
+      return EINVAL;
+    }
+
+  return (ptw32_cond_unblock (cond, PTW32_TRUE, mutex));
+
+}				/* pthread_cond_broadcast_unlock_np */
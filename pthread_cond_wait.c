@@ -256,18 +256,118 @@
  * }
  * -------------------------------------------------------------
  *
+ * When the library is built with PTW32_COND_WAITONADDRESS defined and
+ * the system provides WaitOnAddress(), condition variables instead use
+ * sequence counters guarded by an internal MCS lock, with waiters parked
+ * on a single word (seq) via WaitOnAddress:
+ *
+ * given:
+ * seqLock - internal MCS lock
+ * seq - int, the word waiters park on, bumped by every wakeup
+ * totalSeq - number of waits started
+ * wakeupSeq - number of wakeups issued (signals, timeouts, cancels)
+ * wokenSeq - number of wakeups consumed
+ * broadcastSeq - number of broadcasts
+ * nWaiters - number of threads inside wait
+ * nGenWaiters - waiters since the last broadcast
+ * nMorphWaiters - waiters released by a broadcast that haven't left
+ * 
+ * wait( timeout ) {
+ *   lock( seqLock );
+ *   ++totalSeq; ++nWaiters;              // before unlocking mtxExternal
+ *   mySeq = wakeupSeq; myBroadcast = broadcastSeq;
+ *   unlock( mtxExternal );
+ *   for ( ;; ) {
+ *     s = seq;
+ *     unlock( seqLock );
+ *     bTimedOut = !WaitOnAddress( &seq, &s, timeout );
+ *     lock( seqLock );
+ *     if ( myBroadcast != broadcastSeq ) break;
+ *     if ( wakeupSeq != mySeq && wokenSeq != wakeupSeq ) { ++wokenSeq; break; }
+ *     if ( bTimedOut ) { ++wakeupSeq; ++wokenSeq; break; }
+ *   }
+ *   unlock( seqLock );
+ *   lock( mtxExternal );
+ *   lock( seqLock );
+ *   --nWaiters;
+ *   if ( myBroadcast == broadcastSeq ) --nGenWaiters;
+ *   else if ( 0 != --nMorphWaiters ) {
+ *     mtxExternal.morphCond = cv;        // wake next when we unlock it
+ *   }
+ *   unlock( seqLock );
+ * }
+ * 
+ * signal(bAll) {
+ *   if ( 0 == nWaiters ) return 0;       // no locking, no kernel call
+ *   lock( seqLock );
+ *   if ( totalSeq > wakeupSeq ) {
+ *     if ( bAll ) {
+ *       wokenSeq = wakeupSeq = totalSeq; ++broadcastSeq;
+ *       nMorphWaiters += nGenWaiters; nGenWaiters = 0;
+ *     } else {
+ *       ++wakeupSeq;
+ *     }
+ *     ++seq;
+ *     unlock( seqLock );
+ *     WakeByAddressSingle( &seq );       // broadcast too, see below
+ *   } else unlock( seqLock );
+ * }
+ *
+ * Each signal therefore releases exactly one waiter even though
+ * WaitOnAddress may return spuriously. A broadcast releases all waiters
+ * but only wakes one; each released waiter wakes the next when it first
+ * unlocks the external mutex, so they don't all stampede onto it. A cancelled waiter retracts itself
+ * like a timed out one and wakes the others in case it was the intended
+ * target of a signal. pthread_cancel() bumps seq and wakes all waiters on
+ * the address a deferred-cancellable target is parked on.
+ *
+ * A waiter with cancellation disabled can't be cancelled until it enables
+ * it again itself, so with either algorithm it pushes no cleanup handler
+ * and, here, records no address for pthread_cancel().
+ * -------------------------------------------------------------
+ *
  */
 
 #include "pthread.h"
 #include "implement.h"
 
+/*
+ * The external lock a waiter releases and takes again: a mutex or,
+ * for pthread_cond_wait_rwlock_np, a reader-writer lock held shared
+ * or exclusive.
+ */
+typedef struct
+{
+  pthread_mutex_t *mutex;	/* NULL for a reader-writer lock */
+  pthread_rwlock_t *rwlock;
+  int exclusive;
+} ptw32_cond_lock_t;
+
+static INLINE int
+ptw32_cond_unlock (const ptw32_cond_lock_t * lock)
+{
+  return (lock->mutex != NULL) ? pthread_mutex_unlock (lock->mutex)
+                               : pthread_rwlock_unlock (lock->rwlock);
+}
+
+static INLINE int
+ptw32_cond_relock (const ptw32_cond_lock_t * lock)
+{
+  if (lock->mutex != NULL)
+    {
+      return pthread_mutex_lock (lock->mutex);
+    }
+  return lock->exclusive ? pthread_rwlock_wrlock (lock->rwlock)
+                         : pthread_rwlock_rdlock (lock->rwlock);
+}
+
 /*
  * Arguments for cond_wait_cleanup, since we can only pass a
  * single void * to it.
  */
 typedef struct
 {
-  pthread_mutex_t *mutexPtr;
+  const ptw32_cond_lock_t *lockPtr;
   pthread_cond_t cv;
   int *resultPtr;
 } ptw32_cond_wait_cleanup_args_t;
@@ -344,25 +444,333 @@ ptw32_cond_wait_cleanup (void *args)
    * XSH: Upon successful return, the mutex has been locked and is owned
    * by the calling thread.
    */
-  if ((result = pthread_mutex_lock (cleanup_args->mutexPtr)) != 0)
+  if ((result = ptw32_cond_relock (cleanup_args->lockPtr)) != 0)
     {
       *resultPtr = result;
     }
 }				/* ptw32_cond_wait_cleanup */
 
+#if defined(PTW32_COND_WAITONADDRESS)
+/*
+ * Arguments for cond_seq_wait_cleanup.
+ */
+typedef struct
+{
+  const ptw32_cond_lock_t *lockPtr;
+  pthread_cond_t cv;
+  unsigned __int64 broadcastSeq;
+} ptw32_cond_seq_wait_cleanup_args_t;
+
+/*
+ * Record (or clear) the address that the calling thread is parked on
+ * so that pthread_cancel() can wake it.
+ */
+static INLINE void
+ptw32_cond_set_wait_address (ptw32_thread_t * sp, LONG * address)
+{
+  ptw32_mcs_local_node_t stateLock;
+
+  if (sp != NULL)
+    {
+      ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
+      sp->condWaitAddress = address;
+      ptw32_mcs_lock_release (&stateLock);
+    }
+}
+
+/*
+ * Leave the condition variable once the external mutex is held again.
+ *
+ * A broadcast only wakes one waiter. Each waiter it released wakes the
+ * next one on its way out, but (wait morphing) defers that wakeup to its
+ * own unlock of the external mutex, so that the woken thread doesn't
+ * just block again on the mutex. The deferred wakeup is left in
+ * mx->morphCond, which only the mutex owner touches; robust and process
+ * shared mutexes, mutexes that already hold a deferred wakeup, and
+ * reader-writer locks ('mutex' NULL) get an immediate one.
+ *
+ * Everything is done under seqLock: the condition variable can't be
+ * destroyed while another waiter is still counted in nWaiters, and that
+ * waiter can't leave before it has the mutex, i.e. before our unlock has
+ * delivered the deferred wakeup.
+ */
+static INLINE void
+ptw32_cond_seq_leave (pthread_cond_t cv, pthread_mutex_t * mutex,
+		      unsigned __int64 broadcastSeq, int locked)
+{
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&cv->seqLock, &node);
+
+  cv->nWaiters--;
+
+  if (broadcastSeq == cv->broadcastSeq)
+    {
+      cv->nGenWaiters--;
+    }
+  else if (0 != --cv->nMorphWaiters)
+    {
+      pthread_mutex_t mx = (mutex != NULL) ? *mutex : NULL;
+
+      if (locked && mx != NULL && !PTW32_IS_PSHARED (mx)
+	  && mx->kind >= 0 && mx->kind != PTHREAD_MUTEX_ELIDE_NP
+	  && mx->morphCond == NULL)
+	{
+	  mx->morphCond = cv;
+	  /*
+	   * Make sure the unlock comes to the library: the
+	   * PTW32_INLINE_LOCKS fast path only releases a lock_idx of 1.
+	   */
+	  (void) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+							  (PTW32_INTERLOCKED_LONG) -1,
+							  (PTW32_INTERLOCKED_LONG) 1);
+	}
+      else
+	{
+	  ptw32_wakebyaddresssingle ((PVOID) &cv->seq);
+	}
+    }
+
+  ptw32_mcs_lock_release (&node);
+}
+
+/*
+ * Only run when the waiter is cancelled; normal exits do their own
+ * accounting in ptw32_cond_seq_timedwait.
+ */
+static void PTW32_CDECL
+ptw32_cond_seq_wait_cleanup (void *args)
+{
+  ptw32_cond_seq_wait_cleanup_args_t *cleanup_args =
+    (ptw32_cond_seq_wait_cleanup_args_t *) args;
+  pthread_cond_t cv = cleanup_args->cv;
+  ptw32_mcs_local_node_t node;
+
+  ptw32_cond_set_wait_address ((ptw32_thread_t *) pthread_self ().p, NULL);
+
+  ptw32_mcs_lock_acquire (&cv->seqLock, &node);
+
+  if (cleanup_args->broadcastSeq == cv->broadcastSeq)
+    {
+      /* Retract this waiter */
+      cv->wakeupSeq++;
+      cv->wokenSeq++;
+    }
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &cv->seq);
+
+  /*
+   * A signal may have been meant for this thread; make sure it isn't lost.
+   */
+  ptw32_wakebyaddressall ((PVOID) &cv->seq);
+
+  ptw32_mcs_lock_release (&node);
+
+  /*
+   * XSH: Upon successful return, the mutex has been locked and is owned
+   * by the calling thread.
+   */
+  ptw32_cond_seq_leave (cv, cleanup_args->lockPtr->mutex, cleanup_args->broadcastSeq,
+			0 == ptw32_cond_relock (cleanup_args->lockPtr));
+}				/* ptw32_cond_seq_wait_cleanup */
+
+/*
+ * Wait until signalled, broadcast or timed out. Entered holding seqLock
+ * through 'node', and returns having released it. A waiter that isn't
+ * cancelable skips the cancellation points.
+ */
+static INLINE int
+ptw32_cond_seq_block (pthread_cond_t cv, ptw32_mcs_local_node_t * node,
+		      unsigned __int64 wakeupSeq, unsigned __int64 broadcastSeq,
+		      clockid_t clock, const struct timespec *abstime,
+		      int cancelable)
+{
+  int result = 0;
+  int timedOut = PTW32_FALSE;
+  LONG seq;
+
+  for (;;)
+    {
+      seq = cv->seq;
+
+      ptw32_mcs_lock_release (node);
+
+      /*
+       * A cancel request made before the address was recorded is seen
+       * here; one made after it has bumped seq, so the wait returns at once.
+       */
+      if (cancelable)
+	{
+	  pthread_testcancel ();
+	}
+
+      if (!ptw32_cond_spin (cv, seq))
+	{
+	  PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_COND);
+	  if (!ptw32_waitonaddress_abstime ((volatile VOID *) &cv->seq, (PVOID) &seq,
+					    sizeof (seq), clock, abstime))
+	    {
+	      timedOut = (GetLastError () == ERROR_TIMEOUT);
+	    }
+	}
+
+      if (cancelable)
+	{
+	  pthread_testcancel ();
+	}
+
+      ptw32_mcs_lock_acquire (&cv->seqLock, node);
+
+      if (broadcastSeq != cv->broadcastSeq)
+	{
+	  /* Woken by broadcast, which has already counted us */
+	  break;
+	}
+
+      if (cv->wakeupSeq != wakeupSeq && cv->wokenSeq != cv->wakeupSeq)
+	{
+	  /* Consume a signal */
+	  cv->wokenSeq++;
+	  break;
+	}
+
+      if (timedOut)
+	{
+	  /* Retract this waiter */
+	  cv->wakeupSeq++;
+	  cv->wokenSeq++;
+	  result = ETIMEDOUT;
+	  break;
+	}
+
+      if (0 != cv->nMorphWaiters)
+	{
+	  /*
+	   * We may have taken a wakeup meant for a thread released by an
+	   * earlier broadcast; pass it on.
+	   */
+	  ptw32_wakebyaddresssingle ((PVOID) &cv->seq);
+	}
+    }
+
+  ptw32_mcs_lock_release (node);
+
+  return result;
+}
+
+static INLINE int
+ptw32_cond_seq_timedwait (pthread_cond_t cv, const ptw32_cond_lock_t * lock,
+			  clockid_t clock, const struct timespec *abstime,
+			  ptw32_thread_t * sp, int cancelable)
+{
+  int result = 0;
+  ptw32_cond_seq_wait_cleanup_args_t cleanup_args;
+  ptw32_mcs_local_node_t node;
+  unsigned __int64 wakeupSeq;
+  int result1;
+
+  ptw32_mcs_lock_acquire (&cv->seqLock, &node);
+
+  /*
+   * Count ourselves in before releasing the external mutex: signal and
+   * broadcast look at nWaiters without taking seqLock.
+   */
+  cv->totalSeq++;
+  cv->nWaiters++;
+  cv->nGenWaiters++;
+  wakeupSeq = cv->wakeupSeq;
+
+  if ((result = ptw32_cond_unlock (lock)) != 0)
+    {
+      cv->totalSeq--;
+      cv->nWaiters--;
+      cv->nGenWaiters--;
+      ptw32_mcs_lock_release (&node);
+      return result;
+    }
+
+  cleanup_args.lockPtr = lock;
+  cleanup_args.cv = cv;
+  cleanup_args.broadcastSeq = cv->broadcastSeq;
+
+  if (cancelable)
+    {
+      ptw32_cond_set_wait_address (sp, &cv->seq);
+
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth(0)
+#endif
+      pthread_cleanup_push (ptw32_cond_seq_wait_cleanup, (void *) &cleanup_args);
+
+      result = ptw32_cond_seq_block (cv, &node, wakeupSeq, cleanup_args.broadcastSeq,
+				     clock, abstime, PTW32_TRUE);
+
+      pthread_cleanup_pop (0);
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth()
+#endif
+
+      ptw32_cond_set_wait_address (sp, NULL);
+    }
+  else
+    {
+      /*
+       * Nothing can cancel us before we enable cancellation again
+       * ourselves, so there is no handler to register and no address
+       * for pthread_cancel() to find.
+       */
+      result = ptw32_cond_seq_block (cv, &node, wakeupSeq, cleanup_args.broadcastSeq,
+				     clock, abstime, PTW32_FALSE);
+    }
+
+  /*
+   * XSH: Upon successful return, the mutex has been locked and is owned
+   * by the calling thread.
+   */
+  if ((result1 = ptw32_cond_relock (lock)) != 0)
+    {
+      result = result1;
+    }
+
+  ptw32_cond_seq_leave (cv, lock->mutex, cleanup_args.broadcastSeq, 0 == result1);
+
+  return result;
+
+}				/* ptw32_cond_seq_timedwait */
+#endif /* PTW32_COND_WAITONADDRESS */
+
+/*
+ * A clock of -1 is the condition variable's own (see
+ * pthread_condattr_setclock). The external lock is 'mutex' or, if
+ * that is NULL, 'rwlock', held exclusive if 'exclusive'.
+ */
 static INLINE int
-ptw32_cond_timedwait (pthread_cond_t * cond,
-		      pthread_mutex_t * mutex, const struct timespec *abstime)
+ptw32_cond_timedwait (pthread_cond_t * cond, pthread_mutex_t * mutex,
+		      pthread_rwlock_t * rwlock, int exclusive,
+		      clockid_t clock, const struct timespec *abstime)
 {
   int result = 0;
   pthread_cond_t cv;
+  ptw32_cond_lock_t lock;
   ptw32_cond_wait_cleanup_args_t cleanup_args;
+  ptw32_thread_t * sp;
+  int cancelable;
+  PTW32_LOCKSTAT_DECL (waitStart)
 
   if (cond == NULL || *cond == NULL)
     {
       return EINVAL;
     }
 
+  if (PTW32_IS_PSHARED (*cond))
+    {
+      return (mutex != NULL) ? ptw32_pshared_cond_wait (*cond, mutex, clock, abstime)
+                             : ENOSYS;
+    }
+
+  lock.mutex = mutex;
+  lock.rwlock = rwlock;
+  lock.exclusive = exclusive;
+
   /*
    * We do a quick check to see if we need to do more work
    * to initialise a static condition variable. We check
@@ -381,8 +789,36 @@ ptw32_cond_timedwait (pthread_cond_t * cond,
 
   cv = *cond;
 
+  if (clock == -1)
+    {
+      clock = cv->clock;
+    }
+
+  /*
+   * Only the thread itself can enable cancellation again, so a thread
+   * that has it disabled can't be cancelled during the wait, and the
+   * cleanup handler, with its TSD traffic or exception frame, can be
+   * left out.
+   */
+  sp = (ptw32_thread_t *) pthread_self ().p;
+  cancelable = (sp == NULL || sp->cancelState == PTHREAD_CANCEL_ENABLE);
+
+  PTW32_LOCKSTAT_COND_BEGIN (waitStart);
+  PTW32_ETW_EVENT (PTW32_ETW_COND_WAIT_BEGIN, cv, 0);
+
+#if defined(PTW32_COND_WAITONADDRESS)
+  if (cv->wakeByAddress)
+    {
+      result = ptw32_cond_seq_timedwait (cv, &lock, clock, abstime, sp, cancelable);
+      PTW32_LOCKSTAT_COND_WAITED (cv, result, waitStart);
+      PTW32_ETW_EVENT (PTW32_ETW_COND_WAIT_END, cv, result);
+      return result;
+    }
+#endif
+
   /* Thread can be cancelled in sem_wait() but this is OK */
-  if (sem_wait (&(cv->semBlockLock)) != 0)
+  if ((cancelable ? sem_wait (&(cv->semBlockLock))
+       : ptw32_semwait (&(cv->semBlockLock))) != 0)
     {
       return errno;
     }
@@ -397,10 +833,31 @@ ptw32_cond_timedwait (pthread_cond_t * cond,
   /*
    * Setup this waiter cleanup handler
    */
-  cleanup_args.mutexPtr = mutex;
+  cleanup_args.lockPtr = &lock;
   cleanup_args.cv = cv;
   cleanup_args.resultPtr = &result;
 
+  if (!cancelable)
+    {
+      /*
+       * As below, but the cleanup is simply called.
+       */
+      if ((result = ptw32_cond_unlock (&lock)) == 0)
+	{
+	  if (!ptw32_cond_spin (cv, 0)
+	      && sem_clockwait (&(cv->semBlockQueue), clock, abstime) != 0)
+	    {
+	      result = errno;
+	    }
+	}
+
+      ptw32_cond_wait_cleanup ((void *) &cleanup_args);
+
+      PTW32_LOCKSTAT_COND_WAITED (cv, result, waitStart);
+      PTW32_ETW_EVENT (PTW32_ETW_COND_WAIT_END, cv, result);
+      return result;
+    }
+
 #if defined(PTW32_CONFIG_MSVC7)
 #pragma inline_depth(0)
 #endif
@@ -409,7 +866,7 @@ ptw32_cond_timedwait (pthread_cond_t * cond,
   /*
    * Now we can release 'mutex' and...
    */
-  if ((result = pthread_mutex_unlock (mutex)) == 0)
+  if ((result = ptw32_cond_unlock (&lock)) == 0)
     {
 
       /*
@@ -427,8 +884,12 @@ ptw32_cond_timedwait (pthread_cond_t * cond,
        *      We use the cleanup mechanism to ensure we
        *      re-lock the mutex and adjust (to)unblock(ed) waiters
        *      counts if we are cancelled, timed out or signalled.
+       *
+       *      A waiter with a spin budget first polls for a
+       *      signal (see ptw32_cond_spin.c).
        */
-      if (sem_timedwait (&(cv->semBlockQueue), abstime) != 0)
+      if (!ptw32_cond_spin (cv, 0)
+	  && sem_clockwait (&(cv->semBlockQueue), clock, abstime) != 0)
 	{
 	  result = errno;
 	}
@@ -445,6 +906,8 @@ ptw32_cond_timedwait (pthread_cond_t * cond,
   /*
    * "result" can be modified by the cleanup handler.
    */
+  PTW32_LOCKSTAT_COND_WAITED (cv, result, waitStart);
+  PTW32_ETW_EVENT (PTW32_ETW_COND_WAIT_END, cv, result);
   return result;
 
 }				/* ptw32_cond_timedwait */
@@ -503,7 +966,7 @@ pthread_cond_wait (pthread_cond_t * cond, pthread_mutex_t * mutex)
   /*
    * The NULL abstime arg means INFINITE waiting.
    */
-  return (ptw32_cond_timedwait (cond, mutex, NULL));
+  return (ptw32_cond_timedwait (cond, mutex, NULL, 0, -1, NULL));
 
 }				/* pthread_cond_wait */
 
@@ -562,6 +1025,204 @@ pthread_cond_timedwait (pthread_cond_t * cond,
       return EINVAL;
     }
 
-  return (ptw32_cond_timedwait (cond, mutex, abstime));
+  return (ptw32_cond_timedwait (cond, mutex, NULL, 0, -1, abstime));
 
 }				/* pthread_cond_timedwait */
+
+
+int
+pthread_cond_clockwait (pthread_cond_t * cond,
+			pthread_mutex_t * mutex,
+			clockid_t clock_id,
+			const struct timespec *abstime)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      As pthread_cond_timedwait, with abstime measured
+      *      against clock_id whatever the condition variable's
+      *      own clock.
+      *
+      * PARAMETERS
+      *      cond
+      *              pointer to an instance of pthread_cond_t
+      *
+      *      mutex
+      *              pointer to an instance of pthread_mutex_t
+      *
+      *      clock_id
+      *              CLOCK_REALTIME or CLOCK_MONOTONIC
+      *
+      *      abstime
+      *              pointer to an instance of (const struct timespec)
+      *
+      *
+      * DESCRIPTION
+      *      See pthread_cond_timedwait.
+      *
+      * RESULTS
+      *              0               caught condition; mutex released,
+      *              EINVAL          'cond', 'mutex', 'clock_id' or
+      *                              abstime is invalid,
+      *              ETIMEDOUT       abstime ellapsed before cond was signaled.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (abstime == NULL || !PTW32_VALID_CLOCK(clock_id))
+    {
+      return EINVAL;
+    }
+
+  return (ptw32_cond_timedwait (cond, mutex, NULL, 0, clock_id, abstime));
+
+}				/* pthread_cond_clockwait */
+
+
+int
+pthread_cond_timedwait_relative_np (pthread_cond_t * cond,
+				    pthread_mutex_t * mutex,
+				    const struct timespec *reltime)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      As pthread_cond_timedwait, with a timeout relative
+      *      to the call instead of an absolute time.
+      *
+      * PARAMETERS
+      *      cond
+      *              pointer to an instance of pthread_cond_t
+      *
+      *      mutex
+      *              pointer to an instance of pthread_mutex_t
+      *
+      *      reltime
+      *              how long to wait for the condition
+      *
+      * DESCRIPTION
+      *      See pthread_cond_timedwait. The caller needn't read
+      *      the clock to make an abstime; the library reads the
+      *      monotonic clock once to fix the deadline, so the
+      *      wait is unaffected by changes to the system time.
+      *
+      * RESULTS
+      *              0               caught condition; mutex released,
+      *              EINVAL          'cond', 'mutex' or reltime is
+      *                              invalid,
+      *              ETIMEDOUT       reltime passed before cond was
+      *                              signaled.
+      *
+      * ------------------------------------------------------
+      */
+{
+  struct timespec deadline;
+
+  if (!PTW32_VALID_RELTIME(reltime))
+    {
+      return EINVAL;
+    }
+
+  /*
+   * The wait may sleep more than once, after spurious wakeups, so
+   * it needs a deadline.
+   */
+  ptw32_monotonic_deadline (PTW32_CLOCK_RELATIVE, reltime, &deadline);
+
+  return (ptw32_cond_timedwait (cond, mutex, NULL, 0, CLOCK_MONOTONIC, &deadline));
+
+}				/* pthread_cond_timedwait_relative_np */
+
+
+int
+pthread_cond_wait_rwlock_np (pthread_cond_t * cond,
+			     pthread_rwlock_t * rwlock, int exclusive)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      As pthread_cond_wait, with a reader-writer lock in
+      *      place of the mutex.
+      *
+      * PARAMETERS
+      *      cond
+      *              pointer to an instance of pthread_cond_t
+      *
+      *      rwlock
+      *              pointer to an instance of pthread_rwlock_t
+      *
+      *      exclusive
+      *              nonzero if the caller holds 'rwlock' for
+      *              writing, zero if for reading
+      *
+      * DESCRIPTION
+      *      The caller holds 'rwlock' in the mode 'exclusive'
+      *      gives. The lock is released while waiting and taken
+      *      again in the same mode before returning, also when
+      *      the thread is cancelled. Any number of readers can
+      *      wait on 'cond' at once.
+      *
+      * RESULTS
+      *              0               caught condition; rwlock held
+      *                              again,
+      *              EINVAL          'cond' or 'rwlock' is invalid,
+      *              ENOSYS          'cond' is process shared.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (rwlock == NULL)
+    {
+      return EINVAL;
+    }
+
+  return (ptw32_cond_timedwait (cond, NULL, rwlock, exclusive, -1, NULL));
+
+}				/* pthread_cond_wait_rwlock_np */
+
+
+int
+pthread_cond_timedwait_rwlock_np (pthread_cond_t * cond,
+				  pthread_rwlock_t * rwlock, int exclusive,
+				  const struct timespec *abstime)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      As pthread_cond_timedwait, with a reader-writer lock
+      *      in place of the mutex.
+      *
+      * PARAMETERS
+      *      cond
+      *              pointer to an instance of pthread_cond_t
+      *
+      *      rwlock
+      *              pointer to an instance of pthread_rwlock_t
+      *
+      *      exclusive
+      *              nonzero if the caller holds 'rwlock' for
+      *              writing, zero if for reading
+      *
+      *      abstime
+      *              pointer to an instance of (const struct timespec)
+      *
+      * DESCRIPTION
+      *      See pthread_cond_wait_rwlock_np. The wait ends at
+      *      'abstime' on the condition variable's clock.
+      *
+      * RESULTS
+      *              0               caught condition; rwlock held
+      *                              again,
+      *              EINVAL          'cond', 'rwlock' or 'abstime'
+      *                              is invalid,
+      *              ENOSYS          'cond' is process shared,
+      *              ETIMEDOUT       abstime elapsed before cond was
+      *                              signaled; rwlock held again.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (rwlock == NULL || abstime == NULL)
+    {
+      return EINVAL;
+    }
+
+  return (ptw32_cond_timedwait (cond, NULL, rwlock, exclusive, -1, abstime));
+
+}				/* pthread_cond_timedwait_rwlock_np */
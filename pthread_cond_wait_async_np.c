@@ -0,0 +1,213 @@
+/*
+ * pthread_cond_wait_async_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+static int
+ptw32_cond_async_check (pthread_cond_t * cond, pthread_mutex_t * mutex)
+{
+  int result = 0;
+
+  if (cond == NULL || *cond == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (PTW32_IS_PSHARED (*cond))
+    {
+      return ENOTSUP;
+    }
+
+  if (*cond == PTHREAD_COND_INITIALIZER)
+    {
+      result = ptw32_cond_check_need_init (cond);
+    }
+
+  if (result != 0 && result != EBUSY)
+    {
+      return result;
+    }
+
+  return ptw32_async_mutex_check (mutex);
+}
+
+static int
+ptw32_cond_async_wait (pthread_cond_t * cond, pthread_mutex_t * mutex,
+		       ptw32_async_waiter_t * w)
+{
+  pthread_cond_t cv = *cond;
+
+  w->type = PTW32_ASYNC_COND;
+  w->object = cv;
+  w->mutex = *mutex;
+
+  /* Queued before the mutex is unlocked: no signal is missed */
+  ptw32_async_wait (w, (volatile VOID *) cv);
+
+  return pthread_mutex_unlock (mutex);
+}
+
+int
+pthread_cond_wait_async_np (pthread_cond_t * cond,
+			    pthread_mutex_t * mutex,
+			    pthread_pool_np_t pool,
+			    void (PTW32_CDECL * callback) (void *),
+			    void * arg)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits on a condition variable without blocking the
+      *      calling thread: unlocks 'mutex', and once the
+      *      condition variable has been signalled and the mutex
+      *      relocked, runs 'callback' on 'pool'.
+      *
+      * PARAMETERS
+      *      cond
+      *              pointer to a process private pthread_cond_t
+      *
+      *      mutex
+      *              pointer to a process private, non-robust
+      *              PTHREAD_MUTEX_NORMAL mutex, held by the caller
+      *
+      *      pool
+      *              the thread pool to run 'callback' on
+      *
+      *      callback
+      *              routine called with 'arg', owning the mutex
+      *
+      *      arg
+      *              passed to 'callback'
+      *
+      * DESCRIPTION
+      *      As pthread_cond_wait(), with the wait done without a
+      *      thread. pthread_cond_signal() releases the
+      *      asynchronous waiter that has waited the longest, if
+      *      any, before any blocked thread; pthread_cond_broadcast()
+      *      releases them all. A released waiter then waits for the
+      *      mutex as pthread_mutex_lock_async_np() does. As with
+      *      pthread_cond_wait(), 'callback' must recheck the
+      *      predicate.
+      *
+      *      The waiter is queued before the mutex is unlocked, so
+      *      no signal sent under the mutex afterwards is missed.
+      *      Neither the condition variable, the mutex nor the pool
+      *      may be destroyed while a waiter is pending.
+      *
+      *      This function is not a cancellation point.
+      *
+      * RESULTS
+      *              0               'callback' will be called,
+      *              EINVAL          an argument is invalid, the pool
+      *                              is being destroyed, or the mutex
+      *                              isn't a plain normal mutex,
+      *              ENOTSUP         'cond' or 'mutex' is process
+      *                              shared, or the library was built
+      *                              with PTW32_LOCKSTAT or
+      *                              PTW32_LOCKWATCH,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_async_waiter_t * w;
+  int result;
+
+  if ((result = ptw32_cond_async_check (cond, mutex)) != 0
+      || (result = ptw32_async_new (pool, callback, arg, &w)) != 0)
+    {
+      return result;
+    }
+
+  return ptw32_cond_async_wait (cond, mutex, w);
+}				/* pthread_cond_wait_async_np */
+
+int
+pthread_cond_wait_port_np (pthread_cond_t * cond,
+			   pthread_mutex_t * mutex,
+			   HANDLE port,
+			   void * key,
+			   void * overlapped)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits on a condition variable without blocking the
+      *      calling thread: unlocks 'mutex', and once the
+      *      condition variable has been signalled and the mutex
+      *      relocked, posts a completion packet to 'port'.
+      *
+      * PARAMETERS
+      *      cond, mutex
+      *              as for pthread_cond_wait_async_np()
+      *
+      *      port
+      *              an I/O completion port
+      *
+      *      key, overlapped
+      *              the completion key and OVERLAPPED pointer of
+      *              the packet, which reports no bytes transferred
+      *
+      * DESCRIPTION
+      *      As pthread_cond_wait_async_np(), but the thread that
+      *      dequeues the packet with GetQueuedCompletionStatus()
+      *      owns the mutex, so threads serving a completion port
+      *      can wait for condition variables along with I/O. The
+      *      port must stay open while the wait is pending.
+      *
+      * RESULTS
+      *              0               a packet will be posted,
+      *              EINVAL          an argument is invalid, or the
+      *                              mutex isn't a plain normal
+      *                              mutex,
+      *              ENOTSUP         as for
+      *                              pthread_cond_wait_async_np(),
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_async_waiter_t * w;
+  int result;
+
+  if ((result = ptw32_cond_async_check (cond, mutex)) != 0
+      || (result = ptw32_async_new_port (port, key, overlapped, &w)) != 0)
+    {
+      return result;
+    }
+
+  return ptw32_cond_async_wait (cond, mutex, w);
+}				/* pthread_cond_wait_port_np */
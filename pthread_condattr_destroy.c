@@ -75,7 +75,10 @@ pthread_condattr_destroy (pthread_condattr_t * attr)
     }
   else
     {
-      (void) free (*attr);
+      if (!PTW32_ATTR_IS_INITIALIZER (*attr))
+	{
+	  ptw32_object_free (*attr);
+	}
 
       *attr = NULL;
       result = 0;
@@ -84,7 +84,7 @@ pthread_condattr_getpshared (const pthread_condattr_t * attr, int *pshared)
 
   if ((attr != NULL && *attr != NULL) && (pshared != NULL))
     {
-      *pshared = (*attr)->pshared;
+      *pshared = PTW32_ATTR_READ (*attr, ptw32_condattr_default)->pshared;
       result = 0;
     }
   else
@@ -73,12 +73,18 @@ pthread_condattr_init (pthread_condattr_t * attr)
   pthread_condattr_t attr_result;
   int result = 0;
 
-  attr_result = (pthread_condattr_t) calloc (1, sizeof (*attr_result));
+  attr_result = (pthread_condattr_t) ptw32_object_alloc (sizeof (*attr_result), 0);
 
   if (attr_result == NULL)
     {
       result = ENOMEM;
     }
+  else
+    {
+      attr_result->clock = CLOCK_REALTIME;
+      attr_result->spin = 0;
+      attr_result->wakeOrder = PTHREAD_COND_WAKE_ANY_NP;
+    }
 
   *attr = attr_result;
 
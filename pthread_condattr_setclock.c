@@ -0,0 +1,98 @@
+/*
+ * pthread_condattr_setclock.c
+ *
+ * Description:
+ * This translation unit implements condition variables and their primitives.
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_condattr_setclock (pthread_condattr_t * attr, clockid_t clock_id)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets the clock that the abstime given to
+      *      pthread_cond_timedwait is measured against for
+      *      condition variables created with 'attr'.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_condattr_t
+      *
+      *      clock_id
+      *              must be one of:
+      *
+      *                      CLOCK_REALTIME
+      *                              The system time (the default)
+      *
+      *                      CLOCK_MONOTONIC
+      *                              QueryPerformanceCounter time,
+      *                              see pthread.h
+      *
+      *
+      * DESCRIPTION
+      *      Timed waits on a condition variable whose clock is
+      *      CLOCK_MONOTONIC are unaffected by changes to the
+      *      system time, and pthread_timechange_handler_np
+      *      leaves its waiters alone.
+      *
+      * RESULTS
+      *              0               successfully set attribute,
+      *              EINVAL          'attr' or 'clock_id' is invalid,
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result;
+
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_condattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
+  if ((attr != NULL && *attr != NULL) && PTW32_VALID_CLOCK(clock_id))
+    {
+      (*attr)->clock = clock_id;
+      result = 0;
+    }
+  else
+    {
+      result = EINVAL;
+    }
+
+  return result;
+
+}				/* pthread_condattr_setclock */
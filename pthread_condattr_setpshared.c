@@ -84,6 +84,11 @@ pthread_condattr_setpshared (pthread_condattr_t * attr, int pshared)
 {
   int result;
 
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_condattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
   if ((attr != NULL && *attr != NULL)
       && ((pshared == PTHREAD_PROCESS_SHARED)
 	  || (pshared == PTHREAD_PROCESS_PRIVATE)))
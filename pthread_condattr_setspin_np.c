@@ -0,0 +1,86 @@
+/*
+ * pthread_condattr_setspin_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_condattr_setspin_np (pthread_condattr_t * attr, int spin)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets the spin budget of condition variables
+      *      initialised with 'attr'.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_condattr_t
+      *
+      *      spin
+      *              maximum number of times a waiter polls the
+      *              condition variable for a signal before it
+      *              blocks, 0 (the default) to block immediately.
+      *
+      * DESCRIPTION
+      *      A waiter that is signalled while it spins takes the
+      *      signal without a kernel sleep and wakeup. The number
+      *      of spins actually made is tuned per condition
+      *      variable from recent history and never exceeds
+      *      'spin'. It has no effect on single processor systems
+      *      or on process shared condition variables.
+      *
+      * RESULTS
+      *              0               successfully set attribute,
+      *              EINVAL          'attr' or 'spin' is invalid,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_condattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
+  if (attr == NULL || *attr == NULL || spin < 0)
+    {
+      return EINVAL;
+    }
+
+  (*attr)->spin = spin;
+
+  return 0;
+}				/* pthread_condattr_setspin_np */
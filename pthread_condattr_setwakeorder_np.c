@@ -0,0 +1,99 @@
+/*
+ * pthread_condattr_setwakeorder_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_condattr_setwakeorder_np (pthread_condattr_t * attr, int order)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets which waiter a signal wakes on condition
+      *      variables initialised with 'attr'.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_condattr_t
+      *
+      *      order
+      *              one of:
+      *
+      *              PTHREAD_COND_WAKE_ANY_NP
+      *                      whichever waiter the system wakes,
+      *
+      *              PTHREAD_COND_WAKE_PRIORITY_NP
+      *                      the waiter with the highest scheduling
+      *                      priority, and of those the one that
+      *                      has waited longest.
+      *
+      * DESCRIPTION
+      *      A waiter's priority is its sched_priority, or the
+      *      priority lent to it by the PTHREAD_PRIO_INHERIT and
+      *      PTHREAD_PRIO_PROTECT mutexes it holds if that is
+      *      higher, when it starts to wait. Waiters queue in that
+      *      order, and each signal hands its wakeup to the head
+      *      of the queue. Process shared condition variables
+      *      can't order their waiters: pthread_cond_init()
+      *      returns ENOSYS for them.
+      *
+      *      The default value of the attribute is
+      *      PTHREAD_COND_WAKE_ANY_NP.
+      *
+      * RESULTS
+      *              0               successfully set attribute,
+      *              EINVAL          'attr' or 'order' is invalid,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_condattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
+  if (attr == NULL || *attr == NULL
+      || (order != PTHREAD_COND_WAKE_ANY_NP
+          && order != PTHREAD_COND_WAKE_PRIORITY_NP))
+    {
+      return EINVAL;
+    }
+
+  (*attr)->wakeOrder = order;
+
+  return 0;
+}				/* pthread_condattr_setwakeorder_np */
@@ -0,0 +1,80 @@
+/*
+ * pthread_counter_add_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_counter_add_np (pthread_counter_np_t counter, __int64 delta)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Adds to a sharded counter.
+      *
+      * PARAMETERS
+      *      counter
+      *              an instance of pthread_counter_np_t
+      *
+      *      delta
+      *              the amount to add, which may be negative
+      *
+      * DESCRIPTION
+      *      An interlocked add to the shard of the caller's
+      *      processor. The add is interlocked because the thread
+      *      may move to another processor meanwhile, but it
+      *      rarely contends and the shard's cache line rarely
+      *      moves.
+      *
+      * RESULTS
+      *              0               successfully added,
+      *              EINVAL          'counter' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG64 * shard;
+
+  if (counter == NULL
+      || 0 != pthread_percpu_this_np (counter->shards, (void **) &shard))
+    {
+      return EINVAL;
+    }
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_ADD_64 (shard, (LONG64) delta);
+
+  return 0;
+}				/* pthread_counter_add_np */
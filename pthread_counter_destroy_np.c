@@ -0,0 +1,71 @@
+/*
+ * pthread_counter_destroy_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_counter_destroy_np (pthread_counter_np_t * counter)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Frees a sharded counter.
+      *
+      * PARAMETERS
+      *      counter
+      *              pointer to an instance of pthread_counter_np_t
+      *
+      * RESULTS
+      *              0               successfully freed the counter,
+      *              EINVAL          'counter' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_counter_np_t c;
+
+  if (counter == NULL || (c = *counter) == NULL)
+    {
+      return EINVAL;
+    }
+
+  *counter = NULL;
+  (void) pthread_percpu_destroy_np (&c->shards);
+  ptw32_object_free (c);
+
+  return 0;
+}				/* pthread_counter_destroy_np */
@@ -0,0 +1,92 @@
+/*
+ * pthread_counter_init_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_counter_init_np (pthread_counter_np_t * counter)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Creates a sharded counter, initially zero.
+      *
+      * PARAMETERS
+      *      counter
+      *              pointer to an instance of pthread_counter_np_t
+      *
+      * DESCRIPTION
+      *      The counter keeps a 64 bit shard for each logical
+      *      processor (see pthread_percpu_create_np()). Adding
+      *      to it updates the shard of the caller's processor,
+      *      whose cache line normally stays with that processor,
+      *      so threads counting on different processors don't
+      *      contend. Reading sums the shards.
+      *
+      * RESULTS
+      *              0               successfully created the counter,
+      *              EINVAL          'counter' is invalid,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_counter_np_t c;
+  int result;
+
+  if (counter == NULL)
+    {
+      return EINVAL;
+    }
+
+  c = (pthread_counter_np_t) ptw32_object_alloc (sizeof (*c), 0);
+
+  if (c == NULL)
+    {
+      return ENOMEM;
+    }
+
+  if (0 != (result = pthread_percpu_create_np (&c->shards, sizeof (LONG64))))
+    {
+      ptw32_object_free (c);
+      return result;
+    }
+
+  *counter = c;
+
+  return 0;
+}				/* pthread_counter_init_np */
@@ -0,0 +1,91 @@
+/*
+ * pthread_counter_read_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_counter_read_np (pthread_counter_np_t counter, __int64 * value)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the value of a sharded counter.
+      *
+      * PARAMETERS
+      *      counter
+      *              an instance of pthread_counter_np_t
+      *
+      *      value
+      *              where to return the sum of the shards
+      *
+      * DESCRIPTION
+      *      Sums the shards one at a time, so adds made during the
+      *      read may or may not be counted, but every add that
+      *      finished before the read started is. Reading costs a
+      *      cache miss per processor and is meant to be much rarer
+      *      than adding.
+      *
+      * RESULTS
+      *              0               returned the value,
+      *              EINVAL          an argument is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG64 * shard;
+  LONG64 sum = 0;
+  int n;
+  int i;
+
+  if (counter == NULL || value == NULL)
+    {
+      return EINVAL;
+    }
+
+  n = pthread_percpu_count_np (counter->shards);
+
+  for (i = 0; i < n; i++)
+    {
+      (void) pthread_percpu_slot_np (counter->shards, i, (void **) &shard);
+      /* A single interlocked read, which 32 bit x86 needs for 64 bits */
+      sum += (LONG64) PTW32_INTERLOCKED_COMPARE_EXCHANGE_64 (shard, 0, 0);
+    }
+
+  *value = (__int64) sum;
+
+  return 0;
+}				/* pthread_counter_read_np */
@@ -0,0 +1,121 @@
+/*
+ * pthread_cputokens_acquire_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_cputokens_acquire_np (int min, int max, int * count)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Takes between 'min' and 'max' processor tokens, as
+      *      many as are free, waiting until at least 'min' are.
+      *
+      * PARAMETERS
+      *      min
+      *              the fewest tokens to take, 0 or more. With 0
+      *              the call never waits.
+      *
+      *      max
+      *              the most tokens to take, 'min' or more and at
+      *              least 1.
+      *
+      *      count
+      *              the tokens taken, to be given back with
+      *              pthread_cputokens_release_np().
+      *
+      * DESCRIPTION
+      *      Meant for code that starts threads of its own for
+      *      compute work, such as an adapter setting OpenMP's
+      *      omp_set_num_threads() to one plus the tokens it
+      *      gets before a parallel region. The calling thread
+      *      is not counted: a pool worker already holds a token
+      *      for itself. With no limit (PTHREAD_CPUTOKENS_OFF_NP)
+      *      'max' tokens are taken at once.
+      *
+      *      This is not a cancellation point.
+      *
+      * RESULTS
+      *              0               the tokens were taken,
+      *              EINVAL          an argument is invalid,
+      *              EDEADLK         'min' is more than there are.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (count == NULL || min < 0 || max < 1 || max < min)
+    {
+      return EINVAL;
+    }
+
+  if (ptw32_cpuTokens != PTHREAD_CPUTOKENS_OFF_NP
+      && (LONG) min > ptw32_cpuTokensTotal)
+    {
+      return EDEADLK;
+    }
+
+  *count = ptw32_cputokens_take (min, max);
+
+  return 0;
+}				/* pthread_cputokens_acquire_np */
+
+
+int
+pthread_cputokens_release_np (int count)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Gives back 'count' processor tokens taken with
+      *      pthread_cputokens_acquire_np(), by any thread.
+      *
+      * RESULTS
+      *              0               the tokens were given back,
+      *              EINVAL          'count' is negative.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (count < 0)
+    {
+      return EINVAL;
+    }
+
+  ptw32_cputokens_give (count);
+
+  return 0;
+}				/* pthread_cputokens_release_np */
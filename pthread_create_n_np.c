@@ -0,0 +1,111 @@
+/*
+ * pthread_create_n_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_create_n_np (pthread_t * threads, int n, const pthread_attr_t * attr,
+		     void *(PTW32_CDECL * start) (void *), void ** args)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Creates 'n' threads that run 'start', as 'n' calls of
+      *      pthread_create() would, for a fork-join that is
+      *      finished with pthread_join_n_np().
+      *
+      * PARAMETERS
+      *      threads
+      *              array of 'n' pthread_t that receive the new
+      *              threads
+      *
+      *      n
+      *              the number of threads to create
+      *
+      *      attr
+      *              thread attributes for all of them, or NULL
+      *
+      *      start
+      *              routine each thread runs
+      *
+      *      args
+      *              array of 'n' arguments, args[i] for the i'th
+      *              thread, or NULL to pass NULL to all of them
+      *
+      * DESCRIPTION
+      *      The threads are created in order. If one can't be, it
+      *      and the threads after it are not created and their
+      *      elements of 'threads' are set to a NULL handle; the
+      *      threads already created run on. pthread_join_n_np()
+      *      skips NULL handles, so the same array can be passed to
+      *      it either way.
+      *
+      * RESULTS
+      *              0               all the threads were created,
+      *              EINVAL          'threads' or 'start' is NULL, or 'n'
+      *                              is negative,
+      *              other           pthread_create()'s error for the
+      *                              first thread not created.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result = 0;
+  int i;
+
+  if (threads == NULL || start == NULL || n < 0)
+    {
+      return EINVAL;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      if (0 == result)
+	{
+	  result = pthread_create (&threads[i], attr, start,
+				   (args != NULL) ? args[i] : NULL);
+	}
+
+      if (0 != result)
+	{
+	  threads[i].p = NULL;
+	  threads[i].x = 0;
+	}
+    }
+
+  return result;
+}
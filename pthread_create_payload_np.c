@@ -0,0 +1,96 @@
+/*
+ * pthread_create_payload_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_create_payload_np (pthread_t * tid, const pthread_attr_t * attr,
+			   void *(PTW32_CDECL * start) (void *),
+			   const void * payload, size_t size)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Creates a thread that runs 'start', as pthread_create()
+      *      does, passing it a copy of the 'size' bytes at
+      *      'payload' instead of a pointer argument.
+      *
+      * PARAMETERS
+      *      tid
+      *              receives the new thread
+      *
+      *      attr
+      *              thread attributes, or NULL
+      *
+      *      start
+      *              routine the thread runs
+      *
+      *      payload
+      *              the bytes to copy, which may be NULL if 'size'
+      *              is 0
+      *
+      *      size
+      *              their number, at most PTHREAD_PAYLOAD_MAX_NP
+      *
+      * DESCRIPTION
+      *      The copy is made in the new thread's own struct, which
+      *      is recycled with it, so no memory is allocated for it.
+      *      'start' is passed a pointer to the copy, aligned for
+      *      any basic type; it is the thread's to read and write
+      *      until the thread ends, and is gone once it has been
+      *      joined or, if detached, has ended. With a 'size' of 0
+      *      'start' is passed NULL. The caller may reuse the
+      *      memory at 'payload' as soon as the call returns.
+      *
+      * RESULTS
+      *              0               successfully created thread,
+      *              EINVAL          'size' is more than
+      *                              PTHREAD_PAYLOAD_MAX_NP, or as
+      *                              pthread_create(),
+      *              EAGAIN          as pthread_create().
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (size > PTHREAD_PAYLOAD_MAX_NP || (size > 0 && payload == NULL))
+    {
+      return EINVAL;
+    }
+
+  return ptw32_create (tid, attr, start, NULL, payload, size);
+}
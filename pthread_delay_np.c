@@ -46,7 +46,11 @@
  *       This period ends at the current time plus the specified interval. The routine
  *       will not return before the end of the period is reached, but may return an
  *       arbitrary amount of time after the period has gone by. This can be due to
- *       system load, thread priorities, and system timer granularity. 
+ *       system load and thread priorities. The delay is measured to the 100
+ *       nanoseconds with the thread's high resolution timer where the system
+ *       provides one (Windows 10 1803 and later), otherwise to the system
+ *       clock tick. The last PTW32_DELAY_SPIN (50 microseconds) of a delay
+ *       polls the clock rather than sleeps.
  *
  *       Specifying an interval of zero (0) seconds and zero (0) nanoseconds is
  *       allowed and can be used to force the thread to give up the processor or to
@@ -66,6 +70,9 @@
  *           Successful completion.
  *  [EINVAL] 
  *           The value specified by interval is invalid. 
+ *  [ENOMEM] 
+ *           The calling thread's implicit POSIX handle or its cancel
+ *           event could not be created.
  *
  * Example
  *
@@ -78,17 +85,39 @@
  *  tsWait.tv_nsec = 500000000L;
  *  intRC = pthread_delay_np(&tsWait);
  */
+
+/* Sets *ts to 'delay' 100 nanosecond units after *now */
+static void
+ptw32_delay_after (const struct timespec * now, int64_t delay, struct timespec * ts)
+{
+  ts->tv_sec = now->tv_sec + (time_t) (delay / 10000000);
+  ts->tv_nsec = now->tv_nsec + (long) (delay % 10000000) * 100;
+
+  if (ts->tv_nsec >= 1000000000L)
+    {
+      ts->tv_sec++;
+      ts->tv_nsec -= 1000000000L;
+    }
+}
+
 int
 pthread_delay_np (struct timespec *interval)
 {
-  DWORD wait_time;
-  DWORD secs_in_millisecs;
+  struct timespec now;
+  struct timespec wake;
+  struct timespec end;
+  int64_t delay;
+  int64_t wait;
+  HANDLE handles[2];
+  DWORD nHandles;
   DWORD millisecs;
   DWORD status;
   pthread_t self;
   ptw32_thread_t * sp;
 
-  if (interval == NULL)
+  if (interval == NULL
+      || interval->tv_sec < 0
+      || interval->tv_nsec < 0 || interval->tv_nsec >= 1000000000L)
     {
       return EINVAL;
     }
@@ -96,35 +125,11 @@ pthread_delay_np (struct timespec *interval)
   if (interval->tv_sec == 0L && interval->tv_nsec == 0L)
     {
       pthread_testcancel ();
-      Sleep (0);
+      (void) sched_yield ();
       pthread_testcancel ();
       return (0);
     }
 
-  /* convert secs to millisecs */
-  secs_in_millisecs = (DWORD)interval->tv_sec * 1000L;
-
-  /* convert nanosecs to millisecs (rounding up) */
-  millisecs = (interval->tv_nsec + 999999L) / 1000000L;
-
-#if defined(__WATCOMC__)
-#pragma disable_message (124)
-#endif
-
-  /*
-   * Most compilers will issue a warning 'comparison always 0'
-   * because the variable type is unsigned, but we need to keep this
-   * for some reason I can't recall now.
-   */
-  if (0 > (wait_time = secs_in_millisecs + millisecs))
-    {
-      return EINVAL;
-    }
-
-#if defined(__WATCOMC__)
-#pragma enable_message (124)
-#endif
-
   if (NULL == (self = pthread_self ()).p)
     {
       return ENOMEM;
@@ -132,14 +137,61 @@ pthread_delay_np (struct timespec *interval)
 
   sp = (ptw32_thread_t *) self.p;
 
+  /*
+   * The delay ends at 'end', to the 100 nanoseconds (rounding up).
+   * The thread sleeps until 'wake', PTW32_DELAY_SPIN earlier, and
+   * polls the clock for the rest in case the timer wakes it late.
+   */
+  delay = (int64_t) interval->tv_sec * 10000000 + ((int64_t) interval->tv_nsec + 99) / 100;
+  wait = (delay > PTW32_DELAY_SPIN) ? delay - PTW32_DELAY_SPIN : 0;
+
+  ptw32_monotonic_now (&now);
+  ptw32_delay_after (&now, delay, &end);
+  ptw32_delay_after (&now, wait, &wake);
+
   if (sp->cancelState == PTHREAD_CANCEL_ENABLE)
     {
       /*
-       * Async cancellation won't catch us until wait_time is up.
+       * Async cancellation won't catch us until the delay is up.
        * Deferred cancellation will cancel us immediately.
        */
-      if (WAIT_OBJECT_0 ==
-	  (status = WaitForSingleObject (sp->cancelEvent, wait_time)))
+      if (ptw32_waitonaddress != NULL)
+	{
+	  /*
+	   * Wait for pthread_cancel to change our state, which it
+	   * wakes by address, rather than for the cancel event.
+	   */
+	  PThreadState state;
+
+	  while ((state = sp->state) < PThreadStateCancelPending
+		 && (PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_OTHER),
+		     ptw32_waitonaddress_abstime ((volatile VOID *) &sp->state, (PVOID) &state,
+						  sizeof (state), CLOCK_MONOTONIC, &wake)))
+	    {
+	      /* Woken, possibly spuriously */
+	    }
+
+	  status = (state < PThreadStateCancelPending) ? WAIT_TIMEOUT : WAIT_OBJECT_0;
+	}
+      else
+	{
+	  /* The thread's high resolution timer, if any, ends the wait */
+	  if (NULL == (handles[0] = ptw32_cancel_event (sp)))
+	    {
+	      return ENOMEM;
+	    }
+
+	  millisecs = ptw32_wait_timeout (CLOCK_MONOTONIC, &wake, &handles[1]);
+	  nHandles = (handles[1] != NULL) ? 2 : 1;
+
+	  PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_OTHER);
+	  if ((status = ptw32_wait_objects (nHandles, handles, millisecs)) == WAIT_OBJECT_0 + 1)
+	    {
+	      status = WAIT_TIMEOUT;
+	    }
+	}
+
+      if (WAIT_OBJECT_0 == status)
 	{
           ptw32_mcs_local_node_t stateLock;
 	  /*
@@ -165,7 +217,22 @@ pthread_delay_np (struct timespec *interval)
     }
   else
     {
-      Sleep (wait_time);
+      millisecs = ptw32_wait_timeout (CLOCK_MONOTONIC, &wake, &handles[0]);
+
+      if (handles[0] != NULL)
+	{
+	  PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_OTHER);
+	  (void) ptw32_wait_objects (1, handles, INFINITE);
+	}
+      else if (millisecs > 0)
+	{
+	  Sleep (millisecs);
+	}
+    }
+
+  while (ptw32_rel100nanosecs (CLOCK_MONOTONIC, &end) > 0)
+    {
+      PTW32_YIELD_PROCESSOR ();
     }
 
   return (0);
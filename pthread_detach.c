@@ -124,9 +124,16 @@ pthread_detach (pthread_t thread)
       if (destroyIt)
 	{
 	  /* The thread has exited or is exiting but has not been joined or
-	   * detached. Need to wait in case it's still exiting.
+	   * detached. Need to wait in case it's still exiting, unless it
+	   * has said that it's done with its struct (see pthread_join).
 	   */
-	  (void) WaitForSingleObject(tp->threadH, INFINITE);
+	  if (0 == tp->exited)
+	    {
+	      HANDLE exitH = PTW32_THREAD_EXIT_HANDLE(tp);
+
+	      PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_JOIN);
+	      (void) ptw32_wait_objects (1, &exitH, INFINITE);
+	    }
 	  ptw32_threadDestroy (thread);
 	}
     }
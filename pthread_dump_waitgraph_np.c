@@ -0,0 +1,123 @@
+/*
+ * pthread_dump_waitgraph_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_dump_waitgraph_np (pthread_waitedge_np_t * edges, int n, int * count)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Takes a snapshot of the threads blocked on process
+      *      private mutexes and the threads holding them.
+      *
+      * PARAMETERS
+      *      edges
+      *              array for the first 'n' edges found, or NULL if
+      *              'n' is 0
+      *
+      *      n
+      *              number of elements in 'edges'
+      *
+      *      count
+      *              receives the number of edges found, which may
+      *              be more than 'n'
+      *
+      * DESCRIPTION
+      *      Each edge is a thread blocked in pthread_mutex_lock()
+      *      or pthread_mutex_timedlock(), the mutex, and the
+      *      mutex's owner. The owner is a NULL handle for
+      *      PTHREAD_MUTEX_NORMAL mutexes, which don't track it, and
+      *      for a mutex released since the waiter blocked. Following
+      *      owners from edge to edge leads to the head of a convoy:
+      *      an owner that is not itself a waiter.
+      *
+      *      No lock is taken, so the application is not slowed
+      *      while the graph is read, and threads may block or wake
+      *      meanwhile: an edge may already be gone when returned.
+      *
+      * RESULTS
+      *              0               successful,
+      *              EINVAL          'count' is NULL, 'n' is negative
+      *                              or 'edges' is NULL and 'n' is not
+      *                              0.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_waitgraph_record_t * rec;
+  int found = 0;
+
+  if (count == NULL || n < 0 || (edges == NULL && n != 0))
+    {
+      return EINVAL;
+    }
+
+  for (rec = ptw32_waitgraphRecords; rec != NULL; rec = rec->next)
+    {
+      pthread_mutex_t mx = rec->mutex;
+      pthread_t waiter = rec->thread;
+
+      if (mx == NULL || rec->mutex != mx)
+	{
+	  continue;
+	}
+
+      if (found < n)
+	{
+	  edges[found].waiter = waiter;
+	  edges[found].mutex = mx;
+	  if (mx->kind != PTHREAD_MUTEX_NORMAL
+	      && mx->kind != PTHREAD_MUTEX_ELIDE_NP)
+	    {
+	      edges[found].owner = mx->ownerThread;
+	    }
+	  else
+	    {
+	      edges[found].owner.p = NULL;
+	      edges[found].owner.x = 0;
+	    }
+	}
+
+      found++;
+    }
+
+  *count = found;
+
+  return 0;
+}
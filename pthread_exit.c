@@ -71,7 +71,7 @@ pthread_exit (void *value_ptr)
    * Don't use pthread_self() to avoid creating an implicit POSIX thread handle
    * unnecessarily.
    */
-  sp = (ptw32_thread_t *) pthread_getspecific (ptw32_selfThreadKey);
+  sp = PTW32_SELF_THREAD ();
 
 #if defined(_UWIN)
   if (--pthread_count <= 0)
@@ -99,6 +99,15 @@ pthread_exit (void *value_ptr)
 
   sp->exitStatus = value_ptr;
 
+  /*
+   * Only returns if there is something to unwind on the way back to
+   * the start routine's caller. See ptw32_throw.c.
+   */
+  if (!sp->implicit)
+    {
+      ptw32_exit_return (sp);
+    }
+
   ptw32_throw (PTW32_EPS_EXIT);
 
   /* Never reached. */
@@ -0,0 +1,141 @@
+/*
+ * pthread_flightrec_dump_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_flightrec_dump_np (pthread_t thread, pthread_flightrec_np_t * events,
+			   int n, int * count)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Copies out the latest events in a thread's flight
+      *      recorder.
+      *
+      * PARAMETERS
+      *      thread
+      *              the target thread
+      *
+      *      events
+      *              array for up to 'n' events, or NULL if 'n' is 0
+      *
+      *      n
+      *              number of elements in 'events'
+      *
+      *      count
+      *              receives the number of events stored
+      *
+      * DESCRIPTION
+      *      Every thread keeps its last PTHREAD_FLIGHTREC_EVENTS_NP
+      *      slow path events: blocking on and waking from a mutex
+      *      or condition variable, waking the waiters of one,
+      *      creating a thread, exiting and being canceled. The
+      *      latest 'n' of them are stored in 'events', oldest
+      *      first, with their CLOCK_MONOTONIC times.
+      *
+      *      No lock is taken on the recorder, so it can be read
+      *      while the thread runs, or is hung. An event the thread
+      *      overwrites while it is being copied is left out.
+      *
+      * RESULTS
+      *              0               successful,
+      *              EINVAL          'count' is NULL, 'n' is negative
+      *                              or 'events' is NULL and 'n' is
+      *                              not 0,
+      *              ESRCH           'thread' does not exist.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result = 0;
+  ptw32_thread_t * tp;
+  ptw32_flightrec_t * rec;
+  ptw32_mcs_local_node_t reuseLock;
+  int found = 0;
+
+  if (count == NULL || n < 0 || (events == NULL && n != 0))
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_thread_reuse_lock, &reuseLock);
+
+  tp = (ptw32_thread_t *) thread.p;
+
+  if (NULL == tp || thread.x != tp->ptHandle.x || NULL == PTW32_THREAD_HANDLE (tp))
+    {
+      result = ESRCH;
+    }
+  else if ((rec = tp->flightRec) != NULL && rec->seqNumber == tp->seqNumber)
+    {
+      LONG next = rec->next;
+      LONG pos = next - PTW32_MIN (n, PTW32_FLIGHTREC_EVENTS);
+
+      for (pos = PTW32_MAX (pos, 0); pos != next; pos++)
+	{
+	  ptw32_flightrec_event_t * e = &rec->events[pos & (PTW32_FLIGHTREC_EVENTS - 1)];
+	  ptw32_flightrec_event_t copy;
+
+	  if ((LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &e->seq,
+							  (PTW32_INTERLOCKED_LONG) 0) != pos + 1)
+	    {
+	      continue;
+	    }
+
+	  copy = *e;
+
+	  if ((LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &e->seq,
+							  (PTW32_INTERLOCKED_LONG) 0) != pos + 1)
+	    {
+	      continue;
+	    }
+
+	  events[found].time = ptw32_ticks_to_ns (copy.time);
+	  events[found].event = (int) copy.event;
+	  events[found].object = (void *) copy.object;
+	  events[found].value = (__int64) copy.value;
+	  found++;
+	}
+    }
+
+  ptw32_mcs_lock_release (&reuseLock);
+
+  *count = found;
+
+  return result;
+}
@@ -0,0 +1,99 @@
+/*
+ * pthread_getcpuclockid.c
+ * 
+ * Description:
+ * POSIX clock functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_CLOCK_GETTIME)
+
+int
+pthread_getcpuclockid (pthread_t thread, clockid_t * clock_id)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function returns the ID of a clock that measures
+      *      a thread's CPU time.
+      *
+      * PARAMETERS
+      *      thread
+      *              the target thread
+      *
+      *      clock_id
+      *              where to return the clock ID
+      *
+      * DESCRIPTION
+      *      The clock can be read with clock_gettime() while the
+      *      thread runs, and is the thread's user plus kernel time
+      *      as CLOCK_THREAD_CPUTIME_ID is for the calling thread.
+      *      Reading another thread's clock needs OpenThread
+      *      (Windows 2000 and later). The clock of a fiber thread
+      *      (see pthread_attr_setfiber_np) is that of the worker
+      *      thread it last ran on.
+      *
+      * RESULTS
+      *              0               successfully returned the clock ID,
+      *              EINVAL          'clock_id' is NULL,
+      *              ESRCH           'thread' does not exist.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result;
+  ptw32_thread_t * tp;
+
+  if (NULL == clock_id)
+    {
+      return EINVAL;
+    }
+
+  if ((result = pthread_kill (thread, 0)) != 0)
+    {
+      return result;
+    }
+
+  tp = (ptw32_thread_t *) thread.p;
+
+  /*
+   * Thread clocks are the complement of the Windows thread ID, which
+   * keeps them negative and clear of the fixed clocks.
+   */
+  *clock_id = ~(clockid_t) tp->thread;
+
+  return 0;
+}				/* pthread_getcpuclockid */
+
+#endif /* PTW32_CLOCK_GETTIME */
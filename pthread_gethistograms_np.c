@@ -0,0 +1,112 @@
+/*
+ * pthread_gethistograms_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include <string.h>
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_gethistograms_np (pthread_hist_np_t * hists, int n)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the process wide histograms of the time
+      *      spent in blocking waits.
+      *
+      * PARAMETERS
+      *      hists
+      *              array for the histograms, indexed by
+      *              PTHREAD_HIST_*_NP, or NULL if 'n' is 0
+      *
+      *      n
+      *              number of elements in 'hists'; kinds from
+      *              PTHREAD_HIST_KINDS_NP on are left alone
+      *
+      * DESCRIPTION
+      *      Every wait by a POSIX thread that blocked in the
+      *      library is counted, by the kind of object waited on,
+      *      in the bucket of its duration (see
+      *      PTHREAD_HIST_LOWER_NP in pthread.h): the waits that
+      *      pthread_getstats_np counts, but those of all threads
+      *      since the process started, whether they still run or
+      *      not. Rwlock waits are split into waits to read and
+      *      waits to write. A lock that is woken and loses the race
+      *      for the lock again counts one wait for each time it
+      *      blocked.
+      *
+      *      Each thread counts its own waits and they are added
+      *      up here, so the histograms can be slightly behind the
+      *      waits that are going on.
+      *
+      * RESULTS
+      *              0               successful,
+      *              EINVAL          'n' is negative, or 'hists' is
+      *                              NULL and 'n' is not 0.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_hist_record_t * rec;
+  int kinds;
+  int k;
+  int b;
+
+  if (n < 0 || (hists == NULL && n != 0))
+    {
+      return EINVAL;
+    }
+
+  if ((kinds = PTW32_MIN (n, PTHREAD_HIST_KINDS_NP)) == 0)
+    {
+      return 0;
+    }
+
+  memset (hists, 0, kinds * sizeof (*hists));
+
+  for (rec = ptw32_histRecords; rec != NULL; rec = rec->next)
+    {
+      for (k = 0; k < kinds; k++)
+	{
+	  for (b = 0; b < PTHREAD_HIST_BUCKETS_NP; b++)
+	    {
+	      hists[k].count[b] += rec->count[k][b];
+	    }
+	}
+    }
+
+  return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * pthread_getlibstats_np.c
+ *
+ * Description:
+ * This translation unit implements miscellaneous thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_getlibstats_np (pthread_libstats_np_t * stats)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns process wide counts of the kernel objects the
+      *      library holds and the kernel calls it has made.
+      *
+      * PARAMETERS
+      *      stats
+      *              pointer to the structure to fill.
+      *
+      * DESCRIPTION
+      *      'events', 'semaphores', 'timers' and 'threadHandles'
+      *      are the events, semaphores, waitable timers and thread
+      *      handles the library holds now. The kernel objects
+      *      behind process shared objects are named, may be held
+      *      by other processes too, and are not counted.
+      *      'threads' is the POSIX threads, implicit ones included,
+      *      that have not yet been joined, or detached and ended.
+      *
+      *      The remaining fields count since the process started:
+      *      waits that entered the kernel, by the kind of object
+      *      waited on; SetEvent and ReleaseSemaphore calls; the
+      *      events internal locks created for their waiters; and
+      *      pthread_cancel() requests.
+      *      Where the system lacks WaitOnAddress, condition
+      *      variables and barriers block on internal semaphores
+      *      and their waits are counted as semaphore waits.
+      *
+      *      Each field is read atomically but the structure as a
+      *      whole is not a snapshot.
+      *
+      * RESULTS
+      *              0               successfully retrieved the counts,
+      *              EINVAL          'stats' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG64 v[PTW32_LIBSTAT_COUNT];
+  int i;
+
+  if (stats == NULL)
+    {
+      return EINVAL;
+    }
+
+  for (i = 0; i < PTW32_LIBSTAT_COUNT; i++)
+    {
+      v[i] = PTW32_INTERLOCKED_EXCHANGE_ADD_64 (&ptw32_libStats[i], (LONG64) 0);
+    }
+
+  stats->events = (unsigned __int64) v[PTW32_LIBSTAT_EVENTS];
+  stats->semaphores = (unsigned __int64) v[PTW32_LIBSTAT_SEMAPHORES];
+  stats->timers = (unsigned __int64) v[PTW32_LIBSTAT_TIMERS];
+  stats->threadHandles = (unsigned __int64) v[PTW32_LIBSTAT_THREAD_HANDLES];
+  stats->mutexWaits = (unsigned __int64) v[PTW32_LIBSTAT_WAIT_MUTEX];
+  stats->condWaits = (unsigned __int64) v[PTW32_LIBSTAT_WAIT_COND];
+  stats->rwlockWaits = (unsigned __int64) v[PTW32_LIBSTAT_WAIT_RWLOCK];
+  stats->semWaits = (unsigned __int64) v[PTW32_LIBSTAT_WAIT_SEM];
+  stats->barrierWaits = (unsigned __int64) v[PTW32_LIBSTAT_WAIT_BARRIER];
+  stats->joinWaits = (unsigned __int64) v[PTW32_LIBSTAT_WAIT_JOIN];
+  stats->otherWaits = (unsigned __int64) v[PTW32_LIBSTAT_WAIT_OTHER];
+  stats->setEvents = (unsigned __int64) v[PTW32_LIBSTAT_SET_EVENTS];
+  stats->releaseSemaphores = (unsigned __int64) v[PTW32_LIBSTAT_RELEASE_SEMAPHORES];
+  stats->mcsEvents = (unsigned __int64) v[PTW32_LIBSTAT_MCS_EVENTS];
+  stats->threads = (unsigned __int64) v[PTW32_LIBSTAT_THREADS];
+  stats->cancellations = (unsigned __int64) v[PTW32_LIBSTAT_CANCELS];
+
+  return 0;
+}				/* pthread_getlibstats_np */
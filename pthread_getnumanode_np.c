@@ -0,0 +1,131 @@
+/*
+ * pthread_getnumanode_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_getnumanode_np (pthread_t thread, int * node)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the NUMA node that a thread is placed on.
+      *
+      * PARAMETERS
+      *      thread
+      *              the target thread
+      *
+      *      node
+      *              where to return the node
+      *
+      * DESCRIPTION
+      *      The node is the one all of the CPUs in the thread's
+      *      affinity set belong to, as set by
+      *      pthread_setaffinity_np() or with
+      *      pthread_attr_setnumanode_np(). If the thread may run
+      *      on CPUs of more than one node, -1 is returned.
+      *
+      * RESULTS
+      *              0               successfully returned the node,
+      *              EINVAL          'node' is NULL,
+      *              ESRCH           'thread' does not exist,
+      *              ENOMEM          no memory for the topology,
+      *              ENOSYS          the platform has no CPU affinity.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if ! defined(HAVE_CPU_AFFINITY)
+
+  return ENOSYS;
+
+#else
+
+  int result = 0;
+  ptw32_thread_t * tp;
+  ptw32_mcs_local_node_t reuseLock;
+  ptw32_topology_t * topology;
+
+  if (NULL == node)
+    {
+      return EINVAL;
+    }
+
+  if (NULL == (topology = ptw32_gettopology ()))
+    {
+      return ENOMEM;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_thread_reuse_lock, &reuseLock);
+
+  tp = (ptw32_thread_t *) thread.p;
+
+  if (NULL == tp || thread.x != tp->ptHandle.x || NULL == PTW32_THREAD_HANDLE (tp))
+    {
+      result = ESRCH;
+    }
+  else
+    {
+      int cpu;
+
+      *node = -1;
+
+      if (tp->implicit && 0 == CPU_COUNT (&tp->cpuset))
+	{
+	  ptw32_implicit_affinity (tp);
+	}
+
+      for (cpu = 0; cpu < (int) CPU_SETSIZE; cpu++)
+	{
+	  if (CPU_ISSET (cpu, &tp->cpuset))
+	    {
+	      if (*node != -1 && *node != topology->node[cpu])
+		{
+		  *node = -1;
+		  break;
+		}
+	      *node = topology->node[cpu];
+	    }
+	}
+    }
+
+  ptw32_mcs_lock_release (&reuseLock);
+
+  return result;
+
+#endif
+}
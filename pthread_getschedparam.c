@@ -57,7 +57,7 @@ pthread_getschedparam (pthread_t thread, int *policy,
     }
 
   /* Fill out the policy. */
-  *policy = SCHED_OTHER;
+  *policy = ((ptw32_thread_t *)thread.p)->sched_policy;
 
   /*
    * This function must return the priority value set by
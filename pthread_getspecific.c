@@ -69,6 +69,17 @@ pthread_getspecific (pthread_key_t key)
     {
       ptr = NULL;
     }
+  else if (PTW32_KEY_IN_TABLE(key))
+    {
+      ptr = ptw32_tsd_table_get (key);
+    }
+#if defined(PTW32_TEB_TLS_VALUE)
+  else if (key->key < PTW32_TEB_TLS_SLOTS)
+    {
+      /* Leaves the last error untouched */
+      ptr = PTW32_TEB_TLS_VALUE(key->key);
+    }
+#endif
   else
     {
       int lasterror = GetLastError ();
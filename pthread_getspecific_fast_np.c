@@ -0,0 +1,88 @@
+/*
+ * pthread_getspecific_fast_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+void *
+pthread_getspecific_fast_np (pthread_key_t key)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      As pthread_getspecific(), but the calling thread's
+      *      last error code (GetLastError() and WSAGetLastError())
+      *      may be changed.
+      *
+      * PARAMETERS
+      *      key
+      *              an instance of pthread_key_t
+      *
+      *
+      * DESCRIPTION
+      *      pthread_getspecific() saves and restores the last
+      *      error code around TlsGetValue(), which clears it. This
+      *      function doesn't, for callers that don't depend on the
+      *      error code surviving the call. Where the library reads
+      *      the TLS slot directly from the thread's TEB both
+      *      functions cost the same and neither changes the error
+      *      code.
+      *
+      * RESULTS
+      *              key value or NULL on failure
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (key == NULL)
+    {
+      return NULL;
+    }
+
+  if (PTW32_KEY_IN_TABLE(key))
+    {
+      return ptw32_tsd_table_get (key);
+    }
+
+#if defined(PTW32_TEB_TLS_VALUE)
+  if (key->key < PTW32_TEB_TLS_SLOTS)
+    {
+      return PTW32_TEB_TLS_VALUE(key->key);
+    }
+#endif
+
+  return TlsGetValue (key->key);
+}				/* pthread_getspecific_fast_np */
@@ -0,0 +1,131 @@
+/*
+ * pthread_getstats_np.c
+ * 
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_getstats_np (pthread_t thread, pthread_threadstats_np_t * stats)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns a thread's CPU time and blocking statistics.
+      *
+      * PARAMETERS
+      *      thread
+      *              the target thread
+      *
+      *      stats
+      *              where to return the statistics
+      *
+      * DESCRIPTION
+      *      userTime and kernelTime are the thread's CPU times
+      *      from GetThreadTimes, and cycles its count from
+      *      QueryThreadCycleTime, or 0 where that is not available
+      *      (before Windows Vista). A fiber thread (see
+      *      pthread_attr_setfiber_np) reports the times of the
+      *      worker it last ran on.
+      *
+      *      waits counts the mutex, condition variable, rwlock,
+      *      semaphore, barrier, join and delay waits by the thread that
+      *      blocked, and waitTime the time spent in them. Waits
+      *      that were satisfied without blocking or that spun
+      *      briefly are not counted. cancelRequests counts the
+      *      pthread_cancel() calls made on the thread.
+      *
+      *      Times are in nanoseconds. The counts are read without
+      *      stopping the thread, so they can be slightly behind.
+      *
+      * RESULTS
+      *              0               successfully returned the statistics,
+      *              EINVAL          'stats' is NULL,
+      *              ESRCH           'thread' does not exist.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result = 0;
+  ptw32_thread_t * tp;
+  ptw32_mcs_local_node_t reuseLock;
+  ptw32_mcs_local_node_t stateLock;
+  FILETIME creation, exitTime, kernel, user;
+  ULONG64 cycles;
+
+  if (NULL == stats)
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_thread_reuse_lock, &reuseLock);
+
+  tp = (ptw32_thread_t *) thread.p;
+
+  if (NULL == tp || thread.x != tp->ptHandle.x || NULL == PTW32_THREAD_HANDLE (tp))
+    {
+      result = ESRCH;
+    }
+  else
+    {
+      memset (stats, 0, sizeof (*stats));
+
+      if (GetThreadTimes (tp->threadH, &creation, &exitTime, &kernel, &user))
+	{
+	  stats->userTime = ((((unsigned __int64) user.dwHighDateTime << 32)
+			      + user.dwLowDateTime) * 100);
+	  stats->kernelTime = ((((unsigned __int64) kernel.dwHighDateTime << 32)
+				+ kernel.dwLowDateTime) * 100);
+	}
+
+      if (ptw32_querythreadcycletime != NULL
+	  && ptw32_querythreadcycletime (tp->threadH, &cycles))
+	{
+	  stats->cycles = cycles;
+	}
+
+      stats->waits = tp->waits;
+      stats->waitTime = ptw32_ticks_to_ns (tp->waitTime);
+
+      ptw32_mcs_lock_acquire (&tp->stateLock, &stateLock);
+      stats->cancelRequests = tp->cancelRequests;
+      ptw32_mcs_lock_release (&stateLock);
+    }
+
+  ptw32_mcs_lock_release (&reuseLock);
+
+  return result;
+}
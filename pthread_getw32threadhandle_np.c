@@ -49,7 +49,7 @@
 HANDLE
 pthread_getw32threadhandle_np (pthread_t thread)
 {
-  return ((ptw32_thread_t *)thread.p)->threadH;
+  return PTW32_THREAD_HANDLE ((ptw32_thread_t *)thread.p);
 }
 
 /*
@@ -0,0 +1,262 @@
+/*
+ * pthread_group_add_np.c
+ *
+ * Description:
+ * This translation unit implements thread groups.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Takes tp off the list of group g. Called holding g's lock.
+ */
+static void
+ptw32_group_unlink (pthread_group_np_t g, ptw32_thread_t * tp)
+{
+  if (tp->groupPrev != NULL)
+    {
+      tp->groupPrev->groupNext = tp->groupNext;
+    }
+  else
+    {
+      g->members = tp->groupNext;
+    }
+
+  if (tp->groupNext != NULL)
+    {
+      tp->groupNext->groupPrev = tp->groupPrev;
+    }
+
+  tp->groupNext = NULL;
+  tp->groupPrev = NULL;
+  g->nMembers--;
+}
+
+
+int
+pthread_group_add_np (pthread_group_np_t group, pthread_t thread)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Makes 'thread' a member of 'group'.
+      *
+      * PARAMETERS
+      *      group
+      *              an instance of pthread_group_np_t
+      *
+      *      thread
+      *              the thread to add; it may have ended, but not
+      *              yet have been joined
+      *
+      * DESCRIPTION
+      *      A thread belongs to at most one group, which it
+      *      leaves when it is joined, when it ends detached or
+      *      when it is removed. A thread added to a group that
+      *      has been cancelled is cancelled.
+      *
+      * RESULTS
+      *              0               the thread is a member,
+      *              EINVAL          'group' is invalid,
+      *              ESRCH           the thread could not be found,
+      *              EBUSY           the thread belongs to another
+      *                              group.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * tp;
+  ptw32_mcs_local_node_t node;
+  ptw32_mcs_local_node_t groupLock;
+  ptw32_mcs_local_node_t stateLock;
+  int cancel = PTW32_FALSE;
+  int result = 0;
+
+  if (group == NULL)
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_thread_reuse_lock, &node);
+
+  tp = (ptw32_thread_t *) thread.p;
+
+  if (NULL == tp || thread.x != tp->ptHandle.x)
+    {
+      result = ESRCH;
+    }
+  else
+    {
+      ptw32_mcs_lock_acquire (&group->lock, &groupLock);
+      ptw32_mcs_lock_acquire (&tp->stateLock, &stateLock);
+
+      if (NULL == tp->group)
+	{
+	  tp->group = group;
+	  tp->groupPrev = NULL;
+	  tp->groupNext = group->members;
+	  if (group->members != NULL)
+	    {
+	      group->members->groupPrev = tp;
+	    }
+	  group->members = tp;
+	  group->nMembers++;
+	  cancel = group->cancelled;
+	}
+      else if (PTW32_GROUP_CLOSED == tp->group)
+	{
+	  /* Its struct is on the way to reuse */
+	  result = ESRCH;
+	}
+      else if (group != tp->group)
+	{
+	  result = EBUSY;
+	}
+
+      ptw32_mcs_lock_release (&stateLock);
+      ptw32_mcs_lock_release (&groupLock);
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  if (cancel)
+    {
+      (void) pthread_cancel (thread);
+    }
+
+  return result;
+}				/* pthread_group_add_np */
+
+
+int
+pthread_group_remove_np (pthread_group_np_t group, pthread_t thread)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Takes 'thread' out of 'group'.
+      *
+      * PARAMETERS
+      *      group
+      *              an instance of pthread_group_np_t
+      *
+      *      thread
+      *              a member of 'group'
+      *
+      * DESCRIPTION
+      *      The thread is no longer cancelled, joined or changed
+      *      with the group. A cancellation already requested
+      *      still stands.
+      *
+      * RESULTS
+      *              0               the thread has been removed,
+      *              EINVAL          'group' is invalid or the thread
+      *                              is not a member of it,
+      *              ESRCH           the thread could not be found.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * tp;
+  ptw32_mcs_local_node_t node;
+  ptw32_mcs_local_node_t groupLock;
+  ptw32_mcs_local_node_t stateLock;
+  int result = 0;
+
+  if (group == NULL)
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_thread_reuse_lock, &node);
+
+  tp = (ptw32_thread_t *) thread.p;
+
+  if (NULL == tp || thread.x != tp->ptHandle.x)
+    {
+      result = ESRCH;
+    }
+  else
+    {
+      ptw32_mcs_lock_acquire (&group->lock, &groupLock);
+      ptw32_mcs_lock_acquire (&tp->stateLock, &stateLock);
+
+      if (group != tp->group)
+	{
+	  result = EINVAL;
+	}
+      else
+	{
+	  tp->group = NULL;
+	  ptw32_group_unlink (group, tp);
+	}
+
+      ptw32_mcs_lock_release (&stateLock);
+      ptw32_mcs_lock_release (&groupLock);
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}				/* pthread_group_remove_np */
+
+
+void
+ptw32_group_leave (ptw32_thread_t * tp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Takes thread tp, which is being destroyed, out of its
+      *      group, if it has one, and closes it to
+      *      pthread_group_add_np() until it is reused. Until then
+      *      the thread's struct and handles stay valid to the
+      *      group functions, which hold the group's lock.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_group_np_t g;
+  ptw32_mcs_local_node_t stateLock;
+  ptw32_mcs_local_node_t groupLock;
+
+  ptw32_mcs_lock_acquire (&tp->stateLock, &stateLock);
+  g = tp->group;
+  tp->group = PTW32_GROUP_CLOSED;
+  ptw32_mcs_lock_release (&stateLock);
+
+  if (g != NULL && g != PTW32_GROUP_CLOSED)
+    {
+      ptw32_mcs_lock_acquire (&g->lock, &groupLock);
+      ptw32_group_unlink (g, tp);
+      ptw32_mcs_lock_release (&groupLock);
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * pthread_group_cancel_np.c
+ *
+ * Description:
+ * This translation unit implements thread groups.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_group_cancel_np (pthread_group_np_t group)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Requests cancellation of every member of 'group'.
+      *
+      * PARAMETERS
+      *      group
+      *              an instance of pthread_group_np_t
+      *
+      * DESCRIPTION
+      *      Each member is cancelled as by pthread_cancel(), in
+      *      one pass over the group under its lock rather than
+      *      with a lookup of each thread. Threads added to the
+      *      group afterwards are cancelled as they are added.
+      *      Members that are already ending are passed over. If
+      *      the calling thread is a member it is cancelled last.
+      *
+      * RESULTS
+      *              0               cancellation has been requested,
+      *              EINVAL          'group' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp = PTW32_SELF_THREAD ();
+  ptw32_thread_t * tp;
+  ptw32_mcs_local_node_t groupLock;
+  int cancelSelf = PTW32_FALSE;
+
+  if (group == NULL)
+    {
+      return EINVAL;
+    }
+
+  /* Not under the group lock: it may load a DLL */
+  ptw32_cancel_initialize ();
+
+  ptw32_mcs_lock_acquire (&group->lock, &groupLock);
+
+  group->cancelled = PTW32_TRUE;
+
+  for (tp = group->members; tp != NULL; tp = tp->groupNext)
+    {
+      if (tp == sp)
+	{
+	  /* Mustn't unwind holding the lock */
+	  cancelSelf = PTW32_TRUE;
+	}
+      else
+	{
+	  (void) ptw32_cancel_thread (tp, PTW32_FALSE);
+	}
+    }
+
+  ptw32_mcs_lock_release (&groupLock);
+
+  if (cancelSelf)
+    {
+      (void) pthread_cancel (sp->ptHandle);
+    }
+
+  return 0;
+}				/* pthread_group_cancel_np */
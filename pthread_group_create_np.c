@@ -0,0 +1,87 @@
+/*
+ * pthread_group_create_np.c
+ *
+ * Description:
+ * This translation unit implements thread groups.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_group_create_np (pthread_group_np_t * group)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Creates an empty thread group.
+      *
+      * PARAMETERS
+      *      group
+      *              pointer to an instance of pthread_group_np_t
+      *
+      * DESCRIPTION
+      *      Threads join the group with pthread_group_add_np()
+      *      and leave it when they are joined, or end detached,
+      *      or are removed.
+      *
+      * RESULTS
+      *              0               successfully created group,
+      *              EINVAL          'group' is invalid,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_group_np_t g;
+
+  if (group == NULL)
+    {
+      return EINVAL;
+    }
+
+  g = (pthread_group_np_t) ptw32_object_alloc (sizeof (*g), 0);
+
+  if (g == NULL)
+    {
+      return ENOMEM;
+    }
+
+  g->lock = NULL;
+  g->members = NULL;
+  g->nMembers = 0;
+  g->cancelled = PTW32_FALSE;
+
+  *group = g;
+
+  return 0;
+}				/* pthread_group_create_np */
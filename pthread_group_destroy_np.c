@@ -0,0 +1,87 @@
+/*
+ * pthread_group_destroy_np.c
+ *
+ * Description:
+ * This translation unit implements thread groups.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_group_destroy_np (pthread_group_np_t * group)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Destroys a thread group.
+      *
+      * PARAMETERS
+      *      group
+      *              pointer to an instance of pthread_group_np_t
+      *
+      * DESCRIPTION
+      *      The group must be empty: its threads have all been
+      *      joined, ended detached or been removed.
+      *
+      * RESULTS
+      *              0               successfully destroyed group,
+      *              EINVAL          'group' is invalid,
+      *              EBUSY           the group has members.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_group_np_t g;
+  ptw32_mcs_local_node_t node;
+  int result = 0;
+
+  if (group == NULL || (g = *group) == NULL)
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_lock_acquire (&g->lock, &node);
+  if (g->nMembers > 0)
+    {
+      result = EBUSY;
+    }
+  ptw32_mcs_lock_release (&node);
+
+  if (0 == result)
+    {
+      *group = NULL;
+      ptw32_object_free (g);
+    }
+
+  return result;
+}				/* pthread_group_destroy_np */
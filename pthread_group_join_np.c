@@ -0,0 +1,145 @@
+/*
+ * pthread_group_join_np.c
+ *
+ * Description:
+ * This translation unit implements thread groups.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Frees the handle array, also when the caller is cancelled while
+ * joining.
+ */
+static void PTW32_CDECL
+ptw32_group_join_cleanup (void * arg)
+{
+  free (arg);
+}
+
+
+int
+pthread_group_join_np (pthread_group_np_t group)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits for the joinable members of 'group' to
+      *      terminate and joins them.
+      *
+      * PARAMETERS
+      *      group
+      *              an instance of pthread_group_np_t
+      *
+      * DESCRIPTION
+      *      The members that are joinable when it is called,
+      *      other than the calling thread, are joined together
+      *      by pthread_join_n_np(), so the caller is woken once
+      *      rather than once per thread. Their exit values are
+      *      discarded. Detached members are not waited for. Each
+      *      thread joined leaves the group.
+      *
+      *      This is a cancellation point; a cancelled caller has
+      *      joined none of the threads.
+      *
+      * RESULTS
+      *              0               the members have been joined,
+      *              EINVAL          'group' is invalid,
+      *              ENOMEM          insufficient memory,
+      *              others          as pthread_join_n_np().
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp = PTW32_SELF_THREAD ();
+  ptw32_thread_t * tp;
+  ptw32_mcs_local_node_t groupLock;
+  pthread_t * threads = NULL;
+  int size = 0;
+  int n = 0;
+  int result;
+
+  if (group == NULL)
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_lock_acquire (&group->lock, &groupLock);
+
+  while (size < group->nMembers)
+    {
+      /* Don't allocate holding the lock */
+      size = group->nMembers;
+      ptw32_mcs_lock_release (&groupLock);
+
+      free (threads);
+      threads = (pthread_t *) malloc (size * sizeof (pthread_t));
+
+      if (threads == NULL)
+	{
+	  return ENOMEM;
+	}
+
+      ptw32_mcs_lock_acquire (&group->lock, &groupLock);
+    }
+
+  for (tp = group->members; tp != NULL; tp = tp->groupNext)
+    {
+      if (tp != sp && PTHREAD_CREATE_DETACHED != tp->detachState)
+	{
+	  threads[n++] = tp->ptHandle;
+	}
+    }
+
+  ptw32_mcs_lock_release (&groupLock);
+
+  if (0 == n)
+    {
+      free (threads);
+      return 0;
+    }
+
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth(0)
+#endif
+  pthread_cleanup_push (ptw32_group_join_cleanup, (void *) threads);
+
+  result = pthread_join_n_np (threads, n, NULL);
+
+  pthread_cleanup_pop (1);
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth()
+#endif
+
+  return result;
+}				/* pthread_group_join_np */
@@ -0,0 +1,142 @@
+/*
+ * pthread_group_setaffinity_np.c
+ *
+ * Description:
+ * This translation unit implements thread groups.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_group_setaffinity_np (pthread_group_np_t group, size_t cpusetsize,
+			      const cpu_set_t * cpuset)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets the CPU affinity of every member of 'group'.
+      *
+      * PARAMETERS
+      *      group
+      *              an instance of pthread_group_np_t
+      *
+      *      cpusetsize
+      *              the size of cpuset, usually sizeof(cpu_set_t);
+      *              CPUs beyond it are taken to be clear
+      *
+      *      cpuset
+      *              the new CPU set
+      *
+      * DESCRIPTION
+      *      As pthread_setaffinity_np() for each member, but the
+      *      set is intersected with the process's CPUs once for
+      *      all of them. Members that fail keep their affinity
+      *      and the others are still set.
+      *
+      * RESULTS
+      *              0               the members' affinity is set,
+      *              EINVAL          'group' is invalid or the set
+      *                              has none of the process's CPUs,
+      *              EFAULT          'cpuset' is NULL,
+      *              EAGAIN          a member's affinity could not
+      *                              be set,
+      *              ENOSYS          the platform does not support
+      *                              this function.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if ! defined(HAVE_CPU_AFFINITY)
+
+  return ENOSYS;
+
+#else
+
+  ptw32_thread_t * tp;
+  ptw32_mcs_local_node_t groupLock;
+  cpu_set_t processCpuset;
+  cpu_set_t newMask;
+  int result;
+
+  if (group == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (cpuset == NULL)
+    {
+      return EFAULT;
+    }
+
+  if (0 != (result = ptw32_getprocessaffinity (&processCpuset)))
+    {
+      return result;
+    }
+
+  ptw32_cpusetcopy (&newMask, sizeof (newMask), cpuset, cpusetsize);
+  CPU_AND (&newMask, &processCpuset, &newMask);
+
+  if (CPU_COUNT (&newMask) == 0)
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_lock_acquire (&group->lock, &groupLock);
+
+  for (tp = group->members; tp != NULL; tp = tp->groupNext)
+    {
+      HANDLE threadH = PTW32_THREAD_HANDLE (tp);
+      int r;
+
+      if (NULL == threadH)
+	{
+	  continue;
+	}
+
+      if (0 == (r = ptw32_setthreadaffinity (threadH, &newMask, PTW32_FALSE)))
+	{
+	  /* See pthread_setaffinity_np() */
+	  tp->cpuset = newMask;
+	}
+      else if (0 == result)
+	{
+	  result = r;
+	}
+    }
+
+  ptw32_mcs_lock_release (&groupLock);
+
+  return result;
+
+#endif
+}				/* pthread_group_setaffinity_np */
@@ -0,0 +1,104 @@
+/*
+ * pthread_group_setschedparam_np.c
+ *
+ * Description:
+ * This translation unit implements thread groups.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_group_setschedparam_np (pthread_group_np_t group, int policy,
+				const struct sched_param * param)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets the scheduling policy and priority of every
+      *      member of 'group'.
+      *
+      * PARAMETERS
+      *      group
+      *              an instance of pthread_group_np_t
+      *
+      *      policy
+      *              the scheduling policy, as for
+      *              pthread_setschedparam()
+      *
+      *      param
+      *              the scheduling parameters
+      *
+      * DESCRIPTION
+      *      As pthread_setschedparam() for each member, with the
+      *      policy and priority checked once for all of them.
+      *      Members that fail keep their priority and the others
+      *      are still set.
+      *
+      * RESULTS
+      *              0               the members' priority is set,
+      *              EINVAL          'group', 'policy' or the
+      *                              priority is invalid, or a
+      *                              member's priority could not
+      *                              be set.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * tp;
+  ptw32_mcs_local_node_t groupLock;
+  int result = 0;
+
+  if (group == NULL || param == NULL
+      || policy < SCHED_MIN || policy > SCHED_MAX
+      || param->sched_priority < sched_get_priority_min (policy)
+      || param->sched_priority > sched_get_priority_max (policy))
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_lock_acquire (&group->lock, &groupLock);
+
+  for (tp = group->members; tp != NULL; tp = tp->groupNext)
+    {
+      int r = ptw32_setthreadpriority (tp->ptHandle, policy, param->sched_priority);
+
+      if (0 != r && 0 == result)
+	{
+	  result = r;
+	}
+    }
+
+  ptw32_mcs_lock_release (&groupLock);
+
+  return result;
+}				/* pthread_group_setschedparam_np */
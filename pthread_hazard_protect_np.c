@@ -0,0 +1,144 @@
+/*
+ * pthread_hazard_protect_np.c
+ *
+ * Description:
+ * This translation unit implements hazard pointer primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_hazard_protect_np (int slot, void * volatile * src, void ** ptr)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Loads a shared pointer and protects it from being
+      *      reclaimed.
+      *
+      * PARAMETERS
+      *      slot
+      *              the calling thread's hazard slot to use, from
+      *              0 to PTHREAD_HAZARD_SLOTS_NP - 1
+      *
+      *      src
+      *              the shared location holding the pointer
+      *
+      *      ptr
+      *              receives the pointer, which may be NULL
+      *
+      * DESCRIPTION
+      *      Publishes the pointer in 'slot' and checks that 'src'
+      *      still holds it, repeating if not. The object it points
+      *      to is then not reclaimed (see pthread_hazard_retire_np)
+      *      until the slot is cleared or reused, even if it is
+      *      unlinked and retired meanwhile. A slot protects one
+      *      pointer at a time.
+      *
+      * RESULTS
+      *              0               *ptr is set and protected,
+      *              EINVAL          'slot', 'src' or 'ptr' is invalid,
+      *              ENOMEM          insufficient memory for the
+      *                              thread's slots.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp;
+  ptw32_hazard_record_t * rec;
+  void * p;
+
+  if (slot < 0 || slot >= PTHREAD_HAZARD_SLOTS_NP || src == NULL || ptr == NULL)
+    {
+      return EINVAL;
+    }
+
+  sp = (ptw32_thread_t *) pthread_self ().p;
+
+  if (sp == NULL || (rec = ptw32_hazard_register (sp)) == NULL)
+    {
+      return ENOMEM;
+    }
+
+  /*
+   * The exchange is a full barrier, so the slot is visible to scans
+   * before 'src' is read again. If 'src' still holds the pointer it
+   * wasn't retired before the slot was set.
+   */
+  do
+    {
+      p = *src;
+      (void) PTW32_INTERLOCKED_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &rec->slots[slot],
+					     (PTW32_INTERLOCKED_PVOID) p);
+    }
+  while (*src != p);
+
+  *ptr = p;
+
+  return 0;
+}				/* pthread_hazard_protect_np */
+
+
+int
+pthread_hazard_clear_np (int slot)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Ends the protection given by a hazard slot of the
+      *      calling thread.
+      *
+      * RESULTS
+      *              0               the slot is clear,
+      *              EINVAL          'slot' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp;
+
+  if (slot < 0 || slot >= PTHREAD_HAZARD_SLOTS_NP)
+    {
+      return EINVAL;
+    }
+
+  sp = (ptw32_thread_t *) pthread_self ().p;
+
+  if (sp != NULL && sp->hazards != NULL)
+    {
+      /* Keeps the thread's loads through the pointer before the clear */
+      (void) PTW32_INTERLOCKED_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &sp->hazards->slots[slot],
+					     (PTW32_INTERLOCKED_PVOID) NULL);
+    }
+
+  return 0;
+}				/* pthread_hazard_clear_np */
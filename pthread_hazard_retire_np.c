@@ -0,0 +1,152 @@
+/*
+ * pthread_hazard_retire_np.c
+ *
+ * Description:
+ * This translation unit implements hazard pointer primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_hazard_retire_np (void * p, void (PTW32_CDECL * reclaim) (void *))
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Hands an unlinked object over for reclamation once no
+      *      hazard slot protects it.
+      *
+      * PARAMETERS
+      *      p
+      *              the object, already unlinked from every shared
+      *              location a thread could protect it from
+      *
+      *      reclaim
+      *              called with 'p' when it is safe, typically to
+      *              free it; it must not retire pointers itself
+      *
+      * DESCRIPTION
+      *      The pointer is kept by the calling thread, which scans
+      *      the hazard slots of all threads (and calls 'reclaim'
+      *      itself) once it holds twice as many retired pointers
+      *      as there are slots in use, and at least
+      *      PTW32_HAZARD_SCAN_MIN. What a thread has retired when it
+      *      exits is scanned then.
+      *
+      * RESULTS
+      *              0               'p' is retired,
+      *              EINVAL          'p' or 'reclaim' is NULL,
+      *              ENOMEM          insufficient memory; 'p' is not
+      *                              retired.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp;
+  ptw32_hazard_record_t * rec;
+  LONG threshold;
+
+  if (p == NULL || reclaim == NULL)
+    {
+      return EINVAL;
+    }
+
+  sp = (ptw32_thread_t *) pthread_self ().p;
+
+  if (sp == NULL || (rec = ptw32_hazard_register (sp)) == NULL)
+    {
+      return ENOMEM;
+    }
+
+  if (rec->nRetired == rec->maxRetired)
+    {
+      int max = (rec->maxRetired == 0) ? PTW32_HAZARD_SCAN_MIN : 2 * rec->maxRetired;
+      ptw32_hazard_retired_t * r;
+
+      r = (ptw32_hazard_retired_t *) realloc (rec->retired, (size_t) max * sizeof (*r));
+
+      if (r == NULL)
+	{
+	  return ENOMEM;
+	}
+
+      rec->retired = r;
+      rec->maxRetired = max;
+    }
+
+  rec->retired[rec->nRetired].p = p;
+  rec->retired[rec->nRetired].reclaim = reclaim;
+  rec->nRetired++;
+
+  threshold = 2 * PTHREAD_HAZARD_SLOTS_NP * ptw32_hazardRecordCount;
+
+  if (threshold < PTW32_HAZARD_SCAN_MIN)
+    {
+      threshold = PTW32_HAZARD_SCAN_MIN;
+    }
+
+  if (rec->nRetired >= threshold)
+    {
+      /* Without memory for the scan the pointers wait for the next one */
+      (void) ptw32_hazard_scan (rec);
+    }
+
+  return 0;
+}				/* pthread_hazard_retire_np */
+
+
+int
+pthread_hazard_scan_np (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Reclaims now whatever the calling thread has retired
+      *      that no hazard slot protects.
+      *
+      * RESULTS
+      *              0               the scan was made,
+      *              ENOMEM          insufficient memory; nothing
+      *                              was reclaimed.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+
+  if (sp == NULL || sp->hazards == NULL)
+    {
+      return 0;
+    }
+
+  return ptw32_hazard_scan (sp->hazards);
+}				/* pthread_hazard_scan_np */
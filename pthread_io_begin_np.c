@@ -0,0 +1,160 @@
+/*
+ * pthread_io_begin_np.c
+ *
+ * Description:
+ * This translation unit implements cancelable I/O regions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_io_begin_np (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Starts a region in which a deferred cancel also
+      *      aborts the calling thread's synchronous I/O.
+      *
+      * DESCRIPTION
+      *      While the thread is in the region pthread_cancel()
+      *      calls CancelSynchronousIo() on it, so a blocking
+      *      ReadFile(), recv() or the like returns with
+      *      ERROR_OPERATION_ABORTED and the thread can act on
+      *      the cancel at pthread_io_end_np(). Regions nest.
+      *      This is a cancellation point, tested after the
+      *      thread enters the region.
+      *
+      * RESULTS
+      *              0               the thread is in the region,
+      *              ENOMEM          the implicit self thread can't
+      *                              be created.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+
+  if (sp == NULL)
+    {
+      return ENOMEM;
+    }
+
+  /*
+   * A full barrier: a canceller that finds the thread outside the
+   * region set the state before it looked, so the test sees it.
+   */
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &sp->ioCancel);
+
+  pthread_testcancel ();
+
+  return 0;
+}				/* pthread_io_begin_np */
+
+
+int
+pthread_io_end_np (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Ends a region started by pthread_io_begin_np().
+      *
+      * DESCRIPTION
+      *      This is a cancellation point, so a cancel that
+      *      aborted I/O in the region is acted on here.
+      *
+      * RESULTS
+      *              0               the region has ended,
+      *              EPERM           the thread isn't in one.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp = PTW32_SELF_THREAD ();
+
+  if (sp == NULL || sp->ioCancel == 0)
+    {
+      return EPERM;
+    }
+
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &sp->ioCancel);
+
+  pthread_testcancel ();
+
+  return 0;
+}				/* pthread_io_end_np */
+
+
+void
+ptw32_cancel_io (ptw32_thread_t * tp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Aborts the synchronous I/O of thread tp, which has a
+      *      deferred cancel pending, if it is in a cancelable I/O
+      *      region. The caller keeps tp from being reused.
+      *
+      *      The thread may be in the region but not yet in its
+      *      I/O call, so while nothing is found to cancel it is
+      *      tried again a few times.
+      *
+      * ------------------------------------------------------
+      */
+{
+  HANDLE threadH;
+  int tries;
+
+  if (NULL == ptw32_cancelsynchronousio || NULL != tp->fiber.handle)
+    {
+      return;
+    }
+
+  threadH = PTW32_THREAD_HANDLE (tp);
+
+  for (tries = 0; tries < PTW32_CANCEL_IO_TRIES; tries++)
+    {
+      /* Ordered after the state change, as in pthread_io_begin_np */
+      if (0 == PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &tp->ioCancel,
+                                                    (PTW32_INTERLOCKED_LONG) 0)
+          || ptw32_cancelsynchronousio (threadH)
+          || GetLastError () != ERROR_NOT_FOUND)
+        {
+          return;
+        }
+
+      (void) SwitchToThread ();
+    }
+}
@@ -47,6 +47,73 @@
 #endif
 
 
+int
+ptw32_join_wait (ptw32_thread_t * tp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Waits, as a cancellation point, for joinable thread tp
+      *      to end. An uncached thread sets tp->exited when
+      *      pthread_win32_thread_detach_np() is done with its
+      *      struct, well before its handle is signalled: the OS
+      *      thread has still to run the DLL detach routines and
+      *      exit. A thread that ended without it only signals the
+      *      handle, which is looked at every PTW32_JOIN_SLICE.
+      *
+      * RESULTS
+      *              0               the thread has ended,
+      *              other           the wait failed.
+      *
+      * ------------------------------------------------------
+      */
+{
+  HANDLE exitH = PTW32_THREAD_EXIT_HANDLE(tp);
+  LONG running = 0;
+  FILETIME ft;
+  struct timespec slice;
+  DWORD status;
+  int result;
+
+  if (tp->cached)
+    {
+      PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_JOIN);
+      return pthreadCancelableWait (exitH);
+    }
+
+  /* As pthreadCancelableWait would, act on a pending cancel first */
+  pthread_testcancel ();
+
+  while (0 == tp->exited)
+    {
+      if ((status = WaitForSingleObject (exitH, 0)) == WAIT_OBJECT_0)
+	{
+	  break;
+	}
+      else if (status != WAIT_TIMEOUT)
+	{
+	  return EINVAL;
+	}
+
+      ptw32_filetime_now (&ft);
+      ptw32_filetime_to_timespec (&ft, &slice);
+      slice.tv_nsec += PTW32_JOIN_SLICE * 1000000L;
+      slice.tv_sec += slice.tv_nsec / 1000000000L;
+      slice.tv_nsec %= 1000000000L;
+
+      result = ptw32_wait_on_address ((volatile void *) &tp->exited, &running,
+				      sizeof (running), CLOCK_REALTIME, &slice,
+				      PTW32_LIBSTAT_WAIT_JOIN);
+
+      if (result != 0 && result != ETIMEDOUT)
+	{
+	  return result;
+	}
+    }
+
+  return 0;
+}
+
+
 int
 pthread_join (pthread_t thread, void **value_ptr)
      /*
@@ -129,7 +196,7 @@ pthread_join (pthread_t thread, void **value_ptr)
 	   * pthreadCancelableWait will not return if we
 	   * are canceled.
 	   */
-	  result = pthreadCancelableWait (tp->threadH);
+	  result = ptw32_join_wait (tp);
 
 	  if (0 == result)
 	    {
@@ -0,0 +1,157 @@
+/*
+ * pthread_join_async_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_join_async_np (pthread_t thread,
+		       void (PTW32_CDECL * callback) (pthread_t thread,
+						      void * value,
+						      void * arg),
+		       void * arg)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Arranges for 'callback' to be called with the exit
+      *      value of 'thread' once it has terminated, in place of
+      *      joining it.
+      *
+      * PARAMETERS
+      *      thread
+      *              an instance of pthread_t
+      *
+      *      callback
+      *              routine called with 'thread', its exit value
+      *              and 'arg'
+      *
+      *      arg
+      *              passed to 'callback'
+      *
+      * DESCRIPTION
+      *      The thread is detached: it can't be joined afterwards
+      *      and its resources are reclaimed once 'callback' has
+      *      returned. This function never blocks, so one thread can
+      *      reap any number of others, e.g. with a callback that
+      *      posts to an I/O completion port.
+      *
+      *      If 'thread' is still running, 'callback' is called by
+      *      it as its last act, after its cleanup handlers and
+      *      thread specific data destructors have run. It may then
+      *      run while the system holds the loader lock, so it must
+      *      be short and must not wait for other threads.
+      *
+      *      If 'thread' has already terminated, 'callback' is
+      *      called by the calling thread before this function
+      *      returns.
+      *
+      *      A thread may pass itself.
+      *
+      * RESULTS
+      *              0               'callback' has been, or will be,
+      *                              called,
+      *              EINVAL          'callback' is NULL or 'thread' is
+      *                              not a joinable thread,
+      *              ESRCH           no thread could be found with ID
+      *                              'thread'.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result;
+  BOOL destroyIt = PTW32_FALSE;
+  ptw32_thread_t * tp = (ptw32_thread_t *) thread.p;
+  ptw32_mcs_local_node_t reuseLock;
+
+  if (callback == NULL)
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_lock_acquire(&ptw32_thread_reuse_lock, &reuseLock);
+
+  if (NULL == tp
+      || thread.x != tp->ptHandle.x)
+    {
+      result = ESRCH;
+    }
+  else if (PTHREAD_CREATE_DETACHED == tp->detachState)
+    {
+      result = EINVAL;
+    }
+  else
+    {
+      ptw32_mcs_local_node_t stateLock;
+
+      result = 0;
+
+      /*
+       * As pthread_detach(), but a thread that hasn't finished
+       * exiting will call back before it destroys itself.
+       */
+      ptw32_mcs_lock_acquire (&tp->stateLock, &stateLock);
+      if (tp->state != PThreadStateLast)
+        {
+          tp->joinCallback = callback;
+          tp->joinArg = arg;
+          tp->detachState = PTHREAD_CREATE_DETACHED;
+        }
+      else
+        {
+          destroyIt = PTW32_TRUE;
+        }
+      ptw32_mcs_lock_release (&stateLock);
+    }
+
+  ptw32_mcs_lock_release(&reuseLock);
+
+  if (destroyIt)
+    {
+      HANDLE exitH = PTW32_THREAD_EXIT_HANDLE(tp);
+      void * value;
+
+      PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_JOIN);
+      (void) ptw32_wait_objects (1, &exitH, INFINITE);
+      value = tp->exitStatus;
+      ptw32_threadDestroy (thread);
+
+      callback (thread, value, arg);
+    }
+
+  return (result);
+
+}				/* pthread_join_async_np */
@@ -0,0 +1,294 @@
+/*
+ * pthread_join_n_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+typedef struct
+{
+  pthread_t * threads;
+  int n;
+  volatile LONG count;		/* Threads yet to end */
+} ptw32_join_n_t;
+
+/*
+ * Take back the count of each thread that holds it but hasn't taken
+ * it: all of them, or with 'lostOnly' only those whose exit handle is
+ * signalled, which ended without pthread_win32_thread_detach_np().
+ */
+static void
+ptw32_join_n_unregister (ptw32_join_n_t * j, int lostOnly)
+{
+  ptw32_mcs_local_node_t stateLock;
+  int i;
+
+  for (i = 0; i < j->n; i++)
+    {
+      ptw32_thread_t * tp = (ptw32_thread_t *) j->threads[i].p;
+
+      if (tp == NULL || tp->joinCount != &j->count)
+	{
+	  continue;
+	}
+
+      if (lostOnly)
+	{
+	  HANDLE exitH = PTW32_THREAD_EXIT_HANDLE(tp);
+
+	  if (WaitForSingleObject (exitH, 0) != WAIT_OBJECT_0)
+	    {
+	      continue;
+	    }
+	}
+
+      ptw32_mcs_lock_acquire (&tp->stateLock, &stateLock);
+      if (tp->joinCount == &j->count)
+	{
+	  tp->joinCount = NULL;
+	  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &j->count);
+	}
+      ptw32_mcs_lock_release (&stateLock);
+    }
+}
+
+/*
+ * Cancelled while waiting: the count is on our stack, so none of the
+ * threads may be left holding it.
+ */
+static void PTW32_CDECL
+ptw32_join_n_cleanup (void * arg)
+{
+  ptw32_join_n_t * j = (ptw32_join_n_t *) arg;
+  LONG count;
+
+  ptw32_join_n_unregister (j, PTW32_FALSE);
+
+  /* Those that have taken it are ending; cancellation is disabled */
+  while ((count = j->count) > 0)
+    {
+      (void) ptw32_wait_on_address ((volatile void *) &j->count, &count,
+				    sizeof (count), CLOCK_REALTIME, NULL,
+				    PTW32_LIBSTAT_WAIT_JOIN);
+    }
+}
+
+
+int
+pthread_join_n_np (pthread_t * threads, int n, void ** values)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits for 'n' threads to terminate and joins them all,
+      *      as 'n' calls of pthread_join() would.
+      *
+      * PARAMETERS
+      *      threads
+      *              array of 'n' joinable threads; NULL handles,
+      *              such as pthread_create_n_np() leaves for threads
+      *              it did not create, are skipped
+      *
+      *      n
+      *              the number of elements of 'threads'
+      *
+      *      values
+      *              array of 'n' locations that receive the exit
+      *              values, or NULL; the element of a NULL handle
+      *              is not written
+      *
+      * DESCRIPTION
+      *      The threads share one counter, which each decrements
+      *      as its last act on the way out of the library, and the
+      *      caller sleeps on the counter until it reaches zero: it
+      *      is woken once, by the last thread, rather than once per
+      *      thread.
+      *
+      *      All the handles are checked before any thread is
+      *      joined, so on an error none of them is. This is a
+      *      cancellation point; a cancelled caller has joined none
+      *      of the threads.
+      *
+      * RESULTS
+      *              0               all the threads have been joined,
+      *              EINVAL          'threads' is NULL, 'n' is negative,
+      *                              or a thread is not joinable,
+      *              ESRCH           a thread could not be found,
+      *              EDEADLK         the calling thread is one of them,
+      *              ENOENT          the calling thread has no POSIX
+      *                              handle and couldn't be given one.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_join_n_t j;
+  pthread_t self;
+  ptw32_thread_t * tp;
+  ptw32_mcs_local_node_t node;
+  LONG count;
+  FILETIME ft;
+  struct timespec slice;
+  int oldState;
+  int result = 0;
+  int i;
+
+  if (threads == NULL || n < 0)
+    {
+      return EINVAL;
+    }
+
+  self = pthread_self ();
+
+  if (NULL == self.p)
+    {
+      return ENOENT;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_thread_reuse_lock, &node);
+
+  for (i = 0; i < n && 0 == result; i++)
+    {
+      if (NULL == (tp = (ptw32_thread_t *) threads[i].p))
+	{
+	  continue;
+	}
+
+      if (threads[i].x != tp->ptHandle.x)
+	{
+	  result = ESRCH;
+	}
+      else if (PTHREAD_CREATE_DETACHED == tp->detachState)
+	{
+	  result = EINVAL;
+	}
+      else if (pthread_equal (self, threads[i]))
+	{
+	  result = EDEADLK;
+	}
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  if (0 != result)
+    {
+      return result;
+    }
+
+  pthread_testcancel ();
+
+  /*
+   * A thread that has got as far as PThreadStateLast is already on its
+   * way out and is joined below without the counter.
+   */
+  j.threads = threads;
+  j.n = n;
+  j.count = 0;
+
+  for (i = 0; i < n; i++)
+    {
+      ptw32_mcs_local_node_t stateLock;
+
+      if (NULL == (tp = (ptw32_thread_t *) threads[i].p))
+	{
+	  continue;
+	}
+
+      ptw32_mcs_lock_acquire (&tp->stateLock, &stateLock);
+      if (tp->state != PThreadStateLast && tp->joinCount == NULL)
+	{
+	  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &j.count);
+	  tp->joinCount = &j.count;
+	}
+      ptw32_mcs_lock_release (&stateLock);
+    }
+
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth(0)
+#endif
+  pthread_cleanup_push (ptw32_join_n_cleanup, (void *) &j);
+
+  while ((count = j.count) > 0)
+    {
+      /* See ptw32_join_wait */
+      ptw32_filetime_now (&ft);
+      ptw32_filetime_to_timespec (&ft, &slice);
+      slice.tv_nsec += PTW32_JOIN_SLICE * 1000000L;
+      slice.tv_sec += slice.tv_nsec / 1000000000L;
+      slice.tv_nsec %= 1000000000L;
+
+      if (ETIMEDOUT == ptw32_wait_on_address ((volatile void *) &j.count, &count,
+					      sizeof (count), CLOCK_REALTIME, &slice,
+					      PTW32_LIBSTAT_WAIT_JOIN))
+	{
+	  ptw32_join_n_unregister (&j, PTW32_TRUE);
+	}
+    }
+
+  pthread_cleanup_pop (0);
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth()
+#endif
+
+  /*
+   * Every thread is past the counter or gone, so these waits are
+   * short. Having got this far, all of them are joined.
+   */
+  (void) pthread_setcancelstate (PTHREAD_CANCEL_DISABLE, &oldState);
+
+  for (i = 0; i < n; i++)
+    {
+      if (NULL == (tp = (ptw32_thread_t *) threads[i].p))
+	{
+	  continue;
+	}
+
+      if (0 != ptw32_join_wait (tp))
+	{
+	  result = ESRCH;
+	  continue;
+	}
+
+      if (values != NULL)
+	{
+	  values[i] = tp->exitStatus;
+	}
+
+      (void) pthread_detach (threads[i]);
+    }
+
+  (void) pthread_setcancelstate (oldState, NULL);
+
+  return result;
+}
@@ -38,11 +38,6 @@
 #include "implement.h"
 
 
-/* TLS_OUT_OF_INDEXES not defined on WinCE */
-#if !defined(TLS_OUT_OF_INDEXES)
-#define TLS_OUT_OF_INDEXES 0xffffffff
-#endif
-
 int
 pthread_key_create (pthread_key_t * key, void (PTW32_CDECL *destructor) (void *))
      /*
@@ -66,6 +61,12 @@ pthread_key_create (pthread_key_t * key, void (PTW32_CDECL *destructor) (void *)
       *      thread with a non-NULL value for key terminates, 'destructor'
       *      is called with key's current value for that thread.
       *
+      *      Once Win32 has no TLS indexes left, keys are kept in a
+      *      table per thread, so the number of keys is only limited
+      *      by memory. So are keys created after a key has been
+      *      deleted: deleting one costs the same however many
+      *      threads there are.
+      *
       * RESULTS
       *              0               successfully created semaphore,
       *              EAGAIN          insufficient resources or PTHREAD_KEYS_MAX
@@ -82,24 +83,40 @@ pthread_key_create (pthread_key_t * key, void (PTW32_CDECL *destructor) (void *)
     {
       result = ENOMEM;
     }
-  else if ((newkey->key = TlsAlloc ()) == TLS_OUT_OF_INDEXES)
+  else if (ptw32_tsdNumRetired > 0 && ptw32_tsdTableIndex != TLS_OUT_OF_INDEXES)
+    {
+      /*
+       * Keys are being deleted: make a table key, which is
+       * deleted without retiring a TLS index.
+       */
+      newkey->key = TLS_OUT_OF_INDEXES;
+    }
+  else if ((newkey->key = TlsAlloc ()) == TLS_OUT_OF_INDEXES
+	   && ptw32_tsdTableIndex == TLS_OUT_OF_INDEXES)
     {
       result = EAGAIN;
 
       free (newkey);
       newkey = NULL;
     }
-  else if (destructor != NULL)
+  else
     {
+      newkey->destructor = destructor;
+
       /*
-       * Have to manage associations between thread and key;
-       * Therefore, need a lock that allows competing threads
-       * to gain exclusive access to the key->threads list.
-       *
-       * The mutex will only be created when it is first locked.
+       * Register the key last: exiting threads may look at it
+       * from then on.
        */
-      newkey->keyLock = 0;
-      newkey->destructor = destructor;
+      if ((result = ptw32_tsd_slot_alloc (newkey)) != 0)
+	{
+	  if (!PTW32_KEY_IN_TABLE(newkey))
+	    {
+	      TlsFree (newkey->key);
+	    }
+
+	  free (newkey);
+	  newkey = NULL;
+	}
     }
 
   *key = newkey;
@@ -0,0 +1,121 @@
+/*
+ * pthread_key_create_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_key_create_np (pthread_key_t * key,
+		       void (PTW32_CDECL *destructor) (void *), int flags)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      As pthread_key_create(), with flags.
+      *
+      * PARAMETERS
+      *      key
+      *              pointer to an instance of pthread_key_t
+      *
+      *      destructor
+      *              as for pthread_key_create()
+      *
+      *      flags
+      *              0, or PTHREAD_KEY_TASK_NP
+      *
+      * DESCRIPTION
+      *      A PTHREAD_KEY_TASK_NP key holds a value per pool task
+      *      rather than per thread: when a pthread_pool_np_t
+      *      worker finishes a task, the destructors of the values
+      *      the task set for task keys are run together and every
+      *      task key reads NULL again, so the next task on the
+      *      worker never sees them. Between tasks this costs one
+      *      increment if the task set no values with destructors.
+      *      In other threads a task key is an ordinary key.
+      *
+      * RESULTS
+      *              0               successfully created key,
+      *              EINVAL          'flags' is invalid,
+      *              EAGAIN          PTHREAD_KEY_TASK_NP and the
+      *                              library has no TLS index for
+      *                              per-thread key tables,
+      *              ENOMEM          insufficient memory to create the key.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result;
+  pthread_key_t newkey;
+
+  if (flags & ~PTHREAD_KEY_TASK_NP)
+    {
+      return EINVAL;
+    }
+
+  if (0 == flags)
+    {
+      return pthread_key_create (key, destructor);
+    }
+
+  /*
+   * Task keys are table keys: the table's task number is what
+   * clears them.
+   */
+  if (ptw32_tsdTableIndex == TLS_OUT_OF_INDEXES)
+    {
+      return EAGAIN;
+    }
+
+  if ((newkey = (pthread_key_t) calloc (1, sizeof (*newkey))) == NULL)
+    {
+      return ENOMEM;
+    }
+
+  newkey->key = TLS_OUT_OF_INDEXES;
+  newkey->destructor = destructor;
+  newkey->task = PTW32_TRUE;
+
+  if ((result = ptw32_tsd_slot_alloc (newkey)) != 0)
+    {
+      free (newkey);
+      newkey = NULL;
+    }
+
+  *key = newkey;
+
+  return result;
+}
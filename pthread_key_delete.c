@@ -66,54 +66,19 @@ pthread_key_delete (pthread_key_t key)
       * ------------------------------------------------------
       */
 {
-  ptw32_mcs_local_node_t keyLock;
   int result = 0;
 
   if (key != NULL)
     {
-      if (key->threads != NULL && key->destructor != NULL)
-	{
-	  ThreadKeyAssoc *assoc;
-	  ptw32_mcs_lock_acquire (&(key->keyLock), &keyLock);
-	  /*
-	   * Run through all Thread<-->Key associations
-	   * for this key.
-	   *
-	   * While we hold at least one of the locks guarding
-	   * the assoc, we know that the assoc pointed to by
-	   * key->threads is valid.
-	   */
-	  while ((assoc = (ThreadKeyAssoc *) key->threads) != NULL)
-	    {
-              ptw32_mcs_local_node_t threadLock;
-	      ptw32_thread_t * thread = assoc->thread;
-
-	      if (assoc == NULL)
-		{
-		  /* Finished */
-		  break;
-		}
-
-	      ptw32_mcs_lock_acquire (&(thread->threadLock), &threadLock);
-	      /*
-	       * Since we are starting at the head of the key's threads
-	       * chain, this will also point key->threads at the next assoc.
-	       * While we hold key->keyLock, no other thread can insert
-	       * a new assoc via pthread_setspecific.
-	       */
-	      ptw32_tkAssocDestroy (assoc);
-	      ptw32_mcs_lock_release (&threadLock);
-	      ptw32_mcs_lock_release (&keyLock);
-	    }
-	}
-
-      TlsFree (key->key);
-      if (key->destructor != NULL)
-	{
-	  /* A thread could be holding the keyLock */
-	  ptw32_mcs_lock_acquire (&(key->keyLock), &keyLock);
-	  ptw32_mcs_lock_release (&keyLock);
-	}
+      /*
+       * Once the key is unregistered no exiting thread will look
+       * at it, so there is nothing to undo in other threads. A bit
+       * left in a thread's destructor bitmap only makes it check
+       * the value of whatever key holds the slot when it exits.
+       * Nor is any thread visited to give back the key's TLS index
+       * (see ptw32_tsd_slot_free).
+       */
+      ptw32_tsd_slot_free (key);
 
 #if defined( _DEBUG )
       memset ((char *) key, 0, sizeof (*key));
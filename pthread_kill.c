@@ -37,13 +37,124 @@
 #include "pthread.h"
 #include "implement.h"
 
+#if !defined(WINCE)
+#  include <signal.h>
+#endif
+
 /*
- * Not needed yet, but defining it should indicate clashes with build target
- * environment that should be fixed.
+ * Signals are delivered by raise() on the target thread, so the
+ * handlers are those set with signal(). pthread_kill() marks the
+ * signal pending in the target and, unless the target blocks it (see
+ * pthread_sigmask, with HAVE_SIGSET_T), queues an APC that raises it:
+ * a special user APC where the system has them, which runs wherever
+ * the thread is, otherwise a user APC, which runs at the thread's next
+ * alertable wait. Either way a thread raises its pending signals at
+ * its next cancellation point.
  */
+
+/* The signals raise() can deliver */
+static int
+ptw32_signal_valid (int sig)
+{
+  switch (sig)
+    {
 #if !defined(WINCE)
-#  include <signal.h>
+    case SIGINT:
+    case SIGILL:
+    case SIGFPE:
+    case SIGSEGV:
+    case SIGTERM:
+    case SIGABRT:
+#if defined(SIGBREAK)
+    case SIGBREAK:
+#endif
+      return sig > 0 && sig < 32;
+#endif
+    default:
+      return PTW32_FALSE;
+    }
+}
+
+/* The pending signals that sp doesn't block */
+static LONG
+ptw32_signal_unblocked (ptw32_thread_t * sp)
+{
+  LONG pending = sp->sigPending;
+#if defined(HAVE_SIGSET_T)
+  const unsigned long * mask = (const unsigned long *) &sp->sigmask;
+  int sig;
+
+  for (sig = 1; sig < 32; sig++)
+    {
+      if (mask[(sig - 1) / (8 * sizeof (unsigned long))]
+          & (1UL << ((sig - 1) % (8 * sizeof (unsigned long)))))
+        {
+          pending &= ~(1L << sig);
+        }
+    }
+#endif
+
+  return pending;
+}
+
+static void CALLBACK
+ptw32_signal_callback (ULONG_PTR unused)
+{
+  ptw32_thread_t * sp = PTW32_SELF_THREAD ();
+
+  if (sp != NULL)
+    {
+      ptw32_signal_deliver (sp);
+    }
+}
+
+
+void
+ptw32_signal_deliver (ptw32_thread_t * sp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Raises the calling thread's pending signals that it
+      *      doesn't block, lowest first, each at most once.
+      *      'sp' is the calling thread.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG unblocked;
+
+  /* Lowered first, so that a signal sent meanwhile raises it again */
+  ptw32_testcancel_lower (sp, PTW32_TESTCANCEL_SIGNAL);
+
+  while (0 != (unblocked = ptw32_signal_unblocked (sp)))
+    {
+      LONG pending = sp->sigPending;
+      int sig = 1;
+
+      while (0 == (unblocked & (1L << sig)))
+        {
+          sig++;
+        }
+
+      if ((PTW32_INTERLOCKED_LONG) pending
+          == PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &sp->sigPending,
+                                                      (PTW32_INTERLOCKED_LONG) (pending & ~(1L << sig)),
+                                                      (PTW32_INTERLOCKED_LONG) pending)
+          && (pending & (1L << sig)))
+        {
+#if !defined(WINCE)
+          (void) raise (sig);
 #endif
+        }
+    }
+
+  /* Blocked signals are looked at again at each cancellation point */
+  if (0 != sp->sigPending)
+    {
+      ptw32_testcancel_raise (sp, PTW32_TESTCANCEL_SIGNAL);
+    }
+}
+
 
 int
 pthread_kill (pthread_t thread, int sig)
@@ -57,7 +168,9 @@ pthread_kill (pthread_t thread, int sig)
       *
       * PARAMETERS
       *      thread  reference to an instances of pthread_t
-      *      sig     signal. Currently only a value of 0 is supported.
+      *      sig     signal: 0, or one that raise() supports
+      *              (SIGINT, SIGILL, SIGFPE, SIGSEGV, SIGTERM,
+      *              SIGABRT and, where defined, SIGBREAK).
       *
       *
       * DESCRIPTION
@@ -66,6 +179,18 @@ pthread_kill (pthread_t thread, int sig)
       *      performed but no signal is actually sent such that this
       *      function can be used to check for a valid thread ID.
       *
+      *      The signal is raised on the thread, running the handler
+      *      that raise() would run there. Where the system has
+      *      special user APCs (Windows 11) it interrupts the thread
+      *      wherever it is, so the handler must be async-signal
+      *      safe; otherwise it is raised at the thread's next
+      *      alertable wait. In both cases a thread raises its
+      *      pending signals at its next cancellation point, and a
+      *      thread sending itself a signal has it raised before
+      *      pthread_kill returns. A signal the thread blocks stays
+      *      pending until it is unblocked, and a pending signal
+      *      sent again is raised once.
+      *
       * RESULTS
       *              ESRCH           the thread is not a valid thread ID,
       *              EINVAL          the value of the signal is invalid
@@ -79,25 +204,73 @@ pthread_kill (pthread_t thread, int sig)
   ptw32_thread_t * tp;
   ptw32_mcs_local_node_t node;
 
+  if (0 != sig && !ptw32_signal_valid (sig))
+    {
+      return EINVAL;
+    }
+
+  /*
+   * Just checking the thread ID, as pthread_cancel and others do,
+   * takes no global lock. See ptw32_reuse.c.
+   */
+  if (0 == sig)
+    {
+      return ptw32_thread_valid (thread);
+    }
+
   ptw32_mcs_lock_acquire(&ptw32_thread_reuse_lock, &node);
 
   tp = (ptw32_thread_t *) thread.p;
 
   if (NULL == tp
       || thread.x != tp->ptHandle.x
-      || NULL == tp->threadH)
+      || (NULL == tp->threadH && !tp->implicit && NULL == tp->fiber.handle))
     {
       result = ESRCH;
     }
+  else if (0 != sig)
+    {
+      LONG pending;
 
-  ptw32_mcs_lock_release(&node);
+      do
+        {
+          pending = tp->sigPending;
+        }
+      while ((PTW32_INTERLOCKED_LONG) pending
+             != PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &tp->sigPending,
+                                                         (PTW32_INTERLOCKED_LONG) (pending | (1L << sig)),
+                                                         (PTW32_INTERLOCKED_LONG) pending));
+
+      ptw32_testcancel_raise (tp, PTW32_TESTCANCEL_SIGNAL);
 
-  if (0 == result && 0 != sig)
-    {
       /*
-       * Currently does not support any signals.
+       * The reuse lock keeps the thread's handle open. A fiber has no
+       * OS thread of its own to queue to, so it waits for a
+       * cancellation point.
        */
-      result = EINVAL;
+      if (tp != PTW32_SELF_THREAD ()
+          && NULL == tp->fiber.handle
+          && 0 != (ptw32_signal_unblocked (tp) & (1L << sig)))
+        {
+          HANDLE threadH = PTW32_THREAD_HANDLE (tp);
+
+          if (ptw32_queueuserapc2 != NULL)
+            {
+              (void) ptw32_queueuserapc2 ((PAPCFUNC) ptw32_signal_callback, threadH, 0,
+                                          QUEUE_USER_APC_FLAGS_SPECIAL_USER_APC);
+            }
+          else
+            {
+              (void) QueueUserAPC ((PAPCFUNC) ptw32_signal_callback, threadH, 0);
+            }
+        }
+    }
+
+  ptw32_mcs_lock_release(&node);
+
+  if (0 == result && 0 != sig && tp == PTW32_SELF_THREAD ())
+    {
+      ptw32_signal_deliver (tp);
     }
 
   return result;
@@ -0,0 +1,93 @@
+/*
+ * pthread_latch_destroy_np.c
+ *
+ * Description:
+ * This translation unit implements latch primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_latch_destroy_np (pthread_latch_np_t * latch)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Destroys a latch.
+      *
+      * PARAMETERS
+      *      latch
+      *              pointer to an instance of pthread_latch_np_t
+      *
+      * DESCRIPTION
+      *      Threads that the latch released but that haven't yet
+      *      returned from waiting on it are waited for, so the
+      *      thread that releases the latch may destroy it.
+      *
+      * RESULTS
+      *              0               successfully destroyed latch,
+      *              EINVAL          'latch' is invalid,
+      *              EBUSY           threads are waiting on the
+      *                              unreleased latch.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_latch_np_t l;
+  int yields = 0;
+
+  if (latch == NULL || (l = *latch) == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (!PTW32_ATOMIC_LOAD_ACQ_LONG (&l->released))
+    {
+      if (0 != PTW32_ATOMIC_LOAD_ACQ_LONG (&l->nWaiting))
+	{
+	  return EBUSY;
+	}
+    }
+  else
+    {
+      while (0 != PTW32_ATOMIC_LOAD_ACQ_LONG (&l->nWaiting))
+	{
+	  ptw32_yield (&yields);
+	}
+    }
+
+  *latch = NULL;
+  ptw32_object_free (l);
+
+  return 0;
+}				/* pthread_latch_destroy_np */
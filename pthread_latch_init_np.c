@@ -0,0 +1,90 @@
+/*
+ * pthread_latch_init_np.c
+ *
+ * Description:
+ * This translation unit implements latch primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_latch_init_np (pthread_latch_np_t * latch, unsigned int count)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Creates a count-down latch.
+      *
+      * PARAMETERS
+      *      latch
+      *              pointer to an instance of pthread_latch_np_t
+      *
+      *      count
+      *              the number of arrivals that release the latch;
+      *              0 creates it released
+      *
+      * DESCRIPTION
+      *      Unlike a barrier, the threads that count the latch
+      *      down need not be the ones that wait on it, and
+      *      counting down doesn't wait. The latch is released
+      *      once and for all when its count reaches zero.
+      *
+      * RESULTS
+      *              0               successfully created latch,
+      *              EINVAL          'latch' or 'count' is invalid,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_latch_np_t l;
+
+  if (latch == NULL || count > (unsigned int) LONG_MAX)
+    {
+      return EINVAL;
+    }
+
+  l = (pthread_latch_np_t) ptw32_object_alloc (sizeof (*l), 0);
+
+  if (l == NULL)
+    {
+      return ENOMEM;
+    }
+
+  l->count = (LONG) count;
+  l->released = (count == 0);
+
+  *latch = l;
+
+  return 0;
+}				/* pthread_latch_init_np */
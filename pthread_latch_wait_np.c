@@ -0,0 +1,218 @@
+/*
+ * pthread_latch_wait_np.c
+ *
+ * Description:
+ * This translation unit implements latch primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_latch_count_down_np (pthread_latch_np_t latch, unsigned int n)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Counts 'n' arrivals at the latch, without waiting.
+      *
+      * PARAMETERS
+      *      latch
+      *              an instance of pthread_latch_np_t
+      *
+      *      n
+      *              the number of arrivals, usually 1
+      *
+      * DESCRIPTION
+      *      The arrival that brings the count to zero releases
+      *      the latch's waiters. It only makes the wake call if
+      *      some of them have parked.
+      *
+      * RESULTS
+      *              0               successfully counted down,
+      *              EINVAL          'latch' is invalid or 'n' is more
+      *                              than the remaining count.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG c;
+
+  if (latch == NULL)
+    {
+      return EINVAL;
+    }
+
+  c = PTW32_ATOMIC_LOAD_RELAXED_LONG (&latch->count);
+
+  for (;;)
+    {
+      LONG old;
+
+      if ((ULONG) n > (ULONG) c)
+	{
+	  return EINVAL;
+	}
+
+      old = (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &latch->count,
+							   (PTW32_INTERLOCKED_LONG) (c - (LONG) n),
+							   (PTW32_INTERLOCKED_LONG) c);
+      if (old == c)
+	{
+	  break;
+	}
+
+      c = old;
+    }
+
+  if (n > 0 && c == (LONG) n)
+    {
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &latch->released,
+					      (PTW32_INTERLOCKED_LONG) 1);
+
+      if (ptw32_wakebyaddressall != NULL
+          && 0 != PTW32_ATOMIC_LOAD_RELAXED_LONG (&latch->nWaiting))
+	{
+	  ptw32_wakebyaddressall ((PVOID) &latch->released);
+	}
+    }
+
+  return 0;
+}				/* pthread_latch_count_down_np */
+
+
+int
+pthread_latch_wait_np (pthread_latch_np_t latch)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits until the latch is released.
+      *
+      * PARAMETERS
+      *      latch
+      *              an instance of pthread_latch_np_t
+      *
+      * DESCRIPTION
+      *      Returns at once if the latch has been released.
+      *      Otherwise polls it for a while on a multiprocessor
+      *      and then parks, as waiters at a combining tree
+      *      barrier do. Not a cancellation point, like
+      *      pthread_barrier_wait().
+      *
+      * RESULTS
+      *              0               the latch is released,
+      *              EINVAL          'latch' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (latch == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (PTW32_ATOMIC_LOAD_ACQ_LONG (&latch->released))
+    {
+      return 0;
+    }
+
+  /* Counted before looking again, so that the releaser sees us */
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &latch->nWaiting);
+
+  ptw32_barrier_park (&latch->released, 0, NULL);
+
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &latch->nWaiting);
+
+  return 0;
+}				/* pthread_latch_wait_np */
+
+
+int
+pthread_latch_try_wait_np (pthread_latch_np_t latch)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Tests whether the latch is released.
+      *
+      * PARAMETERS
+      *      latch
+      *              an instance of pthread_latch_np_t
+      *
+      * RESULTS
+      *              0               the latch is released,
+      *              EINVAL          'latch' is invalid,
+      *              EBUSY           the latch isn't released yet.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (latch == NULL)
+    {
+      return EINVAL;
+    }
+
+  return PTW32_ATOMIC_LOAD_ACQ_LONG (&latch->released) ? 0 : EBUSY;
+}				/* pthread_latch_try_wait_np */
+
+
+int
+pthread_latch_arrive_and_wait_np (pthread_latch_np_t latch, unsigned int n)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Counts 'n' arrivals at the latch and waits until it
+      *      is released.
+      *
+      * PARAMETERS
+      *      latch
+      *              an instance of pthread_latch_np_t
+      *
+      *      n
+      *              the number of arrivals, usually 1
+      *
+      * RESULTS
+      *              0               the latch is released,
+      *              EINVAL          'latch' is invalid or 'n' is more
+      *                              than the remaining count.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result = pthread_latch_count_down_np (latch, n);
+
+  if (0 == result)
+    {
+      result = pthread_latch_wait_np (latch);
+    }
+
+  return result;
+}				/* pthread_latch_arrive_and_wait_np */
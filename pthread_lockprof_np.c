@@ -0,0 +1,219 @@
+/*
+ * pthread_lockprof_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_lockprof_setsampling_np (int every, const struct timespec * threshold)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets which contended acquisitions the lock profiler
+      *      samples.
+      *
+      * PARAMETERS
+      *      every
+      *              sample every 'every'th contended acquisition,
+      *              or 0 for none
+      *
+      *      threshold
+      *              also sample every acquisition that waited at
+      *              least this long, or NULL or zero for none
+      *
+      * DESCRIPTION
+      *      Contended mutex and read-write lock acquisitions and
+      *      condition variable waits that were woken are counted.
+      *      A sample holds the waiter's stack and, for a mutex
+      *      whose owner released it to blocked waiters, the
+      *      owner's stack at the release. While sampling is on,
+      *      such releases capture the owner's stack. Sampling is
+      *      off initially; 0 and NULL turn it off again.
+      *
+      * RESULTS
+      *              0               successfully set the sampling,
+      *              EINVAL          'every' is negative or
+      *                              'threshold' is invalid,
+      *              ENOTSUP         the library wasn't built with
+      *                              PTW32_LOCKSTAT.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if defined(PTW32_LOCKSTAT)
+  int64_t ticks = 0;
+
+  if (every < 0)
+    {
+      return EINVAL;
+    }
+
+  if (threshold != NULL)
+    {
+      int64_t frequency = ptw32_perf_frequency ();
+
+      if (threshold->tv_sec < 0 || threshold->tv_nsec < 0 || threshold->tv_nsec >= 1000000000L)
+        {
+          return EINVAL;
+        }
+
+      ticks = (int64_t) threshold->tv_sec * frequency
+              + (int64_t) ((double) threshold->tv_nsec * (double) frequency / 1.0e9);
+    }
+
+  /*
+   * Hooks read the settings without a lock; a sample taken while they
+   * change is just sampled by the old settings.
+   */
+  ptw32_lockprofOn = PTW32_FALSE;
+  ptw32_lockprofEvery = (LONG) every;
+  ptw32_lockprofThreshold = ticks;
+  ptw32_lockprofOn = (every > 0 || ticks > 0);
+
+  return 0;
+#else
+  (void) every;
+  (void) threshold;
+  return ENOTSUP;
+#endif
+}
+
+
+int
+pthread_lockprof_read_np (unsigned int * position,
+                          pthread_lockprof_np_t * samples,
+                          int n,
+                          int * count)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Reads samples taken by the lock profiler.
+      *
+      * PARAMETERS
+      *      position
+      *              the position of the next sample to read,
+      *              advanced past those read or lost; 0 to
+      *              start with the oldest kept
+      *
+      *      samples
+      *              array for up to 'n' samples
+      *
+      *      n
+      *              number of elements in 'samples'
+      *
+      *      count
+      *              receives the number of samples read
+      *
+      * DESCRIPTION
+      *      No lock is taken and sampling threads aren't held up.
+      *      Only the last 256 samples are kept;
+      *      a reader that falls further behind skips the ones
+      *      overwritten. A sample still being written ends the
+      *      read, to be returned by the next call. Each reader
+      *      keeps its own position.
+      *
+      * RESULTS
+      *              0               successful,
+      *              EINVAL          'position', 'samples' or
+      *                              'count' is NULL or 'n' is not
+      *                              positive,
+      *              ENOTSUP         the library wasn't built with
+      *                              PTW32_LOCKSTAT.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if defined(PTW32_LOCKSTAT)
+  unsigned long p;
+  unsigned long head;
+  int found = 0;
+
+  if (position == NULL || samples == NULL || count == NULL || n <= 0)
+    {
+      return EINVAL;
+    }
+
+  p = (unsigned long) *position;
+  head = (unsigned long) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_lockprofNext,
+                                                              (PTW32_INTERLOCKED_LONG) 0);
+
+  if (head - p > PTW32_LOCKPROF_SLOTS)
+    {
+      p = head - PTW32_LOCKPROF_SLOTS;
+    }
+
+  while (found < n && p != head)
+    {
+      ptw32_lockprof_slot_t * slot = &ptw32_lockprofRing[p & (PTW32_LOCKPROF_SLOTS - 1)];
+      unsigned long seq;
+
+      seq = (unsigned long) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->seq,
+                                                                 (PTW32_INTERLOCKED_LONG) 0);
+
+      if (seq == 0 || (long) (seq - (p + 1)) < 0)
+        {
+          /* Still being written, or its writer hasn't begun */
+          break;
+        }
+
+      if (seq == p + 1)
+        {
+          samples[found] = slot->sample;
+
+          if ((unsigned long) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->seq,
+                                                                  (PTW32_INTERLOCKED_LONG) 0) == seq)
+            {
+              found++;
+            }
+        }
+
+      /* Read, or overwritten by a later sample */
+      p++;
+    }
+
+  *position = (unsigned int) p;
+  *count = found;
+
+  return 0;
+#else
+  (void) position;
+  (void) samples;
+  (void) n;
+  (void) count;
+  return ENOTSUP;
+#endif
+}
@@ -0,0 +1,403 @@
+/*
+ * pthread_lockstat_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_LOCKSTAT)
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+#  define PTW32_LOCKSTAT_U64 "%I64u"
+#else
+#  define PTW32_LOCKSTAT_U64 "%llu"
+#endif
+
+typedef struct
+{
+  int kind;
+  void * object;
+  pthread_lockstat_np_t stats;
+} ptw32_lockstat_entry_t;
+
+/*
+ * Must be called with ptw32_lockstat_lock held.
+ */
+static void
+ptw32_lockstat_copy (pthread_lockstat_np_t * to, const ptw32_lockstat_t * from)
+{
+  to->acquisitions = (unsigned __int64) from->acquisitions;
+  to->contended = (unsigned __int64) from->contended;
+  to->waitTime = ptw32_ticks_to_ns (from->waitTime);
+  to->maxWaitTime = ptw32_ticks_to_ns (from->maxWaitTime);
+  to->holdTime = ptw32_ticks_to_ns (from->holdTime);
+}
+
+static int
+ptw32_lockstat_get (const ptw32_lockstat_t * from, pthread_lockstat_np_t * to)
+{
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&ptw32_lockstat_lock, &node);
+  ptw32_lockstat_copy (to, from);
+  ptw32_mcs_lock_release (&node);
+
+  return 0;
+}
+
+static int PTW32_CDECL
+ptw32_lockstat_print (int kind, void * object,
+                      const pthread_lockstat_np_t * stats, void * arg)
+{
+  static const char * kinds[] = { "mutex", "rwlock", "cond" };
+
+  (void) fprintf ((FILE *) arg,
+                  "%-6s %p acquisitions " PTW32_LOCKSTAT_U64
+                  " contended " PTW32_LOCKSTAT_U64
+                  " wait " PTW32_LOCKSTAT_U64 "ns"
+                  " max " PTW32_LOCKSTAT_U64 "ns"
+                  " hold " PTW32_LOCKSTAT_U64 "ns\n",
+                  kinds[kind], object,
+                  stats->acquisitions, stats->contended,
+                  stats->waitTime, stats->maxWaitTime, stats->holdTime);
+
+  return 0;
+}
+
+#endif /* PTW32_LOCKSTAT */
+
+
+int
+pthread_mutex_getstats_np (pthread_mutex_t * mutex,
+                           pthread_lockstat_np_t * stats)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the contention statistics of a mutex.
+      *
+      * PARAMETERS
+      *      mutex
+      *              pointer to an instance of pthread_mutex_t
+      *
+      *      stats
+      *              where to return the statistics
+      *
+      * DESCRIPTION
+      *      Every acquisition is counted when the mutex is
+      *      unlocked. Those that had to spin or block are also
+      *      counted as contended, with the time they waited and
+      *      the time the mutex was then held. A statically
+      *      initialised mutex that hasn't been used returns zeros.
+      *
+      * RESULTS
+      *              0               successfully returned the statistics,
+      *              EINVAL          'mutex' or 'stats' is invalid,
+      *              ENOTSUP         the library wasn't built with
+      *                              PTW32_LOCKSTAT, or 'mutex' is
+      *                              process shared.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if defined(PTW32_LOCKSTAT)
+  if (mutex == NULL || *mutex == NULL || stats == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (PTW32_IS_PSHARED (*mutex))
+    {
+      return ENOTSUP;
+    }
+
+  if (*mutex >= PTHREAD_ERRORCHECK_MUTEX_INITIALIZER)
+    {
+      memset (stats, 0, sizeof (*stats));
+      return 0;
+    }
+
+  return ptw32_lockstat_get (&(*mutex)->stats, stats);
+#else
+  (void) mutex;
+  (void) stats;
+  return ENOTSUP;
+#endif
+}
+
+
+int
+pthread_rwlock_getstats_np (pthread_rwlock_t * rwlock,
+                            pthread_lockstat_np_t * stats)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the contention statistics of a read-write lock.
+      *
+      * PARAMETERS
+      *      rwlock
+      *              pointer to an instance of pthread_rwlock_t
+      *
+      *      stats
+      *              where to return the statistics
+      *
+      * DESCRIPTION
+      *      Read and write locks are counted together; those that
+      *      couldn't be taken at once are counted as contended,
+      *      with the time they waited. No hold time is kept.
+      *      A default kind lock that isn't built on a Slim R/W
+      *      lock returns the statistics of its internal mutex.
+      *
+      * RESULTS
+      *              0               successfully returned the statistics,
+      *              EINVAL          'rwlock' or 'stats' is invalid,
+      *              ENOTSUP         the library wasn't built with
+      *                              PTW32_LOCKSTAT.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if defined(PTW32_LOCKSTAT)
+  pthread_rwlock_t rwl;
+
+  if (rwlock == NULL || *rwlock == NULL || stats == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (*rwlock == PTHREAD_RWLOCK_INITIALIZER)
+    {
+      memset (stats, 0, sizeof (*stats));
+      return 0;
+    }
+
+  rwl = *rwlock;
+
+  if (rwl->nMagic != PTW32_RWLOCK_MAGIC)
+    {
+      return EINVAL;
+    }
+
+  if (rwl->readerSlots == NULL
+      && rwl->kind == PTHREAD_RWLOCK_DEFAULT_NP
+      && !rwl->useSRWLock)
+    {
+      return ptw32_lockstat_get (&rwl->mtxExclusiveAccess->stats, stats);
+    }
+
+  return ptw32_lockstat_get (&rwl->stats, stats);
+#else
+  (void) rwlock;
+  (void) stats;
+  return ENOTSUP;
+#endif
+}
+
+
+int
+pthread_cond_getstats_np (pthread_cond_t * cond,
+                          pthread_lockstat_np_t * stats)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the wait statistics of a condition variable.
+      *
+      * PARAMETERS
+      *      cond
+      *              pointer to an instance of pthread_cond_t
+      *
+      *      stats
+      *              where to return the statistics
+      *
+      * DESCRIPTION
+      *      'acquisitions' counts the waits and 'contended' those
+      *      that were woken rather than timed out, cancelled or
+      *      failed, with the time they waited, including the time
+      *      to lock the mutex again. No hold time is kept.
+      *
+      * RESULTS
+      *              0               successfully returned the statistics,
+      *              EINVAL          'cond' or 'stats' is invalid,
+      *              ENOTSUP         the library wasn't built with
+      *                              PTW32_LOCKSTAT, or 'cond' is
+      *                              process shared.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if defined(PTW32_LOCKSTAT)
+  if (cond == NULL || *cond == NULL || stats == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (PTW32_IS_PSHARED (*cond))
+    {
+      return ENOTSUP;
+    }
+
+  if (*cond == PTHREAD_COND_INITIALIZER)
+    {
+      memset (stats, 0, sizeof (*stats));
+      return 0;
+    }
+
+  return ptw32_lockstat_get (&(*cond)->stats, stats);
+#else
+  (void) cond;
+  (void) stats;
+  return ENOTSUP;
+#endif
+}
+
+
+int
+pthread_lockstat_walk_np (int (PTW32_CDECL *callback) (int kind,
+                                                       void * object,
+                                                       const pthread_lockstat_np_t * stats,
+                                                       void * arg),
+                          void * arg)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Calls 'callback' with the statistics of every object
+      *      that has been contended, or waited on in the case of
+      *      a condition variable, and not yet destroyed.
+      *
+      * PARAMETERS
+      *      callback
+      *              called with PTHREAD_LOCKSTAT_MUTEX_NP,
+      *              PTHREAD_LOCKSTAT_RWLOCK_NP or
+      *              PTHREAD_LOCKSTAT_COND_NP, the object (the
+      *              pthread_mutex_t, pthread_rwlock_t or
+      *              pthread_cond_t value), its statistics and 'arg'.
+      *              A non-zero return ends the walk.
+      *
+      *      arg
+      *              passed to callback
+      *
+      * DESCRIPTION
+      *      The statistics are copied before the first call, so
+      *      callback may use any of the objects. The objects may
+      *      include the library's own, such as the mutexes inside
+      *      condition variables and read-write locks.
+      *
+      * RESULTS
+      *              0               successfully walked the objects,
+      *              EINVAL          'callback' is NULL,
+      *              ENOMEM          no memory for the copy,
+      *              ENOTSUP         the library wasn't built with
+      *                              PTW32_LOCKSTAT,
+      *              the value callback returned if it ended the walk.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if defined(PTW32_LOCKSTAT)
+  ptw32_mcs_local_node_t node;
+  ptw32_lockstat_entry_t * entries;
+  ptw32_lockstat_t * stats;
+  int count = 0;
+  int i;
+  int result = 0;
+
+  if (callback == NULL)
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_lockstat_lock, &node);
+
+  for (stats = ptw32_lockstatList; stats != NULL; stats = stats->next)
+    {
+      count++;
+    }
+
+  entries = (ptw32_lockstat_entry_t *) malloc ((count > 0 ? count : 1) * sizeof (*entries));
+
+  if (entries == NULL)
+    {
+      ptw32_mcs_lock_release (&node);
+      return ENOMEM;
+    }
+
+  for (i = 0, stats = ptw32_lockstatList; stats != NULL; stats = stats->next, i++)
+    {
+      entries[i].kind = stats->kind;
+      entries[i].object = stats->object;
+      ptw32_lockstat_copy (&entries[i].stats, stats);
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  for (i = 0; i < count && 0 == result; i++)
+    {
+      result = callback (entries[i].kind, entries[i].object, &entries[i].stats, arg);
+    }
+
+  free (entries);
+
+  return result;
+#else
+  (void) callback;
+  (void) arg;
+  return ENOTSUP;
+#endif
+}
+
+
+int
+pthread_lockstat_dump_np (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Writes the statistics of every object that
+      *      pthread_lockstat_walk_np would visit to stderr,
+      *      one line each.
+      *
+      * RESULTS
+      *              as pthread_lockstat_walk_np.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if defined(PTW32_LOCKSTAT)
+  return pthread_lockstat_walk_np (ptw32_lockstat_print, (void *) stderr);
+#else
+  return ENOTSUP;
+#endif
+}
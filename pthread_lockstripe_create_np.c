@@ -0,0 +1,139 @@
+/*
+ * pthread_lockstripe_create_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_lockstripe_create_np (pthread_lockstripe_np_t * stripe,
+			      int nstripes,
+			      const pthread_mutexattr_t * attr)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Creates a table of at least 'nstripes' locks that
+      *      protect data selected by a hash.
+      *
+      * PARAMETERS
+      *      stripe
+      *              pointer to an instance of pthread_lockstripe_np_t
+      *
+      *      nstripes
+      *              number of locks, rounded up to a power of 2,
+      *              from 1 to PTHREAD_LOCKSTRIPE_MAX_NP
+      *
+      *      attr
+      *              mutex attributes of every lock, or NULL
+      *
+      * DESCRIPTION
+      *      Each lock is a mutex, with its spinning and lazily
+      *      created event, placed in its own cache lines of a
+      *      single block, so neighbouring stripes don't
+      *      false-share and the table costs two allocations
+      *      whatever its size.
+      *
+      * RESULTS
+      *              0               successfully created the table,
+      *              EINVAL          'stripe' or 'nstripes' is invalid,
+      *                              or 'attr' is process shared,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_lockstripe_np_t s;
+  int align = ptw32_objectAlign > PTW32_CACHE_LINE_SIZE
+	      ? ptw32_objectAlign : PTW32_CACHE_LINE_SIZE;
+  size_t stride = ptw32_object_stride (sizeof (struct pthread_mutex_t_), align);
+  unsigned int size;
+  unsigned int i;
+  char * block;
+  int pshared;
+  int result = 0;
+
+  if (stripe == NULL || nstripes <= 0 || nstripes > PTHREAD_LOCKSTRIPE_MAX_NP)
+    {
+      return EINVAL;
+    }
+
+  if (attr != NULL
+      && pthread_mutexattr_getpshared (attr, &pshared) == 0
+      && pshared == PTHREAD_PROCESS_SHARED)
+    {
+      return EINVAL;
+    }
+
+  for (size = 1; size < (unsigned int) nstripes; size <<= 1)
+    {
+    }
+
+  s = (pthread_lockstripe_np_t) calloc (1, sizeof (*s) + size * sizeof (pthread_mutex_t));
+
+  if (s == NULL)
+    {
+      return ENOMEM;
+    }
+
+  block = (char *) ptw32_object_alloc (size * stride, align);
+
+  if (block == NULL)
+    {
+      free (s);
+      return ENOMEM;
+    }
+
+  s->locks = (pthread_mutex_t *) (s + 1);
+  s->mask = size - 1;
+
+  for (i = 0; i < size; i++)
+    {
+      if (0 != (result = ptw32_mutex_init (&s->locks[i], attr, block + i * stride, stride)))
+	{
+	  while (i-- > 0)
+	    {
+	      (void) pthread_mutex_destroy (&s->locks[i]);
+	    }
+	  ptw32_object_free (block);
+	  free (s);
+	  return result;
+	}
+    }
+
+  *stripe = s;
+
+  return 0;
+}				/* pthread_lockstripe_create_np */
@@ -0,0 +1,113 @@
+/*
+ * pthread_lockstripe_destroy_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_lockstripe_destroy_np (pthread_lockstripe_np_t * stripe)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Destroys a lock table created with
+      *      pthread_lockstripe_create_np().
+      *
+      * PARAMETERS
+      *      stripe
+      *              pointer to an instance of pthread_lockstripe_np_t
+      *
+      * DESCRIPTION
+      *      The table must not be in use. If a stripe is held
+      *      the table is left as it was.
+      *
+      * RESULTS
+      *              0               successfully destroyed the table,
+      *              EINVAL          'stripe' is invalid,
+      *              EBUSY           a stripe is locked.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_lockstripe_np_t s;
+  pthread_mutex_t block;
+  unsigned int i;
+  int result;
+
+  if (stripe == NULL || *stripe == NULL)
+    {
+      return EINVAL;
+    }
+
+  s = *stripe;
+
+  /*
+   * See that no stripe is held before destroying any, so a busy
+   * table stays usable.
+   */
+  for (i = 0; i <= s->mask; i++)
+    {
+      if (0 != (result = pthread_mutex_trylock (&s->locks[i])))
+	{
+	  while (i-- > 0)
+	    {
+	      (void) pthread_mutex_unlock (&s->locks[i]);
+	    }
+	  return result;
+	}
+    }
+
+  for (i = 0; i <= s->mask; i++)
+    {
+      (void) pthread_mutex_unlock (&s->locks[i]);
+    }
+
+  block = s->locks[0];
+
+  for (i = 0; i <= s->mask; i++)
+    {
+      if (0 != (result = pthread_mutex_destroy (&s->locks[i])))
+	{
+	  return result;
+	}
+    }
+
+  ptw32_object_free (block);
+  free (s);
+  *stripe = NULL;
+
+  return 0;
+}				/* pthread_lockstripe_destroy_np */
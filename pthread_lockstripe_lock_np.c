@@ -0,0 +1,233 @@
+/*
+ * pthread_lockstripe_lock_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_lockstripe_lock_np (pthread_lockstripe_np_t stripe, size_t hash)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Locks the stripe that 'hash' selects.
+      *
+      * PARAMETERS
+      *      stripe
+      *              an instance of pthread_lockstripe_np_t
+      *
+      *      hash
+      *              any value identifying the data, such as a
+      *              bucket number or the address of an object
+      *
+      * DESCRIPTION
+      *      Equal hashes always select the same stripe. The
+      *      stripe is locked as with pthread_mutex_lock().
+      *
+      * RESULTS
+      *              0               the stripe is locked,
+      *              EINVAL          'stripe' is invalid,
+      *              other           as for pthread_mutex_lock().
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (stripe == NULL)
+    {
+      return EINVAL;
+    }
+
+  return pthread_mutex_lock (&stripe->locks[PTW32_LOCKSTRIPE_INDEX (stripe, hash)]);
+}				/* pthread_lockstripe_lock_np */
+
+
+int
+pthread_lockstripe_trylock_np (pthread_lockstripe_np_t stripe, size_t hash)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      As pthread_lockstripe_lock_np() but returns EBUSY
+      *      instead of waiting.
+      *
+      * RESULTS
+      *              0               the stripe is locked,
+      *              EINVAL          'stripe' is invalid,
+      *              EBUSY           the stripe is held,
+      *              other           as for pthread_mutex_trylock().
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (stripe == NULL)
+    {
+      return EINVAL;
+    }
+
+  return pthread_mutex_trylock (&stripe->locks[PTW32_LOCKSTRIPE_INDEX (stripe, hash)]);
+}				/* pthread_lockstripe_trylock_np */
+
+
+int
+pthread_lockstripe_getmutex_np (pthread_lockstripe_np_t stripe, size_t hash,
+				pthread_mutex_t * mutex)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the mutex of the stripe that 'hash' selects,
+      *      for pthread_cond_wait() and the like.
+      *
+      * RESULTS
+      *              0               the mutex is in *mutex,
+      *              EINVAL          'stripe' or 'mutex' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (stripe == NULL || mutex == NULL)
+    {
+      return EINVAL;
+    }
+
+  *mutex = stripe->locks[PTW32_LOCKSTRIPE_INDEX (stripe, hash)];
+
+  return 0;
+}				/* pthread_lockstripe_getmutex_np */
+
+
+static unsigned int
+ptw32_lockstripe_next (pthread_lockstripe_np_t stripe, const size_t * hashes,
+		       int count, unsigned int after, int first)
+{
+  unsigned int next = stripe->mask + 1;
+  int i;
+
+  /*
+   * Lowest stripe above 'after' (or any, the first time), so each
+   * stripe is visited once and all callers go in the same order.
+   */
+  for (i = 0; i < count; i++)
+    {
+      unsigned int index = PTW32_LOCKSTRIPE_INDEX (stripe, hashes[i]);
+
+      if ((first || index > after) && index < next)
+	{
+	  next = index;
+	}
+    }
+
+  return next;
+}
+
+
+int
+pthread_lockstripe_lockmany_np (pthread_lockstripe_np_t stripe,
+				const size_t * hashes, int count)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Locks the stripes of all 'count' hashes without
+      *      risk of deadlock.
+      *
+      * PARAMETERS
+      *      stripe
+      *              an instance of pthread_lockstripe_np_t
+      *
+      *      hashes
+      *              array of 'count' hashes, in any order and
+      *              possibly selecting the same stripe
+      *
+      *      count
+      *              number of hashes, at least 1
+      *
+      * DESCRIPTION
+      *      Each stripe selected is locked once, in ascending
+      *      stripe order, so threads locking overlapping sets
+      *      can't deadlock. On an error the stripes already
+      *      locked are unlocked again. Release the stripes with
+      *      pthread_lockstripe_unlockmany_np() and the same
+      *      hashes.
+      *
+      *      With robust mutex attributes, EOWNERDEAD is returned
+      *      once all the stripes are locked.
+      *
+      * RESULTS
+      *              0               the stripes are locked,
+      *              EINVAL          an argument is invalid,
+      *              other           as for pthread_mutex_lock().
+      *
+      * ------------------------------------------------------
+      */
+{
+  unsigned int index = 0;
+  unsigned int held;
+  int first = PTW32_TRUE;
+  int ownerDead = 0;
+  int result;
+
+  if (stripe == NULL || hashes == NULL || count <= 0)
+    {
+      return EINVAL;
+    }
+
+  while ((index = ptw32_lockstripe_next (stripe, hashes, count, index, first))
+	 <= stripe->mask)
+    {
+      result = pthread_mutex_lock (&stripe->locks[index]);
+
+      if (result == EOWNERDEAD)
+	{
+	  ownerDead = result;
+	}
+      else if (result != 0)
+	{
+	  /* Undo, lowest first, the stripes below this one */
+	  if (!first)
+	    {
+	      held = ptw32_lockstripe_next (stripe, hashes, count, 0, PTW32_TRUE);
+	      while (held < index)
+		{
+		  (void) pthread_mutex_unlock (&stripe->locks[held]);
+		  held = ptw32_lockstripe_next (stripe, hashes, count, held, PTW32_FALSE);
+		}
+	    }
+	  return result;
+	}
+
+      first = PTW32_FALSE;
+    }
+
+  return ownerDead;
+}				/* pthread_lockstripe_lockmany_np */
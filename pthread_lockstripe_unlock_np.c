@@ -0,0 +1,122 @@
+/*
+ * pthread_lockstripe_unlock_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_lockstripe_unlock_np (pthread_lockstripe_np_t stripe, size_t hash)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Unlocks the stripe that 'hash' selects.
+      *
+      * RESULTS
+      *              0               the stripe is unlocked,
+      *              EINVAL          'stripe' is invalid,
+      *              other           as for pthread_mutex_unlock().
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (stripe == NULL)
+    {
+      return EINVAL;
+    }
+
+  return pthread_mutex_unlock (&stripe->locks[PTW32_LOCKSTRIPE_INDEX (stripe, hash)]);
+}				/* pthread_lockstripe_unlock_np */
+
+
+int
+pthread_lockstripe_unlockmany_np (pthread_lockstripe_np_t stripe,
+				  const size_t * hashes, int count)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Unlocks the stripes that
+      *      pthread_lockstripe_lockmany_np() locked for the
+      *      same hashes.
+      *
+      * DESCRIPTION
+      *      Each stripe selected is unlocked once. An error
+      *      from one stripe doesn't stop the others being
+      *      unlocked; the first error is returned.
+      *
+      * RESULTS
+      *              0               the stripes are unlocked,
+      *              EINVAL          an argument is invalid,
+      *              other           as for pthread_mutex_unlock().
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result = 0;
+  int i;
+  int j;
+
+  if (stripe == NULL || hashes == NULL || count <= 0)
+    {
+      return EINVAL;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      unsigned int index = PTW32_LOCKSTRIPE_INDEX (stripe, hashes[i]);
+
+      /* Skip stripes an earlier hash already selected */
+      for (j = 0; j < i; j++)
+	{
+	  if (PTW32_LOCKSTRIPE_INDEX (stripe, hashes[j]) == index)
+	    {
+	      break;
+	    }
+	}
+
+      if (j == i)
+	{
+	  int r = pthread_mutex_unlock (&stripe->locks[index]);
+
+	  if (result == 0)
+	    {
+	      result = r;
+	    }
+	}
+    }
+
+  return result;
+}				/* pthread_lockstripe_unlockmany_np */
@@ -0,0 +1,147 @@
+/*
+ * pthread_lockwatch_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_lockwatch_setcallback_np (void (PTW32_CDECL *callback) (const pthread_lockwatch_np_t * report,
+                                                                void * arg),
+                                  void * arg)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets the routine that lock order and hold time
+      *      reports are made to.
+      *
+      * PARAMETERS
+      *      callback
+      *              routine called with each report, or NULL to
+      *              write reports to stderr
+      *
+      *      arg
+      *              passed to callback
+      *
+      * DESCRIPTION
+      *      A PTHREAD_LOCKWATCH_ORDER_NP report is made the first
+      *      time a thread locks 'acquired' while holding 'held'
+      *      after some thread has locked them the other way round.
+      *      A PTHREAD_LOCKWATCH_HOLD_NP report is made when 'held'
+      *      is unlocked after being held for longer than the hold
+      *      limit. The callback runs in the reporting thread, which
+      *      still holds its mutexes, and must not lock them.
+      *
+      * RESULTS
+      *              0               successfully set the callback,
+      *              ENOTSUP         the library wasn't built with
+      *                              PTW32_LOCKWATCH.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if defined(PTW32_LOCKWATCH)
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&ptw32_lockwatch_lock, &node);
+  ptw32_lockwatchCallback = callback;
+  ptw32_lockwatchArg = arg;
+  ptw32_mcs_lock_release (&node);
+
+  return 0;
+#else
+  (void) callback;
+  (void) arg;
+  return ENOTSUP;
+#endif
+}
+
+
+int
+pthread_lockwatch_setholdlimit_np (const struct timespec * limit)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets how long a mutex may be held before it is
+      *      reported.
+      *
+      * PARAMETERS
+      *      limit
+      *              the longest hold not reported, or NULL or zero
+      *              for no limit
+      *
+      * DESCRIPTION
+      *      The hold is measured from the lock to the unlock. A
+      *      condition variable wait unlocks the mutex, so the time
+      *      spent waiting isn't counted. There is no limit
+      *      initially.
+      *
+      * RESULTS
+      *              0               successfully set the limit,
+      *              EINVAL          'limit' is invalid,
+      *              ENOTSUP         the library wasn't built with
+      *                              PTW32_LOCKWATCH.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if defined(PTW32_LOCKWATCH)
+  ptw32_mcs_local_node_t node;
+  int64_t ticks = 0;
+
+  if (limit != NULL)
+    {
+      int64_t frequency = ptw32_perf_frequency ();
+
+      if (limit->tv_sec < 0 || limit->tv_nsec < 0 || limit->tv_nsec >= 1000000000L)
+        {
+          return EINVAL;
+        }
+
+      ticks = (int64_t) limit->tv_sec * frequency
+              + (int64_t) limit->tv_nsec * frequency / 1000000000;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_lockwatch_lock, &node);
+  ptw32_lockwatchLimit = ticks;
+  ptw32_mcs_lock_release (&node);
+
+  return 0;
+#else
+  (void) limit;
+  return ENOTSUP;
+#endif
+}
@@ -0,0 +1,198 @@
+/*
+ * pthread_mcs_lock_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_mcs_lock_np (pthread_mcs_lock_np_t * lock, pthread_mcs_node_np_t * node)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Locks an MCS queue lock.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_mcs_lock_np_t,
+      *              PTHREAD_MCS_LOCK_INITIALIZER_NP when first used
+      *
+      *      node
+      *              a queue node that isn't otherwise in use, which
+      *              must stay in place until the lock is unlocked
+      *              with it (see pthread_mcs_node_transfer_np())
+      *
+      * DESCRIPTION
+      *      Queues the calling thread behind the lock's current
+      *      holder and waiters, if any, and waits for its
+      *      predecessor to hand it the lock. The waiter polls
+      *      its own node, which no other waiter touches, for a
+      *      short time on multiprocessors and then blocks on an
+      *      event until it is handed the lock. Waiters get the
+      *      lock in arrival order.
+      *
+      *      The lock is not recursive, has no owner and is not a
+      *      cancellation point. A lock needs no initialisation
+      *      beyond PTHREAD_MCS_LOCK_INITIALIZER_NP and no
+      *      destruction; it must be free when its memory is
+      *      reused.
+      *
+      * RESULTS
+      *              0               the lock is held,
+      *              EINVAL          'lock' or 'node' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (lock == NULL || node == NULL)
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_lock_acquire ((ptw32_mcs_lock_t *) lock, (ptw32_mcs_local_node_t *) node);
+
+  return 0;
+}				/* pthread_mcs_lock_np */
+
+
+int
+pthread_mcs_trylock_np (pthread_mcs_lock_np_t * lock, pthread_mcs_node_np_t * node)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Locks an MCS queue lock if it is free.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_mcs_lock_np_t
+      *
+      *      node
+      *              a queue node, as for pthread_mcs_lock_np()
+      *
+      * RESULTS
+      *              0               the lock is held,
+      *              EBUSY           the lock is held or threads
+      *                              are queued for it,
+      *              EINVAL          'lock' or 'node' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (lock == NULL || node == NULL)
+    {
+      return EINVAL;
+    }
+
+  return ptw32_mcs_lock_try_acquire ((ptw32_mcs_lock_t *) lock, (ptw32_mcs_local_node_t *) node);
+}				/* pthread_mcs_trylock_np */
+
+
+int
+pthread_mcs_unlock_np (pthread_mcs_node_np_t * node)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Unlocks an MCS queue lock.
+      *
+      * PARAMETERS
+      *      node
+      *              the queue node the lock was locked with, or
+      *              last transferred to
+      *
+      * DESCRIPTION
+      *      Hands the lock to the next thread queued for it, if
+      *      any, waiting for a thread that is still joining the
+      *      queue to link itself to 'node' first. The node may
+      *      be reused as soon as this returns.
+      *
+      * RESULTS
+      *              0               the lock is released,
+      *              EINVAL          'node' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (node == NULL || node->lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_lock_release ((ptw32_mcs_local_node_t *) node);
+
+  return 0;
+}				/* pthread_mcs_unlock_np */
+
+
+int
+pthread_mcs_node_transfer_np (pthread_mcs_node_np_t * newNode, pthread_mcs_node_np_t * oldNode)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Moves a held MCS queue lock from one queue node to
+      *      another.
+      *
+      * PARAMETERS
+      *      newNode
+      *              a queue node that isn't otherwise in use, for
+      *              example one in the data the lock guards
+      *
+      *      oldNode
+      *              the node the lock is held with
+      *
+      * DESCRIPTION
+      *      Lets a lock taken with a node on the stack outlive the
+      *      function that took it, or be unlocked by another
+      *      thread, which then passes newNode to
+      *      pthread_mcs_unlock_np(). Only the holder may call it.
+      *      oldNode may be reused as soon as this returns.
+      *
+      * RESULTS
+      *              0               the lock is held with newNode,
+      *              EINVAL          a node is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (newNode == NULL || oldNode == NULL || oldNode->lock == NULL
+      || newNode == oldNode)
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_node_transfer ((ptw32_mcs_local_node_t *) newNode, (ptw32_mcs_local_node_t *) oldNode);
+
+  return 0;
+}				/* pthread_mcs_node_transfer_np */
@@ -78,7 +78,7 @@ ptw32_robust_mutex_inherit(pthread_mutex_t * mutex)
 {
   int result;
   pthread_mutex_t mx = *mutex;
-  ptw32_robust_node_t* robust = mx->robustNode;
+  ptw32_robust_node_t* robust = &mx->robustNode;
 
   switch ((LONG)PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
             (PTW32_INTERLOCKED_LONGPTR)&robust->stateInconsistent,
@@ -118,7 +118,7 @@ ptw32_robust_mutex_add(pthread_mutex_t* mutex, pthread_t self)
   ptw32_robust_node_t** list;
   pthread_mutex_t mx = *mutex;
   ptw32_thread_t* tp = (ptw32_thread_t*)self.p;
-  ptw32_robust_node_t* robust = mx->robustNode;
+  ptw32_robust_node_t* robust = &mx->robustNode;
 
   list = &tp->robustMxList;
   mx->ownerThread = self;
@@ -143,7 +143,7 @@ ptw32_robust_mutex_remove(pthread_mutex_t* mutex, ptw32_thread_t* otp)
 {
   ptw32_robust_node_t** list;
   pthread_mutex_t mx = *mutex;
-  ptw32_robust_node_t* robust = mx->robustNode;
+  ptw32_robust_node_t* robust = &mx->robustNode;
 
   list = &(((ptw32_thread_t*)mx->ownerThread.p)->robustMxList);
   mx->ownerThread.p = otp;
@@ -176,9 +176,14 @@ pthread_mutex_consistent (pthread_mutex_t* mutex)
       return EINVAL;
     }
 
+  if (PTW32_IS_PSHARED (mx))
+    {
+      return ptw32_pshared_mutex_consistent (mx);
+    }
+
   if (mx->kind >= 0
         || (PTW32_INTERLOCKED_LONG)PTW32_ROBUST_INCONSISTENT != PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
-                                                (PTW32_INTERLOCKED_LONGPTR)&mx->robustNode->stateInconsistent,
+                                                (PTW32_INTERLOCKED_LONGPTR)&mx->robustNode.stateInconsistent,
                                                 (PTW32_INTERLOCKED_LONG)PTW32_ROBUST_CONSISTENT,
                                                 (PTW32_INTERLOCKED_LONG)PTW32_ROBUST_INCONSISTENT))
     {
@@ -48,6 +48,11 @@ pthread_mutex_destroy (pthread_mutex_t * mutex)
    * Let the system deal with invalid pointers.
    */
 
+  if (PTW32_IS_PSHARED (*mutex))
+    {
+      return ptw32_pshared_mutex_destroy (mutex);
+    }
+
   /*
    * Check to see if we have something to delete.
    */
@@ -78,18 +83,22 @@ pthread_mutex_destroy (pthread_mutex_t * mutex)
 
 	      if (0 == result)
 		{
-                  if (mx->robustNode != NULL)
-                    {
-                      free(mx->robustNode);
-                    }
-		  if (!CloseHandle (mx->event))
+		  if (mx->event != NULL && !ptw32_closehandle (mx->event, PTW32_LIBSTAT_EVENTS))
 		    {
 		      *mutex = mx;
 		      result = EINVAL;
 		    }
 		  else
 		    {
-		      free (mx);
+		      PTW32_LOCKSTAT_DESTROY (mx->stats);
+		      ptw32_object_free (mx->fair);
+		      ptw32_object_free (mx->cohort);
+		      ptw32_object_free (mx->prio);
+		      ptw32_object_free (mx->elide);
+		      if (!mx->inPlace)
+			{
+			  ptw32_object_free (mx);
+			}
 		    }
 		}
 	      else
@@ -112,36 +121,23 @@ pthread_mutex_destroy (pthread_mutex_t * mutex)
     }
   else
     {
-      ptw32_mcs_local_node_t node;
-
-      /*
-       * See notes in ptw32_mutex_check_need_init() above also.
-       */
-
-      ptw32_mcs_lock_acquire(&ptw32_mutex_test_init_lock, &node);
+      mx = *mutex;
 
       /*
-       * Check again.
+       * This is all we need to do to destroy a statically
+       * initialised mutex that has not yet been used (initialised).
+       * Another thread initialising it at the same time fails to
+       * publish its mutex and gets an EINVAL (see notes in
+       * ptw32_mutex_check_need_init() also). If it published first,
+       * assume the mutex is in use.
        */
-      if (*mutex >= PTHREAD_ERRORCHECK_MUTEX_INITIALIZER)
-	{
-	  /*
-	   * This is all we need to do to destroy a statically
-	   * initialised mutex that has not yet been used (initialised).
-	   * If we get to here, another thread
-	   * waiting to initialise this mutex will get an EINVAL.
-	   */
-	  *mutex = NULL;
-	}
-      else
+      if (PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) mutex,
+						  (PTW32_INTERLOCKED_PVOID) NULL,
+						  (PTW32_INTERLOCKED_PVOID) mx)
+	  != (PTW32_INTERLOCKED_PVOID) mx)
 	{
-	  /*
-	   * The mutex has been initialised while we were waiting
-	   * so assume it's in use.
-	   */
 	  result = EBUSY;
 	}
-      ptw32_mcs_lock_release(&node);
     }
 
   return (result);
@@ -0,0 +1,79 @@
+/*
+ * pthread_mutex_getprioceiling.c
+ *
+ * Description:
+ * This translation unit implements mutual exclusion (mutex) primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_mutex_getprioceiling (const pthread_mutex_t * mutex, int *prioceiling)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the priority ceiling of a PTHREAD_PRIO_PROTECT
+      *      mutex.
+      *
+      * PARAMETERS
+      *      mutex
+      *              pointer to an instance of pthread_mutex_t
+      *
+      *      prioceiling
+      *              pointer to an integer to receive the ceiling
+      *
+      * RESULTS
+      *              0               success,
+      *              EINVAL          the mutex isn't a PTHREAD_PRIO_PROTECT
+      *                              mutex or 'prioceiling' is NULL.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_mutex_t mx;
+
+  if (mutex == NULL || prioceiling == NULL
+      || (mx = *mutex) == NULL
+      || PTW32_IS_PSHARED (mx)
+      || mx >= PTHREAD_ERRORCHECK_MUTEX_INITIALIZER
+      || mx->prio == NULL
+      || mx->prio->protocol != PTHREAD_PRIO_PROTECT)
+    {
+      return EINVAL;
+    }
+
+  *prioceiling = mx->prio->ceiling;
+
+  return 0;
+}				/* pthread_mutex_getprioceiling */
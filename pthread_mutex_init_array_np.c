@@ -0,0 +1,121 @@
+/*
+ * pthread_mutex_init_array_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_mutex_init_array_np (pthread_mutex_t * mutexes, size_t n,
+			     const pthread_mutexattr_t * attr)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Initialises an array of mutexes with one allocation.
+      *
+      * PARAMETERS
+      *      mutexes
+      *              array of 'n' pthread_mutex_t
+      *
+      *      n
+      *              number of mutexes
+      *
+      *      attr
+      *              as for pthread_mutex_init(), for every mutex.
+      *
+      * DESCRIPTION
+      *      As pthread_mutex_init() on each element, but the
+      *      mutexes are laid out side by side in one block, at the
+      *      spacing that pthread_setobjectalign_np() asks for. No
+      *      kernel object is created until a mutex is contended.
+      *      The mutexes are used as usual but must be destroyed
+      *      together with pthread_mutex_destroy_array_np(). If
+      *      initialising any of them fails none are left
+      *      initialised.
+      *
+      * RESULTS
+      *              0               successfully initialised the mutexes,
+      *              EINVAL          'mutexes' is NULL, 'n' is 0 or
+      *                              'attr' is process shared,
+      *              ENOMEM          insufficient memory,
+      *              other           as for pthread_mutex_init().
+      *
+      * ------------------------------------------------------
+      */
+{
+  int align = ptw32_objectAlign;
+  size_t stride = ptw32_object_stride (sizeof (struct pthread_mutex_t_), align);
+  char * block;
+  int pshared;
+  int result = 0;
+  size_t i;
+
+  if (mutexes == NULL || n == 0 || n > (size_t) -1 / stride)
+    {
+      return EINVAL;
+    }
+
+  if (attr != NULL
+      && pthread_mutexattr_getpshared (attr, &pshared) == 0
+      && pshared == PTHREAD_PROCESS_SHARED)
+    {
+      return EINVAL;
+    }
+
+  if ((block = (char *) ptw32_object_alloc (n * stride, align)) == NULL)
+    {
+      return ENOMEM;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      if (0 != (result = ptw32_mutex_init (&mutexes[i], attr, block + i * stride, stride)))
+	{
+	  break;
+	}
+    }
+
+  if (result != 0)
+    {
+      while (i-- > 0)
+	{
+	  (void) pthread_mutex_destroy (&mutexes[i]);
+	}
+      ptw32_object_free (block);
+    }
+
+  return result;
+}				/* pthread_mutex_init_array_np */
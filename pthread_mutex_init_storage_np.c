@@ -0,0 +1,85 @@
+/*
+ * pthread_mutex_init_storage_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_mutex_init_storage_np (pthread_mutex_t * mutex,
+			       const pthread_mutexattr_t * attr,
+			       pthread_mutex_storage_np_t * storage)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Initialises a mutex in storage provided by the caller.
+      *
+      * PARAMETERS
+      *      mutex
+      *              pointer to an instance of pthread_mutex_t
+      *
+      *      attr
+      *              as for pthread_mutex_init().
+      *
+      *      storage
+      *              where to keep the mutex, typically next to the
+      *              data it protects
+      *
+      * DESCRIPTION
+      *      As pthread_mutex_init(), but the mutex lives in
+      *      'storage' rather than on the heap, so that locking it
+      *      doesn't touch a separate heap block and large numbers
+      *      of mutexes don't fragment the heap. 'storage' must not
+      *      move or be reused until pthread_mutex_destroy() has
+      *      succeeded. Process shared mutexes, and mutexes that
+      *      don't fit (see PTHREAD_MUTEX_STORAGE_SIZE_NP), are
+      *      allocated as usual.
+      *
+      * RESULTS
+      *              0               successfully initialised mutex,
+      *              EINVAL          'storage' is NULL,
+      *              other           as for pthread_mutex_init().
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (storage == NULL)
+    {
+      return EINVAL;
+    }
+
+  return ptw32_mutex_init (mutex, attr, storage, sizeof (*storage));
+}
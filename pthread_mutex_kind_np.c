@@ -0,0 +1,279 @@
+/*
+ * pthread_mutex_kind_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Kind specialised lock, trylock and unlock.
+ *
+ * pthread_mutex_lock() and friends check for process shared and
+ * statically initialised mutexes and then dispatch on the kind,
+ * the robust kinds, elision, fairness, cohorts and the priority
+ * protocols on every call. The functions below are for a mutex
+ * the caller knows was made by pthread_mutex_init() with a given
+ * kind: they skip the handle checks, compare mx->fastKind with the
+ * kind the caller named (a constant), and if it matches use the
+ * lock_idx protocol directly. Anything else, including the
+ * contended paths, goes through the general functions, so a mutex
+ * of another kind or with other attributes still behaves as the
+ * general functions would.
+ *
+ * ptw32::mutex<Kind> in pthread_mutex_np.hpp wraps these.
+ */
+
+static INLINE int
+ptw32_mutex_take (pthread_mutex_t mx)
+{
+  return 0 == (PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG(
+                (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                (PTW32_INTERLOCKED_LONG) 1,
+                (PTW32_INTERLOCKED_LONG) 0);
+}
+
+static INLINE int
+ptw32_mutex_give (pthread_mutex_t mx)
+{
+  if ((LONG) PTW32_ATOMIC_EXCHANGE_REL_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                                             (PTW32_INTERLOCKED_LONG) 0) < 0L)
+    {
+      /* Someone may be waiting on that mutex */
+      if (ptw32_mutex_wake (mx) != 0)
+        {
+          return EINVAL;
+        }
+    }
+
+  return 0;
+}
+
+/*
+ * The unlock fast path must also leave a deferred condition
+ * variable wakeup to the general function.
+ */
+#if defined(PTW32_COND_WAITONADDRESS)
+#define PTW32_MUTEX_FAST(mx, k) \
+  ((mx)->fastKind == (k) && (mx)->morphCond == NULL)
+#else
+#define PTW32_MUTEX_FAST(mx, k) \
+  ((mx)->fastKind == (k))
+#endif
+
+static INLINE int
+ptw32_mutex_owned_lock (pthread_mutex_t * mutex, int kind)
+{
+  pthread_mutex_t mx = *mutex;
+
+  if (mx->fastKind == kind)
+    {
+      pthread_t self = pthread_self ();
+
+      if (ptw32_mutex_take (mx))
+        {
+          mx->recursive_count = 1;
+          mx->ownerThread = self;
+          return 0;
+        }
+
+      if (pthread_equal (mx->ownerThread, self))
+        {
+          if (kind == PTHREAD_MUTEX_RECURSIVE)
+            {
+              mx->recursive_count++;
+              return 0;
+            }
+          return EDEADLK;
+        }
+    }
+
+  return pthread_mutex_lock (mutex);
+}
+
+static INLINE int
+ptw32_mutex_owned_trylock (pthread_mutex_t * mutex, int kind)
+{
+  pthread_mutex_t mx = *mutex;
+
+  if (mx->fastKind == kind)
+    {
+      pthread_t self = pthread_self ();
+
+      if (ptw32_mutex_take (mx))
+        {
+          mx->recursive_count = 1;
+          mx->ownerThread = self;
+          return 0;
+        }
+
+      if (kind == PTHREAD_MUTEX_RECURSIVE
+          && pthread_equal (mx->ownerThread, self))
+        {
+          mx->recursive_count++;
+          return 0;
+        }
+
+      return EBUSY;
+    }
+
+  return pthread_mutex_trylock (mutex);
+}
+
+static INLINE int
+ptw32_mutex_owned_unlock (pthread_mutex_t * mutex, int kind)
+{
+  pthread_mutex_t mx = *mutex;
+
+  if (PTW32_MUTEX_FAST (mx, kind))
+    {
+      if (!pthread_equal (mx->ownerThread, pthread_self ()))
+        {
+          return EPERM;
+        }
+
+      if (kind == PTHREAD_MUTEX_RECURSIVE && 0 != --mx->recursive_count)
+        {
+          return 0;
+        }
+
+      mx->ownerThread.p = NULL;
+      return ptw32_mutex_give (mx);
+    }
+
+  return pthread_mutex_unlock (mutex);
+}
+
+
+int
+pthread_mutex_lock_normal_np (pthread_mutex_t * mutex)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Locks a PTHREAD_MUTEX_NORMAL mutex.
+      *
+      * PARAMETERS
+      *      mutex
+      *              pointer to a mutex initialised by
+      *              pthread_mutex_init() or
+      *              pthread_mutex_init_storage_np(), and not
+      *              process shared
+      *
+      * DESCRIPTION
+      *      As pthread_mutex_lock(), without the checks for
+      *      static initialisers and process shared mutexes, and
+      *      with the uncontended lock of a plain normal mutex
+      *      inlined. pthread_mutex_lock_recursive_np() and
+      *      pthread_mutex_lock_errorcheck_np() do the same for
+      *      the other kinds. A mutex that isn't of the named
+      *      kind, or uses robustness, elision, fairness or a
+      *      priority protocol, is passed to pthread_mutex_lock().
+      *
+      * RESULTS
+      *              as for pthread_mutex_lock().
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_mutex_t mx = *mutex;
+
+  if (mx->fastKind == PTHREAD_MUTEX_NORMAL && ptw32_mutex_take (mx))
+    {
+      return 0;
+    }
+
+  return pthread_mutex_lock (mutex);
+}				/* pthread_mutex_lock_normal_np */
+
+int
+pthread_mutex_trylock_normal_np (pthread_mutex_t * mutex)
+{
+  pthread_mutex_t mx = *mutex;
+
+  if (mx->fastKind == PTHREAD_MUTEX_NORMAL)
+    {
+      return ptw32_mutex_take (mx) ? 0 : EBUSY;
+    }
+
+  return pthread_mutex_trylock (mutex);
+}				/* pthread_mutex_trylock_normal_np */
+
+int
+pthread_mutex_unlock_normal_np (pthread_mutex_t * mutex)
+{
+  pthread_mutex_t mx = *mutex;
+
+  if (PTW32_MUTEX_FAST (mx, PTHREAD_MUTEX_NORMAL))
+    {
+      return ptw32_mutex_give (mx);
+    }
+
+  return pthread_mutex_unlock (mutex);
+}				/* pthread_mutex_unlock_normal_np */
+
+int
+pthread_mutex_lock_recursive_np (pthread_mutex_t * mutex)
+{
+  return ptw32_mutex_owned_lock (mutex, PTHREAD_MUTEX_RECURSIVE);
+}				/* pthread_mutex_lock_recursive_np */
+
+int
+pthread_mutex_trylock_recursive_np (pthread_mutex_t * mutex)
+{
+  return ptw32_mutex_owned_trylock (mutex, PTHREAD_MUTEX_RECURSIVE);
+}				/* pthread_mutex_trylock_recursive_np */
+
+int
+pthread_mutex_unlock_recursive_np (pthread_mutex_t * mutex)
+{
+  return ptw32_mutex_owned_unlock (mutex, PTHREAD_MUTEX_RECURSIVE);
+}				/* pthread_mutex_unlock_recursive_np */
+
+int
+pthread_mutex_lock_errorcheck_np (pthread_mutex_t * mutex)
+{
+  return ptw32_mutex_owned_lock (mutex, PTHREAD_MUTEX_ERRORCHECK);
+}				/* pthread_mutex_lock_errorcheck_np */
+
+int
+pthread_mutex_trylock_errorcheck_np (pthread_mutex_t * mutex)
+{
+  return ptw32_mutex_owned_trylock (mutex, PTHREAD_MUTEX_ERRORCHECK);
+}				/* pthread_mutex_trylock_errorcheck_np */
+
+int
+pthread_mutex_unlock_errorcheck_np (pthread_mutex_t * mutex)
+{
+  return ptw32_mutex_owned_unlock (mutex, PTHREAD_MUTEX_ERRORCHECK);
+}				/* pthread_mutex_unlock_errorcheck_np */
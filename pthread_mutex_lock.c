@@ -46,6 +46,7 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
   int kind;
   pthread_mutex_t mx;
   int result = 0;
+  PTW32_LOCKSTAT_DECL (waitStart)
 
   /*
    * Let the system deal with invalid pointers.
@@ -55,6 +56,11 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
       return EINVAL;
     }
 
+  if (PTW32_IS_PSHARED (*mutex))
+    {
+      return ptw32_pshared_mutex_lock (*mutex, CLOCK_REALTIME, NULL);
+    }
+
   /*
    * We do a quick check to see if we need to do more work
    * to initialise a static mutex. We check
@@ -72,20 +78,56 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
   mx = *mutex;
   kind = mx->kind;
 
+  if (mx->prio != NULL && (result = ptw32_mutex_prio_check (mx)) != 0)
+    {
+      return result;
+    }
+
+  PTW32_LOCKWATCH_ORDER (mx);
+
   if (kind >= 0)
     {
       /* Non-robust */
+      if (PTHREAD_MUTEX_ELIDE_NP == kind)
+        {
+          if (ptw32_mutex_elide_lock (mx))
+            {
+              return 0;
+            }
+          kind = PTHREAD_MUTEX_NORMAL;
+        }
+
       if (PTHREAD_MUTEX_NORMAL == kind)
         {
-          if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+          LONG idx;
+
+          if (mx->fair != NULL)
+            {
+              /* Mustn't overwrite -1 or -2: see ptw32_mutex_fair.c */
+              if ((PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG(
+                           (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+		           (PTW32_INTERLOCKED_LONG) 1,
+		           (PTW32_INTERLOCKED_LONG) 0) != 0
+                  && !PTW32_LOCKSTAT_SPIN (mx, 1, waitStart)
+                  && 0 != ptw32_mutex_fair_acquire (mx, CLOCK_REALTIME, NULL))
+                {
+                  result = EINVAL;
+                }
+            }
+          else if (mx->cohort != NULL)
+            {
+              result = ptw32_mutex_cohort_acquire (mx);
+            }
+          else if ((idx = (LONG) PTW32_ATOMIC_EXCHANGE_ACQ_LONG(
 		       (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
-		       (PTW32_INTERLOCKED_LONG) 1) != 0)
+		       (PTW32_INTERLOCKED_LONG) 1)) != 0
+              && !PTW32_LOCKSTAT_SPIN (mx, idx, waitStart))
 	    {
-	      while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+	      while ((PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_EXCHANGE_ACQ_LONG(
                               (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 			      (PTW32_INTERLOCKED_LONG) -1) != 0)
 	        {
-	          if (WAIT_OBJECT_0 != WaitForSingleObject (mx->event, INFINITE))
+	          if (0 != ptw32_mutex_wait (mx, CLOCK_REALTIME, NULL))
 	            {
 	              result = EINVAL;
 		      break;
@@ -97,7 +139,7 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
         {
           pthread_t self = pthread_self();
 
-          if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+          if ((PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG(
                        (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 		       (PTW32_INTERLOCKED_LONG) 1,
 		       (PTW32_INTERLOCKED_LONG) 0) == 0)
@@ -120,16 +162,34 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
 	        }
 	      else
 	        {
-	          while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
-                                  (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
-			          (PTW32_INTERLOCKED_LONG) -1) != 0)
-		    {
-	              if (WAIT_OBJECT_0 != WaitForSingleObject (mx->event, INFINITE))
-		        {
+	          if (mx->cohort != NULL)
+	            {
+	              result = ptw32_mutex_cohort_acquire (mx);
+	            }
+	          else if (PTW32_LOCKSTAT_SPIN (mx, 1, waitStart))
+	            {
+	              /* Acquired */
+	            }
+	          else if (mx->fair != NULL)
+	            {
+	              if (0 != ptw32_mutex_fair_acquire (mx, CLOCK_REALTIME, NULL))
+	                {
 	                  result = EINVAL;
-		          break;
+	                }
+	            }
+	          else
+	            {
+	              while ((PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_EXCHANGE_ACQ_LONG(
+                                      (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+			              (PTW32_INTERLOCKED_LONG) -1) != 0)
+		        {
+	                  if (0 != ptw32_mutex_wait (mx, CLOCK_REALTIME, NULL))
+		            {
+	                      result = EINVAL;
+		              break;
+		            }
 		        }
-		    }
+	            }
 
 	          if (0 == result)
 		    {
@@ -147,7 +207,7 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
        * All types record the current owner thread.
        * The mutex is added to a per thread list when ownership is acquired.
        */
-      ptw32_robust_state_t* statePtr = &mx->robustNode->stateInconsistent;
+      ptw32_robust_state_t* statePtr = &mx->robustNode.stateInconsistent;
 
       if ((PTW32_INTERLOCKED_LONG)PTW32_ROBUST_NOTRECOVERABLE == PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
                                                  (PTW32_INTERLOCKED_LONGPTR)statePtr,
@@ -163,16 +223,19 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
     
           if (PTHREAD_MUTEX_NORMAL == kind)
             {
-              if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+              LONG idx;
+
+              if ((idx = (LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
                            (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
-                           (PTW32_INTERLOCKED_LONG) 1) != 0)
+                           (PTW32_INTERLOCKED_LONG) 1)) != 0
+                  && !PTW32_LOCKSTAT_SPIN (mx, idx, waitStart))
                 {
                   while (0 == (result = ptw32_robust_mutex_inherit(mutex))
                            && (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
                                        (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
                                        (PTW32_INTERLOCKED_LONG) -1) != 0)
                     {
-                      if (WAIT_OBJECT_0 != WaitForSingleObject (mx->event, INFINITE))
+                      if (0 != ptw32_mutex_wait (mx, CLOCK_REALTIME, NULL))
                         {
                           result = EINVAL;
                           break;
@@ -183,7 +246,7 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
                                     (PTW32_INTERLOCKED_LONG)0))
                         {
                           /* Unblock the next thread */
-                          SetEvent(mx->event);
+                          (void) ptw32_mutex_wake (mx);
                           result = ENOTRECOVERABLE;
                           break;
                         }
@@ -227,25 +290,28 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
                     }
                   else
                     {
-                      while (0 == (result = ptw32_robust_mutex_inherit(mutex))
-                               && (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
-                                           (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
-                                           (PTW32_INTERLOCKED_LONG) -1) != 0)
+                      if (!PTW32_LOCKSTAT_SPIN (mx, 1, waitStart))
                         {
-                          if (WAIT_OBJECT_0 != WaitForSingleObject (mx->event, INFINITE))
+                          while (0 == (result = ptw32_robust_mutex_inherit(mutex))
+                                   && (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                                               (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                                               (PTW32_INTERLOCKED_LONG) -1) != 0)
                             {
-                              result = EINVAL;
-                              break;
-                            }
-                          if ((PTW32_INTERLOCKED_LONG)PTW32_ROBUST_NOTRECOVERABLE ==
-                                      PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
-                                        (PTW32_INTERLOCKED_LONGPTR)statePtr,
-                                        (PTW32_INTERLOCKED_LONG)0))
-                            {
-                              /* Unblock the next thread */
-                              SetEvent(mx->event);
-                              result = ENOTRECOVERABLE;
-                              break;
+                              if (0 != ptw32_mutex_wait (mx, CLOCK_REALTIME, NULL))
+                                {
+                                  result = EINVAL;
+                                  break;
+                                }
+                              if ((PTW32_INTERLOCKED_LONG)PTW32_ROBUST_NOTRECOVERABLE ==
+                                          PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
+                                            (PTW32_INTERLOCKED_LONGPTR)statePtr,
+                                            (PTW32_INTERLOCKED_LONG)0))
+                                {
+                                  /* Unblock the next thread */
+                                  (void) ptw32_mutex_wake (mx);
+                                  result = ENOTRECOVERABLE;
+                                  break;
+                                }
                             }
                         }
 
@@ -264,6 +330,13 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
         }
     }
 
+  if (0 == result || EOWNERDEAD == result)
+    {
+      PTW32_LOCKSTAT_MUTEX_WAITED (mx, waitStart);
+      PTW32_LOCKWATCH_ACQUIRED (mx);
+      PTW32_MUTEX_PRIO_ACQUIRED (mx);
+    }
+
   return (result);
 }
 
@@ -0,0 +1,109 @@
+/*
+ * pthread_mutex_lock_async_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_mutex_lock_async_np (pthread_mutex_t * mutex,
+			     pthread_pool_np_t pool,
+			     void (PTW32_CDECL * callback) (void *),
+			     void * arg)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Locks a mutex without blocking the calling thread:
+      *      'callback' is run on 'pool' once the mutex has been
+      *      locked for it.
+      *
+      * PARAMETERS
+      *      mutex
+      *              pointer to a process private, non-robust
+      *              PTHREAD_MUTEX_NORMAL mutex
+      *
+      *      pool
+      *              the thread pool to run 'callback' on
+      *
+      *      callback
+      *              routine called with 'arg', owning the mutex
+      *
+      *      arg
+      *              passed to 'callback'
+      *
+      * DESCRIPTION
+      *      The waiter queues without a thread and takes its turn
+      *      with threads blocked in pthread_mutex_lock() on the same
+      *      mutex. The mutex is then locked on behalf of 'callback',
+      *      which (or whatever it hands the mutex to) must unlock
+      *      it with pthread_mutex_unlock(), from any thread. If the
+      *      mutex is free it is locked at once and 'callback' is
+      *      submitted to the pool before this function returns.
+      *
+      *      Neither the mutex nor the pool may be destroyed while
+      *      a waiter is pending.
+      *
+      * RESULTS
+      *              0               'callback' will be called,
+      *              EINVAL          an argument is invalid, the pool
+      *                              is being destroyed, or the mutex
+      *                              isn't a plain normal mutex,
+      *              ENOTSUP         the mutex is process shared, or
+      *                              the library was built with
+      *                              PTW32_LOCKSTAT or PTW32_LOCKWATCH,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_async_waiter_t * w;
+  pthread_mutex_t mx;
+  int result;
+
+  if ((result = ptw32_async_mutex_check (mutex)) != 0
+      || (result = ptw32_async_new (pool, callback, arg, &w)) != 0)
+    {
+      return result;
+    }
+
+  mx = *mutex;
+  w->type = PTW32_ASYNC_MUTEX;
+  w->object = mx;
+
+  ptw32_async_wait (w, (volatile VOID *) &mx->lock_idx);
+
+  return 0;
+}				/* pthread_mutex_lock_async_np */
@@ -0,0 +1,126 @@
+/*
+ * Module: pthread_mutex_np.hpp
+ *
+ * Purpose:
+ *	C++ wrappers for the kind specialised mutex functions
+ *	(pthread_mutex_lock_normal_np() etc.). The mutex kind is a
+ *	template argument, so each member function calls the entry
+ *	point for that kind directly.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+#if !defined( PTHREAD_MUTEX_NP_HPP )
+#define PTHREAD_MUTEX_NP_HPP
+
+#include <new>
+#include <pthread.h>
+
+namespace ptw32
+{
+
+  template <int Kind> struct mutex_ops;
+
+  template <> struct mutex_ops<PTHREAD_MUTEX_NORMAL>
+  {
+    static int lock (pthread_mutex_t * m) { return pthread_mutex_lock_normal_np (m); }
+    static int trylock (pthread_mutex_t * m) { return pthread_mutex_trylock_normal_np (m); }
+    static int unlock (pthread_mutex_t * m) { return pthread_mutex_unlock_normal_np (m); }
+  };
+
+  template <> struct mutex_ops<PTHREAD_MUTEX_RECURSIVE>
+  {
+    static int lock (pthread_mutex_t * m) { return pthread_mutex_lock_recursive_np (m); }
+    static int trylock (pthread_mutex_t * m) { return pthread_mutex_trylock_recursive_np (m); }
+    static int unlock (pthread_mutex_t * m) { return pthread_mutex_unlock_recursive_np (m); }
+  };
+
+  template <> struct mutex_ops<PTHREAD_MUTEX_ERRORCHECK>
+  {
+    static int lock (pthread_mutex_t * m) { return pthread_mutex_lock_errorcheck_np (m); }
+    static int trylock (pthread_mutex_t * m) { return pthread_mutex_trylock_errorcheck_np (m); }
+    static int unlock (pthread_mutex_t * m) { return pthread_mutex_unlock_errorcheck_np (m); }
+  };
+
+  /*
+   * A process private mutex of the given kind. lock(), try_lock()
+   * and unlock() make it usable with std::lock_guard and
+   * std::unique_lock. lock() and unlock() return the error
+   * pthread_mutex_lock() and pthread_mutex_unlock() would, e.g.
+   * EDEADLK and EPERM for an error checking mutex. The constructor
+   * throws std::bad_alloc if the mutex can't be created.
+   */
+  template <int Kind = PTHREAD_MUTEX_NORMAL>
+  class mutex
+  {
+  public:
+    mutex ()
+    {
+      pthread_mutexattr_t attr;
+      int result;
+
+      if (pthread_mutexattr_init (&attr) != 0)
+        {
+          throw std::bad_alloc ();
+        }
+      result = pthread_mutexattr_settype (&attr, Kind);
+      if (result == 0)
+        {
+          result = pthread_mutex_init (&m_, &attr);
+        }
+      (void) pthread_mutexattr_destroy (&attr);
+      if (result != 0)
+        {
+          throw std::bad_alloc ();
+        }
+    }
+
+    ~mutex () { (void) pthread_mutex_destroy (&m_); }
+
+    int lock () { return mutex_ops<Kind>::lock (&m_); }
+    bool try_lock () { return mutex_ops<Kind>::trylock (&m_) == 0; }
+    int unlock () { return mutex_ops<Kind>::unlock (&m_); }
+
+    pthread_mutex_t * native_handle () { return &m_; }
+
+  private:
+    mutex (const mutex &);
+    mutex & operator= (const mutex &);
+
+    pthread_mutex_t m_;
+  };
+
+  typedef mutex<PTHREAD_MUTEX_NORMAL> normal_mutex;
+  typedef mutex<PTHREAD_MUTEX_RECURSIVE> recursive_mutex;
+  typedef mutex<PTHREAD_MUTEX_ERRORCHECK> errorcheck_mutex;
+
+} /* namespace ptw32 */
+
+#endif /* PTHREAD_MUTEX_NP_HPP */
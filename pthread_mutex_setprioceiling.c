@@ -0,0 +1,101 @@
+/*
+ * pthread_mutex_setprioceiling.c
+ *
+ * Description:
+ * This translation unit implements mutual exclusion (mutex) primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_mutex_setprioceiling (pthread_mutex_t * mutex, int prioceiling,
+			      int *old_ceiling)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Changes the priority ceiling of a PTHREAD_PRIO_PROTECT
+      *      mutex.
+      *
+      * PARAMETERS
+      *      mutex
+      *              pointer to an instance of pthread_mutex_t
+      *
+      *      prioceiling
+      *              the new ceiling, as for
+      *              pthread_mutexattr_setprioceiling()
+      *
+      *      old_ceiling
+      *              pointer to an integer to receive the previous
+      *              ceiling
+      *
+      * DESCRIPTION
+      *      Locks the mutex, waiting for it if necessary, changes
+      *      the ceiling and unlocks the mutex again. The calling
+      *      thread must be allowed to lock the mutex under its
+      *      current ceiling.
+      *
+      * RESULTS
+      *              0               the ceiling was changed,
+      *              EINVAL          the mutex isn't a PTHREAD_PRIO_PROTECT
+      *                              mutex or 'prioceiling' is invalid,
+      *              as pthread_mutex_lock otherwise.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_mutex_t mx;
+  int result;
+
+  if (mutex == NULL || old_ceiling == NULL
+      || (mx = *mutex) == NULL
+      || PTW32_IS_PSHARED (mx)
+      || mx >= PTHREAD_ERRORCHECK_MUTEX_INITIALIZER
+      || mx->prio == NULL
+      || mx->prio->protocol != PTHREAD_PRIO_PROTECT
+      || prioceiling < sched_get_priority_min (SCHED_OTHER)
+      || prioceiling > sched_get_priority_max (SCHED_FIFO))
+    {
+      return EINVAL;
+    }
+
+  if ((result = pthread_mutex_lock (mutex)) != 0)
+    {
+      return result;
+    }
+
+  *old_ceiling = mx->prio->ceiling;
+  mx->prio->ceiling = prioceiling;
+
+  return pthread_mutex_unlock (mutex);
+}				/* pthread_mutex_setprioceiling */
@@ -38,79 +38,67 @@
 #include "implement.h"
 
 
-static INLINE int
-ptw32_timed_eventwait (HANDLE event, const struct timespec *abstime)
-     /*
-      * ------------------------------------------------------
-      * DESCRIPTION
-      *      This function waits on an event until signaled or until
-      *      abstime passes.
-      *      If abstime has passed when this routine is called then
-      *      it returns a result to indicate this.
-      *
-      *      If 'abstime' is a NULL pointer then this function will
-      *      block until it can successfully decrease the value or
-      *      until interrupted by a signal.
-      *
-      *      This routine is not a cancellation point.
-      *
-      * RESULTS
-      *              0               successfully signaled,
-      *              ETIMEDOUT       abstime passed
-      *              EINVAL          'event' is not a valid event,
-      *
-      * ------------------------------------------------------
-      */
+/*
+ * The deadline the waits below sleep until: abstime on the monotonic
+ * clock, worked out when the thread first has to block so that an
+ * uncontended lock doesn't read the clock, and a thread that loses
+ * the lock again after a wakeup doesn't read the system time again.
+ * A deadline with a negative tv_nsec hasn't been worked out yet.
+ */
+static INLINE const struct timespec *
+ptw32_mutex_deadline (clockid_t clock, const struct timespec * abstime,
+		      struct timespec * deadline)
 {
-
-  DWORD milliseconds;
-  DWORD status;
-
-  if (event == NULL)
+  if (abstime == NULL)
     {
-      return EINVAL;
+      return NULL;
     }
-  else
-    {
-      if (abstime == NULL)
-	{
-	  milliseconds = INFINITE;
-	}
-      else
-	{
-	  /* 
-	   * Calculate timeout as milliseconds from current system time. 
-	   */
-	  milliseconds = ptw32_relmillisecs (abstime);
-	}
 
-      status = WaitForSingleObject (event, milliseconds);
-
-      if (status != WAIT_OBJECT_0)
-        {
-          if (status == WAIT_TIMEOUT)
-            {
-              return ETIMEDOUT;
-            }
-          else
-            {
-              return EINVAL;
-            }
-        }
+  if (deadline->tv_nsec < 0)
+    {
+      ptw32_monotonic_deadline (clock, abstime, deadline);
     }
 
-  return 0;
-
-}				/* ptw32_timed_semwait */
+  return deadline;
+}
 
 
 int
 pthread_mutex_timedlock (pthread_mutex_t * mutex,
 			 const struct timespec *abstime)
+{
+  return pthread_mutex_clocklock (mutex, CLOCK_REALTIME, abstime);
+}
+
+
+/*
+ * pthread_mutex_clocklock once the clock has been checked. The clock may
+ * also be PTW32_CLOCK_RELATIVE.
+ */
+static int
+ptw32_mutex_clocklock (pthread_mutex_t * mutex,
+		       clockid_t clock_id,
+		       const struct timespec *abstime)
 {
   pthread_mutex_t mx;
   int kind;
   int result = 0;
+  struct timespec deadline;
+  PTW32_LOCKSTAT_DECL (waitStart)
+
+  deadline.tv_sec = 0;
+  deadline.tv_nsec = -1;
+
+  if (PTW32_IS_PSHARED (*mutex))
+    {
+      if (clock_id == PTW32_CLOCK_RELATIVE)
+	{
+	  ptw32_monotonic_deadline (clock_id, abstime, &deadline);
+	  return ptw32_pshared_mutex_lock (*mutex, CLOCK_MONOTONIC, &deadline);
+	}
+
+      return ptw32_pshared_mutex_lock (*mutex, clock_id, abstime);
+    }
 
   /*
    * Let the system deal with invalid pointers.
@@ -133,19 +121,74 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
   mx = *mutex;
   kind = mx->kind;
 
+  if (mx->prio != NULL && (result = ptw32_mutex_prio_check (mx)) != 0)
+    {
+      return result;
+    }
+
+  PTW32_LOCKWATCH_ORDER (mx);
+
   if (kind >= 0)
     {
-      if (mx->kind == PTHREAD_MUTEX_NORMAL)
+      if (PTHREAD_MUTEX_ELIDE_NP == kind)
+        {
+          if (ptw32_mutex_elide_lock (mx))
+            {
+              return 0;
+            }
+          kind = PTHREAD_MUTEX_NORMAL;
+        }
+
+      if (PTHREAD_MUTEX_NORMAL == kind)
         {
-          if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+          LONG idx;
+
+          if (mx->fair != NULL)
+            {
+              /* Mustn't overwrite -1 or -2: see ptw32_mutex_fair.c */
+              if ((PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG(
+                           (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+		           (PTW32_INTERLOCKED_LONG) 1,
+		           (PTW32_INTERLOCKED_LONG) 0) != 0
+                  && !PTW32_LOCKSTAT_SPIN (mx, 1, waitStart)
+                  && 0 != (result = ptw32_mutex_fair_acquire (mx, CLOCK_MONOTONIC, ptw32_mutex_deadline (clock_id, abstime, &deadline))))
+                {
+                  return result;
+                }
+            }
+          else if (mx->cohort != NULL)
+            {
+              /*
+               * Mustn't overwrite PTW32_MUTEX_COHORT_HELD with 1: see
+               * ptw32_mutex_cohort.c. Timed waits don't queue.
+               */
+              if ((PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG(
+                           (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+		           (PTW32_INTERLOCKED_LONG) 1,
+		           (PTW32_INTERLOCKED_LONG) 0) != 0
+                  && !PTW32_LOCKSTAT_SPIN (mx, 1, waitStart))
+                {
+                  while ((PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_EXCHANGE_ACQ_LONG(
+                                  (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+			          (PTW32_INTERLOCKED_LONG) -1) != 0)
+                    {
+	              if (0 != (result = ptw32_mutex_wait (mx, CLOCK_MONOTONIC, ptw32_mutex_deadline (clock_id, abstime, &deadline))))
+		        {
+		          return result;
+		        }
+	            }
+                }
+            }
+          else if ((idx = (LONG) PTW32_ATOMIC_EXCHANGE_ACQ_LONG(
 		       (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
-		       (PTW32_INTERLOCKED_LONG) 1) != 0)
+		       (PTW32_INTERLOCKED_LONG) 1)) != 0
+              && !PTW32_LOCKSTAT_SPIN (mx, idx, waitStart))
 	    {
-              while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+              while ((PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_EXCHANGE_ACQ_LONG(
                               (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 			      (PTW32_INTERLOCKED_LONG) -1) != 0)
                 {
-	          if (0 != (result = ptw32_timed_eventwait (mx->event, abstime)))
+	          if (0 != (result = ptw32_mutex_wait (mx, CLOCK_MONOTONIC, ptw32_mutex_deadline (clock_id, abstime, &deadline))))
 		    {
 		      return result;
 		    }
@@ -156,7 +199,7 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
         {
           pthread_t self = pthread_self();
 
-          if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+          if ((PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG(
                        (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 		       (PTW32_INTERLOCKED_LONG) 1,
 		       (PTW32_INTERLOCKED_LONG) 0) == 0)
@@ -179,15 +222,29 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
 	        }
 	      else
 	        {
-                  while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
-                                  (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
-			          (PTW32_INTERLOCKED_LONG) -1) != 0)
+                  if (PTW32_LOCKSTAT_SPIN (mx, 1, waitStart))
                     {
-		      if (0 != (result = ptw32_timed_eventwait (mx->event, abstime)))
-		        {
-		          return result;
-		        }
-		    }
+                      /* Acquired */
+                    }
+                  else if (mx->fair != NULL)
+                    {
+                      if (0 != (result = ptw32_mutex_fair_acquire (mx, CLOCK_MONOTONIC, ptw32_mutex_deadline (clock_id, abstime, &deadline))))
+                        {
+                          return result;
+                        }
+                    }
+                  else
+                    {
+                      while ((PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_EXCHANGE_ACQ_LONG(
+                                      (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+				      (PTW32_INTERLOCKED_LONG) -1) != 0)
+                        {
+			  if (0 != (result = ptw32_mutex_wait (mx, CLOCK_MONOTONIC, ptw32_mutex_deadline (clock_id, abstime, &deadline))))
+			    {
+			      return result;
+			    }
+			}
+                    }
 
 	          mx->recursive_count = 1;
 	          mx->ownerThread = self;
@@ -202,7 +259,7 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
        * All types record the current owner thread.
        * The mutex is added to a per thread list when ownership is acquired.
        */
-      ptw32_robust_state_t* statePtr = &mx->robustNode->stateInconsistent;
+      ptw32_robust_state_t* statePtr = &mx->robustNode.stateInconsistent;
 
       if ((PTW32_INTERLOCKED_LONG)PTW32_ROBUST_NOTRECOVERABLE == PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
                                                  (PTW32_INTERLOCKED_LONGPTR)statePtr,
@@ -218,16 +275,19 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
 
           if (PTHREAD_MUTEX_NORMAL == kind)
             {
-              if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+              LONG idx;
+
+              if ((idx = (LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
 		           (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
-		           (PTW32_INTERLOCKED_LONG) 1) != 0)
+		           (PTW32_INTERLOCKED_LONG) 1)) != 0
+                  && !PTW32_LOCKSTAT_SPIN (mx, idx, waitStart))
 	        {
                   while (0 == (result = ptw32_robust_mutex_inherit(mutex))
                            && (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
                                   (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 			          (PTW32_INTERLOCKED_LONG) -1) != 0)
                     {
-	              if (0 != (result = ptw32_timed_eventwait (mx->event, abstime)))
+	              if (0 != (result = ptw32_mutex_wait (mx, CLOCK_MONOTONIC, ptw32_mutex_deadline (clock_id, abstime, &deadline))))
 		        {
 		          return result;
 		        }
@@ -237,21 +297,21 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
                                     (PTW32_INTERLOCKED_LONG)0))
                         {
                           /* Unblock the next thread */
-                          SetEvent(mx->event);
+                          (void) ptw32_mutex_wake (mx);
                           result = ENOTRECOVERABLE;
                           break;
                         }
 	            }
-
-                  if (0 == result || EOWNERDEAD == result)
-                    {
-                      /*
-                       * Add mutex to the per-thread robust mutex currently-held list.
-                       * If the thread terminates, all mutexes in this list will be unlocked.
-                       */
-                      ptw32_robust_mutex_add(mutex, self);
-                    }
 	        }
+
+              if (0 == result || EOWNERDEAD == result)
+                {
+                  /*
+                   * Add mutex to the per-thread robust mutex currently-held list.
+                   * If the thread terminates, all mutexes in this list will be unlocked.
+                   */
+                  ptw32_robust_mutex_add(mutex, self);
+                }
             }
           else
             {
@@ -284,16 +344,19 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
 	            }
 	          else
 	            {
-                      while (0 == (result = ptw32_robust_mutex_inherit(mutex))
-                               && (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
-                                          (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
-			                  (PTW32_INTERLOCKED_LONG) -1) != 0)
+                      if (!PTW32_LOCKSTAT_SPIN (mx, 1, waitStart))
                         {
-		          if (0 != (result = ptw32_timed_eventwait (mx->event, abstime)))
-		            {
-		              return result;
-		            }
-		        }
+                          while (0 == (result = ptw32_robust_mutex_inherit(mutex))
+                                   && (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                                              (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+					      (PTW32_INTERLOCKED_LONG) -1) != 0)
+                            {
+			      if (0 != (result = ptw32_mutex_wait (mx, CLOCK_MONOTONIC, ptw32_mutex_deadline (clock_id, abstime, &deadline))))
+				{
+				  return result;
+				}
+			    }
+                        }
 
                       if ((PTW32_INTERLOCKED_LONG)PTW32_ROBUST_NOTRECOVERABLE ==
                                   PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
@@ -301,7 +364,7 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
                                     (PTW32_INTERLOCKED_LONG)0))
                         {
                           /* Unblock the next thread */
-                          SetEvent(mx->event);
+                          (void) ptw32_mutex_wake (mx);
                           result = ENOTRECOVERABLE;
                         }
                       else if (0 == result || EOWNERDEAD == result)
@@ -319,5 +382,99 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
         }
     }
 
+  if (0 == result || EOWNERDEAD == result)
+    {
+      PTW32_LOCKSTAT_MUTEX_WAITED (mx, waitStart);
+      PTW32_LOCKWATCH_ACQUIRED (mx);
+      PTW32_MUTEX_PRIO_ACQUIRED (mx);
+    }
+
   return result;
 }
+
+
+int
+pthread_mutex_clocklock (pthread_mutex_t * mutex,
+			 clockid_t clock_id,
+			 const struct timespec *abstime)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      As pthread_mutex_timedlock, with abstime measured
+      *      against clock_id.
+      *
+      * PARAMETERS
+      *      mutex
+      *              pointer to an instance of pthread_mutex_t
+      *
+      *      clock_id
+      *              CLOCK_REALTIME or CLOCK_MONOTONIC
+      *
+      *      abstime
+      *              absolute time by which to lock the mutex
+      *
+      * DESCRIPTION
+      *      Locks the mutex, waiting no later than abstime.
+      *      A CLOCK_MONOTONIC abstime is unaffected by changes
+      *      to the system time. A CLOCK_REALTIME abstime is
+      *      converted to the monotonic clock once, when the
+      *      thread first blocks, so every later sleep is for
+      *      just the time that remains; a change to the system
+      *      time after that doesn't move the deadline.
+      *
+      * RESULTS
+      *              0               the mutex is locked,
+      *              EINVAL          clock_id is not a supported clock,
+      *              ETIMEDOUT       abstime passed,
+      *              as pthread_mutex_timedlock otherwise.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (!PTW32_VALID_CLOCK(clock_id))
+    {
+      return EINVAL;
+    }
+
+  return ptw32_mutex_clocklock (mutex, clock_id, abstime);
+}
+
+
+int
+pthread_mutex_reltimedlock_np (pthread_mutex_t * mutex,
+			       const struct timespec *reltime)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      As pthread_mutex_timedlock, with a timeout relative
+      *      to the call instead of an absolute time.
+      *
+      * PARAMETERS
+      *      mutex
+      *              pointer to an instance of pthread_mutex_t
+      *
+      *      reltime
+      *              how long to wait for the mutex
+      *
+      * DESCRIPTION
+      *      Locks the mutex, waiting for no longer than reltime.
+      *      The caller needn't read the clock to make an
+      *      abstime, and the library reads the monotonic clock
+      *      only if the thread has to block, once.
+      *
+      * RESULTS
+      *              0               the mutex is locked,
+      *              EINVAL          reltime is invalid,
+      *              ETIMEDOUT       reltime passed,
+      *              as pthread_mutex_timedlock otherwise.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (!PTW32_VALID_RELTIME(reltime))
+    {
+      return EINVAL;
+    }
+
+  return ptw32_mutex_clocklock (mutex, PTW32_CLOCK_RELATIVE, reltime);
+}
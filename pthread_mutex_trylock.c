@@ -49,6 +49,11 @@ pthread_mutex_trylock (pthread_mutex_t * mutex)
    * Let the system deal with invalid pointers.
    */
 
+  if (PTW32_IS_PSHARED (*mutex))
+    {
+      return ptw32_pshared_mutex_trylock (*mutex);
+    }
+
   /*
    * We do a quick check to see if we need to do more work
    * to initialise a static mutex. We check
@@ -66,10 +71,24 @@ pthread_mutex_trylock (pthread_mutex_t * mutex)
   mx = *mutex;
   kind = mx->kind;
 
+  if (mx->prio != NULL && (result = ptw32_mutex_prio_check (mx)) != 0)
+    {
+      return result;
+    }
+
   if (kind >= 0)
     {
       /* Non-robust */
-      if (0 == (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG (
+      if (PTHREAD_MUTEX_ELIDE_NP == kind)
+        {
+          if (ptw32_mutex_elide_lock (mx))
+            {
+              return 0;
+            }
+          kind = PTHREAD_MUTEX_NORMAL;
+        }
+
+      if (0 == (PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG (
 		         (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 		         (PTW32_INTERLOCKED_LONG) 1,
 		         (PTW32_INTERLOCKED_LONG) 0))
@@ -101,7 +120,7 @@ pthread_mutex_trylock (pthread_mutex_t * mutex)
        * The mutex is added to a per thread list when ownership is acquired.
        */
       pthread_t self;
-      ptw32_robust_state_t* statePtr = &mx->robustNode->stateInconsistent;
+      ptw32_robust_state_t* statePtr = &mx->robustNode.stateInconsistent;
 
       if ((PTW32_INTERLOCKED_LONG)PTW32_ROBUST_NOTRECOVERABLE ==
                   PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
@@ -150,5 +169,11 @@ pthread_mutex_trylock (pthread_mutex_t * mutex)
         }
     }
 
+  if (0 == result || EOWNERDEAD == result)
+    {
+      PTW32_LOCKWATCH_ACQUIRED (mx);
+      PTW32_MUTEX_PRIO_ACQUIRED (mx);
+    }
+
   return (result);
 }
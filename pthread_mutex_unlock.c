@@ -38,6 +38,26 @@
 #include "implement.h"
 
 
+#if defined(PTW32_COND_WAITONADDRESS)
+/*
+ * Deliver a wakeup deferred to this unlock by a thread that
+ * pthread_cond_broadcast() released (see pthread_cond_wait.c).
+ * Must be called by the owner, before the lock is released.
+ */
+static INLINE void
+ptw32_mutex_morph_wake (pthread_mutex_t mx)
+{
+  if (mx->morphCond != NULL)
+    {
+      pthread_cond_t cv = mx->morphCond;
+
+      mx->morphCond = NULL;
+      ptw32_wakebyaddresssingle ((PVOID) &cv->seq);
+    }
+}
+#endif
+
+
 int
 pthread_mutex_unlock (pthread_mutex_t * mutex)
 {
@@ -51,6 +71,11 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
 
   mx = *mutex;
 
+  if (PTW32_IS_PSHARED (mx))
+    {
+      return ptw32_pshared_mutex_unlock (mx);
+    }
+
   /*
    * If the thread calling us holds the mutex then there is no
    * race condition. If another thread holds the
@@ -62,11 +87,37 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
 
       if (kind >= 0)
         {
+          if (kind == PTHREAD_MUTEX_ELIDE_NP)
+            {
+              if (ptw32_mutex_elide_unlock (mx))
+                {
+                  return 0;
+                }
+              kind = PTHREAD_MUTEX_NORMAL;
+            }
+
           if (kind == PTHREAD_MUTEX_NORMAL)
 	    {
 	      LONG idx;
 
-	      idx = (LONG) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR)&mx->lock_idx,
+	      PTW32_LOCKSTAT_MUTEX_RELEASE (mx);
+	      PTW32_LOCKWATCH_RELEASE (mx);
+#if defined(PTW32_COND_WAITONADDRESS)
+	      ptw32_mutex_morph_wake (mx);
+#endif
+	      PTW32_MUTEX_PRIO_RELEASE (mx);
+
+	      if (mx->fair != NULL)
+	        {
+	          return ptw32_mutex_fair_release (mx);
+	        }
+
+	      if (mx->cohort != NULL)
+	        {
+	          return ptw32_mutex_cohort_release (mx);
+	        }
+
+	      idx = (LONG) PTW32_ATOMIC_EXCHANGE_REL_LONG ((PTW32_INTERLOCKED_LONGPTR)&mx->lock_idx,
 							    (PTW32_INTERLOCKED_LONG)0);
 	      if (idx != 0)
 	        {
@@ -75,7 +126,7 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
 		      /*
 		       * Someone may be waiting on that mutex.
 		       */
-		      if (SetEvent (mx->event) == 0)
+		      if (ptw32_mutex_wake (mx) != 0)
 		        {
 		          result = EINVAL;
 		        }
@@ -90,12 +141,26 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
 		      || 0 == --mx->recursive_count)
 		    {
 		      mx->ownerThread.p = NULL;
+		      PTW32_LOCKSTAT_MUTEX_RELEASE (mx);
+		      PTW32_LOCKWATCH_RELEASE (mx);
+#if defined(PTW32_COND_WAITONADDRESS)
+		      ptw32_mutex_morph_wake (mx);
+#endif
+		      PTW32_MUTEX_PRIO_RELEASE (mx);
 
-		      if ((LONG) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR)&mx->lock_idx,
+		      if (mx->fair != NULL)
+		        {
+		          result = ptw32_mutex_fair_release (mx);
+		        }
+		      else if (mx->cohort != NULL)
+		        {
+		          result = ptw32_mutex_cohort_release (mx);
+		        }
+		      else if ((LONG) PTW32_ATOMIC_EXCHANGE_REL_LONG ((PTW32_INTERLOCKED_LONGPTR)&mx->lock_idx,
 							          (PTW32_INTERLOCKED_LONG)0) < 0L)
 		        {
 		          /* Someone may be waiting on that mutex */
-		          if (SetEvent (mx->event) == 0)
+		          if (ptw32_mutex_wake (mx) != 0)
 			    {
 			      result = EINVAL;
 			    }
@@ -120,11 +185,13 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
            */
           if (pthread_equal (mx->ownerThread, self))
             {
-              PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) &mx->robustNode->stateInconsistent,
+              PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) &mx->robustNode.stateInconsistent,
                                                       (PTW32_INTERLOCKED_LONG)PTW32_ROBUST_NOTRECOVERABLE,
                                                       (PTW32_INTERLOCKED_LONG)PTW32_ROBUST_INCONSISTENT);
               if (PTHREAD_MUTEX_NORMAL == kind)
                 {
+                  PTW32_LOCKSTAT_MUTEX_RELEASE (mx);
+                  PTW32_LOCKWATCH_RELEASE (mx);
                   ptw32_robust_mutex_remove(mutex, NULL);
 
                   if ((LONG) PTW32_INTERLOCKED_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
@@ -133,7 +200,7 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
                       /*
                        * Someone may be waiting on that mutex.
                        */
-                      if (SetEvent (mx->event) == 0)
+                      if (ptw32_mutex_wake (mx) != 0)
                         {
                           result = EINVAL;
                         }
@@ -144,6 +211,8 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
                   if (kind != PTHREAD_MUTEX_RECURSIVE
                       || 0 == --mx->recursive_count)
                     {
+                      PTW32_LOCKSTAT_MUTEX_RELEASE (mx);
+                      PTW32_LOCKWATCH_RELEASE (mx);
                       ptw32_robust_mutex_remove(mutex, NULL);
 
                       if ((LONG) PTW32_INTERLOCKED_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
@@ -152,7 +221,7 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
                           /*
                            * Someone may be waiting on that mutex.
                            */
-                          if (SetEvent (mx->event) == 0)
+                          if (ptw32_mutex_wake (mx) != 0)
                             {
                               result = EINVAL;
                             }
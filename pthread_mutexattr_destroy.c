@@ -76,7 +76,10 @@ pthread_mutexattr_destroy (pthread_mutexattr_t * attr)
       pthread_mutexattr_t ma = *attr;
 
       *attr = NULL;
-      free (ma);
+      if (!PTW32_ATTR_IS_INITIALIZER (ma))
+	{
+	  ptw32_object_free (ma);
+	}
     }
 
   return (result);
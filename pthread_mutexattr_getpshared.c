@@ -82,7 +82,7 @@ pthread_mutexattr_getpshared (const pthread_mutexattr_t * attr, int *pshared)
 
   if ((attr != NULL && *attr != NULL) && (pshared != NULL))
     {
-      *pshared = (*attr)->pshared;
+      *pshared = PTW32_ATTR_READ (*attr, ptw32_mutexattr_default)->pshared;
       result = 0;
     }
   else
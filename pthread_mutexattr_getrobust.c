@@ -105,7 +105,7 @@ pthread_mutexattr_getrobust (const pthread_mutexattr_t * attr, int * robust)
 
   if ((attr != NULL && *attr != NULL && robust != NULL))
     {
-      *robust = (*attr)->robustness;
+      *robust = PTW32_ATTR_READ (*attr, ptw32_mutexattr_default)->robustness;
       result = 0;
     }
 
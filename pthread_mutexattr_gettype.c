@@ -45,7 +45,7 @@ pthread_mutexattr_gettype (const pthread_mutexattr_t * attr, int *kind)
 
   if (attr != NULL && *attr != NULL && kind != NULL)
     {
-      *kind = (*attr)->kind;
+      *kind = PTW32_ATTR_READ (*attr, ptw32_mutexattr_default)->kind;
     }
   else
     {
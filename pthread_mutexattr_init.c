@@ -68,7 +68,7 @@ pthread_mutexattr_init (pthread_mutexattr_t * attr)
   int result = 0;
   pthread_mutexattr_t ma;
 
-  ma = (pthread_mutexattr_t) calloc (1, sizeof (*ma));
+  ma = (pthread_mutexattr_t) ptw32_object_alloc (sizeof (*ma), 0);
 
   if (ma == NULL)
     {
@@ -79,6 +79,10 @@ pthread_mutexattr_init (pthread_mutexattr_t * attr)
       ma->pshared = PTHREAD_PROCESS_PRIVATE;
       ma->kind = PTHREAD_MUTEX_DEFAULT;
       ma->robustness = PTHREAD_MUTEX_STALLED;
+      ma->spin = PTHREAD_MUTEX_SPIN_DEFAULT;
+      ma->fairness = PTHREAD_MUTEX_BARGING_NP;
+      ma->protocol = PTHREAD_PRIO_NONE;
+      ma->prioceiling = PTW32_PRIO_CEILING_DEFAULT;
     }
 
   *attr = ma;
@@ -0,0 +1,142 @@
+/*
+ * pthread_mutexattr_setfairness_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_mutexattr_setfairness_np (pthread_mutexattr_t * attr, int fairness)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets how mutexes initialised with 'attr' choose the
+      *      next owner when they are contended.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_mutexattr_t
+      *
+      *      fairness
+      *              one of:
+      *
+      *              PTHREAD_MUTEX_BARGING_NP
+      *                      the unlocked mutex goes to whichever
+      *                      thread takes it first, which may be a
+      *                      thread that wasn't waiting at all,
+      *
+      *              PTHREAD_MUTEX_FAIR_NP
+      *                      unlock hands the mutex directly to the
+      *                      thread that has waited longest,
+      *
+      *              PTHREAD_MUTEX_EVENTUALLY_FAIR_NP
+      *                      as PTHREAD_MUTEX_BARGING_NP until the
+      *                      longest waiter has waited more than
+      *                      about a millisecond, then as
+      *                      PTHREAD_MUTEX_FAIR_NP for that waiter,
+      *
+      *              PTHREAD_MUTEX_NUMA_COHORT_NP
+      *                      waiters queue by NUMA node, and unlock
+      *                      hands the mutex to the next waiter on
+      *                      the owner's node, up to a bounded
+      *                      number of times in a row, before the
+      *                      waiters of another node get it,
+      *
+      *              PTHREAD_MUTEX_PRIORITY_NP
+      *                      unlock hands the mutex directly to the
+      *                      waiter with the highest priority, and of
+      *                      those to the one that has waited longest.
+      *
+      * DESCRIPTION
+      *      Barging gives the best throughput, since a running
+      *      thread that relocks the mutex doesn't have to wait
+      *      for a woken one to be scheduled, but a thread that
+      *      keeps relocking can starve the waiters. A fair mutex
+      *      queues its waiters in arrival order and bounds how
+      *      long each one waits, at the cost of a context switch
+      *      for every contended handoff. An eventually fair mutex
+      *      only pays that cost for waiters that are starving.
+      *      A cohort mutex keeps the mutex, and the data it
+      *      guards, on one node of a NUMA system for a while
+      *      instead of moving it between nodes at every handoff.
+      *      A priority mutex serves latency critical threads
+      *      first; a waiter's priority is its sched_priority, or
+      *      the boost lent to it by the priority protocol mutexes
+      *      it holds if that is higher, when it queues. It
+      *      complements PTHREAD_PRIO_INHERIT, which raises the
+      *      owner, by choosing the next owner.
+      *      Only pthread_mutex_lock() queues on a cohort mutex;
+      *      pthread_mutex_timedlock() and pthread_mutex_trylock()
+      *      take it when it is free, as they would a barging one.
+      *
+      *      Fairness applies to all mutex types. A waiter that
+      *      spins (see pthread_mutexattr_setspin_np()) may still
+      *      take a free mutex before queueing, and
+      *      pthread_mutex_trylock() only ever succeeds on a mutex
+      *      that no thread is about to be handed. Robust and
+      *      process shared mutexes can't be fair. On systems
+      *      without WaitOnAddress (before Windows 8) all mutexes
+      *      are barging.
+      *
+      *      The default value of the attribute is
+      *      PTHREAD_MUTEX_BARGING_NP.
+      *
+      * RESULTS
+      *              0               successfully set attribute,
+      *              EINVAL          'attr' or 'fairness' is invalid,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_mutexattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
+  if (attr == NULL || *attr == NULL
+      || (fairness != PTHREAD_MUTEX_BARGING_NP
+          && fairness != PTHREAD_MUTEX_FAIR_NP
+          && fairness != PTHREAD_MUTEX_EVENTUALLY_FAIR_NP
+          && fairness != PTHREAD_MUTEX_NUMA_COHORT_NP
+          && fairness != PTHREAD_MUTEX_PRIORITY_NP))
+    {
+      return EINVAL;
+    }
+
+  (*attr)->fairness = fairness;
+
+  return 0;
+}				/* pthread_mutexattr_setfairness_np */
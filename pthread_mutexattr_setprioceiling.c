@@ -0,0 +1,89 @@
+/*
+ * pthread_mutexattr_setprioceiling.c
+ *
+ * Description:
+ * This translation unit implements mutual exclusion (mutex) primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_mutexattr_setprioceiling (pthread_mutexattr_t * attr, int prioceiling)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets the priority ceiling of PTHREAD_PRIO_PROTECT
+      *      mutexes initialised with 'attr'.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_mutexattr_t
+      *
+      *      prioceiling
+      *              a priority of any scheduling policy, from
+      *              sched_get_priority_min() for SCHED_OTHER to
+      *              sched_get_priority_max() for SCHED_FIFO
+      *
+      * DESCRIPTION
+      *      The owner of a PTHREAD_PRIO_PROTECT mutex runs at no
+      *      less than the ceiling, which should be the highest
+      *      priority of the threads that lock the mutex; locking
+      *      the mutex from a thread of higher priority fails with
+      *      EINVAL. The ceiling has no effect on mutexes with
+      *      other protocols. The default ceiling is the highest
+      *      thread priority.
+      *
+      * RESULTS
+      *              0               successfully set attribute,
+      *              EINVAL          'attr' or 'prioceiling' is invalid,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_mutexattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
+  if (attr == NULL || *attr == NULL
+      || prioceiling < sched_get_priority_min (SCHED_OTHER)
+      || prioceiling > sched_get_priority_max (SCHED_FIFO))
+    {
+      return EINVAL;
+    }
+
+  (*attr)->prioceiling = prioceiling;
+
+  return 0;
+}				/* pthread_mutexattr_setprioceiling */
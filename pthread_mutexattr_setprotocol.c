@@ -0,0 +1,105 @@
+/*
+ * pthread_mutexattr_setprotocol.c
+ *
+ * Description:
+ * This translation unit implements mutual exclusion (mutex) primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_mutexattr_setprotocol (pthread_mutexattr_t * attr, int protocol)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets the priority protocol of mutexes initialised
+      *      with 'attr'.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_mutexattr_t
+      *
+      *      protocol
+      *              one of:
+      *
+      *              PTHREAD_PRIO_NONE
+      *                      owning the mutex doesn't change the
+      *                      owner's priority,
+      *
+      *              PTHREAD_PRIO_INHERIT
+      *                      while threads are blocked on the mutex
+      *                      the owner runs at no less than the
+      *                      highest of their priorities,
+      *
+      *              PTHREAD_PRIO_PROTECT
+      *                      the owner runs at no less than the
+      *                      mutex's priority ceiling (see
+      *                      pthread_mutexattr_setprioceiling()).
+      *
+      * DESCRIPTION
+      *      Either protocol stops a low priority thread that holds
+      *      a mutex from being kept off the CPU by medium priority
+      *      threads while a high priority thread waits for the
+      *      mutex (priority inversion). The owner's priority is
+      *      restored when it unlocks the mutex; the priority that
+      *      pthread_getschedparam() reports never changes.
+      *
+      *      The protocol applies to all mutex types. Robust and
+      *      process shared mutexes can't have one. The default
+      *      value of the attribute is PTHREAD_PRIO_NONE.
+      *
+      * RESULTS
+      *              0               successfully set attribute,
+      *              EINVAL          'attr' or 'protocol' is invalid,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_mutexattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
+  if (attr == NULL || *attr == NULL
+      || (protocol != PTHREAD_PRIO_NONE
+          && protocol != PTHREAD_PRIO_INHERIT
+          && protocol != PTHREAD_PRIO_PROTECT))
+    {
+      return EINVAL;
+    }
+
+  (*attr)->protocol = protocol;
+
+  return 0;
+}				/* pthread_mutexattr_setprotocol */
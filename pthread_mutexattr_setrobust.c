@@ -103,6 +103,11 @@ pthread_mutexattr_setrobust (pthread_mutexattr_t * attr, int robust)
 {
   int result = EINVAL;
 
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_mutexattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
   if ((attr != NULL && *attr != NULL))
     {
       switch (robust)
@@ -0,0 +1,99 @@
+/*
+ * pthread_mutexattr_setspin_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_mutexattr_setspin_np (pthread_mutexattr_t * attr, int spin)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets the spin budget of mutexes initialised with
+      *      'attr'.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_mutexattr_t
+      *
+      *      spin
+      *              maximum number of times a contended
+      *              pthread_mutex_lock() or pthread_mutex_timedlock()
+      *              polls the mutex before blocking, or one of:
+      *
+      *              0
+      *                      never spin (block immediately),
+      *
+      *              PTHREAD_MUTEX_SPIN_DEFAULT
+      *                      use the process default set by
+      *                      pthread_mutex_setdefaultspin_np().
+      *
+      * DESCRIPTION
+      *      Adaptive mutexes spin for a short while before
+      *      falling back to waiting in the kernel, which avoids
+      *      a kernel transition when the mutex is only held for
+      *      short periods. The number of spins actually made is
+      *      tuned per mutex from recent history and never exceeds
+      *      'spin'. The attribute applies to all mutex types and
+      *      to robust mutexes. It has no effect on single
+      *      processor systems.
+      *
+      *      The default value of the attribute is
+      *      PTHREAD_MUTEX_SPIN_DEFAULT.
+      *
+      * RESULTS
+      *              0               successfully set attribute,
+      *              EINVAL          'attr' or 'spin' is invalid,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_mutexattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
+  if (attr == NULL || *attr == NULL
+      || (spin < 0 && spin != PTHREAD_MUTEX_SPIN_DEFAULT))
+    {
+      return EINVAL;
+    }
+
+  (*attr)->spin = spin;
+
+  return 0;
+}				/* pthread_mutexattr_setspin_np */
@@ -64,6 +64,8 @@ pthread_mutexattr_settype (pthread_mutexattr_t * attr, int kind)
       *
       *                      PTHREAD_MUTEX_RECURSIVE
       *
+      *                      PTHREAD_MUTEX_ELIDE_NP
+      *
       * DESCRIPTION
       * The pthread_mutexattr_settype() and
       * pthread_mutexattr_gettype() functions  respectively set and
@@ -111,6 +113,16 @@ pthread_mutexattr_settype (pthread_mutexattr_t * attr, int kind)
       *          process        shared         attribute         is
       *          PTHREAD_PROCESS_PRIVATE.
       *
+      * PTHREAD_MUTEX_ELIDE_NP
+      *          (Non-portable) A PTHREAD_MUTEX_NORMAL mutex whose
+      *          critical sections first run as hardware (RTM)
+      *          transactions without taking the lock, so that
+      *          sections that don't conflict run concurrently.
+      *          Elision backs off on a mutex whose transactions
+      *          abort. Without RTM, or if the mutex is also
+      *          robust, fair or has a priority protocol, it is
+      *          simply a normal mutex.
+      *
       * RESULTS
       *              0               successfully set attribute,
       *              EINVAL          'attr' or 'type' is invalid,
@@ -120,6 +132,11 @@ pthread_mutexattr_settype (pthread_mutexattr_t * attr, int kind)
 {
   int result = 0;
 
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_mutexattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
   if ((attr != NULL && *attr != NULL))
     {
       switch (kind)
@@ -127,6 +144,7 @@ pthread_mutexattr_settype (pthread_mutexattr_t * attr, int kind)
 	case PTHREAD_MUTEX_FAST_NP:
 	case PTHREAD_MUTEX_RECURSIVE_NP:
 	case PTHREAD_MUTEX_ERRORCHECK_NP:
+	case PTHREAD_MUTEX_ELIDE_NP:
 	  (*attr)->kind = kind;
 	  break;
 	default:
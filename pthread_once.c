@@ -44,10 +44,18 @@ pthread_once (pthread_once_t * once_control, void (PTW32_CDECL *init_routine) (v
     {
       return EINVAL;
     }
-  
+
+  /*
+   * done is only ever set, after init_routine has returned, so once it
+   * is seen set with acquire semantics there is nothing more to do.
+   */
+#if defined(PTW32_ONCE_IS_DONE)
+  if (!PTW32_ONCE_IS_DONE(once_control))
+#else
   if ((PTW32_INTERLOCKED_LONG)PTW32_FALSE ==
       (PTW32_INTERLOCKED_LONG)PTW32_INTERLOCKED_EXCHANGE_ADD_LONG((PTW32_INTERLOCKED_LONGPTR)&once_control->done,
                                                                   (PTW32_INTERLOCKED_LONG)0)) /* MBR fence */
+#endif
     {
       ptw32_mcs_local_node_t node;
 
@@ -68,7 +76,9 @@ pthread_once (pthread_once_t * once_control, void (PTW32_CDECL *init_routine) (v
 #pragma inline_depth()
 #endif
 
-	  once_control->done = PTW32_TRUE;
+	  /* Release: publish init_routine's effects before done */
+	  (void) PTW32_INTERLOCKED_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR)&once_control->done,
+						 (PTW32_INTERLOCKED_LONG)PTW32_TRUE);
 	}
 
       ptw32_mcs_lock_release(&node);
@@ -0,0 +1,66 @@
+/*
+ * pthread_once_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+/* pthread.h may define a macro of the same name */
+#undef pthread_once_np
+
+int
+pthread_once_np (pthread_once_t * once_control, void (PTW32_CDECL *init_routine) (void))
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      As pthread_once().
+      *
+      * DESCRIPTION
+      *      The function form of the pthread_once_np() macro in
+      *      pthread.h, for callers that can't use the macro. The
+      *      macro tests the done flag of 'once_control' inline and
+      *      only calls pthread_once() while the init routine has
+      *      not completed.
+      *
+      * RESULTS
+      *              0               success,
+      *              EINVAL          'once_control' or 'init_routine'
+      *                              is NULL.
+      *
+      * ------------------------------------------------------
+      */
+{
+  return pthread_once (once_control, init_routine);
+}				/* pthread_once_np */
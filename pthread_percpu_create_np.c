@@ -0,0 +1,126 @@
+/*
+ * pthread_percpu_create_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_percpu_create_np (pthread_percpu_np_t * percpu, size_t size)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Creates a zeroed slot of 'size' bytes for each
+      *      logical processor.
+      *
+      * PARAMETERS
+      *      percpu
+      *              pointer to an instance of pthread_percpu_np_t
+      *
+      *      size
+      *              bytes in each slot, at least 1
+      *
+      * DESCRIPTION
+      *      There is a slot for every processor in every
+      *      processor group, counted as ptw32_getprocessors()
+      *      does, or for every processor of the process' group
+      *      if that is more. Each slot is rounded up to whole
+      *      cache lines so that processors updating their own
+      *      slots don't false-share, and all of them are one
+      *      allocation. Threads running on the same processor
+      *      share its slot, so the memory used doesn't grow with
+      *      the number of threads.
+      *
+      * RESULTS
+      *              0               successfully created the slots,
+      *              EINVAL          'percpu' or 'size' is invalid,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_percpu_np_t p;
+  int count = 0;
+  int base = 0;
+
+  if (percpu == NULL || size == 0)
+    {
+      return EINVAL;
+    }
+
+  if (0 != ptw32_getprocessors (&count) || count <= 0)
+    {
+      count = 1;
+    }
+
+  p = (pthread_percpu_np_t) ptw32_object_alloc (sizeof (*p), 0);
+
+  if (p == NULL)
+    {
+      return ENOMEM;
+    }
+
+  if (ptw32_getactiveprocessorgroupcount != NULL)
+    {
+      WORD groups = ptw32_getactiveprocessorgroupcount ();
+      WORD g;
+
+      for (g = 0; g < groups && g < PTW32_CPU_SET_GROUPS; g++)
+	{
+	  p->groupBase[g] = base;
+	  base += (int) ptw32_getactiveprocessorcount (g);
+	}
+
+      if (base > count)
+	{
+	  count = base;
+	}
+    }
+
+  p->nSlots = count;
+  p->stride = ptw32_object_stride (size, PTW32_CACHE_LINE_SIZE);
+  p->slots = (char *) ptw32_object_alloc ((size_t) count * p->stride, PTW32_CACHE_LINE_SIZE);
+
+  if (p->slots == NULL)
+    {
+      ptw32_object_free (p);
+      return ENOMEM;
+    }
+
+  *percpu = p;
+
+  return 0;
+}				/* pthread_percpu_create_np */
@@ -0,0 +1,150 @@
+/*
+ * pthread_percpu_slot_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_percpu_this_np (pthread_percpu_np_t percpu, void ** slot)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the slot of the processor the calling thread
+      *      is running on.
+      *
+      * PARAMETERS
+      *      percpu
+      *              an instance of pthread_percpu_np_t
+      *
+      *      slot
+      *              where to return the slot
+      *
+      * DESCRIPTION
+      *      The thread may move to another processor at any time,
+      *      including straight after this returns, and other
+      *      threads then use the slot, so updates to it must be
+      *      interlocked. They rarely contend, and the slot's cache
+      *      lines normally stay with its processor. Before
+      *      Windows 7, which can't tell the processor in user
+      *      mode, every thread gets slot 0.
+      *
+      * RESULTS
+      *              0               returned the slot,
+      *              EINVAL          an argument is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_processor_number_t pn;
+  int i = 0;
+
+  if (percpu == NULL || slot == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (ptw32_getcurrentprocessornumberex != NULL)
+    {
+      ptw32_getcurrentprocessornumberex (&pn);
+      i = (int) pn.Number;
+      if (pn.Group < PTW32_CPU_SET_GROUPS)
+	{
+	  i += percpu->groupBase[pn.Group];
+	}
+    }
+
+  *slot = percpu->slots + (size_t) (i % percpu->nSlots) * percpu->stride;
+
+  return 0;
+}				/* pthread_percpu_this_np */
+
+
+int
+pthread_percpu_slot_np (pthread_percpu_np_t percpu, int index, void ** slot)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns a slot by index, to sum counters or drain
+      *      caches over all processors.
+      *
+      * PARAMETERS
+      *      percpu
+      *              an instance of pthread_percpu_np_t
+      *
+      *      index
+      *              from 0 to pthread_percpu_count_np() - 1
+      *
+      *      slot
+      *              where to return the slot
+      *
+      * RESULTS
+      *              0               returned the slot,
+      *              EINVAL          an argument is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (percpu == NULL || slot == NULL || index < 0 || index >= percpu->nSlots)
+    {
+      return EINVAL;
+    }
+
+  *slot = percpu->slots + (size_t) index * percpu->stride;
+
+  return 0;
+}				/* pthread_percpu_slot_np */
+
+
+int
+pthread_percpu_count_np (pthread_percpu_np_t percpu)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the number of slots.
+      *
+      * PARAMETERS
+      *      percpu
+      *              an instance of pthread_percpu_np_t
+      *
+      * RESULTS
+      *              the number of slots, or 0 if 'percpu' is NULL.
+      *
+      * ------------------------------------------------------
+      */
+{
+  return (percpu != NULL) ? percpu->nSlots : 0;
+}				/* pthread_percpu_count_np */
@@ -0,0 +1,397 @@
+/*
+ * pthread_phaser_arrive_np.c
+ *
+ * Description:
+ * This translation unit implements phaser primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * The phase and the parties' counts are kept together in one 64 bit
+ * word, so that an arrival is the single compare-exchange the leaves
+ * of a combining tree barrier use, and a registration can't slip in
+ * between an arrival and the advance it causes. The arrival that
+ * brings the unarrived count to zero also starts the next phase,
+ * with every party unarrived again.
+ *
+ * The word is read without an interlocked operation, which on 32 bit
+ * x86 may see it torn; only a compare-exchange acts on what was read,
+ * and that then fails and returns the real value.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+static void
+ptw32_phaser_advance (pthread_phaser_np_t ph, ULONG phase)
+{
+  int yields = 0;
+
+  /*
+   * Publish the new phase to waiters. The previous advance may still
+   * be between its own compare-exchange and this, if the phase was
+   * short; phase only ever moves forwards.
+   */
+  while ((LONG) phase != (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG (
+				  (PTW32_INTERLOCKED_LONGPTR) &ph->phase,
+				  (PTW32_INTERLOCKED_LONG) (phase + 1),
+				  (PTW32_INTERLOCKED_LONG) phase))
+    {
+      ptw32_yield (&yields);
+    }
+
+  /*
+   * Waiters for the next phase may be parked on this one, having
+   * arrived before it was published here.
+   */
+  if (ptw32_wakebyaddressall != NULL
+      && (0 != PTW32_ATOMIC_LOAD_RELAXED_LONG (&ph->nWaiting[0])
+	  || 0 != PTW32_ATOMIC_LOAD_RELAXED_LONG (&ph->nWaiting[1])))
+    {
+      ptw32_wakebyaddressall ((PVOID) &ph->phase);
+    }
+}
+
+static int
+ptw32_phaser_arrive (pthread_phaser_np_t ph, int deregister, unsigned int * phase)
+{
+  LONG64 s = ph->state;
+  LONG64 old;
+  ULONG p;
+  unsigned int parties;
+  unsigned int unarrived;
+
+  for (;;)
+    {
+      LONG64 next;
+
+      p = PTW32_PHASER_PHASE (s);
+      parties = PTW32_PHASER_PARTIES (s);
+      unarrived = PTW32_PHASER_UNARRIVED (s);
+
+      if (unarrived == 0)
+	{
+	  /* More arrivals than registered parties */
+	  return EINVAL;
+	}
+
+      parties -= (deregister != 0);
+
+      if (--unarrived == 0)
+	{
+	  next = PTW32_PHASER_STATE (p + 1, parties, parties);
+	}
+      else
+	{
+	  next = PTW32_PHASER_STATE (p, parties, unarrived);
+	}
+
+      old = (LONG64) PTW32_INTERLOCKED_COMPARE_EXCHANGE_64 (&ph->state, next, s);
+
+      if (old == s)
+	{
+	  break;
+	}
+
+      s = old;
+    }
+
+  if (phase != NULL)
+    {
+      *phase = (unsigned int) p;
+    }
+
+  if (unarrived == 0)
+    {
+      ptw32_phaser_advance (ph, p);
+      return PTHREAD_BARRIER_SERIAL_THREAD;
+    }
+
+  return 0;
+}
+
+
+int
+pthread_phaser_register_np (pthread_phaser_np_t phaser, unsigned int n,
+			    unsigned int * phase)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Registers 'n' more parties with the phaser.
+      *
+      * PARAMETERS
+      *      phaser
+      *              an instance of pthread_phaser_np_t
+      *
+      *      n
+      *              the number of parties to add, at least 1
+      *
+      *      phase
+      *              NULL, or where the phase the new parties first
+      *              arrive at is returned
+      *
+      * DESCRIPTION
+      *      The new parties take part in the current phase, which
+      *      then needs their arrivals too before it advances.
+      *
+      * RESULTS
+      *              0               successfully registered,
+      *              EINVAL          'phaser' or 'n' is invalid,
+      *              EAGAIN          the phaser would have more than
+      *                              PTHREAD_PHASER_MAX_PARTIES_NP
+      *                              parties.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG64 s;
+  LONG64 old;
+
+  if (phaser == NULL || n == 0)
+    {
+      return EINVAL;
+    }
+
+  s = phaser->state;
+
+  for (;;)
+    {
+      unsigned int parties = PTW32_PHASER_PARTIES (s);
+
+      if (n > PTHREAD_PHASER_MAX_PARTIES_NP - parties)
+	{
+	  return EAGAIN;
+	}
+
+      old = (LONG64) PTW32_INTERLOCKED_COMPARE_EXCHANGE_64 (
+		       &phaser->state,
+		       PTW32_PHASER_STATE (PTW32_PHASER_PHASE (s), parties + n,
+					   PTW32_PHASER_UNARRIVED (s) + n),
+		       s);
+
+      if (old == s)
+	{
+	  break;
+	}
+
+      s = old;
+    }
+
+  if (phase != NULL)
+    {
+      *phase = (unsigned int) PTW32_PHASER_PHASE (s);
+    }
+
+  return 0;
+}				/* pthread_phaser_register_np */
+
+
+int
+pthread_phaser_arrive_np (pthread_phaser_np_t phaser, unsigned int * phase)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Arrives at the current phase without waiting for it
+      *      to advance.
+      *
+      * PARAMETERS
+      *      phaser
+      *              an instance of pthread_phaser_np_t
+      *
+      *      phase
+      *              NULL, or where the phase arrived at is returned,
+      *              for pthread_phaser_await_np()
+      *
+      * RESULTS
+      *              PTHREAD_BARRIER_SERIAL_THREAD
+      *                              the arrival advanced the phase,
+      *              0               otherwise,
+      *              EINVAL          'phaser' is invalid, or every
+      *                              registered party has arrived.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (phaser == NULL)
+    {
+      return EINVAL;
+    }
+
+  return ptw32_phaser_arrive (phaser, PTW32_FALSE, phase);
+}				/* pthread_phaser_arrive_np */
+
+
+int
+pthread_phaser_arrive_and_deregister_np (pthread_phaser_np_t phaser,
+					 unsigned int * phase)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Arrives at the current phase and deregisters the
+      *      caller's party, so later phases don't wait for it.
+      *
+      * PARAMETERS
+      *      phaser
+      *              an instance of pthread_phaser_np_t
+      *
+      *      phase
+      *              NULL, or where the phase arrived at is returned
+      *
+      * RESULTS
+      *              PTHREAD_BARRIER_SERIAL_THREAD
+      *                              the arrival advanced the phase,
+      *              0               otherwise,
+      *              EINVAL          'phaser' is invalid, or every
+      *                              registered party has arrived.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (phaser == NULL)
+    {
+      return EINVAL;
+    }
+
+  return ptw32_phaser_arrive (phaser, PTW32_TRUE, phase);
+}				/* pthread_phaser_arrive_and_deregister_np */
+
+
+int
+pthread_phaser_await_np (pthread_phaser_np_t phaser, unsigned int phase)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits for the phaser to advance past 'phase'.
+      *
+      * PARAMETERS
+      *      phaser
+      *              an instance of pthread_phaser_np_t
+      *
+      *      phase
+      *              the phase returned by an arrival
+      *
+      * DESCRIPTION
+      *      Returns at once if the phaser is already past
+      *      'phase'. Otherwise polls for a while on a
+      *      multiprocessor and then parks, as waiters at a
+      *      combining tree barrier do. Not a cancellation point,
+      *      like pthread_barrier_wait().
+      *
+      * RESULTS
+      *              0               the phase has advanced,
+      *              EINVAL          'phaser' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  volatile LONG * nWaiting;
+  LONG seen;
+
+  if (phaser == NULL)
+    {
+      return EINVAL;
+    }
+
+  seen = PTW32_ATOMIC_LOAD_ACQ_LONG (&phaser->phase);
+
+  if ((LONG) ((ULONG) seen - (ULONG) phase) > 0)
+    {
+      return 0;
+    }
+
+  /* Counted before looking again, so that the advancer sees us */
+  nWaiting = &phaser->nWaiting[phase & 1];
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) nWaiting);
+
+  /*
+   * Until the previous advance has been published here, the phase
+   * seen can be the one before ours.
+   */
+  while ((LONG) ((ULONG) (seen = PTW32_ATOMIC_LOAD_ACQ_LONG (&phaser->phase))
+		 - (ULONG) phase) <= 0)
+    {
+      ptw32_barrier_park (&phaser->phase, seen, NULL);
+    }
+
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) nWaiting);
+
+  return 0;
+}				/* pthread_phaser_await_np */
+
+
+int
+pthread_phaser_arrive_and_await_np (pthread_phaser_np_t phaser, unsigned int * phase)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Arrives at the current phase and waits for it to
+      *      advance, as at a barrier.
+      *
+      * PARAMETERS
+      *      phaser
+      *              an instance of pthread_phaser_np_t
+      *
+      *      phase
+      *              NULL, or where the phase arrived at is returned
+      *
+      * RESULTS
+      *              PTHREAD_BARRIER_SERIAL_THREAD
+      *                              for the last party to arrive,
+      *              0               for the others,
+      *              EINVAL          'phaser' is invalid, or every
+      *                              registered party has arrived.
+      *
+      * ------------------------------------------------------
+      */
+{
+  unsigned int p;
+  int result;
+
+  if (phaser == NULL)
+    {
+      return EINVAL;
+    }
+
+  result = ptw32_phaser_arrive (phaser, PTW32_FALSE, &p);
+
+  if (0 == result)
+    {
+      result = pthread_phaser_await_np (phaser, p);
+    }
+
+  if (phase != NULL && EINVAL != result)
+    {
+      *phase = p;
+    }
+
+  return result;
+}				/* pthread_phaser_arrive_and_await_np */
@@ -0,0 +1,91 @@
+/*
+ * pthread_phaser_destroy_np.c
+ *
+ * Description:
+ * This translation unit implements phaser primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_phaser_destroy_np (pthread_phaser_np_t * phaser)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Destroys a phaser.
+      *
+      * PARAMETERS
+      *      phaser
+      *              pointer to an instance of pthread_phaser_np_t
+      *
+      * DESCRIPTION
+      *      Threads released from the previous phase that haven't
+      *      yet returned are waited for, so the thread that
+      *      advanced the phase may destroy the phaser.
+      *
+      * RESULTS
+      *              0               successfully destroyed phaser,
+      *              EINVAL          'phaser' is invalid,
+      *              EBUSY           threads are waiting for the
+      *                              current phase to advance.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_phaser_np_t ph;
+  ULONG phase;
+  int yields = 0;
+
+  if (phaser == NULL || (ph = *phaser) == NULL)
+    {
+      return EINVAL;
+    }
+
+  phase = (ULONG) PTW32_ATOMIC_LOAD_ACQ_LONG (&ph->phase);
+
+  if (0 != PTW32_ATOMIC_LOAD_ACQ_LONG (&ph->nWaiting[phase & 1]))
+    {
+      return EBUSY;
+    }
+
+  while (0 != PTW32_ATOMIC_LOAD_ACQ_LONG (&ph->nWaiting[(phase + 1) & 1]))
+    {
+      ptw32_yield (&yields);
+    }
+
+  *phaser = NULL;
+  ptw32_object_free (ph);
+
+  return 0;
+}				/* pthread_phaser_destroy_np */
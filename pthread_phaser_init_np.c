@@ -0,0 +1,94 @@
+/*
+ * pthread_phaser_init_np.c
+ *
+ * Description:
+ * This translation unit implements phaser primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_phaser_init_np (pthread_phaser_np_t * phaser, unsigned int parties)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Creates a phaser with 'parties' registered parties,
+      *      at phase 0.
+      *
+      * PARAMETERS
+      *      phaser
+      *              pointer to an instance of pthread_phaser_np_t
+      *
+      *      parties
+      *              the number of parties registered to begin with,
+      *              up to PTHREAD_PHASER_MAX_PARTIES_NP; more may
+      *              register later
+      *
+      * DESCRIPTION
+      *      A phaser is a reusable barrier whose party count can
+      *      change: pthread_phaser_register_np() adds parties and
+      *      pthread_phaser_arrive_and_deregister_np() removes one.
+      *      The phase advances when every registered party has
+      *      arrived. Parties may arrive without waiting and wait
+      *      for the phase to advance separately.
+      *
+      * RESULTS
+      *              0               successfully created phaser,
+      *              EINVAL          'phaser' or 'parties' is invalid,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_phaser_np_t ph;
+
+  if (phaser == NULL || parties > PTHREAD_PHASER_MAX_PARTIES_NP)
+    {
+      return EINVAL;
+    }
+
+  ph = (pthread_phaser_np_t) ptw32_object_alloc (sizeof (*ph), 0);
+
+  if (ph == NULL)
+    {
+      return ENOMEM;
+    }
+
+  ph->state = PTW32_PHASER_STATE (0, parties, parties);
+  ph->phase = 0;
+
+  *phaser = ph;
+
+  return 0;
+}				/* pthread_phaser_init_np */
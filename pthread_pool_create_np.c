@@ -0,0 +1,185 @@
+/*
+ * pthread_pool_create_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_pool_create_np (pthread_pool_np_t * pool,
+                        const pthread_attr_t * attr,
+                        int nworkers)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Creates a pool of 'nworkers' worker threads that run
+      *      tasks submitted with pthread_pool_submit_np().
+      *
+      * PARAMETERS
+      *      pool
+      *              pointer to an instance of pthread_pool_np_t
+      *
+      *      attr
+      *              NULL, or pointer to the thread attributes the
+      *              workers are created with, e.g. a CPU affinity
+      *              set with pthread_attr_setaffinity_np(). The
+      *              detach state and thread name are ignored.
+      *
+      *      nworkers
+      *              number of worker threads, or 0 for the
+      *              concurrency level set with
+      *              pthread_setconcurrency(), which defaults to the
+      *              number of CPUs available to the process.
+      *
+      * DESCRIPTION
+      *      Workers are POSIX threads, so tasks may use thread
+      *      specific data, cleanup handlers and cancellation.
+      *      Each worker keeps its own deque of tasks and steals
+      *      from the others when it runs out; no order of
+      *      execution is guaranteed.
+      *
+      * RESULTS
+      *              0               successfully created pool,
+      *              EINVAL          'pool', 'attr' or 'nworkers' is
+      *                              invalid,
+      *              ENOMEM          insufficient memory,
+      *              EAGAIN          insufficient resources.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_pool_np_t p;
+  int result = 0;
+  int i;
+
+  if (pool == NULL || nworkers < 0
+      || (attr != NULL && ptw32_is_attr (attr) != 0))
+    {
+      return EINVAL;
+    }
+
+  if (0 == nworkers)
+    {
+      nworkers = ptw32_concurrency_level ();
+    }
+
+  p = (pthread_pool_np_t) calloc (1, sizeof (*p));
+
+  if (p == NULL)
+    {
+      return ENOMEM;
+    }
+
+  p->workers = (ptw32_pool_worker_t *) calloc (nworkers, sizeof (*p->workers));
+
+  if (p->workers == NULL)
+    {
+      free (p);
+      return ENOMEM;
+    }
+
+  p->nWorkers = nworkers;
+
+  for (i = 0; 0 == result && i < nworkers; i++)
+    {
+      ptw32_pool_worker_t * w = &p->workers[i];
+
+      w->pool = p;
+      result = ptw32_wsdeque_init (&w->deque);
+    }
+
+  if (0 == result)
+    {
+      result = pthread_key_create (&p->selfKey, NULL);
+    }
+
+  if (0 == result
+      && 0 == (result = pthread_attr_init (&p->attr))
+      && attr != NULL && !PTW32_ATTR_IS_INITIALIZER (*attr))
+    {
+      *p->attr = **attr;
+      p->attr->detachstate = PTHREAD_CREATE_JOINABLE;
+      p->attr->thrname = NULL;
+    }
+
+  if (0 == result
+      && (p->wake = ptw32_libstat_handle (CreateSemaphore (NULL, 0, SEM_VALUE_MAX, NULL),
+                                            PTW32_LIBSTAT_SEMAPHORES)) == NULL)
+    {
+      result = EAGAIN;
+    }
+
+  if (0 == result
+      && 0 == (result = pthread_mutex_init (&p->lock, NULL)))
+    {
+      result = pthread_cond_init (&p->changed, NULL);
+    }
+
+  if (0 != result)
+    {
+      ptw32_pool_free (p);
+      return result;
+    }
+
+  for (i = 0; i < nworkers; i++)
+    {
+      if (0 != (result = pthread_create (&p->workers[i].thread, &p->attr,
+                                         ptw32_pool_worker, &p->workers[i])))
+        {
+          break;
+        }
+    }
+
+  if (0 != result)
+    {
+      int j;
+
+      p->shutdown = PTW32_TRUE;
+      (void) PTW32_RELEASESEMAPHORE (p->wake, i, NULL);
+
+      for (j = 0; j < i; j++)
+        {
+          (void) pthread_join (p->workers[j].thread, NULL);
+        }
+
+      ptw32_pool_free (p);
+      return result;
+    }
+
+  *pool = p;
+
+  return 0;
+}				/* pthread_pool_create_np */
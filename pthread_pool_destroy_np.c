@@ -0,0 +1,112 @@
+/*
+ * pthread_pool_destroy_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_pool_destroy_np (pthread_pool_np_t * pool)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits for every task submitted to the pool to
+      *      complete, then stops and joins the workers and frees
+      *      the pool.
+      *
+      * PARAMETERS
+      *      pool
+      *              pointer to an instance of pthread_pool_np_t
+      *
+      * DESCRIPTION
+      *      Tasks may still submit more tasks while the pool is
+      *      being drained. Handles of tasks not yet passed to
+      *      pthread_pool_task_wait_np() stay valid.
+      *
+      * RESULTS
+      *              0               successfully destroyed pool,
+      *              EINVAL          'pool' is invalid,
+      *              EDEADLK         called from one of the pool's
+      *                              workers.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_pool_np_t p;
+  int result;
+  int i;
+
+  if (pool == NULL || *pool == NULL)
+    {
+      return EINVAL;
+    }
+
+  p = *pool;
+
+  if (0 != (result = pthread_pool_wait_np (p)))
+    {
+      return result;
+    }
+
+  /*
+   * From here on workers that are lost to their tasks aren't
+   * replaced, so w->thread no longer changes.
+   */
+  (void) pthread_mutex_lock (&p->lock);
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) &p->shutdown,
+                                        (PTW32_INTERLOCKED_LONG) PTW32_TRUE);
+  (void) pthread_mutex_unlock (&p->lock);
+
+  (void) PTW32_RELEASESEMAPHORE (p->wake, p->nWorkers, NULL);
+
+  for (i = 0; i < p->nWorkers; i++)
+    {
+      (void) pthread_join (p->workers[i].thread, NULL);
+    }
+
+  /* Spare workers are detached and retire on their own */
+  (void) pthread_mutex_lock (&p->lock);
+  while (p->nSpares > 0)
+    {
+      (void) pthread_cond_wait (&p->changed, &p->lock);
+    }
+  (void) pthread_mutex_unlock (&p->lock);
+
+  ptw32_pool_free (p);
+  *pool = NULL;
+
+  return 0;
+}				/* pthread_pool_destroy_np */
@@ -0,0 +1,116 @@
+/*
+ * pthread_pool_parallel_for_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_pool_parallel_for_np (pthread_pool_np_t pool, long begin, long end, long grain,
+                              void (PTW32_CDECL *routine) (long begin, long end, void * arg),
+                              void * arg)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Runs the iterations begin to end - 1 of a loop in
+      *      parallel on the pool's workers and the calling thread,
+      *      and returns when all have run.
+      *
+      * PARAMETERS
+      *      pool
+      *              the pool whose workers help
+      *
+      *      begin, end
+      *              the loop runs from begin up to, not including,
+      *              end
+      *
+      *      grain
+      *              iterations per call of 'routine', or 0 to let
+      *              the library choose
+      *
+      *      routine
+      *              called with each chunk's first index, the index
+      *              after its last, and 'arg'
+      *
+      *      arg
+      *              passed to 'routine'
+      *
+      * DESCRIPTION
+      *      The range is cut into chunks of 'grain' iterations
+      *      (the last may be shorter). The caller and up to one
+      *      helper task per worker each take the next chunk until
+      *      none are left, so uneven chunks balance out across the
+      *      participants. Chunks run in no particular order and
+      *      concurrently. The workers run with the pool's thread
+      *      attributes, its CPU affinity included.
+      *
+      *      It may be called from a task in the pool: the caller
+      *      runs other tasks while it waits for its helpers. If
+      *      the caller is cancelled in 'routine' the remaining
+      *      chunks are not run and the helpers are waited for.
+      *
+      * RESULTS
+      *              0               every iteration has run,
+      *              EINVAL          'pool' or 'routine' is NULL, or
+      *                              'grain' is negative,
+      *              EINTR           'routine' cancelled or exited a
+      *                              worker, so its chunk didn't finish.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pool_loop_t loop;
+
+  if (pool == NULL || routine == NULL || grain < 0)
+    {
+      return EINVAL;
+    }
+
+  if (begin >= end)
+    {
+      return 0;
+    }
+
+  loop.begin = begin;
+  loop.end = end;
+  loop.grain = grain;
+  loop.forRoutine = routine;
+  loop.reduceRoutine = NULL;
+  loop.identity = NULL;
+  loop.arg = arg;
+
+  return ptw32_pool_loop (pool, &loop, NULL, NULL);
+}
@@ -0,0 +1,119 @@
+/*
+ * pthread_pool_parallel_reduce_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_pool_parallel_reduce_np (pthread_pool_np_t pool, long begin, long end, long grain,
+                                 void * (PTW32_CDECL *routine) (long begin, long end,
+                                                                void * value, void * arg),
+                                 void * (PTW32_CDECL *combine) (void * a, void * b, void * arg),
+                                 void * identity, void * arg, void ** value_ptr)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      As pthread_pool_parallel_for_np(), but also reduces the
+      *      iterations to one value.
+      *
+      * PARAMETERS
+      *      pool, begin, end, grain, arg
+      *              as pthread_pool_parallel_for_np()
+      *
+      *      routine
+      *              called with a chunk, the value so far of the
+      *              participant running it, and 'arg'; returns
+      *              the value with the chunk's iterations added
+      *
+      *      combine
+      *              returns the value of 'a' and 'b' together
+      *
+      *      identity
+      *              the value of no iterations, that each
+      *              participant starts with
+      *
+      *      value_ptr
+      *              receives the value of the whole range
+      *
+      * DESCRIPTION
+      *      Each participant folds the chunks it takes into its
+      *      own value, starting from 'identity', and the caller
+      *      then combines the values with 'combine'. Which chunks
+      *      a participant gets varies from run to run, so both
+      *      routines must give the same result whatever the
+      *      grouping and order: 'combine' must be associative and
+      *      commutative and leave a value unchanged when combined
+      *      with 'identity'. A value that won't fit a pointer can
+      *      live in memory that 'routine' allocates and 'combine'
+      *      frees.
+      *
+      * RESULTS
+      *              0               every iteration has run,
+      *              EINVAL          'pool', 'routine', 'combine' or
+      *                              'value_ptr' is NULL, or 'grain' is
+      *                              negative,
+      *              EINTR           'routine' cancelled or exited a
+      *                              worker; the value is without that
+      *                              worker's part.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pool_loop_t loop;
+
+  if (pool == NULL || routine == NULL || combine == NULL
+      || value_ptr == NULL || grain < 0)
+    {
+      return EINVAL;
+    }
+
+  if (begin >= end)
+    {
+      *value_ptr = identity;
+      return 0;
+    }
+
+  loop.begin = begin;
+  loop.end = end;
+  loop.grain = grain;
+  loop.forRoutine = NULL;
+  loop.reduceRoutine = routine;
+  loop.identity = identity;
+  loop.arg = arg;
+
+  return ptw32_pool_loop (pool, &loop, combine, value_ptr);
+}
@@ -0,0 +1,140 @@
+/*
+ * pthread_pool_submit_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_pool_submit_np (pthread_pool_np_t pool,
+                        void *(PTW32_CDECL *routine) (void *),
+                        void * arg,
+                        pthread_pool_task_np_t * task)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Queues a call of routine(arg) on one of the pool's
+      *      workers.
+      *
+      * PARAMETERS
+      *      pool
+      *              an instance of pthread_pool_np_t
+      *
+      *      routine
+      *              the task
+      *
+      *      arg
+      *              passed to routine
+      *
+      *      task
+      *              NULL, or pointer to where a handle to the task
+      *              is returned. A handle must be passed to
+      *              pthread_pool_task_wait_np() exactly once.
+      *
+      * DESCRIPTION
+      *      A task submitted by a worker goes on that worker's
+      *      own deque, e.g. the halves of a divide and conquer
+      *      problem, and is run by the worker itself unless an
+      *      idle worker steals it first.
+      *
+      * RESULTS
+      *              0               successfully queued the task,
+      *              EINVAL          'pool' or 'routine' is invalid,
+      *                              or the pool is being destroyed
+      *                              and the caller isn't one of its
+      *                              workers,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_pool_task_np_t t;
+  ptw32_pool_worker_t * w;
+  int result;
+
+  if (pool == NULL || routine == NULL)
+    {
+      return EINVAL;
+    }
+
+  w = (ptw32_pool_worker_t *) pthread_getspecific (pool->selfKey);
+
+  if (w == NULL && pool->shutdown)
+    {
+      return EINVAL;
+    }
+
+  t = (pthread_pool_task_np_t) ptw32_object_alloc (sizeof (*t), 0);
+
+  if (t == NULL)
+    {
+      return ENOMEM;
+    }
+
+  t->routine = routine;
+  t->arg = arg;
+  t->pool = pool;
+  t->detached = (task == NULL);
+
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->outstanding);
+
+  if (0 != (result = ptw32_pool_push (pool, w, t)))
+    {
+      (void) PTW32_INTERLOCKED_DECREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->outstanding);
+      ptw32_object_free (t);
+      return result;
+    }
+
+  if (task != NULL)
+    {
+      *task = t;
+    }
+
+  ptw32_pool_wake (pool);
+
+  /*
+   * Workers waiting for a task to complete help run the others.
+   */
+  if (0 != PTW32_INTERLOCKED_EXCHANGE_ADD_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->nWaiting,
+                                               (PTW32_INTERLOCKED_LONG) 0))
+    {
+      (void) pthread_mutex_lock (&pool->lock);
+      (void) pthread_cond_broadcast (&pool->changed);
+      (void) pthread_mutex_unlock (&pool->lock);
+    }
+
+  return 0;
+}				/* pthread_pool_submit_np */
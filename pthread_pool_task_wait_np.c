@@ -0,0 +1,117 @@
+/*
+ * pthread_pool_task_wait_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_pool_task_wait_np (pthread_pool_task_np_t task, void ** value_ptr)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits for a task to complete, returns its result
+      *      and frees the task handle.
+      *
+      * PARAMETERS
+      *      task
+      *              a handle returned by pthread_pool_submit_np()
+      *
+      *      value_ptr
+      *              NULL, or pointer to where the value returned
+      *              by the task is stored. It is PTHREAD_CANCELED
+      *              if the task cancelled or exited its worker.
+      *
+      * DESCRIPTION
+      *      A worker of the task's pool runs other queued tasks
+      *      while it waits, so tasks can wait for the tasks they
+      *      submitted without tying up the pool.
+      *      This function is a cancellation point.
+      *
+      * RESULTS
+      *              0               the task completed,
+      *              EINVAL          'task' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (task == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (!PTW32_INTERLOCKED_EXCHANGE_ADD_LONG((PTW32_INTERLOCKED_LONGPTR) &task->done,
+                                           (PTW32_INTERLOCKED_LONG) 0))
+    {
+      pthread_pool_np_t pool = task->pool;
+      ptw32_pool_worker_t * w =
+        (ptw32_pool_worker_t *) pthread_getspecific (pool->selfKey);
+
+      while (!PTW32_INTERLOCKED_EXCHANGE_ADD_LONG((PTW32_INTERLOCKED_LONGPTR) &task->done,
+                                                  (PTW32_INTERLOCKED_LONG) 0))
+        {
+          pthread_pool_task_np_t t;
+
+          if (w != NULL && (t = ptw32_pool_get (pool, w)) != NULL)
+            {
+              ptw32_pool_run (w, t);
+              continue;
+            }
+
+          (void) PTW32_INTERLOCKED_INCREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->nWaiting);
+          (void) pthread_mutex_lock (&pool->lock);
+
+          pthread_cleanup_push (ptw32_pool_wait_cleanup, pool);
+
+          while (!task->done
+                 && !(w != NULL && ptw32_pool_has_tasks (pool)))
+            {
+              (void) pthread_cond_wait (&pool->changed, &pool->lock);
+            }
+
+          pthread_cleanup_pop (1);
+        }
+    }
+
+  if (value_ptr != NULL)
+    {
+      *value_ptr = task->result;
+    }
+
+  ptw32_object_free (task);
+
+  return 0;
+}				/* pthread_pool_task_wait_np */
@@ -0,0 +1,94 @@
+/*
+ * pthread_pool_wait_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_pool_wait_np (pthread_pool_np_t pool)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits until every task submitted to the pool,
+      *      including tasks submitted by tasks, has completed.
+      *
+      * PARAMETERS
+      *      pool
+      *              an instance of pthread_pool_np_t
+      *
+      * DESCRIPTION
+      *      Task handles must still be passed to
+      *      pthread_pool_task_wait_np(), which then doesn't block.
+      *      This function is a cancellation point.
+      *
+      * RESULTS
+      *              0               the pool is idle,
+      *              EINVAL          'pool' is invalid,
+      *              EDEADLK         called from one of the pool's
+      *                              workers.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (pool == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (pthread_getspecific (pool->selfKey) != NULL)
+    {
+      return EDEADLK;
+    }
+
+  if (0 != PTW32_INTERLOCKED_EXCHANGE_ADD_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->outstanding,
+                                               (PTW32_INTERLOCKED_LONG) 0))
+    {
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->nWaiting);
+      (void) pthread_mutex_lock (&pool->lock);
+
+      pthread_cleanup_push (ptw32_pool_wait_cleanup, pool);
+
+      while (0 != pool->outstanding)
+        {
+          (void) pthread_cond_wait (&pool->changed, &pool->lock);
+        }
+
+      pthread_cleanup_pop (1);
+    }
+
+  return 0;
+}				/* pthread_pool_wait_np */
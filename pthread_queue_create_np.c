@@ -0,0 +1,130 @@
+/*
+ * pthread_queue_create_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_queue_create_np (pthread_queue_np_t * queue, int capacity)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Creates a bounded queue that holds up to 'capacity'
+      *      pointers.
+      *
+      * PARAMETERS
+      *      queue
+      *              pointer to an instance of pthread_queue_np_t
+      *
+      *      capacity
+      *              maximum number of items in the queue, at
+      *              least 1.
+      *
+      * DESCRIPTION
+      *      Any number of threads may push and pop at the same
+      *      time. Items are popped in the order their pushes
+      *      took a place in the queue. Pushing and popping only
+      *      block when the queue is full or empty respectively.
+      *
+      * RESULTS
+      *              0               successfully created queue,
+      *              EINVAL          'queue' or 'capacity' is invalid,
+      *              ENOMEM          insufficient memory,
+      *              ENOSPC          insufficient resources.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_queue_np_t q;
+  LONG size;
+  LONG i;
+
+  if (queue == NULL || capacity <= 0 || capacity > (1 << 30))
+    {
+      return EINVAL;
+    }
+
+  for (size = 1; size < capacity; size <<= 1)
+    {
+    }
+
+  q = (pthread_queue_np_t) calloc (1, sizeof (*q));
+
+  if (q == NULL)
+    {
+      return ENOMEM;
+    }
+
+  q->cells = (ptw32_queue_cell_t *) malloc (size * sizeof (*q->cells));
+
+  if (q->cells == NULL)
+    {
+      free (q);
+      return ENOMEM;
+    }
+
+  for (i = 0; i < size; i++)
+    {
+      q->cells[i].sequence = i;
+      q->cells[i].item = NULL;
+    }
+
+  q->mask = size - 1;
+
+  if (0 != sem_init (&q->slots, 0, (unsigned int) capacity))
+    {
+      int result = errno;
+
+      free (q->cells);
+      free (q);
+      return result;
+    }
+
+  if (0 != sem_init (&q->items, 0, 0))
+    {
+      int result = errno;
+
+      (void) sem_destroy (&q->slots);
+      free (q->cells);
+      free (q);
+      return result;
+    }
+
+  *queue = q;
+
+  return 0;
+}				/* pthread_queue_create_np */
@@ -0,0 +1,95 @@
+/*
+ * pthread_queue_destroy_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_queue_destroy_np (pthread_queue_np_t * queue)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Destroys a queue.
+      *
+      * PARAMETERS
+      *      queue
+      *              pointer to an instance of pthread_queue_np_t
+      *
+      * DESCRIPTION
+      *      Items still in the queue are discarded; the queue
+      *      doesn't own what they point to.
+      *
+      * RESULTS
+      *              0               successfully destroyed queue,
+      *              EINVAL          'queue' is invalid,
+      *              EBUSY           threads are blocked pushing to
+      *                              or popping from the queue.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_queue_np_t q;
+
+  if (queue == NULL || *queue == NULL)
+    {
+      return EINVAL;
+    }
+
+  q = *queue;
+
+  /*
+   * A negative semaphore value counts its waiters.
+   */
+  if ((LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
+               (PTW32_INTERLOCKED_LONGPTR) &q->slots->value,
+               (PTW32_INTERLOCKED_LONG) 0) < 0
+      || (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
+                  (PTW32_INTERLOCKED_LONGPTR) &q->items->value,
+                  (PTW32_INTERLOCKED_LONG) 0) < 0)
+    {
+      return EBUSY;
+    }
+
+  (void) sem_destroy (&q->items);
+  (void) sem_destroy (&q->slots);
+
+  free (q->cells);
+  free (q);
+  *queue = NULL;
+
+  return 0;
+}				/* pthread_queue_destroy_np */
@@ -0,0 +1,163 @@
+/*
+ * pthread_queue_pop_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_queue_pop_np (pthread_queue_np_t queue, void ** item)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Pops the item at the head of the queue, waiting
+      *      while the queue is empty.
+      *
+      * PARAMETERS
+      *      queue
+      *              an instance of pthread_queue_np_t
+      *
+      *      item
+      *              pointer to where the item is returned
+      *
+      * DESCRIPTION
+      *      This function is a cancellation point. A cancelled
+      *      pop leaves the queue unchanged.
+      *
+      * RESULTS
+      *              0               an item was popped,
+      *              EINVAL          'queue' or 'item' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  return pthread_queue_timedpop_np (queue, item, NULL);
+}				/* pthread_queue_pop_np */
+
+
+int
+pthread_queue_timedpop_np (pthread_queue_np_t queue,
+                           void ** item,
+                           const struct timespec * abstime)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Pops the item at the head of the queue, waiting
+      *      while the queue is empty, but not beyond 'abstime'.
+      *
+      * PARAMETERS
+      *      queue
+      *              an instance of pthread_queue_np_t
+      *
+      *      item
+      *              pointer to where the item is returned
+      *
+      *      abstime
+      *              NULL, or pointer to an instance of struct
+      *              timespec, measured against CLOCK_REALTIME as
+      *              for sem_timedwait()
+      *
+      * DESCRIPTION
+      *      This function is a cancellation point. A cancelled
+      *      or timed out pop leaves the queue unchanged.
+      *
+      * RESULTS
+      *              0               an item was popped,
+      *              EINVAL          'queue', 'item' or 'abstime' is
+      *                              invalid,
+      *              ETIMEDOUT       abstime passed while the queue
+      *                              was empty.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (queue == NULL || item == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (0 != sem_timedwait (&queue->items, abstime))
+    {
+      return errno;
+    }
+
+  *item = ptw32_queue_get (queue);
+
+  (void) sem_post (&queue->slots);
+
+  return 0;
+}				/* pthread_queue_timedpop_np */
+
+
+int
+pthread_queue_trypop_np (pthread_queue_np_t queue, void ** item)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Pops the item at the head of the queue if the queue
+      *      isn't empty.
+      *
+      * PARAMETERS
+      *      queue
+      *              an instance of pthread_queue_np_t
+      *
+      *      item
+      *              pointer to where the item is returned
+      *
+      * RESULTS
+      *              0               an item was popped,
+      *              EINVAL          'queue' or 'item' is invalid,
+      *              EAGAIN          the queue is empty.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (queue == NULL || item == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (0 != sem_trywait (&queue->items))
+    {
+      return errno;
+    }
+
+  *item = ptw32_queue_get (queue);
+
+  (void) sem_post (&queue->slots);
+
+  return 0;
+}				/* pthread_queue_trypop_np */
@@ -0,0 +1,162 @@
+/*
+ * pthread_queue_push_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_queue_push_np (pthread_queue_np_t queue, void * item)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Pushes item onto the tail of the queue, waiting
+      *      while the queue is full.
+      *
+      * PARAMETERS
+      *      queue
+      *              an instance of pthread_queue_np_t
+      *
+      *      item
+      *              the pointer to queue, which may be NULL
+      *
+      * DESCRIPTION
+      *      This function is a cancellation point. A cancelled
+      *      push leaves the queue unchanged.
+      *
+      * RESULTS
+      *              0               item was queued,
+      *              EINVAL          'queue' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  return pthread_queue_timedpush_np (queue, item, NULL);
+}				/* pthread_queue_push_np */
+
+
+int
+pthread_queue_timedpush_np (pthread_queue_np_t queue,
+                            void * item,
+                            const struct timespec * abstime)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Pushes item onto the tail of the queue, waiting
+      *      while the queue is full, but not beyond 'abstime'.
+      *
+      * PARAMETERS
+      *      queue
+      *              an instance of pthread_queue_np_t
+      *
+      *      item
+      *              the pointer to queue, which may be NULL
+      *
+      *      abstime
+      *              NULL, or pointer to an instance of struct
+      *              timespec, measured against CLOCK_REALTIME as
+      *              for sem_timedwait()
+      *
+      * DESCRIPTION
+      *      This function is a cancellation point. A cancelled
+      *      or timed out push leaves the queue unchanged.
+      *
+      * RESULTS
+      *              0               item was queued,
+      *              EINVAL          'queue' or 'abstime' is invalid,
+      *              ETIMEDOUT       abstime passed while the queue
+      *                              was full.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (queue == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (0 != sem_timedwait (&queue->slots, abstime))
+    {
+      return errno;
+    }
+
+  ptw32_queue_put (queue, item);
+
+  (void) sem_post (&queue->items);
+
+  return 0;
+}				/* pthread_queue_timedpush_np */
+
+
+int
+pthread_queue_trypush_np (pthread_queue_np_t queue, void * item)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Pushes item onto the tail of the queue if the queue
+      *      isn't full.
+      *
+      * PARAMETERS
+      *      queue
+      *              an instance of pthread_queue_np_t
+      *
+      *      item
+      *              the pointer to queue, which may be NULL
+      *
+      * RESULTS
+      *              0               item was queued,
+      *              EINVAL          'queue' is invalid,
+      *              EAGAIN          the queue is full.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (queue == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (0 != sem_trywait (&queue->slots))
+    {
+      return errno;
+    }
+
+  ptw32_queue_put (queue, item);
+
+  (void) sem_post (&queue->items);
+
+  return 0;
+}				/* pthread_queue_trypush_np */
@@ -0,0 +1,131 @@
+/*
+ * pthread_rcu_online_np.c
+ *
+ * Description:
+ * This translation unit implements read-copy-update primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_rcu_online_np (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Makes the calling thread an RCU reader.
+      *
+      * DESCRIPTION
+      *      From now on the thread may read RCU protected data
+      *      without locks, and pthread_rcu_synchronize_np() waits
+      *      for its next quiescent state. The thread reports one
+      *      whenever it holds no references to such data, with
+      *      pthread_rcu_quiescent_np() or by calling a
+      *      cancellation point, and goes offline before long
+      *      periods without either. It is put offline when it
+      *      exits.
+      *
+      * RESULTS
+      *              0               the thread is online,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+  ptw32_rcu_reader_t * r;
+
+  if (sp == NULL || (r = ptw32_rcu_register (sp)) == NULL)
+    {
+      return ENOMEM;
+    }
+
+  PTW32_RCU_ONLINE (r);
+
+  return 0;
+}				/* pthread_rcu_online_np */
+
+
+int
+pthread_rcu_offline_np (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Takes the calling thread out of the RCU readers
+      *      until it next goes online or reports a quiescent
+      *      state.
+      *
+      * DESCRIPTION
+      *      Grace periods don't wait for an offline thread, which
+      *      must not read RCU protected data. A thread that isn't
+      *      a reader is left alone.
+      *
+      * RESULTS
+      *              0               always.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+
+  if (sp != NULL && sp->rcuReader != NULL)
+    {
+      PTW32_RCU_OFFLINE (sp->rcuReader);
+    }
+
+  return 0;
+}				/* pthread_rcu_offline_np */
+
+
+int
+pthread_rcu_quiescent_np (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Reports that the calling thread holds no references
+      *      to RCU protected data.
+      *
+      * DESCRIPTION
+      *      Grace periods that started before the call no longer
+      *      wait for the thread. An offline thread, or one that
+      *      wasn't a reader, goes online.
+      *
+      * RESULTS
+      *              0               the state was reported,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  return pthread_rcu_online_np ();
+}				/* pthread_rcu_quiescent_np */
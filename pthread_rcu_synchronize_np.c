@@ -0,0 +1,121 @@
+/*
+ * pthread_rcu_synchronize_np.c
+ *
+ * Description:
+ * This translation unit implements read-copy-update primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Quiescent state based RCU, as in liburcu's QSBR flavour.
+ *
+ * ptw32_rcuGp counts grace periods in steps of 2 from 1. An online
+ * reader's ctr is the value of ptw32_rcuGp it saw at its latest
+ * quiescent state; an offline one's is 0. A grace period advances
+ * ptw32_rcuGp and then waits until each reader's ctr is 0 or the new
+ * value, i.e. each online reader has passed a quiescent state since it
+ * began. Readers change only their own ctr, with an interlocked
+ * exchange, so their reads of shared data can't move across it and
+ * they never wait.
+ */
+
+int
+pthread_rcu_synchronize_np (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits for an RCU grace period.
+      *
+      * DESCRIPTION
+      *      Returns once every online reader has passed a
+      *      quiescent state, so no reader still holds a
+      *      reference to data unlinked before the call, which
+      *      may then be freed. If the calling thread is an
+      *      online reader it is treated as quiescent.
+      *
+      * RESULTS
+      *              0               always.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+  ptw32_rcu_reader_t * self = (sp != NULL) ? sp->rcuReader : NULL;
+  ptw32_rcu_reader_t * r;
+  ptw32_mcs_local_node_t node;
+  LONG gp;
+
+  if (self != NULL && self->ctr != 0)
+    {
+      PTW32_RCU_OFFLINE (self);
+    }
+  else
+    {
+      self = NULL;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_rcu_lock, &node);
+
+  gp = (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_rcuGp,
+						   (PTW32_INTERLOCKED_LONG) 2) + 2;
+
+  for (r = ptw32_rcuReaders; r != NULL; r = r->next)
+    {
+      LONG ctr;
+      int spins = 0;
+      int yields = 0;
+
+      while ((ctr = r->ctr) != 0 && ctr != gp)
+	{
+	  if (++spins < PTW32_RCU_SPIN)
+	    {
+	      PTW32_YIELD_PROCESSOR ();
+	    }
+	  else
+	    {
+	      ptw32_yield (&yields);
+	    }
+	}
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  if (self != NULL)
+    {
+      PTW32_RCU_ONLINE (self);
+    }
+
+  return 0;
+}				/* pthread_rcu_synchronize_np */
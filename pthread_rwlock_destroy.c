@@ -59,6 +59,28 @@ pthread_rwlock_destroy (pthread_rwlock_t * rwlock)
 	  return EINVAL;
 	}
 
+      if (rwl->useSRWLock)
+	{
+	  if ((result = ptw32_rwlock_srw_destroy (rwl)) == 0)
+	    {
+	      *rwlock = NULL;
+	      PTW32_LOCKSTAT_DESTROY (rwl->stats);
+	      ptw32_object_free (rwl);
+	    }
+	  return result;
+	}
+
+      if (rwl->kind != PTHREAD_RWLOCK_DEFAULT_NP)
+	{
+	  if ((result = ptw32_rwlock_policy_destroy (rwl)) == 0)
+	    {
+	      *rwlock = NULL;
+	      PTW32_LOCKSTAT_DESTROY (rwl->stats);
+	      ptw32_object_free (rwl);
+	    }
+	  return result;
+	}
+
       if ((result = pthread_mutex_lock (&(rwl->mtxExclusiveAccess))) != 0)
 	{
 	  return result;
@@ -76,7 +98,8 @@ pthread_rwlock_destroy (pthread_rwlock_t * rwlock)
        * report "BUSY" if so.
        */
       if (rwl->nExclusiveAccessCount > 0
-	  || rwl->nSharedAccessCount > rwl->nCompletedSharedAccessCount)
+	  || rwl->nSharedAccessCount > rwl->nCompletedSharedAccessCount
+	  || (rwl->readerSlots != NULL && ptw32_rwlock_readers_active (rwl)))
 	{
 	  result = pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
 	  result1 = pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
@@ -103,40 +126,28 @@ pthread_rwlock_destroy (pthread_rwlock_t * rwlock)
 	  result = pthread_cond_destroy (&(rwl->cndSharedAccessCompleted));
 	  result1 = pthread_mutex_destroy (&(rwl->mtxSharedAccessCompleted));
 	  result2 = pthread_mutex_destroy (&(rwl->mtxExclusiveAccess));
-	  (void) free (rwl);
+	  if (rwl->readerSlots != NULL)
+	    {
+	      (void) free (rwl->readerSlots);
+	    }
+	  PTW32_LOCKSTAT_DESTROY (rwl->stats);
+	  ptw32_object_free (rwl);
 	}
     }
   else
     {
-      ptw32_mcs_local_node_t node;
-      /*
-       * See notes in ptw32_rwlock_check_need_init() above also.
-       */
-      ptw32_mcs_lock_acquire(&ptw32_rwlock_test_init_lock, &node);
-
       /*
-       * Check again.
+       * Clear a static rwlock that has not been used yet, as
+       * pthread_mutex_destroy() does, unless another thread has
+       * just initialised it.
        */
-      if (*rwlock == PTHREAD_RWLOCK_INITIALIZER)
+      if (PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) rwlock,
+						  (PTW32_INTERLOCKED_PVOID) NULL,
+						  (PTW32_INTERLOCKED_PVOID) PTHREAD_RWLOCK_INITIALIZER)
+	  != (PTW32_INTERLOCKED_PVOID) PTHREAD_RWLOCK_INITIALIZER)
 	{
-	  /*
-	   * This is all we need to do to destroy a statically
-	   * initialised rwlock that has not yet been used (initialised).
-	   * If we get to here, another thread
-	   * waiting to initialise this rwlock will get an EINVAL.
-	   */
-	  *rwlock = NULL;
-	}
-      else
-	{
-	  /*
-	   * The rwlock has been initialised while we were waiting
-	   * so assume it's in use.
-	   */
 	  result = EBUSY;
 	}
-
-      ptw32_mcs_lock_release(&node);
     }
 
   return ((result != 0) ? result : ((result1 != 0) ? result1 : result2));
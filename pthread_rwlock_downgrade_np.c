@@ -0,0 +1,118 @@
+/*
+ * pthread_rwlock_downgrade_np.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_rwlock_downgrade_np (pthread_rwlock_t * rwlock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Turns the caller's write lock into a read lock
+      *      without letting a writer in between.
+      *
+      * PARAMETERS
+      *      rwlock
+      *              pointer to a write locked pthread_rwlock_t
+      *
+      * DESCRIPTION
+      *      Readers waiting for the write lock are admitted
+      *      alongside the caller if the lock's kind would admit
+      *      them while a reader holds it. The caller releases
+      *      its read lock with pthread_rwlock_unlock().
+      *
+      *      Default kind locks built on a Windows SRW lock and
+      *      distributed locks can't be downgraded.
+      *
+      * RESULTS
+      *              0               the caller holds a read lock,
+      *              EINVAL          'rwlock' is invalid,
+      *              EPERM           the lock is not write locked,
+      *              ENOTSUP         the lock can't be downgraded.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_rwlock_t rwl;
+  int result, result1;
+
+  if (rwlock == NULL || *rwlock == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (*rwlock == PTHREAD_RWLOCK_INITIALIZER)
+    {
+      return EPERM;
+    }
+
+  rwl = *rwlock;
+
+  if (rwl->nMagic != PTW32_RWLOCK_MAGIC)
+    {
+      return EINVAL;
+    }
+
+  if (rwl->readerSlots != NULL || rwl->useSRWLock)
+    {
+      return ENOTSUP;
+    }
+
+  if (rwl->kind != PTHREAD_RWLOCK_DEFAULT_NP)
+    {
+      return ptw32_rwlock_policy_downgrade (rwl);
+    }
+
+  if (rwl->nExclusiveAccessCount == 0)
+    {
+      return EPERM;
+    }
+
+  /*
+   * The writer holds both mutexes, so no reader has come or gone
+   * and the shared count is zero: count ourselves in, then let
+   * other readers follow.
+   */
+  rwl->nExclusiveAccessCount--;
+  rwl->nSharedAccessCount++;
+
+  result = pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
+  result1 = pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+
+  return ((result != 0) ? result : result1);
+}				/* pthread_rwlock_downgrade_np */
@@ -51,13 +51,19 @@ pthread_rwlock_init (pthread_rwlock_t * rwlock,
       return EINVAL;
     }
 
-  if (attr != NULL && *attr != NULL)
+  if (attr != NULL && PTW32_ATTR_IS_INITIALIZER (*attr))
+    {
+      attr = NULL;
+    }
+
+  if (attr != NULL && *attr != NULL
+      && (*attr)->pshared == PTHREAD_PROCESS_SHARED)
     {
       result = EINVAL;		/* Not supported */
       goto DONE;
     }
 
-  rwl = (pthread_rwlock_t) calloc (1, sizeof (*rwl));
+  rwl = (pthread_rwlock_t) ptw32_object_alloc (sizeof (*rwl), ptw32_objectAlign);
 
   if (rwl == NULL)
     {
@@ -65,6 +71,35 @@ pthread_rwlock_init (pthread_rwlock_t * rwlock,
       goto DONE;
     }
 
+  PTW32_LOCKSTAT_INIT (rwl->stats, PTHREAD_LOCKSTAT_RWLOCK_NP, rwl);
+
+  if (attr != NULL && *attr != NULL && !(*attr)->distributed
+      && (*attr)->kind != PTHREAD_RWLOCK_DEFAULT_NP)
+    {
+      /* Preference policy locks don't use the mutexes or the condvar */
+      result = ptw32_rwlock_policy_init (rwl, (*attr)->kind);
+      if (result != 0)
+	{
+	  goto FAIL0;
+	}
+
+      rwl->nMagic = PTW32_RWLOCK_MAGIC;
+      goto DONE;
+    }
+
+  if (PTW32_RWLOCK_USES_SRW ()
+      && (attr == NULL || *attr == NULL || !(*attr)->distributed))
+    {
+      rwl->useSRWLock = 1;
+      rwl->srwLock = NULL;	/* SRWLOCK_INIT */
+      rwl->srwGeneration = 0;
+      rwl->nSrwTimedWaiters = 0;
+      rwl->nExclusiveAccessCount = 0;
+      rwl->nMagic = PTW32_RWLOCK_MAGIC;
+      result = 0;
+      goto DONE;
+    }
+
   rwl->nSharedAccessCount = 0;
   rwl->nExclusiveAccessCount = 0;
   rwl->nCompletedSharedAccessCount = 0;
@@ -87,11 +122,23 @@ pthread_rwlock_init (pthread_rwlock_t * rwlock,
       goto FAIL2;
     }
 
+  if (attr != NULL && *attr != NULL && (*attr)->distributed)
+    {
+      result = ptw32_rwlock_readers_init (rwl);
+      if (result != 0)
+	{
+	  goto FAIL3;
+	}
+    }
+
   rwl->nMagic = PTW32_RWLOCK_MAGIC;
 
   result = 0;
   goto DONE;
 
+FAIL3:
+  (void) pthread_cond_destroy (&(rwl->cndSharedAccessCompleted));
+
 FAIL2:
   (void) pthread_mutex_destroy (&(rwl->mtxSharedAccessCompleted));
 
@@ -99,7 +146,7 @@ FAIL1:
   (void) pthread_mutex_destroy (&(rwl->mtxExclusiveAccess));
 
 FAIL0:
-  (void) free (rwl);
+  ptw32_object_free (rwl);
   rwl = NULL;
 
 DONE:
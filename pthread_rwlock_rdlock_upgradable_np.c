@@ -0,0 +1,140 @@
+/*
+ * pthread_rwlock_rdlock_upgradable_np.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Only the preference policy kinds can be upgraded.
+ */
+static int
+ptw32_rwlock_upgradable (pthread_rwlock_t * rwlock, pthread_rwlock_t * rwl)
+{
+  if (rwlock == NULL || *rwlock == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (*rwlock == PTHREAD_RWLOCK_INITIALIZER)
+    {
+      return ENOTSUP;
+    }
+
+  *rwl = *rwlock;
+
+  if ((*rwl)->nMagic != PTW32_RWLOCK_MAGIC)
+    {
+      return EINVAL;
+    }
+
+  if ((*rwl)->readerSlots != NULL || (*rwl)->kind == PTHREAD_RWLOCK_DEFAULT_NP)
+    {
+      return ENOTSUP;
+    }
+
+  return 0;
+}
+
+
+int
+pthread_rwlock_rdlock_upgradable_np (pthread_rwlock_t * rwlock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Read locks 'rwlock' such that the caller may later
+      *      upgrade to the write lock with
+      *      pthread_rwlock_upgrade_np().
+      *
+      * PARAMETERS
+      *      rwlock
+      *              pointer to a pthread_rwlock_t of one of the
+      *              preference policy kinds
+      *
+      * DESCRIPTION
+      *      An upgradable reader shares the lock with ordinary
+      *      readers but not with another upgradable reader, so
+      *      two of them can't deadlock upgrading. It releases
+      *      the lock with pthread_rwlock_unlock().
+      *
+      *      This is not a cancellation point.
+      *
+      * RESULTS
+      *              0               the caller holds the lock
+      *                              upgradable,
+      *              EINVAL          'rwlock' is invalid,
+      *              EDEADLK         the caller already holds it
+      *                              upgradable,
+      *              ENOTSUP         'rwlock' is of the default kind
+      *                              or distributed,
+      *              EAGAIN          insufficient resources.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_rwlock_t rwl;
+  int result;
+
+  if (0 != (result = ptw32_rwlock_upgradable (rwlock, &rwl)))
+    {
+      return result;
+    }
+
+  return ptw32_rwlock_policy_rdlock_upgradable (rwl, PTW32_FALSE);
+}				/* pthread_rwlock_rdlock_upgradable_np */
+
+
+int
+pthread_rwlock_tryrdlock_upgradable_np (pthread_rwlock_t * rwlock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      As pthread_rwlock_rdlock_upgradable_np(), but returns
+      *      EBUSY rather than waiting.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_rwlock_t rwl;
+  int result;
+
+  if (0 != (result = ptw32_rwlock_upgradable (rwlock, &rwl)))
+    {
+      return result;
+    }
+
+  return ptw32_rwlock_policy_rdlock_upgradable (rwl, PTW32_TRUE);
+}				/* pthread_rwlock_tryrdlock_upgradable_np */
@@ -74,35 +74,35 @@ pthread_rwlock_timedrdlock (pthread_rwlock_t * rwlock,
       return EINVAL;
     }
 
-  if ((result =
-       pthread_mutex_timedlock (&(rwl->mtxExclusiveAccess), abstime)) != 0)
+  if (rwl->readerSlots != NULL)
     {
-      return result;
+      return PTW32_LOCKSTAT_RWLOCK (rwl, ptw32_rwlock_readers_rdlock, abstime, 0);
     }
 
-  if (++rwl->nSharedAccessCount == INT_MAX)
+  if (rwl->kind != PTHREAD_RWLOCK_DEFAULT_NP)
     {
-      if ((result =
-	   pthread_mutex_timedlock (&(rwl->mtxSharedAccessCompleted),
-				    abstime)) != 0)
+      if (rwl->elide != NULL && ptw32_rwlock_elide_lock (rwl))
 	{
-	  if (result == ETIMEDOUT)
-	    {
-	      ++rwl->nCompletedSharedAccessCount;
-	    }
-	  (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
-	  return result;
+	  return 0;
 	}
+      return PTW32_LOCKSTAT_RWLOCK (rwl, ptw32_rwlock_policy_rdlock, abstime, 0);
+    }
 
-      rwl->nSharedAccessCount -= rwl->nCompletedSharedAccessCount;
-      rwl->nCompletedSharedAccessCount = 0;
+  if (rwl->useSRWLock)
+    {
+      return PTW32_LOCKSTAT_RWLOCK (rwl, ptw32_rwlock_srw_rdlock, abstime, 0);
+    }
 
-      if ((result =
-	   pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted))) != 0)
-	{
-	  (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
-	  return result;
-	}
+  if ((result =
+       pthread_mutex_timedlock (&(rwl->mtxExclusiveAccess), abstime)) != 0)
+    {
+      return result;
+    }
+
+  if (++rwl->nSharedAccessCount == INT_MAX)
+    {
+      /* No writer is waiting: we hold mtxExclusiveAccess */
+      PTW32_RWLOCK_FOLD_COMPLETED (rwl);
     }
 
   return (pthread_mutex_unlock (&(rwl->mtxExclusiveAccess)));
@@ -73,6 +73,25 @@ pthread_rwlock_trywrlock (pthread_rwlock_t * rwlock)
       return EINVAL;
     }
 
+  if (rwl->readerSlots != NULL)
+    {
+      return PTW32_LOCKSTAT_RWLOCK (rwl, ptw32_rwlock_readers_wrlock, NULL, 1);
+    }
+
+  if (rwl->kind != PTHREAD_RWLOCK_DEFAULT_NP)
+    {
+      if (rwl->elide != NULL && ptw32_rwlock_elide_lock (rwl))
+	{
+	  return 0;
+	}
+      return PTW32_LOCKSTAT_RWLOCK (rwl, ptw32_rwlock_policy_wrlock, NULL, 1);
+    }
+
+  if (rwl->useSRWLock)
+    {
+      return PTW32_LOCKSTAT_RWLOCK (rwl, ptw32_rwlock_srw_wrlock, NULL, 1);
+    }
+
   if ((result = pthread_mutex_trylock (&(rwl->mtxExclusiveAccess))) != 0)
     {
       return result;
@@ -87,11 +106,7 @@ pthread_rwlock_trywrlock (pthread_rwlock_t * rwlock)
 
   if (rwl->nExclusiveAccessCount == 0)
     {
-      if (rwl->nCompletedSharedAccessCount > 0)
-	{
-	  rwl->nSharedAccessCount -= rwl->nCompletedSharedAccessCount;
-	  rwl->nCompletedSharedAccessCount = 0;
-	}
+      PTW32_RWLOCK_FOLD_COMPLETED (rwl);
 
       if (rwl->nSharedAccessCount > 0)
 	{
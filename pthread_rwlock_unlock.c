@@ -65,20 +65,46 @@ pthread_rwlock_unlock (pthread_rwlock_t * rwlock)
       return EINVAL;
     }
 
-  if (rwl->nExclusiveAccessCount == 0)
+  if (rwl->readerSlots != NULL)
+    {
+      return ptw32_rwlock_readers_unlock (rwl);
+    }
+
+  if (rwl->kind != PTHREAD_RWLOCK_DEFAULT_NP)
     {
-      if ((result =
-	   pthread_mutex_lock (&(rwl->mtxSharedAccessCompleted))) != 0)
+      if (rwl->elide != NULL && ptw32_rwlock_elide_unlock (rwl))
 	{
-	  return result;
+	  return 0;
 	}
+      return ptw32_rwlock_policy_unlock (rwl);
+    }
+
+  if (rwl->useSRWLock)
+    {
+      return ptw32_rwlock_srw_unlock (rwl);
+    }
 
-      if (++rwl->nCompletedSharedAccessCount == 0)
+  if (rwl->nExclusiveAccessCount == 0)
+    {
+      result = result1 = 0;
+
+      /*
+       * Only the reader that brings a waiting writer's count to
+       * zero takes the mutex, which the writer holds until it
+       * waits, so the signal can't be lost (see
+       * PTW32_RWLOCK_FOLD_COMPLETED).
+       */
+      if (0 == PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->nCompletedSharedAccessCount))
 	{
+	  if ((result =
+	       pthread_mutex_lock (&(rwl->mtxSharedAccessCompleted))) != 0)
+	    {
+	      return result;
+	    }
+
 	  result = pthread_cond_signal (&(rwl->cndSharedAccessCompleted));
+	  result1 = pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
 	}
-
-      result1 = pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
     }
   else
     {
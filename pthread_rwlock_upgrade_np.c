@@ -0,0 +1,101 @@
+/*
+ * pthread_rwlock_upgrade_np.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_rwlock_upgrade_np (pthread_rwlock_t * rwlock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Turns the caller's upgradable read lock into the
+      *      write lock.
+      *
+      * PARAMETERS
+      *      rwlock
+      *              pointer to a pthread_rwlock_t the caller holds
+      *              with pthread_rwlock_rdlock_upgradable_np()
+      *
+      * DESCRIPTION
+      *      New readers are held off while the caller waits for
+      *      the readers already inside to leave. The caller keeps
+      *      its read lock throughout, so what it read is still
+      *      valid when it becomes the writer. It releases the
+      *      write lock with pthread_rwlock_unlock(), or turns it
+      *      back into an ordinary read lock with
+      *      pthread_rwlock_downgrade_np().
+      *
+      *      This is not a cancellation point.
+      *
+      * RESULTS
+      *              0               the caller holds the write lock,
+      *              EINVAL          'rwlock' is invalid,
+      *              EPERM           the caller doesn't hold the lock
+      *                              upgradable,
+      *              ENOTSUP         'rwlock' is of the default kind
+      *                              or distributed.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_rwlock_t rwl;
+
+  if (rwlock == NULL || *rwlock == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (*rwlock == PTHREAD_RWLOCK_INITIALIZER)
+    {
+      return ENOTSUP;
+    }
+
+  rwl = *rwlock;
+
+  if (rwl->nMagic != PTW32_RWLOCK_MAGIC)
+    {
+      return EINVAL;
+    }
+
+  if (rwl->readerSlots != NULL || rwl->kind == PTHREAD_RWLOCK_DEFAULT_NP)
+    {
+      return ENOTSUP;
+    }
+
+  return ptw32_rwlock_policy_upgrade (rwl);
+}				/* pthread_rwlock_upgrade_np */
@@ -73,6 +73,25 @@ pthread_rwlock_wrlock (pthread_rwlock_t * rwlock)
       return EINVAL;
     }
 
+  if (rwl->readerSlots != NULL)
+    {
+      return PTW32_LOCKSTAT_RWLOCK (rwl, ptw32_rwlock_readers_wrlock, NULL, 0);
+    }
+
+  if (rwl->kind != PTHREAD_RWLOCK_DEFAULT_NP)
+    {
+      if (rwl->elide != NULL && ptw32_rwlock_elide_lock (rwl))
+	{
+	  return 0;
+	}
+      return PTW32_LOCKSTAT_RWLOCK (rwl, ptw32_rwlock_policy_wrlock, NULL, 0);
+    }
+
+  if (rwl->useSRWLock)
+    {
+      return PTW32_LOCKSTAT_RWLOCK (rwl, ptw32_rwlock_srw_wrlock, NULL, 0);
+    }
+
   if ((result = pthread_mutex_lock (&(rwl->mtxExclusiveAccess))) != 0)
     {
       return result;
@@ -86,15 +105,12 @@ pthread_rwlock_wrlock (pthread_rwlock_t * rwlock)
 
   if (rwl->nExclusiveAccessCount == 0)
     {
-      if (rwl->nCompletedSharedAccessCount > 0)
-	{
-	  rwl->nSharedAccessCount -= rwl->nCompletedSharedAccessCount;
-	  rwl->nCompletedSharedAccessCount = 0;
-	}
+      PTW32_RWLOCK_FOLD_COMPLETED (rwl);
 
       if (rwl->nSharedAccessCount > 0)
 	{
-	  rwl->nCompletedSharedAccessCount = -rwl->nSharedAccessCount;
+	  (void) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->nCompletedSharedAccessCount,
+						      (PTW32_INTERLOCKED_LONG) -rwl->nSharedAccessCount);
 
 	  /*
 	   * This routine may be a cancellation point
@@ -105,12 +121,12 @@ pthread_rwlock_wrlock (pthread_rwlock_t * rwlock)
 #endif
 	  pthread_cleanup_push (ptw32_rwlock_cancelwrwait, (void *) rwl);
 
-	  do
+	  /* The readers may all have left already */
+	  while (result == 0 && rwl->nCompletedSharedAccessCount < 0)
 	    {
 	      result = pthread_cond_wait (&(rwl->cndSharedAccessCompleted),
 					  &(rwl->mtxSharedAccessCompleted));
 	    }
-	  while (result == 0 && rwl->nCompletedSharedAccessCount < 0);
 
 	  pthread_cleanup_pop ((result != 0) ? 1 : 0);
 #if defined(PTW32_CONFIG_MSVC7)
@@ -77,7 +77,10 @@ pthread_rwlockattr_destroy (pthread_rwlockattr_t * attr)
       pthread_rwlockattr_t rwa = *attr;
 
       *attr = NULL;
-      free (rwa);
+      if (!PTW32_ATTR_IS_INITIALIZER (rwa))
+	{
+	  ptw32_object_free (rwa);
+	}
     }
 
   return (result);
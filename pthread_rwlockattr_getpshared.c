@@ -84,7 +84,7 @@ pthread_rwlockattr_getpshared (const pthread_rwlockattr_t * attr,
 
   if ((attr != NULL && *attr != NULL) && (pshared != NULL))
     {
-      *pshared = (*attr)->pshared;
+      *pshared = PTW32_ATTR_READ (*attr, ptw32_rwlockattr_default)->pshared;
       result = 0;
     }
   else
@@ -66,7 +66,7 @@ pthread_rwlockattr_init (pthread_rwlockattr_t * attr)
   int result = 0;
   pthread_rwlockattr_t rwa;
 
-  rwa = (pthread_rwlockattr_t) calloc (1, sizeof (*rwa));
+  rwa = (pthread_rwlockattr_t) ptw32_object_alloc (sizeof (*rwa), 0);
 
   if (rwa == NULL)
     {
@@ -75,6 +75,8 @@ pthread_rwlockattr_init (pthread_rwlockattr_t * attr)
   else
     {
       rwa->pshared = PTHREAD_PROCESS_PRIVATE;
+      rwa->distributed = 0;
+      rwa->kind = PTHREAD_RWLOCK_DEFAULT_NP;
     }
 
   *attr = rwa;
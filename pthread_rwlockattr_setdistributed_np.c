@@ -0,0 +1,87 @@
+/*
+ * pthread_rwlockattr_setdistributed_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_rwlockattr_setdistributed_np (pthread_rwlockattr_t * attr,
+				      int distributed)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Selects distributed reader counting for read-write
+      *      locks initialised with 'attr'.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_rwlockattr_t
+      *
+      *      distributed
+      *              0 (default) or 1.
+      *
+      * DESCRIPTION
+      *      A distributed read-write lock counts its readers in
+      *      a small array of per-cache-line slots, one of which is
+      *      chosen by each reading thread. Read lock and unlock
+      *      then touch only that slot, so readers on different
+      *      processors don't contend. A writer must visit every
+      *      slot, so write locking is slower, and a waiting writer
+      *      holds off new readers.
+      *
+      * RESULTS
+      *              0               successfully set attribute,
+      *              EINVAL          'attr' or 'distributed' is invalid,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_rwlockattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
+  if (attr == NULL || *attr == NULL
+      || (distributed != 0 && distributed != 1))
+    {
+      return EINVAL;
+    }
+
+  (*attr)->distributed = distributed;
+
+  return 0;
+}				/* pthread_rwlockattr_setdistributed_np */
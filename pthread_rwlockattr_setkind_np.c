@@ -0,0 +1,117 @@
+/*
+ * pthread_rwlockattr_setkind_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_rwlockattr_setkind_np (pthread_rwlockattr_t * attr, int kind)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Selects the preference policy of read-write locks
+      *      initialised with 'attr'.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_rwlockattr_t
+      *
+      *      kind
+      *              one of:
+      *
+      *              PTHREAD_RWLOCK_DEFAULT_NP (default)
+      *                      the standard implementation; waiting
+      *                      writers hold off new readers.
+      *
+      *              PTHREAD_RWLOCK_PREFER_READER_NP
+      *                      readers enter whenever no writer
+      *                      holds the lock. Writers may starve.
+      *
+      *              PTHREAD_RWLOCK_PREFER_WRITER_NP
+      *                      waiting writers hold off new readers
+      *                      and are served before waiting readers.
+      *                      Readers may starve.
+      *
+      *              PTHREAD_RWLOCK_PHASE_FAIR_NP
+      *                      waiting writers hold off new readers,
+      *                      but read and write phases alternate
+      *                      while both are waiting, so neither
+      *                      can starve.
+      *
+      *              PTHREAD_RWLOCK_ELIDE_NP
+      *                      read and write critical sections first
+      *                      run as hardware (RTM) transactions
+      *                      without taking the lock, so sections
+      *                      that don't conflict run concurrently.
+      *                      Otherwise, and without RTM, as
+      *                      PTHREAD_RWLOCK_PREFER_WRITER_NP.
+      *
+      * DESCRIPTION
+      *      The non-default kinds are implemented directly on an
+      *      internal lock and two semaphores, with ownership handed
+      *      from the releasing thread to the next owners. Their
+      *      lock calls are not cancellation points. A thread that
+      *      already holds a read lock must not read lock again if
+      *      a writer might be waiting, except with
+      *      PTHREAD_RWLOCK_PREFER_READER_NP.
+      *
+      *      The kind is ignored for distributed locks (see
+      *      pthread_rwlockattr_setdistributed_np()).
+      *
+      * RESULTS
+      *              0               successfully set attribute,
+      *              EINVAL          'attr' or 'kind' is invalid,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_rwlockattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
+  if (attr == NULL || *attr == NULL
+      || kind < PTHREAD_RWLOCK_DEFAULT_NP
+      || kind > PTHREAD_RWLOCK_ELIDE_NP)
+    {
+      return EINVAL;
+    }
+
+  (*attr)->kind = kind;
+
+  return 0;
+}				/* pthread_rwlockattr_setkind_np */
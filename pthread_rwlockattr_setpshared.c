@@ -84,6 +84,11 @@ pthread_rwlockattr_setpshared (pthread_rwlockattr_t * attr, int pshared)
 {
   int result;
 
+  if (PTW32_ATTR_NEED_INIT (attr, pthread_rwlockattr_init) != 0)
+    {
+      return ENOMEM;
+    }
+
   if ((attr != NULL && *attr != NULL) &&
       ((pshared == PTHREAD_PROCESS_SHARED) ||
        (pshared == PTHREAD_PROCESS_PRIVATE)))
@@ -0,0 +1,102 @@
+/*
+ * pthread_rwspin_destroy_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_rwspin_destroy_np (pthread_rwspinlock_np_t * lock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Destroys a reader-writer spin lock.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_rwspinlock_np_t
+      *
+      * DESCRIPTION
+      *      As for pthread_spin_destroy(), a lock that is held
+      *      isn't destroyed, and a static lock that has not been
+      *      used yet is cleared.
+      *
+      * RESULTS
+      *              0               successfully destroyed the lock,
+      *              EINVAL          'lock' is invalid or held,
+      *              EBUSY           another thread has just
+      *                              initialised a static lock.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_rwspinlock_np_t l;
+
+  if (lock == NULL || *lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  if ((l = *lock) == PTHREAD_RWSPINLOCK_INITIALIZER_NP)
+    {
+      if (PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) lock,
+						  (PTW32_INTERLOCKED_PVOID) NULL,
+						  (PTW32_INTERLOCKED_PVOID) PTHREAD_RWSPINLOCK_INITIALIZER_NP)
+	  != (PTW32_INTERLOCKED_PVOID) PTHREAD_RWSPINLOCK_INITIALIZER_NP)
+	{
+	  return EBUSY;
+	}
+      return 0;
+    }
+
+  if ((PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED !=
+      PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->state,
+					       (PTW32_INTERLOCKED_LONG) PTW32_SPIN_INVALID,
+					       (PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED))
+    {
+      return EINVAL;
+    }
+
+  /*
+   * We are relying on the application to ensure that all other threads
+   * have finished with the lock before destroying it.
+   */
+  *lock = NULL;
+  ptw32_object_free (l);
+
+  return 0;
+}				/* pthread_rwspin_destroy_np */
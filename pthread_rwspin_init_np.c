@@ -0,0 +1,97 @@
+/*
+ * pthread_rwspin_init_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_rwspin_init_np (pthread_rwspinlock_np_t * lock, int pshared)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Initialises a reader-writer spin lock.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_rwspinlock_np_t
+      *
+      *      pshared
+      *              PTHREAD_PROCESS_PRIVATE; PTHREAD_PROCESS_SHARED
+      *              isn't supported
+      *
+      * DESCRIPTION
+      *      A reader-writer spin lock is one word holding a count
+      *      of readers and a writer bit. Readers share it and a
+      *      writer excludes everyone; waiters of either kind spin
+      *      with backoff as pthread_spin_lock() does, and never
+      *      block. A writer that is waiting keeps new readers out
+      *      so that a stream of readers can't starve it.
+      *
+      * RESULTS
+      *              0               successfully initialised the lock,
+      *              EINVAL          'lock' is invalid,
+      *              ENOSYS          'pshared' is PTHREAD_PROCESS_SHARED,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_rwspinlock_np_t l;
+
+  if (lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (pshared == PTHREAD_PROCESS_SHARED)
+    {
+      return ENOSYS;
+    }
+
+  l = (pthread_rwspinlock_np_t) ptw32_object_alloc (sizeof (*l), ptw32_objectAlign);
+
+  if (l == NULL)
+    {
+      return ENOMEM;
+    }
+
+  l->state = PTW32_SPIN_UNLOCKED;
+  *lock = l;
+
+  return 0;
+}				/* pthread_rwspin_init_np */
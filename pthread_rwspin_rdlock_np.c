@@ -0,0 +1,176 @@
+/*
+ * pthread_rwspin_rdlock_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_rwspin_rdlock_np (pthread_rwspinlock_np_t * lock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Locks a reader-writer spin lock for reading, spinning
+      *      while a writer holds it or is waiting for it.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_rwspinlock_np_t
+      *
+      * RESULTS
+      *              0               the lock is held for reading,
+      *              EINVAL          'lock' is invalid,
+      *              EAGAIN          the lock has its maximum number
+      *                              of readers.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_rwspinlock_np_t l;
+  ptw32_rwspin_wait_t w = {0, 0, 0};
+  LONG s;
+
+  if (lock == NULL || *lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (*lock == PTHREAD_RWSPINLOCK_INITIALIZER_NP)
+    {
+      int result;
+
+      if ((result = ptw32_rwspin_check_need_init (lock)) != 0)
+	{
+	  return result;
+	}
+    }
+
+  l = *lock;
+
+  for (;;)
+    {
+      s = (LONG) PTW32_ATOMIC_LOAD_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->state);
+
+      if (PTW32_RWSPIN_READABLE (s))
+	{
+	  if (s >= PTW32_RWSPIN_MAX_STATE)
+	    {
+	      return EAGAIN;
+	    }
+	  if ((LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->state,
+							     (PTW32_INTERLOCKED_LONG) (s + PTW32_RWSPIN_READER),
+							     (PTW32_INTERLOCKED_LONG) s) == s)
+	    {
+	      return 0;
+	    }
+	  /* Another reader came or went: try again at once */
+	  continue;
+	}
+
+      if (s == PTW32_SPIN_INVALID)
+	{
+	  return EINVAL;
+	}
+
+      ptw32_rwspin_wait (l, s, &w);
+    }
+}				/* pthread_rwspin_rdlock_np */
+
+
+int
+pthread_rwspin_tryrdlock_np (pthread_rwspinlock_np_t * lock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Locks a reader-writer spin lock for reading if no
+      *      writer holds it or is waiting for it.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_rwspinlock_np_t
+      *
+      * RESULTS
+      *              0               the lock is held for reading,
+      *              EBUSY           a writer holds or is waiting for
+      *                              the lock,
+      *              EINVAL          'lock' is invalid,
+      *              EAGAIN          the lock has its maximum number
+      *                              of readers.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_rwspinlock_np_t l;
+  LONG s;
+
+  if (lock == NULL || *lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (*lock == PTHREAD_RWSPINLOCK_INITIALIZER_NP)
+    {
+      int result;
+
+      if ((result = ptw32_rwspin_check_need_init (lock)) != 0)
+	{
+	  return result;
+	}
+    }
+
+  l = *lock;
+
+  /*
+   * Only other readers changing the count make the exchange fail
+   * while the lock stays readable.
+   */
+  while (PTW32_RWSPIN_READABLE (s = (LONG) PTW32_ATOMIC_LOAD_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->state)))
+    {
+      if (s >= PTW32_RWSPIN_MAX_STATE)
+	{
+	  return EAGAIN;
+	}
+      if ((LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->state,
+							 (PTW32_INTERLOCKED_LONG) (s + PTW32_RWSPIN_READER),
+							 (PTW32_INTERLOCKED_LONG) s) == s)
+	{
+	  return 0;
+	}
+    }
+
+  return (s == PTW32_SPIN_INVALID) ? EINVAL : EBUSY;
+}				/* pthread_rwspin_tryrdlock_np */
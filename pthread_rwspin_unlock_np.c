@@ -0,0 +1,102 @@
+/*
+ * pthread_rwspin_unlock_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_rwspin_unlock_np (pthread_rwspinlock_np_t * lock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Unlocks a reader-writer spin lock held for reading or
+      *      writing.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_rwspinlock_np_t
+      *
+      * RESULTS
+      *              0               the lock is released,
+      *              EINVAL          'lock' is invalid,
+      *              EPERM           the lock isn't held.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_rwspinlock_np_t l;
+  LONG s;
+
+  if (lock == NULL || *lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (*lock == PTHREAD_RWSPINLOCK_INITIALIZER_NP)
+    {
+      return EPERM;
+    }
+
+  l = *lock;
+  s = (LONG) PTW32_ATOMIC_LOAD_RELAXED_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->state);
+
+  if (s == PTW32_SPIN_LOCKED)
+    {
+      /*
+       * Nobody else changes the state while a writer holds the lock.
+       */
+      PTW32_ATOMIC_STORE_REL_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->state,
+				   (PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED);
+      return 0;
+    }
+
+  if (s == PTW32_SPIN_INVALID)
+    {
+      return EINVAL;
+    }
+
+  if ((s & ~PTW32_RWSPIN_WRITER_WAITING) == PTW32_SPIN_UNLOCKED)
+    {
+      return EPERM;
+    }
+
+  (void) PTW32_ATOMIC_EXCHANGE_ADD_REL_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->state,
+					     (PTW32_INTERLOCKED_LONG) -PTW32_RWSPIN_READER);
+
+  return 0;
+}				/* pthread_rwspin_unlock_np */
@@ -0,0 +1,178 @@
+/*
+ * pthread_rwspin_wrlock_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_rwspin_wrlock_np (pthread_rwspinlock_np_t * lock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Locks a reader-writer spin lock for writing, spinning
+      *      while anyone else holds it.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_rwspinlock_np_t
+      *
+      * DESCRIPTION
+      *      While readers hold the lock the writer marks it
+      *      PTW32_RWSPIN_WRITER_WAITING, which keeps new readers
+      *      out until a writer has had it.
+      *
+      * RESULTS
+      *              0               the lock is held for writing,
+      *              EINVAL          'lock' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_rwspinlock_np_t l;
+  ptw32_rwspin_wait_t w = {0, 0, 0};
+  LONG s;
+
+  if (lock == NULL || *lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (*lock == PTHREAD_RWSPINLOCK_INITIALIZER_NP)
+    {
+      int result;
+
+      if ((result = ptw32_rwspin_check_need_init (lock)) != 0)
+	{
+	  return result;
+	}
+    }
+
+  l = *lock;
+
+  for (;;)
+    {
+      s = (LONG) PTW32_ATOMIC_LOAD_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->state);
+
+      if ((s & ~PTW32_RWSPIN_WRITER_WAITING) == PTW32_SPIN_UNLOCKED)
+	{
+	  if ((LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->state,
+							     (PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED,
+							     (PTW32_INTERLOCKED_LONG) s) == s)
+	    {
+	      return 0;
+	    }
+	  continue;
+	}
+
+      if (s == PTW32_SPIN_INVALID)
+	{
+	  return EINVAL;
+	}
+
+      /*
+       * Readers are in: keep more from joining them. A writer holding
+       * the lock is alone in the state, so there is nothing to mark.
+       * Other waiting writers that lose the lock to this one set the
+       * mark again.
+       */
+      if (s != PTW32_SPIN_LOCKED && 0 == (s & PTW32_RWSPIN_WRITER_WAITING))
+	{
+	  (void) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->state,
+							  (PTW32_INTERLOCKED_LONG) (s | PTW32_RWSPIN_WRITER_WAITING),
+							  (PTW32_INTERLOCKED_LONG) s);
+	  continue;
+	}
+
+      ptw32_rwspin_wait (l, s, &w);
+    }
+}				/* pthread_rwspin_wrlock_np */
+
+
+int
+pthread_rwspin_trywrlock_np (pthread_rwspinlock_np_t * lock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Locks a reader-writer spin lock for writing if nobody
+      *      holds it.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_rwspinlock_np_t
+      *
+      * RESULTS
+      *              0               the lock is held for writing,
+      *              EBUSY           the lock is held,
+      *              EINVAL          'lock' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_rwspinlock_np_t l;
+  LONG s;
+
+  if (lock == NULL || *lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (*lock == PTHREAD_RWSPINLOCK_INITIALIZER_NP)
+    {
+      int result;
+
+      if ((result = ptw32_rwspin_check_need_init (lock)) != 0)
+	{
+	  return result;
+	}
+    }
+
+  l = *lock;
+
+  while (((s = (LONG) PTW32_ATOMIC_LOAD_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->state))
+	  & ~PTW32_RWSPIN_WRITER_WAITING) == PTW32_SPIN_UNLOCKED)
+    {
+      if ((LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->state,
+							 (PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED,
+							 (PTW32_INTERLOCKED_LONG) s) == s)
+	{
+	  return 0;
+	}
+    }
+
+  return (s == PTW32_SPIN_INVALID) ? EINVAL : EBUSY;
+}				/* pthread_rwspin_trywrlock_np */
@@ -65,16 +65,17 @@ pthread_self (void)
       */
 {
   pthread_t self;
-  DWORD_PTR vThreadMask, vProcessMask, vSystemMask;
-  pthread_t nil = {NULL, 0};
   ptw32_thread_t * sp;
+#if defined(_UWIN)
+  pthread_t nil = {NULL, 0};
+#endif
 
 #if defined(_UWIN)
   if (!ptw32_selfThreadKey)
     return nil;
 #endif
 
-  sp = (ptw32_thread_t *) pthread_getspecific (ptw32_selfThreadKey);
+  sp = PTW32_SELF_THREAD ();
 
   if (sp != NULL)
     {
@@ -82,7 +83,6 @@ pthread_self (void)
     }
   else
     {
-	  int fail = PTW32_FALSE;
       /*
        * Need to create an implicit 'self' for the currently
        * executing thread.
@@ -113,65 +113,20 @@ pthread_self (void)
     	   * other threads for whatever purpose.
     	   */
     	  sp->threadH = GetCurrentThread ();
-#else
-    	  if (!DuplicateHandle (GetCurrentProcess (),
-				GetCurrentThread (),
-				GetCurrentProcess (),
-				&sp->threadH,
-				0, FALSE, DUPLICATE_SAME_ACCESS))
-    	    {
-    		  fail = PTW32_TRUE;
-    	    }
 #endif
 
-    	  if (!fail)
-    	    {
-
-#if defined(HAVE_CPU_AFFINITY)
-
-    	      /*
-    	       * Get this threads CPU affinity by temporarily setting the threads
-    	       * affinity to that of the process to get the old thread affinity,
-    	       * then reset to the old affinity.
-    	       */
-    	      if (GetProcessAffinityMask(GetCurrentProcess(), &vProcessMask, &vSystemMask))
-    	        {
-    	          vThreadMask = SetThreadAffinityMask(sp->threadH, vProcessMask);
-    	          if (vThreadMask)
-    	            {
-    	              if (SetThreadAffinityMask(sp->threadH, vThreadMask))
-    	                {
-    	                  sp->cpuset = (size_t) vThreadMask;
-    	                }
-    	              else fail = PTW32_TRUE;
-    	            }
-    	          else fail = PTW32_TRUE;
-    	        }
-    	      else fail = PTW32_TRUE;
-
-#endif
-
-    	      /*
-    	       * No need to explicitly serialise access to sched_priority
-    	       * because the new handle is not yet public.
-    	       */
-    	      sp->sched_priority = GetThreadPriority (sp->threadH);
-    	      pthread_setspecific (ptw32_selfThreadKey, (void *) sp);
-    	    }
-        }
-
-      if (fail)
-        {
     	  /*
-    	   * Thread structs are never freed but are reused so if this
-    	   * continues to fail at least we don't leak memory.
-    	   */
-    	  ptw32_threadReusePush (self);
-    	  /*
-    	   * As this is a win32 thread calling us and we have failed,
-    	   * return a value that makes sense to win32.
+    	   * Win32 threads that only want their errno or a TSD value
+    	   * never need a handle of their own or their CPU affinity,
+    	   * so ptw32_implicit_handle() and ptw32_implicit_affinity()
+    	   * get them on first use. sp->cpuset stays empty till then.
+    	   *
+    	   * No need to explicitly serialise access to sched_priority
+    	   * because the new handle is not yet public.
     	   */
-    	  return nil;
+    	  sp->sched_priority = GetThreadPriority (GetCurrentThread ());
+    	  pthread_setspecific (ptw32_selfThreadKey, (void *) sp);
+    	  PTW32_FLS_ATTACH (sp);
         }
     }
 
@@ -0,0 +1,93 @@
+/*
+ * pthread_seqlock_init_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_seqlock_init_np (pthread_seqlock_np_t * lock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Initialises a sequence lock.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_seqlock_np_t
+      *
+      * DESCRIPTION
+      *      A sequence lock protects small data that is read
+      *      far more often than it is written. Writers exclude
+      *      each other; readers never wait for the lock or write
+      *      to it, but repeat their read if a writer was active
+      *      (see pthread_seqlock_read_begin_np).
+      *
+      * RESULTS
+      *              0               successfully initialised the lock,
+      *              EINVAL          'lock' is invalid,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_seqlock_np_t s;
+  int result;
+
+  if (lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  s = (pthread_seqlock_np_t) ptw32_object_alloc (sizeof (*s), ptw32_objectAlign);
+
+  if (s == NULL)
+    {
+      return ENOMEM;
+    }
+
+  s->sequence = 0;
+
+  if (0 != (result = pthread_mutex_init (&s->writers, NULL)))
+    {
+      ptw32_object_free (s);
+      return result;
+    }
+
+  *lock = s;
+
+  return 0;
+}				/* pthread_seqlock_init_np */
@@ -0,0 +1,144 @@
+/*
+ * pthread_seqlock_read_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_seqlock_read_begin_np (pthread_seqlock_np_t lock, unsigned int * seq)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Starts reading the data a sequence lock protects.
+      *
+      * PARAMETERS
+      *      lock
+      *              an instance of pthread_seqlock_np_t
+      *
+      *      seq
+      *              receives the sequence to pass to
+      *              pthread_seqlock_read_retry_np()
+      *
+      * DESCRIPTION
+      *      Waits, without blocking on the lock, until no writer
+      *      is active. The reader then copies the data and calls
+      *      pthread_seqlock_read_retry_np(), starting again if
+      *      that returns EAGAIN:
+      *
+      *        do
+      *          {
+      *            pthread_seqlock_read_begin_np (lock, &seq);
+      *            copy = shared;
+      *          }
+      *        while (pthread_seqlock_read_retry_np (lock, seq) != 0);
+      *
+      *      A writer may change the data during the copy, so the
+      *      copy must not be acted on (pointers followed, sizes
+      *      trusted) until the retry check has passed.
+      *
+      * RESULTS
+      *              0               *seq is set,
+      *              EINVAL          'lock' or 'seq' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG sequence;
+  int spins = 0;
+  int yields = 0;
+
+  if (lock == NULL || seq == NULL)
+    {
+      return EINVAL;
+    }
+
+  while (((sequence = lock->sequence) & 1) != 0)
+    {
+      if (++spins < PTW32_SEQLOCK_SPIN)
+	{
+	  PTW32_YIELD_PROCESSOR ();
+	}
+      else
+	{
+	  ptw32_yield (&yields);
+	}
+    }
+
+  /* The reader's loads of the data come after this one */
+  PTW32_READ_FENCE ();
+
+  *seq = (unsigned int) sequence;
+
+  return 0;
+}				/* pthread_seqlock_read_begin_np */
+
+
+int
+pthread_seqlock_read_retry_np (pthread_seqlock_np_t lock, unsigned int seq)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Ends a read started with
+      *      pthread_seqlock_read_begin_np().
+      *
+      * PARAMETERS
+      *      lock
+      *              an instance of pthread_seqlock_np_t
+      *
+      *      seq
+      *              the sequence pthread_seqlock_read_begin_np()
+      *              returned
+      *
+      * RESULTS
+      *              0               the data read is consistent,
+      *              EAGAIN          a writer changed the data; read
+      *                              it again,
+      *              EINVAL          'lock' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  /* The data loads complete before the sequence is read again */
+  PTW32_READ_FENCE ();
+
+  return ((unsigned int) lock->sequence == seq) ? 0 : EAGAIN;
+}				/* pthread_seqlock_read_retry_np */
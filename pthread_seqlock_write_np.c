@@ -0,0 +1,115 @@
+/*
+ * pthread_seqlock_write_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_seqlock_write_lock_np (pthread_seqlock_np_t lock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Locks a sequence lock for writing.
+      *
+      * PARAMETERS
+      *      lock
+      *              an instance of pthread_seqlock_np_t
+      *
+      * DESCRIPTION
+      *      Waits for other writers, then makes the sequence odd
+      *      so readers that start now wait and readers already
+      *      copying retry.
+      *
+      * RESULTS
+      *              0               the lock is held for writing,
+      *              EINVAL          'lock' is invalid,
+      *              other           as for pthread_mutex_lock().
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result;
+
+  if (lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (0 != (result = pthread_mutex_lock (&lock->writers)))
+    {
+      return result;
+    }
+
+  /*
+   * Interlocked operations are full barriers, so the odd sequence is
+   * visible before any of the writer's stores.
+   */
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &lock->sequence);
+
+  return 0;
+}				/* pthread_seqlock_write_lock_np */
+
+
+int
+pthread_seqlock_write_unlock_np (pthread_seqlock_np_t lock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Unlocks a sequence lock held for writing.
+      *
+      * PARAMETERS
+      *      lock
+      *              an instance of pthread_seqlock_np_t
+      *
+      * RESULTS
+      *              0               the lock is released,
+      *              EINVAL          'lock' is invalid,
+      *              other           as for pthread_mutex_unlock().
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  /* Publishes the writer's stores along with the even sequence */
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &lock->sequence);
+
+  return pthread_mutex_unlock (&lock->writers);
+}				/* pthread_seqlock_write_unlock_np */
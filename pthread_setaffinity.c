@@ -58,8 +58,9 @@ pthread_setaffinity_np (pthread_t thread, size_t cpusetsize,
       *					The target thread
       *
       *		cpusetsize
-      *					Ignored in pthreads4w.
+      *					The size of cpuset.
       *					Usually set to sizeof(cpu_set_t)
+      *					CPUs beyond it are taken to be clear.
       *
       *		cpuset
       *					The new cpu set mask.
@@ -75,6 +76,10 @@ pthread_setaffinity_np (pthread_t thread, size_t cpusetsize,
       *   call is successful, and the thread is not currently running on one
       *   of the CPUs in cpuset, then it is migrated to one of those CPUs.
       *
+      *   A Win32 thread runs in one processor group at a time. If cpuset
+      *   spans several groups the thread stays in its current group when
+      *   cpuset has CPUs there, or is otherwise moved to one of the others.
+      *
       * RESULTS
       * 				0		Success
       * 				ESRCH	Thread does not exist
@@ -100,7 +105,7 @@ pthread_setaffinity_np (pthread_t thread, size_t cpusetsize,
 
   tp = (ptw32_thread_t *) thread.p;
 
-  if (NULL == tp || thread.x != tp->ptHandle.x || NULL == tp->threadH)
+  if (NULL == tp || thread.x != tp->ptHandle.x || NULL == PTW32_THREAD_HANDLE (tp))
     {
 	  result = ESRCH;
     }
@@ -108,22 +113,21 @@ pthread_setaffinity_np (pthread_t thread, size_t cpusetsize,
 	{
 	  if (cpuset)
 		{
-		  if (sched_getaffinity(0, sizeof(cpu_set_t), &processCpuset))
-		    {
-			  result = PTW32_GET_ERRNO();
-		    }
-		  else
+		  result = ptw32_getprocessaffinity(&processCpuset);
+
+		  if (0 == result)
 			{
 			  /*
 			   * Result is the intersection of available CPUs and the mask.
 			   */
 			  cpu_set_t newMask;
 
-			  CPU_AND(&newMask, &processCpuset, cpuset);
+			  ptw32_cpusetcopy(&newMask, sizeof(newMask), cpuset, cpusetsize);
+			  CPU_AND(&newMask, &processCpuset, &newMask);
 
-			  if (((_sched_cpu_set_vector_*)&newMask)->_cpuset)
+			  if (CPU_COUNT(&newMask) > 0)
 				{
-				  if (SetThreadAffinityMask (tp->threadH, ((_sched_cpu_set_vector_*)&newMask)->_cpuset))
+				  if (0 == (result = ptw32_setthreadaffinity (tp->threadH, &newMask, PTW32_FALSE)))
 					{
 					  /*
 					   * We record the intersection of the process affinity
@@ -131,11 +135,7 @@ pthread_setaffinity_np (pthread_t thread, size_t cpusetsize,
 					   * pthread_getaffinity_np() returns the actual thread
 					   * CPU set.
 					   */
-					  tp->cpuset = ((_sched_cpu_set_vector_*)&newMask)->_cpuset;
-					}
-				  else
-					{
-					  result = EAGAIN;
+					  tp->cpuset = newMask;
 					}
 				}
 			  else
@@ -170,8 +170,9 @@ pthread_getaffinity_np (pthread_t thread, size_t cpusetsize, cpu_set_t *cpuset)
       *					The target thread
       *
       *		cpusetsize
-      *					Ignored in pthreads4w.
+      *					The size of cpuset.
       *					Usually set to sizeof(cpu_set_t)
+      *					CPUs beyond it are not returned.
       *
       *		cpuset
       *					The location where the current cpu set
@@ -205,7 +206,7 @@ pthread_getaffinity_np (pthread_t thread, size_t cpusetsize, cpu_set_t *cpuset)
 
   tp = (ptw32_thread_t *) thread.p;
 
-  if (NULL == tp || thread.x != tp->ptHandle.x || NULL == tp->threadH)
+  if (NULL == tp || thread.x != tp->ptHandle.x || NULL == PTW32_THREAD_HANDLE (tp))
     {
 	  result = ESRCH;
     }
@@ -213,21 +214,36 @@ pthread_getaffinity_np (pthread_t thread, size_t cpusetsize, cpu_set_t *cpuset)
     {
 	  if (cpuset)
 	    {
-		  if (tp->cpuset)
+		  cpu_set_t threadCpuset;
+
+		  if (tp->implicit && 0 == CPU_COUNT(&tp->cpuset))
+		    {
+			  ptw32_implicit_affinity (tp);
+		    }
+
+		  if (CPU_COUNT(&tp->cpuset) > 0
+		      && 0 == ptw32_getthreadaffinity(tp->threadH, &threadCpuset))
 		    {
 			  /*
 			   * The application may have set thread affinity independently
-			   * via SetThreadAffinityMask(). If so, we adjust our record of the threads
-			   * affinity and try to do so in a reasonable way.
+			   * via SetThreadAffinityMask() or SetThreadGroupAffinity(). If so,
+			   * we adjust our record of the threads affinity and try to do so
+			   * in a reasonable way. We left the thread on all the CPUs in our
+			   * record for the one group it runs in.
 			   */
-			  DWORD_PTR vThreadMask = SetThreadAffinityMask(tp->threadH, tp->cpuset);
-			  if (vThreadMask && vThreadMask != tp->cpuset)
+			  size_t * recorded = ((_sched_cpu_set_vector_*)&tp->cpuset)->_cpuset;
+			  size_t * actual = ((_sched_cpu_set_vector_*)&threadCpuset)->_cpuset;
+			  int group;
+
+			  for (group = 0; group < PTW32_CPU_SET_GROUPS && 0 == actual[group]; group++)
+			    {
+			    }
+			  if (group < PTW32_CPU_SET_GROUPS && actual[group] != recorded[group])
 			    {
-				  (void) SetThreadAffinityMask(tp->threadH, vThreadMask);
-				  tp->cpuset = vThreadMask;
+				  tp->cpuset = threadCpuset;
 			    }
 		    }
-		  ((_sched_cpu_set_vector_*)cpuset)->_cpuset = tp->cpuset;
+		  ptw32_cpusetcopy(cpuset, cpusetsize, &tp->cpuset, sizeof(cpu_set_t));
 		}
 	  else
 	    {
@@ -102,11 +102,21 @@ pthread_setcancelstate (int state, int *oldstate)
 
   sp->cancelState = state;
 
+  if (state == PTHREAD_CANCEL_DISABLE)
+    {
+      ptw32_testcancel_lower (sp, PTW32_TESTCANCEL_CANCEL);
+    }
+  else if (sp->state == PThreadStateCancelPending)
+    {
+      ptw32_testcancel_raise (sp, PTW32_TESTCANCEL_CANCEL);
+    }
+
   /*
    * Check if there is a pending asynchronous cancel
    */
   if (state == PTHREAD_CANCEL_ENABLE
       && sp->cancelType == PTHREAD_CANCEL_ASYNCHRONOUS
+      && sp->cancelEvent != NULL
       && WaitForSingleObject (sp->cancelEvent, 0) == WAIT_OBJECT_0)
     {
       sp->state = PThreadStateCanceling;
@@ -91,6 +91,12 @@ pthread_setcanceltype (int type, int *oldtype)
       return EINVAL;
     }
 
+  if (type == PTHREAD_CANCEL_ASYNCHRONOUS)
+    {
+      /* So that cancelling us later doesn't have to */
+      ptw32_cancel_initialize ();
+    }
+
   /*
    * Lock for async-cancel safety.
    */
@@ -108,6 +114,7 @@ pthread_setcanceltype (int type, int *oldtype)
    */
   if (sp->cancelState == PTHREAD_CANCEL_ENABLE
       && type == PTHREAD_CANCEL_ASYNCHRONOUS
+      && sp->cancelEvent != NULL
       && WaitForSingleObject (sp->cancelEvent, 0) == WAIT_OBJECT_0)
     {
       sp->state = PThreadStateCanceling;
@@ -48,6 +48,9 @@ pthread_setconcurrency (int level)
   else
     {
       ptw32_concurrency = level;
+
+      /* Sets the number of PTHREAD_SCOPE_PROCESS workers */
+      ptw32_fiber_workers ();
       return 0;
     }
 }
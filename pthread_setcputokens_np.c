@@ -0,0 +1,116 @@
+/*
+ * pthread_setcputokens_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_setcputokens_np (int tokens)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets how many processor tokens the process has.
+      *
+      * PARAMETERS
+      *      tokens
+      *              PTHREAD_CPUTOKENS_OFF_NP
+      *                      no limit: taking tokens never
+      *                      waits (the default).
+      *
+      *              PTHREAD_CPUTOKENS_PROCESSORS_NP
+      *                      as many as pthread_num_processors_np()
+      *                      gives now.
+      *
+      *              1 or more
+      *                      that many.
+      *
+      * DESCRIPTION
+      *      While there is a limit, pool workers wait for a
+      *      token before running tasks, and give it back while
+      *      they are idle or blocked in the library, and
+      *      pthread_cputokens_acquire_np() waits for the
+      *      tokens it needs. Tokens held when the limit changes
+      *      stay held, so lowering it only takes effect as they
+      *      are given back.
+      *
+      * RESULTS
+      *              0               successfully set the tokens,
+      *              EINVAL          'tokens' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG total;
+  LONG old;
+
+  if (tokens < PTHREAD_CPUTOKENS_OFF_NP)
+    {
+      return EINVAL;
+    }
+
+  if (tokens == PTHREAD_CPUTOKENS_OFF_NP)
+    {
+      total = 0;
+    }
+  else if (tokens == PTHREAD_CPUTOKENS_PROCESSORS_NP)
+    {
+      total = (LONG) pthread_num_processors_np ();
+      if (total < 1)
+        {
+          total = 1;
+        }
+    }
+  else
+    {
+      total = (LONG) tokens;
+    }
+
+  ptw32_cpuTokens = tokens;
+
+  old = (LONG) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_cpuTokensTotal,
+                                               (PTW32_INTERLOCKED_LONG) total);
+  (void) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_cpuTokensFree,
+                                             (PTW32_INTERLOCKED_LONG) (total - old));
+
+  /* Waiters look again, whether there are more tokens or no limit */
+  if (ptw32_wakebyaddressall != NULL)
+    {
+      ptw32_wakebyaddressall ((PVOID) &ptw32_cpuTokensFree);
+    }
+
+  return 0;
+}				/* pthread_setcputokens_np */
@@ -54,8 +54,13 @@ typedef struct tagTHREADNAME_INFO
 } THREADNAME_INFO;
 #pragma pack(pop)
 
-void
-SetThreadName( DWORD dwThreadID, char* threadName)
+/*
+ * The old way of naming a thread for an attached MSVC debugger. It is
+ * only used where SetThreadDescription is unavailable: the exception
+ * is slow and debuggers and profilers stop on it.
+ */
+static void
+SetThreadName( DWORD dwThreadID, const char* threadName)
 {
   THREADNAME_INFO info;
   info.dwType = 0x1000;
@@ -81,12 +86,7 @@ pthread_setname_np(pthread_t thr, const char *name, void *arg)
   int len;
   int result;
   char tmpbuf[PTHREAD_MAX_NAMELEN_NP];
-  char * newname;
-  char * oldname;
   ptw32_thread_t * tp;
-#if defined(_MSC_VER)
-  DWORD Win32ThreadID;
-#endif
 
   /* Validate the thread id. */
   result = pthread_kill (thr, 0);
@@ -111,26 +111,12 @@ pthread_setname_np(pthread_t thr, const char *name, void *arg)
       return EINVAL;
     }
 
-  newname = _strdup(tmpbuf);
-
-#if defined(_MSC_VER)
-  Win32ThreadID = pthread_getw32threadid_np (thr);
-  if (Win32ThreadID)
-    {
-      SetThreadName(Win32ThreadID, newname);
-    }
-#endif
-
   tp = (ptw32_thread_t *) thr.p;
 
   ptw32_mcs_lock_acquire (&tp->threadLock, &threadLock);
 
-  oldname = tp->name;
-  tp->name = newname;
-  if (oldname)
-    {
-      free(oldname);
-    }
+  memcpy(tp->name, tmpbuf, sizeof(tp->name));
+  ptw32_setthreadname (tp);
 
   ptw32_mcs_lock_release (&threadLock);
 
@@ -142,12 +128,7 @@ pthread_setname_np(pthread_t thr, const char *name)
 {
   ptw32_mcs_local_node_t threadLock;
   int result;
-  char * newname;
-  char * oldname;
   ptw32_thread_t * tp;
-#if defined(_MSC_VER)
-  DWORD Win32ThreadID;
-#endif
 
   /* Validate the thread id. */
   result = pthread_kill (thr, 0);
@@ -156,30 +137,51 @@ pthread_setname_np(pthread_t thr, const char *name)
       return result;
     }
 
-  newname = _strdup(name);
-
-#if defined(_MSC_VER)
-  Win32ThreadID = pthread_getw32threadid_np (thr);
-
-  if (Win32ThreadID)
-    {
-      SetThreadName(Win32ThreadID, newname);
-    }
-#endif
-
   tp = (ptw32_thread_t *) thr.p;
 
   ptw32_mcs_lock_acquire (&tp->threadLock, &threadLock);
 
-  oldname = tp->name;
-  tp->name = newname;
-  if (oldname)
-    {
-      free(oldname);
-    }
+  /* Longer names are truncated, as they always have been */
+  strncpy(tp->name, name, sizeof(tp->name) - 1);
+  tp->name[sizeof(tp->name) - 1] = '\0';
+  ptw32_setthreadname (tp);
 
   ptw32_mcs_lock_release (&threadLock);
 
   return 0;
 }
 #endif
+
+
+void
+ptw32_setthreadname (ptw32_thread_t * tp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Gives the OS thread running tp the name in tp->name,
+      *      which is taken as UTF-8. The caller holds
+      *      tp->threadLock, or tp has not started running.
+      *      Failures are ignored, the name is for debuggers,
+      *      profilers and crash dumps.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (NULL != ptw32_setthreaddescription)
+    {
+      WCHAR wname[PTHREAD_MAX_NAMELEN_NP];
+
+      /* UTF-8 never has fewer bytes than UTF-16 has units */
+      if (0 != MultiByteToWideChar (CP_UTF8, 0, tp->name, -1,
+				    wname, PTHREAD_MAX_NAMELEN_NP))
+	{
+	  (void) ptw32_setthreaddescription (PTW32_THREAD_HANDLE (tp), wname);
+	}
+    }
+#if defined(_MSC_VER)
+  else if (0 != tp->thread && IsDebuggerPresent ())
+    {
+      SetThreadName ((DWORD) tp->thread, tp->name);
+    }
+#endif
+}
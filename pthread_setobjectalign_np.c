@@ -0,0 +1,87 @@
+/*
+ * pthread_setobjectalign_np.c
+ *
+ * Description:
+ * This translation unit implements miscellaneous thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_setobjectalign_np (int align)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets the boundary that mutexes, condition variables,
+      *      read/write locks, spin locks, semaphores and barriers
+      *      are allocated on.
+      *
+      * PARAMETERS
+      *      align
+      *              0 (PTHREAD_OBJECT_ALIGN_DEFAULT_NP) for the
+      *              allocator's own alignment, or a power of two
+      *              no larger than 4096. Use
+      *              PTHREAD_OBJECT_ALIGN_CACHELINE_NP (64) to keep
+      *              each object on cache lines of its own, or
+      *              PTHREAD_OBJECT_ALIGN_SECTOR_NP (128) to also
+      *              keep it clear of the line that the adjacent
+      *              sector prefetcher fetches with it.
+      *
+      * DESCRIPTION
+      *      Objects are padded to a multiple of the alignment,
+      *      so two objects never share a cache line and busy
+      *      locks don't slow each other down. This costs memory
+      *      and only pays for objects that are hot on several
+      *      processors. Objects initialised before the call keep
+      *      their placement. Objects initialised with the static
+      *      initialisers are allocated when first used. The
+      *      default is PTHREAD_OBJECT_ALIGN_DEFAULT_NP.
+      *
+      * RESULTS
+      *              0               successfully set the alignment,
+      *              EINVAL          'align' is not 0 or a power of
+      *                              two up to 4096.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (align < 0 || align > 4096 || (align & (align - 1)) != 0)
+    {
+      return EINVAL;
+    }
+
+  ptw32_objectAlign = align;
+
+  return 0;
+}				/* pthread_setobjectalign_np */
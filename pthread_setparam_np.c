@@ -0,0 +1,342 @@
+/*
+ * pthread_setparam_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include <stdlib.h>
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * The environment variable read for each parameter, in the order of
+ * the PTHREAD_PARAM_*_NP values.
+ */
+static const char * const ptw32_paramNames[] =
+{
+  "PTW32_MUTEX_SPIN",
+  "PTW32_MCS_SPIN",
+  "PTW32_SPIN_BACKOFF",
+  "PTW32_THREAD_REUSE",
+  "PTW32_THREAD_CACHE",
+  "PTW32_TIMER_SLACK",
+  "PTW32_YIELD_MODE",
+  "PTW32_OBJECT_ALIGN",
+  "PTW32_CONCURRENCY",
+  "PTW32_HIRES_WAIT",
+  "PTW32_CPU_TOKENS",
+  "PTW32_LARGE_PAGES",
+  "PTW32_WAKE_BOOST"
+};
+
+#define PTW32_PARAM_COUNT \
+  ((int) (sizeof (ptw32_paramNames) / sizeof (ptw32_paramNames[0])))
+
+
+int
+pthread_setparam_np (int param, long value)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets one of the library's process wide tunables.
+      *
+      * PARAMETERS
+      *      param
+      *              one of the PTHREAD_PARAM_*_NP values
+      *
+      *      value
+      *              the new value
+      *
+      * DESCRIPTION
+      *      Parameters that have a setter of their own are set
+      *      through it, with its checks and effects:
+      *
+      *      PTHREAD_PARAM_MUTEX_SPIN_NP
+      *              pthread_mutex_setdefaultspin_np()
+      *      PTHREAD_PARAM_THREAD_REUSE_NP
+      *              pthread_setthreadreuse_np()
+      *      PTHREAD_PARAM_THREAD_CACHE_NP
+      *              pthread_setthreadcache_np()
+      *      PTHREAD_PARAM_TIMER_SLACK_NP
+      *              pthread_settimerslack_np()
+      *      PTHREAD_PARAM_YIELD_MODE_NP
+      *              pthread_setyieldmode_np()
+      *      PTHREAD_PARAM_OBJECT_ALIGN_NP
+      *              pthread_setobjectalign_np()
+      *      PTHREAD_PARAM_CONCURRENCY_NP
+      *              pthread_setconcurrency()
+      *      PTHREAD_PARAM_CPU_TOKENS_NP
+      *              pthread_setcputokens_np()
+      *
+      *      The others have none:
+      *
+      *      PTHREAD_PARAM_MCS_SPIN_NP
+      *              how many times a thread waiting for one of the
+      *              library's internal locks polls it before it
+      *              blocks (0: it blocks at once). The initial
+      *              value is the polls that take about 4us on
+      *              this processor on multi-processor systems,
+      *              and 0 otherwise (see ptw32_spin_calibrate.c).
+      *      PTHREAD_PARAM_SPIN_BACKOFF_NP
+      *              the most processor pause hints a contended
+      *              spin lock waits between attempts, at least 1.
+      *              The wait doubles up to this from 1. The
+      *              initial value is the hints that take about
+      *              4us on this processor.
+      *      PTHREAD_PARAM_HIRES_WAIT_NP
+      *              1 (initially) if timed waits may end on a high
+      *              resolution waitable timer where the system has
+      *              them, 0 to time them all in milliseconds as
+      *              ptw32_relmillisecs() gives them.
+      *      PTHREAD_PARAM_LARGE_PAGES_NP
+      *              1 to cut the slabs synchronisation objects
+      *              come from, and thread structs, from large
+      *              pages where the process may lock them in
+      *              memory, 0 (initially) for the heap. Getting it
+      *              gives 0 while large pages can't be had, see
+      *              ptw32_largepage.c.
+      *      PTHREAD_PARAM_WAKE_BOOST_NP
+      *              1 (initially) if threads the library creates
+      *              get Windows' priority boost when woken, 0 to
+      *              create them without it, see
+      *              pthread_setwakeboost_np.c.
+      *
+      *      Each parameter's initial value can be overridden
+      *      from the environment when the process attaches the
+      *      library, see README.NONPORTABLE.
+      *
+      * RESULTS
+      *              0               successfully set the parameter,
+      *              EINVAL          'param' or 'value' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (value < INT_MIN || value > INT_MAX)
+    {
+      return EINVAL;
+    }
+
+  switch (param)
+    {
+    case PTHREAD_PARAM_MUTEX_SPIN_NP:
+      return pthread_mutex_setdefaultspin_np ((int) value);
+
+    case PTHREAD_PARAM_MCS_SPIN_NP:
+      if (value < 0)
+        {
+          return EINVAL;
+        }
+      ptw32_mcs_spin_limit = (int) value;
+      return 0;
+
+    case PTHREAD_PARAM_SPIN_BACKOFF_NP:
+      if (value < 1)
+        {
+          return EINVAL;
+        }
+      ptw32_spinBackoffLimit = (int) value;
+      return 0;
+
+    case PTHREAD_PARAM_THREAD_REUSE_NP:
+      return pthread_setthreadreuse_np ((int) value);
+
+    case PTHREAD_PARAM_THREAD_CACHE_NP:
+      return pthread_setthreadcache_np ((int) value);
+
+    case PTHREAD_PARAM_TIMER_SLACK_NP:
+      return pthread_settimerslack_np (value);
+
+    case PTHREAD_PARAM_YIELD_MODE_NP:
+      return pthread_setyieldmode_np ((int) value);
+
+    case PTHREAD_PARAM_OBJECT_ALIGN_NP:
+      return pthread_setobjectalign_np ((int) value);
+
+    case PTHREAD_PARAM_CONCURRENCY_NP:
+      return pthread_setconcurrency ((int) value);
+
+    case PTHREAD_PARAM_CPU_TOKENS_NP:
+      return pthread_setcputokens_np ((int) value);
+
+    case PTHREAD_PARAM_LARGE_PAGES_NP:
+      if (value != 0 && value != 1)
+        {
+          return EINVAL;
+        }
+      ptw32_largePages = (int) value;
+      return 0;
+
+    case PTHREAD_PARAM_HIRES_WAIT_NP:
+      if (value != 0 && value != 1)
+        {
+          return EINVAL;
+        }
+      ptw32_hiresWait = (int) value;
+      return 0;
+
+    case PTHREAD_PARAM_WAKE_BOOST_NP:
+      if (value != 0 && value != 1)
+        {
+          return EINVAL;
+        }
+      ptw32_wakeBoost = (int) value;
+      return 0;
+    }
+
+  return EINVAL;
+}				/* pthread_setparam_np */
+
+
+int
+pthread_getparam_np (int param, long *value)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns one of the library's process wide tunables.
+      *
+      * PARAMETERS
+      *      param
+      *              one of the PTHREAD_PARAM_*_NP values
+      *
+      *      value
+      *              pointer to a long to receive the value, as
+      *              pthread_setparam_np() or the parameter's own
+      *              setter left it.
+      *
+      * RESULTS
+      *              0               successfully retrieved the value,
+      *              EINVAL          'param' or 'value' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (value == NULL)
+    {
+      return EINVAL;
+    }
+
+  switch (param)
+    {
+    case PTHREAD_PARAM_MUTEX_SPIN_NP:
+      *value = ptw32_mutex_default_spin;
+      return 0;
+
+    case PTHREAD_PARAM_MCS_SPIN_NP:
+      *value = ptw32_mcs_spin_limit;
+      return 0;
+
+    case PTHREAD_PARAM_SPIN_BACKOFF_NP:
+      *value = ptw32_spinBackoffLimit;
+      return 0;
+
+    case PTHREAD_PARAM_THREAD_REUSE_NP:
+      *value = ptw32_threadReuseMax;
+      return 0;
+
+    case PTHREAD_PARAM_THREAD_CACHE_NP:
+      *value = ptw32_threadCacheMax;
+      return 0;
+
+    case PTHREAD_PARAM_TIMER_SLACK_NP:
+      return pthread_gettimerslack_np (value);
+
+    case PTHREAD_PARAM_YIELD_MODE_NP:
+      *value = ptw32_yield_mode;
+      return 0;
+
+    case PTHREAD_PARAM_OBJECT_ALIGN_NP:
+      *value = ptw32_objectAlign;
+      return 0;
+
+    case PTHREAD_PARAM_CONCURRENCY_NP:
+      *value = ptw32_concurrency;
+      return 0;
+
+    case PTHREAD_PARAM_HIRES_WAIT_NP:
+      *value = ptw32_hiresWait;
+      return 0;
+
+    case PTHREAD_PARAM_CPU_TOKENS_NP:
+      *value = ptw32_cpuTokens;
+      return 0;
+
+    case PTHREAD_PARAM_LARGE_PAGES_NP:
+      *value = ptw32_largepage_available ();
+      return 0;
+
+    case PTHREAD_PARAM_WAKE_BOOST_NP:
+      *value = ptw32_wakeBoost;
+      return 0;
+    }
+
+  return EINVAL;
+}				/* pthread_getparam_np */
+
+
+void
+ptw32_param_environment (void)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Sets the parameters that the environment gives a
+      *      decimal value for, as pthread_setparam_np() would.
+      *      Called once when the process initialises the library;
+      *      variables that aren't a number, or whose value the
+      *      setter rejects, are ignored.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if ! defined(WINCE)
+  int param;
+
+  for (param = 0; param < PTW32_PARAM_COUNT; param++)
+    {
+      char buf[32];
+      DWORD n = GetEnvironmentVariableA (ptw32_paramNames[param], buf, sizeof (buf));
+
+      if (n > 0 && n < sizeof (buf))
+        {
+          char * end;
+          long value = strtol (buf, &end, 10);
+
+          if (end != buf && '\0' == *end)
+            {
+              (void) pthread_setparam_np (param, value);
+            }
+        }
+    }
+#endif
+}
@@ -0,0 +1,133 @@
+/*
+ * pthread_setqos_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_setqos_np (pthread_t thread, int qos)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Changes the quality of service of a thread.
+      *
+      * PARAMETERS
+      *      thread
+      *              the target thread
+      *
+      *      qos
+      *              PTHREAD_QOS_DEFAULT_NP, PTHREAD_QOS_HIGH_NP or
+      *              PTHREAD_QOS_EFFICIENCY_NP
+      *
+      * DESCRIPTION
+      *      PTHREAD_QOS_EFFICIENCY_NP turns on power throttling
+      *      (EcoQoS) for the thread, which Windows then runs at a
+      *      lower clock speed and prefers to run on efficiency
+      *      cores. PTHREAD_QOS_HIGH_NP keeps the thread from ever
+      *      being throttled, and PTHREAD_QOS_DEFAULT_NP leaves it
+      *      to the system again. Unlike pthread_attr_setqos_np(),
+      *      this doesn't change the thread's CPU affinity. The
+      *      QoS has no effect before Windows 10 version 1709 or
+      *      on a fiber thread, but is still recorded.
+      *
+      * RESULTS
+      *              0               successfully set the QoS,
+      *              EINVAL          'qos' is invalid,
+      *              ESRCH           'thread' does not exist.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result;
+  ptw32_thread_t * tp = (ptw32_thread_t *) thread.p;
+  ptw32_mcs_local_node_t threadLock;
+
+  /* Validate the thread id. */
+  if (0 != (result = pthread_kill (thread, 0)))
+    {
+      return result;
+    }
+
+  if (qos < PTHREAD_QOS_DEFAULT_NP || qos > PTHREAD_QOS_EFFICIENCY_NP)
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_lock_acquire (&tp->threadLock, &threadLock);
+
+  tp->qos = qos;
+
+  if (NULL == tp->fiber.handle)
+    {
+      ptw32_setthreadqos (PTW32_THREAD_HANDLE (tp), qos);
+    }
+
+  ptw32_mcs_lock_release (&threadLock);
+
+  return 0;
+}
+
+
+void
+ptw32_setthreadqos (HANDLE threadH, int qos)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Sets the power throttling of a thread for the QoS
+      *      DEFAULT: under system control, HIGH: off,
+      *      EFFICIENCY: on. Failures are ignored, the QoS is
+      *      a hint.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_power_throttling_t state;
+
+  if (NULL == ptw32_setthreadinformation)
+    {
+      return;
+    }
+
+  state.Version = PTW32_POWER_THROTTLING_VERSION;
+  state.ControlMask = (PTHREAD_QOS_DEFAULT_NP == qos
+		       ? 0 : PTW32_POWER_THROTTLING_EXECUTION_SPEED);
+  state.StateMask = (PTHREAD_QOS_EFFICIENCY_NP == qos
+		     ? PTW32_POWER_THROTTLING_EXECUTION_SPEED : 0);
+
+  (void) ptw32_setthreadinformation (threadH, PTW32_THREAD_POWER_THROTTLING,
+				     &state, sizeof (state));
+}
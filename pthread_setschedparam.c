@@ -57,39 +57,44 @@ pthread_setschedparam (pthread_t thread, int policy,
       return EINVAL;
     }
 
-  /* Ensure the policy is SCHED_OTHER. */
-  if (policy != SCHED_OTHER)
-    {
-      return ENOTSUP;
-    }
-
   return (ptw32_setthreadpriority (thread, policy, param->sched_priority));
 }
 
 
-int
-ptw32_setthreadpriority (pthread_t thread, int policy, int priority)
+/*
+ * The Win32 thread priority to run a thread of sched_priority 'prio' at.
+ */
+static INLINE int
+ptw32_win32_priority (int prio)
 {
-  int prio;
-  ptw32_mcs_local_node_t threadLock;
-  int result = 0;
-  ptw32_thread_t * tp = (ptw32_thread_t *) thread.p;
-
-  prio = priority;
-
-  /* Validate priority level. */
-  if (prio < sched_get_priority_min (policy) ||
-      prio > sched_get_priority_max (policy))
-    {
-      return EINVAL;
-    }
-
 #if (THREAD_PRIORITY_LOWEST > THREAD_PRIORITY_NORMAL)
 /* WinCE */
 #else
 /* Everything else */
 
-  if (THREAD_PRIORITY_IDLE < prio && THREAD_PRIORITY_LOWEST > prio)
+  if (PTW32_SCHED_RT_PRIORITY_MIN <= prio)
+    {
+      /*
+       * A SCHED_FIFO or SCHED_RR priority. Only REALTIME_PRIORITY_CLASS
+       * has a thread priority for each level: base 24 is
+       * THREAD_PRIORITY_NORMAL and levels 17 to 30 are contiguous.
+       * In any other class the best that can be done is the top level.
+       */
+      if (REALTIME_PRIORITY_CLASS != GetPriorityClass (GetCurrentProcess ())
+	  || PTW32_SCHED_RT_PRIORITY_MAX <= prio)
+	{
+	  prio = THREAD_PRIORITY_TIME_CRITICAL;
+	}
+      else if (PTW32_SCHED_RT_PRIORITY_MIN == prio)
+	{
+	  prio = THREAD_PRIORITY_IDLE;
+	}
+      else
+	{
+	  prio -= PTW32_SCHED_RT_PRIORITY_MIN + 8;
+	}
+    }
+  else if (THREAD_PRIORITY_IDLE < prio && THREAD_PRIORITY_LOWEST > prio)
     {
       prio = THREAD_PRIORITY_LOWEST;
     }
@@ -101,10 +106,35 @@ ptw32_setthreadpriority (pthread_t thread, int policy, int priority)
 
 #endif
 
+  return prio;
+}
+
+
+int
+ptw32_setthreadpriority (pthread_t thread, int policy, int priority)
+{
+  ptw32_mcs_local_node_t threadLock;
+  int result = 0;
+  ptw32_thread_t * tp = (ptw32_thread_t *) thread.p;
+
+  /* Validate priority level. */
+  if (priority < sched_get_priority_min (policy) ||
+      priority > sched_get_priority_max (policy))
+    {
+      return EINVAL;
+    }
+
   ptw32_mcs_lock_acquire (&tp->threadLock, &threadLock);
 
-  /* If this fails, the current priority is unchanged. */
-  if (0 == SetThreadPriority (tp->threadH, prio))
+  /*
+   * If this fails, the current priority is unchanged. A fiber runs
+   * at its worker's priority, so only records it. A thread holding
+   * priority protocol mutexes keeps running at least at the priority
+   * they lend it (see ptw32_mutex_prio.c).
+   */
+  if (NULL == tp->fiber.handle
+      && 0 == SetThreadPriority (PTW32_THREAD_HANDLE (tp),
+				 ptw32_win32_priority (PTW32_MAX (priority, tp->boostPriority))))
     {
       result = EINVAL;
     }
@@ -115,9 +145,43 @@ ptw32_setthreadpriority (pthread_t thread, int policy, int priority)
        * not as finally adjusted.
        */
       tp->sched_priority = priority;
+      tp->sched_policy = policy;
     }
 
   ptw32_mcs_lock_release (&threadLock);
 
   return result;
 }
+
+
+void
+ptw32_boostthreadpriority (ptw32_thread_t * tp, int boost)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Runs the thread at the higher of its sched_priority
+      *      and 'boost', the priority lent to it by the priority
+      *      protocol mutexes it holds (PTW32_PRIO_NO_BOOST: none),
+      *      without changing the sched_priority that
+      *      pthread_getschedparam() reports.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t threadLock;
+
+  ptw32_mcs_lock_acquire (&tp->threadLock, &threadLock);
+
+  if (boost != tp->boostPriority)
+    {
+      tp->boostPriority = boost;
+
+      if (NULL == tp->fiber.handle)
+	{
+	  (void) SetThreadPriority (PTW32_THREAD_HANDLE (tp),
+				    ptw32_win32_priority (PTW32_MAX (tp->sched_priority, boost)));
+	}
+    }
+
+  ptw32_mcs_lock_release (&threadLock);
+}
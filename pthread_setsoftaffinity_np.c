@@ -0,0 +1,201 @@
+/*
+ * pthread_setsoftaffinity_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_setsoftaffinity_np (pthread_t thread, size_t cpusetsize,
+			    const cpu_set_t * cpuset)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets the CPUs a thread prefers to run on.
+      *
+      * PARAMETERS
+      *      thread
+      *              the target thread
+      *
+      *      cpusetsize
+      *              the size of cpuset, usually sizeof(cpu_set_t);
+      *              CPUs beyond it are taken to be clear
+      *
+      *      cpuset
+      *              the preferred CPUs, or an empty set for none
+      *
+      * DESCRIPTION
+      *      Unlike pthread_setaffinity_np(), which confines a
+      *      thread to its CPUs, this only makes the system prefer
+      *      the CPUs in cpuset (CPU Sets): when they are busy the
+      *      thread still runs on the other CPUs of its affinity.
+      *      CPUs the process doesn't have are dropped. The two
+      *      settings are independent, and the preference has no
+      *      effect on CPUs outside the thread's affinity.
+      *
+      * RESULTS
+      *              0               success,
+      *              ESRCH           'thread' does not exist,
+      *              EFAULT          'cpuset' is NULL,
+      *              EINVAL          'cpuset' has none of the
+      *                              process's CPUs,
+      *              ENOMEM          no memory for the CPU Set ids,
+      *              EAGAIN          the preference could not be set,
+      *              ENOSYS          the system has no CPU Sets
+      *                              (before Windows 10).
+      *
+      * ------------------------------------------------------
+      */
+{
+#if ! defined(HAVE_CPU_AFFINITY)
+
+  return ENOSYS;
+
+#else
+
+  int result = 0;
+  ptw32_thread_t * tp;
+  ptw32_mcs_local_node_t node;
+  cpu_set_t processCpuset;
+  cpu_set_t newSet;
+
+  if (NULL == cpuset)
+    {
+      return EFAULT;
+    }
+
+  ptw32_cpusetcopy (&newSet, sizeof (newSet), cpuset, cpusetsize);
+
+  if (CPU_COUNT (&newSet) > 0)
+    {
+      if (0 != (result = ptw32_getprocessaffinity (&processCpuset)))
+	{
+	  return result;
+	}
+
+      CPU_AND (&newSet, &processCpuset, &newSet);
+
+      if (0 == CPU_COUNT (&newSet))
+	{
+	  return EINVAL;
+	}
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_thread_reuse_lock, &node);
+
+  tp = (ptw32_thread_t *) thread.p;
+
+  if (NULL == tp || thread.x != tp->ptHandle.x || NULL == PTW32_THREAD_HANDLE (tp))
+    {
+      result = ESRCH;
+    }
+  else if (0 == (result = ptw32_setthreadsoftaffinity (tp->threadH, &newSet)))
+    {
+      tp->softCpuset = newSet;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+
+#endif
+}
+
+
+int
+pthread_getsoftaffinity_np (pthread_t thread, size_t cpusetsize,
+			    cpu_set_t * cpuset)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the CPUs a thread prefers to run on, as set
+      *      by pthread_setsoftaffinity_np(), or an empty set if
+      *      it has no preference.
+      *
+      * PARAMETERS
+      *      thread
+      *              the target thread
+      *
+      *      cpusetsize
+      *              the size of cpuset, usually sizeof(cpu_set_t);
+      *              CPUs beyond it are not returned
+      *
+      *      cpuset
+      *              where to return the preferred CPUs
+      *
+      * RESULTS
+      *              0               success,
+      *              ESRCH           'thread' does not exist,
+      *              EFAULT          'cpuset' is NULL,
+      *              ENOSYS          the platform has no CPU affinity.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if ! defined(HAVE_CPU_AFFINITY)
+
+  return ENOSYS;
+
+#else
+
+  int result = 0;
+  ptw32_thread_t * tp;
+  ptw32_mcs_local_node_t node;
+
+  if (NULL == cpuset)
+    {
+      return EFAULT;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_thread_reuse_lock, &node);
+
+  tp = (ptw32_thread_t *) thread.p;
+
+  if (NULL == tp || thread.x != tp->ptHandle.x || NULL == PTW32_THREAD_HANDLE (tp))
+    {
+      result = ESRCH;
+    }
+  else
+    {
+      ptw32_cpusetcopy (cpuset, cpusetsize, &tp->softCpuset, sizeof (cpu_set_t));
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+
+#endif
+}
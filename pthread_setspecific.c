@@ -87,7 +87,7 @@ pthread_setspecific (pthread_key_t key, const void *value)
        * Resolve catch-22 of registering thread with selfThread
        * key
        */
-      ptw32_thread_t * sp = (ptw32_thread_t *) pthread_getspecific (ptw32_selfThreadKey);
+      ptw32_thread_t * sp = PTW32_SELF_THREAD ();
 
       if (sp == NULL)
         {
@@ -109,58 +109,33 @@ pthread_setspecific (pthread_key_t key, const void *value)
     {
       if (self.p != NULL && key->destructor != NULL && value != NULL)
 	{
-          ptw32_mcs_local_node_t keyLock;
-          ptw32_mcs_local_node_t threadLock;
-	  ptw32_thread_t * sp = (ptw32_thread_t *) self.p;
 	  /*
-	   * Only require associations if we have to
-	   * call user destroy routine.
-	   * Don't need to locate an existing association
-	   * when setting data to NULL for WIN32 since the
-	   * data is stored with the operating system; not
-	   * on the association; setting assoc to NULL short
-	   * circuits the search.
+	   * Only record keys we may have to call the destroy
+	   * routine for. Setting data to NULL needs nothing
+	   * since the data is stored with the operating system
+	   * or in the thread's table, not with the record.
 	   */
-	  ThreadKeyAssoc *assoc;
-
-	  ptw32_mcs_lock_acquire(&(key->keyLock), &keyLock);
-	  ptw32_mcs_lock_acquire(&(sp->threadLock), &threadLock);
+	  result = ptw32_tsd_mark_destructor ((ptw32_thread_t *) self.p, key);
+	}
 
-	  assoc = (ThreadKeyAssoc *) sp->keys;
-	  /*
-	   * Locate existing association
-	   */
-	  while (assoc != NULL)
+      if (result == 0)
+	{
+	  if (PTW32_KEY_IN_TABLE(key))
 	    {
-	      if (assoc->key == key)
-		{
-		  /*
-		   * Association already exists
-		   */
-		  break;
-		}
-		assoc = assoc->nextKey;
+	      result = ptw32_tsd_table_set (key, value);
 	    }
-
-	  /*
-	   * create an association if not found
-	   */
-	  if (assoc == NULL)
+	  else if (!TlsSetValue (key->key, (LPVOID) value))
 	    {
-	      result = ptw32_tkAssocCreate (sp, key);
+	      result = EAGAIN;
 	    }
-
-	  ptw32_mcs_lock_release(&threadLock);
-	  ptw32_mcs_lock_release(&keyLock);
 	}
 
-      if (result == 0)
+#if defined(PTW32_THREAD_LOCAL)
+      if (result == 0 && key == ptw32_selfThreadKey)
 	{
-	  if (!TlsSetValue (key->key, (LPVOID) value))
-	    {
-	      result = EAGAIN;
-	    }
+	  ptw32_selfThread = (ptw32_thread_t *) value;
 	}
+#endif
     }
 
   return (result);
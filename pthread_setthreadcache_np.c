@@ -0,0 +1,85 @@
+/*
+ * pthread_setthreadcache_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_setthreadcache_np (int max)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets the number of finished threads' OS threads that
+      *      are kept to run threads created later.
+      *
+      * PARAMETERS
+      *      max
+      *              maximum number of OS threads kept parked
+      *              (0: don't keep any).
+      *
+      * DESCRIPTION
+      *      Threads created while 'max' is greater than 0 don't
+      *      end their OS thread when they exit. After the thread
+      *      has been torn down as usual (TSD destructors have run,
+      *      robust mutexes are released and the thread can be
+      *      joined) the OS thread waits to be given a start routine
+      *      by pthread_create, saving the cost of creating a new
+      *      one. A parked OS thread is only used for a thread with
+      *      the same stack size. Each thread still has its own
+      *      pthread_t and Win32 handle; its Win32 thread ID may be
+      *      that of an earlier thread.
+      *
+      *      Lowering 'max' ends the surplus parked OS threads. The
+      *      initial value is 0.
+      *
+      * RESULTS
+      *              0               successfully set the maximum,
+      *              EINVAL          'max' is negative.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (max < 0)
+    {
+      return EINVAL;
+    }
+
+  ptw32_threadCacheMax = max;
+  ptw32_threadCacheTrim (max);
+
+  return 0;
+}				/* pthread_setthreadcache_np */
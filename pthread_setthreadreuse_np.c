@@ -0,0 +1,87 @@
+/*
+ * pthread_setthreadreuse_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_setthreadreuse_np (int max)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets the number of finished threads' pthread_t structs
+      *      that are kept to be reused.
+      *
+      * PARAMETERS
+      *      max
+      *              maximum number of structs kept
+      *              (-1: no limit).
+      *
+      * DESCRIPTION
+      *      A thread's struct is kept, once the thread has been
+      *      joined or has exited detached, for a later thread to
+      *      reuse, the oldest first, so that a stale copy of a
+      *      pthread_t is recognised as such. By default none is
+      *      ever freed, so the library holds as many as there
+      *      have ever been threads at once.
+      *
+      *      With a limit the oldest surplus structs are freed as
+      *      threads end. A copy of a pthread_t whose struct has
+      *      been freed must not be used at all; nothing else
+      *      changes. Lowering 'max' frees the surplus at once.
+      *
+      * RESULTS
+      *              0               successfully set the maximum,
+      *              EINVAL          'max' is less than -1.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (max < -1)
+    {
+      return EINVAL;
+    }
+
+  ptw32_threadReuseMax = max;
+
+  if (max >= 0)
+    {
+      ptw32_threadReuseTrim (max);
+    }
+
+  return 0;
+}				/* pthread_setthreadreuse_np */
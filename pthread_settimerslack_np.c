@@ -0,0 +1,104 @@
+/*
+ * pthread_settimerslack_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_settimerslack_np (long slack)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets how late the process's timed waits may end, so
+      *      that their timeouts can be ended together.
+      *
+      * PARAMETERS
+      *      slack
+      *              nanoseconds (0: none).
+      *
+      * DESCRIPTION
+      *      With a slack set, a timed wait that parks on an
+      *      address (condition variable, mutex, read/write lock,
+      *      pthread_delay_np and pthread_wait_on_address_np waits)
+      *      and has at least a millisecond to go doesn't give the
+      *      system a timeout of its own. It is queued on a timer
+      *      wheel whose ticks are the slack long, and a library
+      *      thread, started by the first such wait, ends all the
+      *      waits due in a tick together. A wait may end up to a
+      *      tick after its timeout. The slack is rounded up to a
+      *      millisecond.
+      *
+      *      Waits that begin after the slack is set to 0 are timed
+      *      by the system again. The initial value is 0.
+      *
+      * RESULTS
+      *              0               successfully set the slack,
+      *              EINVAL          'slack' is negative.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  LONG ticks = 0;
+
+  if (slack < 0)
+    {
+      return EINVAL;
+    }
+
+  if (slack > 0)
+    {
+      /* 100 nanosecond units, no less than the wheel thread's sleeps */
+      ticks = (LONG) (slack / 100 + (0 != slack % 100));
+      if (ticks < 10000)
+        {
+          ticks = 10000;
+        }
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_wheel_lock, &node);
+
+  ptw32_timerSlack = ticks;
+  if (ticks > 0)
+    {
+      ptw32_timer_wheel_retick (ticks);
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return 0;
+}				/* pthread_settimerslack_np */
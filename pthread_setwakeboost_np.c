@@ -0,0 +1,120 @@
+/*
+ * pthread_setwakeboost_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_setwakeboost_np (pthread_t thread, int boost)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Changes whether a thread gets a priority boost when
+      *      woken.
+      *
+      * PARAMETERS
+      *      thread
+      *              the target thread
+      *
+      *      boost
+      *              1 for the boost Windows gives by default, 0 for
+      *              none
+      *
+      * DESCRIPTION
+      *      Windows raises the dynamic priority of a thread for a
+      *      while when it is woken from a wait, on an event or
+      *      semaphore the library signals, for example. The woken
+      *      thread then often preempts the thread that woke it,
+      *      just after it released a lock, and the signaller gets
+      *      a context switch it didn't need. With the boost off
+      *      the woken thread waits for a processor at its own
+      *      priority, so the signaller can carry on. Has no effect
+      *      on a fiber thread, but is still recorded.
+      *
+      * RESULTS
+      *              0               successfully set the boost,
+      *              EINVAL          'boost' is invalid,
+      *              ESRCH           'thread' does not exist.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result;
+  ptw32_thread_t * tp = (ptw32_thread_t *) thread.p;
+  ptw32_mcs_local_node_t threadLock;
+
+  /* Validate the thread id. */
+  if (0 != (result = pthread_kill (thread, 0)))
+    {
+      return result;
+    }
+
+  if (boost != 0 && boost != 1)
+    {
+      return EINVAL;
+    }
+
+  ptw32_mcs_lock_acquire (&tp->threadLock, &threadLock);
+
+  tp->wakeBoost = boost;
+
+  if (NULL == tp->fiber.handle)
+    {
+      ptw32_setthreadwakeboost (PTW32_THREAD_HANDLE (tp), boost);
+    }
+
+  ptw32_mcs_lock_release (&threadLock);
+
+  return 0;
+}
+
+
+void
+ptw32_setthreadwakeboost (HANDLE threadH, int boost)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Turns the dynamic priority boost of a thread on or
+      *      off. Failures are ignored, as for the QoS.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if ! defined(WINCE)
+  (void) SetThreadPriorityBoost (threadH, boost ? FALSE : TRUE);
+#endif
+}
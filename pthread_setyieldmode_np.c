@@ -0,0 +1,91 @@
+/*
+ * pthread_setyieldmode_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_setyieldmode_np (int mode)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets how sched_yield gives up the processor, for
+      *      the whole process.
+      *
+      * PARAMETERS
+      *      mode
+      *              PTHREAD_YIELD_SWITCH_NP
+      *                      SwitchToThread(): run any thread
+      *                      that is ready on the processor
+      *                      (the default).
+      *
+      *              PTHREAD_YIELD_SLEEP_NP
+      *                      Sleep(0): run only threads of at
+      *                      least the caller's priority.
+      *
+      *              PTHREAD_YIELD_BACKOFF_NP
+      *                      switch on the first calls of a
+      *                      thread that keeps yielding, then
+      *                      Sleep(0), then Sleep(1).
+      *
+      * DESCRIPTION
+      *      A thread that polls with sched_yield for another to
+      *      release something may starve it with Sleep(0) if
+      *      the other has a lower priority. The backoff mode
+      *      bounds the time such a thread takes. It counts the
+      *      calls a thread makes with less than 50 ms between
+      *      them. The library's own polling loops always back
+      *      off, whatever the mode.
+      *
+      * RESULTS
+      *              0               successfully set the mode,
+      *              EINVAL          'mode' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (mode != PTHREAD_YIELD_SWITCH_NP
+      && mode != PTHREAD_YIELD_SLEEP_NP
+      && mode != PTHREAD_YIELD_BACKOFF_NP)
+    {
+      return EINVAL;
+    }
+
+  ptw32_yield_mode = mode;
+
+  return 0;
+}				/* pthread_setyieldmode_np */
@@ -55,6 +55,13 @@ pthread_spin_destroy (pthread_spinlock_t * lock)
 	{
 	  result = pthread_mutex_destroy (&(s->u.mutex));
 	}
+      else if (s->interlock == PTW32_SPIN_USE_TICKET)
+	{
+	  if (s->ticketNext != s->ticketOwner)
+	    {
+	      result = EINVAL;
+	    }
+	}
       else if ((PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED !=
 	       PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->interlock,
 						   (PTW32_INTERLOCKED_LONG) PTW32_SPIN_INVALID,
@@ -70,41 +77,26 @@ pthread_spin_destroy (pthread_spinlock_t * lock)
 	   * have finished with the spinlock before destroying it.
 	   */
 	  *lock = NULL;
-	  (void) free (s);
+	  if (!s->inPlace)
+	    {
+	      ptw32_object_free (s);
+	    }
 	}
     }
   else
     {
       /*
-       * See notes in ptw32_spinlock_check_need_init() above also.
+       * Clear a static spinlock that has not been used yet, as
+       * pthread_mutex_destroy() does, unless another thread has
+       * just initialised it.
        */
-      ptw32_mcs_local_node_t node;
-
-      ptw32_mcs_lock_acquire(&ptw32_spinlock_test_init_lock, &node);
-
-      /*
-       * Check again.
-       */
-      if (*lock == PTHREAD_SPINLOCK_INITIALIZER)
-	{
-	  /*
-	   * This is all we need to do to destroy a statically
-	   * initialised spinlock that has not yet been used (initialised).
-	   * If we get to here, another thread
-	   * waiting to initialise this mutex will get an EINVAL.
-	   */
-	  *lock = NULL;
-	}
-      else
+      if (PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) lock,
+						  (PTW32_INTERLOCKED_PVOID) NULL,
+						  (PTW32_INTERLOCKED_PVOID) PTHREAD_SPINLOCK_INITIALIZER)
+	  != (PTW32_INTERLOCKED_PVOID) PTHREAD_SPINLOCK_INITIALIZER)
 	{
-	  /*
-	   * The spinlock has been initialised while we were waiting
-	   * so assume it's in use.
-	   */
 	  result = EBUSY;
 	}
-
-       ptw32_mcs_lock_release(&node);
     }
 
   return (result);
@@ -0,0 +1,94 @@
+/*
+ * pthread_spin_destroy_array_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_spin_destroy_array_np (pthread_spinlock_t * locks, size_t n)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Destroys an array of spin locks initialised with
+      *      pthread_spin_init_array_np().
+      *
+      * PARAMETERS
+      *      locks
+      *              the array passed to pthread_spin_init_array_np()
+      *
+      *      n
+      *              its number of spin locks
+      *
+      * DESCRIPTION
+      *      Destroys the locks, last first, and frees their block.
+      *      A held lock stops the loop with EBUSY, leaving it and
+      *      those before it initialised.
+      *
+      * RESULTS
+      *              0               successfully destroyed the locks,
+      *              EINVAL          'locks' is NULL, 'n' is 0 or the
+      *                              first lock is not initialised,
+      *              EBUSY           a lock is held.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_spinlock_t block;
+  int result;
+  size_t i;
+
+  if (locks == NULL || n == 0 || locks[0] == NULL)
+    {
+      return EINVAL;
+    }
+
+  /* The block starts with the first lock */
+  block = locks[0];
+
+  for (i = n; i-- > 0;)
+    {
+      if (locks[i] != NULL
+	  && 0 != (result = pthread_spin_destroy (&locks[i])))
+	{
+	  return result;
+	}
+    }
+
+  ptw32_object_free (block);
+
+  return 0;
+}				/* pthread_spin_destroy_array_np */
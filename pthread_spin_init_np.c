@@ -0,0 +1,86 @@
+/*
+ * pthread_spin_init_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_spin_init_np (pthread_spinlock_t * lock, int pshared, int kind)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Initialises a spin lock of the given kind.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_spinlock_t
+      *
+      *      pshared
+      *              as for pthread_spin_init().
+      *
+      *      kind
+      *              PTHREAD_SPINLOCK_DEFAULT_NP
+      *                      test-and-test-and-set with exponential
+      *                      backoff, as for pthread_spin_init().
+      *
+      *              PTHREAD_SPINLOCK_TICKET_NP
+      *                      a ticket lock: threads acquire the lock
+      *                      in the order they arrive.
+      *
+      * DESCRIPTION
+      *      A ticket lock is fair but each release hands the lock
+      *      to one particular waiter, so a preempted waiter holds up
+      *      all those behind it. Only use it when there are no more
+      *      spinning threads than processors. On a single processor
+      *      system both kinds use a mutex.
+      *
+      * RESULTS
+      *              0               successfully initialised lock,
+      *              EINVAL          'lock' or 'kind' is invalid,
+      *              ENOMEM          insufficient memory,
+      *              ENOSYS          'pshared' is PTHREAD_PROCESS_SHARED,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (kind != PTHREAD_SPINLOCK_DEFAULT_NP && kind != PTHREAD_SPINLOCK_TICKET_NP)
+    {
+      return EINVAL;
+    }
+
+  return ptw32_spinlock_init (lock, pshared, kind, NULL, 0);
+}				/* pthread_spin_init_np */
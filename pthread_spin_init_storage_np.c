@@ -0,0 +1,80 @@
+/*
+ * pthread_spin_init_storage_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_spin_init_storage_np (pthread_spinlock_t * lock, int pshared, int kind,
+			      pthread_spinlock_storage_np_t * storage)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Initialises a spin lock of the given kind in storage
+      *      provided by the caller.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_spinlock_t
+      *
+      *      pshared, kind
+      *              as for pthread_spin_init_np().
+      *
+      *      storage
+      *              where to keep the spin lock
+      *
+      * DESCRIPTION
+      *      See pthread_mutex_init_storage_np(). On a single
+      *      processor system the mutex the lock uses is still
+      *      allocated.
+      *
+      * RESULTS
+      *              0               successfully initialised lock,
+      *              EINVAL          'storage' is NULL,
+      *              other           as for pthread_spin_init_np().
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (storage == NULL
+      || (kind != PTHREAD_SPINLOCK_DEFAULT_NP && kind != PTHREAD_SPINLOCK_TICKET_NP))
+    {
+      return EINVAL;
+    }
+
+  return ptw32_spinlock_init (lock, pshared, kind, storage, sizeof (*storage));
+}
@@ -38,6 +38,34 @@
 #include "implement.h"
 
 
+/*
+ * Spinning only helps while the owner is running. The owner records
+ * itself in s->owner, and ptw32_wait_begin/ptw32_wait_end mark a thread
+ * blocked while it waits in the library, so a waiter whose owner is
+ * blocked there yields the processor at once. An owner preempted, or on
+ * a virtual processor the hypervisor has descheduled, can't be seen, so
+ * a waiter also yields after ptw32_spinYieldLimit processor hints
+ * without the lock changing hands. The owner is only a hint: the
+ * PTW32_INLINE_LOCKS fast paths don't record it, and thread structs
+ * are only freed when the reuse limit trims them, so an owner that has
+ * since gone only gives a wrong one.
+ *
+ * A waiter that can't run alongside the owner, because ptw32_spin_pays()
+ * finds a single CPU by affinity or job CPU rate cap, yields every time.
+ */
+static INLINE void
+ptw32_spin_yield_check (pthread_spinlock_t s, long * spun, int pays)
+{
+  ptw32_thread_t * owner = s->owner;
+
+  if (!pays || (owner != NULL && owner->blocked) || *spun >= ptw32_spinYieldLimit)
+    {
+      (void) SwitchToThread ();
+      *spun = 0;
+    }
+}
+
+
 int
 pthread_spin_lock (pthread_spinlock_t * lock)
 {
@@ -60,15 +88,83 @@ pthread_spin_lock (pthread_spinlock_t * lock)
 
   s = *lock;
 
-  while ((PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED ==
-	 PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->interlock,
-					          (PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED,
-					          (PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED))
+  if (s->interlock == PTW32_SPIN_USE_TICKET)
     {
+      ULONG ticket = (ULONG) PTW32_ATOMIC_EXCHANGE_ADD_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->ticketNext,
+								 (PTW32_INTERLOCKED_LONG) 1);
+      ULONG owner;
+      ULONG ahead;
+      ULONG last = ticket;
+      long spun = 0;
+      int pays = -1;
+
+      /*
+       * Back off in proportion to the number of threads ahead of us.
+       */
+      while ((ahead = ticket - (owner = (ULONG) PTW32_ATOMIC_LOAD_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->ticketOwner))) != 0)
+	{
+	  if (owner != last)
+	    {
+	      last = owner;
+	      spun = 0;
+	    }
+	  if (pays < 0)
+	    {
+	      pays = ptw32_spin_pays ();
+	    }
+	  spun += (long) ahead;
+	  while (pays && ahead-- > 0)
+	    {
+	      PTW32_SPIN_WAIT_LONG (&s->ticketOwner, owner);
+	    }
+	  ptw32_spin_yield_check (s, &spun, pays);
+	}
+
+      s->owner = PTW32_SELF_THREAD ();
+
+      return 0;
     }
 
+  {
+    int backoff = 1;
+    long spun = 0;
+    int pays = -1;
+    int i;
+
+    while ((PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED ==
+	   PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->interlock,
+					           (PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED,
+					           (PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED))
+      {
+	/*
+	 * Wait with plain reads until the lock looks free, so as not to
+	 * take the cache line away from the owner, backing off
+	 * exponentially up to ptw32_spinBackoffLimit.
+	 */
+	if (pays < 0)
+	  {
+	    pays = ptw32_spin_pays ();
+	  }
+	do
+	  {
+	    for (i = 0; pays && i < backoff; i++)
+	      {
+		PTW32_SPIN_WAIT_LONG (&s->interlock, PTW32_SPIN_LOCKED);
+	      }
+	    spun += backoff;
+	    if (backoff < ptw32_spinBackoffLimit)
+	      {
+		backoff <<= 1;
+	      }
+	    ptw32_spin_yield_check (s, &spun, pays);
+	  }
+	while (*((long volatile *) &s->interlock) == PTW32_SPIN_LOCKED);
+      }
+  }
+
   if (s->interlock == PTW32_SPIN_LOCKED)
     {
+      s->owner = PTW32_SELF_THREAD ();
       return 0;
     }
   else if (s->interlock == PTW32_SPIN_USE_MUTEX)
@@ -60,12 +60,30 @@ pthread_spin_trylock (pthread_spinlock_t * lock)
 
   s = *lock;
 
+  if (s->interlock == PTW32_SPIN_USE_TICKET)
+    {
+      LONG owner = PTW32_ATOMIC_LOAD_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->ticketOwner);
+
+      /* Free only if no ticket beyond the owner's is out */
+      if ((PTW32_INTERLOCKED_LONG) owner !=
+	  PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->ticketNext,
+						  (PTW32_INTERLOCKED_LONG) (owner + 1),
+						  (PTW32_INTERLOCKED_LONG) owner))
+	{
+	  return EBUSY;
+	}
+
+      s->owner = PTW32_SELF_THREAD ();
+      return 0;
+    }
+
   switch ((long)
-	  PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->interlock,
-					           (PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED,
-					           (PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED))
+	  PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->interlock,
+					          (PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED,
+					          (PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED))
     {
     case PTW32_SPIN_UNLOCKED:
+      s->owner = PTW32_SELF_THREAD ();
       return 0;
     case PTW32_SPIN_LOCKED:
       return EBUSY;
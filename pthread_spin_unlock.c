@@ -55,10 +55,31 @@ pthread_spin_unlock (pthread_spinlock_t * lock)
       return EPERM;
     }
 
+  if (s->interlock == PTW32_SPIN_USE_TICKET)
+    {
+      if (s->ticketNext == s->ticketOwner)
+	{
+	  return EPERM;
+	}
+
+      s->owner = NULL;
+
+      /* Only the owner writes ticketOwner */
+      PTW32_ATOMIC_STORE_REL_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->ticketOwner,
+				   (PTW32_INTERLOCKED_LONG) (s->ticketOwner + 1));
+
+      return 0;
+    }
+
+  if (s->interlock == PTW32_SPIN_LOCKED)
+    {
+      s->owner = NULL;
+    }
+
   switch ((long)
-	  PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->interlock,
-					      (PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED,
-					      (PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED))
+	  PTW32_ATOMIC_COMPARE_EXCHANGE_REL_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->interlock,
+					     (PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED,
+					     (PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED))
     {
     case PTW32_SPIN_LOCKED:
     case PTW32_SPIN_UNLOCKED:
@@ -0,0 +1,106 @@
+/*
+ * pthread_spsc_create_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_spsc_create_np (pthread_spsc_np_t * channel, int capacity)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Creates a single-producer single-consumer channel
+      *      that holds up to 'capacity' pointers.
+      *
+      * PARAMETERS
+      *      channel
+      *              pointer to an instance of pthread_spsc_np_t
+      *
+      *      capacity
+      *              maximum number of items in the channel, at
+      *              least 1.
+      *
+      * DESCRIPTION
+      *      One thread at a time may push to the channel and one
+      *      at a time may pop from it. Items are popped in the
+      *      order they were pushed. Neither end makes an
+      *      interlocked operation unless the channel is empty or
+      *      full, and a push only calls into the system when the
+      *      consumer is parked waiting for it (and vice versa).
+      *
+      * RESULTS
+      *              0               successfully created channel,
+      *              EINVAL          'channel' or 'capacity' is invalid,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_spsc_np_t c;
+  LONG size;
+
+  if (channel == NULL || capacity <= 0 || capacity > (1 << 30))
+    {
+      return EINVAL;
+    }
+
+  for (size = 1; size < capacity; size <<= 1)
+    {
+    }
+
+  c = (pthread_spsc_np_t) ptw32_object_alloc (sizeof (*c), PTW32_CACHE_LINE_SIZE);
+
+  if (c == NULL)
+    {
+      return ENOMEM;
+    }
+
+  c->items = (void **) malloc (size * sizeof (*c->items));
+
+  if (c->items == NULL)
+    {
+      ptw32_object_free (c);
+      return ENOMEM;
+    }
+
+  c->mask = size - 1;
+  c->capacity = capacity;
+
+  *channel = c;
+
+  return 0;
+}				/* pthread_spsc_create_np */
@@ -0,0 +1,201 @@
+/*
+ * pthread_spsc_pop_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_spsc_pop_np (pthread_spsc_np_t channel, void ** item)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Pops the oldest item from the channel, waiting while
+      *      the channel is empty. Only the consumer may call it.
+      *
+      * PARAMETERS
+      *      channel
+      *              an instance of pthread_spsc_np_t
+      *
+      *      item
+      *              pointer to where the item is returned
+      *
+      * DESCRIPTION
+      *      This function is a cancellation point. A cancelled
+      *      pop leaves the channel unchanged.
+      *
+      * RESULTS
+      *              0               an item was popped,
+      *              EINVAL          'channel' or 'item' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  return pthread_spsc_popv_np (channel, item, 1, NULL);
+}				/* pthread_spsc_pop_np */
+
+
+int
+pthread_spsc_popv_np (pthread_spsc_np_t channel, void ** items, int count,
+                      int * popped)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Pops up to 'count' of the oldest items from the
+      *      channel, waiting while the channel is empty. Only
+      *      the consumer may call it.
+      *
+      * PARAMETERS
+      *      channel
+      *              an instance of pthread_spsc_np_t
+      *
+      *      items
+      *              where the items are returned, in order
+      *
+      *      count
+      *              the most items to pop, at least 1
+      *
+      *      popped
+      *              NULL, or where the number popped is returned
+      *
+      * DESCRIPTION
+      *      Pops whatever is in the channel, up to 'count' items,
+      *      handing their places back to the producer at once,
+      *      with one store. Waits only while the channel is
+      *      empty.
+      *
+      *      This function is a cancellation point. A cancelled
+      *      pop leaves the channel unchanged.
+      *
+      * RESULTS
+      *              0               at least one item was popped,
+      *              EINVAL          an argument is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_spsc_np_t c = channel;
+  LONG h;
+  LONG n;
+  LONG i;
+
+  if (c == NULL || items == NULL || count < 1)
+    {
+      return EINVAL;
+    }
+
+  h = PTW32_ATOMIC_LOAD_RELAXED_LONG(&c->head);
+
+  if (0 == (n = PTW32_SPSC_LENGTH(c->tailCache, h)))
+    {
+      c->tailCache = PTW32_ATOMIC_LOAD_ACQ_LONG(&c->tail);
+
+      while (0 == (n = PTW32_SPSC_LENGTH(c->tailCache, h)))
+        {
+          ptw32_spsc_wait (&c->tail, c->tailCache, &c->consumerParked);
+          c->tailCache = PTW32_ATOMIC_LOAD_ACQ_LONG(&c->tail);
+        }
+    }
+
+  n = PTW32_MIN (n, (LONG) count);
+
+  for (i = 0; i < n; i++)
+    {
+      items[i] = c->items[((ULONG) h + i) & (ULONG) c->mask];
+    }
+
+  PTW32_ATOMIC_STORE_REL_LONG(&c->head, (LONG) ((ULONG) h + n));
+  ptw32_spsc_wake (&c->head, &c->producerParked);
+
+  if (popped != NULL)
+    {
+      *popped = (int) n;
+    }
+
+  return 0;
+}				/* pthread_spsc_popv_np */
+
+
+int
+pthread_spsc_trypop_np (pthread_spsc_np_t channel, void ** item)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Pops the oldest item from the channel if the channel
+      *      isn't empty. Only the consumer may call it.
+      *
+      * PARAMETERS
+      *      channel
+      *              an instance of pthread_spsc_np_t
+      *
+      *      item
+      *              pointer to where the item is returned
+      *
+      * RESULTS
+      *              0               an item was popped,
+      *              EINVAL          'channel' or 'item' is invalid,
+      *              EAGAIN          the channel is empty.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_spsc_np_t c = channel;
+  LONG h;
+
+  if (c == NULL || item == NULL)
+    {
+      return EINVAL;
+    }
+
+  h = PTW32_ATOMIC_LOAD_RELAXED_LONG(&c->head);
+
+  if (c->tailCache == h)
+    {
+      c->tailCache = PTW32_ATOMIC_LOAD_ACQ_LONG(&c->tail);
+
+      if (c->tailCache == h)
+        {
+          return EAGAIN;
+        }
+    }
+
+  *item = c->items[(ULONG) h & (ULONG) c->mask];
+
+  PTW32_ATOMIC_STORE_REL_LONG(&c->head, (LONG) ((ULONG) h + 1));
+  ptw32_spsc_wake (&c->head, &c->producerParked);
+
+  return 0;
+}				/* pthread_spsc_trypop_np */
@@ -0,0 +1,200 @@
+/*
+ * pthread_spsc_push_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_spsc_push_np (pthread_spsc_np_t channel, void * item)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Pushes item into the channel, waiting while the
+      *      channel is full. Only the producer may call it.
+      *
+      * PARAMETERS
+      *      channel
+      *              an instance of pthread_spsc_np_t
+      *
+      *      item
+      *              the pointer to push, which may be NULL
+      *
+      * DESCRIPTION
+      *      This function is a cancellation point. A cancelled
+      *      push leaves the channel unchanged.
+      *
+      * RESULTS
+      *              0               item was pushed,
+      *              EINVAL          'channel' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  return pthread_spsc_pushv_np (channel, &item, 1);
+}				/* pthread_spsc_push_np */
+
+
+int
+pthread_spsc_pushv_np (pthread_spsc_np_t channel, void * const * items, int count)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Pushes 'count' items into the channel, waiting while
+      *      the channel is full. Only the producer may call it.
+      *
+      * PARAMETERS
+      *      channel
+      *              an instance of pthread_spsc_np_t
+      *
+      *      items
+      *              the pointers to push, in order
+      *
+      *      count
+      *              the number of items, which may be more than the
+      *              channel holds
+      *
+      * DESCRIPTION
+      *      As many items as there is room for are published to
+      *      the consumer at once, with one store, and the push
+      *      waits for room for the rest.
+      *
+      *      This function is a cancellation point. A push that is
+      *      cancelled has pushed the items before the first it
+      *      was waiting for room for.
+      *
+      * RESULTS
+      *              0               the items were pushed,
+      *              EINVAL          an argument is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_spsc_np_t c = channel;
+  LONG t;
+  int done = 0;
+
+  if (c == NULL || count < 0 || (items == NULL && count > 0))
+    {
+      return EINVAL;
+    }
+
+  t = PTW32_ATOMIC_LOAD_RELAXED_LONG(&c->tail);
+
+  while (done < count)
+    {
+      LONG room = c->capacity - PTW32_SPSC_LENGTH(t, c->headCache);
+      LONG i;
+
+      if (room == 0)
+        {
+          c->headCache = PTW32_ATOMIC_LOAD_ACQ_LONG(&c->head);
+
+          if (0 == (room = c->capacity - PTW32_SPSC_LENGTH(t, c->headCache)))
+            {
+              ptw32_spsc_wait (&c->head, c->headCache, &c->producerParked);
+              continue;
+            }
+        }
+
+      room = PTW32_MIN (room, (LONG) (count - done));
+
+      for (i = 0; i < room; i++)
+        {
+          c->items[((ULONG) t + i) & (ULONG) c->mask] = items[done + i];
+        }
+
+      t = (LONG) ((ULONG) t + room);
+      done += room;
+
+      PTW32_ATOMIC_STORE_REL_LONG(&c->tail, t);
+      ptw32_spsc_wake (&c->tail, &c->consumerParked);
+    }
+
+  return 0;
+}				/* pthread_spsc_pushv_np */
+
+
+int
+pthread_spsc_trypush_np (pthread_spsc_np_t channel, void * item)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Pushes item into the channel if the channel isn't
+      *      full. Only the producer may call it.
+      *
+      * PARAMETERS
+      *      channel
+      *              an instance of pthread_spsc_np_t
+      *
+      *      item
+      *              the pointer to push, which may be NULL
+      *
+      * RESULTS
+      *              0               item was pushed,
+      *              EINVAL          'channel' is invalid,
+      *              EAGAIN          the channel is full.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_spsc_np_t c = channel;
+  LONG t;
+
+  if (c == NULL)
+    {
+      return EINVAL;
+    }
+
+  t = PTW32_ATOMIC_LOAD_RELAXED_LONG(&c->tail);
+
+  if (PTW32_SPSC_LENGTH(t, c->headCache) == c->capacity)
+    {
+      c->headCache = PTW32_ATOMIC_LOAD_ACQ_LONG(&c->head);
+
+      if (PTW32_SPSC_LENGTH(t, c->headCache) == c->capacity)
+        {
+          return EAGAIN;
+        }
+    }
+
+  c->items[(ULONG) t & (ULONG) c->mask] = item;
+
+  PTW32_ATOMIC_STORE_REL_LONG(&c->tail, (LONG) ((ULONG) t + 1));
+  ptw32_spsc_wake (&c->tail, &c->consumerParked);
+
+  return 0;
+}				/* pthread_spsc_trypush_np */
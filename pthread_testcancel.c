@@ -69,14 +69,29 @@ pthread_testcancel (void)
       */
 {
   ptw32_mcs_local_node_t stateLock;
-  pthread_t self = pthread_self ();
-  ptw32_thread_t * sp = (ptw32_thread_t *) self.p;
+  /*
+   * A thread without a struct can't have been sent a cancel or a
+   * signal, so there is no need to create one as pthread_self() would.
+   */
+  ptw32_thread_t * sp = PTW32_SELF_THREAD ();
 
-  if (sp == NULL)
+  if (sp == NULL || sp->testCancel == 0)
     {
       return;
     }
 
+  /* Signals sent with pthread_kill() and not yet raised are raised here */
+  if (sp->testCancel & PTW32_TESTCANCEL_SIGNAL)
+    {
+      ptw32_signal_deliver (sp);
+    }
+
+  /* A cancellation point is a quiescent state for an RCU reader */
+  if (sp->rcuReader != NULL && sp->rcuReader->ctr != 0)
+    {
+      PTW32_RCU_ONLINE (sp->rcuReader);
+    }
+
   /*
    * Pthread_cancel() will have set sp->state to PThreadStateCancelPending
    * and set an event, so no need to enter kernel space if
@@ -91,9 +106,13 @@ pthread_testcancel (void)
 
   if (sp->cancelState != PTHREAD_CANCEL_DISABLE)
     {
-      ResetEvent(sp->cancelEvent);
+      if (sp->cancelEvent != NULL)
+	{
+	  ResetEvent(sp->cancelEvent);
+	}
       sp->state = PThreadStateCanceling;
       sp->cancelState = PTHREAD_CANCEL_DISABLE;
+      ptw32_testcancel_lower (sp, PTW32_TESTCANCEL_CANCEL);
       ptw32_mcs_lock_release (&stateLock);
       ptw32_throw (PTW32_EPS_CANCEL);
       /* Never returns here */
@@ -101,3 +120,94 @@ pthread_testcancel (void)
 
   ptw32_mcs_lock_release (&stateLock);
 }				/* pthread_testcancel */
+
+
+int
+pthread_testcancel_slot_np (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the TLS index that holds the address of the
+      *      calling thread's struct, for the inline
+      *      pthread_testcancel in pthread.h.
+      *
+      * PARAMETERS
+      *      N/A
+      *
+      *
+      * DESCRIPTION
+      *      The struct begins with the thread's pthread_t handle,
+      *      followed by a LONG that is non-zero while
+      *      pthread_testcancel has something to do. The inline
+      *      version reads the slot straight from the TEB, as
+      *      pthread_getspecific does, which holds only the first
+      *      64 slots.
+      *
+      * RESULTS
+      *              the TLS index, or -1 if it is beyond the TEB's
+      *              slots or the library isn't initialised.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if defined(PTW32_TEB_TLS_VALUE)
+  if (ptw32_selfThreadKey != NULL
+      && ptw32_selfThreadKey->key < PTW32_TEB_TLS_SLOTS)
+    {
+      return (int) ptw32_selfThreadKey->key;
+    }
+#endif
+
+  return -1;
+}				/* pthread_testcancel_slot_np */
+
+
+void
+ptw32_testcancel_raise (ptw32_thread_t * sp, LONG bits)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Sets bits in sp->testCancel, so that sp's next
+      *      pthread_testcancel enters the library. Any thread
+      *      may call this.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG old;
+
+  do
+    {
+      old = sp->testCancel;
+    }
+  while ((old & bits) != bits
+         && (PTW32_INTERLOCKED_LONG) old
+            != PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &sp->testCancel,
+                                                        (PTW32_INTERLOCKED_LONG) (old | bits),
+                                                        (PTW32_INTERLOCKED_LONG) old));
+}
+
+
+void
+ptw32_testcancel_lower (ptw32_thread_t * sp, LONG bits)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Clears bits in sp->testCancel. Any thread may call
+      *      this.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG old;
+
+  do
+    {
+      old = sp->testCancel;
+    }
+  while ((old & bits) != 0
+         && (PTW32_INTERLOCKED_LONG) old
+            != PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &sp->testCancel,
+                                                        (PTW32_INTERLOCKED_LONG) (old & ~bits),
+                                                        (PTW32_INTERLOCKED_LONG) old));
+}
@@ -59,6 +59,11 @@
  *    they must be able to deal properly with spurious wakeups. That is,
  *    they must re-test their condition upon wakeup and wait again if
  *    the condition is not satisfied.
+ *
+ * 4) CVs initialised with a CLOCK_MONOTONIC attribute are skipped: their
+ *    timeouts do not depend on the system time, so they are never put
+ *    on the list. Applications that want to avoid the broadcast
+ *    entirely should use such CVs.
  */
 
 void *
@@ -75,7 +80,8 @@ pthread_timechange_handler_np (void *arg)
       *
       * DESCRIPTION
       *      Broadcasts all CVs to force re-evaluation and
-      *      new timeouts if required.
+      *      new timeouts if required. CVs using CLOCK_MONOTONIC
+      *      (see pthread_condattr_setclock) are not broadcast.
       *
       *      This routine may be passed directly to pthread_create()
       *      as a new thread in order to run asynchronously.
@@ -89,20 +95,25 @@ pthread_timechange_handler_np (void *arg)
       */
 {
   int result = 0;
-  pthread_cond_t cv;
-  ptw32_mcs_local_node_t node;
+  int i;
 
-  ptw32_mcs_lock_acquire(&ptw32_cond_list_lock, &node);
+  for (i = 0; i < PTW32_COND_LIST_SHARDS && 0 == result; i++)
+    {
+      pthread_cond_t cv;
+      ptw32_mcs_local_node_t node;
 
-  cv = ptw32_cond_list_head;
+      ptw32_mcs_lock_acquire(&ptw32_cond_list[i].lock, &node);
 
-  while (cv != NULL && 0 == result)
-    {
-      result = pthread_cond_broadcast (&cv);
-      cv = cv->next;
-    }
+      cv = ptw32_cond_list[i].head;
+
+      while (cv != NULL && 0 == result)
+	{
+	  result = pthread_cond_broadcast (&cv);
+	  cv = cv->next;
+	}
 
-  ptw32_mcs_lock_release(&node);
+      ptw32_mcs_lock_release(&node);
+    }
 
   return (void *) (size_t) (result != 0 ? EAGAIN : 0);
 }
@@ -98,22 +98,9 @@ pthread_timedjoin_np (pthread_t thread, void **value_ptr, const struct timespec
 {
   int result;
   pthread_t self;
-  DWORD milliseconds;
   ptw32_thread_t * tp = (ptw32_thread_t *) thread.p;
   ptw32_mcs_local_node_t node;
 
-  if (abstime == NULL)
-    {
-      milliseconds = INFINITE;
-    }
-  else
-    {
-      /*
-       * Calculate timeout as milliseconds from current system time.
-       */
-      milliseconds = ptw32_relmillisecs (abstime);
-    }
-
   ptw32_mcs_lock_acquire(&ptw32_thread_reuse_lock, &node);
 
   if (NULL == tp
@@ -153,10 +140,11 @@ pthread_timedjoin_np (pthread_t thread, void **value_ptr, const struct timespec
            * Pthread_join is a cancellation point.
            * If we are canceled then our target thread must not be
            * detached (destroyed). This is guaranteed because
-           * pthreadCancelableTimedWait will not return if we
+           * ptw32_cancelable_abstimed_wait will not return if we
            * are canceled.
            */
-          result = pthreadCancelableTimedWait (tp->threadH, milliseconds);
+          PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_JOIN);
+          result = ptw32_cancelable_abstimed_wait (PTW32_THREAD_EXIT_HANDLE(tp), CLOCK_REALTIME, abstime);
 
           if (0 == result)
             {
@@ -0,0 +1,231 @@
+/*
+ * pthread_topology_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_num_numanodes_np (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the number of NUMA nodes, numbered from 0.
+      *
+      * RESULTS
+      *              the highest node number + 1, at least 1.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_topology_t * topology = ptw32_gettopology ();
+
+  return (topology != NULL ? topology->nNodes : 1);
+}
+
+
+int
+pthread_getnumanodecpus_np (int node, size_t cpusetsize, cpu_set_t * cpuset)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the CPUs of a NUMA node.
+      *
+      * PARAMETERS
+      *      node
+      *              a node number, less than
+      *              pthread_num_numanodes_np()
+      *
+      *      cpusetsize
+      *              the size of cpuset, usually sizeof(cpu_set_t)
+      *
+      *      cpuset
+      *              where to return the CPUs, which may be none
+      *
+      * RESULTS
+      *              0               successfully returned the CPUs,
+      *              EINVAL          'node' or 'cpuset' is invalid,
+      *              ENOMEM          no memory for the topology.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_topology_t * topology;
+  cpu_set_t nodeCpuset;
+
+  if (NULL == cpuset || node < 0)
+    {
+      return EINVAL;
+    }
+
+  if (NULL == (topology = ptw32_gettopology ()))
+    {
+      return ENOMEM;
+    }
+
+  if (node >= topology->nNodes)
+    {
+      return EINVAL;
+    }
+
+  ptw32_topologycpus (topology->node, node, &nodeCpuset);
+  ptw32_cpusetcopy (cpuset, cpusetsize, &nodeCpuset, sizeof (cpu_set_t));
+
+  return 0;
+}
+
+
+int
+pthread_getcpunumanode_np (int cpu, int * node)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the NUMA node of a CPU.
+      *
+      * PARAMETERS
+      *      cpu
+      *              a CPU number, as used in cpu_set_t
+      *
+      *      node
+      *              where to return the node
+      *
+      * RESULTS
+      *              0               successfully returned the node,
+      *              EINVAL          there is no CPU 'cpu', or
+      *                              'node' is NULL,
+      *              ENOMEM          no memory for the topology.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_topology_t * topology;
+
+  if (NULL == node || cpu < 0 || (size_t) cpu >= CPU_SETSIZE)
+    {
+      return EINVAL;
+    }
+
+  if (NULL == (topology = ptw32_gettopology ()))
+    {
+      return ENOMEM;
+    }
+
+  if (topology->node[cpu] < 0)
+    {
+      return EINVAL;
+    }
+
+  *node = topology->node[cpu];
+
+  return 0;
+}
+
+
+int
+pthread_getcpusiblings_np (int cpu, int relation, size_t cpusetsize, cpu_set_t * cpuset)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the CPUs that share a core, a cache or a NUMA
+      *      node with a CPU.
+      *
+      * PARAMETERS
+      *      cpu
+      *              a CPU number, as used in cpu_set_t
+      *
+      *      relation
+      *              PTHREAD_CPU_CORE_NP for the hardware threads
+      *              (SMT siblings) of the core,
+      *              PTHREAD_CPU_CACHE_NP for the CPUs sharing the
+      *              last level cache, usually L3,
+      *              PTHREAD_CPU_NUMANODE_NP for the CPUs of the
+      *              NUMA node
+      *
+      *      cpusetsize
+      *              the size of cpuset, usually sizeof(cpu_set_t)
+      *
+      *      cpuset
+      *              where to return the CPUs, including 'cpu'
+      *
+      * RESULTS
+      *              0               successfully returned the CPUs,
+      *              EINVAL          there is no CPU 'cpu', or
+      *                              'relation' or 'cpuset' is
+      *                              invalid,
+      *              ENOMEM          no memory for the topology.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_topology_t * topology;
+  const int * table;
+  cpu_set_t siblings;
+
+  if (NULL == cpuset || cpu < 0 || (size_t) cpu >= CPU_SETSIZE)
+    {
+      return EINVAL;
+    }
+
+  if (NULL == (topology = ptw32_gettopology ()))
+    {
+      return ENOMEM;
+    }
+
+  switch (relation)
+    {
+    case PTHREAD_CPU_CORE_NP:
+      table = topology->core;
+      break;
+    case PTHREAD_CPU_CACHE_NP:
+      table = topology->cache;
+      break;
+    case PTHREAD_CPU_NUMANODE_NP:
+      table = topology->node;
+      break;
+    default:
+      return EINVAL;
+    }
+
+  if (table[cpu] < 0)
+    {
+      return EINVAL;
+    }
+
+  ptw32_topologycpus (table, table[cpu], &siblings);
+  ptw32_cpusetcopy (cpuset, cpusetsize, &siblings, sizeof (cpu_set_t));
+
+  return 0;
+}
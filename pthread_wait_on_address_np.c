@@ -0,0 +1,248 @@
+/*
+ * pthread_wait_on_address_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include <string.h>
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Record (or clear) the location the calling thread waits on, so that
+ * pthread_cancel() can wake it.
+ */
+static void
+ptw32_set_wait_address (ptw32_thread_t * sp, volatile void * address)
+{
+  ptw32_mcs_local_node_t stateLock;
+
+  ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
+  sp->waitAddress = address;
+  ptw32_mcs_lock_release (&stateLock);
+}
+
+
+int
+ptw32_wait_on_address (volatile void * address, const void * expected,
+		       size_t size, clockid_t clock, const struct timespec * abstime,
+		       int stat)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      pthread_wait_on_address_np(), with abstime measured
+      *      against 'clock' (CLOCK_REALTIME or CLOCK_MONOTONIC),
+      *      counting the waits that block in the PTW32_LIBSTAT_*
+      *      counter 'stat'.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp;
+  ptw32_rcu_reader_t * rcu;
+  int cancelable;
+  int result = 0;
+  BOOL woken;
+
+  if (address == NULL || expected == NULL
+      || (size != 1 && size != 2 && size != 4 && size != 8)
+      || ((size_t) address & (size - 1)) != 0)
+    {
+      return EINVAL;
+    }
+
+  sp = (ptw32_thread_t *) pthread_self ().p;
+
+  if (sp == NULL)
+    {
+      return ENOMEM;
+    }
+
+  cancelable = (sp->cancelState == PTHREAD_CANCEL_ENABLE);
+
+  if (cancelable)
+    {
+      ptw32_set_wait_address (sp, address);
+    }
+
+  if ((rcu = sp->rcuReader) != NULL && rcu->ctr != 0)
+    {
+      PTW32_RCU_OFFLINE (rcu);
+    }
+  else
+    {
+      rcu = NULL;
+    }
+
+  for (;;)
+    {
+      if (cancelable && sp->state == PThreadStateCancelPending)
+	{
+	  result = ESRCH;
+	  break;
+	}
+
+      if (memcmp ((const void *) address, expected, size) != 0)
+	{
+	  break;
+	}
+
+      if (abstime != NULL && ptw32_rel100nanosecs (clock, abstime) <= 0)
+	{
+	  result = ETIMEDOUT;
+	  break;
+	}
+
+      if (cancelable
+	  && (abstime == NULL
+	      || ptw32_relmillisecs (clock, abstime) > PTW32_WAIT_ADDRESS_SLICE))
+	{
+	  /*
+	   * pthread_cancel() may have woken the location before we
+	   * were parked on it, so don't sleep on it indefinitely.
+	   */
+	  struct timespec slice;
+
+	  ptw32_monotonic_now (&slice);
+	  slice.tv_nsec += PTW32_WAIT_ADDRESS_SLICE * 1000000L;
+	  slice.tv_sec += slice.tv_nsec / 1000000000L;
+	  slice.tv_nsec %= 1000000000L;
+
+	  PTW32_LIBSTAT_WAIT (stat);
+	  woken = ptw32_waitonaddress_abstime (address, (PVOID) expected, size,
+					       CLOCK_MONOTONIC, &slice);
+	}
+      else
+	{
+	  PTW32_LIBSTAT_WAIT (stat);
+	  woken = ptw32_waitonaddress_abstime (address, (PVOID) expected, size,
+					       clock, abstime);
+	}
+
+      if (woken)
+	{
+	  break;
+	}
+    }
+
+  if (rcu != NULL)
+    {
+      PTW32_RCU_ONLINE (rcu);
+    }
+
+  if (cancelable)
+    {
+      ptw32_set_wait_address (sp, NULL);
+    }
+
+  if (result == ESRCH)
+    {
+      ptw32_mcs_local_node_t stateLock;
+      /*
+       * Canceling!
+       */
+      ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
+      if (sp->state < PThreadStateCanceling)
+	{
+	  sp->state = PThreadStateCanceling;
+	  sp->cancelState = PTHREAD_CANCEL_DISABLE;
+	  ptw32_mcs_lock_release (&stateLock);
+
+	  ptw32_throw (PTW32_EPS_CANCEL);
+
+	  /* Never reached */
+	}
+
+      ptw32_mcs_lock_release (&stateLock);
+    }
+
+  return result;
+}
+
+int
+pthread_wait_on_address_np (volatile void * address, const void * expected,
+			    size_t size, const struct timespec * abstime)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Blocks the calling thread while the 'size' bytes at
+      *      'address' hold the value at 'expected'.
+      *
+      * PARAMETERS
+      *      address
+      *              location to wait on; 1, 2, 4 or 8 bytes,
+      *              naturally aligned
+      *
+      *      expected
+      *              pointer to the value to wait against
+      *
+      *      size
+      *              1, 2, 4 or 8
+      *
+      *      abstime
+      *              CLOCK_REALTIME time to stop waiting at, or
+      *              NULL to wait until woken
+      *
+      * DESCRIPTION
+      *      Waits with WaitOnAddress where the system has it
+      *      (Windows 8 and later) and with the library's parking
+      *      lot otherwise. A thread that changes the location
+      *      calls pthread_wake_np() to release the waiters.
+      *
+      *      Like WaitOnAddress, the thread may return without the
+      *      location having changed, so callers check the value
+      *      and wait again.
+      *
+      *      This is a cancellation point: a pending cancel is acted
+      *      on before blocking, and pthread_cancel() wakes a thread
+      *      blocked here when its cancelability is enabled. As with
+      *      the library's other blocking waits, a wakeup that comes
+      *      together with the cancel is returned rather than
+      *      dropped. The calling thread is quiescent for RCU
+      *      while it waits.
+      *
+      * RESULTS
+      *              0               woken, or *address no longer holds
+      *                              the expected value,
+      *              ETIMEDOUT       abstime passed,
+      *              EINVAL          'address' or 'expected' is NULL,
+      *                              'address' is not aligned to 'size',
+      *                              or 'size' is not 1, 2, 4 or 8.
+      *
+      * ------------------------------------------------------
+      */
+{
+  return ptw32_wait_on_address (address, expected, size, CLOCK_REALTIME, abstime,
+				PTW32_LIBSTAT_WAIT_OTHER);
+}				/* pthread_wait_on_address_np */
@@ -0,0 +1,365 @@
+/*
+ * pthread_waitany_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "semaphore.h"
+#include "implement.h"
+
+
+/*
+ * Look at one object without blocking.
+ * Returns nonzero, with *result set, if it is ready.
+ */
+static int
+ptw32_waitany_poll (pthread_waitany_np_t * object, ptw32_thread_t * tp,
+		    HANDLE exitHandle, int * result)
+{
+  switch (object->type)
+    {
+    case PTHREAD_WAITANY_SEM_NP:
+      if (sem_trywait ((sem_t *) object->object) == 0)
+	{
+	  *result = 0;
+	  return 1;
+	}
+      if (errno != EAGAIN)
+	{
+	  *result = errno;
+	  return 1;
+	}
+      return 0;
+
+    case PTHREAD_WAITANY_QUEUE_NP:
+      *result = pthread_queue_trypop_np ((pthread_queue_np_t) object->object,
+					 &object->value);
+      return (*result != EAGAIN);
+
+    case PTHREAD_WAITANY_JOIN_NP:
+      if (WaitForSingleObject (exitHandle, 0) != WAIT_OBJECT_0)
+	{
+	  return 0;
+	}
+      /*
+       * As pthread_join() once the thread has exited, but without
+       * another cancellation point.
+       */
+      object->value = tp->exitStatus;
+      *result = pthread_detach (*(pthread_t *) object->object);
+      return 1;
+    }
+
+  return 0;
+}
+
+
+int
+pthread_waitany_np (pthread_waitany_np_t * objects, int n,
+		    const struct timespec * abstime, int * index)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits until one of a set of semaphores, queues and
+      *      threads is ready, and takes it.
+      *
+      * PARAMETERS
+      *      objects
+      *              array of 'n' objects to wait for, each with
+      *              its type and the object:
+      *              PTHREAD_WAITANY_SEM_NP     a sem_t *,
+      *              PTHREAD_WAITANY_QUEUE_NP   a pthread_queue_np_t,
+      *              PTHREAD_WAITANY_JOIN_NP    a pthread_t *
+      *
+      *      n
+      *              1 to PTHREAD_WAITANY_MAX_NP
+      *
+      *      abstime
+      *              CLOCK_REALTIME time to stop waiting at, or
+      *              NULL to wait until an object is ready
+      *
+      *      index
+      *              where the index of the ready object is returned
+      *
+      * DESCRIPTION
+      *      The objects are looked at in order and the first ready
+      *      one is taken, exactly as by sem_trywait(),
+      *      pthread_queue_trypop_np() or pthread_join(): a
+      *      semaphore is decremented, an item popped from a queue
+      *      into the object's 'value', or an exited thread joined
+      *      with its exit value returned in 'value'. The other
+      *      objects are left alone.
+      *
+      *      The thread sleeps until a semaphore is posted or a
+      *      thread exits, looking at its objects again each time.
+      *      Every post to a process private semaphore wakes every
+      *      thread blocked here, so this suits a few threads
+      *      multiplexing many sources rather than many threads.
+      *      Process shared semaphores can't be waited for.
+      *
+      *      This function is a cancellation point, where an object
+      *      that is ready at the same time as a cancel request is
+      *      taken and the cancel stays pending.
+      *
+      * RESULTS
+      *              0               *index is ready and was taken,
+      *              ETIMEDOUT       abstime passed,
+      *              EINVAL          NULL arguments, 'n' out of range,
+      *                              an unknown type, a process
+      *                              shared semaphore, or a detached
+      *                              thread,
+      *              ESRCH           no thread could be found,
+      *              EDEADLK         the calling thread is in the set,
+      *              ENOMEM          the thread's wakeup event couldn't
+      *                              be created.
+      *
+      *              Otherwise the error of the operation that took
+      *              object *index, which has been set.
+      *
+      * ------------------------------------------------------
+      */
+{
+  HANDLE handles[PTHREAD_WAITANY_MAX_NP + 2];
+  ptw32_thread_t * threads[PTHREAD_WAITANY_MAX_NP];
+  HANDLE exitHandles[PTHREAD_WAITANY_MAX_NP];
+  DWORD nHandles = 1;
+  DWORD cancelIndex = 0;
+  DWORD status;
+  ptw32_thread_t * sp;
+  ptw32_rcu_reader_t * rcu;
+  ptw32_waitany_waiter_t waiter;
+  ptw32_mcs_local_node_t node;
+  int result = 0;
+  int canceled = 0;
+  int i;
+
+  if (objects == NULL || index == NULL || n < 1 || n > PTHREAD_WAITANY_MAX_NP)
+    {
+      return EINVAL;
+    }
+
+  if ((sp = (ptw32_thread_t *) pthread_self ().p) == NULL)
+    {
+      return ENOMEM;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_thread_reuse_lock, &node);
+
+  for (i = 0; i < n && result == 0; i++)
+    {
+      threads[i] = NULL;
+      exitHandles[i] = NULL;
+
+      if (objects[i].object == NULL)
+	{
+	  result = EINVAL;
+	  continue;
+	}
+
+      switch (objects[i].type)
+	{
+	case PTHREAD_WAITANY_SEM_NP:
+	  if (*(sem_t *) objects[i].object == NULL
+	      || PTW32_IS_PSHARED (*(sem_t *) objects[i].object))
+	    {
+	      result = EINVAL;
+	    }
+	  break;
+
+	case PTHREAD_WAITANY_QUEUE_NP:
+	  break;
+
+	case PTHREAD_WAITANY_JOIN_NP:
+	  {
+	    pthread_t thread = *(pthread_t *) objects[i].object;
+	    ptw32_thread_t * tp = (ptw32_thread_t *) thread.p;
+
+	    if (tp == NULL || thread.x != tp->ptHandle.x)
+	      {
+		result = ESRCH;
+	      }
+	    else if (tp == sp)
+	      {
+		result = EDEADLK;
+	      }
+	    else if (tp->detachState == PTHREAD_CREATE_DETACHED)
+	      {
+		result = EINVAL;
+	      }
+	    else
+	      {
+		/* A joinable thread can't be reused before it is joined */
+		threads[i] = tp;
+		exitHandles[i] = PTW32_THREAD_EXIT_HANDLE (tp);
+		handles[nHandles++] = exitHandles[i];
+	      }
+	  }
+	  break;
+
+	default:
+	  result = EINVAL;
+	  break;
+	}
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  if (result != 0)
+    {
+      return result;
+    }
+
+  if (sp->waitanyEvent == NULL
+      && (sp->waitanyEvent = ptw32_libstat_handle (CreateEvent (NULL, PTW32_FALSE, PTW32_FALSE, NULL),
+							 PTW32_LIBSTAT_EVENTS)) == NULL)
+    {
+      return ENOMEM;
+    }
+
+  handles[0] = sp->waitanyEvent;
+
+  if (sp->cancelState == PTHREAD_CANCEL_ENABLE && ptw32_cancel_event (sp) != NULL)
+    {
+      cancelIndex = nHandles;
+      handles[nHandles++] = sp->cancelEvent;
+    }
+
+  waiter.event = sp->waitanyEvent;
+  waiter.prev = NULL;
+  ptw32_mcs_lock_acquire (&ptw32_waitany_lock, &node);
+  if ((waiter.next = ptw32_waitanyWaiters) != NULL)
+    {
+      waiter.next->prev = &waiter;
+    }
+  ptw32_waitanyWaiters = &waiter;
+  ptw32_mcs_lock_release (&node);
+
+  for (;;)
+    {
+      DWORD timeout = INFINITE;
+
+      for (i = 0; i < n; i++)
+	{
+	  if (ptw32_waitany_poll (&objects[i], threads[i], exitHandles[i], &result))
+	    {
+	      *index = i;
+	      break;
+	    }
+	}
+
+      if (i < n)
+	{
+	  break;
+	}
+
+      if (cancelIndex != 0 && sp->state == PThreadStateCancelPending)
+	{
+	  canceled = 1;
+	  result = ESRCH;
+	  break;
+	}
+
+      if (abstime != NULL && (timeout = ptw32_relmillisecs (CLOCK_REALTIME, abstime)) == 0)
+	{
+	  result = ETIMEDOUT;
+	  break;
+	}
+
+      /*
+       * An RCU reader is quiescent while it waits.
+       */
+      if ((rcu = sp->rcuReader) != NULL && rcu->ctr != 0)
+	{
+	  PTW32_RCU_OFFLINE (rcu);
+	}
+      else
+	{
+	  rcu = NULL;
+	}
+
+      PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_OTHER);
+      status = ptw32_wait_objects (nHandles, handles, timeout);
+
+      if (rcu != NULL)
+	{
+	  PTW32_RCU_ONLINE (rcu);
+	}
+
+      if (status == WAIT_FAILED)
+	{
+	  result = EINVAL;
+	  break;
+	}
+
+      /* Everything else, the cancel event included, is looked at again */
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_waitany_lock, &node);
+  if (waiter.prev != NULL)
+    {
+      waiter.prev->next = waiter.next;
+    }
+  else
+    {
+      ptw32_waitanyWaiters = waiter.next;
+    }
+  if (waiter.next != NULL)
+    {
+      waiter.next->prev = waiter.prev;
+    }
+  ptw32_mcs_lock_release (&node);
+
+  if (canceled)
+    {
+      ptw32_mcs_local_node_t stateLock;
+      /*
+       * Canceling!
+       */
+      ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
+      if (sp->state < PThreadStateCanceling)
+	{
+	  sp->state = PThreadStateCanceling;
+	  sp->cancelState = PTHREAD_CANCEL_DISABLE;
+	  ptw32_mcs_lock_release (&stateLock);
+
+	  ptw32_throw (PTW32_EPS_CANCEL);
+
+	  /* Never reached */
+	}
+
+      ptw32_mcs_lock_release (&stateLock);
+    }
+
+  return result;
+}				/* pthread_waitany_np */
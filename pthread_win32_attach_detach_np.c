@@ -38,15 +38,29 @@
 #include "implement.h"
 
 /*
- * Handle to quserex.dll 
+ * FLS callback for a thread with a POSIX handle, sp, that exits without
+ * having been detached. FlsFree calls it too, from the thread detaching
+ * the process, with each thread's value; only a thread's own handle is
+ * detached.
  */
-static HINSTANCE ptw32_h_quserex;
+static VOID WINAPI
+ptw32_fls_detach (PVOID sp)
+{
+  if (sp != NULL && sp == (PVOID) PTW32_SELF_THREAD ())
+    {
+      (void) pthread_win32_thread_detach_np ();
+    }
+}
 
 BOOL
 pthread_win32_process_attach_np ()
 {
-  TCHAR QuserExDLLPathBuf[1024];
   BOOL result = TRUE;
+  /*
+   * The optional system routines looked for below are mostly in
+   * kernel32.dll, which every process has loaded.
+   */
+  HMODULE h_kernel32 = GetModuleHandle (TEXT ("kernel32.dll"));
 
   result = ptw32_processInitialize ();
 
@@ -64,75 +78,366 @@ pthread_win32_process_attach_np ()
 #endif
 
   /*
-   * Load QUSEREX.DLL and try to get address of QueueUserAPCEx.
-   * Because QUSEREX.DLL requires a driver to be installed we will
-   * assume the DLL is in the system directory.
-   *
-   * This should take care of any security issues.
+   * QUSEREX.DLL is loaded when asynchronous cancellation is first
+   * needed. See ptw32_cancel_initialize.c.
    */
-#if defined(__GNUC__) || defined(PTW32_CONFIG_MSVC7)
-  if(GetSystemDirectory(QuserExDLLPathBuf, sizeof(QuserExDLLPathBuf)))
-  {
-    (void) strncat(QuserExDLLPathBuf,
-                   "\\QUSEREX.DLL",
-                   sizeof(QuserExDLLPathBuf) - strlen(QuserExDLLPathBuf) - 1);
-    ptw32_h_quserex = LoadLibrary(QuserExDLLPathBuf);
-  }
-#else
-  /* strncat is secure - this is just to avoid a warning */
-  if(GetSystemDirectory(QuserExDLLPathBuf, sizeof(QuserExDLLPathBuf)) &&
-     0 == strncat_s(QuserExDLLPathBuf, sizeof(QuserExDLLPathBuf), "\\QUSEREX.DLL", 12))
-  {
-    ptw32_h_quserex = LoadLibrary(QuserExDLLPathBuf);
-  }
-#endif
 
-  if (ptw32_h_quserex != NULL)
+  /*
+   * Look for QueueUserAPC2 (Windows 11 and later). A special user APC
+   * cancels a thread asynchronously without suspending it. Also look
+   * for SetThreadStackGuarantee (Windows Vista), for guard sizes.
+   */
+  if (h_kernel32 != NULL)
     {
-      ptw32_register_cancellation = (DWORD (*)(PAPCFUNC, HANDLE, DWORD))
-#if defined(NEED_UNICODE_CONSTS)
-	GetProcAddress (ptw32_h_quserex,
-			(const TCHAR *) TEXT ("QueueUserAPCEx"));
-#else
-	GetProcAddress (ptw32_h_quserex, (LPCSTR) "QueueUserAPCEx");
+      ptw32_queueuserapc2 = (BOOL (WINAPI *)(PAPCFUNC, HANDLE, ULONG_PTR, DWORD))
+        GetProcAddress (h_kernel32, (LPCSTR) "QueueUserAPC2");
+      ptw32_setthreadstackguarantee = (BOOL (WINAPI *)(PULONG))
+        GetProcAddress (h_kernel32, (LPCSTR) "SetThreadStackGuarantee");
+    }
+
+  if (ptw32_queueuserapc2 != NULL)
+    {
+      ptw32_features |= PTW32_SPECIAL_APC_CANCEL;
+    }
+
+#if !defined(NEED_WAITONADDRESS)
+  /*
+   * Look for WaitOnAddress and friends (Windows 8 and later). They are
+   * exported from an API set rather than kernel32.dll. The DLL is never
+   * unloaded because mutexes refer to these routines for the life of
+   * the process, including across a detach and re-attach.
+   */
+  if (NULL == ptw32_waitonaddress)
+    {
+      HINSTANCE h_synch = LoadLibrary (TEXT ("api-ms-win-core-synch-l1-2-0.dll"));
+
+      if (h_synch != NULL)
+        {
+          BOOL (WINAPI *waitonaddress) (volatile VOID *, PVOID, SIZE_T, DWORD);
+
+          waitonaddress = (BOOL (WINAPI *)(volatile VOID *, PVOID, SIZE_T, DWORD))
+            GetProcAddress (h_synch, (LPCSTR) "WaitOnAddress");
+          ptw32_wakebyaddresssingle = (VOID (WINAPI *)(PVOID))
+            GetProcAddress (h_synch, (LPCSTR) "WakeByAddressSingle");
+          ptw32_wakebyaddressall = (VOID (WINAPI *)(PVOID))
+            GetProcAddress (h_synch, (LPCSTR) "WakeByAddressAll");
+
+          if (waitonaddress != NULL
+              && ptw32_wakebyaddresssingle != NULL
+              && ptw32_wakebyaddressall != NULL)
+            {
+              /* Set last - its value selects the mutex wait backend */
+              ptw32_waitonaddress = waitonaddress;
+            }
+          else
+            {
+              ptw32_wakebyaddresssingle = NULL;
+              ptw32_wakebyaddressall = NULL;
+              (void) FreeLibrary (h_synch);
+            }
+        }
+    }
+
+  if (NULL == ptw32_waitonaddress)
+    {
+      /*
+       * Park on addresses in the library's own parking lot instead.
+       * Set last, as above.
+       */
+      ptw32_wakebyaddresssingle = ptw32_unpark_one;
+      ptw32_wakebyaddressall = ptw32_unpark_all;
+      ptw32_waitonaddress = ptw32_park;
+    }
+  else if (ptw32_waitonaddress != ptw32_park
+           && ptw32_fiber_os_waitonaddress != ptw32_park)
+    {
+      /* The system's, possibly wrapped for fibers */
+      ptw32_features |= PTW32_WAIT_ON_ADDRESS;
+    }
+
+  /*
+   * Look for Slim Reader/Writer locks. The TryAcquire routines need
+   * Windows 7; read/write locks also need WaitOnAddress for their timed
+   * lock calls, so don't bother without it.
+   */
+  if (h_kernel32 != NULL
+      && ptw32_waitonaddress != NULL
+      && NULL == ptw32_acquiresrwlockshared)
+    {
+      VOID (WINAPI *acquiresrwlockshared) (PVOID *);
+
+      acquiresrwlockshared = (VOID (WINAPI *)(PVOID *))
+        GetProcAddress (h_kernel32, (LPCSTR) "AcquireSRWLockShared");
+      ptw32_acquiresrwlockexclusive = (VOID (WINAPI *)(PVOID *))
+        GetProcAddress (h_kernel32, (LPCSTR) "AcquireSRWLockExclusive");
+      ptw32_tryacquiresrwlockshared = (BOOLEAN (WINAPI *)(PVOID *))
+        GetProcAddress (h_kernel32, (LPCSTR) "TryAcquireSRWLockShared");
+      ptw32_tryacquiresrwlockexclusive = (BOOLEAN (WINAPI *)(PVOID *))
+        GetProcAddress (h_kernel32, (LPCSTR) "TryAcquireSRWLockExclusive");
+      ptw32_releasesrwlockshared = (VOID (WINAPI *)(PVOID *))
+        GetProcAddress (h_kernel32, (LPCSTR) "ReleaseSRWLockShared");
+      ptw32_releasesrwlockexclusive = (VOID (WINAPI *)(PVOID *))
+        GetProcAddress (h_kernel32, (LPCSTR) "ReleaseSRWLockExclusive");
+
+      if (acquiresrwlockshared != NULL
+          && ptw32_acquiresrwlockexclusive != NULL
+          && ptw32_tryacquiresrwlockshared != NULL
+          && ptw32_tryacquiresrwlockexclusive != NULL
+          && ptw32_releasesrwlockshared != NULL
+          && ptw32_releasesrwlockexclusive != NULL)
+        {
+          /* Set last - its value selects the rwlock backend */
+          ptw32_acquiresrwlockshared = acquiresrwlockshared;
+        }
+    }
+
+  if (ptw32_acquiresrwlockshared != NULL)
+    {
+      ptw32_features |= PTW32_SRW_LOCKS;
+    }
 #endif
+
+  /*
+   * Look for the processor group routines (Windows 7). Without them
+   * only the primary group, CPUs 0 to sizeof(size_t)*8-1, is usable.
+   */
+  if (h_kernel32 != NULL && NULL == ptw32_setthreadgroupaffinity)
+    {
+      BOOL (WINAPI *setthreadgroupaffinity) (HANDLE, const ptw32_group_affinity_t *, ptw32_group_affinity_t *);
+
+      setthreadgroupaffinity = (BOOL (WINAPI *)(HANDLE, const ptw32_group_affinity_t *, ptw32_group_affinity_t *))
+        GetProcAddress (h_kernel32, (LPCSTR) "SetThreadGroupAffinity");
+      ptw32_getthreadgroupaffinity = (BOOL (WINAPI *)(HANDLE, ptw32_group_affinity_t *))
+        GetProcAddress (h_kernel32, (LPCSTR) "GetThreadGroupAffinity");
+      ptw32_getactiveprocessorgroupcount = (WORD (WINAPI *)(void))
+        GetProcAddress (h_kernel32, (LPCSTR) "GetActiveProcessorGroupCount");
+      ptw32_getactiveprocessorcount = (DWORD (WINAPI *)(WORD))
+        GetProcAddress (h_kernel32, (LPCSTR) "GetActiveProcessorCount");
+
+      if (setthreadgroupaffinity != NULL
+          && ptw32_getthreadgroupaffinity != NULL
+          && ptw32_getactiveprocessorgroupcount != NULL
+          && ptw32_getactiveprocessorcount != NULL)
+        {
+          /* Set last - its value selects the group-aware affinity code */
+          ptw32_setthreadgroupaffinity = setthreadgroupaffinity;
+        }
+      else
+        {
+          ptw32_getthreadgroupaffinity = NULL;
+          ptw32_getactiveprocessorgroupcount = NULL;
+          ptw32_getactiveprocessorcount = NULL;
+        }
     }
 
-  if (NULL == ptw32_register_cancellation)
+  if (ptw32_setthreadgroupaffinity != NULL)
     {
-      ptw32_register_cancellation = ptw32_Registercancellation;
+      ptw32_features |= PTW32_PROCESSOR_GROUPS;
+    }
 
-      if (ptw32_h_quserex != NULL)
-	{
-	  (void) FreeLibrary (ptw32_h_quserex);
-	}
-      ptw32_h_quserex = 0;
+  /*
+   * The processor topology. Without it the topology routines report
+   * one NUMA node, one cache and a core for each processor, and
+   * cohort mutexes queue every thread on node 0.
+   */
+  if (h_kernel32 != NULL && NULL == ptw32_getlogicalprocessorinformationex)
+    {
+      ptw32_getlogicalprocessorinformationex = (BOOL (WINAPI *)(DWORD, ptw32_processor_info_t *, PDWORD))
+        GetProcAddress (h_kernel32, (LPCSTR) "GetLogicalProcessorInformationEx");
+      ptw32_getcurrentprocessornumberex = (VOID (WINAPI *)(ptw32_processor_number_t *))
+        GetProcAddress (h_kernel32, (LPCSTR) "GetCurrentProcessorNumberEx");
     }
-  else
+
+  /*
+   * Thread cycle counts for pthread_getstats_np, and other threads'
+   * CPU time clocks (see pthread_getcpuclockid).
+   */
+  if (h_kernel32 != NULL && NULL == ptw32_querythreadcycletime)
     {
-      /* Initialise QueueUserAPCEx */
-      BOOL (*queue_user_apc_ex_init) (VOID);
+      ptw32_querythreadcycletime = (BOOL (WINAPI *)(HANDLE, PULONG64))
+        GetProcAddress (h_kernel32, (LPCSTR) "QueryThreadCycleTime");
+      ptw32_openthread = (HANDLE (WINAPI *)(DWORD, BOOL, DWORD))
+        GetProcAddress (h_kernel32, (LPCSTR) "OpenThread");
+    }
 
-      queue_user_apc_ex_init = (BOOL (*)(VOID))
-#if defined(NEED_UNICODE_CONSTS)
-	GetProcAddress (ptw32_h_quserex,
-			(const TCHAR *) TEXT ("QueueUserAPCEx_Init"));
-#else
-	GetProcAddress (ptw32_h_quserex, (LPCSTR) "QueueUserAPCEx_Init");
+  /*
+   * The asymmetric barrier SPSC channels park with (see ptw32_spsc.c).
+   */
+  if (h_kernel32 != NULL && NULL == ptw32_flushprocesswritebuffers)
+    {
+      ptw32_flushprocesswritebuffers = (VOID (WINAPI *)(void))
+        GetProcAddress (h_kernel32, (LPCSTR) "FlushProcessWriteBuffers");
+    }
+
+  /*
+   * Thread power throttling for pthread_setqos_np. It is accepted by
+   * Windows 10 version 1709 and later only.
+   */
+  if (h_kernel32 != NULL && NULL == ptw32_setthreadinformation)
+    {
+      ptw32_setthreadinformation = (BOOL (WINAPI *)(HANDLE, int, LPVOID, DWORD))
+        GetProcAddress (h_kernel32, (LPCSTR) "SetThreadInformation");
+    }
+
+  /*
+   * Thread names for debuggers and profilers, Windows 10 version 1607
+   * and later. See pthread_setname_np.c.
+   */
+  if (h_kernel32 != NULL && NULL == ptw32_setthreaddescription)
+    {
+      ptw32_setthreaddescription = (HRESULT (WINAPI *)(HANDLE, const WCHAR *))
+        GetProcAddress (h_kernel32, (LPCSTR) "SetThreadDescription");
+    }
+
+  /*
+   * Aborting the blocking I/O of a cancelled thread, for
+   * pthread_io_begin_np. Windows Vista and later.
+   */
+  if (h_kernel32 != NULL && NULL == ptw32_cancelsynchronousio)
+    {
+      ptw32_cancelsynchronousio = (BOOL (WINAPI *)(HANDLE))
+        GetProcAddress (h_kernel32, (LPCSTR) "CancelSynchronousIo");
+    }
+
+  /*
+   * The thread pool that pooled threads run on (see
+   * pthread_attr_setpooled_np). Windows Vista and later.
+   */
+  if (h_kernel32 != NULL && NULL == ptw32_createthreadpool)
+    {
+      ptw32_setthreadpoolthreadminimum = (BOOL (WINAPI *)(PVOID, DWORD))
+        GetProcAddress (h_kernel32, (LPCSTR) "SetThreadpoolThreadMinimum");
+      ptw32_createthreadpoolwork = (PVOID (WINAPI *)(ptw32_tp_work_callback_t, PVOID, ptw32_tp_environ_t *))
+        GetProcAddress (h_kernel32, (LPCSTR) "CreateThreadpoolWork");
+      ptw32_submitthreadpoolwork = (VOID (WINAPI *)(PVOID))
+        GetProcAddress (h_kernel32, (LPCSTR) "SubmitThreadpoolWork");
+      ptw32_closethreadpoolwork = (VOID (WINAPI *)(PVOID))
+        GetProcAddress (h_kernel32, (LPCSTR) "CloseThreadpoolWork");
+      ptw32_callbackmayrunlong = (BOOL (WINAPI *)(PVOID))
+        GetProcAddress (h_kernel32, (LPCSTR) "CallbackMayRunLong");
+
+      if (ptw32_setthreadpoolthreadminimum != NULL
+          && ptw32_createthreadpoolwork != NULL
+          && ptw32_submitthreadpoolwork != NULL
+          && ptw32_closethreadpoolwork != NULL
+          && ptw32_callbackmayrunlong != NULL)
+        {
+          /* Set last: it says the rest are there */
+          ptw32_createthreadpool = (PVOID (WINAPI *)(PVOID))
+            GetProcAddress (h_kernel32, (LPCSTR) "CreateThreadpool");
+        }
+    }
+
+  /*
+   * CPU Sets, for pthread_setsoftaffinity_np. The masks call takes our
+   * per-group masks directly; with only the id based one the CPU Set
+   * ids are looked up.
+   */
+  if (h_kernel32 != NULL
+      && NULL == ptw32_setthreadselectedcpusetmasks
+      && NULL == ptw32_setthreadselectedcpusets)
+    {
+      ptw32_setthreadselectedcpusetmasks = (BOOL (WINAPI *)(HANDLE, ptw32_group_affinity_t *, USHORT))
+        GetProcAddress (h_kernel32, (LPCSTR) "SetThreadSelectedCpuSetMasks");
+      ptw32_setthreadselectedcpusets = (BOOL (WINAPI *)(HANDLE, const ULONG *, ULONG))
+        GetProcAddress (h_kernel32, (LPCSTR) "SetThreadSelectedCpuSets");
+      ptw32_getsystemcpusetinformation = (BOOL (WINAPI *)(ptw32_cpu_set_info_t *, ULONG, PULONG, HANDLE, ULONG))
+        GetProcAddress (h_kernel32, (LPCSTR) "GetSystemCpuSetInformation");
+
+      if (NULL == ptw32_getsystemcpusetinformation)
+        {
+          ptw32_setthreadselectedcpusets = NULL;
+        }
+    }
+
+  if (ptw32_setthreadselectedcpusetmasks != NULL
+      || ptw32_setthreadselectedcpusets != NULL)
+    {
+      ptw32_features |= PTW32_SOFT_AFFINITY;
+    }
+
+#if !defined(NEED_FTIME)
+  /*
+   * Look for a precise clock and high resolution waitable timers for
+   * timed waits. Without them timeouts have the resolution of the
+   * system clock tick. CreateWaitableTimerExW exists before Windows 10
+   * version 1803 but rejects the high resolution flag, so try it.
+   */
+  if (h_kernel32 != NULL && NULL == ptw32_createwaitabletimerex)
+    {
+      HANDLE (WINAPI *createwaitabletimerex) (LPSECURITY_ATTRIBUTES, LPCWSTR, DWORD, DWORD);
+
+      ptw32_getsystemtimepreciseasfiletime = (VOID (WINAPI *)(LPFILETIME))
+        GetProcAddress (h_kernel32, (LPCSTR) "GetSystemTimePreciseAsFileTime");
+      createwaitabletimerex = (HANDLE (WINAPI *)(LPSECURITY_ATTRIBUTES, LPCWSTR, DWORD, DWORD))
+        GetProcAddress (h_kernel32, (LPCSTR) "CreateWaitableTimerExW");
+
+      if (createwaitabletimerex != NULL)
+        {
+          HANDLE timer = createwaitabletimerex (NULL, NULL,
+                                                CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                                TIMER_ALL_ACCESS);
+
+          if (timer != NULL)
+            {
+              (void) CloseHandle (timer);
+              ptw32_createwaitabletimerex = createwaitabletimerex;
+            }
+        }
+    }
+
+  if (ptw32_createwaitabletimerex != NULL)
+    {
+      ptw32_features |= PTW32_HIGH_RES_TIMEOUTS;
+    }
 #endif
 
-      if (queue_user_apc_ex_init == NULL || !queue_user_apc_ex_init ())
-	{
-	  ptw32_register_cancellation = ptw32_Registercancellation;
+  /*
+   * With FLS, a thread with a POSIX handle is detached by the callback
+   * of the value set when it got the handle, so the DLL needn't run
+   * for every thread in the process. See dll.c.
+   */
+  if (h_kernel32 != NULL && FLS_OUT_OF_INDEXES == ptw32_flsIndex)
+    {
+      DWORD (WINAPI *flsalloc) (VOID (WINAPI *) (PVOID));
+
+      flsalloc = (DWORD (WINAPI *)(VOID (WINAPI *) (PVOID)))
+        GetProcAddress (h_kernel32, (LPCSTR) "FlsAlloc");
+      ptw32_flssetvalue = (BOOL (WINAPI *)(DWORD, PVOID))
+        GetProcAddress (h_kernel32, (LPCSTR) "FlsSetValue");
+      ptw32_flsfree = (BOOL (WINAPI *)(DWORD))
+        GetProcAddress (h_kernel32, (LPCSTR) "FlsFree");
+
+      if (flsalloc != NULL && ptw32_flssetvalue != NULL && ptw32_flsfree != NULL)
+        {
+          ptw32_flsIndex = flsalloc (ptw32_fls_detach);
+        }
+    }
 
-	  (void) FreeLibrary (ptw32_h_quserex);
-	  ptw32_h_quserex = 0;
-	}
+  if (ptw32_flsIndex != FLS_OUT_OF_INDEXES)
+    {
+      ptw32_features |= PTW32_THREAD_EXIT_FLS;
     }
 
-  if (ptw32_h_quserex)
+  /*
+   * The large page size, for PTHREAD_PARAM_LARGE_PAGES_NP. Whether
+   * large pages can be had is found out when they are first wanted
+   * (see ptw32_largepage.c).
+   */
+  if (h_kernel32 != NULL && NULL == ptw32_getlargepageminimum)
     {
-      ptw32_features |= PTW32_ALERTABLE_ASYNC_CANCEL;
+      ptw32_getlargepageminimum = (SIZE_T (WINAPI *)(void))
+        GetProcAddress (h_kernel32, (LPCSTR) "GetLargePageMinimum");
+    }
+
+  /*
+   * Elided mutexes and read/write locks need RTM. See ptw32_lock_elide.c.
+   */
+  ptw32_lockElide = ptw32_lock_elide_probe ();
+
+  if (ptw32_lockElide)
+    {
+      ptw32_features |= PTW32_LOCK_ELISION;
     }
 
   return result;
@@ -144,7 +449,16 @@ pthread_win32_process_detach_np ()
 {
   if (ptw32_processInitialized)
     {
-      ptw32_thread_t * sp = (ptw32_thread_t *) pthread_getspecific (ptw32_selfThreadKey);
+      ptw32_thread_t * sp = PTW32_SELF_THREAD ();
+
+      if (ptw32_fastExit)
+	{
+	  /*
+	   * The process is exiting: leave its memory and handles to the
+	   * OS. See ptw32_processTerminate().
+	   */
+	  sp = NULL;
+	}
 
       if (sp != NULL)
 	{
@@ -154,11 +468,22 @@ pthread_win32_process_detach_np ()
 	   */
 	  if (sp->detachState == PTHREAD_CREATE_DETACHED)
 	    {
+	      /*
+	       * Clear the association first so that MCS locks taken
+	       * while destroying sp don't use its cached event.
+	       */
+	      (void) pthread_setspecific (ptw32_selfThreadKey, NULL);
 	      ptw32_threadDestroy (sp->ptHandle);
-	      TlsSetValue (ptw32_selfThreadKey->key, NULL);
 	    }
 	}
 
+      if (ptw32_flsIndex != FLS_OUT_OF_INDEXES && !ptw32_fastExit)
+	{
+	  /* Calls ptw32_fls_detach for every thread's value */
+	  (void) ptw32_flsfree (ptw32_flsIndex);
+	  ptw32_flsIndex = FLS_OUT_OF_INDEXES;
+	}
+
       /*
        * The DLL is being unmapped from the process's address space
        */
@@ -182,6 +507,7 @@ pthread_win32_process_detach_np ()
 	      (void) queue_user_apc_ex_fini ();
 	    }
 	  (void) FreeLibrary (ptw32_h_quserex);
+	  ptw32_h_quserex = 0;
 	}
     }
 
@@ -203,11 +529,16 @@ pthread_win32_thread_detach_np ()
        * Don't use pthread_self() - to avoid creating an implicit POSIX thread handle
        * unnecessarily.
        */
-      ptw32_thread_t * sp = (ptw32_thread_t *) pthread_getspecific (ptw32_selfThreadKey);
+      ptw32_thread_t * sp = PTW32_SELF_THREAD ();
 
       if (sp != NULL) // otherwise Win32 thread with no implicit POSIX handle.
 	{
           ptw32_mcs_local_node_t stateLock;
+	  void (PTW32_CDECL * joinCallback) (pthread_t, void *, void *);
+	  volatile LONG * joinCount;
+
+	  /* This is the detach; the FLS callback mustn't repeat it */
+	  PTW32_FLS_ATTACH (NULL);
 	  ptw32_callUserDestroyRoutines (sp->ptHandle);
 
 	  ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
@@ -216,6 +547,9 @@ pthread_win32_thread_detach_np ()
 	   * If the thread is joinable at this point then it MUST be joined
 	   * or detached explicitly by the application.
 	   */
+	  joinCallback = sp->joinCallback;
+	  joinCount = sp->joinCount;
+	  sp->joinCount = NULL;
 	  ptw32_mcs_lock_release (&stateLock);
 
           /*
@@ -226,22 +560,53 @@ pthread_win32_thread_detach_np ()
               pthread_mutex_t mx = sp->robustMxList->mx;
               ptw32_robust_mutex_remove(&mx, sp);
               (void) PTW32_INTERLOCKED_EXCHANGE_LONG(
-                       (PTW32_INTERLOCKED_LONGPTR)&mx->robustNode->stateInconsistent,
+                       (PTW32_INTERLOCKED_LONGPTR)&mx->robustNode.stateInconsistent,
                        (PTW32_INTERLOCKED_LONG)-1);
               /*
                * If there are no waiters then the next thread to block will
                * sleep, wakeup immediately and then go back to sleep.
                * See pthread_mutex_lock.c.
                */
-              SetEvent(mx->event);
+              (void) ptw32_mutex_wake (mx);
             }
 
+          /*
+           * Priority protocol mutexes
+           */
+          ptw32_mutex_prio_quit (sp);
+
+
+	  if (joinCallback != NULL)
+	    {
+	      /* See pthread_join_async_np() */
+	      joinCallback (sp->ptHandle, sp->exitStatus, sp->joinArg);
+	    }
+
+	  if (joinCount != NULL
+	      && 0 == PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) joinCount))
+	    {
+	      /* See pthread_join_n_np(); the count may be gone now */
+	      ptw32_wakebyaddressall ((PVOID) joinCount);
+	    }
 
 	  if (sp->detachState == PTHREAD_CREATE_DETACHED)
 	    {
+	      /* See pthread_win32_process_detach_np() */
+	      (void) pthread_setspecific (ptw32_selfThreadKey, NULL);
 	      ptw32_threadDestroy (sp->ptHandle);
-
-	      TlsSetValue (ptw32_selfThreadKey->key, NULL);
+	    }
+	  else if (!sp->cached)
+	    {
+	      /*
+	       * Let a joiner have the struct now rather than when the OS
+	       * thread has finished exiting and its handle is signalled.
+	       * sp mustn't be touched after this. A cached thread does
+	       * the same with its exit event (see ptw32_threadCachePark).
+	       */
+	      (void) pthread_setspecific (ptw32_selfThreadKey, NULL);
+	      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &sp->exited,
+						      (PTW32_INTERLOCKED_LONG) 1);
+	      ptw32_wakebyaddressall ((PVOID) &sp->exited);
 	    }
 	}
     }
@@ -249,8 +614,51 @@ pthread_win32_thread_detach_np ()
   return TRUE;
 }
 
+BOOL
+pthread_win32_set_fast_exit_np (BOOL enable)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Selects whether process detach frees the library's
+      *      memory and closes its handles.
+      *
+      * PARAMETERS
+      *      enable
+      *              TRUE to leave them to the OS at exit,
+      *              FALSE (the default) to free them.
+      *
+      * DESCRIPTION
+      *      With fast exit on, pthread_win32_process_detach_np()
+      *      doesn't destroy the calling thread's handle, free the
+      *      pthread_t structs on the reuse stack or close the
+      *      library's TLS indexes and other handles, all of which
+      *      the OS reclaims when the process exits anyway. It still
+      *      drops the process's references to named and process
+      *      shared objects, which other processes can see.
+      *
+      *      Only turn it on in programs that exit without unloading
+      *      the library; a dll unloaded with FreeLibrary leaks.
+      *
+      * RESULTS
+      *              The previous setting.
+      *
+      * ------------------------------------------------------
+      */
+{
+  BOOL previous = (BOOL) ptw32_fastExit;
+
+  ptw32_fastExit = (enable ? PTW32_TRUE : PTW32_FALSE);
+
+  return previous;
+}
+
 BOOL
 pthread_win32_test_features_np (int feature_mask)
 {
+  if (feature_mask & PTW32_ALERTABLE_ASYNC_CANCEL)
+    {
+      ptw32_cancel_initialize ();
+    }
+
   return ((ptw32_features & feature_mask) == feature_mask);
 }
@@ -0,0 +1,235 @@
+/*
+ * pthread_wsdeque_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_wsdeque_create_np (pthread_wsdeque_np_t * deque)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Creates an empty work-stealing deque.
+      *
+      * PARAMETERS
+      *      deque
+      *              pointer to an instance of pthread_wsdeque_np_t
+      *
+      * DESCRIPTION
+      *      The deque belongs to one owner thread, which pushes
+      *      and pops items at its bottom, newest first; any
+      *      thread may steal items from its top, oldest first.
+      *      Push, pop and steal take no lock: the deque is the
+      *      one the library's thread pools are built on. It grows
+      *      as needed and is only shrunk by being destroyed.
+      *
+      * RESULTS
+      *              0               successfully created deque,
+      *              EINVAL          'deque' is invalid,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_wsdeque_np_t dq;
+  int result;
+
+  if (deque == NULL)
+    {
+      return EINVAL;
+    }
+
+  dq = (pthread_wsdeque_np_t) ptw32_object_alloc (sizeof (*dq), PTW32_CACHE_LINE_SIZE);
+
+  if (dq == NULL)
+    {
+      return ENOMEM;
+    }
+
+  if (0 != (result = ptw32_wsdeque_init (dq)))
+    {
+      ptw32_object_free (dq);
+      return result;
+    }
+
+  *deque = dq;
+
+  return 0;
+}				/* pthread_wsdeque_create_np */
+
+
+int
+pthread_wsdeque_destroy_np (pthread_wsdeque_np_t * deque)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Destroys a work-stealing deque.
+      *
+      * PARAMETERS
+      *      deque
+      *              pointer to an instance of pthread_wsdeque_np_t
+      *
+      * DESCRIPTION
+      *      No thread may be using the deque. Items still in it
+      *      are discarded; the deque doesn't own what they point
+      *      to.
+      *
+      * RESULTS
+      *              0               successfully destroyed deque,
+      *              EINVAL          'deque' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_wsdeque_np_t dq;
+
+  if (deque == NULL || (dq = *deque) == NULL)
+    {
+      return EINVAL;
+    }
+
+  *deque = NULL;
+  ptw32_wsdeque_free (dq);
+  ptw32_object_free (dq);
+
+  return 0;
+}				/* pthread_wsdeque_destroy_np */
+
+
+int
+pthread_wsdeque_push_np (pthread_wsdeque_np_t deque, void * item)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Pushes an item on the bottom of the deque. Only the
+      *      deque's owner may call it.
+      *
+      * PARAMETERS
+      *      deque
+      *              an instance of pthread_wsdeque_np_t
+      *
+      *      item
+      *              the item, which may be NULL
+      *
+      * RESULTS
+      *              0               the item was pushed,
+      *              EINVAL          'deque' is invalid,
+      *              ENOMEM          the deque is full and couldn't
+      *                              grow.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (deque == NULL)
+    {
+      return EINVAL;
+    }
+
+  return ptw32_wsdeque_push (deque, item);
+}				/* pthread_wsdeque_push_np */
+
+
+int
+pthread_wsdeque_pop_np (pthread_wsdeque_np_t deque, void ** item)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Pops the newest item from the bottom of the deque.
+      *      Only the deque's owner may call it.
+      *
+      * PARAMETERS
+      *      deque
+      *              an instance of pthread_wsdeque_np_t
+      *
+      *      item
+      *              pointer to where the item is returned
+      *
+      * RESULTS
+      *              0               an item was popped,
+      *              EINVAL          'deque' or 'item' is invalid,
+      *              EAGAIN          the deque is empty.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (deque == NULL || item == NULL)
+    {
+      return EINVAL;
+    }
+
+  return ptw32_wsdeque_pop (deque, item);
+}				/* pthread_wsdeque_pop_np */
+
+
+int
+pthread_wsdeque_steal_np (pthread_wsdeque_np_t deque, void ** item)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Steals the oldest item from the top of the deque.
+      *
+      * PARAMETERS
+      *      deque
+      *              an instance of pthread_wsdeque_np_t
+      *
+      *      item
+      *              pointer to where the item is returned
+      *
+      * DESCRIPTION
+      *      Any thread may steal, the owner included. A thief
+      *      that loses the race for the top item to another
+      *      thief or to the owner gets EBUSY rather than trying
+      *      again itself, so that a scheduler can move on to
+      *      another victim.
+      *
+      * RESULTS
+      *              0               an item was stolen,
+      *              EINVAL          'deque' or 'item' is invalid,
+      *              EAGAIN          the deque is empty,
+      *              EBUSY           another thread took the item
+      *                              first.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (deque == NULL || item == NULL)
+    {
+      return EINVAL;
+    }
+
+  return ptw32_wsdeque_steal (deque, item);
+}				/* pthread_wsdeque_steal_np */
@@ -109,26 +109,72 @@ ptw32_mcs_flag_set (HANDLE * flag)
   if ((HANDLE)0 != e)
     {
       /* another thread has already stored an event handle in the flag */
-      SetEvent(e);
+      PTW32_SETEVENT (e);
     }
 }
 
 /*
  * ptw32_mcs_flag_wait -- wait for notification from another.
  * 
- * Store an event handle in the flag and wait on it if the flag has not been
- * set, and proceed without creating an event otherwise.
+ * Poll the flag for up to ptw32_mcs_spin_limit iterations. If it is still
+ * not set, store an event handle in the flag and wait on it, and proceed
+ * without an event otherwise.
+ *
+ * The event is borrowed from the calling POSIX thread's cache if it has
+ * one, and is returned to the cache afterwards: it is auto-reset and is
+ * signalled at most once, by ptw32_mcs_flag_set, before the wait returns,
+ * so it is always unsignalled again here.
  */
 INLINE void 
 ptw32_mcs_flag_wait (HANDLE * flag)
 {
   if ((PTW32_INTERLOCKED_SIZE)0 ==
-        PTW32_INTERLOCKED_EXCHANGE_ADD_SIZE((PTW32_INTERLOCKED_SIZEPTR)flag,
-                                            (PTW32_INTERLOCKED_SIZE)0)) /* MBR fence */
+        PTW32_ATOMIC_LOAD_ACQ_SIZE((PTW32_INTERLOCKED_SIZEPTR)flag))
     {
-      /* the flag is not set. create event. */
+      ptw32_thread_t * sp = NULL;
+      HANDLE e = NULL;
+      int spins;
+      int yields = 0;
+
+      /* the flag is not set. spin on our own node for a while. */
+      for (spins = ptw32_mcs_spin_limit; spins > 0; spins--)
+        {
+          PTW32_YIELD_PROCESSOR();
+
+          if ((PTW32_INTERLOCKED_SIZE)0 != PTW32_ATOMIC_LOAD_ACQ_SIZE((PTW32_INTERLOCKED_SIZEPTR)flag))
+            {
+              return;
+            }
+        }
 
-      HANDLE e = CreateEvent(NULL, PTW32_FALSE, PTW32_FALSE, NULL);
+      /* still not set. get an event. */
+      if (ptw32_selfThreadKey != NULL
+          && NULL != (sp = PTW32_SELF_THREAD ()))
+        {
+          e = sp->mcsEvent;
+          sp->mcsEvent = NULL;
+        }
+
+      if (NULL == e)
+        {
+          e = ptw32_libstat_handle (CreateEvent (NULL, PTW32_FALSE, PTW32_FALSE, NULL),
+                                    PTW32_LIBSTAT_EVENTS);
+          if (NULL != e)
+            {
+              PTW32_LIBSTAT_ADD (PTW32_LIBSTAT_MCS_EVENTS, 1);
+            }
+        }
+
+      if (NULL == e)
+        {
+          /* no event available. fall back to yielding until the flag is set. */
+          while ((PTW32_INTERLOCKED_SIZE)0 ==
+                   PTW32_ATOMIC_LOAD_ACQ_SIZE((PTW32_INTERLOCKED_SIZEPTR)flag))
+            {
+              ptw32_yield(&yields);
+            }
+          return;
+        }
 
       if ((PTW32_INTERLOCKED_SIZE)0 == PTW32_INTERLOCKED_COMPARE_EXCHANGE_SIZE(
 			                  (PTW32_INTERLOCKED_SIZEPTR)flag,
@@ -136,10 +182,19 @@ ptw32_mcs_flag_wait (HANDLE * flag)
 			                  (PTW32_INTERLOCKED_SIZE)0))
 	{
 	  /* stored handle in the flag. wait on it now. */
+	  PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_OTHER);
 	  WaitForSingleObject(e, INFINITE);
 	}
 
-      CloseHandle(e);
+      if (sp != NULL && sp->mcsEvent == NULL)
+        {
+          /* keep the event for this thread's next wait */
+          sp->mcsEvent = e;
+        }
+      else
+        {
+          ptw32_closehandle (e, PTW32_LIBSTAT_EVENTS);
+        }
     }
 }
 
@@ -194,7 +249,7 @@ ptw32_mcs_lock_release (ptw32_mcs_local_node_t * node)
   ptw32_mcs_lock_t *lock = node->lock;
   ptw32_mcs_local_node_t *next =
     (ptw32_mcs_local_node_t *)
-      PTW32_INTERLOCKED_EXCHANGE_ADD_SIZE((PTW32_INTERLOCKED_SIZEPTR)&node->next, (PTW32_INTERLOCKED_SIZE)0); /* MBR fence */
+      PTW32_ATOMIC_LOAD_ACQ_SIZE((PTW32_INTERLOCKED_SIZEPTR)&node->next);
 
   if (0 == next)
     {
@@ -212,7 +267,7 @@ ptw32_mcs_lock_release (ptw32_mcs_local_node_t * node)
       /* wait for successor */
       ptw32_mcs_flag_wait(&node->nextFlag);
       next = (ptw32_mcs_local_node_t *)
-	PTW32_INTERLOCKED_EXCHANGE_ADD_SIZE((PTW32_INTERLOCKED_SIZEPTR)&node->next, (PTW32_INTERLOCKED_SIZE)0); /* MBR fence */
+	PTW32_ATOMIC_LOAD_ACQ_SIZE((PTW32_INTERLOCKED_SIZEPTR)&node->next);
     }
 
   /* pass the lock */
@@ -267,12 +322,12 @@ ptw32_mcs_node_transfer (ptw32_mcs_local_node_t * new_node, ptw32_mcs_local_node
        != old_node)
     {
       /*
-       * A successor has queued after us, so wait for them to link to us
+       * A successor has queued after us, so wait for them to link to us.
+       * Wait for nextFlag rather than next: the successor sets it after
+       * next, and old_node may be on a stack that is about to be reused.
        */
-      while (old_node->next == 0)
-        {
-          sched_yield();
-        }
-      new_node->next = old_node->next;
+      ptw32_mcs_flag_wait(&old_node->nextFlag);
+      new_node->next = (ptw32_mcs_local_node_t *)
+	PTW32_ATOMIC_LOAD_ACQ_SIZE((PTW32_INTERLOCKED_SIZEPTR)&old_node->next);
     }
 }
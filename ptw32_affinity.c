@@ -0,0 +1,399 @@
+/*
+ * ptw32_affinity.c
+ *
+ * Description:
+ * This translation unit implements routines which are private to
+ * the implementation and may be used throughout it.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+#if ! defined(NEED_PROCESS_AFFINITY_MASK)
+
+/*
+ * The number of processor groups, up to PTW32_CPU_SET_GROUPS, that a
+ * cpu_set_t describes on this system.
+ */
+static WORD
+ptw32_affinityGroups (void)
+{
+  WORD groups = 1;
+
+  if (ptw32_setthreadgroupaffinity != NULL)
+    {
+      groups = ptw32_getactiveprocessorgroupcount ();
+
+      if (groups > PTW32_CPU_SET_GROUPS)
+	{
+	  groups = PTW32_CPU_SET_GROUPS;
+	}
+      else if (0 == groups)
+	{
+	  groups = 1;
+	}
+    }
+
+  return groups;
+}
+
+
+int
+ptw32_getprocessaffinity (cpu_set_t * cpuset)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns the CPUs available to the process in every
+      *      processor group. Win32 keeps no affinity mask for a
+      *      process whose threads span groups, so on a system
+      *      with more than one group every active processor is
+      *      returned.
+      *
+      * RESULTS
+      *              0               success
+      *              EAGAIN          the process affinity could not
+      *                              be read
+      *
+      * ------------------------------------------------------
+      */
+{
+  _sched_cpu_set_vector_ * v = (_sched_cpu_set_vector_ *) cpuset;
+  WORD groups = ptw32_affinityGroups ();
+  WORD group;
+
+  CPU_ZERO (cpuset);
+
+  if (groups > 1)
+    {
+      for (group = 0; group < groups; group++)
+	{
+	  DWORD n = ptw32_getactiveprocessorcount (group);
+
+	  v->_cpuset[group] = (n >= PTW32_CPU_GROUP_SIZE
+			       ? ~(size_t) 0 : ((size_t) 1 << n) - 1);
+	}
+    }
+  else
+    {
+      DWORD_PTR vProcessMask;
+      DWORD_PTR vSystemMask;
+
+      if (!GetProcessAffinityMask (GetCurrentProcess (),
+				   &vProcessMask, &vSystemMask))
+	{
+	  return EAGAIN;
+	}
+
+      v->_cpuset[0] = (size_t) vProcessMask;
+    }
+
+  return 0;
+}
+
+
+int
+ptw32_setthreadaffinity (HANDLE threadH, const cpu_set_t * cpuset, int spread)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Sets the affinity of a Win32 thread to the CPUs in
+      *      cpuset. A thread runs in one processor group at a
+      *      time: if cpuset spans several, the thread is given
+      *      the CPUs of one of them. Unless spread is set it
+      *      stays in the group it runs in if cpuset has CPUs
+      *      there; otherwise the groups are taken in turn so
+      *      that threads sharing a set are spread across the
+      *      machine.
+      *
+      * RESULTS
+      *              0               success
+      *              EINVAL          cpuset names no CPU on this
+      *                              system
+      *              EAGAIN          the thread affinity could not
+      *                              be set
+      *
+      * ------------------------------------------------------
+      */
+{
+  const _sched_cpu_set_vector_ * v = (const _sched_cpu_set_vector_ *) cpuset;
+  WORD groups = ptw32_affinityGroups ();
+  WORD used = 0;
+  WORD pick = 0;
+  WORD group;
+  ptw32_group_affinity_t affinity;
+
+  for (group = 0; group < groups; group++)
+    {
+      if (v->_cpuset[group])
+	{
+	  used++;
+	}
+    }
+
+  if (0 == used)
+    {
+      return EINVAL;
+    }
+
+  if (NULL == ptw32_setthreadgroupaffinity)
+    {
+      return (SetThreadAffinityMask (threadH, (DWORD_PTR) v->_cpuset[0])
+	      ? 0 : EAGAIN);
+    }
+
+  if (used > 1
+      && (spread
+	  || !ptw32_getthreadgroupaffinity (threadH, &affinity)
+	  || affinity.Group >= groups
+	  || 0 == v->_cpuset[affinity.Group]))
+    {
+      pick = (WORD) ((unsigned long) PTW32_INTERLOCKED_INCREMENT_LONG(
+				       (PTW32_INTERLOCKED_LONGPTR) &ptw32_affinityNextGroup)
+		     % used);
+
+      /*
+       * Skip to the pick'th non-empty group.
+       */
+      for (group = 0; 0 == v->_cpuset[group] || pick > 0; group++)
+	{
+	  if (v->_cpuset[group])
+	    {
+	      pick--;
+	    }
+	}
+    }
+  else if (used > 1)
+    {
+      group = affinity.Group;
+    }
+  else
+    {
+      for (group = 0; 0 == v->_cpuset[group]; group++)
+	{
+	}
+    }
+
+  memset (&affinity, 0, sizeof (affinity));
+  affinity.Mask = (DWORD_PTR) v->_cpuset[group];
+  affinity.Group = group;
+
+  return (ptw32_setthreadgroupaffinity (threadH, &affinity, NULL) ? 0 : EAGAIN);
+}
+
+
+int
+ptw32_getthreadaffinity (HANDLE threadH, cpu_set_t * cpuset)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns the CPUs a Win32 thread may run on, all of
+      *      which are in the processor group it currently runs
+      *      in.
+      *
+      * RESULTS
+      *              0               success
+      *              EAGAIN          the thread affinity could not
+      *                              be read
+      *
+      * ------------------------------------------------------
+      */
+{
+  _sched_cpu_set_vector_ * v = (_sched_cpu_set_vector_ *) cpuset;
+
+  CPU_ZERO (cpuset);
+
+  if (ptw32_setthreadgroupaffinity != NULL)
+    {
+      ptw32_group_affinity_t affinity;
+
+      if (!ptw32_getthreadgroupaffinity (threadH, &affinity)
+	  || affinity.Group >= PTW32_CPU_SET_GROUPS)
+	{
+	  return EAGAIN;
+	}
+
+      v->_cpuset[affinity.Group] = (size_t) affinity.Mask;
+    }
+  else
+    {
+      DWORD_PTR vProcessMask;
+      DWORD_PTR vSystemMask;
+      DWORD_PTR vThreadMask;
+
+      /*
+       * Win32 has no call that just reads a thread's affinity, so
+       * temporarily set it to that of the process to get the old
+       * affinity, then reset it.
+       */
+      if (!GetProcessAffinityMask (GetCurrentProcess (),
+				   &vProcessMask, &vSystemMask)
+	  || 0 == (vThreadMask = SetThreadAffinityMask (threadH, vProcessMask))
+	  || !SetThreadAffinityMask (threadH, vThreadMask))
+	{
+	  return EAGAIN;
+	}
+
+      v->_cpuset[0] = (size_t) vThreadMask;
+    }
+
+  return 0;
+}
+
+
+int
+ptw32_setthreadsoftaffinity (HANDLE threadH, const cpu_set_t * cpuset)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Selects the CPU Sets of the CPUs in cpuset for a
+      *      Win32 thread, which the system then prefers to run
+      *      it on but may run it elsewhere (within its affinity)
+      *      when they are busy. An empty cpuset removes the
+      *      selection.
+      *
+      * RESULTS
+      *              0               success
+      *              ENOSYS          the system has no CPU Sets
+      *              ENOMEM          no memory for the CPU Set ids
+      *              EAGAIN          the selection could not be set
+      *
+      * ------------------------------------------------------
+      */
+{
+  const _sched_cpu_set_vector_ * v = (const _sched_cpu_set_vector_ *) cpuset;
+  int result = 0;
+
+  if (ptw32_setthreadselectedcpusetmasks != NULL)
+    {
+      ptw32_group_affinity_t masks[PTW32_CPU_SET_GROUPS];
+      USHORT n = 0;
+      WORD group;
+
+      memset (masks, 0, sizeof (masks));
+
+      for (group = 0; group < PTW32_CPU_SET_GROUPS; group++)
+	{
+	  if (v->_cpuset[group])
+	    {
+	      masks[n].Mask = (DWORD_PTR) v->_cpuset[group];
+	      masks[n].Group = group;
+	      n++;
+	    }
+	}
+
+      if (!ptw32_setthreadselectedcpusetmasks (threadH, (n ? masks : NULL), n))
+	{
+	  result = EAGAIN;
+	}
+    }
+  else if (ptw32_setthreadselectedcpusets != NULL)
+    {
+      /*
+       * Windows 10 only takes CPU Set ids, which have to be looked
+       * up by processor group and number.
+       */
+      BYTE * buf = NULL;
+      ULONG * ids = NULL;
+      ULONG len = 0;
+      ULONG off;
+      ULONG n = 0;
+      ptw32_cpu_set_info_t * info;
+
+      if (0 == CPU_COUNT (cpuset))
+	{
+	  return (ptw32_setthreadselectedcpusets (threadH, NULL, 0) ? 0 : EAGAIN);
+	}
+
+      (void) ptw32_getsystemcpusetinformation (NULL, 0, &len, GetCurrentProcess (), 0);
+
+      if (0 == len
+	  || NULL == (buf = (BYTE *) malloc (len))
+	  || NULL == (ids = (ULONG *) malloc (CPU_COUNT (cpuset) * sizeof (ULONG))))
+	{
+	  free (buf);
+	  return (0 == len ? EAGAIN : ENOMEM);
+	}
+
+      if (ptw32_getsystemcpusetinformation ((ptw32_cpu_set_info_t *) buf, len, &len,
+					    GetCurrentProcess (), 0))
+	{
+	  for (off = 0; off < len && ((ptw32_cpu_set_info_t *) (buf + off))->Size; off += info->Size)
+	    {
+	      info = (ptw32_cpu_set_info_t *) (buf + off);
+
+	      if (PTW32_CPU_SET_INFORMATION == info->Type
+		  && info->u.CpuSet.Group < PTW32_CPU_SET_GROUPS
+		  && info->u.CpuSet.LogicalProcessorIndex < PTW32_CPU_GROUP_SIZE
+		  && (v->_cpuset[info->u.CpuSet.Group]
+		      & ((size_t) 1 << info->u.CpuSet.LogicalProcessorIndex))
+		  && n < (ULONG) CPU_COUNT (cpuset))
+		{
+		  ids[n++] = info->u.CpuSet.Id;
+		}
+	    }
+	}
+
+      if (0 == n || !ptw32_setthreadselectedcpusets (threadH, ids, n))
+	{
+	  result = EAGAIN;
+	}
+
+      free (ids);
+      free (buf);
+    }
+  else
+    {
+      result = ENOSYS;
+    }
+
+  return result;
+}
+
+#endif /* NEED_PROCESS_AFFINITY_MASK */
+
+
+void
+ptw32_cpusetcopy (void * dest, size_t destsize, const void * src, size_t srcsize)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Copies a CPU set between buffers of possibly
+      *      different sizes, as given by the cpusetsize argument
+      *      of the affinity routines. CPUs beyond the end of src
+      *      are cleared; those beyond the end of dest are lost.
+      *
+      * ------------------------------------------------------
+      */
+{
+  memset (dest, 0, destsize);
+  memcpy (dest, src, (srcsize < destsize ? srcsize : destsize));
+}
@@ -0,0 +1,480 @@
+/*
+ * ptw32_async.c
+ *
+ * Description:
+ * This translation unit implements asynchronous waits on mutexes,
+ * condition variables and semaphores.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * Asynchronous waiters (pthread_mutex_lock_async_np,
+ * pthread_cond_wait_async_np and sem_wait_async_np) wait without a
+ * thread: each queues a heap node, in one of PTW32_PARK_BUCKETS
+ * queues chosen by hashing the address the object's wakers already
+ * wake, and when it gets what it waits for its callback is submitted
+ * to the waiter's thread pool. The objects' own blocking waiters and
+ * wakers are unchanged, so threads and asynchronous waiters can use
+ * the same object:
+ *
+ * - A mutex waiter sets lock_idx to -1, as a blocked thread does, so
+ *   the unlock that frees the mutex calls ptw32_mutex_wake, which
+ *   calls ptw32_async_wake. There the waiter retries the exchange:
+ *   if it gets 0 it owns the mutex, otherwise another thread barged
+ *   in and has seen -1, and will wake again when it unlocks.
+ *
+ * - A semaphore waiter takes a unit only while the value is
+ *   positive, so it never counts among the threads blocked on the
+ *   kernel semaphore; each post that leaves a positive value calls
+ *   ptw32_async_wake.
+ *
+ * - A condition variable waiter waits for a signal or broadcast,
+ *   which release it before any blocked thread, and then waits for
+ *   the mutex as above.
+ *
+ * The waiter tries to claim the object with the bucket lock held,
+ * and wakers claim for it with the bucket lock held, so a wake can't
+ * fall between a waiter's failed claim and its queueing. Wakers find
+ * no waiters without taking a lock while ptw32_asyncWaiters is 0.
+ *
+ * The task submitted to the pool is allocated with the waiter, so
+ * that a wake, which can't report an error, never has to allocate.
+ * Waiters made by ptw32_async_new_port post a packet to an I/O
+ * completion port instead, so that threads blocked in
+ * GetQueuedCompletionStatus can serve them along with I/O.
+ */
+
+#include "pthread.h"
+#include "semaphore.h"
+#include "implement.h"
+
+
+static ptw32_async_bucket_t *
+ptw32_async_bucket (volatile VOID * address)
+{
+  return &ptw32_asyncLot[((size_t) address >> 2) % PTW32_PARK_BUCKETS];
+}
+
+static void * PTW32_CDECL
+ptw32_async_run (void * arg)
+{
+  ptw32_async_waiter_t * w = (ptw32_async_waiter_t *) arg;
+  void (PTW32_CDECL * callback) (void *) = w->callback;
+  void * cbArg = w->arg;
+
+  /* The pool frees the task */
+  ptw32_object_free (w);
+  callback (cbArg);
+
+  return NULL;
+}
+
+static void
+ptw32_async_done (ptw32_async_waiter_t * w)
+{
+  pthread_pool_np_t pool;
+
+  if (w->task == NULL)
+    {
+      /*
+       * The thread that dequeues the packet owns what was waited for.
+       * A closed port loses it, as documented.
+       */
+      (void) PostQueuedCompletionStatus (w->port, 0, w->key, w->overlapped);
+      ptw32_object_free (w);
+      return;
+    }
+
+  pool = w->task->pool;
+
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->outstanding);
+  (void) ptw32_pool_push (pool, NULL, w->task);
+  ptw32_pool_wake (pool);
+
+  if (0 != PTW32_INTERLOCKED_EXCHANGE_ADD_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->nWaiting,
+                                               (PTW32_INTERLOCKED_LONG) 0))
+    {
+      (void) pthread_mutex_lock (&pool->lock);
+      (void) pthread_cond_broadcast (&pool->changed);
+      (void) pthread_mutex_unlock (&pool->lock);
+    }
+}
+
+static int
+ptw32_async_claim (ptw32_async_waiter_t * w)
+{
+  switch (w->type)
+    {
+    case PTW32_ASYNC_MUTEX:
+      {
+        pthread_mutex_t mx = (pthread_mutex_t) w->object;
+
+        return 0 == (PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_EXCHANGE_ACQ_LONG(
+                      (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                      (PTW32_INTERLOCKED_LONG) -1);
+      }
+    case PTW32_ASYNC_SEM:
+      {
+        sem_t s = (sem_t) w->object;
+        LONG v;
+
+        while ((v = *((LONG volatile *) &s->value)) > 0)
+          {
+            if ((PTW32_INTERLOCKED_LONG) v ==
+                PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->value,
+                                                        (PTW32_INTERLOCKED_LONG) (v - 1),
+                                                        (PTW32_INTERLOCKED_LONG) v))
+              {
+                return PTW32_TRUE;
+              }
+          }
+        return PTW32_FALSE;
+      }
+    default:
+      /* Only a signal claims a condition variable waiter */
+      return PTW32_FALSE;
+    }
+}
+
+
+int
+ptw32_async_new (pthread_pool_np_t pool,
+                 void (PTW32_CDECL * callback) (void *),
+                 void * arg,
+                 ptw32_async_waiter_t ** waiter)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Allocates an asynchronous waiter that will submit
+      *      callback(arg) to 'pool', and the pool task to do so.
+      *
+      * RESULTS
+      *              0               success,
+      *              EINVAL          'pool' or 'callback' is invalid,
+      *                              or the pool is being destroyed,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_async_waiter_t * w;
+  pthread_pool_task_np_t t;
+
+  if (pool == NULL || callback == NULL || pool->shutdown)
+    {
+      return EINVAL;
+    }
+
+  w = (ptw32_async_waiter_t *) ptw32_object_alloc (sizeof (*w), 0);
+  t = (pthread_pool_task_np_t) ptw32_object_alloc (sizeof (*t), 0);
+
+  if (w == NULL || t == NULL)
+    {
+      ptw32_object_free (w);
+      ptw32_object_free (t);
+      return ENOMEM;
+    }
+
+  t->routine = ptw32_async_run;
+  t->arg = w;
+  t->pool = pool;
+  t->detached = PTW32_TRUE;
+
+  w->address = NULL;
+  w->next = NULL;
+  w->mutex = NULL;
+  w->task = t;
+  w->callback = callback;
+  w->arg = arg;
+  w->port = NULL;
+  w->key = 0;
+  w->overlapped = NULL;
+
+  *waiter = w;
+
+  return 0;
+}
+
+int
+ptw32_async_new_port (HANDLE port, void * key, void * overlapped,
+                      ptw32_async_waiter_t ** waiter)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Allocates an asynchronous waiter that will post a
+      *      completion packet with 'key' and 'overlapped', and no
+      *      bytes transferred, to the I/O completion port 'port'.
+      *
+      * RESULTS
+      *              0               success,
+      *              EINVAL          'port' is invalid,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_async_waiter_t * w;
+
+  if (port == NULL || port == INVALID_HANDLE_VALUE)
+    {
+      return EINVAL;
+    }
+
+  if ((w = (ptw32_async_waiter_t *) ptw32_object_alloc (sizeof (*w), 0)) == NULL)
+    {
+      return ENOMEM;
+    }
+
+  w->address = NULL;
+  w->next = NULL;
+  w->mutex = NULL;
+  w->task = NULL;
+  w->callback = NULL;
+  w->arg = NULL;
+  w->port = port;
+  w->key = (ULONG_PTR) key;
+  w->overlapped = (LPOVERLAPPED) overlapped;
+
+  *waiter = w;
+
+  return 0;
+}
+
+void
+ptw32_async_free (ptw32_async_waiter_t * w)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Frees a waiter from ptw32_async_new that was never
+      *      passed to ptw32_async_wait.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_object_free (w->task);
+  ptw32_object_free (w);
+}
+
+void
+ptw32_async_wait (ptw32_async_waiter_t * w, volatile VOID * address)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Claims what 'w' waits for if it can, and submits its
+      *      callback; otherwise queues 'w' on 'address' for
+      *      ptw32_async_wake. Either way the waiter belongs to the
+      *      library from here on.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_async_bucket_t * b = ptw32_async_bucket (address);
+  ptw32_mcs_local_node_t node;
+
+  /* Counted before the claim, which a waker's check must not miss */
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &ptw32_asyncWaiters);
+
+  ptw32_mcs_lock_acquire (&b->lock, &node);
+
+  if (ptw32_async_claim (w))
+    {
+      ptw32_mcs_lock_release (&node);
+      (void) PTW32_INTERLOCKED_DECREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &ptw32_asyncWaiters);
+      ptw32_async_done (w);
+      return;
+    }
+
+  w->address = address;
+  w->next = NULL;
+
+  if (NULL == b->tail)
+    {
+      b->head = w;
+    }
+  else
+    {
+      b->tail->next = w;
+    }
+  b->tail = w;
+
+  ptw32_mcs_lock_release (&node);
+}
+
+int
+ptw32_async_wake (volatile VOID * address, int all)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Claims for the asynchronous waiters queued on
+      *      'address' the longest, in order, and submits their
+      *      callbacks; stops at the first that can't claim, or
+      *      after the first that can if 'all' is false. Condition
+      *      variable waiters are always released, and go on to
+      *      wait for their mutex.
+      *
+      *      Called by the objects' wakers: after a mutex with
+      *      lock_idx -1 is unlocked, after a semaphore post that
+      *      leaves a positive value, and by condition variable
+      *      signals and broadcasts.
+      *
+      * RESULTS
+      *              The number of waiters released.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_async_bucket_t * b;
+  ptw32_mcs_local_node_t node;
+  ptw32_async_waiter_t * released = NULL;
+  ptw32_async_waiter_t ** releasedTail = &released;
+  ptw32_async_waiter_t ** link;
+  ptw32_async_waiter_t * prev = NULL;
+  int n = 0;
+
+  if (0 == PTW32_INTERLOCKED_EXCHANGE_ADD_LONG((PTW32_INTERLOCKED_LONGPTR) &ptw32_asyncWaiters,
+                                               (PTW32_INTERLOCKED_LONG) 0))
+    {
+      return 0;
+    }
+
+  b = ptw32_async_bucket (address);
+
+  ptw32_mcs_lock_acquire (&b->lock, &node);
+
+  link = &b->head;
+
+  while (*link != NULL)
+    {
+      ptw32_async_waiter_t * w = *link;
+
+      if (w->address != address)
+	{
+	  prev = w;
+	  link = &w->next;
+	  continue;
+	}
+
+      if (w->type != PTW32_ASYNC_COND && !ptw32_async_claim (w))
+	{
+	  break;
+	}
+
+      *link = w->next;
+
+      if (b->tail == w)
+	{
+	  b->tail = prev;
+	}
+
+      w->next = NULL;
+      *releasedTail = w;
+      releasedTail = &w->next;
+      n++;
+
+      if (!all)
+	{
+	  break;
+	}
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  while (released != NULL)
+    {
+      ptw32_async_waiter_t * w = released;
+
+      released = w->next;
+      (void) PTW32_INTERLOCKED_DECREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &ptw32_asyncWaiters);
+
+      if (w->type == PTW32_ASYNC_COND)
+	{
+	  w->type = PTW32_ASYNC_MUTEX;
+	  w->object = w->mutex;
+	  ptw32_async_wait (w, (volatile VOID *) &w->mutex->lock_idx);
+	}
+      else
+	{
+	  ptw32_async_done (w);
+	}
+    }
+
+  return n;
+}
+
+int
+ptw32_async_mutex_check (pthread_mutex_t * mutex)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Initialises a statically initialised mutex and checks
+      *      that asynchronous waiters can wait for it: it must be
+      *      a process private PTHREAD_MUTEX_NORMAL mutex that isn't
+      *      robust, elided, fair, cohort or priority protocol,
+      *      since its owner is whichever thread the callback runs
+      *      on.
+      *
+      * RESULTS
+      *              0               the mutex can be waited for,
+      *              EINVAL          'mutex' is invalid or of another
+      *                              kind,
+      *              ENOTSUP         'mutex' is process shared, or the
+      *                              library was built with
+      *                              PTW32_LOCKSTAT or PTW32_LOCKWATCH,
+      *              other           as for pthread_mutex_init().
+      *
+      * ------------------------------------------------------
+      */
+{
+#if defined(PTW32_LOCKSTAT) || defined(PTW32_LOCKWATCH)
+  (void) mutex;
+  return ENOTSUP;
+#else
+  int result;
+
+  if (mutex == NULL || *mutex == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (PTW32_IS_PSHARED (*mutex))
+    {
+      return ENOTSUP;
+    }
+
+  if (*mutex >= PTHREAD_ERRORCHECK_MUTEX_INITIALIZER
+      && (result = ptw32_mutex_check_need_init (mutex)) != 0)
+    {
+      return result;
+    }
+
+  return ((*mutex)->fastKind == PTHREAD_MUTEX_NORMAL) ? 0 : EINVAL;
+#endif
+}
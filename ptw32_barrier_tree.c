@@ -0,0 +1,353 @@
+/*
+ * ptw32_barrier_tree.c
+ *
+ * Description:
+ * This translation unit implements barrier primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * Combining tree barriers, selected with pthread_barrierattr_setkind_np().
+ *
+ * The nodes array holds the leaves first, then each level above them,
+ * ending with the root. A leaf takes up to PTW32_BARRIER_TREE_FANIN
+ * arrivals and an interior node one arrival per child. An arriving
+ * thread claims room in a leaf, starting with one chosen from its
+ * thread ID and moving on to the next while the leaf is full. The
+ * thread that completes a node arrives at its parent, and the thread
+ * that completes the root is the serial thread: it increments cycle,
+ * which releases everyone else.
+ *
+ * Node counts are never reset. At the start of a cycle each count is
+ * cycle * width (modulo 2^32), so arrivals are measured relative to
+ * that and the next cycle can begin before the last waiter has seen
+ * the release.
+ *
+ * Waiters poll cycle for a while on a multiprocessor and then park on
+ * it with WaitOnAddress. The serial thread only makes the wake call if
+ * somebody parked.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+void
+ptw32_barrier_park (volatile LONG * word, LONG seen, volatile LONG * nParked)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Waits until '*word' is no longer 'seen': polls it for
+      *      a while on a multiprocessor, then parks on it with
+      *      WaitOnAddress. Not a cancellation point.
+      *
+      *      If nParked isn't NULL it counts the thread while it is
+      *      parked; the thread that changes '*word' then only wakes
+      *      it if the count isn't zero. Callers that pass NULL keep
+      *      their own count from before calling until after.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int spins = ptw32_barrierSpinLimit;
+  int yields = 0;
+  int64_t start;
+
+  for (; spins > 0; spins--)
+    {
+      if (seen != PTW32_ATOMIC_LOAD_ACQ_LONG (word))
+	{
+	  return;
+	}
+
+      PTW32_YIELD_PROCESSOR();
+    }
+
+  if (nParked != NULL)
+    {
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) nParked);
+    }
+
+  start = ptw32_wait_begin ();
+
+  while (seen == PTW32_ATOMIC_LOAD_ACQ_LONG (word))
+    {
+      if (ptw32_waitonaddress != NULL)
+	{
+	  PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_BARRIER);
+	  (void) ptw32_waitonaddress (word, &seen, sizeof (seen), INFINITE);
+	}
+      else
+	{
+	  /* NEED_WAITONADDRESS builds: no parking, just back off. */
+	  ptw32_yield (&yields);
+	}
+    }
+
+  ptw32_wait_end (start);
+
+  if (nParked != NULL)
+    {
+      (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) nParked);
+    }
+}
+
+
+int
+ptw32_barrier_tree_init (pthread_barrier_t b, unsigned int count)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Builds the nodes of a combining tree barrier for
+      *      'count' threads.
+      *
+      * RESULTS
+      *              0               success,
+      *              ENOMEM          insufficient memory,
+      *
+      * ------------------------------------------------------
+      */
+{
+  unsigned int nNodes = 0;
+  unsigned int width = count;
+  unsigned int n;
+  unsigned int base;
+  unsigned int i;
+
+  do
+    {
+      width = (width + PTW32_BARRIER_TREE_FANIN - 1) / PTW32_BARRIER_TREE_FANIN;
+      nNodes += width;
+    }
+  while (width > 1);
+
+  b->nodes = (ptw32_barrier_node_t *) ptw32_object_alloc (nNodes * sizeof (ptw32_barrier_node_t),
+							  PTW32_CACHE_LINE_SIZE);
+
+  if (b->nodes == NULL)
+    {
+      return ENOMEM;
+    }
+
+  /* 'width' is the number of arrivals at a level, 'n' its number of nodes */
+  width = count;
+  base = 0;
+
+  for (;;)
+    {
+      n = (width + PTW32_BARRIER_TREE_FANIN - 1) / PTW32_BARRIER_TREE_FANIN;
+
+      for (i = 0; i < n; i++)
+	{
+	  b->nodes[base + i].width = (LONG) PTW32_MIN(PTW32_BARRIER_TREE_FANIN,
+						      width - i * PTW32_BARRIER_TREE_FANIN);
+	  b->nodes[base + i].parent = (n == 1)
+	    ? -1 : (int) (base + n + i / PTW32_BARRIER_TREE_FANIN);
+	}
+
+      if (base == 0)
+	{
+	  b->nLeaves = (int) n;
+	}
+
+      if (n == 1)
+	{
+	  break;
+	}
+
+      base += n;
+      width = n;
+    }
+
+  b->cycle = 0;
+  b->nParked = 0;
+
+  return 0;
+}
+
+
+int
+ptw32_barrier_tree_destroy (pthread_barrier_t b)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Frees the nodes of a combining tree barrier, after
+      *      waiting for released threads to leave WaitOnAddress.
+      *
+      * RESULTS
+      *              0               success,
+      *              EBUSY           threads are waiting at the barrier,
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG cycle = *((LONG volatile *) &b->cycle);
+  int i;
+  int yields = 0;
+
+  for (i = 0; i < b->nLeaves; i++)
+    {
+      if ((ULONG) *((LONG volatile *) &b->nodes[i].count)
+	  != (ULONG) cycle * (ULONG) b->nodes[i].width)
+	{
+	  return EBUSY;
+	}
+    }
+
+  while (0 != *((LONG volatile *) &b->nParked))
+    {
+      ptw32_yield (&yields);
+    }
+
+  ptw32_object_free (b->nodes);
+  b->nodes = NULL;
+
+  return 0;
+}
+
+
+int
+ptw32_barrier_tree_arrive (pthread_barrier_t b, LONG * arrivedAt)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Arrives at a combining tree barrier without waiting
+      *      for the others. The cycle arrived at is returned in
+      *      '*arrivedAt'; the barrier has released it once
+      *      b->cycle has moved on.
+      *
+      * RESULTS
+      *              PTHREAD_BARRIER_SERIAL_THREAD
+      *                              for the last thread to arrive,
+      *                              which has released the others,
+      *              0               for the others.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG cycle = *((LONG volatile *) &b->cycle);
+  ptw32_barrier_node_t * node;
+  ULONG arrived;
+  ULONG base;
+  LONG c;
+  int i;
+  int tried = 0;
+
+  /* Thread IDs are multiples of 4 */
+  i = (int) ((GetCurrentThreadId () >> 2) % (DWORD) b->nLeaves);
+
+  /* Claim room in a leaf */
+  for (;;)
+    {
+      node = &b->nodes[i];
+      base = (ULONG) cycle * (ULONG) node->width;
+      c = *((LONG volatile *) &node->count);
+
+      if ((ULONG) c - base >= (ULONG) node->width)
+	{
+	  /*
+	   * Full. If every leaf is, more threads than the barrier
+	   * count have arrived; wait for the next cycle.
+	   */
+	  if (++tried == b->nLeaves)
+	    {
+	      ptw32_barrier_park (&b->cycle, cycle, &b->nParked);
+	      cycle = *((LONG volatile *) &b->cycle);
+	      tried = 0;
+	    }
+
+	  i = (i + 1) % b->nLeaves;
+	  continue;
+	}
+
+      if ((PTW32_INTERLOCKED_LONG) c ==
+	  PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &node->count,
+						   (PTW32_INTERLOCKED_LONG) (c + 1),
+						   (PTW32_INTERLOCKED_LONG) c))
+	{
+	  arrived = (ULONG) c + 1 - base;
+	  break;
+	}
+    }
+
+  *arrivedAt = cycle;
+
+  /* Climb while we complete nodes */
+  while (arrived == (ULONG) node->width)
+    {
+      if (node->parent < 0)
+	{
+	  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &b->cycle);
+
+	  if (0 != *((LONG volatile *) &b->nParked))
+	    {
+	      ptw32_wakebyaddressall (&b->cycle);
+	    }
+
+	  return PTHREAD_BARRIER_SERIAL_THREAD;
+	}
+
+      node = &b->nodes[node->parent];
+      base = (ULONG) cycle * (ULONG) node->width;
+      arrived = (ULONG) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &node->count)
+	- base;
+    }
+
+  return 0;
+}
+
+
+int
+ptw32_barrier_tree_wait (pthread_barrier_t b)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Waits at a combining tree barrier.
+      *
+      * RESULTS
+      *              PTHREAD_BARRIER_SERIAL_THREAD
+      *                              for the last thread to arrive,
+      *              0               for the others.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG cycle;
+
+  if (PTHREAD_BARRIER_SERIAL_THREAD == ptw32_barrier_tree_arrive (b, &cycle))
+    {
+      return PTHREAD_BARRIER_SERIAL_THREAD;
+    }
+
+  ptw32_barrier_park (&b->cycle, cycle, &b->nParked);
+
+  return 0;
+}
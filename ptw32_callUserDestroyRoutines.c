@@ -63,6 +63,7 @@ ptw32_callUserDestroyRoutines (pthread_t thread)
       *
       * This the routine runs through all thread keys and calls
       * the destroy routines on the user's data for the current thread.
+      * 'thread' must be the calling thread.
       * It simulates the behaviour of POSIX Threads.
       *
       * PARAMETERS
@@ -74,159 +75,142 @@ ptw32_callUserDestroyRoutines (pthread_t thread)
       * -------------------------------------------------------------------
       */
 {
-  ThreadKeyAssoc * assoc;
-
   if (thread.p != NULL)
     {
-      ptw32_mcs_local_node_t threadLock;
-      ptw32_mcs_local_node_t keyLock;
-      int assocsRemaining;
+      ptw32_mcs_local_node_t node;
+      int destructorsCalled;
       int iterations = 0;
       ptw32_thread_t * sp = (ptw32_thread_t *) thread.p;
 
       /*
-       * Run through all Thread<-->Key associations
-       * for the current thread.
+       * Run through the keys marked in the calling thread's
+       * destructor bitmap.
        *
        * Do this process at most PTHREAD_DESTRUCTOR_ITERATIONS times.
        */
       do
 	{
-	  assocsRemaining = 0;
+	  unsigned int word;
+	  unsigned int limit = sp->dtorLimit;
+
+	  destructorsCalled = 0;
 	  iterations++;
 
-	  ptw32_mcs_lock_acquire(&(sp->threadLock), &threadLock);
+	  if (0 == limit)
+	    {
+	      /* No key with a destructor was set (again) */
+	      break;
+	    }
+
+	  word = sp->dtorFirst;
+	  sp->dtorLimit = 0;
+
 	  /*
-	   * The pointer to the next assoc is stored in the thread struct so that
-	   * the assoc destructor in pthread_key_delete can adjust it
-	   * if it deletes this assoc. This can happen if we fail to acquire
-	   * both locks below, and are forced to release all of our locks,
-	   * leaving open the opportunity for pthread_key_delete to get in
-	   * before us.
+	   * Destructors may set values again, growing the bitmap,
+	   * so it is fetched afresh for every word. Each word is
+	   * taken whole so that bits set again by destructors are
+	   * left for the next iteration, which they also make
+	   * cover their words.
 	   */
-	  sp->nextAssoc = sp->keys;
-	  ptw32_mcs_lock_release(&threadLock);
-
-	  for (;;)
+	  for (; word < limit; word++)
 	    {
-	      void * value;
-	      pthread_key_t k;
-	      void (*destructor) (void *);
-
-	      /*
-	       * First we need to serialise with pthread_key_delete by locking
-	       * both assoc guards, but in the reverse order to our convention,
-	       * so we must be careful to avoid deadlock.
-	       */
-	      ptw32_mcs_lock_acquire(&(sp->threadLock), &threadLock);
-
-	      if ((assoc = (ThreadKeyAssoc *)sp->nextAssoc) == NULL)
-		{
-		  /* Finished */
-		  ptw32_mcs_lock_release(&threadLock);
-		  break;
-		}
-	      else
+	      unsigned int bits = PTW32_TSD_DTOR_BITS(sp)[word];
+
+	      PTW32_TSD_DTOR_BITS(sp)[word] = 0;
+
+	      while (bits != 0)
 		{
-		  /*
-		   * assoc->key must be valid because assoc can't change or be
-		   * removed from our chain while we hold at least one lock. If
-		   * the assoc was on our key chain then the key has not been
-		   * deleted yet.
-		   *
-		   * Now try to acquire the second lock without deadlocking.
-		   * If we fail, we need to relinquish the first lock and the
-		   * processor and then try to acquire them all again.
-		   */
-		  if (ptw32_mcs_lock_try_acquire(&(assoc->key->keyLock), &keyLock) == EBUSY)
+		  unsigned int bit = 0;
+		  unsigned int slot;
+		  void * value = NULL;
+		  pthread_key_t k;
+		  void (PTW32_CDECL *destructor) (void *) = NULL;
+
+		  while ((bits & (1U << bit)) == 0)
 		    {
-		      ptw32_mcs_lock_release(&threadLock);
-		      Sleep(0);
-		      /*
-		       * Go around again.
-		       * If pthread_key_delete has removed this assoc in the meantime,
-		       * sp->nextAssoc will point to a new assoc.
-		       */
-		      continue;
+		      bit++;
 		    }
-		}
 
-	      /* We now hold both locks */
+		  bits &= ~(1U << bit);
+		  slot = word * 32 + bit;
 
-	      sp->nextAssoc = assoc->nextKey;
+		  /*
+		   * Serialise with pthread_key_delete: while we hold the
+		   * slot lock the key in the slot can't be freed. The
+		   * slot may be empty, or hold a newer key than the one
+		   * the bit was set for; then the value we find is
+		   * that key's, which is NULL unless we set it.
+		   */
+		  ptw32_mcs_lock_acquire(&ptw32_tsd_slot_lock, &node);
 
-	      /*
-	       * Key still active; pthread_key_delete
-	       * will block on these same mutexes before
-	       * it can release actual key; therefore,
-	       * key is valid and we can call the destroy
-	       * routine;
-	       */
-	      k = assoc->key;
-	      destructor = k->destructor;
-	      value = TlsGetValue(k->key);
-	      TlsSetValue (k->key, NULL);
+		  if (slot < ptw32_tsdNextSlot
+		      && (k = ptw32_tsdKeys[slot]) != NULL
+		      && k->destructor != NULL)
+		    {
+		      destructor = k->destructor;
+
+		      if (PTW32_KEY_IN_TABLE(k))
+			{
+			  value = ptw32_tsd_table_get (k);
+			  (void) ptw32_tsd_table_set (k, NULL);
+			}
+		      else
+			{
+			  value = TlsGetValue(k->key);
+			  TlsSetValue (k->key, NULL);
+			}
+		    }
 
-	      // Every assoc->key exists and has a destructor
-	      if (value != NULL && iterations <= PTHREAD_DESTRUCTOR_ITERATIONS)
-		{
 		  /*
-		   * Unlock both locks before the destructor runs.
+		   * Unlock before the destructor runs.
 		   * POSIX says pthread_key_delete can be run from destructors,
 		   * and that probably includes with this key as target.
-		   * pthread_setspecific can also be run from destructors and
-		   * also needs to be able to access the assocs.
+		   * pthread_setspecific can also be run from destructors.
 		   */
-		  ptw32_mcs_lock_release(&threadLock);
-		  ptw32_mcs_lock_release(&keyLock);
+		  ptw32_mcs_lock_release(&node);
 
-		  assocsRemaining++;
+		  if (value != NULL && iterations <= PTHREAD_DESTRUCTOR_ITERATIONS)
+		    {
+		      destructorsCalled++;
 
 #if defined(__cplusplus)
 
-		  try
-		    {
+		      try
+			{
+			  /*
+			   * Run the caller's cleanup routine.
+			   */
+			  destructor (value);
+			}
+		      catch (...)
+			{
+			  /*
+			   * A system unexpected exception has occurred
+			   * running the user's destructor.
+			   * We get control back within this block in case
+			   * the application has set up it's own terminate
+			   * handler. Since we are leaving the thread we
+			   * should not get any internal pthreads
+			   * exceptions.
+			   */
+			  terminate ();
+			}
+
+#else /* __cplusplus */
+
 		      /*
 		       * Run the caller's cleanup routine.
 		       */
 		      destructor (value);
-		    }
-		  catch (...)
-		    {
-		      /*
-		       * A system unexpected exception has occurred
-		       * running the user's destructor.
-		       * We get control back within this block in case
-		       * the application has set up it's own terminate
-		       * handler. Since we are leaving the thread we
-		       * should not get any internal pthreads
-		       * exceptions.
-		       */
-		      terminate ();
-		    }
-
-#else /* __cplusplus */
-
-		  /*
-		   * Run the caller's cleanup routine.
-		   */
-		  destructor (value);
 
 #endif /* __cplusplus */
 
-		}
-	      else
-		{
-		  /*
-		   * Remove association from both the key and thread chains
-		   * and reclaim it's memory resources.
-		   */
-		  ptw32_tkAssocDestroy (assoc);
-		  ptw32_mcs_lock_release(&threadLock);
-		  ptw32_mcs_lock_release(&keyLock);
+		    }
 		}
 	    }
 	}
-      while (assocsRemaining);
+      while (destructorsCalled);
+
+      ptw32_tsd_table_release ();
     }
 }				/* ptw32_callUserDestroyRoutines */
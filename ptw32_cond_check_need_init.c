@@ -42,37 +42,40 @@
 INLINE int
 ptw32_cond_check_need_init (pthread_cond_t * cond)
 {
-  int result = 0;
-  ptw32_mcs_local_node_t node;
+  int result;
+  pthread_cond_t cv;
 
-  /*
-   * The following guarded test is specifically for statically
-   * initialised condition variables (via PTHREAD_OBJECT_INITIALIZER).
-   */
-  ptw32_mcs_lock_acquire(&ptw32_cond_test_init_lock, &node);
+  if (*cond != PTHREAD_COND_INITIALIZER)
+    {
+      /*
+       * Another thread initialised the cv first, or it has been
+       * destroyed, in which case the operation that caused the
+       * auto-initialisation should fail.
+       */
+      return (*cond == NULL) ? EINVAL : 0;
+    }
 
   /*
-   * We got here possibly under race
-   * conditions. Check again inside the critical section.
-   * If a static cv has been destroyed, the application can
-   * re-initialise it only by calling pthread_cond_init()
-   * explicitly.
+   * As for mutexes (see ptw32_mutex_check_need_init.c), build one and
+   * publish it if the static cv is still untouched.
    */
-  if (*cond == PTHREAD_COND_INITIALIZER)
+  if ((result = pthread_cond_init (&cv, NULL)) != 0)
     {
-      result = pthread_cond_init (cond, NULL);
+      return result;
     }
-  else if (*cond == NULL)
+
+  if (PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) cond,
+						(PTW32_INTERLOCKED_PVOID) cv,
+						(PTW32_INTERLOCKED_PVOID) PTHREAD_COND_INITIALIZER)
+      != (PTW32_INTERLOCKED_PVOID) PTHREAD_COND_INITIALIZER)
     {
-      /*
-       * The cv has been destroyed while we were waiting to
-       * initialise it, so the operation that caused the
-       * auto-initialisation should fail.
-       */
-      result = EINVAL;
-    }
+      (void) pthread_cond_destroy (&cv);
 
-  ptw32_mcs_lock_release(&node);
+      if (*cond == NULL)
+	{
+	  result = EINVAL;
+	}
+    }
 
   return result;
 }
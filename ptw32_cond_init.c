@@ -0,0 +1,216 @@
+/*
+ * ptw32_cond_init.c
+ *
+ * Description:
+ * This translation unit implements condition variables and their primitives.
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+ptw32_cond_init (pthread_cond_t * cond, const pthread_condattr_t * attr,
+		 void * storage, size_t size)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Initialises a condition variable as pthread_cond_init()
+      *      does, in 'storage' if that is given and at least 'size'
+      *      bytes are enough, otherwise on the heap.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result;
+  pthread_cond_t cv = NULL;
+  int wakeOrder;
+
+  if (cond == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (attr != NULL && PTW32_ATTR_IS_INITIALIZER (*attr))
+    {
+      attr = NULL;
+    }
+
+  if ((attr != NULL && *attr != NULL) &&
+      ((*attr)->pshared == PTHREAD_PROCESS_SHARED))
+    {
+      /*
+       * Creating condition variable that can be shared between
+       * processes. See ptw32_pshared_cond.c.
+       */
+      if ((*attr)->wakeOrder != PTHREAD_COND_WAKE_ANY_NP)
+	{
+	  return ENOSYS;
+	}
+
+      return ptw32_pshared_cond_init (cond, (*attr)->clock);
+    }
+
+  if (storage != NULL && size >= sizeof (*cv))
+    {
+      cv = (pthread_cond_t) storage;
+      memset (cv, 0, sizeof (*cv));
+      cv->inPlace = PTW32_TRUE;
+    }
+  else
+    {
+      cv = (pthread_cond_t) ptw32_object_alloc (sizeof (*cv), ptw32_objectAlign);
+    }
+
+  if (cv == NULL)
+    {
+      result = ENOMEM;
+      goto DONE;
+    }
+
+  cv->nWaitersBlocked = 0;
+  cv->nWaitersToUnblock = 0;
+  cv->nWaitersGone = 0;
+  cv->clock = (attr != NULL && *attr != NULL) ? (*attr)->clock : CLOCK_REALTIME;
+  cv->spinLimit = (attr != NULL && *attr != NULL) ? (*attr)->spin : 0;
+  cv->spinEstimate = 0;
+
+  /*
+   * Spinning only pays if the signaller can run while we spin.
+   */
+  if (cv->spinLimit > 0)
+    {
+      int cpus;
+
+      if (0 != ptw32_getprocessors (&cpus) || cpus < 2)
+        {
+          cv->spinLimit = 0;
+        }
+    }
+  PTW32_LOCKSTAT_INIT (cv->stats, PTHREAD_LOCKSTAT_COND_NP, cv);
+
+  /*
+   * Priority ordered waiters queue on semBlockQueue. See
+   * ptw32_sem_fifo.c.
+   */
+  wakeOrder = (attr != NULL && *attr != NULL) ? (*attr)->wakeOrder : PTHREAD_COND_WAKE_ANY_NP;
+
+#if defined(PTW32_COND_WAITONADDRESS)
+  if (ptw32_waitonaddress != NULL && wakeOrder == PTHREAD_COND_WAKE_ANY_NP)
+    {
+      /*
+       * Waiters park on cv->seq; no semaphores or mutexes needed.
+       */
+      cv->wakeByAddress = PTW32_TRUE;
+      cv->seqLock = 0;
+      cv->seq = 0;
+      cv->nWaiters = 0;
+      cv->nGenWaiters = 0;
+      cv->nMorphWaiters = 0;
+      cv->totalSeq = cv->wakeupSeq = cv->wokenSeq = cv->broadcastSeq = 0;
+      result = 0;
+      goto DONE;
+    }
+#endif
+
+  if (sem_init (&(cv->semBlockLock), 0, 1) != 0)
+    {
+      result = errno;
+      goto FAIL0;
+    }
+
+  if ((result = sem_init_np (&(cv->semBlockQueue), 0, 0,
+			     (wakeOrder == PTHREAD_COND_WAKE_PRIORITY_NP)
+			     ? SEM_PRIORITY_NP : 0)) != 0)
+    {
+      goto FAIL1;
+    }
+
+  if ((result = pthread_mutex_init (&(cv->mtxUnblockLock), 0)) != 0)
+    {
+      goto FAIL2;
+    }
+
+  result = 0;
+
+  goto DONE;
+
+  /*
+   * -------------
+   * Failed...
+   * -------------
+   */
+FAIL2:
+  (void) sem_destroy (&(cv->semBlockQueue));
+
+FAIL1:
+  (void) sem_destroy (&(cv->semBlockLock));
+
+FAIL0:
+  if (!cv->inPlace)
+    {
+      ptw32_object_free (cv);
+    }
+  cv = NULL;
+
+DONE:
+  if (0 == result && cv->clock != CLOCK_MONOTONIC)
+    {
+      ptw32_mcs_local_node_t node;
+      ptw32_cond_list_t * list = PTW32_COND_LIST_SHARD(cv);
+
+      ptw32_mcs_lock_acquire(&list->lock, &node);
+
+      cv->next = NULL;
+      cv->prev = list->tail;
+
+      if (list->tail != NULL)
+	{
+	  list->tail->next = cv;
+	}
+
+      list->tail = cv;
+
+      if (list->head == NULL)
+	{
+	  list->head = cv;
+	}
+
+      ptw32_mcs_lock_release(&node);
+    }
+
+  *cond = cv;
+
+  return result;
+
+}				/* ptw32_cond_init */
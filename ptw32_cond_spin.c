@@ -0,0 +1,104 @@
+/*
+ * ptw32_cond_spin.c
+ *
+ * Description:
+ * This translation unit implements condition variables and their primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+INLINE int
+ptw32_cond_spin (pthread_cond_t cv, LONG seq)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Spin-then-block support for condition variables with
+      *      a spin budget (pthread_condattr_setspin_np).
+      *
+      *      Called by a waiter after releasing the external mutex
+      *      and before it blocks. Polls for a signal for a bounded
+      *      number of iterations: a change of cv->seq from 'seq'
+      *      where waiters park on it, otherwise a unit on
+      *      semBlockQueue, which is taken as sem_trywait() would.
+      *
+      *      The bound self-tunes as ptw32_mutex_spin's does: twice
+      *      the running average of the spins that found a signal
+      *      (plus a small constant), but never more than the
+      *      condition variable's spinLimit.
+      *
+      * RESULTS
+      *              PTW32_TRUE      signalled (a semaphore unit has
+      *                              been taken),
+      *              PTW32_FALSE     the caller must block.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int limit;
+  int count;
+
+  if (cv->spinLimit == 0 || !ptw32_spin_pays ())
+    {
+      return PTW32_FALSE;
+    }
+
+  limit = PTW32_MIN(cv->spinEstimate * 2 + 10, cv->spinLimit);
+
+  for (count = 0; count < limit; count++)
+    {
+#if defined(PTW32_COND_WAITONADDRESS)
+      if (cv->wakeByAddress
+          ? PTW32_ATOMIC_LOAD_RELAXED_LONG ((PTW32_INTERLOCKED_LONGPTR) &cv->seq) != seq
+          : (PTW32_ATOMIC_LOAD_RELAXED_LONG ((PTW32_INTERLOCKED_LONGPTR) &cv->semBlockQueue->value) > 0
+             && 0 == sem_trywait (&cv->semBlockQueue)))
+#else
+      if (PTW32_ATOMIC_LOAD_RELAXED_LONG ((PTW32_INTERLOCKED_LONGPTR) &cv->semBlockQueue->value) > 0
+          && 0 == sem_trywait (&cv->semBlockQueue))
+#endif
+        {
+          /*
+           * The estimate isn't updated atomically. Lost updates
+           * only affect the tuning, not correctness.
+           */
+          cv->spinEstimate += (count - cv->spinEstimate) / 8;
+          return PTW32_TRUE;
+        }
+
+      PTW32_YIELD_PROCESSOR();
+    }
+
+  cv->spinEstimate += (count - cv->spinEstimate) / 8;
+
+  return PTW32_FALSE;
+}
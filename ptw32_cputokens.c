@@ -0,0 +1,197 @@
+/*
+ * ptw32_cputokens.c
+ *
+ * Description:
+ * This translation unit implements the process wide processor tokens.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * Processor tokens bound the threads of the process running compute
+ * work at once, whoever started them: pool workers hold one while they
+ * run tasks, and other runtimes, such as OpenMP through an adapter
+ * around omp_set_num_threads(), take as many as the threads they are
+ * about to run. While the tokens are off (the default) taking never
+ * waits, but the tokens held are still counted, so that turning them
+ * on later finds the right number free.
+ *
+ * ptw32_cpuTokensFree is always ptw32_cpuTokensTotal less the tokens
+ * held, and may be negative while they are off or after the total was
+ * lowered. Waiters park on it (WaitOnAddress, or the parking lot).
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+ptw32_cputokens_take (int min, int max)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Takes between 'min' and 'max' tokens, as many as are
+      *      free, waiting until at least 'min' are. With the
+      *      tokens off it takes 'max' at once.
+      *
+      *      The wait is not a library wait (ptw32_wait_begin),
+      *      so a pool worker waiting here isn't counted blocked
+      *      and doesn't start a spare.
+      *
+      * RESULTS
+      *              The number of tokens taken.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG free;
+  LONG n;
+
+  for (;;)
+    {
+      free = (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_cpuTokensFree,
+                                                        (PTW32_INTERLOCKED_LONG) 0);
+
+      if (ptw32_cpuTokens == PTHREAD_CPUTOKENS_OFF_NP)
+        {
+          n = max;
+        }
+      else if (free >= min)
+        {
+          n = (free < max) ? free : max;
+          if (n < 0)
+            {
+              n = 0;
+            }
+        }
+      else
+        {
+          /*
+           * Counted before looking again, ordered by the interlocked
+           * increment, so a giver either sees us or we see its tokens.
+           */
+          (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_cpuTokensWaiters);
+
+          if (free == ptw32_cpuTokensFree
+              && ptw32_cpuTokens != PTHREAD_CPUTOKENS_OFF_NP)
+            {
+              if (ptw32_waitonaddress != NULL)
+                {
+                  (void) ptw32_waitonaddress (&ptw32_cpuTokensFree, &free, sizeof (free), INFINITE);
+                }
+              else
+                {
+                  Sleep (1);
+                }
+            }
+
+          (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_cpuTokensWaiters);
+          continue;
+        }
+
+      if ((LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_cpuTokensFree,
+                                                          (PTW32_INTERLOCKED_LONG) (free - n),
+                                                          (PTW32_INTERLOCKED_LONG) free) == free)
+        {
+          return (int) n;
+        }
+    }
+}
+
+
+void
+ptw32_cputokens_give (int count)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Gives back 'count' tokens, waking the waiters to
+      *      take them. Also used with the difference when the
+      *      total changes.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (count == 0)
+    {
+      return;
+    }
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_cpuTokensFree,
+                                             (PTW32_INTERLOCKED_LONG) count);
+
+  if (count > 0
+      && 0 != PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_cpuTokensWaiters,
+                                                 (PTW32_INTERLOCKED_LONG) 0)
+      && ptw32_wakebyaddressall != NULL)
+    {
+      /* Each takes what it needs; the rest wait again */
+      ptw32_wakebyaddressall ((PVOID) &ptw32_cpuTokensFree);
+    }
+}
+
+
+void
+ptw32_cputoken_hold (ptw32_thread_t * sp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Makes pool worker sp (the caller) hold a token,
+      *      waiting for one if it doesn't already.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (sp->cpuToken != PTW32_CPUTOKEN_HELD)
+    {
+      (void) ptw32_cputokens_take (1, 1);
+      sp->cpuToken = PTW32_CPUTOKEN_HELD;
+    }
+}
+
+
+void
+ptw32_cputoken_drop (ptw32_thread_t * sp, int state)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Gives back the token pool worker sp (the caller)
+      *      holds, if it holds one, leaving it in 'state':
+      *      PTW32_CPUTOKEN_NONE when it goes idle or away,
+      *      PTW32_CPUTOKEN_LENT when it blocks.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (sp->cpuToken == PTW32_CPUTOKEN_HELD)
+    {
+      sp->cpuToken = state;
+      ptw32_cputokens_give (1);
+    }
+}
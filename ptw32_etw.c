@@ -0,0 +1,189 @@
+/*
+ * ptw32_etw.c
+ *
+ * Description:
+ * This translation unit implements the Event Tracing for Windows provider.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * A library built with PTW32_ETW registers an ETW provider named
+ * "pthreads-win32" when the process attaches and writes an event from
+ * the slow paths listed in implement.h. Each event carries
+ *
+ *   UINT64 object    the mutex, condition variable or ptw32_thread_t
+ *   UINT64 thread    the calling thread's seqNumber, 0 if not POSIX
+ *   INT64  value     event specific, see implement.h
+ *   char   name[]    the calling thread's name, "" if it has none
+ *
+ * The name is copied only if the thread's threadLock can be had at
+ * once: an event can be written while the thread holds it.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_ETW)
+
+/* {8b656e23-c73f-4622-baa9-03d94a3ec271} */
+static const GUID ptw32_etwProvider =
+  { 0x8b656e23, 0xc73f, 0x4622, { 0xba, 0xa9, 0x03, 0xd9, 0x4a, 0x3e, 0xc2, 0x71 } };
+
+#define PTW32_ETW_KEYWORD_MUTEX		0x1
+#define PTW32_ETW_KEYWORD_COND		0x2
+#define PTW32_ETW_KEYWORD_THREAD	0x4
+#define PTW32_ETW_KEYWORD_CANCEL	0x8
+
+#define PTW32_ETW_TASK_MUTEX		1
+#define PTW32_ETW_TASK_COND		2
+#define PTW32_ETW_TASK_THREAD		3
+
+#define PTW32_ETW_OPCODE_INFO		0
+#define PTW32_ETW_OPCODE_START		1
+#define PTW32_ETW_OPCODE_STOP		2
+
+#define PTW32_ETW_LEVEL_INFO		4
+
+#define PTW32_ETW_NAME_MAX		64
+
+/*
+ * Indexed by event. Fields are Id, Version, Channel, Level, Opcode,
+ * Task and Keyword.
+ */
+static const EVENT_DESCRIPTOR ptw32_etwEvents[PTW32_ETW_EVENTS] =
+{
+  { 0 },
+  { PTW32_ETW_MUTEX_WAIT_BEGIN, 0, 0, PTW32_ETW_LEVEL_INFO, PTW32_ETW_OPCODE_START,
+    PTW32_ETW_TASK_MUTEX, PTW32_ETW_KEYWORD_MUTEX },
+  { PTW32_ETW_MUTEX_WAIT_END, 0, 0, PTW32_ETW_LEVEL_INFO, PTW32_ETW_OPCODE_STOP,
+    PTW32_ETW_TASK_MUTEX, PTW32_ETW_KEYWORD_MUTEX },
+  { PTW32_ETW_MUTEX_WAKE, 0, 0, PTW32_ETW_LEVEL_INFO, PTW32_ETW_OPCODE_INFO,
+    PTW32_ETW_TASK_MUTEX, PTW32_ETW_KEYWORD_MUTEX },
+  { PTW32_ETW_COND_WAIT_BEGIN, 0, 0, PTW32_ETW_LEVEL_INFO, PTW32_ETW_OPCODE_START,
+    PTW32_ETW_TASK_COND, PTW32_ETW_KEYWORD_COND },
+  { PTW32_ETW_COND_WAIT_END, 0, 0, PTW32_ETW_LEVEL_INFO, PTW32_ETW_OPCODE_STOP,
+    PTW32_ETW_TASK_COND, PTW32_ETW_KEYWORD_COND },
+  { PTW32_ETW_COND_SIGNAL, 0, 0, PTW32_ETW_LEVEL_INFO, PTW32_ETW_OPCODE_INFO,
+    PTW32_ETW_TASK_COND, PTW32_ETW_KEYWORD_COND },
+  { PTW32_ETW_COND_BROADCAST, 0, 0, PTW32_ETW_LEVEL_INFO, PTW32_ETW_OPCODE_INFO,
+    PTW32_ETW_TASK_COND, PTW32_ETW_KEYWORD_COND },
+  { PTW32_ETW_THREAD_CREATE, 0, 0, PTW32_ETW_LEVEL_INFO, PTW32_ETW_OPCODE_START,
+    PTW32_ETW_TASK_THREAD, PTW32_ETW_KEYWORD_THREAD },
+  { PTW32_ETW_THREAD_EXIT, 0, 0, PTW32_ETW_LEVEL_INFO, PTW32_ETW_OPCODE_STOP,
+    PTW32_ETW_TASK_THREAD, PTW32_ETW_KEYWORD_THREAD },
+  { PTW32_ETW_THREAD_CANCEL, 0, 0, PTW32_ETW_LEVEL_INFO, PTW32_ETW_OPCODE_INFO,
+    PTW32_ETW_TASK_THREAD, PTW32_ETW_KEYWORD_CANCEL }
+};
+
+static VOID NTAPI
+ptw32_etw_enable (LPCGUID sourceId, ULONG isEnabled, UCHAR level,
+                  ULONGLONG matchAnyKeyword, ULONGLONG matchAllKeyword,
+                  PEVENT_FILTER_DESCRIPTOR filterData, PVOID context)
+{
+  /*
+   * EventEnabled() filters by level and keyword in ptw32_etw_write;
+   * this only needs to know whether anyone listens at all.
+   */
+  if (isEnabled != EVENT_CONTROL_CODE_CAPTURE_STATE)
+    {
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_etwEnabled,
+                                              (PTW32_INTERLOCKED_LONG) (isEnabled != 0));
+    }
+}
+
+void
+ptw32_etw_register (void)
+{
+  if (ERROR_SUCCESS != EventRegister (&ptw32_etwProvider, ptw32_etw_enable,
+                                      NULL, &ptw32_etwHandle))
+    {
+      ptw32_etwHandle = 0;
+    }
+}
+
+void
+ptw32_etw_unregister (void)
+{
+  if (0 != ptw32_etwHandle)
+    {
+      ptw32_etwEnabled = 0;
+      (void) EventUnregister (ptw32_etwHandle);
+      ptw32_etwHandle = 0;
+    }
+}
+
+void
+ptw32_etw_write (int event, const void * object, int64_t value)
+{
+  const EVENT_DESCRIPTOR * desc = &ptw32_etwEvents[event];
+  ptw32_thread_t * sp;
+  EVENT_DATA_DESCRIPTOR data[4];
+  ULONGLONG address = (ULONGLONG) (size_t) object;
+  ULONGLONG seq = 0;
+  char name[PTW32_ETW_NAME_MAX] = "";
+
+  if (!EventEnabled (ptw32_etwHandle, desc))
+    {
+      return;
+    }
+
+  /*
+   * Don't use pthread_self() so as not to give a Win32 thread an
+   * implicit POSIX handle just to trace it.
+   */
+  sp = PTW32_SELF_THREAD ();
+
+  if (NULL != sp)
+    {
+      ptw32_mcs_local_node_t node;
+
+      seq = (ULONGLONG) sp->seqNumber;
+
+      if (0 == ptw32_mcs_lock_try_acquire (&sp->threadLock, &node))
+        {
+          if ('\0' != sp->name[0])
+            {
+              strncpy (name, sp->name, sizeof (name) - 1);
+              name[sizeof (name) - 1] = '\0';
+            }
+          ptw32_mcs_lock_release (&node);
+        }
+    }
+
+  EventDataDescCreate (&data[0], &address, sizeof (address));
+  EventDataDescCreate (&data[1], &seq, sizeof (seq));
+  EventDataDescCreate (&data[2], &value, sizeof (value));
+  EventDataDescCreate (&data[3], name, (ULONG) strlen (name) + 1);
+
+  (void) EventWrite (ptw32_etwHandle, desc, 4, data);
+}
+
+#endif /* PTW32_ETW */
@@ -0,0 +1,965 @@
+/*
+ * ptw32_fiber.c
+ *
+ * Description:
+ * This translation unit implements PTHREAD_SCOPE_PROCESS threads.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ *
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+#if ! defined(_UWIN) && ! defined(WINCE)
+#include <process.h>
+#endif
+
+
+/*
+ * How it works:
+ * A thread created with PTHREAD_SCOPE_PROCESS is a fiber. Fibers are
+ * run by a pool of worker OS threads, one fiber at a time each, taken
+ * in FIFO order from the run queue. pthread_setconcurrency sets the
+ * number of workers; at level 0 there is one per processor.
+ *
+ * A fiber runs until it blocks in the library or calls sched_yield.
+ * It then switches back to its worker's own fiber, leaving it an
+ * action to carry out once the switch is complete, when nothing runs
+ * on the fiber's stack any more:
+ *
+ * - PTW32_FIBER_YIELD queues the fiber again.
+ * - PTW32_FIBER_WAIT registers a thread pool wait for each handle the
+ *   fiber waits on (ptw32_wait_objects). The first to fire, or time
+ *   out, queues it again.
+ * - PTW32_FIBER_PARK releases the lock of the bucket the fiber parked
+ *   itself in from inside the WaitOnAddress wrapper below. Wakes by
+ *   address take parked fibers out of the bucket and queue them. A
+ *   timer queue timer ends a timed park.
+ * - PTW32_FIBER_EXIT deletes the fiber once its thread has ended.
+ *
+ * A fiber may resume on any worker, so what Win32 keeps per OS thread
+ * moves with it: the values of the TLS backed keys and of the key
+ * table index, the last error and the self key are saved on each
+ * switch out and set again on each switch in.
+ *
+ * The worker clears the self key as soon as it is back, so that the
+ * pool waits and the locks it takes don't act for the fiber.
+ *
+ * What the library waits for without going through ptw32_wait_objects
+ * or WaitOnAddress still blocks the worker: SRW backed read/write
+ * locks, spin locks, contended internal (MCS) locks and Sleep, as well
+ * as anything the application itself blocks in.
+ */
+
+#if defined(PTW32_FIBER_THREADS)
+
+static ptw32_thread_t *
+ptw32_fiber_self (void)
+{
+  ptw32_thread_t * sp = PTW32_SELF_THREAD ();
+
+  return (sp != NULL && sp->fiber.handle != NULL) ? sp : NULL;
+}
+
+/*
+ * Queue a fiber to run.
+ */
+static void
+ptw32_fiber_ready (ptw32_fiber_t * fb)
+{
+  ptw32_mcs_local_node_t node;
+  int wake;
+
+  fb->next = NULL;
+
+  ptw32_mcs_lock_acquire (&ptw32_fiber_lock, &node);
+
+  if (ptw32_fiberRunTail != NULL)
+    {
+      ptw32_fiberRunTail->next = fb;
+    }
+  else
+    {
+      ptw32_fiberRunHead = fb;
+    }
+
+  ptw32_fiberRunTail = fb;
+
+  if ((wake = (ptw32_fiberIdleWorkers > 0)))
+    {
+      ptw32_fiberIdleWorkers--;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  if (wake)
+    {
+      (void) PTW32_RELEASESEMAPHORE (ptw32_fiberIdleSem, 1, NULL);
+    }
+}
+
+/*
+ * Take the calling worker out of the count, with ptw32_fiber_lock
+ * held by 'node'. Its wakeup may have been meant for a queued fiber,
+ * so that is passed on.
+ */
+static void
+ptw32_fiber_leave (ptw32_mcs_local_node_t * node)
+{
+  int wake;
+
+  ptw32_fiberWorkers--;
+
+  if ((wake = (ptw32_fiberRunHead != NULL && ptw32_fiberIdleWorkers > 0)))
+    {
+      ptw32_fiberIdleWorkers--;
+    }
+
+  ptw32_mcs_lock_release (node);
+
+  if (wake)
+    {
+      (void) PTW32_RELEASESEMAPHORE (ptw32_fiberIdleSem, 1, NULL);
+    }
+}
+
+/*
+ * Returns the next fiber to run, waiting for one if need be, or NULL
+ * if there are more workers than pthread_setconcurrency asks for and
+ * the calling one should end.
+ */
+static ptw32_fiber_t *
+ptw32_fiber_next (void)
+{
+  ptw32_mcs_local_node_t node;
+  ptw32_fiber_t * fb;
+
+  for (;;)
+    {
+      int target = ptw32_concurrency_level ();
+
+      ptw32_mcs_lock_acquire (&ptw32_fiber_lock, &node);
+
+      if (ptw32_fiberWorkers > target)
+	{
+	  ptw32_fiber_leave (&node);
+	  return NULL;
+	}
+
+      if ((fb = ptw32_fiberRunHead) != NULL)
+	{
+	  if (NULL == (ptw32_fiberRunHead = fb->next))
+	    {
+	      ptw32_fiberRunTail = NULL;
+	    }
+	  ptw32_mcs_lock_release (&node);
+	  return fb;
+	}
+
+      ptw32_fiberIdleWorkers++;
+      ptw32_mcs_lock_release (&node);
+
+      PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_OTHER);
+      (void) WaitForSingleObject (ptw32_fiberIdleSem, INFINITE);
+    }
+}
+
+/*
+ * Save what the calling fiber keeps per OS thread before it switches
+ * out. See ptw32_fiber_restore.
+ */
+static void
+ptw32_fiber_save (ptw32_thread_t * sp)
+{
+  ptw32_fiber_t * fb = &sp->fiber;
+  ptw32_mcs_local_node_t node;
+  unsigned int n;
+  unsigned int slot;
+
+  fb->lastError = GetLastError ();
+
+  fb->tsdTable = (ptw32_tsdTableIndex != TLS_OUT_OF_INDEXES)
+                 ? TlsGetValue (ptw32_tsdTableIndex) : NULL;
+
+  ptw32_mcs_lock_acquire (&ptw32_tsd_slot_lock, &node);
+
+  if ((n = ptw32_tsdNextSlot) > fb->tsdSize)
+    {
+      ptw32_tsd_entry_t * tsd = (ptw32_tsd_entry_t *)
+	realloc (fb->tsd, n * sizeof (ptw32_tsd_entry_t));
+
+      if (tsd != NULL)
+	{
+	  fb->tsd = tsd;
+	  fb->tsdSize = n;
+	}
+      else
+	{
+	  /* Keys in the slots that don't fit read as NULL afterwards */
+	  n = fb->tsdSize;
+	}
+    }
+
+  for (slot = 0; slot < n; slot++)
+    {
+      pthread_key_t k = ptw32_tsdKeys[slot];
+
+      if (k != NULL && !PTW32_KEY_IN_TABLE(k) && k != ptw32_selfThreadKey)
+	{
+	  fb->tsd[slot].value = TlsGetValue (k->key);
+	  fb->tsd[slot].generation = k->generation;
+	}
+      else
+	{
+	  fb->tsd[slot].value = NULL;
+	}
+    }
+
+  fb->nTsd = n;
+
+  ptw32_mcs_lock_release (&node);
+}
+
+/*
+ * Set again what the calling fiber keeps per OS thread on the worker
+ * it has switched in on. A key deleted while the fiber was switched
+ * out, and its slot reused, doesn't match the saved generation and
+ * starts out NULL as it would for a new key.
+ */
+static void
+ptw32_fiber_restore (ptw32_thread_t * sp)
+{
+  ptw32_fiber_t * fb = &sp->fiber;
+  ptw32_mcs_local_node_t node;
+  unsigned int slot;
+
+  ptw32_mcs_lock_acquire (&ptw32_tsd_slot_lock, &node);
+
+  for (slot = 0; slot < ptw32_tsdNextSlot; slot++)
+    {
+      pthread_key_t k = ptw32_tsdKeys[slot];
+
+      if (k != NULL && !PTW32_KEY_IN_TABLE(k) && k != ptw32_selfThreadKey)
+	{
+	  (void) TlsSetValue (k->key,
+			      (slot < fb->nTsd && fb->tsd[slot].generation == k->generation)
+			      ? fb->tsd[slot].value : NULL);
+	}
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  if (ptw32_tsdTableIndex != TLS_OUT_OF_INDEXES)
+    {
+      (void) TlsSetValue (ptw32_tsdTableIndex, fb->tsdTable);
+    }
+
+  (void) pthread_setspecific (ptw32_selfThreadKey, (void *) sp);
+
+  SetLastError (fb->lastError);
+}
+
+/*
+ * Switch the calling fiber out, leaving its worker 'action' to do.
+ * Returns once the fiber has been switched in again.
+ */
+static void
+ptw32_fiber_switch (ptw32_thread_t * sp, int action)
+{
+  ptw32_fiber_worker_t * worker;
+
+  ptw32_fiber_save (sp);
+
+  worker = (ptw32_fiber_worker_t *) TlsGetValue (ptw32_fiberWorkerIndex);
+  worker->action = action;
+  SwitchToFiber (worker->fiber);
+
+  ptw32_fiber_restore (sp);
+}
+
+static void
+ptw32_fiber_unref (ptw32_fiber_t * fb)
+{
+  if (0 == PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &fb->refs))
+    {
+      ptw32_fiber_ready (fb);
+    }
+}
+
+/*
+ * A handle wait is over. Only the first one to end drops the waits'
+ * reference; the fiber unregisters the others when it runs.
+ */
+static void
+ptw32_fiber_fire (ptw32_fiber_t * fb)
+{
+  if (0 == PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &fb->fired,
+						     (PTW32_INTERLOCKED_LONG) 1,
+						     (PTW32_INTERLOCKED_LONG) 0))
+    {
+      ptw32_fiber_unref (fb);
+    }
+}
+
+static VOID CALLBACK
+ptw32_fiber_fired (PVOID arg, BOOLEAN timedOut)
+{
+  ptw32_fiber_handle_wait_t * w = (ptw32_fiber_handle_wait_t *) arg;
+
+  w->status = timedOut ? WAIT_TIMEOUT : WAIT_OBJECT_0;
+  ptw32_fiber_fire (w->fb);
+}
+
+/*
+ * PTW32_FIBER_WAIT, on the worker. There are two references to the
+ * fiber, one for the registration and one for the waits, so that it
+ * isn't queued before every handle has been registered.
+ */
+static void
+ptw32_fiber_register (ptw32_fiber_t * fb)
+{
+  DWORD i;
+
+  for (i = 0; i < fb->nHandles; i++)
+    {
+      if (!RegisterWaitForSingleObject (&fb->waits[i].wait, fb->handles[i],
+					ptw32_fiber_fired, &fb->waits[i],
+					(0 == i) ? fb->timeout : INFINITE,
+					WT_EXECUTEONLYONCE))
+	{
+	  /* Ends in WAIT_FAILED unless a wait has fired already */
+	  fb->waits[i].wait = NULL;
+	  ptw32_fiber_fire (fb);
+	  break;
+	}
+    }
+
+  ptw32_fiber_unref (fb);
+}
+
+/*
+ * WaitForMultipleObjects, not waiting for all, for the calling fiber.
+ * Every wait that fired took its object's signal, so the lowest of
+ * them is the one reported, as WaitForMultipleObjects would. The
+ * others are the cancel event (manual reset) and timeout timers in
+ * every wait the library makes.
+ */
+static DWORD
+ptw32_fiber_wait (ptw32_thread_t * sp, DWORD nCount, HANDLE * handles, DWORD milliseconds)
+{
+  ptw32_fiber_t * fb = &sp->fiber;
+  DWORD status = WAIT_FAILED;
+  DWORD i;
+
+  fb->nHandles = nCount;
+  fb->timeout = milliseconds;
+  fb->fired = 0;
+  fb->refs = 2;
+
+  for (i = 0; i < nCount; i++)
+    {
+      fb->handles[i] = handles[i];
+      fb->waits[i].fb = fb;
+      fb->waits[i].wait = NULL;
+      fb->waits[i].status = WAIT_FAILED;
+    }
+
+  ptw32_fiber_switch (sp, PTW32_FIBER_WAIT);
+
+  for (i = 0; i < nCount; i++)
+    {
+      if (fb->waits[i].wait != NULL)
+	{
+	  /* Waits for a callback that is running */
+	  (void) UnregisterWaitEx (fb->waits[i].wait, INVALID_HANDLE_VALUE);
+	}
+    }
+
+  for (i = nCount; i-- > 0; )
+    {
+      if (fb->waits[i].status == WAIT_OBJECT_0)
+	{
+	  status = WAIT_OBJECT_0 + i;
+	}
+      else if (fb->waits[i].status == WAIT_TIMEOUT && status == WAIT_FAILED)
+	{
+	  status = WAIT_TIMEOUT;
+	}
+    }
+
+  return status;
+}
+
+/*
+ * Take 'fb' out of its bucket, whose lock the caller holds. Returns
+ * PTW32_TRUE if it was still parked.
+ */
+static int
+ptw32_fiber_unpark (ptw32_fiber_bucket_t * b, ptw32_fiber_t * fb)
+{
+  ptw32_fiber_t ** link;
+
+  for (link = &b->parked; *link != NULL; link = &(*link)->next)
+    {
+      if (*link == fb)
+	{
+	  *link = fb->next;
+	  return PTW32_TRUE;
+	}
+    }
+
+  return PTW32_FALSE;
+}
+
+static VOID CALLBACK
+ptw32_fiber_expired (PVOID arg, BOOLEAN unused)
+{
+  ptw32_fiber_t * fb = (ptw32_fiber_t *) arg;
+  ptw32_fiber_bucket_t * b = PTW32_FIBER_BUCKET (fb->address);
+  ptw32_mcs_local_node_t node;
+  int expired;
+
+  ptw32_mcs_lock_acquire (&b->lock, &node);
+  expired = ptw32_fiber_unpark (b, fb);
+  ptw32_mcs_lock_release (&node);
+
+  if (expired)
+    {
+      ptw32_fiber_ready (fb);
+    }
+}
+
+/*
+ * PTW32_FIBER_PARK, on the worker. The timer is started while the
+ * bucket is still locked so that the fiber can't be woken and look
+ * at fb->timer before it is set.
+ */
+static void
+ptw32_fiber_arm (ptw32_fiber_t * fb)
+{
+  int expired = PTW32_FALSE;
+
+  if (fb->timeout != INFINITE
+      && !CreateTimerQueueTimer (&fb->timer, NULL, ptw32_fiber_expired, fb,
+				 fb->timeout, 0, WT_EXECUTEONLYONCE))
+    {
+      fb->timer = NULL;
+      expired = ptw32_fiber_unpark (PTW32_FIBER_BUCKET (fb->address), fb);
+    }
+
+  ptw32_mcs_lock_release (fb->bucketNode);
+
+  if (expired)
+    {
+      ptw32_fiber_ready (fb);
+    }
+}
+
+/*
+ * Queue the fibers parked on 'address', or just the first of them.
+ * Returns the number queued.
+ */
+static int
+ptw32_fiber_wake (PVOID address, int all)
+{
+  ptw32_fiber_bucket_t * b = PTW32_FIBER_BUCKET (address);
+  ptw32_fiber_t * woken = NULL;
+  ptw32_fiber_t ** link;
+  ptw32_fiber_t * fb;
+  ptw32_mcs_local_node_t node;
+  int count = 0;
+
+  ptw32_mcs_lock_acquire (&b->lock, &node);
+
+  link = &b->parked;
+
+  while ((fb = *link) != NULL)
+    {
+      if (fb->address == address)
+	{
+	  *link = fb->next;
+	  fb->woken = PTW32_TRUE;
+	  fb->next = woken;
+	  woken = fb;
+	  count++;
+
+	  if (!all)
+	    {
+	      break;
+	    }
+	}
+      else
+	{
+	  link = &fb->next;
+	}
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  while (woken != NULL)
+    {
+      fb = woken;
+      woken = fb->next;
+      ptw32_fiber_ready (fb);
+    }
+
+  return count;
+}
+
+/*
+ * The WaitOnAddress functions used by the library once there are
+ * fibers. OS threads still wait in the system's; its wake functions
+ * are called as well unless one parked fiber was all that was asked
+ * to wake.
+ */
+static BOOL WINAPI
+ptw32_fiber_waitonaddress (volatile VOID * address, PVOID compare, SIZE_T size, DWORD milliseconds)
+{
+  ptw32_thread_t * sp = ptw32_fiber_self ();
+  ptw32_fiber_t * fb;
+  ptw32_fiber_bucket_t * b;
+  ptw32_fiber_t ** link;
+  ptw32_mcs_local_node_t node;
+
+  if (NULL == sp)
+    {
+      return ptw32_fiber_os_waitonaddress (address, compare, size, milliseconds);
+    }
+
+  fb = &sp->fiber;
+  b = PTW32_FIBER_BUCKET (address);
+
+  /*
+   * Wakers change the value before they take the bucket lock, so the
+   * value is compared with it held.
+   */
+  ptw32_mcs_lock_acquire (&b->lock, &node);
+
+  if (memcmp ((const void *) address, compare, size) != 0)
+    {
+      ptw32_mcs_lock_release (&node);
+      return PTW32_TRUE;
+    }
+
+  if (0 == milliseconds)
+    {
+      ptw32_mcs_lock_release (&node);
+      SetLastError (ERROR_TIMEOUT);
+      return PTW32_FALSE;
+    }
+
+  fb->address = address;
+  fb->timeout = milliseconds;
+  fb->timer = NULL;
+  fb->woken = PTW32_FALSE;
+  fb->bucketNode = &node;
+  fb->next = NULL;
+
+  for (link = &b->parked; *link != NULL; link = &(*link)->next)
+    {
+      /* Woken in the order parked */
+    }
+  *link = fb;
+
+  /* The worker releases the bucket lock */
+  ptw32_fiber_switch (sp, PTW32_FIBER_PARK);
+
+  if (fb->timer != NULL)
+    {
+      (void) DeleteTimerQueueTimer (NULL, fb->timer, INVALID_HANDLE_VALUE);
+    }
+
+  if (!fb->woken)
+    {
+      SetLastError (ERROR_TIMEOUT);
+      return PTW32_FALSE;
+    }
+
+  return PTW32_TRUE;
+}
+
+static VOID WINAPI
+ptw32_fiber_wakebyaddresssingle (PVOID address)
+{
+  if (0 == ptw32_fiber_wake (address, PTW32_FALSE))
+    {
+      ptw32_fiber_os_wakebyaddresssingle (address);
+    }
+}
+
+static VOID WINAPI
+ptw32_fiber_wakebyaddressall (PVOID address)
+{
+  (void) ptw32_fiber_wake (address, PTW32_TRUE);
+  ptw32_fiber_os_wakebyaddressall (address);
+}
+
+/*
+ * Where every fiber starts. The thread ends like a cached thread,
+ * signalling its exit event once its struct is no longer touched,
+ * and the worker then deletes the fiber.
+ */
+static VOID CALLBACK
+ptw32_fiber_start (LPVOID arg)
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) arg;
+  ptw32_fiber_worker_t * worker;
+  ptw32_mcs_local_node_t stateLock;
+  HANDLE exitEvent;
+
+  ptw32_fiber_restore (sp);
+
+  ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
+  if (sp->state < PThreadStateCancelPending)
+    {
+      sp->state = PThreadStateRunning;
+    }
+  ptw32_mcs_lock_release (&stateLock);
+
+  /* Fibers have a stack guarantee of their own */
+  if (sp->parms.stackGuard > 0)
+    {
+      ULONG guarantee = sp->parms.stackGuard;
+
+      (void) ptw32_setthreadstackguarantee (&guarantee);
+    }
+
+  ptw32_threadRun ();
+
+  exitEvent = sp->exitEvent;
+
+  (void) pthread_win32_thread_detach_np ();
+
+  /* As in ptw32_threadCachePark */
+  if (PTW32_SELF_THREAD () != NULL)
+    {
+      (void) pthread_setspecific (ptw32_selfThreadKey, NULL);
+    }
+  else
+    {
+      exitEvent = NULL;
+    }
+
+  worker = (ptw32_fiber_worker_t *) TlsGetValue (ptw32_fiberWorkerIndex);
+
+  if (exitEvent != NULL)
+    {
+      (void) PTW32_SETEVENT (exitEvent);
+    }
+
+  worker->action = PTW32_FIBER_EXIT;
+  SwitchToFiber (worker->fiber);
+}
+
+#if ! defined (PTW32_CONFIG_MINGW) || defined (__MSVCRT__) || defined (__DMC__)
+static unsigned __stdcall
+#else
+static void
+#endif
+ptw32_fiber_worker (void * arg)
+{
+  ptw32_fiber_worker_t worker;
+  ptw32_fiber_t * fb;
+
+  if (NULL == (worker.fiber = ConvertThreadToFiberEx (NULL, FIBER_FLAG_FLOAT_SWITCH))
+      || !TlsSetValue (ptw32_fiberWorkerIndex, &worker))
+    {
+      ptw32_mcs_local_node_t node;
+
+      ptw32_mcs_lock_acquire (&ptw32_fiber_lock, &node);
+      ptw32_fiber_leave (&node);
+      fb = NULL;
+    }
+  else
+    {
+      fb = ptw32_fiber_next ();
+    }
+
+  while (fb != NULL)
+    {
+      /* The fiber may be gone once it has exited */
+      LPVOID handle = fb->handle;
+
+      SwitchToFiber (handle);
+
+      if (PTW32_SELF_THREAD () != NULL)
+	{
+	  (void) pthread_setspecific (ptw32_selfThreadKey, NULL);
+	}
+
+      switch (worker.action)
+	{
+	case PTW32_FIBER_YIELD:
+	  ptw32_fiber_ready (fb);
+	  break;
+	case PTW32_FIBER_WAIT:
+	  ptw32_fiber_register (fb);
+	  break;
+	case PTW32_FIBER_PARK:
+	  ptw32_fiber_arm (fb);
+	  break;
+	case PTW32_FIBER_EXIT:
+	  DeleteFiber (handle);
+	  break;
+	}
+
+      fb = ptw32_fiber_next ();
+    }
+
+  if (worker.fiber != NULL)
+    {
+      (void) ConvertFiberToThread ();
+    }
+
+#if ! defined (PTW32_CONFIG_MINGW) || defined (__MSVCRT__) || defined (__DMC__)
+  return 0;
+#endif
+}
+
+static int
+ptw32_fiber_startWorker (void)
+{
+#if ! defined (PTW32_CONFIG_MINGW) || defined (__MSVCRT__) || defined (__DMC__)
+  HANDLE threadH = (HANDLE) _beginthreadex (NULL, 0, ptw32_fiber_worker, NULL, 0, NULL);
+
+  if (threadH == 0)
+    {
+      return PTW32_FALSE;
+    }
+
+  (void) CloseHandle (threadH);
+  return PTW32_TRUE;
+#else
+  return (HANDLE) _beginthread (ptw32_fiber_worker, 0, NULL) != (HANDLE) - 1L;
+#endif
+}
+
+#endif /* PTW32_FIBER_THREADS */
+
+/*
+ * Bring the number of fiber workers to what pthread_setconcurrency
+ * asks for. Surplus workers end when they next look for a fiber, so
+ * the idle ones are woken.
+ */
+void
+ptw32_fiber_workers (void)
+{
+#if defined(PTW32_FIBER_THREADS)
+  ptw32_mcs_local_node_t node;
+  int target;
+  int start;
+  int wake = 0;
+
+  if (NULL == ptw32_fiberIdleSem)
+    {
+      /* No fibers yet */
+      return;
+    }
+
+  target = ptw32_concurrency_level ();
+
+  ptw32_mcs_lock_acquire (&ptw32_fiber_lock, &node);
+
+  if ((start = target - ptw32_fiberWorkers) > 0)
+    {
+      ptw32_fiberWorkers = target;
+    }
+  else
+    {
+      wake = ptw32_fiberIdleWorkers;
+      ptw32_fiberIdleWorkers = 0;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  if (wake > 0)
+    {
+      (void) PTW32_RELEASESEMAPHORE (ptw32_fiberIdleSem, wake, NULL);
+    }
+
+  for (; start > 0; start--)
+    {
+      if (!ptw32_fiber_startWorker ())
+	{
+	  ptw32_mcs_lock_acquire (&ptw32_fiber_lock, &node);
+	  ptw32_fiberWorkers -= start;
+	  ptw32_mcs_lock_release (&node);
+	  break;
+	}
+    }
+#endif
+}
+
+/*
+ * Make 'tp' a fiber whose stack reserves 'stackSize' bytes and commits
+ * 'stackCommit' (0: the defaults) and queue it to run.
+ *
+ * RESULTS
+ *              0               the fiber is queued,
+ *              EAGAIN          insufficient resources,
+ *              ENOTSUP         this system has no fibers.
+ */
+int
+ptw32_fiber_create (ptw32_thread_t * tp, size_t stackSize, size_t stackCommit)
+{
+#if defined(PTW32_FIBER_THREADS)
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&ptw32_fiber_lock, &node);
+
+  if (NULL == ptw32_fiberIdleSem)
+    {
+      if (TLS_OUT_OF_INDEXES == ptw32_fiberWorkerIndex)
+	{
+	  ptw32_fiberWorkerIndex = TlsAlloc ();
+	}
+
+      if (TLS_OUT_OF_INDEXES != ptw32_fiberWorkerIndex
+	  && NULL != (ptw32_fiberIdleSem = ptw32_libstat_handle (CreateSemaphore (NULL, 0, (long) SEM_VALUE_MAX, NULL),
+								 PTW32_LIBSTAT_SEMAPHORES))
+	  && NULL != ptw32_waitonaddress)
+	{
+	  ptw32_fiber_os_waitonaddress = ptw32_waitonaddress;
+	  ptw32_fiber_os_wakebyaddresssingle = ptw32_wakebyaddresssingle;
+	  ptw32_fiber_os_wakebyaddressall = ptw32_wakebyaddressall;
+
+	  /* Wakes first, so that no fiber parks unseen by a waker */
+	  ptw32_wakebyaddresssingle = ptw32_fiber_wakebyaddresssingle;
+	  ptw32_wakebyaddressall = ptw32_fiber_wakebyaddressall;
+	  ptw32_waitonaddress = ptw32_fiber_waitonaddress;
+	}
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  if (NULL == ptw32_fiberIdleSem)
+    {
+      return EAGAIN;
+    }
+
+  if (tp->exitEvent == NULL)
+    {
+      tp->exitEvent = ptw32_libstat_handle (CreateEvent (NULL, PTW32_TRUE, PTW32_FALSE, NULL),
+					     PTW32_LIBSTAT_EVENTS);
+    }
+  else
+    {
+      (void) ResetEvent (tp->exitEvent);
+    }
+
+  if (tp->exitEvent == NULL
+      || NULL == (tp->fiber.handle = CreateFiberEx (stackCommit, stackSize, FIBER_FLAG_FLOAT_SWITCH,
+						    ptw32_fiber_start, tp)))
+    {
+      return EAGAIN;
+    }
+
+  tp->fiber.nTsd = 0;
+  tp->fiber.tsdTable = NULL;
+  tp->fiber.lastError = 0;
+  tp->cached = PTW32_TRUE;
+
+  ptw32_fiber_workers ();
+
+  if (0 == ptw32_fiberWorkers)
+    {
+      DeleteFiber (tp->fiber.handle);
+      tp->fiber.handle = NULL;
+      tp->cached = PTW32_FALSE;
+      return EAGAIN;
+    }
+
+  ptw32_fiber_ready (&tp->fiber);
+
+  return 0;
+#else
+  return ENOTSUP;
+#endif
+}
+
+/*
+ * sched_yield for fibers. Returns PTW32_TRUE if the caller is a fiber
+ * and has let the others queued run first.
+ */
+int
+ptw32_fiber_yield (void)
+{
+#if defined(PTW32_FIBER_THREADS)
+  ptw32_thread_t * sp = ptw32_fiber_self ();
+
+  if (sp != NULL)
+    {
+      ptw32_fiber_switch (sp, PTW32_FIBER_YIELD);
+      return PTW32_TRUE;
+    }
+#endif
+
+  return PTW32_FALSE;
+}
+
+/*
+ * Wait as WaitForMultipleObjects does, not waiting for all. A fiber
+ * switches out rather than blocking its worker. Waits that may block
+ * are counted in the thread's statistics.
+ */
+DWORD
+ptw32_wait_objects (DWORD nCount, HANDLE * handles, DWORD milliseconds)
+{
+  DWORD status;
+  int64_t start;
+#if defined(PTW32_FIBER_THREADS)
+  ptw32_thread_t * sp = ptw32_fiber_self ();
+
+  if (sp != NULL && nCount <= PTW32_FIBER_MAX_WAIT)
+    {
+      status = WaitForMultipleObjects (nCount, handles, PTW32_FALSE, 0);
+
+      if (status != WAIT_TIMEOUT || 0 == milliseconds)
+	{
+	  return status;
+	}
+
+      start = ptw32_wait_begin ();
+      status = ptw32_fiber_wait (sp, nCount, handles, milliseconds);
+      ptw32_wait_end (start);
+      return status;
+    }
+#endif
+
+  if (0 == milliseconds)
+    {
+      return WaitForMultipleObjects (nCount, handles, PTW32_FALSE, 0);
+    }
+
+  start = ptw32_wait_begin ();
+  status = WaitForMultipleObjects (nCount, handles, PTW32_FALSE, milliseconds);
+  ptw32_wait_end (start);
+
+  return status;
+}
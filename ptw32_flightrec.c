@@ -0,0 +1,131 @@
+/*
+ * ptw32_flightrec.c
+ *
+ * Description:
+ * This translation unit implements the per thread flight recorder.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include <string.h>
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Each POSIX thread writes its own events, at the ETW recording
+ * points: a ring of PTW32_FLIGHTREC_EVENTS with no lock, and the
+ * slot's seq written last, so pthread_flightrec_dump_np can copy it
+ * while the thread goes on and discard the slots it overwrote
+ * meanwhile. The recording points are all on slow paths, so the
+ * recorder is always on; a thread pays a performance counter read
+ * and a few stores per event.
+ *
+ * A record keeps its thread's Windows ID and seqNumber and the
+ * counter frequency, so that a debugger, starting at ptw32_flightRecs
+ * or searching a full dump for PTW32_FLIGHTREC_TAG, can read it with
+ * nothing else to go on.
+ */
+
+
+void
+ptw32_flightrec_record (int event, const void * object, int64_t value)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Records 'event' in the calling thread's flight
+      *      recorder, making it and adding it to
+      *      ptw32_flightRecs the first time. Nothing is recorded
+      *      if the caller is not a POSIX thread or there is no
+      *      memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp;
+  ptw32_flightrec_t * rec;
+  ptw32_flightrec_event_t * e;
+  LARGE_INTEGER count;
+  LONG pos;
+
+  if (ptw32_selfThreadKey == NULL
+      || NULL == (sp = PTW32_SELF_THREAD ()))
+    {
+      return;
+    }
+
+  if ((rec = sp->flightRec) == NULL)
+    {
+      ptw32_flightrec_t * head;
+
+      if ((rec = (ptw32_flightrec_t *) ptw32_object_alloc (sizeof (*rec), 0)) == NULL)
+	{
+	  return;
+	}
+
+      memcpy (rec->tag, PTW32_FLIGHTREC_TAG, sizeof (rec->tag));
+      rec->frequency = ptw32_perf_frequency ();
+
+      do
+	{
+	  head = ptw32_flightRecs;
+	  rec->link = head;
+	}
+      while (PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &ptw32_flightRecs,
+						     (PTW32_INTERLOCKED_PVOID) rec,
+						     (PTW32_INTERLOCKED_PVOID) head)
+	     != (PTW32_INTERLOCKED_PVOID) head);
+
+      sp->flightRec = rec;
+    }
+
+  if (rec->seqNumber != sp->seqNumber)
+    {
+      /* A new thread in a reused struct starts an empty ring */
+      rec->thread = sp->thread;
+      rec->next = 0;
+      rec->seqNumber = sp->seqNumber;
+    }
+
+  pos = rec->next;
+  e = &rec->events[pos & (PTW32_FLIGHTREC_EVENTS - 1)];
+
+  (void) QueryPerformanceCounter (&count);
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &e->seq,
+					  (PTW32_INTERLOCKED_LONG) 0);
+  e->time = (int64_t) count.QuadPart;
+  e->object = object;
+  e->value = value;
+  e->event = (LONG) event;
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &e->seq,
+					  (PTW32_INTERLOCKED_LONG) (pos + 1));
+  rec->next = pos + 1;
+}
@@ -50,13 +50,12 @@
  * pthread_spin_init() calls this routine when initialising
  * a spinlock. If the number of available processors changes
  * (after a call to SetProcessAffinityMask()) then only
- * newly initialised spinlocks will notice.
+ * newly initialised spinlocks will block, though existing ones
+ * stop spinning (see ptw32_spin_pays() below).
  */
 int
 ptw32_getprocessors (int *count)
 {
-  DWORD_PTR vProcessCPUs;
-  DWORD_PTR vSystemCPUs;
   int result = 0;
 
 #if defined(NEED_PROCESS_AFFINITY_MASK)
@@ -65,27 +64,188 @@ ptw32_getprocessors (int *count)
 
 #else
 
-  if (GetProcessAffinityMask (GetCurrentProcess (),
-			      &vProcessCPUs, &vSystemCPUs))
+  if (ptw32_getactiveprocessorgroupcount != NULL
+      && ptw32_getactiveprocessorgroupcount () > 1)
     {
-      DWORD_PTR bit;
-      int CPUs = 0;
+      /*
+       * Every processor group, including any beyond those a
+       * cpu_set_t can name.
+       */
+      *count = (int) ptw32_getactiveprocessorcount (ALL_PROCESSOR_GROUPS);
+    }
+  else
+    {
+      cpu_set_t processCpuset;
+
+      if (0 == (result = ptw32_getprocessaffinity (&processCpuset)))
+	{
+	  *count = CPU_COUNT (&processCpuset);
+	}
+    }
+
+#endif
+
+  return (result);
+}
+
+
+/*
+ * ptw32_concurrency_level()
+ *
+ * Get the number of workers the library sizes its own worker
+ * threads to: the level last set with pthread_setconcurrency(),
+ * or the number of CPUs available to the process if none has
+ * been set. Always at least 1.
+ *
+ * pthread_pool_create_np() calls this routine for a pool created
+ * with zero workers, and PTHREAD_SCOPE_PROCESS threads are run
+ * on this many worker threads.
+ */
+int
+ptw32_concurrency_level (void)
+{
+  int count = ptw32_concurrency;
+
+  if (count <= 0
+      && (0 != ptw32_getprocessors (&count) || count <= 0))
+    {
+      count = 1;
+    }
+
+  return count;
+}
+
+
+#if ! defined(NEED_PROCESS_AFFINITY_MASK)
+
+/*
+ * JOBOBJECT_CPU_RATE_CONTROL_INFORMATION, which older SDKs lack.
+ * Rates are hundredths of a percent of every processor in the
+ * system; with PTW32_JOB_CPU_RATE_MIN_MAX the high word of rate is
+ * the maximum.
+ */
+typedef struct
+{
+  DWORD flags;
+  DWORD rate;
+} ptw32_job_cpu_rate_t;
+
+#define PTW32_JOB_CPU_RATE_INFORMATION	15
+#define PTW32_JOB_CPU_RATE_ENABLE	0x1
+#define PTW32_JOB_CPU_RATE_HARD_CAP	0x4
+#define PTW32_JOB_CPU_RATE_MIN_MAX	0x10
+
+/*
+ * The CPUs available to the process, reduced to those a hard CPU
+ * rate cap on its job object lets it use at once.
+ */
+static int
+ptw32_effectiveprocessors (void)
+{
+  int cpus;
+  ptw32_job_cpu_rate_t info;
+
+  if (0 != ptw32_getprocessors (&cpus) || cpus < 1)
+    {
+      cpus = 1;
+    }
+
+  if (QueryInformationJobObject (NULL,
+				 (JOBOBJECTINFOCLASS) PTW32_JOB_CPU_RATE_INFORMATION,
+				 &info, sizeof (info), NULL)
+      && (info.flags & PTW32_JOB_CPU_RATE_ENABLE))
+    {
+      DWORD rate = 0;
+
+      if (info.flags & PTW32_JOB_CPU_RATE_MIN_MAX)
+	{
+	  rate = HIWORD (info.rate);
+	}
+      else if (info.flags & PTW32_JOB_CPU_RATE_HARD_CAP)
+	{
+	  rate = info.rate;
+	}
 
-      for (bit = 1; bit != 0; bit <<= 1)
+      if (rate > 0)
 	{
-	  if (vProcessCPUs & bit)
+	  SYSTEM_INFO si;
+	  int capped;
+
+	  GetSystemInfo (&si);
+	  capped = (int) (((ULONGLONG) si.dwNumberOfProcessors * rate) / 10000);
+
+	  if (capped < cpus)
 	    {
-	      CPUs++;
+	      cpus = (capped > 0 ? capped : 1);
 	    }
 	}
-      *count = CPUs;
     }
-  else
+
+  return cpus;
+}
+
+#endif
+
+
+/*
+ * ptw32_spin_pays()
+ *
+ * Whether a thread waiting for a lock can expect the owner to make
+ * progress while it spins, that is whether the calling thread and
+ * the owner can run at once. They can't if the process, or the
+ * calling thread, may only use one CPU, or if the job object caps
+ * the process at less than two CPUs' worth of time.
+ *
+ * Unlike ptw32_getprocessors(), which pthread_spin_init() consults
+ * once, this follows changes to the affinity and the job's CPU rate
+ * made after a lock was initialised. The process-wide part is cached
+ * for PTW32_SPIN_PAYS_REFRESH milliseconds. pthread_spin_lock(), and
+ * adaptive mutex and condition variable spinning, call this once per
+ * contended wait and yield or block at once if it is false.
+ */
+int
+ptw32_spin_pays (void)
+{
+#if defined(NEED_PROCESS_AFFINITY_MASK)
+
+  return PTW32_FALSE;
+
+#else
+
+  DWORD now = GetTickCount ();
+  LONG cpus = PTW32_ATOMIC_LOAD_RELAXED_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_spinCpus);
+
+  /*
+   * Racing refreshes only repeat the work.
+   */
+  if (0 == cpus
+      || now - (DWORD) PTW32_ATOMIC_LOAD_RELAXED_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_spinCpusTick)
+         >= PTW32_SPIN_PAYS_REFRESH)
+    {
+      cpus = (LONG) ptw32_effectiveprocessors ();
+      PTW32_ATOMIC_STORE_RELAXED_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_spinCpusTick,
+				       (PTW32_INTERLOCKED_LONG) now);
+      PTW32_ATOMIC_STORE_RELAXED_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_spinCpus,
+				       (PTW32_INTERLOCKED_LONG) cpus);
+    }
+
+  if (cpus < 2)
     {
-      result = EAGAIN;
+      return PTW32_FALSE;
     }
 
+#if defined(HAVE_CPU_AFFINITY)
+  {
+    ptw32_thread_t * sp = PTW32_SELF_THREAD ();
+
+    if (sp != NULL && 1 == CPU_COUNT (&sp->cpuset))
+      {
+	return PTW32_FALSE;
+      }
+  }
 #endif
 
-  return (result);
+  return PTW32_TRUE;
+
+#endif
 }
@@ -0,0 +1,190 @@
+/*
+ * ptw32_hazard.c
+ *
+ * Description:
+ * This translation unit implements hazard pointer primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Hazard pointers (Michael, 2004).
+ *
+ * Each thread that uses them has a record with PTHREAD_HAZARD_SLOTS_NP
+ * slots, pushed once onto ptw32_hazardRecords and never unlinked, so a
+ * scan can walk the records while threads come and go without taking
+ * any lock. A record stays with its ptw32_thread_t when that is reused;
+ * ptw32_threadDestroy clears the slots and scans what the thread left
+ * retired. Retired pointers are private to the owning thread, which
+ * scans when it holds twice as many as there are slots, so each thread
+ * keeps at most that many unreclaimed however long others stall.
+ */
+
+
+ptw32_hazard_record_t *
+ptw32_hazard_register (ptw32_thread_t * sp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns the hazard pointer record of thread 'sp',
+      *      making it and adding it to ptw32_hazardRecords the
+      *      first time.
+      *
+      * RESULTS
+      *              the record, or NULL if there is no memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_hazard_record_t * rec = sp->hazards;
+
+  if (rec == NULL)
+    {
+      ptw32_hazard_record_t * head;
+
+      /* A cache line of its own: the owner writes a slot per protect */
+      rec = (ptw32_hazard_record_t *) ptw32_object_alloc (sizeof (*rec), PTW32_CACHE_LINE_SIZE);
+
+      if (rec == NULL)
+	{
+	  return NULL;
+	}
+
+      do
+	{
+	  head = ptw32_hazardRecords;
+	  rec->next = head;
+	}
+      while (PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &ptw32_hazardRecords,
+						     (PTW32_INTERLOCKED_PVOID) rec,
+						     (PTW32_INTERLOCKED_PVOID) head)
+	     != (PTW32_INTERLOCKED_PVOID) head);
+
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_hazardRecordCount);
+
+      sp->hazards = rec;
+    }
+
+  return rec;
+}
+
+
+static int
+ptw32_hazard_compare (const void * a, const void * b)
+{
+  size_t x = (size_t) * (void * const *) a;
+  size_t y = (size_t) * (void * const *) b;
+
+  return (x < y) ? -1 : (x > y);
+}
+
+
+int
+ptw32_hazard_scan (ptw32_hazard_record_t * rec)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Reclaims the pointers retired in 'rec' that no slot
+      *      of any record holds. Called by the owner of 'rec'.
+      *
+      * RESULTS
+      *              0               the scan was made,
+      *              ENOMEM          no memory for the hazard list;
+      *                              nothing was reclaimed.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_hazard_record_t * r;
+  void ** hazards;
+  LONG nRecords;
+  LONG n;
+  int nHazards = 0;
+  int kept = 0;
+  int i;
+
+  if (rec->nRetired == 0)
+    {
+      return 0;
+    }
+
+  /*
+   * The interlocked read is also a full barrier: the caller's unlinks
+   * of the retired objects are visible before the slots are read.
+   * Records pushed after it can only protect objects still linked.
+   */
+  nRecords = (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_hazardRecordCount,
+							 (PTW32_INTERLOCKED_LONG) 0);
+
+  hazards = (void **) malloc ((size_t) nRecords * PTHREAD_HAZARD_SLOTS_NP * sizeof (void *));
+
+  if (hazards == NULL)
+    {
+      return ENOMEM;
+    }
+
+  for (r = ptw32_hazardRecords, n = 0; r != NULL && n < nRecords; r = r->next, n++)
+    {
+      for (i = 0; i < PTHREAD_HAZARD_SLOTS_NP; i++)
+	{
+	  void * p = r->slots[i];
+
+	  if (p != NULL)
+	    {
+	      hazards[nHazards++] = p;
+	    }
+	}
+    }
+
+  qsort (hazards, (size_t) nHazards, sizeof (void *), ptw32_hazard_compare);
+
+  for (i = 0; i < rec->nRetired; i++)
+    {
+      ptw32_hazard_retired_t * e = &rec->retired[i];
+
+      if (bsearch (&e->p, hazards, (size_t) nHazards, sizeof (void *), ptw32_hazard_compare) != NULL)
+	{
+	  rec->retired[kept++] = *e;
+	}
+      else
+	{
+	  e->reclaim (e->p);
+	}
+    }
+
+  rec->nRetired = kept;
+
+  free (hazards);
+
+  return 0;
+}
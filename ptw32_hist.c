@@ -0,0 +1,125 @@
+/*
+ * ptw32_hist.c
+ *
+ * Description:
+ * This translation unit implements the wait time histograms.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * ptw32_wait_end() adds every blocking wait of a POSIX thread to the
+ * thread's histogram of its kind. The buckets are log-linear, as
+ * HdrHistogram's with 2 bits of precision: within a power of 2 they
+ * are a quarter of it wide, so a percentile read from them is within
+ * 25% of the true wait. Only the thread writes its record, so adding
+ * needs no atomics; pthread_gethistograms_np adds the records up,
+ * reading them while they change.
+ */
+
+#define PTW32_HIST_MIN_SHIFT 8	/* Bucket 0 is below 1 << 8 ns */
+
+
+static int
+ptw32_hist_bucket (unsigned __int64 ns)
+     /*
+      * Returns the bucket of a wait of 'ns' nanoseconds, as
+      * PTHREAD_HIST_LOWER_NP in pthread.h describes.
+      */
+{
+  int shift = PTW32_HIST_MIN_SHIFT;
+  int bucket;
+
+  if (ns < ((unsigned __int64) 1 << PTW32_HIST_MIN_SHIFT))
+    {
+      return 0;
+    }
+
+  /* The power of 2 below ns */
+  while ((ns >> (shift + 1)) != 0)
+    {
+      shift++;
+    }
+
+  bucket = 1 + (shift - PTW32_HIST_MIN_SHIFT) * 4 + (int) ((ns >> (shift - 2)) & 3);
+
+  return PTW32_MIN (bucket, PTHREAD_HIST_BUCKETS_NP - 1);
+}
+
+
+void
+ptw32_hist_add (ptw32_thread_t * sp, int kind, int64_t ticks)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Counts a wait of 'ticks' performance counter ticks
+      *      in the PTHREAD_HIST_*_NP histogram 'kind' of the
+      *      calling thread 'sp', making its record and adding
+      *      it to ptw32_histRecords the first time. The wait
+      *      goes uncounted if there is no memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_hist_record_t * rec;
+
+  if ((rec = sp->hist) == NULL)
+    {
+      ptw32_hist_record_t * head;
+
+      if ((rec = (ptw32_hist_record_t *) ptw32_object_alloc (sizeof (*rec), 0)) == NULL)
+	{
+	  return;
+	}
+
+      do
+	{
+	  head = ptw32_histRecords;
+	  rec->next = head;
+	}
+      while (PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &ptw32_histRecords,
+						     (PTW32_INTERLOCKED_PVOID) rec,
+						     (PTW32_INTERLOCKED_PVOID) head)
+	     != (PTW32_INTERLOCKED_PVOID) head);
+
+      sp->hist = rec;
+    }
+
+  if (ticks < 0)
+    {
+      ticks = 0;
+    }
+
+  rec->count[kind][ptw32_hist_bucket (ptw32_ticks_to_ns (ticks))]++;
+}
@@ -0,0 +1,142 @@
+/*
+ * ptw32_implicit.c
+ *
+ * Description:
+ * This translation unit implements miscellaneous thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+HANDLE
+ptw32_implicit_handle (ptw32_thread_t * tp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns the Win32 handle of thread tp. pthread_self()
+      *      does not open one for an implicit thread, a Win32
+      *      thread that called into the library, so it is opened
+      *      here the first time something needs it. A thread
+      *      that loses the race to publish it closes its own.
+      *      Use PTW32_THREAD_HANDLE(tp) rather than calling this.
+      *
+      * RESULTS
+      *              the thread's handle, or NULL if it is not an
+      *              implicit thread or it cannot be opened.
+      *
+      * ------------------------------------------------------
+      */
+{
+  HANDLE threadH = NULL;
+
+  if (NULL != tp->threadH || !tp->implicit)
+    {
+      return tp->threadH;
+    }
+
+  if (tp->thread == GetCurrentThreadId ())
+    {
+      if (!DuplicateHandle (GetCurrentProcess (),
+			    GetCurrentThread (),
+			    GetCurrentProcess (),
+			    &threadH,
+			    0, FALSE, DUPLICATE_SAME_ACCESS))
+	{
+	  threadH = NULL;
+	}
+    }
+  else if (NULL != ptw32_openthread)
+    {
+      /*
+       * The thread is still attached, else tp would have been
+       * reclaimed and the caller's pthread_t rejected, so its
+       * ID still names it.
+       */
+      threadH = ptw32_openthread (THREAD_ALL_ACCESS, PTW32_FALSE, tp->thread);
+    }
+
+  (void) ptw32_libstat_handle (threadH, PTW32_LIBSTAT_THREAD_HANDLES);
+
+  if (NULL != threadH
+      && NULL != (HANDLE) PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &tp->threadH,
+								  (PTW32_INTERLOCKED_PVOID) threadH,
+								  (PTW32_INTERLOCKED_PVOID) NULL))
+    {
+      (void) ptw32_closehandle (threadH, PTW32_LIBSTAT_THREAD_HANDLES);
+    }
+
+  return tp->threadH;
+}
+
+#if defined(HAVE_CPU_AFFINITY)
+
+void
+ptw32_implicit_affinity (ptw32_thread_t * tp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Records the CPU affinity of implicit thread tp, which
+      *      pthread_self() leaves empty until it is first asked
+      *      for. A thread still on every CPU the process has in
+      *      its group was never restricted, so the whole process
+      *      set is recorded: threads it creates are then spread
+      *      over all processor groups. Nothing is recorded if the
+      *      affinity cannot be read.
+      *
+      * ------------------------------------------------------
+      */
+{
+  HANDLE threadH;
+  cpu_set_t threadCpuset;
+  cpu_set_t processCpuset;
+
+  threadH = (tp->thread == GetCurrentThreadId ()
+	     ? GetCurrentThread () : PTW32_THREAD_HANDLE (tp));
+
+  if (NULL != threadH
+      && 0 == ptw32_getthreadaffinity (threadH, &threadCpuset)
+      && 0 == ptw32_getprocessaffinity (&processCpuset))
+    {
+      size_t * thread = ((_sched_cpu_set_vector_*)&threadCpuset)->_cpuset;
+      size_t * process = ((_sched_cpu_set_vector_*)&processCpuset)->_cpuset;
+      int group;
+
+      for (group = 0; group < PTW32_CPU_SET_GROUPS && 0 == thread[group]; group++)
+	{
+	}
+      tp->cpuset = (group < PTW32_CPU_SET_GROUPS && thread[group] == process[group]
+		    ? processCpuset : threadCpuset);
+    }
+}
+
+#endif
@@ -0,0 +1,294 @@
+/*
+ * ptw32_largepage.c
+ *
+ * Description:
+ * This translation unit implements large page backed memory for slabs
+ * and thread structs.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * With PTHREAD_PARAM_LARGE_PAGES_NP set, the slabs ptw32_object_alloc()
+ * cuts synchronisation objects from and new ptw32_thread_t structs are
+ * cut in turn from regions of large pages, so that many objects share
+ * a TLB entry. A region is never freed: slabs and thread structs are
+ * kept for the life of the process anyway, and a thread struct freed
+ * by ptw32_threadReuseFree() goes on ptw32_largePageThreads for
+ * ptw32_new() to use again. Anything that can't come from a region
+ * comes from the heap as it would without the parameter.
+ */
+
+
+static int
+ptw32_largepage_privilege (void)
+     /*
+      * Enables SeLockMemoryPrivilege in the process token. An
+      * administrator has to have granted it to the account ("Lock
+      * pages in memory"). The routines are in advapi32.dll, which
+      * the library doesn't otherwise link.
+      */
+{
+  HINSTANCE h_advapi32 = LoadLibrary (TEXT ("advapi32.dll"));
+  BOOL (WINAPI *openprocesstoken) (HANDLE, DWORD, PHANDLE);
+  BOOL (WINAPI *lookupprivilegevalue) (LPCSTR, LPCSTR, PLUID);
+  BOOL (WINAPI *adjusttokenprivileges) (HANDLE, BOOL, PTOKEN_PRIVILEGES,
+                                        DWORD, PTOKEN_PRIVILEGES, PDWORD);
+  TOKEN_PRIVILEGES privileges;
+  HANDLE token;
+  int result = 0;
+
+  if (h_advapi32 == NULL)
+    {
+      return 0;
+    }
+
+  openprocesstoken = (BOOL (WINAPI *)(HANDLE, DWORD, PHANDLE))
+    GetProcAddress (h_advapi32, (LPCSTR) "OpenProcessToken");
+  lookupprivilegevalue = (BOOL (WINAPI *)(LPCSTR, LPCSTR, PLUID))
+    GetProcAddress (h_advapi32, (LPCSTR) "LookupPrivilegeValueA");
+  adjusttokenprivileges = (BOOL (WINAPI *)(HANDLE, BOOL, PTOKEN_PRIVILEGES,
+                                           DWORD, PTOKEN_PRIVILEGES, PDWORD))
+    GetProcAddress (h_advapi32, (LPCSTR) "AdjustTokenPrivileges");
+
+  if (openprocesstoken != NULL
+      && lookupprivilegevalue != NULL
+      && adjusttokenprivileges != NULL
+      && openprocesstoken (GetCurrentProcess (),
+                           TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+    {
+      privileges.PrivilegeCount = 1;
+      privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+      if (lookupprivilegevalue (NULL, "SeLockMemoryPrivilege",
+                                &privileges.Privileges[0].Luid)
+          && adjusttokenprivileges (token, FALSE, &privileges, 0, NULL, NULL))
+        {
+          /* It succeeds without the privilege, and says so here */
+          result = (GetLastError () == ERROR_SUCCESS);
+        }
+
+      CloseHandle (token);
+    }
+
+  (void) FreeLibrary (h_advapi32);
+
+  return result;
+}
+
+
+static int
+ptw32_largepage_check (void)
+     /*
+      * Returns non-zero if large pages can be had, finding out the
+      * first time. Called under ptw32_largepage_lock.
+      */
+{
+  if (ptw32_largePageState == PTW32_LARGEPAGE_UNKNOWN)
+    {
+      ptw32_largePageState = PTW32_LARGEPAGE_NONE;
+
+      /* Looked up when the process attaches */
+      if (ptw32_getlargepageminimum != NULL
+          && (ptw32_largePageSize = ptw32_getlargepageminimum ()) != 0
+          && ptw32_largepage_privilege ())
+        {
+          ptw32_largePageState = PTW32_LARGEPAGE_READY;
+        }
+    }
+
+  return (ptw32_largePageState == PTW32_LARGEPAGE_READY);
+}
+
+
+int
+ptw32_largepage_available (void)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns non-zero if new slabs and thread structs
+      *      come from large pages: PTHREAD_PARAM_LARGE_PAGES_NP
+      *      is set and the system gives the process them.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int result;
+
+  if (!ptw32_largePages)
+    {
+      return 0;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_largepage_lock, &node);
+  result = ptw32_largepage_check ();
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
+
+
+void *
+ptw32_largepage_alloc (size_t size)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Cuts a zeroed block of 'size' bytes, aligned on
+      *      PTW32_OBJECT_SLAB_ALIGN, from the current large page
+      *      region, starting another when it is used up. The
+      *      rest of a region too small for the block is wasted,
+      *      which is less than the block.
+      *
+      *      The system only finds large pages while it has
+      *      physically contiguous memory free. Once it can't,
+      *      it is unlikely to soon, so large pages aren't asked
+      *      for again.
+      *
+      * RESULTS
+      *              the block, or NULL if it can't come from large
+      *              pages, when the caller uses the heap instead.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  char * p = NULL;
+
+  if (!ptw32_largePages)
+    {
+      return NULL;
+    }
+
+  size = (size + PTW32_OBJECT_SLAB_ALIGN - 1) & ~((size_t) PTW32_OBJECT_SLAB_ALIGN - 1);
+
+  ptw32_mcs_lock_acquire (&ptw32_largepage_lock, &node);
+
+  if (ptw32_largepage_check ())
+    {
+      if ((size_t) (ptw32_largePageEnd - ptw32_largePageNext) < size)
+        {
+          SIZE_T bytes = (size + ptw32_largePageSize - 1) & ~(ptw32_largePageSize - 1);
+          char * region = (char *) VirtualAlloc (NULL, bytes,
+                                                 MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                                 PAGE_READWRITE);
+
+          if (region != NULL)
+            {
+              ptw32_largePageNext = region;
+              ptw32_largePageEnd = region + bytes;
+            }
+          else
+            {
+              ptw32_largePageState = PTW32_LARGEPAGE_NONE;
+            }
+        }
+
+      if ((size_t) (ptw32_largePageEnd - ptw32_largePageNext) >= size)
+        {
+          p = ptw32_largePageNext;
+          ptw32_largePageNext += size;
+        }
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return p;
+}
+
+
+ptw32_thread_t *
+ptw32_largepage_thread_alloc (void)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns a zeroed ptw32_thread_t from large pages:
+      *      one freed before, or a new one while large pages
+      *      are set and available.
+      *
+      * RESULTS
+      *              the struct, or NULL if ptw32_new() should
+      *              calloc() one.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  ptw32_thread_t * tp;
+
+  if (ptw32_largePageThreads != NULL)
+    {
+      ptw32_mcs_lock_acquire (&ptw32_largepage_lock, &node);
+      if ((tp = ptw32_largePageThreads) != NULL)
+        {
+          ptw32_largePageThreads = tp->prevReuse;
+        }
+      ptw32_mcs_lock_release (&node);
+
+      if (tp != NULL)
+        {
+          memset (tp, 0, sizeof (*tp));
+          tp->largePage = 1;
+          return tp;
+        }
+    }
+
+  if ((tp = (ptw32_thread_t *) ptw32_largepage_alloc (sizeof (*tp))) != NULL)
+    {
+      tp->largePage = 1;
+    }
+
+  return tp;
+}
+
+
+void
+ptw32_largepage_thread_free (ptw32_thread_t * tp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Keeps a ptw32_thread_t from large pages, that
+      *      ptw32_threadReuseFree() would otherwise free(), for
+      *      ptw32_largepage_thread_alloc() to hand out again.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&ptw32_largepage_lock, &node);
+  tp->prevReuse = ptw32_largePageThreads;
+  ptw32_largePageThreads = tp;
+  ptw32_mcs_lock_release (&node);
+}
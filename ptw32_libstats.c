@@ -0,0 +1,132 @@
+/*
+ * ptw32_libstats.c
+ *
+ * Description:
+ * This translation unit implements miscellaneous thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+HANDLE
+ptw32_libstat_handle (HANDLE h, int stat)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Counts 'h', just created or duplicated, as held in the
+      *      PTW32_LIBSTAT_* gauge 'stat', and returns it. NULL is
+      *      not counted.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (h != NULL)
+    {
+      PTW32_LIBSTAT_ADD (stat, 1);
+    }
+
+  return h;
+}
+
+
+BOOL
+ptw32_closehandle (HANDLE h, int stat)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Closes a handle counted by ptw32_libstat_handle().
+      *
+      * ------------------------------------------------------
+      */
+{
+  BOOL result = CloseHandle (h);
+
+  if (result)
+    {
+      PTW32_LIBSTAT_ADD (stat, -1);
+    }
+
+  return result;
+}
+
+
+/*
+ * The histogram of each PTW32_LIBSTAT_WAIT_* kind of wait.
+ */
+static const int ptw32_libstatHist[] =
+{
+  PTHREAD_HIST_MUTEX_NP,
+  PTHREAD_HIST_COND_NP,
+  PTHREAD_HIST_RWLOCK_READ_NP,
+  PTHREAD_HIST_SEM_NP,
+  PTHREAD_HIST_BARRIER_NP,
+  PTHREAD_HIST_JOIN_NP,
+  PTHREAD_HIST_OTHER_NP
+};
+
+
+void
+ptw32_libstat_wait (int stat)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Counts a wait about to enter the kernel in the
+      *      PTW32_LIBSTAT_WAIT_* counter 'stat', and records the
+      *      kind for ptw32_wait_end() to time it under. A rwlock
+      *      write wait gives PTW32_LIBSTAT_WAIT_RWLOCK_WRITE.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp;
+  int hist;
+
+  if (stat == PTW32_LIBSTAT_WAIT_RWLOCK_WRITE)
+    {
+      stat = PTW32_LIBSTAT_WAIT_RWLOCK;
+      hist = PTHREAD_HIST_RWLOCK_WRITE_NP;
+    }
+  else
+    {
+      hist = ptw32_libstatHist[stat - PTW32_LIBSTAT_WAIT_MUTEX];
+    }
+
+  PTW32_LIBSTAT_ADD (stat, 1);
+
+  if (ptw32_selfThreadKey != NULL
+      && NULL != (sp = PTW32_SELF_THREAD ()))
+    {
+      sp->waitStat = stat;
+      sp->waitHist = hist;
+    }
+}
@@ -0,0 +1,400 @@
+/*
+ * ptw32_lock_elide.c
+ *
+ * Description:
+ * This translation unit implements lock elision for mutexes and read/write locks.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * A PTHREAD_MUTEX_ELIDE_NP mutex, or PTHREAD_RWLOCK_ELIDE_NP read/write
+ * lock, first tries to run the critical section as an RTM transaction
+ * without taking the lock. The transaction reads the lock word, which
+ * puts it in the transaction's read set: a thread that takes the lock
+ * for real writes it, which aborts every transaction that has read it.
+ * Critical sections that don't touch the same data then run
+ * concurrently; the hardware rolls back those that conflict, and any
+ * that make a system call or touch too much data, and they take the
+ * lock as usual.
+ *
+ * The unlock tells an elided section from a locked one by the lock
+ * word: in an elided section it is still free, as any other value
+ * would have aborted it. _xtest guards against unlocking a free lock
+ * outside a transaction, where _xend would fault.
+ *
+ * Each abort makes the lock skip elision for the next 'penalty'
+ * acquisitions and doubles the penalty, up to PTW32_ELIDE_PENALTY_MAX;
+ * each committed section halves it again. A lock whose sections mostly
+ * abort so ends up eliding about once in PTW32_ELIDE_PENALTY_MAX
+ * acquisitions, and one whose sections mostly commit almost always.
+ * The state is only written outside transactions, and the counts are
+ * not kept atomically: lost updates only affect the tuning.
+ *
+ * Elided sections skip the lock statistics, the lock order checks and
+ * the priority protocol, and are never owned by a thread. Errorcheck,
+ * recursive, robust, fair and priority protocol mutexes aren't elided.
+ * Without RTM (checked at process attach) or without the intrinsics
+ * (MSVC 2012 or later, GCC 4.9 or later or clang, on x86 or x64) the
+ * locks are plain normal mutexes and PTHREAD_RWLOCK_PREFER_WRITER_NP
+ * read/write locks.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+#if (defined(_MSC_VER) && _MSC_VER >= 1700 && (defined(_M_IX86) || defined(_M_X64))) \
+    || ((defined(__i386__) || defined(__x86_64__)) \
+        && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#  define PTW32_HAVE_RTM
+#endif
+
+#if defined(PTW32_HAVE_RTM)
+
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#  define PTW32_RTM_TARGET
+#else
+#  include <cpuid.h>
+#  define PTW32_RTM_TARGET __attribute__ ((target ("rtm")))
+#endif
+
+/* _xabort code for a lock found held inside the transaction */
+#define PTW32_ELIDE_ABORT_BUSY 0xff
+
+int
+ptw32_lock_elide_probe (void)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Reports whether the processor supports RTM: CPUID
+      *      leaf 7, EBX bit 11. Processors that had TSX turned
+      *      off by a microcode update clear the bit.
+      *
+      * RESULTS
+      *              PTW32_TRUE      RTM is supported,
+      *              PTW32_FALSE     otherwise.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if defined(_MSC_VER)
+  int regs[4];
+
+  __cpuid (regs, 0);
+  if (regs[0] < 7)
+    {
+      return PTW32_FALSE;
+    }
+  __cpuidex (regs, 7, 0);
+
+  return (regs[1] & (1 << 11)) != 0;
+#else
+  unsigned int eax, ebx, ecx, edx;
+
+  if (__get_cpuid_max (0, NULL) < 7)
+    {
+      return PTW32_FALSE;
+    }
+  __cpuid_count (7, 0, eax, ebx, ecx, edx);
+
+  return (ebx & (1 << 11)) != 0;
+#endif
+}
+
+/*
+ * Returns PTW32_TRUE if the next acquisition mustn't be elided.
+ */
+static INLINE int
+ptw32_lock_elide_skip (ptw32_lock_elide_t * elide)
+{
+  if (elide->skip > 0)
+    {
+      elide->skip--;
+      return PTW32_TRUE;
+    }
+
+  return PTW32_FALSE;
+}
+
+/*
+ * Accounts for an aborted transaction. Returns PTW32_TRUE if it is
+ * worth retrying at once, i.e. the abort was transient, not the lock
+ * being held, and retries are left.
+ */
+static int
+ptw32_lock_elide_aborted (ptw32_lock_elide_t * elide, unsigned int status,
+			  int * retries)
+{
+  if ((status & _XABORT_RETRY) && !(status & _XABORT_EXPLICIT)
+      && --(*retries) > 0)
+    {
+      return PTW32_TRUE;
+    }
+
+  elide->skip = elide->penalty;
+  if (elide->penalty < PTW32_ELIDE_PENALTY_MAX)
+    {
+      elide->penalty *= 2;
+    }
+
+  return PTW32_FALSE;
+}
+
+/*
+ * Accounts for a committed transaction.
+ */
+static INLINE void
+ptw32_lock_elide_committed (ptw32_lock_elide_t * elide)
+{
+  if (elide->penalty > PTW32_ELIDE_PENALTY_MIN)
+    {
+      elide->penalty /= 2;
+    }
+}
+
+ptw32_lock_elide_t *
+ptw32_lock_elide_new (void)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Allocates the elision state of a lock, on its own
+      *      cache line.
+      *
+      * RESULTS
+      *              the state, or NULL if out of memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_lock_elide_t * elide;
+
+  elide = (ptw32_lock_elide_t *) ptw32_object_alloc (sizeof (*elide), PTW32_CACHE_LINE_SIZE);
+  if (elide != NULL)
+    {
+      elide->penalty = PTW32_ELIDE_PENALTY_MIN;
+    }
+
+  return elide;
+}
+
+PTW32_RTM_TARGET int
+ptw32_mutex_elide_lock (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Tries to enter an elided critical section of a
+      *      PTHREAD_MUTEX_ELIDE_NP mutex.
+      *
+      * RESULTS
+      *              PTW32_TRUE      the caller runs in a transaction
+      *                              that saw the mutex free,
+      *              PTW32_FALSE     the caller must lock the mutex.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_lock_elide_t * elide = mx->elide;
+  int retries = PTW32_ELIDE_RETRIES;
+  unsigned int status;
+
+  if (ptw32_lock_elide_skip (elide))
+    {
+      return PTW32_FALSE;
+    }
+
+  do
+    {
+      if ((status = _xbegin ()) == _XBEGIN_STARTED)
+	{
+	  if (mx->lock_idx == 0)
+	    {
+	      return PTW32_TRUE;
+	    }
+	  _xabort (PTW32_ELIDE_ABORT_BUSY);
+	}
+    }
+  while (ptw32_lock_elide_aborted (elide, status, &retries));
+
+  return PTW32_FALSE;
+}
+
+PTW32_RTM_TARGET int
+ptw32_mutex_elide_unlock (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Commits the elided critical section of a
+      *      PTHREAD_MUTEX_ELIDE_NP mutex, if the caller is in one.
+      *
+      * RESULTS
+      *              PTW32_TRUE      the section was elided and has
+      *                              committed,
+      *              PTW32_FALSE     the caller must unlock the mutex.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (mx->lock_idx == 0 && _xtest ())
+    {
+      _xend ();
+      ptw32_lock_elide_committed (mx->elide);
+      return PTW32_TRUE;
+    }
+
+  return PTW32_FALSE;
+}
+
+/*
+ * A policy read/write lock is free when nobody holds or waits for it
+ * and its state lock is free. Elided readers require the same as
+ * writers: with other readers active an unlock couldn't tell an elided
+ * reader from one of them.
+ */
+#define PTW32_RWLOCK_ELIDE_FREE(rwl) \
+  ((rwl)->stateLock == 0 && (rwl)->lockWord == 0 \
+   && (rwl)->nWaitingWriters == 0 && (rwl)->nWaitingReaders == 0)
+
+PTW32_RTM_TARGET int
+ptw32_rwlock_elide_lock (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Tries to enter an elided read or write critical
+      *      section of a PTHREAD_RWLOCK_ELIDE_NP read/write lock.
+      *
+      * RESULTS
+      *              PTW32_TRUE      the caller runs in a transaction
+      *                              that saw the lock free,
+      *              PTW32_FALSE     the caller must lock it.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_lock_elide_t * elide = rwl->elide;
+  int retries = PTW32_ELIDE_RETRIES;
+  unsigned int status;
+
+  if (ptw32_lock_elide_skip (elide))
+    {
+      return PTW32_FALSE;
+    }
+
+  do
+    {
+      if ((status = _xbegin ()) == _XBEGIN_STARTED)
+	{
+	  if (PTW32_RWLOCK_ELIDE_FREE (rwl))
+	    {
+	      return PTW32_TRUE;
+	    }
+	  _xabort (PTW32_ELIDE_ABORT_BUSY);
+	}
+    }
+  while (ptw32_lock_elide_aborted (elide, status, &retries));
+
+  return PTW32_FALSE;
+}
+
+PTW32_RTM_TARGET int
+ptw32_rwlock_elide_unlock (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Commits the elided critical section of a
+      *      PTHREAD_RWLOCK_ELIDE_NP read/write lock, if the caller
+      *      is in one.
+      *
+      * RESULTS
+      *              PTW32_TRUE      the section was elided and has
+      *                              committed,
+      *              PTW32_FALSE     the caller must unlock the lock.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (PTW32_RWLOCK_ELIDE_FREE (rwl) && _xtest ())
+    {
+      _xend ();
+      ptw32_lock_elide_committed (rwl->elide);
+      return PTW32_TRUE;
+    }
+
+  return PTW32_FALSE;
+}
+
+#else /* PTW32_HAVE_RTM */
+
+/*
+ * No intrinsics: elided locks are never created, so only the probe is
+ * ever called.
+ */
+int
+ptw32_lock_elide_probe (void)
+{
+  return PTW32_FALSE;
+}
+
+ptw32_lock_elide_t *
+ptw32_lock_elide_new (void)
+{
+  return NULL;
+}
+
+int
+ptw32_mutex_elide_lock (pthread_mutex_t mx)
+{
+  (void) mx;
+  return PTW32_FALSE;
+}
+
+int
+ptw32_mutex_elide_unlock (pthread_mutex_t mx)
+{
+  (void) mx;
+  return PTW32_FALSE;
+}
+
+int
+ptw32_rwlock_elide_lock (pthread_rwlock_t rwl)
+{
+  (void) rwl;
+  return PTW32_FALSE;
+}
+
+int
+ptw32_rwlock_elide_unlock (pthread_rwlock_t rwl)
+{
+  (void) rwl;
+  return PTW32_FALSE;
+}
+
+#endif /* PTW32_HAVE_RTM */
@@ -0,0 +1,160 @@
+/*
+ * ptw32_lockprof.c
+ *
+ * Description:
+ * This translation unit implements the sampling lock profiler.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * A PTW32_LOCKSTAT build can also sample contended acquisitions, set
+ * with pthread_lockprof_setsampling_np: every Nth one, or every one
+ * that waited at least a threshold, or both. The sample is taken where
+ * ptw32_lockstat.c records the wait, so uncontended paths don't change
+ * and the sampling costs nothing while it is off.
+ *
+ * A sample holds the waiter's stack, captured as it acquires. A thread
+ * can only capture its own stack, so a mutex owner that releases to
+ * blocked waiters while sampling is on captures its stack then, in
+ * the mutex's releasedBy record; the waiter takes it if the release
+ * came after it started waiting. Read-write locks and condition
+ * variables don't track an owner and have only the waiter's half.
+ *
+ * Samples go into ptw32_lockprofRing. A writer takes the next
+ * position with an interlocked increment, marks the slot busy and
+ * publishes the sample by setting the slot's seq to the position
+ * plus 1. Readers check seq before and after copying, so a slot
+ * overwritten meanwhile is skipped rather than returned torn. The
+ * ring keeps the last PTW32_LOCKPROF_SLOTS samples; older ones are
+ * lost to readers that fall behind.
+ */
+
+#include <string.h>
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_LOCKSTAT)
+
+static INLINE int
+ptw32_lockprof_capture (void ** stack)
+{
+  /* Skip ourselves and the lockstat hook */
+  return (int) RtlCaptureStackBackTrace (2, PTHREAD_LOCKPROF_DEPTH_NP, stack, NULL);
+}
+
+void
+ptw32_lockprof_released (ptw32_lockstat_t * stats)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Called by a mutex owner that is about to release
+      *      to blocked waiters while sampling is on. Keeps the
+      *      caller's stack for the next sample of the mutex.
+      * ------------------------------------------------------
+      */
+{
+  ptw32_lockprof_owner_t * rec = stats->releasedBy;
+
+  if (rec == NULL)
+    {
+      rec = (ptw32_lockprof_owner_t *) ptw32_object_alloc (sizeof (*rec), 0);
+
+      if (rec == NULL)
+	{
+	  return;
+	}
+
+      stats->releasedBy = rec;
+    }
+
+  rec->thread = pthread_self ();
+  rec->depth = ptw32_lockprof_capture (rec->stack);
+  rec->when = ptw32_lockstat_now ();
+}
+
+void
+ptw32_lockprof_sample (ptw32_lockstat_t * stats, int64_t start, int64_t waited)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Called after a contended acquisition that started
+      *      waiting at 'start' and waited 'waited' ticks. If it
+      *      is to be sampled, adds it to the ring. A mutex is
+      *      owned by the caller, so its releasedBy is stable.
+      * ------------------------------------------------------
+      */
+{
+  LONG every = ptw32_lockprofEvery;
+  int64_t threshold = ptw32_lockprofThreshold;
+  ptw32_lockprof_owner_t * owner = stats->releasedBy;
+  ptw32_lockprof_slot_t * slot;
+  pthread_lockprof_np_t * sample;
+  LONG pos;
+
+  if (!((threshold > 0 && waited >= threshold)
+	|| (every > 0
+	    && 0 == (unsigned long) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_lockprofCount)
+	            % (unsigned long) every)))
+    {
+      return;
+    }
+
+  pos = (LONG) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_lockprofNext) - 1;
+  slot = &ptw32_lockprofRing[(unsigned long) pos & (PTW32_LOCKPROF_SLOTS - 1)];
+  sample = &slot->sample;
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->seq, 0);
+
+  sample->kind = stats->kind;
+  sample->object = stats->object;
+  sample->waiter = pthread_self ();
+  sample->waitTime = (unsigned __int64) ((double) waited * 1.0e9
+					 / (double) ptw32_perf_frequency ());
+  sample->waiterDepth = ptw32_lockprof_capture (sample->waiterStack);
+
+  if (owner != NULL && owner->when >= start)
+    {
+      sample->owner = owner->thread;
+      sample->ownerDepth = owner->depth;
+      memcpy (sample->ownerStack, owner->stack, owner->depth * sizeof (void *));
+    }
+  else
+    {
+      sample->owner.p = NULL;
+      sample->owner.x = 0;
+      sample->ownerDepth = 0;
+    }
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->seq,
+					  (PTW32_INTERLOCKED_LONG) (pos + 1));
+}
+
+#endif /* PTW32_LOCKSTAT */
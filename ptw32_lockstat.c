@@ -0,0 +1,247 @@
+/*
+ * ptw32_lockstat.c
+ *
+ * Description:
+ * This translation unit implements lock contention statistics.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * A library built with PTW32_LOCKSTAT keeps contention statistics in
+ * every mutex, condition variable and read-write lock. The counters
+ * are only read from the clock on paths that are about to wait anyway:
+ * a mutex lock that has to spin or block, a read-write lock that
+ * can't be taken at once, and every condition variable wait. An
+ * uncontended lock and unlock costs one increment of the owner's
+ * acquisition count.
+ *
+ * The contended counters of all objects are guarded by the one
+ * ptw32_lockstat_lock, which also guards ptw32_lockstatList, where an
+ * object is linked the first time it is contended so that
+ * pthread_lockstat_walk_np can find it.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_LOCKSTAT)
+
+int64_t
+ptw32_lockstat_now (void)
+{
+  LARGE_INTEGER count;
+
+  (void) QueryPerformanceCounter(&count);
+
+  return (int64_t) count.QuadPart;
+}
+
+void
+ptw32_lockstat_init (ptw32_lockstat_t * stats, int kind, void * object)
+{
+  stats->kind = kind;
+  stats->object = object;
+}
+
+void
+ptw32_lockstat_destroy (ptw32_lockstat_t * stats)
+{
+  ptw32_mcs_local_node_t node;
+
+  if (stats->releasedBy != NULL)
+    {
+      ptw32_object_free (stats->releasedBy);
+      stats->releasedBy = NULL;
+    }
+
+  if (!stats->listed)
+    {
+      return;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_lockstat_lock, &node);
+
+  if (stats->prev != NULL)
+    {
+      stats->prev->next = stats->next;
+    }
+  else
+    {
+      ptw32_lockstatList = stats->next;
+    }
+
+  if (stats->next != NULL)
+    {
+      stats->next->prev = stats->prev;
+    }
+
+  stats->listed = 0;
+
+  ptw32_mcs_lock_release (&node);
+}
+
+/*
+ * Must be called with ptw32_lockstat_lock held.
+ */
+static INLINE void
+ptw32_lockstat_record (ptw32_lockstat_t * stats, int64_t waited)
+{
+  stats->contended++;
+  stats->waitTime += waited;
+
+  if (waited > stats->maxWaitTime)
+    {
+      stats->maxWaitTime = waited;
+    }
+
+  if (!stats->listed)
+    {
+      stats->prev = NULL;
+      stats->next = ptw32_lockstatList;
+
+      if (ptw32_lockstatList != NULL)
+	{
+	  ptw32_lockstatList->prev = stats;
+	}
+
+      ptw32_lockstatList = stats;
+      stats->listed = 1;
+    }
+}
+
+void
+ptw32_lockstat_waited (ptw32_lockstat_t * stats, int64_t start, int hold)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Records a contended acquisition that started
+      *      waiting at 'start'. If 'hold' is non-zero the
+      *      caller owns the lock exclusively and the time it
+      *      is held is recorded when ptw32_lockstat_released
+      *      is called.
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int64_t now = ptw32_lockstat_now ();
+
+  ptw32_mcs_lock_acquire (&ptw32_lockstat_lock, &node);
+  ptw32_lockstat_record (stats, now - start);
+  ptw32_mcs_lock_release (&node);
+
+  if (ptw32_lockprofOn)
+    {
+      ptw32_lockprof_sample (stats, start, now - start);
+    }
+
+  if (hold)
+    {
+      stats->holdStart = now;
+    }
+}
+
+void
+ptw32_lockstat_released (ptw32_lockstat_t * stats)
+{
+  /* Only the owner reaches here, so holdTime needs no lock */
+  stats->holdTime += ptw32_lockstat_now () - stats->holdStart;
+  stats->holdStart = 0;
+}
+
+void
+ptw32_lockstat_cond_waited (ptw32_lockstat_t * stats, int result, int64_t start)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Records a condition variable wait that started at
+      *      'start'. Every wait is counted; those that were
+      *      woken rather than timed out or failed are counted
+      *      as contended, with the time they waited.
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int64_t now = ptw32_lockstat_now ();
+
+  ptw32_mcs_lock_acquire (&ptw32_lockstat_lock, &node);
+
+  stats->acquisitions++;
+
+  if (0 == result)
+    {
+      ptw32_lockstat_record (stats, now - start);
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  if (0 == result && ptw32_lockprofOn)
+    {
+      ptw32_lockprof_sample (stats, start, now - start);
+    }
+}
+
+int
+ptw32_lockstat_rwlock (pthread_rwlock_t rwl,
+                       int (*lock) (pthread_rwlock_t, const struct timespec *, int),
+                       const struct timespec * abstime, int tryOnly)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Takes a read-write lock of one of the kinds with
+      *      their own lock functions, timing the wait if it
+      *      can't be taken at once.
+      * ------------------------------------------------------
+      */
+{
+  int result;
+  int64_t start;
+
+  if (0 == (result = lock (rwl, NULL, 1)) || tryOnly)
+    {
+      if (0 == result)
+	{
+	  (void) PTW32_INTERLOCKED_INCREMENT_SIZE ((PTW32_INTERLOCKED_SIZEPTR) &rwl->stats.acquisitions);
+	}
+      return result;
+    }
+
+  start = ptw32_lockstat_now ();
+
+  if (0 == (result = lock (rwl, abstime, 0)))
+    {
+      (void) PTW32_INTERLOCKED_INCREMENT_SIZE ((PTW32_INTERLOCKED_SIZEPTR) &rwl->stats.acquisitions);
+      ptw32_lockstat_waited (&rwl->stats, start, 0);
+    }
+
+  return result;
+}
+
+#endif /* PTW32_LOCKSTAT */
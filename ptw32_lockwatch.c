@@ -0,0 +1,276 @@
+/*
+ * ptw32_lockwatch.c
+ *
+ * Description:
+ * This translation unit implements lock order and hold time checking.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * A library built with PTW32_LOCKWATCH keeps, in each thread, the
+ * mutexes it holds and when it took them. When a thread locks a mutex
+ * B while holding A, the order A then B is recorded as an edge; if B
+ * then A was recorded before, by any thread, the two can deadlock and
+ * the first time that happens it is reported. The check is made before
+ * the lock is taken so that it is reported even if the thread then
+ * deadlocks. pthread_mutex_trylock can't deadlock, so its mutex counts
+ * as held but records no order. A mutex held for
+ * longer than the limit set with pthread_lockwatch_setholdlimit_np is
+ * reported as it is released.
+ *
+ * Edges are kept in the fixed, open addressed ptw32_lockwatchEdges
+ * table under ptw32_lockwatch_lock, keyed by the watchIds given to
+ * mutexes when they are initialised, so that a destroyed mutex's
+ * edges never match a new mutex at the same address. Once the table
+ * is full new orders are no longer recorded. Robust and non-robust
+ * mutexes of all kinds are watched; process shared ones are not.
+ *
+ * Reports are made with no library lock held but with the thread's
+ * mutexes still held, so the callback must not take those.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_LOCKWATCH)
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+#  define PTW32_LOCKWATCH_U64 "%I64u"
+#else
+#  define PTW32_LOCKWATCH_U64 "%llu"
+#endif
+
+static INLINE int64_t
+ptw32_lockwatch_now (void)
+{
+  LARGE_INTEGER count;
+
+  (void) QueryPerformanceCounter(&count);
+
+  return (int64_t) count.QuadPart;
+}
+
+/*
+ * Find the edge before -> after, adding it if 'add' and there is room.
+ * Called under ptw32_lockwatch_lock. Returns NULL if not found.
+ */
+static ptw32_lockwatch_edge_t *
+ptw32_lockwatch_edge (LONG before, LONG after, int add)
+{
+  unsigned int i = ((unsigned int) before * 2654435761u) ^ (unsigned int) after;
+  int probes;
+
+  for (probes = 0; probes < PTW32_LOCKWATCH_EDGES; probes++, i++)
+    {
+      ptw32_lockwatch_edge_t * e = &ptw32_lockwatchEdges[i & (PTW32_LOCKWATCH_EDGES - 1)];
+
+      if (e->before == before && e->after == after)
+        {
+          return e;
+        }
+
+      if (0 == e->before)
+        {
+          if (add)
+            {
+              e->before = before;
+              e->after = after;
+              e->reported = 0;
+              return e;
+            }
+          break;
+        }
+    }
+
+  return NULL;
+}
+
+static void
+ptw32_lockwatch_report (int event, pthread_mutex_t held,
+                        pthread_mutex_t acquired, int64_t ticks)
+{
+  void (PTW32_CDECL *callback) (const pthread_lockwatch_np_t *, void *);
+  void * arg;
+  pthread_lockwatch_np_t report;
+  ptw32_mcs_local_node_t node;
+
+  report.event = event;
+  report.thread = pthread_self ();
+  report.held = held;
+  report.acquired = acquired;
+  report.holdTime = ptw32_ticks_to_ns (ticks);
+
+  ptw32_mcs_lock_acquire (&ptw32_lockwatch_lock, &node);
+  callback = ptw32_lockwatchCallback;
+  arg = ptw32_lockwatchArg;
+  ptw32_mcs_lock_release (&node);
+
+  if (NULL != callback)
+    {
+      callback (&report, arg);
+    }
+  else if (PTHREAD_LOCKWATCH_ORDER_NP == event)
+    {
+      fprintf (stderr, "lockwatch: thread " PTW32_LOCKWATCH_U64
+                       " took mutex %p while holding %p, the reverse of an earlier order\n",
+               pthread_getunique_np (report.thread), (void *) acquired, (void *) held);
+    }
+  else
+    {
+      fprintf (stderr, "lockwatch: thread " PTW32_LOCKWATCH_U64
+                       " held mutex %p for " PTW32_LOCKWATCH_U64 "ns\n",
+               pthread_getunique_np (report.thread), (void *) held, report.holdTime);
+    }
+}
+
+void
+ptw32_lockwatch_order (pthread_mutex_t mx)
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+  pthread_mutex_t inverted[PTW32_LOCKWATCH_DEPTH];
+  int nInverted = 0;
+  ptw32_mcs_local_node_t node;
+  int i;
+
+  if (NULL == sp || 0 == sp->nHeld)
+    {
+      return;
+    }
+
+  /*
+   * Taking a mutex the thread already holds is a recursive lock or
+   * EDEADLK, not an order.
+   */
+  for (i = 0; i < sp->nHeld; i++)
+    {
+      if (sp->held[i].mx == mx)
+        {
+          return;
+        }
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_lockwatch_lock, &node);
+
+  for (i = 0; i < sp->nHeld; i++)
+    {
+      ptw32_lockwatch_edge_t * e = ptw32_lockwatch_edge (mx->watchId, sp->held[i].id, 0);
+
+      if (NULL != e && !e->reported)
+        {
+          e->reported = 1;
+          inverted[nInverted++] = sp->held[i].mx;
+        }
+
+      (void) ptw32_lockwatch_edge (sp->held[i].id, mx->watchId, 1);
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  for (i = 0; i < nInverted; i++)
+    {
+      ptw32_lockwatch_report (PTHREAD_LOCKWATCH_ORDER_NP, inverted[i], mx, 0);
+    }
+}
+
+void
+ptw32_lockwatch_acquired (pthread_mutex_t mx)
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+  int kind = (mx->kind < 0) ? -mx->kind - 1 : mx->kind;
+
+  if (NULL == sp
+      || (PTHREAD_MUTEX_RECURSIVE == kind && mx->recursive_count > 1))
+    {
+      return;
+    }
+
+  if (sp->nHeld < PTW32_LOCKWATCH_DEPTH)
+    {
+      ptw32_lockwatch_held_t * h = &sp->held[sp->nHeld++];
+
+      h->mx = mx;
+      h->id = mx->watchId;
+      h->acquired = ptw32_lockwatch_now ();
+    }
+  else
+    {
+      sp->nUntracked++;
+    }
+}
+
+void
+ptw32_lockwatch_release (pthread_mutex_t mx)
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+  int64_t held;
+  int i;
+
+  if (NULL == sp)
+    {
+      return;
+    }
+
+  /*
+   * Mutexes are mostly released in the reverse order, so search from
+   * the most recent. A normal mutex may be unlocked by a thread that
+   * doesn't hold it; then nothing is found and its holder keeps it.
+   */
+  for (i = sp->nHeld - 1; i >= 0; i--)
+    {
+      if (sp->held[i].mx == mx)
+        {
+          break;
+        }
+    }
+
+  if (i < 0)
+    {
+      if (sp->nUntracked > 0)
+        {
+          sp->nUntracked--;
+        }
+      return;
+    }
+
+  held = ptw32_lockwatch_now () - sp->held[i].acquired;
+
+  for (sp->nHeld--; i < sp->nHeld; i++)
+    {
+      sp->held[i] = sp->held[i + 1];
+    }
+
+  if (0 < ptw32_lockwatchLimit && held > ptw32_lockwatchLimit)
+    {
+      ptw32_lockwatch_report (PTHREAD_LOCKWATCH_HOLD_NP, mx, NULL, held);
+    }
+}
+
+#endif /* PTW32_LOCKWATCH */
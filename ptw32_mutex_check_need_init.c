@@ -38,9 +38,11 @@
 #include "implement.h"
 
 static struct pthread_mutexattr_t_ ptw32_recursive_mutexattr_s =
-  {PTHREAD_PROCESS_PRIVATE, PTHREAD_MUTEX_RECURSIVE, PTHREAD_MUTEX_STALLED};
+  {PTHREAD_PROCESS_PRIVATE, PTHREAD_MUTEX_RECURSIVE, PTHREAD_MUTEX_STALLED, PTHREAD_MUTEX_SPIN_DEFAULT,
+   PTHREAD_MUTEX_BARGING_NP, PTHREAD_PRIO_NONE, PTW32_PRIO_CEILING_DEFAULT};
 static struct pthread_mutexattr_t_ ptw32_errorcheck_mutexattr_s =
-  {PTHREAD_PROCESS_PRIVATE, PTHREAD_MUTEX_ERRORCHECK, PTHREAD_MUTEX_STALLED};
+  {PTHREAD_PROCESS_PRIVATE, PTHREAD_MUTEX_ERRORCHECK, PTHREAD_MUTEX_STALLED, PTHREAD_MUTEX_SPIN_DEFAULT,
+   PTHREAD_MUTEX_BARGING_NP, PTHREAD_PRIO_NONE, PTW32_PRIO_CEILING_DEFAULT};
 static pthread_mutexattr_t ptw32_recursive_mutexattr = &ptw32_recursive_mutexattr_s;
 static pthread_mutexattr_t ptw32_errorcheck_mutexattr = &ptw32_errorcheck_mutexattr_s;
 
@@ -48,45 +50,58 @@ static pthread_mutexattr_t ptw32_errorcheck_mutexattr = &ptw32_errorcheck_mutexa
 INLINE int
 ptw32_mutex_check_need_init (pthread_mutex_t * mutex)
 {
-  register int result = 0;
-  register pthread_mutex_t mtx;
-  ptw32_mcs_local_node_t node;
-
-  ptw32_mcs_lock_acquire(&ptw32_mutex_test_init_lock, &node);
-
-  /*
-   * We got here possibly under race
-   * conditions. Check again inside the critical section
-   * and only initialise if the mutex is valid (not been destroyed).
-   * If a static mutex has been destroyed, the application can
-   * re-initialise it only by calling pthread_mutex_init()
-   * explicitly.
-   */
-  mtx = *mutex;
+  int result;
+  pthread_mutex_t mtx = *mutex;
+  pthread_mutex_t mx;
+  const pthread_mutexattr_t * attr;
 
   if (mtx == PTHREAD_MUTEX_INITIALIZER)
     {
-      result = pthread_mutex_init (mutex, NULL);
+      attr = NULL;
     }
   else if (mtx == PTHREAD_RECURSIVE_MUTEX_INITIALIZER)
     {
-      result = pthread_mutex_init (mutex, &ptw32_recursive_mutexattr);
+      attr = &ptw32_recursive_mutexattr;
     }
   else if (mtx == PTHREAD_ERRORCHECK_MUTEX_INITIALIZER)
     {
-      result = pthread_mutex_init (mutex, &ptw32_errorcheck_mutexattr);
+      attr = &ptw32_errorcheck_mutexattr;
     }
-  else if (mtx == NULL)
+  else
     {
       /*
-       * The mutex has been destroyed while we were waiting to
-       * initialise it, so the operation that caused the
-       * auto-initialisation should fail.
+       * Another thread initialised the mutex first, or it has been
+       * destroyed, in which case the operation that caused the
+       * auto-initialisation should fail. If a static mutex has been
+       * destroyed, the application can re-initialise it only by
+       * calling pthread_mutex_init() explicitly.
        */
-      result = EINVAL;
+      return (mtx == NULL) ? EINVAL : 0;
+    }
+
+  /*
+   * Build a mutex of our own and publish it only if the static one is
+   * still untouched. Threads racing to initialise the same mutex each
+   * build one; the first to publish wins and the others throw theirs
+   * away, so no global lock is needed.
+   */
+  if ((result = pthread_mutex_init (&mx, attr)) != 0)
+    {
+      return result;
     }
 
-  ptw32_mcs_lock_release(&node);
+  if (PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) mutex,
+						(PTW32_INTERLOCKED_PVOID) mx,
+						(PTW32_INTERLOCKED_PVOID) mtx)
+      != (PTW32_INTERLOCKED_PVOID) mtx)
+    {
+      (void) pthread_mutex_destroy (&mx);
+
+      if (*mutex == NULL)
+	{
+	  result = EINVAL;
+	}
+    }
 
-  return (result);
+  return result;
 }
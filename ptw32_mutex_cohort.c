@@ -0,0 +1,255 @@
+/*
+ * ptw32_mutex_cohort.c
+ *
+ * Description:
+ * This translation unit implements mutex primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * A cohort mutex (PTHREAD_MUTEX_NUMA_COHORT_NP) keeps its ownership on
+ * one NUMA node while threads there want it, so that the mutex and the
+ * data it guards don't cross the interconnect at every handoff. See
+ * D. Dice, V. J. Marathe and N. Shavit. Lock Cohorting: A General
+ * Technique for Designing NUMA Locks. PPoPP 2012.
+ *
+ * Threads that find the mutex locked queue on the MCS lock of their
+ * node (c->nodes[n].lock), and the thread at the head of each node
+ * queue then queues on the global MCS lock (c->lock) and, once it has
+ * that, takes lock_idx. An unlock by a thread that queued hands the
+ * mutex to the next thread of its node, keeping both MCS locks and
+ * lock_idx, unless nobody there is waiting or the node has had
+ * PTW32_MUTEX_COHORT_HANDOFFS handoffs in a row; then it frees lock_idx
+ * and both MCS locks, and the heads of the other nodes get their turn.
+ *
+ * MCS queue entries live on the waiter's stack, so each head moves its
+ * entries into the mutex (ptw32_mcs_node_transfer) before returning to
+ * its caller. The entry of a node queue's head is c->nodes[n].owner and
+ * that of the global queue's head is c->owner.
+ *
+ * lock_idx is still what decides who owns the mutex, so trylock, timed
+ * locks and the PTW32_INLINE_LOCKS fast path take a free mutex without
+ * queueing, as does a lock when no thread is queued. Such owners have
+ * c->held -1 and unlock as usual. A thread that queued locks lock_idx
+ * with PTW32_MUTEX_COHORT_HELD (or -1), never 1, so that the inline fast
+ * path can't unlock it behind the queues' back.
+ */
+
+
+static int
+ptw32_mutex_cohort_node (ptw32_mutex_cohort_t * c)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns the NUMA node of the CPU the calling thread
+      *      runs on, or 0 if it can't be told.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_processor_number_t pn;
+  int cpu;
+  int node;
+
+  if (c->nNodes > 1 && ptw32_getcurrentprocessornumberex != NULL)
+    {
+      ptw32_getcurrentprocessornumberex (&pn);
+      cpu = (int) pn.Group * (int) PTW32_CPU_GROUP_SIZE + (int) pn.Number;
+
+      if (cpu < (int) CPU_SETSIZE
+	  && (node = ptw32_topology->node[cpu]) >= 0 && node < c->nNodes)
+	{
+	  return node;
+	}
+    }
+
+  return 0;
+}
+
+
+ptw32_mutex_cohort_t *
+ptw32_mutex_cohort_new (int nNodes)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Allocates the queues of a cohort mutex for nNodes
+      *      NUMA nodes, freed with ptw32_object_free().
+      *
+      * RESULTS
+      *              the queues, or NULL if there is no memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  size_t offset = (sizeof (ptw32_mutex_cohort_t) + PTW32_CACHE_LINE_SIZE - 1)
+                  & ~((size_t) PTW32_CACHE_LINE_SIZE - 1);
+  ptw32_mutex_cohort_t * c;
+
+  c = (ptw32_mutex_cohort_t *) ptw32_object_alloc (offset + nNodes * sizeof (ptw32_mutex_cohort_node_t),
+						   PTW32_CACHE_LINE_SIZE);
+  if (c != NULL)
+    {
+      c->held = -1;
+      c->nNodes = nNodes;
+      c->nodes = (ptw32_mutex_cohort_node_t *) ((char *) c + offset);
+    }
+
+  return c;
+}
+
+
+int
+ptw32_mutex_cohort_acquire (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Locks a cohort mutex that the caller doesn't own,
+      *      queueing if it is locked or other threads are queued.
+      *
+      * RESULTS
+      *              0               the mutex was locked,
+      *              EINVAL          waiting failed.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mutex_cohort_t * c = mx->cohort;
+  ptw32_mutex_cohort_node_t * local;
+  ptw32_mcs_local_node_t node;
+  int n;
+
+  if ((PTW32_INTERLOCKED_SIZE) 0 == PTW32_ATOMIC_LOAD_ACQ_SIZE ((PTW32_INTERLOCKED_SIZEPTR) &c->lock)
+      && (PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+									 (PTW32_INTERLOCKED_LONG) 1,
+									 (PTW32_INTERLOCKED_LONG) 0) == 0)
+    {
+      return 0;
+    }
+
+  n = ptw32_mutex_cohort_node (c);
+  local = &c->nodes[n];
+
+  ptw32_mcs_lock_acquire (&local->lock, &node);
+  ptw32_mcs_node_transfer (&local->owner, &node);
+
+  if (local->passed)
+    {
+      /* Handed over by the previous owner, from this node */
+      local->passed = PTW32_FALSE;
+    }
+  else
+    {
+      ptw32_mcs_lock_acquire (&c->lock, &node);
+      ptw32_mcs_node_transfer (&c->owner, &node);
+
+      if ((PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+									   (PTW32_INTERLOCKED_LONG) PTW32_MUTEX_COHORT_HELD,
+									   (PTW32_INTERLOCKED_LONG) 0) != 0)
+	{
+	  /* Taken without queueing */
+	  while ((PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+									  (PTW32_INTERLOCKED_LONG) -1) != 0)
+	    {
+	      if (0 != ptw32_mutex_wait (mx, CLOCK_REALTIME, NULL))
+		{
+		  local->handoffs = 0;
+		  ptw32_mcs_lock_release (&c->owner);
+		  ptw32_mcs_lock_release (&local->owner);
+		  return EINVAL;
+		}
+	    }
+	}
+    }
+
+  c->held = n;
+
+  return 0;
+}
+
+
+int
+ptw32_mutex_cohort_release (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Unlocks a cohort mutex, handing it to the next thread
+      *      queued on the owner's node if there is one and the
+      *      node hasn't used up its handoffs.
+      *
+      * RESULTS
+      *              0               the mutex was unlocked,
+      *              EINVAL          waking a waiter failed.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mutex_cohort_t * c = mx->cohort;
+  ptw32_mutex_cohort_node_t * local = NULL;
+  int result = 0;
+
+  if (c->held >= 0)
+    {
+      local = &c->nodes[c->held];
+      c->held = -1;
+
+      /* A successor may not have linked itself to us yet */
+      if (local->handoffs < PTW32_MUTEX_COHORT_HANDOFFS
+	  && ((PTW32_INTERLOCKED_SIZE) 0 != PTW32_ATOMIC_LOAD_ACQ_SIZE ((PTW32_INTERLOCKED_SIZEPTR) &local->owner.next)
+	      || (PTW32_INTERLOCKED_SIZE) &local->owner
+	           != PTW32_ATOMIC_LOAD_ACQ_SIZE ((PTW32_INTERLOCKED_SIZEPTR) &local->lock)))
+	{
+	  local->handoffs++;
+	  local->passed = PTW32_TRUE;
+	  ptw32_mcs_lock_release (&local->owner);
+	  return 0;
+	}
+
+      local->handoffs = 0;
+    }
+
+  if ((LONG) PTW32_ATOMIC_EXCHANGE_REL_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+					     (PTW32_INTERLOCKED_LONG) 0) < 0
+      && ptw32_mutex_wake (mx) != 0)
+    {
+      result = EINVAL;
+    }
+
+  if (local != NULL)
+    {
+      ptw32_mcs_lock_release (&c->owner);
+      ptw32_mcs_lock_release (&local->owner);
+    }
+
+  return result;
+}
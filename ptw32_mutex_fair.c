@@ -0,0 +1,414 @@
+/*
+ * ptw32_mutex_fair.c
+ *
+ * Description:
+ * This translation unit implements mutex primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * A fair mutex queues its waiters in f->head..f->tail under f->lock,
+ * and uses lock_idx as other mutexes do, plus one value:
+ *
+ *    0: free, nobody queued; taken with a compare 0 -> 1 anywhere.
+ *    1: locked, nobody queued; released with a compare 1 -> 0 anywhere.
+ *   -1: locked, threads may be queued. Only changed under f->lock.
+ *   -2: free, threads queued (PTW32_MUTEX_FREE_QUEUED). Only changed
+ *       under f->lock, so the lock-free paths (trylock, spinning, the
+ *       PTW32_INLINE_LOCKS fast path) can't take it.
+ *
+ * An unlock that finds -1 dequeues the longest waiter and either hands
+ * it the mutex (lock_idx stays locked, the waiter's state becomes
+ * GRANTED) or frees the mutex and wakes the waiter to retry (RETRY),
+ * in which case the waiter requeues at the front if it loses again.
+ *
+ * A PTHREAD_MUTEX_PRIORITY_NP mutex queues its waiters by their
+ * priority when they queue, highest first and in arrival order within
+ * a priority, and always hands the mutex over.
+ */
+
+
+static int
+ptw32_mutex_fair_take (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Takes the mutex if it is free, otherwise makes sure
+      *      that lock_idx says there are waiters. Called with
+      *      the queue lock held.
+      *
+      * RESULTS
+      *              PTW32_TRUE      the mutex was taken,
+      *              PTW32_FALSE     the mutex is locked (-1).
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mutex_fair_t * f = mx->fair;
+  LONG idx;
+
+  for (;;)
+    {
+      idx = (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+							    (PTW32_INTERLOCKED_LONG) 1,
+							    (PTW32_INTERLOCKED_LONG) 0);
+      if (idx == 0)
+	{
+	  return PTW32_TRUE;
+	}
+
+      if (idx == PTW32_MUTEX_FREE_QUEUED)
+	{
+	  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+						  (PTW32_INTERLOCKED_LONG) ((f->head != NULL) ? -1 : 1));
+	  return PTW32_TRUE;
+	}
+
+      if (idx < 0
+	  || (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+							     (PTW32_INTERLOCKED_LONG) -1,
+							     (PTW32_INTERLOCKED_LONG) 1) == 1)
+	{
+	  return PTW32_FALSE;
+	}
+      /* Unlocked (1 -> 0) meanwhile */
+    }
+}
+
+
+static void
+ptw32_mutex_fair_dequeue (pthread_mutex_t mx, ptw32_mutex_waiter_t * w)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Removes a waiter that gave up from the queue. If it
+      *      was the last one, lock_idx no longer needs to say
+      *      there are waiters. Called with the queue lock held.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mutex_fair_t * f = mx->fair;
+  ptw32_mutex_waiter_t * prev = NULL;
+  ptw32_mutex_waiter_t * p;
+
+  for (p = f->head; p != w; p = p->next)
+    {
+      prev = p;
+    }
+
+  if (prev == NULL)
+    {
+      f->head = w->next;
+    }
+  else
+    {
+      prev->next = w->next;
+    }
+
+  if (f->tail == w)
+    {
+      f->tail = prev;
+    }
+
+  if (f->head == NULL)
+    {
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+					      (PTW32_INTERLOCKED_LONG)
+					      ((mx->lock_idx == PTW32_MUTEX_FREE_QUEUED) ? 0 : 1));
+    }
+}
+
+
+static void
+ptw32_mutex_fair_enqueue_priority (ptw32_mutex_fair_t * f, ptw32_mutex_waiter_t * w)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Queues a waiter on a PTHREAD_MUTEX_PRIORITY_NP mutex
+      *      behind the waiters of at least its priority. Called
+      *      with the queue lock held.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mutex_waiter_t * prev = f->tail;
+  ptw32_mutex_waiter_t * p;
+
+  if (prev != NULL && prev->priority < w->priority)
+    {
+      prev = NULL;
+      for (p = f->head; p->priority >= w->priority; p = p->next)
+	{
+	  prev = p;
+	}
+    }
+
+  if (prev == NULL)
+    {
+      w->next = f->head;
+      f->head = w;
+    }
+  else
+    {
+      w->next = prev->next;
+      prev->next = w;
+    }
+
+  if (w->next == NULL)
+    {
+      f->tail = w;
+    }
+}
+
+
+int
+ptw32_mutex_fair_acquire (pthread_mutex_t mx, clockid_t clock,
+			  const struct timespec * abstime)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Acquires a contended fair mutex, queueing behind
+      *      the threads already waiting for it. A thread woken
+      *      to retry that loses the mutex again goes back to
+      *      the front of the queue, keeping its original place
+      *      and waiting time.
+      *
+      *      If 'abstime' is a NULL pointer then this function
+      *      will block until the mutex is acquired.
+      *
+      *      This routine is not a cancellation point.
+      *
+      * RESULTS
+      *              0               the mutex is locked,
+      *              ETIMEDOUT       abstime passed,
+      *              EINVAL          the wait failed.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mutex_fair_t * f = mx->fair;
+  ptw32_mutex_waiter_t w;
+  ptw32_mcs_local_node_t node;
+  LONG queued = PTW32_MUTEX_WAITER_QUEUED;
+  LARGE_INTEGER count;
+  ptw32_mutex_prio_waiter_t prioWaiter;
+  ptw32_waitgraph_record_t * edge;
+  ptw32_thread_t * self;
+  int result = 0;
+
+  w.state = PTW32_MUTEX_WAITER_RETRY;
+  w.start = 0;
+  w.priority = 0;
+
+  if (f->fairness == PTHREAD_MUTEX_PRIORITY_NP
+      && (self = (ptw32_thread_t *) pthread_self ().p) != NULL)
+    {
+      w.priority = PTW32_WAIT_PRIORITY (self);
+    }
+
+  for (;;)
+    {
+      ptw32_mcs_lock_acquire (&f->lock, &node);
+
+      if (w.state == PTW32_MUTEX_WAITER_QUEUED)
+	{
+	  /* The wait ended without a wakeup */
+	  ptw32_mutex_fair_dequeue (mx, &w);
+	  break;
+	}
+
+      if (w.state == PTW32_MUTEX_WAITER_GRANTED
+	  || ptw32_mutex_fair_take (mx))
+	{
+	  result = 0;
+	  break;
+	}
+
+      if (result != 0)
+	{
+	  /* Woken to retry after abstime: the owner will wake the queue */
+	  break;
+	}
+
+      w.next = NULL;
+      w.state = PTW32_MUTEX_WAITER_QUEUED;
+
+      if (f->fairness == PTHREAD_MUTEX_PRIORITY_NP)
+	{
+	  ptw32_mutex_fair_enqueue_priority (f, &w);
+	}
+      else if (w.start != 0)
+	{
+	  w.next = f->head;
+	  f->head = &w;
+	  if (f->tail == NULL)
+	    {
+	      f->tail = &w;
+	    }
+	}
+      else
+	{
+	  (void) QueryPerformanceCounter (&count);
+	  w.start = (int64_t) count.QuadPart;
+
+	  if (f->tail == NULL)
+	    {
+	      f->head = &w;
+	    }
+	  else
+	    {
+	      f->tail->next = &w;
+	    }
+	  f->tail = &w;
+	}
+
+      ptw32_mcs_lock_release (&node);
+
+      if (mx->prio != NULL)
+	{
+	  ptw32_mutex_prio_block (mx, &prioWaiter);
+	}
+
+      edge = ptw32_waitgraph_block (mx);
+
+      while (w.state == PTW32_MUTEX_WAITER_QUEUED)
+	{
+	  PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_MUTEX);
+	  if (!ptw32_waitonaddress_abstime ((volatile VOID *) &w.state,
+					    (PVOID) &queued, sizeof (queued),
+					    clock, abstime))
+	    {
+	      result = (GetLastError () == ERROR_TIMEOUT) ? ETIMEDOUT : EINVAL;
+	      break;
+	    }
+	}
+
+      ptw32_waitgraph_unblock (edge);
+
+      if (mx->prio != NULL)
+	{
+	  ptw32_mutex_prio_unblock (mx, &prioWaiter);
+	}
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
+
+
+int
+ptw32_mutex_fair_release (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Releases a fair mutex held by the caller. If threads
+      *      are queued, the waiter at the head of the queue is
+      *      handed the mutex if the mutex is PTHREAD_MUTEX_FAIR_NP
+      *      or PTHREAD_MUTEX_PRIORITY_NP or the waiter has waited
+      *      PTW32_MUTEX_STARVATION_MS or more, and otherwise woken
+      *      to compete for it.
+      *
+      * RESULTS
+      *              0               always.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mutex_fair_t * f = mx->fair;
+  ptw32_mutex_waiter_t * w;
+  ptw32_mcs_local_node_t node;
+  LARGE_INTEGER count;
+  volatile LONG * state;
+  int handoff;
+
+  if ((LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+						      (PTW32_INTERLOCKED_LONG) 0,
+						      (PTW32_INTERLOCKED_LONG) 1) == 1)
+    {
+      return 0;
+    }
+
+  ptw32_mcs_lock_acquire (&f->lock, &node);
+
+  if ((w = f->head) == NULL)
+    {
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+					      (PTW32_INTERLOCKED_LONG) 0);
+      ptw32_mcs_lock_release (&node);
+      return 0;
+    }
+
+  if ((f->head = w->next) == NULL)
+    {
+      f->tail = NULL;
+    }
+
+  handoff = (f->fairness != PTHREAD_MUTEX_EVENTUALLY_FAIR_NP);
+
+  if (!handoff)
+    {
+      (void) QueryPerformanceCounter (&count);
+      handoff = ((int64_t) count.QuadPart - w->start
+		 >= ptw32_perf_frequency () / 1000 * PTW32_MUTEX_STARVATION_MS);
+    }
+
+  if (handoff)
+    {
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+					      (PTW32_INTERLOCKED_LONG) ((f->head != NULL) ? -1 : 1));
+      w->state = PTW32_MUTEX_WAITER_GRANTED;
+    }
+  else
+    {
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+					      (PTW32_INTERLOCKED_LONG)
+					      ((f->head != NULL) ? PTW32_MUTEX_FREE_QUEUED : 0));
+      w->state = PTW32_MUTEX_WAITER_RETRY;
+    }
+
+  /*
+   * The waiter may return as soon as its state changes, so only the
+   * address is used from here on; waking an address that is no
+   * longer waited on is harmless.
+   */
+  state = &w->state;
+
+  ptw32_mcs_lock_release (&node);
+
+  ptw32_wakebyaddresssingle ((PVOID) state);
+
+  return 0;
+}
@@ -0,0 +1,266 @@
+/*
+ * ptw32_mutex_init.c
+ *
+ * Description:
+ * This translation unit implements mutual exclusion (mutex) primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+ptw32_mutex_init (pthread_mutex_t * mutex, const pthread_mutexattr_t * attr,
+		  void * storage, size_t size)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Initialises a mutex as pthread_mutex_init() does, in
+      *      'storage' if that is given and at least 'size' bytes
+      *      are enough, otherwise on the heap.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result = 0;
+  int spin = ptw32_mutex_default_spin;
+  ptw32_mutex_fair_t * fair = NULL;
+  ptw32_mutex_cohort_t * cohort = NULL;
+  ptw32_mutex_prio_t * prio = NULL;
+  ptw32_lock_elide_t * elide = NULL;
+  pthread_mutex_t mx;
+
+  if (mutex == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (attr != NULL && PTW32_ATTR_IS_INITIALIZER (*attr))
+    {
+      attr = NULL;
+    }
+
+  if (attr != NULL && *attr != NULL)
+    {
+      if (((*attr)->fairness != PTHREAD_MUTEX_BARGING_NP
+           || (*attr)->protocol != PTHREAD_PRIO_NONE)
+          && ((*attr)->pshared == PTHREAD_PROCESS_SHARED
+              || (*attr)->robustness == PTHREAD_MUTEX_ROBUST))
+        {
+          return ENOSYS;
+        }
+
+      if ((*attr)->pshared == PTHREAD_PROCESS_SHARED)
+        {
+          /*
+           * Creating mutex that can be shared between
+           * processes. See ptw32_pshared_mutex.c.
+           */
+          return ptw32_pshared_mutex_init (mutex,
+                                           (*attr)->kind == PTHREAD_MUTEX_ELIDE_NP
+                                           ? PTHREAD_MUTEX_NORMAL : (*attr)->kind,
+                                           (*attr)->robustness);
+        }
+    }
+
+  /*
+   * Fair mutexes park their waiters with WaitOnAddress; without it
+   * they are barging.
+   */
+  if (attr != NULL && *attr != NULL
+      && (*attr)->fairness != PTHREAD_MUTEX_BARGING_NP
+      && (*attr)->fairness != PTHREAD_MUTEX_NUMA_COHORT_NP
+      && ptw32_waitonaddress != NULL)
+    {
+      if ((fair = (ptw32_mutex_fair_t *) ptw32_object_alloc (sizeof (*fair), 0)) == NULL)
+        {
+          return ENOMEM;
+        }
+      fair->fairness = (*attr)->fairness;
+    }
+
+  /*
+   * Cohort mutexes queue their waiters by NUMA node. See
+   * ptw32_mutex_cohort.c.
+   */
+  if (attr != NULL && *attr != NULL
+      && (*attr)->fairness == PTHREAD_MUTEX_NUMA_COHORT_NP)
+    {
+      ptw32_topology_t * topology = ptw32_gettopology ();
+
+      if (topology == NULL
+          || (cohort = ptw32_mutex_cohort_new (topology->nNodes)) == NULL)
+        {
+          return ENOMEM;
+        }
+    }
+
+  if (attr != NULL && *attr != NULL
+      && (*attr)->protocol != PTHREAD_PRIO_NONE)
+    {
+      if ((prio = (ptw32_mutex_prio_t *) ptw32_object_alloc (sizeof (*prio), 0)) == NULL)
+        {
+          ptw32_object_free (fair);
+          ptw32_object_free (cohort);
+          return ENOMEM;
+        }
+      prio->protocol = (*attr)->protocol;
+      prio->ceiling = (*attr)->prioceiling;
+    }
+
+  /*
+   * Elided mutexes need RTM, and are otherwise normal mutexes. See
+   * ptw32_lock_elide.c.
+   */
+  if (attr != NULL && *attr != NULL
+      && (*attr)->kind == PTHREAD_MUTEX_ELIDE_NP
+      && ptw32_lockElide
+      && fair == NULL && cohort == NULL && prio == NULL
+      && (*attr)->robustness != PTHREAD_MUTEX_ROBUST)
+    {
+      if ((elide = ptw32_lock_elide_new ()) == NULL)
+        {
+          return ENOMEM;
+        }
+    }
+
+  if (storage != NULL && size >= sizeof (*mx))
+    {
+      mx = (pthread_mutex_t) storage;
+      memset (mx, 0, sizeof (*mx));
+      mx->inPlace = PTW32_TRUE;
+    }
+  else
+    {
+      mx = (pthread_mutex_t) ptw32_object_alloc (sizeof (*mx), ptw32_objectAlign);
+    }
+
+  if (mx == NULL)
+    {
+      ptw32_object_free (fair);
+      ptw32_object_free (cohort);
+      ptw32_object_free (prio);
+      ptw32_object_free (elide);
+      result = ENOMEM;
+    }
+  else
+    {
+      mx->lock_idx = 0;
+      mx->recursive_count = 0;
+      if (attr == NULL || *attr == NULL)
+        {
+          mx->kind = PTHREAD_MUTEX_DEFAULT;
+        }
+      else
+        {
+          mx->kind = (*attr)->kind;
+          if (mx->kind == PTHREAD_MUTEX_ELIDE_NP && elide == NULL)
+            {
+              mx->kind = PTHREAD_MUTEX_NORMAL;
+            }
+          if ((*attr)->spin != PTHREAD_MUTEX_SPIN_DEFAULT)
+            {
+              spin = (*attr)->spin;
+            }
+          if ((*attr)->robustness == PTHREAD_MUTEX_ROBUST)
+            {
+              /*
+               * Use the negative range to represent robust types.
+               * Replaces a memory fetch with a register negate and incr
+               * in pthread_mutex_lock etc.
+               *
+               * Map 0,1,..,n to -1,-2,..,(-n)-1
+               */
+              mx->kind = -mx->kind - 1;
+
+              mx->robustNode.stateInconsistent = PTW32_ROBUST_CONSISTENT;
+              mx->robustNode.mx = mx;
+              mx->robustNode.next = NULL;
+              mx->robustNode.prev = NULL;
+            }
+        }
+
+      mx->ownerThread.p = NULL;
+      PTW32_LOCKSTAT_INIT (mx->stats, PTHREAD_LOCKSTAT_MUTEX_NP, mx);
+      PTW32_LOCKWATCH_INIT (mx);
+
+      /*
+       * Spinning only pays if the owner can run while we spin.
+       */
+      if (spin > 0)
+        {
+          int cpus;
+
+          if (0 != ptw32_getprocessors (&cpus) || cpus < 2)
+            {
+              spin = 0;
+            }
+        }
+      mx->spinLimit = spin;
+      mx->spinEstimate = 0;
+
+      /*
+       * Mutexes that wait via WaitOnAddress park their waiters on
+       * lock_idx and never need an event. Otherwise the event is
+       * created when the mutex is first contended. See
+       * ptw32_mutex_wait.c.
+       */
+      mx->event = NULL;
+      mx->parked = 0;
+
+#if defined(PTW32_COND_WAITONADDRESS)
+      mx->morphCond = NULL;
+#endif
+
+      mx->fair = fair;
+      mx->cohort = cohort;
+      mx->prio = prio;
+      mx->elide = elide;
+
+      /*
+       * The kind specialised entry points only take their fast path
+       * on mutexes with nothing to do beyond lock_idx, and never in
+       * instrumented builds. See pthread_mutex_kind_np.c.
+       */
+#if defined(PTW32_LOCKSTAT) || defined(PTW32_LOCKWATCH)
+      mx->fastKind = -1;
+#else
+      mx->fastKind = (mx->kind >= 0 && mx->kind != PTHREAD_MUTEX_ELIDE_NP
+                      && fair == NULL && cohort == NULL && prio == NULL)
+                     ? mx->kind : -1;
+#endif
+    }
+
+  *mutex = mx;
+
+  return (result);
+}
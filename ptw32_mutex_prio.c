@@ -0,0 +1,334 @@
+/*
+ * ptw32_mutex_prio.c
+ *
+ * Description:
+ * This translation unit implements mutex primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Priority protocol mutexes (PTHREAD_PRIO_INHERIT, PTHREAD_PRIO_PROTECT).
+ *
+ * Each owner keeps a list of the protocol mutexes it holds. Its boost,
+ * the priority they lend it, is the highest of the ceilings of the
+ * PTHREAD_PRIO_PROTECT mutexes and of the effective priorities of the
+ * threads blocked on the PTHREAD_PRIO_INHERIT mutexes. It is recomputed
+ * whenever one of those changes, and the thread runs at the higher of
+ * its boost and its sched_priority (see ptw32_boostthreadpriority).
+ *
+ * A waiter counts from just before it blocks until it wakes, and a
+ * waiter that loses the mutex again after waking counts against the
+ * new owner when it blocks again. Inheritance follows a chain of
+ * owners only as far as the effective priorities at the time each
+ * waiter blocks.
+ *
+ * Protocol mutexes are expected to be few, so a single lock guards the
+ * state of all of them. Only acquisitions, releases and blocking waits
+ * of protocol mutexes take it.
+ */
+
+
+static INLINE int
+ptw32_mutex_prio_effective (ptw32_thread_t * tp)
+{
+  return PTW32_WAIT_PRIORITY (tp);
+}
+
+
+static void
+ptw32_mutex_prio_update (ptw32_thread_t * tp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Recomputes and applies the boost the mutexes held by
+      *      'tp' lend it. Called with ptw32_mutex_prio_lock held.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int boost = PTW32_PRIO_NO_BOOST;
+  ptw32_mutex_prio_t * p;
+  ptw32_mutex_prio_waiter_t * w;
+
+  for (p = tp->prioMxList; p != NULL; p = p->next)
+    {
+      if (p->protocol == PTHREAD_PRIO_PROTECT)
+	{
+	  boost = PTW32_MAX (boost, p->ceiling);
+	}
+      else
+	{
+	  for (w = p->waiters; w != NULL; w = w->next)
+	    {
+	      boost = PTW32_MAX (boost, w->priority);
+	    }
+	}
+    }
+
+  ptw32_boostthreadpriority (tp, boost);
+}
+
+
+int
+ptw32_mutex_prio_check (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Checks that the calling thread may lock a priority
+      *      protocol mutex: a thread whose priority is above
+      *      the ceiling of a PTHREAD_PRIO_PROTECT mutex may not.
+      *
+      * RESULTS
+      *              0               the thread may lock the mutex,
+      *              EINVAL          the thread's priority is above
+      *                              the mutex's ceiling.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * self;
+
+  if (mx->prio->protocol == PTHREAD_PRIO_PROTECT)
+    {
+      self = (ptw32_thread_t *) pthread_self ().p;
+
+      if (self != NULL && self->sched_priority > mx->prio->ceiling)
+	{
+	  return EINVAL;
+	}
+    }
+
+  return 0;
+}
+
+
+void
+ptw32_mutex_prio_block (pthread_mutex_t mx, ptw32_mutex_prio_waiter_t * waiter)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Counts the calling thread, about to block on a
+      *      PTHREAD_PRIO_INHERIT mutex, as a waiter and raises
+      *      the owner's priority to at least the caller's.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mutex_prio_t * p = mx->prio;
+  ptw32_thread_t * self = (ptw32_thread_t *) pthread_self ().p;
+  ptw32_mcs_local_node_t node;
+
+  waiter->next = NULL;
+  waiter->prev = NULL;
+  waiter->priority = PTW32_PRIO_NO_BOOST;
+
+  if (p->protocol != PTHREAD_PRIO_INHERIT || self == NULL)
+    {
+      return;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_mutex_prio_lock, &node);
+
+  waiter->priority = ptw32_mutex_prio_effective (self);
+  waiter->next = p->waiters;
+  if (p->waiters != NULL)
+    {
+      p->waiters->prev = waiter;
+    }
+  p->waiters = waiter;
+
+  if (p->owner != NULL
+      && ptw32_mutex_prio_effective (p->owner) < waiter->priority)
+    {
+      ptw32_mutex_prio_update (p->owner);
+    }
+
+  ptw32_mcs_lock_release (&node);
+}
+
+
+void
+ptw32_mutex_prio_unblock (pthread_mutex_t mx, ptw32_mutex_prio_waiter_t * waiter)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Stops counting a waiter counted by
+      *      ptw32_mutex_prio_block(), once it has woken.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mutex_prio_t * p = mx->prio;
+  ptw32_mcs_local_node_t node;
+
+  if (waiter->priority == PTW32_PRIO_NO_BOOST)
+    {
+      return;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_mutex_prio_lock, &node);
+
+  if (waiter->prev == NULL)
+    {
+      p->waiters = waiter->next;
+    }
+  else
+    {
+      waiter->prev->next = waiter->next;
+    }
+  if (waiter->next != NULL)
+    {
+      waiter->next->prev = waiter->prev;
+    }
+
+  if (p->owner != NULL)
+    {
+      /* In case it was a waiter that timed out */
+      ptw32_mutex_prio_update (p->owner);
+    }
+
+  ptw32_mcs_lock_release (&node);
+}
+
+
+void
+ptw32_mutex_prio_acquired (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Records the calling thread, which has just locked a
+      *      priority protocol mutex, as its owner and applies
+      *      the boost the mutex lends it: its ceiling, or the
+      *      priority of the threads still blocked on it.
+      *      Relocking a recursive mutex changes nothing.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mutex_prio_t * p = mx->prio;
+  ptw32_thread_t * self = (ptw32_thread_t *) pthread_self ().p;
+  ptw32_mcs_local_node_t node;
+
+  if (self == NULL || p->owner == self)
+    {
+      return;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_mutex_prio_lock, &node);
+
+  p->owner = self;
+  p->prev = NULL;
+  p->next = self->prioMxList;
+  if (self->prioMxList != NULL)
+    {
+      self->prioMxList->prev = p;
+    }
+  self->prioMxList = p;
+
+  ptw32_mutex_prio_update (self);
+
+  ptw32_mcs_lock_release (&node);
+}
+
+
+void
+ptw32_mutex_prio_release (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Called before a priority protocol mutex is released.
+      *      Forgets its owner and drops the boost the mutex lent
+      *      the owner.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mutex_prio_t * p = mx->prio;
+  ptw32_thread_t * tp;
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&ptw32_mutex_prio_lock, &node);
+
+  if ((tp = p->owner) != NULL)
+    {
+      if (p->prev == NULL)
+	{
+	  tp->prioMxList = p->next;
+	}
+      else
+	{
+	  p->prev->next = p->next;
+	}
+      if (p->next != NULL)
+	{
+	  p->next->prev = p->prev;
+	}
+      p->owner = NULL;
+
+      ptw32_mutex_prio_update (tp);
+    }
+
+  ptw32_mcs_lock_release (&node);
+}
+
+
+void
+ptw32_mutex_prio_quit (ptw32_thread_t * tp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Forgets the owner of the priority protocol mutexes a
+      *      terminating thread still holds, so that no one
+      *      adjusts the priority of a thread that has gone.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+
+  if (tp->prioMxList == NULL)
+    {
+      return;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_mutex_prio_lock, &node);
+
+  while (tp->prioMxList != NULL)
+    {
+      tp->prioMxList->owner = NULL;
+      tp->prioMxList = tp->prioMxList->next;
+    }
+
+  ptw32_mcs_lock_release (&node);
+}
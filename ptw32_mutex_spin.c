@@ -0,0 +1,104 @@
+/*
+ * ptw32_mutex_spin.c
+ *
+ * Description:
+ * This translation unit implements mutual exclusion (mutex) primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+INLINE int
+ptw32_mutex_spin (pthread_mutex_t mx, LONG lockval)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Spin-then-block support for adaptive mutexes.
+      *
+      *      Called after a failed attempt to acquire the mutex
+      *      and before the caller blocks in ptw32_mutex_wait(). Polls
+      *      lock_idx for a bounded number of iterations and
+      *      tries to take the lock as soon as it is seen free.
+      *
+      *      The bound self-tunes: it is twice the running
+      *      average of the spins previously needed to acquire
+      *      this mutex (plus a small constant), but never more
+      *      than the mutex's spinLimit. A mutex whose spinLimit
+      *      is zero never spins, and no mutex spins while
+      *      ptw32_spin_pays() says the owner can't run meanwhile.
+      *
+      *      'lockval' is the value to store in lock_idx on
+      *      acquisition. Callers whose failed attempt may have
+      *      overwritten a -1 (waiters) state must pass -1 so
+      *      that the eventual unlock still wakes a waiter.
+      *
+      * RESULTS
+      *              PTW32_TRUE      the lock was acquired,
+      *              PTW32_FALSE     the caller must block.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int limit;
+  int count;
+
+  if (mx->spinLimit == 0 || !ptw32_spin_pays ())
+    {
+      return PTW32_FALSE;
+    }
+
+  limit = PTW32_MIN(mx->spinEstimate * 2 + 10, mx->spinLimit);
+
+  for (count = 0; count < limit; count++)
+    {
+      if (PTW32_ATOMIC_LOAD_RELAXED_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx) == 0
+          && (PTW32_INTERLOCKED_LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG(
+                     (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                     (PTW32_INTERLOCKED_LONG) lockval,
+                     (PTW32_INTERLOCKED_LONG) 0) == 0)
+        {
+          /*
+           * The estimate isn't updated atomically. Lost updates
+           * only affect the tuning, not correctness.
+           */
+          mx->spinEstimate += (count - mx->spinEstimate) / 8;
+          return PTW32_TRUE;
+        }
+
+      PTW32_YIELD_PROCESSOR();
+    }
+
+  mx->spinEstimate += (count - mx->spinEstimate) / 8;
+
+  return PTW32_FALSE;
+}
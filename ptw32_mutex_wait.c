@@ -0,0 +1,262 @@
+/*
+ * ptw32_mutex_wait.c
+ *
+ * Description:
+ * This translation unit implements mutual exclusion (mutex) primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * ptw32_mutex_event -- get the mutex event, creating it on first use.
+ *
+ * Mutexes that wait on an event don't create it until the mutex is
+ * first contended. The first thread to need it, whether waiter or
+ * waker, creates an event and publishes it with a compare-exchange
+ * (cf. ptw32_mcs_flag_wait). A thread that loses the race closes its
+ * own event and uses the winner's. Because the event is auto-reset a
+ * wake that creates the event is not lost: the waiter finds the event
+ * already signalled.
+ *
+ * Returns NULL if the event could not be created.
+ */
+static INLINE HANDLE
+ptw32_mutex_event (pthread_mutex_t mx)
+{
+  HANDLE e = (HANDLE)(PTW32_INTERLOCKED_SIZE)PTW32_INTERLOCKED_EXCHANGE_ADD_SIZE(
+                                               (PTW32_INTERLOCKED_SIZEPTR)&mx->event,
+                                               (PTW32_INTERLOCKED_SIZE)0); /* MBR fence */
+
+  if ((HANDLE)0 == e)
+    {
+      HANDLE ne = ptw32_libstat_handle (CreateEvent (NULL, PTW32_FALSE,    /* manual reset = No */
+                                                     PTW32_FALSE,           /* initial state = not signaled */
+                                                     NULL),                 /* event name */
+                                        PTW32_LIBSTAT_EVENTS);
+
+      if ((HANDLE)0 != ne)
+        {
+          e = (HANDLE)(PTW32_INTERLOCKED_SIZE)PTW32_INTERLOCKED_COMPARE_EXCHANGE_SIZE(
+                                                (PTW32_INTERLOCKED_SIZEPTR)&mx->event,
+                                                (PTW32_INTERLOCKED_SIZE)ne,
+                                                (PTW32_INTERLOCKED_SIZE)0);
+          if ((HANDLE)0 == e)
+            {
+              /* stored our handle in the mutex */
+              e = ne;
+            }
+          else
+            {
+              /* another thread got there first */
+              (void) ptw32_closehandle (ne, PTW32_LIBSTAT_EVENTS);
+            }
+        }
+    }
+
+  return e;
+}
+
+
+/*
+ * A lock_idx of -1 only says that there may be waiters: a thread that
+ * set it may since have acquired the mutex and left. So that unlocking
+ * doesn't call SetEvent or WakeByAddressSingle for nobody, waiters
+ * count themselves in mx->parked around the wait, and look at lock_idx
+ * again after counting themselves. ptw32_mutex_wake looks at parked
+ * after the unlock has changed lock_idx. Both are full barriers, so
+ * either the waker sees the waiter counted, or the waiter sees that
+ * lock_idx is no longer -1 and doesn't block. Robust mutexes are
+ * woken regardless when their owner dies, which leaves lock_idx -1.
+ */
+
+
+INLINE int
+ptw32_mutex_wait (pthread_mutex_t mx, clockid_t clock,
+                  const struct timespec *abstime)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Blocks the calling thread until the mutex may have
+      *      been released, or until abstime, measured against
+      *      'clock', passes.
+      *
+      *      The caller must have set lock_idx to -1 (locked with
+      *      possible waiters) before calling this routine and must
+      *      retry the acquisition on return. Non-robust mutexes
+      *      wait on lock_idx itself via WaitOnAddress if the system
+      *      provides it, otherwise on the mutex event, which is
+      *      created here on first contention.
+      *
+      *      If 'abstime' is a NULL pointer then this function will
+      *      block until woken.
+      *
+      *      This routine is not a cancellation point.
+      *
+      * RESULTS
+      *              0               woken (possibly spuriously),
+      *              ETIMEDOUT       abstime passed
+      *              EINVAL          the wait failed.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result = 0;
+  ptw32_mutex_prio_waiter_t prioWaiter;
+  ptw32_waitgraph_record_t * edge;
+
+  PTW32_ETW_EVENT (PTW32_ETW_MUTEX_WAIT_BEGIN, mx, 0);
+
+  edge = ptw32_waitgraph_block (mx);
+
+  if (mx->prio != NULL)
+    {
+      ptw32_mutex_prio_block (mx, &prioWaiter);
+    }
+
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->parked);
+
+  if ((LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                                                  (PTW32_INTERLOCKED_LONG) 0) != -1)
+    {
+      /* Released since the caller looked: retry at once */
+    }
+  else if (PTW32_MUTEX_USES_WAITONADDRESS(mx))
+    {
+      LONG waiters = -1;
+
+      PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_MUTEX);
+      if (!ptw32_waitonaddress_abstime ((volatile VOID *) &mx->lock_idx,
+                                        (PVOID) &waiters,
+                                        sizeof (waiters),
+                                        clock, abstime))
+        {
+          result = (GetLastError () == ERROR_TIMEOUT) ? ETIMEDOUT : EINVAL;
+        }
+    }
+  else
+    {
+      DWORD status;
+      DWORD milliseconds;
+      HANDLE handles[2];
+
+      if ((handles[0] = ptw32_mutex_event (mx)) == NULL)
+        {
+          result = EINVAL;
+        }
+      else
+        {
+          /*
+           * handles[1] is a high resolution timer for abstime, if any.
+           */
+          milliseconds = ptw32_wait_timeout (clock, abstime, &handles[1]);
+
+          PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_MUTEX);
+          status = ptw32_wait_objects ((handles[1] == NULL) ? 1 : 2, handles,
+                                       milliseconds);
+
+          if (status != WAIT_OBJECT_0)
+            {
+              result = (status == WAIT_TIMEOUT || status == WAIT_OBJECT_0 + 1)
+                       ? ETIMEDOUT : EINVAL;
+            }
+        }
+    }
+
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->parked);
+
+  if (mx->prio != NULL)
+    {
+      ptw32_mutex_prio_unblock (mx, &prioWaiter);
+    }
+
+  ptw32_waitgraph_unblock (edge);
+
+  PTW32_ETW_EVENT (PTW32_ETW_MUTEX_WAIT_END, mx, result);
+
+  return result;
+}
+
+
+INLINE int
+ptw32_mutex_wake (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Wakes one thread blocked in ptw32_mutex_wait(), if
+      *      there is one (robust mutexes: regardless).
+      *      Called after releasing a mutex whose lock_idx was -1,
+      *      and for robust mutexes whose owner has terminated.
+      *
+      *      An asynchronous waiter (pthread_mutex_lock_async_np)
+      *      that gets the mutex here leaves lock_idx -1, so the
+      *      blocked threads are woken when it unlocks instead.
+      *
+      * RESULTS
+      *              0               success,
+      *              EINVAL          the wake failed.
+      *
+      * ------------------------------------------------------
+      */
+{
+  PTW32_ETW_EVENT (PTW32_ETW_MUTEX_WAKE, mx, 0);
+
+  if (ptw32_async_wake ((volatile VOID *) &mx->lock_idx, PTW32_FALSE) > 0)
+    {
+      return 0;
+    }
+
+  if (mx->kind >= 0
+      && 0 == (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->parked,
+                                                          (PTW32_INTERLOCKED_LONG) 0))
+    {
+      /* The waiters that set lock_idx to -1 have all gone */
+      return 0;
+    }
+
+  if (PTW32_MUTEX_USES_WAITONADDRESS(mx))
+    {
+      ptw32_wakebyaddresssingle ((PVOID) &mx->lock_idx);
+    }
+  else
+    {
+      HANDLE e = ptw32_mutex_event (mx);
+
+      if (e == NULL || PTW32_SETEVENT (e) == 0)
+        {
+          return EINVAL;
+        }
+    }
+
+  return 0;
+}
@@ -62,7 +62,10 @@ ptw32_new (void)
   else
     {
       /* No reuse threads available */
-      tp = (ptw32_thread_t *) calloc (1, sizeof(ptw32_thread_t));
+      if ((tp = ptw32_largepage_thread_alloc ()) == NULL)
+        {
+          tp = (ptw32_thread_t *) calloc (1, sizeof(ptw32_thread_t));
+        }
 
       if (tp == NULL)
 	{
@@ -71,32 +74,40 @@ ptw32_new (void)
 
       /* ptHandle.p needs to point to it's parent ptw32_thread_t. */
       t.p = tp->ptHandle.p = tp;
-      t.x = tp->ptHandle.x = 0;
+      /* Past any counter a freed struct at this address had */
+      t.x = tp->ptHandle.x = ptw32_threadReuseBase;
     }
 
   /* Set default state. */
-  tp->seqNumber = ++ptw32_threadSeqNumber;
+  tp->seqNumber = (unsigned __int64) PTW32_INTERLOCKED_INCREMENT_64 (&ptw32_threadSeqNumber);
   tp->sched_priority = THREAD_PRIORITY_NORMAL;
+  tp->sched_policy = SCHED_OTHER;
+  tp->qos = PTHREAD_QOS_DEFAULT_NP;
+  tp->wakeBoost = 1;
   tp->detachState = PTHREAD_CREATE_JOINABLE;
   tp->cancelState = PTHREAD_CANCEL_ENABLE;
   tp->cancelType = PTHREAD_CANCEL_DEFERRED;
   tp->stateLock = 0;
   tp->threadLock = 0;
-  tp->robustMxListLock = 0;
   tp->robustMxList = NULL;
-  tp->name = NULL;
+  tp->cleanupStack = NULL;
+  tp->prioMxList = NULL;
+  tp->boostPriority = PTW32_PRIO_NO_BOOST;
+  tp->yields = 0;
+  tp->ioCancel = 0;
+  /* A reused struct keeps its RCU reader record */
+  tp->testCancel = (tp->rcuReader != NULL) ? PTW32_TESTCANCEL_RCU : 0;
+  tp->name[0] = '\0';
 #if defined(HAVE_CPU_AFFINITY)
-  CPU_ZERO((cpu_set_t*)&tp->cpuset);
+  CPU_ZERO(&tp->cpuset);
+  CPU_ZERO(&tp->softCpuset);
 #endif
-  tp->cancelEvent = CreateEvent (0, (int) PTW32_TRUE,	/* manualReset  */
-				 (int) PTW32_FALSE,	/* setSignaled  */
-				 NULL);
+  /* The cancel event is created on demand by ptw32_cancel_event */
+  tp->cancelEvent = NULL;
+  tp->waitStat = PTW32_LIBSTAT_WAIT_OTHER;
+  tp->waitHist = PTHREAD_HIST_OTHER_NP;
 
-  if (tp->cancelEvent == NULL)
-    {
-      ptw32_threadReusePush (tp->ptHandle);
-      return nil;
-    }
+  PTW32_LIBSTAT_ADD (PTW32_LIBSTAT_THREADS, 1);
 
   return t;
 
@@ -0,0 +1,319 @@
+/*
+ * ptw32_object_alloc.c
+ *
+ * Description:
+ * This translation unit implements the allocator for synchronisation objects.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Every block has a header word just below the address handed out.
+ * For a slab block it holds the size class plus 1. It is written when
+ * the slab is carved and never again, so the word, which shares a
+ * cache line with the end of the block before, doesn't bounce while
+ * that block is in use. A block too big or too strictly aligned for
+ * the slabs has a calloc() of its own and the header holds the
+ * pointer to it.
+ */
+#define PTW32_OBJECT_HEADER PTW32_OBJECT_GRANULE
+#define PTW32_OBJECT_TAG(p) (((size_t *) (p))[-1])
+#define PTW32_OBJECT_NEXT(p) (*(void **) (p))
+
+
+static void *
+ptw32_object_carve (int c)
+     /*
+      * Cuts a new slab into blocks of class 'c' and returns them
+      * as a list, lowest address first. The slab comes from large
+      * pages if it can (see ptw32_largepage.c).
+      */
+{
+  size_t stride = (size_t) (c + 1) * PTW32_OBJECT_GRANULE;
+  char * slab;
+  char * first;
+  void * list = NULL;
+  size_t n;
+
+  if ((slab = (char *) ptw32_largepage_alloc (PTW32_OBJECT_SLAB_SIZE)) == NULL
+      && (slab = (char *) malloc (PTW32_OBJECT_SLAB_SIZE)) == NULL)
+    {
+      return NULL;
+    }
+
+  first = (char *) (((size_t) slab + PTW32_OBJECT_HEADER + PTW32_OBJECT_SLAB_ALIGN - 1)
+		    & ~((size_t) PTW32_OBJECT_SLAB_ALIGN - 1));
+  n = (size_t) (slab + PTW32_OBJECT_SLAB_SIZE - first + PTW32_OBJECT_HEADER) / stride;
+
+  while (n-- > 0)
+    {
+      char * p = first + n * stride;
+
+      PTW32_OBJECT_TAG (p) = (size_t) c + 1;
+      PTW32_OBJECT_NEXT (p) = list;
+      list = p;
+    }
+
+  return list;
+}
+
+
+static void *
+ptw32_object_take (int c, int max, int * count)
+     /*
+      * Detaches up to 'max' blocks from class 'c', carving a new
+      * slab if it has none, and returns them as a list.
+      */
+{
+  ptw32_object_class_t * oc = &ptw32_objectClasses[c];
+  ptw32_mcs_local_node_t node;
+  void * head;
+  void * p;
+  int n = 0;
+
+  ptw32_mcs_lock_acquire (&oc->lock, &node);
+
+  if (oc->freeList == NULL)
+    {
+      oc->freeList = ptw32_object_carve (c);
+    }
+
+  head = p = oc->freeList;
+
+  if (p != NULL)
+    {
+      for (n = 1; n < max && PTW32_OBJECT_NEXT (p) != NULL; n++)
+	{
+	  p = PTW32_OBJECT_NEXT (p);
+	}
+      oc->freeList = PTW32_OBJECT_NEXT (p);
+      PTW32_OBJECT_NEXT (p) = NULL;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  *count = n;
+
+  return head;
+}
+
+
+static void
+ptw32_object_give (int c, void * head)
+     /*
+      * Returns the list 'head' to class 'c'.
+      */
+{
+  ptw32_object_class_t * oc = &ptw32_objectClasses[c];
+  ptw32_mcs_local_node_t node;
+  void * tail = head;
+
+  while (PTW32_OBJECT_NEXT (tail) != NULL)
+    {
+      tail = PTW32_OBJECT_NEXT (tail);
+    }
+
+  ptw32_mcs_lock_acquire (&oc->lock, &node);
+  PTW32_OBJECT_NEXT (tail) = oc->freeList;
+  oc->freeList = head;
+  ptw32_mcs_lock_release (&node);
+}
+
+
+void *
+ptw32_object_alloc (size_t size, int align)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Allocates a zeroed block of 'size' bytes for a
+      *      synchronisation object, an attribute object or any
+      *      other small structure the library makes and drops at
+      *      the rate its user does: pool tasks and the side
+      *      structures of fair and priority mutexes among them.
+      *
+      *      If 'align' is non-zero the block starts on a multiple
+      *      of it and its size is rounded up to one, so no other
+      *      object shares its cache lines. Synchronisation objects
+      *      pass ptw32_objectAlign, as set by
+      *      pthread_setobjectalign_np().
+      *
+      *      Small blocks come from slabs of blocks of one size,
+      *      through a cache kept by each POSIX thread, so that
+      *      initialising and destroying objects rarely takes a
+      *      lock and never takes the heap's. Slabs are kept for
+      *      the life of the process.
+      *
+      * RESULTS
+      *              the block, or NULL if there is no memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  size_t a = (align > PTW32_OBJECT_GRANULE) ? (size_t) align : PTW32_OBJECT_GRANULE;
+  size_t stride = (size + PTW32_OBJECT_HEADER + a - 1) & ~(a - 1);
+  char * p;
+
+  if (stride <= PTW32_OBJECT_SLAB_MAX && a <= PTW32_OBJECT_SLAB_ALIGN)
+    {
+      int c = (int) (stride / PTW32_OBJECT_GRANULE) - 1;
+      ptw32_thread_t * sp = PTW32_SELF_THREAD ();
+      int n;
+
+      if (sp == NULL)
+	{
+	  p = (char *) ptw32_object_take (c, 1, &n);
+	}
+      else
+	{
+	  if (sp->objectCache[c] == NULL)
+	    {
+	      sp->objectCache[c] = ptw32_object_take (c, PTW32_OBJECT_CACHE_BATCH, &n);
+	      sp->nObjectCache[c] = (unsigned char) n;
+	    }
+	  if ((p = (char *) sp->objectCache[c]) != NULL)
+	    {
+	      sp->objectCache[c] = PTW32_OBJECT_NEXT (p);
+	      sp->nObjectCache[c]--;
+	    }
+	}
+
+      if (p != NULL)
+	{
+	  memset (p, 0, stride - PTW32_OBJECT_HEADER);
+	}
+
+      return p;
+    }
+  else
+    {
+      char * base = (char *) calloc (1, stride + a);
+
+      if (base == NULL)
+	{
+	  return NULL;
+	}
+
+      p = (char *) (((size_t) base + PTW32_OBJECT_HEADER + a - 1) & ~(a - 1));
+      PTW32_OBJECT_TAG (p) = (size_t) base;
+
+      return p;
+    }
+}
+
+
+void
+ptw32_object_free (void * p)
+{
+  size_t tag;
+  int c;
+  ptw32_thread_t * sp;
+
+  if (p == NULL)
+    {
+      return;
+    }
+
+  tag = PTW32_OBJECT_TAG (p);
+
+  if (tag > PTW32_OBJECT_CLASSES)
+    {
+      free ((void *) tag);
+      return;
+    }
+
+  c = (int) tag - 1;
+  sp = PTW32_SELF_THREAD ();
+
+  if (sp == NULL)
+    {
+      PTW32_OBJECT_NEXT (p) = NULL;
+      ptw32_object_give (c, p);
+      return;
+    }
+
+  PTW32_OBJECT_NEXT (p) = sp->objectCache[c];
+  sp->objectCache[c] = p;
+
+  if (++sp->nObjectCache[c] > PTW32_OBJECT_CACHE_MAX)
+    {
+      /*
+       * Keep the most recently freed blocks, which are the likeliest
+       * to still be in this processor's cache.
+       */
+      void * last = p;
+      int n;
+
+      for (n = 1; n < PTW32_OBJECT_CACHE_MAX - PTW32_OBJECT_CACHE_BATCH; n++)
+	{
+	  last = PTW32_OBJECT_NEXT (last);
+	}
+      ptw32_object_give (c, PTW32_OBJECT_NEXT (last));
+      PTW32_OBJECT_NEXT (last) = NULL;
+      sp->nObjectCache[c] = (unsigned char) n;
+    }
+}
+
+
+size_t
+ptw32_object_stride (size_t size, int align)
+     /*
+      * Returns the spacing of objects of 'size' bytes kept side by
+      * side in one block from ptw32_object_alloc (n * stride, align),
+      * so that each is aligned as a block of its own would be.
+      */
+{
+  size_t a = (align > PTW32_OBJECT_GRANULE) ? (size_t) align : PTW32_OBJECT_GRANULE;
+
+  return (size + a - 1) & ~(a - 1);
+}
+
+
+void
+ptw32_object_cache_flush (ptw32_thread_t * tp)
+     /*
+      * Returns the blocks cached by a thread that has ended.
+      */
+{
+  int c;
+
+  for (c = 0; c < PTW32_OBJECT_CLASSES; c++)
+    {
+      if (tp->objectCache[c] != NULL)
+	{
+	  ptw32_object_give (c, tp->objectCache[c]);
+	  tp->objectCache[c] = NULL;
+	  tp->nObjectCache[c] = 0;
+	}
+    }
+}
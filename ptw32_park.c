@@ -0,0 +1,286 @@
+/*
+ * ptw32_park.c
+ *
+ * Description:
+ * This translation unit implements the library's parking lot.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * The parking lot: the library's own WaitOnAddress, WakeByAddressSingle
+ * and WakeByAddressAll, installed in their place when the system
+ * doesn't provide them (before Windows 8; not with NEED_WAITONADDRESS).
+ * Everything that parks on an address - non-robust mutexes, the
+ * WaitOnAddress condition variables, tree barriers, timed SRW
+ * read/write locks and pthread_delay_np - then works the same way on
+ * every system, and none of those objects holds a kernel handle.
+ *
+ * Threads park in one of PTW32_PARK_BUCKETS queues, chosen by hashing
+ * the address, in a node on their own stack. A parked thread blocks on
+ * its cached MCS wait event (see ptw32_mcs_flag_wait), so the process
+ * needs one kernel object per thread that has ever parked rather than
+ * one per object waited on.
+ *
+ * Wakers change the value at the address before they wake it, and the
+ * value is compared with the bucket lock held, so a waker either finds
+ * the waiter parked or the waiter sees the new value. A woken thread
+ * is taken off its queue by the waker, who then sets its event; one
+ * whose wait times out first takes itself off unless a waker already
+ * has, in which case it consumes the event that is on its way. Either
+ * way the event is unsignalled again when ptw32_park returns.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+static ptw32_park_bucket_t *
+ptw32_park_bucket (volatile VOID * address)
+{
+  return &ptw32_parkingLot[((size_t) address >> 2) % PTW32_PARK_BUCKETS];
+}
+
+BOOL WINAPI
+ptw32_park (volatile VOID * address, PVOID compare, SIZE_T size, DWORD milliseconds)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Blocks the calling thread while the 'size' bytes at
+      *      'address' equal those at 'compare', until woken by
+      *      ptw32_unpark_one or ptw32_unpark_all or until
+      *      'milliseconds' have passed, as WaitOnAddress.
+      *
+      *      Like WaitOnAddress it may return spuriously.
+      *
+      * RESULTS
+      *              TRUE            woken, or the value differed,
+      *              FALSE           timed out; GetLastError()
+      *                              returns ERROR_TIMEOUT.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_park_bucket_t * b = ptw32_park_bucket (address);
+  ptw32_mcs_local_node_t node;
+  ptw32_parker_t parker;
+  ptw32_thread_t * sp = NULL;
+  BOOL result = PTW32_TRUE;
+
+  ptw32_mcs_lock_acquire (&b->lock, &node);
+
+  if (memcmp ((const void *) address, compare, size) != 0)
+    {
+      ptw32_mcs_lock_release (&node);
+      return PTW32_TRUE;
+    }
+
+  if (0 == milliseconds)
+    {
+      ptw32_mcs_lock_release (&node);
+      SetLastError (ERROR_TIMEOUT);
+      return PTW32_FALSE;
+    }
+
+  /* Borrow the thread's cached wait event */
+  if (ptw32_selfThreadKey != NULL
+      && NULL != (sp = PTW32_SELF_THREAD ()))
+    {
+      parker.event = sp->mcsEvent;
+      sp->mcsEvent = NULL;
+    }
+  else
+    {
+      parker.event = NULL;
+    }
+
+  if (NULL == parker.event
+      && NULL == (parker.event = ptw32_libstat_handle (CreateEvent (NULL, PTW32_FALSE, PTW32_FALSE, NULL),
+                                                         PTW32_LIBSTAT_EVENTS)))
+    {
+      /* Can't block: return as if woken spuriously */
+      ptw32_mcs_lock_release (&node);
+      Sleep (0);
+      return PTW32_TRUE;
+    }
+
+  parker.address = address;
+  parker.woken = PTW32_FALSE;
+  parker.next = NULL;
+
+  /* Woken in the order parked */
+  if (NULL == b->tail)
+    {
+      b->head = &parker;
+    }
+  else
+    {
+      b->tail->next = &parker;
+    }
+  b->tail = &parker;
+
+  ptw32_mcs_lock_release (&node);
+
+  if (WAIT_OBJECT_0 != WaitForSingleObject (parker.event, milliseconds))
+    {
+      ptw32_mcs_lock_acquire (&b->lock, &node);
+
+      if (!parker.woken)
+	{
+	  ptw32_parker_t ** link;
+	  ptw32_parker_t * prev = NULL;
+
+	  for (link = &b->head; *link != &parker; link = &(*link)->next)
+	    {
+	      prev = *link;
+	    }
+
+	  *link = parker.next;
+
+	  if (b->tail == &parker)
+	    {
+	      b->tail = prev;
+	    }
+
+	  result = PTW32_FALSE;
+	}
+
+      ptw32_mcs_lock_release (&node);
+
+      if (result)
+	{
+	  /* A waker has the node; its event can only be moments away */
+	  (void) WaitForSingleObject (parker.event, INFINITE);
+	}
+    }
+
+  if (sp != NULL && sp->mcsEvent == NULL)
+    {
+      sp->mcsEvent = parker.event;
+    }
+  else
+    {
+      ptw32_closehandle (parker.event, PTW32_LIBSTAT_EVENTS);
+    }
+
+  if (!result)
+    {
+      SetLastError (ERROR_TIMEOUT);
+    }
+
+  return result;
+}
+
+static void
+ptw32_unpark (PVOID address, int all)
+{
+  ptw32_park_bucket_t * b = ptw32_park_bucket (address);
+  ptw32_mcs_local_node_t node;
+  ptw32_parker_t * woken = NULL;
+  ptw32_parker_t ** wokenTail = &woken;
+  ptw32_parker_t ** link;
+  ptw32_parker_t * prev = NULL;
+
+  ptw32_mcs_lock_acquire (&b->lock, &node);
+
+  link = &b->head;
+
+  while (*link != NULL)
+    {
+      ptw32_parker_t * p = *link;
+
+      if (p->address != address)
+	{
+	  prev = p;
+	  link = &p->next;
+	  continue;
+	}
+
+      *link = p->next;
+
+      if (b->tail == p)
+	{
+	  b->tail = prev;
+	}
+
+      p->woken = PTW32_TRUE;
+      p->next = NULL;
+      *wokenTail = p;
+      wokenTail = &p->next;
+
+      if (!all)
+	{
+	  break;
+	}
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  /*
+   * A woken thread's node stays put until its event is set, so read
+   * everything needed from it first.
+   */
+  while (woken != NULL)
+    {
+      ptw32_parker_t * p = woken;
+      HANDLE event = p->event;
+
+      woken = p->next;
+      (void) PTW32_SETEVENT (event);
+    }
+}
+
+VOID WINAPI
+ptw32_unpark_one (PVOID address)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Wakes the thread that has been parked on 'address'
+      *      the longest, if any, as WakeByAddressSingle.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_unpark (address, PTW32_FALSE);
+}
+
+VOID WINAPI
+ptw32_unpark_all (PVOID address)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Wakes every thread parked on 'address', as
+      *      WakeByAddressAll.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_unpark (address, PTW32_TRUE);
+}
@@ -0,0 +1,201 @@
+/*
+ * ptw32_perf.c
+ *
+ * Description:
+ * This translation unit implements the performance counter provider.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * A library built with PTW32_PERFCOUNTERS registers a performance
+ * counter set (Perflib version 2) when the process attaches, with one
+ * instance per process named after its executable and process ID. The
+ * counters refer to ptw32_libStats (see pthread_getlibstats_np.c) and
+ * ptw32_threadReuseCount, so the library never updates them itself:
+ * the counter consumer reads them as it samples. The set is described
+ * to consumers by pthreads-perf.man (see README.NONPORTABLE); the IDs
+ * here must match it.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_PERFCOUNTERS)
+
+/* {575f7dfd-096d-423d-a899-1fe9ef31bb64} */
+static const GUID ptw32_perfProviderGuid =
+  { 0x575f7dfd, 0x096d, 0x423d, { 0xa8, 0x99, 0x1f, 0xe9, 0xef, 0x31, 0xbb, 0x64 } };
+
+/* {77d37be3-843a-4239-9c06-42033152cb8d} */
+static const GUID ptw32_perfCounterSetGuid =
+  { 0x77d37be3, 0x843a, 0x4239, { 0x9c, 0x06, 0x42, 0x03, 0x31, 0x52, 0xcb, 0x8d } };
+
+#define PTW32_PERF_REUSE	-1	/* ptw32_threadReuseCount, not a libstat */
+#define PTW32_PERF_NAME_MAX	MAX_PATH
+
+/*
+ * Indexed by counter ID - 1. Each average timer is followed by its
+ * base, as Perflib requires. A base refers to the low half of its
+ * 64 bit count, which is all Perflib reads of a PERF_AVERAGE_BASE.
+ */
+static const struct
+{
+  ULONG type;
+  int stat;
+} ptw32_perfCounters[] =
+{
+  { PERF_COUNTER_LARGE_RAWCOUNT, PTW32_LIBSTAT_THREADS },		/* 1 */
+  { PERF_COUNTER_RAWCOUNT, PTW32_PERF_REUSE },				/* 2 */
+  { PERF_COUNTER_BULK_COUNT, PTW32_LIBSTAT_WAIT_MUTEX },		/* 3 */
+  { PERF_COUNTER_BULK_COUNT, PTW32_LIBSTAT_WAIT_RWLOCK },		/* 4 */
+  { PERF_COUNTER_BULK_COUNT, PTW32_LIBSTAT_WAIT_COND },			/* 5 */
+  { PERF_COUNTER_BULK_COUNT, PTW32_LIBSTAT_WAIT_SEM },			/* 6 */
+  { PERF_COUNTER_BULK_COUNT, PTW32_LIBSTAT_WAIT_BARRIER },		/* 7 */
+  { PERF_COUNTER_BULK_COUNT, PTW32_LIBSTAT_WAIT_JOIN },			/* 8 */
+  { PERF_AVERAGE_TIMER, PTW32_LIBSTAT_TIME_MUTEX },			/* 9 */
+  { PERF_AVERAGE_BASE, PTW32_LIBSTAT_TIMED_MUTEX },			/* 10 */
+  { PERF_AVERAGE_TIMER, PTW32_LIBSTAT_TIME_MUTEX + PTW32_LIBSTAT_WAIT_RWLOCK - PTW32_LIBSTAT_WAIT_MUTEX },
+  { PERF_AVERAGE_BASE, PTW32_LIBSTAT_TIMED_MUTEX + PTW32_LIBSTAT_WAIT_RWLOCK - PTW32_LIBSTAT_WAIT_MUTEX },
+  { PERF_AVERAGE_TIMER, PTW32_LIBSTAT_TIME_MUTEX + PTW32_LIBSTAT_WAIT_COND - PTW32_LIBSTAT_WAIT_MUTEX },
+  { PERF_AVERAGE_BASE, PTW32_LIBSTAT_TIMED_MUTEX + PTW32_LIBSTAT_WAIT_COND - PTW32_LIBSTAT_WAIT_MUTEX },
+  { PERF_AVERAGE_TIMER, PTW32_LIBSTAT_TIME_MUTEX + PTW32_LIBSTAT_WAIT_SEM - PTW32_LIBSTAT_WAIT_MUTEX },
+  { PERF_AVERAGE_BASE, PTW32_LIBSTAT_TIMED_MUTEX + PTW32_LIBSTAT_WAIT_SEM - PTW32_LIBSTAT_WAIT_MUTEX },
+  { PERF_AVERAGE_TIMER, PTW32_LIBSTAT_TIME_MUTEX + PTW32_LIBSTAT_WAIT_BARRIER - PTW32_LIBSTAT_WAIT_MUTEX },
+  { PERF_AVERAGE_BASE, PTW32_LIBSTAT_TIMED_MUTEX + PTW32_LIBSTAT_WAIT_BARRIER - PTW32_LIBSTAT_WAIT_MUTEX },
+  { PERF_AVERAGE_TIMER, PTW32_LIBSTAT_TIME_MUTEX + PTW32_LIBSTAT_WAIT_JOIN - PTW32_LIBSTAT_WAIT_MUTEX },
+  { PERF_AVERAGE_BASE, PTW32_LIBSTAT_TIMED_MUTEX + PTW32_LIBSTAT_WAIT_JOIN - PTW32_LIBSTAT_WAIT_MUTEX },
+  { PERF_COUNTER_BULK_COUNT, PTW32_LIBSTAT_CANCELS },			/* 21 */
+  { PERF_COUNTER_LARGE_RAWCOUNT, PTW32_LIBSTAT_EVENTS },		/* 22 */
+  { PERF_COUNTER_LARGE_RAWCOUNT, PTW32_LIBSTAT_SEMAPHORES }		/* 23 */
+};
+
+#define PTW32_PERF_COUNTERS \
+  ((ULONG) (sizeof (ptw32_perfCounters) / sizeof (ptw32_perfCounters[0])))
+
+static struct
+{
+  PERF_COUNTERSET_INFO set;
+  PERF_COUNTER_INFO counters[PTW32_PERF_COUNTERS];
+} ptw32_perfTemplate;
+
+void
+ptw32_perf_register (void)
+{
+  WCHAR name[PTW32_PERF_NAME_MAX + 16];
+  WCHAR * base = name;
+  WCHAR * p;
+  DWORD n;
+  ULONG i;
+
+  if (ERROR_SUCCESS != PerfStartProvider ((LPGUID) &ptw32_perfProviderGuid, NULL,
+                                          &ptw32_perfProvider))
+    {
+      ptw32_perfProvider = NULL;
+      return;
+    }
+
+  ptw32_perfTemplate.set.CounterSetGuid = ptw32_perfCounterSetGuid;
+  ptw32_perfTemplate.set.ProviderGuid = ptw32_perfProviderGuid;
+  ptw32_perfTemplate.set.NumCounters = PTW32_PERF_COUNTERS;
+  ptw32_perfTemplate.set.InstanceType = PERF_COUNTERSET_MULTI_INSTANCES;
+
+  for (i = 0; i < PTW32_PERF_COUNTERS; i++)
+    {
+      PERF_COUNTER_INFO * c = &ptw32_perfTemplate.counters[i];
+
+      c->CounterId = i + 1;
+      c->Type = ptw32_perfCounters[i].type;
+      c->Attrib = PERF_ATTRIB_BY_REFERENCE;
+      c->Size = (ptw32_perfCounters[i].type == PERF_COUNTER_RAWCOUNT
+                 || ptw32_perfCounters[i].type == PERF_AVERAGE_BASE)
+                ? sizeof (ULONG) : sizeof (ULONGLONG);
+      c->DetailLevel = PERF_DETAIL_NOVICE;
+      c->Scale = 0;
+      c->Offset = 0;
+    }
+
+  /* "image.exe_1234", as the Process object names instances */
+  n = GetModuleFileNameW (NULL, name, PTW32_PERF_NAME_MAX);
+  if (0 == n || n >= PTW32_PERF_NAME_MAX)
+    {
+      n = 0;
+    }
+  name[n] = L'\0';
+  for (p = name; *p != L'\0'; p++)
+    {
+      if (*p == L'\\' || *p == L'/')
+        {
+          base = p + 1;
+        }
+    }
+  (void) _snwprintf (p, 16, L"_%lu", (unsigned long) GetCurrentProcessId ());
+  name[PTW32_PERF_NAME_MAX + 15] = L'\0';
+
+  if (ERROR_SUCCESS != PerfSetCounterSetInfo (ptw32_perfProvider,
+                                              &ptw32_perfTemplate.set,
+                                              sizeof (ptw32_perfTemplate))
+      || NULL == (ptw32_perfInstance = PerfCreateInstance (ptw32_perfProvider,
+                                                           &ptw32_perfCounterSetGuid,
+                                                           base,
+                                                           GetCurrentProcessId ())))
+    {
+      (void) PerfStopProvider (ptw32_perfProvider);
+      ptw32_perfProvider = NULL;
+      return;
+    }
+
+  for (i = 0; i < PTW32_PERF_COUNTERS; i++)
+    {
+      PVOID address = (ptw32_perfCounters[i].stat == PTW32_PERF_REUSE)
+                      ? (PVOID) &ptw32_threadReuseCount
+                      : (PVOID) &ptw32_libStats[ptw32_perfCounters[i].stat];
+
+      (void) PerfSetCounterRefValue (ptw32_perfProvider, ptw32_perfInstance,
+                                     i + 1, address);
+    }
+}
+
+void
+ptw32_perf_unregister (void)
+{
+  if (NULL != ptw32_perfProvider)
+    {
+      if (NULL != ptw32_perfInstance)
+        {
+          (void) PerfDeleteInstance (ptw32_perfProvider, ptw32_perfInstance);
+          ptw32_perfInstance = NULL;
+        }
+      (void) PerfStopProvider (ptw32_perfProvider);
+      ptw32_perfProvider = NULL;
+    }
+}
+
+#endif /* PTW32_PERFCOUNTERS */
@@ -0,0 +1,744 @@
+/*
+ * ptw32_pool.c
+ *
+ * Description:
+ * This translation unit implements thread pool primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * Thread pools, created with pthread_pool_create_np().
+ *
+ * Each worker owns a work-stealing deque of tasks (ptw32_wsdeque.c).
+ * A task submitted by a worker goes on that worker's deque; one
+ * submitted from outside the pool goes on the pool's submitted list,
+ * guarded by an MCS lock, since only a deque's owner may push to it.
+ * A worker runs the newest task on its own deque first, then the
+ * oldest submitted task, and otherwise steals the oldest task from
+ * another worker's deque, so workers mostly touch only their own
+ * deque and take no lock to do so.
+ *
+ * A worker that finds nothing to do counts itself idle in nIdle,
+ * looks once more and then blocks on the wake semaphore. Submitters
+ * take one idle worker off nIdle and post the semaphore for it, so a
+ * busy pool never makes a kernel call to submit.
+ *
+ * Workers are ordinary POSIX threads: tasks can use TSD, cleanup
+ * handlers and cancellation. Values of task keys (PTHREAD_KEY_TASK_NP)
+ * last only as long as the task that set them. A task that cancels or exits its worker
+ * completes with PTHREAD_CANCELED and a replacement worker is
+ * started on the same deque.
+ *
+ * Every blocking wait in the library is bracketed by ptw32_wait_begin
+ * and ptw32_wait_end, which count a worker's waits in nBlocked. When
+ * every worker is blocked and tasks are queued, a spare worker is
+ * started to run them, up to PTW32_POOL_SPARES_MAX at a time. A spare
+ * has a deque of its own that nobody steals from, and retires as soon
+ * as it finds nothing to do or more workers are running than the
+ * pool was created with, so the pool keeps its size in running
+ * threads rather than in threads.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+typedef struct
+{
+  ptw32_pool_worker_t * w;
+  pthread_pool_task_np_t task;
+} ptw32_pool_run_t;
+
+static void
+ptw32_pool_complete (pthread_pool_task_np_t task, void * result)
+{
+  pthread_pool_np_t pool = task->pool;
+
+  if (task->detached)
+    {
+      ptw32_object_free (task);
+    }
+  else
+    {
+      /* The waiter may free the task as soon as done is set */
+      task->result = result;
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) &task->done,
+                                            (PTW32_INTERLOCKED_LONG) 1);
+    }
+
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->outstanding);
+
+  if (0 != PTW32_INTERLOCKED_EXCHANGE_ADD_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->nWaiting,
+                                               (PTW32_INTERLOCKED_LONG) 0))
+    {
+      (void) pthread_mutex_lock (&pool->lock);
+      (void) pthread_cond_broadcast (&pool->changed);
+      (void) pthread_mutex_unlock (&pool->lock);
+    }
+}
+
+static void
+ptw32_pool_retire (ptw32_pool_worker_t * w)
+{
+  /*
+   * A spare worker is leaving; nobody else knows its deque, which
+   * is empty. pthread_pool_destroy_np waits for nSpares to drop to
+   * zero under the pool lock before it frees the pool.
+   */
+  pthread_pool_np_t pool = w->pool;
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+
+  (void) pthread_setspecific (pool->selfKey, NULL);
+  sp->pool = NULL;
+  ptw32_wsdeque_free (&w->deque);
+  free (w);
+
+  (void) pthread_mutex_lock (&pool->lock);
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->nSpares);
+  (void) pthread_cond_broadcast (&pool->changed);
+  (void) pthread_mutex_unlock (&pool->lock);
+}
+
+static void
+ptw32_pool_compensate (pthread_pool_np_t pool)
+{
+  ptw32_pool_worker_t * w;
+  LONG spares;
+
+  /*
+   * One spare at a time: starting a thread may itself block, and
+   * the workers counted blocked may just be on their way out.
+   */
+  if (pool->shutdown
+      || (spares = pool->nSpares) >= PTW32_POOL_SPARES_MAX
+      || pool->nBlocked < pool->nWorkers + spares
+      || !ptw32_pool_has_tasks (pool)
+      || 0 != PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->spawning,
+                                                      (PTW32_INTERLOCKED_LONG) 1,
+                                                      (PTW32_INTERLOCKED_LONG) 0))
+    {
+      return;
+    }
+
+  if (NULL != (w = (ptw32_pool_worker_t *) calloc (1, sizeof (*w))))
+    {
+      w->pool = pool;
+      w->spare = PTW32_TRUE;
+
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->nSpares);
+
+      if (0 != ptw32_wsdeque_init (&w->deque)
+          || 0 != pthread_create (&w->thread, &pool->attr, ptw32_pool_worker, w))
+        {
+          ptw32_wsdeque_free (&w->deque);
+          free (w);
+          (void) PTW32_INTERLOCKED_DECREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->nSpares);
+        }
+      else
+        {
+          (void) pthread_detach (w->thread);
+        }
+    }
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->spawning,
+                                        (PTW32_INTERLOCKED_LONG) 0);
+}
+
+static void PTW32_CDECL
+ptw32_pool_lost (void * arg)
+{
+  /*
+   * The task cancelled or exited the worker thread.
+   */
+  ptw32_pool_run_t * r = (ptw32_pool_run_t *) arg;
+  ptw32_pool_worker_t * w = r->w;
+  pthread_pool_np_t pool = w->pool;
+
+  ptw32_pool_complete (r->task, PTHREAD_CANCELED);
+
+  if (1 == w->depth)
+    {
+      /* The worker's thread is going, and its token with it */
+      ptw32_cputoken_drop ((ptw32_thread_t *) pthread_self ().p, PTW32_CPUTOKEN_NONE);
+    }
+
+  /*
+   * Only the outermost task on the worker's stack replaces it.
+   * The pool lock orders this with pthread_pool_destroy_np, which
+   * joins w->thread once shutdown is set. A spare just retires.
+   */
+  if (0 == --w->depth && w->spare)
+    {
+      ptw32_pool_retire (w);
+    }
+  else if (0 == w->depth)
+    {
+      (void) pthread_mutex_lock (&pool->lock);
+
+      if (!pool->shutdown)
+        {
+          pthread_t t;
+
+          if (0 == pthread_create (&t, &pool->attr, ptw32_pool_worker, w))
+            {
+              (void) pthread_detach (w->thread);
+              w->thread = t;
+            }
+        }
+
+      (void) pthread_mutex_unlock (&pool->lock);
+    }
+}
+
+static void
+ptw32_pool_unidle (pthread_pool_np_t pool)
+{
+  LONG n;
+
+  /*
+   * Take ourselves off nIdle unless a submitter already has, in
+   * which case the semaphore is left with a count we won't consume.
+   * That only costs some other worker a spurious wake up.
+   */
+  while ((n = pool->nIdle) > 0)
+    {
+      if ((LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                   (PTW32_INTERLOCKED_LONGPTR) &pool->nIdle,
+                   (PTW32_INTERLOCKED_LONG) (n - 1),
+                   (PTW32_INTERLOCKED_LONG) n) == n)
+        {
+          break;
+        }
+    }
+}
+
+void
+ptw32_pool_wake (pthread_pool_np_t pool)
+{
+  LONG n;
+
+  while ((n = (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
+                        (PTW32_INTERLOCKED_LONGPTR) &pool->nIdle,
+                        (PTW32_INTERLOCKED_LONG) 0)) > 0)
+    {
+      if ((LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                   (PTW32_INTERLOCKED_LONGPTR) &pool->nIdle,
+                   (PTW32_INTERLOCKED_LONG) (n - 1),
+                   (PTW32_INTERLOCKED_LONG) n) == n)
+        {
+          (void) PTW32_RELEASESEMAPHORE (pool->wake, 1, NULL);
+          return;
+        }
+    }
+
+  /* Nobody idle: perhaps every worker is blocked */
+  ptw32_pool_compensate (pool);
+}
+
+void
+ptw32_pool_block (pthread_pool_np_t pool)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Counts one of the pool's workers into a blocking
+      *      wait (see ptw32_wait_begin), starting a spare worker
+      *      if that leaves none to run the queued tasks.
+      *
+      * ------------------------------------------------------
+      */
+{
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->nBlocked);
+
+  ptw32_pool_compensate (pool);
+}
+
+void
+ptw32_pool_unblock (pthread_pool_np_t pool)
+{
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->nBlocked);
+}
+
+int
+ptw32_pool_push (pthread_pool_np_t pool, ptw32_pool_worker_t * w,
+                 pthread_pool_task_np_t task)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Pushes task on the owner's end of w's deque, or on
+      *      the submitted list if w is NULL because the caller
+      *      isn't one of the pool's workers.
+      *
+      * RESULTS
+      *              0               the task was queued,
+      *              ENOMEM          the deque couldn't grow.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+
+  if (w != NULL)
+    {
+      return ptw32_wsdeque_push (&w->deque, task);
+    }
+
+  task->next = NULL;
+
+  ptw32_mcs_lock_acquire (&pool->submittedLock, &node);
+
+  if (pool->submitted == NULL)
+    {
+      pool->submitted = task;
+    }
+  else
+    {
+      pool->submittedTail->next = task;
+    }
+
+  pool->submittedTail = task;
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->nSubmitted);
+
+  ptw32_mcs_lock_release (&node);
+
+  return 0;
+}
+
+pthread_pool_task_np_t
+ptw32_pool_get (pthread_pool_np_t pool, ptw32_pool_worker_t * w)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Takes the newest task from w's own deque or, failing
+      *      that, the oldest submitted task or the oldest task
+      *      stolen from another worker's deque.
+      *
+      * RESULTS
+      *              the task, or NULL if every deque was empty.
+      *
+      * ------------------------------------------------------
+      */
+{
+  void * task;
+  ptw32_mcs_local_node_t node;
+  int start = w->spare ? 0 : (int) (w - pool->workers) + 1;
+  int victims = w->spare ? pool->nWorkers : pool->nWorkers - 1;
+  int i;
+
+  if (0 == ptw32_wsdeque_pop (&w->deque, &task))
+    {
+      return (pthread_pool_task_np_t) task;
+    }
+
+  if (pool->nSubmitted > 0)
+    {
+      pthread_pool_task_np_t t = NULL;
+
+      ptw32_mcs_lock_acquire (&pool->submittedLock, &node);
+
+      if ((t = pool->submitted) != NULL)
+        {
+          pool->submitted = t->next;
+          (void) PTW32_INTERLOCKED_DECREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->nSubmitted);
+        }
+
+      ptw32_mcs_lock_release (&node);
+
+      if (t != NULL)
+        {
+          return t;
+        }
+    }
+
+  for (i = 0; i < victims; i++)
+    {
+      ptw32_pool_worker_t * v = &pool->workers[(start + i) % pool->nWorkers];
+      int result;
+
+      /* Losing a race for a task means the deque may hold more */
+      while (EBUSY == (result = ptw32_wsdeque_steal (&v->deque, &task)))
+        {
+          PTW32_YIELD_PROCESSOR ();
+        }
+
+      if (0 == result)
+        {
+          return (pthread_pool_task_np_t) task;
+        }
+    }
+
+  return NULL;
+}
+
+int
+ptw32_pool_has_tasks (pthread_pool_np_t pool)
+{
+  int i;
+
+  if (pool->nSubmitted > 0)
+    {
+      return PTW32_TRUE;
+    }
+
+  for (i = 0; i < pool->nWorkers; i++)
+    {
+      if (!ptw32_wsdeque_empty (&pool->workers[i].deque))
+        {
+          return PTW32_TRUE;
+        }
+    }
+
+  return PTW32_FALSE;
+}
+
+void
+ptw32_pool_run (ptw32_pool_worker_t * w, pthread_pool_task_np_t task)
+{
+  ptw32_pool_run_t r;
+  void * result;
+
+  r.w = w;
+  r.task = task;
+  w->depth++;
+
+  pthread_cleanup_push (ptw32_pool_lost, &r);
+
+  result = (*task->routine) (task->arg);
+
+  pthread_cleanup_pop (0);
+
+  w->depth--;
+
+  /*
+   * The next task starts with its task keys NULL. Tasks run while
+   * a task waits for another share its task keys.
+   */
+  if (0 == w->depth)
+    {
+      ptw32_tsd_task_end ();
+    }
+
+  ptw32_pool_complete (task, result);
+}
+
+void PTW32_CDECL
+ptw32_pool_wait_cleanup (void * arg)
+{
+  pthread_pool_np_t pool = (pthread_pool_np_t) arg;
+
+  (void) pthread_mutex_unlock (&pool->lock);
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->nWaiting);
+}
+
+void * PTW32_CDECL
+ptw32_pool_worker (void * arg)
+{
+  ptw32_pool_worker_t * w = (ptw32_pool_worker_t *) arg;
+  pthread_pool_np_t pool = w->pool;
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+
+  (void) pthread_setspecific (pool->selfKey, w);
+  sp->pool = pool;
+
+  for (;;)
+    {
+      pthread_pool_task_np_t task;
+
+      /* A spare retires once the workers it stood in for are back */
+      if (w->spare && pool->nSpares > pool->nBlocked
+          && ptw32_wsdeque_empty (&w->deque))
+        {
+          break;
+        }
+
+      if ((task = ptw32_pool_get (pool, w)) != NULL)
+        {
+          ptw32_cputoken_hold (sp);
+          ptw32_pool_run (w, task);
+          continue;
+        }
+
+      /* Idle: let another thread run in our place */
+      ptw32_cputoken_drop (sp, PTW32_CPUTOKEN_NONE);
+
+      /*
+       * Queued tasks are still run after shutdown is set.
+       */
+      if (pool->shutdown || w->spare)
+        {
+          break;
+        }
+
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &pool->nIdle);
+
+      /*
+       * Look again now that submitters can see us: a task pushed
+       * before the increment was missed above, and its submitter
+       * may not have seen us idle.
+       */
+      if (pool->shutdown || ptw32_pool_has_tasks (pool))
+        {
+          ptw32_pool_unidle (pool);
+          continue;
+        }
+
+      PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_OTHER);
+      (void) WaitForSingleObject (pool->wake, INFINITE);
+    }
+
+  ptw32_cputoken_drop (sp, PTW32_CPUTOKEN_NONE);
+
+  if (w->spare)
+    {
+      ptw32_pool_retire (w);
+    }
+  else
+    {
+      sp->pool = NULL;
+    }
+
+  return NULL;
+}
+
+void
+ptw32_pool_free (pthread_pool_np_t pool)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Frees a pool whose workers have all exited, or a
+      *      partly built one. Members that were never set up are
+      *      still zero.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (pool->workers != NULL)
+    {
+      int i;
+
+      for (i = 0; i < pool->nWorkers; i++)
+        {
+          ptw32_wsdeque_free (&pool->workers[i].deque);
+        }
+
+      free (pool->workers);
+    }
+
+  if (pool->selfKey != NULL)
+    {
+      (void) pthread_key_delete (pool->selfKey);
+    }
+
+  if (pool->attr != NULL)
+    {
+      (void) pthread_attr_destroy (&pool->attr);
+    }
+
+  if (pool->wake != NULL)
+    {
+      (void) ptw32_closehandle (pool->wake, PTW32_LIBSTAT_SEMAPHORES);
+    }
+
+  if (pool->lock != NULL)
+    {
+      (void) pthread_mutex_destroy (&pool->lock);
+    }
+
+  if (pool->changed != NULL)
+    {
+      (void) pthread_cond_destroy (&pool->changed);
+    }
+
+  free (pool);
+}
+
+static void * PTW32_CDECL
+ptw32_pool_loop_run (void * arg)
+{
+  /*
+   * Runs chunks until there are none left; a helper task's result
+   * is its part of a reduction.
+   */
+  ptw32_pool_loop_t * loop = (ptw32_pool_loop_t *) arg;
+  void * value = loop->identity;
+  LONG i;
+
+  while ((i = (LONG) PTW32_INTERLOCKED_INCREMENT_LONG((PTW32_INTERLOCKED_LONGPTR) &loop->next) - 1)
+         < loop->nChunks)
+    {
+      long b = (long) ((unsigned long) loop->begin + (unsigned long) i * (unsigned long) loop->grain);
+      long e = (i == loop->nChunks - 1) ? loop->end : b + loop->grain;
+
+      if (loop->forRoutine != NULL)
+        {
+          (*loop->forRoutine) (b, e, loop->arg);
+        }
+      else
+        {
+          value = (*loop->reduceRoutine) (b, e, value, loop->arg);
+        }
+    }
+
+  return value;
+}
+
+static void PTW32_CDECL
+ptw32_pool_loop_cleanup (void * arg)
+{
+  /*
+   * The caller was cancelled in a chunk: the loop is on its stack,
+   * so stop handing out chunks and wait for the helpers.
+   */
+  ptw32_pool_loop_t * loop = (ptw32_pool_loop_t *) arg;
+  int i;
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) &loop->next,
+                                        (PTW32_INTERLOCKED_LONG) loop->nChunks);
+
+  for (i = 0; i < loop->nHelpers; i++)
+    {
+      (void) pthread_pool_task_wait_np (loop->helpers[i], NULL);
+    }
+
+  ptw32_object_free (loop->helpers);
+}
+
+int
+ptw32_pool_loop (pthread_pool_np_t pool, ptw32_pool_loop_t * loop,
+                 void * (PTW32_CDECL *combine) (void *, void *, void *),
+                 void ** value_ptr)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Runs a parallel loop whose range, grain, routine and
+      *      argument the caller has set. The range is cut into
+      *      chunks of 'grain' iterations. A helper task for each
+      *      worker, up to one less than the number of chunks, is
+      *      submitted to the pool and the caller joins in: each
+      *      takes the next chunk until none are left, so faster
+      *      participants run more of them. The helpers' parts of
+      *      a reduction are combined with the caller's in
+      *      submission order.
+      *
+      * RESULTS
+      *              0               every chunk has run,
+      *              EINTR           a helper's worker was cancelled
+      *                              or exited in a chunk, which is
+      *                              lost with its part of a
+      *                              reduction.
+      *
+      * ------------------------------------------------------
+      */
+{
+  unsigned long range = (unsigned long) loop->end - (unsigned long) loop->begin;
+  unsigned long grain;
+  void * value;
+  void * part;
+  int result = 0;
+  int i;
+
+  if (loop->grain > 0)
+    {
+      grain = (unsigned long) loop->grain;
+    }
+  else
+    {
+      grain = range / ((unsigned long) (pool->nWorkers + 1) * PTW32_POOL_LOOP_CHUNKS);
+    }
+
+  /* Keep the chunk count a LONG however small the grain */
+  if (grain == 0 || range / grain >= (unsigned long) (LONG_MAX / 2))
+    {
+      grain = PTW32_MAX (1, range / (LONG_MAX / 2) + 1);
+    }
+
+  loop->grain = (long) grain;
+  loop->nChunks = (LONG) (range / grain + (range % grain != 0));
+  loop->next = 0;
+  loop->nHelpers = PTW32_MIN (pool->nWorkers, (int) loop->nChunks - 1);
+  loop->helpers = NULL;
+
+  if (loop->nHelpers > 0
+      && NULL == (loop->helpers = (pthread_pool_task_np_t *)
+                    ptw32_object_alloc (loop->nHelpers * sizeof (*loop->helpers), 0)))
+    {
+      loop->nHelpers = 0;
+    }
+
+  /* Fewer helpers only make the loop slower */
+  for (i = 0; i < loop->nHelpers; i++)
+    {
+      if (0 != pthread_pool_submit_np (pool, ptw32_pool_loop_run, loop, &loop->helpers[i]))
+        {
+          break;
+        }
+    }
+
+  loop->nHelpers = i;
+
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth(0)
+#endif
+  pthread_cleanup_push (ptw32_pool_loop_cleanup, loop);
+
+  value = ptw32_pool_loop_run (loop);
+
+  pthread_cleanup_pop (0);
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth()
+#endif
+
+  /*
+   * A worker waiting for its helpers runs tasks meanwhile, the
+   * helpers included, so a loop in a pool task can't deadlock.
+   */
+  for (i = 0; i < loop->nHelpers; i++)
+    {
+      (void) pthread_pool_task_wait_np (loop->helpers[i], &part);
+
+      if (part == PTHREAD_CANCELED)
+        {
+          result = EINTR;
+        }
+      else if (combine != NULL)
+        {
+          value = (*combine) (value, part, loop->arg);
+        }
+    }
+
+  ptw32_object_free (loop->helpers);
+
+  if (value_ptr != NULL)
+    {
+      *value_ptr = value;
+    }
+
+  return result;
+}
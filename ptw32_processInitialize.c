@@ -78,13 +78,55 @@ ptw32_processInitialize (void)
    */
   ptw32_threadReuseTop = PTW32_THREAD_REUSE_EMPTY;
   ptw32_threadReuseBottom = PTW32_THREAD_REUSE_EMPTY;
+  {
+    int i;
+
+    ptw32_threadReuseQueue.enqueuePos = 0;
+    ptw32_threadReuseQueue.dequeuePos = 0;
+
+    for (i = 0; i < PTW32_THREAD_REUSE_RING_SIZE; i++)
+      {
+        ptw32_threadReuseQueue.cells[i].seq = i;
+        ptw32_threadReuseQueue.cells[i].tp = NULL;
+      }
+
+    for (i = 0; i < PTW32_THREAD_REUSE_CPUS; i++)
+      {
+        ptw32_threadReuseCpus[i].lock = 0;
+        ptw32_threadReuseCpus[i].count = 0;
+        ptw32_threadReuseCpus[i].first = 0;
+      }
+  }
+  ptw32_threadReuseCount = 0;
+  ptw32_threadReuseMax = -1;
+  ptw32_threadCache = NULL;
+  ptw32_threadCacheCount = 0;
+  ptw32_threadCacheMax = 0;
   ptw32_selfThreadKey = NULL;
-  ptw32_cleanupKey = NULL;
-  ptw32_cond_list_head = NULL;
-  ptw32_cond_list_tail = NULL;
+  {
+    int i;
+
+    /*
+     * Condition variable list shards. The list exists to wake up CVs
+     * when a WM_TIMECHANGE message arrives. See
+     * pthread_timechange_handler_np.c.
+     */
+    for (i = 0; i < PTW32_COND_LIST_SHARDS; i++)
+      {
+        ptw32_cond_list[i].lock = 0;
+        ptw32_cond_list[i].head = NULL;
+        ptw32_cond_list[i].tail = NULL;
+      }
+  }
 
   ptw32_concurrency = 0;
 
+  /*
+   * Spin budgets for this processor. MCS lock and barrier waiters only
+   * spin if another processor can release them.
+   */
+  ptw32_spin_calibrate ();
+
   /* What features have been auto-detected */
   ptw32_features = 0;
 
@@ -99,42 +141,14 @@ ptw32_processInitialize (void)
    * blocked threads.
    */
   ptw32_register_cancellation = NULL;
+  ptw32_queueuserapc2 = NULL;
+  ptw32_cancelInitialized = PTW32_FALSE;
 
   /*
    * Global lock for managing pthread_t struct reuse.
    */
   ptw32_thread_reuse_lock = 0;
 
-  /*
-   * Global lock for testing internal state of statically declared mutexes.
-   */
-  ptw32_mutex_test_init_lock = 0;
-
-  /*
-   * Global lock for testing internal state of PTHREAD_COND_INITIALIZER
-   * created condition variables.
-   */
-  ptw32_cond_test_init_lock = 0;
-
-  /*
-   * Global lock for testing internal state of PTHREAD_RWLOCK_INITIALIZER
-   * created read/write locks.
-   */
-  ptw32_rwlock_test_init_lock = 0;
-
-  /*
-   * Global lock for testing internal state of PTHREAD_SPINLOCK_INITIALIZER
-   * created spin locks.
-   */
-  ptw32_spinlock_test_init_lock = 0;
-
-  /*
-   * Global lock for condition variable linked list. The list exists
-   * to wake up CVs when a WM_TIMECHANGE message arrives. See
-   * w32_TimeChangeHandler.c.
-   */
-  ptw32_cond_list_lock = 0;
-
   #if defined(_UWIN)
   /*
    * Keep a count of the number of threads.
@@ -147,12 +161,33 @@ ptw32_processInitialize (void)
   /*
    * Initialize Keys
    */
-  if ((pthread_key_create (&ptw32_selfThreadKey, NULL) != 0) ||
-      (pthread_key_create (&ptw32_cleanupKey, NULL) != 0))
+  if (pthread_key_create (&ptw32_selfThreadKey, NULL) != 0)
     {
 
       ptw32_processTerminate ();
     }
+  else
+    {
+      /*
+       * Reserve the index of the per-thread TSD tables now, while
+       * indexes are available. Without it, pthread_key_create fails
+       * once Win32 runs out, as it always did.
+       */
+      ptw32_tsdTableIndex = TlsAlloc ();
+
+#if defined(PTW32_ETW)
+      ptw32_etw_register ();
+#endif
+
+#if defined(PTW32_PERFCOUNTERS)
+      ptw32_perf_register ();
+#endif
+
+      /*
+       * Tunables given by the environment (see pthread_setparam_np.c).
+       */
+      ptw32_param_environment ();
+    }
 
   return (ptw32_processInitialized);
 
@@ -56,16 +56,42 @@ ptw32_processTerminate (void)
       *      This routine sets the global variable
       *      ptw32_processInitialized to FALSE
       *
+      *      In fast exit mode (pthread_win32_set_fast_exit_np) it
+      *      only releases process shared objects.
+      *
       * RESULTS
       *              N/A
       *
       * ------------------------------------------------------
       */
 {
-  if (ptw32_processInitialized)
+  if (ptw32_processInitialized && ptw32_fastExit)
+    {
+      /*
+       * Leave everything the OS reclaims at exit, but not references
+       * to objects other processes can still see.
+       */
+      ptw32_pshared_terminate ();
+      ptw32_processInitialized = PTW32_FALSE;
+    }
+  else if (ptw32_processInitialized)
     {
-      ptw32_thread_t * tp, * tpNext;
-      ptw32_mcs_local_node_t node;
+#if defined(PTW32_STATIC_LIB)
+      /*
+       * End the parked OS threads. If the dll is being unloaded they
+       * would wake into unmapped code, so there they are left parked.
+       */
+      ptw32_threadCacheMax = 0;
+      ptw32_threadCacheTrim (0);
+#endif
+
+#if defined(PTW32_ETW)
+      ptw32_etw_unregister ();
+#endif
+
+#if defined(PTW32_PERFCOUNTERS)
+      ptw32_perf_unregister ();
+#endif
 
       if (ptw32_selfThreadKey != NULL)
 	{
@@ -77,27 +103,72 @@ ptw32_processTerminate (void)
 	  ptw32_selfThreadKey = NULL;
 	}
 
-      if (ptw32_cleanupKey != NULL)
+      while (ptw32_tsdNumRetired > 0)
 	{
-	  /*
-	   * Release ptw32_cleanupKey
-	   */
-	  pthread_key_delete (ptw32_cleanupKey);
+	  TlsFree (ptw32_tsdRetired[--ptw32_tsdNumRetired]);
+	}
+
+      if (ptw32_tsdTableIndex != TLS_OUT_OF_INDEXES)
+	{
+	  TlsFree (ptw32_tsdTableIndex);
+	  ptw32_tsdTableIndex = TLS_OUT_OF_INDEXES;
+	}
+
+      if (ptw32_topology != NULL)
+	{
+	  free (ptw32_topology);
+	  ptw32_topology = NULL;
+	}
 
-	  ptw32_cleanupKey = NULL;
+      ptw32_pshared_terminate ();
+
+      while (ptw32_rcuReaders != NULL)
+	{
+	  ptw32_rcu_reader_t * r = ptw32_rcuReaders;
+
+	  ptw32_rcuReaders = r->next;
+	  ptw32_object_free (r);
 	}
 
-      ptw32_mcs_lock_acquire(&ptw32_thread_reuse_lock, &node);
+      while (ptw32_hazardRecords != NULL)
+	{
+	  ptw32_hazard_record_t * h = ptw32_hazardRecords;
+
+	  ptw32_hazardRecords = h->next;
+	  free (h->retired);
+	  ptw32_object_free (h);
+	}
+      ptw32_hazardRecordCount = 0;
 
-      tp = ptw32_threadReuseTop;
-      while (tp != PTW32_THREAD_REUSE_EMPTY)
+      while (ptw32_waitgraphRecords != NULL)
 	{
-	  tpNext = tp->prevReuse;
-	  free (tp);
-	  tp = tpNext;
+	  ptw32_waitgraph_record_t * w = ptw32_waitgraphRecords;
+
+	  ptw32_waitgraphRecords = w->next;
+	  ptw32_object_free (w);
+	}
+
+      while (ptw32_flightRecs != NULL)
+	{
+	  ptw32_flightrec_t * f = ptw32_flightRecs;
+
+	  ptw32_flightRecs = f->link;
+	  ptw32_object_free (f);
+	}
+
+      while (ptw32_histRecords != NULL)
+	{
+	  ptw32_hist_record_t * r = ptw32_histRecords;
+
+	  ptw32_histRecords = r->next;
+	  ptw32_object_free (r);
 	}
 
-      ptw32_mcs_lock_release(&node);
+      /*
+       * Drains the reuse ring, its overflow list and the processors'
+       * FIFOs, which ptw32_threadReusePop may leave partly full.
+       */
+      ptw32_threadReuseTrim (0);
 
       ptw32_processInitialized = PTW32_FALSE;
     }
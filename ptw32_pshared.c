@@ -0,0 +1,405 @@
+/*
+ * ptw32_pshared.c
+ *
+ * Description:
+ * This translation unit implements process shared object storage.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * How it works:
+ * A process shared object has to work wherever the application puts
+ * it, typically in a file mapping that each process maps at a
+ * different address, so it can't hold a pointer. Instead its state
+ * lives in a slot of an arena, a named page file backed mapping that
+ * every process opens by name, and the object holds the slot's id
+ * (see PTW32_PSHARED_HANDLE). Each process maps an arena the first
+ * time it meets an id in it.
+ *
+ * The fast paths use interlocked operations on the slot, as the
+ * process private objects do on their structs. Only a thread that has
+ * to block touches a kernel object, an event or semaphore named after
+ * the id and opened on first use, so the objects need no set up in
+ * the processes that didn't create them.
+ *
+ * Ids come from a counter in slot 0 of arena 0 and are never reused,
+ * so a kernel object name never refers to two objects. The mappings
+ * and kernel objects are in the session namespace and go away with the
+ * last process that has them open.
+ */
+
+static void
+ptw32_pshared_name (char * buf, const char * prefix, unsigned long n, int suffix)
+{
+  static const char hex[] = "0123456789abcdef";
+  int i;
+
+  while (*prefix != '\0')
+    {
+      *buf++ = *prefix++;
+    }
+
+  for (i = 28; i >= 0; i -= 4)
+    {
+      *buf++ = hex[(n >> i) & 0xf];
+    }
+
+  if (suffix >= 0)
+    {
+      *buf++ = '-';
+      *buf++ = (char) ('0' + suffix);
+    }
+
+  *buf = '\0';
+}
+
+
+/*
+ * Returns this process's view of arena 'a', mapping it (and creating
+ * it if no process has yet) on first use, or NULL if it can't be
+ * mapped.
+ */
+static ptw32_pshared_arena_t *
+ptw32_pshared_arena (LONG a)
+{
+  ptw32_pshared_arena_t * arena;
+  ptw32_mcs_local_node_t node;
+  char name[48];
+
+  arena = (ptw32_pshared_arena_t *)(PTW32_INTERLOCKED_SIZE)PTW32_INTERLOCKED_EXCHANGE_ADD_SIZE(
+                                      (PTW32_INTERLOCKED_SIZEPTR)&ptw32_psharedArenas[a],
+                                      (PTW32_INTERLOCKED_SIZE)0); /* MBR fence */
+
+  if (NULL != arena)
+    {
+      return arena;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_pshared_lock, &node);
+
+  if (NULL == (arena = ptw32_psharedArenas[a])
+      && NULL != (arena = (ptw32_pshared_arena_t *) calloc (1, sizeof (*arena))))
+    {
+      ptw32_pshared_name (name, "Local\\ptw32-pshared-arena-", (unsigned long) a, -1);
+
+      /*
+       * Opens the arena if another process created it. A new one is
+       * zero filled.
+       */
+      arena->mapping = CreateFileMapping (INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0,
+                                          PTW32_PSHARED_SLOTS * sizeof (ptw32_pshared_slot_t),
+                                          name);
+
+      if (NULL == arena->mapping
+          || NULL == (arena->slots = (ptw32_pshared_slot_t *)
+                                     MapViewOfFile (arena->mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0)))
+        {
+          if (NULL != arena->mapping)
+            {
+              (void) CloseHandle (arena->mapping);
+            }
+          free (arena);
+          arena = NULL;
+        }
+      else
+        {
+          (void) PTW32_INTERLOCKED_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR)&ptw32_psharedArenas[a],
+                                                 (PTW32_INTERLOCKED_PVOID)arena);
+        }
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return arena;
+}
+
+
+int
+ptw32_pshared_alloc (void ** handle, ptw32_pshared_slot_t ** slot)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Allocates a slot for a new process shared object.
+      *      The caller initialises the slot and then publishes
+      *      its type in s.type with an interlocked exchange.
+      *
+      * RESULTS
+      *              0               *handle and *slot are set,
+      *              ENOMEM          an arena could not be mapped,
+      *              EAGAIN          the ids are exhausted.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pshared_arena_t * arena;
+  LONG id;
+
+  if (NULL == (arena = ptw32_pshared_arena (0)))
+    {
+      return ENOMEM;
+    }
+
+  id = (LONG) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &arena->slots[0].s.u.dir.nextId);
+
+  if (id <= 0 || id >= PTW32_PSHARED_ARENAS * PTW32_PSHARED_SLOTS)
+    {
+      return EAGAIN;
+    }
+
+  if (NULL == (arena = ptw32_pshared_arena (id / PTW32_PSHARED_SLOTS)))
+    {
+      return ENOMEM;
+    }
+
+  *slot = &arena->slots[id % PTW32_PSHARED_SLOTS];
+  *handle = PTW32_PSHARED_HANDLE (id);
+
+  return 0;
+}
+
+
+ptw32_pshared_slot_t *
+ptw32_pshared_get (void * handle, LONG type)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns the slot of the process shared object
+      *      'handle', or NULL if it isn't a live object of 'type'.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pshared_arena_t * arena;
+  ptw32_pshared_slot_t * slot;
+  LONG id = PTW32_PSHARED_ID (handle);
+
+  if (id <= 0 || NULL == (arena = ptw32_pshared_arena (id / PTW32_PSHARED_SLOTS)))
+    {
+      return NULL;
+    }
+
+  slot = &arena->slots[id % PTW32_PSHARED_SLOTS];
+
+  return (type == (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.type,
+                                                              (PTW32_INTERLOCKED_LONG) 0))
+         ? slot : NULL;
+}
+
+
+HANDLE
+ptw32_pshared_kernel (void * handle, int n)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns this process's handle to kernel object 'n'
+      *      (0 or 1) of the process shared object 'handle',
+      *      opening it, or creating it if no process has yet, on
+      *      first use. Mutexes wait on an auto-reset event, the
+      *      other types on semaphores. The caller must have got
+      *      the object's slot from ptw32_pshared_get().
+      *
+      *      Returns NULL if the kernel object can't be opened.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG id = PTW32_PSHARED_ID (handle);
+  ptw32_pshared_arena_t * arena = ptw32_psharedArenas[id / PTW32_PSHARED_SLOTS];
+  HANDLE * hp = &arena->kernel[id % PTW32_PSHARED_SLOTS][n];
+  HANDLE h = (HANDLE)(PTW32_INTERLOCKED_SIZE)PTW32_INTERLOCKED_EXCHANGE_ADD_SIZE(
+                                               (PTW32_INTERLOCKED_SIZEPTR)hp,
+                                               (PTW32_INTERLOCKED_SIZE)0); /* MBR fence */
+
+  if (NULL == h)
+    {
+      HANDLE nh;
+      char name[48];
+
+      ptw32_pshared_name (name, "Local\\ptw32-pshared-", (unsigned long) id, n);
+
+      if (PTW32_PSHARED_MUTEX == arena->slots[id % PTW32_PSHARED_SLOTS].s.type)
+        {
+          nh = CreateEvent (NULL, PTW32_FALSE, PTW32_FALSE, name);
+        }
+      else
+        {
+          nh = CreateSemaphore (NULL, 0, (long) SEM_VALUE_MAX, name);
+        }
+
+      if (NULL != nh)
+        {
+          h = (HANDLE)(PTW32_INTERLOCKED_SIZE)PTW32_INTERLOCKED_COMPARE_EXCHANGE_SIZE(
+                                                (PTW32_INTERLOCKED_SIZEPTR)hp,
+                                                (PTW32_INTERLOCKED_SIZE)nh,
+                                                (PTW32_INTERLOCKED_SIZE)0);
+          if (NULL == h)
+            {
+              h = nh;
+            }
+          else
+            {
+              /* another thread got there first */
+              (void) CloseHandle (nh);
+            }
+        }
+    }
+
+  return h;
+}
+
+
+int
+ptw32_pshared_unwait (LONG * value, HANDLE h)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      As ptw32_sem_unwait() for a process shared object
+      *      whose waiters are counted in the negative '*value'
+      *      and block on 'h'.
+      *
+      * RESULTS
+      *              1               the thread took its token,
+      *              0               the thread was withdrawn.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG v;
+
+  do
+    {
+      v = *((LONG volatile *) value);
+      if (v >= 0)
+	{
+	  PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_OTHER);
+	  (void) WaitForSingleObject (h, INFINITE);
+	  return 1;
+	}
+    }
+  while ((PTW32_INTERLOCKED_LONG) v !=
+	 PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) value,
+						  (PTW32_INTERLOCKED_LONG) (v + 1),
+						  (PTW32_INTERLOCKED_LONG) v));
+
+  return 0;
+}
+
+
+void
+ptw32_pshared_free (void * handle)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Frees the slot of a destroyed process shared object
+      *      and closes this process's handles to its kernel
+      *      objects. Other processes close theirs when they
+      *      detach.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG id = PTW32_PSHARED_ID (handle);
+  ptw32_pshared_arena_t * arena = ptw32_psharedArenas[id / PTW32_PSHARED_SLOTS];
+  int n;
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &arena->slots[id % PTW32_PSHARED_SLOTS].s.type,
+                                          (PTW32_INTERLOCKED_LONG) PTW32_PSHARED_FREE);
+
+  for (n = 0; n < 2; n++)
+    {
+      HANDLE h = (HANDLE) PTW32_INTERLOCKED_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &arena->kernel[id % PTW32_PSHARED_SLOTS][n],
+                                                          (PTW32_INTERLOCKED_PVOID) NULL);
+      if (NULL != h)
+        {
+          (void) CloseHandle (h);
+        }
+    }
+}
+
+
+void
+ptw32_pshared_terminate (void)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Closes the named semaphores this process still has
+      *      open, then unmaps the arenas and closes the kernel
+      *      objects that it has opened.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int a;
+  int i;
+
+  while (NULL != ptw32_namedSems)
+    {
+      ptw32_named_sem_t * ns = ptw32_namedSems;
+
+      ptw32_namedSems = ns->next;
+      ptw32_named_sem_release (ns->sem);
+      (void) UnmapViewOfFile (ns->name);
+      (void) CloseHandle (ns->mapping);
+      free (ns);
+    }
+
+  for (a = 0; a < PTW32_PSHARED_ARENAS; a++)
+    {
+      ptw32_pshared_arena_t * arena = ptw32_psharedArenas[a];
+
+      if (NULL == arena)
+        {
+          continue;
+        }
+
+      for (i = 0; i < PTW32_PSHARED_SLOTS; i++)
+        {
+          if (NULL != arena->kernel[i][0])
+            {
+              (void) CloseHandle (arena->kernel[i][0]);
+            }
+          if (NULL != arena->kernel[i][1])
+            {
+              (void) CloseHandle (arena->kernel[i][1]);
+            }
+        }
+
+      (void) UnmapViewOfFile (arena->slots);
+      (void) CloseHandle (arena->mapping);
+      free (arena);
+      ptw32_psharedArenas[a] = NULL;
+    }
+}
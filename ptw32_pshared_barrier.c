@@ -0,0 +1,198 @@
+/*
+ * ptw32_pshared_barrier.c
+ *
+ * Description:
+ * This translation unit implements process shared barriers.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * A process shared barrier counts down the arrivals of the current
+ * cycle in its slot. The last thread to arrive resets the count, moves
+ * the barrier to the next cycle and releases the others from the
+ * cycle's kernel semaphore. Consecutive cycles use alternate
+ * semaphores so that a thread that is quick to arrive at the next
+ * cycle can't take a token meant for a thread still leaving the last.
+ */
+
+int
+ptw32_pshared_barrier_init (pthread_barrier_t * barrier, unsigned int count)
+{
+  ptw32_pshared_slot_t * slot;
+  void * h;
+  int result;
+
+  if (0 == (result = ptw32_pshared_alloc (&h, &slot)))
+    {
+      slot->s.u.barrier.height = (LONG) count;
+      slot->s.u.barrier.remaining = (LONG) count;
+      slot->s.u.barrier.cycle = 0;
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.type,
+                                              (PTW32_INTERLOCKED_LONG) PTW32_PSHARED_BARRIER);
+      *barrier = (pthread_barrier_t) h;
+    }
+
+  return result;
+}
+
+
+int
+ptw32_pshared_barrier_destroy (pthread_barrier_t * barrier)
+{
+  ptw32_pshared_slot_t * slot;
+
+  if (NULL == (slot = ptw32_pshared_get (*barrier, PTW32_PSHARED_BARRIER)))
+    {
+      return EINVAL;
+    }
+
+  if (*((LONG volatile *) &slot->s.u.barrier.remaining) < slot->s.u.barrier.height)
+    {
+      return EBUSY;
+    }
+
+  ptw32_pshared_free (*barrier);
+  *barrier = (pthread_barrier_t) PTW32_OBJECT_INVALID;
+
+  return 0;
+}
+
+
+int
+ptw32_pshared_barrier_wait (pthread_barrier_t barrier)
+{
+  ptw32_pshared_slot_t * slot;
+  HANDLE sem;
+  LONG cycle;
+
+  if (NULL == (slot = ptw32_pshared_get (barrier, PTW32_PSHARED_BARRIER)))
+    {
+      return EINVAL;
+    }
+
+  /*
+   * The cycle can't move on before we have arrived.
+   */
+  cycle = *((LONG volatile *) &slot->s.u.barrier.cycle);
+
+  if (NULL == (sem = ptw32_pshared_kernel (barrier, (int) (cycle & 1))))
+    {
+      return EINVAL;
+    }
+
+  if (0 == (LONG) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.barrier.remaining))
+    {
+      /*
+       * We are the last thread to arrive at the barrier. No one can
+       * arrive at the next cycle until we release them.
+       */
+      slot->s.u.barrier.remaining = slot->s.u.barrier.height;
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.barrier.cycle);
+
+      if (slot->s.u.barrier.height > 1
+	  && !PTW32_RELEASESEMAPHORE (sem, slot->s.u.barrier.height - 1, NULL))
+	{
+	  return EINVAL;
+	}
+
+      return PTHREAD_BARRIER_SERIAL_THREAD;
+    }
+
+  /*
+   * Not a cancellation point, as the process private barrier.
+   */
+  PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_BARRIER);
+  return (WAIT_OBJECT_0 == ptw32_wait_objects (1, &sem, INFINITE)) ? 0 : EINVAL;
+}
+
+
+/*
+ * The split arrival of pthread_barrier_arrive_np(). The last thread to
+ * arrive releases itself too, so that every split arrival takes its
+ * token in ptw32_pshared_barrier_wait_cycle().
+ */
+int
+ptw32_pshared_barrier_arrive (pthread_barrier_t barrier, LONG * arrivedAt)
+{
+  ptw32_pshared_slot_t * slot;
+  HANDLE sem;
+  LONG cycle;
+
+  if (NULL == (slot = ptw32_pshared_get (barrier, PTW32_PSHARED_BARRIER)))
+    {
+      return EINVAL;
+    }
+
+  cycle = *((LONG volatile *) &slot->s.u.barrier.cycle);
+
+  if (NULL == (sem = ptw32_pshared_kernel (barrier, (int) (cycle & 1))))
+    {
+      return EINVAL;
+    }
+
+  *arrivedAt = cycle;
+
+  if (0 == (LONG) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.barrier.remaining))
+    {
+      slot->s.u.barrier.remaining = slot->s.u.barrier.height;
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.barrier.cycle);
+
+      if (!PTW32_RELEASESEMAPHORE (sem, slot->s.u.barrier.height, NULL))
+	{
+	  return EINVAL;
+	}
+
+      return PTHREAD_BARRIER_SERIAL_THREAD;
+    }
+
+  return 0;
+}
+
+
+int
+ptw32_pshared_barrier_wait_cycle (pthread_barrier_t barrier, LONG cycle)
+{
+  HANDLE sem;
+
+  if (NULL == ptw32_pshared_get (barrier, PTW32_PSHARED_BARRIER)
+      || NULL == (sem = ptw32_pshared_kernel (barrier, (int) (cycle & 1))))
+    {
+      return EINVAL;
+    }
+
+  PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_BARRIER);
+  return (WAIT_OBJECT_0 == ptw32_wait_objects (1, &sem, INFINITE)) ? 0 : EINVAL;
+}
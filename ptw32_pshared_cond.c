@@ -0,0 +1,233 @@
+/*
+ * ptw32_pshared_cond.c
+ *
+ * Description:
+ * This translation unit implements process shared condition variables.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * A process shared condition variable is a count of waiters, held
+ * negative in its slot as in a semaphore, and a kernel semaphore that
+ * signal and broadcast release once for each waiter they take off the
+ * count. A waiter joins the count while it holds the mutex, so no
+ * wakeup aimed at it can be missed, but any waiter may take a token:
+ * wakeups are not ordered.
+ */
+
+int
+ptw32_pshared_cond_init (pthread_cond_t * cond, clockid_t clock)
+{
+  ptw32_pshared_slot_t * slot;
+  void * h;
+  int result;
+
+  if (0 == (result = ptw32_pshared_alloc (&h, &slot)))
+    {
+      slot->s.u.cond.value = 0;
+      slot->s.u.cond.clock = (LONG) clock;
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.type,
+                                              (PTW32_INTERLOCKED_LONG) PTW32_PSHARED_COND);
+      *cond = (pthread_cond_t) h;
+    }
+
+  return result;
+}
+
+
+int
+ptw32_pshared_cond_destroy (pthread_cond_t * cond)
+{
+  ptw32_pshared_slot_t * slot;
+
+  if (NULL == (slot = ptw32_pshared_get (*cond, PTW32_PSHARED_COND)))
+    {
+      return EINVAL;
+    }
+
+  if (*((LONG volatile *) &slot->s.u.cond.value) < 0)
+    {
+      return EBUSY;
+    }
+
+  ptw32_pshared_free (*cond);
+  *cond = NULL;
+
+  return 0;
+}
+
+
+typedef struct
+{
+  pthread_mutex_t * mutexPtr;
+  LONG * value;
+  HANDLE sem;
+  int * resultPtr;
+} ptw32_pshared_cond_wait_cleanup_args_t;
+
+static void PTW32_CDECL
+ptw32_pshared_cond_wait_cleanup (void * args)
+{
+  ptw32_pshared_cond_wait_cleanup_args_t * a =
+    (ptw32_pshared_cond_wait_cleanup_args_t *) args;
+  int result;
+
+  /*
+   * We timed out or were cancelled. If we have been signalled since
+   * then we take the token meant for us, as if it woke us.
+   */
+  if (0 != *(a->resultPtr) && ptw32_pshared_unwait (a->value, a->sem))
+    {
+      *(a->resultPtr) = 0;
+    }
+
+  /*
+   * XSH: Upon successful return, the mutex has been locked and is owned
+   * by the calling thread.
+   */
+  if ((result = pthread_mutex_lock (a->mutexPtr)) != 0)
+    {
+      *(a->resultPtr) = result;
+    }
+}
+
+
+int
+ptw32_pshared_cond_wait (pthread_cond_t cond, pthread_mutex_t * mutex,
+                         clockid_t clock, const struct timespec * abstime)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      As ptw32_cond_timedwait() for a process shared
+      *      condition variable. A clock of -1 is the condition
+      *      variable's own.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pshared_slot_t * slot;
+  ptw32_pshared_cond_wait_cleanup_args_t cleanup_args;
+  HANDLE sem;
+  int result;
+
+  if (NULL == (slot = ptw32_pshared_get (cond, PTW32_PSHARED_COND))
+      || NULL == (sem = ptw32_pshared_kernel (cond, 0)))
+    {
+      return EINVAL;
+    }
+
+  if (clock == -1)
+    {
+      clock = (clockid_t) slot->s.u.cond.clock;
+    }
+
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.cond.value);
+
+  if ((result = pthread_mutex_unlock (mutex)) != 0)
+    {
+      (void) ptw32_pshared_unwait (&slot->s.u.cond.value, sem);
+      return result;
+    }
+
+  cleanup_args.mutexPtr = mutex;
+  cleanup_args.value = &slot->s.u.cond.value;
+  cleanup_args.sem = sem;
+  cleanup_args.resultPtr = &result;
+
+  /*
+   * If we are cancelled the cleanup handler finds us still waiting.
+   */
+  result = ETIMEDOUT;
+
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth(0)
+#endif
+  pthread_cleanup_push (ptw32_pshared_cond_wait_cleanup, (void *) &cleanup_args);
+
+  PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_COND);
+  result = ptw32_cancelable_abstimed_wait (sem, clock, abstime);
+
+  /*
+   * Always cleanup
+   */
+  pthread_cleanup_pop (1);
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth()
+#endif
+
+  /*
+   * "result" can be modified by the cleanup handler.
+   */
+  return result;
+}
+
+
+int
+ptw32_pshared_cond_unblock (pthread_cond_t cond, int unblockAll)
+{
+  ptw32_pshared_slot_t * slot;
+  HANDLE sem;
+  LONG v;
+  LONG n;
+
+  if (NULL == (slot = ptw32_pshared_get (cond, PTW32_PSHARED_COND)))
+    {
+      return EINVAL;
+    }
+
+  do
+    {
+      v = *((LONG volatile *) &slot->s.u.cond.value);
+      if (v >= 0)
+	{
+	  /* No waiters */
+	  return 0;
+	}
+      n = unblockAll ? -v : 1;
+    }
+  while ((PTW32_INTERLOCKED_LONG) v !=
+	 PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.cond.value,
+						  (PTW32_INTERLOCKED_LONG) (v + n),
+						  (PTW32_INTERLOCKED_LONG) v));
+
+  if (NULL == (sem = ptw32_pshared_kernel (cond, 0))
+      || !PTW32_RELEASESEMAPHORE (sem, n, NULL))
+    {
+      return EINVAL;
+    }
+
+  return 0;
+}
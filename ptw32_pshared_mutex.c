@@ -0,0 +1,499 @@
+/*
+ * ptw32_pshared_mutex.c
+ *
+ * Description:
+ * This translation unit implements process shared mutexes.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Process shared mutexes use the lock_idx protocol of the process
+ * private ones (see pthread_mutex_lock.c) on their slot, with the
+ * slot's event for waiters. The owner of an errorcheck or recursive
+ * mutex is recorded by Win32 thread id, which is unique across
+ * processes.
+ *
+ * The owner of a robust mutex, of any kind, is recorded by process
+ * and thread id. No process can run code when another dies, so a
+ * waiter finds out for itself: it waits PTW32_PSHARED_ROBUST_POLL
+ * milliseconds at a time and, each time the wait runs out, looks at
+ * the owner. If the owner's process or thread has ended, the first
+ * waiter to see it swaps its own id in for the owner's and has the
+ * mutex, with EOWNERDEAD. Ids can be reused once their process or
+ * thread has gone, so a dead owner can look alive (and the waiters
+ * wait on, as for a mutex that isn't robust) but a live owner never
+ * looks dead. An owner that dies between taking lock_idx and
+ * recording itself isn't detected.
+ */
+
+static void
+ptw32_pshared_mutex_wake (pthread_mutex_t mutex, ptw32_pshared_slot_t * slot,
+                          int * result)
+{
+  if ((LONG) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.mutex.lock_idx,
+                                              (PTW32_INTERLOCKED_LONG) 0) < 0L)
+    {
+      /* Someone may be waiting on that mutex */
+      HANDLE event = ptw32_pshared_kernel (mutex, 0);
+
+      if (NULL == event || !PTW32_SETEVENT (event))
+        {
+          *result = EINVAL;
+        }
+    }
+}
+
+
+int
+ptw32_pshared_mutex_init (pthread_mutex_t * mutex, int kind, int robustness)
+{
+  ptw32_pshared_slot_t * slot;
+  void * h;
+  int result;
+
+  if (0 == (result = ptw32_pshared_alloc (&h, &slot)))
+    {
+      slot->s.u.mutex.lock_idx = 0;
+      slot->s.u.mutex.recursive_count = 0;
+      slot->s.u.mutex.kind = kind;
+      slot->s.u.mutex.ownerThread = 0;
+      slot->s.u.mutex.ownerProcess = 0;
+      slot->s.u.mutex.robustness = robustness;
+      slot->s.u.mutex.state = PTW32_ROBUST_CONSISTENT;
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.type,
+                                              (PTW32_INTERLOCKED_LONG) PTW32_PSHARED_MUTEX);
+      *mutex = (pthread_mutex_t) h;
+    }
+
+  return result;
+}
+
+
+int
+ptw32_pshared_mutex_destroy (pthread_mutex_t * mutex)
+{
+  ptw32_pshared_slot_t * slot;
+
+  if (NULL == (slot = ptw32_pshared_get (*mutex, PTW32_PSHARED_MUTEX)))
+    {
+      return EINVAL;
+    }
+
+  /*
+   * Leave it locked so that no one else can take it.
+   */
+  if (0 != (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG (
+                           (PTW32_INTERLOCKED_LONGPTR) &slot->s.u.mutex.lock_idx,
+                           (PTW32_INTERLOCKED_LONG) 1,
+                           (PTW32_INTERLOCKED_LONG) 0))
+    {
+      return EBUSY;
+    }
+
+  ptw32_pshared_free (*mutex);
+  *mutex = NULL;
+
+  return 0;
+}
+
+
+/*
+ * Block until the mutex may have been released, as ptw32_mutex_wait(),
+ * or for at most 'poll' milliseconds, when it returns EAGAIN.
+ */
+static int
+ptw32_pshared_mutex_wait (HANDLE event, clockid_t clock,
+                          const struct timespec * abstime, DWORD poll)
+{
+  DWORD status;
+  DWORD milliseconds;
+  HANDLE handles[2];
+  int polled;
+
+  if (NULL == (handles[0] = event))
+    {
+      return EINVAL;
+    }
+
+  milliseconds = ptw32_wait_timeout (clock, abstime, &handles[1]);
+
+  if ((polled = (poll < milliseconds)))
+    {
+      milliseconds = poll;
+    }
+
+  PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_MUTEX);
+  status = ptw32_wait_objects ((handles[1] == NULL) ? 1 : 2, handles,
+                               milliseconds);
+
+  if (status != WAIT_OBJECT_0)
+    {
+      if (status == WAIT_TIMEOUT && polled)
+        {
+          return EAGAIN;
+        }
+      return (status == WAIT_TIMEOUT || status == WAIT_OBJECT_0 + 1)
+             ? ETIMEDOUT : EINVAL;
+    }
+
+  return 0;
+}
+
+
+/*
+ * Returns non-zero if 'h' is NULL because what it was opened for no
+ * longer exists, or is signalled because it has ended.
+ */
+static int
+ptw32_pshared_ended (HANDLE h)
+{
+  int ended;
+
+  if (NULL == h)
+    {
+      return (ERROR_INVALID_PARAMETER == GetLastError ());
+    }
+
+  ended = (WAIT_OBJECT_0 == WaitForSingleObject (h, 0));
+  (void) CloseHandle (h);
+
+  return ended;
+}
+
+
+/*
+ * Takes over a robust mutex from an owner that has ended. Returns
+ * non-zero if the caller now owns the mutex.
+ */
+static int
+ptw32_pshared_mutex_takeover (ptw32_pshared_slot_t * slot, DWORD self)
+{
+  DWORD owner = (DWORD) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.mutex.ownerThread,
+                                                             (PTW32_INTERLOCKED_LONG) 0);
+  DWORD process = slot->s.u.mutex.ownerProcess;
+
+  if (0 == owner
+      || !(ptw32_pshared_ended (OpenProcess (SYNCHRONIZE, PTW32_FALSE, process))
+           || (NULL != ptw32_openthread
+               && ptw32_pshared_ended (ptw32_openthread (SYNCHRONIZE, PTW32_FALSE, owner)))))
+    {
+      return PTW32_FALSE;
+    }
+
+  /* Only one waiter takes it over */
+  if ((DWORD) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.mutex.ownerThread,
+                                                       (PTW32_INTERLOCKED_LONG) self,
+                                                       (PTW32_INTERLOCKED_LONG) owner) != owner)
+    {
+      return PTW32_FALSE;
+    }
+
+  slot->s.u.mutex.ownerProcess = GetCurrentProcessId ();
+  (void) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.mutex.state,
+                                                  (PTW32_INTERLOCKED_LONG) PTW32_ROBUST_INCONSISTENT,
+                                                  (PTW32_INTERLOCKED_LONG) PTW32_ROBUST_CONSISTENT);
+  /* Still locked, and the next unlock wakes a waiter */
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.mutex.lock_idx,
+                                          (PTW32_INTERLOCKED_LONG) -1);
+
+  return PTW32_TRUE;
+}
+
+
+/*
+ * Records the caller as the owner of a mutex it has just locked, and
+ * returns the result of the lock.
+ */
+static int
+ptw32_pshared_mutex_owned (pthread_mutex_t mutex, ptw32_pshared_slot_t * slot,
+                           DWORD self)
+{
+  int result = 0;
+
+  slot->s.u.mutex.recursive_count = 1;
+
+  if (PTHREAD_MUTEX_ROBUST != slot->s.u.mutex.robustness)
+    {
+      slot->s.u.mutex.ownerThread = self;
+      return 0;
+    }
+
+  switch (slot->s.u.mutex.state)
+    {
+    case PTW32_ROBUST_NOTRECOVERABLE:
+      /* Pass the wake on to the next waiter */
+      ptw32_pshared_mutex_wake (mutex, slot, &result);
+      return ENOTRECOVERABLE;
+
+    case PTW32_ROBUST_INCONSISTENT:
+      result = EOWNERDEAD;
+      break;
+    }
+
+  slot->s.u.mutex.ownerProcess = GetCurrentProcessId ();
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.mutex.ownerThread,
+                                          (PTW32_INTERLOCKED_LONG) self);
+
+  return result;
+}
+
+
+int
+ptw32_pshared_mutex_lock (pthread_mutex_t mutex, clockid_t clock,
+                          const struct timespec * abstime)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Locks a process shared mutex, waiting until abstime
+      *      (NULL: forever), measured against 'clock'.
+      *
+      * RESULTS
+      *              as pthread_mutex_clocklock.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pshared_slot_t * slot;
+  LONG * lock_idx;
+  DWORD self;
+  DWORD poll;
+  int result;
+
+  if (NULL == (slot = ptw32_pshared_get (mutex, PTW32_PSHARED_MUTEX)))
+    {
+      return EINVAL;
+    }
+
+  lock_idx = &slot->s.u.mutex.lock_idx;
+
+  if (PTHREAD_MUTEX_ROBUST == slot->s.u.mutex.robustness)
+    {
+      if (PTW32_ROBUST_NOTRECOVERABLE == slot->s.u.mutex.state)
+        {
+          return ENOTRECOVERABLE;
+        }
+      poll = PTW32_PSHARED_ROBUST_POLL;
+    }
+  else if (PTHREAD_MUTEX_NORMAL == slot->s.u.mutex.kind)
+    {
+      if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                       (PTW32_INTERLOCKED_LONGPTR) lock_idx,
+                       (PTW32_INTERLOCKED_LONG) 1) != 0)
+        {
+          while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                          (PTW32_INTERLOCKED_LONGPTR) lock_idx,
+                          (PTW32_INTERLOCKED_LONG) -1) != 0)
+            {
+              if (0 != (result = ptw32_pshared_mutex_wait (ptw32_pshared_kernel (mutex, 0),
+                                                           clock, abstime, INFINITE)))
+                {
+                  return result;
+                }
+            }
+        }
+
+      return 0;
+    }
+  else
+    {
+      poll = INFINITE;
+    }
+
+  self = GetCurrentThreadId ();
+
+  if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                   (PTW32_INTERLOCKED_LONGPTR) lock_idx,
+                   (PTW32_INTERLOCKED_LONG) 1,
+                   (PTW32_INTERLOCKED_LONG) 0) != 0)
+    {
+      if (PTHREAD_MUTEX_NORMAL != slot->s.u.mutex.kind
+          && slot->s.u.mutex.ownerThread == self)
+        {
+          if (PTHREAD_MUTEX_RECURSIVE == slot->s.u.mutex.kind)
+            {
+              slot->s.u.mutex.recursive_count++;
+              return 0;
+            }
+          return EDEADLK;
+        }
+
+      while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                      (PTW32_INTERLOCKED_LONGPTR) lock_idx,
+                      (PTW32_INTERLOCKED_LONG) -1) != 0)
+        {
+          result = ptw32_pshared_mutex_wait (ptw32_pshared_kernel (mutex, 0),
+                                             clock, abstime, poll);
+
+          if (EAGAIN == result)
+            {
+              if (ptw32_pshared_mutex_takeover (slot, self))
+                {
+                  slot->s.u.mutex.recursive_count = 1;
+                  return EOWNERDEAD;
+                }
+            }
+          else if (0 != result)
+            {
+              return result;
+            }
+        }
+    }
+
+  return ptw32_pshared_mutex_owned (mutex, slot, self);
+}
+
+
+int
+ptw32_pshared_mutex_trylock (pthread_mutex_t mutex)
+{
+  ptw32_pshared_slot_t * slot;
+  DWORD self;
+
+  if (NULL == (slot = ptw32_pshared_get (mutex, PTW32_PSHARED_MUTEX)))
+    {
+      return EINVAL;
+    }
+
+  self = GetCurrentThreadId ();
+
+  if (PTHREAD_MUTEX_ROBUST == slot->s.u.mutex.robustness
+      && PTW32_ROBUST_NOTRECOVERABLE == slot->s.u.mutex.state)
+    {
+      return ENOTRECOVERABLE;
+    }
+
+  if (0 == (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG (
+                     (PTW32_INTERLOCKED_LONGPTR) &slot->s.u.mutex.lock_idx,
+                     (PTW32_INTERLOCKED_LONG) 1,
+                     (PTW32_INTERLOCKED_LONG) 0))
+    {
+      if (PTHREAD_MUTEX_NORMAL != slot->s.u.mutex.kind
+          || PTHREAD_MUTEX_ROBUST == slot->s.u.mutex.robustness)
+        {
+          return ptw32_pshared_mutex_owned (mutex, slot, self);
+        }
+      return 0;
+    }
+
+  if (PTHREAD_MUTEX_RECURSIVE == slot->s.u.mutex.kind
+      && slot->s.u.mutex.ownerThread == self)
+    {
+      slot->s.u.mutex.recursive_count++;
+      return 0;
+    }
+
+  /* Looking at the owner costs system calls, but never blocks */
+  if (PTHREAD_MUTEX_ROBUST == slot->s.u.mutex.robustness
+      && ptw32_pshared_mutex_takeover (slot, self))
+    {
+      slot->s.u.mutex.recursive_count = 1;
+      return EOWNERDEAD;
+    }
+
+  return EBUSY;
+}
+
+
+int
+ptw32_pshared_mutex_unlock (pthread_mutex_t mutex)
+{
+  ptw32_pshared_slot_t * slot;
+  int result = 0;
+
+  if (NULL == (slot = ptw32_pshared_get (mutex, PTW32_PSHARED_MUTEX)))
+    {
+      return EINVAL;
+    }
+
+  if (PTHREAD_MUTEX_NORMAL != slot->s.u.mutex.kind
+      || PTHREAD_MUTEX_ROBUST == slot->s.u.mutex.robustness)
+    {
+      if (slot->s.u.mutex.ownerThread != GetCurrentThreadId ())
+        {
+          return EPERM;
+        }
+
+      if (PTHREAD_MUTEX_RECURSIVE == slot->s.u.mutex.kind
+          && 0 != --slot->s.u.mutex.recursive_count)
+        {
+          return 0;
+        }
+
+      /*
+       * Unlocked without being made consistent: nobody can have it
+       * again.
+       */
+      (void) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.mutex.state,
+                                                      (PTW32_INTERLOCKED_LONG) PTW32_ROBUST_NOTRECOVERABLE,
+                                                      (PTW32_INTERLOCKED_LONG) PTW32_ROBUST_INCONSISTENT);
+
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.mutex.ownerThread,
+                                              (PTW32_INTERLOCKED_LONG) 0);
+    }
+
+  ptw32_pshared_mutex_wake (mutex, slot, &result);
+
+  return result;
+}
+
+
+int
+ptw32_pshared_mutex_consistent (pthread_mutex_t mutex)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      As pthread_mutex_consistent() for a process shared
+      *      mutex: the caller must own the robust mutex, having
+      *      taken it over with EOWNERDEAD.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pshared_slot_t * slot;
+
+  if (NULL == (slot = ptw32_pshared_get (mutex, PTW32_PSHARED_MUTEX))
+      || PTHREAD_MUTEX_ROBUST != slot->s.u.mutex.robustness
+      || slot->s.u.mutex.ownerThread != GetCurrentThreadId ()
+      || (PTW32_INTERLOCKED_LONG) PTW32_ROBUST_INCONSISTENT != PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG (
+                                    (PTW32_INTERLOCKED_LONGPTR) &slot->s.u.mutex.state,
+                                    (PTW32_INTERLOCKED_LONG) PTW32_ROBUST_CONSISTENT,
+                                    (PTW32_INTERLOCKED_LONG) PTW32_ROBUST_INCONSISTENT))
+    {
+      return EINVAL;
+    }
+
+  return 0;
+}
@@ -0,0 +1,403 @@
+/*
+ * ptw32_pshared_sem.c
+ *
+ * Description:
+ * This translation unit implements process shared semaphores.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include <string.h>
+#include "pthread.h"
+#include "semaphore.h"
+#include "implement.h"
+
+
+/*
+ * Process shared semaphores keep the value of the process private
+ * ones (see sem_post.c and sem_timedwait.c) in their slot, and waiters
+ * block on the slot's kernel semaphore.
+ */
+
+int
+ptw32_pshared_sem_init (sem_t * sem, unsigned int value)
+{
+  ptw32_pshared_slot_t * slot;
+  void * h;
+  int result;
+
+  if (0 == (result = ptw32_pshared_alloc (&h, &slot)))
+    {
+      slot->s.u.sem.value = (LONG) value;
+      slot->s.u.sem.refs = 0;
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.type,
+                                              (PTW32_INTERLOCKED_LONG) PTW32_PSHARED_SEM);
+      *sem = (sem_t) h;
+    }
+
+  return result;
+}
+
+
+int
+ptw32_pshared_sem_destroy (sem_t * sem)
+{
+  ptw32_pshared_slot_t * slot;
+
+  if (NULL == (slot = ptw32_pshared_get (*sem, PTW32_PSHARED_SEM)))
+    {
+      return EINVAL;
+    }
+
+  if (0 != slot->s.u.sem.refs)
+    {
+      /* Named semaphores are closed, not destroyed */
+      return EINVAL;
+    }
+
+  if (*((LONG volatile *) &slot->s.u.sem.value) < 0)
+    {
+      return EBUSY;
+    }
+
+  ptw32_pshared_free (*sem);
+  *sem = NULL;
+
+  return 0;
+}
+
+
+typedef struct
+{
+  LONG * value;
+  HANDLE sem;
+  int * resultPtr;
+} ptw32_pshared_sem_wait_cleanup_args_t;
+
+static void PTW32_CDECL
+ptw32_pshared_sem_wait_cleanup (void * args)
+{
+  ptw32_pshared_sem_wait_cleanup_args_t * a =
+    (ptw32_pshared_sem_wait_cleanup_args_t *) args;
+
+  /*
+   * We either timed out or were cancelled. If someone has posted
+   * between then and now we take the semaphore.
+   */
+  if (ptw32_pshared_unwait (a->value, a->sem))
+    {
+      *(a->resultPtr) = 0;
+    }
+}
+
+
+int
+ptw32_pshared_sem_wait (sem_t sem, clockid_t clock,
+                        const struct timespec * abstime)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      As sem_clockwait() for a process shared semaphore,
+      *      waiting forever if abstime is NULL.
+      *
+      * RESULTS
+      *              0               successfully decreased semaphore,
+      *              EINVAL          'sem' is not a valid semaphore,
+      *              ETIMEDOUT       abstime elapsed before success.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pshared_slot_t * slot;
+  int result = 0;
+
+  if (NULL == (slot = ptw32_pshared_get (sem, PTW32_PSHARED_SEM)))
+    {
+      return EINVAL;
+    }
+
+  if ((LONG) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.sem.value) < 0)
+    {
+      ptw32_pshared_sem_wait_cleanup_args_t cleanup_args;
+
+      cleanup_args.value = &slot->s.u.sem.value;
+      cleanup_args.resultPtr = &result;
+
+      if (NULL == (cleanup_args.sem = ptw32_pshared_kernel (sem, 0)))
+        {
+          /* Nothing can block on a semaphore that no one could open */
+          (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.sem.value);
+          return EINVAL;
+        }
+
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth(0)
+#endif
+      /* Must wait */
+      pthread_cleanup_push (ptw32_pshared_sem_wait_cleanup, (void *) &cleanup_args);
+      PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_SEM);
+      result = ptw32_cancelable_abstimed_wait (cleanup_args.sem, clock, abstime);
+      /* Cleanup if we're canceled or on any other error */
+      pthread_cleanup_pop (result);
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth()
+#endif
+    }
+
+  return result;
+}
+
+
+int
+ptw32_pshared_sem_take (sem_t sem, int max)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Takes up to 'max' units of a process shared
+      *      semaphore that are available now.
+      *
+      * RESULTS
+      *              The number of units taken, or -1 if 'sem' is
+      *              not a valid semaphore.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pshared_slot_t * slot;
+  LONG v;
+  LONG n;
+
+  if (NULL == (slot = ptw32_pshared_get (sem, PTW32_PSHARED_SEM)))
+    {
+      return -1;
+    }
+
+  do
+    {
+      v = *((LONG volatile *) &slot->s.u.sem.value);
+      if (v <= 0)
+	{
+	  return 0;
+	}
+      n = (v < max) ? v : max;
+    }
+  while ((PTW32_INTERLOCKED_LONG) v !=
+	 PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.sem.value,
+						  (PTW32_INTERLOCKED_LONG) (v - n),
+						  (PTW32_INTERLOCKED_LONG) v));
+
+  return (int) n;
+}
+
+
+int
+ptw32_pshared_sem_post (sem_t sem, int count)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      As sem_post_multiple() for a process shared
+      *      semaphore.
+      *
+      * RESULTS
+      *              0               successfully posted,
+      *              EINVAL          'sem' is not a valid semaphore,
+      *              ERANGE          the value would exceed SEM_VALUE_MAX.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pshared_slot_t * slot;
+  HANDLE h;
+  LONG v;
+  long waiters;
+
+  if (NULL == (slot = ptw32_pshared_get (sem, PTW32_PSHARED_SEM)))
+    {
+      return EINVAL;
+    }
+
+  do
+    {
+      v = *((LONG volatile *) &slot->s.u.sem.value);
+      if (v > SEM_VALUE_MAX - count)
+	{
+	  return ERANGE;
+	}
+    }
+  while ((PTW32_INTERLOCKED_LONG) v !=
+	 PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.sem.value,
+						  (PTW32_INTERLOCKED_LONG) (v + count),
+						  (PTW32_INTERLOCKED_LONG) v));
+
+  /* Wake no more threads than are waiting */
+  waiters = -v;
+  if (waiters > 0
+      && (NULL == (h = ptw32_pshared_kernel (sem, 0))
+	  || !PTW32_RELEASESEMAPHORE (h, (waiters <= count) ? waiters : count, 0)))
+    {
+      (void) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.sem.value,
+						  (PTW32_INTERLOCKED_LONG) -count);
+      return EINVAL;
+    }
+
+  return 0;
+}
+
+
+int
+ptw32_pshared_sem_getvalue (sem_t sem, int * sval)
+{
+  ptw32_pshared_slot_t * slot;
+
+  if (NULL == (slot = ptw32_pshared_get (sem, PTW32_PSHARED_SEM)))
+    {
+      return EINVAL;
+    }
+
+  /* The value is only changed with interlocked operations */
+  *sval = (int) *((LONG volatile *) &slot->s.u.sem.value);
+
+  return 0;
+}
+
+
+HANDLE
+ptw32_sem_name_map (const char * name, int create, ptw32_sem_name_t ** view)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Maps the record of named semaphore 'name', creating
+      *      it if 'create' is nonzero and no process has it open.
+      *      A new record has no semaphore.
+      *
+      * RESULTS
+      *              The mapping, with *view set, or NULL with errno
+      *              set to EINVAL, ENAMETOOLONG, ENOENT or ENOSPC.
+      *
+      * ------------------------------------------------------
+      */
+{
+  static const char prefix[] = "Local\\ptw32-sem-";
+  char kname[sizeof (prefix) + PTW32_SEM_NAME_MAX];
+  HANDLE mapping;
+  size_t n;
+
+  if (name == NULL)
+    {
+      errno = EINVAL;
+      return NULL;
+    }
+
+  if (*name == '/')
+    {
+      name++;
+    }
+
+  if (*name == '\0' || strchr (name, '/') != NULL || strchr (name, '\\') != NULL)
+    {
+      errno = EINVAL;
+      return NULL;
+    }
+
+  if ((n = strlen (name)) > PTW32_SEM_NAME_MAX)
+    {
+      errno = ENAMETOOLONG;
+      return NULL;
+    }
+
+  memcpy (kname, prefix, sizeof (prefix) - 1);
+  memcpy (kname + sizeof (prefix) - 1, name, n + 1);
+
+  mapping = create
+            ? CreateFileMapping (INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0,
+                                 sizeof (ptw32_sem_name_t), kname)
+            : OpenFileMapping (FILE_MAP_ALL_ACCESS, PTW32_FALSE, kname);
+
+  if (NULL == mapping)
+    {
+      errno = create ? ENOSPC : ENOENT;
+      return NULL;
+    }
+
+  if (NULL == (*view = (ptw32_sem_name_t *) MapViewOfFile (mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0)))
+    {
+      (void) CloseHandle (mapping);
+      errno = ENOSPC;
+      return NULL;
+    }
+
+  return mapping;
+}
+
+
+void
+ptw32_sem_name_lock (ptw32_sem_name_t * name)
+{
+  int yields = 0;
+
+  while (0 != (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG (
+                        (PTW32_INTERLOCKED_LONGPTR) &name->lock,
+                        (PTW32_INTERLOCKED_LONG) 1,
+                        (PTW32_INTERLOCKED_LONG) 0))
+    {
+      ptw32_yield (&yields);
+    }
+}
+
+
+void
+ptw32_sem_name_unlock (ptw32_sem_name_t * name)
+{
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &name->lock,
+                                          (PTW32_INTERLOCKED_LONG) 0);
+}
+
+
+void
+ptw32_named_sem_release (sem_t sem)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Drops a reference to a named semaphore, held by its
+      *      name until it is unlinked and by each process that
+      *      has it open. The last one frees it.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_pshared_slot_t * slot = ptw32_pshared_get (sem, PTW32_PSHARED_SEM);
+
+  if (NULL != slot
+      && 0 == (LONG) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.sem.refs))
+    {
+      ptw32_pshared_free (sem);
+    }
+}
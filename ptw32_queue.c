@@ -0,0 +1,131 @@
+/*
+ * ptw32_queue.c
+ *
+ * Description:
+ * This translation unit implements bounded queue primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * Bounded MPMC queues, created with pthread_queue_create_np().
+ *
+ * The items live in a ring of cells, each with a sequence number
+ * (D. Vyukov's bounded MPMC queue). A pusher takes the next tail
+ * ticket with one interlocked increment and fills the cell once its
+ * sequence says the cell is free for that ticket; a popper does the
+ * same with the head ticket. Nothing is locked.
+ *
+ * Two semaphores count the free places (slots) and the filled places
+ * (items), so a thread only takes a ticket when its cell is, or is
+ * about to be, ready for it. They are the only place a thread blocks:
+ * sem_wait() is an interlocked decrement unless the queue is full or
+ * empty, and provides the cancellation point and the timed waits.
+ * Because the semaphore is taken before the ticket, a push or pop
+ * that is cancelled or times out leaves the ring untouched.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+void
+ptw32_queue_put (pthread_queue_np_t queue, void * item)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Puts item in the cell of the next tail ticket. The
+      *      caller has taken a slot.
+      *
+      *      The cell can still be in use by the popper of the
+      *      ticket one lap earlier, which has taken its item but
+      *      not yet freed the cell; wait for it.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG ticket = (LONG) PTW32_INTERLOCKED_INCREMENT_LONG(
+                         (PTW32_INTERLOCKED_LONGPTR) &queue->tail) - 1;
+  ptw32_queue_cell_t * cell = &queue->cells[ticket & queue->mask];
+  int yields = 0;
+
+  while ((LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
+                  (PTW32_INTERLOCKED_LONGPTR) &cell->sequence,
+                  (PTW32_INTERLOCKED_LONG) 0) != ticket)
+    {
+      ptw32_yield (&yields);
+    }
+
+  cell->item = item;
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG(
+           (PTW32_INTERLOCKED_LONGPTR) &cell->sequence,
+           (PTW32_INTERLOCKED_LONG) (ticket + 1));
+}
+
+void *
+ptw32_queue_get (pthread_queue_np_t queue)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Takes the item from the cell of the next head ticket
+      *      and frees the cell for the ticket one lap later. The
+      *      caller has taken an item.
+      *
+      *      The pusher of the ticket can still be filling the
+      *      cell; wait for it.
+      *
+      * RESULTS
+      *              the item.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG ticket = (LONG) PTW32_INTERLOCKED_INCREMENT_LONG(
+                         (PTW32_INTERLOCKED_LONGPTR) &queue->head) - 1;
+  ptw32_queue_cell_t * cell = &queue->cells[ticket & queue->mask];
+  void * item;
+  int yields = 0;
+
+  while ((LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
+                  (PTW32_INTERLOCKED_LONGPTR) &cell->sequence,
+                  (PTW32_INTERLOCKED_LONG) 0) != ticket + 1)
+    {
+      ptw32_yield (&yields);
+    }
+
+  item = cell->item;
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG(
+           (PTW32_INTERLOCKED_LONGPTR) &cell->sequence,
+           (PTW32_INTERLOCKED_LONG) (ticket + queue->mask + 1));
+
+  return item;
+}
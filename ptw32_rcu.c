@@ -0,0 +1,80 @@
+/*
+ * ptw32_rcu.c
+ *
+ * Description:
+ * This translation unit implements read-copy-update primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+ptw32_rcu_reader_t *
+ptw32_rcu_register (ptw32_thread_t * sp)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns the RCU reader record of thread 'sp', making
+      *      it (offline) and adding it to ptw32_rcuReaders the
+      *      first time.
+      *
+      * RESULTS
+      *              the record, or NULL if there is no memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_rcu_reader_t * r = sp->rcuReader;
+
+  if (r == NULL)
+    {
+      ptw32_mcs_local_node_t node;
+
+      /* A cache line of its own: readers write it at each quiescent state */
+      r = (ptw32_rcu_reader_t *) ptw32_object_alloc (sizeof (*r), PTW32_CACHE_LINE_SIZE);
+
+      if (r == NULL)
+	{
+	  return NULL;
+	}
+
+      ptw32_mcs_lock_acquire (&ptw32_rcu_lock, &node);
+      r->next = ptw32_rcuReaders;
+      ptw32_rcuReaders = r;
+      ptw32_mcs_lock_release (&node);
+
+      sp->rcuReader = r;
+      ptw32_testcancel_raise (sp, PTW32_TESTCANCEL_RCU);
+    }
+
+  return r;
+}
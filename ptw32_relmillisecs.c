@@ -36,97 +36,95 @@
 
 #include "pthread.h"
 #include "implement.h"
-#if !defined(NEED_FTIME)
-#include <sys/timeb.h>
-#endif
 
 
 #if defined(PTW32_BUILD_INLINED)
 INLINE 
 #endif /* PTW32_BUILD_INLINED */
-DWORD
-ptw32_relmillisecs (const struct timespec * abstime)
+int64_t
+ptw32_rel100nanosecs (clockid_t clock, const struct timespec * abstime)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns the time remaining until abstime, measured
+      *      against 'clock', in the 100 nanosecond units of a
+      *      FILETIME, or 0 if abstime has passed. With
+      *      PTW32_CLOCK_RELATIVE abstime is the time remaining.
+      *
+      *      CLOCK_MONOTONIC is QueryPerformanceCounter time (see
+      *      pthread.h). For CLOCK_REALTIME the current time is
+      *      read with GetSystemTimePreciseAsFileTime where the
+      *      system provides it (Windows 8 and later); otherwise
+      *      it has the resolution of the system clock tick.
+      *
+      * ------------------------------------------------------
+      */
 {
-  const int64_t NANOSEC_PER_MILLISEC = 1000000;
-  const int64_t MILLISEC_PER_SEC = 1000;
-  DWORD milliseconds;
-  int64_t tmpAbsMilliseconds;
-  int64_t tmpCurrMilliseconds;
-#if defined(NEED_FTIME)
-  struct timespec currSysTime;
+  int64_t tmpAbsTime;
+  int64_t tmpCurrTime;
   FILETIME ft;
-  SYSTEMTIME st;
-#else /* ! NEED_FTIME */
-#if ( defined(_MSC_VER) && _MSC_VER >= 1300 ) /* MSVC7+ */ || \
-    ( defined(PTW32_CONFIG_MINGW) && __MSVCRT_VERSION__ >= 0x0601 )
-  struct __timeb64 currSysTime;
-#else
-  struct _timeb currSysTime;
-#endif
-#endif /* NEED_FTIME */
-
-
-  /* 
-   * Calculate timeout as milliseconds from current system time. 
-   */
 
   /*
-   * subtract current system time from abstime in a way that checks
-   * that abstime is never in the past, or is never equivalent to the
-   * defined INFINITE value (0xFFFFFFFF).
-   *
-   * Assume all integers are unsigned, i.e. cannot test if less than 0.
+   * Round abstime up so that a wait never ends before it.
    */
-  tmpAbsMilliseconds =  (int64_t)abstime->tv_sec * MILLISEC_PER_SEC;
-  tmpAbsMilliseconds += ((int64_t)abstime->tv_nsec + (NANOSEC_PER_MILLISEC/2)) / NANOSEC_PER_MILLISEC;
+  tmpAbsTime = (int64_t)abstime->tv_sec * 10000000
+	       + ((int64_t)abstime->tv_nsec + 99) / 100;
 
-  /* get current system time */
+  if (clock == PTW32_CLOCK_RELATIVE)
+    {
+      return tmpAbsTime;
+    }
 
-#if defined(NEED_FTIME)
+  if (clock == CLOCK_MONOTONIC)
+    {
+      struct timespec now;
 
-  GetSystemTime(&st);
-  SystemTimeToFileTime(&st, &ft);
-  /*
-   * GetSystemTimeAsFileTime(&ft); would be faster,
-   * but it does not exist on WinCE
-   */
+      ptw32_monotonic_now(&now);
 
-  ptw32_filetime_to_timespec(&ft, &currSysTime);
+      tmpCurrTime = (int64_t)now.tv_sec * 10000000 + now.tv_nsec / 100;
 
-  tmpCurrMilliseconds = (int64_t)currSysTime.tv_sec * MILLISEC_PER_SEC;
-  tmpCurrMilliseconds += ((int64_t)currSysTime.tv_nsec + (NANOSEC_PER_MILLISEC/2))
-			   / NANOSEC_PER_MILLISEC;
+      return (tmpAbsTime > tmpCurrTime) ? tmpAbsTime - tmpCurrTime : 0;
+    }
 
-#else /* ! NEED_FTIME */
+  tmpAbsTime += PTW32_TIMESPEC_TO_FILETIME_OFFSET;
 
-#if defined(_MSC_VER) && _MSC_VER >= 1400  /* MSVC8+ */
-  _ftime64_s(&currSysTime);
-#elif ( defined(_MSC_VER) && _MSC_VER >= 1300 ) /* MSVC7+ */ || \
-      ( defined(PTW32_CONFIG_MINGW) && __MSVCRT_VERSION__ >= 0x0601 )
-  _ftime64(&currSysTime);
-#else
-  _ftime(&currSysTime);
-#endif
+  /* get current system time */
 
-  tmpCurrMilliseconds = (int64_t) currSysTime.time * MILLISEC_PER_SEC;
-  tmpCurrMilliseconds += (int64_t) currSysTime.millitm;
+  ptw32_filetime_now(&ft);
 
-#endif /* NEED_FTIME */
+  tmpCurrTime = ((int64_t) ft.dwHighDateTime << 32) + (int64_t) ft.dwLowDateTime;
 
-  if (tmpAbsMilliseconds > tmpCurrMilliseconds)
+  if (tmpAbsTime > tmpCurrTime)
     {
-      milliseconds = (DWORD) (tmpAbsMilliseconds - tmpCurrMilliseconds);
-      if (milliseconds == INFINITE)
-        {
-          /* Timeouts must be finite */
-          milliseconds--;
-        }
+      return tmpAbsTime - tmpCurrTime;
     }
-  else
+
+  /* The abstime given is in the past */
+  return 0;
+}
+
+
+#if defined(PTW32_BUILD_INLINED)
+INLINE 
+#endif /* PTW32_BUILD_INLINED */
+DWORD
+ptw32_relmillisecs (clockid_t clock, const struct timespec * abstime)
+{
+  const int64_t HUNDREDNANOSEC_PER_MILLISEC = 10000;
+  int64_t tmpMilliseconds;
+
+  /* 
+   * Calculate timeout as milliseconds from current system time,
+   * rounded up so that a wait that times out never returns early.
+   */
+  tmpMilliseconds = (ptw32_rel100nanosecs (clock, abstime) + HUNDREDNANOSEC_PER_MILLISEC - 1)
+		    / HUNDREDNANOSEC_PER_MILLISEC;
+
+  if (tmpMilliseconds >= (int64_t) INFINITE)
     {
-      /* The abstime given is in the past */
-      milliseconds = 0;
+      /* Timeouts must be finite */
+      return INFINITE - 1;
     }
 
-  return milliseconds;
+  return (DWORD) tmpMilliseconds;
 }
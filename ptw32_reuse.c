@@ -48,14 +48,48 @@
  * The original pthread_t struct plus all copies of it contain the address of
  * the thread state struct ptw32_thread_t_ (p), plus a reuse counter (x). Each
  * ptw32_thread_t contains the original copy of it's pthread_t.
- * Once malloced, a ptw32_thread_t_ struct is not freed until the process exits.
+ * Once malloced, a ptw32_thread_t_ struct is not freed until the process exits,
+ * unless pthread_setthreadreuse_np has limited how many are kept for reuse.
+ * The oldest are then freed first, and new structs start their reuse counter
+ * past that of any struct freed, so a struct malloced at a freed one's address
+ * never gets a pthread_t equal to an old copy. Only copies of threads whose
+ * structs have been freed can then no longer be told apart as destroyed.
  * 
- * The thread reuse stack is a simple LILO stack managed through a singly
- * linked list element in the ptw32_thread_t.
+ * Reusable ptw32_thread_t structs are kept in FIFO order so that a
+ * destroyed thread's struct is reused as late as possible. They are
+ * queued in a bounded lock-free ring (Vyukov's bounded MPMC queue):
+ * every cell carries a sequence number that equals the enqueue
+ * position when the cell is free and the position plus one when it is
+ * full. Positions only grow, so a stale position can never match a
+ * cell's sequence number again and there is no ABA problem. Threads
+ * that are destroyed while the ring is full are kept on a linked
+ * overflow list under ptw32_thread_reuse_lock, which is drained once
+ * the ring is empty.
  *
- * Each time a thread is destroyed, the ptw32_thread_t address is pushed onto the
- * reuse stack after it's ptHandle's reuse counter has been incremented.
+ * Each time a thread is destroyed, the ptw32_thread_t address is queued
+ * after it's ptHandle's reuse counter has been incremented. The struct
+ * is still reset under ptw32_thread_reuse_lock so that routines which
+ * validate a pthread_t under that lock never see a half cleared struct;
+ * the lock is not held while queueing or dequeueing. The reuse counter
+ * is bumped atomically before anything else is cleared, so it also
+ * works as a sequence number: ptw32_thread_valid reads it before and
+ * after looking at the struct and needs no lock at all.
  * 
+ * In front of the ring, each processor (by number, modulo
+ * PTW32_THREAD_REUSE_CPUS) has a small FIFO of the structs most
+ * recently destroyed on it, under a lock of its own that only
+ * threads on that processor normally take. A thread created there
+ * gets the oldest of them, still in its caches and on its node, but
+ * only once the FIFO is full; a struct pushed onto a full FIFO sends
+ * the oldest one on to the ring. Either way a struct is only reused
+ * after PTW32_THREAD_REUSE_CPU_DEPTH - 1 later threads have been
+ * destroyed on its processor, so the reuse counter of a short lived
+ * thread's struct doesn't come round to a stale copy of its
+ * pthread_t straight away. Pop falls back to the ring, then to the
+ * overflow list, then to other processors' full FIFOs; with none of
+ * them it gives nothing and ptw32_new allocates a new struct.
+ * Trimming and process exit take from the FIFOs whatever they hold.
+ *
  * The following can now be said from this:
  * - two pthread_t's are identical if their ptw32_thread_t reference pointers
  * are equal and their reuse counters are equal. That is,
@@ -69,43 +103,220 @@
  *
  */
 
+#define PTW32_RING_DIFF(a, b) ((LONG) ((ULONG) (a) - (ULONG) (b)))
+
+static ptw32_thread_t *
+ptw32_threadReuseDequeue (void)
+{
+  ptw32_thread_reuse_queue_t * q = &ptw32_threadReuseQueue;
+  LONG pos = q->dequeuePos;
+
+  for (;;)
+    {
+      ptw32_thread_reuse_cell_t * cell = &q->cells[pos & (PTW32_THREAD_REUSE_RING_SIZE - 1)];
+      LONG seq = (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
+                          (PTW32_INTERLOCKED_LONGPTR) &cell->seq,
+                          (PTW32_INTERLOCKED_LONG) 0);
+      LONG dif = PTW32_RING_DIFF(seq, (ULONG) pos + 1);
+
+      if (0 == dif)
+        {
+          LONG prev = (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                               (PTW32_INTERLOCKED_LONGPTR) &q->dequeuePos,
+                               (PTW32_INTERLOCKED_LONG) ((ULONG) pos + 1),
+                               (PTW32_INTERLOCKED_LONG) pos);
+
+          if (prev == pos)
+            {
+              ptw32_thread_t * tp = cell->tp;
+
+              /* Free the cell for the enqueue one lap later */
+              (void) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                       (PTW32_INTERLOCKED_LONGPTR) &cell->seq,
+                       (PTW32_INTERLOCKED_LONG) ((ULONG) pos + PTW32_THREAD_REUSE_RING_SIZE));
+              return tp;
+            }
+
+          pos = prev;
+        }
+      else if (dif < 0)
+        {
+          /* Empty */
+          return NULL;
+        }
+      else
+        {
+          pos = q->dequeuePos;
+        }
+    }
+}
+
+static int
+ptw32_threadReuseEnqueue (ptw32_thread_t * tp)
+{
+  ptw32_thread_reuse_queue_t * q = &ptw32_threadReuseQueue;
+  LONG pos = q->enqueuePos;
+
+  for (;;)
+    {
+      ptw32_thread_reuse_cell_t * cell = &q->cells[pos & (PTW32_THREAD_REUSE_RING_SIZE - 1)];
+      LONG seq = (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
+                          (PTW32_INTERLOCKED_LONGPTR) &cell->seq,
+                          (PTW32_INTERLOCKED_LONG) 0);
+      LONG dif = PTW32_RING_DIFF(seq, pos);
+
+      if (0 == dif)
+        {
+          LONG prev = (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                               (PTW32_INTERLOCKED_LONGPTR) &q->enqueuePos,
+                               (PTW32_INTERLOCKED_LONG) ((ULONG) pos + 1),
+                               (PTW32_INTERLOCKED_LONG) pos);
+
+          if (prev == pos)
+            {
+              cell->tp = tp;
+
+              /* Publish the cell to dequeuers */
+              (void) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                       (PTW32_INTERLOCKED_LONGPTR) &cell->seq,
+                       (PTW32_INTERLOCKED_LONG) ((ULONG) pos + 1));
+              return PTW32_TRUE;
+            }
+
+          pos = prev;
+        }
+      else if (dif < 0)
+        {
+          /* Full */
+          return PTW32_FALSE;
+        }
+      else
+        {
+          pos = q->enqueuePos;
+        }
+    }
+}
+
+static ptw32_thread_reuse_cpu_t *
+ptw32_threadReuseCpu (void)
+{
+  ptw32_processor_number_t pn;
+
+  if (ptw32_getcurrentprocessornumberex == NULL)
+    {
+      return &ptw32_threadReuseCpus[0];
+    }
+
+  ptw32_getcurrentprocessornumberex (&pn);
+
+  return &ptw32_threadReuseCpus[((size_t) pn.Group * PTW32_CPU_GROUP_SIZE + pn.Number)
+                                % PTW32_THREAD_REUSE_CPUS];
+}
+
 /*
- * Pop a clean pthread_t struct off the reuse stack.
+ * Take the oldest struct from a processor's FIFO if it holds at
+ * least 'min', else NULL.
  */
-pthread_t
-ptw32_threadReusePop (void)
+static ptw32_thread_t *
+ptw32_threadReuseCpuTake (ptw32_thread_reuse_cpu_t * c, int min)
 {
-  pthread_t t = {NULL, 0};
+  ptw32_thread_t * tp = NULL;
   ptw32_mcs_local_node_t node;
 
-  ptw32_mcs_lock_acquire(&ptw32_thread_reuse_lock, &node);
+  if (c->count < min)
+    {
+      return NULL;
+    }
 
-  if (PTW32_THREAD_REUSE_EMPTY != ptw32_threadReuseTop)
+  ptw32_mcs_lock_acquire(&c->lock, &node);
+
+  if (c->count >= min)
     {
-      ptw32_thread_t * tp;
+      tp = c->tp[c->first];
+      c->first = (c->first + 1) % PTW32_THREAD_REUSE_CPU_DEPTH;
+      c->count--;
+    }
+
+  ptw32_mcs_lock_release(&node);
+
+  return tp;
+}
+
+/*
+ * Take a struct from the ring or the overflow list, oldest first,
+ * then from any processor's FIFO holding at least 'min', starting
+ * after 'skip'.
+ */
+static ptw32_thread_t *
+ptw32_threadReuseTake (ptw32_thread_reuse_cpu_t * skip, int min)
+{
+  ptw32_thread_t * tp;
+  int i;
+
+  tp = ptw32_threadReuseDequeue ();
 
-      tp = ptw32_threadReuseTop;
+  if (NULL == tp && PTW32_THREAD_REUSE_EMPTY != ptw32_threadReuseTop)
+    {
+      ptw32_mcs_local_node_t node;
 
-      ptw32_threadReuseTop = tp->prevReuse;
+      ptw32_mcs_lock_acquire(&ptw32_thread_reuse_lock, &node);
 
-      if (PTW32_THREAD_REUSE_EMPTY == ptw32_threadReuseTop)
+      if (PTW32_THREAD_REUSE_EMPTY != ptw32_threadReuseTop)
         {
-          ptw32_threadReuseBottom = PTW32_THREAD_REUSE_EMPTY;
+          tp = ptw32_threadReuseTop;
+
+          ptw32_threadReuseTop = tp->prevReuse;
+
+          if (PTW32_THREAD_REUSE_EMPTY == ptw32_threadReuseTop)
+            {
+              ptw32_threadReuseBottom = PTW32_THREAD_REUSE_EMPTY;
+            }
         }
 
-      tp->prevReuse = NULL;
+      ptw32_mcs_lock_release(&node);
+    }
 
-      t = tp->ptHandle;
+  for (i = 1; NULL == tp && i <= PTW32_THREAD_REUSE_CPUS; i++)
+    {
+      tp = ptw32_threadReuseCpuTake (&ptw32_threadReuseCpus[((skip - ptw32_threadReuseCpus) + i)
+                                                            % PTW32_THREAD_REUSE_CPUS],
+                                     min);
     }
 
-  ptw32_mcs_lock_release(&node);
+  return tp;
+}
+
+/*
+ * Pop a clean pthread_t struct off the calling processor's FIFO, or
+ * else the reuse queue. Returns a NULL pthread_t if no struct has
+ * waited long enough.
+ */
+pthread_t
+ptw32_threadReusePop (void)
+{
+  pthread_t t = {NULL, 0};
+  ptw32_thread_reuse_cpu_t * c = ptw32_threadReuseCpu ();
+  ptw32_thread_t * tp;
+
+  if (NULL == (tp = ptw32_threadReuseCpuTake (c, PTW32_THREAD_REUSE_CPU_DEPTH))
+      && 0 != ptw32_threadReuseCount)
+    {
+      tp = ptw32_threadReuseTake (c, PTW32_THREAD_REUSE_CPU_DEPTH);
+    }
+
+  if (NULL != tp)
+    {
+      (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_threadReuseCount);
+      tp->prevReuse = NULL;
+      t = tp->ptHandle;
+    }
 
   return t;
 
 }
 
 /*
- * Push a clean pthread_t struct onto the reuse stack.
+ * Push a clean pthread_t struct onto the reuse queue.
  * Must be re-initialised when reused.
  * All object elements (mutexes, events etc) must have been either
  * detroyed before this, or never initialised.
@@ -114,38 +325,223 @@ void
 ptw32_threadReusePush (pthread_t thread)
 {
   ptw32_thread_t * tp = (ptw32_thread_t *) thread.p;
-  pthread_t t;
+  ptw32_thread_reuse_cpu_t * c;
   ptw32_mcs_local_node_t node;
 
+  /*
+   * Invalidate the handle. Only what routines that validate a
+   * pthread_t under ptw32_thread_reuse_lock look at is changed
+   * while the lock is held.
+   */
   ptw32_mcs_lock_acquire(&ptw32_thread_reuse_lock, &node);
 
-  t = tp->ptHandle;
-  memset(tp, 0, sizeof(ptw32_thread_t));
-
-  /* Must restore the original POSIX handle that we just wiped. */
-  tp->ptHandle = t;
-
-  /* Bump the reuse counter now */
+  /* Bump the reuse counter now, and before clearing (see ptw32_thread_valid) */
 #if defined(PTW32_THREAD_ID_REUSE_INCREMENT)
-  tp->ptHandle.x += PTW32_THREAD_ID_REUSE_INCREMENT;
+  (void) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &tp->ptHandle.x,
+                                              (PTW32_INTERLOCKED_LONG) PTW32_THREAD_ID_REUSE_INCREMENT);
 #else
-  tp->ptHandle.x++;
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &tp->ptHandle.x);
 #endif
 
+  tp->threadH = 0;
+  tp->mcsEvent = NULL;
   tp->state = PThreadStateReuse;
 
+  ptw32_mcs_lock_release(&node);
+
+  PTW32_LIBSTAT_ADD (PTW32_LIBSTAT_THREADS, -1);
+
+  /*
+   * Reset the fields that ptw32_new doesn't set. start_mark is
+   * always set by setjmp before it is used.
+   */
   tp->prevReuse = PTW32_THREAD_REUSE_EMPTY;
+  tp->cancelEvent = NULL;
+  tp->waitTimer = NULL;
+  tp->waitanyEvent = NULL;
+  tp->joinCallback = NULL;
+  tp->joinArg = NULL;
+  tp->joinCount = NULL;
+  tp->group = NULL;
+  tp->groupNext = NULL;
+  tp->groupPrev = NULL;
+  tp->exitStatus = NULL;
+  tp->parms.start = NULL;
+  tp->parms.arg = NULL;
+  tp->parms.stackSize = 0;
+  tp->parms.stackCommit = 0;
+  tp->parms.stackGuard = 0;
+  tp->cached = 0;
+  tp->exited = 0;
+  tp->fiber.handle = NULL;
+  tp->dtorBits = NULL;
+  tp->arena = NULL;
+  tp->nDtorWords = 0;
+  tp->dtorFirst = 0;
+  tp->dtorLimit = 0;
+  memset(tp->dtorBitsInline, 0, sizeof(tp->dtorBitsInline));
+  tp->thread = 0;
+  tp->ptErrno = 0;
+  tp->implicit = 0;
+  tp->waits = 0;
+  tp->waitTime = 0;
+  tp->blocked = 0;
+  tp->pool = NULL;
+  tp->poolBlocked = 0;
+  tp->cpuToken = PTW32_CPUTOKEN_NONE;
+  tp->cancelRequests = 0;
+  tp->sigPending = 0;
+  tp->waitAddress = NULL;
+#if defined(PTW32_COND_WAITONADDRESS)
+  tp->condWaitAddress = NULL;
+#endif
+#if defined(PTW32_LOCKWATCH)
+  tp->nHeld = 0;
+  tp->nUntracked = 0;
+#endif
+#if defined(HAVE_SIGSET_T)
+  memset(&tp->sigmask, 0, sizeof(tp->sigmask));
+#endif
 
-  if (PTW32_THREAD_REUSE_EMPTY != ptw32_threadReuseBottom)
+  /*
+   * The calling processor's FIFO takes it, and passes its oldest
+   * on to the ring when full.
+   */
+  c = ptw32_threadReuseCpu ();
+  ptw32_mcs_lock_acquire(&c->lock, &node);
+
+  if (PTW32_THREAD_REUSE_CPU_DEPTH == c->count)
     {
-      ptw32_threadReuseBottom->prevReuse = tp;
+      ptw32_thread_t * oldest = c->tp[c->first];
+
+      c->tp[c->first] = tp;
+      c->first = (c->first + 1) % PTW32_THREAD_REUSE_CPU_DEPTH;
+      tp = oldest;
     }
   else
     {
-      ptw32_threadReuseTop = tp;
+      c->tp[(c->first + c->count) % PTW32_THREAD_REUSE_CPU_DEPTH] = tp;
+      c->count++;
+      tp = NULL;
+    }
+
+  ptw32_mcs_lock_release(&node);
+
+  /*
+   * While anything is on the overflow list new arrivals join it
+   * rather than the ring, which keeps the order close to FIFO.
+   */
+  if (NULL != tp
+      && (PTW32_THREAD_REUSE_EMPTY != ptw32_threadReuseBottom
+          || !ptw32_threadReuseEnqueue (tp)))
+    {
+      ptw32_mcs_lock_acquire(&ptw32_thread_reuse_lock, &node);
+
+      if (PTW32_THREAD_REUSE_EMPTY != ptw32_threadReuseBottom)
+        {
+          ptw32_threadReuseBottom->prevReuse = tp;
+        }
+      else
+        {
+          ptw32_threadReuseTop = tp;
+        }
+
+      ptw32_threadReuseBottom = tp;
+
+      ptw32_mcs_lock_release(&node);
+    }
+
+  if ((LONG) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_threadReuseCount)
+        > (LONG) ptw32_threadReuseMax
+      && ptw32_threadReuseMax >= 0)
+    {
+      ptw32_threadReuseTrim (ptw32_threadReuseMax);
+    }
+}
+
+/*
+ * Free the oldest queued structs until no more than max are left.
+ */
+void
+ptw32_threadReuseTrim (int max)
+{
+  ptw32_thread_t * tp;
+
+  /* The ring before the processors' FIFOs, which hold the newest */
+  while (ptw32_threadReuseCount > (LONG) max
+         && (tp = ptw32_threadReuseTake (ptw32_threadReuseCpu (), 1)) != NULL)
+    {
+      (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_threadReuseCount);
+      ptw32_threadReuseFree (tp);
     }
+}
 
-  ptw32_threadReuseBottom = tp;
+/*
+ * Free a struct that has been popped off the reuse queue.
+ */
+void
+ptw32_threadReuseFree (ptw32_thread_t * tp)
+{
+  ptw32_mcs_local_node_t node;
 
+  /* See ptw32_new */
+  ptw32_mcs_lock_acquire(&ptw32_thread_reuse_lock, &node);
+  if (tp->ptHandle.x >= ptw32_threadReuseBase)
+    {
+      ptw32_threadReuseBase = tp->ptHandle.x + 1;
+    }
   ptw32_mcs_lock_release(&node);
+
+  if (tp->attrCache != NULL)
+    {
+      ptw32_object_free (tp->attrCache);
+    }
+  if (tp->exitEvent != NULL)
+    {
+      ptw32_closehandle (tp->exitEvent, PTW32_LIBSTAT_EVENTS);
+    }
+  if (tp->fiber.tsd != NULL)
+    {
+      free (tp->fiber.tsd);
+    }
+  if (tp->largePage)
+    {
+      ptw32_largepage_thread_free (tp);
+    }
+  else
+    {
+      free (tp);
+    }
+}
+
+/*
+ * Return 0 if thread is a live thread's pthread_t, otherwise ESRCH.
+ * Takes no lock: the reuse counter is read before and after the
+ * struct, and ptw32_threadReusePush bumps it before clearing the
+ * struct, so a thread destroyed meanwhile is seen as destroyed.
+ */
+int
+ptw32_thread_valid (pthread_t thread)
+{
+  ptw32_thread_t * tp = (ptw32_thread_t *) thread.p;
+  int live;
+
+  if (NULL == tp
+      || thread.x != (unsigned int) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
+                                      (PTW32_INTERLOCKED_LONGPTR) &tp->ptHandle.x,
+                                      (PTW32_INTERLOCKED_LONG) 0))
+    {
+      return ESRCH;
+    }
+
+  live = (NULL != tp->threadH || tp->implicit || NULL != tp->fiber.handle);
+
+  if (thread.x != (unsigned int) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
+                                   (PTW32_INTERLOCKED_LONGPTR) &tp->ptHandle.x,
+                                   (PTW32_INTERLOCKED_LONG) 0))
+    {
+      return ESRCH;
+    }
+
+  return live ? 0 : ESRCH;
 }
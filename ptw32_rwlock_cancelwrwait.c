@@ -42,8 +42,9 @@ ptw32_rwlock_cancelwrwait (void *arg)
 {
   pthread_rwlock_t rwl = (pthread_rwlock_t) arg;
 
-  rwl->nSharedAccessCount = -rwl->nCompletedSharedAccessCount;
-  rwl->nCompletedSharedAccessCount = 0;
+  /* Readers still inside count up from zero again as they leave */
+  rwl->nSharedAccessCount = -(int) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->nCompletedSharedAccessCount,
+								    (PTW32_INTERLOCKED_LONG) 0);
 
   (void) pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
   (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
@@ -40,38 +40,40 @@
 INLINE int
 ptw32_rwlock_check_need_init (pthread_rwlock_t * rwlock)
 {
-  int result = 0;
-  ptw32_mcs_local_node_t node;
+  int result;
+  pthread_rwlock_t rwl;
 
-  /*
-   * The following guarded test is specifically for statically
-   * initialised rwlocks (via PTHREAD_RWLOCK_INITIALIZER).
-   */
-  ptw32_mcs_lock_acquire(&ptw32_rwlock_test_init_lock, &node);
+  if (*rwlock != PTHREAD_RWLOCK_INITIALIZER)
+    {
+      /*
+       * Another thread initialised the rwlock first, or it has been
+       * destroyed, in which case the operation that caused the
+       * auto-initialisation should fail.
+       */
+      return (*rwlock == NULL) ? EINVAL : 0;
+    }
 
   /*
-   * We got here possibly under race
-   * conditions. Check again inside the critical section
-   * and only initialise if the rwlock is valid (not been destroyed).
-   * If a static rwlock has been destroyed, the application can
-   * re-initialise it only by calling pthread_rwlock_init()
-   * explicitly.
+   * As for mutexes (see ptw32_mutex_check_need_init.c), build one and
+   * publish it if the static rwlock is still untouched.
    */
-  if (*rwlock == PTHREAD_RWLOCK_INITIALIZER)
+  if ((result = pthread_rwlock_init (&rwl, NULL)) != 0)
     {
-      result = pthread_rwlock_init (rwlock, NULL);
+      return result;
     }
-  else if (*rwlock == NULL)
+
+  if (PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) rwlock,
+						(PTW32_INTERLOCKED_PVOID) rwl,
+						(PTW32_INTERLOCKED_PVOID) PTHREAD_RWLOCK_INITIALIZER)
+      != (PTW32_INTERLOCKED_PVOID) PTHREAD_RWLOCK_INITIALIZER)
     {
-      /*
-       * The rwlock has been destroyed while we were waiting to
-       * initialise it, so the operation that caused the
-       * auto-initialisation should fail.
-       */
-      result = EINVAL;
-    }
+      (void) pthread_rwlock_destroy (&rwl);
 
-  ptw32_mcs_lock_release(&node);
+      if (*rwlock == NULL)
+	{
+	  result = EINVAL;
+	}
+    }
 
   return result;
 }
@@ -0,0 +1,710 @@
+/*
+ * ptw32_rwlock_policy.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * Read/write locks with an explicit preference policy, selected with
+ * pthread_rwlockattr_setkind_np().
+ *
+ * The owners of the lock, active readers and a writer, are counted in
+ * one word, lockWord. pthread_rwlock_tryrdlock and trywrlock take the
+ * lock with a single CAS on it and never touch stateLock, so they
+ * can't wait. Everything else (the waiting counts, the upgrader, and
+ * all decisions about waiters) is guarded by stateLock, and changes
+ * lockWord with CAS too as a try-lock may change it at any time. A
+ * try-lock that slips in where a waiter was about to be granted the
+ * lock merely leaves the grant to its own unlock, which always takes
+ * stateLock. Blocked readers and writers
+ * wait on the semReaders and semWriters semaphores. Ownership is handed
+ * off directly: the thread that releases the lock decides who gets it
+ * next according to the policy, records them as owners and only then
+ * posts the semaphore, so woken threads never have to compete again.
+ *
+ * Semaphore tokens are not tied to a particular waiter. A waiter that
+ * times out retakes stateLock and consumes a token if one is available,
+ * in which case it was granted the lock while timing out and keeps it;
+ * otherwise it removes itself from the waiting count.
+ *
+ *   PTHREAD_RWLOCK_PREFER_READER_NP
+ *      Readers enter whenever no writer holds the lock. A released
+ *      write lock goes to all waiting readers first.
+ *
+ *   PTHREAD_RWLOCK_PREFER_WRITER_NP
+ *      Readers don't enter while a writer waits. A released write
+ *      lock goes to the next writer first.
+ *
+ *   PTHREAD_RWLOCK_PHASE_FAIR_NP
+ *      Readers don't enter while a writer waits, but a released write
+ *      lock goes to all readers that were waiting for it. Read and
+ *      write phases therefore alternate while both are waiting; a
+ *      reader waits for at most one write phase and a writer for at
+ *      most one read phase per writer ahead of it.
+ *
+ * One reader at a time may hold the lock upgradable. It counts as a
+ * reader and is admitted as one, except that it also excludes other
+ * upgradable readers, which wait on semUpgraders. To upgrade, it holds
+ * off new readers and waits on semUpgrade until the last other reader
+ * leaves, which makes it the writer; as it never gave up its read lock,
+ * nothing can have been written in between. Downgrading turns the
+ * writer into a reader and admits the readers waiting for it that the
+ * policy would admit alongside a reader.
+ */
+
+#include <limits.h>
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Add 'n' readers to lockWord unless a writer holds the lock.
+ */
+static int
+ptw32_rwlock_policy_addreaders (pthread_rwlock_t rwl, LONG n)
+{
+  LONG v;
+
+  do
+    {
+      v = rwl->lockWord;
+      if (v & PTW32_RWLOCK_WRITER)
+	{
+	  return PTW32_FALSE;
+	}
+    }
+  while ((PTW32_INTERLOCKED_LONG) v !=
+	 PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->lockWord,
+						 (PTW32_INTERLOCKED_LONG) (v + n * PTW32_RWLOCK_READER),
+						 (PTW32_INTERLOCKED_LONG) v));
+
+  return PTW32_TRUE;
+}
+
+/*
+ * Change lockWord from 'from' to the writer.
+ */
+static int
+ptw32_rwlock_policy_setwriter (pthread_rwlock_t rwl, LONG from)
+{
+  return (PTW32_INTERLOCKED_LONG) from ==
+	 PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->lockWord,
+						 (PTW32_INTERLOCKED_LONG) PTW32_RWLOCK_WRITER,
+						 (PTW32_INTERLOCKED_LONG) from);
+}
+
+/*
+ * Take a read lock if the policy lets a reader in now. The waiting
+ * counts are read without stateLock; at worst a reader gets in just
+ * as a writer starts to wait, as it could have a moment earlier.
+ */
+static int
+ptw32_rwlock_policy_tryread (pthread_rwlock_t rwl)
+{
+  if (*((int volatile *) &rwl->upgradePending)
+      || (rwl->kind != PTHREAD_RWLOCK_PREFER_READER_NP
+	  && *((int volatile *) &rwl->nWaitingWriters) != 0))
+    {
+      return PTW32_FALSE;
+    }
+
+  return ptw32_rwlock_policy_addreaders (rwl, 1);
+}
+
+static int
+ptw32_rwlock_policy_trywrite (pthread_rwlock_t rwl)
+{
+  return rwl->lockWord == 0
+	 && *((int volatile *) &rwl->nWaitingWriters) == 0
+	 && ptw32_rwlock_policy_setwriter (rwl, 0);
+}
+
+/*
+ * Admit the waiting readers and, if the upgradable read lock is free,
+ * one waiting upgradable reader, unless a try-lock has just taken the
+ * write lock. Called with stateLock held.
+ */
+static void
+ptw32_rwlock_policy_admit (pthread_rwlock_t rwl)
+{
+  if (rwl->nWaitingUpgraders > 0 && !rwl->upgraderActive
+      && ptw32_rwlock_policy_addreaders (rwl, 1))
+    {
+      rwl->nWaitingUpgraders--;
+      rwl->upgraderActive = 1;
+      (void) PTW32_RELEASESEMAPHORE (rwl->semUpgraders, 1, NULL);
+    }
+
+  if (rwl->nWaitingReaders > 0
+      && ptw32_rwlock_policy_addreaders (rwl, rwl->nWaitingReaders))
+    {
+      (void) PTW32_RELEASESEMAPHORE (rwl->semReaders, rwl->nWaitingReaders, NULL);
+      rwl->nWaitingReaders = 0;
+    }
+}
+
+/*
+ * Hand the lock to the waiters the policy selects, if any.
+ * Called with stateLock held and the lock free.
+ */
+static void
+ptw32_rwlock_policy_grant (pthread_rwlock_t rwl, int fromWriter)
+{
+  int readersFirst = (rwl->kind == PTHREAD_RWLOCK_PREFER_READER_NP
+		      || (rwl->kind == PTHREAD_RWLOCK_PHASE_FAIR_NP && fromWriter));
+
+  if (rwl->nWaitingWriters > 0
+      && (!readersFirst
+	  || (rwl->nWaitingReaders == 0 && rwl->nWaitingUpgraders == 0)))
+    {
+      if (ptw32_rwlock_policy_setwriter (rwl, 0))
+	{
+	  rwl->nWaitingWriters--;
+	  (void) PTW32_RELEASESEMAPHORE (rwl->semWriters, 1, NULL);
+	}
+    }
+  else
+    {
+      ptw32_rwlock_policy_admit (rwl);
+    }
+}
+
+/*
+ * The upgradable reader becomes the writer if it is the only reader.
+ * Called with stateLock held.
+ */
+static int
+ptw32_rwlock_policy_promote (pthread_rwlock_t rwl)
+{
+  if (!ptw32_rwlock_policy_setwriter (rwl, PTW32_RWLOCK_READER))
+    {
+      return PTW32_FALSE;
+    }
+
+  rwl->upgraderActive = 0;
+  rwl->upgrader = NULL;
+  rwl->upgradePending = 0;
+
+  return PTW32_TRUE;
+}
+
+/*
+ * Block on a semaphore for a grant until abstime (NULL: forever).
+ * Called with stateLock held, having counted ourselves as a waiter in
+ * *waiting; returns with stateLock held.
+ */
+static int
+ptw32_rwlock_policy_block (pthread_rwlock_t rwl, HANDLE sem, int * waiting,
+			   const struct timespec *abstime,
+			   ptw32_mcs_local_node_t * node)
+{
+  DWORD status;
+  DWORD milliseconds;
+  HANDLE handles[2];
+
+  ptw32_mcs_lock_release (node);
+
+  /*
+   * handles[1] is a high resolution timer for abstime, if any.
+   */
+  handles[0] = sem;
+  milliseconds = ptw32_wait_timeout (CLOCK_REALTIME, abstime, &handles[1]);
+
+  PTW32_LIBSTAT_WAIT ((sem == rwl->semWriters || sem == rwl->semUpgrade)
+		      ? PTW32_LIBSTAT_WAIT_RWLOCK_WRITE : PTW32_LIBSTAT_WAIT_RWLOCK);
+  status = ptw32_wait_objects ((handles[1] == NULL) ? 1 : 2, handles,
+			       milliseconds);
+
+  ptw32_mcs_lock_acquire (&rwl->stateLock, node);
+
+  if (status == WAIT_OBJECT_0)
+    {
+      return 0;
+    }
+
+  /*
+   * A grant may have been made since the wait gave up. If so it is
+   * ours to take, as tokens are interchangeable between waiters.
+   */
+  if (WaitForSingleObject (sem, 0) == WAIT_OBJECT_0)
+    {
+      return 0;
+    }
+
+  (*waiting)--;
+
+  /*
+   * A writer that gives up may have been holding back readers.
+   */
+  if (sem == rwl->semWriters && !(rwl->lockWord & PTW32_RWLOCK_WRITER)
+      && rwl->nWaitingWriters == 0)
+    {
+      ptw32_rwlock_policy_grant (rwl, 1);
+    }
+
+  return (status == WAIT_TIMEOUT || status == WAIT_OBJECT_0 + 1) ? ETIMEDOUT : EINVAL;
+}
+
+int
+ptw32_rwlock_policy_init (pthread_rwlock_t rwl, int kind)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Initialises a read/write lock of one of the
+      *      preference policy kinds.
+      *
+      *      PTHREAD_RWLOCK_ELIDE_NP locks prefer writers when
+      *      not elided (see ptw32_lock_elide.c).
+      *
+      * RESULTS
+      *              0               success,
+      *              EAGAIN          insufficient resources,
+      *              ENOMEM          insufficient memory,
+      *
+      * ------------------------------------------------------
+      */
+{
+  rwl->elide = NULL;
+  if (kind == PTHREAD_RWLOCK_ELIDE_NP)
+    {
+      kind = PTHREAD_RWLOCK_PREFER_WRITER_NP;
+      if (ptw32_lockElide && (rwl->elide = ptw32_lock_elide_new ()) == NULL)
+	{
+	  return ENOMEM;
+	}
+    }
+
+  rwl->kind = kind;
+  rwl->stateLock = 0;
+  rwl->lockWord = 0;
+  rwl->nWaitingReaders = 0;
+  rwl->nWaitingWriters = 0;
+  rwl->upgraderActive = 0;
+  rwl->upgrader = NULL;
+  rwl->upgradePending = 0;
+  rwl->nWaitingUpgraders = 0;
+  rwl->semUpgraders = NULL;
+  rwl->semUpgrade = NULL;
+
+  if ((rwl->semReaders = ptw32_libstat_handle (CreateSemaphore (NULL, 0, LONG_MAX, NULL),
+					       PTW32_LIBSTAT_SEMAPHORES)) == 0)
+    {
+      ptw32_object_free (rwl->elide);
+      return EAGAIN;
+    }
+
+  if ((rwl->semWriters = ptw32_libstat_handle (CreateSemaphore (NULL, 0, LONG_MAX, NULL),
+					       PTW32_LIBSTAT_SEMAPHORES)) == 0)
+    {
+      (void) ptw32_closehandle (rwl->semReaders, PTW32_LIBSTAT_SEMAPHORES);
+      ptw32_object_free (rwl->elide);
+      return EAGAIN;
+    }
+
+  return 0;
+}
+
+int
+ptw32_rwlock_policy_destroy (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Releases the resources of a preference policy
+      *      read/write lock if it is neither held nor waited for.
+      *
+      * RESULTS
+      *              0               success,
+      *              EBUSY           the lock is held or waited for,
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int busy;
+
+  ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+  busy = (rwl->lockWord != 0
+	  || rwl->nWaitingReaders > 0 || rwl->nWaitingWriters > 0
+	  || rwl->nWaitingUpgraders > 0);
+  if (!busy)
+    {
+      rwl->nMagic = 0;
+    }
+  ptw32_mcs_lock_release (&node);
+
+  if (busy)
+    {
+      return EBUSY;
+    }
+
+  (void) ptw32_closehandle (rwl->semReaders, PTW32_LIBSTAT_SEMAPHORES);
+  (void) ptw32_closehandle (rwl->semWriters, PTW32_LIBSTAT_SEMAPHORES);
+  if (rwl->semUpgraders != NULL)
+    {
+      (void) ptw32_closehandle (rwl->semUpgraders, PTW32_LIBSTAT_SEMAPHORES);
+      (void) ptw32_closehandle (rwl->semUpgrade, PTW32_LIBSTAT_SEMAPHORES);
+    }
+  ptw32_object_free (rwl->elide);
+
+  return 0;
+}
+
+int
+ptw32_rwlock_policy_rdlock (pthread_rwlock_t rwl,
+			    const struct timespec *abstime, int tryOnly)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Read locks a preference policy read/write lock,
+      *      waiting until 'abstime' (NULL: forever), or not at
+      *      all if 'tryOnly'.
+      *
+      * RESULTS
+      *              0               success,
+      *              EBUSY           'tryOnly' and the lock is not
+      *                              available,
+      *              ETIMEDOUT       'abstime' passed,
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int result = 0;
+
+  if (tryOnly)
+    {
+      return ptw32_rwlock_policy_tryread (rwl) ? 0 : EBUSY;
+    }
+
+  ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+
+  if (!ptw32_rwlock_policy_tryread (rwl))
+    {
+      rwl->nWaitingReaders++;
+      result = ptw32_rwlock_policy_block (rwl, rwl->semReaders,
+					  &rwl->nWaitingReaders, abstime, &node);
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
+
+int
+ptw32_rwlock_policy_wrlock (pthread_rwlock_t rwl,
+			    const struct timespec *abstime, int tryOnly)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Write locks a preference policy read/write lock,
+      *      waiting until 'abstime' (NULL: forever), or not at
+      *      all if 'tryOnly'.
+      *
+      * RESULTS
+      *              0               success,
+      *              EBUSY           'tryOnly' and the lock is held,
+      *              ETIMEDOUT       'abstime' passed,
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int result = 0;
+
+  if (tryOnly)
+    {
+      return ptw32_rwlock_policy_trywrite (rwl) ? 0 : EBUSY;
+    }
+
+  ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+
+  if (!ptw32_rwlock_policy_trywrite (rwl))
+    {
+      rwl->nWaitingWriters++;
+      result = ptw32_rwlock_policy_block (rwl, rwl->semWriters,
+					  &rwl->nWaitingWriters, abstime, &node);
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
+
+int
+ptw32_rwlock_policy_unlock (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Unlocks a preference policy read/write lock and
+      *      hands it to the next owners, if any.
+      *
+      * RESULTS
+      *              0               success,
+      *              EPERM           the lock is not held,
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int result = 0;
+
+  ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+
+  if (rwl->lockWord & PTW32_RWLOCK_WRITER)
+    {
+      /* Nobody else changes lockWord while the writer holds it */
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->lockWord,
+					      (PTW32_INTERLOCKED_LONG) 0);
+      ptw32_rwlock_policy_grant (rwl, 1);
+    }
+  else if (rwl->lockWord != 0)
+    {
+      LONG v;
+
+      if (rwl->upgrader != NULL && rwl->upgrader == PTW32_SELF_THREAD ())
+	{
+	  rwl->upgraderActive = 0;
+	  rwl->upgrader = NULL;
+	}
+
+      v = (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->lockWord,
+						      (PTW32_INTERLOCKED_LONG) -PTW32_RWLOCK_READER)
+	  - PTW32_RWLOCK_READER;
+
+      if (v == 0)
+	{
+	  ptw32_rwlock_policy_grant (rwl, 0);
+	}
+      else if (rwl->upgradePending)
+	{
+	  if (v == PTW32_RWLOCK_READER && ptw32_rwlock_policy_promote (rwl))
+	    {
+	      (void) PTW32_RELEASESEMAPHORE (rwl->semUpgrade, 1, NULL);
+	    }
+	}
+      else if (!rwl->upgraderActive && rwl->nWaitingUpgraders > 0
+	       && (rwl->kind == PTHREAD_RWLOCK_PREFER_READER_NP
+		   || rwl->nWaitingWriters == 0))
+	{
+	  ptw32_rwlock_policy_admit (rwl);
+	}
+    }
+  else
+    {
+      result = EPERM;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
+
+int
+ptw32_rwlock_policy_downgrade (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Turns the caller's write lock on a preference policy
+      *      read/write lock into a read lock, admitting the
+      *      waiting readers the policy lets in alongside it.
+      *
+      * RESULTS
+      *              0               success,
+      *              EPERM           the lock is not write locked,
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int result = 0;
+
+  ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+
+  if (rwl->lockWord & PTW32_RWLOCK_WRITER)
+    {
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->lockWord,
+					      (PTW32_INTERLOCKED_LONG) PTW32_RWLOCK_READER);
+
+      if (rwl->kind != PTHREAD_RWLOCK_PREFER_WRITER_NP || rwl->nWaitingWriters == 0)
+	{
+	  ptw32_rwlock_policy_admit (rwl);
+	}
+    }
+  else if (rwl->elide == NULL)
+    {
+      result = EPERM;
+    }
+  /* else the write lock was elided; reading on in the transaction is fine */
+
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
+
+int
+ptw32_rwlock_policy_rdlock_upgradable (pthread_rwlock_t rwl, int tryOnly)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Read locks a preference policy read/write lock so
+      *      that the caller may later upgrade, waiting unless
+      *      'tryOnly'.
+      *
+      * RESULTS
+      *              0               success,
+      *              EBUSY           'tryOnly' and the lock is not
+      *                              available,
+      *              EDEADLK         the caller already holds the
+      *                              upgradable read lock,
+      *              EAGAIN          insufficient resources,
+      *              ENOMEM          the caller has no POSIX handle
+      *                              and couldn't be given one,
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * self = (ptw32_thread_t *) pthread_self ().p;
+  ptw32_mcs_local_node_t node;
+  int result = 0;
+
+  if (self == NULL)
+    {
+      return ENOMEM;
+    }
+
+  ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+
+  if (rwl->semUpgraders == NULL)
+    {
+      if ((rwl->semUpgraders = ptw32_libstat_handle (CreateSemaphore (NULL, 0, LONG_MAX, NULL),
+						     PTW32_LIBSTAT_SEMAPHORES)) == NULL)
+	{
+	  result = EAGAIN;
+	}
+      else if ((rwl->semUpgrade = ptw32_libstat_handle (CreateSemaphore (NULL, 0, 1, NULL),
+							PTW32_LIBSTAT_SEMAPHORES)) == NULL)
+	{
+	  (void) ptw32_closehandle (rwl->semUpgraders, PTW32_LIBSTAT_SEMAPHORES);
+	  rwl->semUpgraders = NULL;
+	  result = EAGAIN;
+	}
+    }
+
+  if (0 != result)
+    {
+      /* Nothing */
+    }
+  else if (rwl->upgraderActive && rwl->upgrader == self)
+    {
+      result = EDEADLK;
+    }
+  else if (!rwl->upgraderActive && ptw32_rwlock_policy_tryread (rwl))
+    {
+      rwl->upgraderActive = 1;
+    }
+  else if (tryOnly)
+    {
+      result = EBUSY;
+    }
+  else
+    {
+      rwl->nWaitingUpgraders++;
+      result = ptw32_rwlock_policy_block (rwl, rwl->semUpgraders,
+					  &rwl->nWaitingUpgraders, NULL, &node);
+    }
+
+  if (0 == result)
+    {
+      /* A grant set upgraderActive for us */
+      rwl->upgrader = self;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
+
+int
+ptw32_rwlock_policy_upgrade (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Turns the caller's upgradable read lock on a
+      *      preference policy read/write lock into the write
+      *      lock, waiting for the other readers to leave. New
+      *      readers wait meanwhile.
+      *
+      * RESULTS
+      *              0               success,
+      *              EPERM           the caller doesn't hold the
+      *                              upgradable read lock,
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * self = PTW32_SELF_THREAD ();
+  ptw32_mcs_local_node_t node;
+  int result = 0;
+
+  ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+
+  if (!rwl->upgraderActive || rwl->upgrader != self || self == NULL)
+    {
+      result = EPERM;
+    }
+  else if (ptw32_rwlock_policy_promote (rwl))
+    {
+      /* We were the only reader */
+    }
+  else
+    {
+      /*
+       * The last other reader to leave promotes us. We can't time
+       * out, so the count of waiters is only a formality.
+       */
+      int waiting = 1;
+
+      rwl->upgradePending = 1;
+      if (0 != (result = ptw32_rwlock_policy_block (rwl, rwl->semUpgrade,
+						    &waiting, NULL, &node)))
+	{
+	  /* Still a reader; let the others in again */
+	  rwl->upgradePending = 0;
+	  ptw32_rwlock_policy_admit (rwl);
+	}
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
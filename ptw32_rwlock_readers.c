@@ -0,0 +1,328 @@
+/*
+ * ptw32_rwlock_readers.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * Distributed reader counting for read/write locks initialised with
+ * pthread_rwlockattr_setdistributed_np().
+ *
+ * Each reader increments one of nReaderSlots counters, each in its own
+ * cache line and chosen by thread ID, and then checks writerActive. A
+ * writer serialises with other writers on mtxExclusiveAccess, sets
+ * writerActive and waits on cndSharedAccessCompleted until every slot
+ * has drained. Readers that find writerActive set back out and block on
+ * mtxExclusiveAccess until the writer is done.
+ *
+ * The interlocked slot update and the writerActive exchange are both full
+ * fences, so either the reader sees writerActive or the writer sees the
+ * reader's slot. The reader that takes a slot to zero while a writer is
+ * active wakes it.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+static INLINE LONG *
+ptw32_rwlock_reader_slot (pthread_rwlock_t rwl)
+{
+  /* Thread IDs are multiples of 4 */
+  return &rwl->readerSlots[(GetCurrentThreadId () >> 2)
+			   & (rwl->nReaderSlots - 1)].count;
+}
+
+int
+ptw32_rwlock_readers_active (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns non-zero if any reader slot of a distributed
+      *      read/write lock is non-zero.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int i;
+
+  for (i = 0; i < rwl->nReaderSlots; i++)
+    {
+      if (0 != *((LONG volatile *) &rwl->readerSlots[i].count))
+	{
+	  return 1;
+	}
+    }
+
+  return 0;
+}
+
+static INLINE int
+ptw32_rwlock_reader_release (pthread_rwlock_t rwl, LONG * slot)
+{
+  int result = 0;
+
+  if (0 == PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) slot)
+      && 0 != *((LONG volatile *) &rwl->writerActive))
+    {
+      if ((result = pthread_mutex_lock (&(rwl->mtxSharedAccessCompleted))) == 0)
+	{
+	  result = pthread_cond_signal (&(rwl->cndSharedAccessCompleted));
+	  (void) pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
+	}
+    }
+
+  return result;
+}
+
+static void PTW32_CDECL
+ptw32_rwlock_readers_cancelwrwait (void *arg)
+{
+  pthread_rwlock_t rwl = (pthread_rwlock_t) arg;
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->writerActive,
+					  (PTW32_INTERLOCKED_LONG) 0);
+  (void) pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
+  (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+}
+
+int
+ptw32_rwlock_readers_init (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Allocates the reader slots of a distributed read/write
+      *      lock: one per processor, rounded up to a power of two
+      *      and at most PTW32_RWLOCK_MAX_READER_SLOTS.
+      *
+      * RESULTS
+      *              0               success,
+      *              ENOMEM          insufficient memory,
+      *
+      * ------------------------------------------------------
+      */
+{
+  int cpus;
+  int n = 1;
+
+  if (0 != ptw32_getprocessors (&cpus))
+    {
+      cpus = 1;
+    }
+
+  while (n < cpus && n < PTW32_RWLOCK_MAX_READER_SLOTS)
+    {
+      n <<= 1;
+    }
+
+  rwl->readerSlots = (ptw32_rwlock_slot_t *) calloc (n, sizeof (ptw32_rwlock_slot_t));
+
+  if (rwl->readerSlots == NULL)
+    {
+      return ENOMEM;
+    }
+
+  rwl->nReaderSlots = n;
+  rwl->writerActive = 0;
+
+  return 0;
+}
+
+int
+ptw32_rwlock_readers_rdlock (pthread_rwlock_t rwl,
+			     const struct timespec *abstime, int tryOnly)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Read locks a distributed read/write lock. Waits for
+      *      an active writer until 'abstime' (NULL: forever), or
+      *      not at all if 'tryOnly'.
+      *
+      * RESULTS
+      *              0               success,
+      *              EBUSY           'tryOnly' and a writer is active,
+      *              ETIMEDOUT       'abstime' passed,
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG * slot = ptw32_rwlock_reader_slot (rwl);
+  int result;
+
+  for (;;)
+    {
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) slot);
+
+      if (0 == *((LONG volatile *) &rwl->writerActive))
+	{
+	  return 0;
+	}
+
+      /* A writer is active or waiting: back out and wait for it. */
+      if ((result = ptw32_rwlock_reader_release (rwl, slot)) != 0)
+	{
+	  return result;
+	}
+
+      if (tryOnly)
+	{
+	  return EBUSY;
+	}
+
+      result = (abstime == NULL)
+	       ? pthread_mutex_lock (&(rwl->mtxExclusiveAccess))
+	       : pthread_mutex_timedlock (&(rwl->mtxExclusiveAccess), abstime);
+
+      if (result != 0)
+	{
+	  return result;
+	}
+
+      (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+    }
+}
+
+int
+ptw32_rwlock_readers_wrlock (pthread_rwlock_t rwl,
+			     const struct timespec *abstime, int tryOnly)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Write locks a distributed read/write lock. Waits for
+      *      other writers and readers until 'abstime' (NULL:
+      *      forever), or not at all if 'tryOnly'.
+      *
+      * RESULTS
+      *              0               success,
+      *              EBUSY           'tryOnly' and the lock is held,
+      *              ETIMEDOUT       'abstime' passed,
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result;
+
+  if (tryOnly)
+    {
+      result = pthread_mutex_trylock (&(rwl->mtxExclusiveAccess));
+    }
+  else if (abstime == NULL)
+    {
+      result = pthread_mutex_lock (&(rwl->mtxExclusiveAccess));
+    }
+  else
+    {
+      result = pthread_mutex_timedlock (&(rwl->mtxExclusiveAccess), abstime);
+    }
+
+  if (result != 0)
+    {
+      return result;
+    }
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->writerActive,
+					  (PTW32_INTERLOCKED_LONG) 1);
+
+  if (ptw32_rwlock_readers_active (rwl))
+    {
+      if (tryOnly)
+	{
+	  result = EBUSY;
+	}
+      else if ((result = pthread_mutex_lock (&(rwl->mtxSharedAccessCompleted))) == 0)
+	{
+	  /*
+	   * This routine may be a cancellation point
+	   * according to POSIX 1003.1j section 18.1.2.
+	   */
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth(0)
+#endif
+	  pthread_cleanup_push (ptw32_rwlock_readers_cancelwrwait, (void *) rwl);
+
+	  while (result == 0 && ptw32_rwlock_readers_active (rwl))
+	    {
+	      result = (abstime == NULL)
+		       ? pthread_cond_wait (&(rwl->cndSharedAccessCompleted),
+					    &(rwl->mtxSharedAccessCompleted))
+		       : pthread_cond_timedwait (&(rwl->cndSharedAccessCompleted),
+						 &(rwl->mtxSharedAccessCompleted),
+						 abstime);
+	    }
+
+	  pthread_cleanup_pop (0);
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth()
+#endif
+
+	  (void) pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
+	}
+
+      if (result != 0)
+	{
+	  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->writerActive,
+						  (PTW32_INTERLOCKED_LONG) 0);
+	  (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+	  return result;
+	}
+    }
+
+  rwl->nExclusiveAccessCount = 1;
+
+  return 0;
+}
+
+int
+ptw32_rwlock_readers_unlock (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Unlocks a distributed read/write lock held by the
+      *      calling thread.
+      *
+      * RESULTS
+      *              0               success,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (rwl->nExclusiveAccessCount == 0)
+    {
+      return ptw32_rwlock_reader_release (rwl, ptw32_rwlock_reader_slot (rwl));
+    }
+
+  rwl->nExclusiveAccessCount = 0;
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->writerActive,
+					  (PTW32_INTERLOCKED_LONG) 0);
+
+  return pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+}
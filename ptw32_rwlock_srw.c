@@ -0,0 +1,252 @@
+/*
+ * ptw32_rwlock_srw.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * Read/write locks of the default kind built on a Windows Slim
+ * Reader/Writer lock (see PTW32_RWLOCK_USES_SRW). Such a lock needs no
+ * kernel objects, so the mutexes and condvar aren't created.
+ *
+ * SRW locks have no timed acquire. The timed lock calls therefore
+ * poll with TryAcquire, parking between attempts on srwGeneration,
+ * which unlock bumps and wakes whenever nSrwTimedWaiters is non-zero.
+ * A timed waiter raises nSrwTimedWaiters before its attempt and unlock
+ * reads it after releasing the SRW lock, both with full fences, so an
+ * unlock can't slip between a failed attempt and the wait unnoticed.
+ * Timed waiters don't queue in the SRW lock and so may be overtaken.
+ *
+ * An untimed lock that can't be had at once is timed as a blocking
+ * wait (see ptw32_wait_end) around its AcquireSRWLock call.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+typedef BOOLEAN (WINAPI *ptw32_srw_try_t) (PVOID *);
+
+static int
+ptw32_rwlock_srw_timedlock (pthread_rwlock_t rwl, ptw32_srw_try_t tryLock,
+			    const struct timespec *abstime)
+{
+  LONG generation;
+  int result = 0;
+
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->nSrwTimedWaiters);
+
+  for (;;)
+    {
+      generation = *((LONG volatile *) &rwl->srwGeneration);
+
+      if (tryLock (&rwl->srwLock))
+	{
+	  break;
+	}
+
+      if (ptw32_rel100nanosecs (CLOCK_REALTIME, abstime) == 0)
+	{
+	  result = ETIMEDOUT;
+	  break;
+	}
+
+      PTW32_LIBSTAT_WAIT ((tryLock == ptw32_tryacquiresrwlockexclusive)
+			  ? PTW32_LIBSTAT_WAIT_RWLOCK_WRITE : PTW32_LIBSTAT_WAIT_RWLOCK);
+      (void) ptw32_waitonaddress_abstime (&rwl->srwGeneration, &generation,
+					  sizeof (rwl->srwGeneration),
+					  CLOCK_REALTIME, abstime);
+    }
+
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->nSrwTimedWaiters);
+
+  return result;
+}
+
+int
+ptw32_rwlock_srw_destroy (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Checks that an SRW lock based read/write lock is
+      *      neither held nor waited for, and invalidates it.
+      *
+      * RESULTS
+      *              0               success,
+      *              EBUSY           the lock is held or waited for,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (!ptw32_tryacquiresrwlockexclusive (&rwl->srwLock))
+    {
+      return EBUSY;
+    }
+
+  if (0 != PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->nSrwTimedWaiters,
+						(PTW32_INTERLOCKED_LONG) 0))
+    {
+      ptw32_releasesrwlockexclusive (&rwl->srwLock);
+      return EBUSY;
+    }
+
+  rwl->nMagic = 0;
+  ptw32_releasesrwlockexclusive (&rwl->srwLock);
+
+  return 0;
+}
+
+int
+ptw32_rwlock_srw_rdlock (pthread_rwlock_t rwl,
+			 const struct timespec *abstime, int tryOnly)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Read locks an SRW lock based read/write lock,
+      *      waiting until 'abstime' (NULL: forever), or not at
+      *      all if 'tryOnly'.
+      *
+      * RESULTS
+      *              0               success,
+      *              EBUSY           'tryOnly' and the lock is not
+      *                              available,
+      *              ETIMEDOUT       'abstime' passed,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (tryOnly)
+    {
+      return ptw32_tryacquiresrwlockshared (&rwl->srwLock) ? 0 : EBUSY;
+    }
+
+  if (abstime != NULL)
+    {
+      return ptw32_rwlock_srw_timedlock (rwl, ptw32_tryacquiresrwlockshared, abstime);
+    }
+
+  if (!ptw32_tryacquiresrwlockshared (&rwl->srwLock))
+    {
+      int64_t start;
+
+      PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_RWLOCK);
+      start = ptw32_wait_begin ();
+      ptw32_acquiresrwlockshared (&rwl->srwLock);
+      ptw32_wait_end (start);
+    }
+
+  return 0;
+}
+
+int
+ptw32_rwlock_srw_wrlock (pthread_rwlock_t rwl,
+			 const struct timespec *abstime, int tryOnly)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Write locks an SRW lock based read/write lock,
+      *      waiting until 'abstime' (NULL: forever), or not at
+      *      all if 'tryOnly'.
+      *
+      * RESULTS
+      *              0               success,
+      *              EBUSY           'tryOnly' and the lock is held,
+      *              ETIMEDOUT       'abstime' passed,
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result = 0;
+
+  if (tryOnly)
+    {
+      if (!ptw32_tryacquiresrwlockexclusive (&rwl->srwLock))
+	{
+	  result = EBUSY;
+	}
+    }
+  else if (abstime != NULL)
+    {
+      result = ptw32_rwlock_srw_timedlock (rwl, ptw32_tryacquiresrwlockexclusive, abstime);
+    }
+  else if (!ptw32_tryacquiresrwlockexclusive (&rwl->srwLock))
+    {
+      int64_t start;
+
+      PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_RWLOCK_WRITE);
+      start = ptw32_wait_begin ();
+      ptw32_acquiresrwlockexclusive (&rwl->srwLock);
+      ptw32_wait_end (start);
+    }
+
+  if (result == 0)
+    {
+      /* Tells unlock which way the lock is held */
+      rwl->nExclusiveAccessCount = 1;
+    }
+
+  return result;
+}
+
+int
+ptw32_rwlock_srw_unlock (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Unlocks an SRW lock based read/write lock held by
+      *      the calling thread and wakes any timed waiters.
+      *
+      * RESULTS
+      *              0               success,
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (rwl->nExclusiveAccessCount == 0)
+    {
+      ptw32_releasesrwlockshared (&rwl->srwLock);
+    }
+  else
+    {
+      rwl->nExclusiveAccessCount = 0;
+      ptw32_releasesrwlockexclusive (&rwl->srwLock);
+    }
+
+  if (0 != PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->nSrwTimedWaiters,
+						(PTW32_INTERLOCKED_LONG) 0))
+    {
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->srwGeneration);
+      ptw32_wakebyaddressall (&rwl->srwGeneration);
+    }
+
+  return 0;
+}
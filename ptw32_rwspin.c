@@ -0,0 +1,125 @@
+/*
+ * ptw32_rwspin.c
+ *
+ * Description:
+ * This translation unit implements spin lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+
+#include "pthread.h"
+#include "implement.h"
+
+
+INLINE int
+ptw32_rwspin_check_need_init (pthread_rwspinlock_np_t * lock)
+{
+  int result;
+  pthread_rwspinlock_np_t l;
+
+  if (*lock != PTHREAD_RWSPINLOCK_INITIALIZER_NP)
+    {
+      /*
+       * Another thread initialised the lock first, or it has been
+       * destroyed, in which case the operation that caused the
+       * auto-initialisation should fail.
+       */
+      return (*lock == NULL) ? EINVAL : 0;
+    }
+
+  /*
+   * As for spinlocks (see ptw32_spinlock_check_need_init.c), build one
+   * and publish it if the static lock is still untouched.
+   */
+  if ((result = pthread_rwspin_init_np (&l, PTHREAD_PROCESS_PRIVATE)) != 0)
+    {
+      return result;
+    }
+
+  if (PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) lock,
+						(PTW32_INTERLOCKED_PVOID) l,
+						(PTW32_INTERLOCKED_PVOID) PTHREAD_RWSPINLOCK_INITIALIZER_NP)
+      != (PTW32_INTERLOCKED_PVOID) PTHREAD_RWSPINLOCK_INITIALIZER_NP)
+    {
+      (void) pthread_rwspin_destroy_np (&l);
+
+      if (*lock == NULL)
+	{
+	  result = EINVAL;
+	}
+    }
+
+  return result;
+}
+
+
+INLINE void
+ptw32_rwspin_wait (pthread_rwspinlock_np_t l, LONG seen, ptw32_rwspin_wait_t * w)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      One round of waiting for a reader-writer spin lock
+      *      to change from 'seen': processor hints with
+      *      exponential backoff up to ptw32_spinBackoffLimit, as
+      *      pthread_spin_lock() makes. The waiter yields the
+      *      processor instead where ptw32_spin_pays() says the
+      *      holder can't run meanwhile, and after
+      *      ptw32_spinYieldLimit hints in case it was preempted.
+      *
+      *      'w' must be zeroed before the first round.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int i;
+
+  if (0 == w->backoff)
+    {
+      w->backoff = 1;
+      w->pays = ptw32_spin_pays ();
+    }
+
+  for (i = 0; w->pays && i < w->backoff; i++)
+    {
+      PTW32_SPIN_WAIT_LONG (&l->state, seen);
+    }
+  w->spun += w->backoff;
+  if (w->backoff < ptw32_spinBackoffLimit)
+    {
+      w->backoff <<= 1;
+    }
+
+  if (!w->pays || w->spun >= ptw32_spinYieldLimit)
+    {
+      (void) SwitchToThread ();
+      w->spun = 0;
+    }
+}
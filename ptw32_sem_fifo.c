@@ -0,0 +1,372 @@
+/*
+ * ptw32_sem_fifo.c
+ *
+ * Description:
+ * This translation unit implements semaphore primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "semaphore.h"
+#include "implement.h"
+
+/*
+ * A FIFO semaphore keeps "value" as other semaphores do, units minus
+ * waiters, but its blocked waiters queue in f->head..f->tail under
+ * f->lock rather than on the kernel semaphore. A negative value is
+ * only changed under f->lock, and then counts the queued waiters
+ * exactly. The lock-free paths (sem_trywait, the asynchronous waits,
+ * and posts that find the value non-negative) only move the value
+ * while it is non-negative, so they can't take a unit that a queued
+ * waiter is owed.
+ *
+ * A post that finds the value negative hands its units to the
+ * waiters at the head of the queue (their state becomes GRANTED) and
+ * wakes them by address. The queue is in arrival order, or for
+ * SEM_PRIORITY_NP in order of the waiters' priorities when they
+ * queued, highest first, and in arrival order within a priority.
+ */
+
+#if !defined(NEED_SEM)
+
+typedef struct
+{
+  sem_t s;
+  ptw32_sem_waiter_t * w;
+} ptw32_sem_fifo_cleanup_args_t;
+
+
+static void
+ptw32_sem_fifo_enqueue (ptw32_sem_fifo_t * f, ptw32_sem_waiter_t * w)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Queues a waiter whose priority is set. Called with
+      *      the queue lock held.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_sem_waiter_t * prev = f->tail;
+  ptw32_sem_waiter_t * p;
+
+  if (prev != NULL && prev->priority < w->priority)
+    {
+      /* Behind the last waiter of at least our priority */
+      prev = NULL;
+      for (p = f->head; p->priority >= w->priority; p = p->next)
+	{
+	  prev = p;
+	}
+    }
+
+  if (prev == NULL)
+    {
+      w->next = f->head;
+      f->head = w;
+    }
+  else
+    {
+      w->next = prev->next;
+      prev->next = w;
+    }
+
+  if (w->next == NULL)
+    {
+      f->tail = w;
+    }
+}
+
+
+static int
+ptw32_sem_fifo_withdraw (sem_t s, ptw32_sem_waiter_t * w)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Removes a waiter that gave up from the queue, unless
+      *      a post has handed it a unit meanwhile.
+      *
+      * RESULTS
+      *              PTW32_TRUE      the waiter owns a unit,
+      *              PTW32_FALSE     the waiter was withdrawn.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_sem_fifo_t * f = s->fifo;
+  ptw32_sem_waiter_t * prev = NULL;
+  ptw32_sem_waiter_t * p;
+  ptw32_mcs_local_node_t node;
+  int granted;
+
+  ptw32_mcs_lock_acquire (&f->lock, &node);
+
+  granted = (w->state == PTW32_SEM_WAITER_GRANTED);
+
+  if (!granted)
+    {
+      for (p = f->head; p != w; p = p->next)
+	{
+	  prev = p;
+	}
+
+      if (prev == NULL)
+	{
+	  f->head = w->next;
+	}
+      else
+	{
+	  prev->next = w->next;
+	}
+
+      if (f->tail == w)
+	{
+	  f->tail = prev;
+	}
+
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->value);
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return granted;
+}
+
+
+static void PTW32_CDECL
+ptw32_sem_fifo_cleanup (void * args)
+{
+  ptw32_sem_fifo_cleanup_args_t * a = (ptw32_sem_fifo_cleanup_args_t *) args;
+
+  /*
+   * Cancelled. A unit handed over meanwhile goes to the next waiter.
+   */
+  if (ptw32_sem_fifo_withdraw (a->s, a->w))
+    {
+      (void) ptw32_sem_fifo_post (a->s, 1);
+    }
+
+  ptw32_sem_release (a->s);
+}
+
+
+int
+ptw32_sem_fifo_wait (sem_t s, clockid_t clock, const struct timespec * abstime)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Takes a unit of a FIFO semaphore, queueing behind
+      *      the threads already waiting for one (of at least
+      *      the caller's priority, for SEM_PRIORITY_NP) if
+      *      there are none free. 'clock' may be PTW32_CLOCK_RELATIVE.
+      *
+      *      If 'abstime' is a NULL pointer then this function
+      *      will block until it is handed a unit.
+      *
+      *      This routine is a cancellation point.
+      *
+      * RESULTS
+      *              0               the thread owns a unit,
+      *              ETIMEDOUT       abstime passed,
+      *              EINVAL          the wait failed.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_sem_fifo_t * f = s->fifo;
+  ptw32_sem_waiter_t w;
+  ptw32_mcs_local_node_t node;
+  ptw32_sem_fifo_cleanup_args_t cleanup_args;
+  ptw32_thread_t * self;
+  LONG queued = PTW32_SEM_WAITER_QUEUED;
+  struct timespec deadline;
+  LONG v;
+  int result = 0;
+
+  while ((v = *((LONG volatile *) &s->value)) > 0)
+    {
+      if ((PTW32_INTERLOCKED_LONG) v ==
+	  PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->value,
+						  (PTW32_INTERLOCKED_LONG) (v - 1),
+						  (PTW32_INTERLOCKED_LONG) v))
+	{
+	  return 0;
+	}
+    }
+
+  w.priority = 0;
+  if (f->byPriority && (self = (ptw32_thread_t *) pthread_self ().p) != NULL)
+    {
+      w.priority = PTW32_WAIT_PRIORITY (self);
+    }
+
+  ptw32_mcs_lock_acquire (&f->lock, &node);
+
+  if ((LONG) PTW32_ATOMIC_EXCHANGE_ADD_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->value,
+						 (PTW32_INTERLOCKED_LONG) -1) > 0)
+    {
+      /* Posted meanwhile */
+      ptw32_mcs_lock_release (&node);
+      return 0;
+    }
+
+  /* See ptw32_sem_release.c */
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->refs);
+
+  w.state = PTW32_SEM_WAITER_QUEUED;
+  ptw32_sem_fifo_enqueue (f, &w);
+
+  ptw32_mcs_lock_release (&node);
+
+  /* Spurious wakeups may sleep again */
+  if (clock == PTW32_CLOCK_RELATIVE)
+    {
+      ptw32_monotonic_deadline (clock, abstime, &deadline);
+      clock = CLOCK_MONOTONIC;
+      abstime = &deadline;
+    }
+
+  cleanup_args.s = s;
+  cleanup_args.w = &w;
+
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth(0)
+#endif
+  pthread_cleanup_push (ptw32_sem_fifo_cleanup, (void *) &cleanup_args);
+
+  while (result == 0 && w.state == PTW32_SEM_WAITER_QUEUED)
+    {
+      result = ptw32_wait_on_address ((volatile void *) &w.state, &queued,
+				      sizeof (queued), clock, abstime,
+				      PTW32_LIBSTAT_WAIT_SEM);
+    }
+
+  pthread_cleanup_pop (0);
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth()
+#endif
+
+  if (result != 0 && ptw32_sem_fifo_withdraw (s, &w))
+    {
+      result = 0;
+    }
+
+  ptw32_sem_release (s);
+
+  return (result == 0 || result == ETIMEDOUT) ? result : EINVAL;
+}
+
+
+int
+ptw32_sem_fifo_post (sem_t s, int count)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Posts 'count' units to a FIFO semaphore, handing
+      *      them to the longest waiters first. The rest are
+      *      free for anyone.
+      *
+      * RESULTS
+      *              0               posted,
+      *              ERANGE          semaphore count is too big.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_sem_fifo_t * f = s->fifo;
+  ptw32_sem_waiter_t * w;
+  ptw32_mcs_local_node_t node;
+  int locked = PTW32_FALSE;
+  LONG v;
+
+  for (;;)
+    {
+      v = *((LONG volatile *) &s->value);
+
+      if (v < 0 && !locked)
+	{
+	  /* Waiters are queued: the value is stable under the lock */
+	  ptw32_mcs_lock_acquire (&f->lock, &node);
+	  locked = PTW32_TRUE;
+	  continue;
+	}
+
+      if (v > SEM_VALUE_MAX - count)
+	{
+	  if (locked)
+	    {
+	      ptw32_mcs_lock_release (&node);
+	    }
+	  return ERANGE;
+	}
+
+      if ((PTW32_INTERLOCKED_LONG) v ==
+	  PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->value,
+						   (PTW32_INTERLOCKED_LONG) (v + count),
+						   (PTW32_INTERLOCKED_LONG) v))
+	{
+	  break;
+	}
+    }
+
+  /*
+   * A granted waiter may return as soon as its state changes, so it
+   * is woken by address; waking an address that is no longer waited
+   * on is harmless.
+   */
+  while (v < 0 && count > 0)
+    {
+      w = f->head;
+      if ((f->head = w->next) == NULL)
+	{
+	  f->tail = NULL;
+	}
+      w->state = PTW32_SEM_WAITER_GRANTED;
+      ptw32_wakebyaddresssingle ((PVOID) &w->state);
+      v++;
+      count--;
+    }
+
+  if (locked)
+    {
+      ptw32_mcs_lock_release (&node);
+    }
+
+  if (count > 0)
+    {
+      /* Units are free for asynchronous waiters */
+      (void) ptw32_async_wake ((volatile VOID *) &s->value, PTW32_TRUE);
+    }
+
+  return 0;
+}
+
+#endif /* NEED_SEM */
@@ -0,0 +1,75 @@
+/*
+ * ptw32_sem_release.c
+ *
+ * Description:
+ * This translation unit implements mutual exclusion (mutex) primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "semaphore.h"
+#include "implement.h"
+
+
+void
+ptw32_sem_release (sem_t s)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Drops a reference to a process private semaphore.
+      *      sem_init() gives the semaphore one reference, which
+      *      sem_destroy() drops, and every thread that blocks on
+      *      the semaphore holds another until it stops touching it.
+      *
+      *      Whoever drops the last reference closes the kernel
+      *      object and frees the semaphore, so sem_destroy()
+      *      never waits for woken waiters to leave: it either
+      *      frees the semaphore at once or leaves that to the
+      *      last of them.
+      *
+      * RESULTS
+      *              N/A
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (0 == PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->refs))
+    {
+#if defined(NEED_SEM)
+      (void) ptw32_closehandle (s->sem, PTW32_LIBSTAT_EVENTS);
+#else
+      (void) ptw32_closehandle (s->sem, PTW32_LIBSTAT_SEMAPHORES);
+#endif
+      (void) pthread_mutex_destroy (&s->lock);
+      ptw32_object_free (s->fifo);
+      ptw32_object_free (s);
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ * ptw32_sem_unwait.c
+ *
+ * Description:
+ * This translation unit implements mutual exclusion (mutex) primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#if !defined(_UWIN)
+/*#   include <process.h> */
+#endif
+#include "pthread.h"
+#include "implement.h"
+
+
+#if !defined(NEED_SEM)
+int
+ptw32_sem_decrement (sem_t s)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Takes a unit of a semaphore, or counts the calling
+      *      thread as a waiter in the negative semaphore value.
+      *
+      *      A thread that is to block first takes a reference to
+      *      the semaphore, which it must drop with
+      *      ptw32_sem_release() once it has been posted or has
+      *      withdrawn. A thread that gets a unit straight away
+      *      doesn't touch the reference count.
+      *
+      * RESULTS
+      *              The new semaphore value; the caller must wait
+      *              if it is negative.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG v;
+
+  while ((v = *((LONG volatile *) &s->value)) > 0)
+    {
+      if ((PTW32_INTERLOCKED_LONG) v ==
+	  PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->value,
+						  (PTW32_INTERLOCKED_LONG) (v - 1),
+						  (PTW32_INTERLOCKED_LONG) v))
+	{
+	  return v - 1;
+	}
+    }
+
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->refs);
+
+  v = (LONG) PTW32_ATOMIC_EXCHANGE_ADD_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->value,
+						 (PTW32_INTERLOCKED_LONG) -1) - 1;
+
+  if (v >= 0)
+    {
+      /* Posted meanwhile */
+      ptw32_sem_release (s);
+    }
+
+  return v;
+}
+
+int
+ptw32_sem_unwait (sem_t s)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Withdraws a thread that has given up waiting on a
+      *      semaphore, because of a timeout, cancellation or
+      *      error, from the count of waiters held in the
+      *      negative semaphore value.
+      *
+      *      If the value is no longer negative then every waiter,
+      *      including this one, has been posted and the kernel
+      *      semaphore has been, or is about to be, released for
+      *      each. The calling thread then takes its token instead,
+      *      and owns a unit of the semaphore.
+      *
+      *      The caller still holds its reference to the semaphore.
+      *
+      * RESULTS
+      *              1               the thread owns a unit,
+      *              0               the thread was withdrawn.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG v;
+
+  do
+    {
+      v = *((LONG volatile *) &s->value);
+      if (v >= 0)
+	{
+	  PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_SEM);
+	  (void) ptw32_wait_objects (1, &s->sem, INFINITE);
+	  return 1;
+	}
+    }
+  while ((PTW32_INTERLOCKED_LONG) v !=
+	 PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->value,
+						  (PTW32_INTERLOCKED_LONG) (v + 1),
+						  (PTW32_INTERLOCKED_LONG) v));
+
+  return 0;
+}
+#endif /* NEED_SEM */
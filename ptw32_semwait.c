@@ -75,10 +75,13 @@ ptw32_semwait (sem_t * sem)
     }
   else
     {
+#if defined(NEED_SEM)
       if ((result = pthread_mutex_lock (&s->lock)) == 0)
+#endif
         {
           int v;
 
+#if defined(NEED_SEM)
 	  /* See sem_destroy.c
 	   */
 	  if (*sem == NULL)
@@ -88,34 +91,69 @@ ptw32_semwait (sem_t * sem)
 	      return -1;
 	    }
 
-          v = --s->value;
+          if ((v = --s->value) < 0)
+            {
+              /* See ptw32_sem_release.c */
+              (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->refs);
+            }
           (void) pthread_mutex_unlock (&s->lock);
+#else
+          v = (int) ptw32_sem_decrement (s);
+#endif
 
           if (v < 0)
             {
               /* Must wait */
-              if (WaitForSingleObject (s->sem, INFINITE) == WAIT_OBJECT_0)
+              PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_SEM);
+              if (ptw32_wait_objects (1, &s->sem, INFINITE) == WAIT_OBJECT_0)
 		{
 #if defined(NEED_SEM)
 		  if (pthread_mutex_lock (&s->lock) == 0)
 		    {
-        	      if (*sem == NULL)
-        	        {
-        	          (void) pthread_mutex_unlock (&s->lock);
-        	          errno = EINVAL;
-        	          return -1;
-        	        }
-
-		      if (s->leftToUnblock > 0)
+		      /* See sem_destroy.c
+		       */
+		      if (*sem != NULL && s->leftToUnblock > 0)
 			{
 			  --s->leftToUnblock;
-			  SetEvent(s->sem);
+			  PTW32_SETEVENT (s->sem);
 			}
 		      (void) pthread_mutex_unlock (&s->lock);
 		    }
 #endif
+		  ptw32_sem_release (s);
+		  return 0;
+		}
+
+	      /*
+	       * The wait failed. Stop counting ourselves as a waiter,
+	       * unless someone has posted meanwhile, and drop our
+	       * reference as a timed out waiter would.
+	       */
+#if !defined(NEED_SEM)
+	      if (ptw32_sem_unwait (s))
+		{
+		  ptw32_sem_release (s);
 		  return 0;
 		}
+#else
+	      if (pthread_mutex_lock (&s->lock) == 0)
+		{
+		  if (WaitForSingleObject (s->sem, 0) == WAIT_OBJECT_0)
+		    {
+		      (void) pthread_mutex_unlock (&s->lock);
+		      ptw32_sem_release (s);
+		      return 0;
+		    }
+		  if (++s->value > 0)
+		    {
+		      s->leftToUnblock = 0;
+		    }
+		  (void) pthread_mutex_unlock (&s->lock);
+		}
+#endif
+	      ptw32_sem_release (s);
+	      errno = EINVAL;
+	      return -1;
             }
           else
 	    {
@@ -0,0 +1,136 @@
+/*
+ * ptw32_spin_calibrate.c
+ *
+ * Description:
+ * This translation unit implements routines which are private to
+ * the implementation and may be used throughout it.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Processor hints timed per calibration round, and the rounds run.
+ * The fastest round is taken, as the others may have been interrupted.
+ */
+#define PTW32_SPIN_CALIBRATE_HINTS	1000
+#define PTW32_SPIN_CALIBRATE_ROUNDS	5
+
+
+INLINE int
+ptw32_spin_hints (int ns)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      The number of processor hints (PTW32_YIELD_PROCESSOR)
+      *      that take about 'ns' nanoseconds on this processor,
+      *      at least 1. See ptw32_spin_calibrate().
+      *
+      * ------------------------------------------------------
+      */
+{
+  int64_t hints = ((int64_t) ns * 1000) / ptw32_spinHintPs;
+
+  return (int) PTW32_MAX (PTW32_MIN (hints, (int64_t) INT_MAX), (int64_t) 1);
+}
+
+
+void
+ptw32_spin_calibrate (void)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Times the processor hint that spin loops wait with,
+      *      and sets the library's own spin budgets from their
+      *      durations: PTW32_MCS_SPIN_NS, PTW32_BARRIER_SPIN_NS,
+      *      PTW32_SPIN_BACKOFF_NS and PTW32_SPIN_YIELD_NS. The
+      *      hint costs about 10 cycles on older Intel cores but
+      *      about 140 on Skylake and later, so a budget counted
+      *      in hints would spin fourteen times as long there.
+      *
+      *      Called when the process initialises, before
+      *      ptw32_param_environment() applies any overrides.
+      *      Internal locks and barriers only spin on
+      *      multi-processor systems.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int64_t frequency = ptw32_perf_frequency ();
+  int64_t best = -1;
+  int cpus;
+  int round;
+  int i;
+
+  for (round = 0; frequency > 0 && round < PTW32_SPIN_CALIBRATE_ROUNDS; round++)
+    {
+      LARGE_INTEGER start;
+      LARGE_INTEGER end;
+
+      (void) QueryPerformanceCounter (&start);
+      for (i = 0; i < PTW32_SPIN_CALIBRATE_HINTS; i++)
+	{
+	  PTW32_YIELD_PROCESSOR ();
+	}
+      (void) QueryPerformanceCounter (&end);
+
+      if (best < 0 || end.QuadPart - start.QuadPart < best)
+	{
+	  best = end.QuadPart - start.QuadPart;
+	}
+    }
+
+  if (best >= 0)
+    {
+      /*
+       * Picoseconds per hint; a hint that compiles to nothing, or
+       * runs faster than the counter can see, counts as 1ns.
+       */
+      ptw32_spinHintPs = (int) PTW32_MAX (best * 1000000000000 / PTW32_SPIN_CALIBRATE_HINTS
+					  / frequency,
+					  (int64_t) 1000);
+    }
+
+  if (0 == ptw32_getprocessors (&cpus) && cpus > 1)
+    {
+      ptw32_mcs_spin_limit = ptw32_spin_hints (PTW32_MCS_SPIN_NS);
+      ptw32_barrierSpinLimit = ptw32_spin_hints (PTW32_BARRIER_SPIN_NS);
+    }
+  else
+    {
+      ptw32_mcs_spin_limit = 0;
+      ptw32_barrierSpinLimit = 0;
+    }
+  ptw32_spinBackoffLimit = ptw32_spin_hints (PTW32_SPIN_BACKOFF_NS);
+  ptw32_spinYieldLimit = ptw32_spin_hints (PTW32_SPIN_YIELD_NS);
+}
@@ -41,38 +41,40 @@
 INLINE int
 ptw32_spinlock_check_need_init (pthread_spinlock_t * lock)
 {
-  int result = 0;
-  ptw32_mcs_local_node_t node;
+  int result;
+  pthread_spinlock_t s;
 
-  /*
-   * The following guarded test is specifically for statically
-   * initialised spinlocks (via PTHREAD_SPINLOCK_INITIALIZER).
-   */
-  ptw32_mcs_lock_acquire(&ptw32_spinlock_test_init_lock, &node);
+  if (*lock != PTHREAD_SPINLOCK_INITIALIZER)
+    {
+      /*
+       * Another thread initialised the spinlock first, or it has been
+       * destroyed, in which case the operation that caused the
+       * auto-initialisation should fail.
+       */
+      return (*lock == NULL) ? EINVAL : 0;
+    }
 
   /*
-   * We got here possibly under race
-   * conditions. Check again inside the critical section
-   * and only initialise if the spinlock is valid (not been destroyed).
-   * If a static spinlock has been destroyed, the application can
-   * re-initialise it only by calling pthread_spin_init()
-   * explicitly.
+   * As for mutexes (see ptw32_mutex_check_need_init.c), build one and
+   * publish it if the static spinlock is still untouched.
    */
-  if (*lock == PTHREAD_SPINLOCK_INITIALIZER)
+  if ((result = pthread_spin_init (&s, PTHREAD_PROCESS_PRIVATE)) != 0)
     {
-      result = pthread_spin_init (lock, PTHREAD_PROCESS_PRIVATE);
+      return result;
     }
-  else if (*lock == NULL)
+
+  if (PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) lock,
+						(PTW32_INTERLOCKED_PVOID) s,
+						(PTW32_INTERLOCKED_PVOID) PTHREAD_SPINLOCK_INITIALIZER)
+      != (PTW32_INTERLOCKED_PVOID) PTHREAD_SPINLOCK_INITIALIZER)
     {
-      /*
-       * The spinlock has been destroyed while we were waiting to
-       * initialise it, so the operation that caused the
-       * auto-initialisation should fail.
-       */
-      result = EINVAL;
-    }
+      (void) pthread_spin_destroy (&s);
 
-  ptw32_mcs_lock_release(&node);
+      if (*lock == NULL)
+	{
+	  result = EINVAL;
+	}
+    }
 
-  return (result);
+  return result;
 }
@@ -0,0 +1,125 @@
+/*
+ * ptw32_spinlock_init.c
+ *
+ * Description:
+ * This translation unit implements spin lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+ptw32_spinlock_init (pthread_spinlock_t * lock, int pshared, int kind,
+		     void * storage, size_t size)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Initialises a spinlock of a PTHREAD_SPINLOCK_*_NP kind
+      *      (see pthread_spin_init_np), in 'storage' if that is
+      *      given and at least 'size' bytes are enough, otherwise
+      *      on the heap.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_spinlock_t s;
+  int cpus = 0;
+  int result = 0;
+
+  if (lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (0 != ptw32_getprocessors (&cpus))
+    {
+      cpus = 1;
+    }
+
+  if (pshared == PTHREAD_PROCESS_SHARED)
+    {
+      /*
+       * Creating spinlock that can be shared between
+       * processes. Not supported, whether it would spin
+       * or use a mutex.
+       */
+      return ENOSYS;
+    }
+
+  if (storage != NULL && size >= sizeof (*s))
+    {
+      s = (pthread_spinlock_t) storage;
+      memset (s, 0, sizeof (*s));
+      s->inPlace = PTW32_TRUE;
+    }
+  else if ((s = (pthread_spinlock_t) ptw32_object_alloc (sizeof (*s), ptw32_objectAlign)) == NULL)
+    {
+      return ENOMEM;
+    }
+
+  if (cpus > 1)
+    {
+      s->u.cpus = cpus;
+      s->interlock = (kind == PTHREAD_SPINLOCK_TICKET_NP) ? PTW32_SPIN_USE_TICKET : PTW32_SPIN_UNLOCKED;
+    }
+  else
+    {
+      pthread_mutexattr_t ma;
+      result = pthread_mutexattr_init (&ma);
+
+      if (0 == result)
+	{
+	  result = pthread_mutex_init (&(s->u.mutex), &ma);
+	  if (0 == result)
+	    {
+	      s->interlock = PTW32_SPIN_USE_MUTEX;
+	    }
+	}
+      (void) pthread_mutexattr_destroy (&ma);
+    }
+
+  if (0 == result)
+    {
+      *lock = s;
+    }
+  else
+    {
+      if (!s->inPlace)
+	{
+	  ptw32_object_free (s);
+	}
+      *lock = NULL;
+    }
+
+  return (result);
+}
@@ -0,0 +1,153 @@
+/*
+ * ptw32_spsc.c
+ *
+ * Description:
+ * This translation unit implements single-producer single-consumer channel primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * Single-producer single-consumer channels, created with
+ * pthread_spsc_create_np().
+ *
+ * The items are in a ring. The producer fills slots from 'tail' and
+ * publishes them, one or a batch at a time, with a release store of
+ * tail; the consumer empties them from 'head' and hands them back the
+ * same way. Neither end takes a lock or makes an interlocked operation
+ * while the channel is neither empty nor full, and each end only
+ * rereads the other's index when its cached copy says it must.
+ *
+ * An end that finds the channel empty (consumer) or full (producer)
+ * checks the other index PTW32_SPSC_SPIN times and then parks: it
+ * sets its parked flag, looks once more, and waits on the other end's
+ * index with pthread_wait_on_address_np(), which makes the wait a
+ * cancellation point. After publishing, the other end reads the flag
+ * and only if it is set clears it and wakes the index.
+ *
+ * That is Dekker's pattern: the parker stores its flag and then loads
+ * the index, the publisher stores the index and then loads the flag,
+ * and each store must be seen before the following load or a wake
+ * can be lost. The parker sets the flag with an interlocked exchange.
+ * Rather than make the publisher pay a full barrier too, the parker
+ * then calls FlushProcessWriteBuffers, which puts a barrier on every
+ * processor running one of our threads: the publisher's index store
+ * is then visible to the parker's load, or the publisher's flag load
+ * comes after the barrier and sees the flag. Without it (before
+ * Vista) the publisher reads the flag with an interlocked operation.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+void
+ptw32_spsc_wait (volatile LONG * index, LONG seen, volatile LONG * parked)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Waits until the other end's 'index' is no longer
+      *      'seen'. A cancellation point: a cancel leaves
+      *      'parked' set, which only costs a wake up nobody
+      *      waits for.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int spin;
+
+  for (spin = 0; spin < PTW32_SPSC_SPIN; spin++)
+    {
+      if (PTW32_ATOMIC_LOAD_ACQ_LONG(index) != seen)
+        {
+          return;
+        }
+
+      PTW32_YIELD_PROCESSOR ();
+    }
+
+  for (;;)
+    {
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) parked,
+                                            (PTW32_INTERLOCKED_LONG) 1);
+
+      if (ptw32_flushprocesswritebuffers != NULL)
+        {
+          ptw32_flushprocesswritebuffers ();
+        }
+
+      if (PTW32_ATOMIC_LOAD_ACQ_LONG(index) != seen)
+        {
+          break;
+        }
+
+      (void) pthread_wait_on_address_np (index, &seen, sizeof (seen), NULL);
+
+      if (PTW32_ATOMIC_LOAD_ACQ_LONG(index) != seen)
+        {
+          break;
+        }
+    }
+
+  /* The other end may already have cleared it */
+  PTW32_ATOMIC_STORE_RELAXED_LONG(parked, 0);
+}
+
+void
+ptw32_spsc_wake (volatile LONG * index, volatile LONG * parked)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Called after publishing a new 'index': wakes the
+      *      other end if it is parked on it.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG isParked;
+
+  if (ptw32_flushprocesswritebuffers != NULL)
+    {
+      /* A volatile read: the compiler keeps it after the index store */
+      isParked = *parked;
+    }
+  else
+    {
+      isParked = (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG((PTW32_INTERLOCKED_LONGPTR) parked,
+                                                           (PTW32_INTERLOCKED_LONG) 0);
+    }
+
+  if (isParked
+      && 0 != PTW32_INTERLOCKED_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) parked,
+                                              (PTW32_INTERLOCKED_LONG) 0))
+    {
+      ptw32_wakebyaddresssingle ((PVOID) index);
+    }
+}
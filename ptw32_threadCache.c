@@ -0,0 +1,297 @@
+/*
+ * ptw32_threadCache.c
+ *
+ * Description:
+ * This translation unit implements miscellaneous thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * How it works:
+ * Creating and ending an OS thread costs far more than anything else
+ * pthread_create and pthread_join do; the stack has to be reserved and
+ * committed and every loaded DLL sees the thread attach and detach.
+ * With the cache enabled (pthread_setthreadcache_np) a POSIX thread's
+ * OS thread doesn't end with it. Once the thread has been torn down as
+ * it would have been on exit (TSD destructors, robust mutexes, the
+ * struct destroyed if detached) the OS thread parks here until
+ * pthread_create hands it another start routine.
+ *
+ * Joiners can't wait on the handle of an OS thread that doesn't end,
+ * so a cached thread signals its struct's exitEvent instead once it
+ * no longer touches the struct. See PTW32_THREAD_EXIT_HANDLE.
+ *
+ * Each POSIX thread gets its own handle to the OS thread so that join
+ * can close it as before; the parked thread duplicates one for the
+ * next thread when it parks. The next thread also gets a new struct,
+ * so it has a new pthread_t and sequence number.
+ *
+ * A parked thread gives back the stack its last thread committed, down
+ * to the guard region just below where it waits, so that the cache
+ * holds address space rather than memory.
+ */
+
+/*
+ * Values of keys without destructors are still set once a thread has
+ * been torn down. The next thread to run on the calling OS thread
+ * must start with all values NULL as a new OS thread would.
+ */
+void
+ptw32_threadCacheClearKeys (void)
+{
+  ptw32_mcs_local_node_t node;
+  unsigned int slot;
+
+  ptw32_mcs_lock_acquire (&ptw32_tsd_slot_lock, &node);
+
+  for (slot = 0; slot < ptw32_tsdNextSlot; slot++)
+    {
+      pthread_key_t k = ptw32_tsdKeys[slot];
+
+      if (k != NULL && !PTW32_KEY_IN_TABLE(k))
+        {
+          TlsSetValue (k->key, NULL);
+        }
+    }
+
+  ptw32_mcs_lock_release (&node);
+}
+
+/*
+ * Decommit the calling thread's stack below the pages it is using,
+ * moving its guard region (the guard page and any stack guarantee) up
+ * to just below them. The system grows the stack through the guard
+ * region again as it is used.
+ */
+static void
+ptw32_threadCacheTrimStack (void)
+{
+  NT_TIB * tib = (NT_TIB *) NtCurrentTeb ();
+  MEMORY_BASIC_INFORMATION guard;
+  DWORD protect;
+  char * limit = (char *) tib->StackLimit;
+  char * keep;
+  size_t guardBytes;
+
+  /* Leave room for the calls below and the wait */
+  keep = (char *) (((size_t) &guard - PTW32_STACK_PARK_KEEP)
+                   & ~(size_t) (PTW32_STACK_PAGE - 1));
+
+  if (keep <= limit
+      || 0 == VirtualQuery (limit - 1, &guard, sizeof (guard))
+      || guard.State != MEM_COMMIT
+      || 0 == (guard.Protect & PAGE_GUARD))
+    {
+      return;
+    }
+
+  guardBytes = (size_t) (limit - (char *) guard.BaseAddress);
+
+  if (keep - guardBytes <= limit
+      || !VirtualProtect (keep - guardBytes, guardBytes,
+                          PAGE_READWRITE | PAGE_GUARD, &protect))
+    {
+      return;
+    }
+
+  tib->StackLimit = keep;
+  (void) VirtualFree (guard.BaseAddress,
+                      (size_t) (keep - guardBytes - (char *) guard.BaseAddress),
+                      MEM_DECOMMIT);
+}
+
+/*
+ * Park the calling OS thread after its POSIX thread has been torn
+ * down by pthread_win32_thread_detach_np(). 'exitEvent' is that
+ * thread's exit event.
+ *
+ * Returns the next thread's parameters, or NULL if the calling
+ * thread should end.
+ */
+ThreadParms *
+ptw32_threadCachePark (ptw32_parked_thread_t * pt, HANDLE exitEvent)
+{
+  ptw32_mcs_local_node_t node;
+  int parked = PTW32_FALSE;
+
+  /*
+   * A joinable thread's struct is still ours; a detached thread's
+   * was destroyed and cleared from TLS by
+   * pthread_win32_thread_detach_np.
+   */
+  if (PTW32_SELF_THREAD () != NULL)
+    {
+      (void) pthread_setspecific (ptw32_selfThreadKey, NULL);
+    }
+  else
+    {
+      exitEvent = NULL;
+    }
+
+  ptw32_threadCacheClearKeys ();
+
+  /*
+   * The joiner can now destroy the struct.
+   */
+  if (exitEvent != NULL)
+    {
+      (void) PTW32_SETEVENT (exitEvent);
+    }
+
+  if (pt->wakeEvent == NULL)
+    {
+      pt->wakeEvent = ptw32_libstat_handle (CreateEvent (NULL, PTW32_FALSE, PTW32_FALSE, NULL),
+                                           PTW32_LIBSTAT_EVENTS);
+    }
+
+  if (pt->wakeEvent != NULL
+      && DuplicateHandle (GetCurrentProcess (),
+                          GetCurrentThread (),
+                          GetCurrentProcess (),
+                          &pt->threadH,
+                          0, FALSE, DUPLICATE_SAME_ACCESS))
+    {
+      PTW32_LIBSTAT_ADD (PTW32_LIBSTAT_THREAD_HANDLES, 1);
+      pt->thread = GetCurrentThreadId ();
+      pt->parms = NULL;
+
+      ptw32_mcs_lock_acquire (&ptw32_thread_cache_lock, &node);
+
+      if (ptw32_threadCacheCount < ptw32_threadCacheMax)
+        {
+          pt->next = ptw32_threadCache;
+          ptw32_threadCache = pt;
+          ptw32_threadCacheCount++;
+          parked = PTW32_TRUE;
+        }
+
+      ptw32_mcs_lock_release (&node);
+
+      if (parked)
+        {
+          ptw32_threadCacheTrimStack ();
+          PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_OTHER);
+          (void) WaitForSingleObject (pt->wakeEvent, INFINITE);
+
+          if (pt->parms != NULL)
+            {
+              /* The handle now belongs to the next thread */
+              return pt->parms;
+            }
+        }
+
+      (void) ptw32_closehandle (pt->threadH, PTW32_LIBSTAT_THREAD_HANDLES);
+    }
+
+  /*
+   * Not parked, or told to end by ptw32_threadCacheTrim.
+   */
+  if (pt->wakeEvent != NULL)
+    {
+      (void) ptw32_closehandle (pt->wakeEvent, PTW32_LIBSTAT_EVENTS);
+      pt->wakeEvent = NULL;
+    }
+
+  return NULL;
+}
+
+/*
+ * Take a parked OS thread whose stack was reserved with 'stackSize'.
+ * The caller fills in its parms and sets its wakeEvent; the record
+ * must not be touched after that.
+ *
+ * Returns NULL if no such thread is parked.
+ */
+ptw32_parked_thread_t *
+ptw32_threadCacheUnpark (unsigned int stackSize)
+{
+  ptw32_parked_thread_t * pt;
+  ptw32_parked_thread_t ** link;
+  ptw32_mcs_local_node_t node;
+
+  if (NULL == ptw32_threadCache)
+    {
+      return NULL;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_thread_cache_lock, &node);
+
+  for (link = &ptw32_threadCache; (pt = *link) != NULL; link = &pt->next)
+    {
+      if (pt->stackSize == stackSize)
+        {
+          *link = pt->next;
+          ptw32_threadCacheCount--;
+          break;
+        }
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return pt;
+}
+
+/*
+ * Tell parked threads beyond the first 'max' to end.
+ */
+void
+ptw32_threadCacheTrim (int max)
+{
+  ptw32_parked_thread_t * surplus = NULL;
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&ptw32_thread_cache_lock, &node);
+
+  while (ptw32_threadCacheCount > max)
+    {
+      ptw32_parked_thread_t * pt = ptw32_threadCache;
+
+      ptw32_threadCache = pt->next;
+      ptw32_threadCacheCount--;
+      pt->next = surplus;
+      surplus = pt;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  while (surplus != NULL)
+    {
+      ptw32_parked_thread_t * pt = surplus;
+
+      /* Read before the wakeup; the record goes with the thread */
+      surplus = pt->next;
+      (void) PTW32_SETEVENT (pt->wakeEvent);
+    }
+}
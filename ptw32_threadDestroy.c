@@ -43,34 +43,93 @@ void
 ptw32_threadDestroy (pthread_t thread)
 {
   ptw32_thread_t * tp = (ptw32_thread_t *) thread.p;
-  ptw32_thread_t threadCopy;
 
   if (tp != NULL)
     {
       /*
-       * Copy thread state so that the thread can be atomically NULLed.
+       * Take the resources the thread owns so that the thread can be
+       * atomically NULLed.
        */
-      memcpy (&threadCopy, tp, sizeof (threadCopy));
+      HANDLE threadH = tp->threadH;
+      HANDLE cancelEvent = tp->cancelEvent;
+      HANDLE mcsEvent = tp->mcsEvent;
+      HANDLE waitTimer = tp->waitTimer;
+      HANDLE waitanyEvent = tp->waitanyEvent;
+      unsigned int * dtorBits = tp->dtorBits;
+      ptw32_arena_block_t * arena = tp->arena;
+
+      ptw32_object_cache_flush (tp);
+
+      /* Grace periods no longer wait for it */
+      if (tp->rcuReader != NULL)
+	{
+	  PTW32_RCU_OFFLINE (tp->rcuReader);
+	}
+
+      /*
+       * Its hazard slots no longer protect anything; what it retired
+       * and others still protect waits for the record's next owner.
+       */
+      if (tp->hazards != NULL)
+	{
+	  int i;
+
+	  for (i = 0; i < PTHREAD_HAZARD_SLOTS_NP; i++)
+	    {
+	      tp->hazards->slots[i] = NULL;
+	    }
+	  (void) ptw32_hazard_scan (tp->hazards);
+	}
+
+      /* Closed to pthread_group_add_np() from here */
+      ptw32_group_leave (tp);
+
+      /* In case it ended blocked, e.g. by async cancellation */
+      if (tp->waitgraph != NULL)
+	{
+	  tp->waitgraph->mutex = NULL;
+	}
 
       /*
        * Thread ID structs are never freed. They're NULLed and reused.
-       * This also sets the thread to PThreadStateInitial (invalid).
+       * This also sets the thread to PThreadStateReuse (invalid).
        */
       ptw32_threadReusePush (thread);
 
-      /* Now work on the copy. */
-      if (threadCopy.cancelEvent != NULL)
+      if (cancelEvent != NULL)
 	{
-	  CloseHandle (threadCopy.cancelEvent);
+	  ptw32_closehandle (cancelEvent, PTW32_LIBSTAT_EVENTS);
 	}
 
+      if (mcsEvent != NULL)
+	{
+	  ptw32_closehandle (mcsEvent, PTW32_LIBSTAT_EVENTS);
+	}
+
+      if (waitTimer != NULL)
+	{
+	  ptw32_closehandle (waitTimer, PTW32_LIBSTAT_TIMERS);
+	}
+
+      if (waitanyEvent != NULL)
+	{
+	  ptw32_closehandle (waitanyEvent, PTW32_LIBSTAT_EVENTS);
+	}
+
+      if (dtorBits != NULL)
+	{
+	  free (dtorBits);
+	}
+
+      ptw32_arena_free (arena);
+
 #if ! defined(PTW32_CONFIG_MINGW) || defined (__MSVCRT__) || defined (__DMC__)
       /*
        * See documentation for endthread vs endthreadex.
        */
-      if (threadCopy.threadH != 0)
+      if (threadH != 0)
 	{
-	  CloseHandle (threadCopy.threadH);
+	  ptw32_closehandle (threadH, PTW32_LIBSTAT_THREAD_HANDLES);
 	}
 #endif
 
@@ -0,0 +1,238 @@
+/*
+ * ptw32_threadPool.c
+ *
+ * Description:
+ * This translation unit implements miscellaneous thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * How it works:
+ * A detached thread created with pthread_attr_setpooled_np has no OS
+ * thread of its own. It is submitted as a work item to a private pool
+ * of the system thread pool, so that short lived threads cost a queue
+ * operation rather than an OS thread creation and exit. The pool is
+ * separate from the process default pool so that pooled threads, which
+ * may block, neither starve nor are starved by other work items. Each
+ * callback says it may run long, so the pool adds a worker rather than
+ * let queued threads wait behind a blocked one.
+ *
+ * For the duration of the callback the worker is the thread's OS
+ * thread: the thread's struct has its own handle to the worker and the
+ * self key, FLS and priority are set as for a new OS thread. When the
+ * thread ends it is torn down as a cached thread is, and the worker is
+ * given back its priority, affinity, name and QoS, and TSD values of
+ * NULL, before it returns to the pool.
+ *
+ * A pooled thread takes the worker's CPU affinity rather than its
+ * creator's.
+ */
+
+static VOID CALLBACK
+ptw32_threadPoolRun (PVOID instance, PVOID context, PVOID work)
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) context;
+  ptw32_mcs_local_node_t node;
+  HANDLE threadH = NULL;
+  int priority = GetThreadPriority (GetCurrentThread ());
+  int named;
+  int qos;
+  int wakeBoost;
+#if defined(HAVE_CPU_AFFINITY)
+  cpu_set_t workerCpuset;
+  int affinity;
+  int softAffinity;
+#endif
+
+  (void) ptw32_callbackmayrunlong (instance);
+
+  if (DuplicateHandle (GetCurrentProcess (),
+                       GetCurrentThread (),
+                       GetCurrentProcess (),
+                       &threadH,
+                       0, FALSE, DUPLICATE_SAME_ACCESS))
+    {
+      PTW32_LIBSTAT_ADD (PTW32_LIBSTAT_THREAD_HANDLES, 1);
+    }
+
+  ptw32_mcs_lock_acquire (&sp->threadLock, &node);
+  sp->threadH = threadH;
+  sp->thread = GetCurrentThreadId ();
+#if defined(HAVE_CPU_AFFINITY)
+  affinity = (0 == ptw32_getthreadaffinity (GetCurrentThread (), &workerCpuset));
+  if (affinity)
+    {
+      sp->cpuset = workerCpuset;
+    }
+#endif
+  ptw32_mcs_lock_release (&node);
+
+  if (THREAD_PRIORITY_NORMAL != sp->sched_priority)
+    {
+      (void) ptw32_setthreadpriority (sp->ptHandle, sp->sched_policy, sp->sched_priority);
+    }
+
+  if (!sp->wakeBoost)
+    {
+      ptw32_setthreadwakeboost (GetCurrentThread (), 0);
+    }
+
+  if ('\0' != sp->name[0])
+    {
+      ptw32_setthreadname (sp);
+    }
+
+  pthread_setspecific (ptw32_selfThreadKey, sp);
+  ptw32_mcs_lock_acquire (&sp->stateLock, &node);
+  PTW32_FLS_ATTACH (sp);
+
+  /* As in ptw32_threadStart */
+  if (sp->state < PThreadStateCancelPending)
+    {
+      sp->state = PThreadStateRunning;
+    }
+  ptw32_mcs_lock_release (&node);
+
+  ptw32_threadRun ();
+
+  /*
+   * What the thread may have changed on the worker, read before the
+   * struct is destroyed.
+   */
+  named = ('\0' != sp->name[0]);
+  qos = sp->qos;
+  wakeBoost = sp->wakeBoost;
+#if defined(HAVE_CPU_AFFINITY)
+  softAffinity = (CPU_COUNT(&sp->softCpuset) > 0);
+#endif
+
+  (void) pthread_win32_thread_detach_np ();
+
+  ptw32_threadCacheClearKeys ();
+
+  (void) SetThreadPriority (GetCurrentThread (), priority);
+
+#if defined(HAVE_CPU_AFFINITY)
+  if (affinity)
+    {
+      (void) ptw32_setthreadaffinity (GetCurrentThread (), &workerCpuset, PTW32_FALSE);
+    }
+
+  if (softAffinity)
+    {
+      CPU_ZERO(&workerCpuset);
+      (void) ptw32_setthreadsoftaffinity (GetCurrentThread (), &workerCpuset);
+    }
+#endif
+
+  if (PTHREAD_QOS_DEFAULT_NP != qos)
+    {
+      ptw32_setthreadqos (GetCurrentThread (), PTHREAD_QOS_DEFAULT_NP);
+    }
+
+  if (!wakeBoost)
+    {
+      ptw32_setthreadwakeboost (GetCurrentThread (), 1);
+    }
+
+  if (named && NULL != ptw32_setthreaddescription)
+    {
+      (void) ptw32_setthreaddescription (GetCurrentThread (), L"");
+    }
+}
+
+/*
+ * Submit 'tp', which is detached and not suspended, to run as a work
+ * item of the thread pool.
+ *
+ * RESULTS
+ *              0               the thread is submitted,
+ *              EAGAIN          insufficient resources,
+ *              ENOTSUP         this system has no thread pool API.
+ */
+int
+ptw32_threadPoolStart (ptw32_thread_t * tp)
+{
+  ptw32_mcs_local_node_t node;
+  PVOID work;
+
+  if (NULL == ptw32_createthreadpool)
+    {
+      return ENOTSUP;
+    }
+
+  if (NULL == ptw32_threadPool)
+    {
+      ptw32_mcs_lock_acquire (&ptw32_thread_pool_lock, &node);
+
+      if (NULL == ptw32_threadPool)
+        {
+          PVOID pool = ptw32_createthreadpool (NULL);
+
+          if (pool != NULL)
+            {
+              /* Keep a worker for the next thread */
+              (void) ptw32_setthreadpoolthreadminimum (pool, 1);
+
+              memset (&ptw32_threadPoolEnviron, 0, sizeof (ptw32_threadPoolEnviron));
+              ptw32_threadPoolEnviron.version = 1;
+              ptw32_threadPoolEnviron.pool = pool;
+
+              (void) PTW32_INTERLOCKED_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &ptw32_threadPool,
+                                                     (PTW32_INTERLOCKED_PVOID) pool);
+            }
+        }
+
+      ptw32_mcs_lock_release (&node);
+
+      if (NULL == ptw32_threadPool)
+        {
+          return EAGAIN;
+        }
+    }
+
+  if (NULL == (work = ptw32_createthreadpoolwork (ptw32_threadPoolRun, tp,
+                                                  &ptw32_threadPoolEnviron)))
+    {
+      return EAGAIN;
+    }
+
+  ptw32_submitthreadpoolwork (work);
+
+  /* Freed once the callback has returned */
+  ptw32_closethreadpoolwork (work);
+
+  return 0;
+}
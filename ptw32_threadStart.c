@@ -38,6 +38,7 @@
 #include "pthread.h"
 #include "implement.h"
 #include <stdio.h>
+#include <malloc.h>
 
 #if defined(__CLEANUP_C)
 # include <setjmp.h>
@@ -120,19 +121,17 @@ ptw32_terminate ()
 
 #endif
 
-#if ! defined (PTW32_CONFIG_MINGW) || (defined (__MSVCRT__) && ! defined (__DMC__))
-unsigned
-  __stdcall
-#else
+/*
+ * Run the thread's start routine under the cleanup model's handler
+ * for cancellation and pthread_exit(). The result is left in
+ * sp->exitStatus. Fibers start here as well, see ptw32_fiber.c.
+ */
 void
-#endif
-ptw32_threadStart (void *vthreadParms)
+ptw32_threadRun (void)
 {
-  ThreadParms * threadParms = (ThreadParms *) vthreadParms;
-  pthread_t self;
-  ptw32_thread_t * sp;
-  void * (PTW32_CDECL *start) (void *);
-  void * arg;
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+  void * (PTW32_CDECL *start) (void *) = sp->parms.start;
+  void * arg = sp->parms.arg;
 
 #if defined(__CLEANUP_SEH)
   DWORD
@@ -143,37 +142,6 @@ ptw32_threadStart (void *vthreadParms)
   int setjmp_rc;
 #endif
 
-  ptw32_mcs_local_node_t stateLock;
-  void * status = (void *) 0;
-
-  self = threadParms->tid;
-  sp = (ptw32_thread_t *) self.p;
-  start = threadParms->start;
-  arg = threadParms->arg;
-
-  free (threadParms);
-
-#if defined (PTW32_CONFIG_MINGW) && ! defined (__MSVCRT__)
-  /*
-   * beginthread does not return the thread id and is running
-   * before it returns us the thread handle, and so we do it here.
-   */
-  sp->thread = GetCurrentThreadId ();
-  /*
-   * Here we're using stateLock as a general-purpose lock
-   * to make the new thread wait until the creating thread
-   * has the new handle.
-   */
-  ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
-  pthread_setspecific (ptw32_selfThreadKey, sp);
-#else
-  pthread_setspecific (ptw32_selfThreadKey, sp);
-  ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
-#endif
-
-  sp->state = PThreadStateRunning;
-  ptw32_mcs_lock_release (&stateLock);
-
 #if defined(__CLEANUP_SEH)
 
   __try
@@ -181,7 +149,7 @@ ptw32_threadStart (void *vthreadParms)
     /*
      * Run the caller's routine;
      */
-    status = sp->exitStatus = (*start) (arg);
+    sp->exitStatus = (*start) (arg);
     sp->state = PThreadStateExiting;
 
 #if defined(_UWIN)
@@ -195,17 +163,16 @@ ptw32_threadStart (void *vthreadParms)
     switch (ei[0])
       {
       case PTW32_EPS_CANCEL:
-	status = sp->exitStatus = PTHREAD_CANCELED;
+	sp->exitStatus = PTHREAD_CANCELED;
 #if defined(_UWIN)
 	if (--pthread_count <= 0)
 	  exit (0);
 #endif
 	break;
       case PTW32_EPS_EXIT:
-	status = sp->exitStatus;
 	break;
       default:
-	status = sp->exitStatus = PTHREAD_CANCELED;
+	sp->exitStatus = PTHREAD_CANCELED;
 	break;
       }
   }
@@ -222,7 +189,7 @@ ptw32_threadStart (void *vthreadParms)
       /*
        * Run the caller's routine;
        */
-      status = sp->exitStatus = (*start) (arg);
+      sp->exitStatus = (*start) (arg);
       sp->state = PThreadStateExiting;
     }
   else
@@ -230,13 +197,12 @@ ptw32_threadStart (void *vthreadParms)
       switch (setjmp_rc)
 	{
 	case PTW32_EPS_CANCEL:
-	  status = sp->exitStatus = PTHREAD_CANCELED;
+	  sp->exitStatus = PTHREAD_CANCELED;
 	  break;
 	case PTW32_EPS_EXIT:
-	  status = sp->exitStatus;
 	  break;
 	default:
-	  status = sp->exitStatus = PTHREAD_CANCELED;
+	  sp->exitStatus = PTHREAD_CANCELED;
 	  break;
 	}
     }
@@ -256,7 +222,7 @@ ptw32_threadStart (void *vthreadParms)
      */
     try
     {
-      status = sp->exitStatus = (*start) (arg);
+      sp->exitStatus = (*start) (arg);
       sp->state = PThreadStateExiting;
     }
     catch (ptw32_exception &)
@@ -292,14 +258,13 @@ ptw32_threadStart (void *vthreadParms)
     /*
      * Thread was canceled.
      */
-    status = sp->exitStatus = PTHREAD_CANCELED;
+    sp->exitStatus = PTHREAD_CANCELED;
   }
   catch (ptw32_exception_exit &)
   {
     /*
-     * Thread was exited via pthread_exit().
+     * Thread was exited via pthread_exit(), which set sp->exitStatus.
      */
-    status = sp->exitStatus;
   }
   catch (...)
   {
@@ -309,7 +274,7 @@ ptw32_threadStart (void *vthreadParms)
      * and exit with a substitute status. If the thread was not
      * cancelled then this indicates the unhandled exception.
      */
-    status = sp->exitStatus = PTHREAD_CANCELED;
+    sp->exitStatus = PTHREAD_CANCELED;
   }
 
   (void) set_terminate (ptw32_oldTerminate);
@@ -322,23 +287,237 @@ ptw32_threadStart (void *vthreadParms)
 #endif /* __CLEANUP_C */
 #endif /* __CLEANUP_SEH */
 
-#if defined(PTW32_STATIC_LIB)
+  PTW32_ETW_EVENT (PTW32_ETW_THREAD_EXIT, sp, (size_t) sp->exitStatus);
+}
+
+#if defined( _POSIX_THREAD_ATTR_STACKADDR ) && _POSIX_THREAD_ATTR_STACKADDR != -1
+
+/*
+ * Call 'run' on the caller's stack set with pthread_attr_setstack.
+ * The thread's TIB stack bounds move with it because the system
+ * checks exception frames and stack probes against them, and are
+ * put back once 'run' returns.
+ */
+static void
+ptw32_callOnStack (void (*run) (void), void * stackAddr, size_t stackBytes)
+{
+  NT_TIB * tib = (NT_TIB *) NtCurrentTeb ();
+  PVOID stackBase = tib->StackBase;
+  PVOID stackLimit = tib->StackLimit;
+  char * top = (char *) (((size_t) stackAddr + stackBytes) & ~(size_t) 15);
+
+  tib->StackBase = top;
+  tib->StackLimit = stackAddr;
+
+#if defined(__GNUC__) && defined(__x86_64__)
+  __asm__ __volatile__
+  (
+    "movq %%rsp, %%rbx\n\t"
+    "movq %1, %%rsp\n\t"
+    "subq $32, %%rsp\n\t"	/* Home space for the callee */
+    "call *%0\n\t"
+    "movq %%rbx, %%rsp"
+    :
+    : "r" (run), "r" (top)
+    : "rax", "rbx", "rcx", "rdx", "rsi", "rdi",
+      "r8", "r9", "r10", "r11",
+      "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7",
+      "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14", "xmm15",
+      "memory", "cc"
+  );
+#elif defined(__GNUC__) && defined(__i386__)
+  __asm__ __volatile__
+  (
+    "movl %%esp, %%ebx\n\t"
+    "movl %1, %%esp\n\t"
+    "call *%0\n\t"
+    "movl %%ebx, %%esp"
+    :
+    : "r" (run), "r" (top)
+    : "eax", "ebx", "ecx", "edx", "memory", "cc"
+  );
+#elif defined(_MSC_VER) && defined(_M_IX86)
+  __asm
+    {
+      mov eax, run
+      mov ecx, top
+      mov esi, esp
+      mov esp, ecx
+      call eax
+      mov esp, esi
+    }
+#endif
+
+  tib->StackBase = stackBase;
+  tib->StackLimit = stackLimit;
+}
+
+#endif /* _POSIX_THREAD_ATTR_STACKADDR */
+
+/*
+ * Commit the top 'bytes' of the stack, as pthread_attr_setstackcommit_np
+ * asks when the stack size is only reserved. The stack is grown through
+ * its guard page by probing an _alloca block, as any deep call would,
+ * stopping short of the bottom of the reservation.
+ */
+static void
+ptw32_stackCommit (size_t bytes)
+{
+  NT_TIB * tib = (NT_TIB *) NtCurrentTeb ();
+  MEMORY_BASIC_INFORMATION mbi;
+  char * here = (char *) &mbi;
+  char * target = (char *) tib->StackBase - bytes;
+  char * floor;
+  volatile char * block;
+  size_t depth;
+
+  if (target >= (char *) tib->StackLimit
+      || 0 == VirtualQuery (here, &mbi, sizeof (mbi)))
+    {
+      return;
+    }
+
+  floor = (char *) mbi.AllocationBase + PTW32_STACK_COMMIT_SLACK;
+  if (target < floor)
+    {
+      target = floor;
+    }
+
+  if (target >= here)
+    {
+      return;
+    }
+
+  depth = (size_t) (here - target);
+  block = (volatile char *) _alloca (depth);
+
+  while (depth > PTW32_STACK_PAGE)
+    {
+      depth -= PTW32_STACK_PAGE;
+      block[depth] = 0;
+    }
+  block[0] = 0;
+}
+
+#if ! defined (PTW32_CONFIG_MINGW) || (defined (__MSVCRT__) && ! defined (__DMC__))
+unsigned
+  __stdcall
+#else
+void
+#endif
+ptw32_threadStart (void *vthreadParms)
+{
+  ThreadParms * threadParms = (ThreadParms *) vthreadParms;
+  pthread_t self;
+  ptw32_thread_t * sp;
+  ptw32_mcs_local_node_t stateLock;
+  void * status = (void *) 0;
+  ptw32_parked_thread_t parked;
+
+  parked.wakeEvent = NULL;
+  parked.stackSize = threadParms->stackSize;
+
   /*
-   * We need to cleanup the pthread now if we have
-   * been statically linked, in which case the cleanup
-   * in dllMain won't get done. Joinable threads will
-   * only be partially cleaned up and must be fully cleaned
-   * up by pthread_join() or pthread_detach().
-   *
-   * Note: if this library has been statically linked,
-   * implicitly created pthreads (those created
-   * for Win32 threads which have called pthreads routines)
-   * must be cleaned up explicitly by the application
-   * (by calling pthread_win32_thread_detach_np()).
-   * For the dll, dllMain will do the cleanup automatically.
+   * An OS thread from the thread cache comes back here for each
+   * POSIX thread it runs.
    */
-  (void) pthread_win32_thread_detach_np ();
+NEXT_THREAD:
+  self = threadParms->tid;
+  sp = (ptw32_thread_t *) self.p;
+
+#if defined (PTW32_CONFIG_MINGW) && ! defined (__MSVCRT__)
+  /*
+   * beginthread does not return the thread id and is running
+   * before it returns us the thread handle, and so we do it here.
+   */
+  sp->thread = GetCurrentThreadId ();
+  /*
+   * Here we're using stateLock as a general-purpose lock
+   * to make the new thread wait until the creating thread
+   * has the new handle.
+   */
+  ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
+  pthread_setspecific (ptw32_selfThreadKey, sp);
+#else
+  pthread_setspecific (ptw32_selfThreadKey, sp);
+  ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
 #endif
+  PTW32_FLS_ATTACH (sp);
+
+  /*
+   * Don't lose a cancel that arrived before the thread ran; the
+   * cancellation points rely on seeing it in sp->state.
+   */
+  if (sp->state < PThreadStateCancelPending)
+    {
+      sp->state = PThreadStateRunning;
+    }
+  ptw32_mcs_lock_release (&stateLock);
+
+  if (threadParms->stackAddr != NULL)
+    {
+#if defined( _POSIX_THREAD_ATTR_STACKADDR ) && _POSIX_THREAD_ATTR_STACKADDR != -1
+      ptw32_callOnStack (ptw32_threadRun, threadParms->stackAddr,
+			 threadParms->stackBytes);
+#endif
+    }
+  else
+    {
+      if (threadParms->stackGuard > 0)
+        {
+          ULONG guarantee = threadParms->stackGuard;
+
+          (void) ptw32_setthreadstackguarantee (&guarantee);
+        }
+      if (threadParms->stackCommit > 0)
+        {
+          ptw32_stackCommit (threadParms->stackCommit);
+        }
+      ptw32_threadRun ();
+    }
+
+  status = sp->exitStatus;
+
+
+  if (sp->cached)
+    {
+      /*
+       * The OS thread may outlive this thread, so the cleanup
+       * can't be left to dllMain. The struct may be gone after
+       * it, so take the exit event first.
+       */
+      HANDLE exitEvent = sp->exitEvent;
+
+      (void) pthread_win32_thread_detach_np ();
+
+      if ((threadParms = ptw32_threadCachePark (&parked, exitEvent)) != NULL)
+        {
+          goto NEXT_THREAD;
+        }
+    }
+#if defined(PTW32_STATIC_LIB)
+  else
+#else
+  else if (ptw32_flsIndex != FLS_OUT_OF_INDEXES)
+#endif
+    {
+      /*
+       * We need to cleanup the pthread now if we have
+       * been statically linked, or if the dll leaves thread
+       * exits to FLS, in which case the cleanup in dllMain
+       * won't get done. Joinable threads will
+       * only be partially cleaned up and must be fully cleaned
+       * up by pthread_join() or pthread_detach().
+       *
+       * Note: implicitly created pthreads (those created
+       * for Win32 threads which have called pthreads routines)
+       * are cleaned up by the FLS callback or by dllMain. Without
+       * FLS (before Windows Vista) they must be cleaned up
+       * explicitly by the application of a statically linked
+       * library (by calling pthread_win32_thread_detach_np()).
+       */
+      (void) pthread_win32_thread_detach_np ();
+    }
 
 #if ! defined (PTW32_CONFIG_MINGW) || defined (__MSVCRT__) || defined (__DMC__)
   _endthreadex ((unsigned)(size_t) status);
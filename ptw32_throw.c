@@ -42,6 +42,11 @@
 # include <setjmp.h>
 #endif
 
+#if (defined(_M_X64) || defined(__x86_64__)) && !defined(UNW_FLAG_EHANDLER)
+# define UNW_FLAG_EHANDLER 0x1
+# define UNW_FLAG_UHANDLER 0x2
+#endif
+
 /*
  * ptw32_throw
  *
@@ -68,13 +73,16 @@ ptw32_throw (DWORD exception)
    * Don't use pthread_self() to avoid creating an implicit POSIX thread handle
    * unnecessarily.
    */
-  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_getspecific (ptw32_selfThreadKey);
+  ptw32_thread_t * sp = PTW32_SELF_THREAD ();
 
 #if defined(__CLEANUP_SEH)
-  DWORD exceptionInformation[3];
+  ULONG_PTR exceptionInformation[3];
 #endif
 
-  sp->state = PThreadStateExiting;
+  if (NULL != sp)
+    {
+      sp->state = PThreadStateExiting;
+    }
 
   if (exception != PTW32_EPS_CANCEL && exception != PTW32_EPS_EXIT)
     {
@@ -82,6 +90,11 @@ ptw32_throw (DWORD exception)
       exit (1);
     }
 
+  if (exception == PTW32_EPS_CANCEL)
+    {
+      PTW32_ETW_EVENT (PTW32_ETW_THREAD_CANCEL, sp, 0);
+    }
+
   if (NULL == sp || sp->implicit)
     {
       /*
@@ -123,12 +136,18 @@ ptw32_throw (DWORD exception)
 
 #if defined(__CLEANUP_SEH)
 
+  /*
+   * Nothing is registered for the handlers: pthread_cleanup_push is a
+   * __try/__finally, which on x64 is only an entry in the unwind
+   * tables. The exception unwinds them on its way to ptw32_threadRun.
+   * The parameters are ULONG_PTRs, 64 bits on x64; the exception is
+   * noncontinuable as there is nowhere to return to.
+   */
+  exceptionInformation[0] = (ULONG_PTR) (exception);
+  exceptionInformation[1] = (ULONG_PTR) (0);
+  exceptionInformation[2] = (ULONG_PTR) (0);
 
-  exceptionInformation[0] = (DWORD) (exception);
-  exceptionInformation[1] = (DWORD) (0);
-  exceptionInformation[2] = (DWORD) (0);
-
-  RaiseException (EXCEPTION_PTW32_SERVICES, 0, 3, (ULONG_PTR *) exceptionInformation);
+  RaiseException (EXCEPTION_PTW32_SERVICES, EXCEPTION_NONCONTINUABLE, 3, exceptionInformation);
 
 #else /* __CLEANUP_SEH */
 
@@ -174,6 +193,85 @@ ptw32_pop_cleanup_all (int execute)
 }
 
 
+/*
+ * ptw32_exit_return
+ *
+ * Called by pthread_exit() before it falls back on ptw32_throw(). If
+ * nothing between here and ptw32_threadRun has cleanup to do, the
+ * thread resumes in ptw32_threadRun as if its start routine had
+ * returned sp->exitStatus, without raising an exception or longjmp.
+ *
+ * On x64 the unwind tables tell whether a frame has anything to do:
+ * __try/__finally (so pthread_cleanup_push in SEH builds) and C++
+ * destructors (in C++ builds) give it a handler. The frames are
+ * virtually unwound up to ptw32_threadRun and the fast path is only
+ * taken if none has a handler, so it is always taken for a
+ * pthread_exit() from the start routine itself that pushes nothing.
+ * C builds keep their handlers on sp->cleanupStack, which must be
+ * empty. Elsewhere, and if anything is found, this returns.
+ */
+void
+ptw32_exit_return (ptw32_thread_t * sp)
+{
+#if defined(_M_X64) || defined(__x86_64__)
+  static PRUNTIME_FUNCTION runEntry = NULL;
+  CONTEXT context;
+  DWORD64 imageBase;
+  PRUNTIME_FUNCTION entry;
+  PVOID handlerData;
+  DWORD64 establisherFrame;
+  int frames;
+
+#if defined(__CLEANUP_C)
+  if (NULL != sp->cleanupStack)
+    {
+      return;
+    }
+#endif
+
+  if (NULL == runEntry)
+    {
+      /*
+       * NULL under incremental linking, when ptw32_threadRun is a
+       * jump thunk, and then the fast path is never taken.
+       */
+      runEntry = RtlLookupFunctionEntry ((DWORD64) (size_t) ptw32_threadRun,
+                                         &imageBase, NULL);
+      if (NULL == runEntry)
+        {
+          return;
+        }
+    }
+
+  RtlCaptureContext (&context);
+
+  for (frames = 0; frames < PTW32_EXIT_RETURN_FRAMES; frames++)
+    {
+      entry = RtlLookupFunctionEntry (context.Rip, &imageBase, NULL);
+
+      if (entry == runEntry)
+        {
+          /*
+           * Just returned from the start routine.
+           */
+          sp->state = PThreadStateExiting;
+          context.Rax = (DWORD64) (size_t) sp->exitStatus;
+          RtlRestoreContext (&context, NULL);
+        }
+
+      if (NULL == entry
+          || NULL != RtlVirtualUnwind (UNW_FLAG_EHANDLER | UNW_FLAG_UHANDLER,
+                                       imageBase, context.Rip, entry, &context,
+                                       &handlerData, &establisherFrame, NULL))
+        {
+          return;
+        }
+    }
+
+#endif
+}
+
+
 DWORD
 ptw32_get_exception_services_code (void)
 {
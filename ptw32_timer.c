@@ -0,0 +1,403 @@
+/*
+ * ptw32_timer.c
+ *
+ * Description:
+ * This translation unit implements POSIX timers.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * POSIX timers: one library thread, started by the first timer_create,
+ * sleeps until the earliest expiry of all armed timers, kept on a
+ * binary heap, on its high resolution waitable timer where the system
+ * has them. When timers expire it hands their SIGEV_THREAD
+ * notifications to a library thread pool, so any number of timers
+ * needs one timer thread and the pool's workers rather than a thread
+ * each.
+ *
+ * A timer has at most one notification queued. Expiries while one is
+ * queued count as its overrun (timer_getoverrun), as do periods the
+ * timer thread slept through. A queued notification holds a reference
+ * to the timer, so timer_delete can free it only when the last one
+ * has run; one queued before the timer was deleted doesn't call the
+ * function.
+ */
+
+#include <limits.h>
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_TIMER_CREATE)
+
+/* Heap order: earliest expiry first */
+static void
+ptw32_timer_place (int i, timer_t t)
+{
+  ptw32_timerHeap[i] = t;
+  t->heapIndex = i;
+}
+
+static void
+ptw32_timer_sift_up (int i)
+{
+  timer_t t = ptw32_timerHeap[i];
+
+  while (i > 0 && ptw32_timerHeap[(i - 1) / 2]->expiry > t->expiry)
+    {
+      ptw32_timer_place (i, ptw32_timerHeap[(i - 1) / 2]);
+      i = (i - 1) / 2;
+    }
+
+  ptw32_timer_place (i, t);
+}
+
+static void
+ptw32_timer_sift_down (int i)
+{
+  timer_t t = ptw32_timerHeap[i];
+
+  for (;;)
+    {
+      int child = 2 * i + 1;
+
+      if (child >= ptw32_timerHeapSize)
+        {
+          break;
+        }
+      if (child + 1 < ptw32_timerHeapSize
+          && ptw32_timerHeap[child + 1]->expiry < ptw32_timerHeap[child]->expiry)
+        {
+          child++;
+        }
+      if (ptw32_timerHeap[child]->expiry >= t->expiry)
+        {
+          break;
+        }
+      ptw32_timer_place (i, ptw32_timerHeap[child]);
+      i = child;
+    }
+
+  ptw32_timer_place (i, t);
+}
+
+/* Takes an armed timer off the heap */
+static void
+ptw32_timer_remove (timer_t t)
+{
+  int i = t->heapIndex;
+  timer_t last = ptw32_timerHeap[--ptw32_timerHeapSize];
+
+  t->heapIndex = -1;
+
+  if (last != t)
+    {
+      ptw32_timer_place (i, last);
+      ptw32_timer_sift_up (i);
+      ptw32_timer_sift_down (last->heapIndex);
+    }
+}
+
+static void
+ptw32_timer_add_overrun (timer_t t, int64_t n)
+{
+  t->overrun = (n >= (int64_t) (INT_MAX - t->overrun)) ? INT_MAX : t->overrun + (int) n;
+}
+
+static void * PTW32_CDECL
+ptw32_timer_notification (void * arg)
+{
+  timer_t t = (timer_t) arg;
+  ptw32_mcs_local_node_t node;
+  int deleted;
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_lock, &node);
+  t->pending = PTW32_FALSE;
+  t->lastOverrun = t->overrun;
+  t->overrun = 0;
+  deleted = t->deleted;
+  ptw32_mcs_lock_release (&node);
+
+  if (!deleted)
+    {
+      t->event.sigev_notify_function (t->event.sigev_value);
+    }
+
+  ptw32_timer_release (t);
+
+  return NULL;
+}
+
+/*
+ * Notifies an expiry, and 'missed' earlier ones that the timer thread
+ * slept through.
+ */
+static void
+ptw32_timer_notify (timer_t t, int64_t missed)
+{
+  if (SIGEV_THREAD != t->event.sigev_notify)
+    {
+      return;
+    }
+
+  if (t->pending)
+    {
+      ptw32_timer_add_overrun (t, missed + 1);
+      return;
+    }
+
+  ptw32_timer_add_overrun (t, missed);
+  t->pending = PTW32_TRUE;
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &t->refs);
+
+  if (0 != pthread_pool_submit_np (ptw32_timerPool, ptw32_timer_notification, t, NULL))
+    {
+      /* Out of memory: lost, as if overrun */
+      t->pending = PTW32_FALSE;
+      (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &t->refs);
+      ptw32_timer_add_overrun (t, 1);
+    }
+}
+
+static void * PTW32_CDECL
+ptw32_timer_thread (void * arg)
+{
+  ptw32_mcs_local_node_t node;
+  HANDLE handles[2];
+
+  /*
+   * Nothing cancels this thread, and its waits aren't cancellation
+   * points.
+   */
+  (void) pthread_setcancelstate (PTHREAD_CANCEL_DISABLE, NULL);
+
+  handles[0] = ptw32_timerEvent;
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_lock, &node);
+
+  for (;;)
+    {
+      int64_t now = ptw32_monotonic_100nanosecs ();
+      struct timespec deadline;
+      struct timespec * abstime = NULL;
+      DWORD milliseconds;
+
+      while (ptw32_timerHeapSize > 0 && ptw32_timerHeap[0]->expiry <= now)
+        {
+          timer_t t = ptw32_timerHeap[0];
+          int64_t missed = 0;
+
+          if (t->interval > 0)
+            {
+              missed = (now - t->expiry) / t->interval;
+              t->expiry += (missed + 1) * t->interval;
+              ptw32_timer_sift_down (0);
+            }
+          else
+            {
+              ptw32_timer_remove (t);
+            }
+
+          ptw32_timer_notify (t, missed);
+        }
+
+      if (ptw32_timerHeapSize > 0)
+        {
+          int64_t expiry = ptw32_timerHeap[0]->expiry;
+
+          deadline.tv_sec = (time_t) (expiry / 10000000);
+          deadline.tv_nsec = (long) (expiry % 10000000) * 100;
+          abstime = &deadline;
+        }
+
+      ptw32_mcs_lock_release (&node);
+
+      milliseconds = ptw32_wait_timeout (CLOCK_MONOTONIC, abstime, &handles[1]);
+      PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_OTHER);
+      (void) ptw32_wait_objects ((handles[1] == NULL) ? 1 : 2, handles, milliseconds);
+
+      ptw32_mcs_lock_acquire (&ptw32_timer_lock, &node);
+    }
+
+  return NULL;
+}
+
+
+int
+ptw32_timer_start (void)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Starts the timer thread and its pool if they aren't
+      *      running. The caller holds ptw32_timer_lock.
+      *
+      * RESULTS
+      *              0               they are running,
+      *              EAGAIN          they couldn't be started.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_attr_t attr;
+  pthread_t thread;
+  int result;
+
+  if (ptw32_timerPool != NULL)
+    {
+      return 0;
+    }
+
+  if (NULL == ptw32_timerEvent
+      && NULL == (ptw32_timerEvent = ptw32_libstat_handle (CreateEvent (NULL, PTW32_FALSE, PTW32_FALSE, NULL),
+                                                             PTW32_LIBSTAT_EVENTS)))
+    {
+      return EAGAIN;
+    }
+
+  if (0 != pthread_pool_create_np (&ptw32_timerPool, NULL, 0))
+    {
+      ptw32_timerPool = NULL;
+      return EAGAIN;
+    }
+
+  if (0 == (result = pthread_attr_init (&attr)))
+    {
+      (void) pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+      result = pthread_create (&thread, &attr, ptw32_timer_thread, NULL);
+      (void) pthread_attr_destroy (&attr);
+    }
+
+  if (0 != result)
+    {
+      (void) pthread_pool_destroy_np (&ptw32_timerPool);
+      ptw32_timerPool = NULL;
+      return EAGAIN;
+    }
+
+  return 0;
+}
+
+
+int
+ptw32_timer_reserve (int count)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Makes room on the heap for 'count' timers, so that
+      *      arming one never fails. The caller holds
+      *      ptw32_timer_lock.
+      *
+      * RESULTS
+      *              0               there is room,
+      *              EAGAIN          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int capacity = (ptw32_timerCapacity > 0) ? ptw32_timerCapacity : 16;
+  timer_t * heap;
+
+  if (count <= ptw32_timerCapacity)
+    {
+      return 0;
+    }
+
+  while (capacity < count)
+    {
+      capacity *= 2;
+    }
+
+  if (NULL == (heap = (timer_t *) realloc (ptw32_timerHeap, capacity * sizeof (timer_t))))
+    {
+      return EAGAIN;
+    }
+
+  ptw32_timerHeap = heap;
+  ptw32_timerCapacity = capacity;
+
+  return 0;
+}
+
+
+void
+ptw32_timer_arm (timer_t t, int64_t expiry, int64_t interval)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Arms 't' to expire at 'expiry' (monotonic, in 100
+      *      nanosecond units) and every 'interval' after that
+      *      (0: once), or disarms it if 'expiry' is negative.
+      *      Wakes the timer thread if the earliest expiry has
+      *      changed. The caller holds ptw32_timer_lock.
+      *
+      * ------------------------------------------------------
+      */
+{
+  timer_t top = (ptw32_timerHeapSize > 0) ? ptw32_timerHeap[0] : NULL;
+
+  if (t->heapIndex >= 0)
+    {
+      ptw32_timer_remove (t);
+    }
+
+  t->overrun = 0;
+
+  if (expiry >= 0)
+    {
+      t->expiry = expiry;
+      t->interval = interval;
+      ptw32_timer_place (ptw32_timerHeapSize++, t);
+      ptw32_timer_sift_up (t->heapIndex);
+    }
+
+  if (ptw32_timerHeapSize > 0 && (top != ptw32_timerHeap[0] || top == t))
+    {
+      (void) PTW32_SETEVENT (ptw32_timerEvent);
+    }
+}
+
+
+void
+ptw32_timer_release (timer_t t)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Drops a reference to 't', freeing it with the last.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (0 == PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &t->refs))
+    {
+      free (t);
+    }
+}
+
+#endif /* PTW32_TIMER_CREATE */
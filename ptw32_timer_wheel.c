@@ -0,0 +1,441 @@
+/*
+ * ptw32_timer_wheel.c
+ *
+ * Description:
+ * This translation unit implements the timer wheel for timed waits.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * The timer wheel: with a timer slack set (see pthread_settimerslack_np)
+ * a WaitOnAddress wait with a timeout doesn't give the system a timeout
+ * of its own. The waiter parks with no timeout in a node on its stack,
+ * queued on a hierarchical timer wheel whose ticks are the slack long,
+ * and one library thread sleeps until the next tick that ends a wait.
+ * Deadlines that fall in the same tick are ended together, so many
+ * staggered waits cost the system one timer rather than one each, and
+ * a wait that is woken before its deadline, as most are, costs it none.
+ * A wait ends up to a tick late.
+ *
+ * A wait that has reached its tick is moved to ptw32_timerWheelExpired
+ * and woken through ptw32_wakebyaddressall (the system's or the
+ * parking lot's). The value at the address hasn't changed, so a waiter
+ * that was about to park would miss that wake; the wheel thread wakes
+ * the expired list again every tick until each waiter has taken itself
+ * off it. All of it is done with ptw32_timer_wheel_lock held, which
+ * waiters take to leave the wheel, so a node is never used after its
+ * waiter has returned.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/* Queues t by its tick; the caller holds ptw32_timer_wheel_lock */
+static void
+ptw32_timer_wheel_insert (ptw32_wheel_timer_t * t)
+{
+  int64_t expires = t->expires;
+  int64_t delta = expires - ptw32_timerWheelNext;
+  int level = 0;
+  ptw32_wheel_timer_t ** slot;
+
+  if (delta < 0)
+    {
+      /* Ended by the next tick run */
+      expires = ptw32_timerWheelNext;
+    }
+  else if (delta >= (int64_t) 1 << (PTW32_WHEEL_BITS * PTW32_WHEEL_LEVELS))
+    {
+      /* Beyond the wheel: requeued when the top level turns */
+      expires = ptw32_timerWheelNext
+                + ((int64_t) 1 << (PTW32_WHEEL_BITS * PTW32_WHEEL_LEVELS)) - 1;
+      level = PTW32_WHEEL_LEVELS - 1;
+    }
+  else
+    {
+      while (delta >= (int64_t) 1 << (PTW32_WHEEL_BITS * (level + 1)))
+        {
+          level++;
+        }
+    }
+
+  slot = &ptw32_timerWheel[level][(expires >> (PTW32_WHEEL_BITS * level)) & PTW32_WHEEL_MASK];
+
+  t->link = slot;
+  t->next = *slot;
+  if (t->next != NULL)
+    {
+      t->next->link = &t->next;
+    }
+  *slot = t;
+}
+
+/* Takes t off its list; the caller holds ptw32_timer_wheel_lock */
+static void
+ptw32_timer_wheel_remove (ptw32_wheel_timer_t * t)
+{
+  *t->link = t->next;
+  if (t->next != NULL)
+    {
+      t->next->link = t->link;
+    }
+}
+
+/* Requeues a slot of a higher level onto the levels below it */
+static void
+ptw32_timer_wheel_cascade (int level, int index)
+{
+  ptw32_wheel_timer_t * t = ptw32_timerWheel[level][index];
+
+  ptw32_timerWheel[level][index] = NULL;
+
+  while (t != NULL)
+    {
+      ptw32_wheel_timer_t * next = t->next;
+
+      ptw32_timer_wheel_insert (t);
+      t = next;
+    }
+}
+
+/*
+ * Runs the ticks up to and including 'now', moving the waits they end
+ * to the expired list.
+ */
+static void
+ptw32_timer_wheel_run (int64_t now)
+{
+  if (0 == ptw32_timerWheelCount)
+    {
+      /* Nothing to end: skip the idle ticks */
+      if (ptw32_timerWheelNext <= now)
+        {
+          ptw32_timerWheelNext = now + 1;
+        }
+      return;
+    }
+
+  while (ptw32_timerWheelNext <= now)
+    {
+      int64_t tick = ptw32_timerWheelNext;
+      ptw32_wheel_timer_t ** slot = &ptw32_timerWheel[0][tick & PTW32_WHEEL_MASK];
+      int level;
+
+      for (level = 1; level < PTW32_WHEEL_LEVELS; level++)
+        {
+          if (0 != ((tick >> (PTW32_WHEEL_BITS * (level - 1))) & PTW32_WHEEL_MASK))
+            {
+              break;
+            }
+          ptw32_timer_wheel_cascade (level,
+                                     (int) ((tick >> (PTW32_WHEEL_BITS * level)) & PTW32_WHEEL_MASK));
+        }
+
+      while (*slot != NULL)
+        {
+          ptw32_wheel_timer_t * t = *slot;
+
+          ptw32_timer_wheel_remove (t);
+          t->expired = PTW32_TRUE;
+          t->link = &ptw32_timerWheelExpired;
+          t->next = ptw32_timerWheelExpired;
+          if (t->next != NULL)
+            {
+              t->next->link = &t->next;
+            }
+          ptw32_timerWheelExpired = t;
+          ptw32_timerWheelCount--;
+        }
+
+      ptw32_timerWheelNext = tick + 1;
+    }
+}
+
+/* The next tick the wheel thread must run, or -1 if there is none */
+static int64_t
+ptw32_timer_wheel_next_tick (void)
+{
+  int64_t tick = ptw32_timerWheelNext;
+  int64_t turn = (tick | PTW32_WHEEL_MASK) + 1;
+
+  if (ptw32_timerWheelExpired != NULL)
+    {
+      return tick;
+    }
+
+  if (0 == ptw32_timerWheelCount)
+    {
+      return -1;
+    }
+
+  for (; tick < turn; tick++)
+    {
+      if (ptw32_timerWheel[0][tick & PTW32_WHEEL_MASK] != NULL)
+        {
+          return tick;
+        }
+    }
+
+  /* Nothing more on level 0 before the levels above are requeued */
+  return turn;
+}
+
+static void * PTW32_CDECL
+ptw32_timer_wheel_thread (void * arg)
+{
+  ptw32_mcs_local_node_t node;
+
+  (void) pthread_setcancelstate (PTHREAD_CANCEL_DISABLE, NULL);
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_wheel_lock, &node);
+
+  for (;;)
+    {
+      int64_t now = ptw32_monotonic_100nanosecs ();
+      int64_t tick;
+      DWORD milliseconds = INFINITE;
+      ptw32_wheel_timer_t * t;
+
+      ptw32_timer_wheel_run (now / ptw32_timerWheelTick);
+
+      for (t = ptw32_timerWheelExpired; t != NULL; t = t->next)
+        {
+          ptw32_wakebyaddressall ((PVOID) t->address);
+        }
+
+      if ((tick = ptw32_timer_wheel_next_tick ()) >= 0)
+        {
+          int64_t wait = tick * ptw32_timerWheelTick - now;
+
+          milliseconds = (wait <= 0) ? 1 : (DWORD) ((wait + 9999) / 10000);
+        }
+      ptw32_timerWheelWake = tick;
+
+      ptw32_mcs_lock_release (&node);
+      PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_OTHER);
+      (void) WaitForSingleObject (ptw32_timerWheelEvent, milliseconds);
+      ptw32_mcs_lock_acquire (&ptw32_timer_wheel_lock, &node);
+    }
+
+  return NULL;
+}
+
+/*
+ * Starts the wheel thread if it isn't running; the caller holds
+ * ptw32_timer_wheel_lock. Returns nonzero if it is running.
+ */
+static int
+ptw32_timer_wheel_start (void)
+{
+  pthread_attr_t attr;
+  pthread_t thread;
+  LONG slack;
+  int result;
+
+  if (0 != ptw32_timerWheelTick)
+    {
+      return PTW32_TRUE;
+    }
+
+  if (0 == (slack = ptw32_timerSlack))
+    {
+      return PTW32_FALSE;
+    }
+
+  if (NULL == ptw32_timerWheelEvent
+      && NULL == (ptw32_timerWheelEvent = ptw32_libstat_handle (CreateEvent (NULL, PTW32_FALSE, PTW32_FALSE, NULL),
+                                                                  PTW32_LIBSTAT_EVENTS)))
+    {
+      return PTW32_FALSE;
+    }
+
+  ptw32_timerWheelTick = slack;
+  ptw32_timerWheelNext = ptw32_monotonic_100nanosecs () / slack + 1;
+  ptw32_timerWheelWake = -1;
+
+  if (0 != (result = pthread_attr_init (&attr)))
+    {
+      ptw32_timerWheelTick = 0;
+      return PTW32_FALSE;
+    }
+
+  (void) pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+  if (0 != (result = pthread_create (&thread, &attr, ptw32_timer_wheel_thread, NULL)))
+    {
+      ptw32_timerWheelTick = 0;
+    }
+  (void) pthread_attr_destroy (&attr);
+
+  return 0 == result;
+}
+
+
+BOOL
+ptw32_timer_wheel_wait (volatile VOID * address, PVOID compare,
+                        SIZE_T size, int64_t timeout)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      WaitOnAddress for up to 'timeout' 100 nanosecond
+      *      units, ended by the timer wheel up to a tick late.
+      *      Starts the wheel thread if need be; if it can't be
+      *      started, gives the system the timeout instead.
+      *
+      * RESULTS
+      *              As WaitOnAddress: TRUE if woken (possibly
+      *              spuriously), FALSE with the last error set to
+      *              ERROR_TIMEOUT if the wait timed out.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  ptw32_wheel_timer_t t;
+  int64_t now = ptw32_monotonic_100nanosecs ();
+  int64_t start;
+  BOOL woken;
+
+  t.address = address;
+  t.deadline = now + timeout;
+  t.expired = PTW32_FALSE;
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_wheel_lock, &node);
+
+  if (!ptw32_timer_wheel_start ())
+    {
+      ptw32_mcs_lock_release (&node);
+
+      start = ptw32_wait_begin ();
+      woken = ptw32_waitonaddress (address, compare, size, (DWORD) ((timeout + 9999) / 10000));
+      ptw32_wait_end (start);
+
+      return woken;
+    }
+
+  if (0 == ptw32_timerWheelCount)
+    {
+      /* Start from now rather than run every tick the wheel was idle */
+      ptw32_timerWheelNext = now / ptw32_timerWheelTick;
+    }
+
+  t.expires = (t.deadline + ptw32_timerWheelTick - 1) / ptw32_timerWheelTick;
+  ptw32_timer_wheel_insert (&t);
+  ptw32_timerWheelCount++;
+
+  if (ptw32_timerWheelWake < 0 || t.expires < ptw32_timerWheelWake)
+    {
+      /* The wheel thread sleeps past this tick: bring it forward */
+      ptw32_timerWheelWake = t.expires;
+      (void) PTW32_SETEVENT (ptw32_timerWheelEvent);
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  start = ptw32_wait_begin ();
+  (void) ptw32_waitonaddress (address, compare, size, INFINITE);
+  ptw32_wait_end (start);
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_wheel_lock, &node);
+
+  ptw32_timer_wheel_remove (&t);
+  if (!(woken = !t.expired))
+    {
+      SetLastError (ERROR_TIMEOUT);
+    }
+  else
+    {
+      ptw32_timerWheelCount--;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return woken;
+}
+
+
+void
+ptw32_timer_wheel_retick (int64_t tick)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Gives the wheel, if its thread is running, ticks
+      *      'tick' 100 nanosecond units long, requeueing the
+      *      waits on it by their deadlines. The caller holds
+      *      ptw32_timer_wheel_lock.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_wheel_timer_t * all = NULL;
+  int level;
+  int index;
+
+  if (0 == ptw32_timerWheelTick || tick == ptw32_timerWheelTick)
+    {
+      return;
+    }
+
+  for (level = 0; level < PTW32_WHEEL_LEVELS; level++)
+    {
+      for (index = 0; index < PTW32_WHEEL_SLOTS; index++)
+        {
+          ptw32_wheel_timer_t * t = ptw32_timerWheel[level][index];
+
+          ptw32_timerWheel[level][index] = NULL;
+
+          while (t != NULL)
+            {
+              ptw32_wheel_timer_t * next = t->next;
+
+              t->next = all;
+              all = t;
+              t = next;
+            }
+        }
+    }
+
+  ptw32_timerWheelTick = tick;
+  ptw32_timerWheelNext = ptw32_monotonic_100nanosecs () / tick + 1;
+
+  while (all != NULL)
+    {
+      ptw32_wheel_timer_t * t = all;
+
+      all = t->next;
+      t->expires = (t->deadline + tick - 1) / tick;
+      ptw32_timer_wheel_insert (t);
+    }
+
+  /* Have the wheel thread work out its next tick again */
+  ptw32_timerWheelWake = 0;
+  (void) PTW32_SETEVENT (ptw32_timerWheelEvent);
+}
@@ -39,13 +39,11 @@
 #include "implement.h"
 
 
-#if defined(NEED_FTIME)
-
 /*
- * time between jan 1, 1601 and jan 1, 1970 in units of 100 nanoseconds
+ * 100 nanosecond units per second.
  */
-#define PTW32_TIMESPEC_TO_FILETIME_OFFSET \
-	  ( ((int64_t) 27111902 << 32) + (int64_t) 3577643008 )
+#define PTW32_HUNDREDNANOSECS_PER_SEC 10000000
+
 
 INLINE void
 ptw32_timespec_to_filetime (const struct timespec *ts, FILETIME * ft)
@@ -58,7 +56,7 @@ ptw32_timespec_to_filetime (const struct timespec *ts, FILETIME * ft)
       * -------------------------------------------------------------------
       */
 {
-  *(int64_t *) ft = ts->tv_sec * 10000000
+  *(int64_t *) ft = (int64_t) ts->tv_sec * PTW32_HUNDREDNANOSECS_PER_SEC
     + (ts->tv_nsec + 50) / 100 + PTW32_TIMESPEC_TO_FILETIME_OFFSET;
 }
 
@@ -70,14 +68,158 @@ ptw32_filetime_to_timespec (const FILETIME * ft, struct timespec *ts)
       * expressed in 100 nanoseconds from Jan 1, 1601,
       * into struct timespec
       * where the time is expressed in seconds and nanoseconds from Jan 1, 1970.
+      *
+      * Division by a constant compiles to a multiply, so there are no
+      * branches or divide instructions here.
       * -------------------------------------------------------------------
       */
 {
-  ts->tv_sec =
-    (int) ((*(int64_t *) ft - PTW32_TIMESPEC_TO_FILETIME_OFFSET) / 10000000);
-  ts->tv_nsec =
-    (int) ((*(int64_t *) ft - PTW32_TIMESPEC_TO_FILETIME_OFFSET -
-	    ((int64_t) ts->tv_sec * (int64_t) 10000000)) * 100);
+  int64_t t = ((int64_t) ft->dwHighDateTime << 32) + (int64_t) ft->dwLowDateTime
+	      - PTW32_TIMESPEC_TO_FILETIME_OFFSET;
+  int64_t sec = t / PTW32_HUNDREDNANOSECS_PER_SEC;
+
+  ts->tv_sec = (time_t) sec;
+  ts->tv_nsec = (long) (t - sec * PTW32_HUNDREDNANOSECS_PER_SEC) * 100;
 }
 
+INLINE void
+ptw32_filetime_now (FILETIME * ft)
+     /*
+      * -------------------------------------------------------------------
+      * Reads the system time with GetSystemTimePreciseAsFileTime where
+      * the system provides it (Windows 8 and later); otherwise it has the
+      * resolution of the system clock tick.
+      * -------------------------------------------------------------------
+      */
+{
+#if defined(NEED_FTIME)
+
+  SYSTEMTIME st;
+
+  GetSystemTime(&st);
+  SystemTimeToFileTime(&st, ft);
+  /*
+   * GetSystemTimeAsFileTime(&ft); would be faster,
+   * but it does not exist on WinCE
+   */
+
+#else /* ! NEED_FTIME */
+
+  if (ptw32_getsystemtimepreciseasfiletime != NULL)
+    {
+      ptw32_getsystemtimepreciseasfiletime(ft);
+    }
+  else
+    {
+      GetSystemTimeAsFileTime(ft);
+    }
+
 #endif /* NEED_FTIME */
+}
+
+INLINE int64_t
+ptw32_perf_frequency (void)
+     /*
+      * -------------------------------------------------------------------
+      * Returns the QueryPerformanceFrequency value, which is fixed at
+      * boot, reading it only once.
+      * -------------------------------------------------------------------
+      */
+{
+  int64_t frequency = ptw32_perfFrequency;
+
+  if (frequency == 0)
+    {
+      LARGE_INTEGER f;
+
+      (void) QueryPerformanceFrequency(&f);
+      /* Racing threads all store the same value */
+      ptw32_perfFrequency = frequency = f.QuadPart;
+    }
+
+  return frequency;
+}
+
+INLINE unsigned __int64
+ptw32_ticks_to_ns (int64_t ticks)
+     /*
+      * -------------------------------------------------------------------
+      * Converts a duration in QueryPerformanceCounter ticks to
+      * nanoseconds.
+      * -------------------------------------------------------------------
+      */
+{
+  int64_t frequency = ptw32_perf_frequency ();
+
+  /* Split to keep ticks * 10^9 from overflowing */
+  return (unsigned __int64) ((ticks / frequency) * 1000000000
+                             + (ticks % frequency) * 1000000000 / frequency);
+}
+
+INLINE void
+ptw32_monotonic_now (struct timespec *ts)
+     /*
+      * -------------------------------------------------------------------
+      * Reads CLOCK_MONOTONIC: QueryPerformanceCounter ticks converted as
+      * described in pthread.h.
+      * -------------------------------------------------------------------
+      */
+{
+  LARGE_INTEGER count;
+  int64_t frequency = ptw32_perf_frequency();
+
+  (void) QueryPerformanceCounter(&count);
+
+  ts->tv_sec = (time_t) (count.QuadPart / frequency);
+  ts->tv_nsec = (long) ((count.QuadPart % frequency) * 1000000000 / frequency);
+}
+
+int64_t
+ptw32_monotonic_100nanosecs (void)
+     /*
+      * -------------------------------------------------------------------
+      * Reads CLOCK_MONOTONIC in 100 nanosecond units.
+      * -------------------------------------------------------------------
+      */
+{
+  LARGE_INTEGER count;
+  int64_t frequency = ptw32_perf_frequency();
+
+  (void) QueryPerformanceCounter(&count);
+
+  return (count.QuadPart / frequency) * 10000000
+         + (count.QuadPart % frequency) * 10000000 / frequency;
+}
+
+void
+ptw32_monotonic_deadline (clockid_t clock, const struct timespec * abstime,
+                          struct timespec * deadline)
+     /*
+      * -------------------------------------------------------------------
+      * Sets *deadline to the CLOCK_MONOTONIC time at which abstime,
+      * measured against 'clock', will be reached, so that a wait made of
+      * several sleeps reads the system time only once. A
+      * PTW32_CLOCK_RELATIVE abstime is a duration from now.
+      * -------------------------------------------------------------------
+      */
+{
+  int64_t remaining;
+
+  if (clock == CLOCK_MONOTONIC)
+    {
+      *deadline = *abstime;
+      return;
+    }
+
+  remaining = ptw32_rel100nanosecs (clock, abstime);
+
+  ptw32_monotonic_now (deadline);
+
+  deadline->tv_sec += (time_t) (remaining / 10000000);
+  deadline->tv_nsec += (long) (remaining % 10000000) * 100;
+  if (deadline->tv_nsec >= 1000000000)
+    {
+      deadline->tv_sec++;
+      deadline->tv_nsec -= 1000000000;
+    }
+}
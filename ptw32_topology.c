@@ -0,0 +1,258 @@
+/*
+ * ptw32_topology.c
+ *
+ * Description:
+ * This translation unit implements routines which are private to
+ * the implementation and may be used throughout it.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Records id against each CPU in affinity.
+ */
+static void
+ptw32_topologyAdd (int * table, const ptw32_group_affinity_t * affinity, int id)
+{
+  int bit;
+
+  if (affinity->Group >= PTW32_CPU_SET_GROUPS)
+    {
+      return;
+    }
+
+  for (bit = 0; bit < (int) PTW32_CPU_GROUP_SIZE; bit++)
+    {
+      if (affinity->Mask & ((DWORD_PTR) 1 << bit))
+	{
+	  table[affinity->Group * PTW32_CPU_GROUP_SIZE + bit] = id;
+	}
+    }
+}
+
+
+/*
+ * Fills the topology from GetLogicalProcessorInformationEx. The last
+ * level cache is the highest level data or unified cache.
+ */
+static int
+ptw32_topologyRead (ptw32_topology_t * t)
+{
+  ptw32_processor_info_t * info;
+  BYTE * buf = NULL;
+  DWORD len = 0;
+  DWORD off;
+  int level = 0;
+  int cores = 0;
+  int caches = 0;
+  int result = PTW32_FALSE;
+
+  if (NULL == ptw32_getlogicalprocessorinformationex
+      || ptw32_getlogicalprocessorinformationex (PTW32_RELATION_ALL, NULL, &len)
+      || ERROR_INSUFFICIENT_BUFFER != GetLastError ()
+      || NULL == (buf = (BYTE *) malloc (len)))
+    {
+      return result;
+    }
+
+  if (ptw32_getlogicalprocessorinformationex (PTW32_RELATION_ALL,
+					      (ptw32_processor_info_t *) buf, &len))
+    {
+      for (off = 0; off < len && ((ptw32_processor_info_t *) (buf + off))->Size; off += info->Size)
+	{
+	  info = (ptw32_processor_info_t *) (buf + off);
+
+	  if (PTW32_RELATION_CACHE == info->Relationship
+	      && (PTW32_CACHE_UNIFIED == info->u.Cache.Type || PTW32_CACHE_DATA == info->u.Cache.Type)
+	      && info->u.Cache.Level > level)
+	    {
+	      level = info->u.Cache.Level;
+	    }
+	}
+
+      for (off = 0; off < len && ((ptw32_processor_info_t *) (buf + off))->Size; off += info->Size)
+	{
+	  WORD g;
+	  WORD n;
+
+	  info = (ptw32_processor_info_t *) (buf + off);
+
+	  switch (info->Relationship)
+	    {
+	    case PTW32_RELATION_PROCESSOR_CORE:
+	      for (g = 0; g < info->u.Processor.GroupCount; g++)
+		{
+		  ptw32_topologyAdd (t->core, &info->u.Processor.GroupMask[g], cores);
+		  ptw32_topologyAdd (t->efficiency, &info->u.Processor.GroupMask[g],
+				     (int) info->u.Processor.EfficiencyClass);
+		}
+	      if ((int) info->u.Processor.EfficiencyClass >= t->nClasses)
+		{
+		  t->nClasses = (int) info->u.Processor.EfficiencyClass + 1;
+		}
+	      cores++;
+	      break;
+	    case PTW32_RELATION_NUMA_NODE:
+	      n = (info->u.NumaNode.GroupCount ? info->u.NumaNode.GroupCount : 1);
+	      for (g = 0; g < n; g++)
+		{
+		  ptw32_topologyAdd (t->node, &info->u.NumaNode.GroupMask[g],
+				     (int) info->u.NumaNode.NodeNumber);
+		}
+	      if ((int) info->u.NumaNode.NodeNumber >= t->nNodes)
+		{
+		  t->nNodes = (int) info->u.NumaNode.NodeNumber + 1;
+		}
+	      break;
+	    case PTW32_RELATION_CACHE:
+	      if (info->u.Cache.Level == level
+		  && (PTW32_CACHE_UNIFIED == info->u.Cache.Type || PTW32_CACHE_DATA == info->u.Cache.Type))
+		{
+		  n = (info->u.Cache.GroupCount ? info->u.Cache.GroupCount : 1);
+		  for (g = 0; g < n; g++)
+		    {
+		      ptw32_topologyAdd (t->cache, &info->u.Cache.GroupMask[g], caches);
+		    }
+		  caches++;
+		}
+	      break;
+	    }
+	}
+
+      result = (cores > 0 && t->nNodes > 0);
+    }
+
+  free (buf);
+
+  return result;
+}
+
+
+ptw32_topology_t *
+ptw32_gettopology (void)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns the processor topology, building it the first
+      *      time. Without GetLogicalProcessorInformationEx the
+      *      CPUs available to the process make up one NUMA node
+      *      of one efficiency class and share one cache, and each
+      *      is its own core.
+      *
+      * RESULTS
+      *              the topology, or NULL if out of memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  ptw32_topology_t * t;
+
+  ptw32_mcs_lock_acquire (&ptw32_topology_lock, &node);
+
+  if (NULL == (t = ptw32_topology)
+      && NULL != (t = (ptw32_topology_t *) malloc (sizeof (*t))))
+    {
+      int cpu;
+
+      t->nNodes = 0;
+      t->nClasses = 0;
+      for (cpu = 0; cpu < (int) CPU_SETSIZE; cpu++)
+	{
+	  t->node[cpu] = t->core[cpu] = t->cache[cpu] = t->efficiency[cpu] = -1;
+	}
+
+      if (!ptw32_topologyRead (t))
+	{
+	  cpu_set_t processCpuset;
+
+	  t->nNodes = 1;
+	  t->nClasses = 1;
+	  CPU_ZERO (&processCpuset);
+#if ! defined(NEED_PROCESS_AFFINITY_MASK)
+	  (void) ptw32_getprocessaffinity (&processCpuset);
+#endif
+	  if (0 == CPU_COUNT (&processCpuset))
+	    {
+	      CPU_SET (0, &processCpuset);
+	    }
+
+	  for (cpu = 0; cpu < (int) CPU_SETSIZE; cpu++)
+	    {
+	      if (CPU_ISSET (cpu, &processCpuset))
+		{
+		  t->node[cpu] = 0;
+		  t->core[cpu] = cpu;
+		  t->cache[cpu] = 0;
+		  t->efficiency[cpu] = 0;
+		}
+	      else
+		{
+		  t->node[cpu] = t->core[cpu] = t->cache[cpu] = t->efficiency[cpu] = -1;
+		}
+	    }
+	}
+
+      ptw32_topology = t;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return t;
+}
+
+
+void
+ptw32_topologycpus (const int * table, int id, cpu_set_t * cpuset)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns in cpuset the CPUs that have id in table, one
+      *      of the node, core, cache or efficiency tables of the
+      *      topology.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int cpu;
+
+  CPU_ZERO (cpuset);
+
+  for (cpu = 0; cpu < (int) CPU_SETSIZE; cpu++)
+    {
+      if (table[cpu] == id)
+	{
+	  CPU_SET (cpu, cpuset);
+	}
+    }
+}
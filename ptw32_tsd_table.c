@@ -0,0 +1,504 @@
+/*
+ * ptw32_tsd_table.c
+ *
+ * Description:
+ * POSIX thread functions which implement thread-specific data (TSD).
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+static ptw32_tsd_table_t *
+ptw32_tsd_table_self (void)
+{
+  ptw32_tsd_table_t * table;
+
+#if defined(PTW32_TEB_TLS_VALUE)
+  if (ptw32_tsdTableIndex < PTW32_TEB_TLS_SLOTS)
+    {
+      return (ptw32_tsd_table_t *) PTW32_TEB_TLS_VALUE(ptw32_tsdTableIndex);
+    }
+#endif
+
+  {
+    int lasterror = GetLastError ();
+#if defined(RETAIN_WSALASTERROR)
+    int lastWSAerror = WSAGetLastError ();
+#endif
+    table = (ptw32_tsd_table_t *) TlsGetValue (ptw32_tsdTableIndex);
+
+    SetLastError (lasterror);
+#if defined(RETAIN_WSALASTERROR)
+    WSASetLastError (lastWSAerror);
+#endif
+  }
+
+  return table;
+}
+
+
+int
+ptw32_tsd_slot_alloc (pthread_key_t key)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Gives 'key' a slot, reusing the slot of a deleted key
+      *      if there is one, and a new generation number. The slot
+      *      indexes ptw32_tsdKeys, the thread destructor bitmaps
+      *      and, for table keys, the per-thread TSD tables.
+      *
+      *      'key' must be otherwise complete: threads that exit
+      *      may look at it as soon as it is registered.
+      *
+      * RESULTS
+      *              0               success,
+      *              ENOMEM          insufficient memory,
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&ptw32_tsd_slot_lock, &node);
+
+  if (ptw32_tsdNumFreeSlots > 0)
+    {
+      key->slot = ptw32_tsdFreeSlots[--ptw32_tsdNumFreeSlots];
+    }
+  else
+    {
+      /*
+       * Make room to free every slot allocated so far, and to
+       * retire a TLS index for each, so that ptw32_tsd_slot_free
+       * can't fail.
+       */
+      unsigned int * freeSlots;
+      pthread_key_t * keys;
+      DWORD * retired;
+
+      freeSlots = (unsigned int *)
+	realloc (ptw32_tsdFreeSlots, (ptw32_tsdNextSlot + 1) * sizeof (unsigned int));
+
+      if (freeSlots != NULL)
+	{
+	  ptw32_tsdFreeSlots = freeSlots;
+	}
+
+      keys = (pthread_key_t *)
+	realloc (ptw32_tsdKeys, (ptw32_tsdNextSlot + 1) * sizeof (pthread_key_t));
+
+      if (keys != NULL)
+	{
+	  ptw32_tsdKeys = keys;
+	}
+
+      retired = (DWORD *)
+	realloc (ptw32_tsdRetired, (ptw32_tsdNextSlot + 1) * sizeof (DWORD));
+
+      if (retired != NULL)
+	{
+	  ptw32_tsdRetired = retired;
+	}
+
+      if (freeSlots == NULL || keys == NULL || retired == NULL)
+	{
+	  ptw32_mcs_lock_release (&node);
+	  return ENOMEM;
+	}
+
+      key->slot = ptw32_tsdNextSlot++;
+    }
+
+  /* Generation 0 marks table entries never set */
+  if (++ptw32_tsdGeneration == 0)
+    {
+      ++ptw32_tsdGeneration;
+    }
+  key->generation = ptw32_tsdGeneration;
+
+  ptw32_tsdKeys[key->slot] = key;
+
+  ptw32_mcs_lock_release (&node);
+
+  return 0;
+}
+
+
+void
+ptw32_tsd_slot_free (pthread_key_t key)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Unregisters a deleted key and returns its slot for
+      *      reuse. Once this returns no exiting thread will look
+      *      at 'key'. Its TLS index, if it has one, is retired
+      *      rather than freed while there are table keys to use
+      *      instead.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  DWORD index = TLS_OUT_OF_INDEXES;
+
+  ptw32_mcs_lock_acquire (&ptw32_tsd_slot_lock, &node);
+  ptw32_tsdKeys[key->slot] = NULL;
+  ptw32_tsdFreeSlots[ptw32_tsdNumFreeSlots++] = key->slot;
+  if (!PTW32_KEY_IN_TABLE(key))
+    {
+      /*
+       * Keys are made with indexes only until the first is
+       * retired, so there is nearly always room; a key made in
+       * the meantime may find none.
+       */
+      if (ptw32_tsdTableIndex != TLS_OUT_OF_INDEXES
+	  && ptw32_tsdNumRetired < ptw32_tsdNextSlot)
+	{
+	  ptw32_tsdRetired[ptw32_tsdNumRetired++] = key->key;
+	}
+      else
+	{
+	  index = key->key;
+	}
+    }
+  ptw32_mcs_lock_release (&node);
+
+  if (index != TLS_OUT_OF_INDEXES)
+    {
+      TlsFree (index);
+    }
+}
+
+
+int
+ptw32_tsd_mark_destructor (ptw32_thread_t * sp, pthread_key_t key)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Records in the destructor bitmap of thread 'sp', which
+      *      must be the calling thread, that it has set a value for
+      *      'key'. Bits are never cleared for deleted keys; the
+      *      thread finds the slot empty, or holding a key it has no
+      *      value for, when it exits.
+      *
+      * RESULTS
+      *              0               success,
+      *              ENOMEM          insufficient memory,
+      *
+      * ------------------------------------------------------
+      */
+{
+  unsigned int word = key->slot / 32;
+  unsigned int * bits = PTW32_TSD_DTOR_BITS(sp);
+
+  if (word >= PTW32_TSD_DTOR_WORDS(sp))
+    {
+      unsigned int n = PTW32_TSD_DTOR_WORDS(sp) * 2;
+      unsigned int * newBits;
+
+      while (n <= word)
+	{
+	  n *= 2;
+	}
+
+      if ((newBits = (unsigned int *) calloc (n, sizeof (unsigned int))) == NULL)
+	{
+	  return ENOMEM;
+	}
+
+      memcpy (newBits, bits, PTW32_TSD_DTOR_WORDS(sp) * sizeof (unsigned int));
+
+      if (sp->dtorBits != NULL)
+	{
+	  free (sp->dtorBits);
+	}
+
+      sp->dtorBits = bits = newBits;
+      sp->nDtorWords = n;
+    }
+
+  bits[word] |= 1U << (key->slot % 32);
+
+  if (0 == sp->dtorLimit || word < sp->dtorFirst)
+    {
+      sp->dtorFirst = word;
+    }
+  if (word >= sp->dtorLimit)
+    {
+      sp->dtorLimit = word + 1;
+    }
+
+  return 0;
+}
+
+
+void *
+ptw32_tsd_table_get (pthread_key_t key)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns the calling thread's value for table key 'key',
+      *      leaving the last error code unchanged.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_tsd_table_t * table = ptw32_tsd_table_self ();
+  ptw32_tsd_entry_t * entry;
+
+  if (table == NULL || key->slot >= table->nEntries)
+    {
+      return NULL;
+    }
+
+  entry = &table->entries[key->slot];
+
+  return (entry->generation == key->generation
+	  && (!key->task || entry->task == table->task)) ? entry->value : NULL;
+}
+
+
+int
+ptw32_tsd_table_set (pthread_key_t key, const void * value)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Sets the calling thread's value for table key 'key',
+      *      creating or growing the thread's table as needed.
+      *
+      * RESULTS
+      *              0               success,
+      *              ENOMEM          insufficient memory,
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_tsd_table_t * table = ptw32_tsd_table_self ();
+  ptw32_tsd_entry_t * entry;
+
+  if (table == NULL || key->slot >= table->nEntries)
+    {
+      unsigned int n;
+      void * block;
+      ptw32_tsd_entry_t * entries;
+
+      if (value == NULL)
+	{
+	  /* Unset entries already read as NULL */
+	  return 0;
+	}
+
+      n = (table == NULL) ? 16 : table->nEntries * 2;
+
+      while (n <= key->slot)
+	{
+	  n *= 2;
+	}
+
+      block = calloc (1, n * sizeof (ptw32_tsd_entry_t) + PTW32_CACHE_LINE_SIZE);
+
+      if (block == NULL)
+	{
+	  return ENOMEM;
+	}
+
+      entries = (ptw32_tsd_entry_t *)
+	(((size_t) block + PTW32_CACHE_LINE_SIZE - 1)
+	 & ~((size_t) PTW32_CACHE_LINE_SIZE - 1));
+
+      if (table == NULL)
+	{
+	  if ((table = (ptw32_tsd_table_t *) calloc (1, sizeof (*table))) == NULL)
+	    {
+	      free (block);
+	      return ENOMEM;
+	    }
+
+	  if (!TlsSetValue (ptw32_tsdTableIndex, table))
+	    {
+	      free (table);
+	      free (block);
+	      return ENOMEM;
+	    }
+	}
+      else
+	{
+	  memcpy (entries, table->entries, table->nEntries * sizeof (ptw32_tsd_entry_t));
+	  free (table->block);
+	}
+
+      table->block = block;
+      table->entries = entries;
+      table->nEntries = n;
+    }
+
+  entry = &table->entries[key->slot];
+
+  if (key->task)
+    {
+      /* List it for ptw32_tsd_task_end, unless listed already */
+      if (key->destructor != NULL && value != NULL
+	  && !(entry->generation == key->generation
+	       && entry->task == table->task && entry->value != NULL))
+	{
+	  if (table->nTaskSlots < PTW32_TSD_TASK_SLOTS)
+	    {
+	      table->taskSlots[table->nTaskSlots++] = key->slot;
+	    }
+	  else
+	    {
+	      table->nTaskSlots = PTW32_TSD_TASK_SLOTS + 1;
+	    }
+	}
+      entry->task = table->task;
+    }
+
+  entry->value = (void *) value;
+  entry->generation = key->generation;
+
+  return 0;
+}
+
+
+void
+ptw32_tsd_task_end (void)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Ends the calling pool worker's task as far as task
+      *      keys are concerned: runs the destructors of the task
+      *      key values it set, all under one hold of the slot lock
+      *      per PTW32_TSD_TASK_SLOTS values, then bumps the table's
+      *      task number, which makes every task key NULL. Values
+      *      set by the destructors are destroyed too, for up to
+      *      PTHREAD_DESTRUCTOR_ITERATIONS rounds.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_tsd_table_t * table;
+  int iterations;
+
+  if (ptw32_tsdTableIndex == TLS_OUT_OF_INDEXES
+      || (table = ptw32_tsd_table_self ()) == NULL)
+    {
+      return;
+    }
+
+  for (iterations = 0;
+       table->nTaskSlots > 0 && iterations < PTHREAD_DESTRUCTOR_ITERATIONS;
+       iterations++)
+    {
+      unsigned int slots[PTW32_TSD_TASK_SLOTS];
+      unsigned int nSlots = table->nTaskSlots;
+      unsigned int i = 0;
+      int scan = (nSlots > PTW32_TSD_TASK_SLOTS);
+
+      /* Destructors list what they set afresh */
+      if (scan)
+	{
+	  nSlots = table->nEntries;
+	}
+      else
+	{
+	  memcpy (slots, table->taskSlots, nSlots * sizeof (unsigned int));
+	}
+      table->nTaskSlots = 0;
+
+      while (i < nSlots)
+	{
+	  void (PTW32_CDECL *destructors[PTW32_TSD_TASK_SLOTS]) (void *);
+	  void * values[PTW32_TSD_TASK_SLOTS];
+	  int n = 0;
+	  int j;
+	  ptw32_mcs_local_node_t node;
+
+	  /* The slot lock keeps the keys from being freed, see ptw32_callUserDestroyRoutines */
+	  ptw32_mcs_lock_acquire (&ptw32_tsd_slot_lock, &node);
+
+	  for (; i < nSlots && n < PTW32_TSD_TASK_SLOTS; i++)
+	    {
+	      unsigned int slot = scan ? i : slots[i];
+	      pthread_key_t k;
+	      ptw32_tsd_entry_t * entry;
+
+	      if (slot < ptw32_tsdNextSlot && slot < table->nEntries
+		  && (k = ptw32_tsdKeys[slot]) != NULL
+		  && k->task && k->destructor != NULL
+		  && (entry = &table->entries[slot])->generation == k->generation
+		  && entry->task == table->task && entry->value != NULL)
+		{
+		  destructors[n] = k->destructor;
+		  values[n++] = entry->value;
+		  entry->value = NULL;
+		}
+	    }
+
+	  ptw32_mcs_lock_release (&node);
+
+	  for (j = 0; j < n; j++)
+	    {
+	      destructors[j] (values[j]);
+	    }
+	}
+    }
+
+  table->nTaskSlots = 0;
+  table->task++;
+}
+
+
+void
+ptw32_tsd_table_release (void)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Frees the calling thread's TSD table, if it has one.
+      *      Called as the thread exits, after key destructors
+      *      have run.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_tsd_table_t * table;
+
+  if (ptw32_tsdTableIndex == TLS_OUT_OF_INDEXES
+      || (table = ptw32_tsd_table_self ()) == NULL)
+    {
+      return;
+    }
+
+  (void) TlsSetValue (ptw32_tsdTableIndex, NULL);
+  free (table->block);
+  free (table);
+}
@@ -0,0 +1,292 @@
+/*
+ * ptw32_wait_timer.c
+ *
+ * Description:
+ * This translation unit implements routines which are private to
+ * the implementation and may be used throughout it.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+
+#include <string.h>
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * ptw32_wait_timer -- arm the calling thread's high resolution timer.
+ *
+ * The timer is created on the thread's first timed wait and is
+ * closed with the thread (see ptw32_threadDestroy). It is a
+ * synchronization timer, so a wait that sees it signalled resets it.
+ *
+ * Returns the timer, set to become signalled 'timeout' 100 nanosecond
+ * units from now, or NULL if there is none to be had or they have
+ * been turned off (PTHREAD_PARAM_HIRES_WAIT_NP).
+ */
+static HANDLE
+ptw32_wait_timer (int64_t timeout)
+{
+#if !defined(NEED_FTIME)
+  ptw32_thread_t * sp;
+  LARGE_INTEGER dueTime;
+
+  if (NULL == ptw32_createwaitabletimerex
+      || 0 == ptw32_hiresWait
+      || NULL == (sp = (ptw32_thread_t *) pthread_self ().p))
+    {
+      return NULL;
+    }
+
+  if (NULL == sp->waitTimer)
+    {
+      sp->waitTimer = ptw32_libstat_handle (ptw32_createwaitabletimerex (NULL, NULL,
+                                                                         CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                                                         TIMER_ALL_ACCESS),
+                                            PTW32_LIBSTAT_TIMERS);
+      if (NULL == sp->waitTimer)
+        {
+          return NULL;
+        }
+    }
+
+  /* A negative due time is relative to now */
+  dueTime.QuadPart = -timeout;
+
+  if (SetWaitableTimer (sp->waitTimer, &dueTime, 0, NULL, NULL, PTW32_FALSE))
+    {
+      return sp->waitTimer;
+    }
+#endif
+
+  return NULL;
+}
+
+
+DWORD
+ptw32_wait_timeout (clockid_t clock, const struct timespec * abstime,
+                    HANDLE * timer)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Prepares a wait for a handle that is to end at
+      *      abstime (NULL: never), measured against 'clock'.
+      *
+      *      If the system provides high resolution waitable
+      *      timers and abstime hasn't passed, sets *timer to the
+      *      calling thread's timer, armed to become signalled at
+      *      abstime. The caller waits for it as well as for its
+      *      handle; the timer being signalled means the wait has
+      *      timed out. Otherwise sets *timer to NULL.
+      *
+      * RESULTS
+      *              The timeout in milliseconds to give the wait:
+      *              INFINITE if abstime is NULL or *timer is set,
+      *              otherwise as ptw32_relmillisecs().
+      *
+      * ------------------------------------------------------
+      */
+{
+  int64_t timeout;
+
+  *timer = NULL;
+
+  if (abstime == NULL)
+    {
+      return INFINITE;
+    }
+
+  if ((timeout = ptw32_rel100nanosecs (clock, abstime)) > 0
+      && (*timer = ptw32_wait_timer (timeout)) != NULL)
+    {
+      return INFINITE;
+    }
+
+  return ptw32_relmillisecs (clock, abstime);
+}
+
+
+BOOL
+ptw32_waitonaddress_abstime (volatile VOID * address, PVOID compare,
+                             SIZE_T size, clockid_t clock,
+                             const struct timespec * abstime)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      WaitOnAddress until abstime (NULL: forever),
+      *      measured against 'clock'.
+      *
+      *      With less than PTW32_HIRES_WAIT_LIMIT to go, which
+      *      WaitOnAddress would round up to a clock tick, sleeps
+      *      on the calling thread's high resolution timer instead
+      *      and returns as if woken spuriously. A change to
+      *      *address in that time is seen when the caller looks
+      *      again, no later than abstime. With more to go and a
+      *      timer slack set, leaves the timeout to the timer wheel
+      *      (see ptw32_timer_wheel.c).
+      *
+      * RESULTS
+      *              As WaitOnAddress: TRUE if woken (possibly
+      *              spuriously), FALSE with the last error set to
+      *              ERROR_TIMEOUT if abstime passed.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int64_t timeout;
+  int64_t start;
+  HANDLE timer;
+  BOOL woken;
+
+  if (abstime != NULL)
+    {
+      timeout = ptw32_rel100nanosecs (clock, abstime);
+
+      if (timeout > 0 && timeout < PTW32_HIRES_WAIT_LIMIT
+          && memcmp ((const void *) address, compare, size) == 0
+          && (timer = ptw32_wait_timer (timeout)) != NULL
+          && ptw32_wait_objects (1, &timer, INFINITE) == WAIT_OBJECT_0)
+        {
+          return PTW32_TRUE;
+        }
+
+      if (timeout >= PTW32_HIRES_WAIT_LIMIT && 0 != ptw32_timerSlack)
+        {
+          return ptw32_timer_wheel_wait (address, compare, size, timeout);
+        }
+    }
+
+  start = ptw32_wait_begin ();
+  woken = ptw32_waitonaddress (address, compare, size,
+                               (abstime == NULL) ? INFINITE : ptw32_relmillisecs (clock, abstime));
+  ptw32_wait_end (start);
+
+  return woken;
+}
+
+
+int64_t
+ptw32_wait_begin (void)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Returns the start time of a wait that may block,
+      *      to be given to ptw32_wait_end(), and marks the
+      *      calling thread blocked for spinlock waiters and, if
+      *      it is a pool worker, for its pool, lending out its
+      *      processor token while it waits.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LARGE_INTEGER count;
+  ptw32_thread_t * sp = PTW32_SELF_THREAD ();
+
+  if (sp != NULL)
+    {
+      pthread_pool_np_t pool = sp->pool;
+
+      if (pool != NULL && !sp->poolBlocked)
+        {
+          /* Starting a spare worker may wait too: don't count that */
+          sp->pool = NULL;
+          ptw32_pool_block (pool);
+          sp->pool = pool;
+          sp->poolBlocked = PTW32_TRUE;
+          ptw32_cputoken_drop (sp, PTW32_CPUTOKEN_LENT);
+        }
+
+      sp->blocked = PTW32_TRUE;
+    }
+
+  (void) QueryPerformanceCounter (&count);
+
+  return (int64_t) count.QuadPart;
+}
+
+
+void
+ptw32_wait_end (int64_t start)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Marks the calling thread running again, with its
+      *      processor token back if it lent it, and counts a
+      *      wait begun at 'start' in its statistics (see
+      *      pthread_getstats_np), if it is a POSIX thread. Only
+      *      the thread itself writes them. The wait's time is
+      *      also added to the process wide time, and to the
+      *      thread's histogram, of the kind of wait
+      *      ptw32_libstat_wait() last recorded for the thread.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp = PTW32_SELF_THREAD ();
+
+  if (sp != NULL)
+    {
+      LARGE_INTEGER count;
+      int64_t ticks;
+      int stat = sp->waitStat;
+      int hist = sp->waitHist;
+
+      sp->blocked = PTW32_FALSE;
+
+      if (sp->poolBlocked)
+        {
+          sp->poolBlocked = PTW32_FALSE;
+          ptw32_pool_unblock (sp->pool);
+
+          if (sp->cpuToken == PTW32_CPUTOKEN_LENT)
+            {
+              ptw32_cputoken_hold (sp);
+            }
+        }
+
+      (void) QueryPerformanceCounter (&count);
+      ticks = (int64_t) count.QuadPart - start;
+
+      sp->waits++;
+      sp->waitTime += ticks;
+
+      if (stat < PTW32_LIBSTAT_WAIT_MUTEX || stat > PTW32_LIBSTAT_WAIT_OTHER)
+        {
+          stat = PTW32_LIBSTAT_WAIT_OTHER;
+          hist = PTHREAD_HIST_OTHER_NP;
+        }
+      sp->waitStat = PTW32_LIBSTAT_WAIT_OTHER;
+      sp->waitHist = PTHREAD_HIST_OTHER_NP;
+
+      ptw32_hist_add (sp, hist, ticks);
+
+      PTW32_LIBSTAT_ADD (PTW32_LIBSTAT_TIME_MUTEX + stat - PTW32_LIBSTAT_WAIT_MUTEX, ticks);
+      PTW32_LIBSTAT_ADD (PTW32_LIBSTAT_TIMED_MUTEX + stat - PTW32_LIBSTAT_WAIT_MUTEX, 1);
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * ptw32_waitany.c
+ *
+ * Description:
+ * This translation unit implements multiple object wait primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+void
+ptw32_waitany_notify (void)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Sets the event of every thread blocked in
+      *      pthread_waitany_np(), so that each looks at its
+      *      objects again. Called after a post to a process
+      *      private semaphore while there are waiters, through
+      *      PTW32_WAITANY_NOTIFY().
+      *
+      *      A waiter lists itself before it first polls its
+      *      objects and its event is auto-reset, so a post made
+      *      any time after that is seen.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  ptw32_waitany_waiter_t * w;
+
+  ptw32_mcs_lock_acquire (&ptw32_waitany_lock, &node);
+
+  for (w = ptw32_waitanyWaiters; w != NULL; w = w->next)
+    {
+      (void) PTW32_SETEVENT (w->event);
+    }
+
+  ptw32_mcs_lock_release (&node);
+}
@@ -0,0 +1,110 @@
+/*
+ * ptw32_waitgraph.c
+ *
+ * Description:
+ * This translation unit implements the mutex wait-for graph.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * A thread about to block on a mutex sets 'mutex' in its record and
+ * clears it once woken; pthread_dump_waitgraph_np reads the records
+ * without a lock and pairs each waiter with the mutex's owner. An
+ * uncontended lock doesn't come here, so it costs nothing.
+ */
+
+
+ptw32_waitgraph_record_t *
+ptw32_waitgraph_block (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Records that the calling thread is about to block on
+      *      'mx', making its record and adding it to
+      *      ptw32_waitgraphRecords the first time.
+      *
+      * RESULTS
+      *              the record, or NULL if the caller is not a
+      *              POSIX thread or there is no memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp = PTW32_SELF_THREAD ();
+  ptw32_waitgraph_record_t * rec;
+
+  if (sp == NULL)
+    {
+      return NULL;
+    }
+
+  if ((rec = sp->waitgraph) == NULL)
+    {
+      ptw32_waitgraph_record_t * head;
+
+      if ((rec = (ptw32_waitgraph_record_t *) ptw32_object_alloc (sizeof (*rec), 0)) == NULL)
+	{
+	  return NULL;
+	}
+
+      do
+	{
+	  head = ptw32_waitgraphRecords;
+	  rec->next = head;
+	}
+      while (PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &ptw32_waitgraphRecords,
+						     (PTW32_INTERLOCKED_PVOID) rec,
+						     (PTW32_INTERLOCKED_PVOID) head)
+	     != (PTW32_INTERLOCKED_PVOID) head);
+
+      sp->waitgraph = rec;
+    }
+
+  rec->thread = sp->ptHandle;
+  (void) PTW32_INTERLOCKED_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &rec->mutex,
+					 (PTW32_INTERLOCKED_PVOID) mx);
+
+  return rec;
+}
+
+
+void
+ptw32_waitgraph_unblock (ptw32_waitgraph_record_t * rec)
+{
+  if (rec != NULL)
+    {
+      rec->mutex = NULL;
+    }
+}
@@ -0,0 +1,281 @@
+/*
+ * ptw32_wsdeque.c
+ *
+ * Description:
+ * This translation unit implements work-stealing deque primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/*
+ * Work-stealing deques: the Chase-Lev deque, with the fences of Le,
+ * Pop, Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing
+ * for Weak Memory Models" (PPoPP 2013).
+ *
+ * Only the owner touches 'bottom' for writing. A push stores the item
+ * and then publishes it with a release store of bottom. A steal reads
+ * top and then bottom with acquire loads, reads the item at top and
+ * claims it with an interlocked compare-exchange of top. A pop first
+ * takes its item by lowering bottom, with a full barrier so that its
+ * following read of top can't be satisfied before thieves see the
+ * lower bottom; only when that leaves a single item does it race the
+ * thieves for it with the same compare-exchange of top.
+ *
+ * top and bottom only grow (a pop that loses its race puts bottom
+ * back), so the deque's length is their difference, taken modulo
+ * 2^32 so that wrapping after 2^31 pushes is harmless.
+ *
+ * A full array is replaced by one twice the size. The old one is kept
+ * on the new one's 'prev' list until the deque is freed: a thief that
+ * read the old array pointer may still be reading its items, and the
+ * arrays only add up to twice the largest.
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+#define PTW32_WSDEQUE_LENGTH(b, t) ((LONG) ((ULONG) (b) - (ULONG) (t)))
+
+static ptw32_wsdeque_array_t *
+ptw32_wsdeque_array_alloc (LONG size)
+{
+  ptw32_wsdeque_array_t * a;
+
+  a = (ptw32_wsdeque_array_t *) ptw32_object_alloc (
+                                  sizeof (*a) + (size - 1) * sizeof (a->items[0]), 0);
+
+  if (a != NULL)
+    {
+      a->mask = size - 1;
+    }
+
+  return a;
+}
+
+int
+ptw32_wsdeque_init (pthread_wsdeque_np_t dq)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Sets up an empty deque in zeroed memory.
+      *
+      * RESULTS
+      *              0               the deque is ready,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  dq->top = 0;
+  dq->bottom = 0;
+  dq->array = ptw32_wsdeque_array_alloc (PTW32_WSDEQUE_INITIAL_SIZE);
+
+  return (dq->array == NULL) ? ENOMEM : 0;
+}
+
+void
+ptw32_wsdeque_free (pthread_wsdeque_np_t dq)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Frees the deque's arrays, current and replaced. Items
+      *      still in the deque are dropped.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_wsdeque_array_t * a = dq->array;
+
+  while (a != NULL)
+    {
+      ptw32_wsdeque_array_t * prev = a->prev;
+
+      ptw32_object_free (a);
+      a = prev;
+    }
+
+  dq->array = NULL;
+}
+
+int
+ptw32_wsdeque_push (pthread_wsdeque_np_t dq, void * item)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Pushes item on the bottom of the deque, growing the
+      *      deque if it is full. Called only by the owner.
+      *
+      * RESULTS
+      *              0               the item was pushed,
+      *              ENOMEM          the deque couldn't grow.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG b = PTW32_ATOMIC_LOAD_RELAXED_LONG(&dq->bottom);
+  LONG t = PTW32_ATOMIC_LOAD_ACQ_LONG(&dq->top);
+  ptw32_wsdeque_array_t * a = dq->array;
+
+  if (PTW32_WSDEQUE_LENGTH(b, t) > a->mask)
+    {
+      ptw32_wsdeque_array_t * bigger;
+      ULONG i;
+
+      if (a->mask >= LONG_MAX / 2
+          || NULL == (bigger = ptw32_wsdeque_array_alloc (2 * (a->mask + 1))))
+        {
+          return ENOMEM;
+        }
+
+      for (i = (ULONG) t; i != (ULONG) b; i++)
+        {
+          bigger->items[i & (ULONG) bigger->mask] = a->items[i & (ULONG) a->mask];
+        }
+
+      bigger->prev = a;
+
+      /* Full barrier: thieves that see the new array see its items */
+      (void) PTW32_INTERLOCKED_EXCHANGE_PTR((PTW32_INTERLOCKED_PVOID_PTR) &dq->array,
+                                            (PTW32_INTERLOCKED_PVOID) bigger);
+      a = bigger;
+    }
+
+  a->items[b & a->mask] = item;
+  PTW32_ATOMIC_STORE_REL_LONG(&dq->bottom, b + 1);
+
+  return 0;
+}
+
+int
+ptw32_wsdeque_pop (pthread_wsdeque_np_t dq, void ** item)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Pops the newest item from the bottom of the deque.
+      *      Called only by the owner.
+      *
+      * RESULTS
+      *              0               an item was popped,
+      *              EAGAIN          the deque is empty, or thieves
+      *                              took the last item.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG b = PTW32_ATOMIC_LOAD_RELAXED_LONG(&dq->bottom) - 1;
+  ptw32_wsdeque_array_t * a = dq->array;
+  LONG t;
+  LONG length;
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) &dq->bottom,
+                                        (PTW32_INTERLOCKED_LONG) b);
+  t = PTW32_ATOMIC_LOAD_RELAXED_LONG(&dq->top);
+  length = PTW32_WSDEQUE_LENGTH(b, t);
+
+  if (length < 0)
+    {
+      PTW32_ATOMIC_STORE_RELAXED_LONG(&dq->bottom, b + 1);
+      return EAGAIN;
+    }
+
+  *item = a->items[b & a->mask];
+
+  if (length == 0)
+    {
+      /* The last item: thieves may be after it too */
+      int won = (t == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                                (PTW32_INTERLOCKED_LONGPTR) &dq->top,
+                                (PTW32_INTERLOCKED_LONG) (t + 1),
+                                (PTW32_INTERLOCKED_LONG) t));
+
+      PTW32_ATOMIC_STORE_RELAXED_LONG(&dq->bottom, b + 1);
+
+      if (!won)
+        {
+          return EAGAIN;
+        }
+    }
+
+  return 0;
+}
+
+int
+ptw32_wsdeque_steal (pthread_wsdeque_np_t dq, void ** item)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Steals the oldest item from the top of the deque.
+      *      Called by any thread.
+      *
+      * RESULTS
+      *              0               an item was stolen,
+      *              EAGAIN          the deque is empty,
+      *              EBUSY           another thread took the item
+      *                              first; the deque may not be
+      *                              empty.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG t = PTW32_ATOMIC_LOAD_ACQ_LONG(&dq->top);
+  LONG b = PTW32_ATOMIC_LOAD_ACQ_LONG(&dq->bottom);
+  ptw32_wsdeque_array_t * a;
+  void * x;
+
+  if (PTW32_WSDEQUE_LENGTH(b, t) <= 0)
+    {
+      return EAGAIN;
+    }
+
+  a = dq->array;
+  x = a->items[t & a->mask];
+
+  if (t != (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                    (PTW32_INTERLOCKED_LONGPTR) &dq->top,
+                    (PTW32_INTERLOCKED_LONG) (t + 1),
+                    (PTW32_INTERLOCKED_LONG) t))
+    {
+      return EBUSY;
+    }
+
+  *item = x;
+
+  return 0;
+}
+
+int
+ptw32_wsdeque_empty (pthread_wsdeque_np_t dq)
+{
+  LONG t = PTW32_ATOMIC_LOAD_ACQ_LONG(&dq->top);
+  LONG b = PTW32_ATOMIC_LOAD_ACQ_LONG(&dq->bottom);
+
+  return PTW32_WSDEQUE_LENGTH(b, t) <= 0;
+}
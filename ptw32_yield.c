@@ -0,0 +1,88 @@
+/*
+ * ptw32_yield.c
+ *
+ * Description:
+ * This translation unit implements the library's yielding backoff.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+
+void
+ptw32_yield (int * yields)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      Gives up the processor once in a wait loop, backing
+      *      off with the number of times the loop has yielded,
+      *      which the caller keeps in '*yields' (initially 0).
+      *
+      *      SwitchToThread() runs any thread that is ready on
+      *      this processor, including one of lower priority
+      *      that the loop may be waiting for; Sleep(0) would
+      *      only run threads of at least the caller's priority.
+      *      Only when nothing ran do the early yields fall back
+      *      to Sleep(0), to find a thread ready elsewhere. Once
+      *      the wait has gone on, each yield sleeps for a tick,
+      *      which lets every thread run and stops the loop
+      *      taking the processor in turn with another yielder.
+      *
+      *      A fiber lets the other queued fibers run instead.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (ptw32_fiber_yield ())
+    {
+      return;
+    }
+
+  if (*yields < PTW32_YIELD_SWITCHES)
+    {
+      ++*yields;
+
+      if (!SwitchToThread ())
+	{
+	  Sleep (0);
+	}
+    }
+  else if (*yields < PTW32_YIELD_SLEEPS)
+    {
+      ++*yields;
+      Sleep (0);
+    }
+  else
+    {
+      Sleep (1);
+    }
+}
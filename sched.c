@@ -51,3 +51,5 @@
 #include "sched_setscheduler.c"
 #include "sched_getscheduler.c"
 #include "sched_yield.c"
+#include "sched_setaffinity.c"
+#include "sched_getcpu.c"
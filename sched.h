@@ -189,9 +189,17 @@ struct sched_param {
  * due to the need for compatibility with GNU systems
  * and sched_setaffinity() et.al. which include the
  * cpusetsize parameter "normally set to sizeof(cpu_set_t)".
+ *
+ * A cpu_set_t covers PTW32_CPU_SET_GROUPS processor groups of up to
+ * sizeof(size_t)*8 processors each (the size of a Win32 affinity
+ * mask). CPU n is processor n % (sizeof(size_t)*8) of group
+ * n / (sizeof(size_t)*8), so the numbers aren't contiguous on a
+ * system whose groups aren't full.
  */
 
-#define CPU_SETSIZE (sizeof(size_t)*8)
+#define PTW32_CPU_SET_GROUPS 16
+
+#define CPU_SETSIZE (sizeof(size_t)*8*PTW32_CPU_SET_GROUPS)
 
 #define CPU_COUNT(setptr) (_sched_affinitycpucount(setptr))
 
@@ -238,6 +246,8 @@ PTW32_DLLPORT int PTW32_CDECL sched_setaffinity (pid_t pid, size_t cpusetsize, c
 
 PTW32_DLLPORT int PTW32_CDECL sched_getaffinity (pid_t pid, size_t cpusetsize, cpu_set_t *mask);
 
+PTW32_DLLPORT int PTW32_CDECL sched_getcpu (void);
+
 /*
  * Support routines and macros for cpu_set_t
  */
@@ -128,7 +128,15 @@ sched_get_priority_max (int policy)
   /* WinCE? */
   return PTW32_MAX (THREAD_PRIORITY_IDLE, THREAD_PRIORITY_TIME_CRITICAL);
 #else
-  /* This is independent of scheduling policy in Win32. */
+  /*
+   * SCHED_FIFO and SCHED_RR threads run at the REALTIME_PRIORITY_CLASS
+   * levels 16 to 31 of the table above (see ptw32_setthreadpriority).
+   */
+  if (SCHED_OTHER != policy)
+    {
+      return PTW32_SCHED_RT_PRIORITY_MAX;
+    }
+
   return PTW32_MAX (THREAD_PRIORITY_IDLE, THREAD_PRIORITY_TIME_CRITICAL);
 #endif
 }
@@ -129,7 +129,12 @@ sched_get_priority_min (int policy)
   /* WinCE? */
   return PTW32_MIN (THREAD_PRIORITY_IDLE, THREAD_PRIORITY_TIME_CRITICAL);
 #else
-  /* This is independent of scheduling policy in Win32. */
+  /* The real-time policies have their own range, see sched_get_priority_max.c */
+  if (SCHED_OTHER != policy)
+    {
+      return PTW32_SCHED_RT_PRIORITY_MIN;
+    }
+
   return PTW32_MIN (THREAD_PRIORITY_IDLE, THREAD_PRIORITY_TIME_CRITICAL);
 #endif
 }
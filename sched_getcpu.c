@@ -0,0 +1,80 @@
+/*
+ * sched_getcpu.c
+ *
+ * Description:
+ * POSIX scheduling functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+#include "sched.h"
+
+int
+sched_getcpu (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the CPU the calling thread is running on.
+      *
+      * DESCRIPTION
+      *      The CPU is numbered as in cpu_set_t: the processor's
+      *      number within its group, plus the group number times
+      *      the bits in a size_t. The thread may be moved to
+      *      another CPU at any time, so the result is a hint.
+      *
+      *      GetCurrentProcessorNumberEx reads the number in user
+      *      mode (with RDPID or RDTSCP where the processor has
+      *      them), so this doesn't enter the kernel.
+      *      NOTE: This is a Linux extension, defined as returning
+      *                -1 if an error occurs and setting errno to the
+      *                actual error.
+      *
+      * RESULTS
+      *              >= 0            the CPU number,
+      *              -1              errno is ENOSYS: the system
+      *                              can't tell (before Windows 7).
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_processor_number_t pn;
+
+  if (ptw32_getcurrentprocessornumberex == NULL)
+    {
+      PTW32_SET_ERRNO(ENOSYS);
+      return -1;
+    }
+
+  ptw32_getcurrentprocessornumberex (&pn);
+
+  return (int) pn.Group * (int) PTW32_CPU_GROUP_SIZE + (int) pn.Number;
+}
@@ -42,30 +42,31 @@ int
 sched_getscheduler (pid_t pid)
 {
   /*
-   * Win32 only has one policy which we call SCHED_OTHER.
-   * However, we try to provide other valid side-effects
-   * such as EPERM and ESRCH errors.
+   * REALTIME_PRIORITY_CLASS processes are SCHED_FIFO or SCHED_RR,
+   * see sched_setscheduler.c, and all others SCHED_OTHER.
    */
-  if (0 != pid)
+  int result;
+
+  if (0 != pid && pid != (int) GetCurrentProcessId ())
     {
-      int selfPid = (int) GetCurrentProcessId ();
+      HANDLE h =
+	OpenProcess (PROCESS_QUERY_INFORMATION, PTW32_FALSE, (DWORD) pid);
 
-      if (pid != selfPid)
+      if (NULL == h)
 	{
-	  HANDLE h =
-	    OpenProcess (PROCESS_QUERY_INFORMATION, PTW32_FALSE, (DWORD) pid);
-
-	  if (NULL == h)
-	    {
-	      errno =
-		(GetLastError () ==
-		 (0xFF & ERROR_ACCESS_DENIED)) ? EPERM : ESRCH;
-	      return -1;
-	    }
-	  else
-	    CloseHandle(h);
+	  errno =
+	    (GetLastError () ==
+	     (0xFF & ERROR_ACCESS_DENIED)) ? EPERM : ESRCH;
+	  return -1;
 	}
+
+      result = (REALTIME_PRIORITY_CLASS == GetPriorityClass (h)
+		? SCHED_RR : SCHED_OTHER);
+      CloseHandle (h);
+
+      return result;
     }
 
-  return SCHED_OTHER;
+  return (REALTIME_PRIORITY_CLASS == GetPriorityClass (GetCurrentProcess ())
+	  ? ptw32_schedPolicy : SCHED_OTHER);
 }
@@ -0,0 +1,393 @@
+/*
+ * sched_setaffinity.c
+ *
+ * Description:
+ * POSIX scheduling functions that deal with CPU affinity.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+#include "sched.h"
+
+int
+sched_setaffinity (pid_t pid, size_t cpusetsize, cpu_set_t *set)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets the CPU affinity mask of the process pid to the
+      *      CPUs in set. If pid is zero the calling process is
+      *      used.
+      *
+      * PARAMETERS
+      *      pid
+      *              The target process
+      *
+      *      cpusetsize
+      *              The size of set, usually sizeof(cpu_set_t).
+      *              CPUs beyond it are taken to be clear.
+      *
+      *      set
+      *              The CPUs the process may run on
+      *
+      * DESCRIPTION
+      *      Win32 keeps a process affinity mask for the primary
+      *      processor group only, so only CPUs 0 to
+      *      sizeof(size_t)*8-1 are used from set. On a system
+      *      with more than one group this fails once the process
+      *      has threads in other groups.
+      *
+      * RESULTS
+      *              0               successfully set the affinity
+      *              -1              failed, with errno set to:
+      *                              EFAULT  set is NULL
+      *                              EINVAL  set names no available CPU
+      *                              EPERM   no permission to set the
+      *                                      affinity of pid
+      *                              ESRCH   no process pid
+      *                              EAGAIN  the affinity could not be set
+      *                              ENOSYS  no affinity support
+      *
+      * ------------------------------------------------------
+      */
+{
+#if ! defined(NEED_PROCESS_AFFINITY_MASK)
+
+  DWORD_PTR vProcessMask;
+  DWORD_PTR vSystemMask;
+  HANDLE h;
+  int targetPid = (int)(size_t) pid;
+  int result = 0;
+
+  if (NULL == set)
+    {
+      result = EFAULT;
+    }
+  else
+    {
+      cpu_set_t mask;
+
+      ptw32_cpusetcopy (&mask, sizeof (mask), set, cpusetsize);
+
+      if (0 == targetPid)
+	{
+	  targetPid = (int) GetCurrentProcessId ();
+	}
+
+      h = OpenProcess (PROCESS_QUERY_INFORMATION | PROCESS_SET_INFORMATION,
+		       PTW32_FALSE, (DWORD) targetPid);
+
+      if (NULL == h)
+	{
+	  result = (((0xFF & ERROR_ACCESS_DENIED) == GetLastError ()) ? EPERM : ESRCH);
+	}
+      else
+	{
+	  if (GetProcessAffinityMask (h, &vProcessMask, &vSystemMask))
+	    {
+	      /*
+	       * Result is the intersection of available CPUs and the mask.
+	       */
+	      DWORD_PTR newMask = vSystemMask & ((_sched_cpu_set_vector_*)&mask)->_cpuset[0];
+
+	      if (newMask)
+		{
+		  if (SetProcessAffinityMask (h, newMask) == 0)
+		    {
+		      switch (GetLastError ())
+			{
+			case (0xFF & ERROR_ACCESS_DENIED):
+			  result = EPERM;
+			  break;
+			case (0xFF & ERROR_INVALID_PARAMETER):
+			  result = EINVAL;
+			  break;
+			default:
+			  result = EAGAIN;
+			  break;
+			}
+		    }
+		}
+	      else
+		{
+		  /*
+		   * Mask does not contain any CPUs currently available on the system.
+		   */
+		  result = EINVAL;
+		}
+	    }
+	  else
+	    {
+	      switch (GetLastError ())
+		{
+		case (0xFF & ERROR_ACCESS_DENIED):
+		  result = EPERM;
+		  break;
+		case (0xFF & ERROR_INVALID_PARAMETER):
+		  result = EINVAL;
+		  break;
+		default:
+		  result = EAGAIN;
+		  break;
+		}
+	    }
+
+	  CloseHandle (h);
+	}
+    }
+
+  if (result != 0)
+    {
+      PTW32_SET_ERRNO(result);
+      return -1;
+    }
+
+  return 0;
+
+#else
+
+  PTW32_SET_ERRNO(ENOSYS);
+  return -1;
+
+#endif
+}
+
+
+int
+sched_getaffinity (pid_t pid, size_t cpusetsize, cpu_set_t *set)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the CPU affinity mask of the process pid in
+      *      set. If pid is zero the calling process is used.
+      *
+      * PARAMETERS
+      *      pid
+      *              The target process
+      *
+      *      cpusetsize
+      *              The size of set, usually sizeof(cpu_set_t).
+      *              CPUs beyond it are not returned.
+      *
+      *      set
+      *              Where to return the CPUs the process may run on
+      *
+      * DESCRIPTION
+      *      For the calling process set covers every processor
+      *      group; for another process only the primary group.
+      *
+      * RESULTS
+      *              0               successfully returned the affinity
+      *              -1              failed, with errno set to:
+      *                              EFAULT  set is NULL
+      *                              EPERM   no permission to read the
+      *                                      affinity of pid
+      *                              ESRCH   no process pid
+      *                              EAGAIN  the affinity could not be read
+      *                              ENOSYS  no affinity support
+      *
+      * ------------------------------------------------------
+      */
+{
+#if ! defined(NEED_PROCESS_AFFINITY_MASK)
+
+  DWORD_PTR vProcessMask;
+  DWORD_PTR vSystemMask;
+  HANDLE h;
+  int targetPid = (int)(size_t) pid;
+  int result = 0;
+  cpu_set_t mask;
+
+  if (NULL == set)
+    {
+      result = EFAULT;
+    }
+  else if (0 == targetPid || (int) GetCurrentProcessId () == targetPid)
+    {
+      result = ptw32_getprocessaffinity (&mask);
+    }
+  else
+    {
+      h = OpenProcess (PROCESS_QUERY_INFORMATION, PTW32_FALSE, (DWORD) targetPid);
+
+      if (NULL == h)
+	{
+	  result = (((0xFF & ERROR_ACCESS_DENIED) == GetLastError ()) ? EPERM : ESRCH);
+	}
+      else
+	{
+	  if (GetProcessAffinityMask (h, &vProcessMask, &vSystemMask))
+	    {
+	      CPU_ZERO (&mask);
+	      ((_sched_cpu_set_vector_*)&mask)->_cpuset[0] = (size_t) vProcessMask;
+	    }
+	  else
+	    {
+	      result = EAGAIN;
+	    }
+
+	  CloseHandle (h);
+	}
+    }
+
+  if (result != 0)
+    {
+      PTW32_SET_ERRNO(result);
+      return -1;
+    }
+
+  ptw32_cpusetcopy (set, cpusetsize, &mask, sizeof (mask));
+
+  return 0;
+
+#else
+
+  PTW32_SET_ERRNO(ENOSYS);
+  return -1;
+
+#endif
+}
+
+
+/*
+ * Support routines for cpu_set_t
+ */
+int
+_sched_affinitycpucount (const cpu_set_t *set)
+{
+  int group;
+  int count = 0;
+
+  for (group = 0; group < PTW32_CPU_SET_GROUPS; group++)
+    {
+      size_t tset;
+
+      for (tset = ((_sched_cpu_set_vector_*)set)->_cpuset[group]; tset; tset >>= 1)
+	{
+	  if (tset & (size_t)1)
+	    {
+	      count++;
+	    }
+	}
+    }
+
+  return count;
+}
+
+void
+_sched_affinitycpuzero (cpu_set_t *pset)
+{
+  memset (pset, 0, sizeof (cpu_set_t));
+}
+
+void
+_sched_affinitycpuset (int cpu, cpu_set_t *pset)
+{
+  if (cpu >= 0 && (size_t) cpu < CPU_SETSIZE)
+    {
+      ((_sched_cpu_set_vector_*)pset)->_cpuset[cpu / PTW32_CPU_GROUP_SIZE]
+	|= ((size_t)1 << (cpu % PTW32_CPU_GROUP_SIZE));
+    }
+}
+
+void
+_sched_affinitycpuclr (int cpu, cpu_set_t *pset)
+{
+  if (cpu >= 0 && (size_t) cpu < CPU_SETSIZE)
+    {
+      ((_sched_cpu_set_vector_*)pset)->_cpuset[cpu / PTW32_CPU_GROUP_SIZE]
+	&= ~((size_t)1 << (cpu % PTW32_CPU_GROUP_SIZE));
+    }
+}
+
+int
+_sched_affinitycpuisset (int cpu, const cpu_set_t *pset)
+{
+  return (cpu >= 0 && (size_t) cpu < CPU_SETSIZE
+	  && (((_sched_cpu_set_vector_*)pset)->_cpuset[cpu / PTW32_CPU_GROUP_SIZE]
+	      & ((size_t)1 << (cpu % PTW32_CPU_GROUP_SIZE))) != 0);
+}
+
+void
+_sched_affinitycpuand (cpu_set_t *pdestset, const cpu_set_t *psrcset1, const cpu_set_t *psrcset2)
+{
+  int group;
+
+  for (group = 0; group < PTW32_CPU_SET_GROUPS; group++)
+    {
+      ((_sched_cpu_set_vector_*)pdestset)->_cpuset[group] =
+	((_sched_cpu_set_vector_*)psrcset1)->_cpuset[group]
+	& ((_sched_cpu_set_vector_*)psrcset2)->_cpuset[group];
+    }
+}
+
+void
+_sched_affinitycpuor (cpu_set_t *pdestset, const cpu_set_t *psrcset1, const cpu_set_t *psrcset2)
+{
+  int group;
+
+  for (group = 0; group < PTW32_CPU_SET_GROUPS; group++)
+    {
+      ((_sched_cpu_set_vector_*)pdestset)->_cpuset[group] =
+	((_sched_cpu_set_vector_*)psrcset1)->_cpuset[group]
+	| ((_sched_cpu_set_vector_*)psrcset2)->_cpuset[group];
+    }
+}
+
+void
+_sched_affinitycpuxor (cpu_set_t *pdestset, const cpu_set_t *psrcset1, const cpu_set_t *psrcset2)
+{
+  int group;
+
+  for (group = 0; group < PTW32_CPU_SET_GROUPS; group++)
+    {
+      ((_sched_cpu_set_vector_*)pdestset)->_cpuset[group] =
+	((_sched_cpu_set_vector_*)psrcset1)->_cpuset[group]
+	^ ((_sched_cpu_set_vector_*)psrcset2)->_cpuset[group];
+    }
+}
+
+int
+_sched_affinitycpuequal (const cpu_set_t *pset1, const cpu_set_t *pset2)
+{
+  int group;
+
+  for (group = 0; group < PTW32_CPU_SET_GROUPS; group++)
+    {
+      if (((_sched_cpu_set_vector_*)pset1)->_cpuset[group]
+	  != ((_sched_cpu_set_vector_*)pset2)->_cpuset[group])
+	{
+	  return 0;
+	}
+    }
+
+  return 1;
+}
@@ -42,42 +42,73 @@ int
 sched_setscheduler (pid_t pid, int policy)
 {
   /*
-   * Win32 only has one policy which we call SCHED_OTHER.
-   * However, we try to provide other valid side-effects
-   * such as EPERM and ESRCH errors. Choosing to check
-   * for a valid policy last allows us to get the most value out
-   * of this function.
+   * Win32 schedules the threads of a process in REALTIME_PRIORITY_CLASS
+   * above those of every other class, round robin within each level,
+   * which is what we call SCHED_FIFO and SCHED_RR; any other class is
+   * SCHED_OTHER. Only the policy of the calling process is remembered
+   * exactly, that of another real-time process reads as SCHED_RR.
    */
-  if (0 != pid)
+  HANDLE h = GetCurrentProcess ();
+  int self = PTW32_TRUE;
+  DWORD priorityClass;
+  int result;
+
+  if (0 != pid && pid != (int) GetCurrentProcessId ())
     {
-      int selfPid = (int) GetCurrentProcessId ();
+      h = OpenProcess (PROCESS_SET_INFORMATION | PROCESS_QUERY_INFORMATION,
+		       PTW32_FALSE, (DWORD) pid);
 
-      if (pid != selfPid)
+      if (NULL == h)
 	{
-	  HANDLE h =
-	    OpenProcess (PROCESS_SET_INFORMATION, PTW32_FALSE, (DWORD) pid);
+	  errno =
+	    (GetLastError () ==
+	     (0xFF & ERROR_ACCESS_DENIED)) ? EPERM : ESRCH;
+	  return -1;
+	}
+
+      self = PTW32_FALSE;
+    }
+
+  priorityClass = GetPriorityClass (h);
+  result = (REALTIME_PRIORITY_CLASS != priorityClass ? SCHED_OTHER
+	    : self ? ptw32_schedPolicy : SCHED_RR);
 
-	  if (NULL == h)
-	    {
-	      errno =
-		(GetLastError () ==
-		 (0xFF & ERROR_ACCESS_DENIED)) ? EPERM : ESRCH;
-	      return -1;
-	    }
-	  else
-	    CloseHandle(h);
+  if (policy < SCHED_MIN || policy > SCHED_MAX)
+    {
+      errno = EINVAL;
+      result = -1;
+    }
+  else if (SCHED_OTHER == policy)
+    {
+      if (REALTIME_PRIORITY_CLASS == priorityClass)
+	{
+	  (void) SetPriorityClass (h, NORMAL_PRIORITY_CLASS);
+	}
+    }
+  else if (REALTIME_PRIORITY_CLASS != priorityClass)
+    {
+      /*
+       * Without the privilege to increase its base priority a
+       * process is put in HIGH_PRIORITY_CLASS instead.
+       */
+      if (0 == SetPriorityClass (h, REALTIME_PRIORITY_CLASS)
+	  || REALTIME_PRIORITY_CLASS != GetPriorityClass (h))
+	{
+	  (void) SetPriorityClass (h, priorityClass);
+	  errno = EPERM;
+	  result = -1;
 	}
     }
 
-  if (SCHED_OTHER != policy)
+  if (-1 != result && self && SCHED_OTHER != policy)
     {
-      errno = ENOSYS;
-      return -1;
+      ptw32_schedPolicy = policy;
     }
 
-  /*
-   * Don't set anything because there is nothing to set.
-   * Just return the current (the only possible) value.
-   */
-  return SCHED_OTHER;
+  if (!self)
+    {
+      CloseHandle (h);
+    }
+
+  return result;
 }
@@ -53,6 +53,10 @@ sched_yield (void)
       * DESCRIPTION
       *      This function indicates that the calling thread is
       *      willing to give up some time slices to other threads.
+      *      How it does is set for the process with
+      *      pthread_setyieldmode_np(): by default the processor
+      *      goes to any thread that is ready on it, whatever its
+      *      priority.
       *      NOTE: Since this is part of POSIX 1003.1b
       *                (realtime extensions), it is defined as returning
       *                -1 if an error occurs and sets errno to the actual
@@ -65,7 +69,49 @@ sched_yield (void)
       * ------------------------------------------------------
       */
 {
-  Sleep (0);
+  ptw32_thread_t * sp;
+  int yields = 0;
+  DWORD now;
+
+  switch (ptw32_yield_mode)
+    {
+    case PTHREAD_YIELD_SLEEP_NP:
+      /* A fiber lets the other queued fibers run */
+      if (!ptw32_fiber_yield ())
+	{
+	  Sleep (0);
+	}
+      break;
+
+    case PTHREAD_YIELD_BACKOFF_NP:
+      /*
+       * Back off over the calls of a thread that keeps yielding, as
+       * the library's own loops do over theirs. A thread that isn't
+       * a POSIX thread has nowhere to count them and only switches.
+       */
+      sp = (ptw32_thread_t *) PTW32_SELF_THREAD ();
+
+      if (sp == NULL)
+	{
+	  ptw32_yield (&yields);
+	  break;
+	}
+
+      now = GetTickCount ();
+
+      if (now - sp->yieldTick > PTW32_YIELD_RESET)
+	{
+	  sp->yields = 0;
+	}
+
+      ptw32_yield (&sp->yields);
+      sp->yieldTick = GetTickCount ();
+      break;
+
+    default:
+      ptw32_yield (&yields);
+      break;
+    }
 
   return 0;
 }
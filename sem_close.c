@@ -45,14 +45,65 @@
 #include "semaphore.h"
 #include "implement.h"
 
-/* ignore warning "unreferenced formal parameter" */
-#if defined(_MSC_VER)
-#pragma warning( disable : 4100 )
-#endif
 
 int
 sem_close (sem_t * sem)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function closes a named semaphore opened by
+      *      sem_open.
+      *
+      * PARAMETERS
+      *      sem
+      *              the address sem_open returned
+      *
+      * DESCRIPTION
+      *      The semaphore stays open in this process until it
+      *      has been closed as many times as it was opened. It
+      *      is freed once it has been unlinked and every process
+      *      has closed it.
+      *
+      * RESULTS
+      *              0               successfully closed,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'sem' is not an open named semaphore.
+      *
+      * ------------------------------------------------------
+      */
 {
-  errno = ENOSYS;
-  return -1;
+  ptw32_mcs_local_node_t node;
+  ptw32_named_sem_t * ns;
+  ptw32_named_sem_t ** prev;
+
+  ptw32_mcs_lock_acquire (&ptw32_named_sem_lock, &node);
+
+  for (prev = &ptw32_namedSems; (ns = *prev) != NULL && &ns->sem != sem; prev = &ns->next)
+    {
+    }
+
+  if (NULL != ns && 0 == --ns->opens)
+    {
+      *prev = ns->next;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  if (NULL == ns)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  if (0 == ns->opens)
+    {
+      ptw32_named_sem_release (ns->sem);
+      (void) UnmapViewOfFile (ns->name);
+      (void) CloseHandle (ns->mapping);
+      free (ns);
+    }
+
+  return 0;
+
 }				/* sem_close */
@@ -79,6 +79,13 @@ sem_destroy (sem_t * sem)
     {
       result = EINVAL;
     }
+  else if (PTW32_IS_PSHARED (*sem))
+    {
+      if (0 == (result = ptw32_pshared_sem_destroy (sem)))
+	{
+	  return 0;
+	}
+    }
   else
     {
       s = *sem;
@@ -94,39 +101,28 @@ sem_destroy (sem_t * sem)
             {
               /* There are no threads currently blocked on this semaphore. */
 
-              if (!CloseHandle (s->sem))
-	        {
-                  (void) pthread_mutex_unlock (&s->lock);
-	          result = EINVAL;
-	        }
-	      else
-	        {
-                  /*
-                   * Invalidate the semaphore handle when we have the lock.
-                   * Other sema operations should test this after acquiring the lock
-                   * to check that the sema is still valid, i.e. before performing any
-                   * operations. This may only be necessary before the sema op routine
-                   * returns so that the routine can return EINVAL - e.g. if setting
-                   * s->value to SEM_VALUE_MAX below does force a fall-through.
-                   */
-                  *sem = NULL;
+              /*
+               * Invalidate the semaphore handle when we have the lock.
+               * Other sema operations should test this after acquiring the lock
+               * to check that the sema is still valid, i.e. before performing any
+               * operations. This may only be necessary before the sema op routine
+               * returns so that the routine can return EINVAL - e.g. if setting
+               * s->value to SEM_VALUE_MAX below does force a fall-through.
+               */
+              *sem = NULL;
 
-                  /* Prevent anyone else actually waiting on or posting this sema.
-                   */
-                  s->value = SEM_VALUE_MAX;
+              /* Prevent anyone else actually waiting on or posting this sema.
+               */
+              s->value = SEM_VALUE_MAX;
 
-                  (void) pthread_mutex_unlock (&s->lock);
+              (void) pthread_mutex_unlock (&s->lock);
 
-                  do
-                    {
-                      /* Give other threads a chance to run and exit any sema op
-                       * routines. Due to the SEM_VALUE_MAX value, if sem_post or
-                       * sem_wait were blocked by us they should fall through.
-                       */
-                      Sleep(0);
-                    }
-                  while (pthread_mutex_destroy (&s->lock) == EBUSY);
-                }
+              /*
+               * Threads that have been posted but haven't yet left their
+               * sema op routines hold references. The last of us to let go
+               * closes and frees the sema. See ptw32_sem_release.c.
+               */
+              ptw32_sem_release (s);
             }
         }
     }
@@ -137,8 +133,6 @@ sem_destroy (sem_t * sem)
       return -1;
     }
 
-  free (s);
-
   return 0;
 
 }				/* sem_destroy */
@@ -44,126 +44,200 @@
 #include "implement.h"
 
 int
-sem_init (sem_t * sem, int pshared, unsigned int value)
+sem_init_np (sem_t * sem, int pshared, unsigned int value, int flags)
      /*
       * ------------------------------------------------------
       * DOCPUBLIC
-      *      This function initializes a semaphore. The
-      *      initial value of the semaphore is 'value'
+      *      As sem_init, with flags, returning the error
+      *      rather than setting errno.
       *
       * PARAMETERS
-      *      sem
-      *              pointer to an instance of sem_t
+      *      sem, pshared, value
+      *              as sem_init
       *
-      *      pshared
-      *              if zero, this semaphore may only be shared between
-      *              threads in the same process.
-      *              if nonzero, the semaphore can be shared between
-      *              processes
-      *
-      *      value
-      *              initial value of the semaphore counter
+      *      flags
+      *              0, SEM_FIFO_NP or SEM_PRIORITY_NP
       *
       * DESCRIPTION
-      *      This function initializes a semaphore. The
-      *      initial value of the semaphore is set to 'value'.
+      *      With SEM_FIFO_NP, threads blocked on the semaphore
+      *      are queued in arrival order and each post hands its
+      *      unit directly to the longest waiter, so no thread
+      *      that arrives later, and no sem_trywait(), can take
+      *      it first. This bounds how long a waiter can be
+      *      passed over, at the cost of a context switch for
+      *      every unit that is handed over.
+      *
+      *      SEM_PRIORITY_NP queues the waiters by priority
+      *      (sched_priority, or the boost of the priority
+      *      protocol mutexes the waiter holds), highest first,
+      *      and in arrival order within a priority.
       *
       * RESULTS
       *              0               successfully created semaphore,
-      *              -1              failed, error in errno
-      * ERRNO
-      *              EINVAL          'sem' is not a valid semaphore, or
-      *                              'value' >= SEM_VALUE_MAX
+      *              EINVAL          'sem' is not a valid semaphore,
+      *                              'value' >= SEM_VALUE_MAX or
+      *                              'flags' is invalid,
       *              ENOMEM          out of memory,
       *              ENOSPC          a required resource has been exhausted,
-      *              ENOSYS          semaphores are not supported,
-      *              EPERM           the process lacks appropriate privilege
+      *              ENOSYS          SEM_FIFO_NP or SEM_PRIORITY_NP with
+      *                              'pshared', or in a NEED_SEM build
       *
       * ------------------------------------------------------
       */
 {
   int result = 0;
   sem_t s = NULL;
+  ptw32_sem_fifo_t * fifo = NULL;
+
+  if (value > (unsigned int)SEM_VALUE_MAX
+      || (flags & ~(SEM_FIFO_NP | SEM_PRIORITY_NP)) != 0)
+    {
+      return EINVAL;
+    }
+
+  if (flags != 0)
+    {
+#if defined(NEED_SEM)
+      return ENOSYS;
+#else
+      if (pshared != 0)
+	{
+	  return ENOSYS;
+	}
+
+      if ((fifo = (ptw32_sem_fifo_t *) ptw32_object_alloc (sizeof (*fifo), 0)) == NULL)
+	{
+	  return ENOMEM;
+	}
+      fifo->byPriority = ((flags & SEM_PRIORITY_NP) != 0);
+#endif
+    }
 
   if (pshared != 0)
     {
       /*
        * Creating a semaphore that can be shared between
-       * processes
+       * processes. See ptw32_pshared_sem.c.
        */
-      result = EPERM;
+      if (EAGAIN == (result = ptw32_pshared_sem_init (sem, value)))
+	{
+	  result = ENOSPC;
+	}
+      return result;
     }
-  else if (value > (unsigned int)SEM_VALUE_MAX)
+
+  s = (sem_t) ptw32_object_alloc (sizeof (*s), ptw32_objectAlign);
+
+  if (NULL == s)
     {
-      result = EINVAL;
+      ptw32_object_free (fifo);
+      return ENOMEM;
     }
-  else
+
+  s->value = value;
+  s->refs = 1;
+  s->fifo = fifo;
+  if (pthread_mutex_init(&s->lock, NULL) == 0)
     {
-      s = (sem_t) calloc (1, sizeof (*s));
 
-      if (NULL == s)
+#if defined(NEED_SEM)
+
+      s->sem = ptw32_libstat_handle (CreateEvent (NULL,
+						  PTW32_FALSE,	/* auto (not manual) reset */
+						  PTW32_FALSE,	/* initial state is unset */
+						  NULL),
+				     PTW32_LIBSTAT_EVENTS);
+
+      if (0 == s->sem)
 	{
-	  result = ENOMEM;
+	  (void) pthread_mutex_destroy(&s->lock);
+	  result = ENOSPC;
 	}
       else
 	{
-
-	  s->value = value;
-	  if (pthread_mutex_init(&s->lock, NULL) == 0)
-	    {
-
-#if defined(NEED_SEM)
-
-	  s->sem = CreateEvent (NULL,
-				PTW32_FALSE,	/* auto (not manual) reset */
-				PTW32_FALSE,	/* initial state is unset */
-				NULL);
-
-	  if (0 == s->sem)
-	    {
-	      free (s);
-	      (void) pthread_mutex_destroy(&s->lock);
-	      result = ENOSPC;
-	    }
-	  else
-	    {
-	      s->leftToUnblock = 0;
-	    }
+	  s->leftToUnblock = 0;
+	}
 
 #else /* NEED_SEM */
 
-	      if ((s->sem = CreateSemaphore (NULL,	/* Always NULL */
-					     (long) 0,	/* Force threads to wait */
-					     (long) SEM_VALUE_MAX,	/* Maximum value */
-					     NULL)) == 0)	/* Name */
-		{
-		  (void) pthread_mutex_destroy(&s->lock);
-		  result = ENOSPC;
-		}
+      if ((s->sem = ptw32_libstat_handle (CreateSemaphore (NULL,	/* Always NULL */
+							   (long) 0,	/* Force threads to wait */
+							   (long) SEM_VALUE_MAX,	/* Maximum value */
+							   NULL),	/* Name */
+					  PTW32_LIBSTAT_SEMAPHORES)) == 0)
+	{
+	  (void) pthread_mutex_destroy(&s->lock);
+	  result = ENOSPC;
+	}
 
 #endif /* NEED_SEM */
 
-	    }
-	  else
-	    {
-	      result = ENOSPC;
-	    }
+    }
+  else
+    {
+      result = ENOSPC;
+    }
 
-	  if (result != 0)
-	    {
-	      free(s);
-	    }
-	}
+  if (result != 0)
+    {
+      ptw32_object_free (fifo);
+      ptw32_object_free (s);
+      return result;
     }
 
+  *sem = s;
+
+  return 0;
+
+}				/* sem_init_np */
+
+
+int
+sem_init (sem_t * sem, int pshared, unsigned int value)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function initializes a semaphore. The
+      *      initial value of the semaphore is 'value'
+      *
+      * PARAMETERS
+      *      sem
+      *              pointer to an instance of sem_t
+      *
+      *      pshared
+      *              if zero, this semaphore may only be shared between
+      *              threads in the same process.
+      *              if nonzero, the semaphore can be shared between
+      *              processes
+      *
+      *      value
+      *              initial value of the semaphore counter
+      *
+      * DESCRIPTION
+      *      This function initializes a semaphore. The
+      *      initial value of the semaphore is set to 'value'.
+      *
+      * RESULTS
+      *              0               successfully created semaphore,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'sem' is not a valid semaphore, or
+      *                              'value' >= SEM_VALUE_MAX
+      *              ENOMEM          out of memory,
+      *              ENOSPC          a required resource has been exhausted,
+      *              ENOSYS          semaphores are not supported
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result = sem_init_np (sem, pshared, value, 0);
+
   if (result != 0)
     {
       errno = result;
       return -1;
     }
 
-  *sem = s;
-
   return 0;
 
 }				/* sem_init */
@@ -41,18 +41,178 @@
  *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
  */
 
+#include <stdarg.h>
+#include <fcntl.h>
 #include "pthread.h"
 #include "semaphore.h"
 #include "implement.h"
 
-/* ignore warning "unreferenced formal parameter" */
-#if defined(_MSC_VER)
-#pragma warning( disable : 4100 )
-#endif
 
-int
-sem_open (const char *name, int oflag, mode_t mode, unsigned int value)
+sem_t *
+sem_open (const char *name, int oflag, ...)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function opens a named semaphore, creating it
+      *      if O_CREAT is in 'oflag' and it doesn't exist. When
+      *      it's created the arguments after 'oflag' are
+      *      mode_t mode and unsigned int value.
+      *
+      * PARAMETERS
+      *      name
+      *              the semaphore's name, which may start with
+      *              a '/' and otherwise mustn't contain one
+      *
+      *      oflag
+      *              O_CREAT, optionally with O_EXCL, or 0
+      *
+      *      mode
+      *              ignored; the semaphore has the default
+      *              security of the session's named objects
+      *
+      *      value
+      *              initial value of a new semaphore
+      *
+      * DESCRIPTION
+      *      The semaphore is a process shared semaphore, so
+      *      sem_post and sem_wait only enter the kernel to block
+      *      or wake a waiter. Opening the same name again in
+      *      the same process returns the same address.
+      *
+      *      Windows named objects live as long as some process
+      *      has them open, not until they are unlinked: a named
+      *      semaphore that no process has open is gone.
+      *
+      * RESULTS
+      *              the semaphore's address or SEM_FAILED, with the
+      *              error in errno
+      * ERRNO
+      *              EEXIST          O_CREAT and O_EXCL are set and the
+      *                              semaphore exists,
+      *              EINVAL          'name' is not a valid name, or
+      *                              'value' > SEM_VALUE_MAX,
+      *              ENAMETOOLONG    'name' is too long,
+      *              ENOENT          O_CREAT is not set and the
+      *                              semaphore doesn't exist,
+      *              ENOMEM          out of memory,
+      *              ENOSPC          a required resource has been exhausted.
+      *
+      * ------------------------------------------------------
+      */
 {
-  errno = ENOSYS;
-  return -1;
+  ptw32_mcs_local_node_t node;
+  ptw32_sem_name_t * view;
+  ptw32_named_sem_t * ns;
+  HANDLE mapping;
+  unsigned int value = 0;
+  sem_t s;
+  int result = 0;
+
+  if (oflag & O_CREAT)
+    {
+      va_list ap;
+
+      va_start (ap, oflag);
+      (void) va_arg (ap, int);	/* mode_t is promoted */
+      value = va_arg (ap, unsigned int);
+      va_end (ap);
+
+      if (value > (unsigned int) SEM_VALUE_MAX)
+	{
+	  errno = EINVAL;
+	  return SEM_FAILED;
+	}
+    }
+
+  if (NULL == (mapping = ptw32_sem_name_map (name, oflag & O_CREAT, &view)))
+    {
+      return SEM_FAILED;
+    }
+
+  ptw32_sem_name_lock (view);
+
+  if (0 == view->id)
+    {
+      if (!(oflag & O_CREAT))
+	{
+	  /* Unlinked */
+	  result = ENOENT;
+	}
+      else if (0 == (result = ptw32_pshared_sem_init (&s, value)))
+	{
+	  /* The name's reference */
+	  ptw32_pshared_get (s, PTW32_PSHARED_SEM)->s.u.sem.refs = 1;
+	  view->id = PTW32_PSHARED_ID (s);
+	}
+      else if (EAGAIN == result)
+	{
+	  result = ENOSPC;
+	}
+    }
+  else if ((oflag & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL))
+    {
+      result = EEXIST;
+    }
+
+  if (0 != result)
+    {
+      ptw32_sem_name_unlock (view);
+      (void) UnmapViewOfFile (view);
+      (void) CloseHandle (mapping);
+      errno = result;
+      return SEM_FAILED;
+    }
+
+  s = (sem_t) PTW32_PSHARED_HANDLE (view->id);
+
+  ptw32_mcs_lock_acquire (&ptw32_named_sem_lock, &node);
+
+  for (ns = ptw32_namedSems; ns != NULL && ns->sem != s; ns = ns->next)
+    {
+    }
+
+  if (NULL != ns)
+    {
+      ns->opens++;
+    }
+  else if (NULL != (ns = (ptw32_named_sem_t *) calloc (1, sizeof (*ns))))
+    {
+      ptw32_pshared_slot_t * slot = ptw32_pshared_get (s, PTW32_PSHARED_SEM);
+
+      /*
+       * This process's reference, taken under the name's lock so that
+       * an unlink can't free the semaphore first.
+       */
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->s.u.sem.refs);
+      ns->sem = s;
+      ns->mapping = mapping;
+      ns->name = view;
+      ns->opens = 1;
+      ns->next = ptw32_namedSems;
+      ptw32_namedSems = ns;
+      mapping = NULL;
+    }
+  else
+    {
+      result = ENOMEM;
+    }
+
+  ptw32_mcs_lock_release (&node);
+  ptw32_sem_name_unlock (view);
+
+  if (NULL != mapping)
+    {
+      /* Already open in this process, or out of memory */
+      (void) UnmapViewOfFile (view);
+      (void) CloseHandle (mapping);
+    }
+
+  if (0 != result)
+    {
+      errno = result;
+      return SEM_FAILED;
+    }
+
+  return &ns->sem;
+
 }				/* sem_open */
@@ -47,27 +47,26 @@
 
 
 int
-sem_post (sem_t * sem)
+sem_post_np (sem_t * sem)
      /*
       * ------------------------------------------------------
       * DOCPUBLIC
-      *      This function posts a wakeup to a semaphore.
+      *      As sem_post, but returns the error rather than
+      *      setting errno.
       *
       * PARAMETERS
       *      sem
       *              pointer to an instance of sem_t
       *
       * DESCRIPTION
-      *      This function posts a wakeup to a semaphore. If there
-      *      are waiting threads (or processes), one is awakened;
-      *      otherwise, the semaphore value is incremented by one.
+      *      If there are waiting threads (or processes), one is
+      *      awakened; otherwise, the semaphore value is
+      *      incremented by one. Neither errno nor the thread's
+      *      last error code is touched.
       *
       * RESULTS
       *              0               successfully posted semaphore,
-      *              -1              failed, error in errno
-      * ERRNO
       *              EINVAL          'sem' is not a valid semaphore,
-      *              ENOSYS          semaphores are not supported,
       *              ERANGE          semaphore count is too big
       *
       * ------------------------------------------------------
@@ -80,6 +79,11 @@ sem_post (sem_t * sem)
     {
       result = EINVAL;
     }
+  else if (PTW32_IS_PSHARED (s))
+    {
+      result = ptw32_pshared_sem_post (s, 1);
+    }
+#if defined(NEED_SEM)
   else if ((result = pthread_mutex_lock (&s->lock)) == 0)
     {
       /* See sem_destroy.c
@@ -87,27 +91,17 @@ sem_post (sem_t * sem)
       if (*sem == NULL)
         {
           (void) pthread_mutex_unlock (&s->lock);
-          result = EINVAL;
-          return -1;
+          return EINVAL;
         }
 
       if (s->value < SEM_VALUE_MAX)
 	{
-#if defined(NEED_SEM)
-	  if (++s->value <= 0
-	      && !SetEvent(s->sem))
-	    {
-	      s->value--;
-	      result = EINVAL;
-	    }
-#else
 	  if (++s->value <= 0
-	      && !ReleaseSemaphore (s->sem, 1, NULL))
+	      && !PTW32_SETEVENT (s->sem))
 	    {
 	      s->value--;
 	      result = EINVAL;
 	    }
-#endif /* NEED_SEM */
 	}
       else
 	{
@@ -116,6 +110,85 @@ sem_post (sem_t * sem)
 
       (void) pthread_mutex_unlock (&s->lock);
     }
+#else
+  else if (s->fifo != NULL)
+    {
+      result = ptw32_sem_fifo_post (s, 1);
+    }
+  else
+    {
+      LONG v;
+
+      do
+	{
+	  v = *((LONG volatile *) &s->value);
+	  if (v > SEM_VALUE_MAX - 1)
+	    {
+	      result = ERANGE;
+	      break;
+	    }
+	}
+      /*
+       * A full barrier, not just release: the PTW32_WAITANY_NOTIFY
+       * check below mustn't be read before the new value is seen.
+       */
+      while ((PTW32_INTERLOCKED_LONG) v !=
+	     PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->value,
+						      (PTW32_INTERLOCKED_LONG) (v + 1),
+						      (PTW32_INTERLOCKED_LONG) v));
+
+      if (result == 0 && v < 0
+	  && !PTW32_RELEASESEMAPHORE (s->sem, 1, NULL))
+	{
+	  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->value);
+	  result = EINVAL;
+	}
+      else if (result == 0 && v >= 0)
+	{
+	  /* A unit is free for an asynchronous waiter */
+	  (void) ptw32_async_wake ((volatile VOID *) &s->value, PTW32_TRUE);
+	}
+    }
+#endif /* NEED_SEM */
+
+  if (result == 0 && !PTW32_IS_PSHARED (s))
+    {
+      PTW32_WAITANY_NOTIFY ();
+    }
+
+  return result;
+
+}				/* sem_post_np */
+
+
+int
+sem_post (sem_t * sem)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function posts a wakeup to a semaphore.
+      *
+      * PARAMETERS
+      *      sem
+      *              pointer to an instance of sem_t
+      *
+      * DESCRIPTION
+      *      This function posts a wakeup to a semaphore. If there
+      *      are waiting threads (or processes), one is awakened;
+      *      otherwise, the semaphore value is incremented by one.
+      *
+      * RESULTS
+      *              0               successfully posted semaphore,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'sem' is not a valid semaphore,
+      *              ENOSYS          semaphores are not supported,
+      *              ERANGE          semaphore count is too big
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result = sem_post_np (sem);
 
   if (result != 0)
     {
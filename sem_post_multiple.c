@@ -65,6 +65,9 @@ sem_post_multiple (sem_t * sem, int count)
       *      are waiting threads (or processes), n <= count are awakened;
       *      the semaphore value is incremented by count - n.
       *
+      *      The value is updated in one atomic operation and the n
+      *      threads are released with a single kernel call.
+      *
       * RESULTS
       *              0               successfully posted semaphore,
       *              -1              failed, error in errno
@@ -84,6 +87,11 @@ sem_post_multiple (sem_t * sem, int count)
     {
       result = EINVAL;
     }
+  else if (PTW32_IS_PSHARED (s))
+    {
+      result = ptw32_pshared_sem_post (s, count);
+    }
+#if defined(NEED_SEM)
   else if ((result = pthread_mutex_lock (&s->lock)) == 0)
     {
       /* See sem_destroy.c
@@ -101,8 +109,7 @@ sem_post_multiple (sem_t * sem, int count)
 	  s->value += count;
 	  if (waiters > 0)
 	    {
-#if defined(NEED_SEM)
-	      if (SetEvent(s->sem))
+	      if (PTW32_SETEVENT (s->sem))
 		{
 		  waiters--;
 		  s->leftToUnblock += count - 1;
@@ -111,12 +118,6 @@ sem_post_multiple (sem_t * sem, int count)
 		      s->leftToUnblock = waiters;
 		    }
 		}
-#else
-	      if (ReleaseSemaphore (s->sem,  (waiters<=count)?waiters:count, 0))
-		{
-		  /* No action */
-		}
-#endif
 	      else
 		{
 		  s->value -= count;
@@ -130,6 +131,45 @@ sem_post_multiple (sem_t * sem, int count)
 	}
       (void) pthread_mutex_unlock (&s->lock);
     }
+#else
+  else if (s->fifo != NULL)
+    {
+      result = ptw32_sem_fifo_post (s, count);
+    }
+  else
+    {
+      LONG v;
+
+      do
+	{
+	  v = *((LONG volatile *) &s->value);
+	  if (v > SEM_VALUE_MAX - count)
+	    {
+	      result = ERANGE;
+	      break;
+	    }
+	}
+      while ((PTW32_INTERLOCKED_LONG) v !=
+	     PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->value,
+						      (PTW32_INTERLOCKED_LONG) (v + count),
+						      (PTW32_INTERLOCKED_LONG) v));
+
+      /* Wake no more threads than are waiting */
+      waiters = -v;
+      if (result == 0 && waiters > 0
+	  && !PTW32_RELEASESEMAPHORE (s->sem, (waiters <= count) ? waiters : count, 0))
+	{
+	  (void) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->value,
+						      (PTW32_INTERLOCKED_LONG) -count);
+	  result = EINVAL;
+	}
+      else if (result == 0 && v + count > 0)
+	{
+	  /* Units are free for asynchronous waiters */
+	  (void) ptw32_async_wake ((volatile VOID *) &s->value, PTW32_TRUE);
+	}
+    }
+#endif /* NEED_SEM */
 
   if (result != 0)
     {
@@ -137,6 +177,11 @@ sem_post_multiple (sem_t * sem, int count)
       return -1;
     }
 
+  if (!PTW32_IS_PSHARED (s))
+    {
+      PTW32_WAITANY_NOTIFY ();
+    }
+
   return 0;
 
 }				/* sem_post_multiple */
@@ -58,6 +58,16 @@ ptw32_sem_timedwait_cleanup (void * args)
   sem_timedwait_cleanup_args_t * a = (sem_timedwait_cleanup_args_t *)args;
   sem_t s = a->sem;
 
+#if !defined(NEED_SEM)
+  /*
+   * We either timed out or were cancelled. If someone has posted
+   * between then and now we take the semaphore, as below.
+   */
+  if (ptw32_sem_unwait (s))
+    {
+      *(a->resultPtr) = 0;
+    }
+#else
   if (pthread_mutex_lock (&s->lock) == 0)
     {
       /*
@@ -77,65 +87,35 @@ ptw32_sem_timedwait_cleanup (void * args)
 	{
 	  /* Indicate we're no longer waiting */
 	  s->value++;
-#if defined(NEED_SEM)
 	  if (s->value > 0)
 	    {
 	      s->leftToUnblock = 0;
 	    }
-#else
-          /*
-           * Don't release the W32 sema, it doesn't need adjustment
-           * because it doesn't record the number of waiters.
-           */
-#endif
 	}
       (void) pthread_mutex_unlock (&s->lock);
     }
+#endif /* NEED_SEM */
+
+  ptw32_sem_release (s);
 }
 
 
 int
 sem_timedwait (sem_t * sem, const struct timespec *abstime)
-     /*
-      * ------------------------------------------------------
-      * DOCPUBLIC
-      *      This function waits on a semaphore possibly until
-      *      'abstime' time.
-      *
-      * PARAMETERS
-      *      sem
-      *              pointer to an instance of sem_t
-      *
-      *      abstime
-      *              pointer to an instance of struct timespec
-      *
-      * DESCRIPTION
-      *      This function waits on a semaphore. If the
-      *      semaphore value is greater than zero, it decreases
-      *      its value by one. If the semaphore value is zero, then
-      *      the calling thread (or process) is blocked until it can
-      *      successfully decrease the value or until interrupted by
-      *      a signal.
-      *
-      *      If 'abstime' is a NULL pointer then this function will
-      *      block until it can successfully decrease the value or
-      *      until interrupted by a signal.
-      *
-      * RESULTS
-      *              0               successfully decreased semaphore,
-      *              -1              failed, error in errno
-      * ERRNO
-      *              EINVAL          'sem' is not a valid semaphore,
-      *              ENOSYS          semaphores are not supported,
-      *              EINTR           the function was interrupted by a signal,
-      *              EDEADLK         a deadlock condition was detected.
-      *              ETIMEDOUT       abstime elapsed before success.
-      *
-      * ------------------------------------------------------
-      */
+{
+  return sem_clockwait (sem, CLOCK_REALTIME, abstime);
+}				/* sem_timedwait */
+
+
+/*
+ * sem_clockwait once the clock has been checked. The clock may also be
+ * PTW32_CLOCK_RELATIVE: the wait is a single sleep.
+ */
+static int
+ptw32_sem_clockwait (sem_t * sem, clockid_t clock_id, const struct timespec *abstime)
 {
   int result = 0;
-  sem_t s = *sem;
+  sem_t s;
 
   pthread_testcancel();
 
@@ -143,26 +123,25 @@ sem_timedwait (sem_t * sem, const struct timespec *abstime)
     {
       result = EINVAL;
     }
+  else if (PTW32_IS_PSHARED (s = *sem))
+    {
+      result = ptw32_pshared_sem_wait (s, clock_id, abstime);
+    }
+#if !defined(NEED_SEM)
+  else if (s->fifo != NULL)
+    {
+      result = ptw32_sem_fifo_wait (s, clock_id, abstime);
+    }
+#endif
   else
     {
-      DWORD milliseconds;
-
-      if (abstime == NULL)
-	{
-	  milliseconds = INFINITE;
-	}
-      else
-	{
-	  /* 
-	   * Calculate timeout as milliseconds from current system time. 
-	   */
-	  milliseconds = ptw32_relmillisecs (abstime);
-	}
-
+#if defined(NEED_SEM)
       if ((result = pthread_mutex_lock (&s->lock)) == 0)
+#endif
 	{
 	  int v;
 
+#if defined(NEED_SEM)
 	  /* See sem_destroy.c
 	   */
 	  if (*sem == NULL)
@@ -172,14 +151,19 @@ sem_timedwait (sem_t * sem, const struct timespec *abstime)
 	      return -1;
 	    }
 
-	  v = --s->value;
+	  if ((v = --s->value) < 0)
+	    {
+	      /* See ptw32_sem_release.c */
+	      (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->refs);
+	    }
 	  (void) pthread_mutex_unlock (&s->lock);
+#else
+	  v = (int) ptw32_sem_decrement (s);
+#endif
 
 	  if (v < 0)
 	    {
-#if defined(NEED_SEM)
 	      int timedout;
-#endif
 	      sem_timedwait_cleanup_args_t cleanup_args;
 
 	      cleanup_args.sem = s;
@@ -190,10 +174,10 @@ sem_timedwait (sem_t * sem, const struct timespec *abstime)
 #endif
 	      /* Must wait */
               pthread_cleanup_push(ptw32_sem_timedwait_cleanup, (void *) &cleanup_args);
-#if defined(NEED_SEM)
+	      PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_SEM);
 	      timedout =
-#endif
-	      result = pthreadCancelableTimedWait (s->sem, milliseconds);
+	      result = ptw32_cancelable_abstimed_wait (s->sem, clock_id, abstime);
+	      /* The cleanup drops our reference if it runs */
 	      pthread_cleanup_pop(result);
 #if defined(PTW32_CONFIG_MSVC7)
 #pragma inline_depth()
@@ -203,23 +187,23 @@ sem_timedwait (sem_t * sem, const struct timespec *abstime)
 
 	      if (!timedout && pthread_mutex_lock (&s->lock) == 0)
 	        {
-        	  if (*sem == NULL)
-        	    {
-        	      (void) pthread_mutex_unlock (&s->lock);
-        	      errno = EINVAL;
-        	      return -1;
-        	    }
-
-	          if (s->leftToUnblock > 0)
+		  /* See sem_destroy.c
+		   */
+	          if (*sem != NULL && s->leftToUnblock > 0)
 	            {
 		      --s->leftToUnblock;
-		      SetEvent(s->sem);
+		      PTW32_SETEVENT (s->sem);
 		    }
 	          (void) pthread_mutex_unlock (&s->lock);
 	        }
 
 #endif /* NEED_SEM */
 
+	      if (!timedout)
+		{
+		  ptw32_sem_release (s);
+		}
+
 	    }
 	}
 
@@ -235,4 +219,103 @@ sem_timedwait (sem_t * sem, const struct timespec *abstime)
 
   return 0;
 
-}				/* sem_timedwait */
+}				/* ptw32_sem_clockwait */
+
+
+int
+sem_clockwait (sem_t * sem, clockid_t clock_id, const struct timespec *abstime)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function waits on a semaphore possibly until
+      *      'abstime' time, measured against clock_id.
+      *      sem_timedwait is sem_clockwait with CLOCK_REALTIME.
+      *
+      * PARAMETERS
+      *      sem
+      *              pointer to an instance of sem_t
+      *
+      *      clock_id
+      *              CLOCK_REALTIME or CLOCK_MONOTONIC
+      *
+      *      abstime
+      *              pointer to an instance of struct timespec
+      *
+      * DESCRIPTION
+      *      This function waits on a semaphore. If the
+      *      semaphore value is greater than zero, it decreases
+      *      its value by one. If the semaphore value is zero, then
+      *      the calling thread (or process) is blocked until it can
+      *      successfully decrease the value or until interrupted by
+      *      a signal.
+      *
+      *      If 'abstime' is a NULL pointer then this function will
+      *      block until it can successfully decrease the value or
+      *      until interrupted by a signal.
+      *
+      * RESULTS
+      *              0               successfully decreased semaphore,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'sem' is not a valid semaphore,
+      *                              or 'clock_id' is not a valid clock,
+      *              ENOSYS          semaphores are not supported,
+      *              EINTR           the function was interrupted by a signal,
+      *              EDEADLK         a deadlock condition was detected.
+      *              ETIMEDOUT       abstime elapsed before success.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (!PTW32_VALID_CLOCK(clock_id))
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  return ptw32_sem_clockwait (sem, clock_id, abstime);
+}				/* sem_clockwait */
+
+
+int
+sem_reltimedwait_np (sem_t * sem, const struct timespec *reltime)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      As sem_timedwait, with a timeout relative to the
+      *      call instead of an absolute time.
+      *
+      * PARAMETERS
+      *      sem
+      *              pointer to an instance of sem_t
+      *
+      *      reltime
+      *              how long to wait for the semaphore
+      *
+      * DESCRIPTION
+      *      The caller needn't read the clock to make an
+      *      abstime, and the wait, a single sleep, is given
+      *      reltime directly without the library reading it
+      *      either.
+      *
+      * RESULTS
+      *              0               successfully decreased semaphore,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'sem' is not a valid semaphore,
+      *                              or reltime is invalid,
+      *              ETIMEDOUT       reltime passed before success,
+      *              as sem_timedwait otherwise.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (!PTW32_VALID_RELTIME(reltime))
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  return ptw32_sem_clockwait (sem, PTW32_CLOCK_RELATIVE, reltime);
+}				/* sem_reltimedwait_np */
+
@@ -47,31 +47,27 @@
 
 
 int
-sem_trywait (sem_t * sem)
+sem_trywait_np (sem_t * sem)
      /*
       * ------------------------------------------------------
       * DOCPUBLIC
-      *      This function tries to wait on a semaphore.
+      *      As sem_trywait, but returns the error rather than
+      *      setting errno.
       *
       * PARAMETERS
       *      sem
       *              pointer to an instance of sem_t
       *
       * DESCRIPTION
-      *      This function tries to wait on a semaphore. If the
-      *      semaphore value is greater than zero, it decreases
-      *      its value by one. If the semaphore value is zero, then
-      *      this function returns immediately with the error EAGAIN
+      *      If the semaphore value is greater than zero this
+      *      function decreases it by one, otherwise it returns
+      *      EAGAIN at once. Neither errno nor the thread's last
+      *      error code is touched, which makes polling cheaper.
       *
       * RESULTS
       *              0               successfully decreased semaphore,
-      *              -1              failed, error in errno
-      * ERRNO
       *              EAGAIN          the semaphore was already locked,
-      *              EINVAL          'sem' is not a valid semaphore,
-      *              ENOTSUP         sem_trywait is not supported,
-      *              EINTR           the function was interrupted by a signal,
-      *              EDEADLK         a deadlock condition was detected.
+      *              EINVAL          'sem' is not a valid semaphore.
       *
       * ------------------------------------------------------
       */
@@ -83,6 +79,29 @@ sem_trywait (sem_t * sem)
     {
       result = EINVAL;
     }
+  else if (PTW32_IS_PSHARED (s))
+    {
+      switch (ptw32_pshared_sem_take (s, 1))
+	{
+	case 1:
+	  break;
+	case 0:
+	  result = EAGAIN;
+	  break;
+	default:
+	  result = EINVAL;
+	  break;
+	}
+    }
+#if defined(NEED_SEM)
+  else if (*((LONG volatile *) &s->value) <= 0)
+    {
+      /*
+       * Nothing to take when the value was read, so pollers needn't
+       * contend for the lock. Only a decrement has to hold it.
+       */
+      result = EAGAIN;
+    }
   else if ((result = pthread_mutex_lock (&s->lock)) == 0)
     {
       /* See sem_destroy.c
@@ -90,8 +109,7 @@ sem_trywait (sem_t * sem)
      if (*sem == NULL)
         {
           (void) pthread_mutex_unlock (&s->lock);
-          errno = EINVAL;
-          return -1;
+          return EINVAL;
         }
 
       if (s->value > 0)
@@ -105,6 +123,63 @@ sem_trywait (sem_t * sem)
 
       (void) pthread_mutex_unlock (&s->lock);
     }
+#else
+  else
+    {
+      LONG v;
+
+      do
+	{
+	  v = *((LONG volatile *) &s->value);
+	  if (v <= 0)
+	    {
+	      result = EAGAIN;
+	      break;
+	    }
+	}
+      while ((PTW32_INTERLOCKED_LONG) v !=
+	     PTW32_ATOMIC_COMPARE_EXCHANGE_ACQ_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->value,
+						     (PTW32_INTERLOCKED_LONG) (v - 1),
+						     (PTW32_INTERLOCKED_LONG) v));
+    }
+#endif /* NEED_SEM */
+
+  return result;
+
+}				/* sem_trywait_np */
+
+
+int
+sem_trywait (sem_t * sem)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function tries to wait on a semaphore.
+      *
+      * PARAMETERS
+      *      sem
+      *              pointer to an instance of sem_t
+      *
+      * DESCRIPTION
+      *      This function tries to wait on a semaphore. If the
+      *      semaphore value is greater than zero, it decreases
+      *      its value by one. If the semaphore value is zero, then
+      *      this function returns immediately with the error EAGAIN
+      *
+      * RESULTS
+      *              0               successfully decreased semaphore,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EAGAIN          the semaphore was already locked,
+      *              EINVAL          'sem' is not a valid semaphore,
+      *              ENOTSUP         sem_trywait is not supported,
+      *              EINTR           the function was interrupted by a signal,
+      *              EDEADLK         a deadlock condition was detected.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result = sem_trywait_np (sem);
 
   if (result != 0)
     {
@@ -45,14 +45,63 @@
 #include "semaphore.h"
 #include "implement.h"
 
-/* ignore warning "unreferenced formal parameter" */
-#if defined(_MSC_VER)
-#pragma warning( disable : 4100 )
-#endif
 
 int
 sem_unlink (const char *name)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function removes the name of a named semaphore.
+      *
+      * PARAMETERS
+      *      name
+      *              the semaphore's name, as given to sem_open
+      *
+      * DESCRIPTION
+      *      Processes that have the semaphore open can go on
+      *      using it; it is freed once all of them have closed
+      *      it. sem_open of the name creates a new semaphore.
+      *
+      * RESULTS
+      *              0               successfully unlinked,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'name' is not a valid name,
+      *              ENAMETOOLONG    'name' is too long,
+      *              ENOENT          there is no such semaphore.
+      *
+      * ------------------------------------------------------
+      */
 {
-  errno = ENOSYS;
-  return -1;
+  ptw32_sem_name_t * view;
+  HANDLE mapping;
+  LONG id;
+
+  if (NULL == (mapping = ptw32_sem_name_map (name, PTW32_FALSE, &view)))
+    {
+      return -1;
+    }
+
+  ptw32_sem_name_lock (view);
+  id = view->id;
+  view->id = 0;
+  ptw32_sem_name_unlock (view);
+
+  if (0 != id)
+    {
+      /* The name's reference */
+      ptw32_named_sem_release ((sem_t) PTW32_PSHARED_HANDLE (id));
+    }
+
+  (void) UnmapViewOfFile (view);
+  (void) CloseHandle (mapping);
+
+  if (0 == id)
+    {
+      errno = ENOENT;
+      return -1;
+    }
+
+  return 0;
+
 }				/* sem_unlink */
@@ -51,6 +51,13 @@ ptw32_sem_wait_cleanup(void * sem)
 {
   sem_t s = (sem_t) sem;
 
+#if !defined(NEED_SEM)
+  /*
+   * If we have been posted meanwhile, consume the post but cancel anyway.
+   * Otherwise indicate that we're no longer waiting.
+   */
+  (void) ptw32_sem_unwait (s);
+#else
   if (pthread_mutex_lock (&s->lock) == 0)
     {
       /*
@@ -63,20 +70,16 @@ ptw32_sem_wait_cleanup(void * sem)
       if (*((sem_t *)sem) != NULL && !(WaitForSingleObject(s->sem, 0) == WAIT_OBJECT_0))
 	{
 	  ++s->value;
-#if defined(NEED_SEM)
 	  if (s->value > 0)
 	    {
 	      s->leftToUnblock = 0;
 	    }
-#else
-	  /*
-	   * Don't release the W32 sema, it doesn't need adjustment
-	   * because it doesn't record the number of waiters.
-	   */
-#endif /* NEED_SEM */
 	}
       (void) pthread_mutex_unlock (&s->lock);
     }
+#endif /* NEED_SEM */
+
+  ptw32_sem_release (s);
 }
 
 int
@@ -119,12 +122,25 @@ sem_wait (sem_t * sem)
     {
       result = EINVAL;
     }
+  else if (PTW32_IS_PSHARED (s))
+    {
+      result = ptw32_pshared_sem_wait (s, CLOCK_REALTIME, NULL);
+    }
+#if !defined(NEED_SEM)
+  else if (s->fifo != NULL)
+    {
+      result = ptw32_sem_fifo_wait (s, CLOCK_REALTIME, NULL);
+    }
+#endif
   else
     {
+#if defined(NEED_SEM)
       if ((result = pthread_mutex_lock (&s->lock)) == 0)
+#endif
 	{
 	  int v;
 
+#if defined(NEED_SEM)
 	  /* See sem_destroy.c
 	   */
 	  if (*sem == NULL)
@@ -134,8 +150,15 @@ sem_wait (sem_t * sem)
 	      return -1;
 	    }
 
-          v = --s->value;
+          if ((v = --s->value) < 0)
+	    {
+	      /* See ptw32_sem_release.c */
+	      (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->refs);
+	    }
 	  (void) pthread_mutex_unlock (&s->lock);
+#else
+	  v = (int) ptw32_sem_decrement (s);
+#endif
 
 	  if (v < 0)
 	    {
@@ -144,32 +167,39 @@ sem_wait (sem_t * sem)
 #endif
 	      /* Must wait */
 	      pthread_cleanup_push(ptw32_sem_wait_cleanup, (void *) s);
+	      PTW32_LIBSTAT_WAIT (PTW32_LIBSTAT_WAIT_SEM);
 	      result = pthreadCancelableWait (s->sem);
 	      /* Cleanup if we're canceled or on any other error */
 	      pthread_cleanup_pop(result);
 #if defined(PTW32_CONFIG_MSVC7)
 #pragma inline_depth()
+#endif
+#if !defined(NEED_SEM)
+	      if (!result)
+		{
+		  ptw32_sem_release (s);
+		}
 #endif
 	    }
 #if defined(NEED_SEM)
 
 	  if (!result && pthread_mutex_lock (&s->lock) == 0)
 	    {
-	      if (*sem == NULL)
-	        {
-	          (void) pthread_mutex_unlock (&s->lock);
-	          errno = EINVAL;
-	          return -1;
-	        }
-
-	      if (s->leftToUnblock > 0)
+	      /* See sem_destroy.c
+	       */
+	      if (*sem != NULL && s->leftToUnblock > 0)
 		{
 		  --s->leftToUnblock;
-		  SetEvent(s->sem);
+		  PTW32_SETEVENT (s->sem);
 		}
 	      (void) pthread_mutex_unlock (&s->lock);
 	    }
 
+	  if (!result && v < 0)
+	    {
+	      ptw32_sem_release (s);
+	    }
+
 #endif /* NEED_SEM */
 
 	}
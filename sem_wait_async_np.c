@@ -0,0 +1,196 @@
+/*
+ * sem_wait_async_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "semaphore.h"
+#include "implement.h"
+
+
+#if !defined(NEED_SEM)
+static int
+ptw32_sem_async_wait (sem_t * sem, ptw32_async_waiter_t * w)
+{
+  sem_t s = *sem;
+
+  w->type = PTW32_ASYNC_SEM;
+  w->object = s;
+
+  ptw32_async_wait (w, (volatile VOID *) &s->value);
+
+  return 0;
+}
+
+static int
+ptw32_sem_async_check (sem_t * sem)
+{
+  if (sem == NULL || *sem == NULL)
+    {
+      return EINVAL;
+    }
+
+  return PTW32_IS_PSHARED (*sem) ? ENOTSUP : 0;
+}
+#endif
+
+
+int
+sem_wait_async_np (sem_t * sem,
+		   pthread_pool_np_t pool,
+		   void (PTW32_CDECL * callback) (void *),
+		   void * arg)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits on a semaphore without blocking the calling
+      *      thread: 'callback' is run on 'pool' once a unit of the
+      *      semaphore has been taken for it.
+      *
+      * PARAMETERS
+      *      sem
+      *              pointer to a process private sem_t
+      *
+      *      pool
+      *              the thread pool to run 'callback' on
+      *
+      *      callback
+      *              routine called with 'arg'
+      *
+      *      arg
+      *              passed to 'callback'
+      *
+      * DESCRIPTION
+      *      The waiter queues without a thread. It takes a unit
+      *      only while the value is positive, after any threads
+      *      blocked in sem_wait() have been posted; asynchronous
+      *      waiters are served in the order they queued. If a unit
+      *      is available it is taken at once and 'callback' is
+      *      submitted to the pool before this function returns.
+      *
+      *      Neither the semaphore nor the pool may be destroyed
+      *      while a waiter is pending.
+      *
+      * RESULTS
+      *              0               'callback' will be called,
+      *              EINVAL          an argument is invalid, or the
+      *                              pool is being destroyed,
+      *              ENOTSUP         'sem' is process shared, or the
+      *                              library was built with NEED_SEM,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if defined(NEED_SEM)
+  (void) sem;
+  (void) pool;
+  (void) callback;
+  (void) arg;
+  return ENOTSUP;
+#else
+  ptw32_async_waiter_t * w;
+  int result;
+
+  if ((result = ptw32_sem_async_check (sem)) != 0
+      || (result = ptw32_async_new (pool, callback, arg, &w)) != 0)
+    {
+      return result;
+    }
+
+  return ptw32_sem_async_wait (sem, w);
+#endif
+}				/* sem_wait_async_np */
+
+int
+sem_wait_port_np (sem_t * sem,
+		  void * port,
+		  void * key,
+		  void * overlapped)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits on a semaphore without blocking the calling
+      *      thread: once a unit has been taken, posts a
+      *      completion packet to 'port'.
+      *
+      * PARAMETERS
+      *      sem
+      *              pointer to a process private sem_t
+      *
+      *      port
+      *              the HANDLE of an I/O completion port
+      *
+      *      key, overlapped
+      *              the completion key and OVERLAPPED pointer of
+      *              the packet, which reports no bytes transferred
+      *
+      * DESCRIPTION
+      *      As sem_wait_async_np(), but the unit is handed to the
+      *      thread that dequeues the packet with
+      *      GetQueuedCompletionStatus(), so threads serving a
+      *      completion port can wait for semaphores along with
+      *      I/O. Each call waits for one unit; call again to wait
+      *      for the next. The port must stay open while the wait
+      *      is pending.
+      *
+      * RESULTS
+      *              0               a packet will be posted,
+      *              EINVAL          an argument is invalid,
+      *              ENOTSUP         'sem' is process shared, or the
+      *                              library was built with NEED_SEM,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if defined(NEED_SEM)
+  (void) sem;
+  (void) port;
+  (void) key;
+  (void) overlapped;
+  return ENOTSUP;
+#else
+  ptw32_async_waiter_t * w;
+  int result;
+
+  if ((result = ptw32_sem_async_check (sem)) != 0
+      || (result = ptw32_async_new_port ((HANDLE) port, key, overlapped, &w)) != 0)
+    {
+      return result;
+    }
+
+  return ptw32_sem_async_wait (sem, w);
+#endif
+}				/* sem_wait_port_np */
@@ -0,0 +1,155 @@
+/*
+ * -------------------------------------------------------------
+ *
+ * Module: sem_wait_multiple_np.c
+ *
+ * Purpose:
+ *	Semaphores aren't actually part of the PThreads standard.
+ *	They are defined by the POSIX Standard:
+ *
+ *		POSIX 1003.1b-1993	(POSIX.1b)
+ *
+ * -------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "semaphore.h"
+#include "implement.h"
+
+
+/*
+ * Take up to 'max' units that are available now, returning the number
+ * taken.
+ */
+static int
+ptw32_sem_take (sem_t * sem, int max)
+{
+#if !defined(NEED_SEM)
+  sem_t s = *sem;
+  LONG v;
+  LONG n;
+
+  if (PTW32_IS_PSHARED (s))
+    {
+      n = (LONG) ptw32_pshared_sem_take (s, max);
+      return (n > 0) ? (int) n : 0;
+    }
+
+  do
+    {
+      v = *((LONG volatile *) &s->value);
+      if (v <= 0)
+	{
+	  return 0;
+	}
+      n = (v < max) ? v : max;
+    }
+  while ((PTW32_INTERLOCKED_LONG) v !=
+	 PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->value,
+						  (PTW32_INTERLOCKED_LONG) (v - n),
+						  (PTW32_INTERLOCKED_LONG) v));
+
+  return (int) n;
+#else
+  int n = 0;
+
+  while (n < max && sem_trywait (sem) == 0)
+    {
+      n++;
+    }
+
+  return n;
+#endif /* NEED_SEM */
+}
+
+
+int
+sem_wait_multiple_np (sem_t * sem, int count)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function takes up to 'count' units from a
+      *      semaphore, waiting if none are available.
+      *
+      * PARAMETERS
+      *      sem
+      *              pointer to an instance of sem_t
+      *
+      *      count
+      *              maximum number of units to take, must be
+      *              greater than zero.
+      *
+      * DESCRIPTION
+      *      If the semaphore value is greater than zero, this
+      *      function decreases it by 'count' or by the value,
+      *      whichever is smaller, in a single atomic operation.
+      *      Otherwise the calling thread blocks as in sem_wait()
+      *      until it gets one unit, and then takes up to 'count' - 1
+      *      more units that are available without waiting.
+      *
+      *      This function is a cancellation point.
+      *
+      * RESULTS
+      *              > 0             number of units taken,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'sem' is not a valid semaphore
+      *                              or count is less than or equal to zero.
+      *              EINTR           the function was interrupted by a signal,
+      *              EDEADLK         a deadlock condition was detected.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int taken;
+
+  pthread_testcancel();
+
+  if (sem == NULL || *sem == NULL || count <= 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  if ((taken = ptw32_sem_take (sem, count)) > 0)
+    {
+      return taken;
+    }
+
+  if (sem_wait (sem) != 0)
+    {
+      return -1;
+    }
+
+  return 1 + ptw32_sem_take (sem, count - 1);
+
+}				/* sem_wait_multiple_np */
@@ -63,6 +63,8 @@
 #include "sem_timedwait.c"
 #include "sem_post.c"
 #include "sem_post_multiple.c"
+#include "sem_wait_multiple_np.c"
+#include "sem_wait_async_np.c"
 #include "sem_getvalue.c"
 #include "sem_open.c"
 #include "sem_close.c"
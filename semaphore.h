@@ -134,13 +134,35 @@ extern "C"
 typedef unsigned int mode_t;
 #endif
 
+/* As in pthread.h */
+#if !defined(CLOCK_REALTIME)
+#define PTW32_CLOCK_GETTIME
+typedef int clockid_t;
+#define CLOCK_REALTIME 0
+#endif
+#if !defined(CLOCK_MONOTONIC)
+#define CLOCK_MONOTONIC 1
+#endif
+
 
 typedef struct sem_t_ * sem_t;
 
+#define SEM_FAILED ((sem_t *) NULL)
+
 PTW32_DLLPORT int PTW32_CDECL sem_init (sem_t * sem,
 					int pshared,
 					unsigned int value);
 
+/* sem_init_np flags */
+#define SEM_FIFO_NP     1
+#define SEM_PRIORITY_NP 2
+
+/* As sem_init with flags, returning the error instead of setting errno */
+PTW32_DLLPORT int PTW32_CDECL sem_init_np (sem_t * sem,
+					   int pshared,
+					   unsigned int value,
+					   int flags);
+
 PTW32_DLLPORT int PTW32_CDECL sem_destroy (sem_t * sem);
 
 PTW32_DLLPORT int PTW32_CDECL sem_trywait (sem_t * sem);
@@ -150,15 +172,40 @@ PTW32_DLLPORT int PTW32_CDECL sem_wait (sem_t * sem);
 PTW32_DLLPORT int PTW32_CDECL sem_timedwait (sem_t * sem,
 					     const struct timespec * abstime);
 
+PTW32_DLLPORT int PTW32_CDECL sem_clockwait (sem_t * sem,
+					     clockid_t clock_id,
+					     const struct timespec * abstime);
+
 PTW32_DLLPORT int PTW32_CDECL sem_post (sem_t * sem);
 
 PTW32_DLLPORT int PTW32_CDECL sem_post_multiple (sem_t * sem,
 						 int count);
 
-PTW32_DLLPORT int PTW32_CDECL sem_open (const char * name,
-					int oflag,
-					mode_t mode,
-					unsigned int value);
+PTW32_DLLPORT int PTW32_CDECL sem_wait_multiple_np (sem_t * sem,
+						    int count);
+
+PTW32_DLLPORT int PTW32_CDECL sem_reltimedwait_np (sem_t * sem,
+						   const struct timespec * reltime);
+
+/* As sem_trywait and sem_post, returning the error instead of setting errno */
+PTW32_DLLPORT int PTW32_CDECL sem_trywait_np (sem_t * sem);
+
+PTW32_DLLPORT int PTW32_CDECL sem_post_np (sem_t * sem);
+
+/* Waits without a thread; callback(arg) then runs on a pthread_pool_np_t */
+PTW32_DLLPORT int PTW32_CDECL sem_wait_async_np (sem_t * sem,
+						 struct pthread_pool_np_t_ * pool,
+						 void (PTW32_CDECL * callback) (void *),
+						 void * arg);
+
+/* Waits without a thread; then posts a packet to an I/O completion port */
+PTW32_DLLPORT int PTW32_CDECL sem_wait_port_np (sem_t * sem,
+						void * port,
+						void * key,
+						void * overlapped);
+
+PTW32_DLLPORT sem_t * PTW32_CDECL sem_open (const char * name,
+					    int oflag, ...);
 
 PTW32_DLLPORT int PTW32_CDECL sem_close (sem_t * sem);
 
@@ -79,6 +79,10 @@
  *
  * The current context is saved in the target threads
  * pthread_t structure.
+ *
+ * pthread_kill() now delivers the signals raise() supports, by APC
+ * rather than by redirecting the thread's context, and honours the
+ * mask set here (see pthread_kill.c).
  */
 
 #include "pthread.h"
@@ -126,7 +130,7 @@ pthread_sigmask (int how, sigset_t const *set, sigset_t * oset)
   /* Copy the old mask before modifying it. */
   if (oset != NULL)
     {
-      memcpy (oset, &(thread.p->sigmask), sizeof (sigset_t));
+      memcpy (oset, &(((ptw32_thread_t *) thread.p)->sigmask), sizeof (sigset_t));
     }
 
   if (set != NULL)
@@ -137,7 +141,7 @@ pthread_sigmask (int how, sigset_t const *set, sigset_t * oset)
          the size of a long integer. */
 
       unsigned long *src = (unsigned long const *) set;
-      unsigned long *dest = (unsigned long *) &(thread.p->sigmask);
+      unsigned long *dest = (unsigned long *) &(((ptw32_thread_t *) thread.p)->sigmask);
 
       switch (how)
 	{
@@ -151,14 +155,18 @@ pthread_sigmask (int how, sigset_t const *set, sigset_t * oset)
 	case SIG_UNBLOCK:
 	  for (i = 0; i < (sizeof (sigset_t) / sizeof (unsigned long)); i++)
 	    {
-	      /* XOR the bitfield longword-wise. */
-	      *dest++ ^= *src++;
+	      /* Clear the bits longword-wise. */
+	      *dest++ &= ~*src++;
 	    }
+	  break;
 	case SIG_SETMASK:
 	  /* Replace the whole sigmask. */
-	  memcpy (&(thread.p->sigmask), set, sizeof (sigset_t));
+	  memcpy (&(((ptw32_thread_t *) thread.p)->sigmask), set, sizeof (sigset_t));
 	  break;
 	}
+
+      /* Raise any pthread_kill() signals this unblocked */
+      ptw32_signal_deliver ((ptw32_thread_t *) thread.p);
     }
 
   return 0;
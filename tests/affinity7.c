@@ -0,0 +1,183 @@
+/*
+ * affinity7.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2013 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test CPU sets that span processor groups.
+ *
+ * - CPU_* routines cover all CPU_SETSIZE CPUs and ignore others.
+ * - cpusetsize smaller than cpu_set_t returns the first CPUs only.
+ * - pthread_num_processors_np() counts the CPUs of every group.
+ * - threads that may run anywhere are spread over the groups.
+ *
+ */
+
+#if ! defined(WINCE)
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 8
+};
+
+typedef struct
+{
+  DWORD_PTR Mask;
+  WORD Group;
+  WORD Reserved[3];
+} group_affinity_t;
+
+static BOOL (WINAPI *getThreadGroupAffinity) (HANDLE, group_affinity_t *);
+
+static cpu_set_t processCpus;
+static int threadGroup[NUMTHREADS];
+
+void *
+mythread(void * arg)
+{
+  int i = (int)(size_t) arg;
+  cpu_set_t threadCpus;
+  group_affinity_t ga;
+
+  assert(pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &threadCpus) == 0);
+  assert(CPU_EQUAL(&threadCpus, &processCpus));
+
+  assert(getThreadGroupAffinity(GetCurrentThread(), &ga));
+  threadGroup[i] = ga.Group;
+
+  return (void*) 0;
+}
+
+int
+main()
+{
+  int cpu;
+  int i;
+  size_t first;
+  cpu_set_t mask;
+  pthread_t t[NUMTHREADS];
+
+  CPU_ZERO(&mask);
+  CPU_SET(CPU_SETSIZE - 1, &mask);
+  CPU_SET(sizeof(size_t)*8, &mask);
+  CPU_SET(-1, &mask);
+  CPU_SET(CPU_SETSIZE, &mask);
+  assert(CPU_COUNT(&mask) == 2);
+  assert(CPU_ISSET(CPU_SETSIZE - 1, &mask));
+  assert(CPU_ISSET(sizeof(size_t)*8, &mask));
+  assert(!CPU_ISSET(CPU_SETSIZE, &mask));
+  assert(!CPU_ISSET(0, &mask));
+  CPU_CLR(CPU_SETSIZE - 1, &mask);
+  assert(CPU_COUNT(&mask) == 1);
+
+  if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &processCpus) == ENOSYS)
+    {
+      printf("pthread_get/set_affinity_np API not supported for this platform: skipping test.");
+      return 0;
+    }
+
+  assert(sched_getaffinity(0, sizeof(cpu_set_t), &processCpus) == 0);
+  assert(pthread_num_processors_np() >= CPU_COUNT(&processCpus));
+
+  /*
+   * A short set gets only the first CPUs.
+   */
+  memset(&mask, 0xff, sizeof(cpu_set_t));
+  assert(sched_getaffinity(0, sizeof(size_t), &mask) == 0);
+  memcpy(&first, &mask, sizeof(size_t));
+  for (cpu = 0; cpu < (int) sizeof(size_t)*8; cpu++)
+    {
+      assert(((first >> cpu) & 1) == (size_t) (CPU_ISSET(cpu, &processCpus) ? 1 : 0));
+    }
+  for (; cpu < (int) CPU_SETSIZE; cpu++)
+    {
+      assert(CPU_ISSET(cpu, &mask));
+    }
+
+  /*
+   * The rest needs more than one processor group.
+   */
+  for (cpu = sizeof(size_t)*8; cpu < (int) CPU_SETSIZE; cpu++)
+    {
+      if (CPU_ISSET(cpu, &processCpus))
+        {
+          break;
+        }
+    }
+
+  if (!pthread_win32_test_features_np(PTW32_PROCESSOR_GROUPS)
+      || cpu == (int) CPU_SETSIZE)
+    {
+      return 0;
+    }
+
+  getThreadGroupAffinity = (BOOL (WINAPI *)(HANDLE, group_affinity_t *))
+    GetProcAddress(GetModuleHandle(TEXT("kernel32.dll")), (LPCSTR) "GetThreadGroupAffinity");
+  assert(getThreadGroupAffinity != NULL);
+
+  assert(pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask) == 0);
+  assert(CPU_EQUAL(&mask, &processCpus));
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, mythread, (void *)(size_t) i) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  for (i = 1; i < NUMTHREADS; i++)
+    {
+      if (threadGroup[i] != threadGroup[0])
+        {
+          break;
+        }
+    }
+  assert(i < NUMTHREADS);
+
+  return 0;
+}
+
+#else
+
+#include <stdio.h>
+
+int
+main()
+{
+  fprintf(stderr, "Test N/A for this target environment.\n");
+  return 0;
+}
+
+#endif
@@ -0,0 +1,123 @@
+/* 
+ * affinity8.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Soft affinity: set, read back and clear a thread's preferred CPUs.
+ *
+ * Depends on API functions:
+ *	pthread_setsoftaffinity_np()
+ *	pthread_getsoftaffinity_np()
+ *	pthread_getaffinity_np()
+ *	pthread_win32_test_features_np()
+ */
+
+#if ! defined(WINCE)
+
+#include "test.h"
+
+int
+main()
+{
+  cpu_set_t processCpus;
+  cpu_set_t mask;
+  cpu_set_t none;
+  pthread_t self = pthread_self();
+  unsigned int cpu;
+
+  CPU_ZERO(&none);
+
+  if (pthread_getaffinity_np(self, sizeof(cpu_set_t), &processCpus) == ENOSYS)
+    {
+      printf("pthread_get/set_affinity_np API not supported for this platform: skipping test.");
+      return 0;
+    }
+
+  assert(pthread_getsoftaffinity_np(self, sizeof(cpu_set_t), &mask) == 0);
+  assert(CPU_EQUAL(&mask, &none));
+  assert(pthread_getsoftaffinity_np(self, sizeof(cpu_set_t), NULL) == EFAULT);
+  assert(pthread_setsoftaffinity_np(self, sizeof(cpu_set_t), NULL) == EFAULT);
+
+  if (!pthread_win32_test_features_np(PTW32_SOFT_AFFINITY))
+    {
+      assert(pthread_setsoftaffinity_np(self, sizeof(cpu_set_t), &processCpus) == ENOSYS);
+      printf("CPU Sets not supported on this system: skipping the rest of the test.");
+      return 0;
+    }
+
+  /* Prefer the first CPU of the process */
+  for (cpu = 0; !CPU_ISSET(cpu, &processCpus); cpu++)
+    {
+    }
+  CPU_ZERO(&mask);
+  CPU_SET(cpu, &mask);
+  assert(pthread_setsoftaffinity_np(self, sizeof(cpu_set_t), &mask) == 0);
+  CPU_ZERO(&mask);
+  assert(pthread_getsoftaffinity_np(self, sizeof(cpu_set_t), &mask) == 0);
+  assert(CPU_COUNT(&mask) == 1);
+  assert(CPU_ISSET(cpu, &mask));
+
+  /* The hard affinity is unchanged */
+  assert(pthread_getaffinity_np(self, sizeof(cpu_set_t), &mask) == 0);
+  assert(CPU_EQUAL(&mask, &processCpus));
+
+  /* CPUs the process doesn't have */
+  CPU_ZERO(&mask);
+  for (cpu = 0; cpu < sizeof(cpu_set_t)*8; cpu++)
+    {
+      if (!CPU_ISSET(cpu, &processCpus))
+        {
+          CPU_SET(cpu, &mask);
+        }
+    }
+  assert(pthread_setsoftaffinity_np(self, sizeof(cpu_set_t), &mask) == EINVAL);
+
+  assert(pthread_setsoftaffinity_np(self, sizeof(cpu_set_t), &none) == 0);
+  assert(pthread_getsoftaffinity_np(self, sizeof(cpu_set_t), &mask) == 0);
+  assert(CPU_EQUAL(&mask, &none));
+
+  return 0;
+}
+
+#else
+
+#include <stdio.h>
+
+int
+main()
+{
+  fprintf(stderr, "Test N/A for this target environment.\n");
+  return 0;
+}
+
+#endif
@@ -0,0 +1,128 @@
+/* 
+ * arena1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test pthread_arena_alloc_np() and pthread_arena_reset_np().
+ *
+ * Depends on API functions:
+ *	pthread_arena_alloc_np()
+ *	pthread_arena_reset_np()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  NUMALLOCS = 1000
+};
+
+static char * ptrs[NUMALLOCS];
+
+static int
+fill(int seed)
+{
+  int i;
+
+  for (i = 0; i < NUMALLOCS; i++)
+    {
+      size_t size = (size_t) (i % 97) + 1;
+
+      ptrs[i] = (char *) pthread_arena_alloc_np(size);
+      if (ptrs[i] == NULL || ((size_t) ptrs[i] & 15) != 0)
+        return 0;
+      memset(ptrs[i], (i + seed) & 0xff, size);
+    }
+
+  for (i = 0; i < NUMALLOCS; i++)
+    {
+      size_t size = (size_t) (i % 97) + 1;
+      size_t j;
+
+      for (j = 0; j < size; j++)
+        if (ptrs[i][j] != (char) ((i + seed) & 0xff))
+          return 0;
+    }
+
+  return 1;
+}
+
+static void *
+mythread(void * arg)
+{
+  char * big;
+
+  if (!fill(1))
+    return (void *) 1;
+
+  big = (char *) pthread_arena_alloc_np(1024 * 1024);
+  if (big == NULL)
+    return (void *) 2;
+  memset(big, 0x5a, 1024 * 1024);
+
+  /* Left for the library to free when the thread is joined. */
+  return (void *) (size_t) (pthread_arena_alloc_np(0) == NULL ? 3 : 0);
+}
+
+int
+main()
+{
+  pthread_t t;
+  void * result = (void *) 99;
+  char * first;
+  int i;
+
+  assert(fill(0));
+
+  /* Reset keeps the newest block, so nothing allocated afterwards
+   * needs the heap until it is full again. */
+  assert(pthread_arena_reset_np() == 0);
+  first = (char *) pthread_arena_alloc_np(16);
+  assert(first != NULL);
+  assert(pthread_arena_reset_np() == 0);
+  assert((char *) pthread_arena_alloc_np(16) == first);
+  assert(pthread_arena_reset_np() == 0);
+
+  for (i = 0; i < 3; i++)
+    {
+      assert(pthread_create(&t, NULL, mythread, NULL) == 0);
+      assert(pthread_join(t, &result) == 0);
+      assert(result == (void *) 0);
+    }
+
+  assert(fill(2));
+  assert(pthread_arena_reset_np() == 0);
+
+  return 0;
+}
@@ -0,0 +1,212 @@
+/* 
+ * array1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Arrays of mutexes, condition variables and spin locks made with the
+ * *_init_array_np functions work as single objects do, lie in one
+ * block at the object alignment, and are destroyed as a whole, a busy
+ * element leaving the array intact for another try.
+ *
+ * Depends on API functions:
+ *	pthread_mutex_init_array_np()
+ *	pthread_mutex_destroy_array_np()
+ *	pthread_cond_init_array_np()
+ *	pthread_cond_destroy_array_np()
+ *	pthread_spin_init_array_np()
+ *	pthread_spin_destroy_array_np()
+ *	pthread_setobjectalign_np()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4,
+  NUMLOCKS = 8,
+  ITERATIONS = 10000
+};
+
+static pthread_mutex_t mutexes[NUMLOCKS];
+static pthread_spinlock_t spins[NUMLOCKS];
+static pthread_cond_t conds[NUMLOCKS];
+static long mutexCount[NUMLOCKS];
+static long spinCount[NUMLOCKS];
+
+void *
+worker(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      int j = (i + (int) (size_t) arg) % NUMLOCKS;
+
+      assert(pthread_mutex_lock(&mutexes[j]) == 0);
+      mutexCount[j]++;
+      assert(pthread_mutex_unlock(&mutexes[j]) == 0);
+
+      assert(pthread_spin_lock(&spins[j]) == 0);
+      spinCount[j]++;
+      assert(pthread_spin_unlock(&spins[j]) == 0);
+    }
+
+  return NULL;
+}
+
+void *
+signaller(void * arg)
+{
+  int j = (int) (size_t) arg;
+
+  assert(pthread_mutex_lock(&mutexes[j]) == 0);
+  mutexCount[j] = -1;
+  assert(pthread_cond_signal(&conds[j]) == 0);
+  assert(pthread_mutex_unlock(&mutexes[j]) == 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  pthread_mutexattr_t ma;
+  pthread_condattr_t ca;
+  int i;
+
+  assert(pthread_mutex_init_array_np(NULL, NUMLOCKS, NULL) == EINVAL);
+  assert(pthread_mutex_init_array_np(mutexes, 0, NULL) == EINVAL);
+  assert(pthread_cond_init_array_np(NULL, NUMLOCKS, NULL) == EINVAL);
+  assert(pthread_spin_init_array_np(spins, 0, PTHREAD_PROCESS_PRIVATE,
+				    PTHREAD_SPINLOCK_DEFAULT_NP) == EINVAL);
+  assert(pthread_spin_init_array_np(spins, NUMLOCKS, PTHREAD_PROCESS_SHARED,
+				    PTHREAD_SPINLOCK_DEFAULT_NP) == ENOSYS);
+
+  assert(pthread_spin_init_array_np(spins, NUMLOCKS, PTHREAD_PROCESS_PRIVATE,
+				    -1) == EINVAL);
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_setpshared(&ma, PTHREAD_PROCESS_SHARED) == 0);
+  assert(pthread_mutex_init_array_np(mutexes, NUMLOCKS, &ma) == EINVAL);
+  assert(pthread_mutexattr_setpshared(&ma, PTHREAD_PROCESS_PRIVATE) == 0);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_ERRORCHECK) == 0);
+
+  assert(pthread_condattr_init(&ca) == 0);
+  assert(pthread_condattr_setpshared(&ca, PTHREAD_PROCESS_SHARED) == 0);
+  assert(pthread_cond_init_array_np(conds, NUMLOCKS, &ca) == EINVAL);
+  assert(pthread_condattr_destroy(&ca) == 0);
+
+  assert(pthread_setobjectalign_np(PTHREAD_OBJECT_ALIGN_CACHELINE_NP) == 0);
+  assert(pthread_mutex_init_array_np(mutexes, NUMLOCKS, &ma) == 0);
+  assert(pthread_cond_init_array_np(conds, NUMLOCKS, NULL) == 0);
+  assert(pthread_spin_init_array_np(spins, NUMLOCKS, PTHREAD_PROCESS_PRIVATE,
+				    PTHREAD_SPINLOCK_TICKET_NP) == 0);
+  assert(pthread_setobjectalign_np(PTHREAD_OBJECT_ALIGN_DEFAULT_NP) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  /* One block, one element per cache line, in order */
+  for (i = 0; i < NUMLOCKS; i++)
+    {
+      assert(((size_t) mutexes[i] & 63) == 0);
+      assert(((size_t) conds[i] & 63) == 0);
+      assert(((size_t) spins[i] & 63) == 0);
+      if (i > 0)
+	{
+	  assert((char *) mutexes[i] > (char *) mutexes[i - 1]);
+	  assert((size_t) ((char *) mutexes[i] - (char *) mutexes[0])
+		 == i * (size_t) ((char *) mutexes[1] - (char *) mutexes[0]));
+	  assert((size_t) ((char *) spins[i] - (char *) spins[0])
+		 == i * (size_t) ((char *) spins[1] - (char *) spins[0]));
+	}
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, (void *) (size_t) i) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  for (i = 0; i < NUMLOCKS; i++)
+    {
+      assert(mutexCount[i] == NUMTHREADS * ITERATIONS / NUMLOCKS);
+      assert(spinCount[i] == NUMTHREADS * ITERATIONS / NUMLOCKS);
+    }
+
+  /* The elements keep their attributes */
+  assert(pthread_mutex_lock(&mutexes[3]) == 0);
+  assert(pthread_mutex_lock(&mutexes[3]) == EDEADLK);
+
+  /* A busy element stops the destroy and leaves the rest usable */
+  assert(pthread_mutex_destroy_array_np(mutexes, NUMLOCKS) == EBUSY);
+  assert(mutexes[0] != NULL);
+  assert(mutexes[3] != NULL);
+  assert(pthread_mutex_unlock(&mutexes[3]) == 0);
+
+  assert(pthread_spin_lock(&spins[5]) == 0);
+  assert(pthread_spin_destroy_array_np(spins, NUMLOCKS) == EBUSY);
+  assert(pthread_spin_unlock(&spins[5]) == 0);
+
+  /* Condition variables in the array wait and wake as usual */
+  assert(pthread_mutex_lock(&mutexes[2]) == 0);
+  assert(pthread_create(&t[0], NULL, signaller, (void *) (size_t) 2) == 0);
+  while (mutexCount[2] != -1)
+    {
+      assert(pthread_cond_wait(&conds[2], &mutexes[2]) == 0);
+    }
+  assert(pthread_mutex_unlock(&mutexes[2]) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+
+  assert(pthread_mutex_destroy_array_np(mutexes, NUMLOCKS) == 0);
+  assert(pthread_cond_destroy_array_np(conds, NUMLOCKS) == 0);
+  assert(pthread_spin_destroy_array_np(spins, NUMLOCKS) == 0);
+
+  for (i = 0; i < NUMLOCKS; i++)
+    {
+      assert(mutexes[i] == NULL);
+      assert(conds[i] == NULL);
+      assert(spins[i] == NULL);
+    }
+
+  assert(pthread_mutex_destroy_array_np(mutexes, NUMLOCKS) == EINVAL);
+
+  /* Packed arrays */
+  assert(pthread_mutex_init_array_np(mutexes, NUMLOCKS, NULL) == 0);
+  assert(pthread_spin_init_array_np(spins, NUMLOCKS, PTHREAD_PROCESS_PRIVATE,
+				    PTHREAD_SPINLOCK_DEFAULT_NP) == 0);
+  assert(pthread_mutex_destroy_array_np(mutexes, NUMLOCKS) == 0);
+  assert(pthread_spin_destroy_array_np(spins, NUMLOCKS) == 0);
+
+  return 0;
+}
@@ -0,0 +1,191 @@
+/*
+ * File: async1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis: Verify pthread_mutex_lock_async_np(),
+ * - pthread_cond_wait_async_np() and sem_wait_async_np()
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - 
+ *
+ * Features Tested:
+ * - 
+ *
+ * Cases Tested:
+ * - callbacks run on the pool only once the wait is over.
+ * - a thread blocked on the mutex and an asynchronous waiter both
+ *   get it.
+ * - invalid mutexes and pools are rejected.
+ *
+ * Description:
+ * - 
+ *
+ * Environment:
+ * - 
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - 
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+
+#include "test.h"
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static sem_t sem;
+static sem_t done;
+static int ran;
+static int predicate;
+
+static void
+lockedCallback(void * arg)
+{
+  ran++;
+  assert(pthread_mutex_trylock(&mutex) == EBUSY);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(sem_post(&done) == 0);
+}
+
+static void
+condCallback(void * arg)
+{
+  ran++;
+  assert(predicate == 1);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(sem_post(&done) == 0);
+}
+
+static void
+semCallback(void * arg)
+{
+  ran++;
+  assert(sem_post(&done) == 0);
+}
+
+static void *
+blockedLocker(void * arg)
+{
+  assert(pthread_mutex_lock(&mutex) == 0);
+  ran++;
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_pool_np_t pool;
+  pthread_mutex_t rmutex;
+  pthread_mutexattr_t ma;
+  pthread_t t;
+
+  assert(pthread_pool_create_np(&pool, NULL, 2) == 0);
+  assert(sem_init(&sem, 0, 0) == 0);
+  assert(sem_init(&done, 0, 0) == 0);
+
+  /* Free mutex: locked at once, callback on the pool */
+  assert(pthread_mutex_lock_async_np(&mutex, pool, lockedCallback, NULL) == 0);
+  assert(sem_wait(&done) == 0);
+  assert(ran == 1);
+
+  /* Held mutex, with a blocked thread waiting too */
+  ran = 0;
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_create(&t, NULL, blockedLocker, NULL) == 0);
+  Sleep(100);
+  assert(pthread_mutex_lock_async_np(&mutex, pool, lockedCallback, NULL) == 0);
+  Sleep(100);
+  assert(ran == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(sem_wait(&done) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(ran == 2);
+
+  /* Condition variable: runs once signalled and the mutex is free */
+  ran = 0;
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_cond_wait_async_np(&cond, &mutex, pool, condCallback, NULL) == 0);
+  assert(pthread_mutex_lock(&mutex) == 0);
+  predicate = 1;
+  assert(pthread_cond_signal(&cond) == 0);
+  Sleep(100);
+  assert(ran == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(sem_wait(&done) == 0);
+  assert(ran == 1);
+
+  /* Semaphore */
+  ran = 0;
+  assert(sem_wait_async_np(&sem, pool, semCallback, NULL) == 0);
+  Sleep(100);
+  assert(ran == 0);
+  assert(sem_post(&sem) == 0);
+  assert(sem_wait(&done) == 0);
+  assert(ran == 1);
+  assert(sem_trywait_np(&sem) == EAGAIN);
+
+  /* Only plain normal mutexes, and a pool is needed */
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_RECURSIVE) == 0);
+  assert(pthread_mutex_init(&rmutex, &ma) == 0);
+  assert(pthread_mutex_lock_async_np(&rmutex, pool, lockedCallback, NULL) == EINVAL);
+  assert(pthread_mutex_destroy(&rmutex) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+  assert(pthread_mutex_lock_async_np(&mutex, NULL, lockedCallback, NULL) == EINVAL);
+  assert(sem_wait_async_np(&sem, pool, NULL, NULL) == EINVAL);
+
+  assert(pthread_pool_destroy_np(&pool) == 0);
+  assert(sem_destroy(&sem) == 0);
+  assert(sem_destroy(&done) == 0);
+
+  return 0;
+}
@@ -0,0 +1,142 @@
+/* 
+ * attrinit1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * --------------------------------------------------------------------------
+ * Attribute objects set to their PTHREAD_*ATTR_INITIALIZER_NP values
+ * read as the defaults, can be passed to the object init functions and
+ * pthread_create, become ordinary objects when first changed, and can
+ * be destroyed either way.
+ *
+ * Depends on API functions:
+ *	pthread_attr_getdetachstate()
+ *	pthread_mutexattr_gettype()
+ *	pthread_mutexattr_settype()
+ *	pthread_condattr_getclock()
+ *	pthread_rwlockattr_getkind_np()
+ *	pthread_barrierattr_getpshared()
+ */
+
+#include "test.h"
+
+static int washere = 0;
+
+void *
+func(void * arg)
+{
+  washere = 1;
+  return arg;
+}
+
+int
+main()
+{
+  pthread_attr_t attr = PTHREAD_ATTR_INITIALIZER_NP;
+  pthread_mutexattr_t ma = PTHREAD_MUTEXATTR_INITIALIZER_NP;
+  pthread_condattr_t ca = PTHREAD_CONDATTR_INITIALIZER_NP;
+  pthread_rwlockattr_t rwa = PTHREAD_RWLOCKATTR_INITIALIZER_NP;
+  pthread_barrierattr_t ba = PTHREAD_BARRIERATTR_INITIALIZER_NP;
+  pthread_mutex_t mx;
+  pthread_cond_t cv;
+  pthread_rwlock_t rwl;
+  pthread_barrier_t b;
+  pthread_t t;
+  size_t stacksize = 1;
+  clockid_t clock = CLOCK_MONOTONIC;
+  void * result = NULL;
+  int value;
+
+  /* The defaults, read without anything being allocated */
+  assert(pthread_attr_getdetachstate(&attr, &value) == 0);
+  assert(value == PTHREAD_CREATE_JOINABLE);
+  assert(pthread_attr_getstacksize(&attr, &stacksize) == 0);
+  assert(stacksize == 0);
+  assert(pthread_mutexattr_gettype(&ma, &value) == 0);
+  assert(value == PTHREAD_MUTEX_DEFAULT);
+  assert(pthread_mutexattr_getpshared(&ma, &value) == 0);
+  assert(value == PTHREAD_PROCESS_PRIVATE);
+  assert(pthread_condattr_getclock(&ca, &clock) == 0);
+  assert(clock == CLOCK_REALTIME);
+  assert(pthread_rwlockattr_getkind_np(&rwa, &value) == 0);
+  assert(value == PTHREAD_RWLOCK_DEFAULT_NP);
+  assert(pthread_barrierattr_getpshared(&ba, &value) == 0);
+  assert(value == PTHREAD_PROCESS_PRIVATE);
+  assert(attr == PTHREAD_ATTR_INITIALIZER_NP);
+  assert(ma == PTHREAD_MUTEXATTR_INITIALIZER_NP);
+
+  assert(pthread_mutex_init(&mx, &ma) == 0);
+  assert(pthread_cond_init(&cv, &ca) == 0);
+  assert(pthread_rwlock_init(&rwl, &rwa) == 0);
+  assert(pthread_barrier_init(&b, &ba, 2) == 0);
+  assert(pthread_create(&t, &attr, func, (void *) &washere) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert(result == (void *) &washere);
+  assert(washere == 1);
+
+  assert(pthread_rwlock_wrlock(&rwl) == 0);
+  assert(pthread_rwlock_unlock(&rwl) == 0);
+  assert(pthread_mutex_lock(&mx) == 0);
+  assert(pthread_mutex_unlock(&mx) == 0);
+  assert(pthread_barrier_destroy(&b) == 0);
+  assert(pthread_rwlock_destroy(&rwl) == 0);
+  assert(pthread_cond_destroy(&cv) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  /* Changing one gives it a real object */
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_ERRORCHECK) == 0);
+  assert(ma != PTHREAD_MUTEXATTR_INITIALIZER_NP);
+  assert(pthread_mutexattr_gettype(&ma, &value) == 0);
+  assert(value == PTHREAD_MUTEX_ERRORCHECK);
+  assert(pthread_mutex_init(&mx, &ma) == 0);
+  assert(pthread_mutex_lock(&mx) == 0);
+  assert(pthread_mutex_lock(&mx) == EDEADLK);
+  assert(pthread_mutex_unlock(&mx) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  ma = PTHREAD_MUTEXATTR_INITIALIZER_NP;
+  assert(pthread_mutexattr_settype(&ma, -1) == EINVAL);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  assert(pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) == 0);
+  assert(attr != PTHREAD_ATTR_INITIALIZER_NP);
+  assert(pthread_attr_getdetachstate(&attr, &value) == 0);
+  assert(value == PTHREAD_CREATE_DETACHED);
+
+  /* Either kind can be destroyed */
+  assert(pthread_attr_destroy(&attr) == 0);
+  assert(pthread_condattr_destroy(&ca) == 0);
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+  assert(pthread_barrierattr_destroy(&ba) == 0);
+
+  return 0;
+}
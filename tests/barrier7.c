@@ -0,0 +1,129 @@
+/*
+ * barrier7.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Combining tree barriers: repeat the barrier5 test with the tree kind,
+ * at heights that need one, two and three levels of tree nodes, and
+ * with more threads than the barrier height.
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 24,
+  BARRIERMULTIPLE = 200
+};
+
+static const int heights[] = { 1, 2, 4, 5, 16, 17, 24 };
+
+pthread_barrier_t barrier = NULL;
+LONG totalThreadCrossings;
+
+void *
+func(void * crossings)
+{
+  int result;
+  int serialThreads = 0;
+
+  while ((LONG)(size_t)crossings >= (LONG)InterlockedIncrement((LPLONG)&totalThreadCrossings))
+    {
+      result = pthread_barrier_wait(&barrier);
+
+      if (result == PTHREAD_BARRIER_SERIAL_THREAD)
+        {
+          serialThreads++;
+        }
+      else if (result != 0)
+        {
+          printf("Barrier failed: result = %s\n", error_string[result]);
+          fflush(stdout);
+          return NULL;
+        }
+    }
+
+  return (void*)(size_t)serialThreads;
+}
+
+int
+main()
+{
+  int i, j, k;
+  int kind = -1;
+  void* result;
+  int serialThreadsTotal;
+  LONG Crossings;
+  pthread_t t[NUMTHREADS + 1];
+  pthread_barrierattr_t ba;
+
+  assert(pthread_barrierattr_init(&ba) == 0);
+  assert(pthread_barrierattr_getkind_np(&ba, &kind) == 0);
+  assert(kind == PTHREAD_BARRIER_DEFAULT_NP);
+  assert(pthread_barrierattr_setkind_np(&ba, PTHREAD_BARRIER_TREE_NP + 1) == EINVAL);
+  assert(pthread_barrierattr_setkind_np(&ba, PTHREAD_BARRIER_TREE_NP) == 0);
+  assert(pthread_barrierattr_getkind_np(&ba, &kind) == 0);
+  assert(kind == PTHREAD_BARRIER_TREE_NP);
+
+  for (k = 0; k < (int)(sizeof(heights) / sizeof(heights[0])); k++)
+    {
+      int height = heights[k];
+
+      for (j = height; j <= NUMTHREADS && j <= height + 3; j++)
+        {
+          totalThreadCrossings = 0;
+          Crossings = height * BARRIERMULTIPLE;
+
+          assert(pthread_barrier_init(&barrier, &ba, height) == 0);
+
+          for (i = 1; i <= j; i++)
+            {
+              assert(pthread_create(&t[i], NULL, func, (void *)(size_t)Crossings) == 0);
+            }
+
+          serialThreadsTotal = 0;
+          for (i = 1; i <= j; i++)
+            {
+              assert(pthread_join(t[i], &result) == 0);
+              serialThreadsTotal += (int)(size_t)result;
+            }
+
+          assert(serialThreadsTotal == BARRIERMULTIPLE);
+
+          assert(pthread_barrier_destroy(&barrier) == 0);
+        }
+    }
+
+  assert(pthread_barrierattr_destroy(&ba) == 0);
+
+  return 0;
+}
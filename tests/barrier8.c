@@ -0,0 +1,156 @@
+/*
+ * barrier8.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Split-phase barrier waits: threads arrive, do work, then wait with
+ * their token, mixed with threads calling pthread_barrier_wait(), at
+ * default and combining tree barriers. No thread leaves a cycle
+ * before every thread has arrived at it.
+ *
+ * Depends on API functions:
+ *	pthread_barrier_init()
+ *	pthread_barrier_destroy()
+ *	pthread_barrier_wait()
+ *	pthread_barrier_arrive_np()
+ *	pthread_barrier_wait_token_np()
+ *	pthread_barrierattr_setkind_np()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 9,
+  ROUNDS = 300
+};
+
+pthread_barrier_t barrier = NULL;
+static volatile LONG arrived[ROUNDS];
+
+void *
+func(void * arg)
+{
+  int id = (int)(size_t) arg;
+  int serialThreads = 0;
+  unsigned int token;
+  int result;
+  int i;
+
+  for (i = 0; i < ROUNDS; i++)
+    {
+      InterlockedIncrement((LPLONG) &arrived[i]);
+
+      if ((id + i) % 3 == 0)
+        {
+          result = pthread_barrier_wait(&barrier);
+        }
+      else
+        {
+          result = pthread_barrier_arrive_np(&barrier, &token);
+          assert(token == (unsigned int) i);
+          /* Overlapped work would go here */
+          assert(pthread_barrier_wait_token_np(&barrier, token) == 0);
+        }
+
+      assert(result == 0 || result == PTHREAD_BARRIER_SERIAL_THREAD);
+      if (result == PTHREAD_BARRIER_SERIAL_THREAD)
+        {
+          serialThreads++;
+        }
+
+      assert(arrived[i] == NUMTHREADS);
+    }
+
+  return (void*)(size_t)serialThreads;
+}
+
+int
+main()
+{
+  int i, k;
+  void* result;
+  int serialThreadsTotal;
+  unsigned int token;
+  pthread_t t[NUMTHREADS];
+  pthread_barrierattr_t ba;
+  static const int kinds[] = { PTHREAD_BARRIER_DEFAULT_NP, PTHREAD_BARRIER_TREE_NP };
+
+  assert(pthread_barrier_arrive_np(NULL, &token) == EINVAL);
+  assert(pthread_barrier_wait_token_np(NULL, 0) == EINVAL);
+
+  assert(pthread_barrierattr_init(&ba) == 0);
+
+  for (k = 0; k < 2; k++)
+    {
+      assert(pthread_barrierattr_setkind_np(&ba, kinds[k]) == 0);
+
+      /* Height 1: each arrival completes a cycle */
+      assert(pthread_barrier_init(&barrier, &ba, 1) == 0);
+      assert(pthread_barrier_arrive_np(&barrier, NULL) == EINVAL);
+      assert(pthread_barrier_arrive_np(&barrier, &token) == PTHREAD_BARRIER_SERIAL_THREAD);
+      assert(pthread_barrier_wait_token_np(&barrier, token) == 0);
+      assert(pthread_barrier_wait(&barrier) == PTHREAD_BARRIER_SERIAL_THREAD);
+      assert(pthread_barrier_arrive_np(&barrier, &token) == PTHREAD_BARRIER_SERIAL_THREAD);
+      assert(token == 2);
+      assert(pthread_barrier_wait_token_np(&barrier, token) == 0);
+      assert(pthread_barrier_destroy(&barrier) == 0);
+
+      for (i = 0; i < ROUNDS; i++)
+        {
+          arrived[i] = 0;
+        }
+
+      assert(pthread_barrier_init(&barrier, &ba, NUMTHREADS) == 0);
+
+      for (i = 0; i < NUMTHREADS; i++)
+        {
+          assert(pthread_create(&t[i], NULL, func, (void *)(size_t) i) == 0);
+        }
+
+      serialThreadsTotal = 0;
+      for (i = 0; i < NUMTHREADS; i++)
+        {
+          assert(pthread_join(t[i], &result) == 0);
+          serialThreadsTotal += (int)(size_t)result;
+        }
+
+      assert(serialThreadsTotal == ROUNDS);
+
+      assert(pthread_barrier_destroy(&barrier) == 0);
+    }
+
+  assert(pthread_barrierattr_destroy(&ba) == 0);
+
+  return 0;
+}
@@ -39,6 +39,8 @@
 #include "semaphore.h"
 #include <windows.h>
 #include <stdio.h>
+#include <assert.h>
+#include <math.h>
 
 #ifdef __GNUC__
 #include <stdlib.h>
@@ -361,3 +363,277 @@ old_mutex_destroy(old_mutex_t *mutex)
 }
 
 /****************************************************************************************/
+
+/****************************************************************************************/
+
+static volatile LONG bench_ready = 0;
+static volatile LONG bench_go = 0;
+static LARGE_INTEGER bench_frequency;
+
+__int64 benchRepeatTicks[BENCH_REPEATS];
+static double bench_overhead_ns = 0.0;	/* Per loop iteration */
+long benchOps = BENCH_OPS;
+
+__int64
+bench_now(void)
+{
+  LARGE_INTEGER count;
+
+  QueryPerformanceCounter(&count);
+
+  return count.QuadPart;
+}
+
+static double
+bench_ns(__int64 ticks)
+{
+  if (bench_frequency.QuadPart == 0)
+    {
+      QueryPerformanceFrequency(&bench_frequency);
+    }
+
+  return (double) ticks * 1E9 / (double) bench_frequency.QuadPart;
+}
+
+void
+bench_work(int n)
+{
+  volatile int i;
+
+  for (i = 0; i < n; i++)
+    {
+    }
+}
+
+static int
+bench_compare_ns(const void * a, const void * b)
+{
+  double x = *(const double *) a;
+  double y = *(const double *) b;
+
+  return (x < y) ? -1 : (x > y);
+}
+
+/*
+ * The mean time per loop iteration of the last TESTSTART ... TESTSTOP
+ * repetitions without outliers, with the half width of its 95%
+ * confidence interval.
+ */
+static int
+bench_repeats_ns(long iterations, double * mean, double * ci)
+{
+  /* Student's t for 1 to 9 degrees of freedom */
+  static const double t95[] = { 0.0, 12.706, 4.303, 3.182, 2.776,
+                                2.571, 2.447, 2.365, 2.306, 2.262 };
+  double ns[BENCH_REPEATS];
+  double sorted[BENCH_REPEATS];
+  double median, mad, sum = 0.0, sq = 0.0;
+  long perRepeat = iterations / BENCH_REPEATS;
+  int r, n = 0;
+
+  for (r = 0; r < BENCH_REPEATS; r++)
+    {
+      ns[r] = sorted[r] = bench_ns(benchRepeatTicks[r]) / perRepeat;
+    }
+
+  qsort(sorted, BENCH_REPEATS, sizeof(double), bench_compare_ns);
+  median = sorted[BENCH_REPEATS / 2];
+
+  for (r = 0; r < BENCH_REPEATS; r++)
+    {
+      sorted[r] = fabs(ns[r] - median);
+    }
+
+  qsort(sorted, BENCH_REPEATS, sizeof(double), bench_compare_ns);
+  mad = sorted[BENCH_REPEATS / 2];
+
+  for (r = 0; r < BENCH_REPEATS; r++)
+    {
+      if (fabs(ns[r] - median) <= BENCH_OUTLIER_MADS * mad)
+        {
+          sum += ns[r];
+          sq += ns[r] * ns[r];
+          n++;
+        }
+    }
+
+  *mean = sum / n;
+  *ci = 0.0;
+
+  if (n > 1)
+    {
+      double var = (sq - sum * sum / n) / (n - 1);
+
+      *ci = (n - 1 < (int) (sizeof(t95)/sizeof(t95[0])) ? t95[n - 1] : 1.96)
+            * sqrt(var > 0.0 ? var : 0.0) / sqrt((double) n);
+    }
+
+  return n;
+}
+
+void
+bench_columns(void)
+{
+  printf( "%-45s %12s %12s %6s\n",
+	    "Test",
+	    "ns/op",
+	    "95% CI +/-",
+	    "reps");
+}
+
+void
+bench_overhead(long iterations)
+{
+  double ci;
+
+  (void) bench_repeats_ns(iterations, &bench_overhead_ns, &ci);
+}
+
+void
+bench_report(const char * name, long iterations, int opsPerIteration)
+{
+  double mean, ci;
+  int n = bench_repeats_ns(iterations, &mean, &ci);
+
+  printf( "%-45s %12.3f %12.3f %6d\n",
+	    name,
+          (mean - bench_overhead_ns) / opsPerIteration,
+          ci / opsPerIteration,
+          n);
+}
+
+int
+bench_max_threads(void)
+{
+  int cpus = pthread_num_processors_np();
+
+  /* At least two, so that there is contention to measure */
+  return (cpus < 2 ? 2 : cpus);
+}
+
+int
+bench_next_threads(int n)
+{
+  int max = bench_max_threads();
+
+  /* 1, 2, 4, ... and the number of processors */
+  return (n < max && n * 2 > max) ? max : n * 2;
+}
+
+void
+bench_header(const char * title)
+{
+  printf("# %s\n", title);
+  printf("# build %s %s, %d processors, %ld operations per thread\n",
+#if defined(_MSC_VER)
+         "VC",
+#elif defined(__GNUC__)
+         "GC",
+#else
+         "CC",
+#endif
+#if defined(__CLEANUP_CXX)
+         "C++ cleanup",
+#elif defined(__CLEANUP_SEH)
+         "SEH cleanup",
+#else
+         "C cleanup",
+#endif
+         pthread_num_processors_np(), benchOps);
+  printf("# %-14s %-12s %7s %5s %5s %12s %9s %9s %9s\n",
+         "bench", "variant", "threads", "cs", "read%",
+         "ops/sec", "p50", "p99", "p999");
+}
+
+void
+bench_start(bench_thread_t * t)
+{
+  (void) InterlockedIncrement((LPLONG) &bench_ready);
+
+  while (!bench_go)
+    {
+      sched_yield();
+    }
+}
+
+static int
+bench_compare(const void * a, const void * b)
+{
+  __int64 x = *(const __int64 *) a;
+  __int64 y = *(const __int64 *) b;
+
+  return (x < y) ? -1 : (x > y);
+}
+
+void
+bench_run(const char * bench, const char * variant,
+          int threads, int cs, int readPercent,
+          void * (*routine)(void *), void * arg)
+{
+  pthread_t * tid = (pthread_t *) calloc(threads, sizeof(pthread_t));
+  bench_thread_t * t = (bench_thread_t *) calloc(threads, sizeof(bench_thread_t));
+  __int64 * samples = (__int64 *) malloc(threads * benchOps * sizeof(__int64));
+  __int64 start;
+  __int64 elapsed;
+  long i, n;
+
+  assert(tid != NULL && t != NULL && samples != NULL);
+
+  for (i = 0; i < threads * benchOps; i++)
+    {
+      samples[i] = -1;
+    }
+
+  bench_ready = 0;
+  bench_go = 0;
+
+  for (i = 0; i < threads; i++)
+    {
+      t[i].index = (int) i;
+      t[i].threads = threads;
+      t[i].cs = cs;
+      t[i].readPercent = readPercent;
+      t[i].ops = benchOps;
+      t[i].samples = &samples[i * benchOps];
+      t[i].arg = arg;
+      assert(pthread_create(&tid[i], NULL, routine, &t[i]) == 0);
+    }
+
+  while (bench_ready < threads)
+    {
+      Sleep(1);
+    }
+
+  start = bench_now();
+  bench_go = 1;
+
+  for (i = 0; i < threads; i++)
+    {
+      assert(pthread_join(tid[i], NULL) == 0);
+    }
+
+  elapsed = bench_now() - start;
+
+  /* Drop the samples not taken and sort the rest */
+  for (i = 0, n = 0; i < threads * benchOps; i++)
+    {
+      if (samples[i] >= 0)
+        {
+          samples[n++] = samples[i];
+        }
+    }
+
+  qsort(samples, n, sizeof(__int64), bench_compare);
+
+  printf("  %-14s %-12s %7d %5d %5d %12.0f %9.0f %9.0f %9.0f\n",
+         bench, variant, threads, cs, readPercent,
+         (double) threads * benchOps * 1E9 / bench_ns(elapsed),
+         n > 0 ? bench_ns(samples[n * 50 / 100]) : 0.0,
+         n > 0 ? bench_ns(samples[n * 99 / 100]) : 0.0,
+         n > 0 ? bench_ns(samples[n * 999 / 1000]) : 0.0);
+  fflush(stdout);
+
+  free(samples);
+  free(t);
+  free(tid);
+}
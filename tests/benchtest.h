@@ -68,3 +68,76 @@ int old_mutex_unlock(old_mutex_t *mutex);
 int old_mutex_trylock(old_mutex_t *mutex);
 int old_mutex_destroy(old_mutex_t *mutex);
 /****************************************************************************************/
+
+/*
+ * Timing of the single threaded benchmarks (benchtest1 to benchtest5).
+ *
+ * TESTSTART ... TESTSTOP runs the statements between them
+ * ITERATIONS / BENCH_REPEATS times in each of BENCH_REPEATS + 1
+ * repetitions, timed with QueryPerformanceCounter. The first repetition
+ * only warms up the caches and branch predictors. bench_report() then
+ * drops repetitions more than BENCH_OUTLIER_MADS median absolute
+ * deviations from the median, typically those the thread was
+ * preempted in, and prints the mean time per operation of the rest,
+ * less the loop overhead measured by bench_overhead(), with a 95%
+ * confidence interval.
+ *
+ * Dummy use of j, otherwise the loop may be removed by the optimiser
+ * when doing the overhead timing with an empty loop.
+ */
+#define BENCH_REPEATS		10
+#define BENCH_OUTLIER_MADS	3
+
+extern __int64 benchRepeatTicks[BENCH_REPEATS];
+
+#define TESTSTART \
+  { int r_; for (r_ = -1; r_ < BENCH_REPEATS; r_++) { \
+    int i, j = 0, k = 0; __int64 t_ = bench_now(); \
+    for (i = 0; i < ITERATIONS / BENCH_REPEATS; i++) { j++;
+
+#define TESTSTOP \
+  }; if (r_ >= 0) benchRepeatTicks[r_] = bench_now() - t_; if (j + k == i) j++; } }
+
+void bench_columns(void);
+void bench_overhead(long iterations);
+void bench_report(const char * name, long iterations, int opsPerIteration);
+/****************************************************************************************/
+
+/*
+ * Contention benchmarks (benchtest6 onwards) run a routine in a number
+ * of threads released together and print one line per run:
+ *
+ *   bench variant threads cs read% ops/sec p50 p99 p999
+ *
+ * cs is the work done while holding the object (and again outside it),
+ * in bench_work() loop iterations, and latencies are in nanoseconds.
+ * The lines are meant to be compared between library builds with diff
+ * or a spreadsheet.
+ */
+#define BENCH_OPS	20000L		/* Per thread and run */
+
+/* The ops bench_run() gives each thread, BENCH_OPS unless lowered */
+extern long benchOps;
+
+typedef struct bench_thread_t_ bench_thread_t;
+
+struct bench_thread_t_ {
+  int index;
+  int threads;
+  int cs;
+  int readPercent;
+  long ops;
+  __int64 * samples;		/* ops latencies, -1 if not taken */
+  void * arg;
+};
+
+__int64 bench_now(void);
+void bench_work(int n);
+int bench_max_threads(void);
+int bench_next_threads(int n);
+void bench_header(const char * title);
+void bench_start(bench_thread_t * t);
+void bench_run(const char * bench, const char * variant,
+               int threads, int cs, int readPercent,
+               void * (*routine)(void *), void * arg);
+/****************************************************************************************/
@@ -52,28 +52,11 @@
 
 pthread_mutex_t mx;
 pthread_mutexattr_t ma;
-PTW32_STRUCT_TIMEB currSysTimeStart;
-PTW32_STRUCT_TIMEB currSysTimeStop;
-long durationMilliSecs;
-long overHeadMilliSecs = 0;
 int two = 2;
 int one = 1;
 int zero = 0;
 int iter;
 
-#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
-                                               - (_TStart.time*1000+_TStart.millitm)))
-
-/*
- * Dummy use of j, otherwise the loop may be removed by the optimiser
- * when doing the overhead timing with an empty loop.
- */
-#define TESTSTART \
-  { int i, j = 0, k = 0; PTW32_FTIME(&currSysTimeStart); for (i = 0; i < ITERATIONS; i++) { j++;
-
-#define TESTSTOP \
-  }; PTW32_FTIME(&currSysTimeStop); if (j + k == i) j++; }
-
 
 void
 runTest (char * testNameString, int mType)
@@ -90,12 +73,7 @@ runTest (char * testNameString, int mType)
 
   assert(pthread_mutex_destroy(&mx) == 0);
 
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-
-  printf( "%-45s %15ld %15.3f\n",
-	    testNameString,
-          durationMilliSecs,
-          (float) durationMilliSecs * 1E3 / ITERATIONS);
+  bench_report(testNameString, ITERATIONS, 1);
 }
 
 
@@ -110,10 +88,7 @@ main (int argc, char *argv[])
   printf( "=============================================================================\n");
   printf( "\nLock plus unlock on an unlocked mutex.\n%ld iterations\n\n",
           ITERATIONS);
-  printf( "%-45s %15s %15s\n",
-	    "Test",
-	    "Total(msec)",
-	    "average(usec)");
+  bench_columns();
   printf( "-----------------------------------------------------------------------------\n");
 
   /*
@@ -124,8 +99,7 @@ main (int argc, char *argv[])
   assert(2 == two);
   TESTSTOP
 
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-  overHeadMilliSecs = durationMilliSecs;
+  bench_overhead(ITERATIONS);
 
 
   TESTSTART
@@ -133,12 +107,7 @@ main (int argc, char *argv[])
   assert((dummy_call(&i), 2) == two);
   TESTSTOP
 
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-
-  printf( "%-45s %15ld %15.3f\n",
-	    "Dummy call x 2",
-          durationMilliSecs,
-          (float) (durationMilliSecs * 1E3 / ITERATIONS));
+  bench_report("Dummy call x 2", ITERATIONS, 1);
 
 
   TESTSTART
@@ -146,12 +115,7 @@ main (int argc, char *argv[])
   assert((interlocked_dec_with_conditionals(&i), 2) == two);
   TESTSTOP
 
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-
-  printf( "%-45s %15ld %15.3f\n",
-	    "Dummy call -> Interlocked with cond x 2",
-          durationMilliSecs,
-          (float) durationMilliSecs * 1E3 / ITERATIONS);
+  bench_report("Dummy call -> Interlocked with cond x 2", ITERATIONS, 1);
 
 
   TESTSTART
@@ -159,12 +123,7 @@ main (int argc, char *argv[])
   assert((InterlockedDecrement((LPLONG)&i), 2) == (LONG)two);
   TESTSTOP
 
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-
-  printf( "%-45s %15ld %15.3f\n",
-	    "InterlockedOp x 2",
-          durationMilliSecs,
-          (float) durationMilliSecs * 1E3 / ITERATIONS);
+  bench_report("InterlockedOp x 2", ITERATIONS, 1);
 
 
   InitializeCriticalSection(&cs);
@@ -176,12 +135,7 @@ main (int argc, char *argv[])
 
   DeleteCriticalSection(&cs);
 
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-
-  printf( "%-45s %15ld %15.3f\n",
-	    "Simple Critical Section",
-          durationMilliSecs,
-          (float) durationMilliSecs * 1E3 / ITERATIONS);
+  bench_report("Simple Critical Section", ITERATIONS, 1);
 
 
   old_mutex_use = OLD_WIN32CS;
@@ -194,12 +148,7 @@ main (int argc, char *argv[])
 
   assert(old_mutex_destroy(&ox) == 0);
 
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-
-  printf( "%-45s %15ld %15.3f\n",
-	    "Old PT Mutex using a Critical Section (WNT)",
-          durationMilliSecs,
-          (float) durationMilliSecs * 1E3 / ITERATIONS);
+  bench_report("Old PT Mutex using a Critical Section (WNT)", ITERATIONS, 1);
 
 
   old_mutex_use = OLD_WIN32MUTEX;
@@ -212,12 +161,7 @@ main (int argc, char *argv[])
 
   assert(old_mutex_destroy(&ox) == 0);
 
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-
-  printf( "%-45s %15ld %15.3f\n",
-	    "Old PT Mutex using a Win32 Mutex (W9x)",
-          durationMilliSecs,
-          (float) durationMilliSecs * 1E3 / ITERATIONS);
+  bench_report("Old PT Mutex using a Win32 Mutex (W9x)", ITERATIONS, 1);
 
   printf( ".............................................................................\n");
 
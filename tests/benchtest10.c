@@ -0,0 +1,309 @@
+/*
+ * benchtest10.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * --------------------------------------------------------------------------
+ *
+ * Measure how late timed waits end.
+ *
+ * Each benchmark makes timed waits that can only time out, with
+ * requested timeouts from 10 microseconds to 1 second, and samples how
+ * long after the requested time each wait returns:
+ *
+ * - cond        pthread_cond_timedwait on a condition nobody signals
+ * - sem         sem_timedwait on a semaphore at 0
+ * - mutex       pthread_mutex_timedlock on a mutex main holds
+ * - timedjoin   pthread_timedjoin_np of a thread that doesn't end
+ * - delay       pthread_delay_np
+ *
+ * The "hires" variant lets timed waits end on the thread's high
+ * resolution waitable timer, where Windows has them, and the "millis"
+ * variant turns that off with PTHREAD_PARAM_HIRES_WAIT_NP, so that
+ * waits are timed by ptw32_relmillisecs() in whole milliseconds. The
+ * cs column is the requested timeout in microseconds and p50, p99 and
+ * p999 are the lateness in nanoseconds. The read% column is unused.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define TIMED_SPAN_US	2000000L	/* Roughly how long a run waits */
+#define TIMED_OPS_MIN	5L
+#define TIMED_OPS_MAX	200L
+
+typedef struct {
+  long us;			/* Requested timeout */
+  struct timespec interval;
+  __int64 ticks;		/* The same in bench_now() ticks */
+} timeout_t;
+
+static pthread_mutex_t held = PTHREAD_MUTEX_INITIALIZER;
+
+static void
+deadline(struct timespec * abstime, const timeout_t * to)
+{
+  assert(clock_gettime(CLOCK_REALTIME, abstime) == 0);
+  abstime->tv_sec += to->interval.tv_sec;
+  abstime->tv_nsec += to->interval.tv_nsec;
+  if (abstime->tv_nsec >= 1000000000)
+    {
+      abstime->tv_sec++;
+      abstime->tv_nsec -= 1000000000;
+    }
+}
+
+/*
+ * A wait that ends early (it can't, by POSIX) counts as on time.
+ */
+static void
+late(bench_thread_t * t, long i, __int64 start, const timeout_t * to)
+{
+  __int64 lateness = bench_now() - start - to->ticks;
+
+  t->samples[i] = (lateness > 0) ? lateness : 0;
+}
+
+void *
+condRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  timeout_t * to = (timeout_t *) t->arg;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  struct timespec abstime;
+  __int64 start;
+  int result;
+  long i;
+
+  assert(pthread_mutex_init(&mutex, NULL) == 0);
+  assert(pthread_cond_init(&cond, NULL) == 0);
+  assert(pthread_mutex_lock(&mutex) == 0);
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      deadline(&abstime, to);
+      /* Spurious wakeups wait again */
+      while ((result = pthread_cond_timedwait(&cond, &mutex, &abstime)) == 0)
+        {
+        }
+      assert(result == ETIMEDOUT);
+      late(t, i, start, to);
+    }
+
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(pthread_cond_destroy(&cond) == 0);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  return NULL;
+}
+
+void *
+semRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  timeout_t * to = (timeout_t *) t->arg;
+  struct timespec abstime;
+  sem_t sem;
+  __int64 start;
+  long i;
+
+  assert(sem_init(&sem, 0, 0) == 0);
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      deadline(&abstime, to);
+      assert(sem_timedwait(&sem, &abstime) == -1);
+      assert(errno == ETIMEDOUT);
+      late(t, i, start, to);
+    }
+
+  assert(sem_destroy(&sem) == 0);
+
+  return NULL;
+}
+
+void *
+mutexRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  timeout_t * to = (timeout_t *) t->arg;
+  struct timespec abstime;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      deadline(&abstime, to);
+      assert(pthread_mutex_timedlock(&held, &abstime) == ETIMEDOUT);
+      late(t, i, start, to);
+    }
+
+  return NULL;
+}
+
+void *
+blocker(void * arg)
+{
+  assert(sem_wait((sem_t *) arg) == 0);
+
+  return NULL;
+}
+
+void *
+joinRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  timeout_t * to = (timeout_t *) t->arg;
+  struct timespec abstime;
+  pthread_t tid;
+  sem_t release;
+  __int64 start;
+  long i;
+
+  assert(sem_init(&release, 0, 0) == 0);
+  assert(pthread_create(&tid, NULL, blocker, &release) == 0);
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      deadline(&abstime, to);
+      assert(pthread_timedjoin_np(tid, NULL, &abstime) == ETIMEDOUT);
+      late(t, i, start, to);
+    }
+
+  assert(sem_post(&release) == 0);
+  assert(pthread_join(tid, NULL) == 0);
+  assert(sem_destroy(&release) == 0);
+
+  return NULL;
+}
+
+void *
+delayRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  timeout_t * to = (timeout_t *) t->arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      assert(pthread_delay_np(&to->interval) == 0);
+      late(t, i, start, to);
+    }
+
+  return NULL;
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const struct {
+    const char * name;
+    void * (*routine)(void *);
+  } benches[] = {
+    { "cond", condRoutine },
+    { "sem", semRoutine },
+    { "mutex", mutexRoutine },
+    { "timedjoin", joinRoutine },
+    { "delay", delayRoutine }
+  };
+  static const long timeouts[] = {
+    10L, 100L, 1000L, 10000L, 100000L, 1000000L
+  };
+  LARGE_INTEGER frequency;
+  timeout_t to;
+  long oldHires;
+  size_t b, i;
+  int hires;
+
+  assert(QueryPerformanceFrequency(&frequency));
+  assert(pthread_getparam_np(PTHREAD_PARAM_HIRES_WAIT_NP, &oldHires) == 0);
+  assert(pthread_mutex_lock(&held) == 0);
+
+  benchOps = TIMED_OPS_MAX;
+  bench_header("Timed wait lateness");
+
+  for (b = 0; b < sizeof(benches)/sizeof(benches[0]); b++)
+    {
+      for (hires = 1; hires >= 0; hires--)
+        {
+          assert(pthread_setparam_np(PTHREAD_PARAM_HIRES_WAIT_NP, hires) == 0);
+
+          for (i = 0; i < sizeof(timeouts)/sizeof(timeouts[0]); i++)
+            {
+              to.us = timeouts[i];
+              to.interval.tv_sec = to.us / 1000000L;
+              to.interval.tv_nsec = (to.us % 1000000L) * 1000L;
+              to.ticks = to.us * frequency.QuadPart / 1000000L;
+
+              benchOps = TIMED_SPAN_US / to.us;
+              if (benchOps > TIMED_OPS_MAX)
+                {
+                  benchOps = TIMED_OPS_MAX;
+                }
+              else if (benchOps < TIMED_OPS_MIN)
+                {
+                  benchOps = TIMED_OPS_MIN;
+                }
+
+              bench_run(benches[b].name, hires ? "hires" : "millis", 1,
+                        (int) to.us, 0, benches[b].routine, &to);
+            }
+        }
+    }
+
+  assert(pthread_mutex_unlock(&held) == 0);
+  assert(pthread_setparam_np(PTHREAD_PARAM_HIRES_WAIT_NP, oldHires) == 0);
+
+  return 0;
+}
@@ -0,0 +1,324 @@
+/*
+ * benchtest11.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * --------------------------------------------------------------------------
+ *
+ * Measure the memory and kernel objects each synchronisation object
+ * and thread costs.
+ *
+ * Creates OBJECTS (or argv[1]) mutexes, condition variables,
+ * semaphores and read/write locks, one kind at a time, and THREADS
+ * (or argv[2]) threads that each set TSD_KEYS thread-specific values
+ * and wait until all are running. Prints, per object:
+ *
+ * - heap      bytes in use in the process heaps (HeapWalk)
+ * - commit    private bytes committed (the commit charge)
+ * - handles   process handles (GetProcessHandleCount)
+ * - kernel    kernel objects the library holds (pthread_getlibstats_np)
+ * - retained  heap bytes still in use once the objects are destroyed
+ *
+ * The objects are only initialised; objects that create their events
+ * when first contended are measured before they have them. Compare the
+ * output between library builds to track the footprint over time, as
+ * the SIZES.* files do for the structure sizes.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#define OBJECTS		1000000L
+#define THREADS		10000L
+#define TSD_KEYS	4
+
+/* As PROCESS_MEMORY_COUNTERS_EX, which not every psapi.h has */
+typedef struct {
+  DWORD cb;
+  DWORD PageFaultCount;
+  SIZE_T PeakWorkingSetSize;
+  SIZE_T WorkingSetSize;
+  SIZE_T QuotaPeakPagedPoolUsage;
+  SIZE_T QuotaPagedPoolUsage;
+  SIZE_T QuotaPeakNonPagedPoolUsage;
+  SIZE_T QuotaNonPagedPoolUsage;
+  SIZE_T PagefileUsage;
+  SIZE_T PeakPagefileUsage;
+  SIZE_T PrivateUsage;
+} memory_counters_t;
+
+typedef BOOL (WINAPI * memory_info_t)(HANDLE, memory_counters_t *, DWORD);
+typedef BOOL (WINAPI * handle_count_t)(HANDLE, PDWORD);
+
+static memory_info_t memoryInfo = NULL;
+static handle_count_t handleCount = NULL;
+
+typedef struct {
+  __int64 heap;
+  __int64 commit;
+  __int64 handles;
+  __int64 kernel;
+} footprint_t;
+
+static pthread_key_t keys[TSD_KEYS];
+static sem_t ready;
+static sem_t release;
+
+static void
+footprint(footprint_t * f)
+{
+  HANDLE heaps[64];
+  DWORD nHeaps = GetProcessHeaps(sizeof(heaps)/sizeof(heaps[0]), heaps);
+  memory_counters_t mc;
+  pthread_libstats_np_t stats;
+  DWORD handles = 0;
+  DWORD h;
+
+  f->heap = 0;
+
+  for (h = 0; h < nHeaps && h < sizeof(heaps)/sizeof(heaps[0]); h++)
+    {
+      PROCESS_HEAP_ENTRY entry;
+
+      if (!HeapLock(heaps[h]))
+        {
+          continue;
+        }
+
+      entry.lpData = NULL;
+
+      while (HeapWalk(heaps[h], &entry))
+        {
+          if (entry.wFlags & PROCESS_HEAP_ENTRY_BUSY)
+            {
+              f->heap += entry.cbData;
+            }
+        }
+
+      (void) HeapUnlock(heaps[h]);
+    }
+
+  mc.cb = sizeof(mc);
+  f->commit = (memoryInfo != NULL && memoryInfo(GetCurrentProcess(), &mc, sizeof(mc)))
+              ? (__int64) mc.PrivateUsage : 0;
+
+  f->handles = (handleCount != NULL && handleCount(GetCurrentProcess(), &handles))
+               ? (__int64) handles : 0;
+
+  assert(pthread_getlibstats_np(&stats) == 0);
+  f->kernel = (__int64) (stats.events + stats.semaphores + stats.timers
+                         + stats.threadHandles);
+}
+
+static void
+report(const char * name, long count, const footprint_t * before,
+       const footprint_t * during, const footprint_t * after)
+{
+  double n = (count > 0) ? (double) count : 1.0;
+
+  printf("  %-10s %8ld %10.1f %10.1f %8.3f %8.3f %10.1f\n",
+         name, count,
+         (double) (during->heap - before->heap) / n,
+         (double) (during->commit - before->commit) / n,
+         (double) (during->handles - before->handles) / n,
+         (double) (during->kernel - before->kernel) / n,
+         (double) (after->heap - before->heap) / n);
+  fflush(stdout);
+}
+
+void *
+worker(void * arg)
+{
+  int k;
+
+  for (k = 0; k < TSD_KEYS; k++)
+    {
+      assert(pthread_setspecific(keys[k], arg) == 0);
+    }
+
+  assert(sem_post(&ready) == 0);
+  assert(sem_wait(&release) == 0);
+
+  return NULL;
+}
+
+int
+main (int argc, char *argv[])
+{
+  long objects = (argc > 1) ? atol(argv[1]) : OBJECTS;
+  long threads = (argc > 2) ? atol(argv[2]) : THREADS;
+  HMODULE kernel32 = GetModuleHandleA("kernel32.dll");
+  HMODULE psapi;
+  footprint_t before, during, after;
+  void * storage;
+  pthread_t * tid;
+  long i, n;
+  int k;
+
+  assert(objects > 0 && threads > 0);
+
+  memoryInfo = (memory_info_t) GetProcAddress(kernel32, "K32GetProcessMemoryInfo");
+  if (memoryInfo == NULL && (psapi = LoadLibraryA("psapi.dll")) != NULL)
+    {
+      memoryInfo = (memory_info_t) GetProcAddress(psapi, "GetProcessMemoryInfo");
+    }
+  handleCount = (handle_count_t) GetProcAddress(kernel32, "GetProcessHandleCount");
+
+  /* Big enough for any of the object handles, and threads */
+  storage = calloc(objects > threads ? objects : threads, sizeof(pthread_t));
+  assert(storage != NULL);
+
+  printf("# Memory footprint per object\n");
+  printf("# %-10s %8s %10s %10s %8s %8s %10s\n",
+         "object", "count", "heap", "commit", "handles", "kernel", "retained");
+
+  {
+    pthread_mutex_t * mx = (pthread_mutex_t *) storage;
+
+    footprint(&before);
+    for (i = 0; i < objects; i++)
+      {
+        assert(pthread_mutex_init(&mx[i], NULL) == 0);
+      }
+    footprint(&during);
+    for (i = 0; i < objects; i++)
+      {
+        assert(pthread_mutex_destroy(&mx[i]) == 0);
+      }
+    footprint(&after);
+    report("mutex", objects, &before, &during, &after);
+  }
+
+  {
+    pthread_cond_t * cv = (pthread_cond_t *) storage;
+
+    footprint(&before);
+    for (i = 0; i < objects; i++)
+      {
+        assert(pthread_cond_init(&cv[i], NULL) == 0);
+      }
+    footprint(&during);
+    for (i = 0; i < objects; i++)
+      {
+        assert(pthread_cond_destroy(&cv[i]) == 0);
+      }
+    footprint(&after);
+    report("cond", objects, &before, &during, &after);
+  }
+
+  {
+    /* sem_t is a pointer, so an array of them fits in storage */
+    sem_t * sem = (sem_t *) storage;
+
+    footprint(&before);
+    for (i = 0; i < objects; i++)
+      {
+        assert(sem_init(&sem[i], 0, 0) == 0);
+      }
+    footprint(&during);
+    for (i = 0; i < objects; i++)
+      {
+        assert(sem_destroy(&sem[i]) == 0);
+      }
+    footprint(&after);
+    report("sem", objects, &before, &during, &after);
+  }
+
+  {
+    pthread_rwlock_t * rw = (pthread_rwlock_t *) storage;
+
+    footprint(&before);
+    for (i = 0; i < objects; i++)
+      {
+        assert(pthread_rwlock_init(&rw[i], NULL) == 0);
+      }
+    footprint(&during);
+    for (i = 0; i < objects; i++)
+      {
+        assert(pthread_rwlock_destroy(&rw[i]) == 0);
+      }
+    footprint(&after);
+    report("rwlock", objects, &before, &during, &after);
+  }
+
+  tid = (pthread_t *) storage;
+
+  for (k = 0; k < TSD_KEYS; k++)
+    {
+      assert(pthread_key_create(&keys[k], NULL) == 0);
+    }
+  assert(sem_init(&ready, 0, 0) == 0);
+  assert(sem_init(&release, 0, 0) == 0);
+
+  footprint(&before);
+
+  /* Stop short, and report fewer, if the system runs out */
+  for (n = 0; n < threads; n++)
+    {
+      if (pthread_create(&tid[n], NULL, worker, &tid[n]) != 0)
+        {
+          break;
+        }
+    }
+  for (i = 0; i < n; i++)
+    {
+      assert(sem_wait(&ready) == 0);
+    }
+
+  footprint(&during);
+
+  if (n > 0)
+    {
+      assert(sem_post_multiple(&release, (int) n) == 0);
+    }
+  for (i = 0; i < n; i++)
+    {
+      assert(pthread_join(tid[i], NULL) == 0);
+    }
+
+  footprint(&after);
+  report("thread", n, &before, &during, &after);
+
+  assert(sem_destroy(&release) == 0);
+  assert(sem_destroy(&ready) == 0);
+  for (k = 0; k < TSD_KEYS; k++)
+    {
+      assert(pthread_key_delete(keys[k]) == 0);
+    }
+
+  free(storage);
+
+  return 0;
+}
@@ -0,0 +1,773 @@
+/*
+ * benchtest12.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * --------------------------------------------------------------------------
+ *
+ * Measure the library against the primitives Windows and the C++
+ * runtime provide for the same job, with the same contention framework
+ * as benchtest6 to benchtest9, so that each line can be read against
+ * the native line next to it.
+ *
+ * - lock
+ *   pthread_mutex_t (normal), CRITICAL_SECTION, SRWLOCK held exclusive
+ *   and std::mutex, each locked, worked in for cs and unlocked by 1 to
+ *   N threads. The latency is the time each lock call took.
+ *
+ * - rwlock
+ *   pthread_rwlock_t against SRWLOCK at 90% and 50% reads.
+ *
+ * - ring
+ *   2 to N threads pass a token round a ring as in benchtest8, waiting
+ *   with pthread_cond_t, CONDITION_VARIABLE on an SRWLOCK,
+ *   WaitOnAddress on the turn itself, and std::condition_variable.
+ *
+ * - work
+ *   1 to N threads each submit a work item that works for cs, and wait
+ *   for it to finish, to a pthread_pool_np_t or to the process default
+ *   Windows thread pool (TrySubmitThreadpoolCallback). The latency is
+ *   the round trip.
+ *
+ * - start
+ *   As create-join in benchtest9: pthread_create, CreateThread and
+ *   std::thread.
+ *
+ * The native functions are looked up at run time, as the library does,
+ * and their lines are left out where the system lacks them
+ * (WaitOnAddress needs Windows 8). The std:: lines are only built by
+ * the C++ compilers that provide <mutex>, <condition_variable> and
+ * <thread>. The read% column is only used by rwlock.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#if defined(__cplusplus)
+#include <cstddef>
+#if (defined(_MSC_VER) && _MSC_VER >= 1700) \
+    || (defined(__GNUC__) && __cplusplus >= 201103L && defined(_GLIBCXX_HAS_GTHREADS))
+#define BENCH_STD
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#endif
+#endif
+
+#include "benchtest.h"
+
+#define SPAWN_OPS	1000L		/* Threads created per creator and run */
+
+/*
+ * SRWLOCK and CONDITION_VARIABLE are a single pointer, zero when free,
+ * and are declared here as such so that the test builds against
+ * headers older than Vista.
+ */
+typedef PVOID native_srw_t;
+typedef PVOID native_cv_t;
+
+static void (WINAPI *native_acquire_exclusive)(native_srw_t *);
+static void (WINAPI *native_release_exclusive)(native_srw_t *);
+static void (WINAPI *native_acquire_shared)(native_srw_t *);
+static void (WINAPI *native_release_shared)(native_srw_t *);
+static BOOL (WINAPI *native_sleep_cv)(native_cv_t *, native_srw_t *, DWORD, ULONG);
+static void (WINAPI *native_wake_cv)(native_cv_t *);
+static void (WINAPI *native_wake_all_cv)(native_cv_t *);
+static BOOL (WINAPI *native_wait_address)(volatile VOID *, PVOID, SIZE_T, DWORD);
+static void (WINAPI *native_wake_address_all)(PVOID);
+static BOOL (WINAPI *native_submit)(void (CALLBACK *)(PVOID, PVOID), PVOID, PVOID);
+
+static pthread_mutex_t mx;
+static CRITICAL_SECTION cs;
+static native_srw_t srw;
+static pthread_rwlock_t rwl;
+
+#if defined(BENCH_STD)
+static std::mutex * stdMx;
+#endif
+
+typedef struct {
+  pthread_mutex_t mx;
+  pthread_cond_t * cv;
+  native_srw_t srw;
+  native_cv_t * ncv;
+  volatile LONG turn;
+#if defined(BENCH_STD)
+  std::mutex * stdMx;
+  std::condition_variable * stdCv;
+#endif
+} ring_t;
+
+typedef struct {
+  int cs;
+  HANDLE done;
+} item_t;
+
+typedef struct {
+  __int64 started;
+} child_t;
+
+static const int lockCsLengths[] = { 0, 100, 1000 };
+static const int ringCsLengths[] = { 0, 1000 };
+static const int readPercents[] = { 90, 50 };
+
+static void
+native_init(void)
+{
+  HMODULE k32 = GetModuleHandle(TEXT("kernel32.dll"));
+  HMODULE synch = LoadLibrary(TEXT("api-ms-win-core-synch-l1-2-0.dll"));
+
+  *(FARPROC *) &native_acquire_exclusive = GetProcAddress(k32, "AcquireSRWLockExclusive");
+  *(FARPROC *) &native_release_exclusive = GetProcAddress(k32, "ReleaseSRWLockExclusive");
+  *(FARPROC *) &native_acquire_shared = GetProcAddress(k32, "AcquireSRWLockShared");
+  *(FARPROC *) &native_release_shared = GetProcAddress(k32, "ReleaseSRWLockShared");
+  *(FARPROC *) &native_sleep_cv = GetProcAddress(k32, "SleepConditionVariableSRW");
+  *(FARPROC *) &native_wake_cv = GetProcAddress(k32, "WakeConditionVariable");
+  *(FARPROC *) &native_wake_all_cv = GetProcAddress(k32, "WakeAllConditionVariable");
+  *(FARPROC *) &native_submit = GetProcAddress(k32, "TrySubmitThreadpoolCallback");
+
+  if (synch != NULL)
+    {
+      *(FARPROC *) &native_wait_address = GetProcAddress(synch, "WaitOnAddress");
+      *(FARPROC *) &native_wake_address_all = GetProcAddress(synch, "WakeByAddressAll");
+    }
+}
+
+/*
+ * lock
+ */
+void *
+mutexRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      assert(pthread_mutex_lock(&mx) == 0);
+      t->samples[i] = bench_now() - start;
+      bench_work(t->cs);
+      assert(pthread_mutex_unlock(&mx) == 0);
+      bench_work(t->cs);
+    }
+
+  return NULL;
+}
+
+void *
+csRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      EnterCriticalSection(&cs);
+      t->samples[i] = bench_now() - start;
+      bench_work(t->cs);
+      LeaveCriticalSection(&cs);
+      bench_work(t->cs);
+    }
+
+  return NULL;
+}
+
+void *
+srwRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      native_acquire_exclusive(&srw);
+      t->samples[i] = bench_now() - start;
+      bench_work(t->cs);
+      native_release_exclusive(&srw);
+      bench_work(t->cs);
+    }
+
+  return NULL;
+}
+
+#if defined(BENCH_STD)
+void *
+stdMutexRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      stdMx->lock();
+      t->samples[i] = bench_now() - start;
+      bench_work(t->cs);
+      stdMx->unlock();
+      bench_work(t->cs);
+    }
+
+  return NULL;
+}
+#endif
+
+/*
+ * rwlock
+ */
+void *
+rwlockRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      /* Spread the writes evenly over threads and operations */
+      int read = (int) ((i * 37 + t->index * 11) % 100) < t->readPercent;
+
+      start = bench_now();
+      if (read)
+        {
+          assert(pthread_rwlock_rdlock(&rwl) == 0);
+        }
+      else
+        {
+          assert(pthread_rwlock_wrlock(&rwl) == 0);
+        }
+      t->samples[i] = bench_now() - start;
+      bench_work(t->cs);
+      assert(pthread_rwlock_unlock(&rwl) == 0);
+      bench_work(t->cs);
+    }
+
+  return NULL;
+}
+
+void *
+srwSharedRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      int read = (int) ((i * 37 + t->index * 11) % 100) < t->readPercent;
+
+      start = bench_now();
+      if (read)
+        {
+          native_acquire_shared(&srw);
+        }
+      else
+        {
+          native_acquire_exclusive(&srw);
+        }
+      t->samples[i] = bench_now() - start;
+      bench_work(t->cs);
+      if (read)
+        {
+          native_release_shared(&srw);
+        }
+      else
+        {
+          native_release_exclusive(&srw);
+        }
+      bench_work(t->cs);
+    }
+
+  return NULL;
+}
+
+/*
+ * ring
+ */
+void *
+condRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  ring_t * ring = (ring_t *) t->arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      assert(pthread_mutex_lock(&ring->mx) == 0);
+      while (ring->turn != t->index)
+        {
+          assert(pthread_cond_wait(&ring->cv[t->index], &ring->mx) == 0);
+        }
+      t->samples[i] = bench_now() - start;
+      bench_work(t->cs);
+      ring->turn = (t->index + 1) % t->threads;
+      assert(pthread_cond_signal(&ring->cv[ring->turn]) == 0);
+      assert(pthread_mutex_unlock(&ring->mx) == 0);
+    }
+
+  return NULL;
+}
+
+void *
+nativeCondRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  ring_t * ring = (ring_t *) t->arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      native_acquire_exclusive(&ring->srw);
+      while (ring->turn != t->index)
+        {
+          assert(native_sleep_cv(&ring->ncv[t->index], &ring->srw, INFINITE, 0));
+        }
+      t->samples[i] = bench_now() - start;
+      bench_work(t->cs);
+      ring->turn = (t->index + 1) % t->threads;
+      native_wake_cv(&ring->ncv[ring->turn]);
+      native_release_exclusive(&ring->srw);
+    }
+
+  return NULL;
+}
+
+void *
+addressRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  ring_t * ring = (ring_t *) t->arg;
+  __int64 start;
+  LONG turn;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      while ((turn = ring->turn) != t->index)
+        {
+          (void) native_wait_address(&ring->turn, &turn, sizeof(turn), INFINITE);
+        }
+      t->samples[i] = bench_now() - start;
+      bench_work(t->cs);
+      /* Every thread waits on the one address */
+      (void) InterlockedExchange((LPLONG) &ring->turn, (t->index + 1) % t->threads);
+      native_wake_address_all((PVOID) &ring->turn);
+    }
+
+  return NULL;
+}
+
+#if defined(BENCH_STD)
+void *
+stdCondRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  ring_t * ring = (ring_t *) t->arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      {
+        std::unique_lock<std::mutex> lock(*ring->stdMx);
+
+        while (ring->turn != t->index)
+          {
+            ring->stdCv[t->index].wait(lock);
+          }
+        t->samples[i] = bench_now() - start;
+        bench_work(t->cs);
+        ring->turn = (t->index + 1) % t->threads;
+        ring->stdCv[ring->turn].notify_one();
+      }
+    }
+
+  return NULL;
+}
+#endif
+
+/*
+ * work
+ */
+void *
+poolItem(void * arg)
+{
+  bench_work(((item_t *) arg)->cs);
+
+  return NULL;
+}
+
+void CALLBACK
+nativeItem(PVOID instance, PVOID arg)
+{
+  item_t * item = (item_t *) arg;
+
+  bench_work(item->cs);
+  assert(SetEvent(item->done));
+}
+
+void *
+poolRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  pthread_pool_np_t pool = (pthread_pool_np_t) t->arg;
+  pthread_pool_task_np_t task;
+  item_t item;
+  __int64 start;
+  long i;
+
+  item.cs = t->cs;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      assert(pthread_pool_submit_np(pool, poolItem, &item, &task) == 0);
+      assert(pthread_pool_task_wait_np(task, NULL) == 0);
+      t->samples[i] = bench_now() - start;
+    }
+
+  return NULL;
+}
+
+void *
+nativePoolRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  item_t item;
+  __int64 start;
+  long i;
+
+  item.cs = t->cs;
+  item.done = CreateEvent(NULL, FALSE, FALSE, NULL);
+  assert(item.done != NULL);
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      assert(native_submit(nativeItem, &item, NULL));
+      assert(WaitForSingleObject(item.done, INFINITE) == WAIT_OBJECT_0);
+      t->samples[i] = bench_now() - start;
+    }
+
+  assert(CloseHandle(item.done));
+
+  return NULL;
+}
+
+/*
+ * start
+ */
+void *
+child(void * arg)
+{
+  ((child_t *) arg)->started = bench_now();
+
+  return NULL;
+}
+
+DWORD WINAPI
+nativeChild(LPVOID arg)
+{
+  ((child_t *) arg)->started = bench_now();
+
+  return 0;
+}
+
+void *
+spawnRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  pthread_t tid;
+  child_t c;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      assert(pthread_create(&tid, NULL, child, &c) == 0);
+      assert(pthread_join(tid, NULL) == 0);
+      t->samples[i] = c.started - start;
+    }
+
+  return NULL;
+}
+
+void *
+nativeSpawnRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  HANDLE h;
+  child_t c;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      h = CreateThread(NULL, 0, nativeChild, &c, 0, NULL);
+      assert(h != NULL);
+      assert(WaitForSingleObject(h, INFINITE) == WAIT_OBJECT_0);
+      assert(CloseHandle(h));
+      t->samples[i] = c.started - start;
+    }
+
+  return NULL;
+}
+
+#if defined(BENCH_STD)
+static void
+stdChild(child_t * c)
+{
+  c->started = bench_now();
+}
+
+void *
+stdSpawnRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  child_t c;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      std::thread th(stdChild, &c);
+      th.join();
+      t->samples[i] = c.started - start;
+    }
+
+  return NULL;
+}
+#endif
+
+int
+main (int argc, char *argv[])
+{
+  pthread_mutexattr_t ma;
+  pthread_pool_np_t pool;
+  ring_t ring;
+  size_t c, r;
+  int i, n;
+
+  native_init();
+
+  bench_header("The library against native Windows and C++ primitives");
+
+  /* lock */
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_NORMAL) == 0);
+  assert(pthread_mutex_init(&mx, &ma) == 0);
+  InitializeCriticalSection(&cs);
+  srw = NULL;
+#if defined(BENCH_STD)
+  stdMx = new std::mutex;
+#endif
+
+  for (c = 0; c < sizeof(lockCsLengths)/sizeof(lockCsLengths[0]); c++)
+    {
+      for (n = 1; n <= bench_max_threads(); n = bench_next_threads(n))
+        {
+          bench_run("lock", "pthread", n, lockCsLengths[c], 0,
+                    mutexRoutine, NULL);
+          bench_run("lock", "critsec", n, lockCsLengths[c], 0,
+                    csRoutine, NULL);
+          if (native_acquire_exclusive != NULL)
+            {
+              bench_run("lock", "srwlock", n, lockCsLengths[c], 0,
+                        srwRoutine, NULL);
+            }
+#if defined(BENCH_STD)
+          bench_run("lock", "std", n, lockCsLengths[c], 0,
+                    stdMutexRoutine, NULL);
+#endif
+        }
+    }
+
+#if defined(BENCH_STD)
+  delete stdMx;
+#endif
+  DeleteCriticalSection(&cs);
+  assert(pthread_mutex_destroy(&mx) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  /* rwlock */
+  assert(pthread_rwlock_init(&rwl, NULL) == 0);
+
+  for (r = 0; r < sizeof(readPercents)/sizeof(readPercents[0]); r++)
+    {
+      for (n = 1; n <= bench_max_threads(); n = bench_next_threads(n))
+        {
+          bench_run("rwlock", "pthread", n, lockCsLengths[1],
+                    readPercents[r], rwlockRoutine, NULL);
+          if (native_acquire_shared != NULL)
+            {
+              bench_run("rwlock", "srwlock", n, lockCsLengths[1],
+                        readPercents[r], srwSharedRoutine, NULL);
+            }
+        }
+    }
+
+  assert(pthread_rwlock_destroy(&rwl) == 0);
+
+  /* ring */
+  for (c = 0; c < sizeof(ringCsLengths)/sizeof(ringCsLengths[0]); c++)
+    {
+      for (n = 2; n <= bench_max_threads(); n = bench_next_threads(n))
+        {
+          assert(pthread_mutex_init(&ring.mx, NULL) == 0);
+          ring.cv = (pthread_cond_t *) calloc(n, sizeof(pthread_cond_t));
+          ring.ncv = (native_cv_t *) calloc(n, sizeof(native_cv_t));
+          assert(ring.cv != NULL && ring.ncv != NULL);
+          for (i = 0; i < n; i++)
+            {
+              assert(pthread_cond_init(&ring.cv[i], NULL) == 0);
+            }
+          ring.srw = NULL;
+
+          ring.turn = 0;
+          bench_run("ring", "pthread", n, ringCsLengths[c], 0,
+                    condRoutine, &ring);
+
+          if (native_sleep_cv != NULL)
+            {
+              ring.turn = 0;
+              bench_run("ring", "condvar", n, ringCsLengths[c], 0,
+                        nativeCondRoutine, &ring);
+            }
+
+          if (native_wait_address != NULL)
+            {
+              ring.turn = 0;
+              bench_run("ring", "waitonaddr", n, ringCsLengths[c], 0,
+                        addressRoutine, &ring);
+            }
+
+#if defined(BENCH_STD)
+          ring.stdMx = new std::mutex;
+          ring.stdCv = new std::condition_variable[n];
+          ring.turn = 0;
+          bench_run("ring", "std", n, ringCsLengths[c], 0,
+                    stdCondRoutine, &ring);
+          delete [] ring.stdCv;
+          delete ring.stdMx;
+#endif
+
+          for (i = 0; i < n; i++)
+            {
+              assert(pthread_cond_destroy(&ring.cv[i]) == 0);
+            }
+          free(ring.ncv);
+          free(ring.cv);
+          assert(pthread_mutex_destroy(&ring.mx) == 0);
+        }
+    }
+
+  /* work */
+  assert(pthread_pool_create_np(&pool, NULL, bench_max_threads()) == 0);
+
+  for (c = 0; c < sizeof(ringCsLengths)/sizeof(ringCsLengths[0]); c++)
+    {
+      for (n = 1; n <= bench_max_threads(); n = bench_next_threads(n))
+        {
+          bench_run("work", "pthread", n, ringCsLengths[c], 0,
+                    poolRoutine, pool);
+          if (native_submit != NULL)
+            {
+              bench_run("work", "threadpool", n, ringCsLengths[c], 0,
+                        nativePoolRoutine, NULL);
+            }
+        }
+    }
+
+  assert(pthread_pool_destroy_np(&pool) == 0);
+
+  /* start */
+  benchOps = SPAWN_OPS;
+
+  for (n = 1; n <= bench_max_threads(); n = bench_next_threads(n))
+    {
+      bench_run("start", "pthread", n, 0, 0, spawnRoutine, NULL);
+      bench_run("start", "createthread", n, 0, 0, nativeSpawnRoutine, NULL);
+#if defined(BENCH_STD)
+      bench_run("start", "std", n, 0, 0, stdSpawnRoutine, NULL);
+#endif
+    }
+
+  return 0;
+}
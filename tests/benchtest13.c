@@ -0,0 +1,198 @@
+/*
+ * benchtest13.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure time taken to complete an elementary operation.
+ *
+ * - Thread specific data, once, self and cancellation points
+ *   Single thread iteration over the calls every request of a threaded
+ *   program makes, next to the Win32 call each one is built on:
+ *   pthread_getspecific and pthread_setspecific (TlsGetValue and
+ *   TlsSetValue), pthread_once once done, pthread_self
+ *   (GetCurrentThreadId), pthread_testcancel with cancellation enabled
+ *   and disabled, and a pthread_cleanup_push and pop pair, which costs
+ *   most in the C++ and SEH cleanup builds.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITERATIONS      10000000L
+
+pthread_key_t key;
+DWORD w32key;
+pthread_once_t once = PTHREAD_ONCE_INIT;
+pthread_t self;
+
+int one = 1;
+int zero = 0;
+
+
+void
+reportTest (char * testNameString)
+{
+  bench_report(testNameString, ITERATIONS, 1);
+}
+
+void
+onceRoutine(void)
+{
+}
+
+void
+cleanupRoutine(void * arg)
+{
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  int oldstate;
+
+  printf( "=============================================================================\n");
+  printf( "\nPer call overhead of TSD, once, self and cancellation points.\n%ld iterations\n\n",
+          ITERATIONS);
+  bench_columns();
+  printf( "-----------------------------------------------------------------------------\n");
+
+  /*
+   * Time the loop overhead so we can subtract it from the actual test times.
+   */
+
+  TESTSTART
+  assert(1 == one);
+  TESTSTOP
+
+  bench_overhead(ITERATIONS);
+
+
+  /*
+   * Now we can start the actual tests
+   */
+  assert((w32key = TlsAlloc()) != TLS_OUT_OF_INDEXES);
+  assert(TlsSetValue(w32key, &one) != 0);
+  TESTSTART
+  assert(TlsGetValue(w32key) == &one);
+  TESTSTOP
+
+  reportTest("W32 TlsGetValue");
+
+
+  TESTSTART
+  assert((TlsSetValue(w32key, &one),1) == one);
+  TESTSTOP
+  assert(TlsFree(w32key) != 0);
+
+  reportTest("W32 TlsSetValue");
+
+
+  assert(pthread_key_create(&key, NULL) == 0);
+  assert(pthread_setspecific(key, &one) == 0);
+  TESTSTART
+  assert(pthread_getspecific(key) == &one);
+  TESTSTOP
+
+  reportTest("POSIX pthread_getspecific");
+
+
+  TESTSTART
+  assert(pthread_setspecific(key, &one) == 0);
+  TESTSTOP
+  assert(pthread_key_delete(key) == 0);
+
+  reportTest("POSIX pthread_setspecific");
+
+
+  assert(pthread_once(&once, onceRoutine) == 0);
+  TESTSTART
+  assert(pthread_once(&once, onceRoutine) == 0);
+  TESTSTOP
+
+  reportTest("POSIX pthread_once once done");
+
+
+  TESTSTART
+  assert(GetCurrentThreadId() != 0);
+  TESTSTOP
+
+  reportTest("W32 GetCurrentThreadId");
+
+
+  self = pthread_self();
+  TESTSTART
+  assert(pthread_equal(pthread_self(), self));
+  TESTSTOP
+
+  reportTest("POSIX pthread_self");
+
+
+  TESTSTART
+  assert((pthread_testcancel(),1) == one);
+  TESTSTOP
+
+  reportTest("POSIX pthread_testcancel enabled");
+
+
+  assert(pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldstate) == 0);
+  TESTSTART
+  assert((pthread_testcancel(),1) == one);
+  TESTSTOP
+  assert(pthread_setcancelstate(oldstate, &oldstate) == 0);
+
+  reportTest("POSIX pthread_testcancel disabled");
+
+
+  TESTSTART
+  pthread_cleanup_push(cleanupRoutine, NULL);
+  j++;
+  pthread_cleanup_pop(0);
+  TESTSTOP
+
+  reportTest("POSIX cleanup push and pop");
+
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
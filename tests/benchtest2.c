@@ -57,26 +57,9 @@ pthread_mutex_t gate1, gate2;
 old_mutex_t ox1, ox2;
 CRITICAL_SECTION cs1, cs2;
 pthread_mutexattr_t ma;
-long durationMilliSecs;
-long overHeadMilliSecs = 0;
-PTW32_STRUCT_TIMEB currSysTimeStart;
-PTW32_STRUCT_TIMEB currSysTimeStop;
 pthread_t worker;
 int running = 0;
 
-#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
-                                               - (_TStart.time*1000+_TStart.millitm)))
-
-/*
- * Dummy use of j, otherwise the loop may be removed by the optimiser
- * when doing the overhead timing with an empty loop.
- */
-#define TESTSTART \
-  { int i, j = 0, k = 0; PTW32_FTIME(&currSysTimeStart); for (i = 0; i < ITERATIONS; i++) { j++;
-
-#define TESTSTOP \
-  }; PTW32_FTIME(&currSysTimeStop); if (j + k == i) j++; }
-
 
 void *
 overheadThread(void * arg)
@@ -164,11 +147,7 @@ runTest (char * testNameString, int mType)
   assert(pthread_join(worker, NULL) == 0);
   assert(pthread_mutex_destroy(&gate2) == 0);
   assert(pthread_mutex_destroy(&gate1) == 0);
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-  printf( "%-45s %15ld %15.3f\n",
-	    testNameString,
-          durationMilliSecs,
-          (float) durationMilliSecs * 1E3 / ITERATIONS / 4   /* Four locks/unlocks per iteration */);
+  bench_report(testNameString, ITERATIONS, 4);	/* Four locks/unlocks per iteration */
 }
 
 
@@ -181,10 +160,7 @@ main (int argc, char *argv[])
   printf( "\nLock plus unlock on a locked mutex.\n");
   printf("%ld iterations, four locks/unlocks per iteration.\n\n", ITERATIONS);
 
-  printf( "%-45s %15s %15s\n",
-	    "Test",
-	    "Total(msec)",
-	    "average(usec)");
+  bench_columns();
   printf( "-----------------------------------------------------------------------------\n");
 
   /*
@@ -199,8 +175,7 @@ main (int argc, char *argv[])
   TESTSTOP
   running = 0;
   assert(pthread_join(worker, NULL) == 0);
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-  overHeadMilliSecs = durationMilliSecs;
+  bench_overhead(ITERATIONS);
 
 
   InitializeCriticalSection(&cs1);
@@ -222,11 +197,7 @@ main (int argc, char *argv[])
   assert(pthread_join(worker, NULL) == 0);
   DeleteCriticalSection(&cs2);
   DeleteCriticalSection(&cs1);
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-  printf( "%-45s %15ld %15.3f\n",
-	    "Simple Critical Section",
-          durationMilliSecs,
-          (float) durationMilliSecs * 1E3 / ITERATIONS / 4 );
+  bench_report("Simple Critical Section", ITERATIONS, 4);
 
 
   old_mutex_use = OLD_WIN32CS;
@@ -249,11 +220,7 @@ main (int argc, char *argv[])
   assert(pthread_join(worker, NULL) == 0);
   assert(old_mutex_destroy(&ox2) == 0);
   assert(old_mutex_destroy(&ox1) == 0);
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-  printf( "%-45s %15ld %15.3f\n",
-	    "Old PT Mutex using a Critical Section (WNT)",
-          durationMilliSecs,
-          (float) durationMilliSecs * 1E3 / ITERATIONS / 4);
+  bench_report("Old PT Mutex using a Critical Section (WNT)", ITERATIONS, 4);
 
 
   old_mutex_use = OLD_WIN32MUTEX;
@@ -276,11 +243,7 @@ main (int argc, char *argv[])
   assert(pthread_join(worker, NULL) == 0);
   assert(old_mutex_destroy(&ox2) == 0);
   assert(old_mutex_destroy(&ox1) == 0);
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-  printf( "%-45s %15ld %15.3f\n",
-	    "Old PT Mutex using a Win32 Mutex (W9x)",
-          durationMilliSecs,
-          (float) durationMilliSecs * 1E3 / ITERATIONS / 4);
+  bench_report("Old PT Mutex using a Win32 Mutex (W9x)", ITERATIONS, 4);
 
   printf( ".............................................................................\n");
 
@@ -53,23 +53,6 @@
 pthread_mutex_t mx;
 old_mutex_t ox;
 pthread_mutexattr_t ma;
-PTW32_STRUCT_TIMEB currSysTimeStart;
-PTW32_STRUCT_TIMEB currSysTimeStop;
-long durationMilliSecs;
-long overHeadMilliSecs = 0;
-
-#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
-                                               - (_TStart.time*1000+_TStart.millitm)))
-
-/*
- * Dummy use of j, otherwise the loop may be removed by the optimiser
- * when doing the overhead timing with an empty loop.
- */
-#define TESTSTART \
-  { int i, j = 0, k = 0; PTW32_FTIME(&currSysTimeStart); for (i = 0; i < ITERATIONS; i++) { j++;
-
-#define TESTSTOP \
-  }; PTW32_FTIME(&currSysTimeStop); if (j + k == i) j++; }
 
 
 void
@@ -93,12 +76,7 @@ runTest (char * testNameString, int mType)
 
   pthread_mutex_destroy(&mx);
 
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-
-  printf( "%-45s %15ld %15.3f\n",
-	    testNameString,
-          durationMilliSecs,
-          (float) durationMilliSecs * 1E3 / ITERATIONS);
+  bench_report(testNameString, ITERATIONS, 1);
 }
 
 
@@ -110,10 +88,7 @@ main (int argc, char *argv[])
   printf( "=============================================================================\n");
   printf( "Trylock plus unlock on an unlocked mutex.\n");
   printf( "%ld iterations.\n\n", ITERATIONS);
-  printf( "%-45s %15s %15s\n",
-	    "Test",
-	    "Total(msec)",
-	    "average(usec)");
+  bench_columns();
   printf( "-----------------------------------------------------------------------------\n");
 
   /*
@@ -123,8 +98,7 @@ main (int argc, char *argv[])
   TESTSTART
   TESTSTOP
 
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-  overHeadMilliSecs = durationMilliSecs;
+  bench_overhead(ITERATIONS);
 
   old_mutex_use = OLD_WIN32CS;
   assert(old_mutex_init(&ox, NULL) == 0);
@@ -133,11 +107,7 @@ main (int argc, char *argv[])
   (void) old_mutex_unlock(&ox);
   TESTSTOP
   assert(old_mutex_destroy(&ox) == 0);
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-  printf( "%-45s %15ld %15.3f\n",
-	    "Old PT Mutex using a Critical Section (WNT)",
-          durationMilliSecs,
-          (float) durationMilliSecs * 1E3 / ITERATIONS);
+  bench_report("Old PT Mutex using a Critical Section (WNT)", ITERATIONS, 1);
 
   old_mutex_use = OLD_WIN32MUTEX;
   assert(old_mutex_init(&ox, NULL) == 0);
@@ -146,11 +116,7 @@ main (int argc, char *argv[])
   (void) old_mutex_unlock(&ox);
   TESTSTOP
   assert(old_mutex_destroy(&ox) == 0);
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-  printf( "%-45s %15ld %15.3f\n",
-	    "Old PT Mutex using a Win32 Mutex (W9x)",
-          durationMilliSecs,
-          (float) durationMilliSecs * 1E3 / ITERATIONS);
+  bench_report("Old PT Mutex using a Win32 Mutex (W9x)", ITERATIONS, 1);
 
   printf( ".............................................................................\n");
 
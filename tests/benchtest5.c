@@ -52,36 +52,14 @@
 sem_t sema;
 HANDLE w32sema;
 
-PTW32_STRUCT_TIMEB currSysTimeStart;
-PTW32_STRUCT_TIMEB currSysTimeStop;
-long durationMilliSecs;
-long overHeadMilliSecs = 0;
 int one = 1;
 int zero = 0;
 
-#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
-                                               - (_TStart.time*1000+_TStart.millitm)))
-
-/*
- * Dummy use of j, otherwise the loop may be removed by the optimiser
- * when doing the overhead timing with an empty loop.
- */
-#define TESTSTART \
-  { int i, j = 0, k = 0; PTW32_FTIME(&currSysTimeStart); for (i = 0; i < ITERATIONS; i++) { j++;
-
-#define TESTSTOP \
-  }; PTW32_FTIME(&currSysTimeStop); if (j + k == i) j++; }
-
 
 void
 reportTest (char * testNameString)
 {
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-
-  printf( "%-45s %15ld %15.3f\n",
-	    testNameString,
-          durationMilliSecs,
-          (float) durationMilliSecs * 1E3 / ITERATIONS);
+  bench_report(testNameString, ITERATIONS, 1);
 }
 
 
@@ -91,10 +69,7 @@ main (int argc, char *argv[])
   printf( "=============================================================================\n");
   printf( "\nOperations on a semaphore.\n%ld iterations\n\n",
           ITERATIONS);
-  printf( "%-45s %15s %15s\n",
-	    "Test",
-	    "Total(msec)",
-	    "average(usec)");
+  bench_columns();
   printf( "-----------------------------------------------------------------------------\n");
 
   /*
@@ -105,8 +80,7 @@ main (int argc, char *argv[])
   assert(1 == one);
   TESTSTOP
 
-  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
-  overHeadMilliSecs = durationMilliSecs;
+  bench_overhead(ITERATIONS);
 
 
   /*
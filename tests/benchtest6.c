@@ -0,0 +1,157 @@
+/*
+ * benchtest6.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * --------------------------------------------------------------------------
+ *
+ * Measure lock throughput and latency under contention.
+ *
+ * - Mutex, each type, and spinlock
+ *   1 to N threads lock, work for cs, unlock and work for cs again.
+ *   The latency is the time each lock call took.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+static pthread_mutex_t mx;
+static pthread_spinlock_t sp;
+
+static const int csLengths[] = { 0, 100, 1000 };
+
+void *
+mutexRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      assert(pthread_mutex_lock(&mx) == 0);
+      t->samples[i] = bench_now() - start;
+      bench_work(t->cs);
+      assert(pthread_mutex_unlock(&mx) == 0);
+      bench_work(t->cs);
+    }
+
+  return NULL;
+}
+
+void *
+spinRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      assert(pthread_spin_lock(&sp) == 0);
+      t->samples[i] = bench_now() - start;
+      bench_work(t->cs);
+      assert(pthread_spin_unlock(&sp) == 0);
+      bench_work(t->cs);
+    }
+
+  return NULL;
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const struct {
+    const char * name;
+    int type;
+  } types[] = {
+    { "normal", PTHREAD_MUTEX_NORMAL },
+    { "errorcheck", PTHREAD_MUTEX_ERRORCHECK },
+    { "recursive", PTHREAD_MUTEX_RECURSIVE }
+  }, spinKinds[] = {
+    { "default", PTHREAD_SPINLOCK_DEFAULT_NP },
+    { "ticket", PTHREAD_SPINLOCK_TICKET_NP }
+  };
+  pthread_mutexattr_t ma;
+  size_t k, c;
+  int n;
+
+  bench_header("Lock plus unlock on a contended mutex or spinlock");
+
+  for (k = 0; k < sizeof(types)/sizeof(types[0]); k++)
+    {
+      assert(pthread_mutexattr_init(&ma) == 0);
+      assert(pthread_mutexattr_settype(&ma, types[k].type) == 0);
+      assert(pthread_mutex_init(&mx, &ma) == 0);
+
+      for (c = 0; c < sizeof(csLengths)/sizeof(csLengths[0]); c++)
+        {
+          for (n = 1; n <= bench_max_threads(); n = bench_next_threads(n))
+            {
+              bench_run("mutex", types[k].name, n, csLengths[c], 0,
+                        mutexRoutine, NULL);
+            }
+        }
+
+      assert(pthread_mutex_destroy(&mx) == 0);
+      assert(pthread_mutexattr_destroy(&ma) == 0);
+    }
+
+  for (k = 0; k < sizeof(spinKinds)/sizeof(spinKinds[0]); k++)
+    {
+      assert(pthread_spin_init_np(&sp, PTHREAD_PROCESS_PRIVATE, spinKinds[k].type) == 0);
+
+      for (c = 0; c < sizeof(csLengths)/sizeof(csLengths[0]); c++)
+        {
+          for (n = 1; n <= bench_max_threads(); n = bench_next_threads(n))
+            {
+              bench_run("spinlock", spinKinds[k].name, n, csLengths[c], 0,
+                        spinRoutine, NULL);
+            }
+        }
+
+      assert(pthread_spin_destroy(&sp) == 0);
+    }
+
+  return 0;
+}
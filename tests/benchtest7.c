@@ -0,0 +1,133 @@
+/*
+ * benchtest7.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * --------------------------------------------------------------------------
+ *
+ * Measure read/write lock throughput and latency under contention.
+ *
+ * - Read/write lock, each kind, at several read/write ratios
+ *   1 to N threads take a read or write lock, work for cs, unlock and
+ *   work for cs again. The latency is the time each lock call took.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+static pthread_rwlock_t rwl;
+
+static const int csLengths[] = { 0, 100, 1000 };
+static const int readPercents[] = { 100, 90, 50 };
+
+void *
+rwlockRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      /* Spread the writes evenly over threads and operations */
+      int read = (int) ((i * 37 + t->index * 11) % 100) < t->readPercent;
+
+      start = bench_now();
+      if (read)
+        {
+          assert(pthread_rwlock_rdlock(&rwl) == 0);
+        }
+      else
+        {
+          assert(pthread_rwlock_wrlock(&rwl) == 0);
+        }
+      t->samples[i] = bench_now() - start;
+      bench_work(t->cs);
+      assert(pthread_rwlock_unlock(&rwl) == 0);
+      bench_work(t->cs);
+    }
+
+  return NULL;
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const struct {
+    const char * name;
+    int kind;
+    int distributed;
+  } kinds[] = {
+    { "default", PTHREAD_RWLOCK_DEFAULT_NP, 0 },
+    { "distributed", PTHREAD_RWLOCK_DEFAULT_NP, 1 },
+    { "prefer-reader", PTHREAD_RWLOCK_PREFER_READER_NP, 0 },
+    { "prefer-writer", PTHREAD_RWLOCK_PREFER_WRITER_NP, 0 },
+    { "phase-fair", PTHREAD_RWLOCK_PHASE_FAIR_NP, 0 }
+  };
+  pthread_rwlockattr_t ra;
+  size_t k, c, r;
+  int n;
+
+  bench_header("Read or write lock plus unlock on a contended read/write lock");
+
+  for (k = 0; k < sizeof(kinds)/sizeof(kinds[0]); k++)
+    {
+      assert(pthread_rwlockattr_init(&ra) == 0);
+      assert(pthread_rwlockattr_setkind_np(&ra, kinds[k].kind) == 0);
+      assert(pthread_rwlockattr_setdistributed_np(&ra, kinds[k].distributed) == 0);
+      assert(pthread_rwlock_init(&rwl, &ra) == 0);
+
+      for (r = 0; r < sizeof(readPercents)/sizeof(readPercents[0]); r++)
+        {
+          for (c = 0; c < sizeof(csLengths)/sizeof(csLengths[0]); c++)
+            {
+              for (n = 1; n <= bench_max_threads(); n = bench_next_threads(n))
+                {
+                  bench_run("rwlock", kinds[k].name, n, csLengths[c],
+                            readPercents[r], rwlockRoutine, NULL);
+                }
+            }
+        }
+
+      assert(pthread_rwlock_destroy(&rwl) == 0);
+      assert(pthread_rwlockattr_destroy(&ra) == 0);
+    }
+
+  return 0;
+}
@@ -0,0 +1,226 @@
+/*
+ * benchtest8.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * --------------------------------------------------------------------------
+ *
+ * Measure hand off throughput and latency between threads.
+ *
+ * - Condition variable and semaphore rings
+ *   2 to N threads pass a token round a ring, each waiting for its
+ *   turn, working for cs and waking the next thread. The latency is
+ *   the time each thread waited for the token to come round again.
+ *
+ * - Barrier, each kind
+ *   2 to N threads work for cs and wait on the barrier. The latency
+ *   is the time each wait took.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+typedef struct {
+  pthread_mutex_t mx;
+  pthread_cond_t * cv;
+  sem_t * sem;
+  int turn;
+  pthread_barrier_t barrier;
+} ring_t;
+
+static const int csLengths[] = { 0, 1000 };
+
+void *
+condRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  ring_t * ring = (ring_t *) t->arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      assert(pthread_mutex_lock(&ring->mx) == 0);
+      while (ring->turn != t->index)
+        {
+          assert(pthread_cond_wait(&ring->cv[t->index], &ring->mx) == 0);
+        }
+      t->samples[i] = bench_now() - start;
+      bench_work(t->cs);
+      ring->turn = (t->index + 1) % t->threads;
+      assert(pthread_cond_signal(&ring->cv[ring->turn]) == 0);
+      assert(pthread_mutex_unlock(&ring->mx) == 0);
+    }
+
+  return NULL;
+}
+
+void *
+semRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  ring_t * ring = (ring_t *) t->arg;
+  __int64 start;
+  long i;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      assert(sem_wait(&ring->sem[t->index]) == 0);
+      t->samples[i] = bench_now() - start;
+      bench_work(t->cs);
+      assert(sem_post(&ring->sem[(t->index + 1) % t->threads]) == 0);
+    }
+
+  return NULL;
+}
+
+void *
+barrierRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  ring_t * ring = (ring_t *) t->arg;
+  __int64 start;
+  long i;
+  int result;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      bench_work(t->cs);
+      start = bench_now();
+      result = pthread_barrier_wait(&ring->barrier);
+      assert(result == 0 || result == PTHREAD_BARRIER_SERIAL_THREAD);
+      t->samples[i] = bench_now() - start;
+    }
+
+  return NULL;
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const struct {
+    const char * name;
+    int kind;
+  } barrierKinds[] = {
+    { "default", PTHREAD_BARRIER_DEFAULT_NP },
+    { "tree", PTHREAD_BARRIER_TREE_NP }
+  };
+  pthread_barrierattr_t ba;
+  ring_t ring;
+  size_t k, c;
+  int i, n;
+
+  bench_header("Hand offs between threads");
+
+  for (c = 0; c < sizeof(csLengths)/sizeof(csLengths[0]); c++)
+    {
+      for (n = 2; n <= bench_max_threads(); n = bench_next_threads(n))
+        {
+          assert(pthread_mutex_init(&ring.mx, NULL) == 0);
+          ring.cv = (pthread_cond_t *) calloc(n, sizeof(pthread_cond_t));
+          assert(ring.cv != NULL);
+          for (i = 0; i < n; i++)
+            {
+              assert(pthread_cond_init(&ring.cv[i], NULL) == 0);
+            }
+          ring.turn = 0;
+
+          bench_run("cond-ring", "signal", n, csLengths[c], 0,
+                    condRoutine, &ring);
+
+          for (i = 0; i < n; i++)
+            {
+              assert(pthread_cond_destroy(&ring.cv[i]) == 0);
+            }
+          free(ring.cv);
+          assert(pthread_mutex_destroy(&ring.mx) == 0);
+        }
+    }
+
+  for (c = 0; c < sizeof(csLengths)/sizeof(csLengths[0]); c++)
+    {
+      for (n = 2; n <= bench_max_threads(); n = bench_next_threads(n))
+        {
+          ring.sem = (sem_t *) calloc(n, sizeof(sem_t));
+          assert(ring.sem != NULL);
+          for (i = 0; i < n; i++)
+            {
+              assert(sem_init(&ring.sem[i], 0, (i == 0)) == 0);
+            }
+
+          bench_run("sem-ring", "post", n, csLengths[c], 0,
+                    semRoutine, &ring);
+
+          for (i = 0; i < n; i++)
+            {
+              assert(sem_destroy(&ring.sem[i]) == 0);
+            }
+          free(ring.sem);
+        }
+    }
+
+  for (k = 0; k < sizeof(barrierKinds)/sizeof(barrierKinds[0]); k++)
+    {
+      assert(pthread_barrierattr_init(&ba) == 0);
+      assert(pthread_barrierattr_setkind_np(&ba, barrierKinds[k].kind) == 0);
+
+      for (c = 0; c < sizeof(csLengths)/sizeof(csLengths[0]); c++)
+        {
+          for (n = 2; n <= bench_max_threads(); n = bench_next_threads(n))
+            {
+              assert(pthread_barrier_init(&ring.barrier, &ba, n) == 0);
+
+              bench_run("barrier", barrierKinds[k].name, n, csLengths[c], 0,
+                        barrierRoutine, &ring);
+
+              assert(pthread_barrier_destroy(&ring.barrier) == 0);
+            }
+        }
+
+      assert(pthread_barrierattr_destroy(&ba) == 0);
+    }
+
+  return 0;
+}
@@ -0,0 +1,210 @@
+/*
+ * benchtest9.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * --------------------------------------------------------------------------
+ *
+ * Measure the cost of starting and ending threads.
+ *
+ * - spawn
+ *   The latency is from calling pthread_create to the first instruction
+ *   of the new thread's start routine.
+ *
+ * - create-join
+ *   The latency is a whole pthread_create and pthread_join of a thread
+ *   that returns at once.
+ *
+ * - create-detach
+ *   As create-join, but the thread is created detached and the creator
+ *   waits on a semaphore the thread posts.
+ *
+ * 1 to N creating threads run each benchmark at once. The "reuse"
+ * variant only reuses thread structs (ptw32_threadReusePop), the
+ * "cache" variant also hands the start routine to an OS thread parked
+ * in the thread cache (pthread_setthreadcache_np) instead of calling
+ * _beginthreadex. The read% column is unused.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define SPAWN_OPS	1000L		/* Threads created per creator and run */
+
+typedef struct {
+  __int64 started;
+  sem_t * done;
+} child_t;
+
+void *
+child(void * arg)
+{
+  child_t * c = (child_t *) arg;
+
+  c->started = bench_now();
+
+  if (c->done != NULL)
+    {
+      assert(sem_post(c->done) == 0);
+    }
+
+  return NULL;
+}
+
+void *
+spawnRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  pthread_t tid;
+  child_t c;
+  __int64 start;
+  long i;
+
+  c.done = NULL;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      assert(pthread_create(&tid, NULL, child, &c) == 0);
+      assert(pthread_join(tid, NULL) == 0);
+      t->samples[i] = c.started - start;
+    }
+
+  return NULL;
+}
+
+void *
+joinRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  pthread_t tid;
+  child_t c;
+  __int64 start;
+  long i;
+
+  c.done = NULL;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      assert(pthread_create(&tid, NULL, child, &c) == 0);
+      assert(pthread_join(tid, NULL) == 0);
+      t->samples[i] = bench_now() - start;
+    }
+
+  return NULL;
+}
+
+void *
+detachRoutine(void * arg)
+{
+  bench_thread_t * t = (bench_thread_t *) arg;
+  pthread_attr_t * attr = (pthread_attr_t *) t->arg;
+  pthread_t tid;
+  sem_t done;
+  child_t c;
+  __int64 start;
+  long i;
+
+  assert(sem_init(&done, 0, 0) == 0);
+  c.done = &done;
+
+  bench_start(t);
+
+  for (i = 0; i < t->ops; i++)
+    {
+      start = bench_now();
+      assert(pthread_create(&tid, attr, child, &c) == 0);
+      assert(sem_wait(&done) == 0);
+      t->samples[i] = bench_now() - start;
+    }
+
+  assert(sem_destroy(&done) == 0);
+
+  return NULL;
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const struct {
+    const char * name;
+    void * (*routine)(void *);
+  } benches[] = {
+    { "spawn", spawnRoutine },
+    { "create-join", joinRoutine },
+    { "create-detach", detachRoutine }
+  };
+  pthread_attr_t detached;
+  int oldMax;
+  size_t b;
+  int cache, n;
+
+  assert(pthread_attr_init(&detached) == 0);
+  assert(pthread_attr_setdetachstate(&detached, PTHREAD_CREATE_DETACHED) == 0);
+  assert(pthread_getthreadcache_np(&oldMax) == 0);
+
+  benchOps = SPAWN_OPS;
+  bench_header("Thread creation and ending");
+
+  for (b = 0; b < sizeof(benches)/sizeof(benches[0]); b++)
+    {
+      for (cache = 0; cache <= 1; cache++)
+        {
+          for (n = 1; n <= bench_max_threads(); n = bench_next_threads(n))
+            {
+              /*
+               * Each creator has one child alive at a time, so n parked
+               * OS threads are enough for the cache to always hit.
+               */
+              assert(pthread_setthreadcache_np(cache ? n : 0) == 0);
+
+              bench_run(benches[b].name, cache ? "cache" : "reuse", n, 0, 0,
+                        benches[b].routine, &detached);
+            }
+        }
+    }
+
+  assert(pthread_setthreadcache_np(oldMax) == 0);
+  assert(pthread_attr_destroy(&detached) == 0);
+
+  return 0;
+}
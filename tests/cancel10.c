@@ -0,0 +1,126 @@
+/*
+ * File: cancel10.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ *
+ * Test Synopsis: Test that a deferred cancel requested before the
+ * target thread starts running is acted on by its first cancellation
+ * point.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_testcancel and pthread_delay_np see a cancel that
+ *   pthread_cancel made while the thread was still being created.
+ *
+ * Features Tested:
+ * - Deferred cancellation.
+ *
+ * Cases Tested:
+ * - The thread is canceled straight after it is created, usually
+ *   before it runs, with pthread_testcancel as its first
+ *   cancellation point.
+ * - As above, with pthread_delay_np as the first cancellation point.
+ *
+ * Environment:
+ * - 
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - have working pthread_create, pthread_cancel, pthread_join
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+void *
+testcancelThread(void * arg)
+{
+  /*
+   * Loops forever if the cancel is lost.
+   */
+  for (;;)
+    {
+      pthread_testcancel();
+      sched_yield();
+    }
+
+  return arg;
+}
+
+void *
+delayThread(void * arg)
+{
+  struct timespec interval = {5, 0};
+
+  assert(pthread_delay_np(&interval) == 0);
+
+  return arg;
+}
+
+int
+main()
+{
+  void * (*funcs[2])(void *) = { testcancelThread, delayThread };
+  int i;
+
+  for (i = 0; i < 2; i++)
+    {
+      pthread_t t;
+      void * result = NULL;
+
+      /*
+       * The thread may run before or after pthread_cancel;
+       * either way it has to exit canceled.
+       */
+      assert(pthread_create(&t, NULL, funcs[i], (void *)(size_t)1) == 0);
+      assert(pthread_cancel(t) == 0);
+      assert(pthread_join(t, &result) == 0);
+      assert(result == PTHREAD_CANCELED);
+    }
+
+  return 0;
+}
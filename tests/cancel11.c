@@ -0,0 +1,131 @@
+/*
+ * File: cancel11.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ *
+ * Test Synopsis: Test that a deferred cancel aborts a blocking
+ * ReadFile made in a pthread_io_begin_np region.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_cancel aborts the synchronous I/O of a thread in a
+ *   cancelable I/O region, and the thread acts on the cancel at
+ *   pthread_io_end_np.
+ *
+ * Features Tested:
+ * - Deferred cancellation.
+ *
+ * Cases Tested:
+ * - The thread blocks reading an anonymous pipe nobody writes to.
+ * - pthread_io_end_np outside a region fails.
+ *
+ * Environment:
+ * - Windows Vista or later; the test passes trivially without
+ *   CancelSynchronousIo.
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - have working pthread_create, pthread_cancel, pthread_join
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+static HANDLE readH;
+static volatile int inRegion = 0;
+static volatile int readReturned = 0;
+
+void *
+readerThread(void * arg)
+{
+  char buf[16];
+  DWORD n;
+
+  assert(pthread_io_begin_np() == 0);
+  inRegion = 1;
+  (void) ReadFile(readH, buf, sizeof(buf), &n, NULL);
+  readReturned = 1;
+  (void) pthread_io_end_np();
+
+  /* Not reached */
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t;
+  HANDLE writeH;
+  void * result = NULL;
+
+  assert(pthread_io_end_np() == EPERM);
+
+  if (GetProcAddress(GetModuleHandle(TEXT("kernel32.dll")), "CancelSynchronousIo") == NULL)
+    {
+      return 0;
+    }
+
+  assert(CreatePipe(&readH, &writeH, NULL, 0));
+
+  assert(pthread_create(&t, NULL, readerThread, NULL) == 0);
+  while (!inRegion)
+    {
+      Sleep(1);
+    }
+  /* Let it block in ReadFile */
+  Sleep(100);
+
+  assert(pthread_cancel(t) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert(result == PTHREAD_CANCELED);
+  assert(readReturned == 1);
+
+  CloseHandle(readH);
+  CloseHandle(writeH);
+
+  return 0;
+}
@@ -0,0 +1,121 @@
+/* 
+ * cleanup4.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Nested cleanup handlers run innermost first, both in a POSIX thread
+ * that exits with them pushed and in a Win32 thread that pops them.
+ *
+ * Depends on API functions:
+ *	pthread_cleanup_push()
+ *	pthread_cleanup_pop()
+ *	pthread_create()
+ *	pthread_exit()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+#include <process.h>
+
+static int order[4];
+static int nRun;
+
+static void
+handler(void * arg)
+{
+  order[nRun++] = (int)(size_t) arg;
+}
+
+void *
+func(void * arg)
+{
+#ifdef _MSC_VER
+#pragma inline_depth(0)
+#endif
+  pthread_cleanup_push(handler, (void *) 1);
+  pthread_cleanup_push(handler, (void *) 2);
+  pthread_exit(arg);
+  pthread_cleanup_pop(0);
+  pthread_cleanup_pop(0);
+#ifdef _MSC_VER
+#pragma inline_depth()
+#endif
+
+  return NULL;
+}
+
+#if ! defined (__MINGW32__) || defined (__MSVCRT__)
+unsigned __stdcall
+#else
+void
+#endif
+Win32thread(void * arg)
+{
+  pthread_cleanup_push(handler, (void *) 3);
+  pthread_cleanup_push(handler, (void *) 4);
+  pthread_cleanup_pop(1);
+  pthread_cleanup_pop(1);
+
+#if ! defined (__MINGW32__) || defined (__MSVCRT__)
+  return 0;
+#endif
+}
+
+int
+main()
+{
+  pthread_t t;
+  void * result;
+  HANDLE h;
+  unsigned thrAddr;
+
+  assert(pthread_create(&t, NULL, func, (void *) 5) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert((int)(size_t) result == 5);
+  assert(nRun == 2);
+  assert(order[0] == 2 && order[1] == 1);
+
+#if ! defined (__MINGW32__) || defined (__MSVCRT__)
+  h = (HANDLE) _beginthreadex(NULL, 0, Win32thread, NULL, 0, &thrAddr);
+#else
+  h = (HANDLE) _beginthread(Win32thread, 0, NULL);
+#endif
+  assert(h != 0);
+  assert(WaitForSingleObject(h, INFINITE) == WAIT_OBJECT_0);
+  assert(CloseHandle(h));
+  assert(nRun == 4);
+  assert(order[2] == 4 && order[3] == 3);
+
+  return 0;
+}
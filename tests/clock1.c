@@ -0,0 +1,143 @@
+/* 
+ * clock1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ *
+ * Test clock_gettime and clock_getres: every clock reads and has a
+ * resolution, CLOCK_REALTIME agrees with time(), CLOCK_MONOTONIC never
+ * goes backwards and is the clock that CLOCK_MONOTONIC timeouts are
+ * measured against, and the thread CPU time clock advances while the
+ * thread computes.
+ *
+ * Depends on API functions:
+ *	clock_gettime()
+ *	clock_getres()
+ *	sem_clockwait()
+ */
+
+#include "test.h"
+
+#if defined(PTW32_CLOCK_GETTIME)
+
+static int64_t
+toNanosecs(const struct timespec * ts)
+{
+  return (int64_t) ts->tv_sec * 1000000000 + ts->tv_nsec;
+}
+
+int
+main()
+{
+  static const clockid_t clocks[] = {
+    CLOCK_REALTIME, CLOCK_MONOTONIC,
+    CLOCK_PROCESS_CPUTIME_ID, CLOCK_THREAD_CPUTIME_ID
+  };
+  struct timespec ts, last;
+  sem_t sem;
+  int64_t cpu;
+  int i;
+
+  for (i = 0; i < (int) (sizeof(clocks) / sizeof(clocks[0])); i++)
+    {
+      assert(clock_gettime(clocks[i], &ts) == 0);
+      assert(ts.tv_nsec >= 0 && ts.tv_nsec < 1000000000);
+      assert(clock_getres(clocks[i], &ts) == 0);
+      assert(toNanosecs(&ts) > 0);
+      assert(clock_getres(clocks[i], NULL) == 0);
+    }
+
+  assert(clock_gettime((clockid_t) 99, &ts) == -1);
+  assert(errno == EINVAL);
+  assert(clock_getres((clockid_t) 99, &ts) == -1);
+  assert(errno == EINVAL);
+  assert(clock_gettime(CLOCK_REALTIME, NULL) == -1);
+  assert(errno == EINVAL);
+
+  assert(clock_gettime(CLOCK_REALTIME, &ts) == 0);
+  assert(ts.tv_sec - (long) time(NULL) <= 1 && (long) time(NULL) - ts.tv_sec <= 1);
+
+  assert(clock_gettime(CLOCK_MONOTONIC, &last) == 0);
+  for (i = 0; i < 100000; i++)
+    {
+      assert(clock_gettime(CLOCK_MONOTONIC, &ts) == 0);
+      assert(toNanosecs(&ts) >= toNanosecs(&last));
+      last = ts;
+    }
+
+  /*
+   * A monotonic deadline built from clock_gettime has passed by
+   * clock_gettime when a wait against it times out.
+   */
+  assert(sem_init(&sem, 0, 0) == 0);
+  assert(clock_gettime(CLOCK_MONOTONIC, &ts) == 0);
+  ts.tv_nsec += 50000000;
+  if (ts.tv_nsec >= 1000000000)
+    {
+      ts.tv_sec++;
+      ts.tv_nsec -= 1000000000;
+    }
+  assert(sem_clockwait(&sem, CLOCK_MONOTONIC, &ts) == -1);
+  assert(errno == ETIMEDOUT);
+  assert(clock_gettime(CLOCK_MONOTONIC, &last) == 0);
+  assert(toNanosecs(&last) >= toNanosecs(&ts));
+  assert(sem_destroy(&sem) == 0);
+
+  /*
+   * Spin until the thread has been charged some CPU time.
+   */
+  assert(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0);
+  cpu = toNanosecs(&ts);
+  do
+    {
+      assert(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0);
+      assert(toNanosecs(&ts) >= cpu);
+    }
+  while (toNanosecs(&ts) == cpu);
+
+  assert(clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &last) == 0);
+  assert(toNanosecs(&last) >= toNanosecs(&ts));
+
+  return 0;
+}
+
+#else /* ! PTW32_CLOCK_GETTIME */
+
+int
+main()
+{
+  printf("clock_gettime is provided by the compiler's headers: skipping test.\n");
+  return 0;
+}
+
+#endif /* PTW32_CLOCK_GETTIME */
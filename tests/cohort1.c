@@ -0,0 +1,178 @@
+/* 
+ * cohort1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Cohort mutexes: attribute handling, and mutual exclusion between
+ * threads that queue (pthread_mutex_lock) and threads that don't
+ * (pthread_mutex_timedlock, pthread_mutex_trylock), for normal and
+ * recursive mutexes. On a single node system every thread queues
+ * on node 0.
+ *
+ * Depends on API functions:
+ *	pthread_mutexattr_setfairness_np()
+ *	pthread_mutexattr_getfairness_np()
+ *	pthread_mutexattr_settype()
+ *	pthread_mutexattr_setrobust()
+ *	pthread_mutex_init()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_timedlock()
+ *	pthread_mutex_trylock()
+ *	pthread_mutex_unlock()
+ *	pthread_mutex_destroy()
+ *	pthread_create()
+ *	pthread_join()
+ *	clock_gettime()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 8,
+  ITERATIONS = 20000
+};
+
+static pthread_mutex_t mutex;
+static long counter = 0;
+static volatile long inside = 0;
+
+static void
+critical(void)
+{
+  assert(InterlockedIncrement((long *) &inside) == 1);
+  counter++;
+  assert(InterlockedDecrement((long *) &inside) == 0);
+}
+
+void *
+locker(void * arg)
+{
+  int i;
+  int mode = (int)(size_t) arg % 4;
+  struct timespec abstime;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      switch (mode)
+        {
+        case 0:
+          /* Never times out */
+          assert(clock_gettime(CLOCK_REALTIME, &abstime) == 0);
+          abstime.tv_sec += 3600;
+          assert(pthread_mutex_timedlock(&mutex, &abstime) == 0);
+          break;
+        case 1:
+          while (pthread_mutex_trylock(&mutex) != 0)
+            {
+              sched_yield();
+            }
+          break;
+        default:
+          assert(pthread_mutex_lock(&mutex) == 0);
+          break;
+        }
+      critical();
+      assert(pthread_mutex_unlock(&mutex) == 0);
+    }
+
+  return NULL;
+}
+
+static void
+contend(int type)
+{
+  pthread_mutexattr_t ma;
+  pthread_t t[NUMTHREADS];
+  int i;
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_setfairness_np(&ma, PTHREAD_MUTEX_NUMA_COHORT_NP) == 0);
+  assert(pthread_mutexattr_settype(&ma, type) == 0);
+  assert(pthread_mutex_init(&mutex, &ma) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  if (type == PTHREAD_MUTEX_RECURSIVE)
+    {
+      assert(pthread_mutex_lock(&mutex) == 0);
+      assert(pthread_mutex_lock(&mutex) == 0);
+      assert(pthread_mutex_trylock(&mutex) == 0);
+      assert(pthread_mutex_unlock(&mutex) == 0);
+      assert(pthread_mutex_unlock(&mutex) == 0);
+      assert(pthread_mutex_unlock(&mutex) == 0);
+    }
+  else if (type == PTHREAD_MUTEX_ERRORCHECK)
+    {
+      assert(pthread_mutex_lock(&mutex) == 0);
+      assert(pthread_mutex_lock(&mutex) == EDEADLK);
+      assert(pthread_mutex_unlock(&mutex) == 0);
+      assert(pthread_mutex_unlock(&mutex) == EPERM);
+    }
+
+  counter = 0;
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, locker, (void *)(size_t) i) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(counter == NUMTHREADS * ITERATIONS);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+}
+
+int
+main()
+{
+  pthread_mutexattr_t ma;
+  int fairness;
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_setfairness_np(&ma, PTHREAD_MUTEX_NUMA_COHORT_NP) == 0);
+  assert(pthread_mutexattr_getfairness_np(&ma, &fairness) == 0);
+  assert(fairness == PTHREAD_MUTEX_NUMA_COHORT_NP);
+  assert(pthread_mutexattr_setfairness_np(&ma, PTHREAD_MUTEX_NUMA_COHORT_NP + 1) == EINVAL);
+
+  /* Robust mutexes can't be cohort mutexes */
+  assert(pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_ROBUST) == 0);
+  assert(pthread_mutex_init(&mutex, &ma) == ENOSYS);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  contend(PTHREAD_MUTEX_NORMAL);
+  contend(PTHREAD_MUTEX_ERRORCHECK);
+  contend(PTHREAD_MUTEX_RECURSIVE);
+
+  return 0;
+}
@@ -3,57 +3,77 @@
 #
 
 ALL_KNOWN_TESTS = \
-	affinity1 affinity2 affinity3 affinity4 affinity5 affinity6 \
-	barrier1 barrier2 barrier3 barrier4 barrier5 barrier6 \
+	affinity1 affinity2 affinity3 affinity4 affinity5 affinity6 affinity7 affinity8 \
+	numa1 \
+	barrier1 barrier2 barrier3 barrier4 barrier5 barrier6 barrier7 barrier8 \
+	latch1 phaser1 \
 	cancel1 cancel2 cancel3 cancel4 cancel5 cancel6a cancel6d \
-	cancel7 cancel8 cancel9 \
-	cleanup0 cleanup1 cleanup2 cleanup3 \
+	cancel7 cancel8 cancel9 cancel10 cancel11 \
+	cleanup0 cleanup1 cleanup2 cleanup3 cleanup4 \
+	clock1 \
 	condvar1 condvar1_1 condvar1_2 condvar2 condvar2_1 \
 	condvar3 condvar3_1 condvar3_2 condvar3_3 \
 	condvar4 condvar5 condvar6 \
-	condvar7 condvar8 condvar9 \
-	timeouts \
+	condvar7 condvar8 condvar9 condvar10 condvar11 condvar12 condvar13 \
+	timeouts timeouts2 timeouts3 \
+	reltime1 timerslack1 timer1 waitaddr1 waitany1 \
 	count1 \
 	context1 \
-	create1 create2 create3 \
-	delay1 delay2 \
+	create1 create2 create3 create4 create5 create6 create7 \
+	delay1 delay2 delay3 \
 	detach1 \
 	equal1 \
 	errno1 \
 	exception1 exception2 exception3_0 exception3 \
-	exit1 exit2 exit3 exit4 exit5 exit6 \
+	exit1 exit2 exit3 exit4 exit5 exit6 exit7 exit8 \
 	eyal1 \
-	join0 join1 join2 join3 join4 \
-	kill1 \
+	inline1 inline2 \
+	join0 join1 join2 join3 join4 join5 join6 joinasync1 \
+	kill1 kill2 kill3 group1 \
+	lockstat1 lockprof1 lockwatch1 \
+	libstats1 histograms1 flightrec1 waitgraph1 param1 \
 	mutex1 mutex1n mutex1e mutex1r \
 	mutex2 mutex2r mutex2e mutex3 mutex3r mutex3e \
 	mutex4 mutex5 mutex6 mutex6n mutex6e mutex6r \
 	mutex6s mutex6es mutex6rs \
 	mutex7 mutex7n mutex7e mutex7r \
 	mutex8 mutex8n mutex8e mutex8r \
-	name_np1 name_np2 \
-	once1 once2 once3 once4 \
-	priority1 priority2 inherit1 \
+	mutex9 mutex10 mutex11 \
+	fair1 prio1 elide1 cohort1 mcs1 lockstripe1 \
+	name_np1 name_np2 name_np3 \
+	once1 once2 once3 once4 once5 \
+	pool1 pool2 pool3 pool4 pool5 cputokens1 \
+	pooled1 async1 iocp1 \
+	queue1 queue2 wsdeque1 spsc1 \
+	priority1 priority2 priority3 inherit1 priority4 \
+	qos1 wakeboost1 yield1 \
+	pshared1 pshared2 pshared3 \
 	reinit1 \
-	reuse1 reuse2 \
+	reuse1 reuse2 reuse3 reuse4 reuse5 \
 	robust1 robust2 robust3 robust4 robust5 \
 	rwlock1 rwlock2 rwlock3 rwlock4 \
 	rwlock2_t rwlock3_t rwlock4_t rwlock5_t rwlock6_t rwlock6_t2 \
-	rwlock5 rwlock6 rwlock7 rwlock8 \
-	self1 self2 \
+	rwlock5 rwlock6 rwlock7 rwlock8 rwlock9 rwlock10 rwlock11 rwlock12 \
+	scope1 \
+	self1 self2 self3 self4 \
 	semaphore1 semaphore2 semaphore3 \
-	semaphore4 semaphore4t semaphore5 \
+	semaphore4 semaphore4t semaphore5 semaphore6 semaphore7 \
+	semaphore8 semaphore9 semaphore10 semaphore11 semaphore12 \
+	seqlock1 rwspin1 rcu1 hazard1 percpu1 counter1 \
 	sequence1 \
 	sizes \
-	spin1 spin2 spin3 spin4 \
-	stress1 threestage \
-	tsd1 tsd2 tsd3 \
+	spin1 spin2 spin3 spin4 spin5 spin6 spin7 \
+	static1 storage1 objalign1 slab1 attrinit1 array1 arena1 largepage1 \
+	stress1 threadstats1 threestage \
+	tsd1 tsd2 tsd3 tsd4 tsd5 tsd6 tsd7 \
 	valid1 valid2
 
 TESTS = $(ALL_KNOWN_TESTS)
 
 BENCHTESTS = \
-	benchtest1 benchtest2 benchtest3 benchtest4 benchtest5
+	benchtest1 benchtest2 benchtest3 benchtest4 benchtest5 \
+	benchtest6 benchtest7 benchtest8 benchtest9 benchtest10 \
+	benchtest11 benchtest12 benchtest13
 
 # Output useful info if no target given. I.e. the first target that "make" sees is used in this case.
 default_target: help
@@ -0,0 +1,146 @@
+/* 
+ * condvar10.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Signal and broadcast combined with unlocking the mutex: two threads
+ * hand a token back and forth with pthread_cond_signal_unlock_np(),
+ * then pthread_cond_broadcast_unlock_np() releases a group of waiters.
+ *
+ * Depends on API functions:
+ *	pthread_cond_signal_unlock_np()
+ *	pthread_cond_broadcast_unlock_np()
+ *	pthread_cond_wait()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_trylock()
+ *	pthread_mutex_unlock()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  NUMWAITERS = 5,
+  HANDOFFS = 2000
+};
+
+static pthread_mutex_t mx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cv = PTHREAD_COND_INITIALIZER;
+static int turn = 0;
+static int go = 0;
+static int awake = 0;
+
+void *
+pingpong(void * arg)
+{
+  int me = (int)(size_t) arg;
+  int i;
+
+  for (i = 0; i < HANDOFFS; i++)
+    {
+      assert(pthread_mutex_lock(&mx) == 0);
+      while (turn != me)
+        {
+          assert(pthread_cond_wait(&cv, &mx) == 0);
+        }
+      turn = 1 - me;
+      assert(pthread_cond_signal_unlock_np(&cv, &mx) == 0);
+    }
+
+  return NULL;
+}
+
+void *
+waiter(void * arg)
+{
+  assert(pthread_mutex_lock(&mx) == 0);
+  while (!go)
+    {
+      assert(pthread_cond_wait(&cv, &mx) == 0);
+    }
+  awake++;
+  assert(pthread_mutex_unlock(&mx) == 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMWAITERS];
+  int i;
+
+  assert(pthread_mutex_lock(&mx) == 0);
+  assert(pthread_cond_signal_unlock_np(NULL, &mx) == EINVAL);
+  assert(pthread_cond_signal_unlock_np(&cv, NULL) == EINVAL);
+  /* Still ours */
+  assert(pthread_mutex_unlock(&mx) == 0);
+
+  /* No waiters: just unlocks */
+  assert(pthread_mutex_lock(&mx) == 0);
+  assert(pthread_cond_signal_unlock_np(&cv, &mx) == 0);
+  assert(pthread_mutex_trylock(&mx) == 0);
+  assert(pthread_cond_broadcast_unlock_np(&cv, &mx) == 0);
+  assert(pthread_mutex_trylock(&mx) == 0);
+  assert(pthread_mutex_unlock(&mx) == 0);
+
+  assert(pthread_create(&t[0], NULL, pingpong, (void *)(size_t) 0) == 0);
+  assert(pthread_create(&t[1], NULL, pingpong, (void *)(size_t) 1) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(pthread_join(t[1], NULL) == 0);
+  assert(turn == 0);
+
+  for (i = 0; i < NUMWAITERS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, waiter, NULL) == 0);
+    }
+
+  Sleep(200);
+
+  assert(pthread_mutex_lock(&mx) == 0);
+  go = 1;
+  assert(pthread_cond_broadcast_unlock_np(&cv, &mx) == 0);
+
+  for (i = 0; i < NUMWAITERS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(awake == NUMWAITERS);
+
+  assert(pthread_cond_destroy(&cv) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  return 0;
+}
@@ -0,0 +1,126 @@
+/* 
+ * condvar11.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Condition variable waits with cancellation disabled: a cancel request
+ * made during the wait doesn't end it, the waiter returns holding the
+ * mutex when signalled or timed out, and the request is acted on once
+ * the waiter enables cancellation again.
+ *
+ * Depends on API functions:
+ *	pthread_cond_wait()
+ *	pthread_cond_timedwait()
+ *	pthread_cond_signal()
+ *	pthread_setcancelstate()
+ *	pthread_testcancel()
+ *	pthread_cancel()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+static pthread_mutex_t mx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cv = PTHREAD_COND_INITIALIZER;
+static int ready = 0;
+static int waiting = 0;
+static int timedOut = 0;
+
+void *
+waiter(void * arg)
+{
+  struct timespec abstime = { 0, 0 };
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+  int oldstate;
+
+  assert(pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldstate) == 0);
+  assert(oldstate == PTHREAD_CANCEL_ENABLE);
+
+  assert(pthread_mutex_lock(&mx) == 0);
+
+  PTW32_FTIME(&currSysTime);
+  abstime.tv_sec = (long)currSysTime.time + 1;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+  assert(pthread_cond_timedwait(&cv, &mx, &abstime) == ETIMEDOUT);
+  timedOut = 1;
+
+  waiting = 1;
+  while (!ready)
+    {
+      assert(pthread_cond_wait(&cv, &mx) == 0);
+    }
+  assert(pthread_mutex_unlock(&mx) == 0);
+
+  assert(pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL) == 0);
+  pthread_testcancel();
+
+  /* Never reached */
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t;
+  void * result = NULL;
+  int w = 0;
+
+  assert(pthread_create(&t, NULL, waiter, NULL) == 0);
+
+  while (!w)
+    {
+      Sleep(50);
+      assert(pthread_mutex_lock(&mx) == 0);
+      w = waiting;
+      assert(pthread_mutex_unlock(&mx) == 0);
+    }
+
+  assert(pthread_cancel(t) == 0);
+  Sleep(100);
+
+  assert(pthread_mutex_lock(&mx) == 0);
+  ready = 1;
+  assert(pthread_cond_signal(&cv) == 0);
+  assert(pthread_mutex_unlock(&mx) == 0);
+
+  assert(pthread_join(t, &result) == 0);
+  assert(result == PTHREAD_CANCELED);
+  assert(timedOut == 1);
+
+  assert(pthread_cond_destroy(&cv) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+/* 
+ * condvar12.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Condition variables with a spin budget: the attribute is checked and
+ * read back, a ping-pong between two threads loses no signals, and
+ * timed waits still time out.
+ *
+ * Depends on API functions:
+ *	pthread_condattr_setspin_np()
+ *	pthread_condattr_getspin_np()
+ *	pthread_cond_wait()
+ *	pthread_cond_timedwait()
+ *	pthread_cond_signal()
+ */
+
+#include "test.h"
+
+enum {
+  ROUNDS = 20000
+};
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cv[2];
+static int turn = 0;
+
+static void *
+player(void * arg)
+{
+  int me = (int) (size_t) arg;
+  int i;
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+
+  for (i = 0; i < ROUNDS; i++)
+    {
+      while (turn != me)
+        {
+          assert(pthread_cond_wait(&cv[me], &mutex) == 0);
+        }
+      turn = 1 - me;
+      assert(pthread_cond_signal(&cv[1 - me]) == 0);
+    }
+
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_condattr_t attr;
+  struct timespec abstime;
+  pthread_t t[2];
+  int spin;
+
+  assert(pthread_condattr_init(&attr) == 0);
+  assert(pthread_condattr_getspin_np(&attr, &spin) == 0);
+  assert(spin == 0);
+  assert(pthread_condattr_setspin_np(&attr, -1) == EINVAL);
+  assert(pthread_condattr_setspin_np(&attr, 4000) == 0);
+  assert(pthread_condattr_getspin_np(&attr, &spin) == 0);
+  assert(spin == 4000);
+  assert(pthread_condattr_getspin_np(&attr, NULL) == EINVAL);
+
+  assert(pthread_cond_init(&cv[0], &attr) == 0);
+  assert(pthread_cond_init(&cv[1], &attr) == 0);
+  assert(pthread_condattr_destroy(&attr) == 0);
+
+  assert(pthread_create(&t[0], NULL, player, (void *) 0) == 0);
+  assert(pthread_create(&t[1], NULL, player, (void *) 1) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(pthread_join(t[1], NULL) == 0);
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(clock_gettime(CLOCK_REALTIME, &abstime) == 0);
+  abstime.tv_sec += 1;
+  assert(pthread_cond_timedwait(&cv[0], &mutex, &abstime) == ETIMEDOUT);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  assert(pthread_cond_destroy(&cv[0]) == 0);
+  assert(pthread_cond_destroy(&cv[1]) == 0);
+
+  return 0;
+}
@@ -0,0 +1,182 @@
+/* 
+ * condvar13.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Condition variable waits on a reader-writer lock: several readers
+ * wait at once in shared mode, a writer waits in exclusive mode, a
+ * timed wait times out holding the lock again, and a cancelled waiter
+ * runs its cleanup handler with the lock held.
+ *
+ * Depends on API functions:
+ *	pthread_cond_wait_rwlock_np()
+ *	pthread_cond_timedwait_rwlock_np()
+ *	pthread_cond_broadcast()
+ *	pthread_cond_signal()
+ *	pthread_rwlock_rdlock()
+ *	pthread_rwlock_wrlock()
+ *	pthread_cancel()
+ */
+
+#include "test.h"
+
+enum {
+  READERS = 4
+};
+
+static pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
+static pthread_cond_t cv = PTHREAD_COND_INITIALIZER;
+static LONG waiting = 0;
+static int go = 0;
+static int value = 0;
+
+static void *
+reader(void * arg)
+{
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  InterlockedIncrement(&waiting);
+  while (!go)
+    {
+      assert(pthread_cond_wait_rwlock_np(&cv, &rwlock, 0) == 0);
+    }
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  return NULL;
+}
+
+static void *
+writer(void * arg)
+{
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  while (value != 1)
+    {
+      assert(pthread_cond_wait_rwlock_np(&cv, &rwlock, 1) == 0);
+    }
+  value = 2;
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  return NULL;
+}
+
+static void
+unlock(void * arg)
+{
+  assert(pthread_rwlock_unlock((pthread_rwlock_t *) arg) == 0);
+}
+
+static void *
+cancelled(void * arg)
+{
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  InterlockedIncrement(&waiting);
+  pthread_cleanup_push(unlock, &rwlock);
+  for (;;)
+    {
+      (void) pthread_cond_wait_rwlock_np(&cv, &rwlock, 1);
+    }
+  pthread_cleanup_pop(0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[READERS];
+  struct timespec abstime;
+  void * result;
+  int i;
+
+  assert(pthread_cond_wait_rwlock_np(&cv, NULL, 0) == EINVAL);
+
+  /* Shared waiters */
+  for (i = 0; i < READERS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, reader, NULL) == 0);
+    }
+  while (waiting < READERS)
+    {
+      Sleep(10);
+    }
+  /* Only succeeds once every reader has released the lock to wait. */
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  go = 1;
+  assert(pthread_cond_broadcast(&cv) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  for (i = 0; i < READERS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  /* Exclusive waiter */
+  assert(pthread_create(&t[0], NULL, writer, NULL) == 0);
+  Sleep(100);
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  value = 1;
+  assert(pthread_cond_signal(&cv) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(value == 2);
+
+  /* Timeout returns with the read lock held */
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  assert(clock_gettime(CLOCK_REALTIME, &abstime) == 0);
+  abstime.tv_nsec += 100000000;
+  if (abstime.tv_nsec >= 1000000000)
+    {
+      abstime.tv_sec++;
+      abstime.tv_nsec -= 1000000000;
+    }
+  assert(pthread_cond_timedwait_rwlock_np(&cv, &rwlock, 0, &abstime) == ETIMEDOUT);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  /* Cancellation takes the lock again before the cleanup handler */
+  waiting = 0;
+  assert(pthread_create(&t[0], NULL, cancelled, NULL) == 0);
+  while (waiting < 1)
+    {
+      Sleep(10);
+    }
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_cancel(t[0]) == 0);
+  assert(pthread_join(t[0], &result) == 0);
+  assert(result == PTHREAD_CANCELED);
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  assert(pthread_cond_destroy(&cv) == 0);
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+/* 
+ * counter1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Sharded counter: adds from many threads, including negative ones,
+ * sum to the right total.
+ *
+ * Depends on API functions:
+ *	pthread_counter_init_np()
+ *	pthread_counter_destroy_np()
+ *	pthread_counter_add_np()
+ *	pthread_counter_read_np()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 16,
+  ITERATIONS = 10000
+};
+
+static pthread_counter_np_t counter;
+
+void *
+adder(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_counter_add_np(counter, 3) == 0);
+      assert(pthread_counter_add_np(counter, -1) == 0);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  __int64 value = -1;
+  int i;
+
+  assert(pthread_counter_init_np(NULL) == EINVAL);
+  assert(pthread_counter_init_np(&counter) == 0);
+  assert(pthread_counter_read_np(counter, NULL) == EINVAL);
+  assert(pthread_counter_read_np(counter, &value) == 0);
+  assert(value == 0);
+
+  /* Beyond 32 bits */
+  assert(pthread_counter_add_np(counter, (__int64) 1 << 40) == 0);
+  assert(pthread_counter_read_np(counter, &value) == 0);
+  assert(value == (__int64) 1 << 40);
+  assert(pthread_counter_add_np(counter, -((__int64) 1 << 40)) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, adder, NULL) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(pthread_counter_read_np(counter, &value) == 0);
+  assert(value == (__int64) NUMTHREADS * ITERATIONS * 2);
+
+  assert(pthread_counter_destroy_np(&counter) == 0);
+  assert(counter == NULL);
+  assert(pthread_counter_destroy_np(&counter) == EINVAL);
+
+  return 0;
+}
@@ -0,0 +1,194 @@
+/* 
+ * cputokens1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Process wide processor tokens: taking and giving them back directly,
+ * waiting for them, limiting the tasks a pool runs at once, and a pool
+ * worker lending its token while it blocks.
+ *
+ * Depends on API functions:
+ *	pthread_setcputokens_np()
+ *	pthread_getcputokens_np()
+ *	pthread_cputokens_acquire_np()
+ *	pthread_cputokens_release_np()
+ *	pthread_pool_create_np()
+ *	pthread_pool_submit_np()
+ *	pthread_pool_wait_np()
+ *	pthread_setparam_np()
+ */
+
+#include "test.h"
+
+enum {
+  NUMWORKERS = 4,
+  NUMTASKS = 16
+};
+
+static LONG running = 0;
+static LONG most = 0;
+static LONG acquired = 0;
+static sem_t sem;
+
+void *
+waiter(void * arg)
+{
+  int n = 0;
+
+  assert(pthread_cputokens_acquire_np(1, 1, &n) == 0);
+  assert(n == 1);
+  InterlockedExchange(&acquired, 1);
+  assert(pthread_cputokens_release_np(n) == 0);
+
+  return NULL;
+}
+
+void *
+compute(void * arg)
+{
+  LONG now = InterlockedIncrement(&running);
+  LONG seen;
+
+  while ((seen = most) < now)
+    {
+      (void) InterlockedCompareExchange(&most, now, seen);
+    }
+
+  /* Not a library wait, so the token stays held */
+  Sleep(20);
+
+  InterlockedDecrement(&running);
+
+  return NULL;
+}
+
+void *
+blocker(void * arg)
+{
+  assert(sem_wait(&sem) == 0);
+
+  return NULL;
+}
+
+void *
+poster(void * arg)
+{
+  assert(sem_post(&sem) == 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_pool_np_t pool;
+  pthread_t t;
+  int tokens, available, n, i;
+  long value;
+
+  /* No limit by default, but tokens are counted */
+  assert(pthread_getcputokens_np(&tokens, &available) == 0);
+  assert(tokens == PTHREAD_CPUTOKENS_OFF_NP);
+  assert(available == 0);
+  assert(pthread_cputokens_acquire_np(1, 4, &n) == 0);
+  assert(n == 4);
+  assert(pthread_cputokens_release_np(n) == 0);
+
+  assert(pthread_setcputokens_np(-2) == EINVAL);
+  assert(pthread_cputokens_acquire_np(-1, 1, &n) == EINVAL);
+  assert(pthread_cputokens_acquire_np(0, 0, &n) == EINVAL);
+  assert(pthread_cputokens_acquire_np(2, 1, &n) == EINVAL);
+  assert(pthread_cputokens_acquire_np(1, 1, NULL) == EINVAL);
+  assert(pthread_cputokens_release_np(-1) == EINVAL);
+
+  /* Two tokens */
+  assert(pthread_setcputokens_np(2) == 0);
+  assert(pthread_getcputokens_np(&tokens, &available) == 0);
+  assert(tokens == 2);
+  assert(available == 2);
+  assert(pthread_cputokens_acquire_np(1, 4, &n) == 0);
+  assert(n == 2);
+  assert(pthread_getcputokens_np(NULL, &available) == 0);
+  assert(available == 0);
+  assert(pthread_cputokens_acquire_np(0, 1, &n) == 0);
+  assert(n == 0);
+  assert(pthread_cputokens_acquire_np(3, 3, &n) == EDEADLK);
+
+  /* A waiter gets a token once one is given back */
+  assert(pthread_create(&t, NULL, waiter, NULL) == 0);
+  Sleep(100);
+  assert(acquired == 0);
+  assert(pthread_cputokens_release_np(2) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(acquired == 1);
+  assert(pthread_getcputokens_np(NULL, &available) == 0);
+  assert(available == 2);
+
+  /* The pool runs no more tasks at once than there are tokens */
+  assert(pthread_pool_create_np(&pool, NULL, NUMWORKERS) == 0);
+
+  for (i = 0; i < NUMTASKS; i++)
+    {
+      assert(pthread_pool_submit_np(pool, compute, NULL, NULL) == 0);
+    }
+
+  assert(pthread_pool_wait_np(pool) == 0);
+  assert(most >= 1 && most <= 2);
+
+  /* With one token, a blocked worker lends it to the task it waits for */
+  assert(pthread_setcputokens_np(1) == 0);
+  assert(sem_init(&sem, 0, 0) == 0);
+  assert(pthread_pool_submit_np(pool, blocker, NULL, NULL) == 0);
+  Sleep(50);
+  assert(pthread_pool_submit_np(pool, poster, NULL, NULL) == 0);
+  assert(pthread_pool_wait_np(pool) == 0);
+  assert(sem_destroy(&sem) == 0);
+
+  assert(pthread_pool_destroy_np(&pool) == 0);
+
+  /* Idle workers hold none */
+  assert(pthread_getcputokens_np(&tokens, &available) == 0);
+  assert(tokens == 1);
+  assert(available == 1);
+
+  assert(pthread_setcputokens_np(PTHREAD_CPUTOKENS_PROCESSORS_NP) == 0);
+  assert(pthread_getcputokens_np(&tokens, NULL) == 0);
+  assert(tokens == pthread_num_processors_np());
+
+  assert(pthread_setparam_np(PTHREAD_PARAM_CPU_TOKENS_NP, PTHREAD_CPUTOKENS_OFF_NP) == 0);
+  assert(pthread_getparam_np(PTHREAD_PARAM_CPU_TOKENS_NP, &value) == 0);
+  assert(value == PTHREAD_CPUTOKENS_OFF_NP);
+  assert(pthread_getcputokens_np(&tokens, NULL) == 0);
+  assert(tokens == PTHREAD_CPUTOKENS_OFF_NP);
+
+  return 0;
+}
@@ -0,0 +1,202 @@
+/*
+ * File: create4.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Confirm that threads run on stacks supplied with
+ *   pthread_attr_setstack and pthread_attr_setstackaddr.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_attr_setstack, pthread_attr_getstack
+ * - pthread_attr_setstackaddr, pthread_attr_getstackaddr
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - bad stacks are rejected.
+ * - the start routine's locals lie on the supplied stack.
+ * - return, pthread_exit and cancellation all work on it.
+ * - the thread cache doesn't keep threads that ran on a supplied stack.
+ *
+ * Description:
+ * -
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - _POSIX_THREAD_ATTR_STACKADDR is supported, otherwise the test
+ *   only checks for ENOSYS.
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+	STACKSIZE = 64 * 1024
+};
+
+static char * stackLo;
+
+static int
+onStack(void * p)
+{
+  return (char *) p >= stackLo && (char *) p < stackLo + STACKSIZE;
+}
+
+static int
+recurse(int depth)
+{
+  volatile char buf[256];
+
+  buf[0] = (char) depth;
+  assert(onStack((void *) buf));
+  if (depth > 0)
+    {
+      return recurse(depth - 1) + buf[0];
+    }
+  return 0;
+}
+
+void * func(void * arg)
+{
+  int local = 0;
+
+  assert(onStack(&local));
+  assert(recurse(50) == 50 * 51 / 2);
+
+  switch ((int)(size_t) arg)
+    {
+    case 1:
+      pthread_exit((void *)(size_t) 2);
+      break;
+    case 2:
+      for (;;)
+        {
+          pthread_testcancel();
+          Sleep(1);
+        }
+      break;
+    }
+
+  return arg;
+}
+
+int
+main()
+{
+  pthread_t t;
+  pthread_attr_t attr;
+  void * result = NULL;
+  void * addr;
+  size_t size;
+  int i;
+
+  assert(pthread_attr_init(&attr) == 0);
+
+  if (pthread_attr_setstack(&attr, NULL, STACKSIZE) == ENOSYS)
+    {
+      assert(pthread_attr_getstack(&attr, &addr, &size) == ENOSYS);
+      assert(pthread_attr_setstackaddr(&attr, NULL) == ENOSYS);
+      assert(pthread_attr_destroy(&attr) == 0);
+      return 0;
+    }
+
+  stackLo = (char *) malloc(STACKSIZE);
+  assert(stackLo != NULL);
+
+  assert(pthread_attr_setstack(&attr, NULL, STACKSIZE) == EINVAL);
+  assert(pthread_attr_setstack(&attr, stackLo, 16) == EINVAL);
+  assert(pthread_attr_getstack(&attr, &addr, &size) == 0);
+  assert(addr == NULL);
+
+  /*
+   * The size is taken from pthread_attr_setstacksize.
+   */
+  assert(pthread_attr_setstackaddr(&attr, stackLo) == 0);
+  assert(pthread_attr_getstackaddr(&attr, &addr) == 0);
+  assert(addr == stackLo);
+  assert(pthread_create(&t, &attr, func, NULL) == EINVAL);
+  assert(pthread_attr_setstacksize(&attr, STACKSIZE) == 0);
+  assert(pthread_create(&t, &attr, func, (void *)(size_t) 3) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert((int)(size_t) result == 3);
+
+  assert(pthread_setthreadcache_np(2) == 0);
+
+  assert(pthread_attr_setstack(&attr, stackLo, STACKSIZE) == 0);
+  assert(pthread_attr_getstack(&attr, &addr, &size) == 0);
+  assert(addr == stackLo);
+  assert(size == STACKSIZE);
+
+  for (i = 0; i < 10; i++)
+    {
+      /* One thread at a time: it has to be joined before the stack is reused. */
+      assert(pthread_create(&t, &attr, func, (void *)(size_t) 0) == 0);
+      assert(pthread_join(t, &result) == 0);
+      assert(result == NULL);
+
+      assert(pthread_create(&t, &attr, func, (void *)(size_t) 1) == 0);
+      assert(pthread_join(t, &result) == 0);
+      assert((int)(size_t) result == 2);
+
+      assert(pthread_create(&t, &attr, func, (void *)(size_t) 2) == 0);
+      Sleep(10);
+      assert(pthread_cancel(t) == 0);
+      assert(pthread_join(t, &result) == 0);
+      assert(result == PTHREAD_CANCELED);
+    }
+
+  assert(pthread_setthreadcache_np(0) == 0);
+  assert(pthread_attr_destroy(&attr) == 0);
+  free(stackLo);
+
+  return 0;
+}
@@ -0,0 +1,177 @@
+/*
+ * File: create5.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Confirm that the stack size is a reservation and that
+ *   pthread_attr_setstackcommit_np commits the top of the stack.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_attr_setstackcommit_np, pthread_attr_getstackcommit_np
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - a large stack size leaves most of the stack uncommitted.
+ * - a commit below the stack size is committed when the thread starts.
+ * - a commit above the stack size gives at least that much stack.
+ * - the thread cache still runs threads with a commit.
+ *
+ * Description:
+ * -
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - None.
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+	RESERVE = 16 * 1024 * 1024,
+	COMMIT = 512 * 1024
+};
+
+static int
+committed(size_t below)
+{
+  NT_TIB * tib = (NT_TIB *) NtCurrentTeb();
+  MEMORY_BASIC_INFORMATION mbi;
+
+  assert(VirtualQuery((char *) tib->StackBase - below, &mbi, sizeof(mbi)) != 0);
+
+  return mbi.State == MEM_COMMIT;
+}
+
+static int
+recurse(int depth)
+{
+  volatile char buf[1024];
+
+  buf[0] = (char) depth;
+  if (depth > 0)
+    {
+      return recurse(depth - 1) + buf[0];
+    }
+  return 0;
+}
+
+void * func(void * arg)
+{
+  switch ((int)(size_t) arg)
+    {
+    case 0:
+      /* Reserved, not committed */
+      assert(!committed(RESERVE / 2));
+      break;
+    case 1:
+      assert(committed(COMMIT / 2));
+      assert(!committed(RESERVE / 2));
+      break;
+    }
+
+  /* About 2MB deep */
+  (void) recurse(2000);
+
+  return arg;
+}
+
+int
+main()
+{
+  pthread_t t;
+  pthread_attr_t attr;
+  void * result = NULL;
+  size_t commit;
+  int i;
+
+  assert(pthread_attr_init(&attr) == 0);
+  assert(pthread_attr_getstackcommit_np(&attr, &commit) == 0);
+  assert(commit == 0);
+  assert(pthread_attr_getstackcommit_np(&attr, NULL) == EINVAL);
+
+  assert(pthread_attr_setstacksize(&attr, RESERVE) == 0);
+  assert(pthread_create(&t, &attr, func, (void *)(size_t) 0) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert(result == (void *)(size_t) 0);
+
+  assert(pthread_attr_setstackcommit_np(&attr, COMMIT) == 0);
+  assert(pthread_attr_getstackcommit_np(&attr, &commit) == 0);
+  assert(commit == COMMIT);
+  assert(pthread_create(&t, &attr, func, (void *)(size_t) 1) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert(result == (void *)(size_t) 1);
+
+  /* Commit the whole stack: at least that much is reserved */
+  assert(pthread_attr_setstacksize(&attr, 64 * 1024) == 0);
+  assert(pthread_attr_setstackcommit_np(&attr, RESERVE) == 0);
+  assert(pthread_create(&t, &attr, func, (void *)(size_t) 2) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert(result == (void *)(size_t) 2);
+
+  assert(pthread_setthreadcache_np(2) == 0);
+  assert(pthread_attr_setstacksize(&attr, RESERVE) == 0);
+  assert(pthread_attr_setstackcommit_np(&attr, COMMIT) == 0);
+
+  for (i = 0; i < 10; i++)
+    {
+      assert(pthread_create(&t, &attr, func, (void *)(size_t) 1) == 0);
+      assert(pthread_join(t, &result) == 0);
+      assert(result == (void *)(size_t) 1);
+    }
+
+  assert(pthread_setthreadcache_np(0) == 0);
+  assert(pthread_attr_destroy(&attr) == 0);
+
+  return 0;
+}
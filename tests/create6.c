@@ -0,0 +1,180 @@
+/*
+ * File: create6.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Confirm that guard sizes and small stacks are honoured and that
+ *   parked threads give back their stacks.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_attr_setguardsize, pthread_attr_getguardsize
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - the default guard size is one page.
+ * - many threads with 64 KB stacks and a larger guard run.
+ * - a thread from the thread cache starts with its stack decommitted.
+ *
+ * Description:
+ * -
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - None.
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+	SMALL = 64 * 1024,
+	GUARD = 16 * 1024,
+	NUMTHREADS = 200,
+	DEEP = 1024 * 1024
+};
+
+static int
+committed(size_t below)
+{
+  NT_TIB * tib = (NT_TIB *) NtCurrentTeb();
+  MEMORY_BASIC_INFORMATION mbi;
+
+  assert(VirtualQuery((char *) tib->StackBase - below, &mbi, sizeof(mbi)) != 0);
+
+  return mbi.State == MEM_COMMIT;
+}
+
+static int
+recurse(int depth)
+{
+  volatile char buf[1024];
+
+  buf[0] = (char) depth;
+  if (depth > 0)
+    {
+      return recurse(depth - 1) + buf[0];
+    }
+  return 0;
+}
+
+void * small(void * arg)
+{
+  /* About 32 KB deep */
+  (void) recurse(32);
+
+  return arg;
+}
+
+void * deep(void * arg)
+{
+  if (arg != NULL)
+    {
+      assert(!committed(DEEP / 2));
+    }
+
+  (void) recurse(DEEP / 1024);
+  assert(committed(DEEP / 2));
+
+  return arg;
+}
+
+int
+main()
+{
+  static pthread_t t[NUMTHREADS];
+  pthread_attr_t attr;
+  void * result = NULL;
+  size_t guardsize;
+  int i;
+
+  assert(pthread_attr_init(&attr) == 0);
+  assert(pthread_attr_getguardsize(&attr, &guardsize) == 0);
+  assert(guardsize == 4096);
+  assert(pthread_attr_getguardsize(&attr, NULL) == EINVAL);
+
+  assert(pthread_attr_setstacksize(&attr, SMALL) == 0);
+  assert(pthread_attr_setguardsize(&attr, GUARD) == 0);
+  assert(pthread_attr_getguardsize(&attr, &guardsize) == 0);
+  assert(guardsize == GUARD);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], &attr, small, (void *)(size_t) i) == 0);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], &result) == 0);
+      assert(result == (void *)(size_t) i);
+    }
+
+  assert(pthread_attr_setguardsize(&attr, 0) == 0);
+  assert(pthread_create(&t[0], &attr, small, NULL) == 0);
+  assert(pthread_join(t[0], &result) == 0);
+
+  /*
+   * The second thread runs on the first's parked OS thread, whose
+   * stack was committed a megabyte deep.
+   */
+  assert(pthread_attr_setstacksize(&attr, 4 * DEEP) == 0);
+  assert(pthread_attr_setguardsize(&attr, 4096) == 0);
+  assert(pthread_setthreadcache_np(1) == 0);
+  assert(pthread_create(&t[0], &attr, deep, NULL) == 0);
+  assert(pthread_join(t[0], &result) == 0);
+  assert(pthread_create(&t[0], &attr, deep, (void *) &t[0]) == 0);
+  assert(pthread_join(t[0], &result) == 0);
+  assert(pthread_setthreadcache_np(0) == 0);
+  assert(pthread_attr_destroy(&attr) == 0);
+
+  return 0;
+}
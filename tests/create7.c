@@ -0,0 +1,194 @@
+/* 
+ * create7.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Test pthread_create_payload_np.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_create_payload_np
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - the thread gets an aligned copy of the payload, not the caller's.
+ * - the caller may change the payload once the call has returned.
+ * - a payload of PTHREAD_PAYLOAD_MAX_NP bytes, and of none.
+ * - too large a payload, or a NULL one with a size, is EINVAL.
+ * - detached threads with payloads, reusing thread structs.
+ *
+ * Description:
+ * -
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - None.
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+	NUMTHREADS = 100
+};
+
+typedef struct {
+  int id;
+  double scale;
+  void * caller;
+} args_t;
+
+static volatile LONG done = 0;
+
+static void *
+worker(void * arg)
+{
+  args_t * a = (args_t *) arg;
+
+  assert(a != NULL);
+  assert(a != a->caller);
+  assert(((size_t) a % sizeof(double)) == 0);
+  assert(a->scale == 0.5);
+
+  return (void *) (size_t) a->id;
+}
+
+static void *
+full(void * arg)
+{
+  unsigned char * bytes = (unsigned char *) arg;
+  int i;
+
+  for (i = 0; i < PTHREAD_PAYLOAD_MAX_NP; i++)
+    {
+      assert(bytes[i] == (unsigned char) i);
+      bytes[i] = 0;
+    }
+
+  return NULL;
+}
+
+static void *
+none(void * arg)
+{
+  assert(arg == NULL);
+
+  return NULL;
+}
+
+static void *
+detached(void * arg)
+{
+  assert(((args_t *) arg)->id == 42);
+  InterlockedIncrement((LPLONG)&done);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  pthread_attr_t attr;
+  args_t a;
+  unsigned char bytes[PTHREAD_PAYLOAD_MAX_NP + 1];
+  void * result;
+  int i;
+
+  a.scale = 0.5;
+  a.caller = &a;
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      a.id = i;
+      assert(pthread_create_payload_np(&t[i], NULL, worker, &a, sizeof(a)) == 0);
+    }
+  a.scale = 0;
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], &result) == 0);
+      assert((int) (size_t) result == i);
+    }
+
+  for (i = 0; i < (int) sizeof(bytes); i++)
+    {
+      bytes[i] = (unsigned char) i;
+    }
+  assert(pthread_create_payload_np(&t[0], NULL, full, bytes, PTHREAD_PAYLOAD_MAX_NP) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+  for (i = 0; i < (int) sizeof(bytes); i++)
+    {
+      assert(bytes[i] == (unsigned char) i);
+    }
+
+  assert(pthread_create_payload_np(&t[0], NULL, none, NULL, 0) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(pthread_create_payload_np(&t[0], NULL, none, bytes, 0) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+
+  assert(pthread_create_payload_np(&t[0], NULL, full, bytes, sizeof(bytes)) == EINVAL);
+  assert(pthread_create_payload_np(&t[0], NULL, full, NULL, 1) == EINVAL);
+
+  assert(pthread_attr_init(&attr) == 0);
+  assert(pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) == 0);
+  a.id = 42;
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create_payload_np(&t[i], &attr, detached, &a, sizeof(a)) == 0);
+    }
+  while (done < NUMTHREADS)
+    {
+      Sleep(10);
+    }
+  assert(pthread_attr_destroy(&attr) == 0);
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+/* 
+ * delay3.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Short delays: pthread_delay_np and nanosleep never return before the
+ * interval has passed, with cancellation enabled or disabled, and reject
+ * an invalid interval.
+ *
+ * Depends on API functions:
+ *	pthread_delay_np()
+ *	nanosleep()
+ *	pthread_setcancelstate()
+ */
+
+#include "test.h"
+
+/* CLOCK_MONOTONIC now in 100 nanosecond units */
+static int64_t
+now100ns(void)
+{
+  LARGE_INTEGER c, f;
+
+  assert(QueryPerformanceCounter(&c));
+  assert(QueryPerformanceFrequency(&f));
+  return (c.QuadPart / f.QuadPart) * 10000000
+         + (c.QuadPart % f.QuadPart) * 10000000 / f.QuadPart;
+}
+
+static void
+delay(long nsec)
+{
+  struct timespec interval;
+  int64_t start;
+
+  interval.tv_sec = 0;
+  interval.tv_nsec = nsec;
+  start = now100ns();
+  assert(pthread_delay_np(&interval) == 0);
+  assert(now100ns() - start >= nsec / 100);
+}
+
+int
+main()
+{
+  struct timespec interval = {0, 1000000000L};
+  int oldstate;
+  int i;
+
+  assert(pthread_delay_np(&interval) == EINVAL);
+  interval.tv_nsec = -1;
+  assert(pthread_delay_np(&interval) == EINVAL);
+
+  for (i = 0; i < 10; i++)
+    {
+      delay(100000L);	/* 100 microseconds */
+      delay(30000L);	/* Less than the final spin */
+      delay(2500000L);	/* More than a high resolution wait limit */
+    }
+
+  assert(pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldstate) == 0);
+  for (i = 0; i < 10; i++)
+    {
+      delay(100000L);
+      delay(30000L);
+    }
+  assert(pthread_setcancelstate(oldstate, &oldstate) == 0);
+
+#if defined(PTW32_CLOCK_GETTIME)
+  {
+    struct timespec rem = {1, 1};
+    int64_t start;
+
+    interval.tv_nsec = 1000000000L;
+    assert(nanosleep(&interval, NULL) == -1);
+    assert(errno == EINVAL);
+
+    interval.tv_nsec = 200000L;
+    start = now100ns();
+    assert(nanosleep(&interval, &rem) == 0);
+    assert(now100ns() - start >= 2000);
+    assert(rem.tv_sec == 0 && rem.tv_nsec == 0);
+  }
+#endif
+
+  return 0;
+}
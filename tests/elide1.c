@@ -0,0 +1,171 @@
+/* 
+ * elide1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Elided mutexes and read/write locks: attribute handling, mutual
+ * exclusion under contention and trylock. The test passes whether
+ * or not the CPU supports lock elision; without it the locks behave
+ * as ordinary ones.
+ *
+ * Depends on API functions:
+ *	pthread_mutexattr_settype()
+ *	pthread_mutexattr_gettype()
+ *	pthread_mutex_init()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_trylock()
+ *	pthread_mutex_unlock()
+ *	pthread_mutex_destroy()
+ *	pthread_rwlockattr_setkind_np()
+ *	pthread_rwlock_init()
+ *	pthread_rwlock_rdlock()
+ *	pthread_rwlock_wrlock()
+ *	pthread_rwlock_trywrlock()
+ *	pthread_rwlock_unlock()
+ *	pthread_rwlock_destroy()
+ *	pthread_win32_test_features_np()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4,
+  ITERATIONS = 100000
+};
+
+static pthread_mutex_t mutex;
+static pthread_rwlock_t rwlock;
+static long counter = 0;
+static long shadow = 0;
+
+void *
+mutexer(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_mutex_lock(&mutex) == 0);
+      counter++;
+      assert(pthread_mutex_unlock(&mutex) == 0);
+    }
+
+  return NULL;
+}
+
+void *
+rwlocker(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      if (i % 4 == 0)
+        {
+          assert(pthread_rwlock_wrlock(&rwlock) == 0);
+          counter++;
+          shadow++;
+        }
+      else
+        {
+          assert(pthread_rwlock_rdlock(&rwlock) == 0);
+          assert(counter == shadow);
+        }
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_mutexattr_t ma;
+  pthread_rwlockattr_t rwa;
+  pthread_t t[NUMTHREADS];
+  int kind;
+  int i;
+
+  printf("Lock elision is %savailable\n",
+         pthread_win32_test_features_np(PTW32_LOCK_ELISION) ? "" : "not ");
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_ELIDE_NP) == 0);
+  assert(pthread_mutexattr_gettype(&ma, &kind) == 0);
+  assert(kind == PTHREAD_MUTEX_ELIDE_NP);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_ELIDE_NP + 1) == EINVAL);
+  assert(pthread_mutex_init(&mutex, &ma) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  /* Uncontended lock and trylock */
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(pthread_mutex_trylock(&mutex) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, mutexer, NULL) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  assert(counter == NUMTHREADS * ITERATIONS);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  counter = 0;
+
+  assert(pthread_rwlockattr_init(&rwa) == 0);
+  assert(pthread_rwlockattr_setkind_np(&rwa, PTHREAD_RWLOCK_ELIDE_NP + 1) == EINVAL);
+  assert(pthread_rwlockattr_setkind_np(&rwa, PTHREAD_RWLOCK_ELIDE_NP) == 0);
+  assert(pthread_rwlock_init(&rwlock, &rwa) == 0);
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+
+  assert(pthread_rwlock_trywrlock(&rwlock) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, rwlocker, NULL) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  assert(counter == NUMTHREADS * (ITERATIONS / 4));
+  assert(counter == shadow);
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  return 0;
+}
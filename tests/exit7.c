@@ -0,0 +1,108 @@
+/*
+ * File: exit7.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis: Test process exit in fast exit mode.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_win32_set_fast_exit_np
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - the setting starts FALSE and the previous one is returned.
+ * - the process exits normally, with pthread_t structs on the reuse
+ *   stack and a joinable thread never joined.
+ *
+ * Description:
+ * -
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - have working pthread_create, pthread_join
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 100
+};
+
+static void *
+func(void * arg)
+{
+  return arg;
+}
+
+int
+main()
+{
+  pthread_t t;
+  int i;
+
+  assert(pthread_win32_set_fast_exit_np(PTW32_TRUE) == PTW32_FALSE);
+  assert(pthread_win32_set_fast_exit_np(PTW32_FALSE) == PTW32_TRUE);
+  assert(pthread_win32_set_fast_exit_np(PTW32_TRUE) == PTW32_FALSE);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t, NULL, func, (void *)(size_t) i) == 0);
+      assert(pthread_join(t, NULL) == 0);
+    }
+
+  /* Left for process exit */
+  assert(pthread_create(&t, NULL, func, NULL) == 0);
+
+  return 0;
+}
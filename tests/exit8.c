@@ -0,0 +1,162 @@
+/*
+ * File: exit8.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis: Test pthread_exit() from the start routine, which
+ * returns straight to the library where it can, and from deeper frames
+ * and with cleanup handlers pushed, which unwind.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_exit
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - the exit value reaches pthread_join in every case.
+ * - cleanup handlers pushed before pthread_exit are run.
+ * - key destructors are run.
+ * - exit repeated many times, by threads that may be reused.
+ *
+ * Description:
+ * -
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - have working pthread_create, pthread_join
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 200
+};
+
+static pthread_key_t key;
+static volatile LONG cleanups = 0;
+static volatile LONG destroyed = 0;
+
+static void
+destroy(void * arg)
+{
+  (void) InterlockedIncrement(&destroyed);
+}
+
+static void
+cleanup(void * arg)
+{
+  (void) InterlockedIncrement(&cleanups);
+}
+
+static void
+deeper(void * arg)
+{
+  pthread_exit(arg);
+}
+
+static void *
+direct(void * arg)
+{
+  assert(pthread_setspecific(key, arg) == 0);
+  pthread_exit(arg);
+
+  /* Never reached */
+  return NULL;
+}
+
+static void *
+nested(void * arg)
+{
+  assert(pthread_setspecific(key, arg) == 0);
+  deeper(arg);
+
+  /* Never reached */
+  return NULL;
+}
+
+static void *
+pushed(void * arg)
+{
+  assert(pthread_setspecific(key, arg) == 0);
+  pthread_cleanup_push(cleanup, NULL);
+  pthread_exit(arg);
+  pthread_cleanup_pop(0);
+
+  /* Never reached */
+  return NULL;
+}
+
+int
+main()
+{
+  void * (*routines[])(void *) = { direct, nested, pushed };
+  pthread_t t;
+  void * result;
+  int i;
+
+  assert(pthread_key_create(&key, destroy) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t, NULL, routines[i % 3], (void *)(size_t) (i + 1)) == 0);
+      assert(pthread_join(t, &result) == 0);
+      assert((int)(size_t) result == i + 1);
+    }
+
+  assert(cleanups == NUMTHREADS / 3);
+  assert(destroyed == NUMTHREADS);
+
+  assert(pthread_key_delete(key) == 0);
+
+  return 0;
+}
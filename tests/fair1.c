@@ -0,0 +1,225 @@
+/* 
+ * fair1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Fair mutexes: attribute handling, first come first served handoff,
+ * a waiter that an eventually fair mutex doesn't let starve, and
+ * timed out waiters leaving the queue.
+ *
+ * Depends on API functions:
+ *	pthread_mutexattr_setfairness_np()
+ *	pthread_mutexattr_getfairness_np()
+ *	pthread_mutexattr_settype()
+ *	pthread_mutexattr_setrobust()
+ *	pthread_mutex_init()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_timedlock()
+ *	pthread_mutex_trylock()
+ *	pthread_mutex_unlock()
+ *	pthread_mutex_destroy()
+ *	pthread_create()
+ *	pthread_join()
+ *	clock_gettime()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 8
+};
+
+static pthread_mutex_t mutex;
+static volatile long started = 0;
+static volatile long position = 0;
+static int order[NUMTHREADS];
+static volatile long running = 0;
+
+static long
+elapsedms(struct timespec * since)
+{
+  struct timespec now;
+
+  assert(clock_gettime(CLOCK_MONOTONIC, &now) == 0);
+
+  return (long) ((now.tv_sec - since->tv_sec) * 1000
+                 + (now.tv_nsec - since->tv_nsec) / 1000000);
+}
+
+void *
+queued(void * arg)
+{
+  InterlockedIncrement((long *) &started);
+  assert(pthread_mutex_lock(&mutex) == 0);
+  order[position++] = (int)(size_t) arg;
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  return NULL;
+}
+
+void *
+hot(void * arg)
+{
+  struct timespec start;
+
+  assert(clock_gettime(CLOCK_MONOTONIC, &start) == 0);
+  InterlockedExchange((long *) &running, 1);
+
+  /* Relock at once, for a second */
+  while (elapsedms(&start) < 1000)
+    {
+      assert(pthread_mutex_lock(&mutex) == 0);
+      Sleep(0);
+      assert(pthread_mutex_unlock(&mutex) == 0);
+    }
+
+  return NULL;
+}
+
+void *
+timed(void * arg)
+{
+  struct timespec abstime;
+
+  clock_gettime(CLOCK_MONOTONIC, &abstime);
+  abstime.tv_nsec += 50000000;
+  abstime.tv_sec += abstime.tv_nsec / 1000000000;
+  abstime.tv_nsec %= 1000000000;
+
+  return (void *)(size_t) pthread_mutex_clocklock(&mutex, CLOCK_MONOTONIC, &abstime);
+}
+
+static void
+fifo(int fairness, int type)
+{
+  pthread_mutexattr_t ma;
+  pthread_t t[NUMTHREADS];
+  int i;
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_setfairness_np(&ma, fairness) == 0);
+  assert(pthread_mutexattr_settype(&ma, type) == 0);
+  assert(pthread_mutex_init(&mutex, &ma) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  started = 0;
+  position = 0;
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, queued, (void *)(size_t) i) == 0);
+      while (started < i + 1)
+        {
+          Sleep(1);
+        }
+      /* Let it get into the queue */
+      Sleep(20);
+    }
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(position == NUMTHREADS);
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(order[i] == i);
+    }
+
+  assert(pthread_mutex_destroy(&mutex) == 0);
+}
+
+int
+main()
+{
+  pthread_mutexattr_t ma;
+  pthread_t t[2];
+  struct timespec start;
+  void * result;
+  int fairness;
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_getfairness_np(&ma, &fairness) == 0);
+  assert(fairness == PTHREAD_MUTEX_BARGING_NP);
+  assert(pthread_mutexattr_setfairness_np(&ma, 5) == EINVAL);
+  assert(pthread_mutexattr_getfairness_np(&ma, NULL) == EINVAL);
+  assert(pthread_mutexattr_setfairness_np(&ma, PTHREAD_MUTEX_EVENTUALLY_FAIR_NP) == 0);
+  assert(pthread_mutexattr_getfairness_np(&ma, &fairness) == 0);
+  assert(fairness == PTHREAD_MUTEX_EVENTUALLY_FAIR_NP);
+
+  /* Robust mutexes can't be fair */
+  assert(pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_ROBUST) == 0);
+  assert(pthread_mutex_init(&mutex, &ma) == ENOSYS);
+  assert(pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_STALLED) == 0);
+
+  /* A waiter gets in while another thread keeps relocking */
+  assert(pthread_mutex_init(&mutex, &ma) == 0);
+  assert(pthread_create(&t[0], NULL, hot, NULL) == 0);
+  while (running == 0)
+    {
+      Sleep(1);
+    }
+  Sleep(100);
+  assert(clock_gettime(CLOCK_MONOTONIC, &start) == 0);
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(elapsedms(&start) < 500);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  /* Timed out waiters leave the queue */
+  assert(pthread_mutexattr_setfairness_np(&ma, PTHREAD_MUTEX_FAIR_NP) == 0);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_ERRORCHECK) == 0);
+  assert(pthread_mutex_init(&mutex, &ma) == 0);
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_create(&t[0], NULL, timed, NULL) == 0);
+  assert(pthread_create(&t[1], NULL, timed, NULL) == 0);
+  assert(pthread_join(t[0], &result) == 0);
+  assert((int)(size_t) result == ETIMEDOUT);
+  assert(pthread_join(t[1], &result) == 0);
+  assert((int)(size_t) result == ETIMEDOUT);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(pthread_mutex_trylock(&mutex) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  /* Handoff in arrival order */
+  fifo(PTHREAD_MUTEX_FAIR_NP, PTHREAD_MUTEX_NORMAL);
+  fifo(PTHREAD_MUTEX_FAIR_NP, PTHREAD_MUTEX_RECURSIVE);
+
+  return 0;
+}
@@ -0,0 +1,170 @@
+/* 
+ * flightrec1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test pthread_flightrec_dump_np() on a thread that blocks on a
+ * mutex and a condition variable, and on the thread that created it.
+ *
+ * Depends on API functions:
+ *	pthread_flightrec_dump_np()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_unlock()
+ *	pthread_cond_wait()
+ *	pthread_cond_signal()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+static pthread_mutex_t mx;
+static pthread_cond_t cv;
+static int ready = 0;
+static int waiting = 0;
+static int go = 0;
+
+/*
+ * Index of the first 'event' on 'object' in e[from..n), or -1.
+ */
+static int
+find(pthread_flightrec_np_t * e, int from, int n, int event, void * object)
+{
+  int i;
+
+  for (i = from; i < n; i++)
+    {
+      if (e[i].event == event && e[i].object == object)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+static void *
+waiter(void * arg)
+{
+  pthread_flightrec_np_t e[PTHREAD_FLIGHTREC_EVENTS_NP];
+  pthread_flightrec_np_t last;
+  int n = -1;
+  int i;
+
+  /* main holds mx until it sees ready */
+  ready = 1;
+  assert(pthread_mutex_lock(&mx) == 0);
+  while (!go)
+    {
+      waiting = 1;
+      assert(pthread_cond_wait(&cv, &mx) == 0);
+    }
+  assert(pthread_mutex_unlock(&mx) == 0);
+
+  assert(pthread_flightrec_dump_np(pthread_self(), e, PTHREAD_FLIGHTREC_EVENTS_NP, &n) == 0);
+  assert(n >= 4);
+
+  for (i = 1; i < n; i++)
+    {
+      assert(e[i].time >= e[i - 1].time);
+    }
+
+  assert((i = find(e, 0, n, PTHREAD_FLIGHTREC_MUTEX_WAIT_BEGIN_NP, (void *) mx)) >= 0);
+  assert((i = find(e, i, n, PTHREAD_FLIGHTREC_MUTEX_WAIT_END_NP, (void *) mx)) >= 0);
+  assert(e[i].value == 0);
+  assert((i = find(e, i, n, PTHREAD_FLIGHTREC_COND_WAIT_BEGIN_NP, (void *) cv)) >= 0);
+  assert((i = find(e, i, n, PTHREAD_FLIGHTREC_COND_WAIT_END_NP, (void *) cv)) >= 0);
+
+  /* The latest one only */
+  last = e[n - 1];
+  assert(pthread_flightrec_dump_np(pthread_self(), e, 1, &n) == 0);
+  assert(n == 1);
+  assert(e[0].event == last.event);
+  assert(e[0].time == last.time);
+
+  return (void *) 42;
+}
+
+int
+main()
+{
+  pthread_flightrec_np_t e[PTHREAD_FLIGHTREC_EVENTS_NP];
+  pthread_t t;
+  void * result;
+  int n = 0;
+
+  assert(pthread_flightrec_dump_np(pthread_self(), NULL, 0, NULL) == EINVAL);
+  assert(pthread_flightrec_dump_np(pthread_self(), NULL, 1, &n) == EINVAL);
+  assert(pthread_flightrec_dump_np(pthread_self(), e, -1, &n) == EINVAL);
+  assert(pthread_flightrec_dump_np(pthread_self(), NULL, 0, &n) == 0);
+  assert(n == 0);
+
+  assert(pthread_mutex_init(&mx, NULL) == 0);
+  assert(pthread_cond_init(&cv, NULL) == 0);
+
+  assert(pthread_mutex_lock(&mx) == 0);
+  assert(pthread_create(&t, NULL, waiter, NULL) == 0);
+  while (!ready)
+    {
+      Sleep(10);
+    }
+  /* Long enough for the waiter to block */
+  Sleep(200);
+  assert(pthread_mutex_unlock(&mx) == 0);
+
+  /* mx is free again once the waiter waits on cv */
+  while (!go)
+    {
+      assert(pthread_mutex_lock(&mx) == 0);
+      if (waiting)
+        {
+          go = 1;
+          assert(pthread_cond_signal(&cv) == 0);
+        }
+      assert(pthread_mutex_unlock(&mx) == 0);
+      Sleep(10);
+    }
+
+  assert(pthread_join(t, &result) == 0);
+  assert((int)(size_t) result == 42);
+
+  assert(pthread_flightrec_dump_np(pthread_self(), e, PTHREAD_FLIGHTREC_EVENTS_NP, &n) == 0);
+  assert(find(e, 0, n, PTHREAD_FLIGHTREC_THREAD_CREATE_NP, t.p) >= 0);
+
+  assert(pthread_flightrec_dump_np(t, e, PTHREAD_FLIGHTREC_EVENTS_NP, &n) == ESRCH);
+
+  assert(pthread_cond_destroy(&cv) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  return 0;
+}
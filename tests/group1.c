@@ -0,0 +1,125 @@
+/* 
+ * group1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test thread groups: members are cancelled and joined together,
+ * a thread added to a cancelled group is cancelled, and a group can
+ * only be destroyed empty.
+ *
+ * Depends on API functions:
+ *	pthread_group_create_np()
+ *	pthread_group_add_np()
+ *	pthread_group_cancel_np()
+ *	pthread_group_join_np()
+ *	pthread_group_destroy_np()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 20
+};
+
+static volatile LONG started = 0;
+static volatile LONG cancelled = 0;
+
+static void
+counter(void * arg)
+{
+  InterlockedIncrement((LPLONG)&cancelled);
+}
+
+static void *
+worker(void * arg)
+{
+  pthread_cleanup_push(counter, NULL);
+
+  InterlockedIncrement((LPLONG)&started);
+
+  for (;;)
+    {
+      Sleep(1);
+      pthread_testcancel();
+    }
+
+  pthread_cleanup_pop(0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_group_np_t group;
+  pthread_group_np_t other;
+  pthread_t t[NUMTHREADS + 1];
+  struct sched_param param;
+  int i;
+
+  assert(pthread_group_create_np(&group) == 0);
+  assert(pthread_group_create_np(&other) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, NULL) == 0);
+      assert(pthread_group_add_np(group, t[i]) == 0);
+    }
+
+  assert(pthread_group_add_np(group, t[0]) == 0);
+  assert(pthread_group_add_np(other, t[0]) == EBUSY);
+  assert(pthread_group_remove_np(other, t[0]) == EINVAL);
+  assert(pthread_group_destroy_np(&group) == EBUSY);
+
+  param.sched_priority = THREAD_PRIORITY_NORMAL;
+  assert(pthread_group_setschedparam_np(group, SCHED_OTHER, &param) == 0);
+
+  while (started < NUMTHREADS)
+    {
+      Sleep(10);
+    }
+
+  assert(pthread_group_cancel_np(group) == 0);
+
+  assert(pthread_create(&t[NUMTHREADS], NULL, worker, NULL) == 0);
+  assert(pthread_group_add_np(group, t[NUMTHREADS]) == 0);
+
+  assert(pthread_group_join_np(group) == 0);
+  assert(cancelled == NUMTHREADS + 1);
+
+  assert(pthread_group_destroy_np(&group) == 0);
+  assert(group == NULL);
+  assert(pthread_group_destroy_np(&other) == 0);
+
+  return 0;
+}
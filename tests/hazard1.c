@@ -0,0 +1,208 @@
+/* 
+ * hazard1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * A lock-free stack whose popped nodes are retired through hazard
+ * pointers: no thread sees a node after it has been reclaimed, a
+ * stalled thread's hazard holds back only the node it protects, and
+ * everything is reclaimed once the threads are done.
+ *
+ * Depends on API functions:
+ *	pthread_hazard_protect_np()
+ *	pthread_hazard_clear_np()
+ *	pthread_hazard_retire_np()
+ *	pthread_hazard_scan_np()
+ *	sem_wait()
+ *	sem_post()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4,
+  ITERATIONS = 5000,
+  LIVE = 0x1234,
+  DEAD = 0xdead
+};
+
+typedef struct node_t_ node_t;
+
+struct node_t_ {
+  node_t * next;
+  volatile long magic;
+};
+
+static void * volatile top = NULL;
+static long reclaimed = 0;
+static sem_t stalled;
+static sem_t resume;
+
+void PTW32_CDECL
+reclaim(void * p)
+{
+  node_t * n = (node_t *) p;
+
+  assert(n->magic == LIVE);
+  n->magic = DEAD;
+  InterlockedIncrement(&reclaimed);
+}
+
+static void
+push(node_t * n)
+{
+  void * old;
+
+  do
+    {
+      old = top;
+      n->next = (node_t *) old;
+    }
+  while (InterlockedCompareExchangePointer((PVOID volatile *) &top, n, old) != old);
+}
+
+static node_t *
+pop(void)
+{
+  void * p;
+
+  for (;;)
+    {
+      node_t * n;
+
+      assert(pthread_hazard_protect_np(0, &top, &p) == 0);
+      if ((n = (node_t *) p) == NULL)
+	{
+	  break;
+	}
+      assert(n->magic == LIVE);
+      if (InterlockedCompareExchangePointer((PVOID volatile *) &top, n->next, n) == n)
+	{
+	  break;
+	}
+    }
+
+  assert(pthread_hazard_clear_np(0) == 0);
+
+  return (node_t *) p;
+}
+
+void *
+worker(void * arg)
+{
+  node_t * nodes = (node_t *) calloc(ITERATIONS, sizeof(node_t));
+  int i;
+
+  assert(nodes != NULL);
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      node_t * n;
+
+      nodes[i].magic = LIVE;
+      push(&nodes[i]);
+      if ((n = pop()) != NULL)
+	{
+	  assert(pthread_hazard_retire_np(n, reclaim) == 0);
+	}
+    }
+
+  /* The nodes stay allocated so a late look at one is caught */
+  return NULL;
+}
+
+void *
+staller(void * arg)
+{
+  void * p;
+
+  assert(pthread_hazard_protect_np(PTHREAD_HAZARD_SLOTS_NP - 1, (void * volatile *) arg, &p) == 0);
+  assert(sem_post(&stalled) == 0);
+  assert(sem_wait(&resume) == 0);
+  assert(((node_t *) p)->magic == LIVE);
+  assert(pthread_hazard_clear_np(PTHREAD_HAZARD_SLOTS_NP - 1) == 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  node_t held;
+  void * volatile shared = &held;
+  void * p;
+  int i;
+
+  assert(pthread_hazard_protect_np(-1, &top, &p) == EINVAL);
+  assert(pthread_hazard_protect_np(PTHREAD_HAZARD_SLOTS_NP, &top, &p) == EINVAL);
+  assert(pthread_hazard_protect_np(0, NULL, &p) == EINVAL);
+  assert(pthread_hazard_clear_np(PTHREAD_HAZARD_SLOTS_NP) == EINVAL);
+  assert(pthread_hazard_retire_np(NULL, reclaim) == EINVAL);
+  assert(pthread_hazard_retire_np(&held, NULL) == EINVAL);
+  assert(pthread_hazard_scan_np() == 0);
+
+  /* A stalled thread holds back only what it protects */
+  held.magic = LIVE;
+  assert(sem_init(&stalled, 0, 0) == 0);
+  assert(sem_init(&resume, 0, 0) == 0);
+  assert(pthread_create(&t[0], NULL, staller, (void *) &shared) == 0);
+  assert(sem_wait(&stalled) == 0);
+  shared = NULL;
+  assert(pthread_hazard_retire_np(&held, reclaim) == 0);
+  assert(pthread_hazard_scan_np() == 0);
+  assert(reclaimed == 0);
+  assert(sem_post(&resume) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(pthread_hazard_scan_np() == 0);
+  assert(reclaimed == 1);
+  assert(held.magic == DEAD);
+  assert(sem_destroy(&stalled) == 0);
+  assert(sem_destroy(&resume) == 0);
+
+  reclaimed = 0;
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, NULL) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  /* Every node pushed was popped, and the exits scanned what was left */
+  assert(top == NULL);
+  assert(reclaimed == NUMTHREADS * ITERATIONS);
+
+  return 0;
+}
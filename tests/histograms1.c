@@ -0,0 +1,185 @@
+/*
+ * File: histograms1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Confirm that pthread_gethistograms_np counts blocking waits by kind
+ *   and duration.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_gethistograms_np
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - the bucket bounds of PTHREAD_HIST_LOWER_NP.
+ * - a thread that blocks on a mutex, a rwlock to write, a rwlock to
+ *   read and a semaphore counts a wait of each kind, a mutex wait of
+ *   about 100 ms in a bucket from 10 ms up.
+ * - a thread's waits are still counted once it is joined.
+ *
+ * Description:
+ * -
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - have working pthread_create, pthread_join
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+static pthread_mutex_t mx;
+static pthread_rwlock_t rw[2];
+static sem_t sem;
+
+static pthread_hist_np_t before[PTHREAD_HIST_KINDS_NP];
+static pthread_hist_np_t after[PTHREAD_HIST_KINDS_NP];
+
+/*
+ * Waits added to kind 'k' in buckets from 'from' up.
+ */
+static unsigned __int64
+added(int k, int from)
+{
+  unsigned __int64 n = 0;
+  int b;
+
+  for (b = from; b < PTHREAD_HIST_BUCKETS_NP; b++)
+    {
+      assert(after[k].count[b] >= before[k].count[b]);
+      n += after[k].count[b] - before[k].count[b];
+    }
+
+  return n;
+}
+
+static void *
+waiter(void * arg)
+{
+  assert(pthread_mutex_lock(&mx) == 0);
+  assert(pthread_mutex_unlock(&mx) == 0);
+  assert(pthread_rwlock_wrlock(&rw[0]) == 0);
+  assert(pthread_rwlock_unlock(&rw[0]) == 0);
+  assert(pthread_rwlock_rdlock(&rw[1]) == 0);
+  assert(pthread_rwlock_unlock(&rw[1]) == 0);
+  assert(sem_wait(&sem) == 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_rwlockattr_t ra;
+  pthread_t t;
+  int b;
+  int from;
+
+  assert(pthread_gethistograms_np(NULL, 1) == EINVAL);
+  assert(pthread_gethistograms_np(before, -1) == EINVAL);
+  assert(pthread_gethistograms_np(NULL, 0) == 0);
+
+  assert(PTHREAD_HIST_LOWER_NP(0) == 0);
+  assert(PTHREAD_HIST_LOWER_NP(1) == 256);
+  assert(PTHREAD_HIST_LOWER_NP(4) == 448);
+  assert(PTHREAD_HIST_LOWER_NP(5) == 512);
+  for (b = 1; b < PTHREAD_HIST_BUCKETS_NP; b++)
+    {
+      assert(PTHREAD_HIST_LOWER_NP(b) > PTHREAD_HIST_LOWER_NP(b - 1));
+    }
+
+  for (from = 0; PTHREAD_HIST_LOWER_NP(from) < 10000000; from++)
+    {
+    }
+
+  assert(pthread_mutex_init(&mx, NULL) == 0);
+  assert(pthread_rwlockattr_init(&ra) == 0);
+  assert(pthread_rwlockattr_setkind_np(&ra, PTHREAD_RWLOCK_PREFER_WRITER_NP) == 0);
+  assert(pthread_rwlock_init(&rw[0], &ra) == 0);
+  assert(pthread_rwlock_init(&rw[1], &ra) == 0);
+  assert(pthread_rwlockattr_destroy(&ra) == 0);
+  assert(sem_init(&sem, 0, 0) == 0);
+
+  assert(pthread_mutex_lock(&mx) == 0);
+  assert(pthread_rwlock_rdlock(&rw[0]) == 0);
+  assert(pthread_rwlock_wrlock(&rw[1]) == 0);
+
+  assert(pthread_gethistograms_np(before, PTHREAD_HIST_KINDS_NP) == 0);
+
+  assert(pthread_create(&t, NULL, waiter, NULL) == 0);
+
+  Sleep(100);
+  assert(pthread_mutex_unlock(&mx) == 0);
+  Sleep(100);
+  assert(pthread_rwlock_unlock(&rw[0]) == 0);
+  Sleep(100);
+  assert(pthread_rwlock_unlock(&rw[1]) == 0);
+  Sleep(100);
+  assert(sem_post(&sem) == 0);
+
+  assert(pthread_join(t, NULL) == 0);
+
+  assert(pthread_gethistograms_np(after, PTHREAD_HIST_KINDS_NP) == 0);
+
+  assert(added(PTHREAD_HIST_MUTEX_NP, from) >= 1);
+  assert(added(PTHREAD_HIST_RWLOCK_WRITE_NP, 0) >= 1);
+  assert(added(PTHREAD_HIST_RWLOCK_READ_NP, 0) >= 1);
+  assert(added(PTHREAD_HIST_SEM_NP, 0) >= 1);
+
+  assert(sem_destroy(&sem) == 0);
+  assert(pthread_rwlock_destroy(&rw[1]) == 0);
+  assert(pthread_rwlock_destroy(&rw[0]) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  return 0;
+}
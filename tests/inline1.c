@@ -0,0 +1,129 @@
+/* 
+ * inline1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Normal mutexes and spinlocks through the PTW32_INLINE_LOCKS fast
+ * paths: uncontended and contended use, static initialisers, and
+ * other mutex types passed on to the library.
+ *
+ * Depends on API functions:
+ *	pthread_mutex_lock()
+ *	pthread_mutex_trylock()
+ *	pthread_mutex_unlock()
+ *	pthread_spin_lock()
+ *	pthread_spin_trylock()
+ *	pthread_spin_unlock()
+ */
+
+#define PTW32_INLINE_LOCKS
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4,
+  ITERATIONS = 20000
+};
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_spinlock_t spin;
+static long mutexCount = 0;
+static long spinCount = 0;
+
+void *
+worker(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_mutex_lock(&mutex) == 0);
+      mutexCount++;
+      assert(pthread_mutex_unlock(&mutex) == 0);
+
+      assert(pthread_spin_lock(&spin) == 0);
+      spinCount++;
+      assert(pthread_spin_unlock(&spin) == 0);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  pthread_mutex_t ec;
+  pthread_mutexattr_t ma;
+  int i;
+
+  /* The first lock initialises the static mutex in the library */
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(mutex != PTHREAD_MUTEX_INITIALIZER);
+  assert(pthread_mutex_trylock(&mutex) == EBUSY);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(pthread_mutex_trylock(&mutex) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  assert(pthread_spin_init(&spin, PTHREAD_PROCESS_PRIVATE) == 0);
+  assert(pthread_spin_trylock(&spin) == 0);
+  assert(pthread_spin_trylock(&spin) == EBUSY);
+  assert(pthread_spin_unlock(&spin) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, NULL) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(mutexCount == NUMTHREADS * ITERATIONS);
+  assert(spinCount == NUMTHREADS * ITERATIONS);
+
+  /* Other types keep their checks */
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_ERRORCHECK) == 0);
+  assert(pthread_mutex_init(&ec, &ma) == 0);
+  assert(pthread_mutex_unlock(&ec) == EPERM);
+  assert(pthread_mutex_lock(&ec) == 0);
+  assert(pthread_mutex_lock(&ec) == EDEADLK);
+  assert(pthread_mutex_unlock(&ec) == 0);
+
+  assert(pthread_mutex_destroy(&ec) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+  assert(pthread_spin_destroy(&spin) == 0);
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+/* 
+ * inline2.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * pthread_testcancel through the PTW32_INLINE_LOCKS fast path: a
+ * thread spinning on it is cancelled, but not while cancellation is
+ * disabled, and a test with nothing pending leaves the last error
+ * alone.
+ *
+ * Depends on API functions:
+ *	pthread_create()
+ *	pthread_join()
+ *	pthread_cancel()
+ *	pthread_setcancelstate()
+ *	pthread_testcancel()
+ */
+
+#define PTW32_INLINE_LOCKS
+
+#include "test.h"
+
+static volatile int started = 0;
+static volatile int disabledDone = 0;
+static volatile long tests = 0;
+
+void *
+worker(void * arg)
+{
+  int i;
+
+  assert(pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL) == 0);
+  started = 1;
+
+  /* Cancelled by now, but it stays pending */
+  while (!disabledDone)
+    {
+      pthread_testcancel();
+      sched_yield();
+    }
+  for (i = 0; i < 1000; i++)
+    {
+      pthread_testcancel();
+    }
+
+  assert(pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL) == 0);
+
+  for (;;)
+    {
+      pthread_testcancel();
+      tests++;
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t;
+  void * result = NULL;
+
+  SetLastError(ERROR_INVALID_DATA);
+  pthread_testcancel();
+  assert(GetLastError() == ERROR_INVALID_DATA);
+
+  assert(pthread_create(&t, NULL, worker, NULL) == 0);
+  while (!started)
+    {
+      Sleep(1);
+    }
+
+  assert(pthread_cancel(t) == 0);
+  Sleep(50);
+  disabledDone = 1;
+
+  assert(pthread_join(t, &result) == 0);
+  assert(result == PTHREAD_CANCELED);
+
+  return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * File: iocp1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis: Verify sem_wait_port_np() and
+ * - pthread_cond_wait_port_np()
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - 
+ *
+ * Features Tested:
+ * - 
+ *
+ * Cases Tested:
+ * - a packet is posted only once the wait is over, with the key
+ *   and OVERLAPPED pointer given.
+ * - the thread dequeuing a condition variable packet owns the mutex.
+ *
+ * Description:
+ * - 
+ *
+ * Environment:
+ * - 
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - 
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+
+#include "test.h"
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+
+int
+main()
+{
+  HANDLE port;
+  sem_t sem;
+  OVERLAPPED ov;
+  LPOVERLAPPED pov;
+  DWORD bytes;
+  ULONG_PTR key;
+
+  assert((port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1)) != NULL);
+  assert(sem_init(&sem, 0, 0) == 0);
+
+  /* Semaphore */
+  assert(sem_wait_port_np(&sem, port, (void *) 42, &ov) == 0);
+  assert(!GetQueuedCompletionStatus(port, &bytes, &key, &pov, 100));
+  assert(sem_post(&sem) == 0);
+  assert(GetQueuedCompletionStatus(port, &bytes, &key, &pov, 1000));
+  assert(key == 42);
+  assert(pov == &ov);
+  assert(bytes == 0);
+  assert(sem_trywait_np(&sem) == EAGAIN);
+
+  /* A unit that is free is taken at once */
+  assert(sem_post(&sem) == 0);
+  assert(sem_wait_port_np(&sem, port, (void *) 43, NULL) == 0);
+  assert(GetQueuedCompletionStatus(port, &bytes, &key, &pov, 0));
+  assert(key == 43);
+  assert(pov == NULL);
+
+  /* Condition variable: the packet comes with the mutex */
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_cond_wait_port_np(&cond, &mutex, port, (void *) 7, NULL) == 0);
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_cond_signal(&cond) == 0);
+  assert(!GetQueuedCompletionStatus(port, &bytes, &key, &pov, 100));
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(GetQueuedCompletionStatus(port, &bytes, &key, &pov, 1000));
+  assert(key == 7);
+  assert(pthread_mutex_trylock(&mutex) == EBUSY);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  assert(sem_wait_port_np(&sem, NULL, NULL, NULL) == EINVAL);
+  assert(pthread_cond_wait_port_np(&cond, &mutex, INVALID_HANDLE_VALUE, NULL, NULL) == EINVAL);
+
+  assert(sem_destroy(&sem) == 0);
+  assert(CloseHandle(port));
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+/* 
+ * join5.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Fan out to many short-lived joinable threads and join them all, a
+ * number of times. Each thread's exit value is returned and its TSD
+ * destructors have run by the time pthread_join() returns.
+ *
+ * Depends on API functions:
+ *	pthread_create()
+ *	pthread_join()
+ *	pthread_key_create()
+ *	pthread_setspecific()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 64,
+  ROUNDS = 20
+};
+
+static pthread_key_t key;
+static volatile LONG destroyed = 0;
+
+static void
+destructor(void * value)
+{
+  (void) InterlockedIncrement((LPLONG) &destroyed);
+}
+
+static void *
+func(void * arg)
+{
+  assert(pthread_setspecific(key, arg) == 0);
+
+  return arg;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  void * result;
+  int round;
+  int i;
+
+  assert(pthread_key_create(&key, destructor) == 0);
+
+  for (round = 1; round <= ROUNDS; round++)
+    {
+      for (i = 0; i < NUMTHREADS; i++)
+	{
+	  assert(pthread_create(&t[i], NULL, func, (void *)(size_t)(i + 1)) == 0);
+	}
+
+      for (i = 0; i < NUMTHREADS; i++)
+	{
+	  result = NULL;
+	  assert(pthread_join(t[i], &result) == 0);
+	  assert((int)(size_t)result == i + 1);
+	}
+
+      assert(destroyed == round * NUMTHREADS);
+    }
+
+  assert(pthread_key_delete(key) == 0);
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+/* 
+ * join6.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Fork and join a team of threads with pthread_create_n_np() and
+ * pthread_join_n_np(): each thread gets its own argument and its exit
+ * value is returned, and NULL handles are skipped. A team with a
+ * detached thread in it is rejected without joining any of them.
+ *
+ * Depends on API functions:
+ *	pthread_create_n_np()
+ *	pthread_join_n_np()
+ *	pthread_create()
+ *	pthread_detach()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 32,
+  ROUNDS = 10
+};
+
+static void *
+func(void * arg)
+{
+  int i = (int)(size_t)arg;
+
+  if (i % 4 == 0)
+    {
+      Sleep(i / 4);
+    }
+
+  return (void *)(size_t)(i * 2);
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  void * args[NUMTHREADS];
+  void * values[NUMTHREADS];
+  int round;
+  int i;
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      args[i] = (void *)(size_t)(i + 1);
+    }
+
+  for (round = 0; round < ROUNDS; round++)
+    {
+      memset(values, 0, sizeof(values));
+      assert(pthread_create_n_np(t, NUMTHREADS, NULL, func, args) == 0);
+      assert(pthread_join_n_np(t, NUMTHREADS, values) == 0);
+
+      for (i = 0; i < NUMTHREADS; i++)
+	{
+	  assert((int)(size_t)values[i] == (i + 1) * 2);
+	}
+    }
+
+  /* NULL handles are skipped */
+  assert(pthread_create_n_np(t, 2, NULL, func, NULL) == 0);
+  t[2].p = NULL;
+  t[2].x = 0;
+  values[2] = (void *) &t;
+  assert(pthread_join_n_np(t, 3, values) == 0);
+  assert(values[0] == NULL);
+  assert(values[1] == NULL);
+  assert(values[2] == (void *) &t);
+
+  /* Nothing is joined if one can't be */
+  assert(pthread_create_n_np(t, 3, NULL, func, args) == 0);
+  assert(pthread_detach(t[1]) == 0);
+  assert(pthread_join_n_np(t, 3, NULL) == EINVAL);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(pthread_join(t[2], NULL) == 0);
+
+  assert(pthread_join_n_np(t, 0, NULL) == 0);
+  assert(pthread_join_n_np(NULL, 1, NULL) == EINVAL);
+  assert(pthread_create_n_np(t, -1, NULL, func, NULL) == EINVAL);
+
+  return 0;
+}
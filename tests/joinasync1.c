@@ -0,0 +1,123 @@
+/* 
+ * joinasync1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Reap threads with completion callbacks instead of joins: threads
+ * still running, a thread that has already exited (called back at
+ * once), and a thread that registers itself.
+ *
+ * Depends on API functions:
+ *	pthread_join_async_np()
+ *	pthread_create()
+ *	pthread_join()
+ *	pthread_self()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 50
+};
+
+static volatile long done = 0;
+static volatile long sum = 0;
+static volatile long okay = 1;
+
+void PTW32_CDECL
+reaped(pthread_t thread, void * value, void * arg)
+{
+  if (arg != (void *) &done)
+    {
+      okay = 0;
+    }
+  InterlockedExchangeAdd((long *) &sum, (long)(size_t) value);
+  InterlockedIncrement((long *) &done);
+}
+
+void *
+worker(void * arg)
+{
+  Sleep(10);
+  return arg;
+}
+
+void *
+selfreaping(void * arg)
+{
+  assert(pthread_join_async_np(pthread_self(), reaped, (void *) &done) == 0);
+  return arg;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  pthread_t last;
+  long expected = 0;
+  int i;
+
+  assert(pthread_join_async_np(pthread_self(), NULL, NULL) == EINVAL);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, (void *)(size_t) (i + 1)) == 0);
+      assert(pthread_join_async_np(t[i], reaped, (void *) &done) == 0);
+      assert(pthread_join_async_np(t[i], reaped, (void *) &done) != 0);
+      expected += i + 1;
+    }
+
+  while (done < NUMTHREADS)
+    {
+      Sleep(1);
+    }
+  assert(sum == expected);
+
+  /* Already exited: called back before returning */
+  assert(pthread_create(&last, NULL, worker, (void *) 1000) == 0);
+  Sleep(200);
+  assert(pthread_join_async_np(last, reaped, (void *) &done) == 0);
+  assert(done == NUMTHREADS + 1);
+  assert(sum == expected + 1000);
+
+  /* Registered by the thread itself */
+  assert(pthread_create(&last, NULL, selfreaping, (void *) 2000) == 0);
+  while (done < NUMTHREADS + 2)
+    {
+      Sleep(1);
+    }
+  assert(sum == expected + 3000);
+  assert(okay);
+
+  return 0;
+}
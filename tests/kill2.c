@@ -0,0 +1,98 @@
+/* 
+ * kill2.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test pthread_kill() delivery: a signal sent to the calling thread is
+ * raised before pthread_kill returns, and one sent to a thread in
+ * alertable sleeps runs its handler there without polling.
+ *
+ * Depends on API functions:
+ *	pthread_kill()
+ */
+
+#include "test.h"
+#include <signal.h>
+
+static volatile LONG raised = 0;
+static volatile DWORD raisedOn = 0;
+
+static void
+handler(int sig)
+{
+  assert(sig == SIGINT);
+  raisedOn = GetCurrentThreadId();
+  InterlockedIncrement((LPLONG)&raised);
+  (void) signal(SIGINT, handler);
+}
+
+static void *
+worker(void * arg)
+{
+  *(DWORD *) arg = GetCurrentThreadId();
+
+  while (raised < 2)
+    {
+      (void) SleepEx(INFINITE, TRUE);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t;
+  DWORD id = 0;
+
+  assert(signal(SIGINT, handler) != SIG_ERR);
+
+  assert(pthread_kill(pthread_self(), 99) == EINVAL);
+
+  assert(pthread_kill(pthread_self(), SIGINT) == 0);
+  assert(raised == 1);
+  assert(raisedOn == GetCurrentThreadId());
+
+  assert(pthread_create(&t, NULL, worker, &id) == 0);
+  while (id == 0)
+    {
+      Sleep(10);
+    }
+
+  assert(pthread_kill(t, SIGINT) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(raised == 2);
+  assert(raisedOn == id);
+
+  return 0;
+}
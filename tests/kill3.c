@@ -0,0 +1,121 @@
+/* 
+ * kill3.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test that pthread_kill(thread, 0) tells live threads from destroyed
+ * ones while other threads are created and destroyed, now that it
+ * takes no lock.
+ *
+ * Depends on API functions:
+ *	pthread_kill()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  CHURNERS = 4,
+  CHECKS = 100000
+};
+
+static volatile LONG done = 0;
+static pthread_t stale[CHURNERS];
+static volatile LONG staleSet = 0;
+
+static void *
+nothing(void * arg)
+{
+  return arg;
+}
+
+static void *
+churner(void * arg)
+{
+  int i = (int) (size_t) arg;
+  pthread_t t;
+
+  while (!done)
+    {
+      assert(pthread_create(&t, NULL, nothing, NULL) == 0);
+      assert(pthread_join(t, NULL) == 0);
+      if (InterlockedCompareExchange((LPLONG) &staleSet, 0, 0) & (1 << i))
+        {
+          continue;
+        }
+      stale[i] = t;
+      (void) InterlockedExchangeAdd((LPLONG) &staleSet, 1 << i);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[CHURNERS];
+  int i, n;
+
+  for (i = 0; i < CHURNERS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, churner, (void *) (size_t) i) == 0);
+    }
+
+  while (staleSet != (1 << CHURNERS) - 1)
+    {
+      Sleep(1);
+    }
+
+  for (n = 0; n < CHECKS; n++)
+    {
+      /* Joined threads stay destroyed even when their structs are reused */
+      assert(pthread_kill(stale[n % CHURNERS], 0) == ESRCH);
+      assert(pthread_kill(t[n % CHURNERS], 0) == 0);
+      assert(pthread_kill(pthread_self(), 0) == 0);
+    }
+
+  done = 1;
+
+  for (i = 0; i < CHURNERS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  for (i = 0; i < CHURNERS; i++)
+    {
+      assert(pthread_kill(t[i], 0) == ESRCH);
+    }
+
+  return 0;
+}
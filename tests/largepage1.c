@@ -0,0 +1,134 @@
+/* 
+ * largepage1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Slabs and thread structs cut from large pages. Whether or not the
+ * process may lock pages in memory, objects and threads keep working,
+ * and thread structs freed while large pages are set are used again.
+ *
+ * Depends on API functions:
+ *	pthread_setparam_np()
+ *	pthread_getparam_np()
+ *	pthread_mutex_init()
+ *	pthread_cond_init()
+ *	pthread_create()
+ */
+
+#include "test.h"
+
+enum {
+  NUMOBJECTS = 20000,
+  NUMTHREADS = 64
+};
+
+static pthread_mutex_t mx[NUMOBJECTS];
+static pthread_cond_t cv[NUMOBJECTS];
+
+void *
+func(void * arg)
+{
+  int i = (int) (size_t) arg;
+
+  assert(pthread_mutex_lock(&mx[i]) == 0);
+  assert(pthread_mutex_unlock(&mx[i]) == 0);
+
+  return arg;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  long value;
+  long reuse;
+  void * result;
+  int round;
+  int i;
+
+  assert(pthread_getparam_np(PTHREAD_PARAM_LARGE_PAGES_NP, &value) == 0);
+  assert(value == 0);
+  assert(pthread_setparam_np(PTHREAD_PARAM_LARGE_PAGES_NP, 2) == EINVAL);
+  assert(pthread_setparam_np(PTHREAD_PARAM_LARGE_PAGES_NP, 1) == 0);
+
+  /* 1 only if the process may lock pages in memory */
+  assert(pthread_getparam_np(PTHREAD_PARAM_LARGE_PAGES_NP, &value) == 0);
+  assert(value == 0 || value == 1);
+
+  for (i = 0; i < NUMOBJECTS; i++)
+    {
+      assert(pthread_mutex_init(&mx[i], NULL) == 0);
+      assert(pthread_cond_init(&cv[i], NULL) == 0);
+    }
+  for (i = 0; i < NUMOBJECTS; i++)
+    {
+      assert(pthread_mutex_lock(&mx[i]) == 0);
+      assert(pthread_cond_signal(&cv[i]) == 0);
+      assert(pthread_mutex_unlock(&mx[i]) == 0);
+    }
+
+  /* Free thread structs as they are destroyed, and make them again */
+  assert(pthread_getparam_np(PTHREAD_PARAM_THREAD_REUSE_NP, &reuse) == 0);
+  assert(pthread_setparam_np(PTHREAD_PARAM_THREAD_REUSE_NP, 0) == 0);
+
+  for (round = 0; round < 2; round++)
+    {
+      for (i = 0; i < NUMTHREADS; i++)
+        {
+          assert(pthread_create(&t[i], NULL, func, (void *) (size_t) i) == 0);
+        }
+      for (i = 0; i < NUMTHREADS; i++)
+        {
+          assert(pthread_join(t[i], &result) == 0);
+          assert(result == (void *) (size_t) i);
+        }
+    }
+
+  assert(pthread_setparam_np(PTHREAD_PARAM_THREAD_REUSE_NP, reuse) == 0);
+
+  for (i = 0; i < NUMOBJECTS; i++)
+    {
+      assert(pthread_cond_destroy(&cv[i]) == 0);
+      assert(pthread_mutex_destroy(&mx[i]) == 0);
+    }
+
+  /* Off again; objects now come from the heap */
+  assert(pthread_setparam_np(PTHREAD_PARAM_LARGE_PAGES_NP, 0) == 0);
+  assert(pthread_getparam_np(PTHREAD_PARAM_LARGE_PAGES_NP, &value) == 0);
+  assert(value == 0);
+  assert(pthread_mutex_init(&mx[0], NULL) == 0);
+  assert(pthread_mutex_lock(&mx[0]) == 0);
+  assert(pthread_mutex_unlock(&mx[0]) == 0);
+  assert(pthread_mutex_destroy(&mx[0]) == 0);
+
+  return 0;
+}
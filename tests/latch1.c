@@ -0,0 +1,138 @@
+/* 
+ * latch1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Count-down latch: workers count it down without waiting, and
+ * waiters are all released on the last count, whichever order they
+ * arrive in.
+ *
+ * Depends on API functions:
+ *	pthread_latch_init_np()
+ *	pthread_latch_destroy_np()
+ *	pthread_latch_count_down_np()
+ *	pthread_latch_wait_np()
+ *	pthread_latch_try_wait_np()
+ *	pthread_latch_arrive_and_wait_np()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  NUMWORKERS = 8,
+  NUMWAITERS = 4
+};
+
+static pthread_latch_np_t latch;
+static int done[NUMWORKERS];
+
+void *
+worker(void * arg)
+{
+  int i = (int)(size_t) arg;
+
+  done[i] = 1;
+  assert(pthread_latch_count_down_np(latch, 1) == 0);
+
+  return NULL;
+}
+
+void *
+waiter(void * arg)
+{
+  int i;
+
+  assert(pthread_latch_wait_np(latch) == 0);
+
+  for (i = 0; i < NUMWORKERS; i++)
+    {
+      assert(done[i] == 1);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t w[NUMWORKERS];
+  pthread_t v[NUMWAITERS];
+  int i;
+
+  assert(pthread_latch_init_np(NULL, 1) == EINVAL);
+
+  /* Created released */
+  assert(pthread_latch_init_np(&latch, 0) == 0);
+  assert(pthread_latch_try_wait_np(latch) == 0);
+  assert(pthread_latch_wait_np(latch) == 0);
+  assert(pthread_latch_destroy_np(&latch) == 0);
+  assert(latch == NULL);
+
+  assert(pthread_latch_init_np(&latch, NUMWORKERS + 1) == 0);
+  assert(pthread_latch_try_wait_np(latch) == EBUSY);
+  assert(pthread_latch_count_down_np(latch, NUMWORKERS + 2) == EINVAL);
+
+  for (i = 0; i < NUMWAITERS; i++)
+    {
+      assert(pthread_create(&v[i], NULL, waiter, NULL) == 0);
+    }
+
+  Sleep(100);
+
+  for (i = 0; i < NUMWORKERS; i++)
+    {
+      assert(pthread_create(&w[i], NULL, worker, (void *)(size_t) i) == 0);
+    }
+  for (i = 0; i < NUMWORKERS; i++)
+    {
+      assert(pthread_join(w[i], NULL) == 0);
+    }
+
+  /* The last count is ours */
+  assert(pthread_latch_try_wait_np(latch) == EBUSY);
+  assert(pthread_latch_arrive_and_wait_np(latch, 1) == 0);
+  assert(pthread_latch_try_wait_np(latch) == 0);
+  assert(pthread_latch_count_down_np(latch, 1) == EINVAL);
+
+  for (i = 0; i < NUMWAITERS; i++)
+    {
+      assert(pthread_join(v[i], NULL) == 0);
+    }
+
+  assert(pthread_latch_destroy_np(&latch) == 0);
+  assert(pthread_latch_destroy_np(&latch) == EINVAL);
+
+  return 0;
+}
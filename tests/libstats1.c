@@ -0,0 +1,155 @@
+/*
+ * File: libstats1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Confirm that pthread_getlibstats_np counts the kernel objects the
+ *   library holds and the kernel waits and wakes it makes.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_getlibstats_np
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - a semaphore is held from sem_init until sem_destroy.
+ * - a thread's handle is held until it is joined.
+ * - a thread that blocks in sem_wait counts a semaphore wait, and
+ *   the sem_post that wakes it counts a kernel wake.
+ * - the join of a running thread counts a join wait.
+ * - a thread is counted until it is joined.
+ * - pthread_cancel is counted.
+ *
+ * Description:
+ * -
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * -
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+static sem_t sem;
+
+void *
+waiter(void * arg)
+{
+  assert(sem_wait(&sem) == 0);
+
+  return arg;
+}
+
+void *
+sleeper(void * arg)
+{
+  Sleep(500);
+
+  return arg;
+}
+
+int
+main()
+{
+  pthread_libstats_np_t before;
+  pthread_libstats_np_t after;
+  pthread_t t;
+
+  assert(pthread_getlibstats_np(NULL) == EINVAL);
+
+  (void) pthread_self();
+
+  assert(pthread_getlibstats_np(&before) == 0);
+  assert(sem_init(&sem, 0, 0) == 0);
+  assert(pthread_getlibstats_np(&after) == 0);
+  assert(after.events + after.semaphores == before.events + before.semaphores + 1);
+  assert(sem_destroy(&sem) == 0);
+  assert(pthread_getlibstats_np(&after) == 0);
+  assert(after.events + after.semaphores == before.events + before.semaphores);
+
+  assert(sem_init(&sem, 0, 0) == 0);
+  assert(pthread_getlibstats_np(&before) == 0);
+  assert(pthread_create(&t, NULL, waiter, NULL) == 0);
+  assert(pthread_getlibstats_np(&after) == 0);
+  assert(after.threadHandles == before.threadHandles + 1);
+  assert(after.threads == before.threads + 1);
+
+  /* Give the waiter time to block */
+  Sleep(500);
+  assert(sem_post(&sem) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(pthread_getlibstats_np(&after) == 0);
+  assert(after.threadHandles == before.threadHandles);
+  assert(after.threads == before.threads);
+  assert(after.semWaits > before.semWaits);
+  assert(after.releaseSemaphores + after.setEvents
+         > before.releaseSemaphores + before.setEvents);
+  assert(sem_destroy(&sem) == 0);
+
+  assert(pthread_getlibstats_np(&before) == 0);
+  assert(pthread_create(&t, NULL, sleeper, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(pthread_getlibstats_np(&after) == 0);
+  assert(after.joinWaits > before.joinWaits);
+
+  assert(pthread_getlibstats_np(&before) == 0);
+  assert(pthread_create(&t, NULL, sleeper, NULL) == 0);
+  assert(pthread_cancel(t) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(pthread_getlibstats_np(&after) == 0);
+  assert(after.cancellations == before.cancellations + 1);
+
+  return 0;
+}
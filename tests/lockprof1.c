@@ -0,0 +1,143 @@
+/* 
+ * lockprof1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Sampling of contended acquisitions: a mutex released to a blocked
+ * waiter gives a sample with both stacks, and a reader keeps its
+ * position. A library built without PTW32_LOCKSTAT returns ENOTSUP.
+ *
+ * Depends on API functions:
+ *	pthread_lockprof_setsampling_np()
+ *	pthread_lockprof_read_np()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_unlock()
+ */
+
+#include "test.h"
+
+static pthread_mutex_t mutex;
+
+void *
+locker(void * arg)
+{
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  return NULL;
+}
+
+static int
+contend(pthread_t * t)
+{
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_create(t, NULL, locker, NULL) == 0);
+  Sleep(100);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(pthread_join(*t, NULL) == 0);
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_lockprof_np_t samples[4];
+  struct timespec threshold = { 0, 0 };
+  unsigned int position = 0;
+  pthread_t t;
+  int count = -1;
+  int i;
+
+  assert(pthread_mutex_init(&mutex, NULL) == 0);
+
+  if (pthread_lockprof_setsampling_np(1, NULL) == ENOTSUP)
+    {
+      assert(pthread_lockprof_read_np(&position, samples, 4, &count) == ENOTSUP);
+      return 0;
+    }
+
+  assert(pthread_lockprof_setsampling_np(-1, NULL) == EINVAL);
+  threshold.tv_nsec = 1000000000L;
+  assert(pthread_lockprof_setsampling_np(0, &threshold) == EINVAL);
+  assert(pthread_lockprof_read_np(NULL, samples, 4, &count) == EINVAL);
+  assert(pthread_lockprof_read_np(&position, samples, 0, &count) == EINVAL);
+
+  /* Nothing sampled yet */
+  assert(pthread_lockprof_read_np(&position, samples, 4, &count) == 0);
+  assert(count == 0);
+  assert(position == 0);
+
+  /* Every contended acquisition */
+  assert(contend(&t) == 0);
+  assert(pthread_lockprof_read_np(&position, samples, 4, &count) == 0);
+  assert(count >= 1);
+  assert(position == (unsigned int) count);
+  /* The library's own locks may have been contended too */
+  for (i = 0; samples[i].object != (void *) mutex; i++)
+    {
+      assert(i + 1 < count);
+    }
+  assert(samples[i].kind == PTHREAD_LOCKSTAT_MUTEX_NP);
+  assert(pthread_equal(samples[i].waiter, t));
+  assert(pthread_equal(samples[i].owner, pthread_self()));
+  assert(samples[i].waitTime > 0);
+  assert(samples[i].waiterDepth > 0);
+  assert(samples[i].ownerDepth > 0);
+
+  /* Read once per reader */
+  assert(pthread_lockprof_read_np(&position, samples, 4, &count) == 0);
+  assert(count == 0);
+
+  /* Only waits of at least 10 seconds: none */
+  threshold.tv_sec = 10;
+  threshold.tv_nsec = 0;
+  assert(pthread_lockprof_setsampling_np(0, &threshold) == 0);
+  assert(contend(&t) == 0);
+  assert(pthread_lockprof_read_np(&position, samples, 4, &count) == 0);
+  assert(count == 0);
+
+  /* Off */
+  assert(pthread_lockprof_setsampling_np(0, NULL) == 0);
+  assert(contend(&t) == 0);
+  assert(pthread_lockprof_read_np(&position, samples, 4, &count) == 0);
+  assert(count == 0);
+
+  /* A new reader starts with the oldest kept */
+  position = 0;
+  assert(pthread_lockprof_read_np(&position, samples, 4, &count) == 0);
+  assert(count >= 1);
+
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  return 0;
+}
@@ -0,0 +1,188 @@
+/* 
+ * lockstat1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Contention statistics of a mutex, a condition variable and a
+ * read-write lock, each contended once, and the walk over contended
+ * objects. A library built without PTW32_LOCKSTAT returns ENOTSUP.
+ *
+ * Depends on API functions:
+ *	pthread_mutex_getstats_np()
+ *	pthread_cond_getstats_np()
+ *	pthread_rwlock_getstats_np()
+ *	pthread_lockstat_walk_np()
+ *	pthread_lockstat_dump_np()
+ */
+
+#include "test.h"
+
+static pthread_mutex_t mutex;
+static pthread_cond_t cond;
+static pthread_rwlock_t rwlock;
+static int signalled = 0;
+
+void *
+locker(void * arg)
+{
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  return NULL;
+}
+
+void *
+signaller(void * arg)
+{
+  Sleep(100);
+  assert(pthread_mutex_lock(&mutex) == 0);
+  signalled = 1;
+  assert(pthread_cond_signal(&cond) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  return NULL;
+}
+
+void *
+reader(void * arg)
+{
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  return NULL;
+}
+
+static int
+find(int kind, void * object, const pthread_lockstat_np_t * stats, void * arg)
+{
+  return (object == *(void **) arg) ? 1 + kind : 0;
+}
+
+int
+main()
+{
+  pthread_lockstat_np_t stats;
+  struct timespec abstime = { 0, 0 };
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+  pthread_t t;
+  void * object;
+
+  assert(pthread_mutex_init(&mutex, NULL) == 0);
+  assert(pthread_cond_init(&cond, NULL) == 0);
+  assert(pthread_rwlock_init(&rwlock, NULL) == 0);
+
+  if (pthread_mutex_getstats_np(&mutex, &stats) == ENOTSUP)
+    {
+      assert(pthread_cond_getstats_np(&cond, &stats) == ENOTSUP);
+      assert(pthread_rwlock_getstats_np(&rwlock, &stats) == ENOTSUP);
+      assert(pthread_lockstat_walk_np(find, &object) == ENOTSUP);
+      assert(pthread_lockstat_dump_np() == ENOTSUP);
+      return 0;
+    }
+
+  assert(pthread_mutex_getstats_np(&mutex, NULL) == EINVAL);
+  assert(pthread_lockstat_walk_np(NULL, NULL) == EINVAL);
+
+  /* Uncontended */
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(pthread_mutex_getstats_np(&mutex, &stats) == 0);
+  assert(stats.acquisitions == 1);
+  assert(stats.contended == 0);
+  assert(stats.waitTime == 0);
+  object = (void *) mutex;
+  assert(pthread_lockstat_walk_np(find, &object) == 0);
+
+  /* Contended */
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_create(&t, NULL, locker, NULL) == 0);
+  Sleep(100);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(pthread_mutex_getstats_np(&mutex, &stats) == 0);
+  assert(stats.acquisitions == 3);
+  assert(stats.contended == 1);
+  assert(stats.waitTime > 0);
+  assert(stats.maxWaitTime == stats.waitTime);
+  assert(pthread_lockstat_walk_np(find, &object) == 1 + PTHREAD_LOCKSTAT_MUTEX_NP);
+
+  /* A wait that times out, then one that is woken */
+  PTW32_FTIME(&currSysTime);
+  abstime.tv_sec = (long)currSysTime.time;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+  abstime.tv_nsec += 50 * NANOSEC_PER_MILLISEC;
+  if (abstime.tv_nsec >= 1000000000)
+    {
+      abstime.tv_sec++;
+      abstime.tv_nsec -= 1000000000;
+    }
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_cond_timedwait(&cond, &mutex, &abstime) == ETIMEDOUT);
+  assert(pthread_create(&t, NULL, signaller, NULL) == 0);
+  while (!signalled)
+    {
+      assert(pthread_cond_wait(&cond, &mutex) == 0);
+    }
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(pthread_cond_getstats_np(&cond, &stats) == 0);
+  assert(stats.acquisitions >= 2);
+  assert(stats.contended >= 1);
+  assert(stats.waitTime > 0);
+  object = (void *) cond;
+  assert(pthread_lockstat_walk_np(find, &object) == 1 + PTHREAD_LOCKSTAT_COND_NP);
+
+  /* A reader blocked by a writer */
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  assert(pthread_create(&t, NULL, reader, NULL) == 0);
+  Sleep(100);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(pthread_rwlock_getstats_np(&rwlock, &stats) == 0);
+  assert(stats.acquisitions >= 2);
+  assert(stats.contended >= 1);
+  assert(stats.waitTime > 0);
+
+  assert(pthread_lockstat_dump_np() == 0);
+
+  /* Destroyed objects leave the walk */
+  object = (void *) mutex;
+  assert(pthread_mutex_destroy(&mutex) == 0);
+  assert(pthread_lockstat_walk_np(find, &object) == 0);
+
+  assert(pthread_cond_destroy(&cond) == 0);
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  return 0;
+}
@@ -0,0 +1,182 @@
+/* 
+ * lockstripe1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Lock striping: equal hashes share a stripe, several stripes lock
+ * together in a deadlock free order, and transfers between buckets
+ * under pthread_lockstripe_lockmany_np keep the total.
+ *
+ * Depends on API functions:
+ *	pthread_lockstripe_create_np()
+ *	pthread_lockstripe_destroy_np()
+ *	pthread_lockstripe_lock_np()
+ *	pthread_lockstripe_trylock_np()
+ *	pthread_lockstripe_unlock_np()
+ *	pthread_lockstripe_lockmany_np()
+ *	pthread_lockstripe_unlockmany_np()
+ *	pthread_lockstripe_getmutex_np()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4,
+  NUMBUCKETS = 64,
+  NUMSTRIPES = 12,
+  ITERATIONS = 20000
+};
+
+static pthread_lockstripe_np_t stripe;
+static long buckets[NUMBUCKETS];
+
+void *
+worker(void * arg)
+{
+  unsigned int seed = (unsigned int) (size_t) arg;
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      size_t h[3];
+
+      seed = seed * 1103515245 + 12345;
+      h[0] = (seed >> 8) % NUMBUCKETS;
+      seed = seed * 1103515245 + 12345;
+      h[1] = (seed >> 8) % NUMBUCKETS;
+      h[2] = h[0];
+
+      assert(pthread_lockstripe_lockmany_np(stripe, h, 3) == 0);
+      buckets[h[0]]--;
+      buckets[h[1]]++;
+      assert(pthread_lockstripe_unlockmany_np(stripe, h, 3) == 0);
+
+      assert(pthread_lockstripe_lock_np(stripe, h[1]) == 0);
+      buckets[h[1]]--;
+      buckets[h[1]]++;
+      assert(pthread_lockstripe_unlock_np(stripe, h[1]) == 0);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  pthread_mutexattr_t ma;
+  pthread_mutex_t m1;
+  pthread_mutex_t m2;
+  size_t h[2];
+  long total = 0;
+  int i;
+
+  assert(pthread_lockstripe_create_np(NULL, NUMSTRIPES, NULL) == EINVAL);
+  assert(pthread_lockstripe_create_np(&stripe, 0, NULL) == EINVAL);
+  assert(pthread_lockstripe_create_np(&stripe, PTHREAD_LOCKSTRIPE_MAX_NP + 1, NULL) == EINVAL);
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_setpshared(&ma, PTHREAD_PROCESS_SHARED) == 0);
+  assert(pthread_lockstripe_create_np(&stripe, NUMSTRIPES, &ma) == EINVAL);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  /* One stripe holds everything */
+  assert(pthread_lockstripe_create_np(&stripe, 1, NULL) == 0);
+  assert(pthread_lockstripe_getmutex_np(stripe, 1, &m1) == 0);
+  assert(pthread_lockstripe_getmutex_np(stripe, 12345, &m2) == 0);
+  assert(m1 == m2);
+  assert(pthread_lockstripe_destroy_np(&stripe) == 0);
+  assert(stripe == NULL);
+
+  assert(pthread_lockstripe_create_np(&stripe, NUMSTRIPES, NULL) == 0);
+
+  assert(pthread_lockstripe_lockmany_np(stripe, NULL, 1) == EINVAL);
+  assert(pthread_lockstripe_lockmany_np(stripe, h, 0) == EINVAL);
+  assert(pthread_lockstripe_getmutex_np(stripe, 7, NULL) == EINVAL);
+
+  /* Stripes are cache line padded and equal hashes agree */
+  for (i = 0; i < 256; i++)
+    {
+      assert(pthread_lockstripe_getmutex_np(stripe, i, &m1) == 0);
+      assert(pthread_lockstripe_getmutex_np(stripe, i, &m2) == 0);
+      assert(m1 == m2);
+      assert(((size_t) m1 & 63) == 0);
+    }
+
+  /* Find two hashes on different stripes */
+  h[0] = 0;
+  assert(pthread_lockstripe_getmutex_np(stripe, h[0], &m1) == 0);
+  for (h[1] = 1; ; h[1]++)
+    {
+      assert(pthread_lockstripe_getmutex_np(stripe, h[1], &m2) == 0);
+      if (m1 != m2)
+	{
+	  break;
+	}
+    }
+
+  assert(pthread_lockstripe_lockmany_np(stripe, h, 2) == 0);
+  assert(pthread_lockstripe_trylock_np(stripe, h[0]) == EBUSY);
+  assert(pthread_lockstripe_trylock_np(stripe, h[1]) == EBUSY);
+  assert(pthread_mutex_trylock(&m2) == EBUSY);
+  assert(pthread_lockstripe_destroy_np(&stripe) == EBUSY);
+  assert(stripe != NULL);
+  assert(pthread_lockstripe_unlockmany_np(stripe, h, 2) == 0);
+
+  /* The busy destroy left every stripe usable */
+  for (i = 0; i < 256; i++)
+    {
+      assert(pthread_lockstripe_trylock_np(stripe, i) == 0);
+      assert(pthread_lockstripe_unlock_np(stripe, i) == 0);
+    }
+  assert(pthread_lockstripe_destroy_np(&stripe) == 0);
+
+  assert(pthread_lockstripe_create_np(&stripe, NUMSTRIPES, NULL) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, (void *) (size_t) (i + 1)) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  for (i = 0; i < NUMBUCKETS; i++)
+    {
+      total += buckets[i];
+    }
+  assert(total == 0);
+
+  assert(pthread_lockstripe_destroy_np(&stripe) == 0);
+
+  return 0;
+}
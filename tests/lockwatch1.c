@@ -0,0 +1,155 @@
+/* 
+ * lockwatch1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Lock order inversions and long holds are reported to the callback:
+ * A then B in one thread and B then A in another is reported once,
+ * a consistent order and recursive relocking are not, and a hold over
+ * the limit is. A library built without PTW32_LOCKWATCH returns
+ * ENOTSUP.
+ *
+ * Depends on API functions:
+ *	pthread_lockwatch_setcallback_np()
+ *	pthread_lockwatch_setholdlimit_np()
+ */
+
+#include "test.h"
+
+static pthread_mutex_t a;
+static pthread_mutex_t b;
+static pthread_mutex_t c;
+static int orders = 0;
+static int holds = 0;
+static pthread_lockwatch_np_t last;
+
+static void
+watch(const pthread_lockwatch_np_t * report, void * arg)
+{
+  assert(arg == (void *) &last);
+  last = *report;
+  if (report->event == PTHREAD_LOCKWATCH_ORDER_NP)
+    {
+      orders++;
+    }
+  else
+    {
+      holds++;
+    }
+}
+
+void *
+reversed(void * arg)
+{
+  assert(pthread_mutex_lock(&b) == 0);
+  assert(pthread_mutex_lock(&a) == 0);
+  assert(pthread_mutex_unlock(&a) == 0);
+  assert(pthread_mutex_unlock(&b) == 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_mutexattr_t ma;
+  struct timespec limit = { 0, 20000000 };
+  struct timespec bad = { 0, 1000000000 };
+  pthread_t t;
+
+  if (pthread_lockwatch_setcallback_np(watch, &last) == ENOTSUP)
+    {
+      assert(pthread_lockwatch_setholdlimit_np(&limit) == ENOTSUP);
+      return 0;
+    }
+
+  assert(pthread_lockwatch_setholdlimit_np(&bad) == EINVAL);
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_RECURSIVE) == 0);
+  assert(pthread_mutex_init(&a, NULL) == 0);
+  assert(pthread_mutex_init(&b, NULL) == 0);
+  assert(pthread_mutex_init(&c, &ma) == 0);
+
+  /* A then B, twice, and C recursively inside them */
+  assert(pthread_mutex_lock(&a) == 0);
+  assert(pthread_mutex_lock(&b) == 0);
+  assert(pthread_mutex_lock(&c) == 0);
+  assert(pthread_mutex_lock(&c) == 0);
+  assert(pthread_mutex_unlock(&c) == 0);
+  assert(pthread_mutex_unlock(&c) == 0);
+  assert(pthread_mutex_unlock(&b) == 0);
+  assert(pthread_mutex_unlock(&a) == 0);
+  assert(pthread_mutex_lock(&a) == 0);
+  assert(pthread_mutex_trylock(&b) == 0);
+  assert(pthread_mutex_unlock(&b) == 0);
+  assert(pthread_mutex_unlock(&a) == 0);
+  assert(orders == 0);
+
+  /* B then A in another thread */
+  assert(pthread_create(&t, NULL, reversed, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(orders == 1);
+  assert(last.event == PTHREAD_LOCKWATCH_ORDER_NP);
+  assert(last.held == b);
+  assert(last.acquired == a);
+  assert(pthread_equal(last.thread, t));
+
+  /* Only reported once */
+  assert(pthread_create(&t, NULL, reversed, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(orders == 1);
+
+  /* A long hold, and a short one */
+  assert(holds == 0);
+  assert(pthread_lockwatch_setholdlimit_np(&limit) == 0);
+  assert(pthread_mutex_lock(&c) == 0);
+  Sleep(100);
+  assert(pthread_mutex_unlock(&c) == 0);
+  assert(holds == 1);
+  assert(last.event == PTHREAD_LOCKWATCH_HOLD_NP);
+  assert(last.held == c);
+  assert(last.holdTime >= 50000000);
+  assert(pthread_mutex_lock(&c) == 0);
+  assert(pthread_mutex_unlock(&c) == 0);
+  assert(holds == 1);
+
+  assert(pthread_lockwatch_setholdlimit_np(NULL) == 0);
+  assert(pthread_lockwatch_setcallback_np(NULL, NULL) == 0);
+
+  assert(pthread_mutex_destroy(&a) == 0);
+  assert(pthread_mutex_destroy(&b) == 0);
+  assert(pthread_mutex_destroy(&c) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  return 0;
+}
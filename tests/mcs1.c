@@ -0,0 +1,145 @@
+/* 
+ * mcs1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * MCS queue locks: mutual exclusion, trylock, and a lock transferred
+ * to a node outside the locking function and unlocked by another
+ * thread.
+ *
+ * Depends on API functions:
+ *	pthread_mcs_lock_np()
+ *	pthread_mcs_trylock_np()
+ *	pthread_mcs_unlock_np()
+ *	pthread_mcs_node_transfer_np()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 8,
+  ITERATIONS = 50000
+};
+
+static pthread_mcs_lock_np_t lock = PTHREAD_MCS_LOCK_INITIALIZER_NP;
+static pthread_mcs_node_np_t heldNode;
+static long counter = 0;
+static volatile long inside = 0;
+
+void *
+locker(void * arg)
+{
+  pthread_mcs_node_np_t node;
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      if (i % 8 == 0)
+        {
+          while (pthread_mcs_trylock_np(&lock, &node) != 0)
+            {
+              sched_yield();
+            }
+        }
+      else
+        {
+          assert(pthread_mcs_lock_np(&lock, &node) == 0);
+        }
+      assert(InterlockedIncrement((long *) &inside) == 1);
+      counter++;
+      assert(InterlockedDecrement((long *) &inside) == 0);
+      assert(pthread_mcs_unlock_np(&node) == 0);
+    }
+
+  return NULL;
+}
+
+static void
+take(void)
+{
+  pthread_mcs_node_np_t node;
+
+  assert(pthread_mcs_lock_np(&lock, &node) == 0);
+  assert(pthread_mcs_node_transfer_np(&heldNode, &node) == 0);
+}
+
+void *
+release(void * arg)
+{
+  assert(pthread_mcs_unlock_np(&heldNode) == 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_mcs_node_np_t node;
+  pthread_t t[NUMTHREADS];
+  int i;
+
+  assert(pthread_mcs_lock_np(NULL, &node) == EINVAL);
+  assert(pthread_mcs_lock_np(&lock, NULL) == EINVAL);
+
+  assert(pthread_mcs_trylock_np(&lock, &node) == 0);
+  {
+    pthread_mcs_node_np_t other;
+
+    assert(pthread_mcs_trylock_np(&lock, &other) == EBUSY);
+  }
+  assert(pthread_mcs_unlock_np(&node) == 0);
+  assert(lock == NULL);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, locker, NULL) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  assert(counter == NUMTHREADS * ITERATIONS);
+  assert(lock == NULL);
+
+  /* Held beyond take() and released by another thread */
+  take();
+  assert(lock == &heldNode);
+  assert(pthread_mcs_trylock_np(&lock, &node) == EBUSY);
+  assert(pthread_create(&t[0], NULL, release, NULL) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(lock == NULL);
+
+  return 0;
+}
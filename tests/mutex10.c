@@ -0,0 +1,188 @@
+/*
+ * File: mutex10.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis: Verify the kind specialised mutex functions
+ * - pthread_mutex_lock_normal_np() etc.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - 
+ *
+ * Features Tested:
+ * - 
+ *
+ * Cases Tested:
+ * - each kind locks, unlocks and reports errors as the general
+ *   functions do, including under contention.
+ * - a mutex of another kind, or a robust one, takes the general path.
+ *
+ * Description:
+ * - 
+ *
+ * Environment:
+ * - 
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - 
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4,
+  ITERATIONS = 10000
+};
+
+static pthread_mutex_t mutex;
+static long counter;
+
+static int
+initMutex(pthread_mutex_t * mx, int kind, int robust)
+{
+  pthread_mutexattr_t ma;
+  int result;
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_settype(&ma, kind) == 0);
+  assert(pthread_mutexattr_setrobust(&ma, robust) == 0);
+  result = pthread_mutex_init(mx, &ma);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  return result;
+}
+
+static void *
+counterThread(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_mutex_lock_normal_np(&mutex) == 0);
+      counter++;
+      assert(pthread_mutex_unlock_normal_np(&mutex) == 0);
+    }
+
+  return NULL;
+}
+
+static void *
+tryThread(void * arg)
+{
+  return (void *)(size_t) pthread_mutex_trylock_errorcheck_np(&mutex);
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  void * result;
+  int i;
+
+  /* Normal, contended */
+  assert(initMutex(&mutex, PTHREAD_MUTEX_NORMAL, PTHREAD_MUTEX_STALLED) == 0);
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, counterThread, NULL) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  assert(counter == NUMTHREADS * ITERATIONS);
+  assert(pthread_mutex_trylock_normal_np(&mutex) == 0);
+  assert(pthread_mutex_trylock_normal_np(&mutex) == EBUSY);
+  assert(pthread_mutex_unlock_normal_np(&mutex) == 0);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  /* Recursive */
+  assert(initMutex(&mutex, PTHREAD_MUTEX_RECURSIVE, PTHREAD_MUTEX_STALLED) == 0);
+  assert(pthread_mutex_lock_recursive_np(&mutex) == 0);
+  assert(pthread_mutex_lock_recursive_np(&mutex) == 0);
+  assert(pthread_mutex_trylock_recursive_np(&mutex) == 0);
+  assert(pthread_mutex_unlock_recursive_np(&mutex) == 0);
+  assert(pthread_mutex_unlock_recursive_np(&mutex) == 0);
+  assert(pthread_mutex_unlock_recursive_np(&mutex) == 0);
+  assert(pthread_mutex_unlock_recursive_np(&mutex) == EPERM);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  /* Error checking */
+  assert(initMutex(&mutex, PTHREAD_MUTEX_ERRORCHECK, PTHREAD_MUTEX_STALLED) == 0);
+  assert(pthread_mutex_lock_errorcheck_np(&mutex) == 0);
+  assert(pthread_mutex_lock_errorcheck_np(&mutex) == EDEADLK);
+  assert(pthread_mutex_trylock_errorcheck_np(&mutex) == EBUSY);
+  assert(pthread_create(&t[0], NULL, tryThread, NULL) == 0);
+  assert(pthread_join(t[0], &result) == 0);
+  assert((int)(size_t) result == EBUSY);
+  assert(pthread_mutex_unlock_errorcheck_np(&mutex) == 0);
+  assert(pthread_mutex_unlock_errorcheck_np(&mutex) == EPERM);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  /* Kind mismatch: behaves as the mutex's own kind */
+  assert(initMutex(&mutex, PTHREAD_MUTEX_RECURSIVE, PTHREAD_MUTEX_STALLED) == 0);
+  assert(pthread_mutex_lock_normal_np(&mutex) == 0);
+  assert(pthread_mutex_lock_normal_np(&mutex) == 0);
+  assert(pthread_mutex_unlock_normal_np(&mutex) == 0);
+  assert(pthread_mutex_unlock_normal_np(&mutex) == 0);
+  assert(pthread_mutex_unlock_normal_np(&mutex) == EPERM);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  /* Robust: the general path keeps the robust bookkeeping */
+  assert(initMutex(&mutex, PTHREAD_MUTEX_ERRORCHECK, PTHREAD_MUTEX_ROBUST) == 0);
+  assert(pthread_mutex_lock_errorcheck_np(&mutex) == 0);
+  assert(pthread_mutex_lock_errorcheck_np(&mutex) == EDEADLK);
+  assert(pthread_mutex_unlock_errorcheck_np(&mutex) == 0);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  return 0;
+}
@@ -0,0 +1,142 @@
+/*
+ * File: mutex11.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis: Verify that an unlock only wakes parked waiters
+ * - pthread_mutex_unlock() after the waiters have gone.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - 
+ *
+ * Features Tested:
+ * - 
+ *
+ * Cases Tested:
+ * - a waiter that blocked and then acquired the mutex leaves lock_idx
+ *   -1; its own unlock wakes nobody.
+ * - two threads passing a mutex back and forth lose no wakeups.
+ *
+ * Description:
+ * - 
+ *
+ * Environment:
+ * - 
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - 
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+
+#include "test.h"
+
+enum {
+  ROUNDS = 100000
+};
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile long count = 0;
+
+static void *
+waiter(void * arg)
+{
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  return NULL;
+}
+
+static void *
+pingpong(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ROUNDS; i++)
+    {
+      assert(pthread_mutex_lock(&mutex) == 0);
+      count++;
+      assert(pthread_mutex_unlock(&mutex) == 0);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_libstats_np_t before, after;
+  pthread_t t[2];
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_create(&t[0], NULL, waiter, NULL) == 0);
+  Sleep(100);
+
+  assert(pthread_getlibstats_np(&before) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(pthread_getlibstats_np(&after) == 0);
+
+  /*
+   * At most the one wake for the blocked waiter; none for its own
+   * unlock. (None at all where waits use WaitOnAddress.)
+   */
+  assert(after.setEvents - before.setEvents <= 1);
+
+  assert(pthread_create(&t[0], NULL, pingpong, NULL) == 0);
+  assert(pthread_create(&t[1], NULL, pingpong, NULL) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(pthread_join(t[1], NULL) == 0);
+  assert(count == 2 * ROUNDS);
+
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  return 0;
+}
@@ -0,0 +1,171 @@
+/* 
+ * mutex9.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Tests adaptive (spin-then-block) mutexes.
+ * Several threads increment a shared counter under a mutex with a
+ * spin budget, for each mutex type, using both pthread_mutex_lock()
+ * and pthread_mutex_timedlock(). The count must not be disturbed.
+ *
+ * Depends on API functions: 
+ *      pthread_create()
+ *      pthread_join()
+ *      pthread_mutexattr_init()
+ *      pthread_mutexattr_destroy()
+ *      pthread_mutexattr_settype()
+ *      pthread_mutexattr_setspin_np()
+ *      pthread_mutexattr_getspin_np()
+ *      pthread_mutex_setdefaultspin_np()
+ *      pthread_mutex_getdefaultspin_np()
+ *      pthread_mutex_init()
+ *      pthread_mutex_destroy()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_timedlock()
+ *	pthread_mutex_unlock()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4,
+  ITERATIONS = 20000
+};
+
+static int lockCount;
+
+static pthread_mutex_t mutex;
+static pthread_mutexattr_t mxAttr;
+static struct timespec abstime = { 0, 0 };
+
+void * locker(void * arg)
+{
+  int i;
+  int timed = (int)(size_t)arg;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      if (timed)
+        {
+          assert(pthread_mutex_timedlock(&mutex, &abstime) == 0);
+        }
+      else
+        {
+          assert(pthread_mutex_lock(&mutex) == 0);
+        }
+      lockCount++;
+      assert(pthread_mutex_unlock(&mutex) == 0);
+    }
+
+  return (void *) 555;
+}
+
+static void
+runTest (int mxType)
+{
+  pthread_t t[NUMTHREADS];
+  void* result = (void*)0;
+  int i;
+
+  lockCount = 0;
+  assert(pthread_mutexattr_settype(&mxAttr, mxType) == 0);
+  assert(pthread_mutex_init(&mutex, &mxAttr) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, locker, (void *)(size_t)(i & 1)) == 0);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], &result) == 0);
+      assert((int)(size_t)result == 555);
+    }
+
+  assert(lockCount == NUMTHREADS * ITERATIONS);
+
+  assert(pthread_mutex_destroy(&mutex) == 0);
+}
+
+int
+main()
+{
+  int spin = 0;
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+
+  PTW32_FTIME(&currSysTime);
+
+  abstime.tv_sec = (long)currSysTime.time;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+
+  abstime.tv_sec += 60;
+
+  assert(pthread_mutex_getdefaultspin_np(&spin) == 0);
+  assert(spin == 0);
+  assert(pthread_mutex_setdefaultspin_np(-1) == EINVAL);
+  assert(pthread_mutex_setdefaultspin_np(1000) == 0);
+  assert(pthread_mutex_getdefaultspin_np(&spin) == 0);
+  assert(spin == 1000);
+
+  assert(pthread_mutexattr_init(&mxAttr) == 0);
+
+  assert(pthread_mutexattr_getspin_np(&mxAttr, &spin) == 0);
+  assert(spin == PTHREAD_MUTEX_SPIN_DEFAULT);
+  assert(pthread_mutexattr_setspin_np(&mxAttr, -2) == EINVAL);
+
+  BEGIN_MUTEX_STALLED_ROBUST(mxAttr)
+
+  /* Process default spin */
+  assert(pthread_mutexattr_setspin_np(&mxAttr, PTHREAD_MUTEX_SPIN_DEFAULT) == 0);
+  runTest(PTHREAD_MUTEX_NORMAL);
+
+  /* Explicit spin */
+  assert(pthread_mutexattr_setspin_np(&mxAttr, 4000) == 0);
+  assert(pthread_mutexattr_getspin_np(&mxAttr, &spin) == 0);
+  assert(spin == 4000);
+  runTest(PTHREAD_MUTEX_NORMAL);
+  runTest(PTHREAD_MUTEX_ERRORCHECK);
+  runTest(PTHREAD_MUTEX_RECURSIVE);
+
+  /* No spin */
+  assert(pthread_mutexattr_setspin_np(&mxAttr, 0) == 0);
+  runTest(PTHREAD_MUTEX_DEFAULT);
+
+  END_MUTEX_STALLED_ROBUST(mxAttr)
+
+  assert(pthread_mutexattr_destroy(&mxAttr) == 0);
+  assert(pthread_mutex_setdefaultspin_np(0) == 0);
+
+  return 0;
+}
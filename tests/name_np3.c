@@ -0,0 +1,108 @@
+/*
+ * name_np3.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Description:
+ * Names set through the attributes are in place when the thread
+ * starts, renaming replaces the name, and a name longer than
+ * PTHREAD_MAX_NAMELEN_NP - 1 characters is truncated.
+ *
+ * Depends on API functions:
+ *      pthread_create
+ *      pthread_join
+ *      pthread_self
+ *      pthread_attr_init
+ *      pthread_getname_np
+ *      pthread_setname_np
+ *      pthread_attr_setname_np
+ */
+
+#include "test.h"
+#include <string.h>
+
+#if defined(PTW32_COMPATIBILITY_BSD) || defined(PTW32_COMPATIBILITY_TRU64)
+
+int
+main()
+{
+  return 0;
+}
+
+#else
+
+static char startName[32];
+
+void * func(void * arg)
+{
+  assert(pthread_getname_np(pthread_self(), startName, sizeof(startName)) == 0);
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_t t;
+  pthread_attr_t attr;
+  char buf[32];
+  int i;
+
+  assert(pthread_attr_init(&attr) == 0);
+  assert(pthread_attr_setname_np(&attr, "Worker") == 0);
+  assert(pthread_create(&t, &attr, func, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(pthread_attr_destroy(&attr) == 0);
+  assert(strcmp(startName, "Worker") == 0);
+
+  for (i = 0; i < 100; i++)
+    {
+      sprintf(buf, "Task%d", i);
+      assert(pthread_setname_np(pthread_self(), buf) == 0);
+    }
+  assert(pthread_getname_np(pthread_self(), buf, sizeof(buf)) == 0);
+  assert(strcmp(buf, "Task99") == 0);
+
+  assert(pthread_setname_np(pthread_self(), "ABCDEFGHIJKLMNOPQRSTUVWXYZ") == 0);
+  assert(pthread_getname_np(pthread_self(), buf, sizeof(buf)) == 0);
+  assert(strlen(buf) == PTHREAD_MAX_NAMELEN_NP - 1);
+  assert(strncmp(buf, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", PTHREAD_MAX_NAMELEN_NP - 1) == 0);
+
+  assert(pthread_getname_np(pthread_self(), buf, 4) == 0);
+  assert(strcmp(buf, "ABC") == 0);
+
+  return 0;
+}
+
+#endif
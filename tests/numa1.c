@@ -0,0 +1,190 @@
+/* 
+ * numa1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ *
+ * Test the processor topology queries and NUMA node placement: every
+ * CPU of the process is on a node and in its core and cache sets,
+ * and a thread created with a node runs on that node's CPUs.
+ *
+ * Depends on API functions:
+ *	pthread_num_numanodes_np()
+ *	pthread_getnumanodecpus_np()
+ *	pthread_getcpunumanode_np()
+ *	pthread_getcpusiblings_np()
+ *	pthread_attr_setnumanode_np()
+ *	pthread_attr_getnumanode_np()
+ *	pthread_getnumanode_np()
+ *	pthread_getaffinity_np()
+ *	sched_getaffinity()
+ */
+
+#if ! defined(WINCE)
+
+#include "test.h"
+
+static int wantNode;
+
+static int
+subset(cpu_set_t * a, cpu_set_t * b)
+{
+  cpu_set_t common;
+
+  CPU_AND(&common, a, b);
+  return CPU_EQUAL(&common, a);
+}
+
+void *
+mythread(void * arg)
+{
+  cpu_set_t threadCpus;
+  cpu_set_t nodeCpus;
+  int node;
+
+  assert(pthread_getnumanode_np(pthread_self(), &node) == 0);
+  assert(node == wantNode);
+  assert(pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &threadCpus) == 0);
+  assert(pthread_getnumanodecpus_np(wantNode, sizeof(cpu_set_t), &nodeCpus) == 0);
+  assert(CPU_COUNT(&threadCpus) > 0);
+  assert(subset(&threadCpus, &nodeCpus));
+
+  return arg;
+}
+
+int
+main()
+{
+  int cpu;
+  int node;
+  int nodes = pthread_num_numanodes_np();
+  cpu_set_t processCpus;
+  cpu_set_t allNodeCpus;
+  cpu_set_t set;
+  pthread_attr_t attr;
+  pthread_t t;
+
+  assert(nodes >= 1);
+
+  if (pthread_getnumanode_np(pthread_self(), &node) == ENOSYS)
+    {
+      printf("CPU affinity not supported for this platform: skipping test.");
+      return 0;
+    }
+
+  assert(sched_getaffinity(0, sizeof(cpu_set_t), &processCpus) == 0);
+
+  CPU_ZERO(&allNodeCpus);
+  for (node = 0; node < nodes; node++)
+    {
+      assert(pthread_getnumanodecpus_np(node, sizeof(cpu_set_t), &set) == 0);
+      CPU_OR(&allNodeCpus, &allNodeCpus, &set);
+    }
+  assert(pthread_getnumanodecpus_np(nodes, sizeof(cpu_set_t), &set) == EINVAL);
+  assert(pthread_getnumanodecpus_np(-1, sizeof(cpu_set_t), &set) == EINVAL);
+  assert(subset(&processCpus, &allNodeCpus));
+
+  wantNode = -1;
+  for (cpu = 0; cpu < (int) CPU_SETSIZE; cpu++)
+    {
+      cpu_set_t nodeCpus;
+
+      if (!CPU_ISSET(cpu, &processCpus))
+        {
+          continue;
+        }
+
+      assert(pthread_getcpunumanode_np(cpu, &node) == 0);
+      assert(node >= 0 && node < nodes);
+      assert(pthread_getnumanodecpus_np(node, sizeof(cpu_set_t), &nodeCpus) == 0);
+      assert(CPU_ISSET(cpu, &nodeCpus));
+
+      assert(pthread_getcpusiblings_np(cpu, PTHREAD_CPU_NUMANODE_NP, sizeof(cpu_set_t), &set) == 0);
+      assert(CPU_EQUAL(&set, &nodeCpus));
+      assert(pthread_getcpusiblings_np(cpu, PTHREAD_CPU_CORE_NP, sizeof(cpu_set_t), &set) == 0);
+      assert(CPU_ISSET(cpu, &set));
+      assert(subset(&set, &nodeCpus));
+      assert(pthread_getcpusiblings_np(cpu, PTHREAD_CPU_CACHE_NP, sizeof(cpu_set_t), &set) == 0);
+      assert(CPU_ISSET(cpu, &set));
+
+      wantNode = node;
+    }
+  assert(wantNode >= 0);
+  assert(pthread_getcpusiblings_np(0, 3, sizeof(cpu_set_t), &set) == EINVAL);
+  assert(pthread_getcpusiblings_np(CPU_SETSIZE, PTHREAD_CPU_CORE_NP, sizeof(cpu_set_t), &set) == EINVAL);
+  assert(pthread_getcpunumanode_np(-1, &node) == EINVAL);
+
+  assert(pthread_attr_init(&attr) == 0);
+  assert(pthread_attr_getnumanode_np(&attr, &node) == 0);
+  assert(node == -1);
+  assert(pthread_attr_setnumanode_np(&attr, nodes) == EINVAL);
+  assert(pthread_attr_setnumanode_np(&attr, -2) == EINVAL);
+  assert(pthread_attr_setnumanode_np(&attr, wantNode) == 0);
+  assert(pthread_attr_getnumanode_np(&attr, &node) == 0);
+  assert(node == wantNode);
+
+  assert(pthread_create(&t, &attr, mythread, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+
+  /*
+   * A CPU set in the attributes is kept where it overlaps the node.
+   */
+  assert(pthread_getnumanodecpus_np(wantNode, sizeof(cpu_set_t), &set) == 0);
+  for (cpu = 0; cpu < (int) CPU_SETSIZE; cpu++)
+    {
+      if (CPU_ISSET(cpu, &set))
+        {
+          CPU_ZERO(&set);
+          CPU_SET(cpu, &set);
+          break;
+        }
+    }
+  assert(pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set) == 0);
+  assert(pthread_create(&t, &attr, mythread, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+
+  assert(pthread_attr_destroy(&attr) == 0);
+
+  return 0;
+}
+
+#else
+
+#include <stdio.h>
+
+int
+main()
+{
+  fprintf(stderr, "Test N/A for this target environment.\n");
+  return 0;
+}
+
+#endif
@@ -0,0 +1,148 @@
+/* 
+ * objalign1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * --------------------------------------------------------------------------
+ * Mutexes, spin locks, semaphores and barriers initialised after
+ * pthread_setobjectalign_np() start on the requested boundary and
+ * work; objects initialised before the call can still be destroyed.
+ *
+ * Depends on API functions:
+ *	pthread_setobjectalign_np()
+ *	pthread_getobjectalign_np()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4,
+  ITERATIONS = 10000,
+  NUMOBJECTS = 8
+};
+
+static pthread_mutex_t mx[NUMOBJECTS];
+static pthread_spinlock_t spin[NUMOBJECTS];
+static pthread_mutex_t staticMx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_barrier_t barrier;
+static long count[NUMOBJECTS];
+
+#define ALIGNED(p, a) ((((size_t) (p)) & ((a) - 1)) == 0)
+
+void *
+worker(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      int j = i % NUMOBJECTS;
+
+      assert(pthread_mutex_lock(&mx[j]) == 0);
+      count[j]++;
+      assert(pthread_mutex_unlock(&mx[j]) == 0);
+
+      assert(pthread_spin_lock(&spin[j]) == 0);
+      count[j]++;
+      assert(pthread_spin_unlock(&spin[j]) == 0);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  pthread_mutex_t before;
+  sem_t s;
+  int align;
+  int i;
+
+  assert(pthread_getobjectalign_np(NULL) == EINVAL);
+  assert(pthread_getobjectalign_np(&align) == 0);
+  assert(align == PTHREAD_OBJECT_ALIGN_DEFAULT_NP);
+  assert(pthread_setobjectalign_np(-1) == EINVAL);
+  assert(pthread_setobjectalign_np(96) == EINVAL);
+  assert(pthread_setobjectalign_np(8192) == EINVAL);
+
+  assert(pthread_mutex_init(&before, NULL) == 0);
+
+  assert(pthread_setobjectalign_np(PTHREAD_OBJECT_ALIGN_SECTOR_NP) == 0);
+  assert(pthread_getobjectalign_np(&align) == 0);
+  assert(align == PTHREAD_OBJECT_ALIGN_SECTOR_NP);
+
+  for (i = 0; i < NUMOBJECTS; i++)
+    {
+      assert(pthread_mutex_init(&mx[i], NULL) == 0);
+      assert(ALIGNED(mx[i], align));
+      assert(pthread_spin_init(&spin[i], PTHREAD_PROCESS_PRIVATE) == 0);
+      assert(ALIGNED(spin[i], align));
+    }
+
+  assert(pthread_mutex_lock(&staticMx) == 0);
+  assert(ALIGNED(staticMx, align));
+  assert(pthread_mutex_unlock(&staticMx) == 0);
+
+  assert(sem_init(&s, 0, 1) == 0);
+  assert(ALIGNED(s, align));
+  assert(sem_wait(&s) == 0);
+  assert(sem_post(&s) == 0);
+
+  assert(pthread_barrier_init(&barrier, NULL, NUMTHREADS) == 0);
+  assert(ALIGNED(barrier, align));
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, NULL) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(pthread_setobjectalign_np(PTHREAD_OBJECT_ALIGN_DEFAULT_NP) == 0);
+
+  for (i = 0; i < NUMOBJECTS; i++)
+    {
+      assert(count[i] == 2 * NUMTHREADS * ITERATIONS / NUMOBJECTS);
+      assert(pthread_mutex_destroy(&mx[i]) == 0);
+      assert(pthread_spin_destroy(&spin[i]) == 0);
+    }
+
+  assert(pthread_mutex_destroy(&staticMx) == 0);
+  assert(sem_destroy(&s) == 0);
+  assert(pthread_barrier_destroy(&barrier) == 0);
+  assert(pthread_mutex_destroy(&before) == 0);
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * once5.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Channel several threads through pthread_once_np(), both the macro
+ * and the function, and check that later calls return at once.
+ *
+ * Depends on API functions:
+ *	pthread_once_np()
+ *	pthread_create()
+ */
+
+#include "test.h"
+
+#define NUM_THREADS 50
+
+pthread_once_t once[2] = { PTHREAD_ONCE_INIT, PTHREAD_ONCE_INIT };
+
+static LONG numOnce[2];
+
+void
+myfunc0(void)
+{
+  InterlockedIncrement(&numOnce[0]);
+  /* Simulate slow once routine so that following threads pile up behind it */
+  Sleep(100);
+}
+
+void
+myfunc1(void)
+{
+  InterlockedIncrement(&numOnce[1]);
+  Sleep(100);
+}
+
+void *
+mythread(void * arg)
+{
+  int i;
+
+  for (i = 0; i < 1000; i++)
+    {
+      assert(pthread_once_np(&once[0], myfunc0) == 0);
+      assert(numOnce[0] == 1);
+      assert((pthread_once_np)(&once[1], myfunc1) == 0);
+      assert(numOnce[1] == 1);
+    }
+
+  return (void*)(size_t)0;
+}
+
+int
+main()
+{
+  pthread_t t[NUM_THREADS];
+  int i;
+
+  assert((pthread_once_np)(NULL, myfunc0) == EINVAL);
+  assert((pthread_once_np)(&once[0], NULL) == EINVAL);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, mythread, NULL) == 0);
+    }
+
+  for (i = 0; i < NUM_THREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(numOnce[0] == 1);
+  assert(numOnce[1] == 1);
+  assert(once[0].done && once[1].done);
+
+  return 0;
+}
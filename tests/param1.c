@@ -0,0 +1,204 @@
+/*
+ * File: param1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Confirm that pthread_setparam_np and pthread_getparam_np set and
+ *   return the library's tunables.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_setparam_np, pthread_getparam_np
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - each parameter reads back as set, and as its own getter sees it.
+ * - calibrated spin budgets spin on multi-processor systems.
+ * - values the parameter's setter rejects are rejected.
+ * - unknown parameters are rejected.
+ * - spin locks still work with the smallest backoff.
+ * - timed waits still time out with high resolution waits turned off.
+ *
+ * Description:
+ * -
+ *
+ * Environment:
+ * - The PTW32_* variables are not set.
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * -
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+int
+main()
+{
+  long value;
+  long saved;
+  int i;
+  pthread_spinlock_t spin;
+
+  assert(pthread_getparam_np(PTHREAD_PARAM_MUTEX_SPIN_NP, NULL) == EINVAL);
+  assert(pthread_getparam_np(-1, &value) == EINVAL);
+  assert(pthread_setparam_np(-1, 0) == EINVAL);
+  assert(pthread_setparam_np(PTHREAD_PARAM_WAKE_BOOST_NP + 1, 0) == EINVAL);
+
+  /* The initial values, unless the environment overrides them */
+  assert(pthread_getparam_np(PTHREAD_PARAM_THREAD_CACHE_NP, &value) == 0);
+  assert(value == 0);
+  /* Spin budgets are calibrated to the processor, but always spin */
+  assert(pthread_getparam_np(PTHREAD_PARAM_SPIN_BACKOFF_NP, &value) == 0);
+  assert(value >= 1);
+  assert(pthread_getparam_np(PTHREAD_PARAM_MCS_SPIN_NP, &value) == 0);
+  assert(value > 0 || pthread_num_processors_np() < 2);
+
+  assert(pthread_setparam_np(PTHREAD_PARAM_MUTEX_SPIN_NP, 100) == 0);
+  assert(pthread_getparam_np(PTHREAD_PARAM_MUTEX_SPIN_NP, &value) == 0);
+  assert(value == 100);
+  {
+    int spinCount;
+
+    assert(pthread_mutex_getdefaultspin_np(&spinCount) == 0);
+    assert(spinCount == 100);
+  }
+  assert(pthread_setparam_np(PTHREAD_PARAM_MUTEX_SPIN_NP, -1) == EINVAL);
+  assert(pthread_setparam_np(PTHREAD_PARAM_MUTEX_SPIN_NP, 0) == 0);
+
+  assert(pthread_getparam_np(PTHREAD_PARAM_MCS_SPIN_NP, &saved) == 0);
+  assert(pthread_setparam_np(PTHREAD_PARAM_MCS_SPIN_NP, 0) == 0);
+  assert(pthread_getparam_np(PTHREAD_PARAM_MCS_SPIN_NP, &value) == 0);
+  assert(value == 0);
+  assert(pthread_setparam_np(PTHREAD_PARAM_MCS_SPIN_NP, -1) == EINVAL);
+  assert(pthread_setparam_np(PTHREAD_PARAM_MCS_SPIN_NP, saved) == 0);
+
+  assert(pthread_setparam_np(PTHREAD_PARAM_SPIN_BACKOFF_NP, 0) == EINVAL);
+  assert(pthread_setparam_np(PTHREAD_PARAM_SPIN_BACKOFF_NP, 1) == 0);
+  assert(pthread_spin_init(&spin, PTHREAD_PROCESS_PRIVATE) == 0);
+  for (i = 0; i < 10; i++)
+    {
+      assert(pthread_spin_lock(&spin) == 0);
+      assert(pthread_spin_unlock(&spin) == 0);
+    }
+  assert(pthread_spin_destroy(&spin) == 0);
+  assert(pthread_setparam_np(PTHREAD_PARAM_SPIN_BACKOFF_NP, 1024) == 0);
+
+  assert(pthread_setparam_np(PTHREAD_PARAM_THREAD_CACHE_NP, 4) == 0);
+  {
+    int max;
+
+    assert(pthread_getthreadcache_np(&max) == 0);
+    assert(max == 4);
+  }
+  assert(pthread_setparam_np(PTHREAD_PARAM_THREAD_CACHE_NP, -1) == EINVAL);
+  assert(pthread_setparam_np(PTHREAD_PARAM_THREAD_CACHE_NP, 0) == 0);
+
+  assert(pthread_getparam_np(PTHREAD_PARAM_THREAD_REUSE_NP, &saved) == 0);
+  assert(pthread_setparam_np(PTHREAD_PARAM_THREAD_REUSE_NP, 8) == 0);
+  assert(pthread_getparam_np(PTHREAD_PARAM_THREAD_REUSE_NP, &value) == 0);
+  assert(value == 8);
+  assert(pthread_setparam_np(PTHREAD_PARAM_THREAD_REUSE_NP, -2) == EINVAL);
+  assert(pthread_setparam_np(PTHREAD_PARAM_THREAD_REUSE_NP, saved) == 0);
+
+  assert(pthread_setparam_np(PTHREAD_PARAM_TIMER_SLACK_NP, 2000000) == 0);
+  assert(pthread_getparam_np(PTHREAD_PARAM_TIMER_SLACK_NP, &value) == 0);
+  assert(value == 2000000);
+  assert(pthread_setparam_np(PTHREAD_PARAM_TIMER_SLACK_NP, -1) == EINVAL);
+  assert(pthread_setparam_np(PTHREAD_PARAM_TIMER_SLACK_NP, 0) == 0);
+
+  assert(pthread_getparam_np(PTHREAD_PARAM_YIELD_MODE_NP, &saved) == 0);
+  assert(pthread_setparam_np(PTHREAD_PARAM_YIELD_MODE_NP, PTHREAD_YIELD_SLEEP_NP) == 0);
+  assert(pthread_getparam_np(PTHREAD_PARAM_YIELD_MODE_NP, &value) == 0);
+  assert(value == PTHREAD_YIELD_SLEEP_NP);
+  assert(pthread_setparam_np(PTHREAD_PARAM_YIELD_MODE_NP, saved) == 0);
+
+  assert(pthread_setparam_np(PTHREAD_PARAM_OBJECT_ALIGN_NP, 3) == EINVAL);
+  assert(pthread_setparam_np(PTHREAD_PARAM_OBJECT_ALIGN_NP, PTHREAD_OBJECT_ALIGN_CACHELINE_NP) == 0);
+  assert(pthread_getparam_np(PTHREAD_PARAM_OBJECT_ALIGN_NP, &value) == 0);
+  assert(value == PTHREAD_OBJECT_ALIGN_CACHELINE_NP);
+  assert(pthread_setparam_np(PTHREAD_PARAM_OBJECT_ALIGN_NP, PTHREAD_OBJECT_ALIGN_DEFAULT_NP) == 0);
+
+  assert(pthread_setparam_np(PTHREAD_PARAM_CONCURRENCY_NP, 2) == 0);
+  assert(pthread_getconcurrency() == 2);
+  assert(pthread_getparam_np(PTHREAD_PARAM_CONCURRENCY_NP, &value) == 0);
+  assert(value == 2);
+  assert(pthread_setparam_np(PTHREAD_PARAM_CONCURRENCY_NP, -1) == EINVAL);
+  assert(pthread_setparam_np(PTHREAD_PARAM_CONCURRENCY_NP, 0) == 0);
+
+  assert(pthread_getparam_np(PTHREAD_PARAM_HIRES_WAIT_NP, &value) == 0);
+  assert(value == 1);
+  assert(pthread_setparam_np(PTHREAD_PARAM_HIRES_WAIT_NP, 2) == EINVAL);
+  assert(pthread_setparam_np(PTHREAD_PARAM_HIRES_WAIT_NP, 0) == 0);
+  assert(pthread_getparam_np(PTHREAD_PARAM_HIRES_WAIT_NP, &value) == 0);
+  assert(value == 0);
+  {
+    /* Timed waits still time out in milliseconds */
+    struct timespec abstime;
+    sem_t sem;
+
+    assert(sem_init(&sem, 0, 0) == 0);
+    assert(clock_gettime(CLOCK_REALTIME, &abstime) == 0);
+    abstime.tv_nsec += 5000000;
+    if (abstime.tv_nsec >= 1000000000)
+      {
+        abstime.tv_sec++;
+        abstime.tv_nsec -= 1000000000;
+      }
+    assert(sem_timedwait(&sem, &abstime) == -1);
+    assert(errno == ETIMEDOUT);
+    assert(sem_destroy(&sem) == 0);
+  }
+  assert(pthread_setparam_np(PTHREAD_PARAM_HIRES_WAIT_NP, 1) == 0);
+
+  return 0;
+}
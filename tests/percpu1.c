@@ -0,0 +1,130 @@
+/* 
+ * percpu1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Per-CPU data and sched_getcpu(): slot layout, and counters updated
+ * by many threads through their current processor's slot.
+ *
+ * Depends on API functions:
+ *	pthread_percpu_create_np()
+ *	pthread_percpu_destroy_np()
+ *	pthread_percpu_this_np()
+ *	pthread_percpu_slot_np()
+ *	pthread_percpu_count_np()
+ *	pthread_num_processors_np()
+ *	sched_getcpu()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 16,
+  ITERATIONS = 10000
+};
+
+static pthread_percpu_np_t percpu;
+
+void *
+counter(void * arg)
+{
+  long * slot;
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_percpu_this_np(percpu, (void **) &slot) == 0);
+      InterlockedIncrement(slot);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  long * slot;
+  long * prev = NULL;
+  long total = 0;
+  int count;
+  int cpu;
+  int i;
+
+  cpu = sched_getcpu();
+  assert(cpu >= 0 || errno == ENOSYS);
+
+  assert(pthread_percpu_create_np(NULL, sizeof(long)) == EINVAL);
+  assert(pthread_percpu_create_np(&percpu, 0) == EINVAL);
+  assert(pthread_percpu_create_np(&percpu, sizeof(long)) == 0);
+
+  count = pthread_percpu_count_np(percpu);
+  assert(count >= 1);
+  assert(count >= pthread_num_processors_np());
+
+  /* Zeroed, each in cache lines of its own */
+  for (i = 0; i < count; i++)
+    {
+      assert(pthread_percpu_slot_np(percpu, i, (void **) &slot) == 0);
+      assert(((size_t) slot & 63) == 0);
+      assert(prev == NULL || (char *) slot - (char *) prev >= 64);
+      assert(*slot == 0);
+      prev = slot;
+    }
+  assert(pthread_percpu_slot_np(percpu, count, (void **) &slot) == EINVAL);
+  assert(pthread_percpu_slot_np(percpu, -1, (void **) &slot) == EINVAL);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, counter, NULL) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      assert(pthread_percpu_slot_np(percpu, i, (void **) &slot) == 0);
+      total += *slot;
+    }
+  assert(total == NUMTHREADS * ITERATIONS);
+
+  assert(pthread_percpu_destroy_np(&percpu) == 0);
+  assert(percpu == NULL);
+  assert(pthread_percpu_destroy_np(&percpu) == EINVAL);
+
+  return 0;
+}
@@ -0,0 +1,146 @@
+/* 
+ * phaser1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Phaser: parties step through phases together while others register
+ * and deregister, and a party that only arrives lets the phase
+ * advance without waiting.
+ *
+ * Depends on API functions:
+ *	pthread_phaser_init_np()
+ *	pthread_phaser_destroy_np()
+ *	pthread_phaser_register_np()
+ *	pthread_phaser_arrive_np()
+ *	pthread_phaser_arrive_and_deregister_np()
+ *	pthread_phaser_await_np()
+ *	pthread_phaser_arrive_and_await_np()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 6,
+  PHASES = 200
+};
+
+static pthread_phaser_np_t phaser;
+static volatile LONG step[PHASES + 1];
+static volatile LONG serial = 0;
+
+void *
+party(void * arg)
+{
+  unsigned int phase;
+  int i;
+  int result;
+
+  for (i = 0; i < PHASES; i++)
+    {
+      InterlockedIncrement((LPLONG) &step[i]);
+      result = pthread_phaser_arrive_and_await_np(phaser, &phase);
+      assert(result == 0 || result == PTHREAD_BARRIER_SERIAL_THREAD);
+      assert(phase == (unsigned int) i);
+      if (result == PTHREAD_BARRIER_SERIAL_THREAD)
+        {
+          InterlockedIncrement((LPLONG) &serial);
+        }
+
+      /* Everyone arrived at phase i before anyone left it */
+      assert(step[i] == NUMTHREADS);
+    }
+
+  assert(pthread_phaser_arrive_and_deregister_np(phaser, NULL) >= 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  unsigned int phase;
+  unsigned int next;
+  int i;
+
+  assert(pthread_phaser_init_np(NULL, 1) == EINVAL);
+  assert(pthread_phaser_init_np(&phaser, PTHREAD_PHASER_MAX_PARTIES_NP + 1) == EINVAL);
+
+  /* Arrive, then wait separately */
+  assert(pthread_phaser_init_np(&phaser, 2) == 0);
+  assert(pthread_phaser_arrive_np(phaser, &phase) == 0);
+  assert(phase == 0);
+  assert(pthread_phaser_arrive_np(phaser, &next) == PTHREAD_BARRIER_SERIAL_THREAD);
+  assert(next == 0);
+  assert(pthread_phaser_await_np(phaser, phase) == 0);
+  assert(pthread_phaser_register_np(phaser, PTHREAD_PHASER_MAX_PARTIES_NP, NULL) == EAGAIN);
+  assert(pthread_phaser_register_np(phaser, 1, &phase) == 0);
+  assert(phase == 1);
+  assert(pthread_phaser_arrive_and_deregister_np(phaser, NULL) == 0);
+  assert(pthread_phaser_arrive_and_deregister_np(phaser, NULL) == 0);
+  assert(pthread_phaser_arrive_and_deregister_np(phaser, NULL) == PTHREAD_BARRIER_SERIAL_THREAD);
+  assert(pthread_phaser_arrive_np(phaser, NULL) == EINVAL);
+  assert(pthread_phaser_destroy_np(&phaser) == 0);
+  assert(phaser == NULL);
+
+  /*
+   * Parties register as they start. Main holds the phaser at
+   * phase 0 until they all have, then leaves; its arrival may be
+   * the one that advances phase 0.
+   */
+  assert(pthread_phaser_init_np(&phaser, 1) == 0);
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_phaser_register_np(phaser, 1, &phase) == 0);
+      assert(phase == 0);
+      assert(pthread_create(&t[i], NULL, party, NULL) == 0);
+    }
+  if (pthread_phaser_arrive_and_deregister_np(phaser, NULL) == PTHREAD_BARRIER_SERIAL_THREAD)
+    {
+      InterlockedIncrement((LPLONG) &serial);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(serial == PHASES);
+
+  assert(pthread_phaser_destroy_np(&phaser) == 0);
+  assert(pthread_phaser_destroy_np(&phaser) == EINVAL);
+
+  return 0;
+}
@@ -0,0 +1,160 @@
+/* 
+ * pool1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Submit tasks to a thread pool from outside it, with and without
+ * handles, and wait for them singly and for the whole pool.
+ *
+ * Depends on API functions:
+ *	pthread_pool_create_np()
+ *	pthread_pool_submit_np()
+ *	pthread_pool_task_wait_np()
+ *	pthread_pool_wait_np()
+ *	pthread_pool_destroy_np()
+ *	pthread_setconcurrency()
+ */
+
+#include "test.h"
+
+enum {
+  NUMWORKERS = 4,
+  NUMTASKS = 1000
+};
+
+static LONG ran = 0;
+static pthread_key_t key;
+static LONG met = 0;
+
+void *
+square(void * arg)
+{
+  size_t n = (size_t) arg;
+
+  /* Tasks run on POSIX threads, so TSD works */
+  assert(pthread_setspecific(key, arg) == 0);
+  assert(pthread_getspecific(key) == arg);
+
+  InterlockedIncrement(&ran);
+
+  return (void *) (n * n);
+}
+
+void *
+slow(void * arg)
+{
+  Sleep(10);
+  InterlockedIncrement(&ran);
+
+  return NULL;
+}
+
+void *
+meet(void * arg)
+{
+  /* Only returns once every worker is running one of these */
+  InterlockedIncrement(&met);
+
+  while (InterlockedExchangeAdd(&met, 0L) < 3)
+    {
+      Sleep(1);
+    }
+
+  return arg;
+}
+
+int
+main()
+{
+  pthread_pool_np_t pool;
+  pthread_pool_task_np_t tasks[NUMTASKS];
+  pthread_pool_task_np_t t;
+  size_t i;
+
+  assert(pthread_key_create(&key, NULL) == 0);
+
+  assert(pthread_pool_create_np(NULL, NULL, NUMWORKERS) == EINVAL);
+  assert(pthread_pool_create_np(&pool, NULL, -1) == EINVAL);
+  assert(pthread_pool_create_np(&pool, NULL, NUMWORKERS) == 0);
+
+  assert(pthread_pool_submit_np(pool, NULL, NULL, &t) == EINVAL);
+
+  for (i = 0; i < NUMTASKS; i++)
+    {
+      assert(pthread_pool_submit_np(pool, square, (void *) i, &tasks[i]) == 0);
+    }
+
+  for (i = 0; i < NUMTASKS; i++)
+    {
+      void * result = NULL;
+
+      assert(pthread_pool_task_wait_np(tasks[i], &result) == 0);
+      assert((size_t) result == i * i);
+    }
+
+  assert(ran == NUMTASKS);
+
+  /* Fire and forget */
+  for (i = 0; i < 2 * NUMWORKERS; i++)
+    {
+      assert(pthread_pool_submit_np(pool, slow, NULL, NULL) == 0);
+    }
+
+  assert(pthread_pool_wait_np(pool) == 0);
+  assert(ran == NUMTASKS + 2 * NUMWORKERS);
+
+  /* Destroy drains the pool */
+  for (i = 0; i < 2 * NUMWORKERS; i++)
+    {
+      assert(pthread_pool_submit_np(pool, slow, NULL, NULL) == 0);
+    }
+
+  assert(pthread_pool_destroy_np(&pool) == 0);
+  assert(pool == NULL);
+  assert(ran == NUMTASKS + 4 * NUMWORKERS);
+
+  /* Zero workers means one per concurrency level */
+  assert(pthread_setconcurrency(3) == 0);
+  assert(pthread_pool_create_np(&pool, NULL, 0) == 0);
+
+  for (i = 0; i < 3; i++)
+    {
+      assert(pthread_pool_submit_np(pool, meet, NULL, NULL) == 0);
+    }
+
+  assert(pthread_pool_destroy_np(&pool) == 0);
+  assert(pthread_setconcurrency(0) == 0);
+
+  assert(pthread_key_delete(key) == 0);
+
+  return 0;
+}
@@ -0,0 +1,147 @@
+/* 
+ * pool2.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Divide and conquer in a thread pool: tasks submit tasks and wait
+ * for them, which only works if waiting workers run other tasks.
+ * Also a task that exits its worker, whose replacement keeps the
+ * pool going, and workers created with a CPU affinity.
+ *
+ * Depends on API functions:
+ *	pthread_pool_create_np()
+ *	pthread_pool_submit_np()
+ *	pthread_pool_task_wait_np()
+ *	pthread_pool_wait_np()
+ *	pthread_pool_destroy_np()
+ *	pthread_attr_setaffinity_np()
+ *	pthread_cleanup_push()
+ *	pthread_exit()
+ */
+
+#include "test.h"
+
+enum {
+  NUMWORKERS = 3
+};
+
+static pthread_pool_np_t pool;
+static LONG cleanedUp = 0;
+
+void *
+fib(void * arg)
+{
+  size_t n = (size_t) arg;
+  pthread_pool_task_np_t t1, t2;
+  void * r1;
+  void * r2;
+
+  if (n < 2)
+    {
+      return arg;
+    }
+
+  assert(pthread_pool_submit_np(pool, fib, (void *) (n - 1), &t1) == 0);
+  assert(pthread_pool_submit_np(pool, fib, (void *) (n - 2), &t2) == 0);
+  assert(pthread_pool_task_wait_np(t2, &r2) == 0);
+  assert(pthread_pool_task_wait_np(t1, &r1) == 0);
+
+  return (void *) ((size_t) r1 + (size_t) r2);
+}
+
+static void
+cleanup(void * arg)
+{
+  InterlockedIncrement(&cleanedUp);
+}
+
+void *
+quitter(void * arg)
+{
+  pthread_cleanup_push(cleanup, NULL);
+  pthread_exit(arg);
+  pthread_cleanup_pop(0);
+
+  return NULL;
+}
+
+void *
+wait_pool(void * arg)
+{
+  assert(pthread_pool_wait_np(pool) == EDEADLK);
+  assert(pthread_pool_destroy_np(&pool) == EDEADLK);
+
+  return arg;
+}
+
+int
+main()
+{
+  pthread_attr_t attr;
+  cpu_set_t cpus;
+  pthread_pool_task_np_t t;
+  void * result = NULL;
+  int i;
+
+  assert(pthread_attr_init(&attr) == 0);
+  CPU_ZERO(&cpus);
+  assert(sched_getaffinity(0, sizeof(cpus), &cpus) == 0);
+  assert(pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus) == 0);
+  assert(pthread_pool_create_np(&pool, &attr, NUMWORKERS) == 0);
+  assert(pthread_attr_destroy(&attr) == 0);
+
+  assert(pthread_pool_submit_np(pool, fib, (void *) 20, &t) == 0);
+  assert(pthread_pool_task_wait_np(t, &result) == 0);
+  assert((size_t) result == 6765);
+
+  /* Lose every worker in turn, and some of the replacements */
+  for (i = 0; i < 2 * NUMWORKERS; i++)
+    {
+      assert(pthread_pool_submit_np(pool, quitter, (void *) 1, &t) == 0);
+      assert(pthread_pool_task_wait_np(t, &result) == 0);
+      assert(result == PTHREAD_CANCELED);
+    }
+
+  assert(cleanedUp == 2 * NUMWORKERS);
+
+  assert(pthread_pool_submit_np(pool, fib, (void *) 15, &t) == 0);
+  assert(pthread_pool_task_wait_np(t, &result) == 0);
+  assert((size_t) result == 610);
+
+  assert(pthread_pool_submit_np(pool, wait_pool, (void *) 2, &t) == 0);
+  assert(pthread_pool_task_wait_np(t, &result) == 0);
+  assert((size_t) result == 2);
+
+  assert(pthread_pool_destroy_np(&pool) == 0);
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+/* 
+ * pool3.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Parallel loops on a thread pool: every iteration of a for loop runs
+ * exactly once whatever the grain, a reduction sums a range, and a
+ * loop run from a task in the pool completes.
+ *
+ * Depends on API functions:
+ *	pthread_pool_create_np()
+ *	pthread_pool_parallel_for_np()
+ *	pthread_pool_parallel_reduce_np()
+ *	pthread_pool_submit_np()
+ *	pthread_pool_task_wait_np()
+ *	pthread_pool_destroy_np()
+ */
+
+#include "test.h"
+
+enum {
+  NUMWORKERS = 3,
+  N = 10000
+};
+
+static pthread_pool_np_t pool;
+static LONG counts[N];
+
+static void
+mark(long begin, long end, void * arg)
+{
+  long i;
+
+  assert(arg == (void *) &counts);
+  assert(begin < end);
+
+  for (i = begin; i < end; i++)
+    {
+      (void) InterlockedIncrement(&counts[i]);
+    }
+}
+
+static void *
+sum(long begin, long end, void * value, void * arg)
+{
+  size_t total = (size_t) value;
+  long i;
+
+  for (i = begin; i < end; i++)
+    {
+      total += (size_t) i;
+    }
+
+  return (void *) total;
+}
+
+static void *
+add(void * a, void * b, void * arg)
+{
+  return (void *) ((size_t) a + (size_t) b);
+}
+
+static void *
+nested(void * arg)
+{
+  void * total = NULL;
+
+  assert(pthread_pool_parallel_reduce_np(pool, 0, N, 10, sum, add, NULL, NULL, &total) == 0);
+
+  return total;
+}
+
+static void
+check(long begin, long end)
+{
+  long i;
+
+  for (i = 0; i < N; i++)
+    {
+      assert(counts[i] == (i >= begin && i < end));
+      counts[i] = 0;
+    }
+}
+
+int
+main()
+{
+  static const long grains[] = {0, 1, 7, 100, N, 2 * N};
+  pthread_pool_task_np_t task;
+  void * total;
+  int i;
+
+  assert(pthread_pool_create_np(&pool, NULL, NUMWORKERS) == 0);
+
+  for (i = 0; i < (int) (sizeof(grains) / sizeof(grains[0])); i++)
+    {
+      assert(pthread_pool_parallel_for_np(pool, 0, N, grains[i], mark, (void *) &counts) == 0);
+      check(0, N);
+    }
+
+  assert(pthread_pool_parallel_for_np(pool, 17, 18, 0, mark, (void *) &counts) == 0);
+  check(17, 18);
+  assert(pthread_pool_parallel_for_np(pool, 5, 5, 0, mark, (void *) &counts) == 0);
+  check(0, 0);
+
+  total = NULL;
+  assert(pthread_pool_parallel_reduce_np(pool, 0, N, 0, sum, add, NULL, NULL, &total) == 0);
+  assert((size_t) total == (size_t) N * (N - 1) / 2);
+
+  total = (void *) &total;
+  assert(pthread_pool_parallel_reduce_np(pool, 3, 3, 0, sum, add, NULL, NULL, &total) == 0);
+  assert(total == NULL);
+
+  assert(pthread_pool_submit_np(pool, nested, NULL, &task) == 0);
+  assert(pthread_pool_task_wait_np(task, &total) == 0);
+  assert((size_t) total == (size_t) N * (N - 1) / 2);
+
+  assert(pthread_pool_parallel_for_np(NULL, 0, N, 0, mark, NULL) == EINVAL);
+  assert(pthread_pool_parallel_for_np(pool, 0, N, -1, mark, NULL) == EINVAL);
+  assert(pthread_pool_parallel_reduce_np(pool, 0, N, 0, sum, NULL, NULL, NULL, &total) == EINVAL);
+
+  assert(pthread_pool_destroy_np(&pool) == 0);
+
+  return 0;
+}
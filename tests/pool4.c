@@ -0,0 +1,109 @@
+/* 
+ * pool4.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * A pool starts a spare worker while all of its workers are blocked
+ * in the library: a task that waits on a semaphore posted by a later
+ * task of a single worker pool completes.
+ *
+ * Depends on API functions:
+ *	pthread_pool_create_np()
+ *	pthread_pool_submit_np()
+ *	pthread_pool_task_wait_np()
+ *	pthread_pool_destroy_np()
+ *	sem_init()
+ *	sem_wait()
+ *	sem_post()
+ */
+
+#include "test.h"
+
+enum {
+  ROUNDS = 5
+};
+
+static sem_t sem;
+static LONG started;
+
+static void *
+waiter(void * arg)
+{
+  (void) InterlockedExchange(&started, 1);
+  assert(sem_wait(&sem) == 0);
+
+  return arg;
+}
+
+static void *
+poster(void * arg)
+{
+  assert(sem_post(&sem) == 0);
+
+  return arg;
+}
+
+int
+main()
+{
+  pthread_pool_np_t pool;
+  pthread_pool_task_np_t w, p;
+  void * value;
+  int i;
+
+  assert(sem_init(&sem, 0, 0) == 0);
+  assert(pthread_pool_create_np(&pool, NULL, 1) == 0);
+
+  for (i = 0; i < ROUNDS; i++)
+    {
+      started = 0;
+      assert(pthread_pool_submit_np(pool, waiter, (void *) &sem, &w) == 0);
+
+      /* Only submit the poster once the only worker is taken */
+      while (InterlockedExchangeAdd(&started, 0) == 0)
+        {
+          Sleep(1);
+        }
+
+      assert(pthread_pool_submit_np(pool, poster, (void *) &started, &p) == 0);
+      assert(pthread_pool_task_wait_np(p, &value) == 0);
+      assert(value == (void *) &started);
+      assert(pthread_pool_task_wait_np(w, &value) == 0);
+      assert(value == (void *) &sem);
+    }
+
+  assert(pthread_pool_destroy_np(&pool) == 0);
+  assert(sem_destroy(&sem) == 0);
+
+  return 0;
+}
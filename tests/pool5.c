@@ -0,0 +1,182 @@
+/* 
+ * pool5.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Task keys (PTHREAD_KEY_TASK_NP) read NULL at the start of every
+ * pool task, and the destructors of the values a task set have run
+ * by the time it completes. Ordinary keys keep their values across
+ * tasks, and outside a pool a task key is an ordinary key.
+ *
+ * Depends on API functions:
+ *	pthread_key_create_np()
+ *	pthread_key_create()
+ *	pthread_setspecific()
+ *	pthread_getspecific()
+ *	pthread_pool_create_np()
+ *	pthread_pool_submit_np()
+ *	pthread_pool_task_wait_np()
+ *	pthread_pool_destroy_np()
+ */
+
+#include "test.h"
+
+enum {
+  NKEYS = 15,	/* With more destructors than the library lists per task */
+  ROUNDS = 10
+};
+
+static pthread_key_t task[NKEYS];
+static pthread_key_t plain;
+static pthread_key_t again;
+static LONG destroyed;
+static int values[NKEYS];
+
+static void
+destroy(void * value)
+{
+  (void) InterlockedIncrement(&destroyed);
+}
+
+static void
+destroySetting(void * value)
+{
+  (void) InterlockedIncrement(&destroyed);
+  if (value == (void *) &again)
+    {
+      /* Set for the ended task: destroyed in another round */
+      assert(pthread_setspecific(again, (void *) &destroyed) == 0);
+    }
+}
+
+static void *
+setter(void * arg)
+{
+  int n = (int) (size_t) arg;
+  int i;
+
+  for (i = 0; i < NKEYS; i++)
+    {
+      assert(pthread_getspecific(task[i]) == NULL);
+    }
+  assert(pthread_getspecific(again) == NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      assert(pthread_setspecific(task[i], &values[i]) == 0);
+      assert(pthread_setspecific(task[i], &values[i]) == 0);
+      assert(pthread_getspecific(task[i]) == &values[i]);
+    }
+
+  if (pthread_getspecific(plain) == NULL)
+    {
+      assert(pthread_setspecific(plain, (void *) &plain) == 0);
+    }
+  assert(pthread_getspecific(plain) == (void *) &plain);
+
+  return arg;
+}
+
+static void *
+setAgain(void * arg)
+{
+  assert(pthread_setspecific(again, (void *) &again) == 0);
+
+  return arg;
+}
+
+int
+main()
+{
+  pthread_pool_np_t pool;
+  pthread_pool_task_np_t t;
+  pthread_key_t k;
+  void * value;
+  int i;
+
+  assert(pthread_key_create_np(&k, NULL, 2) == EINVAL);
+  assert(pthread_key_create_np(&k, NULL, 0) == 0);
+  assert(pthread_key_delete(k) == 0);
+
+  for (i = 0; i < NKEYS; i++)
+    {
+      assert(pthread_key_create_np(&task[i], (i % 3) ? destroy : NULL,
+                                   PTHREAD_KEY_TASK_NP) == 0);
+    }
+  assert(pthread_key_create_np(&again, destroySetting, PTHREAD_KEY_TASK_NP) == 0);
+  assert(pthread_key_create(&plain, NULL) == 0);
+
+  /* Outside a pool */
+  assert(pthread_setspecific(task[0], &values[0]) == 0);
+  assert(pthread_getspecific(task[0]) == &values[0]);
+  assert(pthread_setspecific(task[0], NULL) == 0);
+
+  assert(pthread_pool_create_np(&pool, NULL, 1) == 0);
+
+  for (i = 0; i < ROUNDS; i++)
+    {
+      int n = (i % 2) ? NKEYS : 3;
+      int j;
+      LONG expected = 0;
+
+      for (j = 0; j < n; j++)
+        {
+          expected += (j % 3) ? 1 : 0;
+        }
+
+      destroyed = 0;
+      assert(pthread_pool_submit_np(pool, setter, (void *) (size_t) n, &t) == 0);
+      assert(pthread_pool_task_wait_np(t, &value) == 0);
+      assert(value == (void *) (size_t) n);
+      assert(InterlockedExchangeAdd(&destroyed, 0) == expected);
+    }
+
+  destroyed = 0;
+  assert(pthread_pool_submit_np(pool, setAgain, NULL, &t) == 0);
+  assert(pthread_pool_task_wait_np(t, NULL) == 0);
+  assert(InterlockedExchangeAdd(&destroyed, 0) == 2);
+
+  assert(pthread_pool_submit_np(pool, setter, (void *) 0, &t) == 0);
+  assert(pthread_pool_task_wait_np(t, NULL) == 0);
+
+  assert(pthread_pool_destroy_np(&pool) == 0);
+
+  for (i = 0; i < NKEYS; i++)
+    {
+      assert(pthread_key_delete(task[i]) == 0);
+    }
+  assert(pthread_key_delete(again) == 0);
+  assert(pthread_key_delete(plain) == 0);
+
+  return 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * File: pooled1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Confirm that detached threads created with
+ *   pthread_attr_setpooled_np run and end as POSIX threads.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_attr_setpooled_np, pthread_attr_getpooled_np
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - the attribute defaults to 0 and reads back as set.
+ * - every pooled thread runs once, with its own pthread_t.
+ * - TSD values start NULL on each thread and destructors run.
+ * - pthread_exit and cancellation end pooled threads.
+ * - a joinable thread with the attribute can be joined.
+ *
+ * Description:
+ * -
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - Without the system thread pool the threads get OS threads of
+ *   their own, so the test passes as well.
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+	NUMTHREADS = 200
+};
+
+static pthread_key_t key;
+static sem_t done;
+static LONG started = 0;
+static LONG destroyed = 0;
+
+static void
+destroy(void * value)
+{
+  assert(value != NULL);
+  InterlockedIncrement(&destroyed);
+}
+
+void * func(void * arg)
+{
+  pthread_t self = pthread_self();
+
+  assert(pthread_getspecific(key) == NULL);
+  assert(pthread_setspecific(key, &self) == 0);
+  InterlockedIncrement(&started);
+
+  switch ((int)(size_t) arg % 3)
+    {
+    case 1:
+      assert(sem_post(&done) == 0);
+      pthread_exit(NULL);
+      break;
+    case 2:
+      assert(sem_post(&done) == 0);
+      assert(pthread_cancel(self) == 0);
+      pthread_testcancel();
+      assert(0);
+      break;
+    }
+
+  assert(sem_post(&done) == 0);
+  return arg;
+}
+
+int
+main()
+{
+  pthread_t t;
+  pthread_attr_t attr;
+  void * result = NULL;
+  int pooled = -1;
+  int i;
+
+  assert(pthread_key_create(&key, destroy) == 0);
+  assert(sem_init(&done, 0, 0) == 0);
+
+  assert(pthread_attr_init(&attr) == 0);
+  assert(pthread_attr_getpooled_np(&attr, &pooled) == 0);
+  assert(pooled == 0);
+  assert(pthread_attr_setpooled_np(&attr, 2) == 0);
+  assert(pthread_attr_getpooled_np(&attr, &pooled) == 0);
+  assert(pooled == 1);
+  assert(pthread_attr_getpooled_np(&attr, NULL) == EINVAL);
+
+  /*
+   * Joinable threads aren't pooled.
+   */
+  assert(pthread_create(&t, &attr, func, (void *)(size_t) 3) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert((int)(size_t) result == 3);
+  assert(sem_wait(&done) == 0);
+
+  assert(pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t, &attr, func, (void *)(size_t) i) == 0);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(sem_wait(&done) == 0);
+    }
+
+  assert(started == NUMTHREADS + 1);
+
+  /* The last destructors may still be running */
+  for (i = 0; i < 100 && destroyed < NUMTHREADS + 1; i++)
+    {
+      Sleep(10);
+    }
+  assert(destroyed == NUMTHREADS + 1);
+
+  assert(pthread_attr_destroy(&attr) == 0);
+  assert(sem_destroy(&done) == 0);
+  assert(pthread_key_delete(key) == 0);
+
+  return 0;
+}
@@ -0,0 +1,190 @@
+/* 
+ * prio1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Priority protocol mutexes: attribute handling, the owner of a
+ * PTHREAD_PRIO_PROTECT mutex running at the ceiling, and the owner of
+ * a PTHREAD_PRIO_INHERIT mutex running at the priority of a higher
+ * priority thread blocked on it, until it unlocks.
+ *
+ * Depends on API functions:
+ *	pthread_mutexattr_setprotocol()
+ *	pthread_mutexattr_getprotocol()
+ *	pthread_mutexattr_setprioceiling()
+ *	pthread_mutexattr_getprioceiling()
+ *	pthread_mutex_setprioceiling()
+ *	pthread_mutex_getprioceiling()
+ *	pthread_mutex_init()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_unlock()
+ *	pthread_mutex_destroy()
+ *	pthread_attr_setinheritsched()
+ *	pthread_attr_setschedparam()
+ *	pthread_getschedparam()
+ *	pthread_setschedparam()
+ *	pthread_getw32threadhandle_np()
+ */
+
+#include "test.h"
+
+static pthread_mutex_t mutex;
+static volatile long locked = 0;
+static volatile long release = 0;
+static int afterUnlock;
+
+void *
+owner(void * arg)
+{
+  HANDLE self = pthread_getw32threadhandle_np(pthread_self());
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  InterlockedExchange((long *) &locked, 1);
+  while (release == 0)
+    {
+      Sleep(1);
+    }
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  afterUnlock = GetThreadPriority(self);
+
+  return NULL;
+}
+
+void *
+waiter(void * arg)
+{
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  return NULL;
+}
+
+static pthread_t
+create(void * (*routine)(void *), int priority)
+{
+  pthread_attr_t attr;
+  struct sched_param param;
+  pthread_t t;
+
+  param.sched_priority = priority;
+  assert(pthread_attr_init(&attr) == 0);
+  assert(pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED) == 0);
+  assert(pthread_attr_setschedparam(&attr, &param) == 0);
+  assert(pthread_create(&t, &attr, routine, NULL) == 0);
+  assert(pthread_attr_destroy(&attr) == 0);
+
+  return t;
+}
+
+int
+main()
+{
+  pthread_mutexattr_t ma;
+  pthread_t o;
+  pthread_t w;
+  HANDLE self = pthread_getw32threadhandle_np(pthread_self());
+  HANDLE ownerH;
+  struct sched_param param;
+  int policy;
+  int value;
+  int i;
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_getprotocol(&ma, &value) == 0);
+  assert(value == PTHREAD_PRIO_NONE);
+  assert(pthread_mutexattr_getprioceiling(&ma, &value) == 0);
+  assert(value == sched_get_priority_max(SCHED_FIFO));
+  assert(pthread_mutexattr_setprotocol(&ma, 3) == EINVAL);
+  assert(pthread_mutexattr_setprioceiling(&ma, sched_get_priority_max(SCHED_FIFO) + 1) == EINVAL);
+
+  /* Robust mutexes can't have a protocol */
+  assert(pthread_mutexattr_setprotocol(&ma, PTHREAD_PRIO_INHERIT) == 0);
+  assert(pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_ROBUST) == 0);
+  assert(pthread_mutex_init(&mutex, &ma) == ENOSYS);
+  assert(pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_STALLED) == 0);
+
+  /* The owner of a priority ceiling mutex runs at the ceiling */
+  assert(pthread_mutexattr_setprotocol(&ma, PTHREAD_PRIO_PROTECT) == 0);
+  assert(pthread_mutexattr_setprioceiling(&ma, THREAD_PRIORITY_HIGHEST) == 0);
+  assert(pthread_mutex_init(&mutex, &ma) == 0);
+  assert(pthread_mutex_getprioceiling(&mutex, &value) == 0);
+  assert(value == THREAD_PRIORITY_HIGHEST);
+  assert(GetThreadPriority(self) == THREAD_PRIORITY_NORMAL);
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(GetThreadPriority(self) == THREAD_PRIORITY_HIGHEST);
+  assert(pthread_getschedparam(pthread_self(), &policy, &param) == 0);
+  assert(param.sched_priority == THREAD_PRIORITY_NORMAL);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(GetThreadPriority(self) == THREAD_PRIORITY_NORMAL);
+
+  /* A thread above the ceiling may not lock it */
+  assert(pthread_mutex_setprioceiling(&mutex, THREAD_PRIORITY_ABOVE_NORMAL, &value) == 0);
+  assert(value == THREAD_PRIORITY_HIGHEST);
+  param.sched_priority = THREAD_PRIORITY_HIGHEST;
+  assert(pthread_setschedparam(pthread_self(), SCHED_OTHER, &param) == 0);
+  assert(pthread_mutex_lock(&mutex) == EINVAL);
+  param.sched_priority = THREAD_PRIORITY_NORMAL;
+  assert(pthread_setschedparam(pthread_self(), SCHED_OTHER, &param) == 0);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  /* The owner of an inheritance mutex runs at its waiter's priority */
+  assert(pthread_mutexattr_setprotocol(&ma, PTHREAD_PRIO_INHERIT) == 0);
+  assert(pthread_mutex_getprioceiling(&mutex, &value) == EINVAL);
+  assert(pthread_mutex_init(&mutex, &ma) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  o = create(owner, THREAD_PRIORITY_LOWEST);
+  ownerH = pthread_getw32threadhandle_np(o);
+  while (locked == 0)
+    {
+      Sleep(1);
+    }
+  assert(GetThreadPriority(ownerH) == THREAD_PRIORITY_LOWEST);
+
+  w = create(waiter, THREAD_PRIORITY_HIGHEST);
+  for (i = 0; i < 2000 && GetThreadPriority(ownerH) != THREAD_PRIORITY_HIGHEST; i++)
+    {
+      Sleep(1);
+    }
+  assert(GetThreadPriority(ownerH) == THREAD_PRIORITY_HIGHEST);
+  assert(pthread_getschedparam(o, &policy, &param) == 0);
+  assert(param.sched_priority == THREAD_PRIORITY_LOWEST);
+
+  InterlockedExchange((long *) &release, 1);
+  assert(pthread_join(w, NULL) == 0);
+  assert(pthread_join(o, NULL) == 0);
+  assert(afterUnlock == THREAD_PRIORITY_LOWEST);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  return 0;
+}
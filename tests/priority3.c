@@ -0,0 +1,144 @@
+/* 
+ * priority3.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Real-time scheduling: the SCHED_FIFO and SCHED_RR priority range,
+ * the process policy, and threads created with and switched to a
+ * real-time policy.
+ *
+ * Depends on API functions:
+ *	sched_get_priority_min()
+ *	sched_get_priority_max()
+ *	sched_setscheduler()
+ *	sched_getscheduler()
+ *	pthread_attr_setschedpolicy()
+ *	pthread_attr_getschedpolicy()
+ *	pthread_attr_setschedparam()
+ *	pthread_attr_setinheritsched()
+ *	pthread_getschedparam()
+ *	pthread_setschedparam()
+ *	pthread_getw32threadhandle_np()
+ */
+
+#include "test.h"
+
+static int realtime = 0;
+
+void *
+func(void * arg)
+{
+  HANDLE self = pthread_getw32threadhandle_np(pthread_self());
+  struct sched_param param;
+  int policy;
+
+  assert(pthread_getschedparam(pthread_self(), &policy, &param) == 0);
+  assert(policy == SCHED_FIFO);
+  assert(param.sched_priority == sched_get_priority_min(SCHED_FIFO) + 8);
+  if (realtime)
+    {
+      assert(GetThreadPriority(self) == THREAD_PRIORITY_NORMAL);
+    }
+  else
+    {
+      assert(GetThreadPriority(self) == THREAD_PRIORITY_TIME_CRITICAL);
+    }
+
+  param.sched_priority = sched_get_priority_max(SCHED_RR);
+  assert(pthread_setschedparam(pthread_self(), SCHED_RR, &param) == 0);
+  assert(pthread_getschedparam(pthread_self(), &policy, &param) == 0);
+  assert(policy == SCHED_RR);
+  assert(param.sched_priority == sched_get_priority_max(SCHED_RR));
+  assert(GetThreadPriority(self) == THREAD_PRIORITY_TIME_CRITICAL);
+
+  param.sched_priority = THREAD_PRIORITY_NORMAL;
+  assert(pthread_setschedparam(pthread_self(), SCHED_RR, &param) == EINVAL);
+  assert(pthread_setschedparam(pthread_self(), SCHED_OTHER, &param) == 0);
+  assert(pthread_getschedparam(pthread_self(), &policy, &param) == 0);
+  assert(policy == SCHED_OTHER);
+  assert(GetThreadPriority(self) == THREAD_PRIORITY_NORMAL);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_attr_t attr;
+  struct sched_param param;
+  pthread_t t;
+  int policy;
+  int result;
+
+  assert(sched_get_priority_min(SCHED_FIFO) > sched_get_priority_max(SCHED_OTHER));
+  assert(sched_get_priority_max(SCHED_FIFO) > sched_get_priority_min(SCHED_FIFO));
+  assert(sched_get_priority_min(SCHED_RR) == sched_get_priority_min(SCHED_FIFO));
+  assert(sched_get_priority_max(SCHED_RR) == sched_get_priority_max(SCHED_FIFO));
+
+  /* The process needs the privilege to raise its base priority */
+  assert(sched_getscheduler(0) == SCHED_OTHER);
+  result = sched_setscheduler(0, SCHED_FIFO);
+  if (result == -1)
+    {
+      assert(errno == EPERM);
+      assert(sched_getscheduler(0) == SCHED_OTHER);
+    }
+  else
+    {
+      assert(result == SCHED_OTHER);
+      assert(sched_getscheduler(0) == SCHED_FIFO);
+      realtime = 1;
+    }
+
+  assert(pthread_attr_init(&attr) == 0);
+  assert(pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED) == 0);
+  assert(pthread_attr_setschedpolicy(&attr, SCHED_MAX + 1) == EINVAL);
+  assert(pthread_attr_setschedpolicy(&attr, SCHED_FIFO) == 0);
+  assert(pthread_attr_getschedpolicy(&attr, &policy) == 0);
+  assert(policy == SCHED_FIFO);
+  param.sched_priority = THREAD_PRIORITY_NORMAL;
+  assert(pthread_attr_setschedparam(&attr, &param) == EINVAL);
+  param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 8;
+  assert(pthread_attr_setschedparam(&attr, &param) == 0);
+  assert(pthread_create(&t, &attr, func, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(pthread_attr_destroy(&attr) == 0);
+
+  if (realtime)
+    {
+      assert(sched_setscheduler(0, SCHED_OTHER) == SCHED_FIFO);
+      assert(sched_getscheduler(0) == SCHED_OTHER);
+    }
+
+  return 0;
+}
@@ -0,0 +1,238 @@
+/* 
+ * priority4.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Priority ordered wakeups: PTHREAD_MUTEX_PRIORITY_NP mutexes,
+ * PTHREAD_COND_WAKE_PRIORITY_NP condition variables and
+ * SEM_PRIORITY_NP semaphores serve their waiters highest priority
+ * first, and in arrival order within a priority.
+ *
+ * Depends on API functions:
+ *	pthread_mutexattr_setfairness_np()
+ *	pthread_condattr_setwakeorder_np()
+ *	pthread_condattr_getwakeorder_np()
+ *	sem_init_np()
+ *	pthread_mutex_init()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_unlock()
+ *	pthread_cond_init()
+ *	pthread_cond_wait()
+ *	pthread_cond_signal()
+ *	sem_wait()
+ *	sem_post()
+ *	pthread_attr_setinheritsched()
+ *	pthread_attr_setschedparam()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 5
+};
+
+enum {
+  MUTEX,
+  COND,
+  SEM
+};
+
+static const int priority[NUMTHREADS] = {
+  THREAD_PRIORITY_LOWEST,
+  THREAD_PRIORITY_HIGHEST,
+  THREAD_PRIORITY_NORMAL,
+  THREAD_PRIORITY_HIGHEST,
+  THREAD_PRIORITY_BELOW_NORMAL
+};
+
+/* Highest first, then in arrival order */
+static const int expected[NUMTHREADS] = { 1, 3, 2, 4, 0 };
+
+static int kind;
+static pthread_mutex_t mutex;
+static pthread_cond_t cond;
+static sem_t sem;
+static volatile long started = 0;
+static volatile long position = 0;
+static int order[NUMTHREADS];
+static int signalled = 0;
+
+void *
+waiter(void * arg)
+{
+  InterlockedIncrement((long *) &started);
+
+  switch (kind)
+    {
+    case MUTEX:
+      assert(pthread_mutex_lock(&mutex) == 0);
+      order[position++] = (int)(size_t) arg;
+      assert(pthread_mutex_unlock(&mutex) == 0);
+      break;
+    case COND:
+      assert(pthread_mutex_lock(&mutex) == 0);
+      while (signalled == 0)
+        {
+          assert(pthread_cond_wait(&cond, &mutex) == 0);
+        }
+      signalled--;
+      order[position++] = (int)(size_t) arg;
+      assert(pthread_mutex_unlock(&mutex) == 0);
+      break;
+    case SEM:
+      assert(sem_wait(&sem) == 0);
+      order[InterlockedIncrement((long *) &position) - 1] = (int)(size_t) arg;
+      break;
+    }
+
+  return NULL;
+}
+
+static void
+run(int k)
+{
+  pthread_attr_t attr;
+  struct sched_param param;
+  pthread_t t[NUMTHREADS];
+  int i;
+
+  kind = k;
+  started = 0;
+  position = 0;
+
+  if (kind == MUTEX)
+    {
+      assert(pthread_mutex_lock(&mutex) == 0);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      param.sched_priority = priority[i];
+      assert(pthread_attr_init(&attr) == 0);
+      assert(pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED) == 0);
+      assert(pthread_attr_setschedparam(&attr, &param) == 0);
+      assert(pthread_create(&t[i], &attr, waiter, (void *)(size_t) i) == 0);
+      assert(pthread_attr_destroy(&attr) == 0);
+      while (started < i + 1)
+        {
+          Sleep(1);
+        }
+      /* Let it get into the queue */
+      Sleep(20);
+    }
+
+  /* Release one waiter at a time */
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      switch (kind)
+        {
+        case MUTEX:
+          /* Each unlock hands the mutex to the next */
+          if (i == 0)
+            {
+              assert(pthread_mutex_unlock(&mutex) == 0);
+            }
+          break;
+        case COND:
+          assert(pthread_mutex_lock(&mutex) == 0);
+          signalled++;
+          assert(pthread_cond_signal(&cond) == 0);
+          assert(pthread_mutex_unlock(&mutex) == 0);
+          while (position < i + 1)
+            {
+              Sleep(1);
+            }
+          break;
+        case SEM:
+          assert(sem_post(&sem) == 0);
+          while (position < i + 1)
+            {
+              Sleep(1);
+            }
+          break;
+        }
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(order[i] == expected[i]);
+    }
+}
+
+int
+main()
+{
+  pthread_mutexattr_t ma;
+  pthread_condattr_t ca;
+  int value;
+
+  assert(pthread_condattr_init(&ca) == 0);
+  assert(pthread_condattr_getwakeorder_np(&ca, &value) == 0);
+  assert(value == PTHREAD_COND_WAKE_ANY_NP);
+  assert(pthread_condattr_setwakeorder_np(&ca, 2) == EINVAL);
+  assert(pthread_condattr_setwakeorder_np(&ca, PTHREAD_COND_WAKE_PRIORITY_NP) == 0);
+  assert(pthread_condattr_getwakeorder_np(&ca, &value) == 0);
+  assert(value == PTHREAD_COND_WAKE_PRIORITY_NP);
+
+  /* Process shared condition variables can't order their waiters */
+  assert(pthread_condattr_setpshared(&ca, PTHREAD_PROCESS_SHARED) == 0);
+  assert(pthread_cond_init(&cond, &ca) == ENOSYS);
+  assert(pthread_condattr_setpshared(&ca, PTHREAD_PROCESS_PRIVATE) == 0);
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_setfairness_np(&ma, PTHREAD_MUTEX_PRIORITY_NP) == 0);
+  assert(pthread_mutex_init(&mutex, &ma) == 0);
+  run(MUTEX);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  assert(pthread_mutex_init(&mutex, NULL) == 0);
+  assert(pthread_cond_init(&cond, &ca) == 0);
+  run(COND);
+  assert(pthread_cond_destroy(&cond) == 0);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+  assert(pthread_condattr_destroy(&ca) == 0);
+
+  assert(sem_init_np(&sem, 0, 0, SEM_PRIORITY_NP) == 0);
+  run(SEM);
+  assert(sem_destroy(&sem) == 0);
+
+  return 0;
+}
@@ -0,0 +1,268 @@
+/*
+ * File: pshared1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Test process shared mutexes and condition variables.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_mutex_init, pthread_cond_init with PTHREAD_PROCESS_SHARED
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - a copy of the objects works as the originals do, as it would at
+ *   another address in another process.
+ * - mutual exclusion, errorcheck and recursive kinds, try and timed
+ *   locks.
+ * - signal, broadcast and timed waits.
+ * - robust process shared mutexes and process shared spin locks are
+ *   not supported.
+ *
+ * Description:
+ * - The objects are initialised in one buffer and used from both it
+ *   and a byte for byte copy of it.
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * -
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+#include <sys/timeb.h>
+#include <string.h>
+
+enum {
+	NUMTHREADS = 4,
+	ITERATIONS = 10000
+};
+
+typedef struct {
+  pthread_mutex_t mx;
+  pthread_cond_t cv;
+  int count;
+  int waiting;
+  int go;
+} shared_t;
+
+static shared_t view1;
+static shared_t view2;
+
+/*
+ * Each view is used through its own pointer, as each process would.
+ */
+static shared_t * views[2] = { &view1, &view2 };
+
+void * increment(void * arg)
+{
+  shared_t * s = views[(int)(size_t) arg & 1];
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_mutex_lock(&s->mx) == 0);
+      view1.count++;
+      assert(pthread_mutex_unlock(&s->mx) == 0);
+    }
+
+  return NULL;
+}
+
+void * waiter(void * arg)
+{
+  shared_t * s = views[(int)(size_t) arg & 1];
+
+  assert(pthread_mutex_lock(&s->mx) == 0);
+  view1.waiting++;
+  while (!view1.go)
+    {
+      assert(pthread_cond_wait(&s->cv, &s->mx) == 0);
+    }
+  view1.waiting--;
+  assert(pthread_mutex_unlock(&s->mx) == 0);
+
+  return NULL;
+}
+
+void * locker(void * arg)
+{
+  shared_t * s = views[(int)(size_t) arg & 1];
+
+  assert(pthread_mutex_trylock(&s->mx) == EBUSY);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  pthread_mutexattr_t ma;
+  pthread_condattr_t ca;
+  pthread_mutex_t mx;
+  pthread_spinlock_t spin;
+  struct timespec abstime = { 0, 0 };
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+  int i;
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_setpshared(&ma, PTHREAD_PROCESS_SHARED) == 0);
+  assert(pthread_condattr_init(&ca) == 0);
+  assert(pthread_condattr_setpshared(&ca, PTHREAD_PROCESS_SHARED) == 0);
+
+  assert(pthread_mutex_init(&view1.mx, &ma) == 0);
+  assert(pthread_cond_init(&view1.cv, &ca) == 0);
+  memcpy(&view2, &view1, sizeof(view1));
+
+  /*
+   * Mutual exclusion through both views.
+   */
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, increment, (void *)(size_t) i) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  assert(view1.count == NUMTHREADS * ITERATIONS);
+
+  /*
+   * Signal, then broadcast, to waiters on both views.
+   */
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, waiter, (void *)(size_t) i) == 0);
+    }
+  do
+    {
+      Sleep(10);
+      assert(pthread_mutex_lock(&view2.mx) == 0);
+      i = view1.waiting;
+      assert(pthread_mutex_unlock(&view2.mx) == 0);
+    }
+  while (i < NUMTHREADS);
+  assert(pthread_cond_destroy(&view1.cv) == EBUSY);
+
+  assert(pthread_cond_signal(&view2.cv) == 0);
+  Sleep(50);
+  assert(pthread_mutex_lock(&view1.mx) == 0);
+  assert(view1.waiting == NUMTHREADS);
+  view1.go = 1;
+  assert(pthread_cond_broadcast(&view1.cv) == 0);
+  assert(pthread_mutex_unlock(&view1.mx) == 0);
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  assert(view1.waiting == 0);
+
+  /*
+   * Timed waits and locks.
+   */
+  PTW32_FTIME(&currSysTime);
+  abstime.tv_sec = (long)currSysTime.time;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+  abstime.tv_nsec += 100 * NANOSEC_PER_MILLISEC;
+  if (abstime.tv_nsec >= 1000000000)
+    {
+      abstime.tv_sec++;
+      abstime.tv_nsec -= 1000000000;
+    }
+
+  assert(pthread_mutex_lock(&view1.mx) == 0);
+  assert(pthread_cond_timedwait(&view2.cv, &view1.mx, &abstime) == ETIMEDOUT);
+  assert(pthread_create(&t[0], NULL, locker, (void *)(size_t) 1) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(pthread_mutex_unlock(&view1.mx) == 0);
+
+  assert(pthread_mutex_destroy(&view2.mx) == 0);
+  assert(pthread_cond_destroy(&view2.cv) == 0);
+  assert(pthread_mutex_lock(&view1.mx) == EINVAL);
+
+  /*
+   * Errorcheck and recursive kinds.
+   */
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_ERRORCHECK) == 0);
+  assert(pthread_mutex_init(&mx, &ma) == 0);
+  assert(pthread_mutex_unlock(&mx) == EPERM);
+  assert(pthread_mutex_lock(&mx) == 0);
+  assert(pthread_mutex_lock(&mx) == EDEADLK);
+  assert(pthread_mutex_timedlock(&mx, &abstime) == EDEADLK);
+  assert(pthread_mutex_destroy(&mx) == EBUSY);
+  assert(pthread_mutex_unlock(&mx) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_RECURSIVE) == 0);
+  assert(pthread_mutex_init(&mx, &ma) == 0);
+  assert(pthread_mutex_lock(&mx) == 0);
+  assert(pthread_mutex_trylock(&mx) == 0);
+  assert(pthread_mutex_unlock(&mx) == 0);
+  assert(pthread_mutex_unlock(&mx) == 0);
+  assert(pthread_mutex_unlock(&mx) == EPERM);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  assert(pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_ROBUST) == 0);
+  assert(pthread_mutex_init(&mx, &ma) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  assert(pthread_spin_init(&spin, PTHREAD_PROCESS_SHARED) == ENOSYS);
+
+  assert(pthread_condattr_destroy(&ca) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  return 0;
+}
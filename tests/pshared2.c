@@ -0,0 +1,214 @@
+/*
+ * File: pshared2.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Test process shared semaphores and barriers.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - sem_init with pshared nonzero, pthread_barrier_init with
+ *   PTHREAD_PROCESS_SHARED
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - a copy of the objects works as the originals do, as it would at
+ *   another address in another process.
+ * - post, wait, trywait, timedwait, getvalue and post_multiple.
+ * - repeated barrier cycles with one serial thread each.
+ *
+ * Description:
+ * - The objects are initialised in one buffer and used from both it
+ *   and a byte for byte copy of it.
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * -
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+#include <sys/timeb.h>
+#include <string.h>
+
+enum {
+	NUMTHREADS = 4,
+	CYCLES = 100
+};
+
+typedef struct {
+  sem_t sem;
+  pthread_barrier_t barrier;
+} shared_t;
+
+static shared_t view1;
+static shared_t view2;
+
+/*
+ * Each view is used through its own pointer, as each process would.
+ */
+static shared_t * views[2] = { &view1, &view2 };
+
+static LONG serial = 0;
+
+void * poster(void * arg)
+{
+  shared_t * s = views[(int)(size_t) arg & 1];
+  int i;
+
+  for (i = 0; i < CYCLES; i++)
+    {
+      assert(sem_post(&s->sem) == 0);
+    }
+
+  return NULL;
+}
+
+void * crosser(void * arg)
+{
+  shared_t * s = views[(int)(size_t) arg & 1];
+  int i;
+  int result;
+
+  for (i = 0; i < CYCLES; i++)
+    {
+      result = pthread_barrier_wait(&s->barrier);
+      assert(result == 0 || result == PTHREAD_BARRIER_SERIAL_THREAD);
+      if (result == PTHREAD_BARRIER_SERIAL_THREAD)
+        {
+          InterlockedIncrement(&serial);
+        }
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  pthread_barrierattr_t ba;
+  struct timespec abstime = { 0, 0 };
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+  int value;
+  int i;
+
+  assert(sem_init(&view1.sem, 1, 0) == 0);
+  assert(pthread_barrierattr_init(&ba) == 0);
+  assert(pthread_barrierattr_setpshared(&ba, PTHREAD_PROCESS_SHARED) == 0);
+  assert(pthread_barrier_init(&view1.barrier, &ba, NUMTHREADS) == 0);
+  memcpy(&view2, &view1, sizeof(view1));
+
+  /*
+   * Posts through one view are seen through the other.
+   */
+  assert(sem_trywait(&view2.sem) == -1);
+  assert(errno == EAGAIN);
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, poster, (void *)(size_t) i) == 0);
+    }
+  for (i = 0; i < NUMTHREADS * CYCLES; i++)
+    {
+      assert(sem_wait(&views[i & 1]->sem) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  assert(sem_getvalue(&view2.sem, &value) == 0);
+  assert(value == 0);
+
+  assert(sem_post_multiple(&view1.sem, 3) == 0);
+  assert(sem_getvalue(&view2.sem, &value) == 0);
+  assert(value == 3);
+  assert(sem_wait_multiple_np(&view2.sem, 5) == 3);
+
+  PTW32_FTIME(&currSysTime);
+  abstime.tv_sec = (long)currSysTime.time;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+  abstime.tv_nsec += 100 * NANOSEC_PER_MILLISEC;
+  if (abstime.tv_nsec >= 1000000000)
+    {
+      abstime.tv_sec++;
+      abstime.tv_nsec -= 1000000000;
+    }
+  assert(sem_timedwait(&view1.sem, &abstime) == -1);
+  assert(errno == ETIMEDOUT);
+  assert(sem_getvalue(&view1.sem, &value) == 0);
+  assert(value == 0);
+
+  /*
+   * Barrier cycles through both views.
+   */
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, crosser, (void *)(size_t) i) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  assert(serial == CYCLES);
+
+  assert(sem_destroy(&view2.sem) == 0);
+  assert(sem_post(&view1.sem) == -1);
+  assert(errno == EINVAL);
+  assert(pthread_barrier_destroy(&view2.barrier) == 0);
+  assert(pthread_barrier_wait(&view1.barrier) == EINVAL);
+  assert(pthread_barrierattr_destroy(&ba) == 0);
+
+  return 0;
+}
@@ -0,0 +1,178 @@
+/* 
+ * pshared3.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Test that robust process shared mutexes detect a dead owner.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_mutex_lock, pthread_mutex_trylock and
+ *   pthread_mutex_consistent on PTHREAD_PROCESS_SHARED,
+ *   PTHREAD_MUTEX_ROBUST mutexes.
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - a waiter blocked on a mutex whose owner ends takes it over with
+ *   EOWNERDEAD, and can make it consistent.
+ * - trylock takes over from an ended owner.
+ * - unlocking without making it consistent leaves it unrecoverable.
+ * - a live owner is never taken over.
+ *
+ * Description:
+ * - The owners are plain Win32 threads, which end as a process would
+ *   without running any library code. The library must see for itself
+ *   that they have gone.
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * -
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+static pthread_mutex_t mx;
+static HANDLE locked;
+static HANDLE release;
+
+static DWORD WINAPI
+diesHolding(LPVOID arg)
+{
+  assert(pthread_mutex_lock(&mx) == 0);
+  assert(SetEvent(locked));
+  Sleep(50);
+  return 0;
+}
+
+static DWORD WINAPI
+holds(LPVOID arg)
+{
+  assert(pthread_mutex_lock(&mx) == 0);
+  assert(SetEvent(locked));
+  assert(WaitForSingleObject(release, INFINITE) == WAIT_OBJECT_0);
+  assert(pthread_mutex_unlock(&mx) == 0);
+  return 0;
+}
+
+static void
+run(LPTHREAD_START_ROUTINE routine, HANDLE * h)
+{
+  DWORD id;
+
+  assert((*h = CreateThread(NULL, 0, routine, NULL, 0, &id)) != NULL);
+}
+
+int
+main()
+{
+  pthread_mutexattr_t ma;
+  HANDLE h;
+  int kinds[] = { PTHREAD_MUTEX_NORMAL, PTHREAD_MUTEX_ERRORCHECK, PTHREAD_MUTEX_RECURSIVE };
+  int i;
+
+  assert((locked = CreateEvent(NULL, FALSE, FALSE, NULL)) != NULL);
+  assert((release = CreateEvent(NULL, FALSE, FALSE, NULL)) != NULL);
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_setpshared(&ma, PTHREAD_PROCESS_SHARED) == 0);
+  assert(pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_ROBUST) == 0);
+
+  for (i = 0; i < (int) (sizeof(kinds) / sizeof(kinds[0])); i++)
+    {
+      assert(pthread_mutexattr_settype(&ma, kinds[i]) == 0);
+      assert(pthread_mutex_init(&mx, &ma) == 0);
+
+      /*
+       * A live owner keeps it.
+       */
+      run(holds, &h);
+      assert(WaitForSingleObject(locked, INFINITE) == WAIT_OBJECT_0);
+      assert(pthread_mutex_trylock(&mx) == EBUSY);
+      assert(SetEvent(release));
+      assert(WaitForSingleObject(h, INFINITE) == WAIT_OBJECT_0);
+      assert(CloseHandle(h));
+      assert(pthread_mutex_consistent(&mx) == EINVAL);
+
+      /*
+       * Blocked when the owner ends.
+       */
+      run(diesHolding, &h);
+      assert(WaitForSingleObject(locked, INFINITE) == WAIT_OBJECT_0);
+      assert(pthread_mutex_lock(&mx) == EOWNERDEAD);
+      assert(WaitForSingleObject(h, INFINITE) == WAIT_OBJECT_0);
+      assert(CloseHandle(h));
+      assert(pthread_mutex_consistent(&mx) == 0);
+      assert(pthread_mutex_unlock(&mx) == 0);
+      assert(pthread_mutex_lock(&mx) == 0);
+      assert(pthread_mutex_unlock(&mx) == 0);
+
+      /*
+       * Found by trylock, and not made consistent.
+       */
+      run(diesHolding, &h);
+      assert(WaitForSingleObject(h, INFINITE) == WAIT_OBJECT_0);
+      assert(CloseHandle(h));
+      assert(WaitForSingleObject(locked, 0) == WAIT_OBJECT_0);
+      assert(pthread_mutex_trylock(&mx) == EOWNERDEAD);
+      assert(pthread_mutex_unlock(&mx) == 0);
+      assert(pthread_mutex_lock(&mx) == ENOTRECOVERABLE);
+      assert(pthread_mutex_trylock(&mx) == ENOTRECOVERABLE);
+      assert(pthread_mutex_destroy(&mx) == 0);
+    }
+
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+  assert(CloseHandle(locked));
+  assert(CloseHandle(release));
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+/* 
+ * qos1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Thread quality of service: the attribute, threads created with it,
+ * and changing the QoS of a running thread.
+ *
+ * Depends on API functions:
+ *	pthread_attr_setqos_np()
+ *	pthread_attr_getqos_np()
+ *	pthread_setqos_np()
+ *	pthread_getqos_np()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+void *
+func(void * arg)
+{
+  int qos;
+
+  assert(pthread_getqos_np(pthread_self(), &qos) == 0);
+  assert(qos == (int)(size_t) arg);
+
+  assert(pthread_setqos_np(pthread_self(), PTHREAD_QOS_HIGH_NP) == 0);
+  assert(pthread_getqos_np(pthread_self(), &qos) == 0);
+  assert(qos == PTHREAD_QOS_HIGH_NP);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_attr_t attr;
+  pthread_t t;
+  int qos;
+
+  assert(pthread_getqos_np(pthread_self(), &qos) == 0);
+  assert(qos == PTHREAD_QOS_DEFAULT_NP);
+  assert(pthread_getqos_np(pthread_self(), NULL) == EINVAL);
+  assert(pthread_setqos_np(pthread_self(), PTHREAD_QOS_EFFICIENCY_NP + 1) == EINVAL);
+
+  assert(pthread_attr_init(&attr) == 0);
+  assert(pthread_attr_getqos_np(&attr, &qos) == 0);
+  assert(qos == PTHREAD_QOS_DEFAULT_NP);
+  assert(pthread_attr_setqos_np(&attr, -1) == EINVAL);
+  assert(pthread_attr_setqos_np(&attr, PTHREAD_QOS_EFFICIENCY_NP) == 0);
+  assert(pthread_attr_getqos_np(&attr, &qos) == 0);
+  assert(qos == PTHREAD_QOS_EFFICIENCY_NP);
+
+  assert(pthread_create(&t, &attr, func, (void *)(size_t) PTHREAD_QOS_EFFICIENCY_NP) == 0);
+  assert(pthread_join(t, NULL) == 0);
+
+  /* The QoS of a thread doesn't outlive it */
+  assert(pthread_create(&t, NULL, func, (void *)(size_t) PTHREAD_QOS_DEFAULT_NP) == 0);
+  assert(pthread_join(t, NULL) == 0);
+
+  assert(pthread_attr_destroy(&attr) == 0);
+
+  return 0;
+}
@@ -0,0 +1,139 @@
+/* 
+ * queue1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Push to and pop from a bounded queue from one thread, with the
+ * try and timed variants at the full and empty edges, and a pop
+ * that blocks until another thread pushes.
+ *
+ * Depends on API functions:
+ *	pthread_queue_create_np()
+ *	pthread_queue_push_np()
+ *	pthread_queue_trypush_np()
+ *	pthread_queue_timedpush_np()
+ *	pthread_queue_pop_np()
+ *	pthread_queue_trypop_np()
+ *	pthread_queue_timedpop_np()
+ *	pthread_queue_destroy_np()
+ */
+
+#include "test.h"
+#include "../implement.h"
+
+enum {
+  CAPACITY = 5		/* not a power of 2 */
+};
+
+static pthread_queue_np_t queue;
+
+void *
+pusher(void * arg)
+{
+  Sleep(100);
+  assert(pthread_queue_push_np(queue, arg) == 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  struct timespec abstime = { 0, 0 };
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+  pthread_t t;
+  void * item;
+  size_t i;
+  int lap;
+
+  assert(pthread_queue_create_np(NULL, CAPACITY) == EINVAL);
+  assert(pthread_queue_create_np(&queue, 0) == EINVAL);
+  assert(pthread_queue_create_np(&queue, CAPACITY) == 0);
+
+  assert(pthread_queue_pop_np(queue, NULL) == EINVAL);
+  assert(pthread_queue_trypop_np(queue, &item) == EAGAIN);
+
+  /* Several laps round the ring, in order */
+  for (lap = 0; lap < 3; lap++)
+    {
+      for (i = 0; i < CAPACITY; i++)
+        {
+          assert(pthread_queue_push_np(queue, (void *) i) == 0);
+        }
+
+      assert(pthread_queue_trypush_np(queue, (void *) i) == EAGAIN);
+
+      for (i = 0; i < CAPACITY; i++)
+        {
+          assert(pthread_queue_trypop_np(queue, &item) == 0);
+          assert((size_t) item == i);
+        }
+
+      assert(pthread_queue_trypop_np(queue, &item) == EAGAIN);
+    }
+
+  /* Timed waits at the edges */
+  PTW32_FTIME(&currSysTime);
+  abstime.tv_sec = (long)currSysTime.time;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+  abstime.tv_sec += 1;
+
+  assert(pthread_queue_timedpop_np(queue, &item, &abstime) == ETIMEDOUT);
+
+  for (i = 0; i < CAPACITY; i++)
+    {
+      assert(pthread_queue_timedpush_np(queue, (void *) i, &abstime) == 0);
+    }
+
+  assert(pthread_queue_timedpush_np(queue, (void *) i, &abstime) == ETIMEDOUT);
+
+  for (i = 0; i < CAPACITY; i++)
+    {
+      assert(pthread_queue_timedpop_np(queue, &item, &abstime) == 0);
+      assert((size_t) item == i);
+    }
+
+  /* A pop that waits for a push */
+  assert(pthread_create(&t, NULL, pusher, (void *) 42) == 0);
+  assert(pthread_queue_pop_np(queue, &item) == 0);
+  assert((size_t) item == 42);
+  assert(pthread_join(t, NULL) == 0);
+
+  /* Items left behind are discarded */
+  assert(pthread_queue_push_np(queue, NULL) == 0);
+  assert(pthread_queue_destroy_np(&queue) == 0);
+  assert(queue == NULL);
+  assert(pthread_queue_destroy_np(&queue) == EINVAL);
+
+  return 0;
+}
@@ -0,0 +1,151 @@
+/* 
+ * queue2.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Several producers and consumers share a small bounded queue; every
+ * item pushed is popped exactly once. Then a consumer blocked on the
+ * empty queue is cancelled, which leaves the queue usable.
+ *
+ * Depends on API functions:
+ *	pthread_queue_create_np()
+ *	pthread_queue_push_np()
+ *	pthread_queue_pop_np()
+ *	pthread_queue_destroy_np()
+ *	pthread_cancel()
+ */
+
+#include "test.h"
+
+enum {
+  CAPACITY = 8,
+  NUMPRODUCERS = 4,
+  NUMCONSUMERS = 4,
+  NUMITEMS = 20000	/* per producer */
+};
+
+static pthread_queue_np_t queue;
+static LONG seen[NUMPRODUCERS * NUMITEMS];
+
+void *
+producer(void * arg)
+{
+  size_t first = (size_t) arg * NUMITEMS;
+  size_t i;
+
+  for (i = 0; i < NUMITEMS; i++)
+    {
+      /* Offset by one so that no item is NULL */
+      assert(pthread_queue_push_np(queue, (void *) (first + i + 1)) == 0);
+    }
+
+  return NULL;
+}
+
+void *
+consumer(void * arg)
+{
+  void * item;
+
+  for (;;)
+    {
+      assert(pthread_queue_pop_np(queue, &item) == 0);
+
+      if (item == NULL)
+        {
+          break;
+        }
+
+      InterlockedIncrement(&seen[(size_t) item - 1]);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t producers[NUMPRODUCERS];
+  pthread_t consumers[NUMCONSUMERS];
+  pthread_t t;
+  void * result;
+  void * item;
+  size_t i;
+
+  assert(pthread_queue_create_np(&queue, CAPACITY) == 0);
+
+  for (i = 0; i < NUMCONSUMERS; i++)
+    {
+      assert(pthread_create(&consumers[i], NULL, consumer, NULL) == 0);
+    }
+
+  for (i = 0; i < NUMPRODUCERS; i++)
+    {
+      assert(pthread_create(&producers[i], NULL, producer, (void *) i) == 0);
+    }
+
+  for (i = 0; i < NUMPRODUCERS; i++)
+    {
+      assert(pthread_join(producers[i], NULL) == 0);
+    }
+
+  /* One NULL stops each consumer */
+  for (i = 0; i < NUMCONSUMERS; i++)
+    {
+      assert(pthread_queue_push_np(queue, NULL) == 0);
+    }
+
+  for (i = 0; i < NUMCONSUMERS; i++)
+    {
+      assert(pthread_join(consumers[i], NULL) == 0);
+    }
+
+  for (i = 0; i < NUMPRODUCERS * NUMITEMS; i++)
+    {
+      assert(seen[i] == 1);
+    }
+
+  /* Cancel a consumer waiting on the empty queue */
+  assert(pthread_create(&t, NULL, consumer, NULL) == 0);
+  Sleep(100);
+  assert(pthread_cancel(t) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert(result == PTHREAD_CANCELED);
+
+  assert(pthread_queue_push_np(queue, (void *) 1) == 0);
+  assert(pthread_queue_pop_np(queue, &item) == 0);
+  assert((size_t) item == 1);
+
+  assert(pthread_queue_destroy_np(&queue) == 0);
+
+  return 0;
+}
@@ -0,0 +1,211 @@
+/* 
+ * rcu1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Readers under quiescent state based RCU never see a node that has
+ * been reclaimed, whether the updater waits with
+ * pthread_rcu_synchronize_np or defers with pthread_call_rcu_np.
+ * Grace periods don't wait for readers that are offline, blocked in a
+ * cancellation point or have exited.
+ *
+ * Depends on API functions:
+ *	pthread_rcu_online_np()
+ *	pthread_rcu_offline_np()
+ *	pthread_rcu_quiescent_np()
+ *	pthread_rcu_synchronize_np()
+ *	pthread_call_rcu_np()
+ *	pthread_rcu_barrier_np()
+ *	sem_wait()
+ */
+
+#include "test.h"
+
+enum {
+  NUMREADERS = 3,
+  ITERATIONS = 400,
+  LIVE = 0x1234,
+  DEAD = 0xdead
+};
+
+typedef struct {
+  pthread_rcu_head_np_t head;	/* first, so a head is its node */
+  volatile long magic;
+} node_t;
+
+static node_t nodes[ITERATIONS + 1];
+static node_t * volatile current = &nodes[0];
+static volatile int done = 0;
+static long retired = 0;
+static long started = 0;
+static sem_t blocker;
+
+void PTW32_CDECL
+retire(pthread_rcu_head_np_t * head)
+{
+  node_t * n = (node_t *) head;
+
+  assert(n->magic == LIVE);
+  n->magic = DEAD;
+  InterlockedIncrement(&retired);
+}
+
+void *
+reader(void * arg)
+{
+  long reads = 0;
+
+  assert(pthread_rcu_online_np() == 0);
+  InterlockedIncrement(&started);
+
+  do
+    {
+      node_t * n = current;
+      int j;
+
+      /* Hold the reference across the updater's next step */
+      for (j = 0; j < 100; j++)
+	{
+	  assert(n->magic == LIVE);
+	  if ((j & 15) == 0)
+	    {
+	      sched_yield();
+	    }
+	}
+      reads++;
+
+      if ((size_t) arg == 0)
+	{
+	  pthread_testcancel();
+	}
+      else
+	{
+	  assert(pthread_rcu_quiescent_np() == 0);
+	}
+    }
+  while (!done);
+
+  assert(pthread_rcu_offline_np() == 0);
+
+  return (void *) (size_t) reads;
+}
+
+void *
+sleeper(void * arg)
+{
+  assert(pthread_rcu_online_np() == 0);
+  assert(sem_wait(&blocker) == 0);
+  assert(pthread_rcu_offline_np() == 0);
+
+  return NULL;
+}
+
+void *
+quitter(void * arg)
+{
+  assert(pthread_rcu_online_np() == 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMREADERS];
+  void * result;
+  int i;
+
+  assert(pthread_call_rcu_np(NULL, retire) == EINVAL);
+  assert(pthread_call_rcu_np(&nodes[0].head, NULL) == EINVAL);
+  assert(pthread_rcu_offline_np() == 0);
+  assert(pthread_rcu_synchronize_np() == 0);
+  assert(pthread_rcu_barrier_np() == 0);
+
+  /* An online caller doesn't wait for itself */
+  assert(pthread_rcu_online_np() == 0);
+  assert(pthread_rcu_synchronize_np() == 0);
+  assert(pthread_rcu_offline_np() == 0);
+
+  /* Nor for readers blocked in a cancellation point or gone */
+  assert(sem_init(&blocker, 0, 0) == 0);
+  assert(pthread_create(&t[0], NULL, sleeper, NULL) == 0);
+  assert(pthread_create(&t[1], NULL, quitter, NULL) == 0);
+  assert(pthread_join(t[1], NULL) == 0);
+  Sleep(100);
+  assert(pthread_rcu_synchronize_np() == 0);
+  assert(sem_post(&blocker) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(sem_destroy(&blocker) == 0);
+
+  for (i = 0; i <= ITERATIONS; i++)
+    {
+      nodes[i].magic = LIVE;
+    }
+
+  for (i = 0; i < NUMREADERS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, reader, (void *) (size_t) i) == 0);
+    }
+
+  while (started < NUMREADERS)
+    {
+      sched_yield();
+    }
+
+  for (i = 1; i <= ITERATIONS; i++)
+    {
+      node_t * old = (node_t *) InterlockedExchangePointer((PVOID volatile *) &current, &nodes[i]);
+
+      if (i & 1)
+	{
+	  assert(pthread_rcu_synchronize_np() == 0);
+	  old->magic = DEAD;
+	}
+      else
+	{
+	  assert(pthread_call_rcu_np(&old->head, retire) == 0);
+	}
+      sched_yield();
+    }
+
+  done = 1;
+  for (i = 0; i < NUMREADERS; i++)
+    {
+      assert(pthread_join(t[i], &result) == 0);
+      assert((size_t) result > 0);
+    }
+
+  assert(pthread_rcu_barrier_np() == 0);
+  assert(retired == ITERATIONS / 2);
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+/* 
+ * reltime1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test the relative-timeout waits: a bad duration is rejected, an
+ * unavailable mutex, semaphore or condition times out, and an
+ * available mutex or semaphore is taken at once.
+ *
+ * Depends on API functions:
+ *	pthread_mutex_reltimedlock_np()
+ *	sem_reltimedwait_np()
+ *	pthread_cond_timedwait_relative_np()
+ */
+
+#include "test.h"
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cv = PTHREAD_COND_INITIALIZER;
+
+static void *
+locker(void * arg)
+{
+  struct timespec reltime = { 0, 50000000 };
+
+  assert(pthread_mutex_reltimedlock_np(&mutex, &reltime) == ETIMEDOUT);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t;
+  sem_t s;
+  struct timespec reltime = { 0, 50000000 };
+  struct timespec bad = { 0, 1000000000L };
+  struct timespec negative = { -1, 0 };
+
+  assert(sem_init(&s, 0, 1) == 0);
+
+  assert(pthread_mutex_reltimedlock_np(&mutex, &bad) == EINVAL);
+  assert(pthread_mutex_reltimedlock_np(&mutex, &negative) == EINVAL);
+  assert(pthread_mutex_reltimedlock_np(&mutex, NULL) == EINVAL);
+  assert(sem_reltimedwait_np(&s, &bad) == -1);
+  assert(errno == EINVAL);
+
+  assert(sem_reltimedwait_np(&s, &reltime) == 0);
+  assert(sem_reltimedwait_np(&s, &reltime) == -1);
+  assert(errno == ETIMEDOUT);
+
+  assert(pthread_mutex_reltimedlock_np(&mutex, &reltime) == 0);
+  assert(pthread_create(&t, NULL, locker, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+
+  assert(pthread_cond_timedwait_relative_np(&cv, &mutex, &bad) == EINVAL);
+  assert(pthread_cond_timedwait_relative_np(&cv, &mutex, &reltime) == ETIMEDOUT);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  assert(sem_destroy(&s) == 0);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+  assert(pthread_cond_destroy(&cv) == 0);
+
+  return 0;
+}
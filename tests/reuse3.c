@@ -0,0 +1,200 @@
+/*
+ * File: reuse3.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Test that thread structs are reused, including after more
+ *   threads have exited than the reuse ring holds. With every thread
+ *   destroyed on one processor, the oldest of the few kept on that
+ *   processor comes back first, then the rest in FIFO order; the
+ *   last few destroyed wait for later ones and are not reused yet.
+ * - Test concurrent create and join.
+ *
+ * Test Method (Validation or Falsification):
+ * -
+ *
+ * Requirements Tested:
+ * -
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * -
+ *
+ * Description:
+ * -
+ *
+ * Environment:
+ * - This test is implementation specific
+ * because it uses knowledge of internals that should be
+ * opaque to an application.
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * -
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+/*
+ * More than the library's reuse ring holds, so that some
+ * thread structs go to the overflow list.
+ */
+enum {
+	NUMTHREADS = 1200,
+	NUMCREATORS = 4,
+	NUMLOOPS = 500,
+	CPU_DEPTH = 4		/* PTW32_THREAD_REUSE_CPU_DEPTH */
+};
+
+static pthread_t t[NUMTHREADS];
+static pthread_t u[NUMTHREADS];
+static char reused[NUMTHREADS];
+static long go = 0;
+
+void * waiter(void * arg)
+{
+  while (0 == InterlockedExchangeAdd((LPLONG)&go, 0L))
+    Sleep(1);
+
+  return arg;
+}
+
+void * func(void * arg)
+{
+  return arg;
+}
+
+void * creator(void * arg)
+{
+  int i;
+
+  for (i = 0; i < NUMLOOPS; i++)
+    {
+      pthread_t c;
+      void * result = NULL;
+
+      assert(pthread_create(&c, NULL, func, (void *)(size_t) i) == 0);
+      assert(pthread_join(c, &result) == 0);
+      assert((int)(size_t) result == i);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t c[NUMCREATORS];
+  int fresh = 0;
+  int last = -1;
+  int i;
+
+  /* The joins destroy the threads, all on this processor */
+  assert(SetThreadAffinityMask(GetCurrentThread(), 1) != 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, waiter, NULL) == 0);
+    }
+
+  InterlockedExchange((LPLONG)&go, 1L);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  /*
+   * The structs come back each once, those that went through the
+   * ring in the order they were destroyed, and all but the last
+   * few destroyed.
+   */
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      int j;
+
+      assert(pthread_create(&u[i], NULL, func, NULL) == 0);
+      for (j = 0; j < NUMTHREADS && u[i].p != t[j].p; j++)
+        ;
+      if (j == NUMTHREADS)
+        {
+          fresh++;
+          continue;
+        }
+      assert(!reused[j]);
+      assert(!pthread_equal(u[i], t[j]));
+      reused[j] = 1;
+      if (j < NUMTHREADS - CPU_DEPTH)
+        {
+          assert(j > last);
+          last = j;
+        }
+    }
+  assert(fresh < CPU_DEPTH);
+  for (i = NUMTHREADS - CPU_DEPTH + 1; i < NUMTHREADS; i++)
+    {
+      assert(!reused[i]);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(u[i], NULL) == 0);
+    }
+
+  for (i = 0; i < NUMCREATORS; i++)
+    {
+      assert(pthread_create(&c[i], NULL, creator, NULL) == 0);
+    }
+
+  for (i = 0; i < NUMCREATORS; i++)
+    {
+      assert(pthread_join(c[i], NULL) == 0);
+    }
+
+  return 0;
+}
@@ -0,0 +1,184 @@
+/*
+ * File: reuse4.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Confirm that threads run on OS threads from the thread cache
+ *   behave as new threads.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_setthreadcache_np, pthread_getthreadcache_np
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - joinable and detached threads are run on parked OS threads.
+ * - every thread has a new pthread_t and sequence number.
+ * - TSD destructors run for every thread and every thread starts
+ *   with NULL TSD values.
+ *
+ * Description:
+ * - Threads are created one at a time with a short pause after each
+ *   ends so that its OS thread has time to park.
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * -
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+	NUMTHREADS = 50
+};
+
+static pthread_key_t dtorKey;
+static pthread_key_t plainKey;
+static int destroyed = 0;
+static int sawValues = 0;
+static DWORD w32id;
+static sem_t done;
+
+static void
+destroy(void * arg)
+{
+  destroyed++;
+  assert(sem_post(&done) == 0);
+}
+
+void * func(void * arg)
+{
+  if (pthread_getspecific(dtorKey) != NULL
+      || pthread_getspecific(plainKey) != NULL)
+    {
+      sawValues++;
+    }
+  assert(pthread_setspecific(dtorKey, arg) == 0);
+  assert(pthread_setspecific(plainKey, arg) == 0);
+  w32id = pthread_getw32threadid_np(pthread_self());
+  return arg;
+}
+
+int
+main()
+{
+  pthread_t t;
+  pthread_attr_t attr;
+  void * result = NULL;
+  unsigned __int64 lastSeq = 0;
+  DWORD lastW32id = 0;
+  int reused = 0;
+  int max;
+  int i;
+
+  assert(pthread_getthreadcache_np(&max) == 0);
+  assert(max == 0);
+  assert(pthread_setthreadcache_np(-1) == EINVAL);
+  assert(pthread_setthreadcache_np(2) == 0);
+  assert(pthread_getthreadcache_np(&max) == 0);
+  assert(max == 2);
+
+  assert(pthread_key_create(&dtorKey, destroy) == 0);
+  assert(pthread_key_create(&plainKey, NULL) == 0);
+  assert(sem_init(&done, 0, 0) == 0);
+
+  for (i = 1; i <= NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t, NULL, func, (void *)(size_t)i) == 0);
+      assert(pthread_join(t, &result) == 0);
+      assert((int)(size_t) result == i);
+      assert(sem_wait(&done) == 0);
+      assert(destroyed == i);
+      assert(pthread_getunique_np(t) > lastSeq);
+      lastSeq = pthread_getunique_np(t);
+      if (w32id == lastW32id)
+        {
+          reused++;
+        }
+      lastW32id = w32id;
+      Sleep(10);
+    }
+
+  assert(sawValues == 0);
+  assert(reused > 0);
+
+  assert(pthread_attr_init(&attr) == 0);
+  assert(pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) == 0);
+
+  for (i = 1; i <= NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t, &attr, func, (void *)(size_t)i) == 0);
+      /* Posted by the destructor */
+      assert(sem_wait(&done) == 0);
+      Sleep(10);
+    }
+
+  assert(destroyed == 2 * NUMTHREADS);
+  assert(sawValues == 0);
+
+  /*
+   * Parked threads end and new ones are created again.
+   */
+  assert(pthread_setthreadcache_np(0) == 0);
+  assert(pthread_create(&t, NULL, func, (void *)(size_t)1) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert((int)(size_t) result == 1);
+  assert(sem_wait(&done) == 0);
+
+  assert(pthread_attr_destroy(&attr) == 0);
+  assert(sem_destroy(&done) == 0);
+  assert(pthread_key_delete(dtorKey) == 0);
+  assert(pthread_key_delete(plainKey) == 0);
+
+  return 0;
+}
@@ -0,0 +1,150 @@
+/*
+ * File: reuse5.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Confirm that limiting the pthread_t structs kept for reuse keeps
+ *   pthread_t values unique.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_setthreadreuse_np, pthread_getthreadreuse_np
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - the limit starts at -1 and can't be set below it.
+ * - with no structs kept, and with a few kept after a burst of
+ *   threads, no thread's pthread_t equals an earlier thread's, even
+ *   where its struct is at the address of a freed one.
+ *
+ * Description:
+ * -
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * -
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+	NUMTHREADS = 64,
+	BURST = 16
+};
+
+static pthread_t seen[NUMTHREADS + BURST];
+static int nSeen = 0;
+
+void * func(void * arg)
+{
+  return arg;
+}
+
+static void
+check(pthread_t t)
+{
+  int i;
+
+  for (i = 0; i < nSeen; i++)
+    {
+      assert(!pthread_equal(t, seen[i]));
+    }
+
+  seen[nSeen++] = t;
+}
+
+int
+main()
+{
+  pthread_t t[BURST];
+  int max;
+  int i;
+
+  assert(pthread_getthreadreuse_np(&max) == 0);
+  assert(max == -1);
+  assert(pthread_setthreadreuse_np(-2) == EINVAL);
+  assert(pthread_setthreadreuse_np(0) == 0);
+  assert(pthread_getthreadreuse_np(&max) == 0);
+  assert(max == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[0], NULL, func, NULL) == 0);
+      check(t[0]);
+      assert(pthread_join(t[0], NULL) == 0);
+    }
+
+  assert(pthread_setthreadreuse_np(-1) == 0);
+
+  for (i = 0; i < BURST; i++)
+    {
+      assert(pthread_create(&t[i], NULL, func, NULL) == 0);
+      check(t[i]);
+    }
+
+  for (i = 0; i < BURST; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  /* Frees all but 4 */
+  assert(pthread_setthreadreuse_np(4) == 0);
+
+  for (i = 0; i < BURST; i++)
+    {
+      assert(pthread_create(&t[0], NULL, func, NULL) == 0);
+      assert(pthread_join(t[0], NULL) == 0);
+    }
+
+  return 0;
+}
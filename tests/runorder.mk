@@ -13,12 +13,17 @@ affinity3.pass: affinity2.pass self1.pass create3.pass
 affinity4.pass: affinity3.pass
 affinity5.pass: affinity4.pass
 affinity6.pass: affinity5.pass
+affinity7.pass: affinity6.pass
+affinity8.pass: affinity7.pass
+numa1.pass: affinity7.pass
 barrier1.pass: semaphore4.pass
 barrier2.pass: barrier1.pass semaphore4.pass
 barrier3.pass: barrier2.pass semaphore4.pass self1.pass create3.pass join4.pass
 barrier4.pass: barrier3.pass semaphore4.pass self1.pass create3.pass join4.pass mutex8.pass
 barrier5.pass: barrier4.pass semaphore4.pass self1.pass create3.pass join4.pass mutex8.pass
 barrier6.pass: barrier5.pass semaphore4.pass self1.pass create3.pass join4.pass mutex8.pass
+barrier7.pass: barrier6.pass
+barrier8.pass: barrier7.pass
 cancel1.pass: self1.pass create3.pass
 cancel2.pass: self1.pass create3.pass join4.pass barrier6.pass
 cancel3.pass: self1.pass create3.pass join4.pass context1.pass
@@ -29,10 +34,14 @@ cancel6d.pass: cancel3.pass self1.pass create3.pass join4.pass
 cancel7.pass: self1.pass create3.pass join4.pass kill1.pass
 cancel8.pass: cancel7.pass self1.pass mutex8.pass kill1.pass
 cancel9.pass: cancel8.pass self1.pass create3.pass join4.pass mutex8.pass kill1.pass
+cancel10.pass: cancel8.pass delay2.pass
+cancel11.pass: cancel10.pass
 cleanup0.pass: self1.pass create3.pass join4.pass mutex8.pass cancel5.pass
 cleanup1.pass: cleanup0.pass
 cleanup2.pass: cleanup1.pass
 cleanup3.pass: cleanup2.pass
+cleanup4.pass: cleanup3.pass
+clock1.pass: timeouts3.pass
 condvar1.pass: self1.pass create3.pass semaphore1.pass mutex8.pass
 condvar1_1.pass: condvar1.pass
 condvar1_2.pass: join2.pass
@@ -48,13 +57,23 @@ condvar6.pass: condvar5.pass
 condvar7.pass: condvar6.pass cleanup1.pass
 condvar8.pass: condvar7.pass
 condvar9.pass: condvar8.pass
+condvar10.pass: condvar9.pass
+condvar11.pass: condvar10.pass
+condvar12.pass: condvar11.pass
+condvar13.pass: condvar12.pass rwlock2.pass
 context1.pass: cancel1.pass
 count1.pass: join1.pass
 create1.pass: mutex2.pass
 create2.pass: create1.pass
 create3.pass: create2.pass
+create4.pass: create3.pass
+create5.pass: create4.pass
+create6.pass: create5.pass
+create7.pass: create6.pass
 delay1.pass: self1.pass create3.pass
 delay2.pass: delay1.pass
+delay3.pass: delay2.pass
+yield1.pass: delay2.pass
 detach1.pass: join0.pass
 equal1.pass: self1.pass create1.pass
 errno1.pass: mutex3.pass
@@ -68,14 +87,26 @@ exit3.pass: create1.pass
 exit4.pass: self1.pass create3.pass 
 exit5.pass: exit4.pass kill1.pass
 exit6.pass: exit5.pass
+exit7.pass: exit6.pass
+exit8.pass: exit7.pass cleanup1.pass tsd1.pass
 eyal1.pass: self1.pass create3.pass mutex8.pass tsd1.pass
 inherit1.pass: join1.pass priority1.pass
+inline1.pass: mutex5.pass spin4.pass
+inline2.pass: inline1.pass cancel2.pass
 join0.pass: create1.pass
 join1.pass: create1.pass
 join2.pass: create1.pass
 join3.pass: join2.pass
 join4.pass: join3.pass
+join5.pass: join4.pass
+join6.pass: join5.pass
 kill1.pass: self1.pass
+kill2.pass: kill1.pass
+kill3.pass: kill2.pass
+group1.pass: kill2.pass
+lockstat1.pass: condvar2.pass rwlock2.pass
+lockprof1.pass: lockstat1.pass
+lockwatch1.pass: mutex5.pass
 mutex1.pass: mutex5.pass
 mutex1n.pass: mutex1.pass
 mutex1e.pass: mutex1.pass
@@ -103,17 +134,58 @@ mutex8.pass: mutex7.pass
 mutex8n.pass: mutex7n.pass
 mutex8e.pass: mutex7e.pass
 mutex8r.pass: mutex7r.pass
+mutex9.pass: mutex8r.pass
+mutex10.pass: mutex9.pass
+mutex11.pass: mutex10.pass
 name_np1.pass: join4.pass barrier6.pass
 name_np2.pass: name_np1.pass
+name_np3.pass: name_np2.pass
 once1.pass: create1.pass
 once2.pass: once1.pass
 once3.pass: once2.pass
 once4.pass: once3.pass
+once5.pass: once4.pass
+pool1.pass: create1.pass tsd1.pass
+pool2.pass: pool1.pass cleanup1.pass exit1.pass
+pool3.pass: pool2.pass
+pool4.pass: pool3.pass semaphore1.pass
+pool5.pass: pool4.pass tsd2.pass
+cputokens1.pass: pool1.pass semaphore1.pass
+async1.pass: pool3.pass
+iocp1.pass: async1.pass
+pooled1.pass: create4.pass
+param1.pass: pooled1.pass
+largepage1.pass: param1.pass slab1.pass
+libstats1.pass: param1.pass
+histograms1.pass: libstats1.pass
+arena1.pass: self1.pass
+waitgraph1.pass: mutex2.pass
+flightrec1.pass: waitgraph1.pass condvar2.pass
+elide1.pass: rwlock7.pass
+cohort1.pass: fair1.pass
+mcs1.pass: self1.pass create1.pass
+percpu1.pass: create1.pass
+counter1.pass: percpu1.pass
+wsdeque1.pass: create1.pass
+spsc1.pass: cancel2.pass
+latch1.pass: create1.pass
+phaser1.pass: latch1.pass
+reltime1.pass: phaser1.pass
+timerslack1.pass: reltime1.pass
+timer1.pass: timerslack1.pass
+queue1.pass: semaphore4t.pass create1.pass
+queue2.pass: queue1.pass cancel2.pass
 priority1.pass: join1.pass
 priority2.pass: priority1.pass barrier3.pass
+pshared1.pass: condvar3.pass mutex8.pass
+pshared2.pass: semaphore7.pass barrier7.pass
+pshared3.pass: pshared1.pass robust1.pass
 reinit1.pass: rwlock7.pass
 reuse1.pass: create3.pass
 reuse2.pass: reuse1.pass
+reuse3.pass: reuse2.pass
+reuse4.pass: reuse3.pass
+reuse5.pass: reuse4.pass
 robust1.pass: mutex8r.pass
 robust2.pass: mutex8r.pass
 robust3.pass: robust2.pass
@@ -127,31 +199,75 @@ rwlock5.pass: rwlock4.pass
 rwlock6.pass: rwlock5.pass
 rwlock7.pass: rwlock6.pass
 rwlock8.pass: rwlock7.pass
+rwlock9.pass: rwlock8.pass
+rwlock10.pass: rwlock9.pass
+rwlock11.pass: rwlock10.pass
+rwlock12.pass: rwlock11.pass
 rwlock2_t.pass: rwlock2.pass
 rwlock3_t.pass: rwlock2_t.pass
 rwlock4_t.pass: rwlock3_t.pass
 rwlock5_t.pass: rwlock4_t.pass
 rwlock6_t.pass: rwlock5_t.pass
 rwlock6_t2.pass: rwlock6_t.pass
+scope1.pass: condvar2.pass semaphore4.pass join4.pass tsd2.pass cancel5.pass
 self1.pass: sizes.pass
 self2.pass: self1.pass equal1.pass create1.pass
+self3.pass: self2.pass
+self4.pass: self3.pass
 semaphore1.pass: sizes.pass
 semaphore2.pass: semaphore1.pass
 semaphore3.pass: semaphore2.pass
 semaphore4.pass: semaphore3.pass cancel1.pass
 semaphore4t.pass: semaphore4.pass
 semaphore5.pass: semaphore4.pass
+semaphore6.pass: semaphore5.pass
+semaphore7.pass: semaphore6.pass
+semaphore8.pass: semaphore7.pass
+semaphore9.pass: semaphore8.pass
+semaphore10.pass: semaphore9.pass
+semaphore11.pass: semaphore10.pass join1.pass
+semaphore12.pass: semaphore11.pass cancel1.pass
 sequence1.pass: reuse2.pass
 sizes.pass: 
 spin1.pass: self1.pass create3.pass mutex8.pass
 spin2.pass: spin1.pass
 spin3.pass: spin2.pass
 spin4.pass: spin3.pass
+spin5.pass: spin4.pass
+spin6.pass: spin5.pass
+spin7.pass: spin6.pass
+static1.pass: mutex5.pass condvar3.pass rwlock2.pass spin4.pass
+storage1.pass: mutex5.pass spin4.pass
+objalign1.pass: barrier1.pass semaphore1.pass spin4.pass
+slab1.pass: condvar1.pass rwlock1.pass semaphore1.pass mutex5.pass join1.pass
+attrinit1.pass: barrier1.pass condvar1.pass rwlock1.pass mutex5.pass join1.pass
+array1.pass: condvar1.pass spin4.pass storage1.pass objalign1.pass
+lockstripe1.pass: mutex5.pass array1.pass
+seqlock1.pass: mutex5.pass join1.pass
+rwspin1.pass: spin1.pass join1.pass
+rcu1.pass: semaphore1.pass join1.pass condvar1.pass
+hazard1.pass: semaphore1.pass join1.pass
+waitaddr1.pass: cancel2.pass join1.pass
+waitany1.pass: semaphore1.pass cancel2.pass join1.pass
+joinasync1.pass: join1.pass
+fair1.pass: mutex8.pass
+prio1.pass: mutex8.pass
+priority3.pass: prio1.pass
+priority4.pass: fair1.pass semaphore11.pass condvar2.pass
+qos1.pass: affinity6.pass
+wakeboost1.pass: qos1.pass param1.pass
 stress1.pass: create3.pass mutex8.pass barrier6.pass
+threadstats1.pass: semaphore4.pass cancel1.pass
 threestage.pass: stress1.pass
 timeouts.pass: condvar9.pass
+timeouts2.pass: timeouts.pass
+timeouts3.pass: timeouts2.pass
 tsd1.pass: barrier5.pass join1.pass
 tsd2.pass: tsd1.pass
 tsd3.pass: tsd2.pass
+tsd4.pass: tsd3.pass
+tsd5.pass: tsd4.pass
+tsd6.pass: tsd5.pass
+tsd7.pass: tsd6.pass
 valid1.pass: join1.pass
 valid2.pass: valid1.pass
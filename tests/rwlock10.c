@@ -0,0 +1,262 @@
+/* 
+ * rwlock10.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Tests read/write lock preference policies.
+ * For each kind, checks that a waiting writer holds off new readers
+ * unless readers are preferred, that timed lock calls time out, and
+ * that readers and writers using the plain, try and timed calls
+ * keep a shared pair consistent.
+ *
+ * Depends on API functions: 
+ *      pthread_create()
+ *      pthread_join()
+ *      pthread_rwlockattr_init()
+ *      pthread_rwlockattr_destroy()
+ *      pthread_rwlockattr_setkind_np()
+ *      pthread_rwlockattr_getkind_np()
+ *      pthread_rwlock_init()
+ *      pthread_rwlock_destroy()
+ *      pthread_rwlock_rdlock()
+ *      pthread_rwlock_tryrdlock()
+ *      pthread_rwlock_timedrdlock()
+ *      pthread_rwlock_wrlock()
+ *      pthread_rwlock_trywrlock()
+ *      pthread_rwlock_timedwrlock()
+ *      pthread_rwlock_unlock()
+ */
+
+#include "test.h"
+
+enum {
+  NUMREADERS = 6,
+  NUMWRITERS = 2,
+  ITERATIONS = 5000
+};
+
+static pthread_rwlock_t rwlock;
+static struct timespec abstime = { 0, 0 };
+static int pair[2];
+static int writes;
+
+void * reader(void * arg)
+{
+  int i;
+  int how = (int)(size_t)arg;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      if (how == 0)
+        {
+          assert(pthread_rwlock_rdlock(&rwlock) == 0);
+        }
+      else if (how == 1)
+        {
+          assert(pthread_rwlock_timedrdlock(&rwlock, &abstime) == 0);
+        }
+      else
+        {
+          int result;
+
+          while ((result = pthread_rwlock_tryrdlock(&rwlock)) == EBUSY)
+            {
+              sched_yield();
+            }
+          assert(result == 0);
+        }
+      assert(pair[0] == pair[1]);
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *) 555;
+}
+
+void * writer(void * arg)
+{
+  int i;
+  int how = (int)(size_t)arg;
+
+  for (i = 0; i < ITERATIONS / 10; i++)
+    {
+      if (how == 0)
+        {
+          assert(pthread_rwlock_wrlock(&rwlock) == 0);
+        }
+      else
+        {
+          assert(pthread_rwlock_timedwrlock(&rwlock, &abstime) == 0);
+        }
+      pair[0]++;
+      sched_yield();
+      pair[1]++;
+      writes++;
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *) 555;
+}
+
+void * onewriter(void * arg)
+{
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  return (void *) 555;
+}
+
+void * timedreader(void * arg)
+{
+  struct timespec soon = { 0, 0 };
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+
+  PTW32_FTIME(&currSysTime);
+
+  soon.tv_sec = (long)currSysTime.time;
+  soon.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+
+  soon.tv_nsec += 100 * NANOSEC_PER_MILLISEC;
+  soon.tv_sec += soon.tv_nsec / 1000000000;
+  soon.tv_nsec %= 1000000000;
+
+  assert(pthread_rwlock_timedrdlock(&rwlock, &soon) == ETIMEDOUT);
+  assert(pthread_rwlock_timedwrlock(&rwlock, &soon) == ETIMEDOUT);
+
+  return (void *) 555;
+}
+
+static void
+runTest (int kind)
+{
+  pthread_t r[NUMREADERS];
+  pthread_t w[NUMWRITERS];
+  pthread_t t;
+  pthread_rwlockattr_t rwa;
+  void* result = (void*)0;
+  int k = -1;
+  int i;
+
+  assert(pthread_rwlockattr_init(&rwa) == 0);
+  assert(pthread_rwlockattr_setkind_np(&rwa, kind) == 0);
+  assert(pthread_rwlockattr_getkind_np(&rwa, &k) == 0);
+  assert(k == kind);
+  assert(pthread_rwlock_init(&rwlock, &rwa) == 0);
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+
+  /* A waiting writer holds off new readers unless they are preferred. */
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  assert(pthread_create(&t, NULL, onewriter, NULL) == 0);
+  Sleep(200);
+  if (kind == PTHREAD_RWLOCK_PREFER_READER_NP)
+    {
+      assert(pthread_rwlock_tryrdlock(&rwlock) == 0);
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+  else
+    {
+      assert(pthread_rwlock_tryrdlock(&rwlock) == EBUSY);
+    }
+  assert(pthread_rwlock_destroy(&rwlock) == EBUSY);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert((int)(size_t)result == 555);
+
+  /* Timed calls time out while a writer holds the lock. */
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  assert(pthread_rwlock_trywrlock(&rwlock) == EBUSY);
+  assert(pthread_rwlock_tryrdlock(&rwlock) == EBUSY);
+  assert(pthread_create(&t, NULL, timedreader, NULL) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert((int)(size_t)result == 555);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == EPERM);
+
+  pair[0] = pair[1] = writes = 0;
+
+  for (i = 0; i < NUMWRITERS; i++)
+    {
+      assert(pthread_create(&w[i], NULL, writer, (void *)(size_t)(i & 1)) == 0);
+    }
+
+  for (i = 0; i < NUMREADERS; i++)
+    {
+      assert(pthread_create(&r[i], NULL, reader, (void *)(size_t)(i % 3)) == 0);
+    }
+
+  for (i = 0; i < NUMREADERS; i++)
+    {
+      assert(pthread_join(r[i], &result) == 0);
+      assert((int)(size_t)result == 555);
+    }
+
+  for (i = 0; i < NUMWRITERS; i++)
+    {
+      assert(pthread_join(w[i], &result) == 0);
+      assert((int)(size_t)result == 555);
+    }
+
+  assert(writes == NUMWRITERS * (ITERATIONS / 10));
+  assert(pair[0] == writes && pair[1] == writes);
+
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+}
+
+int
+main()
+{
+  pthread_rwlockattr_t rwa;
+  int kind = -1;
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+
+  PTW32_FTIME(&currSysTime);
+
+  abstime.tv_sec = (long)currSysTime.time;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+
+  abstime.tv_sec += 60;
+
+  assert(pthread_rwlockattr_init(&rwa) == 0);
+  assert(pthread_rwlockattr_getkind_np(&rwa, &kind) == 0);
+  assert(kind == PTHREAD_RWLOCK_DEFAULT_NP);
+  assert(pthread_rwlockattr_setkind_np(&rwa, -1) == EINVAL);
+  assert(pthread_rwlockattr_setkind_np(&rwa, PTHREAD_RWLOCK_PHASE_FAIR_NP + 1) == EINVAL);
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+
+  runTest(PTHREAD_RWLOCK_PREFER_READER_NP);
+  runTest(PTHREAD_RWLOCK_PREFER_WRITER_NP);
+  runTest(PTHREAD_RWLOCK_PHASE_FAIR_NP);
+
+  return 0;
+}
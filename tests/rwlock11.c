@@ -0,0 +1,185 @@
+/* 
+ * rwlock11.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Tests read/write lock downgrade and upgrade.
+ * A writer that downgrades lets readers in but not writers; an
+ * upgradable reader shares the lock with readers but not with another
+ * upgradable reader, and upgrading waits for the other readers to
+ * leave. The default kind can't be upgraded.
+ *
+ * Depends on API functions: 
+ *      pthread_create()
+ *      pthread_join()
+ *      pthread_rwlockattr_setkind_np()
+ *      pthread_rwlock_rdlock_upgradable_np()
+ *      pthread_rwlock_tryrdlock_upgradable_np()
+ *      pthread_rwlock_upgrade_np()
+ *      pthread_rwlock_downgrade_np()
+ */
+
+#include "test.h"
+
+static pthread_rwlock_t rwlock;
+static volatile LONG readerIn = 0;
+static volatile LONG readerOut = 0;
+
+static void *
+tryrd(void * arg)
+{
+  int result = pthread_rwlock_tryrdlock(&rwlock);
+
+  if (result == 0)
+    {
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *)(size_t) result;
+}
+
+static void *
+trywr(void * arg)
+{
+  int result = pthread_rwlock_trywrlock(&rwlock);
+
+  if (result == 0)
+    {
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *)(size_t) result;
+}
+
+static void *
+tryup(void * arg)
+{
+  int result = pthread_rwlock_tryrdlock_upgradable_np(&rwlock);
+
+  if (result == 0)
+    {
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *)(size_t) result;
+}
+
+static void *
+reader(void * arg)
+{
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  InterlockedExchange((LPLONG)&readerIn, 1);
+  Sleep(200);
+  InterlockedExchange((LPLONG)&readerOut, 1);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  return NULL;
+}
+
+static int
+other(void * (*func)(void *))
+{
+  pthread_t t;
+  void * result;
+
+  assert(pthread_create(&t, NULL, func, NULL) == 0);
+  assert(pthread_join(t, &result) == 0);
+
+  return (int)(size_t) result;
+}
+
+int
+main()
+{
+  pthread_rwlockattr_t ra;
+  pthread_t t;
+  int result;
+
+  /* Default kind: downgrade unless built on an SRW lock, no upgrade */
+  assert(pthread_rwlock_init(&rwlock, NULL) == 0);
+  result = pthread_rwlock_downgrade_np(&rwlock);
+  assert(result == EPERM || result == ENOTSUP);
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  result = pthread_rwlock_downgrade_np(&rwlock);
+  assert(result == 0 || result == ENOTSUP);
+  if (result == 0)
+    {
+      assert(other(tryrd) == 0);
+      assert(other(trywr) == EBUSY);
+    }
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_rwlock_rdlock_upgradable_np(&rwlock) == ENOTSUP);
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  assert(pthread_rwlockattr_init(&ra) == 0);
+  assert(pthread_rwlockattr_setkind_np(&ra, PTHREAD_RWLOCK_PREFER_WRITER_NP) == 0);
+  assert(pthread_rwlock_init(&rwlock, &ra) == 0);
+  assert(pthread_rwlockattr_destroy(&ra) == 0);
+
+  assert(pthread_rwlock_downgrade_np(&rwlock) == EPERM);
+  assert(pthread_rwlock_upgrade_np(&rwlock) == EPERM);
+
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  assert(pthread_rwlock_downgrade_np(&rwlock) == 0);
+  assert(other(tryrd) == 0);
+  assert(other(trywr) == EBUSY);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  assert(pthread_rwlock_rdlock_upgradable_np(&rwlock) == 0);
+  assert(pthread_rwlock_rdlock_upgradable_np(&rwlock) == EDEADLK);
+  assert(other(tryrd) == 0);
+  assert(other(tryup) == EBUSY);
+  assert(other(trywr) == EBUSY);
+
+  /* Upgrading waits for a reader already inside */
+  assert(pthread_create(&t, NULL, reader, NULL) == 0);
+  while (!readerIn)
+    {
+      Sleep(10);
+    }
+  assert(pthread_rwlock_upgrade_np(&rwlock) == 0);
+  assert(readerOut);
+  assert(pthread_join(t, NULL) == 0);
+  assert(other(tryrd) == EBUSY);
+
+  assert(pthread_rwlock_downgrade_np(&rwlock) == 0);
+  assert(other(tryrd) == 0);
+  assert(other(tryup) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  assert(pthread_rwlock_trywrlock(&rwlock) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  return 0;
+}
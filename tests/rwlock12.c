@@ -0,0 +1,190 @@
+/* 
+ * rwlock12.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Tests the try-lock paths of the preference policy kinds, which take
+ * the lock word without the internal state lock: a tried lock
+ * excludes as a waited for one does, and try-locks racing with
+ * blocking lockers, unlocks and grants keep readers and writers apart.
+ *
+ * Depends on API functions: 
+ *      pthread_create()
+ *      pthread_join()
+ *      pthread_rwlockattr_setkind_np()
+ *      pthread_rwlock_tryrdlock()
+ *      pthread_rwlock_trywrlock()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4,
+  ITERATIONS = 20000
+};
+
+static pthread_rwlock_t rwlock;
+static volatile LONG readers = 0;
+static volatile LONG writers = 0;
+
+static void
+reading(void)
+{
+  (void) InterlockedIncrement(&readers);
+  assert(writers == 0);
+  (void) InterlockedDecrement(&readers);
+}
+
+static void
+writing(void)
+{
+  assert(InterlockedIncrement(&writers) == 1);
+  assert(readers == 0);
+  (void) InterlockedDecrement(&writers);
+}
+
+static void *
+worker(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      switch ((i + (int)(size_t) arg) % 4)
+	{
+	case 0:
+	  if (pthread_rwlock_tryrdlock(&rwlock) == 0)
+	    {
+	      reading();
+	      assert(pthread_rwlock_unlock(&rwlock) == 0);
+	    }
+	  break;
+	case 1:
+	  if (pthread_rwlock_trywrlock(&rwlock) == 0)
+	    {
+	      writing();
+	      assert(pthread_rwlock_unlock(&rwlock) == 0);
+	    }
+	  break;
+	case 2:
+	  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+	  reading();
+	  assert(pthread_rwlock_unlock(&rwlock) == 0);
+	  break;
+	case 3:
+	  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+	  writing();
+	  assert(pthread_rwlock_unlock(&rwlock) == 0);
+	  break;
+	}
+    }
+
+  return NULL;
+}
+
+static void *
+trywr(void * arg)
+{
+  return (void *)(size_t) pthread_rwlock_trywrlock(&rwlock);
+}
+
+static void *
+tryrd(void * arg)
+{
+  int result = pthread_rwlock_tryrdlock(&rwlock);
+
+  if (result == 0)
+    {
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *)(size_t) result;
+}
+
+static int
+other(void * (*routine)(void *))
+{
+  pthread_t t;
+  void * result;
+
+  assert(pthread_create(&t, NULL, routine, NULL) == 0);
+  assert(pthread_join(t, &result) == 0);
+
+  return (int)(size_t) result;
+}
+
+int
+main()
+{
+  static const int kinds[] = {
+    PTHREAD_RWLOCK_PREFER_READER_NP,
+    PTHREAD_RWLOCK_PREFER_WRITER_NP,
+    PTHREAD_RWLOCK_PHASE_FAIR_NP
+  };
+  pthread_rwlockattr_t ra;
+  pthread_t t[NUMTHREADS];
+  int k;
+  int i;
+
+  for (k = 0; k < (int) (sizeof(kinds) / sizeof(kinds[0])); k++)
+    {
+      assert(pthread_rwlockattr_init(&ra) == 0);
+      assert(pthread_rwlockattr_setkind_np(&ra, kinds[k]) == 0);
+      assert(pthread_rwlock_init(&rwlock, &ra) == 0);
+      assert(pthread_rwlockattr_destroy(&ra) == 0);
+
+      assert(pthread_rwlock_tryrdlock(&rwlock) == 0);
+      assert(other(tryrd) == 0);
+      assert(other(trywr) == EBUSY);
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+      assert(pthread_rwlock_trywrlock(&rwlock) == 0);
+      assert(other(tryrd) == EBUSY);
+      assert(other(trywr) == EBUSY);
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+      for (i = 0; i < NUMTHREADS; i++)
+	{
+	  assert(pthread_create(&t[i], NULL, worker, (void *)(size_t) i) == 0);
+	}
+
+      for (i = 0; i < NUMTHREADS; i++)
+	{
+	  assert(pthread_join(t[i], NULL) == 0);
+	}
+
+      assert(pthread_rwlock_destroy(&rwlock) == 0);
+    }
+
+  return 0;
+}
@@ -0,0 +1,197 @@
+/* 
+ * rwlock9.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Tests read/write locks with distributed reader counters.
+ * Readers check that the two halves of a shared pair are equal while
+ * writers update them, using the plain, try and timed lock calls.
+ *
+ * Depends on API functions: 
+ *      pthread_create()
+ *      pthread_join()
+ *      pthread_rwlockattr_init()
+ *      pthread_rwlockattr_destroy()
+ *      pthread_rwlockattr_setdistributed_np()
+ *      pthread_rwlockattr_getdistributed_np()
+ *      pthread_rwlock_init()
+ *      pthread_rwlock_destroy()
+ *      pthread_rwlock_rdlock()
+ *      pthread_rwlock_tryrdlock()
+ *      pthread_rwlock_timedrdlock()
+ *      pthread_rwlock_wrlock()
+ *      pthread_rwlock_trywrlock()
+ *      pthread_rwlock_timedwrlock()
+ *      pthread_rwlock_unlock()
+ */
+
+#include "test.h"
+
+enum {
+  NUMREADERS = 6,
+  NUMWRITERS = 2,
+  ITERATIONS = 5000
+};
+
+static pthread_rwlock_t rwlock;
+static struct timespec abstime = { 0, 0 };
+static int pair[2];
+static int writes;
+
+void * reader(void * arg)
+{
+  int i;
+  int how = (int)(size_t)arg;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      if (how == 0)
+        {
+          assert(pthread_rwlock_rdlock(&rwlock) == 0);
+        }
+      else if (how == 1)
+        {
+          assert(pthread_rwlock_timedrdlock(&rwlock, &abstime) == 0);
+        }
+      else
+        {
+          int result;
+
+          while ((result = pthread_rwlock_tryrdlock(&rwlock)) == EBUSY)
+            {
+              sched_yield();
+            }
+          assert(result == 0);
+        }
+      assert(pair[0] == pair[1]);
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *) 555;
+}
+
+void * writer(void * arg)
+{
+  int i;
+  int timed = (int)(size_t)arg;
+
+  for (i = 0; i < ITERATIONS / 10; i++)
+    {
+      if (timed)
+        {
+          assert(pthread_rwlock_timedwrlock(&rwlock, &abstime) == 0);
+        }
+      else
+        {
+          assert(pthread_rwlock_wrlock(&rwlock) == 0);
+        }
+      pair[0]++;
+      sched_yield();
+      pair[1]++;
+      writes++;
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *) 555;
+}
+
+int
+main()
+{
+  pthread_t r[NUMREADERS];
+  pthread_t w[NUMWRITERS];
+  pthread_rwlockattr_t rwa;
+  void* result = (void*)0;
+  int distributed = -1;
+  int i;
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+
+  PTW32_FTIME(&currSysTime);
+
+  abstime.tv_sec = (long)currSysTime.time;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+
+  abstime.tv_sec += 60;
+
+  assert(pthread_rwlockattr_init(&rwa) == 0);
+  assert(pthread_rwlockattr_getdistributed_np(&rwa, &distributed) == 0);
+  assert(distributed == 0);
+  assert(pthread_rwlockattr_setdistributed_np(&rwa, 2) == EINVAL);
+  assert(pthread_rwlockattr_setdistributed_np(&rwa, 1) == 0);
+  assert(pthread_rwlockattr_getdistributed_np(&rwa, &distributed) == 0);
+  assert(distributed == 1);
+
+  assert(pthread_rwlock_init(&rwlock, &rwa) == 0);
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+
+  /* Exclusion between readers and writers when uncontended. */
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  assert(pthread_rwlock_tryrdlock(&rwlock) == 0);
+  assert(pthread_rwlock_trywrlock(&rwlock) == EBUSY);
+  assert(pthread_rwlock_destroy(&rwlock) == EBUSY);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  assert(pthread_rwlock_tryrdlock(&rwlock) == EBUSY);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  for (i = 0; i < NUMWRITERS; i++)
+    {
+      assert(pthread_create(&w[i], NULL, writer, (void *)(size_t)(i & 1)) == 0);
+    }
+
+  for (i = 0; i < NUMREADERS; i++)
+    {
+      assert(pthread_create(&r[i], NULL, reader, (void *)(size_t)(i % 3)) == 0);
+    }
+
+  for (i = 0; i < NUMREADERS; i++)
+    {
+      assert(pthread_join(r[i], &result) == 0);
+      assert((int)(size_t)result == 555);
+    }
+
+  for (i = 0; i < NUMWRITERS; i++)
+    {
+      assert(pthread_join(w[i], &result) == 0);
+      assert((int)(size_t)result == 555);
+    }
+
+  assert(writes == NUMWRITERS * (ITERATIONS / 10));
+  assert(pair[0] == writes && pair[1] == writes);
+
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  return 0;
+}
@@ -0,0 +1,169 @@
+/* 
+ * rwspin1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Readers of data under a reader-writer spin lock always see it
+ * consistent while writers keep changing it; readers share the lock,
+ * writers have it alone, and a static lock is set up on first use.
+ *
+ * Depends on API functions:
+ *	pthread_rwspin_init_np()
+ *	pthread_rwspin_destroy_np()
+ *	pthread_rwspin_rdlock_np()
+ *	pthread_rwspin_tryrdlock_np()
+ *	pthread_rwspin_wrlock_np()
+ *	pthread_rwspin_trywrlock_np()
+ *	pthread_rwspin_unlock_np()
+ */
+
+#include "test.h"
+
+enum {
+  NUMREADERS = 3,
+  NUMWRITERS = 2,
+  ITERATIONS = 20000,
+  NUMWORDS = 8
+};
+
+static pthread_rwspinlock_np_t lock = PTHREAD_RWSPINLOCK_INITIALIZER_NP;
+static volatile long data[NUMWORDS];
+static volatile int done = 0;
+
+void *
+writer(void * arg)
+{
+  int i;
+  int j;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_rwspin_wrlock_np(&lock) == 0);
+      for (j = 0; j < NUMWORDS; j++)
+	{
+	  data[j]++;
+	}
+      assert(pthread_rwspin_unlock_np(&lock) == 0);
+    }
+
+  return NULL;
+}
+
+void *
+reader(void * arg)
+{
+  long reads = 0;
+
+  while (!done || reads == 0)
+    {
+      int j;
+
+      assert(pthread_rwspin_rdlock_np(&lock) == 0);
+      for (j = 1; j < NUMWORDS; j++)
+	{
+	  assert(data[j] == data[0]);
+	}
+      assert(pthread_rwspin_unlock_np(&lock) == 0);
+      reads++;
+    }
+
+  return (void *) (size_t) reads;
+}
+
+int
+main()
+{
+  pthread_t r[NUMREADERS];
+  pthread_t w[NUMWRITERS];
+  pthread_rwspinlock_np_t l2;
+  void * result;
+  int i;
+
+  assert(pthread_rwspin_init_np(NULL, PTHREAD_PROCESS_PRIVATE) == EINVAL);
+  assert(pthread_rwspin_init_np(&l2, PTHREAD_PROCESS_SHARED) == ENOSYS);
+  assert(pthread_rwspin_rdlock_np(NULL) == EINVAL);
+  assert(pthread_rwspin_wrlock_np(NULL) == EINVAL);
+
+  assert(pthread_rwspin_init_np(&l2, PTHREAD_PROCESS_PRIVATE) == 0);
+  assert(pthread_rwspin_unlock_np(&l2) == EPERM);
+
+  /* Readers share the lock and keep writers out */
+  assert(pthread_rwspin_rdlock_np(&l2) == 0);
+  assert(pthread_rwspin_tryrdlock_np(&l2) == 0);
+  assert(pthread_rwspin_trywrlock_np(&l2) == EBUSY);
+  assert(pthread_rwspin_destroy_np(&l2) == EINVAL);
+  assert(pthread_rwspin_unlock_np(&l2) == 0);
+  assert(pthread_rwspin_unlock_np(&l2) == 0);
+  assert(pthread_rwspin_unlock_np(&l2) == EPERM);
+
+  /* A writer keeps everyone out */
+  assert(pthread_rwspin_trywrlock_np(&l2) == 0);
+  assert(pthread_rwspin_tryrdlock_np(&l2) == EBUSY);
+  assert(pthread_rwspin_trywrlock_np(&l2) == EBUSY);
+  assert(pthread_rwspin_destroy_np(&l2) == EINVAL);
+  assert(pthread_rwspin_unlock_np(&l2) == 0);
+
+  assert(pthread_rwspin_destroy_np(&l2) == 0);
+  assert(l2 == NULL);
+  assert(pthread_rwspin_destroy_np(&l2) == EINVAL);
+  assert(pthread_rwspin_rdlock_np(&l2) == EINVAL);
+
+  /* An unused static lock can be destroyed */
+  l2 = PTHREAD_RWSPINLOCK_INITIALIZER_NP;
+  assert(pthread_rwspin_destroy_np(&l2) == 0);
+  assert(l2 == NULL);
+
+  for (i = 0; i < NUMREADERS; i++)
+    {
+      assert(pthread_create(&r[i], NULL, reader, NULL) == 0);
+    }
+  for (i = 0; i < NUMWRITERS; i++)
+    {
+      assert(pthread_create(&w[i], NULL, writer, NULL) == 0);
+    }
+  for (i = 0; i < NUMWRITERS; i++)
+    {
+      assert(pthread_join(w[i], NULL) == 0);
+    }
+  done = 1;
+  for (i = 0; i < NUMREADERS; i++)
+    {
+      assert(pthread_join(r[i], &result) == 0);
+      assert((size_t) result > 0);
+    }
+
+  assert(lock != PTHREAD_RWSPINLOCK_INITIALIZER_NP);
+  assert(data[0] == NUMWRITERS * ITERATIONS);
+  assert(pthread_rwspin_destroy_np(&lock) == 0);
+
+  return 0;
+}
@@ -0,0 +1,285 @@
+/*
+ * File: scope1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis:
+ * - Confirm that PTHREAD_SCOPE_PROCESS threads are multiplexed over
+ *   the number of workers set with pthread_setconcurrency, and that
+ *   they yield rather than block in the library's waits.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - pthread_attr_setscope, pthread_attr_getscope
+ * - pthread_setconcurrency
+ *
+ * Features Tested:
+ * -
+ *
+ * Cases Tested:
+ * - with one worker, pairs of threads take turns through a condition
+ *   variable and through semaphores, and a thread joins another;
+ *   each of these deadlocks unless a wait switches to another thread.
+ * - each thread keeps its own key values while others run.
+ * - no more OS threads run them than the concurrency level.
+ * - timed waits time out, and a thread blocked in sem_wait can be
+ *   canceled.
+ *
+ * Description:
+ * -
+ *
+ * Environment:
+ * -
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - PTHREAD_SCOPE_PROCESS is supported, otherwise the test only checks
+ *   for ENOTSUP.
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+	NPAIRS = 8,
+	NTURNS = 50,
+	MAXWORKERS = 2
+};
+
+static pthread_mutex_t mx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cv = PTHREAD_COND_INITIALIZER;
+static pthread_key_t key;
+static pthread_attr_t attr;
+static int turn[NPAIRS];
+static sem_t sems[NPAIRS][2];
+static DWORD workers[NPAIRS * 2 * NTURNS];
+static int nWorkers = 0;
+
+static void
+noteWorker(void)
+{
+  DWORD id = GetCurrentThreadId();
+  int i;
+
+  assert(pthread_mutex_lock(&mx) == 0);
+  for (i = 0; i < nWorkers && workers[i] != id; i++)
+    {
+    }
+  if (i == nWorkers)
+    {
+      workers[nWorkers++] = id;
+    }
+  assert(pthread_mutex_unlock(&mx) == 0);
+}
+
+/*
+ * Threads 2n and 2n+1 take turns, first through the condition
+ * variable and then through their semaphores.
+ */
+void * func(void * arg)
+{
+  int me = (int)(size_t) arg;
+  int pair = me / 2;
+  int side = me % 2;
+  int i;
+
+  assert(pthread_setspecific(key, arg) == 0);
+
+  for (i = 0; i < NTURNS; i++)
+    {
+      assert(pthread_mutex_lock(&mx) == 0);
+      while (turn[pair] != side)
+        {
+          assert(pthread_cond_wait(&cv, &mx) == 0);
+        }
+      turn[pair] = !side;
+      assert(pthread_cond_broadcast(&cv) == 0);
+      assert(pthread_mutex_unlock(&mx) == 0);
+
+      assert(pthread_getspecific(key) == arg);
+      noteWorker();
+      assert(sched_yield() == 0);
+      assert(pthread_getspecific(key) == arg);
+    }
+
+  for (i = 0; i < NTURNS; i++)
+    {
+      if (side == 0)
+        {
+          assert(sem_post(&sems[pair][1]) == 0);
+          assert(sem_wait(&sems[pair][0]) == 0);
+        }
+      else
+        {
+          assert(sem_wait(&sems[pair][1]) == 0);
+          assert(sem_post(&sems[pair][0]) == 0);
+        }
+      assert(pthread_getspecific(key) == arg);
+    }
+
+  return (void *)(size_t) (me + 1);
+}
+
+void * joiner(void * arg)
+{
+  pthread_t t;
+  void * result = NULL;
+
+  assert(pthread_create(&t, &attr, func, arg) == 0);
+  assert(pthread_join(t, &result) == 0);
+  return result;
+}
+
+void * timedwaiter(void * arg)
+{
+  struct timespec abstime;
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+
+  (void) arg;
+  assert(pthread_mutex_lock(&mx) == 0);
+  PTW32_FTIME(&currSysTime);
+  abstime.tv_sec = (long)currSysTime.time;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+  abstime.tv_sec += 1;
+  assert(pthread_cond_timedwait(&cv, &mx, &abstime) == ETIMEDOUT);
+  assert(pthread_mutex_unlock(&mx) == 0);
+  assert(sem_timedwait(&sems[0][0], &abstime) == -1);
+  assert(errno == ETIMEDOUT);
+  return (void *)(size_t) 1;
+}
+
+void * canceled(void * arg)
+{
+  (void) arg;
+  (void) sem_wait(&sems[0][0]);
+  return NULL;
+}
+
+static void
+run(int level)
+{
+  pthread_t t[NPAIRS * 2];
+  void * result = NULL;
+  int i;
+
+  assert(pthread_setconcurrency(level) == 0);
+  assert(pthread_getconcurrency() == level);
+
+  nWorkers = 0;
+  for (i = 0; i < NPAIRS; i++)
+    {
+      turn[i] = 0;
+      assert(sem_init(&sems[i][0], 0, 0) == 0);
+      assert(sem_init(&sems[i][1], 0, 0) == 0);
+    }
+
+  for (i = 0; i < NPAIRS * 2; i++)
+    {
+      /* Some start the thread for their turn and join it */
+      assert(pthread_create(&t[i], &attr, (i % 4 == 0) ? joiner : func,
+                            (void *)(size_t) i) == 0);
+    }
+
+  for (i = 0; i < NPAIRS * 2; i++)
+    {
+      assert(pthread_join(t[i], &result) == 0);
+      assert((int)(size_t) result == i + 1);
+    }
+
+  assert(nWorkers >= 1);
+  assert(nWorkers <= level);
+
+  for (i = 0; i < NPAIRS; i++)
+    {
+      assert(sem_destroy(&sems[i][0]) == 0);
+      assert(sem_destroy(&sems[i][1]) == 0);
+    }
+}
+
+int
+main()
+{
+  pthread_t t;
+  void * result = NULL;
+  int scope;
+
+  assert(pthread_attr_init(&attr) == 0);
+
+  if (pthread_attr_setscope(&attr, PTHREAD_SCOPE_PROCESS) == ENOTSUP)
+    {
+      assert(pthread_attr_getscope(&attr, &scope) == 0);
+      assert(scope == PTHREAD_SCOPE_SYSTEM);
+      assert(pthread_attr_destroy(&attr) == 0);
+      return 0;
+    }
+
+  assert(pthread_attr_getscope(&attr, &scope) == 0);
+  assert(scope == PTHREAD_SCOPE_PROCESS);
+  assert(pthread_key_create(&key, NULL) == 0);
+
+  run(1);
+  run(MAXWORKERS);
+
+  assert(sem_init(&sems[0][0], 0, 0) == 0);
+
+  assert(pthread_create(&t, &attr, timedwaiter, NULL) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert((int)(size_t) result == 1);
+
+  assert(pthread_create(&t, &attr, canceled, NULL) == 0);
+  Sleep(50);
+  assert(pthread_cancel(t) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert(result == PTHREAD_CANCELED);
+
+  assert(sem_destroy(&sems[0][0]) == 0);
+  assert(pthread_key_delete(key) == 0);
+  assert(pthread_attr_destroy(&attr) == 0);
+  assert(pthread_setconcurrency(0) == 0);
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+/* 
+ * self3.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * A Win32 thread that gets an implicit POSIX handle and exits without
+ * calling pthread_win32_thread_detach_np() is detached anyway where
+ * thread exits are seen through FLS: its TSD destructors run.
+ *
+ * Depends on API functions:
+ *	pthread_self()
+ *	pthread_key_create()
+ *	pthread_setspecific()
+ *	pthread_win32_test_features_np()
+ */
+
+#include "test.h"
+
+#include <process.h>
+
+static pthread_key_t key;
+static int destroyed = 0;
+
+static void
+destructor(void * value)
+{
+  assert(value == (void *) &key);
+  destroyed++;
+}
+
+#if ! defined (__MINGW32__) || defined (__MSVCRT__)
+unsigned __stdcall
+#else
+void
+#endif
+Win32thread(void * arg)
+{
+  assert(pthread_self().p != NULL);
+  assert(pthread_setspecific(key, (void *) &key) == 0);
+
+#if ! defined (__MINGW32__) || defined (__MSVCRT__)
+  return 0;
+#endif
+}
+
+int
+main()
+{
+  HANDLE h;
+  unsigned thrAddr;
+
+  assert(pthread_key_create(&key, destructor) == 0);
+
+#if ! defined (__MINGW32__) || defined (__MSVCRT__)
+  h = (HANDLE) _beginthreadex(NULL, 0, Win32thread, NULL, 0, &thrAddr);
+#else
+  h = (HANDLE) _beginthread(Win32thread, 0, NULL);
+#endif
+  assert(h != 0);
+  assert(WaitForSingleObject(h, INFINITE) == WAIT_OBJECT_0);
+  assert(CloseHandle(h));
+
+  if (pthread_win32_test_features_np(PTW32_THREAD_EXIT_FLS))
+    {
+      assert(destroyed == 1);
+    }
+
+  assert(pthread_key_delete(key) == 0);
+
+  return 0;
+}
@@ -0,0 +1,122 @@
+/* 
+ * self4.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * A Win32 thread's implicit POSIX handle gets its Win32 handle and
+ * CPU affinity on demand: another thread can get the handle, signal,
+ * schedule and ask the affinity of the Win32 thread through it.
+ *
+ * Depends on API functions:
+ *	pthread_self()
+ *	pthread_getw32threadhandle_np()
+ *	pthread_kill()
+ *	pthread_getschedparam()
+ *	pthread_setschedparam()
+ *	pthread_getaffinity_np()
+ */
+
+#include "test.h"
+
+#include <process.h>
+
+static pthread_t implicitSelf;
+static volatile LONG started = 0;
+static volatile LONG release = 0;
+
+#if ! defined (__MINGW32__) || defined (__MSVCRT__)
+unsigned __stdcall
+#else
+void
+#endif
+Win32thread(void * arg)
+{
+  implicitSelf = pthread_self();
+  assert(implicitSelf.p != NULL);
+  InterlockedExchange((LPLONG) &started, 1);
+
+  while (0 == InterlockedExchangeAdd((LPLONG) &release, 0))
+    {
+      Sleep(1);
+    }
+
+  assert(pthread_win32_thread_detach_np() == PTW32_TRUE);
+
+#if ! defined (__MINGW32__) || defined (__MSVCRT__)
+  return 0;
+#endif
+}
+
+int
+main()
+{
+  HANDLE h;
+  unsigned thrAddr;
+  int policy;
+  struct sched_param param;
+  cpu_set_t cpuset;
+  int result;
+
+#if ! defined (__MINGW32__) || defined (__MSVCRT__)
+  h = (HANDLE) _beginthreadex(NULL, 0, Win32thread, NULL, 0, &thrAddr);
+#else
+  h = (HANDLE) _beginthread(Win32thread, 0, NULL);
+#endif
+  assert(h != 0);
+
+  while (0 == InterlockedExchangeAdd((LPLONG) &started, 0))
+    {
+      Sleep(1);
+    }
+
+  assert(pthread_getw32threadhandle_np(implicitSelf) != NULL);
+  assert(WaitForSingleObject(pthread_getw32threadhandle_np(implicitSelf), 0) == WAIT_TIMEOUT);
+  assert(pthread_kill(implicitSelf, 0) == 0);
+
+  assert(pthread_getschedparam(implicitSelf, &policy, &param) == 0);
+  assert(pthread_setschedparam(implicitSelf, policy, &param) == 0);
+
+  CPU_ZERO(&cpuset);
+  result = pthread_getaffinity_np(implicitSelf, sizeof(cpuset), &cpuset);
+  assert(result == 0 || result == ENOSYS);
+  if (0 == result)
+    {
+      assert(CPU_COUNT(&cpuset) > 0);
+    }
+
+  InterlockedExchange((LPLONG) &release, 1);
+  assert(WaitForSingleObject(h, INFINITE) == WAIT_OBJECT_0);
+  assert(CloseHandle(h));
+
+  return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * File: semaphore11.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis: Verify sem_init_np() SEM_FIFO_NP semaphores
+ * - 
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - 
+ *
+ * Features Tested:
+ * - 
+ *
+ * Cases Tested:
+ * - invalid flags are rejected.
+ * - waiters are handed units in the order they blocked.
+ * - a post to a queue of waiters can't be taken by sem_trywait().
+ * - a timed out waiter leaves the count as it was.
+ *
+ * Description:
+ * - 
+ *
+ * Environment:
+ * - 
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - 
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+
+#include "test.h"
+
+#define NUMTHREADS 8
+
+static sem_t s;
+static int order[NUMTHREADS];
+static volatile LONG woken = 0;
+
+void *
+waiter(void * arg)
+{
+  int id = (int)(size_t) arg;
+
+  assert(sem_wait(&s) == 0);
+  order[InterlockedIncrement((LPLONG)&woken) - 1] = id;
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  struct timespec reltime = { 0, 50000000 };
+  int value;
+  int i;
+
+  assert(sem_init_np(&s, PTW32_FALSE, 0, ~SEM_FIFO_NP) == EINVAL);
+  assert(sem_init_np(&s, PTW32_FALSE, 0, SEM_FIFO_NP) == 0);
+
+  /* Queue the waiters one at a time so that their order is known */
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, waiter, (void *)(size_t) i) == 0);
+      do
+	{
+	  Sleep(1);
+	  assert(sem_getvalue(&s, &value) == 0);
+	}
+      while (value != -(i + 1));
+    }
+
+  /* The unit goes to the longest waiter, not to us */
+  assert(sem_post(&s) == 0);
+  assert(sem_trywait(&s) == -1);
+  assert(errno == EAGAIN);
+
+  assert(sem_post_multiple(&s, NUMTHREADS - 1) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(order[i] == i);
+    }
+
+  assert(sem_getvalue(&s, &value) == 0);
+  assert(value == 0);
+
+  assert(sem_reltimedwait_np(&s, &reltime) == -1);
+  assert(errno == ETIMEDOUT);
+  assert(sem_getvalue(&s, &value) == 0);
+  assert(value == 0);
+
+  assert(sem_post(&s) == 0);
+  assert(sem_wait(&s) == 0);
+
+  assert(sem_destroy(&s) == 0);
+
+  return 0;
+}
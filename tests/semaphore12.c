@@ -0,0 +1,151 @@
+/*
+ * File: semaphore12.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis: Verify that abandoned waiters don't hold up sem_destroy()
+ * - 
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - 
+ *
+ * Features Tested:
+ * - 
+ *
+ * Cases Tested:
+ * - a waiter that times out stops counting as a waiter.
+ * - a waiter that is cancelled stops counting as a waiter.
+ * - the semaphore can then be destroyed, and its storage reused.
+ *
+ * Description:
+ * - 
+ *
+ * Environment:
+ * - 
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - 
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+
+#include "test.h"
+
+#define NUMTHREADS 4
+
+static sem_t s;
+
+void *
+timedwaiter(void * arg)
+{
+  struct timespec reltime = { 0, 50000000 };
+
+  assert(sem_reltimedwait_np(&s, &reltime) == -1);
+  assert(errno == ETIMEDOUT);
+
+  return NULL;
+}
+
+void *
+waiter(void * arg)
+{
+  (void) sem_wait(&s);
+
+  return (void *)(size_t) 1;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  void * result;
+  int value;
+  int round;
+  int i;
+
+  for (round = 0; round < 2; round++)
+    {
+      assert(sem_init(&s, PTW32_FALSE, 0) == 0);
+
+      for (i = 0; i < NUMTHREADS; i++)
+	{
+	  assert(pthread_create(&t[i], NULL,
+				(i & 1) ? waiter : timedwaiter, NULL) == 0);
+	}
+
+      do
+	{
+	  Sleep(1);
+	  assert(sem_getvalue(&s, &value) == 0);
+	}
+      while (value != -NUMTHREADS);
+
+      assert(sem_destroy(&s) == -1);
+      assert(errno == EBUSY);
+
+      for (i = 1; i < NUMTHREADS; i += 2)
+	{
+	  assert(pthread_cancel(t[i]) == 0);
+	}
+
+      for (i = 0; i < NUMTHREADS; i++)
+	{
+	  assert(pthread_join(t[i], &result) == 0);
+	  assert(result == ((i & 1) ? PTHREAD_CANCELED : NULL));
+	}
+
+      assert(sem_getvalue(&s, &value) == 0);
+      assert(value == 0);
+
+      assert(sem_destroy(&s) == 0);
+    }
+
+  return 0;
+}
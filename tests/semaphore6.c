@@ -0,0 +1,173 @@
+/*
+ * File: semaphore6.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis: Verify that no posts are lost or invented when
+ * waiters time out while posts arrive.
+ * - 
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - 
+ *
+ * Features Tested:
+ * - 
+ *
+ * Cases Tested:
+ * - 
+ *
+ * Description:
+ * - Several threads take units with short sem_timedwait() calls,
+ *   sem_trywait() and sem_wait() while a producer posts a fixed
+ *   number of units. Units taken plus the final value must equal
+ *   units posted.
+ *
+ * Environment:
+ * - 
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - 
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4,
+  POSTS = 20000
+};
+
+static sem_t s;
+static LONG taken = 0;
+static int done = 0;
+
+void *
+thr(void * arg)
+{
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+  int how = (int)(size_t)arg;
+
+  while (!done)
+    {
+      int result;
+
+      if (how == 0)
+        {
+          struct timespec abstime;
+          PTW32_STRUCT_TIMEB currSysTime;
+
+          PTW32_FTIME(&currSysTime);
+          abstime.tv_sec = (long)currSysTime.time;
+          abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+          abstime.tv_nsec += NANOSEC_PER_MILLISEC;
+          abstime.tv_sec += abstime.tv_nsec / 1000000000;
+          abstime.tv_nsec %= 1000000000;
+
+          result = sem_timedwait(&s, &abstime);
+          assert(result == 0 || errno == ETIMEDOUT);
+        }
+      else
+        {
+          result = sem_trywait(&s);
+          assert(result == 0 || errno == EAGAIN);
+        }
+
+      if (result == 0)
+        {
+          InterlockedIncrement(&taken);
+        }
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  int value;
+  int i;
+
+  assert(sem_init(&s, PTHREAD_PROCESS_PRIVATE, 0) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, thr, (void *)(size_t)(i & 1)) == 0);
+    }
+
+  for (i = 0; i < POSTS; i++)
+    {
+      assert(sem_post(&s) == 0);
+      if ((i % 100) == 0)
+        {
+          Sleep(1);
+        }
+    }
+
+  done = 1;
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(sem_getvalue(&s, &value) == 0);
+  assert(value >= 0);
+  assert(taken + value == POSTS);
+
+  /* Drain what's left with the blocking call */
+  while (value-- > 0)
+    {
+      assert(sem_wait(&s) == 0);
+    }
+  assert(sem_trywait(&s) == -1 && errno == EAGAIN);
+
+  assert(sem_destroy(&s) == 0);
+
+  return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * File: semaphore7.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis: Verify sem_post_multiple() and sem_wait_multiple_np()
+ * - 
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - 
+ *
+ * Features Tested:
+ * - 
+ *
+ * Cases Tested:
+ * - 
+ *
+ * Description:
+ * - Batches of units are posted and taken, with and without
+ *   waiting threads.
+ *
+ * Environment:
+ * - 
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - 
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4
+};
+
+static sem_t s;
+
+void *
+waiter(void * arg)
+{
+  assert(sem_wait(&s) == 0);
+
+  return (void *) 555;
+}
+
+void *
+batchwaiter(void * arg)
+{
+  return (void *)(size_t) sem_wait_multiple_np(&s, 4);
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  void* result = (void*)0;
+  int value;
+  int i;
+
+  assert(sem_init(&s, PTHREAD_PROCESS_PRIVATE, 0) == 0);
+
+  assert(sem_wait_multiple_np(&s, 0) == -1 && errno == EINVAL);
+  assert(sem_post_multiple(&s, 0) == -1 && errno == EINVAL);
+
+  /* No waiters */
+  assert(sem_post_multiple(&s, 5) == 0);
+  assert(sem_getvalue(&s, &value) == 0);
+  assert(value == 5);
+  assert(sem_wait_multiple_np(&s, 3) == 3);
+  assert(sem_wait_multiple_np(&s, 10) == 2);
+  assert(sem_trywait(&s) == -1 && errno == EAGAIN);
+
+  /* Release several waiters at once */
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, waiter, NULL) == 0);
+    }
+  Sleep(100);
+  assert(sem_post_multiple(&s, NUMTHREADS + 1) == 0);
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], &result) == 0);
+      assert((int)(size_t)result == 555);
+    }
+  assert(sem_getvalue(&s, &value) == 0);
+  assert(value == 1);
+  assert(sem_wait(&s) == 0);
+
+  /* A batch waiter takes what is posted after it blocks */
+  assert(pthread_create(&t[0], NULL, batchwaiter, NULL) == 0);
+  Sleep(100);
+  assert(sem_post_multiple(&s, 3) == 0);
+  assert(pthread_join(t[0], &result) == 0);
+  assert((int)(size_t)result == 3);
+  assert(sem_getvalue(&s, &value) == 0);
+  assert(value == 0);
+
+  assert(sem_destroy(&s) == 0);
+
+  return 0;
+}
@@ -0,0 +1,169 @@
+/*
+ * File: semaphore8.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis: Verify sem_open(), sem_close() and sem_unlink()
+ * - 
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - 
+ *
+ * Features Tested:
+ * - 
+ *
+ * Cases Tested:
+ * - O_CREAT, O_EXCL, opening an existing semaphore and bad names.
+ * - a semaphore opened by name in another thread is the same
+ *   semaphore.
+ * - an unlinked semaphore stays usable until closed and its name can
+ *   be reused.
+ *
+ * Description:
+ * - 
+ *
+ * Environment:
+ * - 
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - 
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+#include <fcntl.h>
+
+static const char * NAME = "/ptw32-semaphore8";
+
+void * poster(void * arg)
+{
+  sem_t * s = sem_open(NAME, 0);
+
+  assert(s != SEM_FAILED);
+  assert(sem_post(s) == 0);
+  assert(sem_close(s) == 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t;
+  sem_t * s;
+  sem_t * s2;
+  sem_t * s3;
+  int value;
+  char longName[300];
+
+  assert(sem_open(NAME, 0) == SEM_FAILED);
+  assert(errno == ENOENT);
+  assert(sem_open("a/b", O_CREAT, 0600, 0) == SEM_FAILED);
+  assert(errno == EINVAL);
+  assert(sem_open("/", O_CREAT, 0600, 0) == SEM_FAILED);
+  assert(errno == EINVAL);
+  memset(longName, 'n', sizeof(longName) - 1);
+  longName[sizeof(longName) - 1] = '\0';
+  assert(sem_open(longName, O_CREAT, 0600, 0) == SEM_FAILED);
+  assert(errno == ENAMETOOLONG);
+  assert(sem_open(NAME, O_CREAT, 0600, (unsigned int) SEM_VALUE_MAX + 1) == SEM_FAILED);
+  assert(errno == EINVAL);
+
+  s = sem_open(NAME, O_CREAT | O_EXCL, 0600, 1);
+  assert(s != SEM_FAILED);
+  assert(sem_open(NAME, O_CREAT | O_EXCL, 0600, 1) == SEM_FAILED);
+  assert(errno == EEXIST);
+
+  /*
+   * The same name gives the same address, with or without O_CREAT.
+   */
+  assert(sem_open(NAME, O_CREAT, 0600, 5) == s);
+  assert(sem_getvalue(s, &value) == 0);
+  assert(value == 1);
+  assert(sem_close(s) == 0);
+
+  assert(sem_wait(s) == 0);
+  assert(pthread_create(&t, NULL, poster, NULL) == 0);
+  assert(sem_wait(s) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(sem_trywait(s) == -1);
+  assert(errno == EAGAIN);
+  assert(sem_destroy(s) == -1);
+  assert(errno == EINVAL);
+
+  /*
+   * Unlinked: still usable, and the name is free.
+   */
+  assert(sem_unlink(NAME) == 0);
+  assert(sem_unlink(NAME) == -1);
+  assert(errno == ENOENT);
+  assert(sem_open(NAME, 0) == SEM_FAILED);
+  assert(errno == ENOENT);
+  s2 = sem_open(NAME, O_CREAT | O_EXCL, 0600, 2);
+  assert(s2 != SEM_FAILED);
+  assert(s2 != s);
+  assert(sem_post(s) == 0);
+  assert(sem_getvalue(s, &value) == 0);
+  assert(value == 1);
+  assert(sem_getvalue(s2, &value) == 0);
+  assert(value == 2);
+
+  assert(sem_close(s) == 0);
+  assert(sem_close(s) == -1);
+  assert(errno == EINVAL);
+
+  s3 = sem_open(NAME, 0);
+  assert(s3 == s2);
+  assert(sem_close(s3) == 0);
+  assert(sem_unlink(NAME) == 0);
+  assert(sem_close(s2) == 0);
+
+  return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * File: semaphore9.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis: Verify sem_destroy() straight after sem_post()
+ * - 
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - 
+ *
+ * Features Tested:
+ * - 
+ *
+ * Cases Tested:
+ * - a semaphore can be destroyed as soon as the post that wakes its
+ *   last waiter returns, and the woken waiter returns normally.
+ * - the same for sem_timedwait().
+ *
+ * Description:
+ * - 
+ *
+ * Environment:
+ * - 
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - 
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+
+#include "test.h"
+
+enum {
+  ITERATIONS = 1000
+};
+
+static sem_t sem;
+static sem_t ready;
+static int timed;
+
+static void *
+waiter(void * arg)
+{
+  struct timespec abstime = { 0, 0 };
+
+  assert(sem_post(&ready) == 0);
+
+  if (timed)
+    {
+      abstime.tv_sec = (long) time(NULL) + 60;
+      assert(sem_timedwait(&sem, &abstime) == 0);
+    }
+  else
+    {
+      assert(sem_wait(&sem) == 0);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t;
+  int i;
+  int value;
+
+  assert(sem_init(&ready, 0, 0) == 0);
+
+  for (timed = 0; timed < 2; timed++)
+    {
+      for (i = 0; i < ITERATIONS; i++)
+        {
+          assert(sem_init(&sem, 0, 0) == 0);
+          assert(pthread_create(&t, NULL, waiter, NULL) == 0);
+          assert(sem_wait(&ready) == 0);
+
+          /* Wait until the waiter is blocked */
+          do
+            {
+              assert(sem_getvalue(&sem, &value) == 0);
+              if (value >= 0)
+                {
+                  sched_yield();
+                }
+            }
+          while (value >= 0);
+
+          assert(sem_post(&sem) == 0);
+          assert(sem_destroy(&sem) == 0);
+          assert(pthread_join(t, NULL) == 0);
+        }
+    }
+
+  assert(sem_destroy(&ready) == 0);
+
+  return 0;
+}
@@ -0,0 +1,168 @@
+/* 
+ * seqlock1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Readers of data under a sequence lock never accept a torn copy
+ * while writers keep changing it, and a held write lock makes
+ * read_retry fail and destroy return EBUSY.
+ *
+ * Depends on API functions:
+ *	pthread_seqlock_init_np()
+ *	pthread_seqlock_destroy_np()
+ *	pthread_seqlock_read_begin_np()
+ *	pthread_seqlock_read_retry_np()
+ *	pthread_seqlock_write_lock_np()
+ *	pthread_seqlock_write_unlock_np()
+ */
+
+#include "test.h"
+
+enum {
+  NUMREADERS = 3,
+  NUMWRITERS = 2,
+  ITERATIONS = 20000,
+  NUMWORDS = 8
+};
+
+static pthread_seqlock_np_t lock;
+static volatile long data[NUMWORDS];
+static volatile int done = 0;
+
+void *
+writer(void * arg)
+{
+  int i;
+  int j;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_seqlock_write_lock_np(lock) == 0);
+      for (j = 0; j < NUMWORDS; j++)
+	{
+	  data[j]++;
+	}
+      assert(pthread_seqlock_write_unlock_np(lock) == 0);
+    }
+
+  return NULL;
+}
+
+void *
+reader(void * arg)
+{
+  long reads = 0;
+
+  while (!done || reads == 0)
+    {
+      long copy[NUMWORDS];
+      unsigned int seq;
+      int j;
+
+      do
+	{
+	  assert(pthread_seqlock_read_begin_np(lock, &seq) == 0);
+	  assert((seq & 1) == 0);
+	  for (j = 0; j < NUMWORDS; j++)
+	    {
+	      copy[j] = data[j];
+	    }
+	}
+      while (pthread_seqlock_read_retry_np(lock, seq) != 0);
+
+      for (j = 1; j < NUMWORDS; j++)
+	{
+	  assert(copy[j] == copy[0]);
+	}
+      reads++;
+    }
+
+  return (void *) (size_t) reads;
+}
+
+int
+main()
+{
+  pthread_t r[NUMREADERS];
+  pthread_t w[NUMWRITERS];
+  pthread_seqlock_np_t l2;
+  unsigned int seq;
+  void * result;
+  int i;
+
+  assert(pthread_seqlock_init_np(NULL) == EINVAL);
+  assert(pthread_seqlock_read_begin_np(NULL, &seq) == EINVAL);
+  assert(pthread_seqlock_write_lock_np(NULL) == EINVAL);
+
+  assert(pthread_seqlock_init_np(&l2) == 0);
+  assert(pthread_seqlock_read_begin_np(l2, NULL) == EINVAL);
+  assert(pthread_seqlock_read_begin_np(l2, &seq) == 0);
+  assert(pthread_seqlock_read_retry_np(l2, seq) == 0);
+
+  /* A write between begin and retry forces a retry */
+  assert(pthread_seqlock_write_lock_np(l2) == 0);
+  assert(pthread_seqlock_read_retry_np(l2, seq) == EAGAIN);
+  assert(pthread_seqlock_destroy_np(&l2) == EBUSY);
+  assert(pthread_seqlock_write_unlock_np(l2) == 0);
+  assert(pthread_seqlock_read_retry_np(l2, seq) == EAGAIN);
+  assert(pthread_seqlock_read_begin_np(l2, &seq) == 0);
+  assert(pthread_seqlock_read_retry_np(l2, seq) == 0);
+  assert(pthread_seqlock_destroy_np(&l2) == 0);
+  assert(l2 == NULL);
+  assert(pthread_seqlock_destroy_np(&l2) == EINVAL);
+
+  assert(pthread_seqlock_init_np(&lock) == 0);
+
+  for (i = 0; i < NUMREADERS; i++)
+    {
+      assert(pthread_create(&r[i], NULL, reader, NULL) == 0);
+    }
+  for (i = 0; i < NUMWRITERS; i++)
+    {
+      assert(pthread_create(&w[i], NULL, writer, NULL) == 0);
+    }
+  for (i = 0; i < NUMWRITERS; i++)
+    {
+      assert(pthread_join(w[i], NULL) == 0);
+    }
+  done = 1;
+  for (i = 0; i < NUMREADERS; i++)
+    {
+      assert(pthread_join(r[i], &result) == 0);
+      assert((size_t) result > 0);
+    }
+
+  assert(data[0] == NUMWRITERS * ITERATIONS);
+  assert(pthread_seqlock_destroy_np(&lock) == 0);
+
+  return 0;
+}
@@ -0,0 +1,167 @@
+/* 
+ * slab1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * --------------------------------------------------------------------------
+ * Churn of synchronisation and attribute objects, including objects
+ * destroyed by a thread other than the one that initialised them and
+ * threads that end with freed objects still cached, leaves every
+ * object usable. A mutex destroyed and initialised again by the same
+ * thread reuses the same block.
+ *
+ * Depends on API functions:
+ *	pthread_mutex_init()
+ *	pthread_cond_init()
+ *	pthread_rwlock_init()
+ *	sem_init()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4,
+  ITERATIONS = 2000,
+  NUMHANDOFF = 100
+};
+
+static pthread_mutex_t handoff[NUMTHREADS][NUMHANDOFF];
+
+void *
+churn(void * arg)
+{
+  int id = (int) (size_t) arg;
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      pthread_mutex_t mx[3];
+      pthread_mutexattr_t ma;
+      pthread_cond_t cv;
+      pthread_rwlock_t rwl;
+      sem_t s;
+      int j;
+
+      assert(pthread_mutexattr_init(&ma) == 0);
+      assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_RECURSIVE) == 0);
+      for (j = 0; j < 3; j++)
+	{
+	  assert(pthread_mutex_init(&mx[j], (j == 1) ? &ma : NULL) == 0);
+	}
+      assert(pthread_mutexattr_destroy(&ma) == 0);
+      assert(pthread_cond_init(&cv, NULL) == 0);
+      assert(pthread_rwlock_init(&rwl, NULL) == 0);
+      assert(sem_init(&s, 0, 0) == 0);
+
+      assert(mx[0] != mx[1] && mx[1] != mx[2] && mx[0] != mx[2]);
+      assert(pthread_mutex_lock(&mx[1]) == 0);
+      assert(pthread_mutex_lock(&mx[1]) == 0);
+      assert(pthread_mutex_unlock(&mx[1]) == 0);
+      assert(pthread_mutex_unlock(&mx[1]) == 0);
+      assert(pthread_rwlock_rdlock(&rwl) == 0);
+      assert(pthread_rwlock_unlock(&rwl) == 0);
+      assert(sem_post(&s) == 0);
+      assert(sem_wait(&s) == 0);
+
+      assert(sem_destroy(&s) == 0);
+      assert(pthread_rwlock_destroy(&rwl) == 0);
+      assert(pthread_cond_destroy(&cv) == 0);
+      for (j = 0; j < 3; j++)
+	{
+	  assert(pthread_mutex_destroy(&mx[j]) == 0);
+	}
+    }
+
+  /* Left for main to destroy */
+  for (i = 0; i < NUMHANDOFF; i++)
+    {
+      assert(pthread_mutex_init(&handoff[id][i], NULL) == 0);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  pthread_mutex_t mx;
+  pthread_mutex_t old;
+  int i;
+  int j;
+
+  assert(pthread_mutex_init(&mx, NULL) == 0);
+  old = mx;
+  assert(pthread_mutex_destroy(&mx) == 0);
+  assert(pthread_mutex_init(&mx, NULL) == 0);
+  assert(mx == old);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, churn, (void *) (size_t) i) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      for (j = 0; j < NUMHANDOFF; j++)
+	{
+	  assert(pthread_mutex_lock(&handoff[i][j]) == 0);
+	  assert(pthread_mutex_unlock(&handoff[i][j]) == 0);
+	  assert(pthread_mutex_destroy(&handoff[i][j]) == 0);
+	}
+    }
+
+  /* Run the threads again on the blocks the first ones freed */
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, churn, (void *) (size_t) i) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      for (j = 0; j < NUMHANDOFF; j++)
+	{
+	  assert(pthread_mutex_destroy(&handoff[i][j]) == 0);
+	}
+    }
+
+  return 0;
+}
@@ -0,0 +1,460 @@
+/*
+ * soak1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * --------------------------------------------------------------------------
+ *
+ * Soak the library for as long as asked, derived from stress1.c.
+ *
+ * Usage: soak1 [seconds [interval [pairs]]]
+ *
+ * Runs 'pairs' (by default one per two processors, at least two) master
+ * and slave threads for 'seconds' (SECONDS), alternately over a
+ * condition variable and its mutex, and over a semaphore. As in
+ * stress1, each master feels for the moment the slave's timed wait is
+ * due to time out, keeping timeouts and signals taken close to 1:1,
+ * but here the timeout is TIMEOUT_MS and the master spins rather than
+ * sleeps, so the pairs hand off about a thousand times a second each.
+ *
+ * Every 'interval' seconds (INTERVAL) prints one line of:
+ *
+ * - handoffs/s  signals and posts taken per second
+ * - timeouts/s  timed waits that timed out per second
+ * - p50 p99 p999 max  wakeup latency in nanoseconds, from just before
+ *               the master signals or posts to the slave's return from
+ *               the wait, as the upper bound of a power of two bucket
+ * - handles     process handles (GetProcessHandleCount)
+ * - commit      private bytes committed
+ * - kernel      kernel objects the library holds (pthread_getlibstats_np)
+ *
+ * and at the end the drift of each between the first and last
+ * intervals. Falling throughput, growing latency or growing handles,
+ * commit or kernel objects over a long run point at a leak or at
+ * accounting that degrades, such as a condition variable's waiter
+ * counts. As stress1 does, the condition variables, mutexes and
+ * semaphores must then destroy cleanly.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#define SECONDS		60
+#define INTERVAL	10
+#define TIMEOUT_MS	1
+#define HIST_BUCKETS	40	/* Powers of two of nanoseconds */
+
+enum {
+  KIND_COND,
+  KIND_SEM,
+  KINDS
+};
+
+/* As PROCESS_MEMORY_COUNTERS_EX, which not every psapi.h has */
+typedef struct {
+  DWORD cb;
+  DWORD PageFaultCount;
+  SIZE_T PeakWorkingSetSize;
+  SIZE_T WorkingSetSize;
+  SIZE_T QuotaPeakPagedPoolUsage;
+  SIZE_T QuotaPagedPoolUsage;
+  SIZE_T QuotaPeakNonPagedPoolUsage;
+  SIZE_T QuotaNonPagedPoolUsage;
+  SIZE_T PagefileUsage;
+  SIZE_T PeakPagefileUsage;
+  SIZE_T PrivateUsage;
+} memory_counters_t;
+
+typedef BOOL (WINAPI * memory_info_t)(HANDLE, memory_counters_t *, DWORD);
+typedef BOOL (WINAPI * handle_count_t)(HANDLE, PDWORD);
+
+static memory_info_t memoryInfo = NULL;
+static handle_count_t handleCount = NULL;
+
+typedef struct {
+  int kind;
+  pthread_mutex_t mx;
+  pthread_cond_t cv;
+  sem_t sem;
+  pthread_t master;
+  pthread_t slave;
+  volatile LONG sent;
+  volatile LONG taken;
+  volatile __int64 sentAt;
+  volatile LONG timeouts;
+  volatile LONG hist[HIST_BUCKETS];
+} pair_t;
+
+typedef struct {
+  __int64 handoffs;
+  __int64 timeouts;
+  __int64 hist[HIST_BUCKETS];
+  __int64 handles;
+  __int64 commit;
+  __int64 kernel;
+} sample_t;
+
+static volatile int allExit = 0;
+
+static __int64
+now(void)
+{
+  struct timespec ts;
+
+  assert(clock_gettime(CLOCK_MONOTONIC, &ts) == 0);
+
+  return (__int64) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static struct timespec *
+timeoutFromNow(struct timespec * abstime)
+{
+  assert(clock_gettime(CLOCK_REALTIME, abstime) == 0);
+  abstime->tv_nsec += TIMEOUT_MS * 1000000L;
+  if (abstime->tv_nsec >= 1000000000L)
+    {
+      abstime->tv_sec++;
+      abstime->tv_nsec -= 1000000000L;
+    }
+
+  return abstime;
+}
+
+static void
+record(pair_t * pair)
+{
+  __int64 latency = now() - pair->sentAt;
+  int b = 0;
+
+  while (b < HIST_BUCKETS - 1 && latency >= ((__int64) 2 << b))
+    {
+      b++;
+    }
+
+  /* Only the slave writes its pair's counts */
+  pair->hist[b]++;
+  pair->taken++;
+}
+
+void *
+masterThread(void * arg)
+{
+  pair_t * pair = (pair_t *) arg;
+  const __int64 timeout = (__int64) TIMEOUT_MS * 1000000;
+  __int64 until;
+  LONG lastTimeouts = 0;
+  LONG lastTaken = 0;
+  int dither = 0;
+  int bias = 0;
+
+  while (!allExit)
+    {
+      /* Wait for the last hand off to be taken */
+      while (pair->taken != pair->sent && !allExit)
+        {
+          sched_yield();
+        }
+
+      /*
+       * Feel around the slave's timeout with some [non-random] dither
+       * of a timeout peak-to-peak, and bias towards the side that is
+       * coming up short, as stress1 does.
+       */
+      if (pair->sent % 16 == 0)
+        {
+          LONG timeouts = pair->timeouts - lastTimeouts;
+          LONG taken = pair->taken - lastTaken;
+
+          if (timeouts > taken && bias < 8)
+            {
+              bias++;
+            }
+          else if (timeouts < taken && bias > -8)
+            {
+              bias--;
+            }
+          lastTimeouts = pair->timeouts;
+          lastTaken = pair->taken;
+        }
+      dither = (dither + 1) % 16;
+
+      until = now() + timeout / 2 + (dither - bias) * timeout / 16;
+      while (now() < until)
+        {
+          /* Spin */
+        }
+
+      if (pair->kind == KIND_COND)
+        {
+          assert(pthread_mutex_lock(&pair->mx) == 0);
+          pair->sentAt = now();
+          pair->sent++;
+          assert(pthread_cond_signal(&pair->cv) == 0);
+          assert(pthread_mutex_unlock(&pair->mx) == 0);
+        }
+      else
+        {
+          pair->sentAt = now();
+          pair->sent++;
+          assert(sem_post(&pair->sem) == 0);
+        }
+    }
+
+  return NULL;
+}
+
+void *
+slaveThread(void * arg)
+{
+  pair_t * pair = (pair_t *) arg;
+  struct timespec abstime;
+  int result;
+
+  while (!allExit)
+    {
+      if (pair->kind == KIND_COND)
+        {
+          assert(pthread_mutex_lock(&pair->mx) == 0);
+          while (pair->taken == pair->sent && !allExit)
+            {
+              result = pthread_cond_timedwait(&pair->cv, &pair->mx,
+                                              timeoutFromNow(&abstime));
+              if (result == ETIMEDOUT)
+                {
+                  pair->timeouts++;
+                }
+              else
+                {
+                  assert(result == 0);
+                }
+            }
+          if (pair->taken != pair->sent)
+            {
+              record(pair);
+            }
+          assert(pthread_mutex_unlock(&pair->mx) == 0);
+        }
+      else
+        {
+          if (sem_timedwait(&pair->sem, timeoutFromNow(&abstime)) == 0)
+            {
+              record(pair);
+            }
+          else
+            {
+              assert(errno == ETIMEDOUT);
+              pair->timeouts++;
+            }
+        }
+    }
+
+  return NULL;
+}
+
+static void
+sample(pair_t * pairs, int n, sample_t * s)
+{
+  memory_counters_t mc;
+  pthread_libstats_np_t stats;
+  DWORD handles = 0;
+  int i, b;
+
+  memset(s, 0, sizeof(*s));
+
+  for (i = 0; i < n; i++)
+    {
+      s->handoffs += pairs[i].taken;
+      s->timeouts += pairs[i].timeouts;
+      for (b = 0; b < HIST_BUCKETS; b++)
+        {
+          s->hist[b] += pairs[i].hist[b];
+        }
+    }
+
+  mc.cb = sizeof(mc);
+  s->commit = (memoryInfo != NULL && memoryInfo(GetCurrentProcess(), &mc, sizeof(mc)))
+              ? (__int64) mc.PrivateUsage : 0;
+
+  s->handles = (handleCount != NULL && handleCount(GetCurrentProcess(), &handles))
+               ? (__int64) handles : 0;
+
+  assert(pthread_getlibstats_np(&stats) == 0);
+  s->kernel = (__int64) (stats.events + stats.semaphores + stats.timers
+                         + stats.threadHandles);
+}
+
+/* Upper bound of the bucket holding the given fraction of the counts */
+static __int64
+percentile(const __int64 * hist, __int64 count, int permille)
+{
+  __int64 seen = 0;
+  int b;
+
+  for (b = 0; b < HIST_BUCKETS; b++)
+    {
+      seen += hist[b];
+      if (count > 0 && seen * 1000 >= count * permille)
+        {
+          return (__int64) 2 << b;
+        }
+    }
+
+  return 0;
+}
+
+static void
+report(double secs, const sample_t * before, const sample_t * after,
+       double * rate)
+{
+  __int64 hist[HIST_BUCKETS];
+  __int64 count = after->handoffs - before->handoffs;
+  int b;
+
+  for (b = 0; b < HIST_BUCKETS; b++)
+    {
+      hist[b] = after->hist[b] - before->hist[b];
+    }
+
+  *rate = count / secs;
+
+  printf("  %8.0f %10.0f %10.0f %9.0f %9.0f %9.0f %9.0f %8.0f %12.0f %8.0f\n",
+         secs, *rate,
+         (after->timeouts - before->timeouts) / secs,
+         (double) percentile(hist, count, 500),
+         (double) percentile(hist, count, 990),
+         (double) percentile(hist, count, 999),
+         (double) percentile(hist, count, 1000),
+         (double) after->handles,
+         (double) after->commit,
+         (double) after->kernel);
+  fflush(stdout);
+}
+
+int
+main (int argc, char *argv[])
+{
+  HMODULE kernel32 = GetModuleHandleA("kernel32.dll");
+  HMODULE psapi;
+  int seconds = (argc > 1) ? atoi(argv[1]) : SECONDS;
+  int interval = (argc > 2) ? atoi(argv[2]) : INTERVAL;
+  int n = (argc > 3) ? atoi(argv[3]) : pthread_num_processors_np() / 2;
+  sample_t first, last, prev, cur;
+  double firstRate = 0.0, rate = 0.0;
+  pair_t * pairs;
+  int elapsed;
+  int i, value;
+
+  if (argc <= 3 && n < KINDS)
+    {
+      n = KINDS;
+    }
+  assert(seconds > 0 && interval > 0 && n > 0);
+
+  memoryInfo = (memory_info_t) GetProcAddress(kernel32, "K32GetProcessMemoryInfo");
+  if (memoryInfo == NULL && (psapi = LoadLibraryA("psapi.dll")) != NULL)
+    {
+      memoryInfo = (memory_info_t) GetProcAddress(psapi, "GetProcessMemoryInfo");
+    }
+  handleCount = (handle_count_t) GetProcAddress(kernel32, "GetProcessHandleCount");
+
+  pairs = (pair_t *) calloc(n, sizeof(pair_t));
+  assert(pairs != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      pairs[i].kind = i % KINDS;
+      assert(pthread_mutex_init(&pairs[i].mx, NULL) == 0);
+      assert(pthread_cond_init(&pairs[i].cv, NULL) == 0);
+      assert(sem_init(&pairs[i].sem, 0, 0) == 0);
+    }
+
+  printf("# Soak of %d condition variable and semaphore pairs for %d seconds\n",
+         n, seconds);
+  printf("# %8s %10s %10s %9s %9s %9s %9s %8s %12s %8s\n",
+         "secs", "handoffs/s", "timeouts/s", "p50", "p99", "p999", "max",
+         "handles", "commit", "kernel");
+
+  sample(pairs, n, &prev);
+
+  for (i = 0; i < n; i++)
+    {
+      assert(pthread_create(&pairs[i].slave, NULL, slaveThread, &pairs[i]) == 0);
+      assert(pthread_create(&pairs[i].master, NULL, masterThread, &pairs[i]) == 0);
+    }
+
+  for (elapsed = 0; elapsed < seconds; elapsed += interval)
+    {
+      int secs = (seconds - elapsed < interval) ? seconds - elapsed : interval;
+
+      Sleep(secs * 1000);
+      sample(pairs, n, &cur);
+      report(secs, &prev, &cur, &rate);
+      if (elapsed == 0)
+        {
+          first = cur;
+          firstRate = rate;
+        }
+      prev = cur;
+    }
+
+  last = cur;
+  allExit = 1;
+
+  for (i = 0; i < n; i++)
+    {
+      assert(pthread_join(pairs[i].master, NULL) == 0);
+      assert(pthread_join(pairs[i].slave, NULL) == 0);
+    }
+
+  printf("# drift: handoffs/s %+.1f%%, handles %+.0f, commit %+.0f, kernel %+.0f\n",
+         firstRate > 0.0 ? (rate - firstRate) * 100.0 / firstRate : 0.0,
+         (double) (last.handles - first.handles),
+         (double) (last.commit - first.commit),
+         (double) (last.kernel - first.kernel));
+
+  for (i = 0; i < n; i++)
+    {
+      /* At most the last post is left untaken */
+      assert(sem_getvalue(&pairs[i].sem, &value) == 0);
+      assert(value == 0 || value == 1);
+      assert(sem_destroy(&pairs[i].sem) == 0);
+      assert(pthread_cond_destroy(&pairs[i].cv) == 0);
+      assert(pthread_mutex_destroy(&pairs[i].mx) == 0);
+    }
+
+  free(pairs);
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+/* 
+ * spin5.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Tests ticket spin locks, and default spin locks under contention.
+ * Several threads increment a shared counter under the lock using
+ * pthread_spin_lock() and pthread_spin_trylock(). The count must not
+ * be disturbed.
+ *
+ * Depends on API functions: 
+ *      pthread_create()
+ *      pthread_join()
+ *      pthread_spin_init()
+ *      pthread_spin_init_np()
+ *      pthread_spin_destroy()
+ *      pthread_spin_lock()
+ *      pthread_spin_trylock()
+ *      pthread_spin_unlock()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4,
+  ITERATIONS = 20000
+};
+
+static int lockCount;
+
+static pthread_spinlock_t lock;
+
+void * locker(void * arg)
+{
+  int i;
+  int try = (int)(size_t)arg;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      if (try)
+        {
+          int result;
+
+          while ((result = pthread_spin_trylock(&lock)) == EBUSY)
+            {
+              sched_yield();
+            }
+          assert(result == 0);
+        }
+      else
+        {
+          assert(pthread_spin_lock(&lock) == 0);
+        }
+      lockCount++;
+      assert(pthread_spin_unlock(&lock) == 0);
+    }
+
+  return (void *) 555;
+}
+
+static void
+runTest (void)
+{
+  pthread_t t[NUMTHREADS];
+  void* result = (void*)0;
+  int i;
+
+  lockCount = 0;
+
+  assert(pthread_spin_trylock(&lock) == 0);
+  assert(pthread_spin_trylock(&lock) == EBUSY);
+  assert(pthread_spin_unlock(&lock) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, locker, (void *)(size_t)(i & 1)) == 0);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], &result) == 0);
+      assert((int)(size_t)result == 555);
+    }
+
+  assert(lockCount == NUMTHREADS * ITERATIONS);
+}
+
+int
+main()
+{
+  assert(pthread_spin_init_np(&lock, PTHREAD_PROCESS_PRIVATE, -1) == EINVAL);
+
+  assert(pthread_spin_init(&lock, PTHREAD_PROCESS_PRIVATE) == 0);
+  runTest();
+  assert(pthread_spin_destroy(&lock) == 0);
+
+  assert(pthread_spin_init_np(&lock, PTHREAD_PROCESS_PRIVATE, PTHREAD_SPINLOCK_TICKET_NP) == 0);
+  runTest();
+  assert(pthread_spin_lock(&lock) == 0);
+  /* EINVAL, or EBUSY from the mutex on a single processor */
+  assert(pthread_spin_destroy(&lock) != 0);
+  assert(pthread_spin_unlock(&lock) == 0);
+  assert(pthread_spin_destroy(&lock) == 0);
+
+  return 0;
+}
@@ -0,0 +1,126 @@
+/* 
+ * spin6.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Tests spin locks whose owner blocks while holding them, with more
+ * threads than processors. Waiters yield rather than spin through the
+ * owner's sleep; the count must not be disturbed.
+ *
+ * Depends on API functions: 
+ *      pthread_create()
+ *      pthread_join()
+ *      pthread_spin_init()
+ *      pthread_spin_init_np()
+ *      pthread_spin_destroy()
+ *      pthread_spin_lock()
+ *      pthread_spin_unlock()
+ *      pthread_delay_np()
+ */
+
+#include "test.h"
+
+enum {
+  THREADS_PER_CPU = 4,
+  ITERATIONS = 2000,
+  SLEEP_EVERY = 200,
+  MAX_THREADS = 64
+};
+
+static int lockCount;
+static int numThreads;
+
+static pthread_spinlock_t lock;
+
+void * locker(void * arg)
+{
+  struct timespec interval = { 0, 1000000 };
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_spin_lock(&lock) == 0);
+      lockCount++;
+      if (0 == i % SLEEP_EVERY)
+        {
+          /* Blocks in the library holding the lock */
+          assert(pthread_delay_np(&interval) == 0);
+        }
+      assert(pthread_spin_unlock(&lock) == 0);
+    }
+
+  return (void *) 555;
+}
+
+static void
+runTest (void)
+{
+  pthread_t t[MAX_THREADS];
+  void* result = (void*)0;
+  int i;
+
+  lockCount = 0;
+
+  for (i = 0; i < numThreads; i++)
+    {
+      assert(pthread_create(&t[i], NULL, locker, NULL) == 0);
+    }
+
+  for (i = 0; i < numThreads; i++)
+    {
+      assert(pthread_join(t[i], &result) == 0);
+      assert((int)(size_t)result == 555);
+    }
+
+  assert(lockCount == numThreads * ITERATIONS);
+}
+
+int
+main()
+{
+  numThreads = THREADS_PER_CPU * pthread_num_processors_np();
+  if (numThreads > MAX_THREADS)
+    {
+      numThreads = MAX_THREADS;
+    }
+
+  assert(pthread_spin_init(&lock, PTHREAD_PROCESS_PRIVATE) == 0);
+  runTest();
+  assert(pthread_spin_destroy(&lock) == 0);
+
+  assert(pthread_spin_init_np(&lock, PTHREAD_PROCESS_PRIVATE, PTHREAD_SPINLOCK_TICKET_NP) == 0);
+  runTest();
+  assert(pthread_spin_destroy(&lock) == 0);
+
+  return 0;
+}
@@ -0,0 +1,151 @@
+/* 
+ * spin7.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Tests spin locks initialised while several CPUs are available,
+ * then contended by threads all pinned to one CPU. The waiters must
+ * see that spinning can't help and yield to the owner.
+ *
+ * Depends on API functions: 
+ *      pthread_attr_setaffinity_np()
+ *      pthread_create()
+ *      pthread_join()
+ *      pthread_getaffinity_np()
+ *      pthread_spin_init()
+ *      pthread_spin_init_np()
+ *      pthread_spin_destroy()
+ *      pthread_spin_lock()
+ *      pthread_spin_unlock()
+ */
+
+#if ! defined(WINCE)
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4,
+  ITERATIONS = 20000
+};
+
+static int lockCount;
+
+static pthread_spinlock_t lock;
+
+void * locker(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_spin_lock(&lock) == 0);
+      lockCount++;
+      assert(pthread_spin_unlock(&lock) == 0);
+    }
+
+  return (void *) 555;
+}
+
+static void
+runTest (pthread_attr_t * attr)
+{
+  pthread_t t[NUMTHREADS];
+  void* result = (void*)0;
+  int i;
+
+  lockCount = 0;
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], attr, locker, NULL) == 0);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], &result) == 0);
+      assert((int)(size_t)result == 555);
+    }
+
+  assert(lockCount == NUMTHREADS * ITERATIONS);
+}
+
+int
+main()
+{
+  pthread_attr_t attr;
+  cpu_set_t processCpus;
+  cpu_set_t one;
+  int cpu;
+
+  if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &processCpus) == ENOSYS)
+    {
+      printf("pthread_get/set_affinity_np API not supported for this platform: skipping test.");
+      return 0;
+    }
+  assert(pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &processCpus) == 0);
+
+  for (cpu = 0; !CPU_ISSET(cpu, &processCpus); cpu++)
+    {
+      assert(cpu < (int) sizeof(cpu_set_t) * 8);
+    }
+  CPU_ZERO(&one);
+  CPU_SET(cpu, &one);
+
+  assert(pthread_attr_init(&attr) == 0);
+  assert(pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &one) == 0);
+
+  assert(pthread_spin_init(&lock, PTHREAD_PROCESS_PRIVATE) == 0);
+  runTest(&attr);
+  assert(pthread_spin_destroy(&lock) == 0);
+
+  assert(pthread_spin_init_np(&lock, PTHREAD_PROCESS_PRIVATE, PTHREAD_SPINLOCK_TICKET_NP) == 0);
+  runTest(&attr);
+  assert(pthread_spin_destroy(&lock) == 0);
+
+  assert(pthread_attr_destroy(&attr) == 0);
+
+  return 0;
+}
+
+#else
+
+#include <stdio.h>
+
+int
+main()
+{
+  fprintf(stderr, "Test N/A for this target environment.\n");
+  return 0;
+}
+
+#endif
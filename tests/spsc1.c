@@ -0,0 +1,166 @@
+/* 
+ * spsc1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * SPSC channel: order and completeness through a small channel, so
+ * both ends keep parking, with single and batched pushes and pops,
+ * and cancellation of a consumer parked on an empty channel.
+ *
+ * Depends on API functions:
+ *	pthread_spsc_create_np()
+ *	pthread_spsc_destroy_np()
+ *	pthread_spsc_push_np()
+ *	pthread_spsc_trypush_np()
+ *	pthread_spsc_pushv_np()
+ *	pthread_spsc_pop_np()
+ *	pthread_spsc_trypop_np()
+ *	pthread_spsc_popv_np()
+ *	pthread_create()
+ *	pthread_join()
+ *	pthread_cancel()
+ */
+
+#include "test.h"
+
+enum {
+  CAPACITY = 8,
+  ITEMS = 100000,
+  BATCH = 5
+};
+
+static pthread_spsc_np_t channel;
+
+void *
+producer(void * arg)
+{
+  void * batch[BATCH];
+  size_t i = 1;
+  int j;
+
+  while (i <= ITEMS)
+    {
+      if (i % 2)
+        {
+          assert(pthread_spsc_push_np(channel, (void *) i++) == 0);
+        }
+      else
+        {
+          for (j = 0; j < BATCH; j++)
+            {
+              batch[j] = (void *) i++;
+            }
+          assert(pthread_spsc_pushv_np(channel, batch, BATCH) == 0);
+        }
+    }
+
+  return NULL;
+}
+
+void *
+sleeper(void * arg)
+{
+  void * item;
+
+  (void) pthread_spsc_pop_np(channel, &item);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t;
+  void * items[BATCH + 2];
+  void * item;
+  void * result;
+  size_t expected = 1;
+  int n;
+  int i;
+
+  assert(pthread_spsc_create_np(NULL, 1) == EINVAL);
+  assert(pthread_spsc_create_np(&channel, 0) == EINVAL);
+  assert(pthread_spsc_create_np(&channel, 3) == 0);
+
+  /* Exactly the capacity asked for */
+  assert(pthread_spsc_trypop_np(channel, &item) == EAGAIN);
+  assert(pthread_spsc_trypush_np(channel, (void *) 1) == 0);
+  assert(pthread_spsc_trypush_np(channel, (void *) 2) == 0);
+  assert(pthread_spsc_trypush_np(channel, (void *) 3) == 0);
+  assert(pthread_spsc_trypush_np(channel, (void *) 4) == EAGAIN);
+  assert(pthread_spsc_popv_np(channel, items, BATCH, &n) == 0);
+  assert(n == 3);
+  assert(items[0] == (void *) 1 && items[2] == (void *) 3);
+  assert(pthread_spsc_trypop_np(channel, &item) == EAGAIN);
+  assert(pthread_spsc_popv_np(channel, items, 0, &n) == EINVAL);
+  assert(pthread_spsc_destroy_np(&channel) == 0);
+  assert(channel == NULL);
+  assert(pthread_spsc_destroy_np(&channel) == EINVAL);
+
+  assert(pthread_spsc_create_np(&channel, CAPACITY) == 0);
+  assert(pthread_create(&t, NULL, producer, NULL) == 0);
+
+  while (expected <= ITEMS)
+    {
+      if (expected % 3)
+        {
+          assert(pthread_spsc_pop_np(channel, &item) == 0);
+          assert(item == (void *) expected);
+          expected++;
+        }
+      else
+        {
+          assert(pthread_spsc_popv_np(channel, items, BATCH + 2, &n) == 0);
+          assert(n >= 1 && n <= BATCH + 2);
+          for (i = 0; i < n; i++)
+            {
+              assert(items[i] == (void *) expected);
+              expected++;
+            }
+        }
+    }
+
+  assert(pthread_join(t, NULL) == 0);
+  assert(pthread_spsc_trypop_np(channel, &item) == EAGAIN);
+
+  /* A consumer parked on the empty channel can be cancelled */
+  assert(pthread_create(&t, NULL, sleeper, NULL) == 0);
+  Sleep(200);
+  assert(pthread_cancel(t) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert(result == PTHREAD_CANCELED);
+
+  assert(pthread_spsc_destroy_np(&channel) == 0);
+
+  return 0;
+}
@@ -0,0 +1,131 @@
+/* 
+ * static1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Statically initialised objects first used by many threads at once
+ * are initialised exactly once, and one destroyed before first use
+ * fails the operations that come after.
+ *
+ * Depends on API functions:
+ *	pthread_mutex_lock()
+ *	pthread_rwlock_wrlock()
+ *	pthread_spin_lock()
+ *	pthread_cond_timedwait()
+ *	sem_wait()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 16
+};
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t recursive = PTHREAD_RECURSIVE_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
+static pthread_spinlock_t spin = PTHREAD_SPINLOCK_INITIALIZER;
+static sem_t go;
+static int count = 0;
+static pthread_mutex_t seen[NUMTHREADS];
+
+void *
+worker(void * arg)
+{
+  int i = (int) (size_t) arg;
+  struct timespec abstime = { 0, 0 };
+
+  assert(sem_wait(&go) == 0);
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  seen[i] = mutex;
+  count++;
+  /* Times out at once: abstime is in the past */
+  assert(pthread_cond_timedwait(&cond, &mutex, &abstime) == ETIMEDOUT);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  assert(pthread_mutex_lock(&recursive) == 0);
+  assert(pthread_mutex_lock(&recursive) == 0);
+  assert(pthread_mutex_unlock(&recursive) == 0);
+  assert(pthread_mutex_unlock(&recursive) == 0);
+
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  assert(pthread_spin_lock(&spin) == 0);
+  assert(pthread_spin_unlock(&spin) == 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  pthread_mutex_t unused = PTHREAD_MUTEX_INITIALIZER;
+  pthread_cond_t unusedCond = PTHREAD_COND_INITIALIZER;
+  int i;
+
+  assert(sem_init(&go, 0, 0) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, (void *) (size_t) i) == 0);
+    }
+
+  assert(sem_post_multiple(&go, NUMTHREADS) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+      assert(seen[i] == mutex);
+    }
+
+  assert(count == NUMTHREADS);
+
+  assert(pthread_mutex_destroy(&mutex) == 0);
+  assert(pthread_mutex_destroy(&recursive) == 0);
+  assert(pthread_cond_destroy(&cond) == 0);
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+  assert(pthread_spin_destroy(&spin) == 0);
+
+  /* Destroyed before first use */
+  assert(pthread_mutex_destroy(&unused) == 0);
+  assert(pthread_mutex_lock(&unused) == EINVAL);
+  assert(pthread_cond_destroy(&unusedCond) == 0);
+  assert(pthread_cond_signal(&unusedCond) == EINVAL);
+
+  assert(sem_destroy(&go) == 0);
+
+  return 0;
+}
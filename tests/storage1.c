@@ -0,0 +1,136 @@
+/* 
+ * storage1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Mutexes and spin locks kept in application storage work as heap
+ * ones do, are destroyed without being freed, and the storage can be
+ * initialised again.
+ *
+ * Depends on API functions:
+ *	pthread_mutex_init_storage_np()
+ *	pthread_spin_init_storage_np()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4,
+  ITERATIONS = 10000
+};
+
+typedef struct {
+  pthread_mutex_t lock;
+  pthread_mutex_storage_np_t lockStorage;
+  pthread_spinlock_t spin;
+  pthread_spinlock_storage_np_t spinStorage;
+  long mutexCount;
+  long spinCount;
+} object_t;
+
+static object_t objects[2];
+
+void *
+worker(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      object_t * o = &objects[i & 1];
+
+      assert(pthread_mutex_lock(&o->lock) == 0);
+      o->mutexCount++;
+      assert(pthread_mutex_unlock(&o->lock) == 0);
+
+      assert(pthread_spin_lock(&o->spin) == 0);
+      o->spinCount++;
+      assert(pthread_spin_unlock(&o->spin) == 0);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  pthread_mutexattr_t ma;
+  int i;
+
+  assert(pthread_mutex_init_storage_np(&objects[0].lock, NULL, NULL) == EINVAL);
+  assert(pthread_spin_init_storage_np(&objects[0].spin, PTHREAD_PROCESS_PRIVATE,
+				      PTHREAD_SPINLOCK_DEFAULT_NP, NULL) == EINVAL);
+  assert(pthread_spin_init_storage_np(&objects[0].spin, PTHREAD_PROCESS_PRIVATE,
+				      -1, &objects[0].spinStorage) == EINVAL);
+
+  for (i = 0; i < 2; i++)
+    {
+      assert(pthread_mutex_init_storage_np(&objects[i].lock, NULL,
+					   &objects[i].lockStorage) == 0);
+      assert(pthread_spin_init_storage_np(&objects[i].spin, PTHREAD_PROCESS_PRIVATE,
+					  (i == 0) ? PTHREAD_SPINLOCK_DEFAULT_NP
+					           : PTHREAD_SPINLOCK_TICKET_NP,
+					  &objects[i].spinStorage) == 0);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, NULL) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  for (i = 0; i < 2; i++)
+    {
+      assert(objects[i].mutexCount == NUMTHREADS * ITERATIONS / 2);
+      assert(objects[i].spinCount == NUMTHREADS * ITERATIONS / 2);
+      assert(pthread_mutex_destroy(&objects[i].lock) == 0);
+      assert(pthread_spin_destroy(&objects[i].spin) == 0);
+    }
+
+  /* The storage can be used again, here for an error checking mutex */
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_ERRORCHECK) == 0);
+  assert(pthread_mutex_init_storage_np(&objects[0].lock, &ma,
+				       &objects[0].lockStorage) == 0);
+  assert(pthread_mutex_lock(&objects[0].lock) == 0);
+  assert(pthread_mutex_lock(&objects[0].lock) == EDEADLK);
+  assert(pthread_mutex_destroy(&objects[0].lock) == EBUSY);
+  assert(pthread_mutex_unlock(&objects[0].lock) == 0);
+  assert(pthread_mutex_destroy(&objects[0].lock) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  return 0;
+}
@@ -0,0 +1,130 @@
+/* 
+ * threadstats1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * A thread's statistics count its blocking waits and the time spent
+ * in them, the cancel requests made on it and its CPU time, which the
+ * clock from pthread_getcpuclockid() also measures.
+ *
+ * Depends on API functions:
+ *	pthread_getstats_np()
+ *	pthread_getcpuclockid()
+ *	sem_wait()
+ *	pthread_cancel()
+ */
+
+#include "test.h"
+
+static sem_t go;
+static sem_t ready;
+
+static void
+spin(int ms)
+{
+  DWORD start = GetTickCount();
+
+  while (GetTickCount() - start < (DWORD) ms)
+    {
+    }
+}
+
+void *
+waiter(void * arg)
+{
+  pthread_threadstats_np_t before;
+  pthread_threadstats_np_t after;
+
+  assert(pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL) == 0);
+  assert(pthread_getstats_np(pthread_self(), &before) == 0);
+  assert(sem_post(&ready) == 0);
+  assert(sem_wait(&go) == 0);
+  assert(pthread_getstats_np(pthread_self(), &after) == 0);
+
+  assert(after.waits > before.waits);
+  assert(after.waitTime - before.waitTime >= 50000000);
+  assert(after.cancelRequests == 2);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_threadstats_np_t stats;
+  pthread_t t;
+#if defined(PTW32_CLOCK_GETTIME)
+  clockid_t clock;
+  struct timespec t0, t1;
+#endif
+
+  assert(pthread_getstats_np(pthread_self(), NULL) == EINVAL);
+
+  assert(sem_init(&go, 0, 0) == 0);
+  assert(sem_init(&ready, 0, 0) == 0);
+
+  assert(pthread_create(&t, NULL, waiter, NULL) == 0);
+  assert(sem_wait(&ready) == 0);
+  Sleep(100);
+
+  assert(pthread_getstats_np(t, &stats) == 0);
+  assert(stats.cancelRequests == 0);
+  assert(pthread_cancel(t) == 0);
+  assert(pthread_cancel(t) == 0);
+  assert(pthread_getstats_np(t, &stats) == 0);
+  assert(stats.cancelRequests == 2);
+
+  assert(sem_post(&go) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(pthread_getstats_np(t, &stats) == ESRCH);
+
+  /* CPU time */
+  spin(100);
+  assert(pthread_getstats_np(pthread_self(), &stats) == 0);
+  assert(stats.userTime + stats.kernelTime > 0);
+
+#if defined(PTW32_CLOCK_GETTIME)
+  assert(pthread_getcpuclockid(pthread_self(), NULL) == EINVAL);
+  assert(pthread_getcpuclockid(pthread_self(), &clock) == 0);
+  assert(clock < 0);
+  assert(clock_getres(clock, &t0) == 0);
+  assert(clock_gettime(clock, &t0) == 0);
+  spin(100);
+  assert(clock_gettime(clock, &t1) == 0);
+  assert(t1.tv_sec > t0.tv_sec || t1.tv_nsec > t0.tv_nsec);
+#endif
+
+  assert(sem_destroy(&go) == 0);
+  assert(sem_destroy(&ready) == 0);
+
+  return 0;
+}
@@ -0,0 +1,207 @@
+/* 
+ * timeouts2.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ *
+ * Test that timed waits honour sub-millisecond deadlines when the
+ * library has high resolution timers: sem_timedwait,
+ * pthread_mutex_timedlock (normal and robust),
+ * pthread_cond_timedwait and pthread_rwlock_timedwrlock must time out
+ * no earlier than abstime and, at best, well within a clock tick of it.
+ *
+ * Depends on API functions:
+ *	pthread_win32_test_features_np()
+ *	sem_timedwait()
+ *	pthread_mutex_timedlock()
+ *	pthread_cond_timedwait()
+ *	pthread_rwlock_timedwrlock()
+ */
+
+#include "test.h"
+
+/*
+ * Deadline, and the most that the best of NUMTRIES waits may overshoot
+ * it, in 100 nanosecond units.
+ */
+#define DEADLINE	5000
+#define MAXLATE		20000
+#define NUMTRIES	10
+
+static VOID (WINAPI *getPreciseTime) (LPFILETIME);
+
+static sem_t sem;
+static pthread_mutex_t mutex;
+static pthread_mutex_t robustMutex;
+static pthread_mutex_t cvMutex;
+static pthread_cond_t cv;
+static pthread_rwlock_t rwlock;
+
+static int64_t
+now100ns(void)
+{
+  FILETIME ft;
+
+  getPreciseTime(&ft);
+  return ((int64_t) ft.dwHighDateTime << 32) + (int64_t) ft.dwLowDateTime;
+}
+
+static void
+toTimespec(int64_t t, struct timespec * ts)
+{
+  /* From 100 nanosecond units since 1601 to seconds since 1970 */
+  t -= ((int64_t) 27111902 << 32) + (int64_t) 3577643008;
+  ts->tv_sec = (long) (t / 10000000);
+  ts->tv_nsec = (long) ((t % 10000000) * 100);
+}
+
+static int
+timedWait(int which, const struct timespec * abstime)
+{
+  int result;
+
+  switch (which)
+    {
+    case 0:
+      return (sem_timedwait(&sem, abstime) == -1) ? errno : 0;
+    case 1:
+      return pthread_mutex_timedlock(&mutex, abstime);
+    case 2:
+      return pthread_mutex_timedlock(&robustMutex, abstime);
+    case 3:
+      assert(pthread_mutex_lock(&cvMutex) == 0);
+      result = pthread_cond_timedwait(&cv, &cvMutex, abstime);
+      assert(pthread_mutex_unlock(&cvMutex) == 0);
+      return result;
+    default:
+      return pthread_rwlock_timedwrlock(&rwlock, abstime);
+    }
+}
+
+/*
+ * Returns the least amount by which NUMTRIES waits overshot their
+ * deadlines, none of which may end early.
+ */
+static int64_t
+bestLateness(int which)
+{
+  int64_t best = -1;
+  int i;
+
+  for (i = 0; i < NUMTRIES; i++)
+    {
+      struct timespec abstime;
+      int64_t deadline = now100ns() + DEADLINE;
+      int64_t late;
+
+      toTimespec(deadline, &abstime);
+
+      assert(timedWait(which, &abstime) == ETIMEDOUT);
+
+      late = now100ns() - deadline;
+      assert(late >= 0);
+
+      if (best < 0 || late < best)
+        {
+          best = late;
+        }
+    }
+
+  return best;
+}
+
+void *
+waiter(void * arg)
+{
+  int which;
+
+  for (which = 0; which < 5; which++)
+    {
+      int64_t late = bestLateness(which);
+
+      printf("wait %d: %ld us late\n", which, (long) (late / 10));
+      assert(late < MAXLATE);
+    }
+
+  return arg;
+}
+
+int
+main()
+{
+  pthread_t t;
+  pthread_mutexattr_t ma;
+
+  if (!pthread_win32_test_features_np(PTW32_HIGH_RES_TIMEOUTS))
+    {
+      printf("High resolution timeouts not supported on this system: skipping test.\n");
+      return 0;
+    }
+
+  getPreciseTime = (VOID (WINAPI *)(LPFILETIME))
+    GetProcAddress(GetModuleHandle(TEXT("kernel32.dll")), "GetSystemTimePreciseAsFileTime");
+  assert(getPreciseTime != NULL);
+
+  assert(sem_init(&sem, 0, 0) == 0);
+  assert(pthread_mutex_init(&mutex, NULL) == 0);
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_ROBUST) == 0);
+  assert(pthread_mutex_init(&robustMutex, &ma) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+  assert(pthread_mutex_init(&cvMutex, NULL) == 0);
+  assert(pthread_cond_init(&cv, NULL) == 0);
+  assert(pthread_rwlock_init(&rwlock, NULL) == 0);
+
+  /*
+   * Hold the locks while the waiter times out on them.
+   */
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_mutex_lock(&robustMutex) == 0);
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+
+  assert(pthread_create(&t, NULL, waiter, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_mutex_unlock(&robustMutex) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+  assert(pthread_cond_destroy(&cv) == 0);
+  assert(pthread_mutex_destroy(&cvMutex) == 0);
+  assert(pthread_mutex_destroy(&robustMutex) == 0);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+  assert(sem_destroy(&sem) == 0);
+
+  return 0;
+}
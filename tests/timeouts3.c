@@ -0,0 +1,180 @@
+/* 
+ * timeouts3.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ *
+ * Test timed waits against CLOCK_MONOTONIC: pthread_condattr_setclock
+ * and pthread_condattr_getclock, pthread_cond_timedwait on a monotonic
+ * condition variable, pthread_cond_clockwait, pthread_mutex_clocklock
+ * and sem_clockwait. Each must time out no earlier than its monotonic
+ * abstime, and reject an unknown clock with EINVAL.
+ *
+ * Depends on API functions:
+ *	pthread_condattr_setclock()
+ *	pthread_condattr_getclock()
+ *	pthread_cond_timedwait()
+ *	pthread_cond_clockwait()
+ *	pthread_mutex_clocklock()
+ *	sem_clockwait()
+ */
+
+#include "test.h"
+
+/*
+ * Relative timeout in 100 nanosecond units.
+ */
+#define TIMEOUT		500000
+
+static sem_t sem;
+static pthread_mutex_t mutex;
+static pthread_mutex_t cvMutex;
+static pthread_cond_t cv;
+static pthread_cond_t monoCv;
+
+/*
+ * CLOCK_MONOTONIC time in 100 nanosecond units, as the library
+ * computes it.
+ */
+static int64_t
+monoNow(void)
+{
+  LARGE_INTEGER c, f;
+
+  assert(QueryPerformanceCounter(&c));
+  assert(QueryPerformanceFrequency(&f));
+  return (c.QuadPart / f.QuadPart) * 10000000
+         + (c.QuadPart % f.QuadPart) * 10000000 / f.QuadPart;
+}
+
+static void
+toTimespec(int64_t t, struct timespec * ts)
+{
+  ts->tv_sec = (long) (t / 10000000);
+  ts->tv_nsec = (long) ((t % 10000000) * 100);
+}
+
+static int
+timedWait(int which, clockid_t clock, const struct timespec * abstime)
+{
+  int result;
+
+  switch (which)
+    {
+    case 0:
+      return (sem_clockwait(&sem, clock, abstime) == -1) ? errno : 0;
+    case 1:
+      return pthread_mutex_clocklock(&mutex, clock, abstime);
+    case 2:
+      assert(pthread_mutex_lock(&cvMutex) == 0);
+      result = pthread_cond_clockwait(&cv, &cvMutex, clock, abstime);
+      assert(pthread_mutex_unlock(&cvMutex) == 0);
+      return result;
+    default:
+      /* The condition variable's own clock; 'clock' selects nothing */
+      assert(pthread_mutex_lock(&cvMutex) == 0);
+      result = pthread_cond_timedwait(&monoCv, &cvMutex, abstime);
+      assert(pthread_mutex_unlock(&cvMutex) == 0);
+      return result;
+    }
+}
+
+void *
+waiter(void * arg)
+{
+  int which;
+
+  for (which = 0; which < 4; which++)
+    {
+      struct timespec abstime;
+      int64_t deadline = monoNow() + TIMEOUT;
+
+      toTimespec(deadline, &abstime);
+
+      if (which < 3)
+        {
+          assert(timedWait(which, (clockid_t) 99, &abstime) == EINVAL);
+        }
+
+      assert(timedWait(which, CLOCK_MONOTONIC, &abstime) == ETIMEDOUT);
+      assert(monoNow() >= deadline);
+    }
+
+  return arg;
+}
+
+int
+main()
+{
+  pthread_t t;
+  pthread_condattr_t ca;
+  clockid_t clock;
+
+  assert(pthread_condattr_init(&ca) == 0);
+  assert(pthread_condattr_getclock(&ca, &clock) == 0);
+  assert(clock == CLOCK_REALTIME);
+  assert(pthread_condattr_setclock(&ca, (clockid_t) 99) == EINVAL);
+  assert(pthread_condattr_setclock(&ca, CLOCK_MONOTONIC) == 0);
+  assert(pthread_condattr_getclock(&ca, &clock) == 0);
+  assert(clock == CLOCK_MONOTONIC);
+  assert(pthread_cond_init(&monoCv, &ca) == 0);
+  assert(pthread_condattr_destroy(&ca) == 0);
+
+  assert(sem_init(&sem, 0, 0) == 0);
+  assert(pthread_mutex_init(&mutex, NULL) == 0);
+  assert(pthread_mutex_init(&cvMutex, NULL) == 0);
+  assert(pthread_cond_init(&cv, NULL) == 0);
+
+  /*
+   * Hold the mutex while the waiter times out on it.
+   */
+  assert(pthread_mutex_lock(&mutex) == 0);
+
+  assert(pthread_create(&t, NULL, waiter, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  /*
+   * A monotonic condition variable is not broadcast on a time change.
+   */
+  assert(pthread_timechange_handler_np(NULL) == NULL);
+
+  assert(pthread_cond_destroy(&cv) == 0);
+  assert(pthread_cond_destroy(&monoCv) == 0);
+  assert(pthread_mutex_destroy(&cvMutex) == 0);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+  assert(sem_destroy(&sem) == 0);
+
+  return 0;
+}
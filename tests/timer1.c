@@ -0,0 +1,146 @@
+/* 
+ * timer1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test POSIX timers: a periodic SIGEV_THREAD timer notifies on pool
+ * threads until deleted, a one-shot timer notifies once, and
+ * timer_gettime reports an armed and a disarmed timer.
+ *
+ * Depends on API functions:
+ *	timer_create()
+ *	timer_settime()
+ *	timer_gettime()
+ *	timer_getoverrun()
+ *	timer_delete()
+ */
+
+#include "test.h"
+
+#if defined(PTW32_TIMER_CREATE)
+
+static volatile LONG ticks = 0;
+static volatile LONG shots = 0;
+
+static void
+tick(union sigval value)
+{
+  assert(value.sival_int == 42);
+  InterlockedIncrement((LPLONG)&ticks);
+}
+
+static void
+shot(union sigval value)
+{
+  assert(value.sival_ptr == (void *) &shots);
+  InterlockedIncrement((LPLONG)&shots);
+}
+
+int
+main()
+{
+  timer_t periodic;
+  timer_t oneshot;
+  struct sigevent ev;
+  struct itimerspec its;
+  struct itimerspec old;
+  LONG n;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.sigev_notify = SIGEV_THREAD;
+  ev.sigev_notify_function = tick;
+  ev.sigev_value.sival_int = 42;
+
+  assert(timer_create(CLOCK_MONOTONIC, NULL, &periodic) == -1);
+  assert(errno == EINVAL);
+  assert(timer_create(CLOCK_MONOTONIC, &ev, &periodic) == 0);
+
+  memset(&its, 0, sizeof(its));
+  its.it_value.tv_nsec = 10000000;
+  its.it_interval.tv_nsec = 10000000;
+  assert(timer_settime(periodic, 0, &its, NULL) == 0);
+
+  ev.sigev_notify_function = shot;
+  ev.sigev_value.sival_ptr = (void *) &shots;
+  assert(timer_create(CLOCK_REALTIME, &ev, &oneshot) == 0);
+
+  memset(&its, 0, sizeof(its));
+  its.it_value.tv_nsec = 1000000000L;
+  assert(timer_settime(oneshot, 0, &its, NULL) == -1);
+  assert(errno == EINVAL);
+
+  its.it_value.tv_sec = 10;
+  its.it_value.tv_nsec = 0;
+  assert(timer_settime(oneshot, 0, &its, NULL) == 0);
+  assert(timer_gettime(oneshot, &old) == 0);
+  assert(old.it_value.tv_sec >= 9 && old.it_value.tv_sec <= 10);
+  assert(old.it_interval.tv_sec == 0 && old.it_interval.tv_nsec == 0);
+
+  /* Rearm to fire soon, reading back the old setting */
+  its.it_value.tv_sec = 0;
+  its.it_value.tv_nsec = 20000000;
+  assert(timer_settime(oneshot, 0, &its, &old) == 0);
+  assert(old.it_value.tv_sec >= 9);
+
+  Sleep(500);
+
+  assert(shots == 1);
+  assert(timer_gettime(oneshot, &old) == 0);
+  assert(old.it_value.tv_sec == 0 && old.it_value.tv_nsec == 0);
+  assert(timer_getoverrun(oneshot) == 0);
+
+  n = ticks;
+  assert(n >= 5);
+  assert(timer_getoverrun(periodic) >= 0);
+
+  assert(timer_delete(periodic) == 0);
+  Sleep(100);
+  n = ticks;
+  Sleep(100);
+  assert(ticks == n);
+
+  assert(timer_delete(oneshot) == 0);
+
+  return 0;
+}
+
+#else /* ! PTW32_TIMER_CREATE */
+
+int
+main()
+{
+  printf("timer_create is provided by the compiler's headers: skipping test.\n");
+  return 0;
+}
+
+#endif /* PTW32_TIMER_CREATE */
@@ -0,0 +1,155 @@
+/* 
+ * timerslack1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test the timer slack: it is rounded up to a millisecond, and with it
+ * set, staggered condition variable waits all time out, none of them
+ * early, while one that is signalled first is woken.
+ *
+ * Depends on API functions:
+ *	pthread_settimerslack_np()
+ *	pthread_gettimerslack_np()
+ *	pthread_cond_timedwait()
+ *	pthread_cond_signal()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 20
+};
+
+static pthread_mutex_t mx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cv = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t signalled = PTHREAD_COND_INITIALIZER;
+static int ready = 0;
+
+static void *
+waiter(void * arg)
+{
+  int i = (int) (size_t) arg;
+  struct timespec abstime = { 0, 0 };
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+  int ms;
+
+  PTW32_FTIME(&currSysTime);
+  ms = currSysTime.millitm + 100 + i * 7;
+  abstime.tv_sec = (long)currSysTime.time + ms / 1000;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * (ms % 1000);
+
+  assert(pthread_mutex_lock(&mx) == 0);
+  assert(pthread_cond_timedwait(&cv, &mx, &abstime) == ETIMEDOUT);
+  assert(pthread_mutex_unlock(&mx) == 0);
+
+  /* Not before its time, give or take the clock's millisecond */
+  PTW32_FTIME(&currSysTime);
+  assert((long)currSysTime.time > (long)abstime.tv_sec
+         || ((long)currSysTime.time == (long)abstime.tv_sec
+             && currSysTime.millitm + 1 >= abstime.tv_nsec / NANOSEC_PER_MILLISEC));
+
+  return NULL;
+}
+
+static void *
+signalee(void * arg)
+{
+  struct timespec abstime = { 0, 0 };
+  PTW32_STRUCT_TIMEB currSysTime;
+
+  PTW32_FTIME(&currSysTime);
+  abstime.tv_sec = (long)currSysTime.time + 10;
+
+  assert(pthread_mutex_lock(&mx) == 0);
+  ready = 1;
+  while (ready == 1)
+    {
+      assert(pthread_cond_timedwait(&signalled, &mx, &abstime) == 0);
+    }
+  assert(pthread_mutex_unlock(&mx) == 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  pthread_t s;
+  long slack;
+  int i;
+
+  assert(pthread_settimerslack_np(-1) == EINVAL);
+  assert(pthread_gettimerslack_np(NULL) == EINVAL);
+  assert(pthread_settimerslack_np(1) == 0);
+  assert(pthread_gettimerslack_np(&slack) == 0);
+  assert(slack == 1000000);
+
+  assert(pthread_settimerslack_np(20000000) == 0);
+  assert(pthread_gettimerslack_np(&slack) == 0);
+  assert(slack == 20000000);
+
+  assert(pthread_create(&s, NULL, signalee, NULL) == 0);
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, waiter, (void *) (size_t) i) == 0);
+    }
+
+  /* The signalled wait must not have to wait for its 10 s timeout */
+  for (;;)
+    {
+      assert(pthread_mutex_lock(&mx) == 0);
+      if (ready == 1)
+        {
+          ready = 2;
+          assert(pthread_cond_signal(&signalled) == 0);
+          assert(pthread_mutex_unlock(&mx) == 0);
+          break;
+        }
+      assert(pthread_mutex_unlock(&mx) == 0);
+      Sleep(10);
+    }
+  assert(pthread_join(s, NULL) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(pthread_settimerslack_np(0) == 0);
+  assert(pthread_gettimerslack_np(&slack) == 0);
+  assert(slack == 0);
+
+  return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * tsd4.c
+ *
+ * Test pthread_getspecific() and pthread_getspecific_fast_np().
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Description:
+ * - Both functions return the value set in the calling thread, and
+ *   pthread_getspecific() preserves the last error code.
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 4
+};
+
+static pthread_key_t key;
+
+void *
+mythread(void * arg)
+{
+  assert(pthread_getspecific(key) == NULL);
+  assert(pthread_getspecific_fast_np(key) == NULL);
+
+  assert(pthread_setspecific(key, arg) == 0);
+
+  SetLastError(ERROR_INVALID_PARAMETER);
+  assert(pthread_getspecific(key) == arg);
+  assert(GetLastError() == ERROR_INVALID_PARAMETER);
+
+  assert(pthread_getspecific_fast_np(key) == arg);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  int i;
+
+  assert(pthread_getspecific_fast_np(NULL) == NULL);
+
+  assert(pthread_key_create(&key, NULL) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, mythread, (void *)(size_t)(i + 1)) == 0);
+    }
+
+  (void) mythread((void *)(size_t) (NUMTHREADS + 1));
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(pthread_key_delete(key) == 0);
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+/*
+ * tsd5.c
+ *
+ * Test keys beyond the Win32 TLS index limit.
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Description:
+ * - Create more keys than Win32 has TLS indexes, so that the later
+ *   ones are kept in the library's per-thread tables. Values must be
+ *   thread specific, destructors must run, and a key that reuses a
+ *   deleted key's slot must start out NULL.
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+  NUMKEYS = 2000,
+  NUMTHREADS = 4
+};
+
+static pthread_key_t keys[NUMKEYS];
+static LONG destroyed = 0;
+
+static void
+destroy(void * value)
+{
+  assert(value != NULL);
+  InterlockedIncrement(&destroyed);
+}
+
+void *
+mythread(void * arg)
+{
+  int id = (int)(size_t) arg;
+  int i;
+
+  for (i = 0; i < NUMKEYS; i++)
+    {
+      assert(pthread_getspecific(keys[i]) == NULL);
+      assert(pthread_setspecific(keys[i], (void *)(size_t)(id * NUMKEYS + i + 1)) == 0);
+    }
+
+  SetLastError(ERROR_INVALID_PARAMETER);
+  for (i = 0; i < NUMKEYS; i++)
+    {
+      assert(pthread_getspecific(keys[i]) == (void *)(size_t)(id * NUMKEYS + i + 1));
+      assert(pthread_getspecific_fast_np(keys[i]) == (void *)(size_t)(id * NUMKEYS + i + 1));
+    }
+  assert(pthread_getspecific(keys[NUMKEYS - 1]) != NULL);
+  SetLastError(ERROR_INVALID_PARAMETER);
+  (void) pthread_getspecific(keys[NUMKEYS - 1]);
+  assert(GetLastError() == ERROR_INVALID_PARAMETER);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  int i;
+
+  for (i = 0; i < NUMKEYS; i++)
+    {
+      assert(pthread_key_create(&keys[i], (i % 2) ? destroy : NULL) == 0);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, mythread, (void *)(size_t) (i + 1)) == 0);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(destroyed == NUMTHREADS * (NUMKEYS / 2));
+
+  /* The main thread still sees NULL */
+  for (i = 0; i < NUMKEYS; i++)
+    {
+      assert(pthread_getspecific(keys[i]) == NULL);
+    }
+
+  /* Reused slots start out NULL */
+  assert(pthread_setspecific(keys[NUMKEYS - 1], (void *) 1) == 0);
+  assert(pthread_key_delete(keys[NUMKEYS - 1]) == 0);
+  assert(pthread_key_create(&keys[NUMKEYS - 1], NULL) == 0);
+  assert(pthread_getspecific(keys[NUMKEYS - 1]) == NULL);
+
+  for (i = 0; i < NUMKEYS; i++)
+    {
+      assert(pthread_key_delete(keys[i]) == 0);
+    }
+
+  return 0;
+}
@@ -0,0 +1,183 @@
+/*
+ * tsd6.c
+ *
+ * Test key destructors at thread exit.
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Description:
+ * - Keys with destructors, enough of them that a thread's destructor
+ *   bitmap has to grow. A destructor that sets its key again is called
+ *   again, at most PTHREAD_DESTRUCTOR_ITERATIONS times; a destructor
+ *   may delete a key; a deleted key's destructor isn't called, even
+ *   when its slot has been reused.
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+  NUMKEYS = 200
+};
+
+static pthread_key_t keys[NUMKEYS];
+static pthread_key_t againKey;
+static pthread_key_t deleteKey;
+static pthread_key_t victimKey;
+static pthread_key_t reusedKey;
+static LONG destroyed = 0;
+static LONG againCalls = 0;
+static LONG victimCalls = 0;
+static LONG reusedCalls = 0;
+
+static void
+destroy(void * value)
+{
+  assert(value != NULL);
+  InterlockedIncrement(&destroyed);
+}
+
+static void
+again(void * value)
+{
+  InterlockedIncrement(&againCalls);
+  /* Always set again: the library must give up */
+  assert(pthread_setspecific(againKey, value) == 0);
+}
+
+static void
+deleter(void * value)
+{
+  assert(pthread_key_delete(victimKey) == 0);
+}
+
+static void
+victim(void * value)
+{
+  InterlockedIncrement(&victimCalls);
+}
+
+static void
+reused(void * value)
+{
+  InterlockedIncrement(&reusedCalls);
+}
+
+void *
+mythread(void * arg)
+{
+  int i;
+
+  for (i = 0; i < NUMKEYS; i++)
+    {
+      assert(pthread_setspecific(keys[i], (void *)(size_t)(i + 1)) == 0);
+    }
+
+  assert(pthread_setspecific(againKey, (void *) 1) == 0);
+
+  return NULL;
+}
+
+void *
+deletethread(void * arg)
+{
+  assert(pthread_setspecific(deleteKey, (void *) 1) == 0);
+  assert(pthread_setspecific(victimKey, (void *) 1) == 0);
+
+  return NULL;
+}
+
+void *
+reusethread(void * arg)
+{
+  pthread_key_t k;
+
+  assert(pthread_key_create(&k, victim) == 0);
+  assert(pthread_setspecific(k, (void *) 1) == 0);
+  assert(pthread_key_delete(k) == 0);
+
+  /* Probably gets the slot just freed; this thread has no value for it */
+  assert(pthread_key_create(&reusedKey, reused) == 0);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t;
+  int i;
+
+  for (i = 0; i < NUMKEYS; i++)
+    {
+      assert(pthread_key_create(&keys[i], destroy) == 0);
+    }
+  assert(pthread_key_create(&againKey, again) == 0);
+
+  assert(pthread_create(&t, NULL, mythread, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+
+  assert(destroyed == NUMKEYS);
+  assert(againCalls == PTHREAD_DESTRUCTOR_ITERATIONS);
+
+  /* deleteKey is created first, so its destructor runs first */
+  assert(pthread_key_create(&deleteKey, deleter) == 0);
+  assert(pthread_key_create(&victimKey, victim) == 0);
+
+  assert(pthread_create(&t, NULL, deletethread, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+
+  assert(victimCalls == 0);
+
+  assert(pthread_create(&t, NULL, reusethread, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+
+  assert(victimCalls == 0);
+  assert(reusedCalls == 0);
+
+  for (i = 0; i < NUMKEYS; i++)
+    {
+      assert(pthread_key_delete(keys[i]) == 0);
+    }
+  assert(pthread_key_delete(againKey) == 0);
+  assert(pthread_key_delete(deleteKey) == 0);
+  assert(pthread_key_delete(reusedKey) == 0);
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * tsd7.c
+ *
+ * Test key deletion while threads hold values.
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Description:
+ * - Create and delete keys while threads hold values for them. A
+ *   key created after another was deleted starts out NULL in every
+ *   thread, including those that set the deleted key, and only the
+ *   live key's destructor runs when they exit.
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 10,
+  NUMROUNDS = 100
+};
+
+static pthread_key_t key;
+static pthread_barrier_t barrier;
+static volatile LONG destroyed = 0;
+static int values[NUMTHREADS];
+
+static void
+destroy(void * value)
+{
+  InterlockedIncrement((LPLONG)&destroyed);
+}
+
+static void *
+worker(void * arg)
+{
+  int i;
+
+  for (i = 0; i < NUMROUNDS; i++)
+    {
+      /* main has created a new key */
+      pthread_barrier_wait(&barrier);
+      assert(pthread_getspecific(key) == NULL);
+      assert(pthread_setspecific(key, arg) == 0);
+      assert(pthread_getspecific(key) == arg);
+      pthread_barrier_wait(&barrier);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  int i;
+
+  assert(pthread_barrier_init(&barrier, NULL, NUMTHREADS + 1) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, &values[i]) == 0);
+    }
+
+  for (i = 0; i < NUMROUNDS; i++)
+    {
+      if (i > 0)
+	{
+	  assert(pthread_key_delete(key) == 0);
+	}
+      assert(pthread_key_create(&key, destroy) == 0);
+      assert(pthread_getspecific(key) == NULL);
+      pthread_barrier_wait(&barrier);
+      pthread_barrier_wait(&barrier);
+    }
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(destroyed == NUMTHREADS);
+
+  assert(pthread_key_delete(key) == 0);
+  assert(pthread_barrier_destroy(&barrier) == 0);
+
+  return 0;
+}
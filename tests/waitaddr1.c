@@ -0,0 +1,148 @@
+/* 
+ * waitaddr1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Waiting on and waking an address: argument checks, timeouts, a
+ * waiter released by a store and a wake, and a waiter blocked without
+ * a timeout released by cancellation.
+ *
+ * Depends on API functions:
+ *	pthread_wait_on_address_np()
+ *	pthread_wake_np()
+ *	pthread_create()
+ *	pthread_join()
+ *	pthread_cancel()
+ */
+
+#include "test.h"
+
+static volatile long word = 0;
+static volatile long parked = 0;
+
+void *
+waiter(void * arg)
+{
+  long expected = 0;
+
+  InterlockedIncrement((long *) &parked);
+
+  while (word == expected)
+    {
+      assert(pthread_wait_on_address_np(&word, &expected, sizeof(word), NULL) == 0);
+    }
+
+  return (void *)(size_t) word;
+}
+
+void *
+stuck(void * arg)
+{
+  long expected = 0;
+  volatile long never = 0;
+
+  InterlockedIncrement((long *) &parked);
+
+  for (;;)
+    {
+      (void) pthread_wait_on_address_np(&never, &expected, sizeof(never), NULL);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t;
+  void * result = NULL;
+  struct timespec abstime;
+  long expected = 0;
+  long other = 1;
+  unsigned char byte = 7;
+  unsigned char other8 = 8;
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+
+  assert(pthread_wait_on_address_np(NULL, &expected, sizeof(word), NULL) == EINVAL);
+  assert(pthread_wait_on_address_np(&word, NULL, sizeof(word), NULL) == EINVAL);
+  assert(pthread_wait_on_address_np(&word, &expected, 3, NULL) == EINVAL);
+  assert(pthread_wait_on_address_np((char *) &word + 1, &expected, 2, NULL) == EINVAL);
+  assert(pthread_wake_np(NULL, 1) == EINVAL);
+  assert(pthread_wake_np(&word, 0) == EINVAL);
+  assert(pthread_wake_np(&word, PTHREAD_WAKE_ALL_NP) == 0);
+
+  /* The value differs: no wait */
+  assert(pthread_wait_on_address_np(&word, &other, sizeof(word), NULL) == 0);
+  assert(pthread_wait_on_address_np(&byte, &other8, 1, NULL) == 0);
+
+  /* Timeouts */
+  abstime.tv_sec = 0;
+  abstime.tv_nsec = 0;
+  assert(pthread_wait_on_address_np(&word, &expected, sizeof(word), &abstime) == ETIMEDOUT);
+  PTW32_FTIME(&currSysTime);
+  abstime.tv_sec = (long)currSysTime.time;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm + 50000000;
+  abstime.tv_sec += abstime.tv_nsec / 1000000000;
+  abstime.tv_nsec %= 1000000000;
+  while (pthread_wait_on_address_np(&word, &expected, sizeof(word), &abstime) == 0)
+    {
+      /* Spurious */
+    }
+
+  /* A store and a wake release the waiter */
+  assert(pthread_create(&t, NULL, waiter, NULL) == 0);
+  while (parked == 0)
+    {
+      Sleep(1);
+    }
+  Sleep(50);
+  (void) InterlockedExchange((long *) &word, 2);
+  assert(pthread_wake_np(&word, 1) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert(result == (void *)(size_t) 2);
+
+  /* Cancellation releases a waiter whose location never changes */
+  parked = 0;
+  assert(pthread_create(&t, NULL, stuck, NULL) == 0);
+  while (parked == 0)
+    {
+      Sleep(1);
+    }
+  Sleep(50);
+  assert(pthread_cancel(t) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert(result == PTHREAD_CANCELED);
+
+  return 0;
+}
@@ -0,0 +1,186 @@
+/* 
+ * waitany1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Waiting for the first ready of several semaphores, queues and
+ * threads: argument checks, timeouts, objects that are ready at once,
+ * objects that become ready while waiting, and cancellation.
+ *
+ * Depends on API functions:
+ *	pthread_waitany_np()
+ *	pthread_queue_create_np()
+ *	pthread_queue_push_np()
+ *	pthread_queue_destroy_np()
+ *	sem_init()
+ *	sem_post()
+ *	sem_getvalue()
+ *	pthread_create()
+ *	pthread_join()
+ *	pthread_cancel()
+ */
+
+#include "test.h"
+
+static sem_t s0;
+static sem_t s1;
+static pthread_queue_np_t q;
+static volatile long started = 0;
+
+void *
+poster(void * arg)
+{
+  Sleep(50);
+  assert(sem_post(&s1) == 0);
+  return NULL;
+}
+
+void *
+pusher(void * arg)
+{
+  Sleep(50);
+  assert(pthread_queue_push_np(q, arg) == 0);
+  return NULL;
+}
+
+void *
+exiter(void * arg)
+{
+  Sleep(50);
+  return arg;
+}
+
+void *
+blocked(void * arg)
+{
+  pthread_waitany_np_t w[2];
+  int index;
+
+  w[0].type = PTHREAD_WAITANY_SEM_NP;
+  w[0].object = &s0;
+  w[1].type = PTHREAD_WAITANY_QUEUE_NP;
+  w[1].object = q;
+  InterlockedIncrement((long *) &started);
+  for (;;)
+    {
+      (void) pthread_waitany_np(w, 2, NULL, &index);
+    }
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_waitany_np_t w[3];
+  pthread_t t;
+  struct timespec abstime = { 0, 0 };
+  void * result = NULL;
+  int index = -1;
+  int value;
+
+  assert(sem_init(&s0, 0, 0) == 0);
+  assert(sem_init(&s1, 0, 0) == 0);
+  assert(pthread_queue_create_np(&q, 4) == 0);
+
+  w[0].type = PTHREAD_WAITANY_SEM_NP;
+  w[0].object = &s0;
+  w[1].type = PTHREAD_WAITANY_SEM_NP;
+  w[1].object = &s1;
+  w[2].type = PTHREAD_WAITANY_QUEUE_NP;
+  w[2].object = q;
+
+  assert(pthread_waitany_np(NULL, 1, NULL, &index) == EINVAL);
+  assert(pthread_waitany_np(w, 0, NULL, &index) == EINVAL);
+  assert(pthread_waitany_np(w, PTHREAD_WAITANY_MAX_NP + 1, NULL, &index) == EINVAL);
+  assert(pthread_waitany_np(w, 3, NULL, NULL) == EINVAL);
+  w[1].type = 0;
+  assert(pthread_waitany_np(w, 3, NULL, &index) == EINVAL);
+  w[1].type = PTHREAD_WAITANY_SEM_NP;
+  w[0].type = PTHREAD_WAITANY_JOIN_NP;
+  t = pthread_self();
+  w[0].object = &t;
+  assert(pthread_waitany_np(w, 1, NULL, &index) == EDEADLK);
+  w[0].type = PTHREAD_WAITANY_SEM_NP;
+  w[0].object = &s0;
+
+  /* Nothing ready */
+  assert(pthread_waitany_np(w, 3, &abstime, &index) == ETIMEDOUT);
+
+  /* Ready at once: the first ready object is taken, the others left */
+  assert(sem_post(&s1) == 0);
+  assert(pthread_queue_push_np(q, (void *) 7) == 0);
+  assert(pthread_waitany_np(w, 3, NULL, &index) == 0);
+  assert(index == 1);
+  assert(sem_getvalue(&s1, &value) == 0 && value == 0);
+  assert(pthread_waitany_np(w, 3, NULL, &index) == 0);
+  assert(index == 2);
+  assert(w[2].value == (void *) 7);
+
+  /* Ready while waiting */
+  assert(pthread_create(&t, NULL, poster, NULL) == 0);
+  assert(pthread_waitany_np(w, 3, NULL, &index) == 0);
+  assert(index == 1);
+  assert(pthread_join(t, NULL) == 0);
+
+  assert(pthread_create(&t, NULL, pusher, (void *) 9) == 0);
+  assert(pthread_waitany_np(w, 3, NULL, &index) == 0);
+  assert(index == 2);
+  assert(w[2].value == (void *) 9);
+  assert(pthread_join(t, NULL) == 0);
+
+  /* A thread's exit, which joins it */
+  assert(pthread_create(&t, NULL, exiter, (void *) 42) == 0);
+  w[1].type = PTHREAD_WAITANY_JOIN_NP;
+  w[1].object = &t;
+  assert(pthread_waitany_np(w, 3, NULL, &index) == 0);
+  assert(index == 1);
+  assert(w[1].value == (void *) 42);
+  assert(pthread_join(t, NULL) != 0);
+
+  /* Cancellation */
+  assert(pthread_create(&t, NULL, blocked, NULL) == 0);
+  while (started == 0)
+    {
+      Sleep(1);
+    }
+  Sleep(50);
+  assert(pthread_cancel(t) == 0);
+  assert(pthread_join(t, &result) == 0);
+  assert(result == PTHREAD_CANCELED);
+
+  assert(pthread_queue_destroy_np(&q) == 0);
+  assert(sem_destroy(&s0) == 0);
+  assert(sem_destroy(&s1) == 0);
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+/* 
+ * waitgraph1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test pthread_dump_waitgraph_np() with waiters on an errorcheck
+ * mutex, whose owner is known, and on a normal one, whose isn't.
+ *
+ * Depends on API functions:
+ *	pthread_dump_waitgraph_np()
+ *	pthread_mutex_init()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_unlock()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+static pthread_mutex_t mx[2];
+
+static void *
+locker(void * arg)
+{
+  pthread_mutex_t * m = (pthread_mutex_t *) arg;
+
+  assert(pthread_mutex_lock(m) == 0);
+  assert(pthread_mutex_unlock(m) == 0);
+
+  return NULL;
+}
+
+static int
+edges(pthread_waitedge_np_t * e, int n)
+{
+  int count = -1;
+
+  assert(pthread_dump_waitgraph_np(e, n, &count) == 0);
+  assert(count >= 0);
+
+  return count;
+}
+
+int
+main()
+{
+  pthread_mutexattr_t ma;
+  pthread_waitedge_np_t e[4];
+  pthread_t t[2];
+  int i;
+  int n = 0;
+
+  assert(pthread_dump_waitgraph_np(NULL, 0, NULL) == EINVAL);
+  assert(pthread_dump_waitgraph_np(NULL, 1, &n) == EINVAL);
+  assert(pthread_dump_waitgraph_np(e, -1, &n) == EINVAL);
+  assert(edges(NULL, 0) == 0);
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_ERRORCHECK) == 0);
+  assert(pthread_mutex_init(&mx[0], &ma) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+  assert(pthread_mutex_init(&mx[1], NULL) == 0);
+
+  assert(pthread_mutex_lock(&mx[0]) == 0);
+  assert(pthread_mutex_lock(&mx[1]) == 0);
+
+  for (i = 0; i < 2; i++)
+    {
+      assert(pthread_create(&t[i], NULL, locker, (void *) &mx[i]) == 0);
+    }
+
+  for (i = 0; i < 500 && (n = edges(e, 4)) < 2; i++)
+    {
+      Sleep(10);
+    }
+  assert(n == 2);
+
+  for (i = 0; i < n; i++)
+    {
+      int j = (e[i].mutex == mx[0]) ? 0 : 1;
+
+      assert(e[i].mutex == mx[j]);
+      assert(pthread_equal(e[i].waiter, t[j]));
+      if (j == 0)
+        assert(pthread_equal(e[i].owner, pthread_self()));
+      else
+        assert(e[i].owner.p == NULL);
+    }
+  assert(e[0].mutex != e[1].mutex);
+
+  /* Only the count when the array is too small */
+  assert(edges(e, 1) == 2);
+
+  for (i = 0; i < 2; i++)
+    {
+      assert(pthread_mutex_unlock(&mx[i]) == 0);
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(edges(e, 4) == 0);
+
+  assert(pthread_mutex_destroy(&mx[0]) == 0);
+  assert(pthread_mutex_destroy(&mx[1]) == 0);
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+/* 
+ * wakeboost1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Wake boost: the process wide default for new threads, and turning
+ * the boost off and on again on a running thread, checked against
+ * what Windows reports.
+ *
+ * Depends on API functions:
+ *	pthread_setwakeboost_np()
+ *	pthread_getwakeboost_np()
+ *	pthread_setparam_np()
+ *	pthread_getparam_np()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+static int
+disabled(void)
+{
+  BOOL off;
+
+  assert(GetThreadPriorityBoost(GetCurrentThread(), &off));
+  return off ? 1 : 0;
+}
+
+void *
+func(void * arg)
+{
+  int boost;
+
+  assert(pthread_getwakeboost_np(pthread_self(), &boost) == 0);
+  assert(boost == (int)(size_t) arg);
+  assert(disabled() == !boost);
+
+  assert(pthread_setwakeboost_np(pthread_self(), !boost) == 0);
+  assert(pthread_getwakeboost_np(pthread_self(), &boost) == 0);
+  assert(boost == !(int)(size_t) arg);
+  assert(disabled() == !boost);
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t;
+  long value;
+  int boost;
+
+  assert(pthread_getparam_np(PTHREAD_PARAM_WAKE_BOOST_NP, &value) == 0);
+  assert(value == 1);
+  assert(pthread_setparam_np(PTHREAD_PARAM_WAKE_BOOST_NP, 2) == EINVAL);
+
+  assert(pthread_setwakeboost_np(pthread_self(), 2) == EINVAL);
+  assert(pthread_getwakeboost_np(pthread_self(), NULL) == EINVAL);
+
+  assert(pthread_create(&t, NULL, func, (void *) 1) == 0);
+  assert(pthread_join(t, NULL) == 0);
+
+  assert(pthread_setparam_np(PTHREAD_PARAM_WAKE_BOOST_NP, 0) == 0);
+  assert(pthread_getparam_np(PTHREAD_PARAM_WAKE_BOOST_NP, &value) == 0);
+  assert(value == 0);
+  assert(pthread_create(&t, NULL, func, (void *) 0) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(pthread_setparam_np(PTHREAD_PARAM_WAKE_BOOST_NP, 1) == 0);
+
+  /* The main thread isn't created by the library, so keeps its boost */
+  assert(pthread_getwakeboost_np(pthread_self(), &boost) == 0);
+  assert(boost == 1);
+  assert(pthread_setwakeboost_np(pthread_self(), 0) == 0);
+  assert(disabled() == 1);
+  assert(pthread_setwakeboost_np(pthread_self(), 1) == 0);
+  assert(disabled() == 0);
+
+  return 0;
+}
@@ -0,0 +1,151 @@
+/* 
+ * wsdeque1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Work-stealing deque: LIFO pops and FIFO steals, growth, and every
+ * item taken exactly once while thieves race the owner.
+ *
+ * Depends on API functions:
+ *	pthread_wsdeque_create_np()
+ *	pthread_wsdeque_destroy_np()
+ *	pthread_wsdeque_push_np()
+ *	pthread_wsdeque_pop_np()
+ *	pthread_wsdeque_steal_np()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHIEVES = 4,
+  ITEMS = 100000
+};
+
+static pthread_wsdeque_np_t deque;
+static LONG taken[ITEMS + 1];
+static LONG ownerDone = 0;
+
+void *
+thief(void * arg)
+{
+  void * item;
+  int result;
+
+  for (;;)
+    {
+      result = pthread_wsdeque_steal_np(deque, &item);
+      if (result == 0)
+        {
+          InterlockedIncrement(&taken[(size_t) item]);
+        }
+      else if (result == EAGAIN && InterlockedExchangeAdd(&ownerDone, 0L))
+        {
+          break;
+        }
+      else
+        {
+          assert(result == EAGAIN || result == EBUSY);
+        }
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHIEVES];
+  void * item;
+  size_t i;
+
+  assert(pthread_wsdeque_create_np(NULL) == EINVAL);
+  assert(pthread_wsdeque_create_np(&deque) == 0);
+  assert(pthread_wsdeque_pop_np(deque, &item) == EAGAIN);
+  assert(pthread_wsdeque_steal_np(deque, &item) == EAGAIN);
+  assert(pthread_wsdeque_pop_np(deque, NULL) == EINVAL);
+
+  /* Past the initial size, so the deque grows */
+  for (i = 1; i <= 1000; i++)
+    {
+      assert(pthread_wsdeque_push_np(deque, (void *) i) == 0);
+    }
+  assert(pthread_wsdeque_steal_np(deque, &item) == 0);
+  assert(item == (void *) 1);
+  assert(pthread_wsdeque_pop_np(deque, &item) == 0);
+  assert(item == (void *) 1000);
+  for (i = 999; i >= 2; i--)
+    {
+      assert(pthread_wsdeque_pop_np(deque, &item) == 0);
+      assert(item == (void *) i);
+    }
+  assert(pthread_wsdeque_pop_np(deque, &item) == EAGAIN);
+  assert(pthread_wsdeque_steal_np(deque, &item) == EAGAIN);
+
+  for (i = 0; i < NUMTHIEVES; i++)
+    {
+      assert(pthread_create(&t[i], NULL, thief, NULL) == 0);
+    }
+
+  /* Push in bursts and pop some back, racing the thieves */
+  for (i = 1; i <= ITEMS; i++)
+    {
+      assert(pthread_wsdeque_push_np(deque, (void *) i) == 0);
+      if (i % 3 == 0 && pthread_wsdeque_pop_np(deque, &item) == 0)
+        {
+          InterlockedIncrement(&taken[(size_t) item]);
+        }
+    }
+  while (pthread_wsdeque_pop_np(deque, &item) == 0)
+    {
+      InterlockedIncrement(&taken[(size_t) item]);
+    }
+  InterlockedExchange(&ownerDone, 1L);
+
+  for (i = 0; i < NUMTHIEVES; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  for (i = 1; i <= ITEMS; i++)
+    {
+      assert(taken[i] == 1);
+    }
+
+  assert(pthread_wsdeque_destroy_np(&deque) == 0);
+  assert(deque == NULL);
+  assert(pthread_wsdeque_destroy_np(&deque) == EINVAL);
+
+  return 0;
+}
@@ -0,0 +1,104 @@
+/* 
+ * yield1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * The sched_yield modes: setting and getting the mode, yielding in
+ * each, and the backoff of a thread that keeps yielding.
+ *
+ * Depends on API functions:
+ *	pthread_setyieldmode_np()
+ *	pthread_getyieldmode_np()
+ *	sched_yield()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  NYIELDS = 100
+};
+
+void *
+func(void * arg)
+{
+  DWORD start = GetTickCount();
+  int i;
+
+  for (i = 0; i < NYIELDS; i++)
+    {
+      assert(sched_yield() == 0);
+    }
+
+  return (void *)(size_t) (GetTickCount() - start);
+}
+
+int
+main()
+{
+  pthread_t t;
+  void * elapsed;
+  int mode;
+
+  assert(pthread_getyieldmode_np(&mode) == 0);
+  assert(mode == PTHREAD_YIELD_SWITCH_NP);
+  assert(pthread_getyieldmode_np(NULL) == EINVAL);
+  assert(pthread_setyieldmode_np(-1) == EINVAL);
+  assert(pthread_setyieldmode_np(PTHREAD_YIELD_BACKOFF_NP + 1) == EINVAL);
+
+  assert(sched_yield() == 0);
+
+  assert(pthread_setyieldmode_np(PTHREAD_YIELD_SLEEP_NP) == 0);
+  assert(pthread_getyieldmode_np(&mode) == 0);
+  assert(mode == PTHREAD_YIELD_SLEEP_NP);
+  assert(sched_yield() == 0);
+
+  /*
+   * Most of a run of yields sleep for a tick, which can't take less
+   * than a millisecond.
+   */
+  assert(pthread_setyieldmode_np(PTHREAD_YIELD_BACKOFF_NP) == 0);
+  assert(pthread_getyieldmode_np(&mode) == 0);
+  assert(mode == PTHREAD_YIELD_BACKOFF_NP);
+  assert(sched_yield() == 0);
+  assert(pthread_create(&t, NULL, func, NULL) == 0);
+  assert(pthread_join(t, &elapsed) == 0);
+  assert((int)(size_t) elapsed >= NYIELDS / 2);
+
+  assert(pthread_setyieldmode_np(PTHREAD_YIELD_SWITCH_NP) == 0);
+  assert(pthread_create(&t, NULL, func, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+
+  return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * timer_create.c
+ * 
+ * Description:
+ * POSIX timer functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_TIMER_CREATE)
+
+int
+timer_create (clockid_t clock_id, struct sigevent * evp, timer_t * timerid)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function creates a timer.
+      *
+      * PARAMETERS
+      *      clock_id
+      *              CLOCK_REALTIME or CLOCK_MONOTONIC
+      *
+      *      evp
+      *              pointer to how expiries are notified:
+      *              SIGEV_THREAD, calling sigev_notify_function
+      *              with sigev_value, or SIGEV_NONE
+      *
+      *      timerid
+      *              pointer to an instance of timer_t
+      *
+      * DESCRIPTION
+      *      The timer is created disarmed; see timer_settime.
+      *      SIGEV_THREAD notifications run on the threads of a
+      *      library thread pool, not on a new thread each, and
+      *      sigev_notify_attributes is ignored. One library
+      *      thread times all of the process's timers; both it and
+      *      the pool are started by the first call.
+      *
+      * RESULTS
+      *              0               successfully created the timer,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'clock_id' is not a clock a timer
+      *                              can use, 'evp' is NULL (there are
+      *                              no signals to notify with), or
+      *                              its notification is not
+      *                              SIGEV_NONE or SIGEV_THREAD with
+      *                              a function,
+      *              EAGAIN          insufficient resources.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  timer_t t;
+  int result;
+
+  if (timerid == NULL
+      || evp == NULL
+      || (clock_id != CLOCK_REALTIME && clock_id != CLOCK_MONOTONIC)
+      || (evp->sigev_notify != SIGEV_NONE
+          && (evp->sigev_notify != SIGEV_THREAD || evp->sigev_notify_function == NULL)))
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  if (NULL == (t = (timer_t) calloc (1, sizeof (*t))))
+    {
+      errno = EAGAIN;
+      return -1;
+    }
+
+  t->event = *evp;
+  t->clock = clock_id;
+  t->heapIndex = -1;
+  t->refs = 1;
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_lock, &node);
+
+  if (0 == (result = ptw32_timer_start ())
+      && 0 == (result = ptw32_timer_reserve (ptw32_timerCount + 1)))
+    {
+      ptw32_timerCount++;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  if (0 != result)
+    {
+      free (t);
+      errno = result;
+      return -1;
+    }
+
+  *timerid = t;
+
+  return 0;
+}
+
+#endif /* PTW32_TIMER_CREATE */
@@ -0,0 +1,88 @@
+/*
+ * timer_delete.c
+ * 
+ * Description:
+ * POSIX timer functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_TIMER_CREATE)
+
+int
+timer_delete (timer_t timerid)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function deletes a timer.
+      *
+      * PARAMETERS
+      *      timerid
+      *              a timer from timer_create
+      *
+      * DESCRIPTION
+      *      The timer is disarmed and a notification that hasn't
+      *      begun yet won't call its function. One that has begun
+      *      runs to completion; timer_delete doesn't wait for it.
+      *
+      * RESULTS
+      *              0               successfully deleted the timer,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'timerid' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+
+  if (timerid == NULL)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_lock, &node);
+
+  ptw32_timer_arm (timerid, -1, 0);
+  timerid->deleted = PTW32_TRUE;
+  ptw32_timerCount--;
+
+  ptw32_mcs_lock_release (&node);
+
+  ptw32_timer_release (timerid);
+
+  return 0;
+}
+
+#endif /* PTW32_TIMER_CREATE */
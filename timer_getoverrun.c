@@ -0,0 +1,84 @@
+/*
+ * timer_getoverrun.c
+ * 
+ * Description:
+ * POSIX timer functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_TIMER_CREATE)
+
+int
+timer_getoverrun (timer_t timerid)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function returns a timer's overrun count.
+      *
+      * PARAMETERS
+      *      timerid
+      *              a timer from timer_create
+      *
+      * DESCRIPTION
+      *      The count is of the expiries that weren't notified
+      *      separately because a notification was still queued,
+      *      up to the last notification to begin. It is INT_MAX
+      *      if there were more.
+      *
+      * RESULTS
+      *              >= 0            the overrun count,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'timerid' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int result;
+
+  if (timerid == NULL)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_lock, &node);
+  result = timerid->lastOverrun;
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
+
+#endif /* PTW32_TIMER_CREATE */
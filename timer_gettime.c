@@ -0,0 +1,99 @@
+/*
+ * timer_gettime.c
+ * 
+ * Description:
+ * POSIX timer functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_TIMER_CREATE)
+
+int
+timer_gettime (timer_t timerid, struct itimerspec * value)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function returns the time until a timer next
+      *      expires, and its interval.
+      *
+      * PARAMETERS
+      *      timerid
+      *              a timer from timer_create
+      *
+      *      value
+      *              pointer to an instance of struct itimerspec;
+      *              it_value is zero if the timer is disarmed
+      *
+      * RESULTS
+      *              0               successfully read the timer,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'timerid' or 'value' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int64_t now;
+  int64_t remaining = 0;
+  int64_t interval = 0;
+
+  if (timerid == NULL || value == NULL)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  now = ptw32_monotonic_100nanosecs ();
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_lock, &node);
+
+  if (timerid->heapIndex >= 0)
+    {
+      /* Due now, but not yet seen by the timer thread: about to expire */
+      remaining = (timerid->expiry > now) ? timerid->expiry - now : 1;
+      interval = timerid->interval;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  value->it_value.tv_sec = (time_t) (remaining / 10000000);
+  value->it_value.tv_nsec = (long) (remaining % 10000000) * 100;
+  value->it_interval.tv_sec = (time_t) (interval / 10000000);
+  value->it_interval.tv_nsec = (long) (interval % 10000000) * 100;
+
+  return 0;
+}
+
+#endif /* PTW32_TIMER_CREATE */
@@ -0,0 +1,138 @@
+/*
+ * timer_settime.c
+ * 
+ * Description:
+ * POSIX timer functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2005 Pthreads-win32 contributors
+ * 
+ *      Contact Email: rpj@callisto.canberra.edu.au
+ * 
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include "pthread.h"
+#include "implement.h"
+
+#if defined(PTW32_TIMER_CREATE)
+
+/* A timespec in 100 nanosecond units, rounded up */
+static int64_t
+ptw32_timer_100nanosecs (const struct timespec * ts)
+{
+  return (int64_t) ts->tv_sec * 10000000 + (ts->tv_nsec + 99) / 100;
+}
+
+int
+timer_settime (timer_t timerid, int flags,
+               const struct itimerspec * value, struct itimerspec * ovalue)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      This function arms or disarms a timer.
+      *
+      * PARAMETERS
+      *      timerid
+      *              a timer from timer_create
+      *
+      *      flags
+      *              TIMER_ABSTIME: it_value is a time of the
+      *              timer's clock rather than an interval from now
+      *
+      *      value
+      *              pointer to when the timer first expires
+      *              (it_value; zero disarms it) and the period of
+      *              its later expiries (it_interval; zero: none)
+      *
+      *      ovalue
+      *              NULL, or pointer to an instance of struct
+      *              itimerspec to receive the timer's previous
+      *              setting, as timer_gettime
+      *
+      * DESCRIPTION
+      *      Expiries are timed against CLOCK_MONOTONIC to the
+      *      100 nanoseconds where the system has high resolution
+      *      timers. An absolute CLOCK_REALTIME time is converted
+      *      when the timer is armed, so later changes to the
+      *      system time don't move it. A periodic timer's
+      *      expiries stay on the grid set by it_value, however
+      *      late the notifications run.
+      *
+      * RESULTS
+      *              0               successfully set the timer,
+      *              -1              failed, error in errno
+      * ERRNO
+      *              EINVAL          'timerid' or 'value' is invalid,
+      *                              or a tv_nsec is not from 0 to
+      *                              999999999.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int64_t expiry = -1;
+  int64_t interval;
+
+  if (timerid == NULL || value == NULL
+      || value->it_value.tv_sec < 0
+      || value->it_value.tv_nsec < 0 || value->it_value.tv_nsec >= 1000000000L
+      || value->it_interval.tv_sec < 0
+      || value->it_interval.tv_nsec < 0 || value->it_interval.tv_nsec >= 1000000000L)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  if (ovalue != NULL)
+    {
+      (void) timer_gettime (timerid, ovalue);
+    }
+
+  interval = ptw32_timer_100nanosecs (&value->it_interval);
+
+  if (value->it_value.tv_sec != 0 || value->it_value.tv_nsec != 0)
+    {
+      if (flags & TIMER_ABSTIME)
+        {
+          struct timespec deadline;
+
+          ptw32_monotonic_deadline (timerid->clock, &value->it_value, &deadline);
+          expiry = ptw32_timer_100nanosecs (&deadline);
+        }
+      else
+        {
+          expiry = ptw32_monotonic_100nanosecs () + ptw32_timer_100nanosecs (&value->it_value);
+        }
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_lock, &node);
+  ptw32_timer_arm (timerid, expiry, interval);
+  ptw32_mcs_lock_release (&node);
+
+  return 0;
+}
+
+#endif /* PTW32_TIMER_CREATE */
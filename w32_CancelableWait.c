@@ -39,7 +39,7 @@
 
 
 static INLINE int
-ptw32_cancelable_wait (HANDLE waitHandle, DWORD timeout)
+ptw32_cancelable_wait (HANDLE waitHandle, DWORD timeout, HANDLE timer)
      /*
       * -------------------------------------------------------------------
       * This provides an extra hook into the pthread_cancel
@@ -51,13 +51,17 @@ ptw32_cancelable_wait (HANDLE waitHandle, DWORD timeout)
       * 
       * Given this hook it would be possible to implement more of the cancellation
       * points.
+      *
+      * If 'timer' is not NULL it is a waitable timer that is waited for
+      * last; it becoming signalled is a timeout.
       * -------------------------------------------------------------------
       */
 {
   int result;
   pthread_t self;
   ptw32_thread_t * sp;
-  HANDLE handles[2];
+  ptw32_rcu_reader_t * rcu = NULL;
+  HANDLE handles[3];
   DWORD nHandles = 1;
   DWORD status;
 
@@ -74,7 +78,7 @@ ptw32_cancelable_wait (HANDLE waitHandle, DWORD timeout)
       if (sp->cancelState == PTHREAD_CANCEL_ENABLE)
 	{
 
-	  if ((handles[1] = sp->cancelEvent) != NULL)
+	  if ((handles[1] = ptw32_cancel_event (sp)) != NULL)
 	    {
 	      nHandles++;
 	    }
@@ -85,7 +89,45 @@ ptw32_cancelable_wait (HANDLE waitHandle, DWORD timeout)
       handles[1] = NULL;
     }
 
-  status = WaitForMultipleObjects (nHandles, handles, PTW32_FALSE, timeout);
+  if (nHandles > 1 && sp->state == PThreadStateCancelPending)
+    {
+      /*
+       * Act on a cancel that is already pending without waiting.
+       */
+      status = WAIT_OBJECT_0 + 1;
+    }
+  else
+    {
+      if (timer != NULL)
+	{
+	  handles[nHandles++] = timer;
+	}
+
+      /*
+       * An RCU reader is quiescent while it waits, so it is offline
+       * rather than holding up grace periods.
+       */
+      if (sp != NULL && (rcu = sp->rcuReader) != NULL && rcu->ctr != 0)
+	{
+	  PTW32_RCU_OFFLINE (rcu);
+	}
+      else
+	{
+	  rcu = NULL;
+	}
+
+      status = ptw32_wait_objects (nHandles, handles, timeout);
+
+      if (rcu != NULL)
+	{
+	  PTW32_RCU_ONLINE (rcu);
+	}
+
+      if (timer != NULL && status == WAIT_OBJECT_0 + nHandles - 1)
+	{
+	  status = WAIT_TIMEOUT;
+	}
+    }
 
   switch (status - WAIT_OBJECT_0)
     {
@@ -151,11 +193,28 @@ ptw32_cancelable_wait (HANDLE waitHandle, DWORD timeout)
 int
 pthreadCancelableWait (HANDLE waitHandle)
 {
-  return (ptw32_cancelable_wait (waitHandle, INFINITE));
+  return (ptw32_cancelable_wait (waitHandle, INFINITE, NULL));
 }
 
 int
 pthreadCancelableTimedWait (HANDLE waitHandle, DWORD timeout)
 {
-  return (ptw32_cancelable_wait (waitHandle, timeout));
+  return (ptw32_cancelable_wait (waitHandle, timeout, NULL));
+}
+
+int
+ptw32_cancelable_abstimed_wait (HANDLE waitHandle, clockid_t clock,
+                                const struct timespec * abstime)
+     /*
+      * -------------------------------------------------------------------
+      * As pthreadCancelableTimedWait, but waits until abstime (NULL:
+      * forever) measured against 'clock', using a high resolution timer
+      * if the system has them.
+      * -------------------------------------------------------------------
+      */
+{
+  HANDLE timer;
+  DWORD timeout = ptw32_wait_timeout (clock, abstime, &timer);
+
+  return (ptw32_cancelable_wait (waitHandle, timeout, timer));
 }